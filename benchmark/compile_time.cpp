@@ -0,0 +1,310 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <csrc/exceptions.h>
+#include <fusion.h>
+#include <instrumentation.h>
+#include <ir/all_nodes.h>
+#include <ir/builder.h>
+#include <kernel_cache.h>
+#include <ops/all_ops.h>
+#include <options.h>
+
+#include <benchmark/benchmark.h>
+
+#include <cuda_runtime.h>
+
+#include <benchmark/utils.h>
+#include <test/utils.h>
+
+using namespace nvfuser;
+
+// The time of the first run of representative fusions, i.e., of
+// concretization, segmentation, scheduling, lowering and NVRTC, on a new
+// FusionExecutorCache in each iteration. The per-iteration time of each
+// phase is reported as a counter, from the aggregated traced scopes of
+// [ Compile Profile ].
+//
+// The fusions are those of the BERT, timm and nanoGPT benchmarks of
+// benchmark/ and python_benchmarks/, rebuilt with the same ops.
+
+namespace {
+
+using FusionAndInputs =
+    std::pair<std::unique_ptr<Fusion>, std::vector<c10::IValue>>;
+
+at::TensorOptions halfOptions() {
+  return at::TensorOptions().dtype(at::kHalf).device(at::kCUDA, 0);
+}
+
+// Bias, dropout, residual and layer norm of a BERT layer
+FusionAndInputs bertBiasDropoutAddLayerNorm() {
+  constexpr int64_t kTokens = 8 * 512;
+  constexpr int64_t kHidden = 1024;
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  TensorView* x = makeContigTensor(2, DataType::Half);
+  TensorView* bias = makeContigTensor(1, DataType::Half);
+  TensorView* residual = makeContigTensor(2, DataType::Half);
+  TensorView* weight = makeContigTensor(1, DataType::Half);
+  TensorView* beta = makeContigTensor(1, DataType::Half);
+  for (TensorView* tv : {x, bias, residual, weight, beta}) {
+    fusion->addInput(tv);
+  }
+  TensorView* y = add(
+      castOp(DataType::Float, x),
+      broadcast(castOp(DataType::Float, bias), {true, false}));
+  y = dropout(y, IrBuilder::create<Val>(0.9)).output;
+  y = add(y, castOp(DataType::Float, residual));
+  auto ln = layer_norm(
+      y,
+      1,
+      castOp(DataType::Float, weight),
+      castOp(DataType::Float, beta),
+      IrBuilder::create<Val>(1e-5));
+  fusion->addOutput(castOp(DataType::Half, ln.output));
+  fusion->addOutput(ln.mean);
+  fusion->addOutput(ln.invstd);
+
+  auto options = halfOptions();
+  return {
+      std::move(fusion),
+      {at::randn({kTokens, kHidden}, options),
+       at::randn({kHidden}, options),
+       at::randn({kTokens, kHidden}, options),
+       at::randn({kHidden}, options),
+       at::randn({kHidden}, options)}};
+}
+
+// Layer norm backward of a BERT layer
+FusionAndInputs bertLayerNormBackward() {
+  constexpr int64_t kTokens = 8 * 512;
+  constexpr int64_t kHidden = 1024;
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  TensorView* dy = makeContigTensor(2, DataType::Half);
+  TensorView* x = makeContigTensor(2, DataType::Half);
+  TensorView* mean = makeConcreteTensor({-1, 1});
+  TensorView* rstd = makeConcreteTensor({-1, 1});
+  TensorView* weight = makeContigTensor(1, DataType::Half);
+  TensorView* bias = makeContigTensor(1, DataType::Half);
+  for (TensorView* tv : {dy, x, mean, rstd, weight, bias}) {
+    fusion->addInput(tv);
+  }
+  auto grads = layer_norm_backward(
+      castOp(DataType::Float, dy),
+      castOp(DataType::Float, x),
+      {kHidden},
+      mean,
+      rstd,
+      castOp(DataType::Float, weight),
+      castOp(DataType::Float, bias),
+      {true, true, true});
+  fusion->addOutput(castOp(DataType::Half, grads.grad_input));
+  fusion->addOutput(castOp(DataType::Half, grads.grad_weight));
+  fusion->addOutput(castOp(DataType::Half, grads.grad_bias));
+
+  auto options = halfOptions();
+  auto float_options = options.dtype(at::kFloat);
+  return {
+      std::move(fusion),
+      {at::randn({kTokens, kHidden}, options),
+       at::randn({kTokens, kHidden}, options),
+       at::randn({kTokens, 1}, float_options),
+       at::rand({kTokens, 1}, float_options),
+       at::randn({kHidden}, options),
+       at::randn({kHidden}, options)}};
+}
+
+// Channels-last batch norm and ReLU of a timm ResNet block
+FusionAndInputs timmBatchNormRelu() {
+  constexpr int64_t kN = 64;
+  constexpr int64_t kHW = 56;
+  constexpr int64_t kC = 64;
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  TensorView* x = makeContigTensor(4, DataType::Half);
+  TensorView* weight = makeContigTensor(1);
+  TensorView* bias = makeContigTensor(1);
+  TensorView* running_mean = makeContigTensor(1);
+  TensorView* running_var = makeContigTensor(1);
+  for (TensorView* tv : {x, weight, bias, running_mean, running_var}) {
+    fusion->addInput(tv);
+  }
+  auto bn = batch_norm(
+      castOp(DataType::Float, x),
+      weight,
+      bias,
+      running_mean,
+      running_var,
+      /*kTraining=*/true,
+      IrBuilder::create<Val>(0.1),
+      IrBuilder::create<Val>(1e-5),
+      /*channels_last=*/true);
+  fusion->addOutput(castOp(DataType::Half, relu(bn.output)));
+  fusion->addOutput(bn.mean);
+  fusion->addOutput(bn.invstd);
+
+  auto float_options = halfOptions().dtype(at::kFloat);
+  return {
+      std::move(fusion),
+      {at::randn({kN, kHW, kHW, kC}, halfOptions()),
+       at::ones({kC}, float_options),
+       at::zeros({kC}, float_options),
+       at::zeros({kC}, float_options),
+       at::ones({kC}, float_options)}};
+}
+
+// Scaled softmax and dropout of nanoGPT attention
+FusionAndInputs nanoGptAttentionSoftmax() {
+  constexpr int64_t kBatchHeads = 16 * 12;
+  constexpr int64_t kSeq = 1024;
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  TensorView* scores = makeContigTensor(3, DataType::Half);
+  fusion->addInput(scores);
+  TensorView* y =
+      mul(castOp(DataType::Float, scores), IrBuilder::create<Val>(0.125));
+  y = softmax(y, -1);
+  y = dropout(y, IrBuilder::create<Val>(0.9)).output;
+  fusion->addOutput(castOp(DataType::Half, y));
+
+  return {
+      std::move(fusion),
+      {at::randn({kBatchHeads, kSeq, kSeq}, halfOptions())}};
+}
+
+// Bias, tanh GELU and residual of the MLPs of a stack of BERT layers, which
+// the pointwise scheduler generates a single kernel of thousands of
+// expressions for. Lowering, in particular expression sorting, dominates the
+// compile time of such fusions.
+FusionAndInputs bertMlpEpilogueStack() {
+  constexpr int64_t kTokens = 8 * 512;
+  constexpr int64_t kHidden = 1024;
+  constexpr int64_t kLayers = 96;
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  TensorView* x = makeContigTensor(2, DataType::Half);
+  TensorView* bias = makeContigTensor(1, DataType::Half);
+  fusion->addInput(x);
+  fusion->addInput(bias);
+  TensorView* y = castOp(DataType::Float, x);
+  TensorView* b = broadcast(castOp(DataType::Float, bias), {true, false});
+  for (int64_t i = 0; i < kLayers; i++) {
+    TensorView* h = tanh_gelu(add(y, b));
+    y = add(mul(h, IrBuilder::create<Val>(0.5)), y);
+  }
+  fusion->addOutput(castOp(DataType::Half, y));
+
+  auto options = halfOptions();
+  return {
+      std::move(fusion),
+      {at::randn({kTokens, kHidden}, options),
+       at::randn({kHidden}, options)}};
+}
+
+// The traced scope of each phase, see [ Compile Profile ]
+const std::vector<std::pair<std::string, std::string>>& compilePhases() {
+  static const std::vector<std::pair<std::string, std::string>> phases = {
+      {"concretization_ms", "DynamicTransform::concretizeFusion"},
+      {"pre_segmenter_ms", "PreSegmenter"},
+      {"segmenter_ms", "Finding valid fusion segment solutions"},
+      {"lowering_ms", "GpuLower::lower"},
+      {"expr_sort_ms", "reorderExprsForComputeAt"},
+      {"codegen_ms", "generateCudaKernel"},
+      {"nvrtc_ms", "executor_utils::NVRTC"},
+  };
+  return phases;
+}
+
+void NvFuserScheduler_CompileTime(
+    benchmark::State& benchmark_state,
+    FusionAndInputs (*make_fusion)()) {
+  // Nothing compiled before may be reused
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().unset(EnableOption::CompileCache);
+  EnableOptionsGuard::getCurOptions().unset(EnableOption::KernelDb);
+
+  auto [fusion, inputs] = make_fusion();
+
+  inst::Trace* trace = inst::Trace::instance();
+  const bool recorded_profile = trace->recordsProfile();
+  trace->setRecordProfile(true);
+  trace->resetProfile();
+
+  for (auto _ : benchmark_state) {
+    benchmark_state.PauseTiming();
+    auto fusion_copy = std::make_unique<Fusion>(*fusion);
+    benchmark_state.ResumeTiming();
+
+    auto fec = std::make_unique<FusionExecutorCache>(std::move(fusion_copy));
+    fec->runFusionWithInputs(inputs);
+
+    benchmark_state.PauseTiming();
+    NVFUSER_CUDA_RT_SAFE_CALL(cudaDeviceSynchronize());
+    fec.reset();
+    benchmark_state.ResumeTiming();
+  }
+
+  // Scopes of scheduling are named by scheduler, e.g., "Schedule PointWise
+  // Fusion"
+  std::unordered_map<std::string, double> phase_ms;
+  for (const inst::ScopeProfile& scope : trace->profile()) {
+    if (scope.name.rfind("Schedule ", 0) == 0) {
+      phase_ms["scheduling_ms"] += scope.total_ms;
+    }
+    for (const auto& [phase, scope_name] : compilePhases()) {
+      if (scope.name == scope_name) {
+        phase_ms[phase] += scope.total_ms;
+      }
+    }
+  }
+  for (const auto& [phase, ms] : phase_ms) {
+    benchmark_state.counters[phase] = ms / (double)benchmark_state.iterations();
+  }
+
+  trace->resetProfile();
+  trace->setRecordProfile(recorded_profile);
+}
+
+} // namespace
+
+BENCHMARK_CAPTURE(
+    NvFuserScheduler_CompileTime,
+    BertBiasDropoutAddLayerNorm,
+    bertBiasDropoutAddLayerNorm)
+    ->Unit(benchmark::kMillisecond)
+    ->Iterations(5);
+BENCHMARK_CAPTURE(
+    NvFuserScheduler_CompileTime,
+    BertLayerNormBackward,
+    bertLayerNormBackward)
+    ->Unit(benchmark::kMillisecond)
+    ->Iterations(5);
+BENCHMARK_CAPTURE(
+    NvFuserScheduler_CompileTime,
+    BertMlpEpilogueStack,
+    bertMlpEpilogueStack)
+    ->Unit(benchmark::kMillisecond)
+    ->Iterations(5);
+BENCHMARK_CAPTURE(
+    NvFuserScheduler_CompileTime,
+    TimmBatchNormRelu,
+    timmBatchNormRelu)
+    ->Unit(benchmark::kMillisecond)
+    ->Iterations(5);
+BENCHMARK_CAPTURE(
+    NvFuserScheduler_CompileTime,
+    NanoGptAttentionSoftmax,
+    nanoGptAttentionSoftmax)
+    ->Unit(benchmark::kMillisecond)
+    ->Iterations(5);
@@ -0,0 +1,244 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <csrc/exceptions.h>
+#include <fusion.h>
+#include <ir/all_nodes.h>
+#include <ir/builder.h>
+#include <kernel_cache.h>
+#include <ops/all_ops.h>
+
+#include <benchmark/benchmark.h>
+
+#include <c10/cuda/CUDACachingAllocator.h>
+#include <cuda_runtime.h>
+
+#include <benchmark/utils.h>
+#include <test/utils.h>
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+
+using namespace nvfuser;
+
+// Replays a stream of requests of varying sequence lengths through a single
+// FusionExecutorCache, like a model serving variable-length prompts. Each
+// iteration starts from a new FusionExecutorCache, so the latencies include
+// the compilation of every new runtime. Reported counters:
+//
+//   p50_ms, p99_ms, max_ms   latency of a request, from the run to the
+//                            completion of its kernels
+//   steady_requests_per_s    throughput of replaying the same stream again
+//                            once everything is compiled
+//   runtimes, concretizations
+//                            countRuntimes and countConcretizations after
+//                            the stream
+//   device_memory_growth     device memory held after the stream, e.g., by
+//                            loaded kernels, beyond what was held before it
+//   kernel_binary_bytes      size of the loaded kernel binaries
+//
+// The sequence lengths follow a log-normal distribution, as prompt lengths
+// of serving traces do. The argument is the shape bucket kind, see
+// [ Shape Buckets ]: 0 for none, 1 for powers of two and 2 for multiples of
+// 64. Fusions with dynamic reshapes aren't bucketed, so ReshapeSoftmax only
+// runs without buckets.
+
+namespace {
+
+constexpr int64_t kHidden = 1024;
+constexpr int64_t kRequests = 256;
+constexpr int64_t kMinSeq = 16;
+constexpr int64_t kMaxSeq = 2048;
+
+//! A deterministic stream of sequence lengths with a median of 256
+const std::vector<int64_t>& sequenceLengths() {
+  static const std::vector<int64_t> lengths = []() {
+    std::mt19937 gen(0);
+    std::lognormal_distribution<double> dist(std::log(256.0), 0.8);
+    std::vector<int64_t> lengths;
+    lengths.reserve(kRequests);
+    for (int64_t i = 0; i < kRequests; ++i) {
+      lengths.push_back(std::clamp((int64_t)dist(gen), kMinSeq, kMaxSeq));
+    }
+    return lengths;
+  }();
+  return lengths;
+}
+
+ShapeBuckets shapeBucketsArg(int64_t arg) {
+  switch (arg) {
+    case 1:
+      return {ShapeBuckets::Kind::PowerOfTwo};
+    case 2:
+      return {ShapeBuckets::Kind::Multiple, 64};
+    default:
+      return {};
+  }
+}
+
+// Layer norm over the hidden dimension of [seq, hidden] activations
+std::unique_ptr<Fusion> layerNormFusion() {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  TensorView* x = makeContigTensor(2, DataType::Half);
+  TensorView* weight = makeContigTensor(1, DataType::Half);
+  TensorView* bias = makeContigTensor(1, DataType::Half);
+  fusion->addInput(x);
+  fusion->addInput(weight);
+  fusion->addInput(bias);
+  auto ln = layer_norm(
+      castOp(DataType::Float, x),
+      1,
+      castOp(DataType::Float, weight),
+      castOp(DataType::Float, bias),
+      IrBuilder::create<Val>(1e-5));
+  fusion->addOutput(castOp(DataType::Half, ln.output));
+  return fusion;
+}
+
+std::vector<c10::IValue> layerNormInputs(int64_t seq) {
+  auto options = at::TensorOptions().dtype(at::kHalf).device(at::kCUDA, 0);
+  return {
+      at::randn({seq, kHidden}, options),
+      at::randn({kHidden}, options),
+      at::randn({kHidden}, options)};
+}
+
+// Splits [seq * hidden] into heads of 64 with a reshape of symbolic extents,
+// which is concretized for each new sequence length, and applies a softmax
+// over the heads of each token
+std::unique_ptr<Fusion> reshapeSoftmaxFusion() {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  TensorView* x = makeContigTensor(1, DataType::Half);
+  Val* seq = IrBuilder::create<Val>(DataType::Int);
+  fusion->addInput(x);
+  fusion->addInput(seq);
+  TensorView* y = reshape(
+      castOp(DataType::Float, x),
+      {seq,
+       IrBuilder::create<Val>(kHidden / 64),
+       IrBuilder::create<Val>((int64_t)64)});
+  y = softmax(y, 1);
+  fusion->addOutput(castOp(DataType::Half, y));
+  return fusion;
+}
+
+std::vector<c10::IValue> reshapeSoftmaxInputs(int64_t seq) {
+  auto options = at::TensorOptions().dtype(at::kHalf).device(at::kCUDA, 0);
+  return {at::randn({seq * kHidden}, options), seq};
+}
+
+size_t deviceMemoryInUse() {
+  c10::cuda::CUDACachingAllocator::emptyCache();
+  size_t free_bytes = 0;
+  size_t total_bytes = 0;
+  NVFUSER_CUDA_RT_SAFE_CALL(cudaMemGetInfo(&free_bytes, &total_bytes));
+  return total_bytes - free_bytes;
+}
+
+double percentile(std::vector<double> values, double p) {
+  std::sort(values.begin(), values.end());
+  const auto rank = (size_t)(p * (double)(values.size() - 1) + 0.5);
+  return values.at(rank);
+}
+
+void NvFuserScheduler_DynamicShapes(
+    benchmark::State& benchmark_state,
+    std::unique_ptr<Fusion> (*make_fusion)(),
+    std::vector<c10::IValue> (*make_inputs)(int64_t)) {
+  const std::vector<int64_t>& lengths = sequenceLengths();
+  std::unique_ptr<Fusion> fusion = make_fusion();
+
+  using Clock = std::chrono::steady_clock;
+  std::vector<double> latencies_ms;
+  std::unique_ptr<FusionExecutorCache> fec;
+  size_t memory_before = 0;
+
+  for (auto _ : benchmark_state) {
+    benchmark_state.PauseTiming();
+    fec.reset();
+    memory_before = deviceMemoryInUse();
+    fec = std::make_unique<FusionExecutorCache>(
+        std::make_unique<Fusion>(*fusion));
+    fec->setShapeBuckets(shapeBucketsArg(benchmark_state.range(0)));
+    latencies_ms.clear();
+    benchmark_state.ResumeTiming();
+
+    for (int64_t seq : lengths) {
+      benchmark_state.PauseTiming();
+      std::vector<c10::IValue> inputs = make_inputs(seq);
+      NVFUSER_CUDA_RT_SAFE_CALL(cudaDeviceSynchronize());
+      benchmark_state.ResumeTiming();
+
+      const auto start = Clock::now();
+      fec->runFusionWithInputs(inputs);
+      NVFUSER_CUDA_RT_SAFE_CALL(cudaDeviceSynchronize());
+      const std::chrono::duration<double, std::milli> latency =
+          Clock::now() - start;
+      latencies_ms.push_back(latency.count());
+    }
+  }
+
+  benchmark_state.counters["p50_ms"] = percentile(latencies_ms, 0.5);
+  benchmark_state.counters["p99_ms"] = percentile(latencies_ms, 0.99);
+  benchmark_state.counters["max_ms"] =
+      *std::max_element(latencies_ms.begin(), latencies_ms.end());
+  benchmark_state.counters["runtimes"] = (double)fec->countRuntimes();
+  benchmark_state.counters["concretizations"] =
+      (double)fec->countConcretizations();
+  benchmark_state.counters["device_memory_growth"] = benchmark::Counter(
+      (double)deviceMemoryInUse() - (double)memory_before,
+      benchmark::Counter::kDefaults,
+      benchmark::Counter::kIs1024);
+  benchmark_state.counters["kernel_binary_bytes"] = benchmark::Counter(
+      (double)fec->loadedModules().second,
+      benchmark::Counter::kDefaults,
+      benchmark::Counter::kIs1024);
+
+  // Replay the stream on the warm cache, with the inputs of each length
+  // made beforehand in groups so only the runs are timed
+  constexpr int64_t kGroup = 32;
+  double steady_s = 0.0;
+  for (size_t begin = 0; begin < lengths.size(); begin += kGroup) {
+    const size_t end = std::min(lengths.size(), begin + kGroup);
+    std::vector<std::vector<c10::IValue>> inputs;
+    for (size_t i = begin; i < end; ++i) {
+      inputs.push_back(make_inputs(lengths.at(i)));
+    }
+    NVFUSER_CUDA_RT_SAFE_CALL(cudaDeviceSynchronize());
+    const auto start = Clock::now();
+    for (const auto& request_inputs : inputs) {
+      fec->runFusionWithInputs(request_inputs);
+    }
+    NVFUSER_CUDA_RT_SAFE_CALL(cudaDeviceSynchronize());
+    const std::chrono::duration<double> elapsed = Clock::now() - start;
+    steady_s += elapsed.count();
+  }
+  benchmark_state.counters["steady_requests_per_s"] =
+      (double)lengths.size() / steady_s;
+}
+
+} // namespace
+
+BENCHMARK_CAPTURE(
+    NvFuserScheduler_DynamicShapes,
+    LayerNorm,
+    layerNormFusion,
+    layerNormInputs)
+    ->DenseRange(0, 2)
+    ->Unit(benchmark::kMillisecond)
+    ->Iterations(1);
+BENCHMARK_CAPTURE(
+    NvFuserScheduler_DynamicShapes,
+    ReshapeSoftmax,
+    reshapeSoftmaxFusion,
+    reshapeSoftmaxInputs)
+    ->Arg(0)
+    ->Unit(benchmark::kMillisecond)
+    ->Iterations(1);
@@ -176,7 +176,36 @@ static void NvFuserScheduler_LayerNormForward_HeuristicLookup(
   }
 }
 
+// Looks up the input id of a few different input sets that are reused, as a
+// FusionExecutorCache would for every call of runFusionWithInputs. The lookup
+// table is shared by all benchmark threads to measure contention.
+static void NvFuserScheduler_InputsIdLookup(benchmark::State& benchmark_state) {
+  static InputsIdLookup inputs_id_lookup;
+
+  // Only the metadata of the inputs is used, so there is no need to allocate
+  // them on the GPU. Each thread uses its own set of shapes.
+  const auto thread_offset = benchmark_state.thread_index() * 4;
+  std::vector<std::vector<c10::IValue>> inputs_list;
+  for (int64_t i = 0; i < 4; ++i) {
+    inputs_list.push_back(
+        {at::empty({20, 100, 35, 67 + thread_offset + i}),
+         at::empty({67 + thread_offset + i}),
+         at::empty({67 + thread_offset + i}),
+         1e-5});
+  }
+
+  size_t i = 0;
+  for (auto _ : benchmark_state) {
+    benchmark::DoNotOptimize(
+        inputs_id_lookup.lookupId(inputs_list.at(i++ % inputs_list.size())));
+  }
+}
+
 BENCHMARK(NvFuserScheduler_LayerNormBackward_HeuristicLookup)
     ->Unit(benchmark::kMicrosecond);
 BENCHMARK(NvFuserScheduler_LayerNormForward_HeuristicLookup)
     ->Unit(benchmark::kMicrosecond);
+BENCHMARK(NvFuserScheduler_InputsIdLookup)
+    ->Unit(benchmark::kNanosecond)
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
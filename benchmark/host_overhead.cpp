@@ -0,0 +1,235 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <csrc/exceptions.h>
+#include <executor_kernel_arg.h>
+#include <executor_utils.h>
+#include <fusion.h>
+#include <ir/all_nodes.h>
+#include <ir/builder.h>
+#include <kernel_cache.h>
+#include <ops/all_ops.h>
+
+#include <benchmark/benchmark.h>
+
+#include <cuda_runtime.h>
+
+#include <benchmark/utils.h>
+#include <test/utils.h>
+
+using namespace nvfuser;
+
+// Host time of each stage of running a fusion whose kernels are already
+// compiled and cached, on tiny inputs so the device time doesn't matter. The
+// stages are measured on their own where possible; the others are the
+// difference of two benchmarks:
+//
+//   InputsIdLookup      InputsIdLookup::lookupId
+//   PrepareInputs       KernelArgumentHolder creation + lookupId
+//   GetKernelRuntime    PrepareInputs + getKernelRuntimeFor
+//   BindInputs          ExpressionEvaluator binding of the fusion inputs
+//   KernelArguments     serializing the arguments of the first kernel
+//   RunWithInputs       ArgumentManager bookkeeping and the host work of the
+//                       executors of all segments, without launching
+//   RunFusion           the whole runFusionWithInputs, with launches
+//   RunFusionNoLaunch   the same without cuLaunchKernel
+//
+// Each is swept over the number of tensor inputs, segments and symbolic
+// scalar inputs.
+
+namespace {
+
+constexpr int64_t kNumel = 4;
+
+struct HostOverheadFusion {
+  std::unique_ptr<FusionExecutorCache> fec;
+  std::vector<c10::IValue> inputs;
+};
+
+// Adds num_inputs tensors, multiplies the sum with num_scalars scalars, and
+// separates num_segments segments with segment_set
+HostOverheadFusion makeHostOverheadFusion(
+    benchmark::State& benchmark_state) {
+  const int64_t num_inputs = benchmark_state.range(0);
+  const int64_t num_segments = benchmark_state.range(1);
+  const int64_t num_scalars = benchmark_state.range(2);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  HostOverheadFusion result;
+
+  TensorView* out = nullptr;
+  for (int64_t i = 0; i < num_inputs; ++i) {
+    TensorView* tv = makeContigTensor(1);
+    fusion->addInput(tv);
+    out = (out == nullptr) ? tv : add(out, tv);
+    result.inputs.emplace_back(at::randn({kNumel}, options));
+  }
+  for (int64_t i = 0; i < num_scalars; ++i) {
+    Val* s = IrBuilder::create<Val>(DataType::Double);
+    fusion->addInput(s);
+    out = mul(out, s);
+    result.inputs.emplace_back(1.0 + (double)i);
+  }
+  out = neg(out);
+  for (int64_t i = 1; i < num_segments; ++i) {
+    out = neg(segment_set(out));
+  }
+  fusion->addOutput(out);
+
+  result.fec = std::make_unique<FusionExecutorCache>(std::move(fusion));
+  result.fec->runFusionWithInputs(result.inputs);
+  return result;
+}
+
+void setHostOverheadCounters(
+    benchmark::State& benchmark_state,
+    const HostOverheadFusion& f) {
+  benchmark_state.counters["inputs"] = (double)benchmark_state.range(0);
+  benchmark_state.counters["segments"] =
+      (double)f.fec->getMostRecentKernelRuntime()->executors().size();
+  benchmark_state.counters["scalars"] = (double)benchmark_state.range(2);
+}
+
+void NvFuserScheduler_HostOverhead_InputsIdLookup(
+    benchmark::State& benchmark_state) {
+  HostOverheadFusion f = makeHostOverheadFusion(benchmark_state);
+  InputsIdLookup lookup;
+  lookup.lookupId(f.inputs);
+  for (auto _ : benchmark_state) {
+    benchmark::DoNotOptimize(lookup.lookupId(f.inputs));
+  }
+  setHostOverheadCounters(benchmark_state, f);
+}
+
+void NvFuserScheduler_HostOverhead_PrepareInputs(
+    benchmark::State& benchmark_state) {
+  HostOverheadFusion f = makeHostOverheadFusion(benchmark_state);
+  for (auto _ : benchmark_state) {
+    benchmark::DoNotOptimize(f.fec->prepareInputs(f.inputs));
+  }
+  setHostOverheadCounters(benchmark_state, f);
+}
+
+void NvFuserScheduler_HostOverhead_GetKernelRuntime(
+    benchmark::State& benchmark_state) {
+  HostOverheadFusion f = makeHostOverheadFusion(benchmark_state);
+  for (auto _ : benchmark_state) {
+    benchmark::DoNotOptimize(f.fec->isCompiled(f.inputs));
+  }
+  setHostOverheadCounters(benchmark_state, f);
+}
+
+void NvFuserScheduler_HostOverhead_BindInputs(
+    benchmark::State& benchmark_state) {
+  HostOverheadFusion f = makeHostOverheadFusion(benchmark_state);
+  KernelArgumentHolder args = f.fec->prepareInputs(f.inputs);
+  for (auto _ : benchmark_state) {
+    benchmark::DoNotOptimize(
+        executor_utils::bindInputs(args, f.fec->fusion()));
+  }
+  setHostOverheadCounters(benchmark_state, f);
+}
+
+void NvFuserScheduler_HostOverhead_KernelArguments(
+    benchmark::State& benchmark_state) {
+  HostOverheadFusion f = makeHostOverheadFusion(benchmark_state);
+  KernelArgumentHolder args = f.fec->prepareInputs(f.inputs);
+  kir::Kernel* kernel =
+      f.fec->getMostRecentKernelRuntime()->executors().front().kernel();
+  ExpressionEvaluator expr_eval = executor_utils::bindInputs(args, kernel);
+  // A pointwise kernel has no parameters but its inputs and outputs
+  for (Val* out : kernel->outputs()) {
+    expr_eval.bind(
+        out, at::empty({kNumel}, f.inputs.front().toTensor().options()));
+  }
+  for (auto _ : benchmark_state) {
+    std::vector<std::vector<std::byte>> arg_buffers;
+    arg_buffers.reserve(kernel->parameters().size());
+    for (Val* v : kernel->parameters()) {
+      arg_buffers.emplace_back(
+          getKernelArgument(expr_eval, v, kernel->indexType()));
+    }
+    benchmark::DoNotOptimize(arg_buffers);
+  }
+  setHostOverheadCounters(benchmark_state, f);
+}
+
+void NvFuserScheduler_HostOverhead_RunWithInputs(
+    benchmark::State& benchmark_state) {
+  HostOverheadFusion f = makeHostOverheadFusion(benchmark_state);
+  f.fec->disableKernelLaunch();
+  FusionKernelRuntime* runtime = f.fec->getMostRecentKernelRuntime();
+  KernelArgumentHolder args = f.fec->prepareInputs(f.inputs);
+  for (auto _ : benchmark_state) {
+    benchmark::DoNotOptimize(runtime->runWithInputs(args));
+  }
+  setHostOverheadCounters(benchmark_state, f);
+}
+
+void NvFuserScheduler_HostOverhead_RunFusion(
+    benchmark::State& benchmark_state) {
+  HostOverheadFusion f = makeHostOverheadFusion(benchmark_state);
+  for (auto _ : benchmark_state) {
+    benchmark::DoNotOptimize(f.fec->runFusionWithInputs(f.inputs));
+  }
+  // Don't let the queued kernels run into the next benchmark
+  cudaDeviceSynchronize();
+  setHostOverheadCounters(benchmark_state, f);
+}
+
+void NvFuserScheduler_HostOverhead_RunFusionNoLaunch(
+    benchmark::State& benchmark_state) {
+  HostOverheadFusion f = makeHostOverheadFusion(benchmark_state);
+  f.fec->disableKernelLaunch();
+  for (auto _ : benchmark_state) {
+    benchmark::DoNotOptimize(f.fec->runFusionWithInputs(f.inputs));
+  }
+  setHostOverheadCounters(benchmark_state, f);
+}
+
+// {inputs, segments, scalars}
+void addHostOverheadArgs(benchmark::internal::Benchmark* b) {
+  for (int64_t inputs : {1, 4, 16, 64}) {
+    b->Args({inputs, 1, 0});
+  }
+  for (int64_t segments : {2, 4, 8}) {
+    b->Args({4, segments, 0});
+  }
+  for (int64_t scalars : {4, 16, 64}) {
+    b->Args({4, 1, scalars});
+  }
+}
+
+} // namespace
+
+BENCHMARK(NvFuserScheduler_HostOverhead_InputsIdLookup)
+    ->Apply(addHostOverheadArgs)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(NvFuserScheduler_HostOverhead_PrepareInputs)
+    ->Apply(addHostOverheadArgs)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(NvFuserScheduler_HostOverhead_GetKernelRuntime)
+    ->Apply(addHostOverheadArgs)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(NvFuserScheduler_HostOverhead_BindInputs)
+    ->Apply(addHostOverheadArgs)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(NvFuserScheduler_HostOverhead_KernelArguments)
+    ->Apply(addHostOverheadArgs)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(NvFuserScheduler_HostOverhead_RunWithInputs)
+    ->Apply(addHostOverheadArgs)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(NvFuserScheduler_HostOverhead_RunFusion)
+    ->Apply(addHostOverheadArgs)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(NvFuserScheduler_HostOverhead_RunFusionNoLaunch)
+    ->Apply(addHostOverheadArgs)
+    ->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,112 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <csrc/exceptions.h>
+#include <compute_at_map.h>
+#include <fusion.h>
+#include <id_model/id_model.h>
+#include <ir/all_nodes.h>
+#include <ir/builder.h>
+#include <ir/utils.h>
+#include <ops/all_ops.h>
+#include <scheduler/registry_utils.h>
+
+#include <benchmark/benchmark.h>
+
+#include <benchmark/utils.h>
+#include <test/utils.h>
+
+using namespace nvfuser;
+
+// Builds the IterDomain graphs of fusions of the size of the timm
+// benchmarks or larger, and copies them as FusionExecutorCache does for
+// every concretization. Only the graphs are built, so no GPU is needed.
+
+namespace {
+
+// A stack of normalization-like blocks on [N, C, H, W] tensors, each of which
+// adds about 24 IterDomains
+std::unique_ptr<Fusion> makeNormBlocks(int64_t num_blocks) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  TensorView* x = makeSymbolicTensor(4);
+  TensorView* weight = makeSymbolicTensor(1);
+  fusion->addInput(x);
+  fusion->addInput(weight);
+  TensorView* bcast_weight = broadcast(weight, {true, false, true, true});
+
+  for (int64_t i = 0; i < num_blocks; ++i) {
+    TensorView* mean = broadcast(sum(x, {1}), {false, true, false, false});
+    TensorView* centered = sub(x, mean);
+    TensorView* scaled = mul(centered, bcast_weight);
+    x = add(relu(scaled), x);
+  }
+  fusion->addOutput(x);
+  return fusion;
+}
+
+void setIterDomainCounter(benchmark::State& benchmark_state, Fusion* fusion) {
+  benchmark_state.counters["iter_domains"] =
+      (double)ir_utils::filterByType<IterDomain>(fusion->vals()).size();
+}
+
+void NvFuserScheduler_ComputeAtMap(benchmark::State& benchmark_state) {
+  auto fusion = makeNormBlocks(benchmark_state.range(0));
+  for (auto _ : benchmark_state) {
+    ComputeAtMap ca_map(fusion.get());
+    benchmark::DoNotOptimize(ca_map);
+  }
+  setIterDomainCounter(benchmark_state, fusion.get());
+}
+
+void NvFuserScheduler_IdModel(benchmark::State& benchmark_state) {
+  auto fusion = makeNormBlocks(benchmark_state.range(0));
+  for (auto _ : benchmark_state) {
+    IdModel id_model(fusion.get());
+    benchmark::DoNotOptimize(id_model);
+  }
+  setIterDomainCounter(benchmark_state, fusion.get());
+}
+
+void NvFuserScheduler_IsConnectedFusionGraph(
+    benchmark::State& benchmark_state) {
+  auto fusion = makeNormBlocks(benchmark_state.range(0));
+  for (auto _ : benchmark_state) {
+    benchmark::DoNotOptimize(
+        registry_utils::isConnectedFusionGraph(fusion.get()));
+  }
+  setIterDomainCounter(benchmark_state, fusion.get());
+}
+
+void NvFuserScheduler_FusionCopy(benchmark::State& benchmark_state) {
+  auto fusion = makeNormBlocks(benchmark_state.range(0));
+  for (auto _ : benchmark_state) {
+    Fusion copy(*fusion);
+    benchmark::DoNotOptimize(copy);
+  }
+  setIterDomainCounter(benchmark_state, fusion.get());
+}
+
+} // namespace
+
+BENCHMARK(NvFuserScheduler_ComputeAtMap)
+    ->RangeMultiplier(4)
+    ->Range(16, 256)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(NvFuserScheduler_IdModel)
+    ->RangeMultiplier(4)
+    ->Range(16, 256)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(NvFuserScheduler_IsConnectedFusionGraph)
+    ->RangeMultiplier(4)
+    ->Range(16, 256)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(NvFuserScheduler_FusionCopy)
+    ->RangeMultiplier(4)
+    ->Range(16, 256)
+    ->Unit(benchmark::kMicrosecond);
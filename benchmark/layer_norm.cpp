@@ -26,6 +26,11 @@ using namespace nvfuser;
 
 //------------------------------------------------------------------------------
 
+// The sum of the mean; the subtraction, square and sum of the variance; and
+// the subtraction, multiplication by the inverse standard deviation and the
+// affine multiplication and addition
+constexpr int64_t kLayerNormFlopsPerElement = 8;
+
 static void setupLayerNorm(Fusion* fusion, DataType dtype) {
   NVF_ERROR(dtype == DataType::Float || dtype == DataType::Half);
 
@@ -84,7 +89,10 @@ static void NvFuserScheduler_LayerNorm(
 
   std::vector<c10::IValue> aten_inputs({input, weight, bias});
 
-  runBenchmarkIterations(benchmark_state, fusion_executor_cache, aten_inputs);
+  int64_t io_bytes = runBenchmarkIterations(
+      benchmark_state, fusion_executor_cache, aten_inputs);
+  setRooflineCounters(
+      benchmark_state, io_bytes, kLayerNormFlopsPerElement * input.numel());
 
   benchmark_state.SetBytesProcessed(
       int64_t(benchmark_state.iterations()) *
@@ -162,7 +170,10 @@ static void NvFuserScheduler_TIMM_LayerNorm(
 
   std::vector<c10::IValue> aten_inputs({input, weight, bias});
 
-  runBenchmarkIterations(benchmark_state, fusion_executor_cache, aten_inputs);
+  int64_t io_bytes = runBenchmarkIterations(
+      benchmark_state, fusion_executor_cache, aten_inputs);
+  setRooflineCounters(
+      benchmark_state, io_bytes, kLayerNormFlopsPerElement * input.numel());
 
   benchmark_state.SetBytesProcessed(
       int64_t(benchmark_state.iterations()) *
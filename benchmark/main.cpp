@@ -62,6 +62,13 @@ void addGPUBenchmarkContext() {
       std::to_string(prop.maxThreadsPerMultiProcessor));
   ::benchmark::AddCustomContext(
       "gpu_max_threads_per_block", std::to_string(prop.maxThreadsPerBlock));
+  // The roofs of tools/roofline.py
+  ::benchmark::AddCustomContext(
+      "gpu_peak_bandwidth_gbps", std::to_string(getPeakBandwidth() / 1e9));
+  ::benchmark::AddCustomContext(
+      "gpu_peak_fp32_tflops", std::to_string(getPeakFlops(false) / 1e12));
+  ::benchmark::AddCustomContext(
+      "gpu_peak_tensor_tflops", std::to_string(getPeakFlops(true) / 1e12));
 }
 
 } // namespace
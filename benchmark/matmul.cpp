@@ -190,9 +190,9 @@ static void SingleMatmulBase(
   auto outputs = fe.runFusion(aten_inputs);
   checkMatch(expected_output, outputs.at(0).to(at::kDouble), k);
 
-  runBenchmarkIterations(benchmark_state, &fe, aten_inputs);
-
-  // TODO: FLOPS calculation
+  int64_t io_bytes = runBenchmarkIterations(benchmark_state, &fe, aten_inputs);
+  setRooflineCounters(
+      benchmark_state, io_bytes, 2 * m * n * k, /*use_tensor_cores=*/true);
 }
 
 static void Baseline_Matmul(
@@ -358,9 +358,9 @@ static void SingleMatmulPartitionedK(
 
   checkMatch(expected_output, outputs.at(0).to(at::kDouble), Ki);
 
-  runBenchmarkIterations(benchmark_state, &fe, aten_inputs);
-
-  // TODO: FLOPS calculation
+  int64_t io_bytes = runBenchmarkIterations(benchmark_state, &fe, aten_inputs);
+  setRooflineCounters(
+      benchmark_state, io_bytes, 2 * M * N * K, /*use_tensor_cores=*/true);
 }
 
 static void NvFuserScheduler_Matmul(
@@ -459,9 +459,9 @@ static void NvFuserScheduler_MatmulSplitKReduction(
 
   checkMatch(expected_output, outputs.at(0).to(at::kDouble), splitk_factor);
 
-  runBenchmarkIterations(benchmark_state, &fe, aten_inputs, lparams);
-
-  // TODO: FLOPS calculation
+  int64_t io_bytes =
+      runBenchmarkIterations(benchmark_state, &fe, aten_inputs, lparams);
+  setRooflineCounters(benchmark_state, io_bytes, M * N * splitk_factor);
 }
 // ----------------------------- Benchmark Instantiation-------
 
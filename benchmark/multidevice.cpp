@@ -0,0 +1,396 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#ifdef USE_DISTRIBUTED
+#include <csrc/exceptions.h>
+#include <fusion.h>
+#include <ir/all_nodes.h>
+#include <multidevice/communication.h>
+#include <multidevice/communicator.h>
+#include <multidevice/pipeline.h>
+#include <multidevice/runtime.h>
+#include <multidevice/utils.h>
+#include <ops/all_ops.h>
+
+#include <ATen/cuda/CUDAContext.h>
+#include <benchmark/benchmark.h>
+
+#include <benchmark/utils.h>
+#include <test/utils.h>
+
+#include <chrono>
+#include <numeric>
+
+using namespace nvfuser;
+
+// These benchmarks must be launched on several processes, one per GPU, e.g.:
+//   mpirun -np 8 build/nvfuser_bench --benchmark_filter=NvFuserMultiDevice
+// Every process runs every benchmark, as they all take part in the
+// communications. The benchmarks over fewer devices than processes are only
+// run by the first devices, and the results to compare with
+// tools/compare_benchmark.py are the ones of process 0.
+
+namespace {
+
+Communicator& getCommunicator() {
+  static Communicator communicator;
+  return communicator;
+}
+
+// Returns whether the current process takes part in a benchmark over
+// num_devices devices, and skips the benchmark otherwise
+bool setUpDevices(benchmark::State& benchmark_state, int64_t num_devices) {
+  Communicator& comm = getCommunicator();
+  if (!comm.is_available() || comm.size() < num_devices) {
+    benchmark_state.SkipWithError("Not enough devices");
+    return false;
+  }
+  if (comm.deviceId() >= num_devices) {
+    benchmark_state.SkipWithError("Device not in the mesh");
+    return false;
+  }
+  at::cuda::set_device(comm.device().index());
+  return true;
+}
+
+DeviceMesh getMesh(int64_t num_devices) {
+  std::vector<DeviceIdxType> devices(num_devices);
+  std::iota(devices.begin(), devices.end(), 0);
+  return DeviceMesh(devices);
+}
+
+// Every device of a benchmark must run the same number of iterations, as they
+// synchronize at each of them
+constexpr int64_t kIterations = 50;
+
+// Times fn on the current device once every device of the team is ready
+template <typename Fn>
+double timeOnDevices(Fn fn) {
+  c10::cuda::getCurrentCUDAStream().synchronize();
+  auto start = std::chrono::steady_clock::now();
+  fn();
+  c10::cuda::getCurrentCUDAStream().synchronize();
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return elapsed.count();
+}
+
+// Blocks until every device of the first num_devices has reached it
+void barrier(int64_t num_devices) {
+  getCommunicator()
+      .getBackendForTeam(getMesh(num_devices).vector(), std::nullopt)
+      ->barrier()
+      ->wait();
+}
+
+enum class CollectiveType { Allgather, Allreduce, ReduceScatter };
+
+} // namespace
+
+//------------------------------------------------------------------------------
+
+// Reports the bus bandwidth of a collective over all devices, as defined by
+// nccl-tests: the bandwidth of the links between the devices that the
+// collective achieves, independently of the number of devices
+static void NvFuserMultiDevice_Collective(
+    benchmark::State& benchmark_state,
+    CollectiveType type) {
+  const int64_t num_devices = benchmark_state.range(0);
+  const int64_t bytes = benchmark_state.range(1);
+  if (!setUpDevices(benchmark_state, num_devices)) {
+    return;
+  }
+  Communicator& comm = getCommunicator();
+  auto options = at::TensorOptions().dtype(at::kFloat).device(comm.device());
+  const int64_t numel = bytes / (int64_t)sizeof(float);
+  const int64_t shard_numel = numel / num_devices;
+
+  CommParams params;
+  params.team = getMesh(num_devices).vector();
+  params.redOp = c10d::ReduceOp::RedOpType::SUM;
+  std::shared_ptr<Communication> communication;
+  double bus_factor = 0.0;
+  switch (type) {
+    case CollectiveType::Allgather:
+      params.src_bufs = {at::randn({shard_numel}, options)};
+      for (auto i : c10::irange(num_devices)) {
+        (void)i;
+        params.dst_bufs.push_back(at::empty({shard_numel}, options));
+      }
+      communication = std::make_shared<Allgather>(params);
+      bus_factor = (double)(num_devices - 1) / (double)num_devices;
+      break;
+    case CollectiveType::Allreduce:
+      params.src_bufs = {at::randn({numel}, options)};
+      params.dst_bufs = {at::empty({numel}, options)};
+      communication = std::make_shared<Allreduce>(params);
+      bus_factor = 2.0 * (double)(num_devices - 1) / (double)num_devices;
+      break;
+    case CollectiveType::ReduceScatter:
+      for (auto i : c10::irange(num_devices)) {
+        (void)i;
+        params.src_bufs.push_back(at::randn({shard_numel}, options));
+      }
+      params.dst_bufs = {at::empty({shard_numel}, options)};
+      communication = std::make_shared<ReduceScatter>(params);
+      bus_factor = (double)(num_devices - 1) / (double)num_devices;
+      break;
+  }
+
+  // Warm up, which also creates the backend of the team
+  communication->post(comm)->wait();
+
+  double total_time = 0.0;
+  for (auto _ : benchmark_state) {
+    barrier(num_devices);
+    const double elapsed =
+        timeOnDevices([&]() { communication->post(comm)->wait(); });
+    benchmark_state.SetIterationTime(elapsed);
+    total_time += elapsed;
+  }
+
+  const double iterations = (double)benchmark_state.iterations();
+  benchmark_state.SetBytesProcessed(benchmark_state.iterations() * bytes);
+  benchmark_state.counters["bus_bandwidth_GBps"] =
+      (double)bytes * bus_factor * iterations / total_time / 1e9;
+}
+
+//------------------------------------------------------------------------------
+
+namespace {
+
+// Runs the pipeline and reports its time per run. If num_micro_batches is
+// greater than one, also reports the overlap efficiency: the speedup of the
+// micro-batched run over a run on a single batch, relative to the speedup of
+// an ideal pipeline of num_stages stages, whose bubbles account for
+// (num_stages - 1) / (num_micro_batches + num_stages - 1) of the time.
+void runPipelineBenchmark(
+    benchmark::State& benchmark_state,
+    std::unique_ptr<Fusion> fusion,
+    std::vector<c10::IValue> inputs,
+    int64_t num_devices,
+    int64_t num_stages = 1,
+    int64_t num_micro_batches = 1) {
+  Communicator& comm = getCommunicator();
+  Pipeline pipeline(fusion.get(), inferPipelineDescriptor(fusion.get()));
+  MultiDeviceRuntime runtime(&pipeline, comm);
+  auto error_msg = runtime.validate();
+  if (!error_msg.empty()) {
+    benchmark_state.SkipWithError(error_msg.c_str());
+    return;
+  }
+
+  // Warm up, which compiles the stages
+  runtime.runWithInput(inputs, num_micro_batches);
+  double single_batch_time = 0.0;
+  if (num_micro_batches > 1) {
+    runtime.runWithInput(inputs);
+    barrier(num_devices);
+    single_batch_time = timeOnDevices([&]() { runtime.runWithInput(inputs); });
+  }
+
+  double total_time = 0.0;
+  for (auto _ : benchmark_state) {
+    barrier(num_devices);
+    const double elapsed = timeOnDevices(
+        [&]() { runtime.runWithInput(inputs, num_micro_batches); });
+    benchmark_state.SetIterationTime(elapsed);
+    total_time += elapsed;
+  }
+
+  if (num_micro_batches > 1) {
+    const double time = total_time / (double)benchmark_state.iterations();
+    const double ideal_speedup = (double)(num_stages * num_micro_batches) /
+        (double)(num_micro_batches + num_stages - 1);
+    benchmark_state.counters["overlap_efficiency"] =
+        single_batch_time / time / ideal_speedup;
+  }
+}
+
+} // namespace
+
+// Row-parallel MLP of Megatron: each device multiplies its shard of the
+// hidden activations [tokens, hidden / devices] by its shard of the weights
+// [hidden / devices, hidden], and the partial products are allreduced before
+// the activation
+static void NvFuserMultiDevice_TensorParallelMlp(
+    benchmark::State& benchmark_state) {
+  const int64_t num_devices = benchmark_state.range(0);
+  const int64_t tokens = benchmark_state.range(1);
+  const int64_t hidden = benchmark_state.range(2);
+  if (!setUpDevices(benchmark_state, num_devices)) {
+    return;
+  }
+  const DeviceMesh mesh = getMesh(num_devices);
+  const int64_t shard = hidden / num_devices;
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  TensorView* x = makeContigTensor(3);
+  TensorView* w = makeContigTensor(3);
+  fusion->addInput(x);
+  fusion->addInput(w);
+  // [devices, tokens, shard, b] * [devices, b, shard, hidden]
+  TensorView* product = mul(
+      broadcast(x, {false, false, false, true}),
+      broadcast(w, {false, true, false, false}));
+  TensorView* partial = sum(product, {2});
+  TensorView* y = sum(partial, {0});
+  TensorView* out = gelu(y);
+  fusion->addOutput(out);
+  for (auto tv : {x, w}) {
+    tv->setDeviceMesh(mesh);
+    tv->axis(0)->parallelize(ParallelType::DIDx);
+  }
+  propagateShardings(fusion.get());
+
+  auto options =
+      at::TensorOptions().dtype(at::kFloat).device(getCommunicator().device());
+  std::vector<c10::IValue> inputs = {
+      at::randn({num_devices, tokens, shard}, options),
+      at::randn({num_devices, shard, hidden}, options)};
+  runPipelineBenchmark(
+      benchmark_state, std::move(fusion), inputs, num_devices);
+}
+
+// Layer norm of the shards of a sequence [sequence / devices, hidden]
+// followed by the allgather of the normalized sequence
+static void NvFuserMultiDevice_SequenceParallelLayerNorm(
+    benchmark::State& benchmark_state) {
+  const int64_t num_devices = benchmark_state.range(0);
+  const int64_t sequence = benchmark_state.range(1);
+  const int64_t hidden = benchmark_state.range(2);
+  if (!setUpDevices(benchmark_state, num_devices)) {
+    return;
+  }
+  const DeviceMesh mesh = getMesh(num_devices);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  TensorView* x = makeContigTensor(3);
+  fusion->addInput(x);
+  TensorView* normalized = layer_norm(
+                               x,
+                               /*kNormShapeNumDims=*/1,
+                               nullptr,
+                               nullptr,
+                               IrBuilder::create<Val>(1e-5))
+                               .output;
+  TensorView* gathered = set(normalized);
+  fusion->addOutput(gathered);
+  x->setDeviceMesh(mesh);
+  x->axis(0)->parallelize(ParallelType::DIDx);
+  propagateShardings(fusion.get());
+  // The output is replicated
+  gathered->axis(0)->parallelize(ParallelType::Serial);
+
+  auto options =
+      at::TensorOptions().dtype(at::kFloat).device(getCommunicator().device());
+  std::vector<c10::IValue> inputs = {
+      at::randn({num_devices, sequence / num_devices, hidden}, options)};
+  runPipelineBenchmark(
+      benchmark_state, std::move(fusion), inputs, num_devices);
+}
+
+// Blocks of a layer norm, an activation and a residual, each block on its own
+// device, run on micro-batches. The blocks take no weights, as every global
+// input of a pipeline is split into the micro-batches, see
+// [ Micro-batching ].
+static void NvFuserMultiDevice_PipelineParallelBlocks(
+    benchmark::State& benchmark_state) {
+  const int64_t num_devices = benchmark_state.range(0);
+  const int64_t tokens = benchmark_state.range(1);
+  const int64_t hidden = benchmark_state.range(2);
+  const int64_t num_micro_batches = benchmark_state.range(3);
+  if (!setUpDevices(benchmark_state, num_devices)) {
+    return;
+  }
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  TensorView* x = makeContigTensor(2);
+  fusion->addInput(x);
+  x->setDeviceMesh(DeviceMesh({0}));
+  TensorView* act = x;
+  for (auto block : c10::irange(num_devices)) {
+    if (block > 0) {
+      // The activations are sent to the device of the next block
+      act = set(act);
+      act->setDeviceMesh(DeviceMesh({(DeviceIdxType)block}));
+    }
+    TensorView* normalized = layer_norm(
+                                 act,
+                                 /*kNormShapeNumDims=*/1,
+                                 nullptr,
+                                 nullptr,
+                                 IrBuilder::create<Val>(1e-5))
+                                 .output;
+    act = add(act, gelu(normalized));
+  }
+  fusion->addOutput(act);
+  propagateShardings(fusion.get());
+
+  auto options =
+      at::TensorOptions().dtype(at::kFloat).device(getCommunicator().device());
+  std::vector<c10::IValue> inputs = {at::randn({tokens, hidden}, options)};
+  runPipelineBenchmark(
+      benchmark_state,
+      std::move(fusion),
+      inputs,
+      num_devices,
+      /*num_stages=*/num_devices,
+      num_micro_batches);
+}
+
+//------------------------------------------------------------------------------
+
+BENCHMARK_CAPTURE(
+    NvFuserMultiDevice_Collective,
+    Allgather,
+    CollectiveType::Allgather)
+    ->ArgsProduct({{2, 4, 8}, benchmark::CreateRange(1 << 16, 1 << 28, 16)})
+    ->Iterations(kIterations)
+    ->Unit(benchmark::kMicrosecond)
+    ->UseManualTime();
+
+BENCHMARK_CAPTURE(
+    NvFuserMultiDevice_Collective,
+    Allreduce,
+    CollectiveType::Allreduce)
+    ->ArgsProduct({{2, 4, 8}, benchmark::CreateRange(1 << 16, 1 << 28, 16)})
+    ->Iterations(kIterations)
+    ->Unit(benchmark::kMicrosecond)
+    ->UseManualTime();
+
+BENCHMARK_CAPTURE(
+    NvFuserMultiDevice_Collective,
+    ReduceScatter,
+    CollectiveType::ReduceScatter)
+    ->ArgsProduct({{2, 4, 8}, benchmark::CreateRange(1 << 16, 1 << 28, 16)})
+    ->Iterations(kIterations)
+    ->Unit(benchmark::kMicrosecond)
+    ->UseManualTime();
+
+BENCHMARK(NvFuserMultiDevice_TensorParallelMlp)
+    ->ArgsProduct({{2, 4, 8}, {2048}, {1024, 4096}})
+    ->Iterations(kIterations)
+    ->Unit(benchmark::kMicrosecond)
+    ->UseManualTime();
+
+BENCHMARK(NvFuserMultiDevice_SequenceParallelLayerNorm)
+    ->ArgsProduct({{2, 4, 8}, {2048, 8192}, {1024, 4096}})
+    ->Iterations(kIterations)
+    ->Unit(benchmark::kMicrosecond)
+    ->UseManualTime();
+
+BENCHMARK(NvFuserMultiDevice_PipelineParallelBlocks)
+    ->ArgsProduct({{2, 4, 8}, {8192}, {1024}, {1, 4, 8}})
+    ->Iterations(kIterations)
+    ->Unit(benchmark::kMicrosecond)
+    ->UseManualTime();
+
+#endif
@@ -26,6 +26,10 @@ using namespace nvfuser;
 
 //------------------------------------------------------------------------------
 
+// The square and sum of the mean square, and the multiplications by the
+// inverse root mean square and the weight
+constexpr int64_t kRMSNormFlopsPerElement = 4;
+
 static void setupRMSNorm(Fusion* fusion, DataType dtype) {
   NVF_ERROR(
       dtype == DataType::Float || dtype == DataType::Half ||
@@ -80,7 +84,10 @@ static void NvFuserScheduler_RMSNorm(
 
   std::vector<c10::IValue> aten_inputs({input, weight});
 
-  runBenchmarkIterations(benchmark_state, fusion_executor_cache, aten_inputs);
+  int64_t io_bytes = runBenchmarkIterations(
+      benchmark_state, fusion_executor_cache, aten_inputs);
+  setRooflineCounters(
+      benchmark_state, io_bytes, kRMSNormFlopsPerElement * input.numel());
 
   benchmark_state.SetBytesProcessed(
       int64_t(benchmark_state.iterations()) *
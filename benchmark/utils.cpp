@@ -163,6 +163,54 @@ int64_t getSizeOfOutputs(const std::vector<at::Tensor>& outputs) {
 }
 } // namespace
 
+double getPeakBandwidth() {
+  auto properties = at::cuda::getCurrentDeviceProperties();
+  // Double data rate
+  return 2.0 * properties->memoryClockRate * 1e3 *
+      (properties->memoryBusWidth / 8.0);
+}
+
+double getPeakFlops(bool use_tensor_cores) {
+  auto properties = at::cuda::getCurrentDeviceProperties();
+  const int64_t arch = properties->major * 10 + properties->minor;
+  // Dense FLOPs per cycle per SM, counting an FMA as two
+  int64_t flops_per_cycle = 0;
+  if (use_tensor_cores) {
+    if (arch >= 90) {
+      flops_per_cycle = 4096;
+    } else if (arch == 80) {
+      flops_per_cycle = 2048;
+    } else if (arch >= 70) {
+      flops_per_cycle = 1024;
+    }
+  } else {
+    flops_per_cycle = (arch >= 86) ? 256 : 128;
+  }
+  return (double)flops_per_cycle * properties->multiProcessorCount *
+      properties->clockRate * 1e3;
+}
+
+void setRooflineCounters(
+    benchmark::State& benchmark_state,
+    int64_t bytes,
+    int64_t flops,
+    bool use_tensor_cores) {
+  benchmark_state.counters["bytes"] = (double)bytes;
+  // As rates, the percentages are divided by the time of an iteration
+  benchmark_state.counters["peak_bandwidth_pct"] = benchmark::Counter(
+      100.0 * (double)bytes / getPeakBandwidth(),
+      benchmark::Counter::kIsIterationInvariantRate);
+  if (flops == 0) {
+    return;
+  }
+  benchmark_state.counters["flops"] = (double)flops;
+  benchmark_state.counters["arithmetic_intensity"] =
+      (double)flops / (double)bytes;
+  benchmark_state.counters["peak_flops_pct"] = benchmark::Counter(
+      100.0 * (double)flops / getPeakFlops(use_tensor_cores),
+      benchmark::Counter::kIsIterationInvariantRate);
+}
+
 int64_t runBenchmarkIterations(
     benchmark::State& benchmark_state,
     FusionExecutorCache* fusion_executor_cache,
@@ -223,6 +271,7 @@ int64_t runBenchmarkIterations(
   // cpu while benchmarking.
   NVFUSER_CUDA_RT_SAFE_CALL(cudaDeviceSynchronize());
 
+  setRooflineCounters(benchmark_state, io_bytes);
   return io_bytes;
 }
 
@@ -259,6 +308,7 @@ int64_t runBenchmarkIterations(
   // cpu while benchmarking.
   NVFUSER_CUDA_RT_SAFE_CALL(cudaDeviceSynchronize());
 
+  setRooflineCounters(benchmark_state, io_bytes);
   return io_bytes;
 }
 
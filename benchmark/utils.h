@@ -53,6 +53,26 @@ int64_t runBenchmarkIterations(
     const LaunchParams& launch_constraints = LaunchParams(),
     CompileParams compile_params = CompileParams());
 
+//! Peak DRAM bandwidth of the current device in bytes per second
+double getPeakBandwidth();
+
+//! Peak dense throughput of the current device in FLOPs per second, of the
+//! tensor cores in half precision if use_tensor_cores, or else of the FP32 FMA
+//! units. Estimated from the SM count and clock of the device properties and
+//! the per-SM throughput of its architecture.
+double getPeakFlops(bool use_tensor_cores);
+
+//! Report the roofline of a benchmark that moves bytes to and from DRAM and
+//! computes flops in each iteration: the bytes and FLOPs per iteration,
+//! their ratio, and the achieved percentages of getPeakBandwidth and
+//! getPeakFlops. runBenchmarkIterations reports the bytes of the inputs and
+//! outputs; benchmarks that count FLOPs report them again with the FLOPs.
+void setRooflineCounters(
+    benchmark::State& benchmark_state,
+    int64_t bytes,
+    int64_t flops = 0,
+    bool use_tensor_cores = false);
+
 void addCasesOneWave128To32K(benchmark::internal::Benchmark* b);
 void addCases16Wave128To32K(benchmark::internal::Benchmark* b);
 
@@ -5,7 +5,9 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 // clang-format on
+#include <algorithm>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include <alias_analysis.h>
@@ -36,6 +38,7 @@ class AliasFinder : public OptOutConstDispatch {
   void handle(const SliceOp*) override;
   void handle(const BroadcastOp*) override;
   void handle(const SqueezeOp*) override;
+  void handle(const ExpandOp*) override;
 
  private:
   // A helper function used to compute the perferred output layout. It computes
@@ -372,6 +375,25 @@ void AliasFinder::handle(const SqueezeOp* squeeze) {
   analysis_.add(out, in, std::move(*out_layout));
 }
 
+void AliasFinder::handle(const ExpandOp* expand) {
+  TensorView* in = dynamic_cast<TensorView*>(expand->in());
+  if (in == nullptr) {
+    return;
+  }
+  auto* out = expand->out()->as<TensorView>();
+
+  // Preserve the allocation order of existing dimensions. An expanded
+  // dimension maps to a broadcast dimension of `in`, so it stays where it is
+  // and gets a stride of 0 instead of being materialized.
+  std::optional<Layout> out_layout =
+      mapInLayoutToOutRoot(analysis_.preferredLayout(in), in, out);
+  if (!out_layout.has_value()) {
+    return;
+  }
+
+  analysis_.add(out, in, std::move(*out_layout));
+}
+
 } // namespace
 
 void AliasAnalysisResult::add(
@@ -485,6 +507,120 @@ AliasAnalysisResult findAliases(
   return analysis;
 }
 
+void validateInplaceUpdate(
+    TensorView* out,
+    TensorView* in,
+    const std::vector<Expr*>& exprs) {
+  // Maps each tensor computed from `in` to the IterDomains carrying the axes
+  // of `in`
+  std::unordered_map<TensorView*, std::vector<IterDomain*>> in_axes;
+  in_axes.emplace(in, TensorDomain::noReductions(in->getMaybeRFactorDomain()));
+
+  for (Expr* expr : exprs) {
+    for (auto* producer : ir_utils::filterByType<TensorView>(expr->inputs())) {
+      auto producer_it = in_axes.find(producer);
+      if (producer_it == in_axes.end()) {
+        continue;
+      }
+      NVF_CHECK(
+          !expr->isOneOf<TorchGatherOp, IndexSelectOp, ScatterOp, SelectOp>(),
+          "Can't update ",
+          in->toString(),
+          " in place because it's gathered or scattered by ",
+          expr->toString());
+
+      for (auto* consumer :
+           ir_utils::filterByType<TensorView>(expr->outputs())) {
+        const std::unordered_map<IterDomain*, IterDomain*> p2c =
+            PairwiseRootDomainMap(producer, consumer).mapProducerToConsumer();
+        const std::vector<IterDomain*>& consumer_rfactor =
+            consumer->getMaybeRFactorDomain();
+        std::vector<IterDomain*> consumer_axes;
+        consumer_axes.reserve(producer_it->second.size());
+        auto last_pos = consumer_rfactor.begin();
+        for (IterDomain* producer_id : producer_it->second) {
+          auto it = p2c.find(producer_id);
+          IterDomain* consumer_id = it == p2c.end() ? nullptr : it->second;
+          auto pos = std::find(last_pos, consumer_rfactor.end(), consumer_id);
+          NVF_CHECK(
+              consumer_id != nullptr && !consumer_id->isReduction() &&
+                  (consumer_id->isBroadcast() || !producer_id->isBroadcast()) &&
+                  pos != consumer_rfactor.end(),
+              "Can't update ",
+              in->toString(),
+              " in place because ",
+              expr->toString(),
+              " reduces, transforms, reorders or expands ",
+              producer_id->toString());
+          last_pos = pos + 1;
+          consumer_axes.push_back(consumer_id);
+        }
+
+        auto [consumer_it, inserted] = in_axes.emplace(consumer, consumer_axes);
+        NVF_CHECK(
+            inserted || consumer_it->second == consumer_axes,
+            "Can't update ",
+            in->toString(),
+            " in place because ",
+            expr->toString(),
+            " combines it at different positions");
+      }
+    }
+  }
+
+  // The elements of a tensor stored by the kernel are computed without
+  // waiting for the other positions, so axes added by broadcasts have to be
+  // reduced before. Otherwise, the same element of `in` would be read for
+  // several positions, which `out` may have already overwritten.
+  const std::unordered_set<Expr*> expr_set(exprs.begin(), exprs.end());
+  for (const auto& [tv, axes] : in_axes) {
+    if (tv == in) {
+      continue;
+    }
+    const std::vector<Expr*>& uses = tv->uses();
+    const bool is_stored = tv->isFusionOutput() || uses.empty() ||
+        std::any_of(uses.begin(), uses.end(), [&](Expr* use) {
+          return expr_set.count(use) == 0;
+        });
+    if (!is_stored) {
+      continue;
+    }
+    for (IterDomain* id :
+         TensorDomain::noReductions(tv->getMaybeRFactorDomain())) {
+      NVF_CHECK(
+          id->isBroadcast() ||
+              std::find(axes.begin(), axes.end(), id) != axes.end(),
+          "Can't update ",
+          in->toString(),
+          " in place because ",
+          tv->toString(),
+          " reads it along the broadcast axis ",
+          id->toString());
+    }
+  }
+
+  auto out_it = in_axes.find(out);
+  if (out_it == in_axes.end()) {
+    // `out` is not computed from `in`, so nothing else may read `in`.
+    NVF_CHECK(
+        in_axes.size() == 1,
+        "Can't update ",
+        in->toString(),
+        " in place with ",
+        out->toString(),
+        ", which is not computed from it, while it's read in the same kernel");
+    return;
+  }
+  NVF_CHECK(
+      out_it->second ==
+          TensorDomain::noReductions(out->getMaybeRFactorDomain()),
+      "Can't update ",
+      in->toString(),
+      " in place with ",
+      out->toString(),
+      ", which doesn't have the axes of the input at the same positions");
+}
+
 int64_t Layout::size() const {
   NVF_ERROR(allocation_domain.size() == contiguity.size());
   return static_cast<int64_t>(allocation_domain.size());
@@ -113,4 +113,24 @@ AliasAnalysisResult findAliases(
     Fusion* fusion,
     bool can_override_empty_allocation_domain = true);
 
+// Checks that `out` can be written in place into the buffer of fusion input
+// `in`, as declared by `Fusion::aliasOutputToInput` with
+// `AliasType::InplaceUpdate`, when `exprs` run in one kernel. `exprs` have to
+// be topologically sorted.
+//
+// A kernel doesn't order the threads and CTAs reading `in` with the ones
+// writing `out`, so an element of `in` may already be overwritten when it's
+// read. This is only safe when every element of `in` is read for the element
+// of `out` at the same position and nothing else, e.g.,
+// `param = param - lr * grad`. Therefore, the check is conservative: every
+// tensor computed from `in` has to keep the axes of `in` in the same order
+// without reducing, transforming, gathering, or expanding them, and `out` has
+// to have them at the same positions as `in`. Axes added by broadcasts have to
+// be reduced before a tensor is stored, e.g., for the running stats of
+// instance norm. Throws if `out` can't be safely updated in place.
+void validateInplaceUpdate(
+    TensorView* out,
+    TensorView* in,
+    const std::vector<Expr*>& exprs);
+
 } // namespace nvfuser
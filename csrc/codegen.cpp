@@ -16,6 +16,7 @@
 #include <type.h>
 #include <utils.h>
 
+#include <algorithm>
 #include <array>
 #include <cmath>
 #include <sstream>
@@ -49,6 +50,50 @@ bool isTmaType(const DataType& dtype) {
       dtype.type);
 }
 
+//! Whether an RNG op samples a normal distribution, whose normals are cached
+//! with the Philox result they are computed from
+bool isNormalRNGOp(const RNGOp* rop) {
+  return rop->getRNGOpType() == RNGOpType::NormalStandard ||
+      rop->getRNGOpType() == RNGOpType::NormalGeneral;
+}
+
+//! Whether an expression reads and writes no global memory, so it may run
+//! before the preceding kernels of the stream complete. See
+//! [ Programmatic Dependent Launch ] in csrc/executor.cpp. Only
+//! allocations, syncs and scalar computations of kernel arguments qualify.
+bool isIndependentOfPrecedingGrids(const Expr* expr) {
+  auto all_independent = [](const std::vector<Expr*>& exprs) {
+    return std::all_of(
+        exprs.begin(), exprs.end(), isIndependentOfPrecedingGrids);
+  };
+  if (auto fl = dynamic_cast<const kir::ForLoop*>(expr)) {
+    return all_independent(fl->body().exprs());
+  }
+  if (auto ite = dynamic_cast<const kir::IfThenElse*>(expr)) {
+    return all_independent(ite->thenBody().exprs()) &&
+        all_independent(ite->elseBody().exprs());
+  }
+  if (expr->isOneOf<
+          kir::Allocate,
+          kir::InitMagicZero,
+          kir::BlockSync,
+          kir::MBarrierInit>()) {
+    return true;
+  }
+  if (!lower_utils::isScalarOp(expr) ||
+      expr->isOneOf<kir::Asm, kir::GetRNGSeedAndOffsetFromHost>()) {
+    return false;
+  }
+  // The metadata of a tensor is a kernel argument
+  if (expr->isA<GetMetaData>()) {
+    return true;
+  }
+  return std::none_of(
+      expr->inputs().begin(), expr->inputs().end(), [](const Val* in) {
+        return in->isOneOf<kir::TensorIndex, TensorView>();
+      });
+}
+
 //! Utility class to build an argument list
 class ArgumentBuilder {
  public:
@@ -249,11 +294,13 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
 
   // Generates the kernel function declaration
   void genDeclaration(const std::string& kernel_name) {
-    code_ << "__global__ void " << kernel_name << "(";
+    const bool spill_tensors =
+        kernel_->summary().has_spilled_tensor_arguments;
 
     std::unordered_set<Val*> unique_args;
 
-    std::vector<Val*> params;
+    // Declarations of the kernel parameters
+    std::vector<std::string> param_decls;
 
     // Generate parameter declarations
     kernel_params_.reserve(kernel_->parameters().size());
@@ -275,30 +322,55 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
         var_name_ss << "_duplicate_" << duplicate_counter++;
       }
 
+      std::stringstream decl_ss;
       if (const auto tv = dynamic_cast<TensorView*>(param)) {
         if (tv->isCpuScalar()) {
-          code_ << " CpuScalarTensor<" << param->dtype() << "> "
-                << var_name_ss.str();
+          decl_ss << " CpuScalarTensor<" << param->dtype() << "> "
+                  << var_name_ss.str();
         } else {
-          code_
+          decl_ss
               << "Tensor<" << param->dtype() << ", "
               << TensorDomain::noReductions(tv->getMaybeRFactorDomain()).size()
               << ", "
               << TensorDomain::noReductions(tv->getMaybeAllocationDomain())
                      .size()
               << "> " << var_name_ss.str();
+          if (spill_tensors) {
+            spilled_params_.emplace_back(decl_ss.str(), var_name_ss.str());
+            continue;
+          }
         }
       } else {
         NVF_ERROR(param->isScalar()); // NOLINT (LLVM bug 48525)
         if (isTmaType(param->dtype())) {
-          code_ << "const __grid_constant__ " << param->dtype() << " "
-                << var_name_ss.str();
+          decl_ss << "const __grid_constant__ " << param->dtype() << " "
+                  << var_name_ss.str();
         } else {
-          code_ << param->dtype() << " " << var_name_ss.str();
+          decl_ss << param->dtype() << " " << var_name_ss.str();
         }
       }
+      param_decls.push_back(decl_ss.str());
+    }
 
-      if (i + 1 != kernel_->parameters().size()) {
+    // The tensor arguments are members of a struct in a device buffer, which
+    // is passed as the first parameter. See [ Spilled Kernel Arguments ] in
+    // csrc/executor.cpp.
+    if (spill_tensors) {
+      const std::string args_type = kernel_name + "_args";
+      code_ << "struct " << args_type << " {\n";
+      for (const auto& [decl, name] : spilled_params_) {
+        code_ << kTab << decl << ";\n";
+      }
+      code_ << "};\n";
+      param_decls.insert(
+          param_decls.begin(),
+          "const " + args_type + "* __restrict__ spilled_args");
+    }
+
+    code_ << "__global__ void " << kernel_name << "(";
+    for (auto i : c10::irange(param_decls.size())) {
+      code_ << param_decls.at(i);
+      if (i + 1 != param_decls.size()) {
         code_ << ", ";
       }
     }
@@ -310,10 +382,25 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
   void genPrologue() {
     const auto& kernel_summary = kernel_->summary();
 
-    if (kernel_summary.has_philox_op) {
-      indent() << "uint4 rng_result;\n";
-      indent() << "nvfuser_index_t rng_subseq = -1;\n";
-      indent() << "nvfuser_index_t rng_offset = -1;\n";
+    // Tensor arguments passed in a device buffer are copied to local
+    // variables of the names of the parameters
+    for (const auto& [decl, name] : spilled_params_) {
+      indent() << decl << " = spilled_args->" << name << ";\n";
+    }
+
+    // One Philox call generates four 32-bit values, which are reused by
+    // the consecutive elements of the same op. So are the normals of their
+    // Box-Muller pairs.
+    for (auto rop : kernel_summary.rng_ops) {
+      indent() << "uint4 rng_result" << rop->name() << ";\n";
+      if (isNormalRNGOp(rop)) {
+        indent() << (rop->dtype() == DataType::Float ? "float4" : "double2")
+                 << " rng_normals" << rop->name() << ";\n";
+      }
+      indent() << "nvfuser_index_t rng_cached_subseq" << rop->name()
+               << " = -1;\n";
+      indent() << "nvfuser_index_t rng_cached_offset" << rop->name()
+               << " = -1;\n";
     }
 
     // Do we have any dynamic shared memory buffers?
@@ -322,7 +409,7 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
 
     // Do we have any reductions?
     const bool has_reductions = kernel_summary.has_block_reductions ||
-        kernel_summary.has_grid_reductions;
+        kernel_summary.has_grid_reductions || kernel_summary.has_block_scans;
     const bool has_parallel_welford =
         kernel_summary.has_block_welford || kernel_summary.has_grid_welford;
 
@@ -350,6 +437,14 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
                 << ")";
             smem_buf_size = smem_buf_size_with_outer_opt.str();
           }
+          if (kernel_summary.has_outer_grouped_grid_reduction) {
+            std::stringstream smem_buf_size_with_outer_opt;
+            smem_buf_size_with_outer_opt
+                << "max(" << smem_buf_size << ", "
+                << kernel_summary.outer_grouped_grid_reduction_largest_smem_size
+                << ")";
+            smem_buf_size = smem_buf_size_with_outer_opt.str();
+          }
           // Ensure that smem_offset remains 16-byte aligned, like shared_mem
           indent() << "const unsigned smem_offset = alignBufferSize("
                    << smem_buf_size << ", 16);\n";
@@ -389,7 +484,42 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
   }
 
   void genBody() {
-    handle(kernel_->topLevelExprs());
+    // With programmatic dependent launch, the kernel lets the next kernel of
+    // the stream launch right away, and waits for the preceding kernels
+    // before its first access of global memory. The wait is emitted even if
+    // the kernel doesn't access global memory, as the next kernel only waits
+    // for the completion of this one. See [ Programmatic Dependent Launch ]
+    // in csrc/executor.cpp.
+    const bool wait_for_grids = kernel_->summary().has_grid_dependency_wait;
+    bool waited = false;
+    if (wait_for_grids) {
+      indent() << "grid_sync::launchDependentGrids();\n";
+    }
+    for (auto expr : kernel_->topLevelExprs()) {
+      if (wait_for_grids && !waited && !isIndependentOfPrecedingGrids(expr)) {
+        indent() << "grid_sync::waitForPrerequisiteGrids();\n";
+        waited = true;
+      }
+      // Profiled top-level expressions are enclosed by probes, see
+      // [ Profiling of Top-Level Expressions ]
+      if (!isOptionEnabled(EnableOption::KernelProfile) ||
+          !kernel_->profile().isProfiled(expr)) {
+        kir::ConstIrVisitor::dispatch(expr);
+        continue;
+      }
+      const auto entry_index =
+          kernel_->profile().getIndicesInProfileBuffer(expr).at(0);
+      const auto start_name = "profile_start" + std::to_string(entry_index);
+      indent() << "const int64_t " << start_name
+               << " = startProfiledRegion();\n";
+      kir::ConstIrVisitor::dispatch(expr);
+      indent() << "stopProfiledRegion(" << start_name << ", &"
+               << genVariableName(kernel_->profile().getBuffer()) << "["
+               << entry_index << "]);\n";
+    }
+    if (wait_for_grids && !waited) {
+      indent() << "grid_sync::waitForPrerequisiteGrids();\n";
+    }
   }
 
   void startBlock(bool continuation = false) {
@@ -642,6 +772,70 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
     indent() << genCall(func_name, func_args) << ";\n";
   }
 
+  void genWarpTranspose(const LoadStoreOp* ldst) {
+    // generate code like
+    //   transpose::warpTranspose<TILE>(&T_out[...], &T_in[0]);
+    // The predicate is not used, as all the lanes of the warp must take part
+    // in the shuffles, and each only writes its own registers. See
+    // [ Register Transpose ]
+    auto in_tv = ldst->in()->as<kir::TensorIndex>()->view();
+    auto out_tv = ldst->out()->as<kir::TensorIndex>()->view();
+    NVF_ERROR(
+        in_tv->getMemoryType() == MemoryType::Local &&
+            out_tv->getMemoryType() == MemoryType::Local,
+        "Warp transposes are only supported on tiles held in registers: ",
+        ldst->toString());
+
+    // The lanes pass their whole tiles, so the allocations of both tensors
+    // must be exactly the tiles
+    auto allocated_size = [](TensorView* tv) {
+      int64_t size = 1;
+      for (auto i : c10::irange(tv->getComputeAtPosition(), tv->nDims())) {
+        auto id = tv->axis((int)i);
+        if (id->isThread() || id->isBroadcast()) {
+          continue;
+        }
+        NVF_ERROR(
+            id->extent()->isConstInt(),
+            "The tiles of warp transposes must be of a constant size: ",
+            tv->toString());
+        size *= id->extent()->evaluate().as<int64_t>();
+      }
+      return size;
+    };
+    const int64_t tile = allocated_size(out_tv);
+    NVF_ERROR(
+        tile > 1 && tile <= 32 && (tile & (tile - 1)) == 0 &&
+            allocated_size(in_tv) == tile,
+        "Expected square tiles of a power of two of at most 32 elements: ",
+        ldst->toString());
+
+    ArgumentBuilder template_args;
+    template_args.arg(tile);
+
+    ArgumentBuilder func_args;
+    func_args.arg("&" + gen(ldst->out()));
+    func_args.arg("&" + gen(ldst->in()));
+
+    indent() << genCall("transpose::warpTranspose", template_args, func_args)
+             << ";\n";
+  }
+
+  void genCpAsyncBulk(const LoadStoreOp* ldst) {
+    auto in = ldst->in()->as<kir::TensorIndex>();
+    auto out = ldst->out()->as<kir::TensorIndex>();
+    NVF_ERROR(
+        in->view()->getMemoryType() == MemoryType::Global &&
+            out->view()->getMemoryType() == MemoryType::Shared,
+        "Only global to shared memory bulk copies are supported");
+
+    ArgumentBuilder func_args;
+    func_args.arg(genInline(in->index()));
+    func_args.arg(genInline(out->index()));
+
+    indent() << genCall("Hopper::cpAsyncBulkG2S", func_args) << ";\n";
+  }
+
   void handle(const GetMetaData* gop) final {
     if (print_inline_) {
       code_ << gen(gop->in());
@@ -757,20 +951,31 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
              << " = linear_index" << rop->name() << " % " << multiple << ";\n";
     indent() << "nvfuser_index_t rng_offset" << rop->name() << " = "
              << genInline(rop->getRNGOffsetVal()) << ";\n";
-    indent() << "if (rng_subseq != rng_subseq" << rop->name()
-             << " || rng_offset != rng_offset" << rop->name() << ") {\n";
-    indent() << "  rng_result = philox(" << genInline(rop->getRNGSeedVal())
-             << ", rng_subseq" << rop->name() << ", "
+    indent() << "if (rng_cached_subseq" << rop->name() << " != rng_subseq"
+             << rop->name() << " || rng_cached_offset" << rop->name()
+             << " != rng_offset" << rop->name() << ") {\n";
+    indent() << "  rng_result" << rop->name() << " = philox("
+             << genInline(rop->getRNGSeedVal()) << ", rng_subseq"
+             << rop->name() << ", "
              << "rng_offset" << rop->name() << ");\n";
-    indent() << "  rng_subseq = rng_subseq" << rop->name() << ";\n";
-    indent() << "  rng_offset = rng_offset" << rop->name() << ";\n";
+    if (isNormalRNGOp(rop)) {
+      indent() << "  rng_normals" << rop->name() << " = "
+               << (rop->dtype() == DataType::Float ? "rng_normal_standard4f"
+                                                   : "rng_normal_standard2")
+               << "(rng_result" << rop->name() << ");\n";
+    }
+    indent() << "  rng_cached_subseq" << rop->name() << " = rng_subseq"
+             << rop->name() << ";\n";
+    indent() << "  rng_cached_offset" << rop->name() << " = rng_offset"
+             << rop->name() << ";\n";
     indent() << "}\n";
     auto op_type = rop->getRNGOpType();
     indent() << gen(rop->output(0)) << " = " << op_type;
     if (needFloatSuffix(op_type) && rop->dtype() == DataType::Float) {
       code_ << "f";
     }
-    code_ << "(rng_result, rng_component" << rop->name();
+    code_ << (isNormalRNGOp(rop) ? "(rng_normals" : "(rng_result")
+          << rop->name() << ", rng_component" << rop->name();
     switch (op_type) {
       case RNGOpType::UniformRange: {
         auto parameters = rop->getParameters();
@@ -1057,15 +1262,104 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
 
   void handle(const ScatterOp* sop) final {
     // generate code like T_output[... T_index[...]] = op(T_src[...]);
-    if (sop->getScatterOpType() == ScatterOpType::Set) {
-      // When value of index_tv are not unique, the behavior of Set is
-      // non-deterministic
-      indent() << gen(sop->output(0)) << " = " << gen(sop->input(2)) << ";\n";
-    } else {
-      NVF_ERROR(false, "unkown scatterOp");
+    switch (sop->getScatterOpType()) {
+      case ScatterOpType::Set:
+        // When value of index_tv are not unique, the behavior of Set is
+        // non-deterministic
+        indent() << gen(sop->output(0)) << " = " << gen(sop->input(2))
+                 << ";\n";
+        break;
+      case ScatterOpType::Add:
+        indent() << "scatter::scatterAdd(&" << gen(sop->output(0)) << ", "
+                 << gen(sop->input(2)) << ");\n";
+        break;
     }
   }
 
+  void handle(const SortOp* sop) final {
+    // generate code like
+    //   sort::threadSort<T, SIZE, DESCENDING>(
+    //       &T_values[...], &T_indices[...], &T_in[...], length);
+    auto in = sop->in()->as<kir::TensorIndex>();
+    auto out_values = sop->outValues()->as<kir::TensorIndex>();
+    NVF_ERROR(
+        in->view()->getMemoryType() == MemoryType::Local &&
+            out_values->view()->getMemoryType() == MemoryType::Local,
+        "Sorts are only supported on rows held in registers: ",
+        sop->toString());
+
+    int64_t size = 1;
+    for (auto id : out_values->view()->getLeafDomain()) {
+      if (id->getParallelType() != ParallelType::Bulk) {
+        continue;
+      }
+      NVF_ERROR(
+          id->extent()->isConstInt(),
+          "Sorted rows must have a constant size: ",
+          id->toString());
+      size *= id->extent()->evaluate().as<int64_t>();
+    }
+    Val* length =
+        in->view()->getMaybeRFactorDomain().at(sop->dim())->extent();
+
+    indent() << "sort::threadSort<" << out_values->dtype() << ", " << size
+             << ", " << (sop->descending() ? "true" : "false") << ">(&"
+             << gen(out_values) << ", &" << gen(sop->outIndices()) << ", &"
+             << gen(in) << ", " << gen(length) << ");\n";
+  }
+
+  void handle(const ScanOp* sop) final {
+    // generate code like
+    //   scan::blockScan<ITEMS, ALIGNED>(
+    //       &T_out[...], &T_in[...], length, scan_op,
+    //       static_cast<T*>(shared_mem), pred, init);
+    auto in = sop->in()->as<kir::TensorIndex>();
+    auto out = sop->out()->as<kir::TensorIndex>();
+    NVF_ERROR(
+        in->view()->getMemoryType() == MemoryType::Local &&
+            out->view()->getMemoryType() == MemoryType::Local,
+        "Scans are only supported on rows held in registers: ",
+        sop->toString());
+
+    int64_t items = 1;
+    for (auto id : out->view()->getLeafDomain()) {
+      if (id->getParallelType() != ParallelType::Bulk) {
+        continue;
+      }
+      NVF_ERROR(
+          id->extent()->isConstInt(),
+          "The elements of a scanned row each thread holds must be of a ",
+          "constant number: ",
+          id->toString());
+      items *= id->extent()->evaluate().as<int64_t>();
+    }
+    Val* length =
+        TensorDomain::noReductions(in->view()->getMaybeRFactorDomain())
+            .at(sop->dim())
+            ->extent();
+
+    const auto data_type = out->dtype();
+    ArgumentBuilder template_args;
+    template_args.arg(items);
+    template_args.arg(isAligned());
+
+    ArgumentBuilder func_args;
+    func_args.arg("&" + gen(out));
+    func_args.arg("&" + gen(in));
+    func_args.arg(gen(length));
+    func_args.arg(genReductionOp(sop->getScanOpType(), data_type));
+    func_args.arg(genStaticCast(genPtrType(data_type), "shared_mem"));
+    NVF_ERROR(
+        sop->predicate() != nullptr && sop->predicate()->hasValue(),
+        "Scans across threads need an inline predicate: ",
+        sop->toString());
+    func_args.arg(genInline(sop->predicate()));
+    func_args.arg(genCall(data_type, genInline(sop->init())));
+
+    indent() << genCall("scan::blockScan", template_args, func_args)
+             << ";\n";
+  }
+
   std::string genReductionOp(BinaryOpType op_type, DataType data_type) {
     std::stringstream lambda;
     lambda << "[](" << data_type << " &a, " << data_type << " b) "
@@ -1127,6 +1421,27 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
       const Val* init,
       BinaryOpType reduction_op_type,
       kir::Predicate* read_pred) {
+    // See [ Warp Segment Reduction ]
+    const auto segment_size =
+        kernel_->getWarpPaddedParallelInfo().tidx_warp_segment_size;
+    if (segment_size > 0) {
+      ArgumentBuilder template_args;
+      template_args.arg(segment_size);
+
+      ArgumentBuilder func_args;
+      func_args.arg(gen(output));
+      func_args.arg(gen(input));
+      func_args.arg(genReductionOp(reduction_op_type, output->dtype()));
+      NVF_ERROR(read_pred != nullptr && read_pred->hasValue());
+      func_args.arg(genInline(read_pred));
+      func_args.arg(genStaticCast(output->dtype(), genInline(init)));
+
+      indent() << genCall(
+                      "warp::warpSegmentReduceTIDX", template_args, func_args)
+               << ";\n";
+      return;
+    }
+
     ArgumentBuilder template_args;
     template_args.arg(kernel_->getWarpPaddedParallelInfo().is_tidx_single_warp);
     template_args.arg(isAligned());
@@ -1208,7 +1523,10 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
     if (!has_block_reduce) {
       genSerialReduction(output, input, op_type);
     } else if (
-        auto reduction_id = ir_utils::getMaybeWarpReductionDim(output, input)) {
+        auto reduction_id = ir_utils::getMaybeWarpReductionDim(
+            output,
+            input,
+            kernel_->getWarpPaddedParallelInfo().tidx_warp_segment_size)) {
       genWarpReduction(output, input, rop->init(), op_type, rop->predicate());
     } else {
       genBlockReduction(
@@ -1221,6 +1539,39 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
     }
   }
 
+  //! Whether ldst is a scalar, non-volatile store of a local element to
+  //! global memory that is generated with the cache operator of
+  //! EnableOption::StreamingStores
+  bool isScalarStreamingStore(const LoadStoreOp* ldst) const {
+    if (!isOptionEnabled(EnableOption::StreamingStores) ||
+        !ldst->out()->isA<kir::TensorIndex>() ||
+        !ldst->in()->isA<kir::TensorIndex>()) {
+      return false;
+    }
+    auto out_tv = ldst->out()->as<kir::TensorIndex>()->view();
+    auto in_tv = ldst->in()->as<kir::TensorIndex>()->view();
+    if (out_tv->getMemoryType() != MemoryType::Global ||
+        in_tv->getMemoryType() != MemoryType::Local ||
+        kernel_->summary().sync_map->needsRawSync(out_tv).hasBID()) {
+      return false;
+    }
+    const DataType dtype = ldst->out()->dtype();
+    if (dtype != ldst->in()->dtype() ||
+        !std::holds_alternative<PrimDataType>(dtype.type)) {
+      return false;
+    }
+    switch (dataTypeSize(dtype, kernel_->indexType())) {
+      case 1:
+      case 2:
+      case 4:
+      case 8:
+      case 16:
+        return true;
+      default:
+        return false;
+    }
+  }
+
   void handle(const LoadStoreOp* ldst) final {
     auto optype = ldst->opType();
     NVF_ERROR(
@@ -1262,6 +1613,17 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
         return;
       }
 
+      // dispatch cp.async.bulk
+      if (optype == LoadStoreOpType::CpAsyncBulk) {
+        genCpAsyncBulk(ldst);
+        return;
+      }
+
+      if (optype == LoadStoreOpType::WarpTranspose) {
+        genWarpTranspose(ldst);
+        return;
+      }
+
       // dispatch vectorized load/store
       if (is_vector_op) {
         NVF_ERROR(optype == LoadStoreOpType::Set);
@@ -1307,7 +1669,14 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
               in_tv->getMemoryType() == MemoryType::Global &&
               kernel_->summary().sync_map->needsRawSync(in_tv).hasBID();
 
-          if (localToGlobal) {
+          if (localToGlobal && !is_volatile_to &&
+              isOptionEnabled(EnableOption::StreamingStores)) {
+            indent() << "storeLocalToGlobal<" << ldst->out()->dtype()
+                     << ", /*vec_size=*/" << vector_word_size << ", "
+                     << "CacheOp::" << ldst->cacheOp() << ">(&"
+                     << gen(ldst->out()) << ", &" << gen(ldst->in())
+                     << ");\n";
+          } else if (localToGlobal) {
             indent() << "loadLocalToGlobal<" << ldst->out()->dtype()
                      << ", /*vec_size=*/" << vector_word_size
                      << ", /*is_volatile=*/"
@@ -1359,6 +1728,13 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
       return;
     }
 
+    if (!print_inline_ && isScalarStreamingStore(ldst)) {
+      indent() << "storeLocalToGlobal<" << ldst->out()->dtype()
+               << ", /*vec_size=*/1, CacheOp::" << ldst->cacheOp() << ">(&"
+               << gen(ldst->out()) << ", &" << gen(ldst->in()) << ");\n";
+      return;
+    }
+
     if (!print_inline_) {
       indent() << gen(ldst->out());
       if (!ldst->out()->isScalar() && !ldst->in()->isScalar()) {
@@ -1604,6 +1980,11 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
     const auto data_type = grop->out()->dtype();
     const auto op_type = grop->getReductionOpType();
 
+    if (grop->atomicGridReductionRequested()) {
+      generateAtomicGridReduction(grop);
+      return;
+    }
+
     NVF_ERROR(grop->reduction_buffer()->buffer()->isA<TensorView>());
     NVF_ERROR(grop->sync_buffer()->buffer()->isA<TensorView>());
     const auto work_buffer =
@@ -1626,11 +2007,23 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
     const bool persistent_sync =
         kernel_->summary().has_cooperative_grid_reduction;
 
+    // The work buffer of a single-pass grid reduction is too small for
+    // gridReduce. See [ Single-Pass Grid Reduction ]
+    const bool single_pass = grop->singlePassGridReductionRequested();
+    NVF_ERROR(
+        !single_pass || !persistent_sync,
+        "Single-pass grid reductions are not supported in cooperative kernels: ",
+        grop->toString());
+
     // Since block-level reduction is already done, those dimensions
     // with tidx/y/z being true do not participate in the grid
     // reduction.
     ArgumentBuilder template_args;
-    template_args.arg(flags_str).arg(persistent_sync).arg(isAligned());
+    template_args.arg(flags_str);
+    if (!single_pass) {
+      template_args.arg(persistent_sync);
+    }
+    template_args.arg(isAligned());
 
     ArgumentBuilder func_args(block_nest_level_ + 1, kTab);
     func_args.arg(gen(grop->out()));
@@ -1656,7 +2049,9 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
 
     addProfileArguments(func_args, grop);
 
-    indent() << "reduction::gridReduce<" << template_args << ">(\n";
+    indent() << "reduction::"
+             << (single_pass ? "gridReduceSinglePass" : "gridReduce") << "<"
+             << template_args << ">(\n";
     indent() << kTab << func_args << ");\n";
   }
 
@@ -1724,6 +2119,62 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
     indent() << kTab << func_args << ");\n";
   }
 
+  // See [ Atomic Grid Reduction ]
+  void generateAtomicGridReduction(const kir::GridReduction* grop) {
+    NVF_ERROR(grop->atomicGridReductionRequested());
+
+    const auto out = grop->out()->as<kir::TensorIndex>();
+
+    const auto data_type = grop->out()->dtype();
+    const auto op_type = grop->getReductionOpType();
+
+    const auto par_domains =
+        ir_utils::getParallelDomains(ir_utils::getTvOutput(grop));
+    const auto& thread_pred = grop->threadPredicate();
+
+    // Only the thread dimensions are reduced by gridReduceAtomic itself, the
+    // block dimensions by the atomics
+    ArgumentBuilder template_args;
+    for (const ParallelType pt : kParallelTypeTIDs) {
+      const bool parallel_reduction =
+          par_domains.find(pt) != par_domains.end() &&
+          par_domains.at(pt)->isReduction();
+      template_args.arg(parallel_reduction);
+    }
+    template_args.arg(isAligned());
+
+    ArgumentBuilder func_args(block_nest_level_ + 1, kTab);
+    func_args.arg(gen(out));
+    func_args.arg(gen(grop->in()));
+    func_args.arg(genReductionOp(op_type, out->dtype()));
+    func_args.arg(genCall("static_cast", ptrType(data_type), "shared_mem"));
+    // read and write predicates
+    NVF_ERROR(grop->predicate() != nullptr && grop->predicate()->hasValue());
+    const auto read_pred = genInline(grop->predicate());
+    func_args.arg(read_pred);
+    std::stringstream write_pred;
+    if (grop->writePredicate() != nullptr) {
+      NVF_ERROR(grop->writePredicate()->hasValue());
+      write_pred << genInline(grop->writePredicate());
+    } else {
+      write_pred << read_pred;
+    }
+    // Unlike the other grid reductions, which write the same result from
+    // every thread of the predicated dimensions, each of them would add its
+    // partial result again
+    for (const ParallelType pt : kParallelTypeThreads) {
+      if (thread_pred.get(pt)) {
+        write_pred << " && " << stringifyThread(pt) << " == 0";
+      }
+    }
+    func_args.arg(write_pred.str());
+    // Init val
+    func_args.arg(genCall(data_type, genInline(grop->init())));
+
+    indent() << "reduction::gridReduceAtomic<" << template_args << ">(\n";
+    indent() << kTab << func_args << ");\n";
+  }
+
   void generateGridAllreduce(const kir::GridReduction* grop) {
     NVF_ERROR(grop->isAllreduce());
 
@@ -1801,7 +2252,11 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
         grouped_grop->sync_buffer()->buffer()->as<TensorView>();
 
     if (grouped_grop->isAllreduce()) {
-      generateGroupedGridAllreduce(grouped_grop);
+      if (grouped_grop->useOuterOpt()) {
+        generateGroupedGridAllreduceOuter(grouped_grop);
+      } else {
+        generateGroupedGridAllreduce(grouped_grop);
+      }
       return;
     }
 
@@ -2344,6 +2799,80 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
              << ";\n";
   }
 
+  // Non-Welford version of generateGroupedGridAllreduceWelfordOuter. The
+  // grouped iterations of each horizontally grouped reduction are
+  // reduced together by a separate call.
+  void generateGroupedGridAllreduceOuter(
+      const kir::GroupedGridReduction* grouped_grop) {
+    NVF_ERROR(grouped_grop->isAllreduce());
+
+    const auto num_grouped_iterations =
+        getGroupedLoopIndexConcreteIntSets().size();
+
+    NVF_ERROR(
+        num_grouped_iterations <= kMaxNumGroupedReductions,
+        "Too many grouped reductions: ",
+        grouped_grop->toString(),
+        ". Up to ",
+        kMaxNumGroupedReductions,
+        " reductions are allowed.");
+
+    const auto& par_dim_map = kernel_->summary().parallel_dimension_map_;
+    NVF_ERROR(par_dim_map.get(ParallelType::TIDx)->isConstInt());
+    NVF_ERROR(par_dim_map.get(ParallelType::TIDy)->isConstInt());
+
+    const auto sync_buffer =
+        grouped_grop->sync_buffer()->buffer()->as<TensorView>();
+
+    for (const auto expr_index :
+         c10::irange(grouped_grop->numHorizontallyGroupedExprs())) {
+      const auto data_type = grouped_grop->output(expr_index)->dtype();
+
+      ArgumentBuilder func_args;
+      func_args.arg(genVariableName(grouped_grop->output(expr_index)));
+      func_args.arg(genVariableName(grouped_grop->input(expr_index)));
+
+      // global buf
+      const auto work_buffer = grouped_grop->reduction_buffer(expr_index)
+                                   ->buffer()
+                                   ->as<TensorView>();
+      func_args.arg("&").append(genVariableName(work_buffer)).append("[0]");
+
+      // shared buf
+      func_args.arg(
+          genCall("reinterpret_cast", ptrType(data_type), "shared_mem"));
+
+      // sync buf
+      func_args.arg("&").append(genVariableName(sync_buffer)).append("[0]");
+
+      func_args.arg(genReductionOp(
+          grouped_grop->getReductionOpType(expr_index), data_type));
+      auto iv = grouped_grop->initVal(expr_index);
+      if (iv->dtype() != data_type) {
+        func_args.arg(genCall(data_type, gen(iv)));
+      } else {
+        func_args.arg(genInline(iv));
+      }
+
+      addProfileArguments(func_args, grouped_grop);
+
+      ArgumentBuilder func_template_args;
+      func_template_args.arg(isAligned());
+      func_template_args.arg(num_grouped_iterations);
+      func_template_args.arg(data_type);
+      func_template_args.arg(genInline(par_dim_map.get(ParallelType::TIDx)));
+      func_template_args.arg(genInline(par_dim_map.get(ParallelType::TIDy)));
+
+      indent() << genCall(
+                      genFusedReductionName(
+                          ir_utils::getTvOutput(grouped_grop)) +
+                          ".reduceGroupOuter",
+                      func_template_args,
+                      func_args)
+               << ";\n";
+    }
+  }
+
   void handle(const kir::GridBroadcast* grop) final {
     const auto bop = grop->broadcast_op();
     NVF_ERROR(bop->out()->isA<kir::TensorIndex>());
@@ -2654,8 +3183,10 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
       if (!has_block_reduce) {
         genSerialReduction(output, input, op_type);
       } else if (
-          auto reduction_id =
-              ir_utils::getMaybeWarpReductionDim(output, input)) {
+          auto reduction_id = ir_utils::getMaybeWarpReductionDim(
+              output,
+              input,
+              kernel_->getWarpPaddedParallelInfo().tidx_warp_segment_size)) {
         genWarpReduction(
             output,
             input,
@@ -2681,6 +3212,77 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
         " which is handled by its own handler");
   }
 
+  //! Name of the packed runtime function of a BinaryOp of a loop body that
+  //! can be generated with packed half-precision instructions, or nullptr.
+  //! See [ Half-Precision Arithmetic ] in optimization/half_arithmetic.h.
+  static const char* getPackedHalfFunction(
+      const Expr* expr,
+      const kir::ForLoop* loop) {
+    auto bop = dynamic_cast<const BinaryOp*>(expr);
+    if (bop == nullptr) {
+      return nullptr;
+    }
+    const auto dtype = bop->out()->dtype();
+    if (dtype != DataType::Half && dtype != DataType::BFloat16) {
+      return nullptr;
+    }
+    // Consecutive elements of local tensors of the same type, so a pair of
+    // elements can be reinterpreted as a packed value
+    for (auto val : {bop->out(), bop->lhs(), bop->rhs()}) {
+      auto ti = dynamic_cast<const kir::TensorIndex*>(val);
+      if (ti == nullptr || ti->dtype() != dtype ||
+          ti->view()->getMemoryType() != MemoryType::Local ||
+          !ti->index()->sameAs(loop->index())) {
+        return nullptr;
+      }
+    }
+    switch (bop->getBinaryOpType()) {
+      case BinaryOpType::Add:
+        return "__hadd2";
+      case BinaryOpType::Sub:
+        return "__hsub2";
+      case BinaryOpType::Mul:
+        return "__hmul2";
+      default:
+        return nullptr;
+    }
+  }
+
+  //! Whether an unrolled loop only consists of half-precision arithmetic
+  //! that is generated with packed instructions, two iterations at a time
+  static bool isPackedHalfLoop(const kir::ForLoop* loop) {
+    if (!isOptionEnabled(EnableOption::HalfArithmetic) ||
+        !loop->isUnrolled() || loop->iter_domain()->isParallelized() ||
+        !loop->step()->isOneInt() ||
+        !loop->simplifiedStop()->isConstInt() ||
+        loop->simplifiedStop()->evaluate().as<int64_t>() % 2 != 0 ||
+        loop->body().empty()) {
+      return false;
+    }
+    return std::all_of(
+        loop->body().exprs().begin(),
+        loop->body().exprs().end(),
+        [loop](const Expr* expr) {
+          return getPackedHalfFunction(expr, loop) != nullptr;
+        });
+  }
+
+  void handlePackedHalfLoop(const kir::ForLoop* loop) {
+    const auto gen_index = gen(loop->index());
+    indent() << "#pragma unroll\n";
+    indent() << "for(nvfuser_index_t " << gen_index << " = 0; " << gen_index
+             << " < " << genInline(loop->simplifiedStop()) << "; "
+             << gen_index << " += 2) ";
+    startBlock(true);
+    for (auto expr : loop->body().exprs()) {
+      auto bop = expr->as<BinaryOp>();
+      indent() << getPackedHalfFunction(expr, loop) << "(&" << gen(bop->out())
+               << ", &" << gen(bop->lhs()) << ", &" << gen(bop->rhs())
+               << ");\n";
+    }
+    endBlock();
+  }
+
   void handle(const kir::ForLoop* loop) final {
     if (loop->isTrivial()) {
       handleTrivialLoop(loop);
@@ -2696,6 +3298,11 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
       return;
     }
 
+    if (isPackedHalfLoop(loop)) {
+      handlePackedHalfLoop(loop);
+      return;
+    }
+
     const auto gen_index = gen(loop->index());
     const auto gen_start = genInline(loop->start());
     const auto gen_stop = genInline(loop->simplifiedStop());
@@ -2975,6 +3582,13 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
     // Use a custom synchronization method if enabled
     if (getNvFuserEnv("USE_BLOCK_SYNC_ATOMIC")) {
       indent() << "block_sync::sync();\n";
+    } else if (sync->isRowSync()) {
+      // See [ Row Barriers ]
+      indent() << genCall(
+                      "block_sync::syncRow",
+                      ArgumentBuilder().arg(isAligned()),
+                      ArgumentBuilder())
+               << ";\n";
     } else if (isAligned()) {
       indent() << "__syncthreads();\n";
     } else {
@@ -3067,6 +3681,22 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
     indent() << call << ";\n";
   }
 
+  void handle(const kir::MBarrierWaitParity* wait) final {
+    auto call = genCall(
+        "mbarrier::waitParity",
+        ArgumentBuilder()
+            .arg(genInline(wait->mbarrier()))
+            .arg(genInline(wait->parity())));
+    indent() << call << ";\n";
+  }
+
+  void handle(const kir::CpAsyncMBarrierArrive* arrive) final {
+    auto call = genCall(
+        "mbarrier::cpAsyncArrive",
+        ArgumentBuilder().arg(genInline(arrive->mbarrier())));
+    indent() << call << ";\n";
+  }
+
   void handle(const kir::BlockSerializeWait* sync) final {
     // Use a custom synchronization method if enabled
     bool bidx = sync->syncDims().get(ParallelType::BIDx);
@@ -3139,6 +3769,15 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
     indent() << "NVFUSER_UPDATE_MAGIC_ZERO;\n";
   }
 
+  void handle(const kir::IncrementScalar* incr) final {
+    NVF_ERROR(
+        alloc_set_.count(incr->scalar()),
+        "Incremented scalar must be allocated: ",
+        incr->scalar()->toString());
+    indent() << gen(incr->scalar()) << " += " << genInline(incr->increment())
+             << ";\n";
+  }
+
   void handle(const CatOp* cat) final {
     auto out = gen(cat->output(0));
 
@@ -3196,6 +3835,10 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
   std::unordered_map<const Val*, std::string> val_to_name_;
   //! basically kernel_->parameters(), but as a set so it's faster to lookup
   std::unordered_set<const Val*> kernel_params_;
+
+  //! Declarations and names of the tensor parameters passed in a device
+  //! buffer, see [ Spilled Kernel Arguments ] in csrc/executor.cpp
+  std::vector<std::pair<std::string, std::string>> spilled_params_;
 };
 
 } // namespace
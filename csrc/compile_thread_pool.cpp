@@ -0,0 +1,194 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <compile_thread_pool.h>
+#include <debug.h>
+#include <options.h>
+#include <utils.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace nvfuser {
+
+namespace {
+
+//! The pool the current thread belongs to
+thread_local const CompileThreadPool* current_pool = nullptr;
+
+//! Parses a list of CPUs like "0-3,8"
+std::vector<int64_t> parseCpuList(const std::string& list) {
+  std::vector<int64_t> cpus;
+  std::stringstream ss(list);
+  std::string range;
+  while (std::getline(ss, range, ',')) {
+    if (range.empty()) {
+      continue;
+    }
+    auto dash = range.find('-');
+    try {
+      int64_t first = std::stoll(range.substr(0, dash));
+      int64_t last = dash == std::string::npos
+          ? first
+          : std::stoll(range.substr(dash + 1));
+      NVF_CHECK(
+          0 <= first && first <= last, "Invalid range of CPUs: ", range);
+      for (int64_t cpu = first; cpu <= last; ++cpu) {
+        cpus.push_back(cpu);
+      }
+    } catch (const std::logic_error&) {
+      NVF_CHECK(false, "Invalid list of CPUs: ", list);
+    }
+  }
+  return cpus;
+}
+
+//! Applies the affinity and nice value of options to the calling thread
+void setThreadAttributes(const CompileThreadPool::Options& options) {
+#ifdef __linux__
+  if (!options.cpus.empty()) {
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    for (auto cpu : options.cpus) {
+      if (cpu < CPU_SETSIZE) {
+        CPU_SET(cpu, &cpu_set);
+      }
+    }
+    if (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) !=
+        0) {
+      debug() << "Failed to set the CPU affinity of a compile thread"
+              << std::endl;
+    }
+  }
+  // On Linux, the nice value applies to the thread rather than the process
+  if (options.nice != 0) {
+    auto tid = (id_t)syscall(SYS_gettid);
+    if (setpriority(PRIO_PROCESS, tid, (int)options.nice) != 0) {
+      debug() << "Failed to set the nice value of a compile thread"
+              << std::endl;
+    }
+  }
+#endif
+}
+
+std::mutex thread_pool_mutex;
+std::unique_ptr<CompileThreadPool> thread_pool;
+
+} // namespace
+
+CompileThreadPool::Options CompileThreadPool::Options::fromEnvironment() {
+  Options options;
+  options.num_threads = getNumThreads();
+  if (const char* cpus = getNvFuserEnv("COMPILE_THREAD_CPUS")) {
+    options.cpus = parseCpuList(cpus);
+  }
+  if (const char* nice = getNvFuserEnv("COMPILE_THREAD_NICE")) {
+    options.nice = std::atoi(nice);
+  }
+  return options;
+}
+
+CompileThreadPool::CompileThreadPool(Options options)
+    : options_(std::move(options)) {
+  NVF_CHECK(
+      options_.num_threads > 0, "A thread pool needs at least one thread");
+  threads_.reserve(options_.num_threads);
+  for (int64_t i = 0; i < options_.num_threads; ++i) {
+    threads_.emplace_back([this]() { workerLoop(); });
+  }
+}
+
+CompileThreadPool::~CompileThreadPool() {
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    stopped_ = true;
+  }
+  task_available_.notify_all();
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+void CompileThreadPool::run(std::function<void()> task, int64_t priority) {
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    tasks_.push(Task{priority, num_queued_++, std::move(task)});
+  }
+  task_available_.notify_one();
+}
+
+void CompileThreadPool::waitWorkComplete() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  work_complete_.wait(
+      lock, [this]() { return tasks_.empty() && num_running_ == 0; });
+}
+
+bool CompileThreadPool::inThreadPool() const {
+  return current_pool == this;
+}
+
+void CompileThreadPool::workerLoop() {
+  current_pool = this;
+  setThreadAttributes(options_);
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    task_available_.wait(
+        lock, [this]() { return stopped_ || !tasks_.empty(); });
+    if (stopped_) {
+      return;
+    }
+    // top() is const, but the task is popped right after
+    auto function = std::move(const_cast<Task&>(tasks_.top()).function);
+    tasks_.pop();
+    ++num_running_;
+    lock.unlock();
+    try {
+      function();
+    } catch (...) {
+      // See run
+    }
+    // Captures of the task are released before the pool is idle
+    function = nullptr;
+    lock.lock();
+    --num_running_;
+    if (tasks_.empty() && num_running_ == 0) {
+      work_complete_.notify_all();
+    }
+  }
+}
+
+CompileThreadPool* getThreadPool() {
+  std::lock_guard<std::mutex> guard(thread_pool_mutex);
+  if (thread_pool == nullptr) {
+    thread_pool = std::make_unique<CompileThreadPool>(
+        CompileThreadPool::Options::fromEnvironment());
+  }
+  return thread_pool.get();
+}
+
+void configureThreadPool(CompileThreadPool::Options options) {
+  auto pool = std::make_unique<CompileThreadPool>(std::move(options));
+  std::lock_guard<std::mutex> guard(thread_pool_mutex);
+  if (thread_pool != nullptr) {
+    thread_pool->waitWorkComplete();
+  }
+  thread_pool = std::move(pool);
+}
+
+} // namespace nvfuser
@@ -0,0 +1,118 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <exceptions.h>
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace nvfuser {
+
+//! [ Compile Thread Pool ]
+//!
+//! Kernels of segments are compiled in parallel, asynchronous compiles and
+//! prefetched modules run in the background, and the FusionCache is
+//! deserialized in parallel, all on the threads of getThreadPool(). A
+//! serving process wants these threads capped and niced, so that compiling
+//! new shapes doesn't starve the threads serving requests, while a build
+//! farm precompiling kernels wants every core. The pool is configured by
+//! CompileThreadPool::Options, which by default are read from:
+//!   NVFUSER_NUM_THREADS: number of threads, 8 by default and every core if
+//!     0, capped by the number of cores
+//!   NVFUSER_COMPILE_THREAD_CPUS: CPUs the threads run on, e.g., "0-3,8"
+//!   NVFUSER_COMPILE_THREAD_NICE: nice value of the threads, e.g., 10
+//! or set with configureThreadPool. Affinity and priority are only applied
+//! on Linux.
+//!
+//! Tasks are run by decreasing priority and in the order they were queued
+//! for the same priority. Compiles of a FusionExecutorCache are queued with
+//! its compile priority, see FusionExecutorCache::setCompilePriority, so the
+//! hot fusions of a service can be compiled first.
+class CompileThreadPool {
+ public:
+  struct Options {
+    int64_t num_threads = 8;
+    //! CPUs the threads are pinned to, all of them if empty
+    std::vector<int64_t> cpus;
+    //! Nice value of the threads, unchanged if 0
+    int64_t nice = 0;
+
+    //! Reads the options from the environment
+    static Options fromEnvironment();
+  };
+
+  explicit CompileThreadPool(Options options);
+  //! Pending tasks are dropped, and running ones finish
+  ~CompileThreadPool();
+
+  CompileThreadPool(const CompileThreadPool&) = delete;
+  CompileThreadPool& operator=(const CompileThreadPool&) = delete;
+
+  //! Queues a task, which runs before the pending tasks of lower priority.
+  //! Exceptions of the task are dropped, so tasks report their own errors.
+  void run(std::function<void()> task, int64_t priority = 0);
+
+  //! Blocks until all queued tasks have finished
+  void waitWorkComplete();
+
+  //! Whether the calling thread is a thread of the pool
+  bool inThreadPool() const;
+
+  size_t size() const {
+    return threads_.size();
+  }
+
+  const Options& options() const {
+    return options_;
+  }
+
+ private:
+  struct Task {
+    int64_t priority;
+    //! Order in which the task was queued
+    uint64_t sequence;
+    std::function<void()> function;
+
+    //! The task with the highest priority that was queued first is on top
+    bool operator<(const Task& other) const {
+      return priority != other.priority ? priority < other.priority
+                                        : sequence > other.sequence;
+    }
+  };
+
+  void workerLoop();
+
+  Options options_;
+  std::vector<std::thread> threads_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable task_available_;
+  std::condition_variable work_complete_;
+  std::priority_queue<Task> tasks_;
+  uint64_t num_queued_ = 0;
+  //! Number of tasks being run
+  int64_t num_running_ = 0;
+  bool stopped_ = false;
+};
+
+//! The pool compiling and deserializing kernels, created with
+//! Options::fromEnvironment() on first use
+CompileThreadPool* getThreadPool();
+
+//! Replaces the pool of getThreadPool() by one with options, after the
+//! tasks of the current pool have finished. It must not be called while
+//! fusions are being compiled or deserialized.
+void configureThreadPool(CompileThreadPool::Options options);
+
+} // namespace nvfuser
@@ -0,0 +1,292 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <cuda_graph.h>
+
+#include <cuda_utils.h>
+#include <driver_api.h>
+#include <instrumentation.h>
+
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/cuda/CUDAGeneratorImpl.h>
+#include <c10/util/irange.h>
+
+#include <cstring>
+#include <unordered_map>
+
+namespace nvfuser {
+
+namespace {
+
+void* getDataPointer(const std::vector<std::byte>& arg_buffer) {
+  NVF_ERROR(arg_buffer.size() >= sizeof(void*));
+  void* ptr = nullptr;
+  std::memcpy(&ptr, arg_buffer.data(), sizeof(void*));
+  return ptr;
+}
+
+void setDataPointer(std::vector<std::byte>& arg_buffer, void* ptr) {
+  NVF_ERROR(arg_buffer.size() >= sizeof(void*));
+  std::memcpy(arg_buffer.data(), &ptr, sizeof(void*));
+}
+
+void setIntValue(std::vector<std::byte>& arg_buffer, int64_t value) {
+  NVF_ERROR(arg_buffer.size() == sizeof(int64_t));
+  std::memcpy(arg_buffer.data(), &value, sizeof(int64_t));
+}
+
+} // namespace
+
+std::unique_ptr<FusionCudaGraph> FusionCudaGraph::create(
+    std::vector<FusionExecutor::LaunchRecord> launches,
+    const KernelArgumentHolder& inputs,
+    const std::vector<at::Tensor>& outputs) {
+  FUSER_PERF_SCOPE("FusionCudaGraph::create");
+
+  // Data pointers of the fusion inputs followed by the fusion outputs. These
+  // are the only kernel arguments updated on replay.
+  std::vector<void*> io_ptrs;
+  io_ptrs.reserve(inputs.size() + outputs.size());
+  for (const auto i : c10::irange(inputs.size())) {
+    if (!inputs[i]->is<at::Tensor>()) {
+      return nullptr;
+    }
+    const auto& tensor = inputs[i]->as<at::Tensor>();
+    if (!tensor.is_cuda() || tensor.data_ptr() == nullptr) {
+      return nullptr;
+    }
+    io_ptrs.push_back(tensor.data_ptr());
+  }
+  for (const auto& tensor : outputs) {
+    // Outputs are newly allocated on replay, which is only equivalent if
+    // they own their memory rather than being views of something else
+    if (tensor.data_ptr() == nullptr || tensor.storage_offset() != 0 ||
+        tensor.storage().data() != tensor.data_ptr()) {
+      return nullptr;
+    }
+    io_ptrs.push_back(tensor.data_ptr());
+  }
+
+  // Each data pointer must identify a unique input or output, otherwise we
+  // cannot tell which argument slots to update
+  std::unordered_map<void*, size_t> io_index_map;
+  for (const auto i : c10::irange(io_ptrs.size())) {
+    if (!io_index_map.emplace(io_ptrs.at(i), i).second) {
+      return nullptr;
+    }
+  }
+
+  if (std::any_of(launches.begin(), launches.end(), [](const auto& launch) {
+        return launch.is_cooperative || launch.has_spilled_arguments;
+      })) {
+    return nullptr;
+  }
+
+  std::unique_ptr<FusionCudaGraph> graph(new FusionCudaGraph());
+  graph->num_inputs_ = inputs.size();
+  graph->io_ptrs_ = io_ptrs;
+  graph->stream_ = at::cuda::getCurrentCUDAStream().stream();
+  for (const auto& tensor : outputs) {
+    graph->outputs_.push_back(
+        {tensor.sizes().vec(), tensor.strides().vec(), tensor.options()});
+  }
+
+  CUcontext context = nullptr;
+  NVFUSER_CUDA_SAFE_CALL(cuCtxGetCurrent(&context));
+  NVFUSER_CUDA_SAFE_CALL(cuGraphCreate(&graph->graph_, 0));
+
+  // Kernels are serialized in the order they were launched
+  CUgraphNode last_node = nullptr;
+  for (auto& launch : launches) {
+    NVF_ERROR(launch.intermediates.size() == launch.zero_init.size());
+    for (const auto i : c10::irange(launch.intermediates.size())) {
+      const auto& buffer = launch.intermediates.at(i);
+      graph->persistent_buffers_.push_back(buffer);
+      if (!launch.zero_init.at(i)) {
+        continue;
+      }
+      CUDA_MEMSET_NODE_PARAMS memset_params = {};
+      memset_params.dst = (CUdeviceptr)buffer.data_ptr();
+      memset_params.value = 0;
+      memset_params.elementSize = 1;
+      memset_params.width = buffer.storage().nbytes();
+      memset_params.height = 1;
+      CUgraphNode memset_node = nullptr;
+      NVFUSER_CUDA_SAFE_CALL(cuGraphAddMemsetNode(
+          &memset_node,
+          graph->graph_,
+          last_node == nullptr ? nullptr : &last_node,
+          last_node == nullptr ? 0 : 1,
+          &memset_params,
+          context));
+      last_node = memset_node;
+    }
+
+    // Segment outputs that are not fusion outputs are consumed by later
+    // segments, so the graph needs to keep them alive
+    for (const auto& output : launch.outputs) {
+      if (io_index_map.count(output.data_ptr()) == 0) {
+        graph->persistent_buffers_.push_back(output);
+      }
+    }
+
+    KernelNode kernel_node;
+    kernel_node.arg_buffers = std::move(launch.arg_buffers);
+    NVF_ERROR(kernel_node.arg_buffers.size() == launch.is_tensor_arg.size());
+
+    if (launch.rng_args.has_value()) {
+      const auto& rng_args = launch.rng_args.value();
+      // The seed and offset were read from the device when the recorded
+      // run was itself being captured into another graph
+      if (getDataPointer(kernel_node.arg_buffers.at(rng_args.seed_ptr)) !=
+              nullptr ||
+          getDataPointer(kernel_node.arg_buffers.at(rng_args.offset_ptr)) !=
+              nullptr) {
+        return nullptr;
+      }
+      graph->rng_slots_.push_back(
+          {graph->kernel_nodes_.size(),
+           rng_args.seed_val,
+           rng_args.offset_val,
+           graph->rng_offset_increment_});
+      graph->rng_offset_increment_ += rng_args.offset_increment;
+    }
+    for (const auto arg_i : c10::irange(kernel_node.arg_buffers.size())) {
+      auto& arg_buffer = kernel_node.arg_buffers.at(arg_i);
+      kernel_node.arg_ptrs.push_back(arg_buffer.data());
+      if (!launch.is_tensor_arg.at(arg_i)) {
+        continue;
+      }
+      auto io_it = io_index_map.find(getDataPointer(arg_buffer));
+      if (io_it != io_index_map.end()) {
+        graph->pointer_slots_.push_back(
+            {graph->kernel_nodes_.size(), arg_i, io_it->second});
+      }
+    }
+
+    const auto& lparams = launch.launch_params;
+    auto& params = kernel_node.params;
+    params.func = launch.function;
+    params.gridDimX = (unsigned int)lparams.gdimx();
+    params.gridDimY = (unsigned int)lparams.gdimy();
+    params.gridDimZ = (unsigned int)lparams.gdimz();
+    params.blockDimX = (unsigned int)lparams.bdimx();
+    params.blockDimY = (unsigned int)lparams.bdimy();
+    params.blockDimZ = (unsigned int)lparams.bdimz();
+    params.sharedMemBytes = (unsigned int)lparams.smem();
+    params.kernelParams = kernel_node.arg_ptrs.data();
+    params.extra = nullptr;
+    NVFUSER_CUDA_SAFE_CALL(cuGraphAddKernelNode(
+        &kernel_node.node,
+        graph->graph_,
+        last_node == nullptr ? nullptr : &last_node,
+        last_node == nullptr ? 0 : 1,
+        &params));
+    last_node = kernel_node.node;
+
+    graph->kernel_nodes_.push_back(std::move(kernel_node));
+  }
+
+  NVFUSER_CUDA_SAFE_CALL(
+      cuGraphInstantiateWithFlags(&graph->graph_exec_, graph->graph_, 0));
+
+  return graph;
+}
+
+FusionCudaGraph::~FusionCudaGraph() {
+  if (graph_exec_ != nullptr) {
+    NVFUSER_CUDA_SAFE_CALL(cuGraphExecDestroy(graph_exec_));
+  }
+  if (graph_ != nullptr) {
+    NVFUSER_CUDA_SAFE_CALL(cuGraphDestroy(graph_));
+  }
+}
+
+std::vector<at::Tensor> FusionCudaGraph::replay(
+    const KernelArgumentHolder& inputs) {
+  FUSER_PERF_SCOPE("FusionCudaGraph::replay");
+  NVF_ERROR(
+      inputs.size() == num_inputs_,
+      "Expected ",
+      num_inputs_,
+      " inputs to replay CUDA graph but received ",
+      inputs.size());
+
+  std::vector<at::Tensor> outputs;
+  outputs.reserve(outputs_.size());
+  for (const auto& info : outputs_) {
+    outputs.push_back(
+        at::empty_strided(info.sizes, info.strides, info.options));
+  }
+
+  // Find which inputs and outputs have moved since the last replay
+  std::vector<bool> io_changed(io_ptrs_.size(), false);
+  for (const auto i : c10::irange(io_ptrs_.size())) {
+    void* ptr = i < num_inputs_ ? inputs[i]->as<at::Tensor>().data_ptr()
+                                : outputs.at(i - num_inputs_).data_ptr();
+    if (ptr != io_ptrs_.at(i)) {
+      io_ptrs_.at(i) = ptr;
+      io_changed.at(i) = true;
+    }
+  }
+
+  std::vector<bool> node_changed(kernel_nodes_.size(), false);
+  for (const auto& slot : pointer_slots_) {
+    if (!io_changed.at(slot.io_index)) {
+      continue;
+    }
+    setDataPointer(
+        kernel_nodes_.at(slot.kernel_node).arg_buffers.at(slot.arg),
+        io_ptrs_.at(slot.io_index));
+    node_changed.at(slot.kernel_node) = true;
+  }
+
+  // Advance the generator as the launches of a regular run would
+  if (!rng_slots_.empty()) {
+    at::PhiloxCudaState philox_state;
+    auto gen = at::cuda::detail::getDefaultCUDAGenerator();
+    {
+      // See Note [Acquire lock when using random generators]
+      std::lock_guard<std::mutex> lock(gen.mutex());
+      philox_state =
+          at::check_generator<at::CUDAGeneratorImpl>(gen)->philox_cuda_state(
+              (uint64_t)rng_offset_increment_);
+    }
+    NVF_ERROR(
+        !philox_state.captured_,
+        "Replaying a CUDA graph with random ops while capturing another ",
+        "graph is not supported");
+    for (const auto& slot : rng_slots_) {
+      auto& arg_buffers = kernel_nodes_.at(slot.kernel_node).arg_buffers;
+      setIntValue(
+          arg_buffers.at(slot.seed_arg), (int64_t)philox_state.seed_.val);
+      setIntValue(
+          arg_buffers.at(slot.offset_arg),
+          (int64_t)philox_state.offset_.val + slot.intragraph_offset);
+      node_changed.at(slot.kernel_node) = true;
+    }
+  }
+
+  // The argument values are copied into the executable graph, so the
+  // argument buffers can be modified again right after this call
+  for (const auto i : c10::irange(kernel_nodes_.size())) {
+    if (!node_changed.at(i)) {
+      continue;
+    }
+    auto& kernel_node = kernel_nodes_.at(i);
+    kernel_node.params.kernelParams = kernel_node.arg_ptrs.data();
+    NVFUSER_CUDA_SAFE_CALL(cuGraphExecKernelNodeSetParams(
+        graph_exec_, kernel_node.node, &kernel_node.params));
+  }
+
+  NVFUSER_CUDA_SAFE_CALL(
+      cuGraphLaunch(graph_exec_, at::cuda::getCurrentCUDAStream().stream()));
+
+  return outputs;
+}
+
+} // namespace nvfuser
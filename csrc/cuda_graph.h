@@ -0,0 +1,146 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <exceptions.h>
+#include <executor.h>
+#include <executor_kernel_arg.h>
+#include <utils.h>
+
+#include <cuda.h>
+
+#include <memory>
+#include <vector>
+
+namespace nvfuser {
+
+//! [ CUDA Graph Replay of Segmented Fusions ]
+//!
+//! Launching a segmented fusion goes through FusionExecutor::runFusion once
+//! per segment. For small problem sizes, the host overhead of binding
+//! inputs, allocating intermediates and launching each kernel can be larger
+//! than the GPU time. When EnableOption::CudaGraph is set,
+//! FusionKernelRuntime records the kernel launches of the first run for a
+//! given input cache id and builds a CUDA graph out of them. Subsequent runs
+//! with the same cache id, i.e., the same sizes, strides and alignment of all
+//! inputs, are executed by launching that graph.
+//!
+//! The graph is built explicitly node by node from the recorded launches
+//! rather than by stream capture, so that no allocation happens while
+//! building it. All intermediate buffers of the recorded run, including the
+//! tensors passed between segments, are owned by the graph and reused by every
+//! replay. Buffers that need zero-initialization get a memset node in front
+//! of the kernel that uses them.
+//!
+//! The only things that change between replays are the data pointers of the
+//! fusion inputs and outputs. When building the graph, each tensor argument
+//! of each kernel is matched against those pointers and the matching
+//! argument slots are remembered. On replay, fresh outputs are allocated,
+//! and only the kernel nodes whose pointers actually changed are patched
+//! with cuGraphExecKernelNodeSetParams before the graph is launched.
+//!
+//! Fusions with random ops, like dropout, take the Philox seed and offset of
+//! the default CUDA generator as kernel arguments, which must advance on
+//! every run. On replay, the offsets of all the kernels of the graph are
+//! reserved from the generator at once, as PyTorch does for captured graphs,
+//! and the seed and offset arguments of the kernels with random ops are
+//! patched along with the data pointers. Each kernel gets the offset it
+//! would have had if the segments were launched one after another, so a
+//! replay draws the same numbers as a regular run.
+//!
+//! Fusions are not eligible when anything else baked into the kernel
+//! arguments can change without changing the cache id, e.g., scalar inputs.
+//! See FusionKernelRuntime::isCudaGraphCompatible.
+class FusionCudaGraph : public NonCopyable {
+ public:
+  //! Builds a graph from the launches recorded while running a fusion with
+  //! the given inputs, which produced the given outputs. Returns nullptr if
+  //! the recorded launches cannot be safely replayed as a graph.
+  static std::unique_ptr<FusionCudaGraph> create(
+      std::vector<FusionExecutor::LaunchRecord> launches,
+      const KernelArgumentHolder& inputs,
+      const std::vector<at::Tensor>& outputs);
+
+  ~FusionCudaGraph();
+
+  //! Allocates new outputs, points the graph at the given inputs and the new
+  //! outputs, and launches the graph on the current stream
+  std::vector<at::Tensor> replay(const KernelArgumentHolder& inputs);
+
+  //! Number of kernel nodes in the graph
+  size_t numKernels() const {
+    return kernel_nodes_.size();
+  }
+
+  //! The stream the graph was created on. Intermediate buffers are shared by
+  //! all replays, so the graph must not be replayed on other streams.
+  CUstream stream() const {
+    return stream_;
+  }
+
+ private:
+  FusionCudaGraph() = default;
+
+  struct KernelNode {
+    CUgraphNode node = nullptr;
+    CUDA_KERNEL_NODE_PARAMS params = {};
+    std::vector<std::vector<std::byte>> arg_buffers;
+    std::vector<void*> arg_ptrs;
+  };
+
+  //! A kernel argument holding the data pointer of a fusion input or output
+  struct PointerSlot {
+    size_t kernel_node = 0;
+    size_t arg = 0;
+    //! Index into the fusion inputs followed by the fusion outputs
+    size_t io_index = 0;
+  };
+
+  //! The RNG seed and offset arguments of a kernel with random ops
+  struct RNGSlot {
+    size_t kernel_node = 0;
+    size_t seed_arg = 0;
+    size_t offset_arg = 0;
+    //! Offset of the kernel from the first offset reserved for the graph
+    int64_t intragraph_offset = 0;
+  };
+
+  //! Sizes, strides and dtype to allocate a new output on replay
+  struct OutputInfo {
+    std::vector<int64_t> sizes;
+    std::vector<int64_t> strides;
+    at::TensorOptions options;
+  };
+
+ private:
+  CUgraph graph_ = nullptr;
+  CUgraphExec graph_exec_ = nullptr;
+
+  std::vector<KernelNode> kernel_nodes_;
+  std::vector<PointerSlot> pointer_slots_;
+  std::vector<RNGSlot> rng_slots_;
+
+  //! Offset all the kernels of the graph advance the default CUDA generator
+  //! by on each replay
+  int64_t rng_offset_increment_ = 0;
+  std::vector<OutputInfo> outputs_;
+
+  //! Data pointers of the fusion inputs and outputs currently set in the
+  //! instantiated graph
+  std::vector<void*> io_ptrs_;
+
+  size_t num_inputs_ = 0;
+
+  CUstream stream_ = nullptr;
+
+  //! Intermediate buffers referenced by the graph. They are allocated once
+  //! when the graph is created and live as long as the graph.
+  std::vector<at::Tensor> persistent_buffers_;
+};
+
+} // namespace nvfuser
@@ -7,13 +7,20 @@
 // clang-format on
 #include <device_lower/analysis/bank_conflict.h>
 
+#include <debug.h>
 #include <expr_evaluator.h>
+#include <fusion.h>
+#include <ir/cloner.h>
 #include <ir/utils.h>
+#include <iter_visitor.h>
 #include <kernel_ir.h>
 #include <kernel_ir_dispatch.h>
+#include <options.h>
 #include <polymorphic_value.h>
 #include <type.h>
 
+#include <memory>
+#include <optional>
 #include <unordered_set>
 
 namespace nvfuser {
@@ -278,4 +285,144 @@ std::unordered_map<const Expr*, std::pair<int, int>> getBankConflictInfo(
   return BankConflictInfo::get(kernel, launch_params, known_values);
 }
 
+namespace {
+
+using TvBankConflictInfo = std::
+    unordered_map<TensorView*, std::pair<std::vector<int>, std::vector<int>>>;
+
+// The analysis evaluates the indices of the first iteration, which fails if
+// they depend on values only known at run time
+std::optional<TvBankConflictInfo> maybeGetBankConflictInfo(
+    Fusion* fusion,
+    const CompileParams& compile_params,
+    const LaunchParams& launch_params) {
+  try {
+    return fusion->bankConflictInfo(compile_params, launch_params);
+  } catch (const std::exception& e) {
+    if (isDebugDumpEnabled(DebugDumpOption::BankConflictInfo)) {
+      debug() << "Could not analyze bank conflicts: " << e.what()
+              << std::endl;
+    }
+    return std::nullopt;
+  }
+}
+
+// Sum of the conflict ways of all accesses of tv, 0 if there are none
+int64_t getTotalConflictWays(const TvBankConflictInfo& info, TensorView* tv) {
+  auto it = info.find(tv);
+  if (it == info.end()) {
+    return 0;
+  }
+  int64_t ways = 0;
+  for (auto way : it->second.first) {
+    ways += way;
+  }
+  for (auto way : it->second.second) {
+    ways += way;
+  }
+  return ways;
+}
+
+bool canSwizzle(TensorView* tv) {
+  if (tv->hasSwizzleOp()) {
+    return false;
+  }
+  std::vector<Expr*> exprs = tv->uses();
+  if (tv->definition() != nullptr) {
+    exprs.push_back(tv->definition());
+  }
+  return std::none_of(exprs.begin(), exprs.end(), [](Expr* expr) {
+    return expr->isA<MmaOp>() ||
+        (expr->isA<LoadStoreOp>() &&
+         expr->as<LoadStoreOp>()->opType() != LoadStoreOpType::Set);
+  });
+}
+
+// Pairs of leaf positions an XOR data swizzle can be applied to, innermost
+// first. See [ Automatic Bank Conflict Swizzle ].
+std::vector<std::pair<int, int>> getSwizzleCandidates(TensorView* tv) {
+  const int start = (int)std::max(
+      tv->getMaxComputePosition(), tv->getMaybeMaxProducerPosition());
+  std::vector<std::pair<int, int64_t>> positions_and_extents;
+  for (int pos = start; pos < (int)tv->nDims(); pos++) {
+    IterDomain* id = tv->axis(pos);
+    if (!id->extent()->isConstInt() ||
+        isParallelTypeVectorize(id->getParallelType())) {
+      continue;
+    }
+    const int64_t extent = id->extent()->evaluate().as<int64_t>();
+    if (extent <= 1 || (extent & (extent - 1)) != 0) {
+      continue;
+    }
+    auto root_ids = ir_utils::filterByType<IterDomain>(InputsOf::output(id));
+    if (std::any_of(root_ids.begin(), root_ids.end(), [](IterDomain* root_id) {
+          return root_id->isBroadcast() || root_id->isReduction();
+        })) {
+      continue;
+    }
+    positions_and_extents.emplace_back(pos, extent);
+  }
+
+  std::vector<std::pair<int, int>> candidates;
+  for (auto y_it = positions_and_extents.rbegin();
+       y_it != positions_and_extents.rend();
+       y_it++) {
+    for (auto x_it = std::next(y_it); x_it != positions_and_extents.rend();
+         x_it++) {
+      if (x_it->second == y_it->second) {
+        candidates.emplace_back(x_it->first, y_it->first);
+      }
+    }
+  }
+  return candidates;
+}
+
+} // namespace
+
+std::vector<TensorView*> swizzleBankConflicts(
+    Fusion* fusion,
+    const CompileParams& compile_params,
+    const LaunchParams& launch_params) {
+  const auto info =
+      maybeGetBankConflictInfo(fusion, compile_params, launch_params);
+  if (!info.has_value() || info->empty()) {
+    return {};
+  }
+
+  std::vector<TensorView*> swizzled_tvs;
+  // Visit the tensors in a deterministic order
+  for (auto tv : ir_utils::allTvs(fusion)) {
+    const int64_t conflict_ways = getTotalConflictWays(*info, tv);
+    if (conflict_ways == 0 || !canSwizzle(tv)) {
+      continue;
+    }
+    for (auto [x, y] : getSwizzleCandidates(tv)) {
+      auto fusion_copy = std::make_unique<Fusion>();
+      IrCloner ir_cloner = Fusion::copy(fusion, fusion_copy.get());
+      TensorView* tv_copy = ir_cloner.clone(tv);
+      tv_copy->swizzle(Swizzle2DType::XOR, x, y);
+      const auto swizzled_info = maybeGetBankConflictInfo(
+          fusion_copy.get(), compile_params, launch_params);
+      if (!swizzled_info.has_value()) {
+        continue;
+      }
+      const int64_t swizzled_conflict_ways =
+          getTotalConflictWays(*swizzled_info, tv_copy);
+      if (swizzled_conflict_ways >= conflict_ways) {
+        continue;
+      }
+      tv->swizzle(Swizzle2DType::XOR, x, y);
+      swizzled_tvs.push_back(tv);
+      if (isDebugDumpEnabled(DebugDumpOption::BankConflictInfo)) {
+        debug() << "Swizzled axes " << x << " and " << y << " of "
+                << tv->toString() << " to reduce bank conflicts from "
+                << conflict_ways << " to " << swizzled_conflict_ways
+                << " ways" << std::endl;
+      }
+      break;
+    }
+  }
+  return swizzled_tvs;
+}
+
 } // namespace nvfuser
@@ -15,6 +15,7 @@
 
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 namespace nvfuser {
 
@@ -48,4 +49,30 @@ std::unordered_map<const Expr*, std::pair<int, int>> getBankConflictInfo(
     LaunchParams launch_params = {},
     const std::unordered_map<Val*, PolymorphicValue>& known_values = {});
 
+//! [ Automatic Bank Conflict Swizzle ]
+//!
+//! Schedulers have to apply swizzles by hand to avoid bank conflicts of
+//! shared memory tensors. With NVFUSER_ENABLE=bank_conflict_swizzle,
+//! FusionExecutor::compileFusion calls swizzleBankConflicts before lowering
+//! to do it for them. It lowers the fusion, and for each shared memory
+//! tensor the analysis above reports conflicts for, tries XOR data swizzles
+//! of pairs of its leaf domains. A candidate pair is
+//!  - to the right of the compute-at and max producer positions, so the
+//!    swizzle doesn't change any loop,
+//!  - of equal, constant, power-of-two extents, as required by XOR,
+//!  - not vectorized and not derived from broadcast or reduction domains.
+//! Each candidate is applied to a copy of the fusion, which is lowered and
+//! analyzed again. The first candidate that reduces the conflicts of the
+//! tensor is applied to the fusion. Since the analysis only evaluates the
+//! first iteration of each access, see the limitations above, a swizzle is
+//! only kept if the analysis verifies it helps.
+//!
+//! Tensors that already have a swizzle, or that are accessed by ldmatrix,
+//! cp.async or other non-set ops, are left alone. Returns the swizzled
+//! tensors.
+std::vector<TensorView*> swizzleBankConflicts(
+    Fusion* fusion,
+    const CompileParams& compile_params = CompileParams(),
+    const LaunchParams& launch_params = {});
+
 } // namespace nvfuser
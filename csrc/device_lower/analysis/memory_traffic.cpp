@@ -0,0 +1,158 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <device_lower/analysis/memory_traffic.h>
+
+#include <ir/utils.h>
+#include <kernel_ir.h>
+#include <kernel_ir_dispatch.h>
+#include <type.h>
+#include <utils.h>
+
+#include <optional>
+#include <unordered_set>
+#include <vector>
+
+namespace nvfuser {
+
+namespace {
+
+class MemoryTraffic : private kir::ConstIrVisitor {
+ public:
+  static MemoryTrafficEstimate get(
+      const kir::Kernel* kernel,
+      ExpressionEvaluator& expr_eval) {
+    MemoryTraffic visitor(expr_eval);
+    std::vector<const Expr*> exprs(
+        kernel->topLevelExprs().begin(), kernel->topLevelExprs().end());
+    visitor.handle(exprs);
+    return visitor.estimate_;
+  }
+
+ private:
+  explicit MemoryTraffic(ExpressionEvaluator& expr_eval)
+      : expr_eval_(expr_eval) {}
+
+  using kir::ConstIrVisitor::dispatch;
+  using kir::ConstIrVisitor::handle;
+
+  void dispatch(const Expr* expr) final {
+    if (expr->isA<kir::ForLoop>() || expr->isA<kir::IfThenElse>()) {
+      kir::ConstIrVisitor::dispatch(expr);
+      return;
+    }
+    for (auto inp : expr->inputs()) {
+      if (auto ti = globalTensorIndex(inp)) {
+        estimate_.load_bytes += accessBytes(ti);
+        if (loaded_tvs_.insert(ti->view()).second) {
+          estimate_.unique_load_bytes += tensorBytes(ti->view());
+        }
+      }
+    }
+    for (auto out : expr->outputs()) {
+      if (auto ti = globalTensorIndex(out)) {
+        estimate_.store_bytes += accessBytes(ti);
+        if (stored_tvs_.insert(ti->view()).second) {
+          estimate_.unique_store_bytes += tensorBytes(ti->view());
+        }
+      }
+    }
+  }
+
+  void handle(const kir::ForLoop* for_loop) final {
+    const int64_t saved_iterations = iterations_;
+    iterations_ *= tripCount(for_loop);
+    if (iterations_ > 0) {
+      kir::ConstIrVisitor::handle(for_loop);
+    }
+    iterations_ = saved_iterations;
+  }
+
+  void handle(const kir::IfThenElse* ite) final {
+    const Scope& scope =
+        ite->thenBody().empty() ? ite->elseBody() : ite->thenBody();
+    for (auto expr : scope.exprs()) {
+      dispatch(expr);
+    }
+  }
+
+  static const kir::TensorIndex* globalTensorIndex(const Val* val) {
+    auto ti = dynamic_cast<const kir::TensorIndex*>(val);
+    if (ti == nullptr || ti->view()->getMemoryType() != MemoryType::Global) {
+      return nullptr;
+    }
+    return ti;
+  }
+
+  int64_t accessBytes(const kir::TensorIndex* ti) const {
+    return iterations_ * (int64_t)dataTypeSize(ti->dtype());
+  }
+
+  std::optional<int64_t> evaluate(Val* val) {
+    PolymorphicValue value = expr_eval_.evaluate(val);
+    if (!value.hasValue()) {
+      return std::nullopt;
+    }
+    return value.as<int64_t>();
+  }
+
+  int64_t tripCount(const kir::ForLoop* for_loop) {
+    IterDomain* id = for_loop->iter_domain();
+    if (!id->isThread() && !for_loop->vectorize()) {
+      auto start = evaluate(for_loop->start());
+      auto stop = evaluate(for_loop->stop());
+      auto step = evaluate(for_loop->step());
+      if (start.has_value() && stop.has_value() && step.has_value() &&
+          step.value() > 0) {
+        return std::max(
+            ceilDiv(stop.value() - start.value(), step.value()), (int64_t)0);
+      }
+    }
+    // The extent of the loop, also when its bounds depend on the index of an
+    // enclosing loop
+    if (auto extent = evaluate(id->extent())) {
+      return extent.value();
+    }
+    estimate_.complete = false;
+    return 1;
+  }
+
+  int64_t tensorBytes(TensorView* tv) {
+    int64_t numel = 1;
+    for (IterDomain* id :
+         TensorDomain::noReductions(tv->getMaybeAllocationDomain())) {
+      if (id->isBroadcast()) {
+        continue;
+      }
+      auto extent = evaluate(id->extent());
+      if (!extent.has_value()) {
+        estimate_.complete = false;
+        return 0;
+      }
+      numel *= extent.value();
+    }
+    return numel * (int64_t)dataTypeSize(tv->dtype());
+  }
+
+ private:
+  ExpressionEvaluator& expr_eval_;
+  //! Product of the trip counts of the enclosing loops
+  int64_t iterations_ = 1;
+  std::unordered_set<const TensorView*> loaded_tvs_;
+  std::unordered_set<const TensorView*> stored_tvs_;
+  MemoryTrafficEstimate estimate_;
+};
+
+} // namespace
+
+MemoryTrafficEstimate estimateMemoryTraffic(
+    const kir::Kernel* kernel,
+    ExpressionEvaluator& expr_eval) {
+  return MemoryTraffic::get(kernel, expr_eval);
+}
+
+} // namespace nvfuser
@@ -0,0 +1,56 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <exceptions.h>
+#include <expr_evaluator.h>
+#include <kernel.h>
+
+#include <cstdint>
+
+namespace nvfuser {
+
+//! [ Memory Traffic Model ]
+//!
+//! FusionExecutor::inputBytesProcessed and outputBytesProcessed count the
+//! bytes of the tensors, which is the DRAM traffic of a kernel only if every
+//! element is read and written once. A broadcast input of a non-persistent
+//! normalization is read once per reduction pass, and an input broadcast to
+//! many blocks is read by each of them.
+//!
+//! estimateMemoryTraffic walks the lowered kernel and counts, for each
+//! expression accessing a global TensorIndex, the element size times the
+//! product of the trip counts of its enclosing loops. Thread-parallel and
+//! vectorized loops count their extent, serial loops (stop - start) / step.
+//! Predicates are ignored, so partial tiles count as full ones, and of an
+//! IfThenElse only the then branch is counted, as the else branch of an
+//! unswitched loop nest repeats the same accesses. The ratio of the modeled
+//! bytes to the bytes of the tensors is the number of times a kernel reads
+//! or writes each element; comparing the modeled bytes with the DRAM bytes
+//! measured by the profiler, see [ Kernel Metrics ], tells how much of it the
+//! caches absorb. Accesses of the work buffers hidden in grid reductions and
+//! grid broadcasts aren't modeled.
+struct MemoryTrafficEstimate {
+  //! Bytes loaded from and stored to global memory by all threads
+  int64_t load_bytes = 0;
+  int64_t store_bytes = 0;
+  //! Bytes of the global tensors read and written, each counted once
+  int64_t unique_load_bytes = 0;
+  int64_t unique_store_bytes = 0;
+  //! False if a loop trip count or a tensor size couldn't be evaluated, in
+  //! which case it is counted as 1, respectively ignored
+  bool complete = true;
+};
+
+//! Estimates the global memory traffic of a launch of the kernel. expr_eval
+//! must bind the inputs of the kernel and the launch dimensions.
+MemoryTrafficEstimate estimateMemoryTraffic(
+    const kir::Kernel* kernel,
+    ExpressionEvaluator& expr_eval);
+
+} // namespace nvfuser
@@ -164,9 +164,13 @@ class PredicateAnalyzer : public OptOutDispatch {
       return;
     }
 
+    // The divisor is known from constant extents and, for kernels
+    // specialized for a size class, from the input sizes. See
+    // [ Size-Specialized Predicate Elimination ]
     auto in_extent = split->in()->extent();
-
-    if (!in_extent->isConstInt() || ((in_extent->evaluate() % factor) != 0)) {
+    if (GpuLower::current()->getKnownDivisor(in_extent) %
+            factor.as<int64_t>() !=
+        0) {
       needs_predicate_ = true;
       return;
     }
@@ -16,6 +16,33 @@
 
 namespace nvfuser {
 
+//! [ Size-Specialized Predicate Elimination ]
+//!
+//! The predicate of an expression can be omitted if none of the splits of
+//! its consumer can make an index exceed the extent of the split input,
+//! i.e., if the input extents are divisible by the split factors. Without
+//! further information, this can only be proved for constant extents, but
+//! most problems have sizes that are multiples of small powers of two.
+//!
+//! With NVFUSER_ENABLE=size_specialization, SchedulerEntry::makeEntry
+//! records the largest power-of-two divisor of each input extent, up to
+//! scheduler_utils::kMaxExtentDivisor, in CompileParams::extent_divisors.
+//! The compile parameters are part of the heuristic parameters, so inputs
+//! of another size class get another FusionKernelRuntime, i.e., a kernel is
+//! specialized per size class. GpuLower::getKnownDivisor propagates the
+//! divisors through the extents of merges and splits, which lets both the
+//! predicate elimination and NonDivisibleSplitInfo treat splits that are
+//! divisible for the size class like splits of constant extents. Since the
+//! kernel is only valid for its size class, the executor validates the
+//! divisors of the input extents before each launch.
+//!
+//! Every power of two is a size class of its own, so dynamic shapes can
+//! compile many kernels. With a divisor given to the option, e.g.,
+//! NVFUSER_ENABLE=size_specialization(128) for the hidden sizes of serving
+//! workloads, each extent is only either divisible by the divisor or not.
+//! Inputs whose extents are multiples of it share a kernel without the
+//! predicates and with the vectorization of the divisible splits, and the
+//! other inputs fall back to a generic kernel, which assumes no divisibility.
 class PredicateElimination : public IterVisitor {
  public:
   PredicateElimination(Fusion* fusion);
@@ -0,0 +1,86 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <device_lower/analysis/register_pressure.h>
+
+#include <kernel_ir.h>
+#include <kernel_ir_dispatch.h>
+#include <type.h>
+#include <utils.h>
+
+#include <vector>
+
+namespace nvfuser {
+
+namespace {
+
+constexpr int64_t kBytesPerRegister = 4;
+
+class LocalBufferRegisters : private kir::ConstIrVisitor {
+ public:
+  static int64_t get(const kir::Kernel* kernel) {
+    LocalBufferRegisters visitor;
+    visitor.openScope();
+    std::vector<const Expr*> exprs(
+        kernel->topLevelExprs().begin(), kernel->topLevelExprs().end());
+    visitor.handle(exprs);
+    visitor.closeScope();
+    return visitor.max_live_registers_;
+  }
+
+ private:
+  using kir::ConstIrVisitor::handle;
+
+  void handle(const kir::ForLoop* for_loop) final {
+    openScope();
+    kir::ConstIrVisitor::handle(for_loop);
+    closeScope();
+  }
+
+  void handle(const kir::IfThenElse* ite) final {
+    openScope();
+    kir::ConstIrVisitor::handle(ite);
+    closeScope();
+  }
+
+  void handle(const kir::Allocate* alloc) final {
+    if (alloc->memoryType() != MemoryType::Local ||
+        alloc->alias() != nullptr || !alloc->size()->isConstInt()) {
+      return;
+    }
+    const int64_t registers = ceilDiv(
+        alloc->size()->evaluate().as<int64_t>() *
+            (int64_t)dataTypeSize(alloc->buffer()->dtype()),
+        kBytesPerRegister);
+    live_registers_ += registers;
+    scope_registers_.back() += registers;
+    max_live_registers_ = std::max(max_live_registers_, live_registers_);
+  }
+
+  void openScope() {
+    scope_registers_.push_back(0);
+  }
+
+  void closeScope() {
+    live_registers_ -= scope_registers_.back();
+    scope_registers_.pop_back();
+  }
+
+ private:
+  // Registers allocated in each open scope
+  std::vector<int64_t> scope_registers_;
+  int64_t live_registers_ = 0;
+  int64_t max_live_registers_ = 0;
+};
+
+} // namespace
+
+int64_t estimateLocalBufferRegisters(const kir::Kernel* kernel) {
+  return LocalBufferRegisters::get(kernel);
+}
+
+} // namespace nvfuser
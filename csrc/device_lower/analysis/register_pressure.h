@@ -0,0 +1,30 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <exceptions.h>
+#include <kernel.h>
+
+#include <cstdint>
+
+namespace nvfuser {
+
+//! Estimates how many 32-bit registers per thread the local buffers of a
+//! lowered kernel need at the same time. A local allocation is live from its
+//! Allocate to the end of the scope it is allocated in, and the estimate is
+//! the maximum of the sizes of the live allocations over the kernel.
+//! Allocations aliasing another allocation don't add to it. Registers used
+//! for indexing, predicates and other scalars are not included, nor is the
+//! register allocation of the compiler modeled, so this is only a lower bound
+//! that grows with the persistent buffers of a schedule.
+//!
+//! Local allocations of non-constant size are ignored, since they are placed
+//! in local memory anyway.
+int64_t estimateLocalBufferRegisters(const kir::Kernel* kernel);
+
+} // namespace nvfuser
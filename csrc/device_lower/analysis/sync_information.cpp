@@ -552,7 +552,10 @@ SyncMap::SyncMap(Fusion* fusion) {
         for (auto parallel_type : kParallelTypeThreads) {
           // TIDx is reserved for lane_id in the case of mma ops.
           //  It is swizzled and handled separately in validateMma.
-          if (parallel_type == ParallelType::TIDx && expr->isA<MmaOp>()) {
+          //  Warp transposes exchange their tiles across the lanes of
+          //  TIDx with shuffles. See [ Register Transpose ]
+          if (parallel_type == ParallelType::TIDx &&
+              (expr->isA<MmaOp>() || ir_utils::isWarpTransposeOp(expr))) {
             continue;
           }
 
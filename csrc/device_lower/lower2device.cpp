@@ -16,6 +16,7 @@
 #include <device_lower/pass/double_buffer.h>
 #include <device_lower/pass/expr_sort.h>
 #include <device_lower/pass/fusion_simplifier.h>
+#include <device_lower/pass/grid_serialization.h>
 #include <device_lower/pass/index.h>
 #include <device_lower/pass/inline_ptx.h>
 #include <device_lower/pass/insert_syncs.h>
@@ -38,6 +39,10 @@
 #include <ir/iostream.h>
 #include <ir/utils.h>
 
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <future>
 #include <list>
 #include <unordered_map>
 #include <unordered_set>
@@ -272,7 +277,9 @@ GpuLower::GpuLower(Fusion* fusion, const CompileParams& cparams)
            {"rotateLoops", rotateLoops},
            {"UnrollPass", UnrollPass::runPass},
            {"processMisalignedVectorization", processMisalignedVectorization},
+           {"findHoistableUnrolledLoops", findHoistableUnrolledLoops},
            {"IndexLowering", IndexLowering::getIndexedExprs},
+           {"insertGridSerializationSyncs", insertGridSerializationSyncs},
            {"fuseWarpReduce", fuseWarpReduce},
            {"generateConditionalFromPredicate",
             generateConditionalFromPredicate},
@@ -286,19 +293,8 @@ GpuLower::GpuLower(Fusion* fusion, const CompileParams& cparams)
   analysis(fusion);
 }
 
-namespace {
-struct LowerGuard {
-  LowerGuard(GpuLower* gpu_lower) {
-    active_gpu_lower = gpu_lower;
-  }
-  ~LowerGuard() {
-    active_gpu_lower = nullptr;
-  }
-};
-
-} // namespace
-
 kir::Kernel* GpuLower::run() {
+  FUSER_PERF_SCOPE("GpuLower::run");
   FusionGuard fg(fusion_);
   LowerGuard lower_guard(this);
   // Reorder expressions for loop-nest generation respecting computeAt
@@ -316,6 +312,7 @@ kir::Kernel* GpuLower::run() {
   assignRNGOffset(fusion_);
 
   for (auto [name, pass] : passes()) {
+    FUSER_PERF_SCOPE(name.c_str());
     exprs_lowered = pass(exprs_lowered);
     dumpExprsIfEnabled(exprs_lowered, name);
   }
@@ -328,6 +325,60 @@ kir::Kernel* GpuLower::run() {
   return kernel_.get();
 }
 
+void GpuLower::releaseAnalyses() {
+  passes_.clear();
+  concretized_broadcast_domains_.reset();
+  thread_pred_map_ = ThreadPredicateMap();
+  pred_elimination_.reset();
+  compute_at_map_.reset();
+  halo_info_.reset();
+  local_allocation_info_map_.clear();
+  sync_map_.reset();
+  divisible_splits_.clear();
+  vectorized_accesses_.clear();
+  vectorized_set_info_.clear();
+  ldst_mbarrier_map_.clear();
+  hoistable_loop_indices_.clear();
+}
+
+namespace {
+
+struct LowerGuard {
+  LowerGuard(GpuLower* gpu_lower) {
+    active_gpu_lower = gpu_lower;
+  }
+  ~LowerGuard() {
+    active_gpu_lower = nullptr;
+  }
+};
+
+//! Runs analysis on another thread, concurrently with the calling one, if
+//! EnableOption::ParallelLowering is set, and right away otherwise. The
+//! thread has the same active fusion, lowering and debug stream as the
+//! calling one. See [ Parallel Lowering ]
+std::future<void> launchAnalysis(
+    GpuLower* gpu_lower,
+    Fusion* fusion,
+    std::function<void()> analysis) {
+  if (!isOptionEnabled(EnableOption::ParallelLowering)) {
+    analysis();
+    std::promise<void> done;
+    done.set_value();
+    return done.get_future();
+  }
+  std::ostream& stream = debug();
+  return std::async(
+      std::launch::async,
+      [gpu_lower, fusion, &stream, analysis = std::move(analysis)]() {
+        DebugStreamGuard dsg(stream);
+        FusionGuard fg(fusion);
+        LowerGuard lower_guard(gpu_lower);
+        analysis();
+      });
+}
+
+} // namespace
+
 void GpuLower::analysis(Fusion* fusion) {
   FUSER_PERF_SCOPE("GpuLower::lower");
   NVF_ERROR(fusion != nullptr);
@@ -376,7 +427,10 @@ void GpuLower::analysis(Fusion* fusion) {
   // mappings of all iteration domains across the fusion. There are three types
   // of mappings Permissive, Exact, and Loop, see compute_at_map.h/cpp for more
   // information.
-  compute_at_map_ = std::make_shared<ComputeAtMap>(fusion_);
+  {
+    FUSER_PERF_SCOPE("GpuLower::lower::ComputeAtMap");
+    compute_at_map_ = std::make_shared<ComputeAtMap>(fusion_);
+  }
 
   // Transitory testing of IdModel if enabled. No existing
   // functionality should be affected. New IterDomains may be created,
@@ -395,13 +449,17 @@ void GpuLower::analysis(Fusion* fusion) {
   compute_at_map_->validateAndPropagatePType();
   dumpExprsIfEnabled(fusion_->exprs(), "validateAndPropagatePType");
 
+  // Used in parallel dimension map
+  auto concretized_broadcast_domains = launchAnalysis(this, fusion_, [this]() {
+    concretized_broadcast_domains_ =
+        std::make_shared<const ConcretizedBroadcastDomains>(fusion_);
+  });
+
   // Uses compute_at_map, find all splits that are enforced to be divisible
   divisible_splits_ = getAllDivisibleSplits(fusion_, compute_at_map_.get());
   dumpExprsIfEnabled(fusion_->exprs(), "getAllDivisibleSplits");
 
-  // Used in parallel dimension map
-  concretized_broadcast_domains_ =
-      std::make_shared<const ConcretizedBroadcastDomains>(fusion_);
+  concretized_broadcast_domains.get();
   dumpExprsIfEnabled(fusion_->exprs(), "build ConcretizedBroadcastDomains");
 
   parallelDimensionMap().build(fusion_);
@@ -411,19 +469,37 @@ void GpuLower::analysis(Fusion* fusion) {
   }
   dumpExprsIfEnabled(fusion_->exprs(), "build parallelDimensionMap");
 
-  // Validate mma data format and compatibility if any on the fusion.
-  validateMma(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "validateMma");
-
-  // Validate swizzle usage on the fusion schedule.
-  validateSwizzle(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "validateSwizzle");
+  // See [ Warp Segment Reduction ]
+  if (cparams_.enable_warp_segment_reduction &&
+      !warp_pad_info_.is_tidx_padded &&
+      parallelDimensionMap().isExact(ParallelType::TIDx)) {
+    auto tidx = parallelDimensionMap().getRaw(ParallelType::TIDx);
+    if (tidx != nullptr && tidx->isConstInt()) {
+      auto size = tidx->evaluate().as<int64_t>();
+      if (size > 1 && size < at::cuda::warp_size() &&
+          (size & (size - 1)) == 0) {
+        warp_pad_info_.tidx_warp_segment_size = size;
+      }
+    }
+  }
 
-  validateResize(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "validateResize");
+  // The validations only read the fusion, so they run concurrently with the
+  // thread predicate analysis
+  auto validations = launchAnalysis(this, fusion_, [this]() {
+    // Validate mma data format and compatibility if any on the fusion.
+    validateMma(fusion_);
+    // Validate swizzle usage on the fusion schedule.
+    validateSwizzle(fusion_);
+    validateResize(fusion_);
+  });
 
   // Compute thread predicates. Depends on parallel_dimension_map_
   thread_pred_map_.build(fusion_);
+
+  validations.get();
+  dumpExprsIfEnabled(fusion_->exprs(), "validateMma");
+  dumpExprsIfEnabled(fusion_->exprs(), "validateSwizzle");
+  dumpExprsIfEnabled(fusion_->exprs(), "validateResize");
   dumpExprsIfEnabled(fusion_->exprs(), "build thread_pred_map_");
 
   // Fuse cetain patterns of reductions, such as a grid reduction
@@ -470,6 +546,26 @@ void GpuLower::analysis(Fusion* fusion) {
   validatePartialSplit(fusion_);
   dumpExprsIfEnabled(fusion_->exprs(), "validatePartialSplit");
 
+  // See [ Size-Specialized Predicate Elimination ]
+  if (!cparams_.extent_divisors.empty()) {
+    auto divisor_it = cparams_.extent_divisors.begin();
+    for (auto tv : ir_utils::filterByType<TensorView>(fusion_->inputs())) {
+      for (auto id : tv->getRootDomain()) {
+        NVF_ERROR(
+            divisor_it != cparams_.extent_divisors.end(),
+            "Fewer extent divisors than root domains of the fusion inputs");
+        if (!id->extent()->isConstScalar()) {
+          extent_divisors_.emplace(id->extent(), *divisor_it);
+        }
+        ++divisor_it;
+      }
+    }
+    NVF_ERROR(
+        divisor_it == cparams_.extent_divisors.end(),
+        "More extent divisors than root domains of the fusion inputs");
+  }
+
+  // Depends on extent_divisors_
   nonDivisibleSplitInfo().build(fusion_);
   dumpExprsIfEnabled(fusion_->exprs(), "build nonDivisibleSplitInfo");
 
@@ -485,6 +581,47 @@ void GpuLower::analysis(Fusion* fusion) {
   dumpExprsIfEnabled(fusion_->exprs(), "allocateIndexVariables");
 }
 
+int64_t GpuLower::getKnownDivisor(Val* extent) const {
+  if (extent->isConstInt()) {
+    return std::abs(extent->evaluate().as<int64_t>());
+  }
+  if (auto it = extent_divisors_.find(extent); it != extent_divisors_.end()) {
+    return it->second;
+  }
+  auto bop = dynamic_cast<BinaryOp*>(extent->definition());
+  if (bop == nullptr) {
+    return 1;
+  }
+  switch (bop->getBinaryOpType()) {
+    case BinaryOpType::Mul: {
+      int64_t divisor =
+          getKnownDivisor(bop->lhs()) * getKnownDivisor(bop->rhs());
+      // Keep only a power-of-two divisor of large products, so nested
+      // merges can't overflow
+      constexpr int64_t max_divisor = (int64_t)1 << 32;
+      if (divisor > max_divisor) {
+        divisor = std::min(divisor & -divisor, max_divisor);
+      }
+      return divisor;
+    }
+    case BinaryOpType::Div:
+    case BinaryOpType::CeilDiv: {
+      // Exact if the factor divides the divisor of the dividend
+      if (!bop->rhs()->isConstInt()) {
+        return 1;
+      }
+      auto factor = bop->rhs()->evaluate().as<int64_t>();
+      auto divisor = getKnownDivisor(bop->lhs());
+      if (factor <= 0 || divisor % factor != 0) {
+        return 1;
+      }
+      return divisor / factor;
+    }
+    default:
+      return 1;
+  }
+}
+
 kir::Kernel* GpuLower::kernel() const {
   NVF_CHECK(kernel_);
   return kernel_.get();
@@ -501,6 +638,10 @@ bool GpuLower::hasCurrent() {
 
 void GpuLower::propagateExprInfo(const Expr* old_expr, const Expr* new_expr) {
   predicateElimination().propagateRemovalInfo(old_expr, new_expr);
+  auto mbarrier_it = ldstMBarrierMap().find(old_expr);
+  if (mbarrier_it != ldstMBarrierMap().end()) {
+    ldstMBarrierMap().emplace(new_expr, mbarrier_it->second);
+  }
   if (old_expr->isA<kir::Allocate>()) {
     auto alloc_info_it =
         localAllocationInfoMap().find(old_expr->as<kir::Allocate>());
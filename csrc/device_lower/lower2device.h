@@ -41,6 +41,19 @@
 
 namespace nvfuser {
 
+//! [ Parallel Lowering ]
+//!
+//! The global state lowering depends on, i.e., the active fusion of
+//! FusionGuard, GpuLower::current() and the debug stream, is thread-local,
+//! and the IR container serializes the registration of statements, see
+//! [ Thread-Safe Registration ]. With EnableOption::ParallelLowering, the
+//! analyses of GpuLower::analysis that only read the fusion and don't depend
+//! on each other run on other threads with the same thread-local state:
+//! ConcretizedBroadcastDomains concurrently with the divisible splits, and
+//! the mma, swizzle and resize validations concurrently with the thread
+//! predicates. The lowering passes of GpuLower::run transform the
+//! expressions in sequence, so they stay on the calling thread.
+//!
 // TODO: we frequently use pairwise root mapping from consumers to producers.
 // This information is implicitly in the computeAtMaps, but there's no isolated
 // container for this information that we can reuse. Would be nice to generate
@@ -77,6 +90,18 @@ class GpuLower : public NonCopyable {
   //! passes_
   kir::Kernel* run();
 
+  //! [ Releasing Lowering Info ]
+  //!
+  //! The analyses of the lowering, e.g., the ComputeAtMap, the thread
+  //! predicates and the predicate elimination, take more host memory than the
+  //! kernel itself, but the kernel copies what its launches need into its
+  //! summary when it's finalized. With EnableOption::ReleaseLoweringInfo, a
+  //! FusionExecutor releases them once its kernel is compiled, which matters
+  //! for processes that cache thousands of fusions. The kernel IR and the
+  //! ParallelDimensionMap are kept, as the launches bind their inputs and
+  //! compute their launch parameters and buffers from them.
+  void releaseAnalyses();
+
   const PrimDataType& indexType() const {
     return cparams_.index_type.value();
   }
@@ -150,6 +175,16 @@ class GpuLower : public NonCopyable {
     return divisible_splits_;
   }
 
+  //! Extents of the root domains of the fusion inputs and their divisors
+  //! given by the compile parameters
+  const std::unordered_map<Val*, int64_t>& extentDivisors() const {
+    return extent_divisors_;
+  }
+
+  //! Largest divisor of an extent known at compile time. See
+  //! [ Size-Specialized Predicate Elimination ]
+  int64_t getKnownDivisor(Val* extent) const;
+
   DoubleBufferInfo& doubleBufferInfo() {
     return double_buffer_info_;
   }
@@ -194,6 +229,16 @@ class GpuLower : public NonCopyable {
     return ldst_mbarrier_map_;
   }
 
+  //! Indices of the unrolled loops that are left unprotected by magic zero,
+  //! see [ Magic Zero Elision ]
+  std::unordered_set<Val*>& hoistableLoopIndices() {
+    return hoistable_loop_indices_;
+  }
+
+  const std::unordered_set<Val*>& hoistableLoopIndices() const {
+    return hoistable_loop_indices_;
+  }
+
   bool isNvFuserZeroEnabled() {
     if (isOptionDisabled(DisableOption::MagicZero)) {
       return false;
@@ -201,6 +246,10 @@ class GpuLower : public NonCopyable {
     return cparams_.enable_magic_zero;
   }
 
+  bool isFastMathEnabled() const {
+    return cparams_.enable_fast_math;
+  }
+
   // This is an interface to propagate information after expression
   //  replacement on the kernel IR. E.g.:
   //    for ...
@@ -269,6 +318,7 @@ class GpuLower : public NonCopyable {
   std::shared_ptr<const SyncMap> sync_map_;
   kir::KernelPerformanceProfile profile_;
   std::unordered_set<Split*> divisible_splits_;
+  std::unordered_map<Val*, int64_t> extent_divisors_;
   CompileParams cparams_;
 
   // Track which tensor views are inputs or outputs of a vectorized operation
@@ -285,6 +335,9 @@ class GpuLower : public NonCopyable {
   // keep track of the mbarrier used for each load/store operation
   std::unordered_map<const Expr*, TensorView*> ldst_mbarrier_map_;
 
+  // Indices of the unrolled loops that don't need magic zero
+  std::unordered_set<Val*> hoistable_loop_indices_;
+
   Fusion* fusion_ = nullptr;
 };
 
@@ -36,6 +36,17 @@
 namespace nvfuser {
 
 namespace {
+//! Like lower_utils::hasBlockSync, but row syncs don't count, as they don't
+//! synchronize the rows of the block when their buffers are reused, see
+//! [ Row Barriers ]
+bool syncsAllThreads(const Expr* expr) {
+  if (auto sync = dynamic_cast<const kir::BlockSync*>(expr);
+      sync != nullptr && sync->isRowSync()) {
+    return false;
+  }
+  return lower_utils::hasBlockSync(expr, GpuLower::current()->threadPredMap());
+}
+
 // Alias used for std::transform
 IterDomain* exactConcreteId(IterDomain* id) {
   return GpuLower::current()->caMap()->getConcreteMappedID(
@@ -1680,7 +1691,7 @@ class StackBasedSharedMemAllocator : kir::IrVisitor {
 
     // Reclaim memory whenever we pass an Expr that is known to synchronize the
     // block
-    if (lower_utils::hasBlockSync(expr, GpuLower::current()->threadPredMap())) {
+    if (syncsAllThreads(expr)) {
       if (isDebugDumpEnabled(DebugDumpOption::BufferReuseInfo)) {
         debug() << "Block syncing expr found at position " << position_
                 << ". Reclaiming memory." << std::endl;
@@ -1851,6 +1862,172 @@ class StackBasedSharedMemAllocator : kir::IrVisitor {
   std::vector<AllocationInfo*> waiting_to_push_;
 };
 
+//! Assign addresses to shared memory allocations by treating the assignment
+//! as packing of an interval graph, similar to register allocation. This is
+//! only done with NVFUSER_ENABLE=smem_packing, after
+//! StackBasedSharedMemAllocator has assigned addresses, and only if the sizes
+//! of all unaliased allocations are constant.
+//!
+//! Two allocations A and B can share memory if there is a block sync at a
+//! position s with lastRead(A) <= s < firstWrite(B), or vice versa. This is the
+//! same condition under which StackBasedSharedMemAllocator reclaims memory,
+//! so no new syncs are needed. The allocations that can't share memory form
+//! the edges of an interval graph. Allocations are visited by decreasing size
+//! and each one is placed at the lowest aligned address that doesn't overlap
+//! any already placed neighbor in the graph.
+//!
+//! Unlike the stack, this can reclaim memory below a live allocation. For
+//! example, if D and A are written, D is last read, the block syncs, B is
+//! written, A is last read, the block syncs again, and C is written, then the
+//! stack has A at the bottom when B and C are pushed, so it needs the sizes of
+//! A, B and C. Packing lets B reuse the memory of D and C reuse the memory
+//! of A. The addresses of the stack are only replaced if packing results in
+//! a lower peak usage.
+class IntervalGraphSharedMemAllocator : kir::IrVisitor {
+ public:
+  IntervalGraphSharedMemAllocator(const AllocationInfoMap& allocation_info_map)
+      : allocation_info_map_(allocation_info_map) {}
+
+  void allocate(const std::vector<Expr*>& exprs) {
+    if (!collectBuffers()) {
+      return;
+    }
+
+    // Record the positions of block syncs
+    handle(exprs);
+    std::sort(sync_positions_.begin(), sync_positions_.end());
+
+    const int64_t stack_peak = getStackPeak();
+
+    std::vector<Buffer*> order;
+    order.reserve(buffers_.size());
+    for (auto& buffer : buffers_) {
+      order.push_back(&buffer);
+    }
+    std::sort(order.begin(), order.end(), [](Buffer* a, Buffer* b) {
+      if (a->size != b->size) {
+        return a->size > b->size;
+      }
+      if (a->first_write != b->first_write) {
+        return a->first_write < b->first_write;
+      }
+      // break ties so that allocations will be deterministic
+      return a->info->alloc_expr->name() < b->info->alloc_expr->name();
+    });
+
+    int64_t packed_peak = 0;
+    std::vector<Buffer*> placed;
+    for (auto buffer : order) {
+      std::vector<std::pair<int64_t, int64_t>> occupied;
+      for (auto other : placed) {
+        if (interferes(buffer, other)) {
+          occupied.emplace_back(other->offset, other->offset + other->size);
+        }
+      }
+      std::sort(occupied.begin(), occupied.end());
+      int64_t offset = 0;
+      for (auto [start, end] : occupied) {
+        if (offset + buffer->size <= start) {
+          break;
+        }
+        offset = std::max(offset, alignInt(end));
+      }
+      buffer->offset = offset;
+      packed_peak = std::max(packed_peak, offset + buffer->size);
+      placed.push_back(buffer);
+    }
+
+    if (isDebugDumpEnabled(DebugDumpOption::BufferReuseInfo)) {
+      debug() << "Peak shared memory usage: " << stack_peak
+              << " bytes with stack allocation, " << packed_peak
+              << " bytes with interval graph packing" << std::endl;
+    }
+
+    if (packed_peak >= stack_peak) {
+      return;
+    }
+
+    for (const auto& buffer : buffers_) {
+      auto alloc = buffer.info->alloc_expr;
+      alloc->setAddress(
+          IrBuilder::create<Val>(buffer.offset, DataType::Index));
+      if (isDebugDumpEnabled(DebugDumpOption::BufferReuseInfo)) {
+        debug() << "Reassigned address " << buffer.offset << " for T"
+                << alloc->buffer()->name() << std::endl;
+      }
+    }
+  }
+
+ private:
+  struct Buffer {
+    AllocationInfo* info = nullptr;
+    int64_t size = 0;
+    int first_write = -1;
+    int last_read = -1;
+    int64_t offset = -1;
+  };
+
+  static int64_t alignInt(int64_t unaligned, int64_t alignment = 16) {
+    return (unaligned + alignment - 1) / alignment * alignment;
+  }
+
+  void dispatch(Expr* expr) final {
+    if (syncsAllThreads(expr)) {
+      sync_positions_.push_back(
+          allocation_info_map_.getScopeMap().getExprPos(expr));
+    }
+    kir::IrVisitor::dispatch(expr);
+  }
+
+  //! Returns false if any size is not constant
+  bool collectBuffers() {
+    for (auto& alloc_info : allocation_info_map_.allAllocationInfos()) {
+      if (alloc_info->mem_type != MemoryType::Shared || alloc_info->alias_to) {
+        continue;
+      }
+      auto size = allocSizeBytes(alloc_info->alloc_expr);
+      if (!size->isConstInt()) {
+        return false;
+      }
+      Buffer buffer;
+      buffer.info = alloc_info.get();
+      buffer.size = size->evaluate().as<int64_t>();
+      buffer.first_write = alloc_info->outer_live_interval->firstWrite();
+      buffer.last_read = alloc_info->getAliasedOuterLastRead();
+      buffers_.push_back(buffer);
+    }
+    return !buffers_.empty();
+  }
+
+  //! Whether the memory of a can be reused for b without a new sync
+  bool isSyncedBefore(const Buffer* a, const Buffer* b) const {
+    auto it = std::lower_bound(
+        sync_positions_.begin(), sync_positions_.end(), a->last_read);
+    return it != sync_positions_.end() && *it < b->first_write;
+  }
+
+  bool interferes(const Buffer* a, const Buffer* b) const {
+    return !isSyncedBefore(a, b) && !isSyncedBefore(b, a);
+  }
+
+  int64_t getStackPeak() const {
+    int64_t peak = 0;
+    for (const auto& buffer : buffers_) {
+      auto address = buffer.info->alloc_expr->address();
+      NVF_ERROR(address != nullptr);
+      peak = std::max(peak, address->evaluate().as<int64_t>() + buffer.size);
+    }
+    return peak;
+  }
+
+ private:
+  const AllocationInfoMap& allocation_info_map_;
+
+  std::vector<Buffer> buffers_;
+
+  std::vector<int> sync_positions_;
+};
+
 } // namespace
 
 // Use allocation info map to find aliases, i.e. allocations that are properly
@@ -1996,8 +2173,7 @@ class PromoteReuseSyncModifier : private kir::ExprMutator {
     // writes since they can be considered safe. If we just inserted a sync,
     // there is no need to perform the hasBlockSync check as we know that
     // upcoming_first_writes_ was just cleared.
-    if (!inserted_sync &&
-        lower_utils::hasBlockSync(expr, GpuLower::current()->threadPredMap())) {
+    if (!inserted_sync && syncsAllThreads(expr)) {
       if (isDebugDumpEnabled(DebugDumpOption::BufferReuseInfo)) {
         debug() << "Found blocking expression at position " << position
                 << std::endl;
@@ -2052,11 +2228,15 @@ std::pair<std::vector<Expr*>, bool> promoteReuseSyncs(
 
 // Assign addresses for dynamic shared memory allocations. This re-uses memory
 // by reclaiming memory that is unused when encountering a block
-// synchronization.
+// synchronization. Optionally, the addresses are then improved by packing the
+// allocations, see IntervalGraphSharedMemAllocator.
 void assignSharedMemoryAllocations(
     const std::vector<Expr*>& exprs,
     AllocationInfoMap& allocation_info_map) {
   StackBasedSharedMemAllocator(allocation_info_map).allocate(exprs);
+  if (isOptionEnabled(EnableOption::SmemPacking)) {
+    IntervalGraphSharedMemAllocator(allocation_info_map).allocate(exprs);
+  }
 
   // Verify that all smem allocations have a non-null address now
   for (auto& alloc_info : allocation_info_map.allAllocationInfos()) {
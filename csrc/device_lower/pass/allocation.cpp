@@ -464,6 +464,12 @@ class AllocationInserter : public kir::ExprMutator {
             default_val == nullptr,
             "Reduction should not have a default initialization value for predicate elimination.");
         init = expr->as<ReductionOp>()->init();
+        // The output of an atomic grid reduction is zero-initialized by
+        // FusionExecutor. See [ Atomic Grid Reduction ]
+        if (expr->as<ReductionOp>()->atomicGridReductionRequested() &&
+            out_tv->isFusionOutput() && out_tv->domain()->hasGridReduction()) {
+          init = nullptr;
+        }
       } else if (expr->isA<GroupedReductionOp>() && out_tv->hasReduction()) {
         NVF_ERROR(
             default_val == nullptr,
@@ -571,6 +577,115 @@ class AllocationInserter : public kir::ExprMutator {
       registerInsertAfter(expr, mbarrier_inval, expr_scope);
       GpuLower::current()->ldstMBarrierMap()[expr] = mbarrier;
     }
+
+    // All 1D bulk copies of the kernel share one mbarrier. See
+    // [ TMA Loads of Persistent Buffers ]
+    if (ir_utils::isCpAsyncBulk1D(expr)) {
+      if (bulk_copy_mbarrier_ == nullptr) {
+        bulk_copy_mbarrier_ = createMBarriers(std::nullopt);
+        insertKernelMBarriers({bulk_copy_mbarrier_}, false);
+      }
+      GpuLower::current()->ldstMBarrierMap()[expr] = bulk_copy_mbarrier_;
+    }
+
+    // Each stage of tensors handed off with mbarriers gets a full and an
+    // empty mbarrier, shared by all the tensors of the same double buffer
+    // loop. See [MBarrier Handoff]
+    auto out_tv = ir_utils::getTvOutput(expr);
+    if (out_tv != nullptr && out_tv->hasMBarrierHandoff()) {
+      auto& db_info = gpu_lower->doubleBufferInfo();
+      auto db_axis = db_info.getDoubleBufferAxis(out_tv);
+      if (db_info.getMBarrierHandoff(db_axis) == nullptr) {
+        const int64_t stage_depth = db_info.getStageDepthFor(db_axis);
+        DoubleBufferInfo::MBarrierHandoff handoff{
+            createMBarriers(stage_depth), createMBarriers(stage_depth)};
+        insertKernelMBarriers({handoff.full, handoff.empty}, true);
+        db_info.setMBarrierHandoff(db_axis, handoff);
+      }
+    }
+  }
+
+  // Returns a shared memory tensor of the given number of mbarriers, or a
+  // single one if the number is not given
+  static TensorView* createMBarriers(std::optional<int64_t> num_mbarriers) {
+    auto mbarriers = TensorViewBuilder()
+                         .shape(
+                             num_mbarriers.has_value()
+                                 ? std::vector<int64_t>{*num_mbarriers}
+                                 : std::vector<int64_t>{})
+                         .dtype(DataType::UInt)
+                         .contiguity(true)
+                         .build();
+    mbarriers->setMemoryType(MemoryType::Shared);
+    return mbarriers;
+  }
+
+  // Allocates mbarriers at the beginning of the kernel. They are initialized
+  // by a single thread with the number of threads of the block as the
+  // arrival count and invalidated at the end of the kernel, which keeps them
+  // alive during the whole kernel. If wait_cp_async is true, all cp.async
+  // copies are waited for before invalidating them, as arrivals triggered by
+  // cp.async may still be pending.
+  void insertKernelMBarriers(
+      const std::vector<TensorView*>& mbarriers,
+      bool wait_cp_async) {
+    Val* is_first_thread = gpu_lower->kernel()->trueVal();
+    Val* num_threads = gpu_lower->kernel()->oneVal();
+    for (auto pt : kParallelTypeTIDs) {
+      is_first_thread = SimplifyingIrBuilder::logicalAndExpr(
+          is_first_thread,
+          IrBuilder::eqExpr(
+              NamedScalar::getParallelIndex(pt),
+              gpu_lower->kernel()->zeroVal()));
+      num_threads = SimplifyingIrBuilder::mulExpr(
+          num_threads, NamedScalar::getParallelDim(pt));
+    }
+    num_threads = IrBuilder::maybeCastExpr(DataType::UInt32, num_threads);
+
+    auto init_ite = IrBuilder::create<kir::IfThenElse>(
+        IrBuilder::create<kir::Predicate>(is_first_thread));
+    auto inval_ite = IrBuilder::create<kir::IfThenElse>(
+        IrBuilder::create<kir::Predicate>(is_first_thread));
+    for (auto mbarrier : mbarriers) {
+      std::vector<Val*> indexed_mbarriers;
+      if (mbarrier->nDims() == 0) {
+        indexed_mbarriers.push_back(mbarrier);
+      } else {
+        const int64_t num_mbarriers =
+            mbarrier->axis(0)->extent()->evaluate().as<int64_t>();
+        for (auto i : c10::irange(num_mbarriers)) {
+          indexed_mbarriers.push_back(lower_utils::u32IndexSmemTvElement(
+              mbarrier, IrBuilder::create<Val>(i, DataType::Index)));
+        }
+      }
+      for (auto indexed_mbarrier : indexed_mbarriers) {
+        init_ite->thenBody().push_back(IrBuilder::create<kir::MBarrierInit>(
+            indexed_mbarrier, num_threads));
+        inval_ite->thenBody().push_back(
+            IrBuilder::create<kir::MBarrierInvalidate>(indexed_mbarrier));
+      }
+    }
+
+    NVF_ERROR(!exprs_.empty());
+    for (auto mbarrier : mbarriers) {
+      registerInsertBefore(
+          exprs_.front(),
+          IrBuilder::create<kir::Allocate>(mbarrier, MemoryType::Shared),
+          nullptr);
+    }
+    registerInsertBefore(exprs_.front(), init_ite, nullptr);
+    registerInsertBefore(
+        exprs_.front(), IrBuilder::create<kir::BlockSync>(), nullptr);
+    // Inserted right after the last expression, so in reverse order
+    registerInsertAfter(exprs_.back(), inval_ite, nullptr);
+    registerInsertAfter(
+        exprs_.back(), IrBuilder::create<kir::BlockSync>(), nullptr);
+    if (wait_cp_async) {
+      registerInsertAfter(
+          exprs_.back(),
+          IrBuilder::create<kir::AsyncWait>(AsyncOpType::CpAsync, 0),
+          nullptr);
+    }
   }
 
   // Sends alloc_expr, info.has_halo, info.allocation_domains to GpuLower
@@ -613,6 +728,8 @@ class AllocationInserter : public kir::ExprMutator {
  private:
   GpuLower* gpu_lower;
 
+  TensorView* bulk_copy_mbarrier_ = nullptr;
+
  public:
   static std::vector<Expr*> insert(const std::vector<Expr*>& exprs) {
     AllocationInserter inserter(exprs);
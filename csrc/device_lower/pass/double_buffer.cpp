@@ -6,6 +6,7 @@
  */
 // clang-format on
 #include <device_lower/lower2device.h>
+#include <device_lower/utils.h>
 #include <ir/utils.h>
 #include <kernel_ir.h>
 
@@ -436,6 +437,12 @@ void getAllocInTrivialLoop(
   }
 }
 
+// Index of the iteration of a double buffer loop. Trivial loops are not
+// generated, so their start is used instead.
+Val* getLoopIndex(kir::ForLoop* loop) {
+  return loop->isTrivial() ? loop->start() : loop->index();
+}
+
 } // namespace
 
 // Apply double buffering transformations
@@ -500,10 +507,41 @@ class DoubleBufferInserter : private kir::ExprMutator {
               MemoryType::Shared;
         });
 
+    const auto handoff =
+        GpuLower::current()->doubleBufferInfo().getMBarrierHandoff(
+            double_buffer_loop->iter_domain());
+    if (handoff != nullptr) {
+      NVF_ERROR(
+          std::all_of(
+              loads.begin(),
+              loads.end(),
+              [](const Expr* expr) {
+                auto out_tv = ir_utils::getTvOutput(expr);
+                return out_tv->getMemoryType() != MemoryType::Shared ||
+                    out_tv->hasMBarrierHandoff();
+              }),
+          "All shared memory tensors of a double buffer loop need to be ",
+          "handed off with mbarriers if any of them is: ",
+          double_buffer_loop->toString());
+    }
+
     // RAW sync is not inserted for double buffered tensors. The only
     // exception is the prologue load.
     bool has_cpasync = false;
-    if (write_to_smem) {
+    if (handoff != nullptr) {
+      // The full mbarrier of each stage of the prologue replaces the
+      // cp.async.wait and the initial block sync. See [MBarrier Handoff]
+      prologue_loop->body().push_back(
+          IrBuilder::create<kir::CpAsyncMBarrierArrive>(
+              lower_utils::u32IndexSmemTvElement(
+                  handoff->full, getLoopIndex(prologue_loop))));
+      registerInsertBefore(
+          double_buffer_loop,
+          IrBuilder::create<kir::MBarrierWaitParity>(
+              lower_utils::u32IndexSmemTvElement(
+                  handoff->full, GpuLower::current()->kernel()->zeroVal()),
+              GpuLower::current()->kernel()->zeroVal(DataType::UInt32)));
+    } else if (write_to_smem) {
       // Here the initial sync before entering double buffer loop is
       //  inserted.
 
@@ -571,7 +609,9 @@ class DoubleBufferInserter : private kir::ExprMutator {
     //  We are currently not actively exploring opportunities
     //   with this property of "double buffer sync" so this
     //   is more conceptual at the moment, aka low priority.
-    if (has_cpasync) {
+    if (handoff != nullptr) {
+      insertMBarrierHandoffInMainLoop(main_loop, loads, *handoff);
+    } else if (has_cpasync) {
       insertCpAsyncCommitWaitInMainLoop(main_loop, loads);
     }
 
@@ -649,6 +689,77 @@ class DoubleBufferInserter : private kir::ExprMutator {
     }
   }
 
+  // Inserts the mbarrier operations of the main loop, see [MBarrier Handoff]
+  void insertMBarrierHandoffInMainLoop(
+      kir::ForLoop* main_loop,
+      const std::vector<Expr*>& loads,
+      const DoubleBufferInfo::MBarrierHandoff& handoff) {
+    auto& exprs = main_loop->body().exprs();
+    Expr* first_double_buffer_load = nullptr;
+    Expr* last_double_buffer_load = nullptr;
+    for (auto expr : exprs) {
+      if (IsDoubleBufferLoadLoop::check(expr, loads)) {
+        if (first_double_buffer_load == nullptr) {
+          first_double_buffer_load = expr;
+        }
+        last_double_buffer_load = expr;
+      }
+    }
+    NVF_ERROR(last_double_buffer_load != nullptr);
+
+    const int64_t depth =
+        GpuLower::current()->doubleBufferInfo().getStageDepthFor(
+            main_loop->iter_domain());
+    auto stage_depth = IrBuilder::create<Val>(depth, DataType::Index);
+    auto stage_of = [&](Val* iteration) {
+      return SimplifyingIrBuilder::modExpr(iteration, stage_depth);
+    };
+    // Parity of the phase of the mbarrier of a stage that completes in the
+    // given iteration
+    auto parity_of = [&](Val* iteration) {
+      return IrBuilder::maybeCastExpr(
+          DataType::UInt32,
+          SimplifyingIrBuilder::modExpr(
+              SimplifyingIrBuilder::divExpr(iteration, stage_depth),
+              IrBuilder::create<Val>(2L, DataType::Index)));
+    };
+
+    auto index = getLoopIndex(main_loop);
+    // The loads of iteration i are for iteration i+D-1
+    auto load_iteration = SimplifyingIrBuilder::addExpr(
+        index, IrBuilder::create<Val>(depth - 1, DataType::Index));
+    auto load_stage = stage_of(load_iteration);
+
+    // Wait until the stage to load was released in the previous iteration.
+    // In the first iteration, the stage hasn't been used yet, and the wait
+    // on the parity of the phase before the first one completes immediately.
+    main_loop->body().insert_before(
+        first_double_buffer_load,
+        IrBuilder::create<kir::MBarrierWaitParity>(
+            lower_utils::u32IndexSmemTvElement(handoff.empty, load_stage),
+            parity_of(
+                SimplifyingIrBuilder::addExpr(load_iteration, stage_depth))));
+    main_loop->body().insert_after(
+        last_double_buffer_load,
+        IrBuilder::create<kir::CpAsyncMBarrierArrive>(
+            lower_utils::u32IndexSmemTvElement(handoff.full, load_stage)));
+
+    // Release the stage read in this iteration and wait for the stage of the
+    // next iteration
+    auto state = IrBuilder::create<Val>(DataType::UInt);
+    main_loop->body().push_back(IrBuilder::create<kir::Allocate>(
+        state, MemoryType::Local, GpuLower::current()->kernel()->oneVal()));
+    main_loop->body().push_back(IrBuilder::create<kir::MBarrierArrive>(
+        state,
+        lower_utils::u32IndexSmemTvElement(handoff.empty, stage_of(index))));
+    auto next_iteration = SimplifyingIrBuilder::addExpr(
+        index, GpuLower::current()->kernel()->oneVal());
+    main_loop->body().push_back(IrBuilder::create<kir::MBarrierWaitParity>(
+        lower_utils::u32IndexSmemTvElement(
+            handoff.full, stage_of(next_iteration)),
+        parity_of(next_iteration)));
+  }
+
  private:
   InsertionInfo& insertion_info_;
   kir::ForLoop* processed_loop_ = nullptr;
@@ -783,6 +894,25 @@ void DoubleBufferInfo::setOriginalAllocSize(
   getTvInfo(tv).original_alloc_size = original_alloc_size;
 }
 
+void DoubleBufferInfo::setMBarrierHandoff(
+    IterDomain* double_buffer_axis,
+    const MBarrierHandoff& handoff) {
+  auto concrete_loop_id = GpuLower::current()->caMap()->getConcreteMappedID(
+      double_buffer_axis, IdMappingMode::LOOP);
+  NVF_ERROR(
+      mbarrier_handoff_.emplace(concrete_loop_id, handoff).second,
+      "MBarriers already allocated for ",
+      concrete_loop_id->toString());
+}
+
+const DoubleBufferInfo::MBarrierHandoff* DoubleBufferInfo::getMBarrierHandoff(
+    IterDomain* double_buffer_axis) {
+  auto concrete_loop_id = GpuLower::current()->caMap()->getConcreteMappedID(
+      double_buffer_axis, IdMappingMode::LOOP);
+  auto it = mbarrier_handoff_.find(concrete_loop_id);
+  return it == mbarrier_handoff_.end() ? nullptr : &it->second;
+}
+
 Val* DoubleBufferInfo::getOriginalAllocSize(const TensorView* tv) {
   if (!(tv->isDoubleBuffered() || tv->isCircularBuffered())) {
     return nullptr;
@@ -164,6 +164,46 @@
 //                      would need to sync to this point to ensure
 //                      completion of the whole tile.
 
+// [MBarrier Handoff] The __syncthreads above both publishes a stage to all
+// threads and keeps any thread from overwriting a stage that other threads
+// are still reading, so every thread waits for the slowest one in each
+// iteration. When the double buffered tensors are marked with
+// TensorView::handOffStagesWithMBarriers, each stage s instead gets two
+// mbarriers expecting an arrival of every thread of the block: full[s]
+// completes when the loads of the stage have landed and empty[s] when all
+// threads are done reading it. The phase of both mbarriers flips each time
+// the stage is reused, so a thread waits on the parity of the phase it
+// needs:
+//
+// allocate X[S*D] // allocation
+// for i in 0..D-1: // prolog
+//   for j in ...
+//     if pred:
+//       x[i*S+j] = y[i, j];
+//   cp.async.mbarrier.arrive.noinc full[i];
+//
+// mbarrier.wait.parity full[0], 0;
+//
+// for i in 0..N: // main loop
+//   # Parity ((i+D-1)/D+1)%2 of a fresh mbarrier completes immediately
+//   mbarrier.wait.parity empty[(i+D-1)%D], ((i+D-1)/D+1)%2;
+//   for j in ...
+//     if pred:
+//       x[((i+D-1)%D)*S+j] = y[i+D-1, j];
+//   cp.async.mbarrier.arrive.noinc full[(i+D-1)%D];
+//   for j in ...
+//     .. = x[(i%D)*S+j]
+//   mbarrier.arrive empty[i%D];
+//   mbarrier.wait.parity full[(i+1)%D], ((i+1)/D)%2;
+//
+// cp.async.mbarrier.arrive.noinc makes the arrival of a thread happen once
+// its cp.async copies have completed, so no thread needs to wait for its own
+// copies before moving on. A thread that arrived at empty[s] only waits for
+// the other threads when it is about to overwrite stage s, D-1 iterations
+// later. The mbarriers are allocated at the beginning of the kernel by
+// insertAllocations, and the WAR syncs of the handed off tensors are
+// omitted by insertWarThreadSynchronization.
+
 namespace nvfuser {
 
 unsigned int getDoubleBufferAxisPosition(const TensorView* tv);
@@ -220,6 +260,21 @@ class DoubleBufferInfo {
   //!  the number of stages will be 2 in the case of double buffer loop.
   unsigned int getStageDepthFor(IterDomain* circular_buffered_id);
 
+  //! The mbarriers of each stage of a double buffer loop whose tensors are
+  //! handed off with mbarriers. See [MBarrier Handoff].
+  struct MBarrierHandoff {
+    TensorView* full = nullptr;
+    TensorView* empty = nullptr;
+  };
+
+  void setMBarrierHandoff(
+      IterDomain* double_buffer_axis,
+      const MBarrierHandoff& handoff);
+
+  //! Returns nullptr if the stages of the loop are not handed off with
+  //! mbarriers
+  const MBarrierHandoff* getMBarrierHandoff(IterDomain* double_buffer_axis);
+
  private:
   TvInfo& getTvInfo(const TensorView* tv);
 
@@ -246,6 +301,10 @@ class DoubleBufferInfo {
   //! Only one stage depth is supported, so that the loops can indeed
   //! shared with the same prolog extent and main loop offset.
   std::unordered_map<IterDomain*, unsigned int> stage_depth_;
+
+  //! Keeps track of the mbarriers of each concrete double buffer loop id
+  //!  whose stages are handed off with mbarriers.
+  std::unordered_map<IterDomain*, MBarrierHandoff> mbarrier_handoff_;
 };
 
 } // namespace nvfuser
@@ -99,6 +99,12 @@ struct ExprSortPayload : public PolymorphicBase {
   std::vector<IterDomain*> ca_domains;
   std::vector<IterDomain*> pa_domains;
 
+  // LOOP concrete IDs of the leaf domains of the tensor inputs of the exprs of
+  // this group, up to their compute or produce position. The CA and PA
+  // domains of a merged group are ordered from the union of these sets of the
+  // merged groups, so the exprs don't have to be traversed again.
+  std::unordered_set<IterDomain*> loop_domains;
+
   // Maximum path distance from an input expr group required for
   // Theorem 4.2
   int level = -1;
@@ -317,6 +323,11 @@ class ExprSegmentationSorter {
 
   bool hasCADomains(const std::unordered_set<IterDomain*>& domains) const;
 
+  // Account for the CA domains of a group that is added to or removed from
+  // groups_
+  void addCADomains(const ExprGroup* group);
+  void removeCADomains(const ExprGroup* group);
+
   // Checks if the for loop associated with the concrete ID is ready to be
   // resolved in sorting.
   bool loopReady(IterDomain* concrete_id) const;
@@ -364,6 +375,10 @@ class ExprSegmentationSorter {
 
   std::deque<ExprGroup*> to_visit_;
 
+  // Number of occurrences of each ID in the CA domains of groups_, so
+  // loopReady doesn't need to look through all the groups
+  std::unordered_map<IterDomain*, int64_t> ca_domain_counts_;
+
   std::vector<std::pair<ExprGroup*, ExprGroup*>> to_merge_;
 
   Fusion* fusion_ = nullptr;
@@ -605,49 +620,44 @@ void ExprSegmentationSorter::resetTraversal() {
 }
 
 // Level is maximum distance from inputs. It's the metric used to select what
-// nodes can be merged while maintaining a DAG
+// nodes can be merged while maintaining a DAG. Groups are visited in
+// topological order, each once all of its producer edges are visited, so this
+// is linear in the number of groups and edges.
 void ExprSegmentationSorter::resetLevels() {
-  std::vector<ExprGroup*> next_to_visit;
+  // Producer edges of each reached group that are not visited yet
+  std::unordered_map<ExprGroup*, size_t> pending_producer_edges;
 
   while (!to_visit_.empty()) {
     auto visit = to_visit_.front();
     to_visit_.pop_front();
 
-    // All inputs processed?
-    bool ready = true;
-    if (!visit->producerEdges().empty()) {
-      ready = std::all_of(
-          visit->producerEdges().begin(),
-          visit->producerEdges().end(),
-          [&](ExprGroupConnections* dep) {
-            return dep->from->payload()->visited;
-          });
-    }
-
-    if (!ready) {
-      // In case traversal doesn't complete because there's an error in the
-      // DAG topology.
-      next_to_visit.push_back(visit);
-      continue;
-    }
-
     visit->payload()->visited = true;
 
-    to_visit_.insert(
-        to_visit_.end(), next_to_visit.begin(), next_to_visit.end());
-    next_to_visit.clear();
-
-    for (auto out : visit->consumerEdges()) {
-      to_visit_.push_back(out->to);
-    }
-
     visit->payload()->level = 0;
     for (auto inp : visit->producerEdges()) {
       visit->payload()->level =
           std::max(visit->payload()->level, inp->from->payload()->level + 1);
     }
+
+    for (auto out : visit->consumerEdges()) {
+      auto it = pending_producer_edges
+                    .try_emplace(out->to, out->to->producerEdges().size())
+                    .first;
+      if (--it->second == 0) {
+        to_visit_.push_back(out->to);
+      }
+    }
   }
-  NVF_ERROR(next_to_visit.empty(), "Error in graph, is not a DAG.");
+
+  // Groups on a cycle are never ready to be visited
+  NVF_ERROR(
+      std::all_of(
+          groups_.begin(),
+          groups_.end(),
+          [](const std::unique_ptr<ExprGroup>& group) {
+            return group->payload()->visited;
+          }),
+      "Error in graph, is not a DAG.");
 }
 
 ExprGroup* ExprSegmentationSorter::makeEmptyGroup(bool is_scalar_only) {
@@ -688,7 +698,18 @@ ExprGroup* ExprSegmentationSorter::makeEmptyGroup(
       auto concrete_id = getConcreteID(out_tv->axis((int)tv_i));
       group->payload()->pa_domains.push_back(concrete_id);
     }
+    auto tv_output = ir_utils::getTvOutput(expr);
+    for (auto tv_input : ir_utils::filterByType<TensorView>(expr->inputs())) {
+      const auto pos = std::max(
+          tv_input->getComputePosition(tv_output),
+          tv_input->getMaxProducerPosition());
+      for (const auto tv_i : c10::irange(pos)) {
+        group->payload()->loop_domains.insert(
+            getConcreteID(tv_input->axis((int)tv_i)));
+      }
+    }
   }
+  addCADomains(group);
   return group;
 }
 
@@ -789,56 +810,18 @@ ExprGroup* getProducer(ExprGroup* sg1, ExprGroup* sg2) {
   return nullptr;
 }
 
+// Orders the domains that are in filter
 std::vector<IterDomain*> getLocalDomainOrdering(
-    const std::vector<Expr*>& exprs,
-    const std::unordered_set<IterDomain*> filter,
+    const std::unordered_set<IterDomain*>& domains,
+    const std::unordered_set<IterDomain*>& filter,
     const std::unordered_map<IterDomain*, std::unordered_set<IterDomain*>>&
         concrete_id_dependencies) {
-  if (exprs.empty()) {
-    return std::vector<IterDomain*>();
-  }
-
-  const auto& ca_map = GpuLower::current()->caMap();
-
-  std::unordered_set<IterDomain*> domains;
-
-  for (auto expr : exprs) {
-    if (!ir_utils::isTvOp(expr)) {
-      continue;
-    }
-
-    auto tv_output = ir_utils::getTvOutput(expr);
-
-    auto tv_inputs = ir_utils::filterByType<TensorView>(expr->inputs());
-    for (auto tv_input : tv_inputs) {
-      std::vector<IterDomain*> domain;
-
-      std::transform(
-          tv_input->getLeafDomain().begin(),
-          tv_input->getLeafDomain().begin() +
-              std::max(
-                  tv_input->getComputePosition(tv_output),
-                  tv_input->getMaxProducerPosition()),
-          std::back_inserter(domain),
-          [&ca_map](IterDomain* id) {
-            return ca_map->getConcreteMappedID(id, IdMappingMode::LOOP);
-          });
-
-      domain.erase(
-          std::remove_if(
-              domain.begin(),
-              domain.end(),
-              [&filter, &ca_map](IterDomain* id) {
-                return filter.find(ca_map->getConcreteMappedID(
-                           id, IdMappingMode::LOOP)) == filter.end();
-              }),
-          domain.end());
-
-      domains.insert(domain.begin(), domain.end());
-    }
-  }
-
-  std::vector<IterDomain*> merged_domain(domains.begin(), domains.end());
+  std::vector<IterDomain*> merged_domain;
+  std::copy_if(
+      domains.begin(),
+      domains.end(),
+      std::back_inserter(merged_domain),
+      [&filter](IterDomain* id) { return filter.count(id) > 0; });
   std::sort(
       merged_domain.begin(),
       merged_domain.end(),
@@ -888,12 +871,27 @@ ExprGroup* ExprSegmentationSorter::makeMergedNode(
       producer != nullptr,
       "Tried to merge expr's together that aren't neighbors.");
 
-  joined_groups->exprs() = producer->exprs();
+  if (isDebugDumpEnabled(DebugDumpOption::ExprSort) ||
+      isDebugDumpEnabled(DebugDumpOption::ExprSortVerbose)) {
+    debug() << "==========================================\n" << std::endl;
+    debug() << "Producer:\n" << producer->toString() << std::endl;
+    debug() << "Consumer:\n" << consumer->toString() << std::endl;
+  }
+
+  // sg1 and sg2 are removed once merged, so their exprs and loop domains are
+  // moved rather than copied as the merged groups grow
+  joined_groups->exprs() = std::move(producer->exprs());
   joined_groups->exprs().insert(
       joined_groups->exprs().end(),
       consumer->exprs().begin(),
       consumer->exprs().end());
 
+  auto& loop_domains = joined_groups->payload()->loop_domains;
+  loop_domains = std::move(producer->payload()->loop_domains);
+  loop_domains.insert(
+      consumer->payload()->loop_domains.begin(),
+      consumer->payload()->loop_domains.end());
+
   auto producer_edges = getMergedProducerEdges(sg1, sg2);
   // Connect joined group to resulting neighbors
   for (auto& edge : producer_edges) {
@@ -968,7 +966,7 @@ ExprGroup* ExprSegmentationSorter::makeMergedNode(
   all_ca_pa_ids.insert(pa_ids.begin(), pa_ids.end());
 
   auto ordered_ids = getLocalDomainOrdering(
-      joined_groups->exprs(), all_ca_pa_ids, concrete_id_dependencies_);
+      loop_domains, all_ca_pa_ids, concrete_id_dependencies_);
 
   // Add the global scope first if necessary
   if (pa_ids.count(kernelScopeDomain())) {
@@ -988,11 +986,10 @@ ExprGroup* ExprSegmentationSorter::makeMergedNode(
     }
   }
 
+  addCADomains(joined_groups);
+
   if (isDebugDumpEnabled(DebugDumpOption::ExprSort) ||
       isDebugDumpEnabled(DebugDumpOption::ExprSortVerbose)) {
-    debug() << "==========================================\n" << std::endl;
-    debug() << "Producer:\n" << producer->toString() << std::endl;
-    debug() << "Consumer:\n" << consumer->toString() << std::endl;
     debug() << "Merged:\n" << joined_groups->toString() << std::endl;
   }
 
@@ -1125,6 +1122,7 @@ void ExprSegmentationSorter::mergeNodes() {
   }
 
   for (auto group : clean_up_groups) {
+    removeCADomains(group);
     auto disconnected_edges = disconnectGroup(group);
     clean_up_edges.insert(disconnected_edges.begin(), disconnected_edges.end());
   }
@@ -1261,23 +1259,36 @@ void ExprSegmentationSorter::initializeForLoopDependencies() {
   }
 }
 
-bool ExprSegmentationSorter::hasCADomains(
-    const std::unordered_set<IterDomain*>& domains) const {
-  for (auto& group : groups_) {
-    if (std::any_of(
-            group->payload()->ca_domains.begin(),
-            group->payload()->ca_domains.end(),
-            [&](auto ca_domain) { return domains.count(ca_domain); })) {
-      return true;
+void ExprSegmentationSorter::addCADomains(const ExprGroup* group) {
+  for (auto ca_domain : group->payload()->ca_domains) {
+    ca_domain_counts_[ca_domain]++;
+  }
+}
+
+void ExprSegmentationSorter::removeCADomains(const ExprGroup* group) {
+  for (auto ca_domain : group->payload()->ca_domains) {
+    auto it = ca_domain_counts_.find(ca_domain);
+    NVF_ERROR(
+        it != ca_domain_counts_.end() && it->second > 0,
+        "Untracked CA domain: ",
+        ca_domain->toString());
+    if (--it->second == 0) {
+      ca_domain_counts_.erase(it);
     }
   }
-  return false;
+}
+
+bool ExprSegmentationSorter::hasCADomains(
+    const std::unordered_set<IterDomain*>& domains) const {
+  return std::any_of(domains.begin(), domains.end(), [&](auto domain) {
+    return ca_domain_counts_.count(domain) > 0;
+  });
 }
 
 // Checks if the for loop associated with the concrete ID is ready to be
-// resolved in sorting. This could be done more efficiently with some
-// additional tracking, however we recreate ca_domain_ when we merge groups,
-// so it's hard to track what is no longer needed.
+// resolved in sorting. The CA domains of all the groups are tracked in
+// ca_domain_counts_ as groups are made and merged, so this only looks up the
+// dependencies of the loop.
 bool ExprSegmentationSorter::loopReady(IterDomain* concrete_id) const {
   NVF_ERROR(
       concrete_id == getConcreteID(concrete_id),
@@ -1544,15 +1555,16 @@ void ExprSegmentationSorter::sort() {
     expr2group.insert(std::make_pair(expr, group));
   }
 
+  const std::unordered_set<Val*> known_vals(
+      GpuLower::current()->allKnownVals().begin(),
+      GpuLower::current()->allKnownVals().end());
+
   // Create edges between the Exprs. Mark inputs and outputs of the fusion.
   for (auto expr : all_exprs) {
     auto expr_group = expr2group.at(expr);
     auto out = expr->outputs()[0];
     for (auto inp : expr->inputs()) {
-      if (std::any_of(
-              GpuLower::current()->allKnownVals().begin(),
-              GpuLower::current()->allKnownVals().end(),
-              [&inp](Val* input) { return input == inp; })) {
+      if (known_vals.count(inp) > 0) {
         continue;
       }
 
@@ -1748,6 +1760,7 @@ std::vector<Expr*> ExprSegmentationSorter::getExprs() const {
 } // namespace
 
 std::vector<Expr*> reorderExprsForComputeAt() {
+  FUSER_PERF_SCOPE("reorderExprsForComputeAt");
   auto fusion = FusionGuard::getCurFusion();
   NVF_ERROR(fusion != nullptr);
 
@@ -0,0 +1,100 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <device_lower/pass/grid_serialization.h>
+
+#include <device_lower/lower2device.h>
+#include <instrumentation.h>
+#include <ir/utils.h>
+#include <kernel_ir_dispatch.h>
+
+#include <unordered_map>
+
+namespace nvfuser {
+
+namespace {
+
+class GridSerializationSyncInserter : public kir::ExprMutator {
+ public:
+  static std::vector<Expr*> insert(const std::vector<Expr*>& exprs) {
+    GridSerializationSyncInserter inserter(exprs);
+    return inserter.exprs_;
+  }
+
+ private:
+  GridSerializationSyncInserter(const std::vector<Expr*>& exprs) {
+    kir::ExprMutator::traverseAndInsert(exprs);
+  }
+
+  using kir::ExprMutator::handle;
+
+  void handle(kir::GridReduction* grop) final {
+    if (!grop->isSerial()) {
+      return;
+    }
+
+    ParallelTypeBitmap sync_dims;
+    for (auto id :
+         grop->out()->as<kir::TensorIndex>()->view()->getLeafDomain()) {
+      if (id->isReduction() && id->isBlockDim()) {
+        sync_dims.set(id->getParallelType());
+      }
+    }
+
+    // The syncs are placed around the outermost enclosing expression that is
+    // not a trivial loop, i.e., one that is actually generated. If there is
+    // none, they are placed around the grid reduction itself.
+    Expr* synced_expr = grop;
+    kir::Scope* scope = scope_.empty() ? nullptr : scope_.back();
+    for (auto i : c10::irange(scope_exprs_.size())) {
+      auto fl = dynamic_cast<kir::ForLoop*>(scope_exprs_.at(i));
+      if (fl != nullptr && fl->isTrivial()) {
+        continue;
+      }
+      synced_expr = scope_exprs_.at(i);
+      scope = i == 0 ? nullptr : scope_.at(i - 1);
+      break;
+    }
+
+    // Multiple serial grid reductions in the same loop nest are serialized
+    // together
+    auto it = synced_exprs_.find(synced_expr);
+    if (it != synced_exprs_.end()) {
+      NVF_ERROR(
+          it->second == sync_dims,
+          "Serial grid reductions in the same loop nest must reduce the same ",
+          "parallel dimensions: ",
+          grop->toString());
+      return;
+    }
+    synced_exprs_.emplace(synced_expr, sync_dims);
+
+    auto sync_buffer = grop->sync_buffer()->buffer();
+    kir::ExprMutator::registerInsertBefore(
+        synced_expr,
+        IrBuilder::create<kir::BlockSerializeWait>(sync_dims, sync_buffer),
+        scope);
+    kir::ExprMutator::registerInsertAfter(
+        synced_expr,
+        IrBuilder::create<kir::BlockSerializeRelease>(sync_dims, sync_buffer),
+        scope);
+  }
+
+ private:
+  //! Expressions serialized so far and the reduced parallel dimensions
+  std::unordered_map<Expr*, ParallelTypeBitmap> synced_exprs_;
+};
+
+} // namespace
+
+std::vector<Expr*> insertGridSerializationSyncs(
+    const std::vector<Expr*>& exprs) {
+  FUSER_PERF_SCOPE("GpuLower::Lower::insertGridSerializationSyncs");
+  return GridSerializationSyncInserter::insert(exprs);
+}
+
+} // namespace nvfuser
@@ -0,0 +1,39 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <exceptions.h>
+#include <kernel_ir.h>
+
+#include <vector>
+
+namespace nvfuser {
+
+//! [ Serial Grid Reduction ]
+//!
+//! A grid reduction of a ReductionOp with serialGridReductionRequested() is
+//! not done with gridReduce, which writes the partial result of every block
+//! to a work buffer and reduces them in the last block. Instead, the blocks
+//! of each reduction segment take turns: each one combines its values with
+//! the partial result in the work buffer and writes the result back, and
+//! the last block keeps the final result. See serialReductionStep in
+//! runtime/grid_reduction.cu. This needs no block reduction, no shared
+//! memory and a work buffer of only one element per thread and output
+//! element, and it is deterministic. On the other hand, the blocks of a
+//! segment are serialized, so it's best suited for reductions across a few
+//! blocks with a lot of work each, e.g., split-K matmuls.
+//!
+//! Index lowering creates a serial kir::GridReduction. This pass then
+//! inserts a kir::BlockSerializeWait before and a kir::BlockSerializeRelease
+//! after the outermost loop nest containing it. Since they synchronize the
+//! thread block, they are placed outside of any non-trivial loop and any
+//! predicate.
+std::vector<Expr*> insertGridSerializationSyncs(
+    const std::vector<Expr*>& exprs);
+
+} // namespace nvfuser
@@ -314,9 +314,10 @@ void IndexLowering::handle(const IndexSelectOp* sop) {
   const auto lookup =
       lowerSrcIndex(sop->input(0), sop->output(0), override_index);
 
+  // The lookup is already indexed, so this is a plain copy, which can be
+  // vectorized along the innermost dimension of the lookup like SliceOp
   const auto out = lowerDstIndex(sop->output(0));
-  pushBack(
-      IrBuilder::create<IndexSelectOp>(out, lookup, sop->dim(), lowered_index));
+  pushBack(IrBuilder::create<LoadStoreOp>(LoadStoreOpType::Set, out, lookup));
   GpuLower::current()->propagateExprInfo(sop, back());
 }
 
@@ -354,6 +355,27 @@ void IndexLowering::handle(const ScatterOp* sop) {
   GpuLower::current()->propagateExprInfo(sop, back());
 }
 
+void IndexLowering::handle(const SortOp* sop) {
+  // The sorted domains are parallelized with ParallelType::Bulk, so these are
+  // the indices of the first elements of the rows
+  const auto in = lowerSrcIndex(sop->in(), sop->outValues());
+  const auto out_values = lowerDstIndex(sop->outValues());
+  const auto out_indices = lowerDstIndex(sop->outIndices());
+  pushBack(IrBuilder::create<SortOp>(
+      out_values, out_indices, in, sop->dim(), sop->descending()));
+  GpuLower::current()->propagateExprInfo(sop, back());
+}
+
+void IndexLowering::handle(const ScanOp* sop) {
+  // The elements of the rows each thread holds are parallelized with
+  // ParallelType::Bulk, so these are the indices of the first of them
+  const auto in = lowerSrcIndex(sop->in(), sop->out());
+  const auto out = lowerDstIndex(sop->out());
+  pushBack(IrBuilder::create<ScanOp>(
+      sop->getScanOpType(), sop->init(), out, in, sop->dim()));
+  GpuLower::current()->propagateExprInfo(sop, back());
+}
+
 void IndexLowering::handle(const SelectOp* sop) {
   auto lowered_index = lowerSrcIndex(sop->input(1), sop->output(0));
   auto lowered_index_cast = lowered_index;
@@ -410,10 +432,13 @@ struct GridCommWorkBufferSizeInfo {
 // Get the size of the temporary work buffer for grid communication, this can be
 // grid reduction, broadcast, or grid welford.
 // The buffer is expanded for privatization when not persistent or grouped.
+// Single-pass grid reductions accumulate into one value per reduction
+// segment, so the buffer doesn't need space for the reduced block dimensions.
 GridCommWorkBufferSizeInfo getGridCommWorkBufferSize(
     const TensorDomain* td,
     const std::vector<kir::ForLoop*>& for_loops,
-    bool is_persistent) {
+    bool is_persistent,
+    bool is_single_pass = false) {
   // The buffer size is the number of thread blocks multiplied by the
   // number of threads not used for reduction domains.
   // Note: Previously it was calculated based on the shape of the
@@ -436,6 +461,12 @@ GridCommWorkBufferSizeInfo getGridCommWorkBufferSize(
         })) {
       continue;
     }
+    if (is_single_pass && isParallelTypeBlockDim(pt) &&
+        std::any_of(td->leaf().begin(), td->leaf().end(), [&](auto out_id) {
+          return out_id->getParallelType() == pt && out_id->isReduction();
+        })) {
+      continue;
+    }
     size_of_single_buffer =
         SimplifyingIrBuilder::mulExpr(size_of_single_buffer, pt_dim);
   }
@@ -579,7 +610,9 @@ void IndexLowering::handle(const ReductionOp* rop) {
   const auto out = lowerDstIndex(rop->out());
   const auto in = lowerSrcIndex(rop->in(), rop->out());
 
-  if (has_grid_reduce) {
+  if (has_grid_reduce && rop->serialGridReductionRequested()) {
+    handleSerialGridReduction(rop, out, in);
+  } else if (has_grid_reduce) {
     handleGridReduction(rop, out, in);
   } else if (has_block_reduce) {
     handleBlockReduction(rop, out, in);
@@ -644,25 +677,54 @@ void IndexLowering::handleGridReduction(
   // a persistent manner, so all grid reductions should be consulted.
   // TODO: fix this
   const bool is_persistent = rop->isAllreduce();
-  const auto buffer_size_info =
-      getGridCommWorkBufferSize(out_domain, for_loops_, is_persistent);
-
-  auto work_buffer = allocateUniqueBuffer(
-      buffer_size_info.size_of_privatized_buffer,
-      out_tv->dtype(),
-      false,
-      out_tv,
-      work_buffer_map_);
+  // See [ Single-Pass Grid Reduction ]
+  const bool is_single_pass =
+      rop->singlePassGridReductionRequested() && !is_persistent;
+
+  // An atomic grid reduction accumulates directly into the output, so it
+  // needs neither a work nor a sync buffer. See [ Atomic Grid Reduction ]
+  const bool is_atomic = rop->atomicGridReductionRequested();
+  if (is_atomic) {
+    NVF_ERROR(
+        !rop->isAllreduce(),
+        "Atomic grid reductions can't be allreduce: ",
+        rop->toString());
+    NVF_ERROR(
+        out_tv->isFusionOutput() &&
+            out_tv->getMemoryType() == MemoryType::Global,
+        "Atomic grid reductions must reduce into fusion outputs: ",
+        rop->toString());
+    NVF_ERROR(
+        rop->getReductionOpType() == BinaryOpType::Add &&
+            (out_tv->dtype() == DataType::Float ||
+             out_tv->dtype() == DataType::Double),
+        "Atomic grid reductions only support float and double sums: ",
+        rop->toString());
+  }
+
+  kir::Allocate* work_buffer = nullptr;
+  kir::Allocate* sync_buffer = nullptr;
+  if (!is_atomic) {
+    const auto buffer_size_info = getGridCommWorkBufferSize(
+        out_domain, for_loops_, is_persistent, is_single_pass);
+
+    work_buffer = allocateUniqueBuffer(
+        buffer_size_info.size_of_privatized_buffer,
+        out_tv->dtype(),
+        false,
+        out_tv,
+        work_buffer_map_);
 
-  auto sync_buffer_size =
-      getGridSyncBufferSize(out_domain, for_loops_, is_persistent);
-  auto sync_buffer = allocateUniqueBuffer(
-      sync_buffer_size, DataType::Int, true, out_tv, sync_buffer_map_);
+    auto sync_buffer_size =
+        getGridSyncBufferSize(out_domain, for_loops_, is_persistent);
+    sync_buffer = allocateUniqueBuffer(
+        sync_buffer_size, DataType::Int, true, out_tv, sync_buffer_map_);
+  }
 
-  const auto entrance_ind = !is_persistent
+  const auto entrance_ind = !is_persistent && !is_atomic
       ? getEntranceLinIndGridReduce(for_loops_)
       : GpuLower::current()->kernel()->zeroVal();
-  const auto n_entrances = !is_persistent
+  const auto n_entrances = !is_persistent && !is_atomic
       ? getEntranceCountGridReduce(for_loops_)
       : GpuLower::current()->kernel()->oneVal();
 
@@ -683,6 +745,12 @@ void IndexLowering::handleGridReduction(
       n_entrances,
       rop->isAllreduce());
 
+  if (is_atomic) {
+    grid_reduction->requestAtomicGridReduction();
+  } else if (is_single_pass) {
+    grid_reduction->requestSinglePassGridReduction();
+  }
+
   grid_reduction = grid_reduction->withThreadPredicate(thread_pred);
 
   if (rop->predicate()) {
@@ -702,6 +770,128 @@ void IndexLowering::handleGridReduction(
   }
 }
 
+void IndexLowering::handleSerialGridReduction(
+    const ReductionOp* rop,
+    Val* out,
+    Val* in) {
+  const auto out_tv = out->as<kir::TensorIndex>()->view();
+  const auto out_domain = out_tv->domain();
+
+  NVF_ERROR(out_domain->hasGridReduction());
+  NVF_ERROR(
+      !rop->isAllreduce(),
+      "Serial grid reductions can't be allreduces: ",
+      rop->toString());
+  // Each thread accumulates its own values, so any other reduction must be
+  // done by rfactor first
+  NVF_ERROR(
+      std::none_of(
+          out_domain->leaf().begin(),
+          out_domain->leaf().end(),
+          [](IterDomain* id) {
+            return id->isReduction() && !id->isBlockDim() &&
+                !id->extent()->isOneInt();
+          }),
+      "Serial grid reductions may only reduce across blocks. ",
+      "Please use rfactor to do the other reductions first. ",
+      rop->toString());
+
+  // See [ Serial Grid Reduction ]. Blocks of the same reduction segment
+  // share the work buffer and each thread uses its own element of it per
+  // entrance, so the work buffer is indexed by the entrance, the position
+  // of the reduction segment in the grid, and the thread index.
+  Val* num_segments = GpuLower::current()->kernel()->oneVal();
+  Val* segment_index = GpuLower::current()->kernel()->zeroVal();
+  Val* block_size = GpuLower::current()->kernel()->oneVal();
+  Val* thread_index = GpuLower::current()->kernel()->zeroVal();
+  // Linearized with TIDx innermost, so that accesses are coalesced
+  for (auto pt :
+       {ParallelType::BIDz,
+        ParallelType::BIDy,
+        ParallelType::BIDx,
+        ParallelType::TIDz,
+        ParallelType::TIDy,
+        ParallelType::TIDx}) {
+    auto pt_dim = GpuLower::current()->parallelDimensionMap().get(pt);
+    if (pt_dim == nullptr || pt_dim->isOneInt()) {
+      continue;
+    }
+    auto pt_index = NamedScalar::getParallelIndex(pt);
+    if (isParallelTypeThreadDim(pt)) {
+      thread_index = SimplifyingIrBuilder::addExpr(
+          SimplifyingIrBuilder::mulExpr(thread_index, pt_dim), pt_index);
+      block_size = SimplifyingIrBuilder::mulExpr(block_size, pt_dim);
+      continue;
+    }
+    if (std::any_of(
+            out_domain->leaf().begin(),
+            out_domain->leaf().end(),
+            [&](auto out_id) {
+              return out_id->getParallelType() == pt && out_id->isReduction();
+            })) {
+      continue;
+    }
+    segment_index = SimplifyingIrBuilder::addExpr(
+        SimplifyingIrBuilder::mulExpr(segment_index, pt_dim), pt_index);
+    num_segments = SimplifyingIrBuilder::mulExpr(num_segments, pt_dim);
+  }
+
+  const auto entrance_ind = getEntranceLinIndGridReduce(for_loops_);
+  const auto n_entrances = getEntranceCountGridReduce(for_loops_);
+
+  auto work_buffer = allocateUniqueBuffer(
+      SimplifyingIrBuilder::mulExpr(
+          SimplifyingIrBuilder::mulExpr(n_entrances, num_segments),
+          block_size),
+      out_tv->dtype(),
+      false,
+      out_tv,
+      work_buffer_map_);
+  auto work_buffer_index = SimplifyingIrBuilder::addExpr(
+      SimplifyingIrBuilder::mulExpr(
+          SimplifyingIrBuilder::addExpr(
+              SimplifyingIrBuilder::mulExpr(entrance_ind, num_segments),
+              segment_index),
+          block_size),
+      thread_index);
+  auto serial_reduction_tensor = IrBuilder::create<kir::TensorIndex>(
+      work_buffer->buffer()->as<TensorView>(), work_buffer_index);
+
+  // A single semaphore per reduction segment, which is reset to zero by the
+  // last block of the segment
+  auto sync_buffer = allocateUniqueBuffer(
+      num_segments, DataType::Int, true, out_tv, sync_buffer_map_);
+
+  const auto& thread_pred =
+      GpuLower::current()->threadPredMap().getPredicatedParallelTypes(out_tv);
+
+  auto grid_reduction = IrBuilder::create<kir::GridReduction>(
+      rop->getReductionOpType(),
+      rop->init(),
+      out,
+      in,
+      work_buffer,
+      sync_buffer,
+      entrance_ind,
+      n_entrances,
+      false,
+      serial_reduction_tensor);
+
+  grid_reduction = grid_reduction->withThreadPredicate(thread_pred);
+
+  if (rop->predicate()) {
+    grid_reduction = grid_reduction->withPredicate(rop->predicate())
+                         ->as<kir::GridReduction>();
+  }
+  if (rop->writePredicate()) {
+    grid_reduction = grid_reduction->withWritePredicate(rop->writePredicate())
+                         ->as<kir::GridReduction>();
+  }
+
+  pushBack(grid_reduction);
+  GpuLower::current()->propagateExprInfo(rop, back());
+}
+
 void IndexLowering::handle(const GroupedReductionOp* grouped_rop) {
   NVF_ERROR(ir_utils::isTvOp(grouped_rop));
 
@@ -761,6 +951,145 @@ void IndexLowering::handleBlockReduction(
   GpuLower::current()->propagateExprInfo(grouped_rop, back());
 }
 
+namespace {
+
+// Returns true if a GroupedWelfordOp or GroupedReductionOp op is
+// eligible for using the outer-optimized grouped welford or reduction
+// runtime function
+bool canUseOuterOptRuntimeKernel(const Expr* grouped_op) {
+  const auto out_tv = ir_utils::getTvOutput(grouped_op);
+  const auto out_domain = out_tv->domain();
+
+  if (!out_domain->hasGridReduction()) {
+    return false;
+  }
+
+  // TIDx and BIDx must be used for non-reduction domains. TIDy and
+  // BIDy must be used for reduction domains.
+  ParallelTypeBitmap used_pts;
+  for (auto leaf_id : out_domain->leaf()) {
+    auto pt = leaf_id->getParallelType();
+    if (isParallelTypeThread(pt)) {
+      used_pts.set(pt);
+      if ((leaf_id->isReduction() &&
+           (pt == ParallelType::BIDy || pt == ParallelType::TIDy)) ||
+          (leaf_id->getIterType() == IterType::Iteration &&
+           (pt == ParallelType::BIDx || pt == ParallelType::TIDx))) {
+        // valid pattern
+        continue;
+      } else {
+        return false;
+      }
+    }
+  }
+
+  ParallelTypeBitmap valid_pt_map;
+  valid_pt_map.set(ParallelType::BIDx);
+  valid_pt_map.set(ParallelType::BIDy);
+  valid_pt_map.set(ParallelType::TIDx);
+  valid_pt_map.set(ParallelType::TIDy);
+  if (used_pts != valid_pt_map) {
+    return false;
+  }
+
+  // TIDx and TIDy must be static constant
+  const auto& par_dim_map = GpuLower::current()->parallelDimensionMap();
+  auto tidx_val = par_dim_map.get(ParallelType::TIDx);
+  auto tidy_val = par_dim_map.get(ParallelType::TIDy);
+  if (!tidx_val->isConstInt() || !tidy_val->isConstInt()) {
+    return false;
+  }
+  auto tidx = static_cast<int>(tidx_val->evaluate());
+  auto tidy = static_cast<int>(tidy_val->evaluate());
+
+  // TIDz and BIDz must be unused or just 1. This contraint can be
+  // lifted if necessary.
+  auto tidz_val = par_dim_map.get(ParallelType::TIDz);
+  if (tidz_val != nullptr && !tidz_val->isOneInt()) {
+    return false;
+  }
+  auto bidz_val = par_dim_map.get(ParallelType::BIDz);
+  if (bidz_val != nullptr && !bidz_val->isOneInt()) {
+    return false;
+  }
+
+  // Warp reduction along threadIdx.y is a key factor for the
+  // outer-optimized kernel. The larger (32 / blockDim.x) is, the more
+  // effective. It shouldn't give any perf benefit when blockDim.x >=
+  // 32 as there's no warp reduction. blockDim.x == 16 is not
+  // preferable, but still would be better than the default
+  // implementation. blockDim.x == 8 is preferred.
+  if (tidx > 16) {
+    return false;
+  }
+
+  int num_grouped_iterations = 1;
+  for (auto axis : out_domain->leaf()) {
+    if (axis->getParallelType() == ParallelType::Group) {
+      NVF_ERROR(
+          axis->extent()->isConstInt(),
+          "Grouped IterDomain must have a static integer extent: ",
+          axis->extent()->toInlineString());
+      num_grouped_iterations *= (int)axis->extent()->evaluate();
+    }
+  }
+
+  // Assumptions about TIDx/TIDy and group size
+  if (tidy % num_grouped_iterations != 0 || tidx > 32 || 32 % tidx != 0 ||
+      num_grouped_iterations < 32 / tidx) {
+    return false;
+  }
+
+  // Only considers the case where all outputs are local. This
+  // eliminates thread predicates
+  if (std::any_of(
+          grouped_op->outputs().begin(),
+          grouped_op->outputs().end(),
+          [](const Val* output) {
+            return !output->isA<TensorView>() ||
+                output->as<TensorView>()->getMemoryType() != MemoryType::Local;
+          })) {
+    return false;
+  }
+
+  // Must not be predicated. If the per-thread serial reduction is
+  // rfactored, the remaining block+grid reduction is not predicated.
+  if (!((grouped_op->predicate()->hasValue() &&
+         grouped_op->predicate()->value()) ||
+        GpuLower::current()->predicateElimination().canOmitPredicate(
+            grouped_op))) {
+    return false;
+  }
+
+  return true;
+}
+
+// The outer-optimized grouped reduction shuffles each value of a
+// group separately, so only the arithmetic types supported by
+// __shfl_xor_sync are allowed. Its inputs must also be arrays of
+// registers. See also runtime/fused_reduction_impl_outer.cu
+bool canUseOuterOptRuntimeKernel(const GroupedReductionOp* grouped_rop) {
+  if (!grouped_rop->isAllreduce() ||
+      !isOptionEnabled(EnableOption::GridOuterPersistentReduction)) {
+    return false;
+  }
+  for (auto i : c10::irange(grouped_rop->numHorizontallyGroupedExprs())) {
+    const auto input = grouped_rop->input(i);
+    if (!input->isA<TensorView>() ||
+        input->as<TensorView>()->getMemoryType() != MemoryType::Local) {
+      return false;
+    }
+    const auto dtype = grouped_rop->output(i)->dtype();
+    if (dtype != DataType::Float && dtype != DataType::Double &&
+        dtype != DataType::Int && dtype != DataType::Int32) {
+      return false;
+    }
+  }
+  return canUseOuterOptRuntimeKernel(static_cast<const Expr*>(grouped_rop));
+}
+
+} // namespace
+
 void IndexLowering::handleGridReduction(
     const GroupedReductionOp* grouped_rop,
     const std::vector<Val*>& outputs,
@@ -831,7 +1160,8 @@ void IndexLowering::handleGridReduction(
       entrance_ind,
       n_entrances,
       work_buf_size_info.buffer_stride,
-      grouped_rop->isAllreduce());
+      grouped_rop->isAllreduce(),
+      canUseOuterOptRuntimeKernel(grouped_rop));
 
   grid_reduction = grid_reduction->withThreadPredicate(thread_pred);
 
@@ -1083,120 +1413,6 @@ std::vector<kir::Allocate*> IndexLowering::allocateWelfordWorkBuffer(
   return work_buffers;
 }
 
-namespace {
-
-// Returns true if a GroupedWelfordOp op is eligible for using the
-// outer-optimized grouped welford runtime function
-bool canUseOuterOptRuntimeKernel(const GroupedWelfordOp* grouped_wop) {
-  const auto out_tv = ir_utils::getTvOutput(grouped_wop);
-  const auto out_domain = out_tv->domain();
-
-  if (!out_domain->hasGridReduction()) {
-    return false;
-  }
-
-  // TIDx and BIDx must be used for non-reduction domains. TIDy and
-  // BIDy must be used for reduction domains.
-  ParallelTypeBitmap used_pts;
-  for (auto leaf_id : out_domain->leaf()) {
-    auto pt = leaf_id->getParallelType();
-    if (isParallelTypeThread(pt)) {
-      used_pts.set(pt);
-      if ((leaf_id->isReduction() &&
-           (pt == ParallelType::BIDy || pt == ParallelType::TIDy)) ||
-          (leaf_id->getIterType() == IterType::Iteration &&
-           (pt == ParallelType::BIDx || pt == ParallelType::TIDx))) {
-        // valid pattern
-        continue;
-      } else {
-        return false;
-      }
-    }
-  }
-
-  ParallelTypeBitmap valid_pt_map;
-  valid_pt_map.set(ParallelType::BIDx);
-  valid_pt_map.set(ParallelType::BIDy);
-  valid_pt_map.set(ParallelType::TIDx);
-  valid_pt_map.set(ParallelType::TIDy);
-  if (used_pts != valid_pt_map) {
-    return false;
-  }
-
-  // TIDx and TIDy must be static constant
-  const auto& par_dim_map = GpuLower::current()->parallelDimensionMap();
-  auto tidx_val = par_dim_map.get(ParallelType::TIDx);
-  auto tidy_val = par_dim_map.get(ParallelType::TIDy);
-  if (!tidx_val->isConstInt() || !tidy_val->isConstInt()) {
-    return false;
-  }
-  auto tidx = static_cast<int>(tidx_val->evaluate());
-  auto tidy = static_cast<int>(tidy_val->evaluate());
-
-  // TIDz and BIDz must be unused or just 1. This contraint can be
-  // lifted if necessary.
-  auto tidz_val = par_dim_map.get(ParallelType::TIDz);
-  if (tidz_val != nullptr && !tidz_val->isOneInt()) {
-    return false;
-  }
-  auto bidz_val = par_dim_map.get(ParallelType::BIDz);
-  if (bidz_val != nullptr && !bidz_val->isOneInt()) {
-    return false;
-  }
-
-  // Warp reduction along threadIdx.y is a key factor for the
-  // outer-optimized kernel. The larger (32 / blockDim.x) is, the more
-  // effective. It shouldn't give any perf benefit when blockDim.x >=
-  // 32 as there's no warp reduction. blockDim.x == 16 is not
-  // preferable, but still would be better than the default
-  // implementation. blockDim.x == 8 is preferred.
-  if (tidx > 16) {
-    return false;
-  }
-
-  int num_grouped_iterations = 1;
-  for (auto axis : out_domain->leaf()) {
-    if (axis->getParallelType() == ParallelType::Group) {
-      NVF_ERROR(
-          axis->extent()->isConstInt(),
-          "Grouped IterDomain must have a static integer extent: ",
-          axis->extent()->toInlineString());
-      num_grouped_iterations *= (int)axis->extent()->evaluate();
-    }
-  }
-
-  // Assumptions about TIDx/TIDy and group size
-  if (tidy % num_grouped_iterations != 0 || tidx > 32 || 32 % tidx != 0 ||
-      num_grouped_iterations < 32 / tidx) {
-    return false;
-  }
-
-  // Only considers the case where all outputs are local. This
-  // eliminates thread predicates
-  if (std::any_of(
-          grouped_wop->outputs().begin(),
-          grouped_wop->outputs().end(),
-          [](const Val* output) {
-            return !output->isA<TensorView>() ||
-                output->as<TensorView>()->getMemoryType() != MemoryType::Local;
-          })) {
-    return false;
-  }
-
-  // Must not be predicated. If the per-thread serial reduction is
-  // rfactored, the remaining block+grid reduction is not predicated.
-  if (!((grouped_wop->predicate()->hasValue() &&
-         grouped_wop->predicate()->value()) ||
-        GpuLower::current()->predicateElimination().canOmitPredicate(
-            grouped_wop))) {
-    return false;
-  }
-
-  return true;
-}
-
-} // namespace
-
 void IndexLowering::handleGroupedGridWelford(
     const GroupedWelfordOp* op,
     const std::vector<WelfordTriplet>& output_vals,
@@ -1293,6 +1509,12 @@ void IndexLowering::handleGroupedGridWelford(
 }
 
 void IndexLowering::handle(const kir::MBarrierInit* minit) {
+  // Elements of arrays of mbarriers are already indexed
+  if (minit->mbarrier()->isA<kir::TensorIndex>()) {
+    // TODO(kir): remove the need for const_cast
+    pushBack(const_cast<kir::MBarrierInit*>(minit)); // NOLINT
+    return;
+  }
   auto minit_indexed = IrBuilder::create<kir::MBarrierInit>(
       lower_utils::u32IndexScalarSmemTv(minit->mbarrier()->as<TensorView>()),
       minit->threadCount());
@@ -1301,12 +1523,34 @@ void IndexLowering::handle(const kir::MBarrierInit* minit) {
 }
 
 void IndexLowering::handle(const kir::MBarrierInvalidate* minval) {
+  if (minval->mbarrier()->isA<kir::TensorIndex>()) {
+    // TODO(kir): remove the need for const_cast
+    pushBack(const_cast<kir::MBarrierInvalidate*>(minval)); // NOLINT
+    return;
+  }
   auto minval_indexed = IrBuilder::create<kir::MBarrierInvalidate>(
       lower_utils::u32IndexScalarSmemTv(minval->mbarrier()->as<TensorView>()));
   pushBack(minval_indexed);
   GpuLower::current()->propagateExprInfo(minval, minval_indexed);
 }
 
+// The mbarrier operations of [MBarrier Handoff] are created with indexed
+// mbarriers by the double buffering pass
+void IndexLowering::handle(const kir::MBarrierArrive* arrive) {
+  // TODO(kir): remove the need for const_cast
+  pushBack(const_cast<kir::MBarrierArrive*>(arrive)); // NOLINT
+}
+
+void IndexLowering::handle(const kir::MBarrierWaitParity* wait) {
+  // TODO(kir): remove the need for const_cast
+  pushBack(const_cast<kir::MBarrierWaitParity*>(wait)); // NOLINT
+}
+
+void IndexLowering::handle(const kir::CpAsyncMBarrierArrive* arrive) {
+  // TODO(kir): remove the need for const_cast
+  pushBack(const_cast<kir::CpAsyncMBarrierArrive*>(arrive)); // NOLINT
+}
+
 void IndexLowering::handleCpAsyncBulkLoad(const LoadStoreOp* ldst) {
   auto out_tv = ldst->out()->as<TensorView>();
   auto in_tv = ldst->in()->as<TensorView>();
@@ -1356,6 +1600,101 @@ void IndexLowering::handleCpAsyncBulkStore(const LoadStoreOp* ldst) {
   pushBack(IrBuilder::create<kir::AsyncWait>(AsyncOpType::CpAsyncBulk, 0));
 }
 
+namespace {
+
+// Returns the number of bytes copied by a 1D bulk copy. The copied range is
+// the innermost root domain of the consumer, which needs to be fully covered
+// by its Bulk leaf domains, see [ TMA Loads of Persistent Buffers ]
+Val* getCpAsyncBulk1DBytes(TensorView* in_tv, TensorView* out_tv) {
+  NVF_ERROR(
+      in_tv->getMemoryType() == MemoryType::Global &&
+          out_tv->getMemoryType() == MemoryType::Shared,
+      "1D bulk copies are only supported from global to shared memory: ",
+      out_tv->toString());
+  NVF_ERROR(
+      !in_tv->hasAllocation() && !out_tv->hasAllocation(),
+      "1D bulk copies of tensors with allocation domains are not supported: ",
+      out_tv->toString());
+
+  IterDomain* inner_id = out_tv->getRootDomain().back();
+  NVF_ERROR(
+      in_tv->domain()->contiguity().back().value_or(false),
+      "The innermost domain of a 1D bulk copy needs to be contiguous: ",
+      in_tv->toString());
+
+  auto inner_leaf_ids = ir_utils::getLeafIDsSplitFrom(out_tv, inner_id);
+  NVF_ERROR(
+      inner_leaf_ids.has_value(),
+      "Only splits of the innermost domain of a 1D bulk copy are supported: ",
+      out_tv->toString());
+
+  const auto& leaf = out_tv->getLeafDomain();
+  const auto num_bulk = (int64_t)std::count_if(
+      leaf.begin(), leaf.end(), [](IterDomain* id) { return id->isBulk(); });
+  NVF_ERROR(
+      num_bulk == (int64_t)inner_leaf_ids->size() &&
+          std::equal(
+              inner_leaf_ids->begin(),
+              inner_leaf_ids->end(),
+              leaf.end() - num_bulk),
+      "The innermost leaf domains of a 1D bulk copy need to be the Bulk ",
+      "domains the innermost root domain is split into: ",
+      out_tv->toString());
+
+  return SimplifyingIrBuilder::maybeCastExpr(
+      DataType::UInt32,
+      SimplifyingIrBuilder::mulExpr(
+          inner_id->extent(),
+          IrBuilder::create<Val>(dataTypeSize(in_tv->dtype()))));
+}
+
+} // namespace
+
+void IndexLowering::handleCpAsyncBulk1DLoad(const LoadStoreOp* ldst) {
+  auto out_tv = ldst->out()->as<TensorView>();
+  auto in_tv = ldst->in()->as<TensorView>();
+  auto bytes = getCpAsyncBulk1DBytes(in_tv, out_tv);
+
+  auto mbarrier = GpuLower::current()->ldstMBarrierMap().at(ldst);
+  auto mbarrier_index = lower_utils::u32IndexScalarSmemTv(mbarrier);
+
+  auto state = IrBuilder::create<Val>(DataType::UInt);
+  pushBack(IrBuilder::create<kir::Allocate>(
+      state, MemoryType::Local, ldst->container()->oneVal()));
+
+  // The predicate elects one thread per copy and guards the copy. All the
+  // other threads only arrive at the mbarrier, which completes once all
+  // threads arrived and all the expected bytes have been copied.
+  NVF_ERROR(
+      ldst->predicate() != nullptr,
+      "1D bulk copies need to be predicated: ",
+      ldst->toString());
+  auto ite = IrBuilder::create<kir::IfThenElse>(ldst->predicate());
+  ite->thenBody().push_back(
+      IrBuilder::create<kir::MBarrierArriveExpectTx>(
+          state, mbarrier_index, bytes));
+
+  auto out = lowerDstIndex(ldst->out(), {}, true);
+  auto src_ptr =
+      lowerSrcIndex(ldst->in(), ldst->out(), {}, true)->as<kir::TensorIndex>();
+  auto index = IrBuilder::structExpr(
+      {{"src", src_ptr->index()},
+       {"bytes", bytes},
+       {"mbarrier", mbarrier_index}},
+      "Hopper::CpAsyncBulkG2SIndex");
+  auto in = IrBuilder::create<kir::TensorIndex>(in_tv, index);
+  auto new_ldst =
+      IrBuilder::create<LoadStoreOp>(ldst->opType(), out, in, ldst->cacheOp());
+  ite->thenBody().push_back(new_ldst);
+  GpuLower::current()->propagateExprInfo(ldst, new_ldst);
+
+  ite->elseBody().push_back(
+      IrBuilder::create<kir::MBarrierArrive>(state, mbarrier_index));
+  pushBack(ite);
+
+  pushBack(IrBuilder::create<kir::MBarrierWait>(mbarrier_index, state));
+}
+
 static DataType getMmaInputAType(MmaMacro macro) {
   int warp_group_size = isHopper(macro) ? 128 : 32;
   int size = getM(macro) * getK(macro) / warp_group_size /
@@ -1382,7 +1721,9 @@ static inline DataType getMmaOutType(TensorView* mma_out) {
 void IndexLowering::handle(const LoadStoreOp* ldst) {
   Val* in = nullptr;
   Val* out = nullptr;
-  if (ir_utils::isCpAsyncBulk(ldst)) {
+  if (ir_utils::isCpAsyncBulk1D(ldst)) {
+    handleCpAsyncBulk1DLoad(ldst);
+  } else if (ir_utils::isCpAsyncBulk(ldst)) {
     if (ir_utils::isCpAsyncBulkLoad(ldst)) {
       handleCpAsyncBulkLoad(ldst);
     } else if (ir_utils::isCpAsyncBulkStore(ldst)) {
@@ -1401,11 +1742,20 @@ void IndexLowering::handle(const LoadStoreOp* ldst) {
       // For MMA accumulator initialization
       as_type = getMmaOutType(ldst->out()->as<TensorView>());
     }
-    in = lowerSrcIndex(
-        ldst->in(),
-        ldst->out(),
-        {},
-        ir_utils::isLdMatrixOp(ldst) || ir_utils::isCpAsyncOp(ldst));
+    if (ir_utils::isWarpTransposeOp(ldst)) {
+      // The tile of each lane isn't indexed by the loops of the consumer, as
+      // the lanes exchange it. The producer holds exactly the tile, which is
+      // passed from its first element. See [ Register Transpose ]
+      in = IrBuilder::create<kir::TensorIndex>(
+          ldst->in()->as<TensorView>(),
+          GpuLower::current()->kernel()->zeroVal());
+    } else {
+      in = lowerSrcIndex(
+          ldst->in(),
+          ldst->out(),
+          {},
+          ir_utils::isLdMatrixOp(ldst) || ir_utils::isCpAsyncOp(ldst));
+    }
     out = lowerDstIndex(ldst->out(), {}, ir_utils::isCpAsyncOp(ldst), as_type);
     auto new_ldst =
         IrBuilder::create<LoadStoreOp>(ldst->opType(), out, in, ldst->cacheOp())
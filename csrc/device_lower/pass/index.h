@@ -61,6 +61,8 @@ class IndexLowering : private OptOutConstDispatch {
   void handle(const IndexSelectOp*) final;
   void handle(const TorchGatherOp*) final;
   void handle(const ScatterOp*) final;
+  void handle(const SortOp*) final;
+  void handle(const ScanOp*) final;
   void handle(const RNGOp*) final;
   void handle(const ReductionOp*) final;
   void handle(const GroupedReductionOp*) final;
@@ -80,6 +82,9 @@ class IndexLowering : private OptOutConstDispatch {
   void handle(const kir::GridSync*) final;
   void handle(const kir::MBarrierInit*) final;
   void handle(const kir::MBarrierInvalidate*) final;
+  void handle(const kir::MBarrierArrive*) final;
+  void handle(const kir::MBarrierWaitParity*) final;
+  void handle(const kir::CpAsyncMBarrierArrive*) final;
   void handle(const kir::AsyncWait*) final;
   void handle(const kir::AsyncCommit*) final;
 
@@ -117,9 +122,11 @@ class IndexLowering : private OptOutConstDispatch {
 
   void handleCpAsyncBulkLoad(const LoadStoreOp* ldst);
   void handleCpAsyncBulkStore(const LoadStoreOp* ldst);
+  void handleCpAsyncBulk1DLoad(const LoadStoreOp* ldst);
 
   void handleBlockReduction(const ReductionOp* rop, Val* out, Val* in);
   void handleGridReduction(const ReductionOp* rop, Val* out, Val* in);
+  void handleSerialGridReduction(const ReductionOp* rop, Val* out, Val* in);
 
   void handleBlockReduction(
       const GroupedReductionOp* rop,
@@ -6,12 +6,16 @@
  */
 // clang-format on
 
+#include <device_lower/lower2device.h>
 #include <device_lower/pass/inline_ptx.h>
 #include <device_lower/utils.h>
 #include <ir/builder.h>
 #include <ir/utils.h>
 #include <kernel_ir_dispatch.h>
 
+#include <ATen/cuda/CUDAContext.h>
+
+#include <cmath>
 #include <sstream>
 
 namespace nvfuser {
@@ -249,6 +253,100 @@ class LowerToInlinePtx : public kir::ExprMutator {
     registerRemove(mma);
   }
 
+  // Inserts before uop the approximate instruction op computing result from
+  // operand
+  void insertApprox(UnaryOp* uop, const char* op, Val* result, Val* operand) {
+    registerInsertBefore(
+        uop,
+        IrBuilder::create<kir::Asm>(
+            op, std::vector<Val*>{result}, std::vector<Val*>{operand}));
+  }
+
+  // Inserts before uop result = lhs <op> constant
+  void insertArith(
+      UnaryOp* uop,
+      BinaryOpType op,
+      Val* result,
+      Val* lhs,
+      double constant) {
+    registerInsertBefore(
+        uop,
+        IrBuilder::create<BinaryOp>(
+            op,
+            result,
+            lhs,
+            IrBuilder::create<Val>(constant, DataType::Float)));
+  }
+
+  // See [ Fast Math ]. The input is only read by the first instruction, as
+  // the output may reuse the buffer of the input.
+  void handle(UnaryOp* uop) override {
+    if (!GpuLower::current()->isFastMathEnabled() ||
+        !uop->out()->isA<kir::TensorIndex>() ||
+        uop->out()->dtype() != DataType::Float ||
+        uop->in()->dtype() != DataType::Float) {
+      return;
+    }
+    const auto properties = at::cuda::getCurrentDeviceProperties();
+    const bool has_tanh_approx =
+        properties->major * 10 + properties->minor >= 75;
+
+    Val* out = uop->out();
+    Val* in = uop->in();
+    switch (uop->getUnaryOpType()) {
+      case UnaryOpType::Exp2:
+        insertApprox(uop, "ex2.approx.ftz.f32", out, in);
+        break;
+      case UnaryOpType::Log2:
+        insertApprox(uop, "lg2.approx.ftz.f32", out, in);
+        break;
+      case UnaryOpType::Sin:
+        insertApprox(uop, "sin.approx.ftz.f32", out, in);
+        break;
+      case UnaryOpType::Cos:
+        insertApprox(uop, "cos.approx.ftz.f32", out, in);
+        break;
+      case UnaryOpType::Rsqrt:
+        insertApprox(uop, "rsqrt.approx.ftz.f32", out, in);
+        break;
+      case UnaryOpType::Reciprocal:
+        insertApprox(uop, "rcp.approx.ftz.f32", out, in);
+        break;
+      case UnaryOpType::Exp:
+        // exp(x) = 2^(x * log2(e))
+        insertArith(uop, BinaryOpType::Mul, out, in, 1.0 / std::log(2.0));
+        insertApprox(uop, "ex2.approx.ftz.f32", out, out);
+        break;
+      case UnaryOpType::Log:
+        // log(x) = log2(x) * log(2)
+        insertApprox(uop, "lg2.approx.ftz.f32", out, in);
+        insertArith(uop, BinaryOpType::Mul, out, out, std::log(2.0));
+        break;
+      case UnaryOpType::Log10:
+        insertApprox(uop, "lg2.approx.ftz.f32", out, in);
+        insertArith(uop, BinaryOpType::Mul, out, out, std::log10(2.0));
+        break;
+      case UnaryOpType::Tanh:
+        if (!has_tanh_approx) {
+          return;
+        }
+        insertApprox(uop, "tanh.approx.f32", out, in);
+        break;
+      case UnaryOpType::Sigmoid:
+        if (!has_tanh_approx) {
+          return;
+        }
+        insertArith(uop, BinaryOpType::Mul, out, in, 0.5);
+        insertApprox(uop, "tanh.approx.f32", out, out);
+        insertArith(uop, BinaryOpType::Mul, out, out, 0.5);
+        insertArith(uop, BinaryOpType::Add, out, out, 0.5);
+        break;
+      default:
+        return;
+    }
+    registerRemove(uop);
+  }
+
   void handle(MmaOp* mma) override {
     if (mma->isTuring() || mma->isAmpere()) {
       handleTuringOrAmpereMma(mma);
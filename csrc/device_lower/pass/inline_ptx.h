@@ -11,6 +11,23 @@
 
 namespace nvfuser {
 
+//! [ Fast Math ]
+//!
+//! Transcendental unary ops are generated as calls to the precise CUDA math
+//! functions. With CompileParams::enable_fast_math, unary ops on float
+//! tensors are instead lowered to the approximate PTX instructions of the
+//! special function units:
+//!   exp2, log2, sin, cos, rsqrt, reciprocal: ex2, lg2, sin, cos, rsqrt and
+//!     rcp .approx.ftz.f32
+//!   exp, log, log10: ex2 or lg2 with a multiplication by a constant, like
+//!     __expf and __logf
+//!   tanh, sigmoid: tanh.approx.f32, with sigmoid(x) = (tanh(x/2) + 1) / 2,
+//!     on sm_75 and later
+//! Subnormal inputs and results are flushed to zero. The error is a few ULPs
+//! for exp2, log2, rsqrt and reciprocal, grows with the magnitude of the
+//! input for exp and sin and cos, and is about 2^-11 relative for tanh.
+//! erf and other ops have no such instructions and stay precise. Use
+//! getFastMathErrors of test/validator.h to measure the error for an input.
 std::vector<Expr*> lowerToInlinePtx(const std::vector<Expr*>& exprs);
 
 } // namespace nvfuser
@@ -13,13 +13,43 @@
 #include <ir/utils.h>
 #include <kernel_ir.h>
 #include <kernel_ir_dispatch.h>
+#include <options.h>
 
+#include <algorithm>
 #include <unordered_set>
 
 namespace nvfuser {
 
 namespace {
 
+//! True if threads with different threadIdx.y or threadIdx.z access disjoint
+//! parts of the shared memory tensor tv, so row syncs protect it, see
+//! [ Row Barriers ]
+bool isPartitionedByRows(TensorView* tv) {
+  if (!isOptionEnabled(EnableOption::NamedBarriers)) {
+    return false;
+  }
+  const auto sync_bits = GpuLower::current()->syncMap()->needsRawSync(tv);
+  if (sync_bits.get(ParallelType::TIDy) || sync_bits.get(ParallelType::TIDz)) {
+    return false;
+  }
+  for (auto pt : {ParallelType::TIDy, ParallelType::TIDz}) {
+    Val* dim = GpuLower::current()->parallelDimensionMap().get(pt);
+    if (dim == nullptr || dim->isOneInt()) {
+      continue;
+    }
+    if (std::none_of(
+            tv->getLeafDomain().begin(),
+            tv->getLeafDomain().end(),
+            [pt](IterDomain* id) {
+              return id->getParallelType() == pt && !id->isBroadcast();
+            })) {
+      return false;
+    }
+  }
+  return true;
+}
+
 //! Scan through Kernel IR for-loops to insert Sync nodes to avoid
 //! Write-After-Read (WAR) race condition.
 //!
@@ -90,6 +120,10 @@ struct WarMemoryInfo {
 
   // For loop this TV is compute_at'ed in.
   kir::ForLoop* ca_loop = nullptr;
+
+  // True if all the tensors of this memory are partitioned by rows, so row
+  // syncs protect it, see [ Row Barriers ]
+  bool partitioned_by_rows = true;
 };
 
 // To prevent shared memory from being over written before it is read, a
@@ -147,13 +181,19 @@ class WarSyncInserter : private kir::ExprMutator {
 
   void handle(kir::BlockSync* sync) final {
     // Register the sync for the active for loop
-    sync_hit_.back() = true;
+    if (sync->isRowSync()) {
+      row_sync_hit_.back() = true;
+    } else {
+      sync_hit_.back() = true;
+    }
     // Run through the active allocations, if a read was hit, register there was
     // a sync after the read. If there's subsequent reads on this buffer the
-    // sync_after_read will be cleared.
+    // sync_after_read will be cleared. Row syncs only protect memory that is
+    // partitioned by rows.
     for (auto& entry : smem_allocations_) {
       auto& alloc_stack = entry.second;
-      if (alloc_stack.back().read_hit) {
+      if (alloc_stack.back().read_hit &&
+          (!sync->isRowSync() || alloc_stack.back().partitioned_by_rows)) {
         alloc_stack.back().sync_after_read = true;
       }
     }
@@ -173,11 +213,13 @@ class WarSyncInserter : private kir::ExprMutator {
     }
   }
 
-  // Checks if fl or loops within it have hit a sync
-  bool syncWithin(kir::ForLoop* fl) {
+  // Checks if fl or loops within it have hit a sync, or a row sync if
+  // row_syncs is true
+  bool syncWithin(kir::ForLoop* fl, bool row_syncs = false) {
+    const std::vector<bool>& sync_hit = row_syncs ? row_sync_hit_ : sync_hit_;
     // If outer most scope check the first sync_hit_ position
     if (fl == nullptr) {
-      return sync_hit_[0];
+      return sync_hit[0];
     }
 
     // Find the for loop we want to look within
@@ -187,8 +229,8 @@ class WarSyncInserter : private kir::ExprMutator {
     auto fl_i = std::distance(for_loops_.begin(), fl_it) + 1;
 
     // Start at that index and see if there's syncs within that for loop
-    for (auto i : c10::irange(fl_i, sync_hit_.size())) {
-      if (sync_hit_[i]) {
+    for (auto i : c10::irange(fl_i, sync_hit.size())) {
+      if (sync_hit[i]) {
         return true;
       }
     }
@@ -206,19 +248,26 @@ class WarSyncInserter : private kir::ExprMutator {
       return;
     }
 
-    // Mark write has been hit for all output tvs
+    // Mark write has been hit for all output tvs. Tensors handed off with
+    // mbarriers are protected by their empty mbarriers instead, see
+    // [MBarrier Handoff]
     auto out_tvs = ir_utils::filterByType<TensorView>(expr->outputs());
     for (auto out_tv : out_tvs) {
       if (out_tv->getMemoryType() != MemoryType::Shared ||
+          out_tv->hasMBarrierHandoff() ||
           GpuLower::current()->syncMap()->needsRawSync(out_tv).none()) {
         continue;
       }
 
       auto& entry = getMemInfo(out_tv);
+      entry.partitioned_by_rows =
+          entry.partitioned_by_rows && isPartitionedByRows(out_tv);
 
       // If this is the first write and there's a sync in one of the loops after
       // the compute at loop, then this buffer is protected.
-      if (syncWithin(entry.ca_loop) && !entry.write_hit) {
+      if ((syncWithin(entry.ca_loop) ||
+           (entry.partitioned_by_rows && syncWithin(entry.ca_loop, true))) &&
+          !entry.write_hit) {
         entry.sync_before_write = true;
       }
       entry.write_hit = true;
@@ -228,11 +277,14 @@ class WarSyncInserter : private kir::ExprMutator {
     auto inp_tvs = ir_utils::filterByType<TensorView>(expr->inputs());
     for (auto inp_tv : inp_tvs) {
       if (inp_tv->getMemoryType() != MemoryType::Shared ||
+          inp_tv->hasMBarrierHandoff() ||
           GpuLower::current()->syncMap()->needsRawSync(inp_tv).none()) {
         continue;
       }
 
       auto& entry = getMemInfo(inp_tv);
+      entry.partitioned_by_rows =
+          entry.partitioned_by_rows && isPartitionedByRows(inp_tv);
       entry.read_hit = true;
       // Clear the sync_after_read if it was set because there was another write
       entry.sync_after_read = false;
@@ -243,6 +295,7 @@ class WarSyncInserter : private kir::ExprMutator {
     // Push loop scope information
     auto prev_within_iter_loop_ = within_iter_loop_;
     sync_hit_.push_back(false);
+    row_sync_hit_.push_back(false);
 
     // If there is no real iterating loop WAR syncs aren't necessary
     within_iter_loop_ = within_iter_loop_ || !for_loop->isTrivial();
@@ -258,12 +311,17 @@ class WarSyncInserter : private kir::ExprMutator {
     //   Insert sync at end of this for loop if any of the entries require
     std::vector<TensorView*> to_erase;
     bool insert_sync = false;
+    // A row sync suffices if all the unprotected memory is partitioned by
+    // rows, see [ Row Barriers ]
+    bool insert_row_sync = true;
     for (auto& entry : smem_allocations_) {
       auto& alloc_stack = entry.second;
       if (!alloc_stack.empty() && alloc_stack.back().ca_loop == for_loop) {
         if (!alloc_stack.back().sync_after_read &&
             !alloc_stack.back().sync_before_write) {
           insert_sync = within_iter_loop_;
+          insert_row_sync =
+              insert_row_sync && alloc_stack.back().partitioned_by_rows;
         }
 
         alloc_stack.pop_back();
@@ -279,7 +337,7 @@ class WarSyncInserter : private kir::ExprMutator {
 
     // WAR Sync is necessary in this loop, register its insertion.
     if (insert_sync) {
-      auto sync_expr = IrBuilder::create<kir::BlockSync>(true);
+      auto sync_expr = IrBuilder::create<kir::BlockSync>(true, insert_row_sync);
       kir::ExprMutator::registerInsertAfter(
           for_loop->body().exprs().back(), sync_expr, &for_loop->body());
       handle(sync_expr);
@@ -287,6 +345,7 @@ class WarSyncInserter : private kir::ExprMutator {
 
     // Pop for loop scope information
     sync_hit_.pop_back();
+    row_sync_hit_.pop_back();
     within_iter_loop_ = prev_within_iter_loop_;
   }
 
@@ -330,6 +389,9 @@ class WarSyncInserter : private kir::ExprMutator {
   // write.
   std::vector<bool> sync_hit_ = {false};
 
+  // Same as sync_hit_ for row syncs, see [ Row Barriers ]
+  std::vector<bool> row_sync_hit_ = {false};
+
   // Keep track of the active allocations we need to protect. Key is the
   // "getRealBuffer", not the raw tv. There can be multiple WarMemoryInfo's
   // because of aliasing. If the "getRealBuffer" tv has a compute at outside the
@@ -482,6 +544,8 @@ class ReadAfterWriteSyncs : public kir::ExprMutator {
       sync_before_.pop_front();
       auto last_writes = last_writes_.front();
       last_writes_.pop_front();
+      const bool row_sync = row_syncs_.front();
+      row_syncs_.pop_front();
       // Found that a sync is needed
 
       // TODO: Explicitly test the 3 cases below
@@ -493,7 +557,8 @@ class ReadAfterWriteSyncs : public kir::ExprMutator {
         sync_expr = IrBuilder::create<kir::GridSync>(
             sync_bitmap, maybe_alloc->buffer());
       } else {
-        sync_expr = IrBuilder::create<kir::BlockSync>(false); // is not war sync
+        sync_expr = IrBuilder::create<kir::BlockSync>(
+            false, row_sync); // is not war sync
       }
 
       insertSyncExpr(last_writes, expr, sync_expr, maybe_alloc);
@@ -673,6 +738,7 @@ class ReadAfterWriteSyncs : public kir::ExprMutator {
 
         sync_before_.emplace_back(expr, bitmap);
         last_writes_.push_back(last_gmem_writes);
+        row_syncs_.push_back(false);
         gmem.clear();
       }
 
@@ -707,16 +773,19 @@ class ReadAfterWriteSyncs : public kir::ExprMutator {
         //  be taken into consideration when deciding which loopnest level
         //  to insert the block sync. see FusionRAWSyncInsertionPlace4.
         std::unordered_set<Expr*> smem_writes;
+        // A row sync suffices if all the pending writes are partitioned by
+        // rows, see [ Row Barriers ]
+        bool row_sync = true;
         for (auto it : smem) {
+          auto tv = it.first->as<TensorView>();
           // No need to keep track of shared mem writes that does not
           //  require a RAW block sync.
-          if (GpuLower::current()
-                  ->syncMap()
-                  ->needsRawSync(it.first->as<TensorView>())
-                  .hasTID()) {
+          if (GpuLower::current()->syncMap()->needsRawSync(tv).hasTID()) {
             smem_writes.insert(it.second);
+            row_sync = row_sync && isPartitionedByRows(tv);
           }
         }
+        row_syncs_.push_back(row_sync && !smem_writes.empty());
         last_writes_.push_back(smem_writes);
         smem.clear();
       }
@@ -761,6 +830,10 @@ class ReadAfterWriteSyncs : public kir::ExprMutator {
   //! it is not placed before those write expressions.
   std::deque<std::unordered_set<Expr*>> last_writes_;
 
+  //! Whether each sync of sync_before_ only needs to synchronize the rows of
+  //! the block, see [ Row Barriers ]
+  std::deque<bool> row_syncs_;
+
   //! Keep track of expressions that must be wait for cp.async to finish.
   std::deque<Expr*> cpasync_wait_before_;
 
@@ -27,6 +27,25 @@ std::vector<Expr*> insertWarThreadSynchronization(
 //! Insert syncs between writing to shared memory and then reading it.
 //! RAW pass is run before indexing, unrolling (loop duplication), memory
 //! aliasing, and index (grid/block bcast/reduction)
+//!
+//! [ Row Barriers ]
+//!
+//! When a block holds several rows of threads, e.g., with multiple reductions
+//! per block or warp-specialized layouts, a shared memory tensor is often
+//! only communicated among the threads of a row: it's parallelized with
+//! threadIdx.y and threadIdx.z, and its consumers only need a sync across
+//! threadIdx.x. A __syncthreads() for such a tensor makes every row wait for
+//! the slowest one. With NVFUSER_ENABLE=named_barriers, the RAW and WAR syncs
+//! of tensors whose rows are disjoint are row syncs instead, for which each
+//! row of blockDim.x threads synchronizes on its own named barrier with
+//! bar.sync, see block_sync::syncRow. There are 16 named barriers, and
+//! barrier 0 is used by __syncthreads(), so this falls back to a block sync
+//! at runtime if there are more than 15 rows, or if blockDim.x isn't a
+//! multiple of the warp size, as the barriers count whole warps.
+//!
+//! A row sync only protects the tensors of its rows. Syncs for tensors shared
+//! by rows, the syncs of memory reuse and those within the runtime functions
+//! of reductions and broadcasts still synchronize the whole block.
 std::vector<Expr*> insertRawThreadSynchronization(
     const std::vector<Expr*>& exprs);
 
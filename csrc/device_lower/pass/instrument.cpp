@@ -9,9 +9,12 @@
 #include <device_lower/pass/magic_zero.h>
 #include <iter_visitor.h>
 #include <kernel_ir_dispatch.h>
+#include <options.h>
 
 #include <device_lower/pass/instrument.h>
 
+#include <algorithm>
+
 namespace nvfuser {
 
 namespace {
@@ -21,6 +24,20 @@ class Instrumentor : private kir::IrVisitor {
   Instrumentor(const std::vector<Expr*>& exprs) {
     IrVisitor::handle(exprs);
 
+    // See [ Profiling of Top-Level Expressions ]
+    const auto& args = getEnableOptionArguments(EnableOption::KernelProfile);
+    if (std::find(args.begin(), args.end(), "loops") != args.end()) {
+      for (auto expr : exprs) {
+        if (expr->isOneOf<
+                kir::ForLoop,
+                kir::IfThenElse,
+                kir::BlockSync,
+                kir::GridSync>()) {
+          profile_.registerExpr(expr);
+        }
+      }
+    }
+
     if (profile_.getNumberOfProfileEntries() == 0) {
       exprs_ = exprs;
       return;
@@ -71,8 +88,9 @@ class Instrumentor : private kir::IrVisitor {
       return;
     }
 
-    // Allocate two integers for each entry. One is used for accumulating
-    // cycles, and another for couting the number of hits
+    // Allocate kEntrySize integers for each entry. One is used for
+    // accumulating cycles, another for couting the number of hits, and the
+    // others for the first start and the last end of profiled regions
     const std::vector<IterDomain*> new_buffer_ids = {
         IterDomainBuilder(
             GpuLower::current()->kernel()->zeroVal(),
@@ -80,7 +98,9 @@ class Instrumentor : private kir::IrVisitor {
             .build(),
         IterDomainBuilder(
             GpuLower::current()->kernel()->zeroVal(),
-            IrBuilder::create<Val>(2L, DataType::Index))
+            IrBuilder::create<Val>(
+                (int64_t)kir::KernelPerformanceProfile::kEntrySize,
+                DataType::Index))
             .build()};
 
     const auto buffer_domain = IrBuilder::create<TensorDomain>(new_buffer_ids);
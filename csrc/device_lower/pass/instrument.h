@@ -19,6 +19,19 @@ namespace nvfuser {
 //! profiled, so this pass should be called after all expressions are
 //! lowered. KernelPerformanceProfile is copied to Kernel after
 //! lowering.
+//!
+//! [ Profiling of Top-Level Expressions ]
+//!
+//! With NVFUSER_ENABLE=kernel_profile(loops), top-level loop nests,
+//! predicated top-level scopes, e.g., unswitched loop nests, and block and
+//! grid synchronizations are profiled as well. The generated code reads the
+//! cycle counter before and after each of them, and the last thread block
+//! accumulates the elapsed cycles as well as the first start and the last end
+//! into the profile buffer. The executor decodes the buffer into the time
+//! spent per expression and a timeline, which shows where a fused kernel
+//! stalls, e.g., on a synchronization after a loop that loads global memory.
+//! Since the cycle counter is read after a memory fence, the probes slow the
+//! kernel down, so the times are only meaningful relative to each other.
 std::vector<Expr*> instrumentKernel(const std::vector<Expr*>& exprs);
 
 } // namespace nvfuser
@@ -9,6 +9,7 @@
 
 #include <device_lower/analysis/index_compute.h>
 #include <device_lower/lower2device.h>
+#include <device_lower/utils.h>
 #include <dispatch.h>
 #include <instrumentation.h>
 #include <ir/utils.h>
@@ -57,8 +58,159 @@ class MagicZeroInserter : public kir::ExprMutator {
   std::vector<InsertionInfo> insertion_list_;
 };
 
+// Registers nvcc may hoist the indices and predicates of an unrolled loop
+// nest into, roughly a tenth of what a thread of a full block can have
+constexpr int64_t kMaxHoistedValues = 24;
+
+//! Finds the unrolled loop nests whose indices and predicates nvcc can hoist
+//! without taking many registers, see [ Magic Zero Elision ]
+class HoistableUnrolledLoopFinder {
+ public:
+  static void find(const std::vector<Expr*>& exprs) {
+    HoistableUnrolledLoopFinder finder;
+    finder.findInScope(exprs);
+    // Loops of different nests may share an index
+    for (auto index : finder.hoistable_indices_) {
+      if (!finder.protected_indices_.count(index)) {
+        GpuLower::current()->hoistableLoopIndices().insert(index);
+      }
+    }
+  }
+
+ private:
+  // Find the outermost unrolled loops that are small enough
+  void findInScope(const std::vector<Expr*>& exprs) {
+    for (auto expr : exprs) {
+      if (auto fl = dynamic_cast<kir::ForLoop*>(expr)) {
+        auto num_hoisted = fl->isUnrolled()
+            ? numHoistedValues(fl->body().exprs(), tripCount(fl))
+            : std::nullopt;
+        if (num_hoisted.has_value() &&
+            num_hoisted.value() <= kMaxHoistedValues) {
+          recordUnrolledLoops({fl});
+        } else {
+          if (fl->isUnrolled()) {
+            protected_indices_.insert(fl->index());
+          }
+          findInScope(fl->body().exprs());
+        }
+      } else if (auto ite = dynamic_cast<kir::IfThenElse*>(expr)) {
+        findInScope(ite->thenBody().exprs());
+        findInScope(ite->elseBody().exprs());
+      }
+    }
+  }
+
+  // Trip count of an unrolled loop, whose start and stop are constant
+  static std::optional<int64_t> tripCount(kir::ForLoop* fl) {
+    if (!fl->step()->isConstScalar()) {
+      return std::nullopt;
+    }
+    const auto start = fl->start()->evaluate().as<int64_t>();
+    const auto stop = fl->stop()->evaluate().as<int64_t>();
+    const auto step = fl->step()->evaluate().as<int64_t>();
+    return ceilDiv(std::max(stop - start, (int64_t)0), step);
+  }
+
+  // Number of tensor accesses and predicates in exprs, each executed
+  // iterations times in the unrolled nest, or std::nullopt if it can't be
+  // bounded
+  static std::optional<int64_t> numHoistedValues(
+      const std::vector<Expr*>& exprs,
+      std::optional<int64_t> iterations) {
+    if (!iterations.has_value()) {
+      return std::nullopt;
+    }
+    int64_t num_hoisted = 0;
+    for (auto expr : exprs) {
+      std::optional<int64_t> num_hoisted_in_expr = 0;
+      if (auto fl = dynamic_cast<kir::ForLoop*>(expr)) {
+        // The indices of a serial loop in an unrolled nest are only
+        // replicated by the enclosing unrolled loops
+        num_hoisted_in_expr = numHoistedValues(
+            fl->body().exprs(),
+            fl->isUnrolled() ? mulTripCount(iterations.value(), tripCount(fl))
+                             : iterations);
+      } else if (auto ite = dynamic_cast<kir::IfThenElse*>(expr)) {
+        auto num_hoisted_in_then =
+            numHoistedValues(ite->thenBody().exprs(), iterations);
+        auto num_hoisted_in_else =
+            numHoistedValues(ite->elseBody().exprs(), iterations);
+        if (num_hoisted_in_then.has_value() &&
+            num_hoisted_in_else.has_value()) {
+          // One more for the predicate
+          num_hoisted_in_expr = num_hoisted_in_then.value() +
+              num_hoisted_in_else.value() + iterations.value();
+        } else {
+          num_hoisted_in_expr = std::nullopt;
+        }
+      } else if (ir_utils::isTvOp(expr)) {
+        // The index of each global tensor and the predicate of the expr
+        int64_t num_accesses = 1;
+        for (const auto& vals : {expr->inputs(), expr->outputs()}) {
+          for (auto tv : ir_utils::filterByType<TensorView>(vals)) {
+            if (tv->getMemoryType() == MemoryType::Global) {
+              num_accesses++;
+            }
+          }
+        }
+        num_hoisted_in_expr = num_accesses * iterations.value();
+      }
+      if (!num_hoisted_in_expr.has_value()) {
+        return std::nullopt;
+      }
+      num_hoisted += num_hoisted_in_expr.value();
+      if (num_hoisted > kMaxHoistedValues) {
+        // Large enough to be protected, no need to look further
+        return num_hoisted;
+      }
+    }
+    return num_hoisted;
+  }
+
+  static std::optional<int64_t> mulTripCount(
+      int64_t iterations,
+      std::optional<int64_t> trip_count) {
+    if (!trip_count.has_value()) {
+      return std::nullopt;
+    }
+    return iterations * trip_count.value();
+  }
+
+  // Record the indices of the unrolled loops in the nests of exprs
+  void recordUnrolledLoops(const std::vector<Expr*>& exprs) {
+    for (auto expr : exprs) {
+      if (auto fl = dynamic_cast<kir::ForLoop*>(expr)) {
+        if (fl->isUnrolled()) {
+          hoistable_indices_.insert(fl->index());
+        }
+        recordUnrolledLoops(fl->body().exprs());
+      } else if (auto ite = dynamic_cast<kir::IfThenElse*>(expr)) {
+        recordUnrolledLoops(ite->thenBody().exprs());
+        recordUnrolledLoops(ite->elseBody().exprs());
+      }
+    }
+  }
+
+ private:
+  // Indices of the unrolled loops of small nests
+  std::unordered_set<Val*> hoistable_indices_;
+  // Indices of the other unrolled loops
+  std::unordered_set<Val*> protected_indices_;
+};
+
 } // namespace
 
+std::vector<Expr*> findHoistableUnrolledLoops(
+    const std::vector<Expr*>& exprs) {
+  FUSER_PERF_SCOPE("GpuLower::Lower::findHoistableUnrolledLoops");
+  if (isOptionEnabled(EnableOption::MagicZeroElision) &&
+      GpuLower::current()->isNvFuserZeroEnabled()) {
+    HoistableUnrolledLoopFinder::find(exprs);
+  }
+  return exprs;
+}
+
 std::vector<Expr*> insertMagicZero(const std::vector<Expr*>& exprs) {
   FUSER_PERF_SCOPE("GpuLower::Lower::insertMagicZero");
   if (!GpuLower::current()->isNvFuserZeroEnabled()) {
@@ -117,6 +269,10 @@ bool needsMagicZero(
     return false;
   }
 
+  if (GpuLower::current()->hoistableLoopIndices().count(loop->index())) {
+    return false;
+  }
+
   bool ref_dom_simple =
       reference_domain == nullptr || reference_domain->definition() != nullptr;
   bool ind_simple =
@@ -23,6 +23,22 @@ struct IndexFromIdGraph;
 //! This will make sure nvrtc does not aggressively save predicate and indices.
 std::vector<Expr*> insertMagicZero(const std::vector<Expr*>& exprs);
 
+//! [ Magic Zero Elision ]
+//!
+//! Magic zero keeps nvcc from hoisting the indices and predicates of all the
+//! iterations of an unrolled loop nest out of the nest, each of which would
+//! then be kept in a register throughout the kernel. It also keeps the
+//! unrolled loop indices from being folded into constants, so it costs
+//! instructions on every access. A nest with few tensor accesses and
+//! iterations, e.g., the unrolled loop of a small pointwise kernel, can't
+//! take many registers even if everything is hoisted out of it. This pass
+//! records the indices of the unrolled loops of such nests in
+//! GpuLower::hoistableLoopIndices, and needsMagicZero doesn't protect them.
+//! It must run right before indexing, after the loop nests are final.
+//!
+//! Enabled with NVFUSER_ENABLE=magic_zero_elision.
+std::vector<Expr*> findHoistableUnrolledLoops(const std::vector<Expr*>& exprs);
+
 //! Check if val is a reference to the magic zero variable
 bool isMagicZero(const Val* val);
 
@@ -43,6 +59,8 @@ Val* maybeUnwrapMagicZero(Val* val);
 // Magic zero protection should only be done for global memory and predicates.
 // We should avoid use on registers. Shared memory does not require it, but
 // likely wouldn't hurt.
+//
+// Loops recorded by findHoistableUnrolledLoops are never protected.
 bool needsMagicZero(
     kir::ForLoop* loop,
     IterDomain* reference_domain = nullptr,
@@ -8,12 +8,17 @@
 #include <device_lower/lower2device.h>
 #include <device_lower/pass/magic_zero.h>
 #include <expr_simplifier.h>
+#include <ir/builder.h>
 #include <iter_visitor.h>
 #include <kernel_ir_dispatch.h>
 #include <options.h>
 
 #include <device_lower/pass/scalar_hoist.h>
 
+#include <algorithm>
+#include <functional>
+#include <optional>
+
 namespace nvfuser {
 
 namespace {
@@ -23,7 +28,31 @@ bool shouldHoistToHost(Val* value) {
     return false;
   }
   auto def = value->definition();
-  return def->isA<kir::EncodeTensorMapTiled>();
+  return def->isOneOf<kir::EncodeTensorMapTiled, kir::EncodeFastDivmod>();
+}
+
+// Whether the value only depends on the kernel arguments, so it can be
+// evaluated on the host
+bool isHostEvaluable(Val* value) {
+  if (value->isConstScalar()) {
+    return true;
+  }
+  if (value->isFusionInput()) {
+    return !value->isA<TensorView>();
+  }
+  auto def = value->definition();
+  if (def == nullptr) {
+    return false;
+  }
+  if (def->isA<GetMetaData>()) {
+    auto tv = def->input(0);
+    return tv->isFusionInput() || tv->isFusionOutput();
+  }
+  if (!def->isOneOf<UnaryOp, BinaryOp, TernaryOp, GetAttr, GetItem>()) {
+    return false;
+  }
+  return std::all_of(
+      def->inputs().begin(), def->inputs().end(), isHostEvaluable);
 }
 
 // Get the position of the innermost non-trivial loop
@@ -335,11 +364,166 @@ std::vector<Val*> getAssumptions(const std::vector<kir::ForLoop*>& loops) {
 
 } // namespace
 
-Val* CommonScalarMap::hoistScalar(
+size_t CommonScalarMap::structuralHash(Val* value) {
+  if (auto it = structural_hashes_.find(value);
+      it != structural_hashes_.end()) {
+    return it->second;
+  }
+  size_t hash = 0;
+  auto def = value->definition();
+  if (def == nullptr) {
+    // Only constants are sameAs other leaves
+    hash = value->value().hasValue()
+        ? std::hash<std::string>()(value->toString())
+        : std::hash<Val*>()(value);
+  } else {
+    hash = typeid(*def).hash_code();
+    if (auto uop = dynamic_cast<UnaryOp*>(def)) {
+      hashCombine(hash, (size_t)uop->getUnaryOpType());
+    } else if (auto bop = dynamic_cast<BinaryOp*>(def)) {
+      hashCombine(hash, (size_t)bop->getBinaryOpType());
+    } else if (auto top = dynamic_cast<TernaryOp*>(def)) {
+      hashCombine(hash, (size_t)top->getTernaryOpType());
+    }
+    for (auto input : def->inputs()) {
+      hashCombine(hash, structuralHash(input));
+    }
+  }
+  structural_hashes_.emplace(value, hash);
+  return hash;
+}
+
+Val* CommonScalarMap::simplifyInLoops(
     Val* value,
     const std::vector<kir::ForLoop*>& loops) {
-  value =
+  std::vector<LoopInfo> loop_infos;
+  loop_infos.reserve(loops.size());
+  for (auto loop : loops) {
+    LoopInfo& info = loop_infos.emplace_back();
+    info.index = loop->index();
+    info.is_trivial = loop->isTrivial();
+    if (info.is_trivial) {
+      info.is_thread = loop->iter_domain()->isThread();
+    } else {
+      // simplifiedStop may recursively hoist and simplify the stop
+      info.start = loop->start();
+      info.stop = loop->simplifiedStop();
+      info.is_unrolled = loop->isUnrolled();
+    }
+  }
+
+  size_t hash = structuralHash(value);
+  for (const LoopInfo& info : loop_infos) {
+    hashCombine(hash, std::hash<Val*>()(info.index));
+    hashCombine(hash, std::hash<Val*>()(info.stop));
+  }
+
+  auto& candidates = simplified_scalars_[hash];
+  for (const auto& candidate : candidates) {
+    if (candidate.loops == loop_infos && value->sameAs(candidate.value)) {
+      return candidate.simplified;
+    }
+  }
+
+  Val* simplified =
       simplifyExpr(value, getVariableInfo(value, loops), getAssumptions(loops));
+  if (isOptionEnabled(EnableOption::FastDivmod)) {
+    simplified = lowerFastDivmod(simplified, loops);
+  }
+  // References to the elements of an unordered_map are not invalidated by
+  // insertions
+  candidates.push_back({value, std::move(loop_infos), simplified});
+  return simplified;
+}
+
+kir::EncodeFastDivmod* CommonScalarMap::getFastDivmod(Val* divisor) {
+  for (auto fast_divmod : fast_divmods_) {
+    if (fast_divmod->divisor()->sameAs(divisor)) {
+      return fast_divmod;
+    }
+  }
+  const DataType index_type = GpuLower::current()->kernel()->indexType();
+  auto fast_divmod = IrBuilder::create<kir::EncodeFastDivmod>(
+      IrBuilder::create<Val>(index_type),
+      IrBuilder::create<Val>(index_type),
+      divisor);
+  fast_divmods_.push_back(fast_divmod);
+  return fast_divmod;
+}
+
+// See [ Fast Divmod ]
+Val* CommonScalarMap::lowerFastDivmod(
+    Val* value,
+    const std::vector<kir::ForLoop*>& loops) {
+  std::optional<std::vector<Val*>> assumptions;
+  auto is_non_negative = [&](Val* x) {
+    if (!assumptions.has_value()) {
+      assumptions = getAssumptions(loops);
+    }
+    auto zero = IrBuilder::create<Val>(0L, DataType::Index);
+    return simplifyExpr(
+               IrBuilder::geExpr(x, zero),
+               getVariableInfo(x, loops),
+               *assumptions)
+        ->isTrue();
+  };
+
+  std::unordered_map<Val*, Val*> lowered;
+  std::function<Val*(Val*)> lower = [&](Val* x) -> Val* {
+    auto def = x->definition();
+    if (def == nullptr || def->outputs().size() != 1 ||
+        x->isOneOf<TensorView, kir::TensorIndex>() || def->isA<GetMetaData>()) {
+      return x;
+    }
+    if (auto it = lowered.find(x); it != lowered.end()) {
+      return it->second;
+    }
+
+    std::vector<Val*> inputs;
+    bool changed = false;
+    for (auto input : def->inputs()) {
+      inputs.push_back(lower(input));
+      changed = changed || inputs.back() != input;
+    }
+    Val* result = x;
+    if (changed) {
+      result = IrBuilder::create<Val>(*x->getDataType());
+      auto create_fn = def->newObjectFunc();
+      create_fn(x->container(), inputs, {result}, def->attributes());
+    }
+
+    auto bop = dynamic_cast<BinaryOp*>(result->definition());
+    if (bop != nullptr &&
+        (bop->getBinaryOpType() == BinaryOpType::Div ||
+         bop->getBinaryOpType() == BinaryOpType::Mod) &&
+        result->dtype() == DataType::Index &&
+        bop->lhs()->dtype() == DataType::Index &&
+        bop->rhs()->dtype() == DataType::Index &&
+        !bop->rhs()->isConstScalar() && isHostEvaluable(bop->rhs()) &&
+        is_non_negative(bop->lhs())) {
+      auto fast_divmod = getFastDivmod(bop->rhs());
+      Val* quotient = IrBuilder::create<Val>(DataType::Index);
+      IrBuilder::create<TernaryOp>(
+          TernaryOpType::FastDiv,
+          quotient,
+          bop->lhs(),
+          fast_divmod->multiplier(),
+          fast_divmod->shift());
+      result = bop->getBinaryOpType() == BinaryOpType::Div
+          ? quotient
+          : IrBuilder::subExpr(
+                bop->lhs(), IrBuilder::mulExpr(quotient, bop->rhs()));
+    }
+    lowered.emplace(x, result);
+    return result;
+  };
+  return lower(value);
+}
+
+Val* CommonScalarMap::hoistScalar(
+    Val* value,
+    const std::vector<kir::ForLoop*>& loops) {
+  value = simplifyInLoops(value, loops);
   std::vector<Val*> seen_subexprs;
   return hoistScalarImpl(
              value,
@@ -513,6 +697,10 @@ class CommonScalarInserter : private kir::ExprMutator {
         continue;
       }
 
+      if (insert_ref == nullptr && maybeReduceStrength(value, loop)) {
+        continue;
+      }
+
       auto alloc = IrBuilder::create<kir::Allocate>(
           value, MemoryType::Local, GpuLower::current()->kernel()->oneVal());
       const auto def = value->definition();
@@ -530,6 +718,82 @@ class CommonScalarInserter : private kir::ExprMutator {
     }
   }
 
+  // See [ Index Strength Reduction ]. If the hoisted value is
+  // base + index * stride of the given loop, computes base before the loop
+  // and increments it by stride * step at the end of each iteration.
+  bool maybeReduceStrength(Val* value, kir::ForLoop* loop) {
+    if (loop == nullptr ||
+        !isOptionEnabled(EnableOption::IndexStrengthReduction) ||
+        loop->iter_domain()->getParallelType() != ParallelType::Serial ||
+        loop->isTrivial() || loop->isUnrolled() || loop->body().empty() ||
+        !isIntegralType(value->dtype())) {
+      return false;
+    }
+    auto def = dynamic_cast<BinaryOp*>(value->definition());
+    if (def == nullptr || def->getBinaryOpType() != BinaryOpType::Add) {
+      return false;
+    }
+
+    // Returns the stride if the given value is index * stride
+    auto getStride = [&](Val* term) -> Val* {
+      if (term == loop->index()) {
+        return GpuLower::current()->kernel()->oneVal(term->dtype());
+      }
+      auto mul = dynamic_cast<BinaryOp*>(term->definition());
+      if (mul == nullptr || mul->getBinaryOpType() != BinaryOpType::Mul) {
+        return nullptr;
+      }
+      if (mul->lhs() == loop->index()) {
+        return mul->rhs();
+      }
+      if (mul->rhs() == loop->index()) {
+        return mul->lhs();
+      }
+      return nullptr;
+    };
+    Val* base = def->lhs();
+    Val* stride = getStride(def->rhs());
+    if (stride == nullptr) {
+      base = def->rhs();
+      stride = getStride(def->lhs());
+    }
+    if (stride == nullptr || dependsOnLoop(base, loop) ||
+        dependsOnLoop(stride, loop)) {
+      return false;
+    }
+
+    kir::Scope* outer_scope = scope_.empty() ? nullptr : scope_.back();
+    auto alloc = IrBuilder::create<kir::Allocate>(
+        value, MemoryType::Local, GpuLower::current()->kernel()->oneVal());
+    registerInsertBefore(loop, alloc, outer_scope);
+    // The definition of value becomes the one of its initial value
+    auto init = IrBuilder::create<LoadStoreOp>(
+        LoadStoreOpType::Set,
+        value,
+        SimplifyingIrBuilder::addExpr(
+            base, SimplifyingIrBuilder::mulExpr(loop->start(), stride)));
+    registerInsertBefore(loop, init, outer_scope);
+    registerInsertAfter(
+        loop->body().exprs().back(),
+        IrBuilder::create<kir::IncrementScalar>(
+            value, SimplifyingIrBuilder::mulExpr(loop->step(), stride)),
+        &loop->body());
+    return true;
+  }
+
+  // Whether the value may change across iterations of the loop
+  static bool dependsOnLoop(Val* value, kir::ForLoop* loop) {
+    if (value == loop->index() || value->isA<kir::TensorIndex>() ||
+        value->isA<TensorView>()) {
+      return true;
+    }
+    auto def = value->definition();
+    return def != nullptr &&
+        std::any_of(def->inputs().begin(), def->inputs().end(), [&](Val* in) {
+             return dependsOnLoop(in, loop);
+           });
+  }
+
   using kir::ExprMutator::handle;
 
   void handle(kir::ForLoop* loop) final {
@@ -96,7 +96,78 @@ class CommonScalarMap {
   //! return nullptr.
   Val* reuseScalarIfAlreadyComputed(Val* value, kir::ForLoop* loop);
 
+  //! [ Simplification Memo ]
+  //!
+  //! The indices and predicates of different tensors are built from the same
+  //! subexpressions, so hoistScalar is given many values that are sameAs each
+  //! other in the same loop nests, and simplifying each of them from scratch
+  //! is a large part of the lowering time of big kernels. The results of
+  //! simplifyExpr are thus kept for the whole lowering, bucketed by a
+  //! structural hash of the simplified value and by what the simplification
+  //! depends on in the loop nest, and reused for any later value that is
+  //! sameAs a simplified one in an equal loop nest.
+  Val* simplifyInLoops(Val* value, const std::vector<kir::ForLoop*>& loops);
+
+  //! Hash that is equal for values that are sameAs each other
+  size_t structuralHash(Val* value);
+
+  //! [ Fast Divmod ]
+  //!
+  //! The indices of merged domains of symbolic extents are divided by and
+  //! taken modulo those extents, e.g., i / T0.logical_size[1], and integer
+  //! division is a long sequence of instructions on the GPU. With
+  //! NVFUSER_ENABLE=fast_divmod, a division of a provably non-negative index
+  //! by a non-constant divisor that only depends on the kernel arguments is
+  //! instead
+  //!   fastDiv(i, multiplier, shift) = (umulhi(multiplier, i) + i) >> shift
+  //! whose multiplier and shift are kernel arguments computed on the host by
+  //! a kir::EncodeFastDivmod of the divisor d, where shift = ceil(log2(d))
+  //! and multiplier = floor(2^N * (2^shift - d) / d) + 1 for an index type of
+  //! N bits (Granlund and Montgomery, "Division by Invariant Integers using
+  //! Multiplication"). The quotient is exact for all indices less than
+  //! 2^(N - 1), for which the sum doesn't overflow. A modulo becomes
+  //! i - fastDiv(i, multiplier, shift) * d. Constant divisors are left to the
+  //! compiler, which does the same.
+  Val* lowerFastDivmod(Val* value, const std::vector<kir::ForLoop*>& loops);
+
+  //! The multiplier and shift of the given divisor, created once per
+  //! divisor, see [ Fast Divmod ]
+  kir::EncodeFastDivmod* getFastDivmod(Val* divisor);
+
  private:
+  //! What simplifyExpr depends on of a loop, i.e., the variables and
+  //! assumptions the loop introduces
+  struct LoopInfo {
+    Val* index = nullptr;
+    Val* start = nullptr;
+    Val* stop = nullptr;
+    bool is_trivial = false;
+    bool is_thread = false;
+    bool is_unrolled = false;
+
+    bool operator==(const LoopInfo& other) const {
+      return index == other.index && start == other.start &&
+          stop == other.stop && is_trivial == other.is_trivial &&
+          is_thread == other.is_thread && is_unrolled == other.is_unrolled;
+    }
+  };
+
+  struct SimplifiedScalar {
+    Val* value = nullptr;
+    std::vector<LoopInfo> loops;
+    Val* simplified = nullptr;
+  };
+
+  //! Simplified values by the combined hash of the value and
+  //! the loops, see [ Simplification Memo ]
+  std::unordered_map<size_t, std::vector<SimplifiedScalar>> simplified_scalars_;
+
+  //! Memoized results of structuralHash
+  std::unordered_map<Val*, size_t> structural_hashes_;
+
+  //! The multipliers and shifts of the divisors of fast divisions
+  std::vector<kir::EncodeFastDivmod*> fast_divmods_;
+
   //! Map to hold hoisted common indices. The order matters and indicates data
   //! dependency. For example, my list might have [i1*4, i1*4+2, i1*4/16]
   std::unordered_map<kir::ForLoop*, std::list<Val*>> common_scalar_map_;
@@ -108,6 +179,24 @@ class CommonScalarMap {
   std::unordered_set<Val*> hoisted_or_reused_;
 };
 
+//! [ Index Strength Reduction ]
+//!
+//! A hoisted index of a serial loop is typically the index of the outer
+//! loops plus a multiple of the loop index, e.g.,
+//!   FOR i2
+//!     index = i1_index + i2 * 128
+//! With NVFUSER_ENABLE=index_strength_reduction, such an index is instead
+//! allocated before the loop, initialized with its value in the first
+//! iteration, and incremented at the end of each iteration:
+//!   index = i1_index + start * 128
+//!   FOR i2
+//!     ...
+//!     index += step * 128;
+//! which replaces the multiplication by an addition. The definition of the
+//! index becomes the one of its initial value, and the increment is a
+//! kir::IncrementScalar. Unrolled loops are skipped, as the compiler folds
+//! their indices into constants anyway.
+
 //! Insert allocations of hoisted indices. Must be called after
 //! collecting all common indices.
 std::vector<Expr*> allocateCommonScalars(const std::vector<Expr*>& exprs);
@@ -16,6 +16,7 @@
 #include <ir/iostream.h>
 #include <ir/utils.h>
 #include <ops/arith.h>
+#include <options.h>
 #include <predicate_compute.h>
 
 namespace nvfuser {
@@ -213,6 +214,10 @@ void UnrollPass::handle(kir::ForLoop* fl) {
     return;
   }
 
+  unswitch(fl);
+}
+
+void UnrollPass::unswitch(kir::ForLoop* fl) {
   auto unroll_pred = IrBuilder::create<kir::Predicate>(fl);
 
   kir::IfThenElse* unroll_ite = IrBuilder::create<kir::IfThenElse>(unroll_pred);
@@ -241,7 +246,9 @@ void UnrollPass::handle(kir::ForLoop* fl) {
   scope_exprs_.push_back(unroll_ite);
   look_for_unroll_ = false;
   non_trivial_pred_found_ = false;
-  handle(inlined_loop);
+  if (!peelTail(inlined_loop)) {
+    handle(inlined_loop);
+  }
   look_for_unroll_ = true;
   scope_.pop_back();
   scope_exprs_.pop_back();
@@ -255,6 +262,76 @@ void UnrollPass::handle(kir::ForLoop* fl) {
   }
 }
 
+bool UnrollPass::peelTail(kir::ForLoop* inlined_loop) {
+  if (peeling_ || !isOptionEnabled(EnableOption::TailPeeling)) {
+    return false;
+  }
+
+  // Find the outermost loop of the nest that iterates more than once. The
+  // loops around it must be trivial, and it must not be parallelized, as it
+  // is the loop whose iterations are predicated separately.
+  std::vector<kir::ForLoop*> loop_chain({inlined_loop});
+  auto getSoleNestedLoop = [](kir::ForLoop* loop) -> kir::ForLoop* {
+    const auto& exprs = loop->body().exprs();
+    return exprs.size() == 1 ? dynamic_cast<kir::ForLoop*>(exprs.front())
+                             : nullptr;
+  };
+  while (loop_chain.back()->stop()->isOneInt()) {
+    auto nested_loop = getSoleNestedLoop(loop_chain.back());
+    if (nested_loop == nullptr) {
+      return false;
+    }
+    loop_chain.push_back(nested_loop);
+  }
+  kir::ForLoop* peeled_loop = loop_chain.back();
+  const auto ptype = peeled_loop->iter_domain()->getParallelType();
+  if (isParallelTypeThread(ptype) || isParallelTypeVectorize(ptype) ||
+      ptype == ParallelType::Mma) {
+    return false;
+  }
+  kir::ForLoop* body_loop = getSoleNestedLoop(peeled_loop);
+  if (body_loop == nullptr) {
+    return false;
+  }
+
+  // Iterations of the peeled loop may take different paths, so block syncs
+  // would diverge
+  const auto& pred_map = GpuLower::current()->threadPredMap();
+  std::vector<kir::ForLoop*> loops({inlined_loop});
+  while (!loops.empty()) {
+    auto loop = loops.back();
+    loops.pop_back();
+    for (auto expr : loop->body().exprs()) {
+      if (lower_utils::hasBlockSync(expr, pred_map) ||
+          expr->isA<kir::IfThenElse>()) {
+        return false;
+      }
+      if (auto nested_loop = dynamic_cast<kir::ForLoop*>(expr)) {
+        loops.push_back(nested_loop);
+      }
+    }
+  }
+
+  for (auto loop : loop_chain) {
+    for_loops_.push_back(loop);
+    scope_.push_back(&loop->body());
+    scope_exprs_.push_back(loop);
+  }
+
+  peeling_ = true;
+  unswitch(body_loop);
+  peeling_ = false;
+  look_for_unroll_ = false;
+
+  for (auto i : c10::irange(loop_chain.size())) {
+    (void)i;
+    for_loops_.pop_back();
+    scope_.pop_back();
+    scope_exprs_.pop_back();
+  }
+  return true;
+}
+
 bool UnrollPass::canOmitElseClause(kir::ForLoop* fl) {
   std::vector<kir::ForLoop*> loops({fl});
 
@@ -57,6 +57,29 @@ namespace nvfuser {
 //! predicate still in the inner most loop, making sure that we cover edges and
 //! corners.
 //!
+//! [ Tail Peeling ]
+//!
+//! With NVFUSER_ENABLE=tail_peeling, the second set of loops isn't fully
+//! predicated if the unswitched loop nest has a serial or unrolled loop,
+//! e.g., I0i{4} above, whose loop nest is predicated once per iteration:
+//!
+//!     } else {
+//!       for( k : I0i{4} )
+//!         if( i * 4 + k < I && j * 128 + 127 < J ){
+//!           for( l : I1i{128} )
+//!             T0[ ( i * 4 + k ) * J + j * 128 + l ] = ...
+//!         } else {
+//!           for( l : I1i{128} )
+//!             if( i * 4 + k < I && j * 128 + l < J)
+//!               T0[ ( i * 4 + k ) * J + j * 128 + l ] = ...
+//!         }
+//!     }
+//!
+//! This way, only the iterations of a tile that a non-divisible extent cuts
+//! off are predicated per access. The others still run unpredicated, e.g.,
+//! with vectorized accesses. The peeled loop must be the outermost loop of
+//! the nest that iterates more than once, and its body must be a single
+//! loop. Nests with block syncs or existing conditionals aren't peeled.
 class UnrollPass : kir::ExprMutator {
  public:
   // Take the incoming exprs and run loop unrolling, returning the new IR
@@ -78,6 +101,13 @@ class UnrollPass : kir::ExprMutator {
 
   void handle(kir::ForLoop* fl) final;
 
+  // Replace the loop nest with an unswitched and an inlined path
+  void unswitch(kir::ForLoop* fl);
+
+  // Unswitch the body of a loop of the inlined path, see [ Tail Peeling ].
+  // Returns false if the inlined loop nest can't be peeled.
+  bool peelTail(kir::ForLoop* inlined_loop);
+
   void dispatch(Expr* expr) final;
 
  private:
@@ -94,6 +124,9 @@ class UnrollPass : kir::ExprMutator {
   // As we generate inline predicates check if we actually generated a
   // non-trivial one.
   bool non_trivial_pred_found_ = false;
+
+  // Whether the currently visited expression is inside a peeled loop
+  bool peeling_ = false;
 };
 
 } // namespace nvfuser
@@ -383,13 +383,24 @@ class FuseBroadcastWithWarpReduce : private kir::IrVisitor {
 
   // Checks if the given IterDomain is mapped to a single warp,
   //  i.e. they are known at compile time to be of constant
-  //   size of warp_size and they are paralleled on TIDx
+  //   size of warp_size and they are paralleled on TIDx, or to a warp
+  //   segment, see [ Warp Segment Reduction ]
   int warp_size = at::cuda::warp_size();
   bool isSingleWarp(IterDomain* id) {
     if (id->getParallelType() != ParallelType::TIDx) {
       return false;
     }
 
+    // TIDx is exactly a segment, so all of its lanes have the result of a
+    // segment reduction
+    const auto segment_size =
+        GpuLower::current()->getWarpPaddedParallelInfo().tidx_warp_segment_size;
+    if (segment_size > 0) {
+      return id->isBroadcast() ||
+          (id->extent()->isConstScalar() &&
+           id->extent()->evaluate() == segment_size);
+    }
+
     if (!GpuLower::current()->getWarpPaddedParallelInfo().is_tidx_single_warp) {
       return false;
     }
@@ -12,10 +12,28 @@
 
 namespace nvfuser {
 
+//! [ Warp Segment Reduction ]
+//!
+//! Reductions over TIDx are lowered to warp reductions if TIDx is a
+//! multiple of a warp. Smaller reductions, e.g., softmax over a head
+//! dimension of 16, would otherwise use a block reduction, which goes
+//! through shared memory and synchronizes the block. With
+//! CompileParams::enable_warp_segment_reduction, which the inner persistent
+//! scheduler sets for small groups (see [ Small Group Persistence ]) and
+//! NVFUSER_ENABLE=warp_segment_reduction sets for all fusions, if TIDx is
+//! exactly a constant power of two smaller than a warp, each warp consists
+//! of segments of consecutive lanes that have the same threadIdx.y and
+//! threadIdx.z, i.e., a warp holds 32 / blockDim.x rows. A TIDx reduction
+//! is then a shuffle reduction within each segment, see
+//! warp::warpSegmentReduceTIDX, and as with single-warp reductions, a
+//! following broadcast over TIDx is fused into the reduction.
 struct WarpPaddedParallelInfo {
   bool is_tidx_padded = false;
   bool is_tidx_single_warp = false;
   bool has_warp_reduction = false;
+  //! blockDim.x if warp reductions are lowered to warp segment reductions,
+  //! 0 otherwise. See [ Warp Segment Reduction ]
+  int64_t tidx_warp_segment_size = 0;
 };
 
 std::vector<Expr*> fuseWarpReduce(const std::vector<Expr*> exprs);
@@ -140,6 +140,8 @@ bool isTvOp(const Expr* expr) {
           IndexSelectOp,
           TorchGatherOp,
           ScatterOp,
+          SortOp,
+          ScanOp,
           RNGOp,
           FullOp,
           IotaOp,
@@ -186,6 +188,13 @@ bool isCpAsyncOp(const Expr* expr) {
   return false;
 }
 
+bool isWarpTransposeOp(const Expr* expr) {
+  if (auto ldst = dynamic_cast<const LoadStoreOp*>(expr)) {
+    return ldst->opType() == LoadStoreOpType::WarpTranspose;
+  }
+  return false;
+}
+
 namespace {
 
 enum class CpAsyncBulkTileType { G2S, S2G, NotACpAsyncBulkTile };
@@ -225,6 +234,13 @@ bool isCpAsyncBulkStore(const Expr* expr) {
   return getCpAsyncBulkTileType(expr) == CpAsyncBulkTileType::S2G;
 }
 
+bool isCpAsyncBulk1D(const Expr* expr) {
+  if (auto ldst = dynamic_cast<const LoadStoreOp*>(expr)) {
+    return ldst->opType() == LoadStoreOpType::CpAsyncBulk;
+  }
+  return false;
+}
+
 bool isTensorScalarFillOp(const Expr* expr) {
   // Check that the input is a single scalar.
   if (expr->inputs().size() == 1 && expr->input(0)->isScalar()) {
@@ -302,7 +318,8 @@ bool isIterDomainOp(const Expr* expr) {
 
 std::optional<IterDomain*> getMaybeWarpReductionDim(
     const Val* output,
-    const Val* input) {
+    const Val* input,
+    int64_t warp_segment_size) {
   auto tv_out = getTv(output);
   if (tv_out == nullptr) {
     return std::nullopt;
@@ -342,7 +359,8 @@ std::optional<IterDomain*> getMaybeWarpReductionDim(
 
   if (reduction_on_xdim->extent()->isConstInt()) {
     auto extent_value = reduction_on_xdim->extent()->evaluate();
-    if (extent_value % at::cuda::warp_size() == 0) {
+    if (extent_value % at::cuda::warp_size() == 0 ||
+        (warp_segment_size > 0 && extent_value == warp_segment_size)) {
       return std::optional<IterDomain*>(reduction_on_xdim);
     }
   }
@@ -671,6 +689,16 @@ bool hasBlockSync(const Expr* expr, const ThreadPredicateMap& pred_map) {
     return false;
   }
 
+  // Scans across threads combine the totals of the warps in shared memory,
+  // see [ Scan Scheduler ]
+  if (expr->isA<ScanOp>()) {
+    const auto tv = ir_utils::getTvOutput(expr);
+    return std::any_of(
+        tv->getLeafDomain().begin(),
+        tv->getLeafDomain().end(),
+        [](IterDomain* id) { return id->isThreadDim(); });
+  }
+
   if (!(ir_utils::isReductionOp(expr) || expr->isA<BroadcastOp>() ||
         expr->isA<kir::GridBroadcast>())) {
     return false;
@@ -784,7 +812,15 @@ BasicAllocInfo getAllocInformation(
 //!  in type.cpp. Conceptually this should be a generic definition
 //!  rather than a util.
 bool supportInlinePredicate(Expr* expr) {
-  if (ir_utils::isCpAsyncOp(expr)) {
+  // The predicate of a 1D bulk copy only guards the copy itself. All threads
+  // need to arrive at its mbarrier.
+  if (ir_utils::isCpAsyncOp(expr) || ir_utils::isCpAsyncBulk1D(expr)) {
+    return true;
+  }
+  // All the lanes of a warp must take part in its shuffles. A warp transpose
+  // only writes registers of each thread, so it needs no predicate of its
+  // own, see [ Register Transpose ]
+  if (ir_utils::isWarpTransposeOp(expr)) {
     return true;
   }
   // TODO: build out support.
@@ -830,6 +866,17 @@ Val* u32IndexScalarSmemTv(TensorView* smem_tv) {
   return u32addr;
 }
 
+kir::TensorIndex* u32IndexSmemTvElement(TensorView* tv, Val* index) {
+  NVF_ERROR(tv->getMemoryType() == MemoryType::Shared);
+  auto offset = SimplifyingIrBuilder::mulExpr(
+      index,
+      IrBuilder::create<Val>(
+          (int64_t)dataTypeSize(tv->dtype()), DataType::Index));
+  auto u32addr =
+      SimplifyingIrBuilder::addExpr(u32IndexScalarSmemTv(tv), offset);
+  return IrBuilder::create<kir::TensorIndex>(tv, u32addr);
+}
+
 } // namespace lower_utils
 
 } // namespace nvfuser
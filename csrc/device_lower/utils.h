@@ -104,10 +104,12 @@ TensorView* getTvInput(const Expr*);
 
 //! Returns the iterdomain that maps to the thread dimension grouped
 //!  to warps. Returns nullopt if the reduction is not to be lowered to
-//!  a warp reduction.
+//!  a warp reduction. A non-zero warp_segment_size also accepts reductions
+//!  of that size, see [ Warp Segment Reduction ]
 std::optional<IterDomain*> getMaybeWarpReductionDim(
     const Val* output,
-    const Val* input);
+    const Val* input,
+    int64_t warp_segment_size = 0);
 
 bool isScalarOp(const Expr*);
 
@@ -132,12 +134,21 @@ bool isLdMatrixOp(const Expr* expr);
 //!  a cp.async intrinsic.
 bool isCpAsyncOp(const Expr* expr);
 
+//! Returns true if the expression transposes tiles across the lanes of
+//!  warps with shuffles, see [ Register Transpose ]
+bool isWarpTransposeOp(const Expr* expr);
+
 //! Returns true if the expression will be lowered to
 //!  a cp.async.bulk (a.k.a. TMA) intrinsic.
 bool isCpAsyncBulkLoad(const Expr* expr);
 bool isCpAsyncBulkStore(const Expr* expr);
 bool isCpAsyncBulk(const Expr* expr);
 
+//! Returns true if the expression will be lowered to a non-tensor
+//!  cp.async.bulk of a contiguous range, see
+//!  [ TMA Loads of Persistent Buffers ]
+bool isCpAsyncBulk1D(const Expr* expr);
+
 //! Short-cut for detecting initialization for cpAsync op.
 bool isCpAsyncInit(const Expr* expr);
 
@@ -302,6 +313,10 @@ bool isExtentEqualToMaxParallelTypeExtent(const IterDomain* id);
 // indexing special items in shared memory, like mbarrier.
 Val* u32IndexScalarSmemTv(TensorView* tv);
 
+// Get the uint32_t address of the given element of a 1D TensorView in shared
+// memory, like an mbarrier of each stage of a circular buffer.
+kir::TensorIndex* u32IndexSmemTvElement(TensorView* tv, Val* index);
+
 } // namespace lower_utils
 
 } // namespace nvfuser
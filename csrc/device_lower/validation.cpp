@@ -499,6 +499,23 @@ class VectorizeValidator : public OptInDispatch {
     vectorized_set_info.vectorized_leaf_id = v_id;
     vectorized_set_info.vectorized_consumer_alloc_id = consumer_vectorized_id;
 
+    // The lookup tensor of index_select is indexed along another dimension,
+    // so its rows along the innermost allocation domain are read as they
+    // are, see scheduler_utils::getInputsOutputsWithInnerDim
+    if (auto index_select = dynamic_cast<IndexSelectOp*>(tv->definition())) {
+      IterDomain* lookup_inner_id =
+          producer_tv->getMaybeAllocationDomain().back();
+      NVF_CHECK(
+          lookup_inner_id != index_select->getIndexedID() &&
+              producer_tv->domain()->contiguity().back().value_or(false),
+          "Vectorized index_select requires the lookup tensor to be contiguous and not indexed along its innermost dimension: ",
+          index_select->toString());
+      vectorized_set_info.vectorized_producer_alloc_id = lookup_inner_id;
+      GpuLower::current()->vectorizedSetInfo().emplace_back(
+          vectorized_set_info);
+      return;
+    }
+
     // Validate producer
     auto pairwise_map = PairwiseRootDomainMap(producer_tv, tv);
     auto producer_replayed_as_consumer =
@@ -581,7 +598,8 @@ void validateAndCollectVectorizeInfo(Fusion* fusion) {
     if (has_vectorize_dim) {
       NVF_ERROR(
           tv->definition() == nullptr || tv->definition()->isA<LoadStoreOp>() ||
-              tv->definition()->isA<SliceOp>(),
+              tv->definition()->isA<SliceOp>() ||
+              tv->definition()->isA<IndexSelectOp>(),
           "Vectorized accesses cannot be inline with computation, they are only supported with a Set operation.",
           "TensorView: ",
           tv);
@@ -8,6 +8,7 @@
 #pragma once
 
 #include <c10/util/Exception.h>
+#include <c10/util/irange.h>
 #include <exceptions.h>
 
 #include <algorithm>
@@ -175,6 +176,12 @@ class VectorOfUniqueEntries {
     set_.clear();
   }
 
+  // Reserves space for size elements
+  void reserve(size_t size) {
+    vector_.reserve(size);
+    set_.reserve(size);
+  }
+
   // Returns the number of elements in this container
   size_t size() const {
     return vector_.size();
@@ -260,12 +267,88 @@ class VectorOfUniqueEntries {
   std::unordered_set<T, Hash> set_;
 };
 
+//! Union-find over the dense ids [0, size()), with path halving and union by
+//! size, so finding the set of an id takes amortized near-constant time and
+//! the whole structure is two contiguous vectors. Unlike DisjointSets, the
+//! members of the sets are not kept, which makes it the container of choice
+//! when only the connectivity is needed.
+class UnionFind {
+ public:
+  explicit UnionFind(int64_t size = 0) {
+    resize(size);
+  }
+
+  int64_t size() const {
+    return (int64_t)parents_.size();
+  }
+
+  // Adds the ids from size() to new_size as singletons
+  void resize(int64_t new_size) {
+    NVF_ERROR(new_size >= size(), "UnionFind can't shrink");
+    num_sets_ += new_size - size();
+    parents_.reserve(new_size);
+    for (auto id = size(); id < new_size; ++id) {
+      parents_.push_back(id);
+    }
+    sizes_.resize(new_size, 1);
+  }
+
+  // Returns the representative id of the set of id
+  int64_t find(int64_t id) {
+    NVF_ERROR(id >= 0 && id < size(), "Invalid UnionFind id: ", id);
+    while (parents_[id] != id) {
+      parents_[id] = parents_[parents_[id]];
+      id = parents_[id];
+    }
+    return id;
+  }
+
+  // Merges the sets of id0 and id1. Returns true if they were disjoint.
+  bool join(int64_t id0, int64_t id1) {
+    id0 = find(id0);
+    id1 = find(id1);
+    if (id0 == id1) {
+      return false;
+    }
+    if (sizes_[id0] < sizes_[id1]) {
+      std::swap(id0, id1);
+    }
+    parents_[id1] = id0;
+    sizes_[id0] += sizes_[id1];
+    --num_sets_;
+    return true;
+  }
+
+  bool sameSet(int64_t id0, int64_t id1) {
+    return find(id0) == find(id1);
+  }
+
+  // Number of disjoint sets
+  int64_t numSets() const {
+    return num_sets_;
+  }
+
+ private:
+  std::vector<int64_t> parents_;
+  // Sizes of the sets, only valid for the representative ids
+  std::vector<int64_t> sizes_;
+  int64_t num_sets_ = 0;
+};
+
 //! Container class DisjointSet models equivalence relationships
 //!
 //! Each instance of this class keeps equivalence sets
 //! DisjointSet::mapEntries(a,b) makes the full set of a and b equivalent
 //! DisjointSet::*AreMapped(a,b) checks if a and b belong to the same disjoint
 //! set
+//!
+//! mapEntries always creates a new set for the merged entries, as users like
+//! ValGraph keep the original sets as keys. The merged sets are however not
+//! searched for and erased from the ordered list of sets, which was
+//! quadratic in the number of sets, but replaced by null and removed the
+//! next time the list is read. The list is thus compacted by the const
+//! accessors, which should not be called concurrently with each other after
+//! a modification.
 template <typename T, typename Hash = std::hash<T>>
 class DisjointSets {
  public:
@@ -286,6 +369,8 @@ class DisjointSets {
     using std::swap;
     swap(sets1.disjoint_sets_, sets2.disjoint_sets_);
     swap(sets1.disjoint_set_maps_, sets2.disjoint_set_maps_);
+    swap(sets1.set_positions_, sets2.set_positions_);
+    swap(sets1.num_erased_sets_, sets2.num_erased_sets_);
   }
 
   // Warning: returned values should never be modified. This accessor isn't
@@ -298,6 +383,7 @@ class DisjointSets {
   // strictly safe as VectorOfUniqueEntries is not returned as a const.
   const std::vector<std::shared_ptr<VectorOfUniqueEntries<T, Hash>>>&
   disjointSets() const {
+    compact();
     return disjoint_sets_;
   }
 
@@ -318,11 +404,10 @@ class DisjointSets {
       return std::make_pair(disjoint_set_maps_it, false);
     }
 
-    disjoint_sets_.push_back(
-        std::make_shared<VectorOfUniqueEntries<T, Hash>>());
-    disjoint_sets_.back()->pushBack(entry);
-    return disjoint_set_maps_.emplace(
-        std::make_pair(entry, disjoint_sets_.back()));
+    auto new_set = std::make_shared<VectorOfUniqueEntries<T, Hash>>();
+    new_set->pushBack(entry);
+    appendSet(new_set);
+    return disjoint_set_maps_.emplace(std::make_pair(entry, new_set));
   }
 
   // Adds all of the disjoint set belonging to entry1 to the disjoint set
@@ -341,9 +426,11 @@ class DisjointSets {
     }
 
     // Make and map new set
-    disjoint_sets_.push_back(
-        std::make_shared<VectorOfUniqueEntries<T, Hash>>());
-    auto new_set = disjoint_sets_.back();
+    auto new_set = std::make_shared<VectorOfUniqueEntries<T, Hash>>();
+    new_set->reserve(
+        (set_0_found ? set_it_0->second->size() : 1) +
+        (set_1_found ? set_it_1->second->size() : 1));
+    appendSet(new_set);
 
     // Add an entry to new_set along with the other entries previously
     // grouped together with the entry. The existing set is erased.
@@ -355,8 +442,7 @@ class DisjointSets {
           new_set->pushBack(existing_entry);
           disjoint_set_maps_[existing_entry] = new_set;
         }
-        disjoint_sets_.erase(std::find(
-            disjoint_sets_.begin(), disjoint_sets_.end(), existing_set));
+        eraseSet(existing_set);
       } else {
         new_set->pushBack(entry);
         disjoint_set_maps_[entry] = new_set;
@@ -414,8 +500,7 @@ class DisjointSets {
           set->front() == entry,
           "Disjoint set container found to be in inconsistent state.");
       disjoint_set_maps_.erase(entry);
-      disjoint_sets_.erase(
-          std::find(disjoint_sets_.begin(), disjoint_sets_.end(), set));
+      eraseSet(set);
     } else {
       disjoint_set_maps_.erase(entry);
       set->erase(entry);
@@ -430,7 +515,7 @@ class DisjointSets {
   // Warning: constructed on every call, consider caching result.
   VectorOfUniqueEntries<T, Hash> getAllElements() const {
     VectorOfUniqueEntries<T, Hash> all_elements;
-    for (auto set : disjoint_sets_) {
+    for (const auto& set : disjointSets()) {
       for (auto entry : set->vector()) {
         all_elements.pushBack(entry);
       }
@@ -442,13 +527,15 @@ class DisjointSets {
   void clear() {
     disjoint_set_maps_.clear();
     disjoint_sets_.clear();
+    set_positions_.clear();
+    num_erased_sets_ = 0;
   }
 
   std::string toString() const {
     std::stringstream ss;
     ss << "disjoint sets{\n";
     const std::string sep("  ");
-    for (auto s_ptr : disjoint_sets_) {
+    for (const auto& s_ptr : disjointSets()) {
       auto& set = *s_ptr;
       ss << sep << abstractToString(set) << "\n";
     }
@@ -457,10 +544,42 @@ class DisjointSets {
   }
 
   auto size() const {
-    return disjoint_sets_.size();
+    return disjoint_sets_.size() - num_erased_sets_;
   }
 
  private:
+  void appendSet(std::shared_ptr<VectorOfUniqueEntries<T, Hash>> set) {
+    set_positions_[set.get()] = disjoint_sets_.size();
+    disjoint_sets_.push_back(std::move(set));
+  }
+
+  // Replaces set by null in disjoint_sets_, see compact
+  void eraseSet(const std::shared_ptr<VectorOfUniqueEntries<T, Hash>>& set) {
+    auto position_it = set_positions_.find(set.get());
+    NVF_ERROR(
+        position_it != set_positions_.end(),
+        "Disjoint set container found to be in inconsistent state.");
+    disjoint_sets_.at(position_it->second) = nullptr;
+    set_positions_.erase(position_it);
+    ++num_erased_sets_;
+  }
+
+  // Removes the erased sets from disjoint_sets_, keeping the order of the
+  // others
+  void compact() const {
+    if (num_erased_sets_ == 0) {
+      return;
+    }
+    disjoint_sets_.erase(
+        std::remove(disjoint_sets_.begin(), disjoint_sets_.end(), nullptr),
+        disjoint_sets_.end());
+    set_positions_.clear();
+    for (auto i : c10::irange(disjoint_sets_.size())) {
+      set_positions_[disjoint_sets_[i].get()] = i;
+    }
+    num_erased_sets_ = 0;
+  }
+
   // Disjoint sets
   DisjointSetMap disjoint_set_maps_;
 
@@ -468,7 +587,16 @@ class DisjointSets {
   //
   // TODO: Should this just be a
   // VectorOfUniqueEntries<std::shared_ptr<VectorOfUniqueEntries ?
-  std::vector<std::shared_ptr<VectorOfUniqueEntries<T, Hash>>> disjoint_sets_;
+  //
+  // Erased sets are null until the next compact
+  mutable std::vector<std::shared_ptr<VectorOfUniqueEntries<T, Hash>>>
+      disjoint_sets_;
+
+  // Positions of the sets in disjoint_sets_
+  mutable std::unordered_map<const VectorOfUniqueEntries<T, Hash>*, size_t>
+      set_positions_;
+
+  mutable size_t num_erased_sets_ = 0;
 };
 
 template <typename T, typename Hash>
@@ -478,10 +606,10 @@ DisjointSets<T, Hash>::DisjointSets(const DisjointSets<T, Hash>& other) {
 
   // Deep copy the vector of the disjoint sets, keeping the same
   // ordering of the sets.
-  for (const auto& other_set : other.disjoint_sets_) {
+  for (const auto& other_set : other.disjointSets()) {
     auto new_set = std::make_shared<VectorOfUniqueEntries<T, Hash>>(*other_set);
     int new_set_index = disjoint_sets_.size();
-    disjoint_sets_.emplace_back(new_set);
+    appendSet(new_set);
     NVF_ERROR(
         ptr_map.emplace(other_set, new_set_index).second,
         "Duplicated set found: ",
@@ -499,8 +627,7 @@ DisjointSets<T, Hash>::DisjointSets(const DisjointSets<T, Hash>& other) {
 template <typename T, typename Hash>
 DisjointSets<T, Hash>& DisjointSets<T, Hash>::operator=(
     const DisjointSets<T, Hash>& other) {
-  disjoint_set_maps_.clear();
-  disjoint_sets_.clear();
+  clear();
 
   DisjointSets<T, Hash> copy(other);
   swap(*this, copy);
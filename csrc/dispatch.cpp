@@ -153,6 +153,14 @@ void Expr::dispatch(T handler, Expr* expr) {
     ptr(handler)->handle(expr->as<ScatterOp>());
     return;
   }
+  if (expr->isStrictlyA<SortOp>()) {
+    ptr(handler)->handle(expr->as<SortOp>());
+    return;
+  }
+  if (expr->isStrictlyA<ScanOp>()) {
+    ptr(handler)->handle(expr->as<ScanOp>());
+    return;
+  }
   if (expr->isStrictlyA<RNGOp>()) {
     ptr(handler)->handle(expr->as<RNGOp>());
     return;
@@ -277,6 +285,14 @@ void Expr::dispatch(T handler, Expr* expr) {
     ptr(handler)->handle(expr->as<kir::MBarrierWait>());
     return;
   }
+  if (expr->isStrictlyA<kir::MBarrierWaitParity>()) {
+    ptr(handler)->handle(expr->as<kir::MBarrierWaitParity>());
+    return;
+  }
+  if (expr->isStrictlyA<kir::CpAsyncMBarrierArrive>()) {
+    ptr(handler)->handle(expr->as<kir::CpAsyncMBarrierArrive>());
+    return;
+  }
   if (expr->isStrictlyA<kir::BlockSerializeWait>()) {
     ptr(handler)->handle(expr->as<kir::BlockSerializeWait>());
     return;
@@ -301,6 +317,10 @@ void Expr::dispatch(T handler, Expr* expr) {
     ptr(handler)->handle(expr->as<kir::UpdateMagicZero>());
     return;
   }
+  if (expr->isStrictlyA<kir::IncrementScalar>()) {
+    ptr(handler)->handle(expr->as<kir::IncrementScalar>());
+    return;
+  }
   if (expr->isStrictlyA<kir::ForLoop>()) {
     ptr(handler)->handle(expr->as<kir::ForLoop>());
     return;
@@ -345,6 +365,10 @@ void Expr::dispatch(T handler, Expr* expr) {
     ptr(handler)->handle(expr->as<kir::EncodeTensorMapTiled>());
     return;
   }
+  if (expr->isStrictlyA<kir::EncodeFastDivmod>()) {
+    ptr(handler)->handle(expr->as<kir::EncodeFastDivmod>());
+    return;
+  }
   if (expr->isStrictlyA<PipelineStage>()) {
     ptr(handler)->handle(expr->as<PipelineStage>());
     return;
@@ -477,6 +501,14 @@ void Expr::constDispatch(T handler, const Expr* expr) {
     ptr(handler)->handle(expr->as<ScatterOp>());
     return;
   }
+  if (expr->isStrictlyA<SortOp>()) {
+    ptr(handler)->handle(expr->as<SortOp>());
+    return;
+  }
+  if (expr->isStrictlyA<ScanOp>()) {
+    ptr(handler)->handle(expr->as<ScanOp>());
+    return;
+  }
   if (expr->isStrictlyA<RNGOp>()) {
     ptr(handler)->handle(expr->as<RNGOp>());
     return;
@@ -601,6 +633,14 @@ void Expr::constDispatch(T handler, const Expr* expr) {
     ptr(handler)->handle(expr->as<kir::MBarrierWait>());
     return;
   }
+  if (expr->isStrictlyA<kir::MBarrierWaitParity>()) {
+    ptr(handler)->handle(expr->as<kir::MBarrierWaitParity>());
+    return;
+  }
+  if (expr->isStrictlyA<kir::CpAsyncMBarrierArrive>()) {
+    ptr(handler)->handle(expr->as<kir::CpAsyncMBarrierArrive>());
+    return;
+  }
   if (expr->isStrictlyA<kir::BlockSerializeWait>()) {
     ptr(handler)->handle(expr->as<kir::BlockSerializeWait>());
     return;
@@ -625,6 +665,10 @@ void Expr::constDispatch(T handler, const Expr* expr) {
     ptr(handler)->handle(expr->as<kir::UpdateMagicZero>());
     return;
   }
+  if (expr->isStrictlyA<kir::IncrementScalar>()) {
+    ptr(handler)->handle(expr->as<kir::IncrementScalar>());
+    return;
+  }
   if (expr->isStrictlyA<kir::ForLoop>()) {
     ptr(handler)->handle(expr->as<kir::ForLoop>());
     return;
@@ -669,6 +713,10 @@ void Expr::constDispatch(T handler, const Expr* expr) {
     ptr(handler)->handle(expr->as<kir::EncodeTensorMapTiled>());
     return;
   }
+  if (expr->isStrictlyA<kir::EncodeFastDivmod>()) {
+    ptr(handler)->handle(expr->as<kir::EncodeFastDivmod>());
+    return;
+  }
   if (expr->isStrictlyA<PipelineStage>()) {
     ptr(handler)->handle(expr->as<PipelineStage>());
     return;
@@ -921,6 +969,12 @@ void OptOutConstDispatch::handle(const TorchGatherOp* stmt) {
 void OptOutConstDispatch::handle(const ScatterOp* stmt) {
   unhandled(stmt);
 }
+void OptOutConstDispatch::handle(const SortOp* stmt) {
+  unhandled(stmt);
+}
+void OptOutConstDispatch::handle(const ScanOp* stmt) {
+  unhandled(stmt);
+}
 void OptOutConstDispatch::handle(const RNGOp* stmt) {
   unhandled(stmt);
 }
@@ -1016,6 +1070,12 @@ void OptOutConstDispatch::handle(const kir::MBarrierArriveExpectTx* stmt) {
 void OptOutConstDispatch::handle(const kir::MBarrierWait* stmt) {
   unhandled(stmt);
 }
+void OptOutConstDispatch::handle(const kir::MBarrierWaitParity* stmt) {
+  unhandled(stmt);
+}
+void OptOutConstDispatch::handle(const kir::CpAsyncMBarrierArrive* stmt) {
+  unhandled(stmt);
+}
 void OptOutConstDispatch::handle(const kir::BlockSerializeWait* stmt) {
   unhandled(stmt);
 }
@@ -1034,6 +1094,9 @@ void OptOutConstDispatch::handle(const kir::InitMagicZero* stmt) {
 void OptOutConstDispatch::handle(const kir::UpdateMagicZero* stmt) {
   unhandled(stmt);
 }
+void OptOutConstDispatch::handle(const kir::IncrementScalar* stmt) {
+  unhandled(stmt);
+}
 void OptOutConstDispatch::handle(const kir::ForLoop* stmt) {
   unhandled(stmt);
 }
@@ -1067,6 +1130,9 @@ void OptOutConstDispatch::handle(const kir::GetRNGSeedAndOffsetFromHost* stmt) {
 void OptOutConstDispatch::handle(const kir::EncodeTensorMapTiled* stmt) {
   unhandled(stmt);
 }
+void OptOutConstDispatch::handle(const kir::EncodeFastDivmod* stmt) {
+  unhandled(stmt);
+}
 
 void OptOutConstDispatch::handle(const PipelineStage* stmt) {
   unhandled(stmt);
@@ -1161,6 +1227,12 @@ void OptOutDispatch::handle(TorchGatherOp* stmt) {
 void OptOutDispatch::handle(ScatterOp* stmt) {
   unhandled(stmt);
 }
+void OptOutDispatch::handle(SortOp* stmt) {
+  unhandled(stmt);
+}
+void OptOutDispatch::handle(ScanOp* stmt) {
+  unhandled(stmt);
+}
 void OptOutDispatch::handle(RNGOp* stmt) {
   unhandled(stmt);
 }
@@ -1256,6 +1328,12 @@ void OptOutDispatch::handle(kir::MBarrierArriveExpectTx* stmt) {
 void OptOutDispatch::handle(kir::MBarrierWait* stmt) {
   unhandled(stmt);
 }
+void OptOutDispatch::handle(kir::MBarrierWaitParity* stmt) {
+  unhandled(stmt);
+}
+void OptOutDispatch::handle(kir::CpAsyncMBarrierArrive* stmt) {
+  unhandled(stmt);
+}
 void OptOutDispatch::handle(kir::BlockSerializeWait* stmt) {
   unhandled(stmt);
 }
@@ -1274,6 +1352,9 @@ void OptOutDispatch::handle(kir::InitMagicZero* stmt) {
 void OptOutDispatch::handle(kir::UpdateMagicZero* stmt) {
   unhandled(stmt);
 }
+void OptOutDispatch::handle(kir::IncrementScalar* stmt) {
+  unhandled(stmt);
+}
 void OptOutDispatch::handle(kir::ForLoop* stmt) {
   unhandled(stmt);
 }
@@ -1307,6 +1388,9 @@ void OptOutDispatch::handle(kir::GetRNGSeedAndOffsetFromHost* stmt) {
 void OptOutDispatch::handle(kir::EncodeTensorMapTiled* stmt) {
   unhandled(stmt);
 }
+void OptOutDispatch::handle(kir::EncodeFastDivmod* stmt) {
+  unhandled(stmt);
+}
 
 void OptOutDispatch::handle(PipelineStage* stmt) {
   unhandled(stmt);
@@ -89,6 +89,8 @@ class SelectOp;
 class IndexSelectOp;
 class TorchGatherOp;
 class ScatterOp;
+class SortOp;
+class ScanOp;
 class RNGOp;
 class ReductionOp;
 class GroupedReductionOp;
@@ -130,6 +132,8 @@ class MBarrierInvalidate;
 class MBarrierArrive;
 class MBarrierArriveExpectTx;
 class MBarrierWait;
+class MBarrierWaitParity;
+class CpAsyncMBarrierArrive;
 class BlockSerializeWait;
 class BlockSerializeRelease;
 class AsyncWait;
@@ -145,8 +149,10 @@ class VectorizedWelfordOp;
 class AllocateFusedReduction;
 class InitMagicZero;
 class UpdateMagicZero;
+class IncrementScalar;
 class GetRNGSeedAndOffsetFromHost;
 class EncodeTensorMapTiled;
+class EncodeFastDivmod;
 
 } // namespace kir
 
@@ -196,6 +202,8 @@ class OptOutConstDispatch : public PolymorphicBase {
   virtual void handle(const IndexSelectOp* stmt);
   virtual void handle(const TorchGatherOp* stmt);
   virtual void handle(const ScatterOp* stmt);
+  virtual void handle(const SortOp* stmt);
+  virtual void handle(const ScanOp* stmt);
   virtual void handle(const RNGOp* stmt);
   virtual void handle(const ReductionOp* stmt);
   virtual void handle(const GroupedReductionOp* stmt);
@@ -229,12 +237,15 @@ class OptOutConstDispatch : public PolymorphicBase {
   virtual void handle(const kir::MBarrierArrive*);
   virtual void handle(const kir::MBarrierArriveExpectTx*);
   virtual void handle(const kir::MBarrierWait*);
+  virtual void handle(const kir::MBarrierWaitParity*);
+  virtual void handle(const kir::CpAsyncMBarrierArrive*);
   virtual void handle(const kir::BlockSerializeWait*);
   virtual void handle(const kir::BlockSerializeRelease*);
   virtual void handle(const kir::AsyncWait*);
   virtual void handle(const kir::AsyncCommit*);
   virtual void handle(const kir::InitMagicZero*);
   virtual void handle(const kir::UpdateMagicZero*);
+  virtual void handle(const kir::IncrementScalar*);
   virtual void handle(const kir::ForLoop*);
   virtual void handle(const kir::IfThenElse*);
   virtual void handle(const kir::GridReduction*);
@@ -246,6 +257,7 @@ class OptOutConstDispatch : public PolymorphicBase {
   virtual void handle(const kir::AllocateFusedReduction*);
   virtual void handle(const kir::GetRNGSeedAndOffsetFromHost*);
   virtual void handle(const kir::EncodeTensorMapTiled*);
+  virtual void handle(const kir::EncodeFastDivmod*);
 
   virtual void handle(const PipelineStage*);
   virtual void handle(const PipelineCommunication*);
@@ -293,6 +305,8 @@ class OptOutDispatch : public PolymorphicBase {
   virtual void handle(IndexSelectOp* stmt);
   virtual void handle(TorchGatherOp* stmt);
   virtual void handle(ScatterOp* stmt);
+  virtual void handle(SortOp* stmt);
+  virtual void handle(ScanOp* stmt);
   virtual void handle(RNGOp* stmt);
   virtual void handle(ReductionOp* stmt);
   virtual void handle(GroupedReductionOp* stmt);
@@ -326,12 +340,15 @@ class OptOutDispatch : public PolymorphicBase {
   virtual void handle(kir::MBarrierArrive* stmt);
   virtual void handle(kir::MBarrierArriveExpectTx* stmt);
   virtual void handle(kir::MBarrierWait* stmt);
+  virtual void handle(kir::MBarrierWaitParity* stmt);
+  virtual void handle(kir::CpAsyncMBarrierArrive* stmt);
   virtual void handle(kir::BlockSerializeWait* stmt);
   virtual void handle(kir::BlockSerializeRelease* stmt);
   virtual void handle(kir::AsyncWait* stmt);
   virtual void handle(kir::AsyncCommit* stmt);
   virtual void handle(kir::InitMagicZero* stmt);
   virtual void handle(kir::UpdateMagicZero* stmt);
+  virtual void handle(kir::IncrementScalar* stmt);
   virtual void handle(kir::ForLoop* stmt);
   virtual void handle(kir::IfThenElse* stmt);
   virtual void handle(kir::GridReduction* stmt);
@@ -343,6 +360,7 @@ class OptOutDispatch : public PolymorphicBase {
   virtual void handle(kir::AllocateFusedReduction* stmt);
   virtual void handle(kir::GetRNGSeedAndOffsetFromHost* stmt);
   virtual void handle(kir::EncodeTensorMapTiled* stmt);
+  virtual void handle(kir::EncodeFastDivmod* stmt);
 
   virtual void handle(PipelineStage* stmt);
   virtual void handle(PipelineCommunication* stmt);
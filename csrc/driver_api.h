@@ -23,10 +23,17 @@ namespace nvfuser {
 #define ALL_DRIVER_API_WRAPPER_CUDA11(fn) \
   fn(cuDeviceGetAttribute);               \
   fn(cuDeviceGetName);                    \
+  fn(cuCtxGetCurrent);                    \
   fn(cuFuncGetAttribute);                 \
   fn(cuFuncSetAttribute);                 \
   fn(cuGetErrorName);                     \
   fn(cuGetErrorString);                   \
+  fn(cuGraphAddMemsetNode);               \
+  fn(cuGraphCreate);                      \
+  fn(cuGraphDestroy);                     \
+  fn(cuGraphExecDestroy);                 \
+  fn(cuGraphInstantiateWithFlags);        \
+  fn(cuGraphLaunch);                      \
   fn(cuLaunchCooperativeKernel);          \
   fn(cuLaunchKernel);                     \
   fn(cuModuleGetFunction);                \
@@ -34,12 +41,22 @@ namespace nvfuser {
   fn(cuModuleUnload);                     \
   fn(cuOccupancyMaxActiveBlocksPerMultiprocessor)
 
+// Kernel node APIs are versioned starting from CUDA 12, where cuda.h maps the
+// unversioned names to the _v2 entry points with macros. Wrap the versioned
+// symbols directly so that the symbol we load matches the declared signature.
 #if (CUDA_VERSION >= 12000)
-#define ALL_DRIVER_API_WRAPPER(fn)   \
-  ALL_DRIVER_API_WRAPPER_CUDA11(fn); \
+#define ALL_DRIVER_API_WRAPPER(fn)       \
+  ALL_DRIVER_API_WRAPPER_CUDA11(fn);     \
+  fn(cuGraphAddKernelNode_v2);           \
+  fn(cuGraphExecKernelNodeSetParams_v2); \
+  fn(cuLaunchKernelEx);                  \
+  fn(cuOccupancyMaxActiveClusters);      \
   fn(cuTensorMapEncodeTiled)
 #else
-#define ALL_DRIVER_API_WRAPPER ALL_DRIVER_API_WRAPPER_CUDA11
+#define ALL_DRIVER_API_WRAPPER(fn)   \
+  ALL_DRIVER_API_WRAPPER_CUDA11(fn); \
+  fn(cuGraphAddKernelNode);          \
+  fn(cuGraphExecKernelNodeSetParams)
 #endif
 
 ALL_DRIVER_API_WRAPPER(DECLARE_DRIVER_API_WRAPPER);
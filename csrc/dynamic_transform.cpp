@@ -10,6 +10,7 @@
 #include <executor_kernel_arg.h>
 #include <expr_evaluator.h>
 #include <fusion.h>
+#include <instrumentation.h>
 #include <ir/cloner.h>
 #include <ir/utils.h>
 #include <ops/alias.h>
@@ -50,6 +51,7 @@ DynamicTransformInitialInfo DynamicTransformInitialInfo::clone(
   for (const auto v : root_dynamic_vals_) {
     cloned_info.root_dynamic_vals_.insert(ir_cloner.clone(v));
   }
+  cloned_info.root_dynamic_val_positions_ = root_dynamic_val_positions_;
   return cloned_info;
 }
 
@@ -192,6 +194,38 @@ class DynamicTransformInitialInfoBuilder : public IterVisitor {
         info_.scalar_inputs_affecting_concretization_.insert(i);
       }
     }
+
+    // Locate the root Vals among the scalar inputs and the extents of the
+    // input TensorViews, so a concretization can be looked up by their
+    // values without evaluating anything
+    std::vector<std::pair<size_t, int64_t>> positions;
+    std::unordered_set<Val*> located;
+    for (const auto i : c10::irange(info_.fusion()->inputs().size())) {
+      auto input = info_.fusion()->inputs().at(i);
+      if (dyn_vals.count(input)) {
+        positions.emplace_back(i, -1);
+        located.insert(input);
+        continue;
+      }
+      auto input_tv = dynamic_cast<TensorView*>(input);
+      if (input_tv == nullptr) {
+        continue;
+      }
+      const auto root_dom =
+          TensorDomain::noReductions(input_tv->getMaybeRFactorDomain());
+      for (const auto axis : c10::irange((int64_t)root_dom.size())) {
+        Val* extent = root_dom.at(axis)->getMaybeExpandedExtent();
+        if (dyn_vals.count(extent)) {
+          positions.emplace_back(i, axis);
+          located.insert(extent);
+        }
+      }
+    }
+    if (std::all_of(dyn_vals.begin(), dyn_vals.end(), [&located](Val* v) {
+          return v->isConstScalar() || located.count(v);
+        })) {
+      info_.root_dynamic_val_positions_ = std::move(positions);
+    }
   }
 
   //! Convert maybe_zero_extents_set_ to a vector so we can index it reliably
@@ -246,6 +280,38 @@ DynamicTransformConcretizationInfo::DynamicTransformConcretizationInfo(
       empty_extents_.push_back(i);
     }
   }
+
+  computeSignature();
+}
+
+void DynamicTransformConcretizationInfo::computeSignature() {
+  // Each group of decisions starts with its size, so groups need no
+  // delimiters
+  signature_.clear();
+  signature_.push_back((int64_t)reshape_transforms_.size());
+  for (const auto& [tv_index, view_result] : reshape_transforms_) {
+    signature_.push_back((int64_t)tv_index);
+    view_result.encode(signature_);
+  }
+  signature_.push_back((int64_t)resize_itertypes_.size());
+  for (const auto& [id_index, iter_type] : resize_itertypes_) {
+    signature_.push_back((int64_t)id_index);
+    signature_.push_back((int64_t)iter_type);
+  }
+  signature_.push_back((int64_t)expand_axes_.size());
+  for (const auto& [tv_index, expand_axes] : expand_axes_) {
+    signature_.push_back((int64_t)tv_index);
+    signature_.push_back((int64_t)expand_axes.size());
+    signature_.insert(signature_.end(), expand_axes.begin(), expand_axes.end());
+  }
+  signature_.push_back((int64_t)empty_extents_.size());
+  signature_.insert(
+      signature_.end(), empty_extents_.begin(), empty_extents_.end());
+
+  hash_ = 0;
+  for (const int64_t v : signature_) {
+    hashCombine(hash_, std::hash<int64_t>{}(v));
+  }
 }
 
 void DynamicTransformConcretizationInfo::analyzeReshapes(
@@ -415,46 +481,7 @@ bool DynamicTransformConcretizationInfo::operator==(
   if (this == &other) {
     return true;
   }
-
-  if (reshape_transforms_.size() != other.reshape_transforms_.size() ||
-      resize_itertypes_.size() != other.resize_itertypes_.size() ||
-      empty_extents_.size() != other.empty_extents_.size()) {
-    return false;
-  }
-
-  for (const auto i : c10::irange(reshape_transforms_.size())) {
-    const auto& analysis = reshape_transforms_.at(i);
-    const auto& other_analysis = other.reshape_transforms_.at(i);
-    if (analysis != other_analysis) {
-      return false;
-    }
-  }
-
-  for (const auto i : c10::irange(resize_itertypes_.size())) {
-    const auto& itertype = resize_itertypes_.at(i);
-    const auto& other_itertype = other.resize_itertypes_.at(i);
-    if (itertype != other_itertype) {
-      return false;
-    }
-  }
-
-  for (const auto i : c10::irange(expand_axes_.size())) {
-    const auto& expand_axes = expand_axes_.at(i);
-    const auto& other_expand_axes = other.expand_axes_.at(i);
-    if (expand_axes != other_expand_axes) {
-      return false;
-    }
-  }
-
-  for (const auto i : c10::irange(empty_extents_.size())) {
-    const auto& ee = empty_extents_.at(i);
-    const auto& other_ee = other.empty_extents_.at(i);
-    if (ee != other_ee) {
-      return false;
-    }
-  }
-
-  return true;
+  return hash_ == other.hash_ && signature_ == other.signature_;
 }
 
 std::string DynamicTransformConcretizationInfo::toString() const {
@@ -1077,27 +1104,8 @@ DynamicTransformInitialInfo DynamicTransform::getInitialInfo(Fusion* fusion) {
 void DynamicTransform::concretizeFusion(
     Fusion* fusion,
     const DynamicTransformConcretizationInfo* info) {
+  FUSER_PERF_SCOPE("DynamicTransform::concretizeFusion");
   DynamicTransformConcretizer concretizer(fusion, info);
 }
 
-size_t DynamicTransformConcretizationInfo::hash() const {
-  size_t hash = 0;
-  for (const auto& [tv, view_result] : getReshapeTransforms()) {
-    hashCombine(hash, view_result.hash());
-  }
-  for (const auto& extent_idx : getEmptyExtents()) {
-    hashCombine(hash, (size_t)extent_idx);
-  }
-  for (const auto& [id, iter_type] : getResizeIterTypes()) {
-    hashCombine(hash, (size_t)iter_type);
-  }
-  for (const auto& [id, expand_axes] : getExpandAxes()) {
-    hashCombine(hash, (size_t)id);
-    for (bool e : expand_axes) {
-      hashCombine(hash, (size_t)e);
-    }
-  }
-  return hash;
-}
-
 } // namespace nvfuser
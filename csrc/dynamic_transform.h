@@ -19,6 +19,7 @@
 
 #include <functional>
 #include <memory>
+#include <optional>
 #include <vector>
 
 namespace nvfuser {
@@ -62,6 +63,16 @@ class DynamicTransformInitialInfo {
     return root_dynamic_vals_;
   }
 
+  //! Return the position among the fusion inputs of each non-constant root
+  //! dynamic Val as the index of the input and, for the extent of an input
+  //! TensorView, its axis, or -1 for a scalar input. Returns nullopt if a root
+  //! dynamic Val is neither, in which case concretization can't be keyed by
+  //! the input values alone.
+  const std::optional<std::vector<std::pair<size_t, int64_t>>>&
+  getRootDynamicValPositions() const {
+    return root_dynamic_val_positions_;
+  }
+
   //! Return a set of scalars that appear as extents in TensorViews in the
   //! Fusion. If any of these evaluate to zero, there is at least one empty
   //! TensorView present.
@@ -129,6 +140,10 @@ class DynamicTransformInitialInfo {
   // Root Vals that determine concretization
   std::unordered_set<Val*> root_dynamic_vals_;
 
+  // Positions of root_dynamic_vals_ among the fusion inputs
+  std::optional<std::vector<std::pair<size_t, int64_t>>>
+      root_dynamic_val_positions_;
+
   friend class DynamicTransformInitialInfoBuilder;
 };
 
@@ -176,7 +191,8 @@ class DynamicTransformConcretizationInfo {
   //! not guarantee equality of all members. Instead, it returns equal if the
   //! resulting concretizations would be structurally equivalent. Note that
   //! pointers to Statements may differ between equivalent concretizations due
-  //! to cloning before concretization.
+  //! to cloning before concretization. Only the hashes and the signatures are
+  //! compared, see signature().
   bool operator==(const DynamicTransformConcretizationInfo& other) const;
 
   bool operator!=(const DynamicTransformConcretizationInfo& other) const {
@@ -210,13 +226,25 @@ class DynamicTransformConcretizationInfo {
 
   std::string toString() const;
 
-  size_t hash() const;
+  size_t hash() const {
+    return hash_;
+  }
+
+  //! Integers encoding all of the concretization decisions, in the order of
+  //! the dynamic ops in initialInfo(). Two infos concretize a fusion the same
+  //! way if and only if their signatures are equal.
+  const std::vector<int64_t>& signature() const {
+    return signature_;
+  }
 
  private:
   DynamicTransformConcretizationInfo(
       const DynamicTransformInitialInfo* initial_info)
       : initial_info_(initial_info) {}
 
+  //! Compute signature_ and hash_ from the analysis results
+  void computeSignature();
+
  private:
   const DynamicTransformInitialInfo* initial_info_ = nullptr;
 
@@ -239,6 +267,10 @@ class DynamicTransformConcretizationInfo {
   //! of bools indicating whether each axis is in fact expanded.
   std::vector<std::pair<size_t, std::vector<bool>>> expand_axes_;
 
+  std::vector<int64_t> signature_;
+
+  size_t hash_ = 0;
+
   friend class DynamicTransformInfoBuilder;
 };
 
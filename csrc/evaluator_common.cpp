@@ -15,7 +15,9 @@
 #include <ir/utils.h>
 #include <tensor_metadata.h>
 
+#include <numeric>
 #include <optional>
+#include <unordered_set>
 
 namespace nvfuser {
 
@@ -378,6 +380,7 @@ NaiveValueMachine::NaiveValueMachine(PrecomputedValues& precomputed_values)
       }
     }
   }
+  makeRegisterInstructions();
 }
 
 void NaiveValueMachine::copyFrom(const NaiveValueMachine& other) {
@@ -399,25 +402,48 @@ void NaiveValueMachine::copyFrom(const NaiveValueMachine& other) {
   bop_type_.insert(
       bop_type_.end(), other.bop_type_.begin(), other.bop_type_.end());
 
+  top_type_.clear();
+  top_type_.insert(
+      top_type_.end(), other.top_type_.begin(), other.top_type_.end());
+
   src0_.clear();
   src0_.insert(src0_.end(), other.src0_.begin(), other.src0_.end());
 
   src1_.clear();
   src1_.insert(src1_.end(), other.src1_.begin(), other.src1_.end());
 
+  src2_.clear();
+  src2_.insert(src2_.end(), other.src2_.begin(), other.src2_.end());
+
   dest_.clear();
   dest_.insert(dest_.end(), other.dest_.begin(), other.dest_.end());
+
+  on_registers_ = other.on_registers_;
+  register_type_ = other.register_type_;
+  register_inputs_ = other.register_inputs_;
+  registers_.assign(other.registers_.size(), 0);
 }
 
 void NaiveValueMachine::run() {
+  bool use_registers = loadRegisters();
   for (const auto i : c10::irange(num_of_instructions_)) {
     // Skip this instruction if the dest location
     //  has already been computed or is constant.
-    if (precomputed_values_.defined_[dest_[i]] ||
-        precomputed_values_.is_constant_[dest_[i]]) {
+    const int dest_index = dest_[i];
+    if (precomputed_values_.defined_[dest_index] ||
+        precomputed_values_.is_constant_[dest_index]) {
+      continue;
+    }
+    if (use_registers && on_registers_[i]) {
+      runRegisterInstruction(i);
       continue;
     }
     runInstruction(i);
+    // Instructions on registers may read the result
+    if (use_registers && register_type_[dest_index] != RegisterType::None &&
+        precomputed_values_.defined_[dest_index]) {
+      use_registers = loadRegister(dest_index);
+    }
   }
 }
 
@@ -468,6 +494,9 @@ void NaiveValueMachine::makeTernaryOp(TernaryOp* top) {
   int index = makeInstructionEntry();
   inst_type_[index] = InstructionType::TERNARY_OP;
   top_type_[index] = top->getTernaryOpType();
+  if (top_type_[index] == TernaryOpType::FastDiv) {
+    data_type_[index] = top->in2()->getDataType().value();
+  }
   src0_[index] = in0;
   src1_[index] = in1;
   src2_[index] = in2;
@@ -671,6 +700,13 @@ void NaiveValueMachine::runTernaryOp(int index) {
     case TernaryOpType::Clamp:
       dest = std::min(std::max(a, b), c);
       break;
+    case TernaryOpType::FastDiv:
+      dest = fastDiv(
+          a.as<int64_t>(),
+          b.as<int64_t>(),
+          c.as<int64_t>(),
+          data_type_[index] == DataType::Int32 ? 32 : 64);
+      break;
     case TernaryOpType::Lerp:
       // This is the same lerp computed in helpers.cu
       // https://math.stackexchange.com/a/1798323
@@ -689,4 +725,260 @@ void NaiveValueMachine::runTernaryOp(int index) {
   precomputed_values_.defined_[dest_index] = true;
 }
 
+void NaiveValueMachine::makeRegisterInstructions() {
+  const auto& symbols = precomputed_values_.symbols_;
+  register_type_.resize(symbols.size(), RegisterType::None);
+  for (const auto i : c10::irange(symbols.size())) {
+    const auto dtype = symbols[i]->dtype();
+    if (dtype == DataType::Bool) {
+      register_type_[i] = RegisterType::Bool;
+    } else if (isIntegralType(dtype)) {
+      register_type_[i] = RegisterType::Int;
+    }
+  }
+  registers_.assign(symbols.size(), 0);
+
+  on_registers_.resize(num_of_instructions_, false);
+  std::unordered_set<int> inputs;
+  for (const auto i : c10::irange(num_of_instructions_)) {
+    on_registers_[i] = canRunOnRegisters(i);
+    if (!on_registers_[i]) {
+      continue;
+    }
+    for (int src : {src0_[i], src1_[i], src2_[i]}) {
+      if (src >= 0 && inputs.insert(src).second) {
+        register_inputs_.push_back(src);
+      }
+    }
+  }
+}
+
+bool NaiveValueMachine::canRunOnRegisters(int index) const {
+  auto is = [&](int value_index, RegisterType type) {
+    return register_type_[value_index] == type;
+  };
+  constexpr auto kInt = RegisterType::Int;
+  constexpr auto kBool = RegisterType::Bool;
+  const int dest = dest_[index];
+  switch (inst_type_[index]) {
+    case InstructionType::UNARY_OP:
+      switch (uop_type_[index]) {
+        case UnaryOpType::Neg:
+        case UnaryOpType::Abs:
+        case UnaryOpType::BitwiseNot:
+          return is(src0_[index], kInt) && is(dest, kInt);
+        case UnaryOpType::LogicalNot:
+          return is(src0_[index], kBool) && is(dest, kBool);
+        case UnaryOpType::Cast:
+          return !is(src0_[index], RegisterType::None) &&
+              !is(dest, RegisterType::None);
+        default:
+          return false;
+      }
+    case InstructionType::BINARY_OP:
+      switch (bop_type_[index]) {
+        case BinaryOpType::Add:
+        case BinaryOpType::Sub:
+        case BinaryOpType::Mul:
+        case BinaryOpType::Div:
+        case BinaryOpType::Mod:
+        case BinaryOpType::CeilDiv:
+        case BinaryOpType::BitwiseAnd:
+        case BinaryOpType::BitwiseOr:
+        case BinaryOpType::BitwiseXor:
+        case BinaryOpType::Max:
+        case BinaryOpType::Min:
+        case BinaryOpType::Gcd:
+          return is(src0_[index], kInt) && is(src1_[index], kInt) &&
+              is(dest, kInt);
+        case BinaryOpType::LT:
+        case BinaryOpType::LE:
+        case BinaryOpType::Eq:
+        case BinaryOpType::NE:
+        case BinaryOpType::GE:
+        case BinaryOpType::GT:
+          return is(src0_[index], kInt) && is(src1_[index], kInt) &&
+              is(dest, kBool);
+        case BinaryOpType::LogicalAnd:
+        case BinaryOpType::LogicalOr:
+          return is(src0_[index], kBool) && is(src1_[index], kBool) &&
+              is(dest, kBool);
+        default:
+          return false;
+      }
+    case InstructionType::TERNARY_OP:
+      switch (top_type_[index]) {
+        case TernaryOpType::Clamp:
+          return is(src0_[index], kInt) && is(src1_[index], kInt) &&
+              is(src2_[index], kInt) && is(dest, kInt);
+        case TernaryOpType::Where:
+          return is(src0_[index], kBool) && !is(dest, RegisterType::None) &&
+              is(src1_[index], register_type_[dest]) &&
+              is(src2_[index], register_type_[dest]);
+        default:
+          return false;
+      }
+    case InstructionType::SET_OP:
+      return false;
+  }
+  return false;
+}
+
+bool NaiveValueMachine::loadRegisters() {
+  for (int index : register_inputs_) {
+    if ((precomputed_values_.defined_[index] ||
+         precomputed_values_.is_constant_[index]) &&
+        !loadRegister(index)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool NaiveValueMachine::loadRegister(int index) {
+  const auto& value = precomputed_values_.values_[index];
+  if (value.is<int64_t>()) {
+    registers_[index] = value.as<int64_t>();
+    return true;
+  }
+  if (value.is<bool>()) {
+    registers_[index] = value.as<bool>();
+    return true;
+  }
+  return false;
+}
+
+void NaiveValueMachine::runRegisterInstruction(int index) {
+  auto is_available = [&](int value_index) {
+    return value_index < 0 || precomputed_values_.defined_[value_index] ||
+        precomputed_values_.is_constant_[value_index];
+  };
+  if (!is_available(src0_[index]) || !is_available(src1_[index]) ||
+      !is_available(src2_[index])) {
+    return;
+  }
+  auto reg = [&](int value_index) {
+    return value_index < 0 ? 0 : registers_[value_index];
+  };
+  const int64_t a = reg(src0_[index]);
+  const int64_t b = reg(src1_[index]);
+  const int64_t c = reg(src2_[index]);
+  const int dest_index = dest_[index];
+
+  int64_t dest = 0;
+  switch (inst_type_[index]) {
+    case InstructionType::UNARY_OP:
+      switch (uop_type_[index]) {
+        case UnaryOpType::Neg:
+          dest = -a;
+          break;
+        case UnaryOpType::Abs:
+          dest = std::abs(a);
+          break;
+        case UnaryOpType::BitwiseNot:
+          dest = ~a;
+          break;
+        case UnaryOpType::LogicalNot:
+          dest = !a;
+          break;
+        case UnaryOpType::Cast:
+          dest = register_type_[dest_index] == RegisterType::Bool ? a != 0 : a;
+          break;
+        default:
+          NVF_ERROR(false, "Unexpected operator type ", uop_type_[index]);
+      }
+      break;
+    case InstructionType::BINARY_OP:
+      switch (bop_type_[index]) {
+        case BinaryOpType::Add:
+          dest = a + b;
+          break;
+        case BinaryOpType::Sub:
+          dest = a - b;
+          break;
+        case BinaryOpType::Mul:
+          dest = a * b;
+          break;
+        case BinaryOpType::Div:
+          NVF_CHECK(b != 0);
+          dest = a / b;
+          break;
+        case BinaryOpType::Mod:
+          NVF_CHECK(b != 0);
+          dest = a % b;
+          break;
+        case BinaryOpType::CeilDiv:
+          NVF_CHECK(b != 0);
+          dest = b > 0 ? (a + b - 1) / b : (a + b + 1) / b;
+          break;
+        case BinaryOpType::BitwiseAnd:
+          dest = a & b;
+          break;
+        case BinaryOpType::BitwiseOr:
+          dest = a | b;
+          break;
+        case BinaryOpType::BitwiseXor:
+          dest = a ^ b;
+          break;
+        case BinaryOpType::Max:
+          dest = std::max(a, b);
+          break;
+        case BinaryOpType::Min:
+          dest = std::min(a, b);
+          break;
+        case BinaryOpType::Gcd:
+          dest = std::gcd(a, b);
+          break;
+        case BinaryOpType::LT:
+          dest = a < b;
+          break;
+        case BinaryOpType::LE:
+          dest = a <= b;
+          break;
+        case BinaryOpType::Eq:
+          dest = a == b;
+          break;
+        case BinaryOpType::NE:
+          dest = a != b;
+          break;
+        case BinaryOpType::GE:
+          dest = a >= b;
+          break;
+        case BinaryOpType::GT:
+          dest = a > b;
+          break;
+        case BinaryOpType::LogicalAnd:
+          dest = a && b;
+          break;
+        case BinaryOpType::LogicalOr:
+          dest = a || b;
+          break;
+        default:
+          NVF_ERROR(false, "Unexpected operator type ", bop_type_[index]);
+      }
+      break;
+    case InstructionType::TERNARY_OP:
+      switch (top_type_[index]) {
+        case TernaryOpType::Clamp:
+          dest = std::min(std::max(a, b), c);
+          break;
+        case TernaryOpType::Where:
+          dest = a ? b : c;
+          break;
+        default:
+          NVF_ERROR(false, "Unexpected operator type ", top_type_[index]);
+      }
+      break;
+    case InstructionType::SET_OP:
+      NVF_ERROR(false, "Set instructions don't run on registers");
+  }
+
+  registers_[dest_index] = dest;
+  precomputed_values_.values_[dest_index] =
+      register_type_[dest_index] == RegisterType::Bool
+      ? PolymorphicValue(dest != 0)
+      : PolymorphicValue(dest);
+  precomputed_values_.defined_[dest_index] = true;
+}
+
 } // namespace nvfuser
@@ -29,10 +29,25 @@ struct TensorArgAbstract;
 //!   and it currently must be associated with an instance of
 //!   PrecomputedValues that will provide the workspace
 //!   containing the concrete values for the values.
+//!
+//! [ Register Evaluation ]
+//!  Most values are integers or booleans, e.g., extents, launch
+//!   parameters and allocation sizes. The instructions computing
+//!   them only from other integers and booleans are marked at
+//!   construction, and run on a flat file of int64_t registers
+//!   indexed like the workspace, without dispatching on the
+//!   runtime type of PolymorphicValue. Their results are still
+//!   stored in the workspace, and the other instructions are
+//!   interpreted on PolymorphicValue. If a value bound to an
+//!   integer or boolean symbol holds another type, the whole run
+//!   falls back to interpreting PolymorphicValue.
 class NaiveValueMachine {
   //! The generic types of instructions supported for this machine.
   enum class InstructionType { UNARY_OP, BINARY_OP, TERNARY_OP, SET_OP };
 
+  //! The type of the register holding a value, if any.
+  enum class RegisterType { None, Int, Bool };
+
  public:
   //! Constructor lowers all the expr IR nodes stored in precomputed_values
   //!  and stores them in the private state.
@@ -76,6 +91,28 @@ class NaiveValueMachine {
   //! Runs a ternary operation at given index of instruction buffer
   void runTernaryOp(int index);
 
+  //! Marks the instructions that run on registers,
+  //!  see [ Register Evaluation ]
+  void makeRegisterInstructions();
+
+  //! Returns if the instruction at the given index only reads
+  //!  and writes integers and booleans.
+  bool canRunOnRegisters(int index) const;
+
+  //! Loads all the defined values read by instructions on
+  //!  registers. Returns false if one of them holds neither an
+  //!  integer nor a boolean.
+  bool loadRegisters();
+
+  //! Loads the value at the given index of the workspace into
+  //!  its register. Returns false if it holds neither an integer
+  //!  nor a boolean.
+  bool loadRegister(int index);
+
+  //! Runs the instruction at the given index on registers, and
+  //!  stores its result in the workspace too.
+  void runRegisterInstruction(int index);
+
  private:
   friend PrecomputedValues;
 
@@ -99,8 +136,9 @@ class NaiveValueMachine {
   //!  value at each index corresponding to a binary op.
   std::vector<UnaryOpType> uop_type_;
 
-  //! Data type for unary op of type UnaryOpType::Cast, contains a default
-  //!  value at each index corresponding other ops.
+  //! Data type for unary op of type UnaryOpType::Cast and of the multiplier
+  //!  of TernaryOpType::FastDiv, contains a default value at each index
+  //!  corresponding other ops.
   std::vector<DataType> data_type_;
 
   //! Binary operator type if applicable, contains a default
@@ -128,6 +166,19 @@ class NaiveValueMachine {
 
   //! Destination of each instruction.
   std::vector<int> dest_;
+
+  //! Whether each instruction runs on registers.
+  std::vector<bool> on_registers_;
+
+  //! Type of the register of each value in the workspace.
+  std::vector<RegisterType> register_type_;
+
+  //! Values read by the instructions on registers, which are
+  //!  loaded at the start of each run.
+  std::vector<int> register_inputs_;
+
+  //! Integer and boolean values of the workspace.
+  std::vector<int64_t> registers_;
 };
 
 //! PrecomputedValues:
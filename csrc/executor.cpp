@@ -9,15 +9,18 @@
 #include <executor.h>
 
 #include <codegen.h>
+#include <compile_thread_pool.h>
 #include <debug.h>
 #include <device_lower/analysis/bank_conflict.h>
 #include <driver_api.h>
 #include <executor_kernel_arg.h>
 #include <executor_utils.h>
+#include <fusion_profiler.h>
 #include <instrumentation.h>
 #include <ir/all_nodes.h>
 #include <ir/utils.h>
 #include <iter_visitor.h>
+#include <kernel_db/utils.h>
 #include <kernel_ir.h>
 #include <options.h>
 #include <polymorphic_value.h>
@@ -35,6 +38,7 @@
 #include <c10/util/irange.h>
 
 #include <cmath>
+#include <cstring>
 #include <fstream>
 
 namespace nvfuser {
@@ -317,6 +321,13 @@ void FusionExecutor::compileFusion(
     compile_params.index_type = arg_index_type;
   }
 
+  if (isOptionEnabled(EnableOption::FastMath)) {
+    compile_params.enable_fast_math = true;
+  }
+  if (isOptionEnabled(EnableOption::WarpSegmentReduction)) {
+    compile_params.enable_warp_segment_reduction = true;
+  }
+
   c10::DeviceGuard dg(options_.device);
 
   NVF_ERROR(
@@ -327,6 +338,10 @@ void FusionExecutor::compileFusion(
   device_smem_limit_ = static_cast<int64_t>(properties->sharedMemPerBlockOptin);
   warp_size_ = properties->warpSize;
 
+  if (isOptionEnabled(EnableOption::BankConflictSwizzle)) {
+    swizzleBankConflicts(fusion, compile_params, launch_constraints);
+  }
+
   lowered_ = std::make_unique<GpuLower>(fusion, compile_params);
   lowered_->run();
 
@@ -364,6 +379,9 @@ void FusionExecutor::compileFusion(
   }
 
   kernel_code_ = codegen::generateCudaKernel(kernel, kernelName());
+  programmatic_dependent_launch_ =
+      kernel->summary().has_grid_dependency_wait;
+  spilled_tensor_arguments_ = kernel->summary().has_spilled_tensor_arguments;
 
   // If NVFUSER_EXTERNAL_SRC is set, utilize the external source code.
   // If the loaded external source code is empty, revert to the default codegen.
@@ -426,6 +444,7 @@ void FusionExecutor::compileFusion(
       (block_size.has_value() ? block_size.value() : 1),
       block_size_high_water_mark_);
   maxrregcount_high_water_mark_ = compile_params.maxrregcount;
+  compiled_kernels_by_maxrregcount_.clear();
   compiled_kernel_ = executor_utils::getCompiledKernel(
       kernel_code_,
       structured_code,
@@ -447,6 +466,11 @@ void FusionExecutor::compileFusion(
   if (isDebugDumpEnabled(DebugDumpOption::Sass)) {
     debug() << disassembledKernelSASS() << std::endl;
   }
+
+  // See [ Releasing Lowering Info ]
+  if (isOptionEnabled(EnableOption::ReleaseLoweringInfo)) {
+    releaseLoweringInfo();
+  }
 }
 
 namespace {
@@ -475,6 +499,8 @@ void fillTensorWithNan(at::Tensor& t) {
     case at::ScalarType::Float:
     case at::ScalarType::Double:
     case at::ScalarType::BFloat16:
+    case at::ScalarType::Float8_e4m3fn:
+    case at::ScalarType::Float8_e5m2:
       t.fill_(std::nan(""));
       break;
     case at::ScalarType::ComplexHalf:
@@ -927,13 +953,76 @@ int64_t IndexOfFusionInput(const Val* in, const Fusion* fusion) {
   return std::distance(fusion->inputs().begin(), i);
 }
 
+// Allocate a new `at::Tensor` for `out_info` that does not alias any other
+// tensor. If `output_buffer` is defined, it is used instead of allocating.
+at::Tensor allocateOutputBuffer(
+    const FusionExecutor::GlobalBufferInfo& out_info,
+    const c10::Device& device,
+    const at::Tensor& output_buffer) {
+  if (output_buffer.defined()) {
+    NVF_ERROR(
+        output_buffer.sizes() == c10::IntArrayRef(out_info.sizes) &&
+            output_buffer.strides() == c10::IntArrayRef(out_info.strides) &&
+            output_buffer.scalar_type() == out_info.type,
+        "Given output buffer of sizes ",
+        output_buffer.sizes(),
+        ", strides ",
+        output_buffer.strides(),
+        " and type ",
+        output_buffer.scalar_type(),
+        " does not match the expected sizes ",
+        c10::IntArrayRef(out_info.sizes),
+        ", strides ",
+        c10::IntArrayRef(out_info.strides),
+        " and type ",
+        out_info.type);
+    // The kernel may vectorize accesses to the output
+    NVF_ERROR(
+        reinterpret_cast<uintptr_t>(output_buffer.data_ptr()) % 16 == 0,
+        "Given output buffer is not aligned to 16 bytes");
+    return output_buffer;
+  }
+  auto alloc_tensor = at::native::empty_strided_cuda(
+      out_info.sizes,
+      out_info.strides,
+      out_info.type,
+      c10::nullopt,
+      device,
+      c10::nullopt);
+  if (shouldFillAllocationWithNan()) {
+    fillTensorWithNan(alloc_tensor);
+  }
+  return alloc_tensor;
+}
+
+// Returns self of the scatter_add that defines tv, if any. Its output is
+// accumulated into a copy of self, see [ Scatter Accumulation ] in
+// runtime/scatter.cu.
+TensorView* getScatterAddSelf(const TensorView* tv) {
+  auto scatter = dynamic_cast<ScatterOp*>(tv->definition());
+  if (scatter == nullptr ||
+      scatter->getScatterOpType() != ScatterOpType::Add) {
+    return nullptr;
+  }
+  return scatter->selfTv();
+}
+
+// Returns whether tv is accumulated into with atomics by a grid reduction, so
+// it must be zero-initialized. See [ Atomic Grid Reduction ] in kernel_ir.h.
+bool isAtomicGridReductionOutput(const TensorView* tv) {
+  auto rop = dynamic_cast<ReductionOp*>(tv->definition());
+  return rop != nullptr && rop->atomicGridReductionRequested() &&
+      tv->domain()->hasGridReduction();
+}
+
 // Allocate an `at::Tensor` for `out_info` or compute it as an alias.
 at::Tensor allocateOutput(
     const FusionExecutor::GlobalBufferInfo& out_info,
     Val* aliased_io,
     const AliasInfo* alias_info,
     const c10::Device& device,
-    ExpressionEvaluator& ee) {
+    ExpressionEvaluator& ee,
+    const at::Tensor& output_buffer) {
   TensorView* out_tv = out_info.tv;
   if (ee.isKnown(out_tv)) {
     return ee.evaluate(out_tv).as<at::Tensor>();
@@ -975,26 +1064,26 @@ at::Tensor allocateOutput(
     }
   }
 
-  auto alloc_tensor = at::native::empty_strided_cuda(
-      out_info.sizes,
-      out_info.strides,
-      out_info.type,
-      c10::nullopt,
-      device,
-      c10::nullopt);
-  if (shouldFillAllocationWithNan()) {
-    fillTensorWithNan(alloc_tensor);
+  at::Tensor out_tensor =
+      allocateOutputBuffer(out_info, device, output_buffer);
+  if (TensorView* self = getScatterAddSelf(out_tv)) {
+    out_tensor.copy_(ee.evaluate(self).as<at::Tensor>());
+  } else if (isAtomicGridReductionOutput(out_tv)) {
+    out_tensor.zero_();
   }
-  return alloc_tensor;
+  return out_tensor;
 }
 
 // Allocate output tensors for a given kernel. Outputs may alias inputs, in
-// that case output tensors are shallow copies of the aliased inputs
+// that case output tensors are shallow copies of the aliased inputs. Defined
+// entries of `output_buffers` are used for non-aliased outputs instead of
+// allocating them.
 std::vector<at::Tensor> allocateOutputs(
     const kir::Kernel* kernel,
     const std::vector<FusionExecutor::GlobalBufferInfo>& output_info,
     const c10::Device& device,
-    ExpressionEvaluator& ee) {
+    ExpressionEvaluator& ee,
+    const std::vector<at::Tensor>& output_buffers = {}) {
   FUSER_PERF_SCOPE("allocateOutputs");
 
   const auto num_outs = output_info.size();
@@ -1032,7 +1121,14 @@ std::vector<at::Tensor> allocateOutputs(
   for (const auto& [out_index, out] : sorted_outs) {
     auto [aliased_io, alias_info] = kernel->getOutputAlias(out);
     at::Tensor out_tensor = allocateOutput(
-        output_info[out_index], aliased_io, alias_info, device, ee);
+        output_info[out_index],
+        aliased_io,
+        alias_info,
+        device,
+        ee,
+        out_index < (int64_t)output_buffers.size()
+            ? output_buffers.at(out_index)
+            : at::Tensor());
     // Bind `out_tensor` so
     // 1. duplicated outputs map to the same tensor,
     // 2. an output that aliases another output can be evaluated via
@@ -1096,6 +1192,27 @@ int64_t FusionExecutor::computeSharedMemory(
   return total;
 }
 
+const std::vector<IterDomain*>& FusionExecutor::getParallelBindingIds() {
+  auto lower = lowered_.get();
+  auto& used_tvs = getUsedTVs();
+  auto parallel_binding_ids_entry =
+      executor_utils::caching::ExecutorCompileTimeEntry<
+          executor_utils::caching::ParallelBindingIterDomains>(
+          compileTimeDataCache(), [&used_tvs, &lower]() {
+            return std::make_unique<std::vector<IterDomain*>>(
+                executor_utils::getParallelBindingsIterDomains(
+                    lower, used_tvs));
+          });
+  return parallel_binding_ids_entry.get();
+}
+
+void FusionExecutor::releaseLoweringInfo() {
+  // The parallel bindings are the only launch information computed from the
+  // ComputeAtMap, so they are cached before it's released
+  getParallelBindingIds();
+  lowered_->releaseAnalyses();
+}
+
 LaunchParams FusionExecutor::computeLaunchParams(
     const LaunchParams& launch_constraints,
     ExpressionEvaluator& expr_eval,
@@ -1109,16 +1226,7 @@ LaunchParams FusionExecutor::computeLaunchParams(
   auto data_cache = compileTimeDataCache();
 
   auto lower = lowered_.get();
-  auto& used_tvs = getUsedTVs();
-  auto parallel_binding_ids_entry =
-      executor_utils::caching::ExecutorCompileTimeEntry<
-          executor_utils::caching::ParallelBindingIterDomains>(
-          data_cache, [&used_tvs, &lower]() {
-            return std::make_unique<std::vector<IterDomain*>>(
-                executor_utils::getParallelBindingsIterDomains(
-                    lower, used_tvs));
-          });
-  auto& parallel_binding_ids = parallel_binding_ids_entry.get();
+  auto& parallel_binding_ids = getParallelBindingIds();
 
   auto parallel_iter_extent_entry =
       executor_utils::caching::ExecutorCompileTimeEntry<
@@ -1206,7 +1314,8 @@ LaunchParams FusionExecutor::computeLaunchParams(
   int64_t reduction_broadcast_workspace = 0;
   const bool has_workspace = kernel_summary.has_block_reductions ||
       kernel_summary.has_grid_reductions ||
-      kernel_summary.has_block_broadcasts || kernel_summary.has_grid_broadcasts;
+      kernel_summary.has_block_broadcasts ||
+      kernel_summary.has_grid_broadcasts || kernel_summary.has_block_scans;
   if (has_workspace &&
       kernel_summary.largest_smem_data_type != DataType::Null) {
     // Not using nThreads here since it does not handle uninitialized value
@@ -1228,6 +1337,12 @@ LaunchParams FusionExecutor::computeLaunchParams(
           reduction_broadcast_workspace,
           (int64_t)kernel_summary.outer_grouped_grid_welford_largest_smem_size);
     }
+    if (kernel_summary.has_outer_grouped_grid_reduction) {
+      reduction_broadcast_workspace = std::max(
+          reduction_broadcast_workspace,
+          (int64_t)
+              kernel_summary.outer_grouped_grid_reduction_largest_smem_size);
+    }
   }
 
   const auto dynamic_smem_size = computeSharedMemory(
@@ -1293,6 +1408,10 @@ std::vector<FusionExecutor::GlobalBufferInfo> FusionExecutor::
         tv == kernel->profile().getBuffer()) {
       info.is_profile_buffer = true;
     }
+    // The only other zero-initialized buffers are the semaphores of grid
+    // communication. See [ Persistent Semaphores ].
+    info.resets_to_zero = info.zero_init && tv->dtype() == DataType::Int &&
+        tv != kernel->profile().getBuffer();
 
     global_buffers.emplace_back(info);
   }
@@ -1429,6 +1548,188 @@ void validateCooperativeLaunch(
       at::cuda::getDeviceProperties(device_index)->multiProcessorCount);
 }
 
+// [ Cluster Grid Sync ]
+//
+// Cooperative kernels synchronize the grid with grid_sync::sync, where every
+// block arrives at a semaphore in global memory and, for persistent kernels,
+// spins on it until all blocks have arrived. On Hopper, with
+// NVFUSER_ENABLE=cluster_grid_sync, cooperative kernels are launched with
+// thread block clusters of up to 8 blocks along X instead. Syncs across
+// BIDx then first synchronize the blocks of each cluster with the hardware
+// cluster barrier, and only one block per cluster arrives at and spins on
+// the semaphore, which cuts the global memory traffic of every sync by the
+// cluster size. Syncs that don't include BIDx are done as before. Grid
+// reductions, Welfords and broadcasts all go through grid_sync::sync.
+//
+// The cluster size must divide gdimx, and all clusters must still be
+// resident at once, which cuOccupancyMaxActiveClusters checks. Otherwise,
+// a smaller cluster size or no clusters at all are used.
+
+// Size of the clusters along X to launch a cooperative kernel with, or 1 to
+// launch it without clusters. See [ Cluster Grid Sync ]
+unsigned int getGridSyncClusterSize(
+    CUfunction kernel,
+    const LaunchParams& launch_params,
+    int64_t device_index) {
+#if (CUDA_VERSION >= 12000)
+  if (!isOptionEnabled(EnableOption::ClusterGridSync) ||
+      at::cuda::getDeviceProperties(device_index)->major < 9) {
+    return 1;
+  }
+  const int64_t grid_size =
+      launch_params.gdimx() * launch_params.gdimy() * launch_params.gdimz();
+  for (unsigned int cluster_size : {8u, 4u, 2u}) {
+    if (launch_params.gdimx() % cluster_size != 0) {
+      continue;
+    }
+    CUlaunchAttribute attribute;
+    attribute.id = CU_LAUNCH_ATTRIBUTE_CLUSTER_DIMENSION;
+    attribute.value.clusterDim.x = cluster_size;
+    attribute.value.clusterDim.y = 1;
+    attribute.value.clusterDim.z = 1;
+
+    CUlaunchConfig config = {};
+    config.gridDimX = launch_params.gdimx();
+    config.gridDimY = launch_params.gdimy();
+    config.gridDimZ = launch_params.gdimz();
+    config.blockDimX = launch_params.bdimx();
+    config.blockDimY = launch_params.bdimy();
+    config.blockDimZ = launch_params.bdimz();
+    config.sharedMemBytes = launch_params.smem();
+    config.attrs = &attribute;
+    config.numAttrs = 1;
+
+    int max_active_clusters = 0;
+    NVFUSER_CUDA_SAFE_CALL(
+        cuOccupancyMaxActiveClusters(&max_active_clusters, kernel, &config));
+    if ((int64_t)max_active_clusters * cluster_size >= grid_size) {
+      return cluster_size;
+    }
+  }
+#endif
+  return 1;
+}
+
+// Launches a cooperative kernel, with thread block clusters if
+// getGridSyncClusterSize finds a cluster size
+void launchCooperativeKernel(
+    CUfunction kernel,
+    const LaunchParams& launch_params,
+    CUstream stream,
+    void** kernel_args,
+    int64_t device_index) {
+  const unsigned int cluster_size =
+      getGridSyncClusterSize(kernel, launch_params, device_index);
+  if (cluster_size == 1) {
+    NVFUSER_CUDA_SAFE_CALL(cuLaunchCooperativeKernel(
+        kernel,
+        launch_params.gdimx(),
+        launch_params.gdimy(),
+        launch_params.gdimz(),
+        launch_params.bdimx(),
+        launch_params.bdimy(),
+        launch_params.bdimz(),
+        launch_params.smem(),
+        stream,
+        kernel_args));
+    return;
+  }
+#if (CUDA_VERSION >= 12000)
+  CUlaunchAttribute attributes[2];
+  attributes[0].id = CU_LAUNCH_ATTRIBUTE_COOPERATIVE;
+  attributes[0].value.cooperative = 1;
+  attributes[1].id = CU_LAUNCH_ATTRIBUTE_CLUSTER_DIMENSION;
+  attributes[1].value.clusterDim.x = cluster_size;
+  attributes[1].value.clusterDim.y = 1;
+  attributes[1].value.clusterDim.z = 1;
+
+  CUlaunchConfig config = {};
+  config.gridDimX = launch_params.gdimx();
+  config.gridDimY = launch_params.gdimy();
+  config.gridDimZ = launch_params.gdimz();
+  config.blockDimX = launch_params.bdimx();
+  config.blockDimY = launch_params.bdimy();
+  config.blockDimZ = launch_params.bdimz();
+  config.sharedMemBytes = launch_params.smem();
+  config.hStream = stream;
+  config.attrs = attributes;
+  config.numAttrs = 2;
+
+  NVFUSER_CUDA_SAFE_CALL(
+      cuLaunchKernelEx(&config, kernel, kernel_args, nullptr));
+#endif
+}
+
+// [ Programmatic Dependent Launch ]
+//
+// Consecutive segments of a fusion are launched on the same stream, and a
+// kernel normally can't start before the preceding one has completed, so the
+// launch latency and the ramp-up of every segment, i.e., its prologue of
+// allocations and index computations, are exposed. On Hopper, with
+// NVFUSER_ENABLE=programmatic_dependent_launch, kernels are generated to
+// call grid_sync::launchDependentGrids at their start, which lets the next
+// kernel of the stream begin launching, and grid_sync::waitForPrerequisiteGrids
+// before their first top-level expression that may access global memory,
+// which waits for the completion of the preceding kernels and the visibility
+// of their writes. Such kernels are launched with
+// CU_LAUNCH_ATTRIBUTE_PROGRAMMATIC_STREAM_SERIALIZATION, so their prologue
+// overlaps the tail of the preceding kernel.
+//
+// The wait is emitted in every kernel compiled with the option, even if it
+// doesn't access global memory, since a kernel only waits for the kernel
+// right before it. Launching a kernel without the attribute is always safe,
+// as the wait then returns immediately, so cooperative kernels and devices
+// before Hopper are launched as usual. A kernel compiled without the option
+// is never launched with the attribute.
+
+// Launches a non-cooperative kernel, with programmatic dependent launch if
+// the kernel waits for the preceding kernels and the device supports it. See
+// [ Programmatic Dependent Launch ]
+void launchKernel(
+    CUfunction kernel,
+    const LaunchParams& launch_params,
+    CUstream stream,
+    void** kernel_args,
+    bool programmatic_dependent_launch,
+    int64_t device_index) {
+#if (CUDA_VERSION >= 12000)
+  if (programmatic_dependent_launch &&
+      at::cuda::getDeviceProperties(device_index)->major >= 9) {
+    CUlaunchAttribute attribute;
+    attribute.id = CU_LAUNCH_ATTRIBUTE_PROGRAMMATIC_STREAM_SERIALIZATION;
+    attribute.value.programmaticStreamSerializationAllowed = 1;
+
+    CUlaunchConfig config = {};
+    config.gridDimX = launch_params.gdimx();
+    config.gridDimY = launch_params.gdimy();
+    config.gridDimZ = launch_params.gdimz();
+    config.blockDimX = launch_params.bdimx();
+    config.blockDimY = launch_params.bdimy();
+    config.blockDimZ = launch_params.bdimz();
+    config.sharedMemBytes = launch_params.smem();
+    config.hStream = stream;
+    config.attrs = &attribute;
+    config.numAttrs = 1;
+
+    NVFUSER_CUDA_SAFE_CALL(
+        cuLaunchKernelEx(&config, kernel, kernel_args, nullptr));
+    return;
+  }
+#endif
+  NVFUSER_CUDA_SAFE_CALL(cuLaunchKernel(
+      kernel,
+      launch_params.gdimx(),
+      launch_params.gdimy(),
+      launch_params.gdimz(),
+      launch_params.bdimx(),
+      launch_params.bdimy(),
+      launch_params.bdimz(),
+      launch_params.smem(),
+      stream,
+      kernel_args,
+      nullptr));
+}
+
 // Dump fusion inputs and outputs as well as some useful fusion
 // information. Note that inputs and outputs are those that are passed
 // to FusionExecutor::runFusion, so outputs may not be given.
@@ -1486,6 +1787,41 @@ void dumpKernelArgs(
   }
 }
 
+// Allocate a temporary work buffer or an intermediate global-memory tensor
+at::Tensor allocateIntermediateBuffer(
+    const FusionExecutor::GlobalBufferInfo& buf_info,
+    const c10::Device& device) {
+  bool has_expansion = false;
+  std::vector<int64_t> unexpanded_sizes;
+  unexpanded_sizes.reserve(buf_info.sizes.size());
+  NVF_ERROR(buf_info.sizes.size() == buf_info.strides.size())
+  for (const auto j : c10::irange(buf_info.sizes.size())) {
+    if (buf_info.strides[j] == 0) {
+      has_expansion = true;
+      unexpanded_sizes.push_back(1L);
+    } else {
+      unexpanded_sizes.push_back(buf_info.sizes[j]);
+    }
+  }
+  at::Tensor intermediate_buffer;
+  if (buf_info.zero_init) {
+    intermediate_buffer = at::zeros(
+        unexpanded_sizes,
+        at::TensorOptions().dtype(buf_info.type).device(device));
+  } else {
+    intermediate_buffer = at::native::empty_cuda(
+        unexpanded_sizes, buf_info.type, c10::nullopt, device, c10::nullopt);
+    if (shouldFillAllocationWithNan()) {
+      fillTensorWithNan(intermediate_buffer);
+    }
+  }
+  if (has_expansion) {
+    intermediate_buffer =
+        at::native::expand(intermediate_buffer, buf_info.sizes);
+  }
+  return intermediate_buffer;
+}
+
 FusionExecutor::GlobalBufferInfo getGlobalBufferAllocationInfo(
     const at::Tensor& at_tensor) {
   FusionExecutor::GlobalBufferInfo info{
@@ -1497,6 +1833,66 @@ FusionExecutor::GlobalBufferInfo getGlobalBufferAllocationInfo(
 
 } // namespace
 
+at::Tensor FusionExecutor::getIntermediateBuffer(
+    ExecutorEntry& executor_entry,
+    size_t index) {
+  const GlobalBufferInfo& buf_info = executor_entry.intermediates.at(index);
+  if (!buf_info.resets_to_zero || record_launch_ ||
+      isOptionDisabled(DisableOption::PersistentSemaphores)) {
+    return allocateIntermediateBuffer(buf_info, options_.device);
+  }
+
+  const cudaStream_t stream =
+      at::cuda::getCurrentCUDAStream(options_.device.index()).stream();
+  {
+    std::shared_lock<std::shared_mutex> guard(executor_entry_mutex_);
+    auto it = executor_entry.semaphores.find(stream);
+    if (it != executor_entry.semaphores.end() &&
+        it->second.at(index).defined()) {
+      return it->second.at(index);
+    }
+  }
+  std::unique_lock<std::shared_mutex> guard(executor_entry_mutex_);
+  auto& semaphores = executor_entry.semaphores[stream];
+  semaphores.resize(executor_entry.intermediates.size());
+  at::Tensor& semaphore = semaphores.at(index);
+  if (!semaphore.defined()) {
+    semaphore = allocateIntermediateBuffer(buf_info, options_.device);
+  }
+  return semaphore;
+}
+
+FusionExecutor::ExecutorEntry& FusionExecutor::getExecutorEntry(
+    size_t cache_id,
+    const KernelArgumentHolder& args,
+    const LaunchParams& launch_constraints,
+    const CompileParams& compile_params,
+    const std::vector<at::Tensor>& outputs) {
+  {
+    std::shared_lock<std::shared_mutex> guard(executor_entry_mutex_);
+    auto it = executor_entry_lookup_.find(cache_id);
+    if (it != executor_entry_lookup_.end() && it->second.init) {
+      return it->second;
+    }
+  }
+  // Initializing the entry binds the inputs to the shared precomputed values,
+  // so it's done exclusively. The references to the other entries stay
+  // valid, as an unordered_map never moves its elements.
+  auto kernel_guard = lockKernelForEntry();
+  std::unique_lock<std::shared_mutex> guard(executor_entry_mutex_);
+  ExecutorEntry& executor_entry = executor_entry_lookup_[cache_id];
+  if (!executor_entry.init) {
+    initializeExecutorEntry(
+        executor_entry,
+        args,
+        launch_constraints,
+        compile_params,
+        outputs,
+        kernel()->indexType());
+  }
+  return executor_entry;
+}
+
 void FusionExecutor::initializeExecutorEntry(
     ExecutorEntry& executor_entry,
     const KernelArgumentHolder& args,
@@ -1506,16 +1902,27 @@ void FusionExecutor::initializeExecutorEntry(
     DataType index_type) {
   FUSER_PERF_SCOPE("FusionExecutor::initializeExecutorEntry");
 
+  // See [ Occupancy-Driven Launch Parameters ]
+  LaunchParams constraints = launch_constraints;
+  std::optional<LaunchChoice> launch_choice;
+  if (isOptionEnabled(EnableOption::OccupancyLaunch)) {
+    launch_choice = LaunchChoice();
+    constraints = chooseLaunchConstraints(
+        args, launch_constraints, index_type, *launch_choice);
+  }
+
   ExpressionEvaluator expr_eval;
   evaluatorPrecomputedValues()->bindInputs(args);
   expr_eval.precomputedValues() = evaluatorPrecomputedValues().get();
 
-  auto launch_params = computeLaunchParams(
-      launch_constraints, expr_eval, warp_size_, index_type);
+  auto launch_params =
+      computeLaunchParams(constraints, expr_eval, warp_size_, index_type);
 
   executor_utils::validateVectorizedTensors(
       kernel(), args, outputs, compileTimeDataCache(), expr_eval);
 
+  executor_utils::validateExtentDivisors(kernel(), expr_eval);
+
   std::vector<GlobalBufferInfo> output_info;
 
   if (outputs.empty()) {
@@ -1535,28 +1942,74 @@ void FusionExecutor::initializeExecutorEntry(
   executor_entry.launch_params = launch_params;
   executor_entry.outputs = output_info;
   executor_entry.intermediates = intermediates;
+  executor_entry.launch_choice = launch_choice;
   executor_entry.init = true;
+  max_entry_dynamic_smem_size_ =
+      std::max(max_entry_dynamic_smem_size_.load(), launch_params.smem());
+}
+
+bool FusionExecutor::needsRecompile(
+    const LaunchParams& new_launch_params,
+    const CompileParams& new_compile_params) const {
+  return new_launch_params.nThreads() > block_size_high_water_mark_ ||
+      new_compile_params.maxrregcount != maxrregcount_high_water_mark_;
+}
+
+std::shared_lock<std::shared_mutex> FusionExecutor::lockKernelForLaunch(
+    const LaunchParams& launch_params,
+    const CompileParams& compile_params) {
+  while (true) {
+    std::shared_lock<std::shared_mutex> guard(kernel_mutex_);
+    if (!needsRecompile(launch_params, compile_params)) {
+      return guard;
+    }
+    guard.unlock();
+    // Another thread may recompile the kernel for other parameters before
+    // this one locks it again, so check again
+    std::unique_lock<std::shared_mutex> recompile_guard(kernel_mutex_);
+    recompileKernel(launch_params, compile_params);
+  }
 }
 
 void FusionExecutor::recompileKernel(
     const LaunchParams& new_launch_params,
     const CompileParams& new_compile_params) {
-  if (new_launch_params.nThreads() <= block_size_high_water_mark_ &&
-      new_compile_params.maxrregcount == maxrregcount_high_water_mark_) {
+  if (!needsRecompile(new_launch_params, new_compile_params)) {
     return;
   }
 
-  const auto structured_code = getStructuredCode();
-  block_size_high_water_mark_ = new_launch_params.nThreads();
-  maxrregcount_high_water_mark_ = new_compile_params.maxrregcount;
+  // Lowering doesn't depend on the launch constraints, so only the kernel
+  // binary changes. Keep the current one in case its register cap is needed
+  // again, and reuse a kernel previously compiled for the new register cap
+  // if it supports the new block size.
+  const int64_t new_maxrregcount = new_compile_params.maxrregcount;
+  if (new_maxrregcount != maxrregcount_high_water_mark_) {
+    compiled_kernels_by_maxrregcount_[maxrregcount_high_water_mark_] = {
+        block_size_high_water_mark_, std::move(compiled_kernel_)};
+  }
+  auto it = compiled_kernels_by_maxrregcount_.find(new_maxrregcount);
+  if (it != compiled_kernels_by_maxrregcount_.end() &&
+      new_launch_params.nThreads() <= it->second.first) {
+    block_size_high_water_mark_ = it->second.first;
+    maxrregcount_high_water_mark_ = new_maxrregcount;
+    compiled_kernel_ = std::move(it->second.second);
+    compiled_kernels_by_maxrregcount_.erase(it);
+  } else {
+    if (it != compiled_kernels_by_maxrregcount_.end()) {
+      compiled_kernels_by_maxrregcount_.erase(it);
+    }
+    const auto structured_code = getStructuredCode();
+    block_size_high_water_mark_ = new_launch_params.nThreads();
+    maxrregcount_high_water_mark_ = new_maxrregcount;
 
-  compiled_kernel_ = executor_utils::getCompiledKernel(
-      kernel_code_,
-      structured_code,
-      kernelName(),
-      kernel_id_,
-      new_compile_params,
-      block_size_high_water_mark_);
+    compiled_kernel_ = executor_utils::getCompiledKernel(
+        kernel_code_,
+        structured_code,
+        kernelName(),
+        kernel_id_,
+        new_compile_params,
+        block_size_high_water_mark_);
+  }
 
   resetCompiledKernelProperties();
 
@@ -1567,22 +2020,22 @@ void FusionExecutor::recompileKernel(
     // false positives
     ensureAvailableDynamicSmemSize(new_launch_params.smem());
     validateCooperativeLaunch(
-        compiled_kernel_->function, new_launch_params, options_.device.index());
+        compiledFunction(), new_launch_params, options_.device.index());
   }
 }
 
 int64_t FusionExecutor::getAvailableDynamicSmemSize() {
   NVF_ERROR(
       isCompiled(), "Cannot get dynamic smem size unless kernel is compiled");
-  if (!available_dynamic_smem_size_.has_value()) {
+  if (compiled_kernel_->max_dynamic_smem_size < 0) {
     int size = 0;
     NVFUSER_CUDA_SAFE_CALL(cuFuncGetAttribute(
         &size,
         CU_FUNC_ATTRIBUTE_MAX_DYNAMIC_SHARED_SIZE_BYTES,
-        compiled_kernel_->function));
-    available_dynamic_smem_size_ = size;
+        compiledFunction()));
+    compiled_kernel_->max_dynamic_smem_size = size;
   }
-  return available_dynamic_smem_size_.value();
+  return compiled_kernel_->max_dynamic_smem_size;
 }
 
 int64_t FusionExecutor::getStaticSmemSize() {
@@ -1592,9 +2045,7 @@ int64_t FusionExecutor::getStaticSmemSize() {
     int size = 0;
     // Is this really a costly operation worth caching?
     NVFUSER_CUDA_SAFE_CALL(cuFuncGetAttribute(
-        &size,
-        CU_FUNC_ATTRIBUTE_SHARED_SIZE_BYTES,
-        compiled_kernel_->function));
+        &size, CU_FUNC_ATTRIBUTE_SHARED_SIZE_BYTES, compiledFunction()));
     static_smem_size_ = size;
   }
   return static_smem_size_.value();
@@ -1618,20 +2069,372 @@ int64_t FusionExecutor::ensureAvailableDynamicSmemSize(
     int64_t dynamic_smem_size) {
   NVF_ERROR(
       isCompiled(), "Cannot set dynamic smem size unless kernel is compiled");
-  if (dynamic_smem_size > getAvailableDynamicSmemSize()) {
-    validateDynamicSmemSize(dynamic_smem_size);
+  // Configure the largest size any entry needs at once, unless that doesn't
+  // fit, so the launches of the other entries don't call into the driver.
+  // The configured size is kept with the compiled kernel, so executors
+  // sharing it never lower it below each other's, see
+  // [ Kernel Deduplication ]
+  int64_t size =
+      std::max(dynamic_smem_size, max_entry_dynamic_smem_size_.load());
+  if (size > dynamic_smem_size &&
+      getStaticSmemSize() + size >= device_smem_limit_) {
+    size = dynamic_smem_size;
+  }
+  if (size > getAvailableDynamicSmemSize()) {
+    validateDynamicSmemSize(size);
     NVFUSER_CUDA_SAFE_CALL(cuFuncSetAttribute(
-        compiled_kernel_->function,
+        compiledFunction(),
         CU_FUNC_ATTRIBUTE_MAX_DYNAMIC_SHARED_SIZE_BYTES,
-        dynamic_smem_size));
-    available_dynamic_smem_size_ = dynamic_smem_size;
+        size));
+    compiled_kernel_->max_dynamic_smem_size = size;
   }
   return getAvailableDynamicSmemSize();
 }
 
 void FusionExecutor::resetCompiledKernelProperties() {
-  available_dynamic_smem_size_.reset();
   static_smem_size_.reset();
+  kernel_resources_ = KernelResources();
+}
+
+void FusionExecutor::updateKernelResources(const LaunchParams& launch_params) {
+  KernelResources& resources = kernel_resources_;
+  if (resources.registers < 0) {
+    int value = 0;
+    NVFUSER_CUDA_SAFE_CALL(cuFuncGetAttribute(
+        &value, CU_FUNC_ATTRIBUTE_NUM_REGS, compiledFunction()));
+    resources.registers = value;
+    NVFUSER_CUDA_SAFE_CALL(cuFuncGetAttribute(
+        &value, CU_FUNC_ATTRIBUTE_LOCAL_SIZE_BYTES, compiledFunction()));
+    resources.local_bytes = value;
+    resources.static_smem_bytes = getStaticSmemSize();
+    resources.spill_store_bytes = compiled_kernel_->spill_store_bytes;
+    resources.spill_load_bytes = compiled_kernel_->spill_load_bytes;
+  }
+
+  const LaunchParams& last = resources.launch_params;
+  const bool same_block = resources.blocks_per_sm >= 0 &&
+      last.nThreads() == launch_params.nThreads() &&
+      last.smem() == launch_params.smem();
+  if (same_block && last.nBlocks() == launch_params.nBlocks()) {
+    return;
+  }
+
+  const auto prop = at::cuda::getDeviceProperties(options_.device.index());
+  if (!same_block) {
+    int blocks_per_sm = -1;
+    NVFUSER_CUDA_SAFE_CALL(cuOccupancyMaxActiveBlocksPerMultiprocessor(
+        &blocks_per_sm,
+        compiledFunction(),
+        (int)launch_params.nThreads(),
+        launch_params.smem()));
+    resources.blocks_per_sm = blocks_per_sm;
+    const int64_t warps_per_sm =
+        ceilDiv(blocks_per_sm * launch_params.nThreads(), prop->warpSize);
+    const int64_t hw_max_warps =
+        prop->maxThreadsPerMultiProcessor / prop->warpSize;
+    resources.theoretical_occupancy_pct =
+        (double)warps_per_sm / (double)hw_max_warps * 100.0;
+    // Measured for another block size
+    resources.achieved_occupancy_pct.reset();
+  }
+  resources.dynamic_smem_bytes = launch_params.smem();
+  resources.waves = resources.blocks_per_sm > 0
+      ? (double)launch_params.nBlocks() /
+          (double)(resources.blocks_per_sm * prop->multiProcessorCount)
+      : 0.0;
+  resources.launch_params = launch_params;
+}
+
+std::string FusionExecutor::KernelResources::toString() const {
+  std::stringstream ss;
+  ss << "registers= " << registers << ", local_bytes= " << local_bytes
+     << ", spill_store_bytes= " << spill_store_bytes
+     << ", spill_load_bytes= " << spill_load_bytes
+     << ", static_smem= " << static_smem_bytes
+     << ", dynamic_smem= " << dynamic_smem_bytes
+     << ", blocks_per_sm= " << blocks_per_sm << std::fixed
+     << std::setprecision(2)
+     << ", theoretical_occupancy= " << theoretical_occupancy_pct << "%";
+  if (achieved_occupancy_pct.has_value()) {
+    ss << ", achieved_occupancy= " << achieved_occupancy_pct.value() << "%";
+  }
+  ss << ", waves= " << waves << ", grid= (" << launch_params.gdimx() << ", "
+     << launch_params.gdimy() << ", " << launch_params.gdimz() << ")"
+     << ", block= (" << launch_params.bdimx() << ", "
+     << launch_params.bdimy() << ", " << launch_params.bdimz() << ")";
+  return ss.str();
+}
+
+std::string FusionExecutor::LaunchChoice::toString() const {
+  std::stringstream ss;
+  ss << "requested grid= (" << requested.gdimx() << ", " << requested.gdimy()
+     << ", " << requested.gdimz() << "), block= (" << requested.bdimx() << ", "
+     << requested.bdimy() << ", " << requested.bdimz()
+     << "), resident_warps= " << requested_resident_warps
+     << ", chosen grid= (" << chosen.gdimx() << ", " << chosen.gdimy() << ", "
+     << chosen.gdimz() << "), block= (" << chosen.bdimx() << ", "
+     << chosen.bdimy() << ", " << chosen.bdimz()
+     << "), resident_warps= " << chosen_resident_warps
+     << ", smem_carveout= " << smem_carveout_pct;
+  return ss.str();
+}
+
+int64_t FusionExecutor::blocksPerSm(const LaunchParams& launch_params) {
+  int blocks_per_sm = 0;
+  NVFUSER_CUDA_SAFE_CALL(cuOccupancyMaxActiveBlocksPerMultiprocessor(
+      &blocks_per_sm,
+      compiledFunction(),
+      (int)launch_params.nThreads(),
+      launch_params.smem()));
+  return blocks_per_sm;
+}
+
+LaunchParams FusionExecutor::chooseLaunchConstraints(
+    const KernelArgumentHolder& args,
+    const LaunchParams& launch_constraints,
+    DataType index_type,
+    LaunchChoice& choice) {
+  FUSER_PERF_SCOPE("FusionExecutor::chooseLaunchConstraints");
+  // The shared precomputed values are bound for the chosen constraints
+  // afterwards, so each candidate is evaluated without them
+  auto launch_params_for = [&](const LaunchParams& constraints) {
+    auto expr_eval = executor_utils::bindInputs(args, kernel());
+    return computeLaunchParams(constraints, expr_eval, warp_size_, index_type);
+  };
+  const auto prop = at::cuda::getDeviceProperties(options_.device.index());
+  auto resident_warps = [&](const LaunchParams& launch_params) {
+    const int64_t resident_blocks = std::min(
+        launch_params.nBlocks(),
+        blocksPerSm(launch_params) * prop->multiProcessorCount);
+    return resident_blocks * ceilDiv(launch_params.nThreads(), prop->warpSize);
+  };
+
+  choice.requested = launch_params_for(launch_constraints);
+  choice.requested_resident_warps = resident_warps(choice.requested);
+  choice.chosen = choice.requested;
+  choice.chosen_resident_warps = choice.requested_resident_warps;
+  if (getStaticSmemSize() == 0 && choice.requested.smem() == 0) {
+    // CU_SHAREDMEM_CARVEOUT_MAX_L1
+    choice.smem_carveout_pct = 0;
+  }
+
+  // A kernel compiled for a smaller block is recompiled for the requested
+  // one, which may change its registers
+  if (kernel()->summary().has_cooperative_grid_reduction ||
+      choice.requested.nThreads() > block_size_high_water_mark_) {
+    return launch_constraints;
+  }
+
+  // A dimension is free if all the domains parallelized with it are split
+  // by blockDim or gridDim, so its only value is the launch constraint
+  const ParallelDimensionMap& pdim_map = lowered_->parallelDimensionMap();
+  auto is_free = [&](ParallelType pt) {
+    auto dim = dynamic_cast<NamedScalar*>(pdim_map.getRaw(pt));
+    return launch_constraints.hasDim(pt) && pdim_map.isExact(pt) &&
+        dim != nullptr && dim->getParallelDim() == pt;
+  };
+
+  // LaunchParams::bind doesn't change a bound dimension
+  auto with_dim = [](const LaunchParams& params, ParallelType pt, int64_t dim) {
+    auto raw_val = [&](ParallelType raw_pt) {
+      return raw_pt == pt ? dim : params.getRawVal(raw_pt);
+    };
+    LaunchParams result(
+        raw_val(ParallelType::BIDx),
+        raw_val(ParallelType::BIDy),
+        raw_val(ParallelType::BIDz),
+        raw_val(ParallelType::TIDx),
+        raw_val(ParallelType::TIDy),
+        raw_val(ParallelType::TIDz));
+    result.setSmem(params.smem());
+    return result;
+  };
+
+  LaunchParams constraints = launch_constraints;
+  for (auto pt : {ParallelType::TIDy, ParallelType::TIDz}) {
+    if (!is_free(pt)) {
+      continue;
+    }
+    LaunchParams best_constraints = constraints;
+    for (int64_t dim = constraints.getDim(pt) / 2; dim >= 1; dim /= 2) {
+      const LaunchParams candidate_constraints = with_dim(constraints, pt, dim);
+      const LaunchParams candidate = launch_params_for(candidate_constraints);
+      // Smaller blocks need more of them along the grid dimensions bound to
+      // what the free dimension splits
+      if (candidate.gdimy() > 65535 || candidate.gdimz() > 65535) {
+        break;
+      }
+      const int64_t warps = resident_warps(candidate);
+      if (warps > choice.chosen_resident_warps) {
+        best_constraints = candidate_constraints;
+        choice.chosen = candidate;
+        choice.chosen_resident_warps = warps;
+      }
+    }
+    constraints = best_constraints;
+  }
+
+  for (auto pt : kParallelTypeBIDs) {
+    if (!is_free(pt)) {
+      continue;
+    }
+    const int64_t other_blocks =
+        choice.chosen.nBlocks() / choice.chosen.getDim(pt);
+    const int64_t dim = std::max(
+        blocksPerSm(choice.chosen) * prop->multiProcessorCount / other_blocks,
+        (int64_t)1);
+    if (dim == choice.chosen.getDim(pt)) {
+      continue;
+    }
+    constraints = with_dim(constraints, pt, dim);
+    choice.chosen = launch_params_for(constraints);
+    choice.chosen_resident_warps = resident_warps(choice.chosen);
+  }
+
+  if (isDebugDumpEnabled(DebugDumpOption::Occupancy)) {
+    debug() << "Launch choice of " << kernelName() << ": "
+            << choice.toString() << std::endl;
+  }
+  return constraints;
+}
+
+std::shared_lock<std::shared_mutex> FusionExecutor::lockKernelForEntry() {
+  if (!isOptionEnabled(EnableOption::OccupancyLaunch)) {
+    return std::shared_lock<std::shared_mutex>();
+  }
+  return std::shared_lock<std::shared_mutex>(kernel_mutex_);
+}
+
+void FusionExecutor::ensureSmemCarveout(int64_t carveout_pct) {
+  if (carveout_pct < 0 || compiled_kernel_->smem_carveout_pct == carveout_pct) {
+    return;
+  }
+  NVFUSER_CUDA_SAFE_CALL(cuFuncSetAttribute(
+      compiledFunction(),
+      CU_FUNC_ATTRIBUTE_PREFERRED_SHARED_MEMORY_CARVEOUT,
+      (int)carveout_pct));
+  compiled_kernel_->smem_carveout_pct = carveout_pct;
+}
+
+// [ Spilled Kernel Arguments ]
+//
+// Every tensor is passed to a kernel as a Tensor struct of its data pointer,
+// logical sizes and allocation strides, so fusions of hundreds of tensors,
+// e.g., multi-tensor optimizers and concatenations, exceed the 4KB limit of
+// kernel parameters, and the parameters of every launch are copied by the
+// driver. If the parameters of a kernel exceed the limit, or the bytes given
+// with NVFUSER_ENABLE=spill_kernel_arguments(<bytes>), 1024 by default, the
+// tensor arguments are instead declared as members of a struct, and the
+// kernel takes a pointer to the struct as its first parameter, followed by
+// the remaining scalar parameters. The prologue of the kernel copies the
+// members to local variables of the names of the parameters, so the rest of
+// the kernel is unchanged.
+//
+// For each launch, the tensor arguments are packed at 8-byte aligned
+// offsets, as the members of the struct are, into a pinned host buffer,
+// which is copied asynchronously to a device buffer of the caching
+// allocator on the stream of the launch. Both buffers are released right
+// after the launch, as the caching allocators don't reuse them before the
+// copy and the kernel are done. With a launch plan, the patched argument
+// buffer is already laid out like the struct. The sizes and strides are of
+// the index type, i.e., 32-bit integers when the kernel uses 32-bit
+// indexing.
+
+at::Tensor FusionExecutor::uploadSpilledArguments(
+    const std::vector<std::byte>& buffer) const {
+  FUSER_PERF_SCOPE("FusionExecutor::uploadSpilledArguments");
+  const auto size = (int64_t)buffer.size();
+  at::Tensor host_buffer = at::empty(
+      {size}, at::TensorOptions().dtype(at::kByte).pinned_memory(true));
+  std::memcpy(host_buffer.data_ptr(), buffer.data(), buffer.size());
+  at::Tensor device_buffer = at::empty(
+      {size}, at::TensorOptions().dtype(at::kByte).device(options_.device));
+  device_buffer.copy_(host_buffer, /*non_blocking=*/true);
+  return device_buffer;
+}
+
+std::optional<FusionExecutor::LaunchPlan> FusionExecutor::buildLaunchPlan(
+    const std::vector<std::vector<std::byte>>& arg_buffers) const {
+  FUSER_PERF_SCOPE("FusionExecutor::buildLaunchPlan");
+  const auto& parameters = kernel()->parameters();
+  NVF_ERROR(parameters.size() == arg_buffers.size());
+
+  const auto& kernel_inputs = kernel()->inputs();
+  const auto& kernel_outputs = kernel()->outputs();
+  const auto& global_allocations = kernel()->summary().global_allocations;
+
+  // Outputs are allocated with the sizes and strides saved in the
+  // ExecutorEntry, so they must neither be forwarded inputs, duplicated,
+  // aliases of other tensors nor initialized from inputs or zeros
+  for (const auto i : c10::irange(kernel_outputs.size())) {
+    Val* out = kernel_outputs.at(i);
+    if (kernel()->getOutputAlias(out).first != nullptr ||
+        getScatterAddSelf(out->as<TensorView>()) != nullptr ||
+        isAtomicGridReductionOutput(out->as<TensorView>()) ||
+        std::find(kernel_inputs.begin(), kernel_inputs.end(), out) !=
+            kernel_inputs.end() ||
+        std::find(kernel_outputs.begin(), kernel_outputs.begin() + i, out) !=
+            kernel_outputs.begin() + i) {
+      return std::nullopt;
+    }
+  }
+
+  // Keep each argument aligned as it would be in its own buffer. Spilled
+  // tensor arguments are laid out like the members of their struct instead,
+  // so the buffer is uploaded as is. See [ Spilled Kernel Arguments ]
+  const int64_t arg_alignment = spilled_tensor_arguments_ ? 8 : 16;
+
+  LaunchPlan plan;
+  plan.arg_offsets.reserve(parameters.size());
+  int64_t total_size = 0;
+  for (const auto i : c10::irange(parameters.size())) {
+    // Only the metadata of global-memory tensors is known to stay the same
+    // for a given input cache id. Scalars, CPU scalar tensors and values
+    // evaluated on the host for each launch, like RNG states and TMA
+    // descriptors, are not supported.
+    auto tv = dynamic_cast<TensorView*>(parameters.at(i));
+    if (tv == nullptr || tv->isCpuScalar()) {
+      return std::nullopt;
+    }
+
+    LaunchPlan::PointerPatch patch;
+    auto in_it = std::find(kernel_inputs.begin(), kernel_inputs.end(), tv);
+    auto out_it = std::find(kernel_outputs.begin(), kernel_outputs.end(), tv);
+    auto alloc_it = std::find_if(
+        global_allocations.begin(),
+        global_allocations.end(),
+        [tv](const kir::Allocate* alloc) { return alloc->buffer() == tv; });
+    if (in_it != kernel_inputs.end()) {
+      patch.source = LaunchPlan::PointerSource::Input;
+      patch.index = std::distance(kernel_inputs.begin(), in_it);
+    } else if (out_it != kernel_outputs.end()) {
+      patch.source = LaunchPlan::PointerSource::Output;
+      patch.index = std::distance(kernel_outputs.begin(), out_it);
+    } else if (alloc_it != global_allocations.end()) {
+      patch.source = LaunchPlan::PointerSource::Intermediate;
+      patch.index = std::distance(global_allocations.begin(), alloc_it);
+    } else {
+      return std::nullopt;
+    }
+
+    // The data pointer comes first in the tensor metadata
+    NVF_ERROR(arg_buffers.at(i).size() >= sizeof(void*));
+    total_size = roundUpToMultiple(total_size, arg_alignment);
+    patch.offset = (size_t)total_size;
+    plan.arg_offsets.push_back((size_t)total_size);
+    plan.patches.push_back(patch);
+    total_size += (int64_t)arg_buffers.at(i).size();
+  }
+
+  plan.arg_buffer.resize((size_t)total_size);
+  for (const auto i : c10::irange(arg_buffers.size())) {
+    std::copy(
+        arg_buffers.at(i).begin(),
+        arg_buffers.at(i).end(),
+        plan.arg_buffer.begin() + (int64_t)plan.arg_offsets.at(i));
+  }
+
+  return plan;
 }
 
 std::vector<at::Tensor> FusionExecutor::runFusion(
@@ -1642,9 +2445,13 @@ std::vector<at::Tensor> FusionExecutor::runFusion(
   FUSER_PERF_SCOPE("FusionExecutor::runFusion");
   NVF_ERROR(isCompiled());
   NVF_ERROR(validKernelId(), "Invalid kernel id for FusionExecutor.");
-  NVF_ERROR(
-      !args.getCacheId().has_value() || outputs.empty(),
-      "short cut input cache is not compatible with pre-allocated output");
+  // See [ Annotated NVTX Ranges ]
+  inst::AnnotatedRange nvtx_range(group_id_, [this]() {
+    std::stringstream ss;
+    ss << kernelName() << " (" << heuristic_ << ", group " << group_id_
+       << ")";
+    return ss.str();
+  });
 
   validateIndexType(kernel(), compile_params);
 
@@ -1660,40 +2467,71 @@ std::vector<at::Tensor> FusionExecutor::runFusion(
   at::cuda::jit::initializeCudaContext();
   NVF_ERROR(lowered_);
 
+  // Only applies to this call. See setOutputBuffers.
+  std::vector<at::Tensor> output_buffers = std::move(output_buffers_);
+  output_buffers_.clear();
+
+  // With an input cache id, pre-allocated outputs are checked against the
+  // cached output info like the buffers of setOutputBuffers, so the cached
+  // entry and its launch plan stay valid
+  if (args.getCacheId().has_value() && !outputs.empty()) {
+    NVF_ERROR(
+        output_buffers.empty(),
+        "Output buffers and pre-allocated outputs can't be given together");
+    NVF_ERROR(
+        outputs.size() == fusion_->outputs().size(),
+        __func__,
+        " provided number of outputs does not match fusion output");
+    output_buffers = std::move(outputs);
+    outputs.clear();
+  }
+
   // Placeholder for the case where parameter cache is not used
   ExecutorEntry temporary_executor_entry;
 
-  ExecutorEntry* executor_entry =
-      args.getCacheId().has_value() && !disable_parameter_cache_
-      ? &executor_entry_lookup_[*args.getCacheId()]
-      : &temporary_executor_entry;
-
-  // Initialize the executor entry if not initlized
-  if (!executor_entry->init) {
-    initializeExecutorEntry(
-        *executor_entry,
-        args,
-        launch_constraints,
-        compile_params,
-        outputs,
-        kernel()->indexType());
+  ExecutorEntry* executor_entry = nullptr;
+  {
+    SegmentHostPhaseGuard phase_guard(SegmentHostPhase::ExecutorEntryLookup);
+    if (args.getCacheId().has_value() && !disable_parameter_cache_) {
+      executor_entry = &getExecutorEntry(
+          *args.getCacheId(),
+          args,
+          launch_constraints,
+          compile_params,
+          outputs);
+    } else {
+      // The precomputed values are shared by all entries
+      auto kernel_guard = lockKernelForEntry();
+      std::unique_lock<std::shared_mutex> guard(executor_entry_mutex_);
+      executor_entry = &temporary_executor_entry;
+      initializeExecutorEntry(
+          *executor_entry,
+          args,
+          launch_constraints,
+          compile_params,
+          outputs,
+          kernel()->indexType());
+    }
   }
+  const LaunchParams& launch_params = executor_entry->launch_params;
 
-  recompileKernel(executor_entry->launch_params, compile_params);
+  // The kernel isn't recompiled by other threads until this launch is done,
+  // see [ Concurrent Launches ]
+  std::shared_lock<std::shared_mutex> kernel_guard;
+  {
+    SegmentHostPhaseGuard phase_guard(SegmentHostPhase::ExecutorEntryLookup);
+    kernel_guard = lockKernelForLaunch(launch_params, compile_params);
+  }
 
-  // TODO: Why does this need to be stored in the class?
-  launch_params_ = executor_entry->launch_params;
+  {
+    std::lock_guard<std::mutex> guard(launch_state_mutex_);
+    launch_params_ = launch_params;
+    last_launch_choice_ = executor_entry->launch_choice;
+  }
 
   // context manager to disable auto grad for `empty_cuda` calls later
   at::AutoDispatchBelowADInplaceOrView non_variable_type_mode;
 
-  ExpressionEvaluator expr_eval;
-  const auto& inputs = kernel()->inputs();
-
-  for (const auto i : c10::irange(inputs.size())) {
-    expr_eval.bind(inputs[i], *args[i]);
-  }
-
   const bool measure_kernel_time = measure_kernel_time_ ||
       isDebugDumpEnabled(DebugDumpOption::EffectiveBandwidth) ||
       isDebugDumpEnabled(DebugDumpOption::PerfDebugVerbose);
@@ -1706,92 +2544,148 @@ std::vector<at::Tensor> FusionExecutor::runFusion(
     inputBytesProcessed(args);
   }
 
-  // only allocate outputs when not given
-  if (outputs.empty()) {
-    outputs = allocateOutputs(
-        kernel(), executor_entry->outputs, options_.device, expr_eval);
-  } else {
-    // TODO: Use validateKernelOutputs
-    NVF_ERROR(
-        outputs.size() == fusion_->outputs().size(),
-        __func__,
-        " provided number of outputs does not match fusion output");
-  }
-  args.push(outputs);
-
-  for (const auto i : c10::irange(outputs.size())) {
-    auto output = kernel()->outputs()[i];
-    if (std::any_of(
-            kernel()->inputs().begin(),
-            kernel()->inputs().end(),
-            [&](const auto& in) { return in == output; })) {
-      // Skip trivially forwarded outputs because they are just placeholders
-      continue;
+  // The launch plan is only used when nothing else needs the individual
+  // argument buffers or the ExpressionEvaluator
+  const LaunchPlan* launch_plan = nullptr;
+  bool launch_plan_checked = false;
+  {
+    std::shared_lock<std::shared_mutex> guard(executor_entry_mutex_);
+    launch_plan_checked = executor_entry->launch_plan_checked;
+    if (executor_entry->launch_plan.has_value() && !record_launch_ &&
+        !isDebugDumpEnabled(DebugDumpOption::KernelArgs) &&
+        !isOptionEnabled(EnableOption::KernelProfile)) {
+      launch_plan = &executor_entry->launch_plan.value();
     }
-    expr_eval.bind(output, *args[inputs.size() + i]);
   }
 
   std::vector<at::Tensor> intermediates;
   at::Tensor profile_buffer;
-  {
-    FUSER_PERF_SCOPE("ExecutorRunFusion::IntermediateBufferAlloc");
-    for (const auto i : c10::irange(executor_entry->intermediates.size())) {
-      const auto& buf_info = executor_entry->intermediates.at(i);
-      bool has_expansion = false;
-      std::vector<int64_t> unexpanded_sizes;
-      unexpanded_sizes.reserve(buf_info.sizes.size());
-      NVF_ERROR(buf_info.sizes.size() == buf_info.strides.size())
-      for (const auto j : c10::irange(buf_info.sizes.size())) {
-        if (buf_info.strides[j] == 0) {
-          has_expansion = true;
-          unexpanded_sizes.push_back(1L);
-        } else {
-          unexpanded_sizes.push_back(buf_info.sizes[j]);
-        }
-      }
-      at::Tensor intermediate_buffer;
-      if (buf_info.zero_init) {
-        intermediate_buffer = at::zeros(
-            unexpanded_sizes,
-            at::TensorOptions().dtype(buf_info.type).device(options_.device));
-      } else {
-        intermediate_buffer = at::native::empty_cuda(
-            unexpanded_sizes,
-            buf_info.type,
-            c10::nullopt,
+  std::vector<std::vector<std::byte>> arg_buffers;
+  // Copy of the argument buffer of launch_plan patched for this launch
+  std::vector<std::byte> plan_arg_buffer;
+
+  if (launch_plan != nullptr) {
+    FUSER_PERF_SCOPE("ExecutorRunFusion::PatchLaunchPlan");
+    // A launch plan is only built for entries with an input cache id, which
+    // can't be used with pre-allocated outputs
+    NVF_ERROR(outputs.empty());
+    {
+      SegmentHostPhaseGuard phase_guard(SegmentHostPhase::Allocation);
+      outputs.reserve(executor_entry->outputs.size());
+      for (const auto i : c10::irange(executor_entry->outputs.size())) {
+        outputs.push_back(allocateOutputBuffer(
+            executor_entry->outputs.at(i),
             options_.device,
-            c10::nullopt);
-        if (shouldFillAllocationWithNan()) {
-          fillTensorWithNan(intermediate_buffer);
-        }
+            i < output_buffers.size() ? output_buffers.at(i) : at::Tensor()));
       }
-      if (has_expansion) {
-        intermediate_buffer =
-            at::native::expand(intermediate_buffer, buf_info.sizes);
+      args.push(outputs);
+
+      intermediates.reserve(executor_entry->intermediates.size());
+      for (const auto i : c10::irange(executor_entry->intermediates.size())) {
+        intermediates.push_back(getIntermediateBuffer(*executor_entry, i));
+        args.push(intermediates.back());
       }
-      args.push(intermediate_buffer);
-      intermediates.push_back(intermediate_buffer);
-      expr_eval.bind(
-          kernel()->summary().global_allocations.at(i)->buffer(),
-          *args[inputs.size() + outputs.size() + i]);
-      if (buf_info.is_profile_buffer) {
-        profile_buffer = intermediate_buffer;
+    }
+
+    SegmentHostPhaseGuard phase_guard(SegmentHostPhase::ArgumentBinding);
+    plan_arg_buffer = launch_plan->arg_buffer;
+    for (const auto& patch : launch_plan->patches) {
+      void* ptr = nullptr;
+      switch (patch.source) {
+        case LaunchPlan::PointerSource::Input:
+          ptr = args[patch.index]->as<at::Tensor>().data_ptr();
+          break;
+        case LaunchPlan::PointerSource::Output:
+          ptr = outputs[patch.index].data_ptr();
+          break;
+        case LaunchPlan::PointerSource::Intermediate:
+          ptr = intermediates[patch.index].data_ptr();
+          break;
       }
+      std::memcpy(plan_arg_buffer.data() + patch.offset, &ptr, sizeof(void*));
     }
-  }
+  } else {
+    ExpressionEvaluator expr_eval;
+    const auto& inputs = kernel()->inputs();
 
-  std::vector<std::vector<std::byte>> arg_buffers;
-  {
-    FUSER_PERF_SCOPE("ExecutorRunFusion::GetArgsBuffers");
-    arg_buffers.reserve(kernel()->parameters().size());
-    for (auto v : kernel()->parameters()) {
-      arg_buffers.emplace_back(
-          getKernelArgument(expr_eval, v, kernel()->indexType()));
+    {
+      SegmentHostPhaseGuard phase_guard(SegmentHostPhase::ArgumentBinding);
+      for (const auto i : c10::irange(inputs.size())) {
+        expr_eval.bind(inputs[i], *args[i]);
+      }
+    }
+
+    // only allocate outputs when not given
+    if (outputs.empty()) {
+      SegmentHostPhaseGuard phase_guard(SegmentHostPhase::Allocation);
+      outputs = allocateOutputs(
+          kernel(),
+          executor_entry->outputs,
+          options_.device,
+          expr_eval,
+          output_buffers);
+    } else {
+      // TODO: Use validateKernelOutputs
+      NVF_ERROR(
+          outputs.size() == fusion_->outputs().size(),
+          __func__,
+          " provided number of outputs does not match fusion output");
+    }
+    args.push(outputs);
+
+    for (const auto i : c10::irange(outputs.size())) {
+      auto output = kernel()->outputs()[i];
+      if (std::any_of(
+              kernel()->inputs().begin(),
+              kernel()->inputs().end(),
+              [&](const auto& in) { return in == output; })) {
+        // Skip trivially forwarded outputs because they are just placeholders
+        continue;
+      }
+      expr_eval.bind(output, *args[inputs.size() + i]);
+    }
+
+    {
+      FUSER_PERF_SCOPE("ExecutorRunFusion::IntermediateBufferAlloc");
+      SegmentHostPhaseGuard phase_guard(SegmentHostPhase::Allocation);
+      for (const auto i : c10::irange(executor_entry->intermediates.size())) {
+        const auto& buf_info = executor_entry->intermediates.at(i);
+        at::Tensor intermediate_buffer =
+            getIntermediateBuffer(*executor_entry, i);
+        args.push(intermediate_buffer);
+        intermediates.push_back(intermediate_buffer);
+        expr_eval.bind(
+            kernel()->summary().global_allocations.at(i)->buffer(),
+            *args[inputs.size() + outputs.size() + i]);
+        if (buf_info.is_profile_buffer) {
+          profile_buffer = intermediate_buffer;
+        }
+      }
+    }
+
+    SegmentHostPhaseGuard phase_guard(SegmentHostPhase::ArgumentBinding);
+    {
+      FUSER_PERF_SCOPE("ExecutorRunFusion::GetArgsBuffers");
+      arg_buffers.reserve(kernel()->parameters().size());
+      for (auto v : kernel()->parameters()) {
+        arg_buffers.emplace_back(
+            getKernelArgument(expr_eval, v, kernel()->indexType()));
+      }
+    }
+
+    // Only entries kept in executor_entry_lookup_ are worth a launch plan
+    if (executor_entry != &temporary_executor_entry && !launch_plan_checked) {
+      auto new_launch_plan = buildLaunchPlan(arg_buffers);
+      std::unique_lock<std::shared_mutex> guard(executor_entry_mutex_);
+      if (!executor_entry->launch_plan_checked) {
+        executor_entry->launch_plan = std::move(new_launch_plan);
+        executor_entry->launch_plan_checked = true;
+      }
     }
   }
 
   if (isDebugDumpEnabled(DebugDumpOption::LaunchParam)) {
-    launch_params_.print();
+    launch_params.print();
   }
 
   if (isDebugDumpEnabled(DebugDumpOption::KernelArgs)) {
@@ -1814,87 +2708,167 @@ std::vector<at::Tensor> FusionExecutor::runFusion(
     timer.init();
   }
 
-  if (execute_kernel_) {
-    ensureAvailableDynamicSmemSize(executor_entry->launch_params.smem());
+  // A kernel whose outputs are all computed by allocateOutputs, e.g., the
+  // views of a NoOp segment, has nothing to launch. See [ Host-Only Segments ]
+  const bool has_device_work = !kernel()->topLevelExprs().empty();
+  if (execute_kernel_ && !has_device_work && measure_kernel_time) {
+    std::lock_guard<std::mutex> guard(launch_state_mutex_);
+    kernel_time_ms_ = 0;
+  }
 
+  if (execute_kernel_ && has_device_work) {
     std::vector<void*> arg_buffer_ptrs;
-    arg_buffer_ptrs.reserve(arg_buffers.size());
-    for (auto& arg_buffer : arg_buffers) {
-      arg_buffer_ptrs.push_back(arg_buffer.data());
-    }
-
-    if (isDebugDumpEnabled(DebugDumpOption::Occupancy) ||
-        isDebugDumpEnabled(DebugDumpOption::PerfDebugVerbose)) {
-      int blocks_per_sm = -1;
-      NVFUSER_CUDA_SAFE_CALL(cuOccupancyMaxActiveBlocksPerMultiprocessor(
-          &blocks_per_sm,
-          compiled_kernel_->function,
-          launch_params_.nThreads(),
-          launch_params_.smem()));
-      const int64_t device_id =
-          static_cast<unsigned char>(options_.device.index());
-      const auto prop = at::cuda::getDeviceProperties(device_id);
-      const int64_t warps_per_sm =
-          ceilDiv(blocks_per_sm * launch_params_.nThreads(), prop->warpSize);
-      const int hw_max_warps =
-          prop->maxThreadsPerMultiProcessor / prop->warpSize;
-      const float occupancy = (float)warps_per_sm / (float)hw_max_warps * 100.f;
-      setKernelOccupancy(occupancy);
-      std::ostringstream oss;
-      oss << std::fixed << std::setprecision(2) << occupancy << "%";
-      debug() << "blocks_per_sm= " << blocks_per_sm
-              << ", warps_per_sm= " << warps_per_sm
-              << ", occupancy= " << oss.str() << std::endl;
+    void** kernel_args = nullptr;
+    // The device buffer of spilled tensor arguments and its address, which
+    // is passed as the first kernel argument
+    at::Tensor spilled_args;
+    void* spilled_args_ptr = nullptr;
+    if (launch_plan != nullptr && spilled_tensor_arguments_) {
+      // All arguments of a launch plan are tensors
+      spilled_args = uploadSpilledArguments(plan_arg_buffer);
+      spilled_args_ptr = spilled_args.data_ptr();
+      kernel_args = &spilled_args_ptr;
+    } else if (launch_plan != nullptr) {
+      arg_buffer_ptrs = launch_plan->argPointers(plan_arg_buffer);
+      kernel_args = arg_buffer_ptrs.data();
+    } else {
+      arg_buffer_ptrs.reserve(arg_buffers.size() + 1);
+      std::vector<std::byte> spilled_buffer;
+      if (spilled_tensor_arguments_) {
+        arg_buffer_ptrs.push_back(&spilled_args_ptr);
+      }
+      for (const auto i : c10::irange(arg_buffers.size())) {
+        auto tv = dynamic_cast<TensorView*>(kernel()->parameters().at(i));
+        if (spilled_tensor_arguments_ && tv != nullptr && !tv->isCpuScalar()) {
+          spilled_buffer.resize(
+              roundUpToMultiple((int64_t)spilled_buffer.size(), 8));
+          spilled_buffer.insert(
+              spilled_buffer.end(),
+              arg_buffers.at(i).begin(),
+              arg_buffers.at(i).end());
+          continue;
+        }
+        arg_buffer_ptrs.push_back(arg_buffers.at(i).data());
+      }
+      if (spilled_tensor_arguments_) {
+        spilled_args = uploadSpilledArguments(spilled_buffer);
+        spilled_args_ptr = spilled_args.data_ptr();
+      }
+      kernel_args = arg_buffer_ptrs.data();
+    }
+
+    {
+      std::lock_guard<std::mutex> guard(launch_state_mutex_);
+      ensureAvailableDynamicSmemSize(launch_params.smem());
+      if (executor_entry->launch_choice.has_value()) {
+        ensureSmemCarveout(executor_entry->launch_choice->smem_carveout_pct);
+      }
+      updateKernelResources(launch_params);
+
+      if (isDebugDumpEnabled(DebugDumpOption::Occupancy) ||
+          isDebugDumpEnabled(DebugDumpOption::PerfDebugVerbose)) {
+        const auto& resources = kernel_resources_;
+        const auto prop =
+            at::cuda::getDeviceProperties(options_.device.index());
+        const int64_t warps_per_sm = ceilDiv(
+            resources.blocks_per_sm * launch_params.nThreads(),
+            prop->warpSize);
+        const auto occupancy = (float)resources.theoretical_occupancy_pct;
+        setKernelOccupancy(occupancy);
+        std::ostringstream oss;
+        oss << std::fixed << std::setprecision(2) << occupancy << "%";
+        debug() << "blocks_per_sm= " << resources.blocks_per_sm
+                << ", warps_per_sm= " << warps_per_sm
+                << ", occupancy= " << oss.str() << std::endl;
+      }
     }
 
     if (measure_kernel_time) {
       timer.start();
     }
 
+    ++launch_count_;
     if (!kernel()->summary().has_cooperative_grid_reduction) {
       FUSER_PERF_SCOPE("ExecutorRunFusion::cuLaunchKernel");
-      NVFUSER_CUDA_SAFE_CALL(cuLaunchKernel(
-          compiled_kernel_->function,
-          launch_params_.gdimx(),
-          launch_params_.gdimy(),
-          launch_params_.gdimz(),
-          launch_params_.bdimx(),
-          launch_params_.bdimy(),
-          launch_params_.bdimz(),
-          launch_params_.smem(),
+      SegmentHostPhaseGuard phase_guard(SegmentHostPhase::KernelLaunch);
+      launchKernel(
+          compiledFunction(),
+          launch_params,
           stream,
-          arg_buffer_ptrs.data(),
-          nullptr));
+          kernel_args,
+          programmatic_dependent_launch_,
+          options_.device.index());
     } else {
       FUSER_PERF_SCOPE("ExecutorRunFusion::cuLaunchCooperativeKernel");
-      NVFUSER_CUDA_SAFE_CALL(cuLaunchCooperativeKernel(
-          compiled_kernel_->function,
-          launch_params_.gdimx(),
-          launch_params_.gdimy(),
-          launch_params_.gdimz(),
-          launch_params_.bdimx(),
-          launch_params_.bdimy(),
-          launch_params_.bdimz(),
-          launch_params_.smem(),
+      SegmentHostPhaseGuard phase_guard(SegmentHostPhase::KernelLaunch);
+      launchCooperativeKernel(
+          compiledFunction(),
+          launch_params,
           stream,
-          arg_buffer_ptrs.data()));
+          kernel_args,
+          options_.device.index());
     }
 
     if (measure_kernel_time) {
-      kernel_time_ms_ = timer.elapsed();
+      const float kernel_time_ms = timer.elapsed();
+      {
+        std::lock_guard<std::mutex> guard(launch_state_mutex_);
+        kernel_time_ms_ = kernel_time_ms;
+      }
 
       outputBytesProcessed(outputs);
 
       if (isDebugDumpEnabled(DebugDumpOption::EffectiveBandwidth)) {
         double gb_per_s =
-            ((double)bytesProcessed() / ((double)kernel_time_ms_ / 1000)) /
+            ((double)bytesProcessed() / ((double)kernel_time_ms / 1000)) /
             (double)1.0e9;
-        debug() << "kernel" << kernel_id_ << " run in " << kernel_time_ms_
+        debug() << "kernel" << kernel_id_ << " run in " << kernel_time_ms
                 << " ms, achieved: " << gb_per_s << " GB/s" << std::endl;
       }
     }
   }
 
+  if (record_launch_ && execute_kernel_) {
+    LaunchRecord record;
+    record.function = compiledFunction();
+    record.launch_params = launch_params;
+    record.is_cooperative = kernel()->summary().has_cooperative_grid_reduction;
+    record.has_spilled_arguments = spilled_tensor_arguments_;
+    record.is_tensor_arg.reserve(kernel()->parameters().size());
+    for (const auto i : c10::irange(kernel()->parameters().size())) {
+      Val* v = kernel()->parameters().at(i);
+      auto tv = dynamic_cast<TensorView*>(v);
+      record.is_tensor_arg.push_back(tv != nullptr && !tv->isCpuScalar());
+      auto get_rng = dynamic_cast<kir::GetRNGSeedAndOffsetFromHost*>(
+          v->definition());
+      if (get_rng == nullptr) {
+        continue;
+      }
+      if (!record.rng_args.has_value()) {
+        record.rng_args = LaunchRecord::RNGArgs();
+        record.rng_args->offset_increment = get_rng->offsets() * 4;
+      }
+      if (v == get_rng->output(0)) {
+        record.rng_args->seed_ptr = i;
+      } else if (v == get_rng->output(1)) {
+        record.rng_args->seed_val = i;
+      } else if (v == get_rng->output(2)) {
+        record.rng_args->offset_ptr = i;
+      } else {
+        record.rng_args->offset_val = i;
+      }
+    }
+    record.arg_buffers = std::move(arg_buffers);
+    record.outputs = outputs;
+    record.intermediates = intermediates;
+    record.zero_init.reserve(executor_entry->intermediates.size());
+    for (const auto& buf_info : executor_entry->intermediates) {
+      record.zero_init.push_back(buf_info.zero_init);
+    }
+    std::lock_guard<std::mutex> guard(launch_state_mutex_);
+    last_launch_record_ = std::move(record);
+  }
+
   if (isOptionEnabled(EnableOption::KernelProfile)) {
     debug() << kernel()->profile().toString(profile_buffer);
   }
@@ -1946,6 +2920,16 @@ int64_t FusionExecutor::outputBytesProcessed(
   return total_bytes;
 }
 
+MemoryTrafficEstimate FusionExecutor::estimateMemoryTraffic(
+    const KernelArgumentHolder& args) const {
+  NVF_ERROR(isCompiled(), "Kernel must be compiled to estimate its traffic");
+  ExpressionEvaluator expr_eval = executor_utils::bindInputs(args, kernel());
+  for (auto p_type : kParallelTypeThreads) {
+    expr_eval.bind(p_type, lastLaunchParams().getDim(p_type));
+  }
+  return nvfuser::estimateMemoryTraffic(kernel(), expr_eval);
+}
+
 void FusionExecutor::compileRtc(
     const std::string& code,
     const std::string& name,
@@ -2009,7 +2993,7 @@ float FusionExecutor::runRtc(
   }
 
   NVFUSER_CUDA_SAFE_CALL(cuLaunchKernel(
-      compiled_kernel_->function,
+      compiledFunction(),
       launch_params.gdimx(),
       launch_params.gdimy(),
       launch_params.gdimz(),
@@ -2043,11 +3027,23 @@ flatbuffers::Offset<serde::FusionExecutor> FusionExecutor::serialize(
   // vectors. The key value is the cache_id value in the KernelArgumentHolder.
   std::vector<size_t> executor_entry_lookup_keys_fb;
   std::vector<fb_executor_entry> executor_entry_lookup_values_fb;
+  std::shared_lock<std::shared_mutex> guard(executor_entry_mutex_);
   for (const auto& [key, value] : executor_entry_lookup_) {
     executor_entry_lookup_keys_fb.push_back(key);
     executor_entry_lookup_values_fb.push_back(serialize(builder, value));
   }
 
+  // See [ Compressed Kernel Binaries ]
+  std::vector<char> compressed_kernel_code;
+  std::vector<uint8_t> compressed_kernel_code_fb;
+  if (isOptionEnabled(EnableOption::CompressKernelBinaries) &&
+      compress_binary(
+          std::vector<char>(kernel_code_.begin(), kernel_code_.end()),
+          compressed_kernel_code)) {
+    compressed_kernel_code_fb.assign(
+        compressed_kernel_code.begin(), compressed_kernel_code.end());
+  }
+
   return serde::CreateFusionExecutorDirect(
       builder,
       device_smem_limit_,
@@ -2059,11 +3055,17 @@ flatbuffers::Offset<serde::FusionExecutor> FusionExecutor::serialize(
       concrete_id_,
       runtime_id_,
       group_id_,
-      kernel_code_.c_str(),
+      compressed_kernel_code_fb.empty() ? kernel_code_.c_str() : "",
       &executor_entry_lookup_keys_fb,
       &executor_entry_lookup_values_fb,
       toUnderlying(kernel()->indexType()),
-      serialize(builder, compiled_kernel_.get()));
+      serialize(builder, compiled_kernel_.get()),
+      serialize(builder, kernel_resources_),
+      programmatic_dependent_launch_,
+      spilled_tensor_arguments_,
+      launch_count_.load(),
+      compressed_kernel_code_fb.empty() ? nullptr
+                                        : &compressed_kernel_code_fb);
 }
 
 flatbuffers::Offset<serde::CudaKernel> FusionExecutor::serialize(
@@ -2077,27 +3079,31 @@ flatbuffers::Offset<serde::CudaKernel> FusionExecutor::serialize(
   auto fb_kernel_name = builder.CreateString(compiled_kernel->kernel_name);
   auto fb_compile_args = builder.CreateString(compiled_kernel->compile_args);
 
+  // See [ Compressed Kernel Binaries ]
+  const bool compress = isOptionEnabled(EnableOption::CompressKernelBinaries);
+  auto create_blob = [&](const std::vector<char>& blob) {
+    std::vector<char> compressed;
+    const std::vector<char>& data =
+        compress && compress_binary(blob, compressed) ? compressed : blob;
+    uint8_t* data_ptr = nullptr;
+    auto fb_blob = builder.CreateUninitializedVector(data.size(), &data_ptr);
+    std::copy(data.begin(), data.end(), data_ptr);
+    return fb_blob;
+  };
+
   flatbuffers::Offset<flatbuffers::Vector<uint8_t>> fb_cubin = 0;
   flatbuffers::Offset<flatbuffers::String> fb_cubin_filename = 0;
   if (!compiled_kernel->cubin.empty()) {
-    uint8_t* cubin_ptr = nullptr;
-    fb_cubin = builder.CreateUninitializedVector(
-        compiled_kernel->cubin.size(), &cubin_ptr);
-    std::copy(
-        compiled_kernel->cubin.begin(),
-        compiled_kernel->cubin.end(),
-        cubin_ptr);
+    fb_cubin = create_blob(compiled_kernel->cubin);
     fb_cubin_filename = builder.CreateString(compiled_kernel->cubin_filename);
   }
 
+  // The ptx isn't needed to load a kernel with a cubin
   flatbuffers::Offset<flatbuffers::Vector<uint8_t>> fb_ptx = 0;
   flatbuffers::Offset<flatbuffers::String> fb_ptx_filename = 0;
-  if (!compiled_kernel->ptx.empty()) {
-    uint8_t* ptx_ptr = nullptr;
-    fb_ptx = builder.CreateUninitializedVector(
-        compiled_kernel->ptx.size(), &ptx_ptr);
-    std::copy(
-        compiled_kernel->ptx.begin(), compiled_kernel->ptx.end(), ptx_ptr);
+  if (!compiled_kernel->ptx.empty() &&
+      !(compress && !compiled_kernel->cubin.empty())) {
+    fb_ptx = create_blob(compiled_kernel->ptx);
     fb_ptx_filename = builder.CreateString(compiled_kernel->ptx_filename);
   }
 
@@ -2109,6 +3115,10 @@ flatbuffers::Offset<serde::CudaKernel> FusionExecutor::serialize(
   ckb.add_kernel_name(fb_kernel_name);
   ckb.add_compile_args(fb_compile_args);
   ckb.add_block_size(compiled_kernel->block_size);
+  int nvrtc_major = 0, nvrtc_minor = 0;
+  NVFUSER_NVRTC_SAFE_CALL(nvrtcVersion(&nvrtc_major, &nvrtc_minor));
+  ckb.add_nvrtc_major(nvrtc_major);
+  ckb.add_nvrtc_minor(nvrtc_minor);
   return ckb.Finish();
 }
 
@@ -2178,7 +3188,27 @@ flatbuffers::Offset<serde::GlobalBufferInfo> FusionExecutor::serialize(
       nvfuser::toUnderlying(data.type),
       data.zero_init,
       data.is_profile_buffer,
-      is_fusion_output);
+      is_fusion_output,
+      data.resets_to_zero);
+}
+
+flatbuffers::Offset<serde::KernelResources> FusionExecutor::serialize(
+    flatbuffers::FlatBufferBuilder& builder,
+    const KernelResources& data) const {
+  // See table definition for KernelResources in serde/fusion_cache.fbs
+  return serde::CreateKernelResources(
+      builder,
+      data.registers,
+      data.local_bytes,
+      data.spill_store_bytes,
+      data.spill_load_bytes,
+      data.static_smem_bytes,
+      data.dynamic_smem_bytes,
+      data.launch_params.serialize(builder),
+      data.blocks_per_sm,
+      data.theoretical_occupancy_pct,
+      data.waves,
+      data.achieved_occupancy_pct.value_or(-1.0));
 }
 
 void FusionExecutor::deserialize(
@@ -2217,7 +3247,18 @@ void FusionExecutor::deserialize(
   block_size_high_water_mark_ = buffer->block_size_high_water_mark();
   maxrregcount_high_water_mark_ = buffer->maxrregcount_high_water_mark();
   warp_size_ = buffer->warp_size();
-  kernel_code_ = buffer->kernel_code()->str();
+  if (buffer->compressed_kernel_code() != nullptr) {
+    std::vector<char> kernel_code(
+        buffer->compressed_kernel_code()->begin(),
+        buffer->compressed_kernel_code()->end());
+    NVF_CHECK(
+        maybe_decompress_binary(kernel_code),
+        "Unable to decompress the serialized kernel code, see ",
+        "[ Compressed Kernel Binaries ]");
+    kernel_code_.assign(kernel_code.begin(), kernel_code.end());
+  } else {
+    kernel_code_ = buffer->kernel_code()->str();
+  }
 
   // KernelDB query checks kernel_code string and compile_params before
   // copying cubin.
@@ -2240,14 +3281,79 @@ void FusionExecutor::deserialize(
 
   // GlobalBufferInfo requires lowered kernel before deserialization
   for (auto idx : c10::irange(buffer->executor_entry_lookup_keys()->size())) {
-    executor_entry_lookup_.emplace(
-        buffer->executor_entry_lookup_keys()->Get(idx),
-        deserialize(buffer->executor_entry_lookup_values()->Get(idx)));
+    const auto it =
+        executor_entry_lookup_
+            .emplace(
+                buffer->executor_entry_lookup_keys()->Get(idx),
+                deserialize(buffer->executor_entry_lookup_values()->Get(idx)))
+            .first;
+    max_entry_dynamic_smem_size_ = std::max(
+        max_entry_dynamic_smem_size_.load(), it->second.launch_params.smem());
   }
 
   compiled_kernel_ = executor_utils::getCompiledKernel(
       buffer->compiled_kernel(), compile_params);
 
+  // Compile the serialized code again if its binary can't be used, e.g.,
+  // after an upgrade of CUDA. See [ Versioned Kernel Entries ]
+  const bool recompiled = compiled_kernel_ == nullptr;
+  if (recompiled) {
+    std::optional<int64_t> block_size;
+    if (buffer->compiled_kernel()->block_size() >= 0) {
+      block_size = buffer->compiled_kernel()->block_size();
+    }
+    compiled_kernel_ = executor_utils::getCompiledKernel(
+        kernel_code_,
+        getStructuredCode(),
+        kernelName(),
+        kernel_id_,
+        compile_params,
+        block_size);
+  }
+
+  // Buffers written before the kernel resources were serialized don't have
+  // them, in which case they are queried at the next launch. The resources
+  // of a recompiled kernel may differ.
+  if (!recompiled && buffer->kernel_resources() != nullptr) {
+    kernel_resources_ = deserialize(buffer->kernel_resources());
+  }
+  programmatic_dependent_launch_ = buffer->programmatic_dependent_launch();
+  spilled_tensor_arguments_ = buffer->spilled_tensor_arguments();
+  launch_count_ = buffer->launch_count();
+
+  // Load the modules of kernels that were launched often enough in the
+  // background, so their first launch doesn't wait for the module. See
+  // [ Lazy Module Loading ]
+  if (compiled_kernel_->function == nullptr &&
+      isOptionEnabled(EnableOption::PrefetchModules)) {
+    int64_t min_launch_count = 1;
+    const auto& args = getEnableOptionArguments(EnableOption::PrefetchModules);
+    if (!args.empty()) {
+      try {
+        min_launch_count = std::stoll(args.at(0));
+      } catch (const std::exception& e) {
+        debug() << "skip invalid argument for PrefetchModules, arg = "
+                << args.at(0) << std::endl;
+      }
+    }
+    if (launch_count_ >= min_launch_count) {
+      getThreadPool()->run(
+          [compiled_kernel = compiled_kernel_, device = options_.device]() {
+            try {
+              c10::DeviceGuard device_guard(device);
+              executor_utils::getFunction(*compiled_kernel);
+            } catch (const std::exception& e) {
+              // The module is loaded again at the first launch
+            }
+          });
+    }
+  }
+
+  // See [ Releasing Lowering Info ]
+  if (isOptionEnabled(EnableOption::ReleaseLoweringInfo)) {
+    releaseLoweringInfo();
+  }
+
   NVF_ERROR(isCompiled(), "Failed to deserialize FusionExecutor");
 }
 
@@ -2274,6 +3380,28 @@ FusionExecutor::ExecutorEntry FusionExecutor::deserialize(
   return entry;
 }
 
+FusionExecutor::KernelResources FusionExecutor::deserialize(
+    const serde::KernelResources* buffer) {
+  // See table definition for KernelResources in serde/fusion_cache.fbs
+  KernelResources resources;
+  resources.registers = buffer->registers();
+  resources.local_bytes = buffer->local_bytes();
+  resources.spill_store_bytes = buffer->spill_store_bytes();
+  resources.spill_load_bytes = buffer->spill_load_bytes();
+  resources.static_smem_bytes = buffer->static_smem_bytes();
+  resources.dynamic_smem_bytes = buffer->dynamic_smem_bytes();
+  if (buffer->launch_params() != nullptr) {
+    resources.launch_params.deserialize(buffer->launch_params());
+  }
+  resources.blocks_per_sm = buffer->blocks_per_sm();
+  resources.theoretical_occupancy_pct = buffer->theoretical_occupancy_pct();
+  resources.waves = buffer->waves();
+  if (buffer->achieved_occupancy_pct() >= 0) {
+    resources.achieved_occupancy_pct = buffer->achieved_occupancy_pct();
+  }
+  return resources;
+}
+
 FusionExecutor::GlobalBufferInfo FusionExecutor::deserialize(
     const serde::GlobalBufferInfo* buffer) {
   // See table definition for GlobalBufferInfo in serde/fusion_cache.fbs
@@ -2307,6 +3435,7 @@ FusionExecutor::GlobalBufferInfo FusionExecutor::deserialize(
   info.type = serde::mapToAtenDtype(buffer->dtype());
   info.zero_init = buffer->zero_init();
   info.is_profile_buffer = buffer->is_profile_buffer();
+  info.resets_to_zero = buffer->resets_to_zero();
   return info;
 }
 
@@ -6,6 +6,7 @@
  */
 // clang-format on
 #pragma once
+#include <device_lower/analysis/memory_traffic.h>
 #include <device_lower/lower2device.h>
 #include <exceptions.h>
 #include <executor_params.h>
@@ -21,8 +22,11 @@
 #include <atomic>
 
 #include <c10/core/DeviceType.h>
+#include <c10/cuda/CUDAStream.h>
 
 #include <functional>
+#include <mutex>
+#include <shared_mutex>
 
 namespace nvfuser {
 
@@ -43,6 +47,9 @@ class FusionExecutor : public NonCopyable {
     at::ScalarType type = at::ScalarType::Undefined;
     bool zero_init = false;
     bool is_profile_buffer = false;
+    //! Whether the kernel leaves the zero-initialized buffer in a valid
+    //! initial state for its next launch, see [ Persistent Semaphores ]
+    bool resets_to_zero = false;
   };
 
   // Unsafe compilation that's useful for debugging kernels, iterating over
@@ -151,12 +158,16 @@ class FusionExecutor : public NonCopyable {
   // execute
   bool isCompiled() const {
     if (compiled_kernel_ != nullptr) {
-      NVF_ERROR(compiled_kernel_->function != nullptr);
+      NVF_ERROR(
+          compiled_kernel_->function != nullptr ||
+          compiled_kernel_->load_module != nullptr);
     }
     return validKernelId() && lowered_ && compiled_kernel_ != nullptr;
   };
 
+  //! Must not be called while the entry of cache_id is being launched
   void evictCache(size_t cache_id) {
+    std::unique_lock<std::shared_mutex> guard(executor_entry_mutex_);
     executor_entry_lookup_.erase(cache_id);
   }
 
@@ -166,12 +177,161 @@ class FusionExecutor : public NonCopyable {
   // TODO: strides would also be important when we handle permutations in
   //       codegen.
   //
+  //! All kernel arguments of an ExecutorEntry packed into a single byte
+  //! buffer. The sizes and strides of all tensors passed to the kernel are
+  //! fixed for a given input cache id, so the only thing that changes from
+  //! one launch to the next is the data pointers, which are patched into a
+  //! copy of the buffer, as launches of the same entry may overlap, see
+  //! [ Concurrent Launches ]. This way a launch with a warm ExecutorEntry
+  //! needs neither an ExpressionEvaluator nor per-argument buffers. See
+  //! FusionExecutor::buildLaunchPlan for the kernels this is supported for.
+  struct LaunchPlan {
+    //! Which tensor a data pointer in the argument buffer belongs to
+    enum class PointerSource { Input, Output, Intermediate };
+
+    struct PointerPatch {
+      //! Byte offset of the data pointer in arg_buffer
+      size_t offset = 0;
+      PointerSource source = PointerSource::Input;
+      //! Index into the inputs, outputs or intermediates
+      size_t index = 0;
+    };
+
+    std::vector<std::byte> arg_buffer;
+    //! Byte offset of each kernel parameter in arg_buffer
+    std::vector<size_t> arg_offsets;
+    std::vector<PointerPatch> patches;
+
+    //! Pointers to each kernel parameter in buffer, a patched copy of
+    //! arg_buffer, as passed to cuLaunchKernel
+    std::vector<void*> argPointers(std::vector<std::byte>& buffer) const {
+      std::vector<void*> arg_ptrs;
+      arg_ptrs.reserve(arg_offsets.size());
+      for (auto offset : arg_offsets) {
+        arg_ptrs.push_back(buffer.data() + offset);
+      }
+      return arg_ptrs;
+    }
+  };
+
+  //! [ Occupancy-Driven Launch Parameters ]
+  //!
+  //! The heuristics choose the launch dimensions before the kernel is
+  //! compiled, so they can't account for the registers and shared memory it
+  //! ends up using. Some dimensions are only used by the kernel through
+  //! blockDim or gridDim, e.g., bdimy of a 2D pointwise schedule split by
+  //! TIDy or gdimx of a pointwise persistent grid, so any value is correct.
+  //! With EnableOption::OccupancyLaunch, these free dimensions are chosen
+  //! from the occupancy calculator when an ExecutorEntry is initialized:
+  //!  - A free thread dimension is halved as long as that increases the warps
+  //!    resident on the device, never exceeding the block size the kernel is
+  //!    compiled for.
+  //!  - A free grid dimension is set so the grid is as many blocks as the SMs
+  //!    hold at once.
+  //! Cooperative kernels keep their dimensions. Kernels that use no shared
+  //! memory also prefer the largest L1 with
+  //! CU_FUNC_ATTRIBUTE_PREFERRED_SHARED_MEMORY_CARVEOUT. The choice of each
+  //! entry is recorded as a LaunchChoice, see lastLaunchChoice.
+  struct LaunchChoice {
+    //! Launch parameters of the launch constraints given to runFusion
+    LaunchParams requested;
+    LaunchParams chosen;
+    //! Warps resident on the device at once, at most those of the grid
+    int64_t requested_resident_warps = 0;
+    int64_t chosen_resident_warps = 0;
+    //! Preferred shared memory carveout in percent, or -1 to keep the default
+    //! of the driver
+    int64_t smem_carveout_pct = -1;
+
+    std::string toString() const;
+  };
+
   struct ExecutorEntry {
     bool init = false;
     LaunchParams launch_params;
     std::vector<GlobalBufferInfo> outputs;
     // Temporary work buffers and intemediate global-memory tensors
     std::vector<GlobalBufferInfo> intermediates;
+    // Whether building launch_plan has been attempted. Not all kernels
+    // support it, in which case launch_plan stays empty.
+    bool launch_plan_checked = false;
+    std::optional<LaunchPlan> launch_plan;
+    // Semaphores kept across launches for each stream, indexed like
+    // intermediates and undefined for the other intermediates. See
+    // [ Persistent Semaphores ].
+    std::unordered_map<cudaStream_t, std::vector<at::Tensor>> semaphores;
+    // Only with EnableOption::OccupancyLaunch, see
+    // [ Occupancy-Driven Launch Parameters ]
+    std::optional<LaunchChoice> launch_choice;
+  };
+
+  //! Everything needed to relaunch the most recent kernel without going
+  //! through runFusion again. Only recorded when enabled with
+  //! setRecordLaunchFlag, e.g., to build a CUDA graph of a segmented fusion.
+  struct LaunchRecord {
+    CUfunction function = nullptr;
+    LaunchParams launch_params;
+    bool is_cooperative = false;
+    //! Whether the tensor arguments are passed in a device buffer, see
+    //! [ Spilled Kernel Arguments ]
+    bool has_spilled_arguments = false;
+    //! Argument buffers in the order of kir::Kernel::parameters()
+    std::vector<std::vector<std::byte>> arg_buffers;
+    //! Whether each argument is a global-memory tensor. The data pointer of a
+    //! tensor argument is stored at the beginning of its argument buffer.
+    std::vector<bool> is_tensor_arg;
+    //! Outputs allocated or given for this launch
+    std::vector<at::Tensor> outputs;
+    //! Temporary work buffers and intermediate global-memory tensors
+    std::vector<at::Tensor> intermediates;
+    //! Whether each of the intermediates must be cleared before the launch
+    std::vector<bool> zero_init;
+    //! Arguments of the RNG seed and offset of a kernel with random ops,
+    //! see kir::GetRNGSeedAndOffsetFromHost
+    struct RNGArgs {
+      size_t seed_ptr = 0;
+      size_t seed_val = 0;
+      size_t offset_ptr = 0;
+      size_t offset_val = 0;
+      //! Offset the launch advances the default CUDA generator by
+      int64_t offset_increment = 0;
+    };
+    std::optional<RNGArgs> rng_args;
+  };
+
+  //! [ Kernel Resources ]
+  //!
+  //! The resources used by the compiled kernel and its occupancy at the most
+  //! recent launch. The attributes of the function are queried once, while
+  //! the occupancy is recomputed whenever the block size or the dynamic
+  //! shared memory change, and the waves whenever the grid changes. The
+  //! record is kept, and serialized, with the FusionExecutor, so that every
+  //! kernel a model produces can be checked for spills and low occupancy
+  //! without DebugDumpOption::Occupancy or PrintPtxasLog.
+  struct KernelResources {
+    //! Registers per thread
+    int64_t registers = -1;
+    //! Local memory per thread, which holds the spilled registers and the
+    //! stack frame
+    int64_t local_bytes = -1;
+    //! Spilled bytes reported by ptxas, or -1 if its log isn't verbose, see
+    //! CompileParams::enable_ptxas_verbose
+    int64_t spill_store_bytes = -1;
+    int64_t spill_load_bytes = -1;
+    int64_t static_smem_bytes = -1;
+    int64_t dynamic_smem_bytes = -1;
+    LaunchParams launch_params;
+    //! Resident blocks per SM given by the occupancy calculator
+    int64_t blocks_per_sm = -1;
+    //! Resident warps in percent of the maximum per SM
+    double theoretical_occupancy_pct = 0.0;
+    //! Blocks of the grid divided by the blocks all SMs hold at once
+    double waves = 0.0;
+    //! Active warps in percent of the maximum per SM, as measured by the
+    //! kernel metrics of FusionProfiler, see [ Kernel Metrics ]
+    std::optional<double> achieved_occupancy_pct;
+
+    std::string toString() const;
   };
 
   using ExecutorCompileTimeInfoCache =
@@ -182,6 +342,8 @@ class FusionExecutor : public NonCopyable {
     return lowered_->kernel();
   }
 
+  //! Empty once the lowering info is released, see
+  //! [ Releasing Lowering Info ]
   const ThreadPredicateMap& threadPredMap() const {
     return lowered_->threadPredMap();
   }
@@ -196,6 +358,34 @@ class FusionExecutor : public NonCopyable {
     measure_kernel_time_ = measure_kernel_time;
   }
 
+  //! Record the arguments of each kernel launch so that it can be replayed
+  //! later. See LaunchRecord.
+  void setRecordLaunchFlag(bool record_launch) {
+    record_launch_ = record_launch;
+    if (!record_launch) {
+      last_launch_record_.reset();
+    }
+  }
+
+  //! Use the given tensors as the outputs of the next call of runFusion
+  //! instead of allocating them, e.g., to place the outputs in a
+  //! preallocated arena. An undefined entry means the output is allocated as
+  //! usual, and so does an output that aliases another tensor. The sizes,
+  //! strides and dtype of a given tensor must match those of the output, and
+  //! it must be aligned to 16 bytes.
+  void setOutputBuffers(std::vector<at::Tensor> output_buffers) {
+    output_buffers_ = std::move(output_buffers);
+  }
+
+  //! Returns and clears the record of the last kernel launch. Returns
+  //! std::nullopt if no launch has been recorded.
+  std::optional<LaunchRecord> takeLastLaunchRecord() {
+    std::lock_guard<std::mutex> guard(launch_state_mutex_);
+    auto record = std::move(last_launch_record_);
+    last_launch_record_.reset();
+    return record;
+  }
+
   //! Returns the last kernel execution time, in milliseconds
   //!
   //! \note The kernel time is only tracked if enabled by calling
@@ -221,12 +411,35 @@ class FusionExecutor : public NonCopyable {
   int getKernelRegisterSpills() const {
     return compiled_kernel_->register_spills;
   }
+
+  //! The resources of the compiled kernel as of its most recent launch, see
+  //! [ Kernel Resources ]
+  const KernelResources& kernelResources() const {
+    return kernel_resources_;
+  }
+
+  void setAchievedOccupancy(double achieved_occupancy_pct) {
+    kernel_resources_.achieved_occupancy_pct = achieved_occupancy_pct;
+  }
+
+  //! Whether the kernel waits for the preceding kernels of the stream, so it
+  //! is launched with programmatic dependent launch on Hopper, see
+  //! [ Programmatic Dependent Launch ]
+  bool usesProgrammaticDependentLaunch() const {
+    return programmatic_dependent_launch_;
+  }
+
   //! Returns the input bytes accessed for a kernel
   //! \note It is important to sample the args struct prior to adding the
   // 1    output to the args struct
   int64_t inputBytesProcessed(const KernelArgumentHolder& args);
   //! Returns the output bytes accessed for a kernel
   int64_t outputBytesProcessed(const std::vector<at::Tensor>& outputs);
+  //! Estimates the global memory traffic of running the kernel with the
+  //! inputs args and the most recent launch parameters, see
+  //! [ Memory Traffic Model ]
+  MemoryTrafficEstimate estimateMemoryTraffic(
+      const KernelArgumentHolder& args) const;
 
   //! Returns the number of bytes processed last kernel execution
   int64_t bytesProcessed() const {
@@ -258,9 +471,18 @@ class FusionExecutor : public NonCopyable {
 
   //! Returns the launch parameters from the last kernel execution
   LaunchParams lastLaunchParams() const {
+    std::lock_guard<std::mutex> guard(launch_state_mutex_);
     return launch_params_;
   }
 
+  //! Returns how the launch parameters of the last kernel execution were
+  //! chosen, or std::nullopt without EnableOption::OccupancyLaunch. See
+  //! [ Occupancy-Driven Launch Parameters ]
+  std::optional<LaunchChoice> lastLaunchChoice() const {
+    std::lock_guard<std::mutex> guard(launch_state_mutex_);
+    return last_launch_choice_;
+  }
+
   //! Returns the string of the compiled kernel
   std::string kernelString() const {
     NVF_ERROR(!kernel_code_.empty(), "Kernel code not generated");
@@ -279,6 +501,18 @@ class FusionExecutor : public NonCopyable {
     return *compiled_kernel_;
   }
 
+  //! The function of the compiled kernel, whose module is only loaded at its
+  //! first use after deserialization. See [ Lazy Module Loading ]
+  CUfunction compiledFunction() const {
+    return executor_utils::getFunction(*compiled_kernel_);
+  }
+
+  //! Number of launches of the kernel, including those of the process the
+  //! executor was serialized in
+  int64_t launchCount() const {
+    return launch_count_;
+  }
+
   //! Returns the disassembled latest compiled binary
   std::string disassembledBinary(const std::string& nvdisasm_args = "") const {
     return executor_utils::disassembleBinary(
@@ -424,6 +658,14 @@ class FusionExecutor : public NonCopyable {
     return &compile_time_info_cache_;
   }
 
+  //! Thread-parallel leaf domains of the used tensors, which the launch
+  //! parameters are inferred from
+  const std::vector<IterDomain*>& getParallelBindingIds();
+
+  //! Releases the analyses of lowered_ the launches don't use, see
+  //! [ Releasing Lowering Info ]
+  void releaseLoweringInfo();
+
   //! TODO: Consider changing this to a constructor of ExecutorEntry
   void initializeExecutorEntry(
       ExecutorEntry& executor_entry,
@@ -435,6 +677,51 @@ class FusionExecutor : public NonCopyable {
 
   std::unique_ptr<PrecomputedValues>& evaluatorPrecomputedValues();
 
+  //! [ Persistent Semaphores ]
+  //!
+  //! Grid reductions, grid broadcasts and grid syncs need zero-initialized
+  //! semaphores, which would cost an allocation and a memset kernel per
+  //! launch. The kernels already leave them in a valid initial state: the
+  //! serializing semaphores of serial and single-pass grid reductions are
+  //! reset to 0 by the last block, and each grid_sync::sync adds a multiple
+  //! of 2^63 to its semaphore, so that the semaphore is back to 0 or only
+  //! has the bit that sync flips set, with which sync works just as well.
+  //!
+  //! So the semaphores of an ExecutorEntry are allocated and zeroed at its
+  //! first launch on a stream and kept for the following launches on that
+  //! stream. All launches of an entry on the same stream run in order, so a
+  //! launch never sees the semaphores of a running launch, while launches on
+  //! other streams, e.g., of other threads, have their own. They are not
+  //! kept when launches are recorded, as the recorded launches may be
+  //! replayed on another stream, nor with
+  //! DisableOption::PersistentSemaphores.
+  //!
+  //! Returns the buffer of the index-th intermediate of the entry, the
+  //! persistent semaphore if it is one, or a new allocation otherwise.
+  at::Tensor getIntermediateBuffer(ExecutorEntry& executor_entry, size_t index);
+
+  //! The entry of cache_id, initialized at its first use. See
+  //! [ Concurrent Launches ]
+  ExecutorEntry& getExecutorEntry(
+      size_t cache_id,
+      const KernelArgumentHolder& args,
+      const LaunchParams& launch_constraints,
+      const CompileParams& compile_params,
+      const std::vector<at::Tensor>& outputs);
+
+  //! Recompile the kernel for the given parameters if needed, and lock it
+  //! against recompilations until the returned lock is released, so that no
+  //! other thread swaps it out during a launch
+  std::shared_lock<std::shared_mutex> lockKernelForLaunch(
+      const LaunchParams& launch_params,
+      const CompileParams& compile_params);
+
+  // Whether the kernel needs to be recompiled, as the number of threads in the
+  // block has increased or maxrregcount has changed
+  bool needsRecompile(
+      const LaunchParams& new_launch_params,
+      const CompileParams& new_compile_params) const;
+
   // Recompile the kernel if the number of threads in the block has increased
   // or maxrregcount has changed
   void recompileKernel(
@@ -468,6 +755,14 @@ class FusionExecutor : public NonCopyable {
   //! Deserialize GlobalBufferInfo using flatbuffers
   GlobalBufferInfo deserialize(const serde::GlobalBufferInfo* buffer);
 
+  //! Serialize KernelResources using flatbuffers
+  flatbuffers::Offset<serde::KernelResources> serialize(
+      flatbuffers::FlatBufferBuilder& builder,
+      const KernelResources& data) const;
+
+  //! Deserialize KernelResources using flatbuffers
+  KernelResources deserialize(const serde::KernelResources* buffer);
+
   //! Get the current dynamic shared memory size
   int64_t getAvailableDynamicSmemSize();
 
@@ -480,12 +775,52 @@ class FusionExecutor : public NonCopyable {
   void validateDynamicSmemSize(int64_t dynamic_smem_size);
 
   //! Make sure the dynamic shared memory size is at least as large as
-  //! the given size
+  //! the given size. Raising it configures the function for the largest
+  //! size of all ExecutorEntries, so the launches of the others don't call
+  //! into the driver.
   int64_t ensureAvailableDynamicSmemSize(int64_t dynamic_smem_size);
 
   //! Clear the cached properties of the compiled kernel
   void resetCompiledKernelProperties();
 
+  //! Update kernel_resources_ for a launch with the given parameters, see
+  //! [ Kernel Resources ]
+  void updateKernelResources(const LaunchParams& launch_params);
+
+  //! Blocks of the compiled kernel an SM holds at once when launched with
+  //! the given parameters
+  int64_t blocksPerSm(const LaunchParams& launch_params);
+
+  //! Returns the launch constraints with the free launch dimensions chosen
+  //! from the occupancy of the compiled kernel and records the choice. The
+  //! kernel must not be recompiled meanwhile, see lockKernelForEntry and
+  //! [ Occupancy-Driven Launch Parameters ]
+  LaunchParams chooseLaunchConstraints(
+      const KernelArgumentHolder& args,
+      const LaunchParams& launch_constraints,
+      DataType index_type,
+      LaunchChoice& choice);
+
+  //! Lock the kernel shared while an entry is initialized, if its launch
+  //! parameters are chosen from the occupancy of the kernel. It's locked
+  //! before executor_entry_mutex_, like in a launch.
+  std::shared_lock<std::shared_mutex> lockKernelForEntry();
+
+  //! Configure the preferred shared memory carveout of the compiled kernel,
+  //! unless it already is
+  void ensureSmemCarveout(int64_t carveout_pct);
+
+  //! Pack the argument buffers of a launch into a LaunchPlan. Returns
+  //! std::nullopt if some of the arguments may change without changing the
+  //! input cache id, e.g., scalars, RNG states and host-computed values, or
+  //! if outputs need to be evaluated from aliased tensors.
+  //! Copy the tensor arguments of a launch, laid out like the members of a
+  //! struct, to a new device buffer. See [ Spilled Kernel Arguments ]
+  at::Tensor uploadSpilledArguments(const std::vector<std::byte>& buffer) const;
+
+  std::optional<LaunchPlan> buildLaunchPlan(
+      const std::vector<std::vector<std::byte>>& arg_buffers) const;
+
  private:
   CompileOptions options_;
 
@@ -495,9 +830,9 @@ class FusionExecutor : public NonCopyable {
   //! Static shared memory size of the current compiled kernel
   std::optional<int64_t> static_smem_size_ = std::nullopt;
 
-  //! Available shared memory space for dynamic allocation for the current
-  //!  compiled kernel at the current shared memory/L1 configuration
-  std::optional<int64_t> available_dynamic_smem_size_ = std::nullopt;
+  //! Largest dynamic shared memory size of the ExecutorEntries, which the
+  //! function is configured for at once, see ensureAvailableDynamicSmemSize
+  std::atomic<int64_t> max_entry_dynamic_smem_size_ = 0;
 
   // Assuming sm70 or above:
   //  limit of statically allocated smem is 48 KB:
@@ -507,7 +842,7 @@ class FusionExecutor : public NonCopyable {
   const int64_t max_static_smem_ = 48 << 10;
 
   int64_t warp_size_ = 0;
-  std::unique_ptr<executor_utils::CompiledKernel> compiled_kernel_;
+  std::shared_ptr<executor_utils::CompiledKernel> compiled_kernel_;
 
   // TensorViews actually used in the kernel.
   std::vector<TensorView*> used_tvs_;
@@ -542,10 +877,44 @@ class FusionExecutor : public NonCopyable {
   int64_t block_size_high_water_mark_ = 1;
   int64_t maxrregcount_high_water_mark_ = 255;
 
+  // Kernels previously compiled for other register caps than the current
+  // one, keyed by maxrregcount, along with the block size high water mark
+  // they were compiled for. recompileKernel swaps them back in instead of
+  // invoking NVRTC again when the launch alternates between register caps.
+  std::unordered_map<
+      int64_t,
+      std::pair<int64_t, std::shared_ptr<executor_utils::CompiledKernel>>>
+      compiled_kernels_by_maxrregcount_;
+
   // lookup table to take short cut to retrieve recorded information in order to
   // launch kernels without re-inference parameters.
   std::unordered_map<size_t, ExecutorEntry> executor_entry_lookup_;
 
+  //! [ Concurrent Launches ]
+  //!
+  //! runFusion may be called from several threads at once, each on its own
+  //! stream, e.g., to serve independent requests with the same kernel. The
+  //! state of a launch, its argument buffers, outputs and intermediates, is
+  //! kept on the stack of runFusion, and the mutable state of the executor is
+  //! guarded by the mutexes below, whose critical sections are short:
+  //!  - executor_entry_mutex_ guards executor_entry_lookup_ and what is
+  //!    added to an entry after its initialization, its launch plan and
+  //!    semaphores. Warm lookups only take it shared.
+  //!  - kernel_mutex_ is held shared during a launch and exclusively to swap
+  //!    compiled_kernel_ in recompileKernel.
+  //!  - launch_state_mutex_ guards the attributes each launch updates: the
+  //!    configured dynamic shared memory and carveout, kernel_resources_ and
+  //!    the records of the last launch.
+  //! Launches of the same entry on different streams use different
+  //! semaphores, see [ Persistent Semaphores ], so they don't need to be
+  //! serialized on the GPU either. Concurrent callers should pass their
+  //! outputs to runFusion rather than use setOutputBuffers, and the profiling
+  //! records, e.g., kernelTimeMs and bytesProcessed, are only meaningful for
+  //! a single thread.
+  mutable std::shared_mutex executor_entry_mutex_;
+  std::shared_mutex kernel_mutex_;
+  mutable std::mutex launch_state_mutex_;
+
   // Compile time information caching. This is used for shape inference
   //  support. The cache stores graph information that are available
   //  without shape information so that each shape inference call will
@@ -566,10 +935,40 @@ class FusionExecutor : public NonCopyable {
   // is true
   float kernel_time_ms_ = 0;
 
+  // CUDA graph support: knob to record the arguments of each kernel launch
+  bool record_launch_ = false;
+
+  // CUDA graph support: the arguments of the last kernel launch, if
+  // record_launch_ is true
+  std::optional<LaunchRecord> last_launch_record_ = std::nullopt;
+
+  // See [ Occupancy-Driven Launch Parameters ]
+  std::optional<LaunchChoice> last_launch_choice_ = std::nullopt;
+
+  // Outputs to use for the next call of runFusion. See setOutputBuffers.
+  std::vector<at::Tensor> output_buffers_;
+
   // Heuristic tuning support: the last kernel occupancy, if
   // DebugDumpOption::Occupancy is true
   float kernel_occupancy_ = -1.0f;
 
+  // See [ Kernel Resources ]
+  KernelResources kernel_resources_;
+
+  // Whether kernel_code_ waits for the preceding kernels of the stream. It's
+  // serialized with kernel_code_, as a deserialized executor only re-lowers
+  // the fusion with the options of the current process. See
+  // [ Programmatic Dependent Launch ]
+  bool programmatic_dependent_launch_ = false;
+
+  // Whether kernel_code_ takes its tensor arguments in a device buffer.
+  // Serialized for the same reason. See [ Spilled Kernel Arguments ]
+  bool spilled_tensor_arguments_ = false;
+
+  // See launchCount. Serialized, so that deserialization can prefetch the
+  // modules of the kernels that were used. See [ Lazy Module Loading ]
+  std::atomic<int64_t> launch_count_ = 0;
+
   // Profiling support: last kernel bytes processed in each input
   std::optional<std::vector<int64_t>> bytes_processed_per_input_ = std::nullopt;
 
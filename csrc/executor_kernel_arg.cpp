@@ -17,6 +17,25 @@
 
 namespace nvfuser {
 
+KernelArgumentHolder::KernelArgumentHolder(const KernelArgumentHolder& other)
+    : device_index_(other.device_index_), cache_id_(other.cache_id_) {
+  for (const auto& arg : other.arguments_) {
+    push(*arg.value);
+  }
+}
+
+KernelArgumentHolder& KernelArgumentHolder::operator=(
+    const KernelArgumentHolder& other) {
+  if (this == &other) {
+    return *this;
+  }
+  // The arguments of other may be views of this holder's, so copy them
+  // before releasing ours
+  KernelArgumentHolder copy(other);
+  *this = std::move(copy);
+  return *this;
+}
+
 KernelArgumentHolder KernelArgumentHolder::createKernelArgumentHolder(
     const c10::ArrayRef<c10::IValue>& inputs,
     std::optional<int8_t> selected_device) {
@@ -89,8 +108,16 @@ void KernelArgumentHolder::push(const std::vector<at::Tensor>& tensors) {
 
 void KernelArgumentHolder::erase(const PolymorphicValue* arg_to_delete) {
   auto iter = std::remove_if(
-      arguments_.begin(), arguments_.end(), [&](const auto& ref) {
-        return arg_to_delete == ref.get();
+      arguments_.begin(), arguments_.end(), [&](const Argument& arg) {
+        if (arg.value != arg_to_delete) {
+          return false;
+        }
+        // Release the value, e.g., the memory of a tensor, but keep its slot
+        // so that the other arguments don't move
+        if (!arg.is_view) {
+          *arg.value = PolymorphicValue();
+        }
+        return true;
       });
   arguments_.erase(iter, arguments_.end());
 }
@@ -98,15 +125,16 @@ void KernelArgumentHolder::erase(const PolymorphicValue* arg_to_delete) {
 std::string KernelArgumentHolder::toString() const {
   std::stringstream ss;
   for (const auto& arg : arguments_) {
-    ss << *arg << "\n";
+    ss << *arg.value << "\n";
   }
   return ss.str();
 }
 
 PrimDataType KernelArgumentHolder::getSmallestIndexTypeOfArguments() const {
   for (const auto& arg : arguments_) {
-    if (arg->is<at::Tensor>()) {
-      if (getSmallestIndexType(arg->as<at::Tensor>()) == PrimDataType::Int) {
+    if (arg.value->is<at::Tensor>()) {
+      if (getSmallestIndexType(arg.value->as<at::Tensor>()) ==
+          PrimDataType::Int) {
         return PrimDataType::Int;
       }
     }
@@ -138,8 +166,9 @@ flatbuffers::Offset<serde::KernelArgumentHolder> KernelArgumentHolder::
 
   std::vector<fb_poly_value> arguments_fb;
   arguments_fb.reserve(arguments_.size());
-  for (auto& arg : arguments_) {
-    arguments_fb.push_back(serde::serializePolymorphicValue(builder, arg));
+  for (const auto& arg : arguments_) {
+    arguments_fb.push_back(
+        serde::serializePolymorphicValue(builder, arg.value));
   }
 
   return serde::CreateKernelArgumentHolderDirect(
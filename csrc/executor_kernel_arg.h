@@ -17,6 +17,7 @@
 #include <type.h>
 
 #include <cstddef>
+#include <deque>
 #include <optional>
 #include <vector>
 
@@ -27,6 +28,20 @@ namespace nvfuser {
 //! for both compilation as well as kernel execution. The important thing is to
 //! strip ownership of tensor from KernelArgumentHolder, so that during async
 //! compilation, we are not unnecessarily holding memory that is not needed.
+//!
+//! [ Kernel Argument Storage ]
+//!
+//! Running a segmented fusion pushes the extents of the inputs and the
+//! outputs of every segment to the arguments of the fusion, and gathers the
+//! inputs of each segment into a holder of its own. The values pushed to a
+//! holder are stored inline in a deque, which allocates them in chunks and
+//! never moves them, so pointers to the arguments stay valid while more are
+//! pushed, and erasing one releases its value but keeps its slot. The
+//! arguments of a segment are pushed as views with pushView instead, which
+//! refer to the arguments of the fusion without copying them. Views must not
+//! outlive the arguments they refer to. Copying a holder copies the values
+//! of its views, so the copy owns all of its arguments, while moving it
+//! keeps the views.
 class KernelArgumentHolder {
  public:
   static KernelArgumentHolder createKernelArgumentHolder(
@@ -35,7 +50,11 @@ class KernelArgumentHolder {
 
   KernelArgumentHolder() = default;
 
-  KernelArgumentHolder(const KernelArgumentHolder& self) = default;
+  KernelArgumentHolder(const KernelArgumentHolder& other);
+  KernelArgumentHolder& operator=(const KernelArgumentHolder& other);
+
+  KernelArgumentHolder(KernelArgumentHolder&& other) = default;
+  KernelArgumentHolder& operator=(KernelArgumentHolder&& other) = default;
 
   //! Computes the smallest index type for the currently held
   //! arguments. It does not consider any other tensors used in a kernel.
@@ -54,29 +73,25 @@ class KernelArgumentHolder {
   void erase(const PolymorphicValue* arg_to_delete);
 
   void push(PolymorphicValue val) {
-    arguments_.push_back(std::make_shared<PolymorphicValue>(std::move(val)));
+    owned_.push_back(std::move(val));
+    arguments_.push_back({&owned_.back(), false});
+  }
+
+  //! Push an argument of another holder without copying it, see
+  //! [ Kernel Argument Storage ]
+  void pushView(const PolymorphicValue* arg) {
+    NVF_ERROR(arg != nullptr);
+    arguments_.push_back({const_cast<PolymorphicValue*>(arg), true});
   }
 
   PolymorphicValue* back() {
-    return arguments_.back().get();
+    return arguments_.back().value;
   }
 
   PolymorphicValue* operator[](size_t ind) const {
-    return arguments_.at(ind).get();
+    return arguments_.at(ind).value;
   };
 
-  auto cbegin() const {
-    return arguments_.cbegin();
-  }
-
-  auto cend() const {
-    return arguments_.cend();
-  }
-
-  auto getBackInserter() {
-    return std::back_inserter(arguments_);
-  }
-
   size_t size() const {
     return arguments_.size();
   }
@@ -111,7 +126,17 @@ class KernelArgumentHolder {
   void deserialize(const serde::KernelArgumentHolder* buffer);
 
  private:
-  std::vector<std::shared_ptr<PolymorphicValue>> arguments_;
+  struct Argument {
+    PolymorphicValue* value = nullptr;
+    //! Whether value belongs to another holder
+    bool is_view = false;
+  };
+
+  //! Values pushed to this holder
+  std::deque<PolymorphicValue> owned_;
+
+  //! The arguments in order, either in owned_ or views
+  std::vector<Argument> arguments_;
 
   int8_t device_index_ = 0;
   std::optional<size_t> cache_id_ = std::nullopt;
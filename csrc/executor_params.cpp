@@ -22,7 +22,17 @@ std::string CompileParams::toString() const {
   }
   ss << "maxrregcount = " << maxrregcount << ", "
      << "enable_magic_zero = " << enable_magic_zero << ", "
-     << "enable_ptxas_verbose = " << enable_ptxas_verbose << "\n";
+     << "enable_ptxas_verbose = " << enable_ptxas_verbose << ", "
+     << "enable_fast_math = " << enable_fast_math << ", "
+     << "enable_warp_segment_reduction = " << enable_warp_segment_reduction;
+  if (!extent_divisors.empty()) {
+    ss << ", extent_divisors = {";
+    for (size_t i = 0; i < extent_divisors.size(); ++i) {
+      ss << (i == 0 ? "" : ", ") << extent_divisors.at(i);
+    }
+    ss << "}";
+  }
+  ss << "\n";
   return ss.str();
 }
 
@@ -11,6 +11,7 @@
 #include <type.h>
 
 #include <optional>
+#include <vector>
 
 namespace nvfuser {
 
@@ -20,6 +21,19 @@ struct CompileParams {
   bool enable_magic_zero = true;
   // if true, save ptxas info to compile log and check for register spilling
   bool enable_ptxas_verbose = false;
+  //! Largest known divisors of the extents of the root domains of the
+  //! fusion input tensors, in order of the inputs and their domains. Empty
+  //! unless the kernel is specialized for a size class, see
+  //! [ Size-Specialized Predicate Elimination ]
+  std::vector<int64_t> extent_divisors;
+  //! Generate approximate PTX instructions for transcendental unary ops on
+  //! float, see [ Fast Math ] in device_lower/pass/inline_ptx.h. Also
+  //! enabled for all fusions with NVFUSER_ENABLE=fast_math.
+  bool enable_fast_math = false;
+  //! Lower reductions over a TIDx of a constant power of two smaller than a
+  //! warp to shuffles within warp segments, see [ Warp Segment Reduction ].
+  //! Also enabled for all fusions with NVFUSER_ENABLE=warp_segment_reduction.
+  bool enable_warp_segment_reduction = false;
 
   bool operator==(const CompileParams& other) const {
     // Disallow comparison if the index type is nullopt
@@ -31,7 +45,10 @@ struct CompileParams {
         "cannot compare as the other index type is not defined");
     return index_type == other.index_type &&
         maxrregcount == other.maxrregcount &&
-        enable_magic_zero == other.enable_magic_zero;
+        enable_magic_zero == other.enable_magic_zero &&
+        extent_divisors == other.extent_divisors &&
+        enable_fast_math == other.enable_fast_math &&
+        enable_warp_segment_reduction == other.enable_warp_segment_reduction;
   }
 
   bool operator!=(const CompileParams& other) const {
@@ -19,7 +19,10 @@
 #include <ir/all_nodes.h>
 #include <ir/iostream.h>
 #include <ir/utils.h>
+#include <kernel_db/compile_cache.h>
 #include <kernel_db/kernel_db.h>
+#include <kernel_db/remote_compile_cache.h>
+#include <kernel_db/utils.h>
 #include <options.h>
 #include <tensor_metadata.h>
 #include <torch/csrc/jit/resource_guard.h>
@@ -31,13 +34,16 @@
 #include <nvfuser_resources/bf16_support.h>
 #include <nvfuser_resources/bit.h>
 #include <nvfuser_resources/block_reduction.h>
+#include <nvfuser_resources/block_reduction_outer.h>
 #include <nvfuser_resources/block_sync_atomic.h>
 #include <nvfuser_resources/block_sync_default.h>
 #include <nvfuser_resources/block_welford_outer.h>
 #include <nvfuser_resources/broadcast.h>
 #include <nvfuser_resources/complex_number.h>
 #include <nvfuser_resources/fp16_support.h>
+#include <nvfuser_resources/fp8_support.h>
 #include <nvfuser_resources/fused_reduction.h>
+#include <nvfuser_resources/fused_reduction_impl_outer.h>
 #include <nvfuser_resources/fused_welford_helper.h>
 #include <nvfuser_resources/fused_welford_impl.h>
 #include <nvfuser_resources/fused_welford_impl_outer.h>
@@ -49,7 +55,11 @@
 #include <nvfuser_resources/mbarrier.h>
 #include <nvfuser_resources/memory.h>
 #include <nvfuser_resources/random_numbers.h>
+#include <nvfuser_resources/scan.h>
+#include <nvfuser_resources/scatter.h>
+#include <nvfuser_resources/sort.h>
 #include <nvfuser_resources/tensor.h>
+#include <nvfuser_resources/transpose.h>
 #include <nvfuser_resources/tuple.h>
 #include <nvfuser_resources/type_traits.h>
 #include <nvfuser_resources/warp.h>
@@ -57,6 +67,11 @@
 
 #include <cstdlib>
 #include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <unordered_map>
 #include <variant>
 
 #include <nvrtc.h>
@@ -72,6 +87,7 @@ std::string kernelPreamble() {
 
   ss << nvfuser_resources::fp16_support_cu;
   ss << nvfuser_resources::bf16_support_cu;
+  ss << nvfuser_resources::fp8_support_cu;
 
   // Base classes and helpers
   ss << nvfuser_resources::type_traits_cu;
@@ -81,6 +97,9 @@ std::string kernelPreamble() {
   ss << nvfuser_resources::helpers_cu;
   ss << nvfuser_resources::index_utils_cu;
   ss << nvfuser_resources::tuple_cu;
+  ss << nvfuser_resources::sort_cu;
+  ss << nvfuser_resources::scatter_cu;
+  ss << nvfuser_resources::transpose_cu;
 
   // Synchronization classes
   if (getNvFuserEnv("USE_BLOCK_SYNC_ATOMIC")) {
@@ -98,12 +117,15 @@ std::string kernelPreamble() {
   ss << nvfuser_resources::broadcast_cu;
   ss << nvfuser_resources::welford_cu;
   ss << nvfuser_resources::warp_cu;
+  ss << nvfuser_resources::scan_cu;
   ss << nvfuser_resources::memory_cu;
   ss << nvfuser_resources::fused_welford_helper_cu;
   ss << nvfuser_resources::fused_reduction_cu;
   ss << nvfuser_resources::fused_welford_impl_cu;
   ss << nvfuser_resources::block_welford_outer_cu;
   ss << nvfuser_resources::fused_welford_impl_outer_cu;
+  ss << nvfuser_resources::block_reduction_outer_cu;
+  ss << nvfuser_resources::fused_reduction_impl_outer_cu;
 
   return ss.str();
 }
@@ -707,6 +729,21 @@ void validateVectorizedTensors(
   validateVectorizedSplits(kernel, expr_eval);
 }
 
+void validateExtentDivisors(
+    kir::Kernel* kernel,
+    ExpressionEvaluator& expr_eval) {
+  for (const auto& [extent, divisor] :
+       kernel->summary().extent_divisors_to_validate) {
+    auto input_extent = expr_eval.evaluate(extent);
+    NVF_ERROR(
+        input_extent.hasValue() && input_extent.as<int64_t>() % divisor == 0,
+        "The kernel is specialized for extents divisible by ",
+        divisor,
+        ", but the extent is ",
+        input_extent);
+  }
+}
+
 ExpressionEvaluator bindInputs(
     const KernelArgumentHolder& args,
     Fusion* kernel) {
@@ -956,6 +993,31 @@ class CuModuleLoadDataDriver {
   std::string log_;
 };
 
+// Number of threads NVRTC may use with --split-compile, which is given as
+// the argument of EnableOption::SplitCompile. Zero lets NVRTC use as many
+// threads as there are CPUs.
+int64_t getSplitCompileThreads() {
+  const auto& args = getEnableOptionArguments(EnableOption::SplitCompile);
+  if (args.empty()) {
+    return 0;
+  }
+  try {
+    return std::max((int64_t)std::stoi(args.at(0)), (int64_t)0);
+  } catch (const std::exception& e) {
+    debug() << "skip invalid argument for SplitCompile, arg = " << args.at(0)
+            << std::endl;
+    return 0;
+  }
+}
+
+// Check if the NVRTC loaded at runtime supports --split-compile, which was
+// added in CUDA 12.1
+bool isSplitCompileSupported() {
+  int nvrtc_major = 0, nvrtc_minor = 0;
+  NVFUSER_NVRTC_SAFE_CALL(nvrtcVersion(&nvrtc_major, &nvrtc_minor));
+  return nvrtc_major > 12 || (nvrtc_major == 12 && nvrtc_minor >= 1);
+}
+
 // Fill options for nvrtcCompileProgram and cuModuleLoadDataEx
 void fillCompileOptions(
     NvrtcCompileDriver& nvrtc_compile_driver,
@@ -1058,6 +1120,15 @@ void fillCompileOptions(
       module_load_driver.setOption(CU_JIT_MAX_REGISTERS, (int)*max_register);
     }
   }
+
+  // Large kernels spend most of their compilation in ptxas, which can
+  // optimize independent functions on multiple threads. This only applies
+  // when compiling to SASS, as PTX is compiled by the driver.
+  if (compile_to_sass && isOptionEnabled(EnableOption::SplitCompile) &&
+      isSplitCompileSupported()) {
+    nvrtc_compile_driver.setOption(
+        "--split-compile=" + std::to_string(getSplitCompileThreads()));
+  }
 }
 
 // Dump ptxas output if register spill is detected
@@ -1099,6 +1170,26 @@ int warnRegisterSpill(const std::string& compile_log) {
   return store_count + load_count;
 }
 
+// The number preceding "bytes <what>" in a verbose ptxas log, e.g., of "0
+// bytes spill stores", or -1 if there is none
+int64_t ptxasLogBytes(
+    const std::string& compile_log,
+    const std::string& what) {
+  const auto pos = compile_log.find(" bytes " + what);
+  if (pos == std::string::npos || pos == 0) {
+    return -1;
+  }
+  const auto begin = compile_log.find_last_of(" \t\n,", pos - 1);
+  const auto number = begin == std::string::npos
+      ? compile_log.substr(0, pos)
+      : compile_log.substr(begin + 1, pos - begin - 1);
+  try {
+    return std::stoll(number);
+  } catch (const std::exception&) {
+    return -1;
+  }
+}
+
 void createNvrtcProgram(
     nvrtcProgram& program,
     const std::string& id,
@@ -1157,6 +1248,93 @@ std::unique_ptr<CompiledKernel> compileSource(
   return compiled_kernel;
 }
 
+// [ Kernel Deduplication ]
+//
+// Identical segments, e.g., the same bias and GELU of every layer of a
+// transformer, whether traced as separate fusions or repeated within one
+// fusion, generate the same source code up to the name of the kernel. The
+// compiled kernels of a process are therefore registered by a hash of the
+// source code with the kernel name replaced, the compile options and the
+// target, and by their device. A FusionExecutor compiling a registered
+// kernel for the same device shares its CompiledKernel, i.e., its CUmodule
+// and CUfunction, instead of invoking NVRTC and loading another module. The
+// compiled kernel keeps the name it was compiled with, which is what
+// cuModuleGetFunction and the serialized binaries refer to.
+//
+// Modules can't be shared across devices, but binaries can be shared across
+// devices of the same architecture, which the target in the hash ensures.
+// If the kernel is only registered for other devices, e.g., when the same
+// model runs on every GPU of a node in one process, the binary of one of
+// them is loaded into a new module on the current device instead of being
+// compiled again. Launch parameters are computed per executor as usual.
+//
+// The registry only holds weak references, so a module is still unloaded
+// once the last executor using it is destroyed. Disabled with
+// NVFUSER_DISABLE=kernel_deduplication.
+class CompiledKernelRegistry {
+ public:
+  //! Hash of the code and the block size the kernel is compiled for
+  using Key = std::tuple<uint64_t, uint64_t, int64_t>;
+
+  static CompiledKernelRegistry& get() {
+    static CompiledKernelRegistry registry;
+    return registry;
+  }
+
+  //! The kernel registered for the key on the device, or nullptr
+  std::shared_ptr<CompiledKernel> find(const Key& key, int device) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto it = kernels_.find(key);
+    if (it == kernels_.end()) {
+      return nullptr;
+    }
+    auto device_it = it->second.find(device);
+    if (device_it == it->second.end()) {
+      return nullptr;
+    }
+    auto compiled_kernel = device_it->second.lock();
+    if (compiled_kernel == nullptr) {
+      it->second.erase(device_it);
+    }
+    return compiled_kernel;
+  }
+
+  //! A kernel registered for the key on any device, or nullptr
+  std::shared_ptr<CompiledKernel> findOnAnyDevice(const Key& key) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto it = kernels_.find(key);
+    if (it == kernels_.end()) {
+      return nullptr;
+    }
+    for (const auto& [device, entry] : it->second) {
+      if (auto compiled_kernel = entry.lock()) {
+        return compiled_kernel;
+      }
+    }
+    return nullptr;
+  }
+
+  //! Registers a compiled kernel, unless another thread registered one for
+  //! the same key and device in the meantime, which is returned instead
+  std::shared_ptr<CompiledKernel> insert(
+      const Key& key,
+      int device,
+      std::shared_ptr<CompiledKernel> compiled_kernel) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto& entry = kernels_[key][device];
+    if (auto existing = entry.lock()) {
+      return existing;
+    }
+    entry = compiled_kernel;
+    return compiled_kernel;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::map<Key, std::unordered_map<int, std::weak_ptr<CompiledKernel>>>
+      kernels_;
+};
+
 } // namespace
 
 CompiledKernel::~CompiledKernel() {
@@ -1166,7 +1344,7 @@ CompiledKernel::~CompiledKernel() {
 }
 
 // Compile the source if no existing compiled binary is found in KernelDB
-std::unique_ptr<CompiledKernel> getCompiledKernel(
+std::shared_ptr<CompiledKernel> getCompiledKernel(
     std::optional<std::reference_wrapper<const std::string>> kernel_code,
     const std::string& full_src_code,
     const std::string& func_name,
@@ -1228,15 +1406,116 @@ std::unique_ptr<CompiledKernel> getCompiledKernel(
     }
   }
 
-  auto compiled_kernel = std::make_unique<CompiledKernel>();
   const auto compile_args =
       toDelimitedString(nvrtc_compile_driver.options(), " ");
 
+  int nvrtc_major = 0, nvrtc_minor = 0;
+  NVFUSER_NVRTC_SAFE_CALL(nvrtcVersion(&nvrtc_major, &nvrtc_minor));
+
+  // Share the kernel compiled for an identical segment, see
+  // [ Kernel Deduplication ]
+  std::optional<CompiledKernelRegistry::Key> registry_key;
+  if (!isOptionDisabled(DisableOption::KernelDeduplication)) {
+    std::string normalized_code = full_src_code;
+    for (size_t pos = normalized_code.find(func_name);
+         pos != std::string::npos;
+         pos = normalized_code.find(func_name, pos)) {
+      normalized_code.replace(pos, func_name.size(), "kernel");
+    }
+    const auto hash = CompileCache::makeKey(
+        normalized_code,
+        compile_args,
+        nvrtc_major,
+        nvrtc_minor,
+        major,
+        minor,
+        compile_to_sass);
+    registry_key = CompiledKernelRegistry::Key{
+        hash.at(0), hash.at(1), opt_block_size.value_or(-1)};
+    if (auto compiled_kernel =
+            CompiledKernelRegistry::get().find(registry_key.value(), device)) {
+      return compiled_kernel;
+    }
+  }
+
+  auto compiled_kernel = std::make_unique<CompiledKernel>();
+
+  // Load the binary compiled for another device of the same architecture
+  std::shared_ptr<CompiledKernel> other_device_kernel;
+  if (registry_key.has_value()) {
+    other_device_kernel =
+        CompiledKernelRegistry::get().findOnAnyDevice(registry_key.value());
+  }
+  const bool loaded_from_other_device = other_device_kernel != nullptr;
+  if (loaded_from_other_device) {
+    compiled_kernel->kernel_name = other_device_kernel->kernel_name;
+    compiled_kernel->cubin = other_device_kernel->cubin;
+    compiled_kernel->ptx = other_device_kernel->ptx;
+    log << "Loaded the binary compiled for another device" << std::endl;
+  }
+
   auto& kernel_db = KernelDb::get();
   const auto use_kernel_db = kernel_db.enabled() && kernel_code.has_value();
 
+  // The persistent compile cache is keyed by the full source, so it is
+  // checked first. See [ Persistent Compile Cache ].
+  CompileCache* compile_cache = CompileCache::get();
+  RemoteCompileCache* remote_compile_cache =
+      loaded_from_other_device ? nullptr : RemoteCompileCache::get();
+  std::optional<CompileCache::Key> compile_cache_key;
+  if (compile_cache != nullptr || remote_compile_cache != nullptr) {
+    compile_cache_key = CompileCache::makeKey(
+        full_src_code,
+        compile_args,
+        nvrtc_major,
+        nvrtc_minor,
+        major,
+        minor,
+        compile_to_sass);
+  }
+
+  bool cached = !loaded_from_other_device && compile_cache != nullptr &&
+      compile_cache->query(
+          compile_cache_key.value(),
+          compiled_kernel->kernel_name,
+          (compile_to_sass ? compiled_kernel->cubin : compiled_kernel->ptx));
+  if (cached) {
+    log << "Loaded from compile cache: "
+        << CompileCache::toString(compile_cache_key.value()) << std::endl;
+  }
+
+  // A kernel missing from the store is only compiled by the client that
+  // claims it, see [ Remote Compile Cache ]
+  bool remote_compile_claimed = false;
+  if (!cached && remote_compile_cache != nullptr) {
+    const auto& key = compile_cache_key.value();
+    auto query_remote = [&]() {
+      return remote_compile_cache->query(
+          key,
+          compiled_kernel->kernel_name,
+          (compile_to_sass ? compiled_kernel->cubin : compiled_kernel->ptx));
+    };
+    cached = query_remote();
+    if (!cached) {
+      remote_compile_claimed = remote_compile_cache->claim(key);
+      cached = !remote_compile_claimed && remote_compile_cache->wait(key) &&
+          query_remote();
+    }
+    if (cached) {
+      log << "Loaded from remote compile cache: "
+          << CompileCache::toString(key) << std::endl;
+      if (compile_cache != nullptr) {
+        compile_cache->write(
+            key,
+            compiled_kernel->kernel_name,
+            compile_to_sass ? compiled_kernel->cubin : compiled_kernel->ptx);
+      }
+    }
+  }
+
   // If the Kernel Query fails, the Kernel is recompiled
-  if (!(use_kernel_db &&
+  if (!loaded_from_other_device && !cached &&
+      !(use_kernel_db &&
         kernel_db.query(
             kernel_code.value(),
             compile_args,
@@ -1258,6 +1537,25 @@ std::unique_ptr<CompiledKernel> getCompiledKernel(
             compiled_kernel->kernel_name);
       }
     }
+    if (compile_cache_key.has_value() &&
+        !compile_cache->write(
+            compile_cache_key.value(),
+            compiled_kernel->kernel_name,
+            compile_to_sass ? compiled_kernel->cubin : compiled_kernel->ptx)) {
+      TORCH_WARN(
+          "compile cache was unable to write kernel: ",
+          compiled_kernel->kernel_name);
+    }
+  }
+
+  if (remote_compile_claimed &&
+      !remote_compile_cache->write(
+          compile_cache_key.value(),
+          compiled_kernel->kernel_name,
+          compile_to_sass ? compiled_kernel->cubin : compiled_kernel->ptx)) {
+    TORCH_WARN(
+        "remote compile cache was unable to write kernel: ",
+        compiled_kernel->kernel_name);
   }
 
   log << module_load_driver.invoke(
@@ -1273,6 +1571,17 @@ std::unique_ptr<CompiledKernel> getCompiledKernel(
     compiled_kernel->register_spills =
         warnRegisterSpill(compiled_kernel->compile_log);
   }
+  compiled_kernel->spill_store_bytes =
+      ptxasLogBytes(compiled_kernel->compile_log, "spill stores");
+  compiled_kernel->spill_load_bytes =
+      ptxasLogBytes(compiled_kernel->compile_log, "spill loads");
+  // The ptxas log is only of the device the binary was compiled for
+  if (loaded_from_other_device) {
+    compiled_kernel->register_spills = other_device_kernel->register_spills;
+    compiled_kernel->spill_store_bytes =
+        other_device_kernel->spill_store_bytes;
+    compiled_kernel->spill_load_bytes = other_device_kernel->spill_load_bytes;
+  }
 
   NVFUSER_CUDA_SAFE_CALL(cuModuleGetFunction(
       &(compiled_kernel->function),
@@ -1284,6 +1593,10 @@ std::unique_ptr<CompiledKernel> getCompiledKernel(
     compiled_kernel->block_size = opt_block_size.value();
   }
 
+  if (registry_key.has_value()) {
+    return CompiledKernelRegistry::get().insert(
+        registry_key.value(), device, std::move(compiled_kernel));
+  }
   return compiled_kernel;
 }
 
@@ -1318,6 +1631,13 @@ std::unique_ptr<CompiledKernel> getCompiledKernel(
     compiled_kernel->ptx_filename = buffer->ptx_filename()->str();
   }
 
+  NVF_CHECK(
+      maybe_decompress_binary(compiled_kernel->cubin) &&
+          maybe_decompress_binary(compiled_kernel->ptx),
+      "Unable to decompress the serialized kernel ",
+      compiled_kernel->kernel_name,
+      ", see [ Compressed Kernel Binaries ]");
+
   at::cuda::jit::initializeCudaContext();
 
   // The above initialization works in some cases. However, it seems to
@@ -1358,38 +1678,70 @@ std::unique_ptr<CompiledKernel> getCompiledKernel(
 
   const auto latest_compile_args =
       toDelimitedString(nvrtc_compile_driver.options(), " ");
-  NVF_ERROR(
-      latest_compile_args == compiled_kernel->compile_args,
-      "The compile arguments for the serialized cuda kernel does not ",
-      "match the latest generated compile args.\t",
-      latest_compile_args,
-      "\t",
-      compiled_kernel->compile_args);
 
-  NVF_ERROR(
-      !compile_to_sass || !compiled_kernel->cubin.empty(),
-      "Expected compiled cubin after deserializing CompiledKernel.");
-
-  NVF_ERROR(
-      compile_to_sass || !compiled_kernel->ptx.empty(),
-      "Expected compiled ptx after deserializing CompiledKernel.");
-
-  std::stringstream log;
-  log << module_load_driver.invoke(
-             compiled_kernel->module,
-             (compile_to_sass ? compiled_kernel->cubin.data()
-                              : compiled_kernel->ptx.data()))
-      << std::endl;
-  compiled_kernel->compile_log = log.str();
-
-  NVFUSER_CUDA_SAFE_CALL(cuModuleGetFunction(
-      &(compiled_kernel->function),
-      compiled_kernel->module,
-      compiled_kernel->kernel_name.c_str()));
+  // See [ Versioned Kernel Entries ]
+  int nvrtc_major = 0, nvrtc_minor = 0;
+  NVFUSER_NVRTC_SAFE_CALL(nvrtcVersion(&nvrtc_major, &nvrtc_minor));
+  const bool compatible_nvrtc = buffer->nvrtc_major() == nvrtc_major &&
+      (compile_to_sass || buffer->nvrtc_minor() == nvrtc_minor);
+  const bool has_binary = compile_to_sass ? !compiled_kernel->cubin.empty()
+                                          : !compiled_kernel->ptx.empty();
+  if (!compatible_nvrtc || !has_binary ||
+      latest_compile_args != compiled_kernel->compile_args) {
+    if (isDebugDumpEnabled(DebugDumpOption::PerfDebugVerbose)) {
+      debug() << "Compiling serialized kernel " << compiled_kernel->kernel_name
+              << " again, since it was compiled by NVRTC "
+              << buffer->nvrtc_major() << "." << buffer->nvrtc_minor()
+              << " with args: " << compiled_kernel->compile_args << std::endl;
+    }
+    return nullptr;
+  }
+
+  // See [ Lazy Module Loading ]
+  compiled_kernel->load_module = [module_load_driver, compile_to_sass](
+                                     CompiledKernel& compiled_kernel) mutable {
+    FUSER_PERF_SCOPE("executor_utils::loadDeserializedModule");
+    std::stringstream log;
+    log << module_load_driver.invoke(
+               compiled_kernel.module,
+               (compile_to_sass ? compiled_kernel.cubin.data()
+                                : compiled_kernel.ptx.data()))
+        << std::endl;
+    compiled_kernel.compile_log = log.str();
+
+    NVFUSER_CUDA_SAFE_CALL(cuModuleGetFunction(
+        &(compiled_kernel.function),
+        compiled_kernel.module,
+        compiled_kernel.kernel_name.c_str()));
+  };
+  if (isOptionDisabled(DisableOption::LazyModuleLoading)) {
+    getFunction(*compiled_kernel);
+  }
 
   return compiled_kernel;
 }
 
+// [ Lazy Module Loading ]
+//
+// Restoring a serialized cache used to load the binary of every kernel into
+// a CUmodule, which costs startup time and device memory for kernels that
+// may never run in this process. The CompiledKernel of a deserialized
+// executor instead keeps the binary and a loader configured with the module
+// load options, and getFunction loads the module into the current context
+// the first time the function is needed, i.e., usually at the first launch.
+// The loader runs at most once, also when the kernel is prefetched by
+// another thread, see FusionExecutor::deserialize. Disabled with
+// NVFUSER_DISABLE=lazy_module_loading.
+CUfunction getFunction(CompiledKernel& compiled_kernel) {
+  if (compiled_kernel.load_module) {
+    std::call_once(
+        compiled_kernel.load_module_once,
+        compiled_kernel.load_module,
+        compiled_kernel);
+  }
+  return compiled_kernel.function;
+}
+
 namespace caching {
 
 //! CompileTimeInfo is the actual subclass of CompileTimeInfoBase that will
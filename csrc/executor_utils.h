@@ -25,6 +25,8 @@
 #include <ir/all_nodes.h>
 #include <kernel.h>
 
+#include <functional>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -59,10 +61,29 @@ struct CompiledKernel : public NonCopyable {
   std::string compile_args;
   long block_size = -1;
   int register_spills = -1;
+  //! Spilled bytes in the ptxas log, or -1 if it isn't verbose
+  int64_t spill_store_bytes = -1;
+  int64_t spill_load_bytes = -1;
+  //! Maximum dynamic shared memory size the function is configured for, or
+  //! -1 if it isn't queried yet. Kept here rather than in the executors,
+  //! since the kernel may be shared, see [ Kernel Deduplication ]
+  int64_t max_dynamic_smem_size = -1;
+  //! Preferred shared memory carveout in percent the function is configured
+  //! for, or -1 if it isn't set, see [ Occupancy-Driven Launch Parameters ]
+  int64_t smem_carveout_pct = -1;
+  //! Loads module and function of a deserialized kernel, which is deferred
+  //! until they are first used. See [ Lazy Module Loading ]
+  std::function<void(CompiledKernel&)> load_module;
+  std::once_flag load_module_once;
 };
 
-// Returns executable function and the ptxas log from compilation
-std::unique_ptr<CompiledKernel> getCompiledKernel(
+//! The function of a compiled kernel, loading its module if it is deferred
+CUfunction getFunction(CompiledKernel& compiled_kernel);
+
+// Returns executable function and the ptxas log from compilation. The
+// compiled kernel may be shared with other executors of the same code, see
+// [ Kernel Deduplication ]
+std::shared_ptr<CompiledKernel> getCompiledKernel(
     std::optional<std::reference_wrapper<const std::string>> kernel_code,
     const std::string& code,
     const std::string& func_name,
@@ -70,7 +91,21 @@ std::unique_ptr<CompiledKernel> getCompiledKernel(
     const CompileParams& compile_params = CompileParams(),
     std::optional<int64_t> opt_block_size = std::nullopt);
 
-// Returns executable function using flatbuffer object
+//! [ Versioned Kernel Entries ]
+//!
+//! Each serialized CudaKernel records the NVRTC version it was compiled
+//! with. A serialized FusionCache is loaded regardless of the CUDA version,
+//! and the binary of a kernel is only discarded when it can't be used:
+//!  - a cubin is kept for the same NVRTC major version, since the SASS of a
+//!    minor version runs on the drivers of the other minor versions,
+//!  - PTX is only kept for the same major and minor version, since the
+//!    driver may not know the ISA of a newer minor version,
+//!  - neither is kept if the compile args generated now differ.
+//! The FusionExecutor then compiles its serialized kernel code again, and
+//! reuses its lowering, heuristics and executor entries.
+
+// Returns executable function using flatbuffer object, or nullptr if the
+// serialized binary can't be used. See [ Versioned Kernel Entries ]
 std::unique_ptr<CompiledKernel> getCompiledKernel(
     const serde::CudaKernel* buffer,
     const CompileParams& compile_params);
@@ -249,6 +284,12 @@ void validateVectorizedTensors(
     caching::ExecutorCompileTimeInfoCache* data_cache,
     ExpressionEvaluator& expr_eval);
 
+//! Check that the input extents are divisible by the divisors the kernel is
+//! specialized for. See [ Size-Specialized Predicate Elimination ]
+void validateExtentDivisors(
+    kir::Kernel* kernel,
+    ExpressionEvaluator& expr_eval);
+
 //! Kernel timing utility
 //!
 //! Usage example:
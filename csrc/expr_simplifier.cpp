@@ -344,16 +344,26 @@ std::unordered_set<Val*> getSubexprDependency(
 
 // Apply `rule` to `value`, if `rule` returns a new `Val*` to replace `value`,
 // then return that new `Val*`, otherwise recursively goes down to its inputs.
-Val* recurseDown(Val* value, std::function<Val*(Val*)> rule) {
+// Subexpressions shared by multiple parents, which are common in indices, are
+// only visited once, and `memo` holds the results of the visited ones.
+Val* recurseDown(
+    Val* value,
+    const std::function<Val*(Val*)>& rule,
+    std::unordered_map<Val*, Val*>& memo) {
   if (value->isOneOf<TensorView, kir::TensorIndex>()) {
     return value;
   }
+  if (auto it = memo.find(value); it != memo.end()) {
+    return it->second;
+  }
   auto transformed = rule(value);
   if (transformed != value) {
+    memo.emplace(value, transformed);
     return transformed;
   }
   auto def = value->definition();
   if (def == nullptr) {
+    memo.emplace(value, value);
     return value;
   }
 
@@ -361,13 +371,14 @@ Val* recurseDown(Val* value, std::function<Val*(Val*)> rule) {
   std::vector<Val*> new_inputs;
   new_inputs.reserve(def->inputs().size());
   for (auto v : def->inputs()) {
-    new_inputs.emplace_back(recurseDown(v, rule));
+    new_inputs.emplace_back(recurseDown(v, rule, memo));
     if (new_inputs.back() != v) {
       changed = true;
     }
   }
 
   if (!changed) {
+    memo.emplace(value, value);
     return value;
   }
 
@@ -375,9 +386,15 @@ Val* recurseDown(Val* value, std::function<Val*(Val*)> rule) {
   auto create_fn = def->newObjectFunc();
   create_fn(
       def->container(), std::move(new_inputs), {output}, def->attributes());
+  memo.emplace(value, output);
   return output;
 }
 
+Val* recurseDown(Val* value, const std::function<Val*(Val*)>& rule) {
+  std::unordered_map<Val*, Val*> memo;
+  return recurseDown(value, rule, memo);
+}
+
 inline RegisterType promoteRegisterType(RegisterType t1, RegisterType t2) {
   if (t1 == RegisterType::Unknown) {
     return t2;
@@ -2763,4 +2780,80 @@ Val* simplifyExpr(
 
 #undef RUN_PASS
 
+std::optional<int64_t> getUpperBound(
+    Val* value,
+    const std::unordered_map<Val*, int64_t>& var_bounds) {
+  // Bounds beyond this are useless for choosing an index type and could
+  // overflow when combined
+  constexpr int64_t kMaxBound = (int64_t)1 << 40;
+  auto checked = [&](int64_t bound) -> std::optional<int64_t> {
+    if (bound < 0 || bound > kMaxBound) {
+      return std::nullopt;
+    }
+    return bound;
+  };
+
+  if (!value->isIntegralScalar()) {
+    return std::nullopt;
+  }
+  if (value->isConstInt()) {
+    return checked(value->evaluate().as<int64_t>());
+  }
+  if (auto it = var_bounds.find(value); it != var_bounds.end()) {
+    return checked(it->second);
+  }
+  if (isMagicZero(value)) {
+    return 0;
+  }
+  if (auto ns = dynamic_cast<NamedScalar*>(value); ns && ns->isThreadIdx()) {
+    // Blocks have at most 1024 threads and a z dimension of at most 64
+    return ns->getParallelIndex() == ParallelType::TIDz ? 63 : 1023;
+  }
+
+  auto def = value->definition();
+  if (auto uop = dynamic_cast<UnaryOp*>(def);
+      uop && uop->getUnaryOpType() == UnaryOpType::Cast) {
+    return getUpperBound(uop->in(), var_bounds);
+  }
+  auto bop = dynamic_cast<BinaryOp*>(def);
+  if (bop == nullptr) {
+    return std::nullopt;
+  }
+  auto lhs = getUpperBound(bop->lhs(), var_bounds);
+  if (!lhs.has_value()) {
+    return std::nullopt;
+  }
+  const bool rhs_is_positive_const =
+      bop->rhs()->isConstInt() && bop->rhs()->evaluate().as<int64_t>() > 0;
+  switch (bop->getBinaryOpType()) {
+    case BinaryOpType::Div:
+      if (rhs_is_positive_const) {
+        return *lhs / bop->rhs()->evaluate().as<int64_t>();
+      }
+      return std::nullopt;
+    case BinaryOpType::Mod:
+      if (rhs_is_positive_const) {
+        return std::min(*lhs, bop->rhs()->evaluate().as<int64_t>() - 1);
+      }
+      return std::nullopt;
+    default:
+      break;
+  }
+  auto rhs = getUpperBound(bop->rhs(), var_bounds);
+  if (!rhs.has_value()) {
+    return std::nullopt;
+  }
+  switch (bop->getBinaryOpType()) {
+    case BinaryOpType::Add:
+      return checked(*lhs + *rhs);
+    case BinaryOpType::Mul:
+      if (*lhs != 0 && *rhs > kMaxBound / *lhs) {
+        return std::nullopt;
+      }
+      return checked(*lhs * *rhs);
+    default:
+      return std::nullopt;
+  }
+}
+
 } // namespace nvfuser
@@ -10,6 +10,8 @@
 #include <exceptions.h>
 #include <ir/all_nodes.h>
 
+#include <optional>
+#include <unordered_map>
 #include <vector>
 
 // Note: [The Mathematics of Integer Arithmetic]
@@ -652,6 +654,16 @@ Val* simplifyExpr(
     std::vector<Val*> assumptions = {},
     bool preserve_error = false);
 
+// Range analysis of integer index math. Returns an upper bound of the given
+// scalar if it is provably non-negative and bounded, std::nullopt otherwise.
+// Non-negative constants are bounded by themselves, threadIdx by the maximum
+// block size and magic zero by 0. The bounds of other variables, e.g., loop
+// indices, are given by var_bounds. Bounds propagate through addition,
+// multiplication and division and modulo by positive constants.
+std::optional<int64_t> getUpperBound(
+    Val* value,
+    const std::unordered_map<Val*, int64_t>& var_bounds = {});
+
 class Context;
 namespace assoc_comm {
 // The expression type that represents the flattened ops. For example, if I have
@@ -71,8 +71,9 @@ IrCloner Fusion::copy(const Fusion* from, Fusion* to) {
   auto ir_cloner = IrContainer::copy(from, to);
 
   for (auto val : from->vals_) {
-    ir_cloner.clone(val)->setDefinition(ir_cloner.clone(val->definition_));
-    ir_cloner.clone(val)->setUses(ir_cloner.clone(val->uses_));
+    Val* val_clone = ir_cloner.clone(val);
+    val_clone->setDefinition(ir_cloner.clone(val->definition_));
+    val_clone->setUses(ir_cloner.clone(val->uses_));
   }
 
   to->inputs_ = ir_cloner.clone(from->inputs_);
@@ -117,11 +118,11 @@ IrCloner Fusion::copy(const Fusion* from, Fusion* to) {
   return ir_cloner;
 }
 
-// Clang tidy complains when using default constructor for IrContainer instead
-// of copy constructor. Fusion::copy has a call to IrContainer::copy, so it's
-// redundant to use the IrContainer copy constructor, but it is harmless since
-// Fusion::copy starts by calling clear().
-Fusion::Fusion(const Fusion& other) : IrContainer(other) {
+// Fusion::copy has a call to IrContainer::copy, so the IrContainer copy
+// constructor would clone every statement twice. Clang tidy complains when
+// using the default constructor for IrContainer instead.
+// NOLINTNEXTLINE(bugprone-copy-constructor-init)
+Fusion::Fusion(const Fusion& other) : IrContainer() {
   FUSER_PERF_SCOPE("Fusion copy");
   Fusion::copy(&other, this);
 }
@@ -419,7 +420,9 @@ void Fusion::printKernel(const CompileParams& compile_params) {
 }
 
 std::unordered_map<TensorView*, std::pair<std::vector<int>, std::vector<int>>>
-Fusion::bankConflictInfo(const CompileParams& compile_params) {
+Fusion::bankConflictInfo(
+    const CompileParams& compile_params,
+    const LaunchParams& launch_params) {
   std::vector<TensorView*> smem_tvs;
   for (auto v : usedMathVals()) {
     auto tv = dynamic_cast<TensorView*>(v);
@@ -438,7 +441,7 @@ Fusion::bankConflictInfo(const CompileParams& compile_params) {
   GpuLower lower(this, compile_params);
   lower.run();
   auto kernel = lower.kernel();
-  auto info = getBankConflictInfo(kernel);
+  auto info = getBankConflictInfo(kernel, launch_params);
 
   // Convert TVs in kernel to TVs in fusion
   auto smem_tvs_in_kernel =
@@ -181,9 +181,12 @@ class Fusion : public IrContainer {
   //! Lower the fusion and evaluate bank conflict info
   //! Returns (tensor, read conflict ways, write conflict ways)
   //! Each tensor can be read/write by multiple expressions, so the ways are
-  //! vectors.
+  //! vectors. Block dimensions that can't be inferred from the fusion can be
+  //! given with launch_params.
   std::unordered_map<TensorView*, std::pair<std::vector<int>, std::vector<int>>>
-  bankConflictInfo(const CompileParams& compile_params = CompileParams());
+  bankConflictInfo(
+      const CompileParams& compile_params = CompileParams(),
+      const LaunchParams& launch_params = LaunchParams());
 
   //! Return a list of topologically sorted expressions. This only includes
   //! exprs required to genereate registered outputs.
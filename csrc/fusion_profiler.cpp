@@ -7,6 +7,17 @@
 // clang-format on
 #include <cupti.h>
 #include <fusion_profiler.h>
+
+#if __has_include(<cupti_range_profiler.h>)
+#include <cupti_profiler_host.h>
+#include <cupti_profiler_target.h>
+#include <cupti_range_profiler.h>
+#include <cupti_target.h>
+#define NVFUSER_CUPTI_RANGE_PROFILER
+#endif
+
+#include <algorithm>
+#include <array>
 #include <iomanip>
 
 namespace nvfuser {
@@ -179,6 +190,331 @@ const char* profiler_state2string(const ProfilerState& pstate) {
 
 } // namespace
 
+//! [ Kernel Metrics ]
+//!
+//! With NVFUSER_PROF=metrics, each kernel launched while a fusion is profiled
+//! is also measured by the CUPTI Range Profiler. The profiler runs in auto
+//! range mode, so each kernel is a range, and in kernel replay mode, so each
+//! kernel is replayed as many times as its metrics need passes. Its memory is
+//! saved and restored around the replays, which keeps the results intact but
+//! inflates the host and CUDA event times of the run. The metrics are those
+//! of kKernelMetrics. They are evaluated when the profiler stops and
+//! attached to the KernelProfile of each segment, matched by kernel name, and
+//! printed as extra columns with NVFUSER_PROF=print.verbose.
+//!
+//! The Range Profiler is available from CUPTI 12.6, and collecting hardware
+//! counters may require the permission of the driver. Without them, a
+//! warning is printed and the kernel profiles have no metrics.
+
+namespace {
+
+struct KernelMetricName {
+  const char* name;
+  double KernelMetrics::*field;
+};
+
+const std::array<KernelMetricName, 10> kKernelMetrics{{
+    {"dram__bytes_read.sum", &KernelMetrics::dram_read_bytes},
+    {"dram__bytes_write.sum", &KernelMetrics::dram_write_bytes},
+    {"dram__throughput.avg.pct_of_peak_sustained_elapsed",
+     &KernelMetrics::dram_throughput_pct},
+    {"lts__t_sector_hit_rate.pct", &KernelMetrics::l2_hit_rate_pct},
+    {"sm__warps_active.avg.pct_of_peak_sustained_active",
+     &KernelMetrics::achieved_occupancy_pct},
+    {"smsp__average_warps_issue_stalled_long_scoreboard_per_issue_active.ratio",
+     &KernelMetrics::stall_long_scoreboard},
+    {"smsp__average_warps_issue_stalled_barrier_per_issue_active.ratio",
+     &KernelMetrics::stall_barrier},
+    {"smsp__average_warps_issue_stalled_mio_throttle_per_issue_active.ratio",
+     &KernelMetrics::stall_mio_throttle},
+    {"smsp__average_warps_issue_stalled_short_scoreboard_per_issue_active.ratio",
+     &KernelMetrics::stall_short_scoreboard},
+    {"l1tex__data_bank_conflicts_pipe_lsu_mem_shared.sum",
+     &KernelMetrics::smem_bank_conflicts},
+}};
+
+//! The nvfuser_* name of a possibly mangled kernel name
+std::string trimKernelName(const char* name) {
+  std::string trimmed = demangle(name);
+  size_t start = trimmed.find("nvfuser");
+  if (start != std::string::npos) {
+    size_t end = trimmed.find('(', start);
+    trimmed = trimmed.substr(start, end - start);
+  }
+  return trimmed;
+}
+
+//! Warns about a failed call of the Range Profiler, which disables the
+//! collection of metrics rather than the profiler
+bool cuptiSucceeded(CUptiResult status, const char* call) {
+  if (status == CUPTI_SUCCESS) {
+    return true;
+  }
+  const char* error_string = nullptr;
+  cuptiGetResultString(status, &error_string);
+  TORCH_WARN(
+      "Disabling the collection of kernel metrics because ",
+      call,
+      " failed: ",
+      error_string);
+  return false;
+}
+
+#define NVFUSER_CUPTI_METRICS_CALL(x) \
+  if (!cuptiSucceeded(x, #x)) {       \
+    return false;                     \
+  }
+
+} // namespace
+
+class KernelMetricsCollector {
+ public:
+  ~KernelMetricsCollector() {
+#ifdef NVFUSER_CUPTI_RANGE_PROFILER
+    if (host_object_ != nullptr) {
+      CUpti_Profiler_Host_Deinitialize_Params params = {
+          CUpti_Profiler_Host_Deinitialize_Params_STRUCT_SIZE};
+      params.pHostObject = host_object_;
+      cuptiProfilerHostDeinitialize(&params);
+    }
+#endif
+  }
+
+  //! Starts measuring the kernels launched in the current context on device
+  void start(int device) {
+    if (disabled_) {
+      return;
+    }
+    disabled_ = !((device_ == device || initialize(device)) && enable());
+  }
+
+  //! The metrics of each kernel launched since start, by name
+  std::unordered_map<std::string, KernelMetrics> stop() {
+    std::unordered_map<std::string, KernelMetrics> metrics;
+    if (!disabled_ && range_profiler_ != nullptr) {
+      disabled_ = !collect(metrics);
+      disable();
+    }
+    return metrics;
+  }
+
+ private:
+#ifdef NVFUSER_CUPTI_RANGE_PROFILER
+  // At most this many kernels of a run are measured
+  static constexpr size_t kMaxRanges = 256;
+
+  std::vector<const char*> metricNames() const {
+    std::vector<const char*> names;
+    for (const auto& metric : kKernelMetrics) {
+      names.push_back(metric.name);
+    }
+    return names;
+  }
+
+  //! Creates the configuration of the metrics for the chip of device
+  bool initialize(int device) {
+    CUpti_Profiler_Initialize_Params init_params = {
+        CUpti_Profiler_Initialize_Params_STRUCT_SIZE};
+    NVFUSER_CUPTI_METRICS_CALL(cuptiProfilerInitialize(&init_params));
+
+    CUpti_Device_GetChipName_Params chip_params = {
+        CUpti_Device_GetChipName_Params_STRUCT_SIZE};
+    chip_params.deviceIndex = (size_t)device;
+    NVFUSER_CUPTI_METRICS_CALL(cuptiDeviceGetChipName(&chip_params));
+
+    CUcontext ctx = nullptr;
+    NVFUSER_CUDA_SAFE_CALL(cuCtxGetCurrent(&ctx));
+    CUpti_RangeProfiler_GetCounterAvailability_Params availability_params = {
+        CUpti_RangeProfiler_GetCounterAvailability_Params_STRUCT_SIZE};
+    availability_params.ctx = ctx;
+    NVFUSER_CUPTI_METRICS_CALL(
+        cuptiRangeProfilerGetCounterAvailability(&availability_params));
+    std::vector<uint8_t> availability(
+        availability_params.counterAvailabilityImageSize);
+    availability_params.pCounterAvailabilityImage = availability.data();
+    NVFUSER_CUPTI_METRICS_CALL(
+        cuptiRangeProfilerGetCounterAvailability(&availability_params));
+
+    CUpti_Profiler_Host_Initialize_Params host_params = {
+        CUpti_Profiler_Host_Initialize_Params_STRUCT_SIZE};
+    host_params.profilerType = CUPTI_PROFILER_TYPE_RANGE_PROFILER;
+    host_params.pChipName = chip_params.pChipName;
+    host_params.pCounterAvailabilityImage = availability.data();
+    NVFUSER_CUPTI_METRICS_CALL(cuptiProfilerHostInitialize(&host_params));
+    host_object_ = host_params.pHostObject;
+
+    std::vector<const char*> names = metricNames();
+    CUpti_Profiler_Host_ConfigAddMetrics_Params add_params = {
+        CUpti_Profiler_Host_ConfigAddMetrics_Params_STRUCT_SIZE};
+    add_params.pHostObject = host_object_;
+    add_params.ppMetricNames = names.data();
+    add_params.numMetrics = names.size();
+    NVFUSER_CUPTI_METRICS_CALL(cuptiProfilerHostConfigAddMetrics(&add_params));
+
+    CUpti_Profiler_Host_GetConfigImageSize_Params size_params = {
+        CUpti_Profiler_Host_GetConfigImageSize_Params_STRUCT_SIZE};
+    size_params.pHostObject = host_object_;
+    NVFUSER_CUPTI_METRICS_CALL(
+        cuptiProfilerHostGetConfigImageSize(&size_params));
+    config_image_.resize(size_params.configImageSize);
+
+    CUpti_Profiler_Host_GetConfigImage_Params image_params = {
+        CUpti_Profiler_Host_GetConfigImage_Params_STRUCT_SIZE};
+    image_params.pHostObject = host_object_;
+    image_params.configImageSize = config_image_.size();
+    image_params.pConfigImage = config_image_.data();
+    NVFUSER_CUPTI_METRICS_CALL(cuptiProfilerHostGetConfigImage(&image_params));
+
+    device_ = device;
+    return true;
+  }
+
+  //! Enables the Range Profiler in the current context with a new counter
+  //! data image
+  bool enable() {
+    CUcontext ctx = nullptr;
+    NVFUSER_CUDA_SAFE_CALL(cuCtxGetCurrent(&ctx));
+    CUpti_RangeProfiler_Enable_Params enable_params = {
+        CUpti_RangeProfiler_Enable_Params_STRUCT_SIZE};
+    enable_params.ctx = ctx;
+    NVFUSER_CUPTI_METRICS_CALL(cuptiRangeProfilerEnable(&enable_params));
+    range_profiler_ = enable_params.pRangeProfilerObject;
+
+    std::vector<const char*> names = metricNames();
+    CUpti_RangeProfiler_GetCounterDataSize_Params size_params = {
+        CUpti_RangeProfiler_GetCounterDataSize_Params_STRUCT_SIZE};
+    size_params.pRangeProfilerObject = range_profiler_;
+    size_params.pMetricNames = names.data();
+    size_params.numMetrics = names.size();
+    size_params.maxNumOfRanges = kMaxRanges;
+    size_params.maxNumRangeTreeNodes = kMaxRanges;
+    NVFUSER_CUPTI_METRICS_CALL(
+        cuptiRangeProfilerGetCounterDataSize(&size_params));
+    counter_data_.assign(size_params.counterDataSize, 0);
+
+    CUpti_RangeProfiler_CounterDataImage_Initialize_Params image_params = {
+        CUpti_RangeProfiler_CounterDataImage_Initialize_Params_STRUCT_SIZE};
+    image_params.pRangeProfilerObject = range_profiler_;
+    image_params.counterDataSize = counter_data_.size();
+    image_params.pCounterData = counter_data_.data();
+    NVFUSER_CUPTI_METRICS_CALL(
+        cuptiRangeProfilerCounterDataImageInitialize(&image_params));
+
+    CUpti_RangeProfiler_SetConfig_Params config_params = {
+        CUpti_RangeProfiler_SetConfig_Params_STRUCT_SIZE};
+    config_params.pRangeProfilerObject = range_profiler_;
+    config_params.configSize = config_image_.size();
+    config_params.pConfig = config_image_.data();
+    config_params.counterDataImageSize = counter_data_.size();
+    config_params.pCounterDataImage = counter_data_.data();
+    config_params.range = CUPTI_AutoRange;
+    config_params.replayMode = CUPTI_KernelReplay;
+    config_params.maxRangesPerPass = kMaxRanges;
+    config_params.numNestingLevels = 1;
+    config_params.minNestingLevel = 1;
+    config_params.passIndex = 0;
+    config_params.targetNestingLevel = 1;
+    NVFUSER_CUPTI_METRICS_CALL(cuptiRangeProfilerSetConfig(&config_params));
+
+    CUpti_RangeProfiler_Start_Params start_params = {
+        CUpti_RangeProfiler_Start_Params_STRUCT_SIZE};
+    start_params.pRangeProfilerObject = range_profiler_;
+    NVFUSER_CUPTI_METRICS_CALL(cuptiRangeProfilerStart(&start_params));
+    return true;
+  }
+
+  //! Stops the Range Profiler and evaluates the metrics of its ranges
+  bool collect(std::unordered_map<std::string, KernelMetrics>& metrics) {
+    CUpti_RangeProfiler_Stop_Params stop_params = {
+        CUpti_RangeProfiler_Stop_Params_STRUCT_SIZE};
+    stop_params.pRangeProfilerObject = range_profiler_;
+    NVFUSER_CUPTI_METRICS_CALL(cuptiRangeProfilerStop(&stop_params));
+
+    CUpti_RangeProfiler_DecodeData_Params decode_params = {
+        CUpti_RangeProfiler_DecodeData_Params_STRUCT_SIZE};
+    decode_params.pRangeProfilerObject = range_profiler_;
+    NVFUSER_CUPTI_METRICS_CALL(cuptiRangeProfilerDecodeData(&decode_params));
+
+    CUpti_RangeProfiler_GetCounterDataInfo_Params info_params = {
+        CUpti_RangeProfiler_GetCounterDataInfo_Params_STRUCT_SIZE};
+    info_params.pCounterDataImage = counter_data_.data();
+    info_params.counterDataImageSize = counter_data_.size();
+    NVFUSER_CUPTI_METRICS_CALL(
+        cuptiRangeProfilerGetCounterDataInfo(&info_params));
+
+    std::vector<const char*> names = metricNames();
+    std::vector<double> values(names.size());
+    for (size_t range = 0; range < info_params.numTotalRanges; ++range) {
+      CUpti_RangeProfiler_CounterData_GetRangeInfo_Params range_params = {
+          CUpti_RangeProfiler_CounterData_GetRangeInfo_Params_STRUCT_SIZE};
+      range_params.pCounterDataImage = counter_data_.data();
+      range_params.counterDataImageSize = counter_data_.size();
+      range_params.rangeIndex = range;
+      range_params.rangeDelimiter = "/";
+      NVFUSER_CUPTI_METRICS_CALL(
+          cuptiRangeProfilerCounterDataGetRangeInfo(&range_params));
+
+      CUpti_Profiler_Host_EvaluateToGpuValues_Params eval_params = {
+          CUpti_Profiler_Host_EvaluateToGpuValues_Params_STRUCT_SIZE};
+      eval_params.pHostObject = host_object_;
+      eval_params.pCounterDataImage = counter_data_.data();
+      eval_params.counterDataImageSize = counter_data_.size();
+      eval_params.rangeIndex = range;
+      eval_params.ppMetricNames = names.data();
+      eval_params.numMetrics = names.size();
+      eval_params.pMetricValues = values.data();
+      NVFUSER_CUPTI_METRICS_CALL(
+          cuptiProfilerHostEvaluateToGpuValues(&eval_params));
+
+      KernelMetrics& kernel_metrics =
+          metrics[trimKernelName(range_params.rangeName)];
+      for (size_t i = 0; i < kKernelMetrics.size(); ++i) {
+        kernel_metrics.*(kKernelMetrics.at(i).field) = values.at(i);
+      }
+    }
+    return true;
+  }
+
+  void disable() {
+    CUpti_RangeProfiler_Disable_Params params = {
+        CUpti_RangeProfiler_Disable_Params_STRUCT_SIZE};
+    params.pRangeProfilerObject = range_profiler_;
+    cuptiSucceeded(
+        cuptiRangeProfilerDisable(&params), "cuptiRangeProfilerDisable");
+    range_profiler_ = nullptr;
+  }
+
+  CUpti_Profiler_Host_Object* host_object_ = nullptr;
+  CUpti_RangeProfiler_Object* range_profiler_ = nullptr;
+#else
+  bool initialize(int device) {
+    TORCH_WARN(
+        "Kernel metrics need the CUPTI Range Profiler, which this build of "
+        "nvFuser doesn't have");
+    return false;
+  }
+
+  bool enable() {
+    return false;
+  }
+
+  bool collect(std::unordered_map<std::string, KernelMetrics>& metrics) {
+    return false;
+  }
+
+  void disable() {}
+
+  void* range_profiler_ = nullptr;
+#endif
+
+  bool disabled_ = false;
+  int device_ = -1;
+  std::vector<uint8_t> config_image_;
+  std::vector<uint8_t> counter_data_;
+};
+
+#undef NVFUSER_CUPTI_METRICS_CALL
+
 std::ostream& operator<<(std::ostream& out, const ProfilerState& pstate) {
   return out << profiler_state2string(pstate);
 }
@@ -315,6 +651,21 @@ void DeviceDescriptor::generate(DeviceDescriptor& desc, int device) {
       static_cast<double>(desc.bus_width);
 }
 
+double& SegmentHostProfile::phaseTime(SegmentHostPhase phase) {
+  switch (phase) {
+    case SegmentHostPhase::ExecutorEntryLookup:
+      return executor_entry_lookup_time_ms;
+    case SegmentHostPhase::ArgumentBinding:
+      return argument_binding_time_ms;
+    case SegmentHostPhase::Allocation:
+      return allocation_time_ms;
+    case SegmentHostPhase::KernelLaunch:
+      return kernel_launch_time_ms;
+    default:
+      NVF_ERROR(false, "Unexpected SegmentHostPhase enum value!");
+  }
+}
+
 SegmentProfiler::SegmentProfiler(uint32_t id, bool cupti_disabled)
     : cupti_disabled_(cupti_disabled),
       device_(-1),
@@ -322,7 +673,12 @@ SegmentProfiler::SegmentProfiler(uint32_t id, bool cupti_disabled)
       compile_timer_(),
       input_bytes_(0),
       output_bytes_(0),
-      kernel_profile_state_(ProfilerState::Ready) {}
+      modeled_load_bytes_(0),
+      modeled_store_bytes_(0),
+      kernel_profile_state_(ProfilerState::Ready),
+      host_timer_(),
+      host_phase_timer_(),
+      host_profile_() {}
 
 void SegmentProfiler::startCompile(int device) {
   device_ = device;
@@ -339,6 +695,7 @@ void SegmentProfiler::startKernel(int device) {
       kernel_profile_state_ == ProfilerState::Ready,
       "ProfilerState is not Ready!",
       kernel_profile_state_);
+  host_timer_.start();
   if (!cupti_disabled_) {
     NVFUSER_CUPTI_SAFE_CALL(cuptiActivityPushExternalCorrelationId(
         CUPTI_EXTERNAL_CORRELATION_KIND_UNKNOWN,
@@ -363,9 +720,25 @@ void SegmentProfiler::stopKernel() {
         " Segment Id: ",
         segment_id_);
   }
+  host_timer_.stop();
+  host_profile_.host_time_ms = host_timer_.time();
   kernel_profile_state_ = ProfilerState::Finished;
 }
 
+void SegmentProfiler::startHostPhase(SegmentHostPhase phase) {
+  NVF_CHECK(
+      kernel_profile_state_ == ProfilerState::Running,
+      "ProfilerState is not Running!",
+      kernel_profile_state_);
+  host_phase_timer_.start();
+}
+
+void SegmentProfiler::stopHostPhase(SegmentHostPhase phase) {
+  host_phase_timer_.stop();
+  host_profile_.phaseTime(phase) += host_phase_timer_.time();
+  host_phase_timer_.reset();
+}
+
 void SegmentProfiler::inputBytesAccessed(int64_t bytes) {
   input_bytes_ = bytes;
 }
@@ -374,6 +747,13 @@ void SegmentProfiler::outputBytesAccessed(int64_t bytes) {
   output_bytes_ = bytes;
 }
 
+void SegmentProfiler::modeledBytesAccessed(
+    int64_t load_bytes,
+    int64_t store_bytes) {
+  modeled_load_bytes_ = load_bytes;
+  modeled_store_bytes_ = store_bytes;
+}
+
 uint32_t SegmentProfiler::segmentId() const {
   return segment_id_;
 }
@@ -387,6 +767,10 @@ void FusionProfile::reset() {
   compile_time_ms = 0.0;
   kernel_time_ms = 0.0;
 
+  input_encoding_time_ms = 0.0;
+  runtime_lookup_time_ms = 0.0;
+  segment_host_time_ms = 0.0;
+
   input_bytes = 0;
   output_bytes = 0;
 
@@ -394,55 +778,95 @@ void FusionProfile::reset() {
   percentage_peak_bandwidth = 0.0;
 
   kernel_profiles.clear();
+  segment_host_profiles.clear();
 }
 
-std::array<const char*, 25> column_strs{
-    "Fus#",      "NSegs",       "CuEvtTm(ms)",  "HstTm(ms)",
-    "CmpTm(ms)", "KerTm(ms)",   "EffBw(GB/s)",  "%PeakBw",
-    "S-Seg#",    "S-KerTm(ms)", "S-CmpTm(ms)",  "S-EffBw(GB/s)",
-    "S-%PeakBw", "S-In(MB)",    "S-Out(MB)",    "S-Smem[Dyn,Stat]",
-    "S-Regs",    "S-Grid",      "S-Block",      "S-Cluster",
-    "S-Dev",     "S-Stm",       "S-PkBw(GB/s)", "S-DeviceName",
+std::array<const char*, 45> column_strs{
+    "Fus#",         "NSegs",         "CuEvtTm(ms)",  "HstTm(ms)",
+    "CmpTm(ms)",    "EncTm(ms)",     "LkupTm(ms)",   "SegHstTm(ms)",
+    "KerTm(ms)",    "EffBw(GB/s)",   "%PeakBw",      "S-Seg#",
+    "S-KerTm(ms)",  "S-CmpTm(ms)",   "S-HstTm(ms)",  "S-LkupTm(ms)",
+    "S-BindTm(ms)", "S-AllocTm(ms)", "S-LnchTm(ms)", "S-EffBw(GB/s)",
+    "S-%PeakBw",    "S-In(MB)",      "S-Out(MB)",    "S-Smem[Dyn,Stat]",
+    "S-Regs",       "S-Grid",        "S-Block",      "S-Cluster",
+    "S-Dev",        "S-Stm",         "S-PkBw(GB/s)", "S-DeviceName",
+    "S-MdlLd(MB)",  "S-MdlSt(MB)",   "S-DramRd(MB)", "S-DramWr(MB)",
+    "S-Dram%",      "S-L2Hit%",      "S-Occ%",       "S-StlLS",
+    "S-StlBar",     "S-StlMIO",      "S-StlSS",      "S-BankConf",
     "S-KerName"};
 
 std::ostream& operator<<(std::ostream& os, const FusionProfile& fp) {
+  // The columns of [ Kernel Metrics ]
+  const bool print_metrics = fp.verbose &&
+      std::any_of(fp.kernel_profiles.begin(),
+                  fp.kernel_profiles.end(),
+                  [](const KernelProfile& kp) {
+                    return kp.metrics.has_value();
+                  });
   if (fp.fusion_id == 0) {
     os << std::left << std::setw(5) << std::get<0>(column_strs) << " "
        << std::setw(5) << std::get<1>(column_strs) << " " << std::setw(11)
        << std::get<2>(column_strs) << " " << std::setw(9)
        << std::get<3>(column_strs) << " " << std::setw(9)
-       << std::get<4>(column_strs);
+       << std::get<4>(column_strs) << " " << std::setw(9)
+       << std::get<5>(column_strs) << " " << std::setw(10)
+       << std::get<6>(column_strs) << " " << std::setw(12)
+       << std::get<7>(column_strs);
 
     if (!fp.kernel_profiles.empty()) {
-      os << " " << std::setw(9) << std::get<5>(column_strs) << " "
-         << std::setw(11) << std::get<6>(column_strs) << " " << std::setw(9)
-         << std::get<7>(column_strs);
+      os << " " << std::setw(9) << std::get<8>(column_strs) << " "
+         << std::setw(11) << std::get<9>(column_strs) << " " << std::setw(9)
+         << std::get<10>(column_strs);
 
-      os << " " << std::setw(6) << std::get<8>(column_strs) << " "
-         << std::setw(9) << std::get<9>(column_strs);
+      os << " " << std::setw(6) << std::get<11>(column_strs) << " "
+         << std::setw(9) << std::get<12>(column_strs);
 
       if (fp.verbose) {
-        os << " " << std::setw(11) << std::get<10>(column_strs);
+        os << " " << std::setw(11) << std::get<13>(column_strs);
       }
 
-      os << " " << std::setw(13) << std::get<11>(column_strs) << " "
-         << std::setw(9) << std::get<12>(column_strs) << " " << std::setw(9)
-         << std::get<13>(column_strs) << " " << std::setw(9)
-         << std::get<14>(column_strs) << " " << std::setw(16)
-         << std::get<15>(column_strs) << " " << std::setw(6)
-         << std::get<16>(column_strs) << " " << std::setw(16)
-         << std::get<17>(column_strs) << " " << std::setw(16)
-         << std::get<18>(column_strs);
+      os << " " << std::setw(11) << std::get<14>(column_strs);
 
       if (fp.verbose) {
-        os << " " << std::setw(16) << std::get<19>(column_strs) << " "
-           << std::setw(5) << std::get<20>(column_strs) << " " << std::setw(5)
-           << std::get<21>(column_strs) << " " << std::setw(12)
-           << std::get<22>(column_strs) << " " << std::setw(20)
-           << std::get<23>(column_strs);
+        os << " " << std::setw(12) << std::get<15>(column_strs) << " "
+           << std::setw(12) << std::get<16>(column_strs) << " "
+           << std::setw(13) << std::get<17>(column_strs) << " "
+           << std::setw(12) << std::get<18>(column_strs);
       }
 
-      os << " " << std::setw(20) << std::get<24>(column_strs);
+      os << " " << std::setw(13) << std::get<19>(column_strs) << " "
+         << std::setw(9) << std::get<20>(column_strs) << " " << std::setw(9)
+         << std::get<21>(column_strs) << " " << std::setw(9)
+         << std::get<22>(column_strs) << " " << std::setw(16)
+         << std::get<23>(column_strs) << " " << std::setw(6)
+         << std::get<24>(column_strs) << " " << std::setw(16)
+         << std::get<25>(column_strs) << " " << std::setw(16)
+         << std::get<26>(column_strs);
+
+      if (fp.verbose) {
+        os << " " << std::setw(16) << std::get<27>(column_strs) << " "
+           << std::setw(5) << std::get<28>(column_strs) << " " << std::setw(5)
+           << std::get<29>(column_strs) << " " << std::setw(12)
+           << std::get<30>(column_strs) << " " << std::setw(20)
+           << std::get<31>(column_strs) << " " << std::setw(11)
+           << std::get<32>(column_strs) << " " << std::setw(11)
+           << std::get<33>(column_strs);
+      }
+
+      if (print_metrics) {
+        os << " " << std::setw(12) << std::get<34>(column_strs) << " "
+           << std::setw(12) << std::get<35>(column_strs) << " "
+           << std::setw(8) << std::get<36>(column_strs) << " " << std::setw(8)
+           << std::get<37>(column_strs) << " " << std::setw(8)
+           << std::get<38>(column_strs) << " " << std::setw(8)
+           << std::get<39>(column_strs) << " " << std::setw(8)
+           << std::get<40>(column_strs) << " " << std::setw(8)
+           << std::get<41>(column_strs) << " " << std::setw(8)
+           << std::get<42>(column_strs) << " " << std::setw(10)
+           << std::get<43>(column_strs);
+      }
+
+      os << " " << std::setw(20) << std::get<44>(column_strs);
     }
 
     os << std::endl;
@@ -453,8 +877,11 @@ std::ostream& operator<<(std::ostream& os, const FusionProfile& fp) {
        << fp.fusion_id << " " << std::setw(5) << fp.segments << " "
        << std::setw(11) << std::setprecision(3) << fp.cuda_evt_time_ms << " "
        << std::setw(9) << std::setprecision(3) << fp.host_time_ms << " "
-       << std::setw(9) << std::setprecision(3) << fp.compile_time_ms
-       << std::endl;
+       << std::setw(9) << std::setprecision(3) << fp.compile_time_ms << " "
+       << std::setw(9) << std::setprecision(3) << fp.input_encoding_time_ms
+       << " " << std::setw(10) << std::setprecision(3)
+       << fp.runtime_lookup_time_ms << " " << std::setw(12)
+       << std::setprecision(3) << fp.segment_host_time_ms << std::endl;
   } else {
     bool first_prof = true;
     int idx = 0;
@@ -465,6 +892,10 @@ std::ostream& operator<<(std::ostream& os, const FusionProfile& fp) {
            << std::setw(11) << std::setprecision(3) << fp.cuda_evt_time_ms
            << " " << std::setw(9) << std::setprecision(3) << fp.host_time_ms
            << " " << std::setw(9) << std::setprecision(3) << fp.compile_time_ms
+           << " " << std::setw(9) << std::setprecision(3)
+           << fp.input_encoding_time_ms << " " << std::setw(10)
+           << std::setprecision(3) << fp.runtime_lookup_time_ms << " "
+           << std::setw(12) << std::setprecision(3) << fp.segment_host_time_ms
            << " " << std::setw(9) << std::setprecision(3) << fp.kernel_time_ms
            << " " << std::setw(11) << std::setprecision(2)
            << fp.effective_bandwidth_gbs << " " << std::setw(9)
@@ -478,6 +909,9 @@ std::ostream& operator<<(std::ostream& os, const FusionProfile& fp) {
            << " " << std::setw(9) << "-"
            << " " << std::setw(9) << "-"
            << " " << std::setw(9) << "-"
+           << " " << std::setw(10) << "-"
+           << " " << std::setw(12) << "-"
+           << " " << std::setw(9) << "-"
            << " " << std::setw(11) << "-"
            << " " << std::setw(9) << "-";
       }
@@ -494,6 +928,10 @@ std::ostream& operator<<(std::ostream& os, const FusionProfile& fp) {
       std::stringstream smem;
       smem << "[" << kp.dynamic_shared_mem << ", " << kp.static_shared_mem
            << "]";
+      const SegmentHostProfile host_prof =
+          (size_t)idx < fp.segment_host_profiles.size()
+          ? fp.segment_host_profiles.at(idx)
+          : SegmentHostProfile();
       os << std::setfill(' ') << std::right << std::fixed << " " << std::setw(6)
          << idx << " " << std::setw(11) << std::setprecision(3) << kp.time_ms;
 
@@ -502,6 +940,18 @@ std::ostream& operator<<(std::ostream& os, const FusionProfile& fp) {
            << kp.compile_time_ms;
       }
 
+      os << " " << std::setw(11) << std::setprecision(3)
+         << host_prof.host_time_ms;
+
+      if (fp.verbose) {
+        os << " " << std::setw(12) << std::setprecision(3)
+           << host_prof.executor_entry_lookup_time_ms << " " << std::setw(12)
+           << std::setprecision(3) << host_prof.argument_binding_time_ms
+           << " " << std::setw(13) << std::setprecision(3)
+           << host_prof.allocation_time_ms << " " << std::setw(12)
+           << std::setprecision(3) << host_prof.kernel_launch_time_ms;
+      }
+
       os << " " << std::setw(13) << std::setprecision(2)
          << kp.effective_bandwidth_gbs << " " << std::setw(9)
          << std::setprecision(2) << kp.percentage_peak_bandwidth << " "
@@ -515,7 +965,38 @@ std::ostream& operator<<(std::ostream& os, const FusionProfile& fp) {
         os << " " << std::setw(16) << cluster.str() << " " << std::setw(5)
            << kp.device << " " << std::setw(5) << kp.stream << " "
            << std::setw(12) << std::setprecision(2) << kp.peak_bandwidth_gbs
-           << " " << std::setw(20) << kp.device_name;
+           << " " << std::setw(20) << kp.device_name << " " << std::setw(11)
+           << std::setprecision(3)
+           << ((double)kp.modeled_load_bytes / 1000000.0) << " "
+           << std::setw(11) << std::setprecision(3)
+           << ((double)kp.modeled_store_bytes / 1000000.0);
+      }
+      if (print_metrics) {
+        if (kp.metrics.has_value()) {
+          const KernelMetrics& km = kp.metrics.value();
+          os << " " << std::setw(12) << std::setprecision(3)
+             << (km.dram_read_bytes / 1000000.0) << " " << std::setw(12)
+             << std::setprecision(3) << (km.dram_write_bytes / 1000000.0)
+             << " " << std::setw(8) << std::setprecision(2)
+             << km.dram_throughput_pct << " " << std::setw(8)
+             << std::setprecision(2) << km.l2_hit_rate_pct << " "
+             << std::setw(8) << std::setprecision(2)
+             << km.achieved_occupancy_pct << " " << std::setw(8)
+             << std::setprecision(2) << km.stall_long_scoreboard << " "
+             << std::setw(8) << std::setprecision(2) << km.stall_barrier
+             << " " << std::setw(8) << std::setprecision(2)
+             << km.stall_mio_throttle << " " << std::setw(8)
+             << std::setprecision(2) << km.stall_short_scoreboard << " "
+             << std::setw(10) << std::setprecision(0)
+             << km.smem_bank_conflicts;
+        } else {
+          os << " " << std::setw(12) << "-"
+             << " " << std::setw(12) << "-";
+          for (int i = 0; i < 7; ++i) {
+            os << " " << std::setw(8) << "-";
+          }
+          os << " " << std::setw(10) << "-";
+        }
       }
       os << " " << std::setw(20) << kp.name;
       os << std::endl;
@@ -527,6 +1008,7 @@ std::ostream& operator<<(std::ostream& os, const FusionProfile& fp) {
 
 FusionProfiler::FusionProfiler()
     : cupti_disabled_(false),
+      metrics_collector_(),
       cupti_buffer_(FusionProfiler::cupti_activity_buffer_size),
       state_(ProfilerState::Ready),
       fusion_id_(-1),
@@ -534,6 +1016,8 @@ FusionProfiler::FusionProfiler()
       fusion_timer_(at::cuda::getCurrentCUDAStream()),
       host_timer_(),
       compile_timer_(),
+      input_encoding_timer_(),
+      runtime_lookup_timer_(),
       segments_(),
       device_descriptors_(),
       kernel_profiles_(),
@@ -564,6 +1048,8 @@ void FusionProfiler::reset() {
   fp->fusion_timer_.reset();
   fp->host_timer_.reset();
   fp->compile_timer_.reset();
+  fp->input_encoding_timer_.reset();
+  fp->runtime_lookup_timer_.reset();
   fp->segments_.clear();
   fp->kernel_profiles_.clear();
   fp->corrid_2_segid_.clear();
@@ -588,6 +1074,18 @@ SegmentProfiler& FusionProfiler::segment(size_t idx) {
   return get()->segments_.at(idx);
 }
 
+SegmentProfiler* FusionProfiler::runningSegment() {
+  FusionProfiler* fp = get();
+  if (fp->state_ != ProfilerState::Running) {
+    return nullptr;
+  }
+  auto it = std::find_if(
+      fp->segments_.begin(), fp->segments_.end(), [](const auto& seg) {
+        return seg.state() == ProfilerState::Running;
+      });
+  return it == fp->segments_.end() ? nullptr : &(*it);
+}
+
 void FusionProfiler::start(bool cupti_disable) {
   FusionProfiler* fp = get();
   fp->cupti_disabled_ = cupti_disable;
@@ -598,6 +1096,12 @@ void FusionProfiler::start(bool cupti_disable) {
     NVFUSER_CUPTI_SAFE_CALL(cuptiActivityEnable(CUPTI_ACTIVITY_KIND_DRIVER));
     NVFUSER_CUPTI_SAFE_CALL(
         cuptiActivityEnable(CUPTI_ACTIVITY_KIND_EXTERNAL_CORRELATION));
+    if (isProfilerCollectingMetrics()) {
+      if (fp->metrics_collector_ == nullptr) {
+        fp->metrics_collector_ = std::make_unique<KernelMetricsCollector>();
+      }
+      fp->metrics_collector_->start(c10::cuda::current_device());
+    }
   }
   cudaDeviceSynchronize();
   fp->fusion_timer_.start();
@@ -633,6 +1137,11 @@ void FusionProfiler::stop() {
 
     NVFUSER_CUPTI_SAFE_CALL(cuptiActivityFlushAll(0));
 
+    std::unordered_map<std::string, KernelMetrics> metrics;
+    if (fp->metrics_collector_ != nullptr) {
+      metrics = fp->metrics_collector_->stop();
+    }
+
     NVF_CHECK(
         fp->kernel_profiles_.size() >= fp->segments_.size(),
         "All of the kernel profiles have not been recorded!");
@@ -677,12 +1186,18 @@ void FusionProfiler::stop() {
           fp->segments_[kp_idx].state());
       kprof.input_bytes = segment(kp_idx).inputBytes();
       kprof.output_bytes = segment(kp_idx).outputBytes();
+      kprof.modeled_load_bytes = segment(kp_idx).modeledLoadBytes();
+      kprof.modeled_store_bytes = segment(kp_idx).modeledStoreBytes();
       kprof.effective_bandwidth_gbs =
           (double)(kprof.input_bytes + kprof.output_bytes) / kprof.time_ms *
           mb_divider;
       kprof.percentage_peak_bandwidth =
           kprof.effective_bandwidth_gbs / kprof.peak_bandwidth_gbs * 100.0;
       kprof.compile_time_ms = segment(kp_idx).compileTime();
+      if (auto metrics_it = metrics.find(kprof.name);
+          metrics_it != metrics.end()) {
+        kprof.metrics = metrics_it->second;
+      }
 
       kernel_time_ms += kprof.time_ms;
       fprof.kernel_profiles[kp_idx] = std::move(kprof);
@@ -706,6 +1221,14 @@ void FusionProfiler::stop() {
     }
   }
   fprof.compile_time_ms = fp->compile_timer_.time();
+  fprof.input_encoding_time_ms = fp->input_encoding_timer_.time();
+  fprof.runtime_lookup_time_ms = fp->runtime_lookup_timer_.time();
+
+  fprof.segment_host_profiles.reserve(fp->segments_.size());
+  for (auto& seg : fp->segments_) {
+    fprof.segment_host_profiles.push_back(seg.hostProfile());
+    fprof.segment_host_time_ms += seg.hostProfile().host_time_ms;
+  }
 
   fp->state_ = ProfilerState::Processed;
 }
@@ -726,6 +1249,38 @@ void FusionProfiler::stopCompile() {
   get()->compile_timer_.stop();
 }
 
+void FusionProfiler::startInputEncoding() {
+  NVF_CHECK(
+      state() == ProfilerState::Running,
+      "FusionProfiler state is not Running!",
+      state());
+  get()->input_encoding_timer_.start();
+}
+
+void FusionProfiler::stopInputEncoding() {
+  NVF_CHECK(
+      state() == ProfilerState::Running,
+      "FusionProfiler state is not Running!",
+      state());
+  get()->input_encoding_timer_.stop();
+}
+
+void FusionProfiler::startRuntimeLookup() {
+  NVF_CHECK(
+      state() == ProfilerState::Running,
+      "FusionProfiler state is not Running!",
+      state());
+  get()->runtime_lookup_timer_.start();
+}
+
+void FusionProfiler::stopRuntimeLookup() {
+  NVF_CHECK(
+      state() == ProfilerState::Running,
+      "FusionProfiler state is not Running!",
+      state());
+  get()->runtime_lookup_timer_.stop();
+}
+
 void FusionProfiler::inputBytesAccessed(int64_t bytes) {
   NVF_CHECK(
       state() == ProfilerState::Running,
@@ -769,4 +1324,19 @@ uint8_t* FusionProfiler::cuptiBufferPtr() {
   return get()->cupti_buffer_.data();
 }
 
+SegmentHostPhaseGuard::SegmentHostPhaseGuard(SegmentHostPhase phase)
+    : segment_(
+          isProfilerEnabled() ? FusionProfiler::runningSegment() : nullptr),
+      phase_(phase) {
+  if (segment_ != nullptr) {
+    segment_->startHostPhase(phase_);
+  }
+}
+
+SegmentHostPhaseGuard::~SegmentHostPhaseGuard() {
+  if (segment_ != nullptr) {
+    segment_->stopHostPhase(phase_);
+  }
+}
+
 } // namespace nvfuser
@@ -7,6 +7,8 @@
 // clang-format on
 #pragma once
 #include <chrono>
+#include <memory>
+#include <optional>
 #include <unordered_map>
 
 #include <c10/cuda/CUDAStream.h>
@@ -90,6 +92,59 @@ struct DeviceDescriptor {
   double peak_bandwidth_gbs{0.0};
 };
 
+//! \enum SegmentHostPhase
+//! \brief The phases of the host work to launch the kernel of a segment
+enum class SegmentHostPhase {
+  //! Lookup or initialization of the ExecutorEntry for the inputs
+  ExecutorEntryLookup,
+  //! Binding of the inputs and outputs and evaluation of the kernel arguments
+  ArgumentBinding,
+  //! Allocation of the outputs and intermediate buffers
+  Allocation,
+  //! cuLaunchKernel
+  KernelLaunch,
+};
+
+//! \struct SegmentHostProfile
+//! \brief This struct captures the host time spent to launch the kernel of a
+//! segment, split into the phases of SegmentHostPhase.
+struct SegmentHostProfile {
+  double& phaseTime(SegmentHostPhase phase);
+
+  //! Total host time of running the segment, including the phases
+  double host_time_ms{0.0};
+
+  double executor_entry_lookup_time_ms{0.0};
+  double argument_binding_time_ms{0.0};
+  double allocation_time_ms{0.0};
+  double kernel_launch_time_ms{0.0};
+};
+
+//! \struct KernelMetrics
+//! \brief This struct captures the hardware metrics of a kernel collected by
+//! the CUPTI Range Profiler. See [ Kernel Metrics ].
+struct KernelMetrics {
+  //! Bytes read from and written to DRAM, to compare with the modeled bytes
+  //! of the KernelProfile
+  double dram_read_bytes{0.0};
+  double dram_write_bytes{0.0};
+  //! DRAM throughput in percent of the peak
+  double dram_throughput_pct{0.0};
+  //! Hit rate of the L2 sectors in percent
+  double l2_hit_rate_pct{0.0};
+  //! Active warps in percent of the maximum per SM
+  double achieved_occupancy_pct{0.0};
+
+  //! Average warps stalled per issued instruction, by the reason of the stall
+  double stall_long_scoreboard{0.0};
+  double stall_barrier{0.0};
+  double stall_mio_throttle{0.0};
+  double stall_short_scoreboard{0.0};
+
+  //! Bank conflicts of the shared memory loads and stores
+  double smem_bank_conflicts{0.0};
+};
+
 //! \struct KernelProfile
 //! \brief This struct captures the CUPTI profiled information from a kernel
 //! generated by a segment.
@@ -114,9 +169,16 @@ struct KernelProfile {
 
   int64_t input_bytes{0};
   int64_t output_bytes{0};
+  //! Global memory bytes loaded and stored by the kernel according to
+  //! [ Memory Traffic Model ]
+  int64_t modeled_load_bytes{0};
+  int64_t modeled_store_bytes{0};
 
   std::string device_name{};
   double peak_bandwidth_gbs{0.0};
+
+  //! Only collected with ProfilerOption::Metrics
+  std::optional<KernelMetrics> metrics{};
 };
 
 //! \struct FusionProfile
@@ -126,7 +188,7 @@ struct KernelProfile {
 struct FusionProfile {
   //! A static array to capture header strings for tables that print
   //! the profiled information
-  static std::array<const char*, 25> column_strs;
+  static std::array<const char*, 45> column_strs;
 
   void reset();
 
@@ -139,6 +201,13 @@ struct FusionProfile {
   double compile_time_ms{0.0};
   double kernel_time_ms{0.0};
 
+  //! Host time of creating the KernelArgumentHolder and the input cache id
+  double input_encoding_time_ms{0.0};
+  //! Host time of looking up or creating the FusionKernelRuntime
+  double runtime_lookup_time_ms{0.0};
+  //! Sum of the host times of all segments
+  double segment_host_time_ms{0.0};
+
   int64_t input_bytes{0};
   int64_t output_bytes{0};
 
@@ -147,6 +216,9 @@ struct FusionProfile {
 
   //! Vector of of the KernelProfiles for each segment of a Fusion
   std::vector<KernelProfile> kernel_profiles{};
+  //! Vector of the host profiles for each segment of a Fusion. Unlike
+  //! kernel_profiles, this is also collected without CUPTI.
+  std::vector<SegmentHostProfile> segment_host_profiles{};
 };
 
 std::ostream& operator<<(std::ostream&, const FusionProfile&);
@@ -165,6 +237,14 @@ class SegmentProfiler {
 
   void inputBytesAccessed(int64_t bytes);
   void outputBytesAccessed(int64_t bytes);
+  //! The bytes of the kernel's global memory accesses according to
+  //! [ Memory Traffic Model ]
+  void modeledBytesAccessed(int64_t load_bytes, int64_t store_bytes);
+
+  //! Phases must not overlap and are only timed between startKernel and
+  //! stopKernel
+  void startHostPhase(SegmentHostPhase phase);
+  void stopHostPhase(SegmentHostPhase phase);
 
   uint32_t segmentId() const;
   int device() const {
@@ -177,12 +257,21 @@ class SegmentProfiler {
   int64_t outputBytes() const {
     return output_bytes_;
   }
+  int64_t modeledLoadBytes() const {
+    return modeled_load_bytes_;
+  }
+  int64_t modeledStoreBytes() const {
+    return modeled_store_bytes_;
+  }
   double compileTime() {
     return compile_timer_.time();
   }
   ProfilerState state() const {
     return kernel_profile_state_;
   }
+  const SegmentHostProfile& hostProfile() const {
+    return host_profile_;
+  }
 
  private:
   bool cupti_disabled_;
@@ -193,9 +282,20 @@ class SegmentProfiler {
   HostTimer compile_timer_;
   int64_t input_bytes_;
   int64_t output_bytes_;
+  int64_t modeled_load_bytes_;
+  int64_t modeled_store_bytes_;
   ProfilerState kernel_profile_state_;
+
+  //! Times the span from startKernel to stopKernel
+  HostTimer host_timer_;
+  HostTimer host_phase_timer_;
+  SegmentHostProfile host_profile_;
 };
 
+//! Collects the hardware metrics of kernels with the CUPTI Range Profiler.
+//! See [ Kernel Metrics ].
+class KernelMetricsCollector;
+
 //! \struct FusionProfiler
 //! \brief A singleton class to profile Fusions that can include multiple
 //! segments.
@@ -215,10 +315,16 @@ class FusionProfiler {
   static void createSegments(size_t num);
   static void startCompile();
   static void stopCompile();
+  static void startInputEncoding();
+  static void stopInputEncoding();
+  static void startRuntimeLookup();
+  static void stopRuntimeLookup();
   static void inputBytesAccessed(int64_t bytes);
   static void outputBytesAccessed(int64_t bytes);
   static const FusionProfile& profile();
   static SegmentProfiler& segment(size_t idx);
+  //! The segment whose kernel is being launched, or nullptr if there is none
+  static SegmentProfiler* runningSegment();
 
   //! Methods to capture Asynchronous CUPTI activity that get called from
   //! functions registered with CUPTI.
@@ -238,6 +344,8 @@ class FusionProfiler {
  private:
   //! Disables CUPTI usage in order to measure Host Time without CUPTI overhead
   bool cupti_disabled_;
+  //! Created when metrics are first collected
+  std::unique_ptr<KernelMetricsCollector> metrics_collector_;
   //! Buffer for Cupti to store Activity Buffers during async activity
   std::vector<uint8_t> cupti_buffer_;
   //! The state is used to check for errors in usage
@@ -250,6 +358,8 @@ class FusionProfiler {
   HostTimer host_timer_;
   //! Total compilation time if there is more than one segment
   HostTimer compile_timer_;
+  HostTimer input_encoding_timer_;
+  HostTimer runtime_lookup_timer_;
   std::vector<SegmentProfiler> segments_;
   //! The FusionProfiler collects a cache of device descriptors so each segment
   //! does not need to spend time re-generating the information.
@@ -261,4 +371,21 @@ class FusionProfiler {
   std::unordered_map<uint32_t, uint32_t> corrid_2_segid_;
 };
 
+//! \class SegmentHostPhaseGuard
+//! \brief Adds the host time spent in its scope to a phase of the segment
+//! whose kernel is being launched. Does nothing if the FusionProfiler is
+//! disabled.
+class SegmentHostPhaseGuard {
+ public:
+  SegmentHostPhaseGuard(SegmentHostPhase phase);
+  ~SegmentHostPhaseGuard();
+
+  SegmentHostPhaseGuard(const SegmentHostPhaseGuard&) = delete;
+  SegmentHostPhaseGuard& operator=(const SegmentHostPhaseGuard&) = delete;
+
+ private:
+  SegmentProfiler* segment_;
+  SegmentHostPhase phase_;
+};
+
 } // namespace nvfuser
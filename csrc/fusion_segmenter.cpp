@@ -17,6 +17,9 @@
 #include <ops/arith.h>
 #include <scheduler/debug_utils.h>
 #include <scheduler/normalization_utils.h>
+#include <scheduler/utils.h>
+
+#include <ATen/cuda/CUDAContext.h>
 
 #include <sstream>
 
@@ -1455,14 +1458,6 @@ class GroupDependencyAnalysis : public NonCopyable, public SegmenterAnalysis {
   //!  a backward DFS would do the same
   void computeAllProducers();
 
-  //! Add all consumers of `producer` to `to_visit`
-  void addConsumersToWorkList(SegmentedGroup* producer, GroupSet& to_visit) {
-    for (auto e : producer->consumer_edges) {
-      // A consumer wouldn't have been worked before any of its producer
-      to_visit.pushBack(e->to);
-    }
-  }
-
   //! Propagate all known producers of `from` into `into`, used to keep track
   //! of:
   //!  1. `from` is a producer of `into`
@@ -1476,6 +1471,16 @@ class GroupDependencyAnalysis : public NonCopyable, public SegmenterAnalysis {
     }
   }
 
+  //! Propagate the producers in `producers` into `into`
+  void mergeAllKnownProducersIntoFrom(
+      SegmentedGroup* into,
+      const GroupSet& producers) {
+    auto& into_set = getAllKnownProducersSet(into);
+    for (auto group : producers) {
+      into_set->pushBack(group);
+    }
+  }
+
   //! Utility to access known producers of a group so far
   GroupSetOwningPtr& getAllKnownProducersSet(SegmentedGroup* group) {
     auto& producer_set_ptr = known_producers_of_[group];
@@ -1550,17 +1555,27 @@ void GroupDependencyAnalysis::mergeGroups(
   ab_set->erase(b);
 
   // a, b no longer exist, remove their producer sets
+  GroupSetOwningPtr a_producers = std::move(getAllKnownProducersSet(a));
+  GroupSetOwningPtr b_producers = std::move(getAllKnownProducersSet(b));
   known_producers_of_.erase(a);
   known_producers_of_.erase(b);
 
   // update producer maps of other groups
   for (auto& it : known_producers_of_) {
+    const bool produced_by_a = it.second->has(a);
+    const bool produced_by_b = it.second->has(b);
     // for all groups that are produced by either a or b
-    if (it.second->has(a) || it.second->has(b)) {
+    if (produced_by_a || produced_by_b) {
       // insert ab as the new producer
       it.second->pushBack(ab);
-      // all producers of both a and b are now producers of `it`
-      mergeAllKnownProducersIntoFrom(it.first, ab);
+      // all producers of both a and b are now producers of `it`. The
+      //  producers of a are already known if a is, and the same for b.
+      if (!produced_by_a) {
+        mergeAllKnownProducersIntoFrom(it.first, *a_producers);
+      }
+      if (!produced_by_b) {
+        mergeAllKnownProducersIntoFrom(it.first, *b_producers);
+      }
     }
     // a, b no longer exist, remove them from `it`
     it.second->erase(a);
@@ -1615,55 +1630,59 @@ void GroupDependencyAnalysis::mergeGroups(
 //!  a work list algorithm through forward traversal
 //!  a backward DFS would do the same
 void GroupDependencyAnalysis::computeAllProducers() {
-  GroupSet visited;
-  GroupSet to_visit;
+  // Groups are visited in topological order, each once all of its producers
+  //  are visited, so it's linear in the number of groups and edges besides
+  //  the propagation of the producer sets
+  std::unordered_map<SegmentedGroup*, size_t> num_pending_producers;
+  std::deque<SegmentedGroup*> to_visit;
 
   // Collect source nodes, with no producers we are guaranteed
   //  a source node on a DAG
   for (auto group : segmented_fusion_->cgroups()) {
-    if (group->producer_edges.empty()) {
-      visited.pushBack(group);
+    // filter multi-edges
+    GroupSet producers_of_group;
+    for (auto edge : group->producer_edges) {
+      producers_of_group.pushBack(edge->from);
+    }
+    num_pending_producers[group] = producers_of_group.size();
+    if (producers_of_group.empty()) {
+      to_visit.push_back(group);
     }
   }
 
-  // visited now only contain source nodes
-  //  they can go backward to nowhere
-  for (auto group : visited) {
-    addConsumersToWorkList(group, to_visit);
-  }
-
+  size_t num_visited = 0;
   while (!to_visit.empty()) {
-    SegmentedGroup* to_update = nullptr;
-    for (auto visiting_group : to_visit) {
-      if (std::all_of(
-              visiting_group->producer_edges.begin(),
-              visiting_group->producer_edges.end(),
-              [&visited](SegmentedEdge* e) { return visited.has(e->from); })) {
-        // filter multi-edges
-        GroupSet producers_of_visiting_group;
-        for (auto edge : visiting_group->producer_edges) {
-          producers_of_visiting_group.pushBack(edge->from);
-        }
+    auto visiting_group = to_visit.front();
+    to_visit.pop_front();
+    num_visited++;
 
-        // populate all possible paths
-        // from producer backward, including
-        // the producer
-        for (auto producer : producers_of_visiting_group) {
-          getAllKnownProducersSet(visiting_group)->pushBack(producer);
-          mergeAllKnownProducersIntoFrom(visiting_group, producer);
-        }
-        to_update = visiting_group;
-        break;
-      }
+    GroupSet producers_of_visiting_group;
+    for (auto edge : visiting_group->producer_edges) {
+      producers_of_visiting_group.pushBack(edge->from);
     }
-    if (to_update) {
-      addConsumersToWorkList(to_update, to_visit);
-      to_visit.erase(to_update);
-      visited.pushBack(to_update);
-    } else {
-      NVF_ERROR(false, "unreachable, original graph not a DAG");
+
+    // populate all possible paths
+    // from producer backward, including
+    // the producer
+    for (auto producer : producers_of_visiting_group) {
+      getAllKnownProducersSet(visiting_group)->pushBack(producer);
+      mergeAllKnownProducersIntoFrom(visiting_group, producer);
+    }
+
+    GroupSet consumers_of_visiting_group;
+    for (auto edge : visiting_group->consumer_edges) {
+      consumers_of_visiting_group.pushBack(edge->to);
+    }
+    for (auto consumer : consumers_of_visiting_group) {
+      if (--num_pending_producers.at(consumer) == 0) {
+        to_visit.push_back(consumer);
+      }
     }
   }
+
+  NVF_ERROR(
+      num_visited == segmented_fusion_->cgroups().size(),
+      "unreachable, original graph not a DAG");
 }
 
 std::ostream& operator<<(
@@ -1852,7 +1871,16 @@ std::unique_ptr<Fusion> SegmentedFusion::makeFusion(SegmentedGroup* sg) {
   // note, we would want to keep output consistent and not artificially drop
   // duplicates.
   for (auto out : sg->output_vals) {
-    fusion_segment->addOutput(complete_to_segment_map.clone(out));
+    auto clone_out = complete_to_segment_map.clone(out);
+    // CPU scalars are only bound to inputs. Outputs of a segment kept on the
+    // host as CPU scalars for later segments are computed as usual by its
+    // own kernel, see [ Host-Evaluated Segments ].
+    if (auto clone_tv = dynamic_cast<TensorView*>(clone_out);
+        clone_tv != nullptr && clone_tv->isCpuScalar() &&
+        !clone_tv->isFusionInput()) {
+      clone_tv->setCpuScalar(false);
+    }
+    fusion_segment->addOutput(clone_out);
   }
 
   // Replace all vals that are rfactor extents in fusion_segment->inputs() with
@@ -2011,6 +2039,8 @@ void SegmentCandidateFinder::eraseGroups(
 
 SegmentedGroup* SegmentCandidateFinder::mergeNodes() {
   SegmentedGroup* last_merged = nullptr;
+  // Merged groups are erased below, so their addresses may be reused
+  merge_score_cache_.clear();
   auto it = to_merge_.begin();
   NVF_ERROR(to_merge_.size() % 2 == 0);
   while (it != to_merge_.end()) {
@@ -2118,6 +2148,7 @@ SegmentedGroup* SegmentCandidateFinder::mergeAllGivenGroups(
   NVF_ERROR(
       !groups_to_merge.empty(),
       "fusion segment :(mergeAllGivenGroups) tried to merge no groups")
+  merge_score_cache_.clear();
 
   // Make a set to detect internal edges
   std::unordered_set<SegmentedGroup*> group_set(
@@ -3536,23 +3567,180 @@ std::optional<SegmentedGroup::NeighborGroup> PreferredMergeCandidatePicker::
       (*producer_edge_it)->from, *producer_edge_it);
 }
 
+//! Number of elements of a tensor passed between segments, skipping the
+//! extents that aren't known at segmentation time
+int64_t tensorNumel(SchedulerRuntimeInfo& runtime_info, TensorView* tv) {
+  int64_t numel = 1;
+  for (auto id : TensorDomain::noReductions(tv->getMaybeRFactorDomain())) {
+    if (id->isBroadcast()) {
+      continue;
+    }
+    auto extent = runtime_info.expressionEvaluator().evaluate(id->extent());
+    if (extent.hasValue()) {
+      numel *= extent.as<int64_t>();
+    }
+  }
+  return numel;
+}
+
+int64_t tensorBytes(SchedulerRuntimeInfo& runtime_info, TensorView* tv) {
+  return tensorNumel(runtime_info, tv) *
+      dataTypeSize(tv->getDataType().value(), runtime_info.getIndexType());
+}
+
+bool isPersistentHeuristic(ScheduleHeuristic heuristic) {
+  return heuristic == ScheduleHeuristic::InnerPersistent ||
+      heuristic == ScheduleHeuristic::OuterPersistent ||
+      heuristic == ScheduleHeuristic::InnerOuterPersistent;
+}
+
 } // namespace
 
+int64_t BytesMovedCostModel::savedBytes(
+    SchedulerRuntimeInfo& runtime_info,
+    SegmentedGroup* a,
+    SegmentedGroup* b) {
+  int64_t saved_bytes = 0;
+  for (auto groups : {std::make_pair(a, b), std::make_pair(b, a)}) {
+    SegmentedGroup* from = groups.first;
+    SegmentedGroup* to = groups.second;
+    VectorOfUniqueEntries<TensorView*> boundary_tvs;
+    for (auto edge : from->consumer_edges) {
+      if (edge->to == to && edge->val->isA<TensorView>()) {
+        boundary_tvs.pushBack(edge->val->as<TensorView>());
+      }
+    }
+    for (auto tv : boundary_tvs) {
+      const int64_t bytes = tensorBytes(runtime_info, tv);
+      // The consumer no longer reads the tensor from global memory
+      saved_bytes += bytes;
+      // The producer no longer writes it unless it's needed outside of the
+      // merged group
+      const bool still_written = tv->isFusionOutput() ||
+          std::any_of(from->consumer_edges.begin(),
+                      from->consumer_edges.end(),
+                      [&](SegmentedEdge* edge) {
+                        return edge->val == tv && edge->to != to;
+                      });
+      if (!still_written) {
+        saved_bytes += bytes;
+      }
+    }
+  }
+  return saved_bytes;
+}
+
+double BytesMovedCostModel::estimatedOccupancy(
+    SegmentedFusion* segmented_fusion,
+    SchedulerRuntimeInfo& runtime_info,
+    SegmentedGroup* a,
+    SegmentedGroup* b,
+    ScheduleHeuristic heuristic) {
+  if (!isPersistentHeuristic(heuristic)) {
+    return 1.0;
+  }
+
+  FusionSegmentGuard fsg(segmented_fusion, a, b);
+  Fusion* fusion = segmented_fusion->completeFusion();
+  FusionGuard fg(fusion);
+
+  auto persistent_buffer_info = scheduler_utils::persistentBuffers(fusion);
+  if (persistent_buffer_info.persistent_buffers.empty()) {
+    return 1.0;
+  }
+  auto persistent_buffer_size_info = scheduler_utils::persistentBufferSize(
+      fusion, runtime_info, persistent_buffer_info);
+  int64_t buffer_bytes = persistent_buffer_size_info.persistent_buffer_size;
+  if (persistent_buffer_size_info.projected_persistent_buffer_size > 0) {
+    buffer_bytes = std::min(
+        buffer_bytes,
+        persistent_buffer_size_info.projected_persistent_buffer_size);
+  }
+
+  const int64_t registers_per_thread = std::min(
+      scheduler_utils::register_overhead +
+          ceilDiv(
+              buffer_bytes,
+              scheduler_utils::bytes_per_register *
+                  kThreadsPerPersistentBuffer),
+      scheduler_utils::max_registers_per_thread);
+  const int64_t max_threads_per_sm =
+      (int64_t)at::cuda::getCurrentDeviceProperties()
+          ->maxThreadsPerMultiProcessor;
+  return std::min(
+      1.0,
+      (double)getThreadsPerSMGivenRegPerThread(registers_per_thread) /
+          (double)max_threads_per_sm);
+}
+
+double BytesMovedCostModel::mergeScore(
+    SegmentedFusion* segmented_fusion,
+    SchedulerRuntimeInfo& runtime_info,
+    SegmentedGroup* a,
+    SegmentedGroup* b,
+    ScheduleHeuristic heuristic) {
+  return (double)savedBytes(runtime_info, a, b) *
+      estimatedOccupancy(segmented_fusion, runtime_info, a, b, heuristic);
+}
+
+std::optional<double> SegmentCandidateFinder::mergeScore(
+    SegmentedGroup* group1,
+    SegmentedGroup* group2) {
+  const std::pair<SegmentedGroup*, SegmentedGroup*> key =
+      std::minmax(group1, group2);
+  auto cached_it = merge_score_cache_.find(key);
+  if (cached_it != merge_score_cache_.end()) {
+    return cached_it->second;
+  }
+
+  std::optional<double> score = std::nullopt;
+  if (auto heuristic = proposeHeuristics(group1, group2)) {
+    const double model_score = cost_model_->mergeScore(
+        segmented_fusion_.get(),
+        runtime_info_,
+        group1,
+        group2,
+        heuristic.value());
+    if (isDebugDumpEnabled(DebugDumpOption::SegmenterCostModel)) {
+      debug() << "Segmenter cost model (" << cost_model_->name()
+              << "): score " << model_score << " for merging as "
+              << heuristic.value() << ":\n  " << group1 << "  " << group2;
+    }
+    if (model_score >= 0) {
+      score = model_score;
+    }
+  }
+  merge_score_cache_.emplace(key, score);
+  return score;
+}
+
 bool SegmentCandidateFinder::codeGenSupportedMerge(
     SegmentedGroup* group1,
     SegmentedGroup* group2) {
   NVF_ERROR(
       areDirectlyConnected(group1, group2),
       "only support testing immediate producer-consumer groups");
-  auto h = tryMerge(segmented_fusion_.get(), runtime_info_, group1, group2);
-  return h.has_value();
+  return proposeHeuristics(group1, group2).has_value();
+}
+
+std::optional<ScheduleHeuristic> SegmentCandidateFinder::proposeHeuristics(
+    SegmentedGroup* group1,
+    SegmentedGroup* group2) {
+  auto key = std::make_pair(
+      getAllInputs(group1, group2), getAllOutputs(group1, group2));
+  auto cached_it = heuristic_cache_.find(key);
+  if (cached_it != heuristic_cache_.end()) {
+    return cached_it->second;
+  }
+  auto heuristic =
+      tryMerge(segmented_fusion_.get(), runtime_info_, group1, group2);
+  heuristic_cache_.emplace(std::move(key), heuristic);
+  return heuristic;
 }
 
-// TODO: consider caching the heuristics value so tryMerge doesn't have to be
-//       called twice
 ScheduleHeuristic SegmentCandidateFinder::deriveHeuristic(
     SegmentedGroup* group) {
-  auto h = tryMerge(segmented_fusion_.get(), runtime_info_, group);
+  auto h = proposeHeuristics(group);
   NVF_ERROR(
       h.has_value(), "Can not find a scheduler to schedule fusion segment");
   return h.value();
@@ -3563,6 +3751,10 @@ SegmentCandidateFinder::SegmentCandidateFinder(
     const KernelArgumentHolder& inputs,
     SegmentCandidateFinderOptions options)
     : options_(options),
+      cost_model_(
+          options.cost_model != nullptr
+              ? options.cost_model
+              : std::make_shared<BytesMovedCostModel>()),
       runtime_info_(fusion.get(), inputs),
       runtime_inputs_(inputs) {
   segmented_fusion_ = std::make_unique<SegmentedFusion>(std::move(fusion));
@@ -3572,6 +3764,7 @@ SegmentCandidateFinder::SegmentCandidateFinder(
 void SegmentCandidateFinder::buildInitialSegments() {
   groups().clear();
   edges().clear();
+  heuristic_cache_.clear();
 
   // TODO: Make traversal items local to this function.
   // Need this for initialization of the DAG that is process
@@ -3651,15 +3844,26 @@ void SegmentCandidateFinder::trySetUpMerge(
     return;
   }
 
-  auto candidate_it = candidates.begin();
-  while (candidate_it != candidates.end() &&
-         !codeGenSupportedMerge(group, candidate_it->group)) {
-    candidate_it++;
+  // Take the legal candidate with the highest score, the first one on ties
+  auto candidate_it = candidates.end();
+  double best_score = 0;
+  for (auto it = candidates.begin(); it != candidates.end(); ++it) {
+    auto score = mergeScore(group, it->group);
+    if (score.has_value() &&
+        (candidate_it == candidates.end() || score.value() > best_score)) {
+      candidate_it = it;
+      best_score = score.value();
+    }
   }
   if (candidate_it == candidates.end()) {
     return;
   }
 
+  if (isDebugDumpEnabled(DebugDumpOption::SegmenterCostModel)) {
+    debug() << "Segmenter cost model: merging with score " << best_score
+            << ":\n  " << group << "  " << candidate_it->group;
+  }
+
   to_merge_.emplace_back(group);
   to_merge_.emplace_back(candidate_it->group);
 
@@ -3729,8 +3933,29 @@ void SegmentCandidateFinder::findSegments() {
       // If there are preferred groups to merge, merge them first
       // without considering the rest of groups
       if (to_merge_.empty()) {
-        for (auto& group : groups()) {
-          trySetUpMerge(group);
+        // Visit the groups with the most profitable merges first, see
+        // [ Segmentation Cost Model ]
+        std::vector<std::pair<SegmentedGroup*, double>> groups_by_score;
+        for (auto group : groups()) {
+          std::optional<double> best_score = std::nullopt;
+          for (const auto& candidate : group->getMergeCandidates()) {
+            auto score = mergeScore(group, candidate.group);
+            if (score.has_value() &&
+                (!best_score.has_value() ||
+                 score.value() > best_score.value())) {
+              best_score = score;
+            }
+          }
+          if (best_score.has_value()) {
+            groups_by_score.emplace_back(group, best_score.value());
+          }
+        }
+        std::stable_sort(
+            groups_by_score.begin(),
+            groups_by_score.end(),
+            [](const auto& a, const auto& b) { return a.second > b.second; });
+        for (auto& group_and_score : groups_by_score) {
+          trySetUpMerge(group_and_score.first);
         }
       }
 
@@ -3757,6 +3982,10 @@ void SegmentCandidateFinder::findSegments() {
   // Forwarded input groups are no longer used. Clean them up.
   cleanupForwardedInputs();
 
+  if (options_.run_recompute_cheap_producers) {
+    recomputeCheapProducers();
+  }
+
   finalize();
 
   // Do sanity check on the final graph. At this point, the graph may
@@ -3857,6 +4086,137 @@ void SegmentCandidateFinder::cleanupForwardedInputs() {
   input2group_.clear();
 }
 
+void SegmentCandidateFinder::recomputeCheapProducers() {
+  // Edges of each tensor passed between groups, in a deterministic order
+  std::vector<TensorView*> boundary_tvs;
+  std::unordered_map<TensorView*, std::vector<SegmentedEdge*>> tv_edges;
+  for (auto edge : edges()) {
+    auto tv = dynamic_cast<TensorView*>(edge->val);
+    if (tv == nullptr || tv->isFusionOutput()) {
+      continue;
+    }
+    auto& edges_of_tv = tv_edges[tv];
+    if (edges_of_tv.empty()) {
+      boundary_tvs.push_back(tv);
+    }
+    edges_of_tv.push_back(edge);
+  }
+
+  // Inputs of a group if tv is recomputed in it along with the tensors
+  // already recomputed in it
+  auto inputs_with_recomputation = [](SegmentedGroup* group, TensorView* tv) {
+    std::vector<Val*> to_recompute = {tv};
+    std::vector<Val*> inputs;
+    for (auto inp : group->input_vals) {
+      if (inp->isFusionInput()) {
+        inputs.push_back(inp);
+      } else {
+        to_recompute.push_back(inp);
+      }
+    }
+    for (auto edge : group->producer_edges) {
+      if (edge->val != tv) {
+        inputs.push_back(edge->val);
+      }
+    }
+    for (auto inp : IterVisitor::getInputsTo(to_recompute)) {
+      if (inp->isFusionInput()) {
+        inputs.push_back(inp);
+      }
+    }
+    return uniqueValConcat({inputs});
+  };
+
+  std::unordered_set<SegmentedGroup*> unused_groups;
+  for (auto tv : boundary_tvs) {
+    const auto chain = StmtSort::getExprsTo({tv});
+    const bool is_pointwise =
+        std::all_of(chain.begin(), chain.end(), [](Expr* expr) {
+          return expr->isA<UnaryOp>() || expr->isA<BinaryOp>() ||
+              expr->isA<TernaryOp>();
+        });
+    if (!is_pointwise) {
+      continue;
+    }
+    const int64_t num_ops =
+        std::count_if(chain.begin(), chain.end(), [](Expr* expr) {
+          return !ir_utils::isScalarOp(expr);
+        });
+
+    VectorOfUniqueEntries<SegmentedGroup*> consumers;
+    for (auto edge : tv_edges.at(tv)) {
+      consumers.pushBack(edge->to);
+    }
+    const auto num_consumers = (int64_t)consumers.size();
+
+    const auto chain_inputs = IterVisitor::getInputsTo({tv});
+    int64_t input_bytes = 0;
+    for (auto inp : ir_utils::filterByType<TensorView>(chain_inputs)) {
+      input_bytes += tensorBytes(runtime_info_, inp);
+    }
+    const int64_t materialized_bytes =
+        tensorBytes(runtime_info_, tv) * (1 + num_consumers);
+    const int64_t recomputed_bytes = input_bytes * num_consumers;
+    const int64_t saved_bytes = materialized_bytes - recomputed_bytes;
+    const int64_t recomputed_ops =
+        num_ops * tensorNumel(runtime_info_, tv) * num_consumers;
+    if (saved_bytes <= 0 ||
+        (double)recomputed_ops >
+            options_.recompute_ops_per_byte * (double)saved_bytes) {
+      continue;
+    }
+
+    const bool can_schedule =
+        std::all_of(consumers.begin(), consumers.end(), [&](auto consumer) {
+          FusionSegmentGuard fsg(
+              completeFusion(),
+              inputs_with_recomputation(consumer, tv),
+              getAllOutputs(consumer));
+          return SchedulerEntry::proposeHeuristics(
+                     completeFusion(), runtime_info_)
+              .has_value();
+        });
+    if (!can_schedule) {
+      continue;
+    }
+
+    if (isDebugDumpEnabled(DebugDumpOption::FusionSegmenterLog)) {
+      debug() << "Recomputing " << tv->toString() << " in " << num_consumers
+              << " segments, saving " << saved_bytes << " bytes" << std::endl;
+    }
+
+    // Replace the edges by recomputing tv like a forwarded input
+    std::unordered_set<SegmentedEdge*> removed_edges;
+    for (auto edge : tv_edges.at(tv)) {
+      removed_edges.insert(edge);
+      auto& from_edges = edge->from->consumer_edges;
+      from_edges.erase(
+          std::remove(from_edges.begin(), from_edges.end(), edge),
+          from_edges.end());
+      auto& to_edges = edge->to->producer_edges;
+      to_edges.erase(
+          std::remove(to_edges.begin(), to_edges.end(), edge), to_edges.end());
+      if (edge->from->consumer_edges.empty() &&
+          edge->from->output_vals.empty()) {
+        unused_groups.insert(edge->from);
+      }
+    }
+    for (auto consumer : consumers) {
+      consumer->input_vals.push_back(tv);
+    }
+    edges().erase(
+        std::remove_if(
+            edges().begin(),
+            edges().end(),
+            [&removed_edges](SegmentedEdge* edge) {
+              return removed_edges.count(edge) > 0;
+            }),
+        edges().end());
+  }
+
+  eraseGroups(unused_groups);
+}
+
 void SegmentCandidateFinder::finalMerge() {
   auto producer_check = getGroupDependency();
 
@@ -3886,21 +4246,38 @@ void SegmentCandidateFinder::finalMerge() {
           std::back_inserter(all_consumers_of_producer_group),
           [](auto& it) { return it.first; });
 
+      // Try the most profitable merges first, see
+      // [ Segmentation Cost Model ]
+      std::vector<std::pair<SegmentedGroup*, double>> consumers_by_score;
       for (auto consumer : all_consumers_of_producer_group) {
-        if (!producer_check->isConsumerOfAny(
-                consumer, all_consumers_of_producer_group) &&
-            codeGenSupportedMerge(producer_group, consumer)) {
-          to_merge_.emplace_back(producer_group);
-          to_merge_.emplace_back(consumer);
-          producer_group->merged_ = true;
-          producer_group->merge_with_ = consumer;
-          producer_group->merge_through_ = consumer_edge_map.at(consumer);
-          consumer->merged_ = true;
-          consumer->merge_with_ = producer_group;
-          consumer->merge_through_ = producer_group->merge_through_;
-          break;
+        if (producer_check->isConsumerOfAny(
+                consumer, all_consumers_of_producer_group)) {
+          continue;
+        }
+        if (auto score = mergeScore(producer_group, consumer)) {
+          consumers_by_score.emplace_back(consumer, score.value());
         }
       }
+      std::stable_sort(
+          consumers_by_score.begin(),
+          consumers_by_score.end(),
+          [](const auto& a, const auto& b) { return a.second > b.second; });
+
+      if (!consumers_by_score.empty()) {
+        auto [consumer, score] = consumers_by_score.front();
+        if (isDebugDumpEnabled(DebugDumpOption::SegmenterCostModel)) {
+          debug() << "Segmenter cost model: final merge with score " << score
+                  << ":\n  " << producer_group << "  " << consumer;
+        }
+        to_merge_.emplace_back(producer_group);
+        to_merge_.emplace_back(consumer);
+        producer_group->merged_ = true;
+        producer_group->merge_with_ = consumer;
+        producer_group->merge_through_ = consumer_edge_map.at(consumer);
+        consumer->merged_ = true;
+        consumer->merge_with_ = producer_group;
+        consumer->merge_through_ = producer_group->merge_through_;
+      }
 
       // Only want to merge one pair at a time so break if found any
       if (!to_merge_.empty()) {
@@ -4178,10 +4555,26 @@ FusionKernelRuntime::SchedulerEntryPtr SegmentedFusion::
 
 std::unique_ptr<FusionHeuristics> SegmentedFusion::makeInitialHeuristics(
     const KernelArgumentHolder& inputs,
-    SchedulerRuntimeInfo& runtime_info) {
+    SchedulerRuntimeInfo& runtime_info,
+    const std::vector<std::shared_ptr<HeuristicParams>>& serde_params) {
+  NVF_ERROR(
+      serde_params.empty() || serde_params.size() == groups().size(),
+      "Expected the parameters of all ",
+      groups().size(),
+      " groups but got ",
+      serde_params.size());
   auto ret = std::make_unique<FusionHeuristics>();
-  for (auto g : groups()) {
-    ret->emplaceBack(makeInitialSchedulerEntry(g, runtime_info));
+  for (auto i : c10::irange(groups().size())) {
+    auto g = groups().at(i);
+    // The summary of the compile-time analyses isn't built for groups with
+    //  deserialized parameters. Their later heuristic checks run without
+    //  it, see getMaybeSchedulerEntry.
+    if (!serde_params.empty() && serde_params.at(i) != nullptr) {
+      ret->emplaceBack(
+          SchedulerEntry::makeEntry(g->heuristic(), serde_params.at(i)));
+    } else {
+      ret->emplaceBack(makeInitialSchedulerEntry(g, runtime_info));
+    }
   }
   return ret;
 }
@@ -4362,18 +4755,53 @@ class ForceHalfAnnotation : public IterVisitor {
 
 } // namespace
 
+// [ Low Precision Segment Edges ]
+//
+// By default, only the fp32 intermediates whose uses end with a half output
+// are stored in half precision when they become segment edges, as the output
+// is rounded anyway. With EnableOption::LowPrecisionSegmentEdges, all the fp32
+// intermediates are, except the results of reductions. Those are mostly small
+// statistics, e.g., the mean and variance of a normalization, whose precision
+// matters more than their traffic. The consumer segment casts the edge back to
+// fp32, so this roughly halves the traffic between the segments of, e.g.,
+// multi-segment normalizations at the cost of rounding the edges.
+//
+// The half type is the one of the half outputs of the fusion, if any, as
+// mixing Half and BFloat16 is not supported. Otherwise, it's given by the
+// argument of the option, "fp16" or "bf16", and defaults to BFloat16 for its
+// range.
 void SegmentedFusion::annotateFP16IntermediateTensors() {
   force_fp16_tv_set_ =
       ForceHalfAnnotation::getFP16AnnotatedSet(complete_fusion_.get());
+  bool has_half_output = false;
   for (auto out_tv :
        ir_utils::filterByType<TensorView>(complete_fusion_->outputs())) {
     if (out_tv) {
       auto dtype = out_tv->getDataType().value();
       if (dtype == DataType::Half || dtype == DataType::BFloat16) {
         force_half_precision_type_ = dtype;
+        has_half_output = true;
       }
     }
   }
+
+  if (!isOptionEnabled(EnableOption::LowPrecisionSegmentEdges)) {
+    return;
+  }
+  if (!has_half_output) {
+    force_half_precision_type_ = DataType::BFloat16;
+    const auto& args =
+        getEnableOptionArguments(EnableOption::LowPrecisionSegmentEdges);
+    if (std::find(args.begin(), args.end(), "fp16") != args.end()) {
+      force_half_precision_type_ = DataType::Half;
+    }
+  }
+  for (auto tv : ir_utils::allTvs(complete_fusion_.get())) {
+    if (tv->getDataType() == DataType::Float && !tv->isFusionInput() &&
+        !tv->isFusionOutput() && !ir_utils::isReductionOp(tv->definition())) {
+      force_fp16_tv_set_.insert(tv);
+    }
+  }
 }
 
 std::string toString(const SegmentCandidateFinderOptions& segment_options) {
@@ -4388,6 +4816,9 @@ std::string toString(const SegmentCandidateFinderOptions& segment_options) {
   if (segment_options.run_final_merge) {
     ss << "final merging\n";
   }
+  if (segment_options.cost_model != nullptr) {
+    ss << "cost model " << segment_options.cost_model->name() << "\n";
+  }
   ss << "\n}\n";
   return ss.str();
 }
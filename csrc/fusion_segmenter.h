@@ -19,6 +19,10 @@
 
 #include <deque>
 #include <list>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
 #include <unordered_set>
 #include <vector>
 
@@ -346,10 +350,13 @@ class SegmentedFusion {
   //! Make a clone of the group and convert to fusion
   std::unique_ptr<Fusion> makeFusion(SegmentedGroup* sg);
 
-  //! Make heuristics for all groups in this segmented fusion
+  //! Make heuristics for all groups in this segmented fusion. The entries of
+  //!  the groups with deserialized parameters, in the order of the groups,
+  //!  are built from them, see [ Serialized Heuristics ]
   std::unique_ptr<FusionHeuristics> makeInitialHeuristics(
       const KernelArgumentHolder& inputs,
-      SchedulerRuntimeInfo& runtime_info);
+      SchedulerRuntimeInfo& runtime_info,
+      const std::vector<std::shared_ptr<HeuristicParams>>& serde_params = {});
 
   //! Inline Debug print for segmented fusion
   std::string toString(int verbosity) const;
@@ -526,12 +533,97 @@ class GroupDependencyAnalysis;
 // Manual node merging passes
 class CombineReductions;
 
+//! [ Segmentation Cost Model ]
+//!
+//! Whether two groups can be merged is decided by the schedulers, see
+//! codeGenSupportedMerge. When a group has several neighbors it can be
+//! merged with, a SegmentationCostModel decides which merge is taken:
+//! SegmentCandidateFinder::trySetUpMerge picks the legal candidate with the
+//! highest score, the Herrmann merge visits the groups in the order of the
+//! best score of their candidates, and finalMerge tries the consumers of a
+//! producer in the order of their scores. Ties keep the order of the
+//! merge candidates. A negative score vetoes a merge even if it can be
+//! scheduled.
+//!
+//! The default, BytesMovedCostModel, scores a merge by the global memory
+//! traffic it saves, i.e., the bytes of the intermediates between the two
+//! groups that no longer have to be read from and, unless they are still
+//! needed outside of the merged group, written to global memory. The saved
+//! bytes are weighted by the estimated occupancy of the merged kernel, as a
+//! persistent kernel with large buffers may run much slower than the two
+//! kernels it replaces. Its scores are never negative, so it only changes
+//! the merge order, not the set of merges that are legal.
+//!
+//! The scores and the decisions are printed with
+//! NVFUSER_DUMP=segmenter_cost_model.
+class SegmentationCostModel {
+ public:
+  virtual ~SegmentationCostModel() = default;
+
+  //! Score of merging the directly connected groups a and b, which can be
+  //! scheduled as a single kernel with the given heuristic. Higher is
+  //! better, negative means the groups should not be merged.
+  virtual double mergeScore(
+      SegmentedFusion* segmented_fusion,
+      SchedulerRuntimeInfo& runtime_info,
+      SegmentedGroup* a,
+      SegmentedGroup* b,
+      ScheduleHeuristic heuristic) = 0;
+
+  virtual std::string name() const = 0;
+};
+
+//! See [ Segmentation Cost Model ]
+class BytesMovedCostModel : public SegmentationCostModel {
+ public:
+  double mergeScore(
+      SegmentedFusion* segmented_fusion,
+      SchedulerRuntimeInfo& runtime_info,
+      SegmentedGroup* a,
+      SegmentedGroup* b,
+      ScheduleHeuristic heuristic) override;
+
+  std::string name() const override {
+    return "bytes_moved";
+  }
+
+  //! Global memory bytes saved by merging a and b
+  static int64_t savedBytes(
+      SchedulerRuntimeInfo& runtime_info,
+      SegmentedGroup* a,
+      SegmentedGroup* b);
+
+  //! Estimated fraction of the maximum number of resident threads per SM of
+  //! the kernel merged from a and b. Only persistent kernels are estimated
+  //! to have a lower occupancy than 1, based on the registers needed to
+  //! hold their persistent buffers.
+  static double estimatedOccupancy(
+      SegmentedFusion* segmented_fusion,
+      SchedulerRuntimeInfo& runtime_info,
+      SegmentedGroup* a,
+      SegmentedGroup* b,
+      ScheduleHeuristic heuristic);
+
+  //! Number of threads a persistent buffer is assumed to be distributed
+  //! over when estimating registers per thread
+  static constexpr int64_t kThreadsPerPersistentBuffer = 256;
+};
+
 //! Options to configure/debug candidate finder
 struct SegmentCandidateFinderOptions {
   bool run_translate_welford = true;
   bool run_combine_reductions = true;
   bool run_herrmann_merge = true;
   bool run_final_merge = true;
+  //! Orders the merges, see [ Segmentation Cost Model ]. BytesMovedCostModel
+  //! is used if not set.
+  std::shared_ptr<SegmentationCostModel> cost_model = nullptr;
+  //! See [ Recomputation of Cheap Producers ]
+  bool run_recompute_cheap_producers =
+      isOptionEnabled(EnableOption::RecomputeCheapProducers);
+  //! Maximum number of recomputed pointwise ops per global memory byte
+  //! saved by a recomputation
+  double recompute_ops_per_byte = 4.0;
 };
 
 //!  SegmentCandidateFinder
@@ -608,6 +700,20 @@ class SegmentCandidateFinder {
 
   bool codeGenSupportedMerge(SegmentedGroup* group1, SegmentedGroup* group2);
 
+  //! Heuristic of the merged group of group1 and group2, or of group1 alone,
+  //! or std::nullopt if it can't be scheduled. Memoized by the inputs and
+  //! outputs of the group, see heuristic_cache_.
+  std::optional<ScheduleHeuristic> proposeHeuristics(
+      SegmentedGroup* group1,
+      SegmentedGroup* group2 = nullptr);
+
+  //! Score of merging the directly connected groups according to the cost
+  //! model, or std::nullopt if they can't be merged or the cost model
+  //! vetoes the merge. Scores are cached until the next merge.
+  std::optional<double> mergeScore(
+      SegmentedGroup* group1,
+      SegmentedGroup* group2);
+
   void buildInitialSegments();
 
   void findSegments();
@@ -716,6 +822,28 @@ class SegmentCandidateFinder {
 
   void cleanupForwardedInputs();
 
+  //! [ Recomputation of Cheap Producers ]
+  //!
+  //! A tensor passed between segments is written to and read back from
+  //! global memory. If it's computed from fusion inputs by a short chain of
+  //! pointwise ops, e.g., an upcast, its consumer segments can recompute it
+  //! instead, which trades the extra ops for memory traffic. This is done
+  //! for a tensor that isn't a fusion output if
+  //!  - every consumer segment can still be scheduled with the chain
+  //!    prepended,
+  //!  - reading the inputs of the chain in each consumer moves fewer bytes
+  //!    than writing the tensor once and reading it in each consumer, and
+  //!  - the recomputed ops per element, summed over the consumers, are at
+  //!    most SegmentCandidateFinderOptions::recompute_ops_per_byte times the
+  //!    bytes per element saved.
+  //! Random number generation is never recomputed, as each kernel would draw
+  //! different numbers. The chain is added to the consumers like a
+  //! forwarded input, see resolveInputsInGroup. Producer segments that are
+  //! no longer used are removed.
+  //!
+  //! Enabled with NVFUSER_ENABLE=recompute_cheap_producers.
+  void recomputeCheapProducers();
+
   //! Query if a val is a fusion input or a forwarded input
   bool isFusionInput(Val* val) const {
     return std::find(
@@ -741,6 +869,24 @@ class SegmentCandidateFinder {
 
   std::vector<SegmentedGroup*> to_merge_;
 
+  //! See [ Segmentation Cost Model ]
+  std::shared_ptr<SegmentationCostModel> cost_model_;
+
+  //! Scores of the pairs of groups considered since the last merge
+  std::map<std::pair<SegmentedGroup*, SegmentedGroup*>, std::optional<double>>
+      merge_score_cache_;
+
+  //! The segment of a merged group, and so whether and how it can be
+  //! scheduled, only depends on its inputs and outputs in the complete
+  //! fusion. The merges of the groups that aren't affected by a merge are
+  //! proposed again in the following iterations, e.g., in every iteration of
+  //! finalMerge, so their heuristics are memoized. Cleared when the initial
+  //! segments are rebuilt, as the complete fusion may have been modified.
+  std::map<
+      std::pair<std::vector<Val*>, std::vector<Val*>>,
+      std::optional<ScheduleHeuristic>>
+      heuristic_cache_;
+
   std::unique_ptr<SegmentedFusion> segmented_fusion_;
 
   std::unique_ptr<SegmenterAnalysis> group_dependency_;
@@ -26,11 +26,13 @@
 #include <ir/iostream.h>
 #include <ir/utils.h>
 #include <ops/arith.h>
+#include <options.h>
 #include <root_domain_map.h>
 #include <swizzle.h>
 #include <transform_iter.h>
 #include <transform_replay.h>
 
+#include <limits>
 #include <memory>
 
 namespace nvfuser {
@@ -2395,6 +2397,108 @@ Val* Index::getProducerStridedIndices(
   }
 }
 
+namespace {
+
+// Rebuilds an index term that provably fits in 32 bits with Int32 arithmetic
+Val* toInt32Index(Val* value) {
+  if (value->isConstInt()) {
+    return IrBuilder::create<Val>(
+        value->evaluate().as<int64_t>(), DataType::Int32);
+  }
+  if (auto bop = dynamic_cast<BinaryOp*>(value->definition())) {
+    switch (bop->getBinaryOpType()) {
+      case BinaryOpType::Add:
+        return IrBuilder::addExpr(
+            toInt32Index(bop->lhs()), toInt32Index(bop->rhs()));
+      case BinaryOpType::Mul:
+        return IrBuilder::mulExpr(
+            toInt32Index(bop->lhs()), toInt32Index(bop->rhs()));
+      case BinaryOpType::Div:
+        return IrBuilder::divExpr(
+            toInt32Index(bop->lhs()), toInt32Index(bop->rhs()));
+      case BinaryOpType::Mod:
+        return IrBuilder::modExpr(
+            toInt32Index(bop->lhs()), toInt32Index(bop->rhs()));
+      default:
+        break;
+    }
+  }
+  auto narrowed = IrBuilder::create<Val>(DataType::Int32);
+  IrBuilder::create<UnaryOp>(UnaryOpType::Cast, narrowed, value);
+  return narrowed;
+}
+
+// See [ Mixed Index Type ] in index_compute.h
+Val* narrowIndexTerms(Val* index, const std::vector<kir::ForLoop*>& loops) {
+  if (!isOptionEnabled(EnableOption::MixedIndexType) ||
+      GpuLower::current()->kernel()->indexType() != PrimDataType::Int ||
+      index->dtype() != DataType::Index) {
+    return index;
+  }
+
+  std::unordered_map<Val*, int64_t> loop_index_bounds;
+  for (auto loop : loops) {
+    // Threads beyond the extent of a parallelized loop may still compute
+    // indices, so their bound is left to getUpperBound
+    if (!loop->isTrivial() && !loop->iter_domain()->isThread() &&
+        loop->start()->isZeroInt() && loop->stop()->isConstInt()) {
+      loop_index_bounds.emplace(
+          loop->index(), loop->stop()->evaluate().as<int64_t>() - 1);
+    }
+  }
+
+  // Split the sum into the terms whose sum is provably less than 2^31 and
+  // the rest
+  std::vector<Val*> narrow_terms;
+  std::vector<Val*> wide_terms;
+  int64_t narrow_bound = 0;
+  std::vector<Val*> to_visit({index});
+  while (!to_visit.empty()) {
+    auto term = to_visit.back();
+    to_visit.pop_back();
+    auto add = dynamic_cast<BinaryOp*>(term->definition());
+    if (add != nullptr && add->getBinaryOpType() == BinaryOpType::Add) {
+      to_visit.push_back(add->rhs());
+      to_visit.push_back(add->lhs());
+      continue;
+    }
+    std::optional<int64_t> bound;
+    if (!term->isConstInt()) {
+      bound = getUpperBound(term, loop_index_bounds);
+    }
+    if (bound.has_value() &&
+        narrow_bound + *bound <= std::numeric_limits<int32_t>::max()) {
+      narrow_terms.push_back(term);
+      narrow_bound += *bound;
+    } else {
+      wide_terms.push_back(term);
+    }
+  }
+
+  // A single variable isn't worth the casts
+  if (narrow_terms.empty() ||
+      (narrow_terms.size() == 1 &&
+       narrow_terms.front()->definition() == nullptr)) {
+    return index;
+  }
+
+  Val* narrow_sum = nullptr;
+  for (auto term : narrow_terms) {
+    auto narrowed = toInt32Index(term);
+    narrow_sum = narrow_sum == nullptr
+        ? narrowed
+        : IrBuilder::addExpr(narrow_sum, narrowed);
+  }
+  Val* result = IrBuilder::create<Val>(DataType::Index);
+  IrBuilder::create<UnaryOp>(UnaryOpType::Cast, result, narrow_sum);
+  for (auto term : wide_terms) {
+    result = IrBuilder::addExpr(result, term);
+  }
+  return result;
+}
+
+} // namespace
+
 // Producer is the inputs of an expression
 kir::TensorIndex* Index::getProducerIndex(
     TensorView* producer,
@@ -2411,6 +2515,9 @@ kir::TensorIndex* Index::getProducerIndex(
       rotated_loops,
       override_index,
       generate_pointer);
+  if (!generate_pointer) {
+    index = narrowIndexTerms(index, loops);
+  }
   index = GpuLower::current()->commonScalarMap().hoistScalar(index, loops);
   if (ir_utils::isLdMatrixOp(consumer->definition()) &&
       at::cuda::getCurrentDeviceProperties()->major < 8) {
@@ -2487,6 +2594,9 @@ kir::TensorIndex* Index::getConsumerIndex(
     DataType as_type) {
   auto index = getConsumerStridedIndices(
       consumer, loops, rotated_loops, override_index, generate_pointer);
+  if (!generate_pointer) {
+    index = narrowIndexTerms(index, loops);
+  }
   index = GpuLower::current()->commonScalarMap().hoistScalar(index, loops);
   return SimplifyingIrBuilder::create<kir::TensorIndex>(
       consumer, index, as_type);
@@ -409,6 +409,18 @@ class RootPredicateInfo {
   std::unordered_set<IterDomain*> root_ids_;
 };
 
+//! [ Mixed Index Type ]
+//!
+//! The index type is chosen for the whole kernel, so a single tensor with
+//! more than 2^31 elements makes all index math 64-bit. With
+//! NVFUSER_ENABLE=mixed_index_type, the terms of a 64-bit tensor index whose
+//! sum getUpperBound proves to be less than 2^31 are instead computed with
+//! 32-bit arithmetic, and only the result is widened before it is added to
+//! the remaining terms. These are typically the offsets within a tile, i.e.,
+//! threadIdx and the indices of loops with constant extents times constant
+//! strides, whereas the base offsets of the tile, e.g., blockIdx times a
+//! stride, stay 64-bit. Predicates and pointer indices are not narrowed.
+
 // Simple interface for IndexCompute
 // If getComputeAtAxis and more generally TensorView const model is fixed, we
 // can make the below tensorviews const.
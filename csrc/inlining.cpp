@@ -66,10 +66,11 @@ bool MaxPosCalculator::isAllowedID(
   }
 
   if (!allow_vectorize) {
-    // Avoid inlining if marked as Vectorize or Group. In the case of
+    // Avoid inlining if marked as Vectorize, Group or Bulk. In the case of
     // BestEffort and MostInlined modes, avoid Unroll as well.
     bool is_vectorize = isParallelTypeVectorize(id->getParallelType()) ||
         id->getParallelType() == ParallelType::Group ||
+        id->getParallelType() == ParallelType::Bulk ||
         (best_effort && id->getParallelType() == ParallelType::Unroll);
     allowed = allowed && !is_vectorize;
   }
@@ -11,6 +11,8 @@
 
 #include <c10/macros/Export.h>
 
+#include <algorithm>
+
 #ifdef _WIN32
 #include <c10/util/win32-headers.h>
 #else
@@ -42,10 +44,18 @@ Trace::Trace() {
   // constructor should not be used from a destructor.
   if (isOptionDisabled(DisableOption::Nvtx)) {
     record_nvtx_range_ = false;
+  } else {
+    nvtx_domain_ = nvtxDomainCreateA("nvFuser");
+  }
+  if (isOptionEnabled(EnableOption::CompileProfile)) {
+    record_profile_ = true;
   }
 }
 
 Trace::~Trace() {
+  if (nvtx_domain_ != nullptr) {
+    nvtxDomainDestroy(nvtx_domain_);
+  }
   if (log_file_ != nullptr) {
     // Print trace epilogue
     logEvent('I', "TRACE_END", ' ');
@@ -54,6 +64,81 @@ Trace::~Trace() {
   }
 }
 
+void Trace::beginAnnotatedRange(
+    const std::string& message,
+    int64_t payload) {
+  nvtxEventAttributes_t attributes = {};
+  attributes.version = NVTX_VERSION;
+  attributes.size = NVTX_EVENT_ATTRIB_STRUCT_SIZE;
+  attributes.messageType = NVTX_MESSAGE_TYPE_ASCII;
+  attributes.message.ascii = message.c_str();
+  attributes.payloadType = NVTX_PAYLOAD_TYPE_INT64;
+  attributes.payload.llValue = payload;
+  nvtxDomainRangePushEx(nvtx_domain_, &attributes);
+}
+
+void Trace::endAnnotatedRange() {
+  nvtxDomainRangePop(nvtx_domain_);
+}
+
+namespace {
+
+//! Time spent in the scopes nested in each open profiled scope of the
+//! calling thread, innermost last
+std::vector<double>& nestedScopeTimes() {
+  static thread_local std::vector<double> nested_ms;
+  return nested_ms;
+}
+
+} // namespace
+
+void Trace::beginProfileScope() {
+  nestedScopeTimes().push_back(0.0);
+}
+
+void Trace::endProfileScope(const char* name, Clock::time_point start) {
+  const std::chrono::duration<double, std::milli> d = Clock::now() - start;
+  const double elapsed_ms = d.count();
+
+  auto& nested_ms = nestedScopeTimes();
+  NVF_ERROR(!nested_ms.empty(), "No profiled scope to end: ", name);
+  const double self_ms = elapsed_ms - nested_ms.back();
+  nested_ms.pop_back();
+  if (!nested_ms.empty()) {
+    nested_ms.back() += elapsed_ms;
+  }
+
+  std::lock_guard<std::mutex> guard(profile_mutex_);
+  ScopeProfile& entry = profile_[name];
+  entry.count++;
+  entry.total_ms += elapsed_ms;
+  entry.self_ms += self_ms;
+}
+
+std::vector<ScopeProfile> Trace::profile() const {
+  std::vector<ScopeProfile> entries;
+  {
+    std::lock_guard<std::mutex> guard(profile_mutex_);
+    entries.reserve(profile_.size());
+    for (const auto& [name, entry] : profile_) {
+      entries.push_back(entry);
+      entries.back().name = name;
+    }
+  }
+  std::sort(
+      entries.begin(),
+      entries.end(),
+      [](const ScopeProfile& a, const ScopeProfile& b) {
+        return a.total_ms > b.total_ms;
+      });
+  return entries;
+}
+
+void Trace::resetProfile() {
+  std::lock_guard<std::mutex> guard(profile_mutex_);
+  profile_.clear();
+}
+
 void Trace::logEvent(char ph, const char* name, char sep) {
   const std::chrono::duration<double> d = Clock::now() - start_timestamp_;
   const double elapsed = d.count() * 1e6;
@@ -14,12 +14,28 @@
 
 // NOLINTNEXTLINE(modernize-deprecated-headers)
 #include <stdio.h>
+#include <atomic>
 #include <chrono>
 #include <cstdio>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace nvfuser {
 namespace inst {
 
+//! Aggregated time of the traced scopes of the same name, see
+//! [ Compile Profile ]
+struct ScopeProfile {
+  std::string name;
+  int64_t count = 0;
+  //! Time spent in the scopes, including the scopes nested in them
+  double total_ms = 0.0;
+  //! Time spent in the scopes, excluding the scopes nested in them
+  double self_ms = 0.0;
+};
+
 //! An optional record of selected timestamped operations, events and counters
 //!
 //! This class is not intended to be used directly. Instead, the operations
@@ -36,6 +52,29 @@ namespace inst {
 //! An easy way to view traces is to type `about://tracing` in Chrome or
 //! Chromium.
 //!
+//! [ Compile Profile ]
+//!
+//! Independently of the trace file, the durations of the traced scopes can be
+//! aggregated by name, which breaks down where the time of the first run of
+//! a fusion goes: concretization, the pre-segmenter passes, the segmenter,
+//! the heuristics and scheduling of each scheduler, each lowering pass,
+//! code generation and the NVRTC compilation. The aggregation is enabled
+//! with EnableOption::CompileProfile or setRecordProfile, and read with
+//! profile(). Profiles of single fusions are obtained by resetting the
+//! profile before their first run and reading it after.
+//!
+//! [ Annotated NVTX Ranges ]
+//!
+//! The NVTX ranges of FUSER_PERF_SCOPE are named by static strings, which
+//! don't tell which fusion or segment a kernel launch belongs to. Besides
+//! them, the runs of a FusionExecutorCache and the runs of each segment push
+//! ranges in the "nvFuser" NVTX domain, named after their fusion, runtime and
+//! cache lookup, and after the kernel, heuristic and group of the segment.
+//! The kernels are named like the ranges of their segments, see
+//! FusionExecutor::kernelName, and the payloads of the ranges are the fusion
+//! and group ids. Both kinds of ranges are disabled with
+//! NVFUSER_DISABLE=nvtx.
+//!
 class Trace : public NonCopyable {
  public:
   using Clock = std::chrono::steady_clock;
@@ -64,6 +103,35 @@ class Trace : public NonCopyable {
     }
   }
 
+  bool recordsNvtxRanges() const {
+    return record_nvtx_range_;
+  }
+
+  //! Pushes a range of the nvFuser domain, see [ Annotated NVTX Ranges ]
+  void beginAnnotatedRange(const std::string& message, int64_t payload);
+
+  void endAnnotatedRange();
+
+  bool recordsProfile() const {
+    return record_profile_.load(std::memory_order_relaxed);
+  }
+
+  void setRecordProfile(bool record) {
+    record_profile_.store(record, std::memory_order_relaxed);
+  }
+
+  //! Starts a profiled scope on the calling thread
+  void beginProfileScope();
+
+  //! Ends the innermost profiled scope of the calling thread, which started
+  //! at start
+  void endProfileScope(const char* name, Clock::time_point start);
+
+  //! The aggregated scopes, by decreasing total time
+  std::vector<ScopeProfile> profile() const;
+
+  void resetProfile();
+
  private:
   Trace();
   ~Trace();
@@ -74,6 +142,11 @@ class Trace : public NonCopyable {
   FILE* log_file_ = nullptr;
   Clock::time_point start_timestamp_;
   bool record_nvtx_range_ = true;
+  nvtxDomainHandle_t nvtx_domain_ = nullptr;
+
+  std::atomic<bool> record_profile_ = false;
+  mutable std::mutex profile_mutex_;
+  std::unordered_map<std::string, ScopeProfile> profile_;
 };
 
 //! \internal Automatic scope for a perf marker
@@ -81,15 +154,50 @@ class Trace : public NonCopyable {
 class TraceScope : public NonCopyable {
  public:
   explicit TraceScope(const char* event_name) : event_name_(event_name) {
-    Trace::instance()->beginEvent(event_name_);
+    Trace* trace = Trace::instance();
+    trace->beginEvent(event_name_);
+    if (trace->recordsProfile()) {
+      profiled_ = true;
+      trace->beginProfileScope();
+      start_ = Trace::Clock::now();
+    }
   }
 
   ~TraceScope() {
-    Trace::instance()->endEvent(event_name_);
+    Trace* trace = Trace::instance();
+    if (profiled_) {
+      trace->endProfileScope(event_name_, start_);
+    }
+    trace->endEvent(event_name_);
   }
 
  private:
   const char* event_name_ = nullptr;
+  bool profiled_ = false;
+  Trace::Clock::time_point start_;
+};
+
+//! A range of the nvFuser NVTX domain. The message is only made when NVTX
+//! is enabled.
+class AnnotatedRange : public NonCopyable {
+ public:
+  template <typename MakeMessage>
+  AnnotatedRange(int64_t payload, MakeMessage make_message) {
+    Trace* trace = Trace::instance();
+    if (trace->recordsNvtxRanges()) {
+      active_ = true;
+      trace->beginAnnotatedRange(make_message(), payload);
+    }
+  }
+
+  ~AnnotatedRange() {
+    if (active_) {
+      Trace::instance()->endAnnotatedRange();
+    }
+  }
+
+ private:
+  bool active_ = false;
 };
 
 #define FUSER_MACRO_CONCAT2(a, b) a##b
@@ -0,0 +1,132 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <intermediate_arena.h>
+
+#include <instrumentation.h>
+
+#include <ATen/cuda/CUDAContext.h>
+#include <c10/util/irange.h>
+
+#include <algorithm>
+#include <numeric>
+
+namespace nvfuser {
+
+namespace {
+
+// Same as the alignment of cudaMalloc, which is more than enough for
+// vectorized accesses
+constexpr int64_t kArenaAlignment = 256;
+
+bool overlaps(
+    const IntermediateArena::Buffer& a,
+    const IntermediateArena::Buffer& b) {
+  return a.first_use <= b.last_use && b.first_use <= a.last_use;
+}
+
+} // namespace
+
+int64_t IntermediateArena::planOffsets(std::vector<Buffer>& buffers) {
+  // Greedily place the largest buffers first. Each buffer goes into the
+  // lowest gap that is not used by any already placed buffer alive at the
+  // same time.
+  std::vector<size_t> order(buffers.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    return buffers.at(a).nbytes > buffers.at(b).nbytes;
+  });
+
+  int64_t total_size = 0;
+  std::vector<const Buffer*> placed;
+  for (auto buffer_i : order) {
+    auto& buffer = buffers.at(buffer_i);
+
+    std::vector<const Buffer*> conflicts;
+    for (auto other : placed) {
+      if (overlaps(buffer, *other)) {
+        conflicts.push_back(other);
+      }
+    }
+    std::sort(
+        conflicts.begin(),
+        conflicts.end(),
+        [](const Buffer* a, const Buffer* b) { return a->offset < b->offset; });
+
+    int64_t offset = 0;
+    for (auto other : conflicts) {
+      if (offset + buffer.nbytes <= other->offset) {
+        break;
+      }
+      offset = std::max(
+          offset,
+          roundUpToMultiple(other->offset + other->nbytes, kArenaAlignment));
+    }
+
+    buffer.offset = offset;
+    total_size = std::max(total_size, offset + buffer.nbytes);
+    placed.push_back(&buffer);
+  }
+
+  return total_size;
+}
+
+void IntermediateArena::addLayout(
+    size_t cache_id,
+    std::vector<Buffer> buffers) {
+  FUSER_PERF_SCOPE("IntermediateArena::addLayout");
+  Layout layout;
+  layout.buffers = std::move(buffers);
+  layout.size = planOffsets(layout.buffers);
+  layouts_[cache_id] = std::move(layout);
+}
+
+std::vector<std::vector<at::Tensor>> IntermediateArena::getOutputBuffers(
+    size_t cache_id,
+    const std::vector<int64_t>& num_segment_outputs,
+    const c10::Device& device) {
+  FUSER_PERF_SCOPE("IntermediateArena::getOutputBuffers");
+  const auto& layout = layouts_.at(cache_id);
+  if (layout.buffers.empty()) {
+    return {};
+  }
+
+  // Regions of the arena are reused without any synchronization other than
+  // the ordering of kernels on a stream
+  auto stream = at::cuda::getCurrentCUDAStream(device.index());
+  if (!stream_.has_value() || stream_.value() != stream ||
+      (arena_.defined() && arena_.device() != device)) {
+    arena_ = at::Tensor();
+    stream_ = stream;
+  }
+  if (!arena_.defined() || (int64_t)arena_.numel() < layout.size) {
+    arena_ = at::empty(
+        {layout.size}, at::TensorOptions().dtype(at::kByte).device(device));
+  }
+
+  std::vector<std::vector<at::Tensor>> output_buffers;
+  output_buffers.reserve(num_segment_outputs.size());
+  for (auto num_outputs : num_segment_outputs) {
+    output_buffers.emplace_back(num_outputs);
+  }
+
+  for (const auto& buffer : layout.buffers) {
+    const auto item_size = (int64_t)c10::elementSize(buffer.type);
+    NVF_ERROR(buffer.offset % item_size == 0);
+    output_buffers.at(buffer.first_use).at(buffer.output_index) =
+        at::empty({0}, at::TensorOptions().dtype(buffer.type).device(device))
+            .set_(
+                arena_.storage(),
+                buffer.offset / item_size,
+                buffer.sizes,
+                buffer.strides);
+  }
+
+  return output_buffers;
+}
+
+} // namespace nvfuser
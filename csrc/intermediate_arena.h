@@ -0,0 +1,112 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <exceptions.h>
+#include <utils.h>
+
+#include <ATen/ATen.h>
+#include <c10/cuda/CUDAStream.h>
+
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace nvfuser {
+
+//! [ Arena for Segment Intermediates ]
+//!
+//! Tensors passed from one segment of a segmented fusion to later segments
+//! are allocated when the producing segment runs and freed by
+//! ArgumentManager after their last consumer has run. For fusions with many
+//! small segments, this is a steady stream of allocations and frees through
+//! the caching allocator on every run.
+//!
+//! Instead, FusionKernelRuntime places these tensors in a single device
+//! buffer that lives as long as the runtime. The first run with a given
+//! input cache id allocates the intermediates as usual, and the runtime
+//! records their sizes, strides and lifetimes, i.e., the positions in the
+//! run order of the producing segment and of the last consuming segment.
+//! From that, a layout is planned that gives each intermediate an offset in
+//! the arena such that no two intermediates that are alive at the same time
+//! overlap. Subsequent runs with that cache id pass views of the arena to
+//! FusionExecutor::setOutputBuffers instead of allocating.
+//!
+//! All segments are launched on the same stream, so a region of the arena
+//! can be reused as soon as the kernel that last reads it has been launched.
+//! The same holds across runs, as long as they are on the same stream. If
+//! the stream changes, a new arena is allocated.
+class IntermediateArena : public NonCopyable {
+ public:
+  //! A tensor produced by one segment and consumed by later segments
+  struct Buffer {
+    //! Position of the producing segment in the run order
+    int64_t first_use = 0;
+    //! Position of the last consuming segment in the run order
+    int64_t last_use = 0;
+    //! Index of this tensor in the outputs of the producing segment
+    int64_t output_index = 0;
+    std::vector<int64_t> sizes;
+    std::vector<int64_t> strides;
+    at::ScalarType type = at::ScalarType::Undefined;
+    int64_t nbytes = 0;
+    //! Byte offset in the arena, set by addLayout
+    int64_t offset = 0;
+  };
+
+  //! Plan the placement of the given buffers and save it for the cache id
+  void addLayout(size_t cache_id, std::vector<Buffer> buffers);
+
+  bool hasLayout(size_t cache_id) const {
+    return layouts_.count(cache_id) > 0;
+  }
+
+  void evictLayout(size_t cache_id) {
+    layouts_.erase(cache_id);
+  }
+
+  //! Views of the arena to be used as outputs of each segment, indexed by
+  //! the position in the run order and the output index of the segment.
+  //! Outputs not placed in the arena are left undefined. Grows the arena if
+  //! needed.
+  std::vector<std::vector<at::Tensor>> getOutputBuffers(
+      size_t cache_id,
+      const std::vector<int64_t>& num_segment_outputs,
+      const c10::Device& device);
+
+  //! Size of the layout planned for the cache id in bytes
+  int64_t layoutSize(size_t cache_id) const {
+    return layouts_.at(cache_id).size;
+  }
+
+  //! Currently allocated size of the arena in bytes
+  int64_t size() const {
+    return arena_.defined() ? (int64_t)arena_.numel() : 0;
+  }
+
+ private:
+  struct Layout {
+    std::vector<Buffer> buffers;
+    int64_t size = 0;
+  };
+
+  //! Set the offset of each buffer and return the total size
+  static int64_t planOffsets(std::vector<Buffer>& buffers);
+
+ private:
+  //! Layouts by input cache id
+  std::unordered_map<size_t, Layout> layouts_;
+
+  //! Bytes of the arena
+  at::Tensor arena_;
+
+  //! Stream the arena was last used on
+  std::optional<c10::cuda::CUDAStream> stream_;
+};
+
+} // namespace nvfuser
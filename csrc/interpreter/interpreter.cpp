@@ -0,0 +1,410 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <instrumentation.h>
+#include <interpreter/interpreter.h>
+#include <ir/all_nodes.h>
+#include <ir/utils.h>
+
+#include <ATen/cuda/CUDAContext.h>
+#include <c10/cuda/CUDAGuard.h>
+#include <c10/util/irange.h>
+
+#include <numeric>
+#include <unordered_map>
+
+namespace nvfuser {
+
+namespace {
+
+using interpreter::ElementType;
+using interpreter::OpCode;
+
+std::optional<ElementType> toElementType(DataType dtype) {
+  if (dtype == DataType::Float) {
+    return ElementType::Float;
+  }
+  if (dtype == DataType::Half) {
+    return ElementType::Half;
+  }
+  if (dtype == DataType::BFloat16) {
+    return ElementType::BFloat16;
+  }
+  return std::nullopt;
+}
+
+std::optional<OpCode> toOpCode(UnaryOpType op_type, DataType out_dtype) {
+  // Casts between the supported types only round
+  if (op_type == UnaryOpType::Cast) {
+    switch (toElementType(out_dtype).value()) {
+      case ElementType::Half:
+        return OpCode::RoundToHalf;
+      case ElementType::BFloat16:
+        return OpCode::RoundToBFloat16;
+      default:
+        return OpCode::Set;
+    }
+  }
+  // Other math is done in float, so it can only produce float
+  if (out_dtype != DataType::Float) {
+    return std::nullopt;
+  }
+  switch (op_type) {
+    case UnaryOpType::Abs:
+      return OpCode::Abs;
+    case UnaryOpType::Cos:
+      return OpCode::Cos;
+    case UnaryOpType::Erf:
+      return OpCode::Erf;
+    case UnaryOpType::Exp:
+      return OpCode::Exp;
+    case UnaryOpType::Log:
+      return OpCode::Log;
+    case UnaryOpType::Neg:
+      return OpCode::Neg;
+    case UnaryOpType::Reciprocal:
+      return OpCode::Reciprocal;
+    case UnaryOpType::Relu:
+      return OpCode::Relu;
+    case UnaryOpType::Rsqrt:
+      return OpCode::Rsqrt;
+    case UnaryOpType::Sigmoid:
+      return OpCode::Sigmoid;
+    case UnaryOpType::Silu:
+      return OpCode::Silu;
+    case UnaryOpType::Sin:
+      return OpCode::Sin;
+    case UnaryOpType::Sqrt:
+      return OpCode::Sqrt;
+    case UnaryOpType::Tanh:
+      return OpCode::Tanh;
+    default:
+      return std::nullopt;
+  }
+}
+
+std::optional<OpCode> toOpCode(BinaryOpType op_type, DataType out_dtype) {
+  if (out_dtype != DataType::Float) {
+    return std::nullopt;
+  }
+  switch (op_type) {
+    case BinaryOpType::Add:
+      return OpCode::Add;
+    case BinaryOpType::Div:
+      return OpCode::Div;
+    case BinaryOpType::Max:
+      return OpCode::Max;
+    case BinaryOpType::Min:
+      return OpCode::Min;
+    case BinaryOpType::Mul:
+      return OpCode::Mul;
+    case BinaryOpType::Pow:
+      return OpCode::Pow;
+    case BinaryOpType::Sub:
+      return OpCode::Sub;
+    default:
+      return std::nullopt;
+  }
+}
+
+std::optional<OpCode> toOpCode(Expr* expr, TensorView* out) {
+  if (auto uop = dynamic_cast<UnaryOp*>(expr)) {
+    return toOpCode(uop->getUnaryOpType(), out->dtype());
+  }
+  if (auto bop = dynamic_cast<BinaryOp*>(expr)) {
+    return toOpCode(bop->getBinaryOpType(), out->dtype());
+  }
+  if (expr->isA<BroadcastOp>() ||
+      (expr->isA<LoadStoreOp>() &&
+       expr->as<LoadStoreOp>()->opType() == LoadStoreOpType::Set)) {
+    return OpCode::Set;
+  }
+  return std::nullopt;
+}
+
+std::optional<float> toFloat(const PolymorphicValue& value) {
+  if (value.is<double>()) {
+    return (float)value.as<double>();
+  }
+  if (value.is<int64_t>()) {
+    return (float)value.as<int64_t>();
+  }
+  if (value.is<bool>()) {
+    return value.as<bool>() ? 1.0f : 0.0f;
+  }
+  return std::nullopt;
+}
+
+bool isSupportedTensor(TensorView* tv) {
+  if (!toElementType(tv->dtype()).has_value() || tv->hasReduction() ||
+      tv->hasRFactor() || tv->hasAllocation()) {
+    return false;
+  }
+  const auto& rfactor_domain = tv->getMaybeRFactorDomain();
+  return (int64_t)rfactor_domain.size() <= interpreter::kMaxDims &&
+      std::none_of(
+             rfactor_domain.begin(),
+             rfactor_domain.end(),
+             [](IterDomain* id) { return id->hasExpandedExtent(); });
+}
+
+} // namespace
+
+std::unique_ptr<PointwiseInterpreter> PointwiseInterpreter::tryCreate(
+    Fusion* fusion) {
+  FUSER_PERF_SCOPE("PointwiseInterpreter::tryCreate");
+  std::unique_ptr<PointwiseInterpreter> interp(new PointwiseInterpreter());
+  interpreter::Program& program = interp->program_;
+
+  // The outputs span the iteration space
+  std::optional<size_t> num_dims;
+  for (Val* output : fusion->outputs()) {
+    auto tv = dynamic_cast<TensorView*>(output);
+    if (tv == nullptr || tv->isFusionInput() || tv->hasBroadcast() ||
+        fusion->getOutputAlias(output).first != nullptr) {
+      return nullptr;
+    }
+    if (!num_dims.has_value()) {
+      num_dims = tv->getMaybeRFactorDomain().size();
+    }
+    if (tv->getMaybeRFactorDomain().size() != *num_dims) {
+      return nullptr;
+    }
+  }
+  if (!num_dims.has_value() ||
+      fusion->outputs().size() > (size_t)interpreter::kMaxTensors) {
+    return nullptr;
+  }
+  const auto tvs = ir_utils::allTvs(fusion);
+  if (!std::all_of(tvs.begin(), tvs.end(), isSupportedTensor)) {
+    return nullptr;
+  }
+  program.num_dims = (int8_t)*num_dims;
+
+  std::unordered_map<Val*, int8_t> registers;
+  auto allotRegister = [&](Val* val) -> std::optional<int8_t> {
+    if (registers.size() >= (size_t)interpreter::kMaxRegisters) {
+      return std::nullopt;
+    }
+    auto reg = (int8_t)registers.size();
+    registers.emplace(val, reg);
+    return reg;
+  };
+  const auto& fusion_inputs = fusion->inputs();
+  auto argIndex = [&](Val* input) {
+    return (int64_t)std::distance(
+        fusion_inputs.begin(),
+        std::find(fusion_inputs.begin(), fusion_inputs.end(), input));
+  };
+
+  // Register of an operand, which is loaded or initialized on first use
+  auto operandRegister = [&](Val* val) -> std::optional<int8_t> {
+    if (auto it = registers.find(val); it != registers.end()) {
+      return it->second;
+    }
+    if (auto tv = dynamic_cast<TensorView*>(val)) {
+      if (!tv->isFusionInput() ||
+          interp->input_tensors_.size() >= (size_t)interpreter::kMaxTensors) {
+        return std::nullopt;
+      }
+      auto reg = allotRegister(tv);
+      if (!reg.has_value()) {
+        return std::nullopt;
+      }
+      interpreter::TensorArg& arg = program.inputs[program.num_inputs++];
+      arg.dtype = toElementType(tv->dtype()).value();
+      arg.reg = *reg;
+      interp->input_tensors_.push_back({argIndex(tv), {}, {}});
+      return reg;
+    }
+    if (val->isFusionInput()) {
+      auto reg = allotRegister(val);
+      if (reg.has_value()) {
+        interp->input_scalars_.push_back({argIndex(val), *reg});
+      }
+      return reg;
+    }
+    if (!val->isConstScalar()) {
+      return std::nullopt;
+    }
+    auto value = toFloat(val->evaluate());
+    auto reg = value.has_value() ? allotRegister(val) : std::nullopt;
+    if (reg.has_value()) {
+      program.registers[*reg] = *value;
+    }
+    return reg;
+  };
+
+  const auto exprs = fusion->exprs();
+  for (Expr* expr : exprs) {
+    // Scalars are evaluated where they are used
+    if (ir_utils::isScalarOp(expr)) {
+      continue;
+    }
+    if (expr->outputs().size() != 1 || !expr->output(0)->isA<TensorView>() ||
+        expr->inputs().empty() || expr->inputs().size() > 2 ||
+        program.num_instructions >= interpreter::kMaxInstructions) {
+      return nullptr;
+    }
+    auto out = expr->output(0)->as<TensorView>();
+    auto op = toOpCode(expr, out);
+    auto lhs = operandRegister(expr->input(0));
+    auto rhs = expr->inputs().size() > 1 ? operandRegister(expr->input(1))
+                                         : lhs;
+    auto reg = allotRegister(out);
+    if (!op.has_value() || !lhs.has_value() || !rhs.has_value() ||
+        !reg.has_value()) {
+      return nullptr;
+    }
+    program.instructions[program.num_instructions++] = {*op, *reg, *lhs, *rhs};
+  }
+  program.num_registers = (int8_t)registers.size();
+
+  for (Val* output : fusion->outputs()) {
+    auto it = registers.find(output);
+    if (it == registers.end()) {
+      return nullptr;
+    }
+    interpreter::TensorArg& arg = program.outputs[program.num_outputs++];
+    arg.dtype = toElementType(output->dtype()).value();
+    arg.reg = it->second;
+    interp->output_dtypes_.push_back(output->dtype());
+  }
+
+  // Walk back from the outputs to find the axes of the iteration space
+  // along which each tensor is indexed. Only broadcasts drop axes.
+  std::unordered_map<TensorView*, std::vector<int64_t>> axes;
+  auto setAxes = [&axes](TensorView* tv, std::vector<int64_t> tv_axes) {
+    auto [it, inserted] = axes.emplace(tv, tv_axes);
+    return inserted || it->second == tv_axes;
+  };
+  std::vector<int64_t> all_axes(*num_dims);
+  std::iota(all_axes.begin(), all_axes.end(), 0);
+  for (auto output : ir_utils::filterByType<TensorView>(fusion->outputs())) {
+    setAxes(output, all_axes);
+  }
+  for (auto it = exprs.rbegin(); it != exprs.rend(); ++it) {
+    Expr* expr = *it;
+    if (ir_utils::isScalarOp(expr)) {
+      continue;
+    }
+    auto out_it = axes.find(expr->output(0)->as<TensorView>());
+    if (out_it == axes.end()) {
+      return nullptr;
+    }
+    const std::vector<int64_t> out_axes = out_it->second;
+    for (auto in : ir_utils::filterByType<TensorView>(expr->inputs())) {
+      std::vector<int64_t> in_axes;
+      if (auto bop = dynamic_cast<BroadcastOp*>(expr)) {
+        const auto& flags = bop->getBroadcastDimFlags();
+        for (auto i : c10::irange(flags.size())) {
+          if (!flags.at(i)) {
+            in_axes.push_back(out_axes.at(i));
+          }
+        }
+      } else {
+        in_axes = out_axes;
+      }
+      if (in_axes.size() != in->getMaybeRFactorDomain().size() ||
+          !setAxes(in, in_axes)) {
+        return nullptr;
+      }
+    }
+  }
+
+  for (InputTensor& input : interp->input_tensors_) {
+    auto tv = fusion_inputs.at(input.arg_index)->as<TensorView>();
+    input.axes = axes.at(tv);
+    for (IterDomain* id : tv->getMaybeRFactorDomain()) {
+      input.is_broadcast.push_back(id->isBroadcast());
+    }
+  }
+  return interp;
+}
+
+std::optional<std::vector<at::Tensor>> PointwiseInterpreter::run(
+    const KernelArgumentHolder& args) const {
+  FUSER_PERF_SCOPE("PointwiseInterpreter::run");
+  interpreter::Program program = program_;
+
+  std::vector<int64_t> shape(program.num_dims, 1);
+  std::vector<const at::Tensor*> tensors;
+  for (const InputTensor& input : input_tensors_) {
+    const PolymorphicValue* arg = args[input.arg_index];
+    if (!arg->is<at::Tensor>()) {
+      return std::nullopt;
+    }
+    const auto& tensor = arg->as<at::Tensor>();
+    if (!tensor.is_cuda() || tensor.dim() != (int64_t)input.axes.size()) {
+      return std::nullopt;
+    }
+    for (auto i : c10::irange(tensor.dim())) {
+      int64_t& extent = shape.at(input.axes.at(i));
+      if (tensor.size(i) != 1) {
+        if (input.is_broadcast.at(i) ||
+            (extent != 1 && extent != tensor.size(i))) {
+          return std::nullopt;
+        }
+        extent = tensor.size(i);
+      }
+    }
+    tensors.push_back(&tensor);
+  }
+
+  for (auto i : c10::irange(tensors.size())) {
+    const InputTensor& input = input_tensors_.at(i);
+    const at::Tensor& tensor = *tensors.at(i);
+    interpreter::TensorArg& tensor_arg = program.inputs[i];
+    tensor_arg.data = tensor.data_ptr();
+    for (auto j : c10::irange(tensor.dim())) {
+      const int64_t axis = input.axes.at(j);
+      // Only broadcast dimensions may be expanded
+      if (!input.is_broadcast.at(j) && tensor.size(j) != shape.at(axis)) {
+        return std::nullopt;
+      }
+      tensor_arg.strides[axis] = tensor.size(j) == 1 ? 0 : tensor.stride(j);
+    }
+  }
+
+  for (const InputScalar& input : input_scalars_) {
+    auto value = toFloat(*args[input.arg_index]);
+    if (!value.has_value()) {
+      return std::nullopt;
+    }
+    program.registers[input.reg] = *value;
+  }
+
+  int64_t numel = 1;
+  for (auto i : c10::irange(shape.size())) {
+    program.shape[i] = shape.at(i);
+    numel *= shape.at(i);
+  }
+
+  c10::cuda::CUDAGuard dg(args.getDeviceIndex());
+  std::vector<at::Tensor> outputs;
+  outputs.reserve(output_dtypes_.size());
+  for (auto i : c10::irange(output_dtypes_.size())) {
+    outputs.push_back(at::empty(
+        shape,
+        at::TensorOptions()
+            .dtype(data_type_to_aten(output_dtypes_.at(i)))
+            .device(at::kCUDA, args.getDeviceIndex())));
+    program.outputs[i].data = outputs.back().data_ptr();
+  }
+
+  if (numel > 0) {
+    cudaError_t error = interpreter::launchProgram(
+        program, numel, at::cuda::getCurrentCUDAStream());
+    NVF_ERROR(
+        error == cudaSuccess,
+        "Failed to launch the interpreted pointwise kernel: ",
+        cudaGetErrorString(error));
+  }
+  return outputs;
+}
+
+} // namespace nvfuser
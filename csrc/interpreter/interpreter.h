@@ -0,0 +1,93 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <executor_kernel_arg.h>
+#include <fusion.h>
+#include <interpreter/program.h>
+#include <type.h>
+
+#include <ATen/core/Tensor.h>
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace nvfuser {
+
+//! [ Interpreted Pointwise Kernels ]
+//!
+//! Even with AsyncCompile, a new fusion is evaluated with ATen in the
+//! meantime, one kernel per expression. Most of the fusions seen for the
+//! first time are however short chains of pointwise ops with broadcasts,
+//! e.g., a bias add followed by an activation. For those, a single kernel
+//! precompiled by nvcc, see interpreter/kernel.cu, interprets the fusion
+//! instead:
+//!
+//!   - Every tensor and scalar of the fusion is assigned a float register.
+//!   - Scalars are either constants or fusion inputs, whose values are put
+//!     into the registers before the launch.
+//!   - Each expression becomes one instruction. Casts to Half and BFloat16
+//!     round their values, and all other math is done in float.
+//!   - BroadcastOp only copies its register. Instead, each input tensor is
+//!     given the axes of the iteration space along which it is read, which
+//!     are found by walking back from the outputs. Broadcast dimensions are
+//!     read with stride zero.
+//!
+//! The iteration space is the shape of the outputs, which are allocated
+//! contiguously. Only fusions of UnaryOp, BinaryOp, BroadcastOp and Set on
+//! Float, Half and BFloat16 tensors without broadcast outputs, reshapes,
+//! allocation domains or aliases are interpreted, and the number of
+//! registers, tensors and instructions is limited by interpreter::Program.
+//!
+//! When EnableOption::InterpretedPointwise is set, FusionKernelRuntime
+//! translates its complete fusion into a program once. Until the kernels
+//! compiled in the background are ready, see [ Asynchronous Compilation ],
+//! FusionExecutorCache runs the program instead.
+class PointwiseInterpreter {
+ public:
+  //! Translates fusion into a program, or returns nullptr if some part of
+  //! it cannot be interpreted
+  static std::unique_ptr<PointwiseInterpreter> tryCreate(Fusion* fusion);
+
+  //! Runs the program on the inputs of the fusion. Returns nullopt if the
+  //! inputs are not CUDA tensors or their shapes don't broadcast.
+  std::optional<std::vector<at::Tensor>> run(
+      const KernelArgumentHolder& args) const;
+
+ private:
+  PointwiseInterpreter() = default;
+
+  //! Where an input tensor is found in the arguments and how its
+  //! dimensions map to the axes of the iteration space
+  struct InputTensor {
+    int64_t arg_index = 0;
+    std::vector<int64_t> axes;
+    std::vector<bool> is_broadcast;
+  };
+
+  //! Where an input scalar is found in the arguments and its register
+  struct InputScalar {
+    int64_t arg_index = 0;
+    int8_t reg = 0;
+  };
+
+  //! Program without the shape and the tensor data, which are filled in
+  //! by run
+  interpreter::Program program_;
+
+  //! Parallel to program_.inputs
+  std::vector<InputTensor> input_tensors_;
+
+  std::vector<InputScalar> input_scalars_;
+
+  //! Parallel to program_.outputs
+  std::vector<DataType> output_dtypes_;
+};
+
+} // namespace nvfuser
@@ -0,0 +1,171 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+
+// Warning: this file should not include any header from nvFuser or pytorch
+// (except raw headers). See [ Interpreted Pointwise Kernels ].
+
+#include <interpreter/program.h>
+
+#include <cuda_bf16.h>
+#include <cuda_fp16.h>
+
+#include <cstdint>
+
+namespace nvfuser::interpreter {
+
+namespace {
+
+constexpr int kBlockSize = 256;
+constexpr int64_t kMaxBlocks = 65535;
+
+// Follows fmax and fmin of runtime/helpers.cu, which propagate NaNs
+__device__ float propagateNanMax(float a, float b) {
+  return a != a ? a : (b != b ? b : fmaxf(a, b));
+}
+
+__device__ float propagateNanMin(float a, float b) {
+  return a != a ? a : (b != b ? b : fminf(a, b));
+}
+
+__device__ float sigmoid(float x) {
+  return 1.0f / (1.0f + expf(-x));
+}
+
+__device__ float load(const TensorArg& arg, int64_t offset) {
+  switch (arg.dtype) {
+    case ElementType::Half:
+      return __half2float(static_cast<const __half*>(arg.data)[offset]);
+    case ElementType::BFloat16:
+      return __bfloat162float(
+          static_cast<const __nv_bfloat16*>(arg.data)[offset]);
+    default:
+      return static_cast<const float*>(arg.data)[offset];
+  }
+}
+
+__device__ void store(const TensorArg& arg, int64_t offset, float value) {
+  switch (arg.dtype) {
+    case ElementType::Half:
+      static_cast<__half*>(arg.data)[offset] = __float2half(value);
+      break;
+    case ElementType::BFloat16:
+      static_cast<__nv_bfloat16*>(arg.data)[offset] = __float2bfloat16(value);
+      break;
+    default:
+      static_cast<float*>(arg.data)[offset] = value;
+  }
+}
+
+__device__ float evaluate(OpCode op, float a, float b) {
+  switch (op) {
+    case OpCode::Set:
+      return a;
+    case OpCode::Abs:
+      return fabsf(a);
+    case OpCode::Cos:
+      return cosf(a);
+    case OpCode::Erf:
+      return erff(a);
+    case OpCode::Exp:
+      return expf(a);
+    case OpCode::Log:
+      return logf(a);
+    case OpCode::Neg:
+      return -a;
+    case OpCode::Reciprocal:
+      return 1.0f / a;
+    case OpCode::Relu:
+      return a <= 0.0f ? 0.0f : a;
+    case OpCode::Rsqrt:
+      return rsqrtf(a);
+    case OpCode::Sigmoid:
+      return sigmoid(a);
+    case OpCode::Silu:
+      return a * sigmoid(a);
+    case OpCode::Sin:
+      return sinf(a);
+    case OpCode::Sqrt:
+      return sqrtf(a);
+    case OpCode::Tanh:
+      return tanhf(a);
+    case OpCode::RoundToHalf:
+      return __half2float(__float2half(a));
+    case OpCode::RoundToBFloat16:
+      return __bfloat162float(__float2bfloat16(a));
+    case OpCode::Add:
+      return a + b;
+    case OpCode::Div:
+      return a / b;
+    case OpCode::Max:
+      return propagateNanMax(a, b);
+    case OpCode::Min:
+      return propagateNanMin(a, b);
+    case OpCode::Mul:
+      return a * b;
+    case OpCode::Pow:
+      return powf(a, b);
+    case OpCode::Sub:
+      return a - b;
+  }
+  return a;
+}
+
+// Each thread evaluates the program for the elements of the grid-stride
+// loop. Outputs are contiguous, so the linear index is their offset.
+__global__ void interpretProgram(const Program program, int64_t numel) {
+  float registers[kMaxRegisters];
+  for (int i = 0; i < program.num_registers; ++i) {
+    registers[i] = program.registers[i];
+  }
+
+  for (int64_t index = (int64_t)blockIdx.x * blockDim.x + threadIdx.x;
+       index < numel;
+       index += (int64_t)gridDim.x * blockDim.x) {
+    int64_t coordinates[kMaxDims];
+    int64_t remainder = index;
+    for (int d = program.num_dims - 1; d >= 0; --d) {
+      coordinates[d] = remainder % program.shape[d];
+      remainder /= program.shape[d];
+    }
+
+    for (int i = 0; i < program.num_inputs; ++i) {
+      const TensorArg& input = program.inputs[i];
+      int64_t offset = 0;
+      for (int d = 0; d < program.num_dims; ++d) {
+        offset += coordinates[d] * input.strides[d];
+      }
+      registers[input.reg] = load(input, offset);
+    }
+
+    for (int i = 0; i < program.num_instructions; ++i) {
+      const Instruction& inst = program.instructions[i];
+      registers[inst.out] =
+          evaluate(inst.op, registers[inst.lhs], registers[inst.rhs]);
+    }
+
+    for (int i = 0; i < program.num_outputs; ++i) {
+      const TensorArg& output = program.outputs[i];
+      store(output, index, registers[output.reg]);
+    }
+  }
+}
+
+} // namespace
+
+cudaError_t launchProgram(
+    const Program& program,
+    int64_t numel,
+    cudaStream_t stream) {
+  int64_t blocks = (numel + kBlockSize - 1) / kBlockSize;
+  blocks = blocks < kMaxBlocks ? blocks : kMaxBlocks;
+  interpretProgram<<<(unsigned int)blocks, kBlockSize, 0, stream>>>(
+      program, numel);
+  return cudaGetLastError();
+}
+
+} // namespace nvfuser::interpreter
@@ -0,0 +1,103 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+// Warning: this header is shared with interpreter/kernel.cu, which is
+// compiled by nvcc as C++17, so it must not include any header from nvFuser
+// or pytorch.
+
+#include <cuda_runtime.h>
+
+#include <cstdint>
+
+namespace nvfuser::interpreter {
+
+//! Limits of the programs the precompiled kernel runs. All of Program is
+//! passed as a kernel parameter, which must stay below 4KB.
+constexpr int kMaxDims = 8;
+constexpr int kMaxTensors = 12;
+constexpr int kMaxRegisters = 64;
+constexpr int kMaxInstructions = 128;
+
+enum class OpCode : int8_t {
+  // out = lhs
+  Set,
+  // Unary ops, out = op(lhs)
+  Abs,
+  Cos,
+  Erf,
+  Exp,
+  Log,
+  Neg,
+  Reciprocal,
+  Relu,
+  Rsqrt,
+  Sigmoid,
+  Silu,
+  Sin,
+  Sqrt,
+  Tanh,
+  // Rounds lhs to the precision of a reduced precision type and back
+  RoundToHalf,
+  RoundToBFloat16,
+  // Binary ops, out = op(lhs, rhs)
+  Add,
+  Div,
+  Max,
+  Min,
+  Mul,
+  Pow,
+  Sub,
+};
+
+//! Element types of the tensors. Everything is computed in float.
+enum class ElementType : int8_t { Float, Half, BFloat16 };
+
+struct Instruction {
+  OpCode op = OpCode::Set;
+  int8_t out = 0;
+  int8_t lhs = 0;
+  int8_t rhs = 0;
+};
+
+//! A tensor loaded into or stored from a register. Strides are in elements
+//! and are zero along broadcast dimensions.
+struct TensorArg {
+  void* data = nullptr;
+  int64_t strides[kMaxDims] = {};
+  ElementType dtype = ElementType::Float;
+  int8_t reg = 0;
+};
+
+//! A straight-line program evaluated for each element of the iteration space
+//! shape. The registers are initialized with the values of the scalars, then
+//! the inputs are loaded, the instructions are run in order and the outputs
+//! are stored.
+struct Program {
+  int64_t shape[kMaxDims] = {};
+  int8_t num_dims = 0;
+  int8_t num_inputs = 0;
+  int8_t num_outputs = 0;
+  int8_t num_registers = 0;
+  int16_t num_instructions = 0;
+  TensorArg inputs[kMaxTensors];
+  TensorArg outputs[kMaxTensors];
+  float registers[kMaxRegisters] = {};
+  Instruction instructions[kMaxInstructions];
+};
+
+static_assert(sizeof(Program) < 4096, "Program must fit in kernel parameters");
+
+//! Runs program over its numel elements on stream and returns the launch
+//! error, if any
+cudaError_t launchProgram(
+    const Program& program,
+    int64_t numel,
+    cudaStream_t stream);
+
+} // namespace nvfuser::interpreter
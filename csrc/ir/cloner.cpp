@@ -13,7 +13,8 @@
 
 namespace nvfuser {
 
-IrCloner::IrCloner(IrContainer* container) : ir_container_(container) {}
+IrCloner::IrCloner(IrContainer* container, bool keep_names)
+    : ir_container_(container), keep_names_(keep_names) {}
 
 Statement* IrCloner::clone(const Statement* statement) {
   if (statement == nullptr) {
@@ -32,8 +32,11 @@ class IrCloner {
   friend class IrBuilder;
 
  public:
+  //! Clones into another container keep the names of the statements they
+  //! are cloned from, unless keep_names is false, e.g., when the statements
+  //! of several fusions are cloned into one.
   // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init)
-  explicit IrCloner(IrContainer* container);
+  explicit IrCloner(IrContainer* container, bool keep_names = true);
   virtual ~IrCloner() = default;
 
   Statement* clone(const Statement* statement);
@@ -97,6 +100,15 @@ class IrCloner {
     return ir_container_;
   }
 
+  bool keepsNames() const {
+    return keep_names_;
+  }
+
+  //! Reserve room for the clones of num_statements statements
+  void reserve(size_t num_statements) {
+    clones_map_.reserve(num_statements);
+  }
+
  protected:
   void registerClone(const Statement* src, Statement* clone);
   virtual Statement* handle(const Statement* s);
@@ -110,6 +122,9 @@ class IrCloner {
   // The destination Fusion container
   IrContainer* ir_container_ = nullptr;
 
+  // Whether clones into another container keep the names of the originals
+  bool keep_names_ = true;
+
   // Builder to make all the new nodes
   IrBuilder builder_;
 };
@@ -150,7 +165,7 @@ T* IrBuilder::clone(const T* src, IrCloner* ir_cloner) {
 
   dest_container->registerStmt(IrBuilderPasskey(dest_container), dest_stmt);
 
-  if (src_container != dest_container) {
+  if (src_container != dest_container && ir_cloner->keepsNames()) {
     dest_stmt->setName(IrBuilderPasskey(dest_container), src_stmt->name());
   }
 
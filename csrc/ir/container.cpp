@@ -51,6 +51,11 @@ void swap(IrContainer& a, IrContainer& b) noexcept {
 IrCloner IrContainer::copy(const IrContainer* from, IrContainer* to) {
   to->clear();
   IrCloner ir_cloner(to);
+  // Every statement is cloned once, so size the maps up front instead of
+  // rehashing them as they grow
+  ir_cloner.reserve(from->vals().size() + from->unordered_exprs().size());
+  to->vals_.reserve(from->vals().size());
+  to->exprs_.reserve(from->unordered_exprs().size());
 
   // Copy values in deterministic order
   // deterministic_vals can contain special values like one_val_, zero_val_, etc
@@ -116,6 +121,7 @@ IrContainer::~IrContainer() {
 
 //! Register the Statement with this container
 void IrContainer::registerStmt(IrBuilderPasskey, Statement* stmt) {
+  std::lock_guard<std::recursive_mutex> guard(mutex_);
   if (stmt->isVal()) {
     registerVal(stmt->asVal());
   } else {
@@ -125,15 +131,18 @@ void IrContainer::registerStmt(IrBuilderPasskey, Statement* stmt) {
 
 //! Register the Val with this container
 void IrContainer::registerVal(IrBuilderPasskey, Val* val) {
+  std::lock_guard<std::recursive_mutex> guard(mutex_);
   registerVal(val);
 }
 
 //! Register expr with this container.
 void IrContainer::registerExpr(IrBuilderPasskey, Expr* expr) {
+  std::lock_guard<std::recursive_mutex> guard(mutex_);
   registerExpr(expr);
 }
 
 void IrContainer::removeExpr(Expr* expr) {
+  std::lock_guard<std::recursive_mutex> guard(mutex_);
   NVF_ERROR(
       exprs_.find(expr) != exprs_.end(),
       "Wanted to remove an expression but it doesn't exist in this container.");
@@ -154,6 +163,7 @@ void IrContainer::removeExpr(Expr* expr) {
 //! Completely remove val from the fusion, break all dependencies associated
 //! with it
 void IrContainer::removeVal(Val* val) {
+  std::lock_guard<std::recursive_mutex> guard(mutex_);
   // Don't remove shortcuts
   if (val == true_val_.get() || val == false_val_.get() ||
       val == one_val_.get() || val == zero_val_.get() ||
@@ -242,6 +252,7 @@ bool IrContainer::inContainer(const Statement* stmt) const {
 
 // Shortcuts for frequently used vals
 Val* IrContainer::zeroVal() {
+  std::lock_guard<std::recursive_mutex> guard(mutex_);
   if (!zero_val_) {
     auto zero_val = IrBuilder::create<Val>(this, 0L, DataType::Index);
     NVF_ERROR(vals_up_.back().get() == zero_val);
@@ -263,6 +274,7 @@ Val* IrContainer::zeroVal(DataType dtype) {
 }
 
 Val* IrContainer::oneVal() {
+  std::lock_guard<std::recursive_mutex> guard(mutex_);
   if (!one_val_) {
     auto one_val = IrBuilder::create<Val>(this, 1L, DataType::Index);
     NVF_ERROR(vals_up_.back().get() == one_val);
@@ -284,6 +296,7 @@ Val* IrContainer::oneVal(DataType dtype) {
 }
 
 Val* IrContainer::falseVal() {
+  std::lock_guard<std::recursive_mutex> guard(mutex_);
   if (!false_val_) {
     auto false_val = IrBuilder::create<Val>(this, false, DataType::Bool);
     NVF_ERROR(vals_up_.back().get() == false_val);
@@ -294,6 +307,7 @@ Val* IrContainer::falseVal() {
 }
 
 Val* IrContainer::trueVal() {
+  std::lock_guard<std::recursive_mutex> guard(mutex_);
   if (!true_val_) {
     auto true_val = IrBuilder::create<Val>(this, true, DataType::Bool);
     NVF_ERROR(vals_up_.back().get() == true_val);
@@ -304,6 +318,7 @@ Val* IrContainer::trueVal() {
 }
 
 NamedScalar* IrContainer::magicZeroVal() {
+  std::lock_guard<std::recursive_mutex> guard(mutex_);
   if (!magic_zero_val_) {
     auto magic_zero =
         IrBuilder::create<NamedScalar>(kMagicZeroName, DataType::Index);
@@ -316,6 +331,7 @@ NamedScalar* IrContainer::magicZeroVal() {
 }
 
 Val* IrContainer::metadataOf(Val* v) {
+  std::lock_guard<std::recursive_mutex> guard(mutex_);
   if (metadata_.count(v) == 0) {
     auto metadata_val = IrBuilder::create<Val>(this, metaDataTypeOf(v));
     auto metadata_expr = IrBuilder::create<GetMetaData>(this, metadata_val, v);
@@ -325,6 +341,7 @@ Val* IrContainer::metadataOf(Val* v) {
 }
 
 void IrContainer::lazyInitAxioms() {
+  std::lock_guard<std::recursive_mutex> guard(mutex_);
   if (!axioms_) {
     axioms_ = std::make_unique<std::vector<Val*>>();
     axioms_->reserve(kParallelTypeThreads.size() * 3);
@@ -340,12 +357,14 @@ void IrContainer::lazyInitAxioms() {
 }
 
 void IrContainer::assumePositive(Val* val) {
+  std::lock_guard<std::recursive_mutex> guard(mutex_);
   NVF_ERROR(val->container() == this);
   lazyInitAxioms();
   axioms_->emplace_back(IrBuilder::gtExpr(val, zeroVal()));
 }
 
 void IrContainer::assumeNonNegative(Val* val) {
+  std::lock_guard<std::recursive_mutex> guard(mutex_);
   NVF_ERROR(val->container() == this);
   lazyInitAxioms();
   axioms_->emplace_back(IrBuilder::geExpr(val, zeroVal()));
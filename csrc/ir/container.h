@@ -14,6 +14,7 @@
 #include <utils.h>
 
 #include <deque>
+#include <mutex>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -33,6 +34,13 @@ class IrContainerPasskey {
   explicit IrContainerPasskey() = default;
 };
 
+//! [ Thread-Safe Registration ]
+//!
+//! Statements can be created in a container from multiple threads, e.g., by
+//! the analyses GpuLower runs concurrently, see [ Parallel Lowering ]. The
+//! registration and removal of statements and the lazily created shortcut
+//! vals are thus serialized by a mutex. Other modifications of the IR, like
+//! replacing the uses of a val, are not, and must not race with readers.
 class IrContainer : public PolymorphicBase {
  public:
   IrContainer();
@@ -221,6 +229,10 @@ class IrContainer : public PolymorphicBase {
   std::unique_ptr<NamedScalar> magic_zero_val_;
   std::unique_ptr<std::vector<Val*>> axioms_;
   std::unordered_map<Val*, std::pair<Val*, Expr*>> metadata_;
+
+  // Serializes registrations, see [ Thread-Safe Registration ]. It is
+  // recursive as registering a statement may create shortcut vals.
+  std::recursive_mutex mutex_;
 };
 
 } // namespace nvfuser
@@ -413,6 +413,17 @@ class TensorView : public Val {
     return circular_buffer_stage_;
   }
 
+  //! Synchronize the stages of this double or circular buffered tensor with
+  //! mbarriers instead of cp.async.wait_group and block syncs. Only
+  //! supported for cp.async loads from global to shared memory. See
+  //! [MBarrier Handoff] in device_lower/pass/double_buffer.h
+  void handOffStagesWithMBarriers();
+
+  // Returns true if the stages of this tensor are handed off with mbarriers.
+  bool hasMBarrierHandoff() const {
+    return has_mbarrier_handoff_;
+  }
+
   //! Transforms the innermost iterdomains according to the given mma swizzle,
   //!  this should be used on the tvs that are either inputs/outputs of an
   //!  MmaOp, or any tv's that are involved in prolog/epilog fusions and need to
@@ -583,6 +594,9 @@ class TensorView : public Val {
   //! Indicates the circular buffering stage depth if applicable.
   unsigned int circular_buffer_stage_ = 0;
 
+  //! Indicates if the stages are synchronized with mbarriers.
+  bool has_mbarrier_handoff_ = false;
+
   // special handling for CPU based zero-dim tensors (i.e. CPU Tensors that
   // only have one value). This is only used if on an input value, otherwise
   // ignored. This is important as special handling because these "scalars"
@@ -226,6 +226,100 @@ class ScatterOp : public Expr {
   }
 };
 
+//! Stable sort of in along dim. outValues are the sorted elements and
+//! outIndices their positions along dim in in. NaNs are larger than any
+//! other value, as in PyTorch.
+class SortOp : public Expr {
+ public:
+  using Expr::Expr;
+  SortOp(
+      IrBuilderPasskey,
+      Val* out_values,
+      Val* out_indices,
+      Val* in,
+      int64_t dim,
+      bool descending);
+
+  NVFUSER_DECLARE_CLONE_AND_CREATE
+
+  const char* getOpString() const override {
+    return "SortOp";
+  }
+
+  std::string toString(int indent_size = 0) const override;
+  std::string toInlineString(int indent_size = 0) const override;
+  std::vector<PolymorphicValue> evaluate(
+      const ExpressionEvaluator& ee,
+      const std::vector<PolymorphicValue>& inputs) const override;
+
+  Val* outValues() const {
+    return output(0);
+  }
+
+  Val* outIndices() const {
+    return output(1);
+  }
+
+  Val* in() const {
+    return input(0);
+  }
+
+  int64_t dim() const {
+    return attribute<int64_t>(0);
+  }
+
+  bool descending() const {
+    return attribute<bool>(1);
+  }
+};
+
+//! Inclusive scan of in along dim with a binary op, e.g., torch.cumsum for
+//! BinaryOpType::Add. Each element of out is init combined with all elements
+//! of in up to and including its position along dim. See [ Scan Scheduler ].
+class ScanOp : public Expr {
+ public:
+  using Expr::Expr;
+  ScanOp(
+      IrBuilderPasskey,
+      BinaryOpType scan_op_type,
+      Val* init,
+      Val* out,
+      Val* in,
+      int64_t dim);
+
+  NVFUSER_DECLARE_CLONE_AND_CREATE
+
+  const char* getOpString() const override {
+    return "ScanOp";
+  }
+
+  std::string toString(int indent_size = 0) const override;
+  std::string toInlineString(int indent_size = 0) const override;
+  std::vector<PolymorphicValue> evaluate(
+      const ExpressionEvaluator& ee,
+      const std::vector<PolymorphicValue>& inputs) const override;
+
+  Val* out() const {
+    return output(0);
+  }
+
+  Val* in() const {
+    return input(0);
+  }
+
+  Val* init() const {
+    return attributeVal(0);
+  }
+
+  BinaryOpType getScanOpType() const {
+    return attribute<BinaryOpType>(1);
+  }
+
+  int64_t dim() const {
+    return attribute<int64_t>(2);
+  }
+};
+
 class IotaOp : public Expr {
  public:
   using Expr::Expr;
@@ -913,6 +1007,41 @@ class ReductionOp : public Expr {
   bool isAllreduce() const {
     return attribute<bool>(2);
   }
+
+  //! Request that the grid reduction of this op is done serially, i.e., the
+  //! blocks of each reduction segment accumulate into a global work buffer
+  //! one after another. See [ Serial Grid Reduction ]
+  void requestSerialGridReduction(bool value = true) {
+    attribute<bool>(3) = value;
+  }
+
+  bool serialGridReductionRequested() const {
+    return attribute<bool>(3);
+  }
+
+  //! Request that the grid reduction of this op is done in a single pass,
+  //! i.e., the blocks of each reduction segment combine their partial
+  //! results into a global work buffer in the order of their index, and the
+  //! last block writes the result. See [ Single-Pass Grid Reduction ]
+  void requestSinglePassGridReduction(bool value = true) {
+    attribute<bool>(4) = value;
+  }
+
+  bool singlePassGridReductionRequested() const {
+    return attribute<bool>(4);
+  }
+
+  //! Request that the grid reduction of this op accumulates the partial
+  //! result of each block into its output with atomics, i.e., without a
+  //! work buffer or a grid synchronization. The result is
+  //! nondeterministic. See [ Atomic Grid Reduction ]
+  void requestAtomicGridReduction(bool value = true) {
+    attribute<bool>(5) = value;
+  }
+
+  bool atomicGridReductionRequested() const {
+    return attribute<bool>(5);
+  }
 };
 
 //! Grouped reduction operation for horizontal fusions. It works like
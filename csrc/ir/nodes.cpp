@@ -276,11 +276,128 @@ std::vector<PolymorphicValue> ScatterOp::evaluate(
   const auto& index = inputs.at(1).as<at::Tensor>();
   const auto& src = inputs.at(2).as<at::Tensor>();
   auto dimension = dim();
-  return {at::scatter(input, dimension, index, src)};
+  switch (getScatterOpType()) {
+    case ScatterOpType::Set:
+      return {at::scatter(input, dimension, index, src)};
+    case ScatterOpType::Add:
+      return {at::scatter_add(input, dimension, index, src)};
+  }
+  NVF_ERROR(false, "Unknown scatter op type: ", getScatterOpType());
 }
 
 NVFUSER_DEFINE_CLONE_AND_CREATE(ScatterOp)
 
+SortOp::SortOp(
+    IrBuilderPasskey passkey,
+    Val* out_values,
+    Val* out_indices,
+    Val* in,
+    int64_t dim,
+    bool descending)
+    : Expr(passkey) {
+  addInput(in);
+  addOutput(out_values);
+  addOutput(out_indices);
+  addDataAttribute(dim);
+  addDataAttribute(descending);
+}
+
+std::string SortOp::toString(int indent_size) const {
+  std::stringstream ss;
+  indent(ss, indent_size) << outValues()->toString() << "(Values),\n"
+                          << outIndices()->toString() << "(Indices)\n";
+  indent_size++;
+  indent(ss, indent_size) << " = sort( " << in()->toString()
+                          << ", dim = " << dim() << ", descending = "
+                          << (descending() ? "true" : "false") << " )\n";
+  return ss.str();
+}
+
+std::string SortOp::toInlineString(int indent_size) const {
+  NVF_CHECK(false, "Sort op can not be printed inline");
+}
+
+std::vector<PolymorphicValue> SortOp::evaluate(
+    const ExpressionEvaluator& ee,
+    const std::vector<PolymorphicValue>& inputs) const {
+  const auto& input = inputs.at(0).as<at::Tensor>();
+  auto [values, indices] =
+      at::sort(input, /*stable=*/true, dim(), descending());
+  return {values, indices};
+}
+
+NVFUSER_DEFINE_CLONE_AND_CREATE(SortOp)
+
+ScanOp::ScanOp(
+    IrBuilderPasskey passkey,
+    BinaryOpType scan_op_type,
+    Val* init,
+    Val* out,
+    Val* in,
+    int64_t dim)
+    : Expr(passkey) {
+  NVF_ERROR(
+      (in->isA<TensorView>() && out->isA<TensorView>()) ||
+          (in->isA<kir::TensorIndex>() && out->isA<kir::TensorIndex>()),
+      "Scan operation was created that does not have tensor inputs and ",
+      "outputs.");
+  NVF_ERROR(
+      init->isConstScalar(),
+      "Tried to create a scan operation with an initial value that isn't a ",
+      "constant.");
+  addOutput(out);
+  addInput(in);
+  addAttribute(init);
+  addDataAttribute(scan_op_type);
+  addDataAttribute(dim);
+}
+
+std::string ScanOp::toString(int indent_size) const {
+  std::stringstream ss;
+  indent(ss, indent_size) << out() << "\n";
+  indent(ss, indent_size) << "   = scan( " << in()->toString()
+                          << ", op = " << getScanOpType()
+                          << ", initial value = " << init()->toString()
+                          << ", dim = " << dim() << " )\n";
+  return ss.str();
+}
+
+std::string ScanOp::toInlineString(int indent_size) const {
+  NVF_CHECK(false, "Scan op can not be printed inline");
+}
+
+std::vector<PolymorphicValue> ScanOp::evaluate(
+    const ExpressionEvaluator& ee,
+    const std::vector<PolymorphicValue>& inputs) const {
+  const auto& input = inputs.at(0).as<at::Tensor>();
+  at::Tensor scanned;
+  switch (getScanOpType()) {
+    case BinaryOpType::Add:
+      scanned = at::cumsum(input, dim());
+      break;
+    case BinaryOpType::Mul:
+      scanned = at::cumprod(input, dim());
+      break;
+    case BinaryOpType::Max:
+      scanned = std::get<0>(at::cummax(input, dim()));
+      break;
+    case BinaryOpType::Min:
+      scanned = std::get<0>(at::cummin(input, dim()));
+      break;
+    default:
+      NVF_CHECK(
+          false,
+          "Unexpected operator type: ",
+          getScanOpType(),
+          " in ",
+          toString());
+  }
+  // The initial value is the identity of the built-in scans
+  return {scanned};
+}
+
+NVFUSER_DEFINE_CLONE_AND_CREATE(ScanOp)
+
 IotaOp::IotaOp(
     IrBuilderPasskey passkey,
     Val* out,
@@ -740,6 +857,13 @@ std::vector<PolymorphicValue> TernaryOp::evaluate(
     case TernaryOpType::Clamp:
       return {std::min(std::max(a, b), c)};
       break;
+    case TernaryOpType::FastDiv:
+      return {fastDiv(
+          a.as<int64_t>(),
+          b.as<int64_t>(),
+          c.as<int64_t>(),
+          in2()->dtype() == DataType::Int32 ? 32 : 64)};
+      break;
     case TernaryOpType::Lerp:
       // This is the same lerp computed in helpers.cu
       // https://math.stackexchange.com/a/1798323
@@ -1443,6 +1567,12 @@ ReductionOp::ReductionOp(
   addAttribute(init);
   addDataAttribute(reduction_op_type);
   addDataAttribute(is_allreduce);
+  // Serial grid reduction requested
+  addDataAttribute(false);
+  // Single-pass grid reduction requested
+  addDataAttribute(false);
+  // Atomic grid reduction requested
+  addDataAttribute(false);
 }
 
 std::string ReductionOp::toString(int indent_size) const {
@@ -2102,7 +2232,9 @@ std::vector<PolymorphicValue> ExpandOp::evaluate(
   for (auto i : c10::irange(1, inputs.size())) {
     expanded_size.push_back((int64_t)inputs.at(i));
   }
-  return {at::expand_copy(in, expanded_size)};
+  // Expanded dimensions get a stride of 0 so the result is a view of `in`,
+  // which lets an expanded fusion output alias its source.
+  return {in.expand(expanded_size)};
 }
 
 NVFUSER_DEFINE_CLONE_AND_CREATE(ExpandOp)
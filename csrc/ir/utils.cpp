@@ -743,6 +743,25 @@ std::vector<IterDomain*> allIDsOf(const TensorView* tv) {
   return std::vector<IterDomain*>(all_ids.begin(), all_ids.end());
 }
 
+std::optional<std::vector<IterDomain*>> getLeafIDsSplitFrom(
+    const TensorView* tv,
+    IterDomain* root_id) {
+  const auto& leaf_domain = tv->getLeafDomain();
+  std::vector<IterDomain*> ids = {root_id};
+  for (auto expr : StmtSort::getExprsBetween(
+           {root_id}, {leaf_domain.begin(), leaf_domain.end()})) {
+    auto split = dynamic_cast<Split*>(expr);
+    if (split == nullptr) {
+      return std::nullopt;
+    }
+    auto it = std::find(ids.begin(), ids.end(), split->in());
+    NVF_ERROR(it != ids.end());
+    it = ids.erase(it);
+    ids.insert(it, {split->outer(), split->inner()});
+  }
+  return ids;
+}
+
 bool isSelectInput(TensorView* tv) {
   for (auto expr : tv->uses()) {
     if (expr->isA<SelectOp>()) {
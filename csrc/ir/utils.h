@@ -440,6 +440,13 @@ IterDomain* getConsumerOfIndexedProducerID(const Expr* expr);
 // unique.
 std::vector<IterDomain*> allIDsOf(const TensorView* tv);
 
+// Get the leaf IDs the given root ID of a tensor is split into, ordered as
+// they are laid out in memory. Returns std::nullopt if the root ID or any of
+// the IDs derived from it is transformed by other than a split.
+std::optional<std::vector<IterDomain*>> getLeafIDsSplitFrom(
+    const TensorView* tv,
+    IterDomain* root_id);
+
 // Check if the given tv is an input of SelectOp
 bool isSelectInput(TensorView* tv);
 
@@ -13,9 +13,11 @@
 #include <ir/utils.h>
 #include <kernel.h>
 #include <kernel_ir_dispatch.h>
+#include <options.h>
 
 #include <ATen/cuda/CUDAContext.h>
 
+#include <algorithm>
 #include <iostream>
 #include <unordered_set>
 
@@ -38,6 +40,9 @@ class KernelIrScanner : private IrVisitor {
       auto factor = split->factor();
       summary_.splits_to_validate.emplace_back(extent, factor);
     }
+    for (const auto& [extent, divisor] : gpu_lower->extentDivisors()) {
+      summary_.extent_divisors_to_validate.emplace_back(extent, divisor);
+    }
   }
 
   const auto& summary() const {
@@ -89,6 +94,7 @@ class KernelIrScanner : private IrVisitor {
 
   void handle(RNGOp* rng_op) final {
     summary_.has_philox_op = true;
+    summary_.rng_ops.push_back(rng_op);
   }
 
   void handle(TensorIndex* tensor_index) final {
@@ -139,6 +145,17 @@ class KernelIrScanner : private IrVisitor {
     if (grid_reduction->isAllreduce()) {
       summary_.has_cooperative_grid_reduction = true;
     }
+    if (grid_reduction->useOuterOpt()) {
+      summary_.has_outer_grouped_grid_reduction = true;
+      const auto& par_dim_map = GpuLower::current()->parallelDimensionMap();
+      auto tidx =
+          static_cast<int>(par_dim_map.get(ParallelType::TIDx)->evaluate());
+      auto tidy =
+          static_cast<int>(par_dim_map.get(ParallelType::TIDy)->evaluate());
+      summary_.outer_grouped_grid_reduction_largest_smem_size = std::max(
+          summary_.outer_grouped_grid_reduction_largest_smem_size,
+          grid_reduction->getSmemBufferSize(tidx, tidy, 1));
+    }
   }
 
   void handle(GroupedGridWelford* grid_welford) final {
@@ -169,6 +186,18 @@ class KernelIrScanner : private IrVisitor {
     }
   }
 
+  void handle(ScanOp* sop) final {
+    // The totals of the warps are scanned through the workspace of block
+    // reductions
+    summary_.has_block_scans = true;
+    const auto data_type = sop->out()->dtype();
+    const size_t type_size = dataTypeSize(data_type, index_type_);
+    if (type_size > max_smem_type_size_) {
+      max_smem_type_size_ = type_size;
+      summary_.largest_smem_data_type = data_type;
+    }
+  }
+
   void handle(GridBroadcast* grid_broadcast) final {
     summary_.has_cooperative_grid_reduction = true;
     handle(grid_broadcast->broadcast_op());
@@ -294,6 +323,54 @@ class ValidateAllocation : private OptOutConstDispatch {
   std::vector<std::vector<const Allocate*>> live_allocations_;
 };
 
+// Kernel parameters are limited to 4KB
+constexpr int64_t kMaxKernelParameterBytes = 4096;
+
+// Whether the parameters of a kernel are too large to be passed directly, see
+// [ Spilled Kernel Arguments ] in csrc/executor.cpp
+bool shouldSpillTensorArguments(
+    const std::vector<Val*>& parameters,
+    PrimDataType index_type) {
+  int64_t max_bytes = kMaxKernelParameterBytes;
+  if (isOptionEnabled(EnableOption::SpillKernelArguments)) {
+    max_bytes = 1024;
+    const auto& args =
+        getEnableOptionArguments(EnableOption::SpillKernelArguments);
+    if (!args.empty()) {
+      try {
+        max_bytes = std::min(max_bytes, (int64_t)std::stoll(args.at(0)));
+      } catch (const std::exception& e) {
+        debug() << "skip invalid argument for SpillKernelArguments, arg = "
+                << args.at(0) << std::endl;
+      }
+    }
+  }
+
+  const int64_t index_bytes = dataTypeSize(index_type);
+  int64_t bytes = 0;
+  bool has_tensor_arguments = false;
+  for (Val* param : parameters) {
+    // Parameters are assumed to be aligned to 8 bytes
+    bytes = roundUpToMultiple(bytes, 8);
+    auto tv = dynamic_cast<TensorView*>(param);
+    if (tv == nullptr) {
+      bytes += dataTypeSize(param->dtype(), index_type);
+    } else if (tv->isCpuScalar()) {
+      bytes += dataTypeSize(tv->dtype());
+    } else {
+      // The data pointer, the logical sizes and the allocation strides
+      has_tensor_arguments = true;
+      const auto num_sizes =
+          TensorDomain::noReductions(tv->getMaybeRFactorDomain()).size();
+      const auto num_strides =
+          TensorDomain::noReductions(tv->getMaybeAllocationDomain()).size();
+      bytes += (int64_t)sizeof(void*) +
+          (int64_t)(num_sizes + num_strides) * index_bytes;
+    }
+  }
+  return has_tensor_arguments && bytes > max_bytes;
+}
+
 } // namespace
 
 Kernel::Kernel(Fusion* fusion, PrimDataType index_type)
@@ -319,11 +396,15 @@ void Kernel::finalize(std::vector<Expr*> top_level_exprs) {
   summary_.sync_map = GpuLower::current()->syncMap();
   summary_.parallel_dimension_map_ =
       GpuLower::current()->parallelDimensionMap();
+  summary_.has_grid_dependency_wait =
+      isOptionEnabled(EnableOption::ProgrammaticDependentLaunch);
   parameters_ = GpuLower::current()->allKnownVals();
   parameters_.insert(parameters_.end(), outputs().begin(), outputs().end());
   for (auto alloc : summary_.global_allocations) {
     parameters_.push_back(alloc->buffer());
   }
+  summary_.has_spilled_tensor_arguments =
+      shouldSpillTensorArguments(parameters_, index_type_);
 }
 
 void Kernel::analyze() {
@@ -427,12 +508,27 @@ std::array<int, 2> KernelPerformanceProfile::getIndicesInProfileBuffer(
     const Expr* expr) const {
   NVF_ERROR(isProfiled(expr), "Not a profiled expression: ", expr->toString());
 
-  int cycle_index = getIndex(expr).value() * 2;
+  int cycle_index = getIndex(expr).value() * kEntrySize;
   int count_index = cycle_index + 1;
 
   return {cycle_index, count_index};
 }
 
+namespace {
+
+std::string describeProfiledExpr(const Expr* expr) {
+  std::stringstream ss;
+  ss << expr->getOpString();
+  if (auto loop = dynamic_cast<const ForLoop*>(expr)) {
+    ss << " " << loop->iter_domain()->toString();
+  } else if (auto out_tv = ir_utils::getTvOutput(expr)) {
+    ss << ", T" << out_tv->name();
+  }
+  return ss.str();
+}
+
+} // namespace
+
 std::string KernelPerformanceProfile::toString(const at::Tensor& buffer) const {
   std::stringstream ss;
   ss << "Kernel performance profile:\n";
@@ -442,19 +538,46 @@ std::string KernelPerformanceProfile::toString(const at::Tensor& buffer) const {
   }
 
   double kilo_freq = at::cuda::getCurrentDeviceProperties()->clockRate;
+  auto to_us = [&](double cycles) { return cycles / kilo_freq * 1000.0; };
 
   ss << std::setprecision(3) << std::fixed;
 
-  for (const auto& kv : expr_entry_map_) {
-    auto expr = kv.first;
-    auto index = kv.second;
-    auto out_tv = ir_utils::getTvOutput(expr);
+  // Entries in the order of registration, which is the program order of the
+  // profiled top-level expressions
+  std::vector<std::pair<int, const Expr*>> entries;
+  entries.reserve(expr_entry_map_.size());
+  for (const auto& [expr, index] : expr_entry_map_) {
+    entries.emplace_back(index, expr);
+  }
+  std::sort(entries.begin(), entries.end());
+
+  std::optional<int64_t> kernel_start;
+  for (const auto& [index, expr] : entries) {
     double cycles = static_cast<double>(buffer[index][0].item<int64_t>());
     auto count = buffer[index][1].item<int64_t>();
     auto cycles_per_call = count == 0 ? 0.0 : cycles / (double)count;
-    auto us_per_call = cycles_per_call / kilo_freq * 1000.0;
-    ss << expr->getOpString() << ", T" << out_tv->name() << ", " << us_per_call
+    ss << describeProfiledExpr(expr) << ", " << to_us(cycles_per_call)
        << " us, " << count << "\n";
+    auto start = buffer[index][2].item<int64_t>();
+    if (count > 0 && start != 0) {
+      kernel_start = std::min(kernel_start.value_or(start), start);
+    }
+  }
+
+  // Profiled regions on the timeline of the last thread block, relative to
+  // the start of the first region
+  if (kernel_start.has_value()) {
+    ss << "Timeline of the last thread block:\n";
+    for (const auto& [index, expr] : entries) {
+      auto start = buffer[index][2].item<int64_t>();
+      auto end = buffer[index][3].item<int64_t>();
+      if (buffer[index][1].item<int64_t>() == 0 || start == 0) {
+        continue;
+      }
+      ss << "  " << to_us((double)(start - kernel_start.value())) << " - "
+         << to_us((double)(end - kernel_start.value())) << " us: "
+         << describeProfiledExpr(expr) << "\n";
+    }
   }
 
   return ss.str();
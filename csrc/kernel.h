@@ -45,6 +45,10 @@ struct KernelSummary {
   //! Indicate the need to generate random numbers
   bool has_philox_op = false;
 
+  //! RNG ops of the kernel. Each one caches the last four Philox outputs it
+  //! generated, so ops with different offsets don't evict each other.
+  std::vector<const RNGOp*> rng_ops;
+
   //! Do we have any block reductions?
   bool has_block_reductions = false;
 
@@ -61,6 +65,9 @@ struct KernelSummary {
   //! Do we have any grid broadcasts?
   bool has_grid_broadcasts = false;
 
+  //! Do we have any block scans? See [ Scan Scheduler ]
+  bool has_block_scans = false;
+
   //! Do we have any welford op?
   bool has_welford = false;
 
@@ -76,12 +83,27 @@ struct KernelSummary {
   //! Largest shared memory buffer size of outer grouped grid welford
   int outer_grouped_grid_welford_largest_smem_size = 0;
 
+  //! Do we have any outer grouped grid reduction op?
+  bool has_outer_grouped_grid_reduction = false;
+
+  //! Largest shared memory buffer size of outer grouped grid reduction
+  int outer_grouped_grid_reduction_largest_smem_size = 0;
+
   //! Largest shared memory buffer base type
   DataType largest_smem_data_type = DataType::Null;
 
   //! Do we have allocations of dynamic local memory?
   bool has_dynamic_local_memory_allocations = false;
 
+  //! Does the kernel wait for the preceding kernel of the stream with
+  //! griddepcontrol, i.e., may it be launched with programmatic dependent
+  //! launch? See [ Programmatic Dependent Launch ]
+  bool has_grid_dependency_wait = false;
+
+  //! Are the tensor arguments passed in a device buffer instead of as kernel
+  //! parameters? See [ Spilled Kernel Arguments ]
+  bool has_spilled_tensor_arguments = false;
+
   //! List of dynamic local memory buffers.
   //! Only used for debugging.
   std::vector<const kir::Allocate*> dynamic_lmem_allocations;
@@ -89,6 +111,9 @@ struct KernelSummary {
   //! ceilDiv extents that must be divisible
   std::vector<std::pair<const Val*, const Val*>> splits_to_validate;
 
+  //! Input extents and the divisors the kernel is specialized for
+  std::vector<std::pair<const Val*, int64_t>> extent_divisors_to_validate;
+
   //! Effective ParallelTypes of broadcast ops
   std::unordered_map<const BroadcastOp*, ParallelTypeBitmap>
       broadcast_parallel_types;
@@ -111,6 +136,11 @@ struct KernelSummary {
 
 class KernelPerformanceProfile {
  public:
+  //! Number of integers of each profile entry: the cycles spent, the count,
+  //! and the cycle counter at the first start and the last end of the
+  //! profiled region. Profiled grid reductions only fill the first two.
+  static constexpr int kEntrySize = 4;
+
   //! Register an expression to profile
   void registerExpr(const Expr* expr);
 
@@ -147,17 +177,13 @@ class KernelPerformanceProfile {
  private:
   int num_profile_entries_ = 0;
 
-  //! Backing buffer of Nx2 integer tensor, where N is the number of profiled
-  //! regions. Each region has two integer values, one representing
-  //! the cycles spent, and another the count.
+  //! Backing buffer of NxkEntrySize integer tensor, where N is the number of
+  //! profiled regions
   TensorView* buffer_ = nullptr;
 
-  //! Map profiled expressions to profile entry offsets
+  //! Map profiled expressions, including top-level loops, to profile entry
+  //! offsets
   std::unordered_map<const Expr*, int> expr_entry_map_;
-
-  // TODO: Allow profiling of ForLoops
-  //! Map profiled ForLoop to profile entry offsets
-  // std::unordered_map<const kir::ForLoop*, int> loop_entry_map_;
 };
 
 class KernelInternalProxy;
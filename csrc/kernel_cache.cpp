@@ -7,6 +7,9 @@
 // clang-format on
 #include <kernel_cache.h>
 
+#include <alias_analysis.h>
+#include <compile_thread_pool.h>
+#include <compute_at_map.h>
 #include <debug.h>
 #include <driver_api.h>
 #include <dynamic_transform.h>
@@ -17,26 +20,105 @@
 #include <ir/utils.h>
 #include <optimization/pre_segmenter.h>
 #include <options.h>
+#include <scheduler/cache_policy_refiner.h>
 #include <scheduler/debug_utils.h>
 #include <scheduler/registry.h>
+#include <scheduler/utils.h>
+#include <serde/heuristic_params.h>
 #include <torch/csrc/jit/jit_log.h>
 #include <torch/csrc/jit/runtime/graph_executor.h>
 #include <utils.h>
 
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/cuda/CUDAEvent.h>
 #include <c10/cuda/CUDAGuard.h>
 #include <c10/util/irange.h>
 #include <torch/csrc/jit/jit_log.h>
 
+#include <array>
+#include <chrono>
+
 namespace nvfuser {
 
 namespace {
 
+const char* runtimeLookupName(FusionTelemetry::RuntimeLookup lookup) {
+  switch (lookup) {
+    case FusionTelemetry::RuntimeLookup::InputCacheHit:
+      return "input cache hit";
+    case FusionTelemetry::RuntimeLookup::Reuse:
+      return "reuse";
+    case FusionTelemetry::RuntimeLookup::Miss:
+      return "miss";
+  }
+  return "unknown";
+}
+
+// Maximum number of streams independent segments are spread over. See
+// [ Multi-Stream Execution of Segments ].
+constexpr int64_t kMaxSegmentStreams = 4;
+
+// Largest number of elements of the outputs of a group evaluated on the host
+// by default. See [ Host-Evaluated Segments ].
+constexpr int64_t kMaxHostEvaluatedElements = 16;
+
+// Whether ExpressionEvaluator computes the tensors written by expr with ATen
+// on the host, given that its inputs are on the host. Random numbers would
+// differ from the ones of the kernels.
+bool isHostEvaluable(Expr* expr) {
+  if (ir_utils::filterByType<TensorView>(expr->outputs()).empty()) {
+    return true;
+  }
+  return expr->isOneOf<
+             UnaryOp,
+             BinaryOp,
+             TernaryOp,
+             BroadcastOp,
+             SqueezeOp,
+             ExpandOp,
+             ReductionOp,
+             ViewOp,
+             LoadStoreOp>();
+}
+
+// ATen has to take less than this fraction of the kernel time of a segment
+// to be used instead. See [ Profile-Guided ATen Fallback ].
+constexpr float kAtenFallbackMargin = 0.9f;
+
+// Whether the outputs of a group are the same whether it runs with its
+// kernel or with ATen, and running it twice has no side effects
+bool canRunWithAten(Fusion* complete_fusion, SegmentedGroup* group) {
+  if (group->heuristic() == ScheduleHeuristic::NoOp) {
+    return false;
+  }
+  if (std::any_of(group->exprs().begin(), group->exprs().end(), [](Expr* e) {
+        return e->isA<RNGOp>();
+      })) {
+    return false;
+  }
+  return std::all_of(
+      group->outputs().begin(),
+      group->outputs().end(),
+      [complete_fusion](Val* output) {
+        auto tv = dynamic_cast<TensorView*>(output);
+        if (tv == nullptr || tv->hasAllocation() ||
+            tv->dtype() == DataType::Index ||
+            complete_fusion->getOutputAlias(tv).first != nullptr) {
+          return false;
+        }
+        const auto& rfactor_domain = tv->getMaybeRFactorDomain();
+        return std::none_of(
+            rfactor_domain.begin(), rfactor_domain.end(), [](IterDomain* id) {
+              return id->hasExpandedExtent();
+            });
+      });
+}
+
 // Replace CUDA tensor with Meta tensor because storing tensors can cause
 // out-of-memory issues. Other arguments are returned as-is.
-std::shared_ptr<PolymorphicValue> convertMetadataArg(
-    std::shared_ptr<PolymorphicValue> arg) {
-  if (arg->is<at::Tensor>()) {
-    if (const auto& tensor = arg->as<at::Tensor>(); tensor.is_cuda()) {
+PolymorphicValue convertMetadataArg(const PolymorphicValue& arg) {
+  if (arg.is<at::Tensor>()) {
+    if (const auto& tensor = arg.as<at::Tensor>(); tensor.is_cuda()) {
       auto meta_tensor = at::Tensor(at::detail::empty_strided_meta(
           tensor.sizes(),
           tensor.strides(),
@@ -44,7 +126,7 @@ std::shared_ptr<PolymorphicValue> convertMetadataArg(
           c10::nullopt,
           c10::Device(c10::DeviceType::Meta, 0),
           c10::nullopt));
-      return std::make_shared<PolymorphicValue>(std::move(meta_tensor));
+      return meta_tensor;
     }
   }
   return arg;
@@ -213,8 +295,278 @@ class ArgumentManager {
   }
 };
 
+// Collect the outputs of the segment at group_pos in the run order that can
+// be placed in the intermediate arena. See [ Arena for Segment Intermediates ].
+void addArenaBuffers(
+    const std::vector<SegmentedGroup*>& group_run_order,
+    int64_t group_pos,
+    const KernelArgumentHolder& group_inputs,
+    const std::vector<at::Tensor>& group_outputs,
+    std::vector<IntermediateArena::Buffer>& buffers) {
+  auto group = group_run_order.at(group_pos);
+  const auto& outputs = group->outputs();
+  NVF_ERROR(outputs.size() == group_outputs.size());
+
+  for (const auto out_i : c10::irange(outputs.size())) {
+    Val* val = outputs.at(out_i);
+    // Fusion outputs are returned to the caller, so they can't be reused
+    if (val->isFusionInput() || val->isFusionOutput() ||
+        std::find(outputs.begin(), outputs.begin() + (int64_t)out_i, val) !=
+            outputs.begin() + (int64_t)out_i) {
+      continue;
+    }
+
+    // Only tensors that own their memory can be moved to the arena. Aliases
+    // of inputs or of other outputs are left as they are.
+    const auto& tensor = group_outputs.at(out_i);
+    if (!tensor.defined() || !tensor.is_cuda() ||
+        tensor.storage_offset() != 0 ||
+        tensor.storage().data() != tensor.data_ptr()) {
+      continue;
+    }
+    bool is_alias = false;
+    for (const auto in_i : c10::irange(group_inputs.size())) {
+      if (group_inputs[in_i]->is<at::Tensor>() &&
+          group_inputs[in_i]->as<at::Tensor>().is_alias_of(tensor)) {
+        is_alias = true;
+      }
+    }
+    for (const auto other_i : c10::irange(out_i)) {
+      if (group_outputs.at(other_i).is_alias_of(tensor)) {
+        is_alias = true;
+      }
+    }
+    if (is_alias) {
+      continue;
+    }
+
+    IntermediateArena::Buffer buffer;
+    buffer.first_use = group_pos;
+    buffer.last_use = group_pos;
+    for (auto pos :
+         c10::irange(group_pos + 1, (int64_t)group_run_order.size())) {
+      const auto& consumer_inputs = group_run_order.at(pos)->inputs();
+      if (std::find(consumer_inputs.begin(), consumer_inputs.end(), val) !=
+          consumer_inputs.end()) {
+        buffer.last_use = pos;
+      }
+    }
+    buffer.output_index = (int64_t)out_i;
+    buffer.sizes = tensor.sizes().vec();
+    buffer.strides = tensor.strides().vec();
+    buffer.type = tensor.scalar_type();
+    buffer.nbytes = (int64_t)tensor.storage().nbytes();
+    buffers.push_back(std::move(buffer));
+  }
+}
+
+// Whether val is freed after the last segment reading it. See [ Memory-Aware
+// Segment Order ].
+bool isSegmentIntermediate(Val* val) {
+  return val->isA<TensorView>() && !val->isFusionInput() &&
+      !val->isFusionOutput();
+}
+
+// Bytes allocated for val by the segment producing it, or 0 if it's not a
+// tensor, aliases an input, or its size can't be evaluated
+int64_t allocatedBytes(
+    Fusion* fusion,
+    Val* val,
+    ExpressionEvaluator& expr_eval) {
+  auto tv = dynamic_cast<TensorView*>(val);
+  if (tv == nullptr ||
+      (tv->isFusionOutput() && fusion->getOutputAlias(tv).second != nullptr)) {
+    return 0;
+  }
+  int64_t numel = 1;
+  for (IterDomain* id :
+       TensorDomain::noReductions(tv->getMaybeAllocationDomain())) {
+    if (id->isBroadcast()) {
+      continue;
+    }
+    PolymorphicValue extent = expr_eval.evaluate(id->extent());
+    if (!extent.hasValue()) {
+      return 0;
+    }
+    numel *= extent.as<int64_t>();
+  }
+  return numel * dataTypeSize(tv->dtype(), DataType::Int);
+}
+
+// Rows of the chunked dimension the slices of chunked execution are a
+// multiple of. See [ Chunked Execution ].
+constexpr int64_t kChunkAlignment = 16;
+
+// Whether the run is streamed from host memory, i.e., a tensor input that
+// isn't a CPU scalar or a given output is on the host. See
+// [ Host Streaming ].
+bool hasHostTensors(
+    Fusion* fusion,
+    const at::ArrayRef<c10::IValue>& inputs,
+    const std::vector<at::Tensor>& preallocated_outputs) {
+  for (const auto i :
+       c10::irange(std::min(inputs.size(), fusion->inputs().size()))) {
+    auto tv = dynamic_cast<TensorView*>(fusion->inputs().at(i));
+    if (tv != nullptr && !tv->isCpuScalar() && inputs[i].isTensor() &&
+        inputs[i].toTensor().is_cpu()) {
+      return true;
+    }
+  }
+  return std::any_of(
+      preallocated_outputs.begin(),
+      preallocated_outputs.end(),
+      [](const at::Tensor& output) {
+        return output.defined() && output.is_cpu();
+      });
+}
+
+// Whether the values of expr depend on the indices of its tensors along
+// the dimensions they have, not only on the values at the same indices
+bool isIndexDependent(Expr* expr) {
+  return expr->isOneOf<
+      ScanOp,
+      SortOp,
+      ShiftOp,
+      GatherOp,
+      ScatterOp,
+      TorchGatherOp,
+      IndexSelectOp,
+      IotaOp,
+      EyeOp,
+      MmaOp>();
+}
+
+// Whether each input of fusion is sliced by chunked execution, or empty if
+// the fusion can't be chunked. See [ Chunked Execution ].
+std::vector<bool> chunkedInputs(Fusion* fusion) {
+  FusionGuard fg(fusion);
+  if (fusion->outputs().empty() ||
+      !fusion->getPermutationInputMap().empty() ||
+      !fusion->getPermutationOutputMap().empty() ||
+      ir_utils::hasOpsOfType<RNGOp>(fusion)) {
+    return {};
+  }
+  for (Val* out : fusion->outputs()) {
+    if (!out->isA<TensorView>() ||
+        fusion->getOutputAlias(out).second != nullptr) {
+      return {};
+    }
+  }
+
+  // The outermost non-reduction logical domain of tv, if any
+  auto outer_id = [](TensorView* tv) -> IterDomain* {
+    auto logical = TensorDomain::noReductions(tv->getMaybeRFactorDomain());
+    return logical.empty() ? nullptr : logical.front();
+  };
+  IterDomain* chunked_id =
+      outer_id(fusion->outputs().front()->as<TensorView>());
+  if (chunked_id == nullptr || chunked_id->isBroadcast()) {
+    return {};
+  }
+  ComputeAtMap ca_map(fusion);
+  auto is_chunked = [&](IterDomain* id) {
+    return ca_map.areMapped(id, chunked_id, IdMappingMode::EXACT);
+  };
+
+  for (Val* out : fusion->outputs()) {
+    IterDomain* id = outer_id(out->as<TensorView>());
+    if (id == nullptr || !is_chunked(id)) {
+      return {};
+    }
+  }
+
+  // Slicing may only change the outermost extent of each tensor
+  std::unordered_set<TensorView*> chunked_tvs;
+  for (TensorView* tv : ir_utils::allTvs(fusion)) {
+    IterDomain* outer = outer_id(tv);
+    for (const auto& domain :
+         {tv->getRootDomain(), tv->getMaybeRFactorDomain()}) {
+      for (IterDomain* id : domain) {
+        if (!is_chunked(id)) {
+          continue;
+        }
+        if (id != outer || id->isReduction() ||
+            id->extent()->isConstScalar() || !id->extent()->uses().empty()) {
+          return {};
+        }
+        chunked_tvs.insert(tv);
+      }
+    }
+  }
+  for (Expr* expr : fusion->exprs()) {
+    if (!isIndexDependent(expr)) {
+      continue;
+    }
+    for (auto vals : {expr->inputs(), expr->outputs()}) {
+      for (auto tv : ir_utils::filterByType<TensorView>(vals)) {
+        if (chunked_tvs.count(tv)) {
+          return {};
+        }
+      }
+    }
+  }
+
+  std::vector<bool> chunked_inputs;
+  chunked_inputs.reserve(fusion->inputs().size());
+  for (Val* in : fusion->inputs()) {
+    auto tv = dynamic_cast<TensorView*>(in);
+    chunked_inputs.push_back(tv != nullptr && chunked_tvs.count(tv));
+  }
+  if (std::none_of(chunked_inputs.begin(), chunked_inputs.end(), [](bool b) {
+        return b;
+      })) {
+    return {};
+  }
+  return chunked_inputs;
+}
+
+} // namespace
+
+namespace {
+
+//! Upper bound on the number of shards of an InputsIdLookup
+constexpr size_t kMaxInputsIdLookupShards = 8;
+
+//! A shard is only split off when each shard can still hold this many
+//! entries, so that eviction does not become too unfair
+constexpr size_t kMinInputsIdLookupShardSize = 16;
+
 } // namespace
 
+void InputsIdLookup::initShards(size_t max_cache_size) {
+  NVF_ERROR(max_cache_size > 0, "InputsIdLookup needs a positive cache size");
+  max_cache_size_ = max_cache_size;
+
+  // Small caches use a single shard, which keeps eviction exactly LRU
+  size_t num_shards = 1;
+  while (num_shards * 2 <= kMaxInputsIdLookupShards &&
+         max_cache_size / (num_shards * 2) >= kMinInputsIdLookupShardSize) {
+    num_shards *= 2;
+  }
+
+  shards_.clear();
+  for (const auto i : c10::irange(num_shards)) {
+    auto shard = std::make_unique<Shard>();
+    shard->max_size =
+        max_cache_size / num_shards + (i < max_cache_size % num_shards ? 1 : 0);
+    shards_.push_back(std::move(shard));
+  }
+}
+
+InputsIdLookup::Shard& InputsIdLookup::shardFor(
+    const std::string& encoding) const {
+  return *shards_.at(std::hash<std::string>{}(encoding) % shards_.size());
+}
+
+size_t InputsIdLookup::size() const {
+  size_t total_size = 0;
+  for (const auto& shard : shards_) {
+    std::shared_lock<std::shared_mutex> guard(shard->mutex);
+    total_size += shard->encoding_lookup.size();
+  }
+  return total_size;
+}
+
 flatbuffers::Offset<serde::InputsIdLookup> InputsIdLookup::serialize(
     flatbuffers::FlatBufferBuilder& builder) const {
   // See definitions in serde/fusion_cache.fbs for table
@@ -222,29 +574,38 @@ flatbuffers::Offset<serde::InputsIdLookup> InputsIdLookup::serialize(
 
   using fb_string = flatbuffers::Offset<flatbuffers::String>;
 
-  // For serialization, we require a consistent ordering for the
-  // encoding_lookup_ map.
-  std::unordered_map<std::string, size_t> str_key_ordering;
+  // Collect all entries ordered from the most to the least recently used,
+  // which is the order of the LRU list in the serialized format
+  std::vector<std::tuple<uint64_t, const std::string*, size_t>> entries;
+  std::vector<std::shared_lock<std::shared_mutex>> guards;
+  for (const auto& shard : shards_) {
+    guards.emplace_back(shard->mutex);
+    for (const auto& [key, value] : shard->encoding_lookup) {
+      entries.emplace_back(value.last_use.load(), &key, value.id);
+    }
+  }
+  std::sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) {
+    return std::get<0>(a) > std::get<0>(b);
+  });
 
-  // 1. Serialize used_entry_ list
+  // 1. Serialize LRU list
   std::vector<fb_string> lru_cache_fb;
-  for (const auto& str : used_entry_) {
-    lru_cache_fb.push_back(builder.CreateString(str));
-    str_key_ordering.emplace(str, str_key_ordering.size());
+  for (const auto& entry : entries) {
+    lru_cache_fb.push_back(builder.CreateString(*std::get<1>(entry)));
   }
 
-  // 2. Serialize encoding_lookup_ map
+  // 2. Serialize encoding lookup map
   std::vector<fb_string> encoding_lookup_keys_fb;
   std::vector<serde::EncodingEntry> encoding_lookup_values_fb;
-  for (auto&& [key, value] : encoding_lookup_) {
-    encoding_lookup_keys_fb.push_back(builder.CreateString(key));
-    encoding_lookup_values_fb.emplace_back(value.id, str_key_ordering.at(key));
+  for (const auto i : c10::irange(entries.size())) {
+    encoding_lookup_keys_fb.push_back(lru_cache_fb.at(i));
+    encoding_lookup_values_fb.emplace_back(std::get<2>(entries.at(i)), i);
   }
 
   return serde::CreateInputsIdLookupDirect(
       builder,
       max_cache_size_,
-      current_id_,
+      current_id_.load(),
       &lru_cache_fb,
       &encoding_lookup_keys_fb,
       &encoding_lookup_values_fb);
@@ -254,24 +615,23 @@ void InputsIdLookup::deserialize(const serde::InputsIdLookup* buffer) {
   // See definitions in serde/fusion_cache.fbs for tables
   // InputsIdLookup and EncodingEntry
   NVF_ERROR(buffer != nullptr, "serde::InputsIdLookup is nullptr.");
-  using list_iter = std::list<std::string>::iterator;
-  std::vector<list_iter> used_entry_iterators;
 
-  max_cache_size_ = buffer->max_cache_size();
+  initShards(buffer->max_cache_size());
   current_id_ = buffer->current_id();
-  for (auto fb_str : *buffer->lru_cache()) {
-    used_entry_.emplace_back(fb_str->str());
-    used_entry_iterators.emplace_back(std::prev(used_entry_.end()));
-  }
+
+  // The LRU list starts with the most recently used entry
+  const auto num_entries = buffer->lru_cache()->size();
+  use_counter_ = num_entries;
 
   for (auto idx : c10::irange(buffer->encoding_lookup_keys()->size())) {
     auto fb_encoding_lookup_str = buffer->encoding_lookup_keys()->Get(idx);
     auto fb_encoding_entry = buffer->encoding_lookup_values()->Get(idx);
 
-    EncodingEntry entry{
-        fb_encoding_entry->id(),
-        used_entry_iterators.at(fb_encoding_entry->lru_iter())};
-    encoding_lookup_.emplace(fb_encoding_lookup_str->str(), entry);
+    auto encoding = fb_encoding_lookup_str->str();
+    auto& shard = shardFor(encoding);
+    auto& entry = shard.encoding_lookup[encoding];
+    entry.id = fb_encoding_entry->id();
+    entry.last_use = num_entries - fb_encoding_entry->lru_iter();
   }
 }
 
@@ -281,34 +641,44 @@ InputsIdLookup::IdLookupReturn InputsIdLookup::lookupId(
     int8_t device) {
   IdLookupReturn ret;
 
-  // lock mutex_ because we are touching encoding_
-  std::lock_guard<std::mutex> guard(mutex_);
-  encoding_.clear();
-  encodeBuffer(device, encoding_);
+  // Reuse the buffer across calls instead of building a new string each time.
+  // It is thread-local, so encoding needs no locking.
+  thread_local std::string encoding;
+  encoding.clear();
+  encodeBuffer(device, encoding);
   for (const auto i : c10::irange(inputs.size())) {
-    auto input = inputs[i];
+    const auto& input = inputs[i];
     if (input.isTensor()) {
-      auto& input_tensor = input.toTensor();
+      const auto& input_tensor = input.toTensor();
 
+      // The rank comes first so that sizes and strides need no delimiters
+      encoding.push_back('t');
+      encodeBuffer(input_tensor.dim(), encoding);
       for (auto size : input_tensor.sizes()) {
-        encodeBuffer(size, encoding_);
-        encoding_.push_back(' ');
+        encodeBuffer(size, encoding);
       }
-      encoding_.push_back('X');
-      encoding_.push_back(' ');
       for (auto stride : input_tensor.strides()) {
-        encodeBuffer(stride, encoding_);
-        encoding_.push_back(' ');
-      }
-      encoding_.push_back('a');
-      encodeBuffer(
-          SchedulerRuntimeInfo::computeAlignmentSize(
-              (size_t)input_tensor.data_ptr()),
-          encoding_);
+        encodeBuffer(stride, encoding);
+      }
+      // Misaligned vectorization peels the same number of elements from all
+      // the vectorized inputs, so their offsets, not only their alignments,
+      // must match the ones the kernel was scheduled for. See
+      // [ Misaligned Pointwise Vectorization ].
+      if (isOptionEnabled(EnableOption::MisalignedVectorize)) {
+        encodeBuffer(
+            (size_t)input_tensor.data_ptr() %
+                SchedulerRuntimeInfo::max_alignment_size_in_byte,
+            encoding);
+      } else {
+        encodeBuffer(
+            SchedulerRuntimeInfo::computeAlignmentSize(
+                (size_t)input_tensor.data_ptr()),
+            encoding);
+      }
       // NOTE: device is set for the whole set of inputs first using device arg
     } else {
       // encode s for scalar;
-      encoding_.push_back('s');
+      encoding.push_back('s');
       if (scalar_inputs_to_record.find(i) != scalar_inputs_to_record.end()) {
         // Add value of scalars here only if it is one of the scalars
         // provided, as these are used in determining concretization.
@@ -316,13 +686,13 @@ InputsIdLookup::IdLookupReturn InputsIdLookup::lookupId(
         // any DataType might appear via `cast` and `where`, so we handle all
         // cases here.
         if (input.isInt()) {
-          encodeBuffer(input.toInt(), encoding_);
+          encodeBuffer(input.toInt(), encoding);
         } else if (input.isBool()) {
-          encodeBuffer(input.toBool(), encoding_);
+          encodeBuffer(input.toBool(), encoding);
         } else if (input.isDouble()) {
-          encodeBuffer(input.toDouble(), encoding_);
+          encodeBuffer(input.toDouble(), encoding);
         } else if (input.isComplexDouble()) {
-          encodeBuffer(input.toComplexDouble(), encoding_);
+          encodeBuffer(input.toComplexDouble(), encoding);
         } else {
           NVF_ERROR(
               false,
@@ -331,37 +701,93 @@ InputsIdLookup::IdLookupReturn InputsIdLookup::lookupId(
         }
       }
     }
-    encoding_.push_back(';');
   }
 
-  auto& entry = encoding_lookup_[encoding_];
+  auto& shard = shardFor(encoding);
+  const uint64_t now = ++use_counter_;
 
-  if (entry.id == 0) {
-    // no entry existed for given input set, set id for given entry
-    entry.id = current_id_++;
-    if (used_entry_.size() == max_cache_size_) {
-      // pop least recently used cache;
-      const auto& remove_iter = encoding_lookup_.find(used_entry_.back());
-      used_entry_.pop_back();
-      ret.evict_id = remove_iter->second.id;
-      ret.eviction = true;
-      encoding_lookup_.erase(remove_iter);
-    }
-  } else {
-    // short-cut to leave LRU entry as is
-    if (entry.lru_iter == used_entry_.begin()) {
-      ret.id = entry.id;
+  // Fast path: the entry exists, so only its last use needs to be updated
+  {
+    std::shared_lock<std::shared_mutex> guard(shard.mutex);
+    auto it = shard.encoding_lookup.find(encoding);
+    if (it != shard.encoding_lookup.end()) {
+      it->second.last_use.store(now, std::memory_order_relaxed);
+      ret.id = it->second.id;
       return ret;
     }
+  }
 
-    used_entry_.erase(entry.lru_iter);
+  std::unique_lock<std::shared_mutex> guard(shard.mutex);
+  // Another thread may have inserted the same encoding in the meantime
+  auto [entry_it, inserted] = shard.encoding_lookup.try_emplace(encoding);
+  auto& entry = entry_it->second;
+  entry.last_use.store(now, std::memory_order_relaxed);
+  if (!inserted) {
+    ret.id = entry.id;
+    return ret;
   }
 
+  // no entry existed for given input set, set id for given entry
+  entry.id = current_id_++;
   ret.id = entry.id;
-  entry.lru_iter = used_entry_.insert(used_entry_.begin(), encoding_);
+
+  if (shard.encoding_lookup.size() > shard.max_size) {
+    // pop least recently used cache;
+    auto lru_it = shard.encoding_lookup.end();
+    for (auto it = shard.encoding_lookup.begin();
+         it != shard.encoding_lookup.end();
+         ++it) {
+      if (it != entry_it &&
+          (lru_it == shard.encoding_lookup.end() ||
+           it->second.last_use.load(std::memory_order_relaxed) <
+               lru_it->second.last_use.load(std::memory_order_relaxed))) {
+        lru_it = it;
+      }
+    }
+    NVF_ERROR(lru_it != shard.encoding_lookup.end());
+    ret.evict_id = lru_it->second.id;
+    ret.eviction = true;
+    shard.encoding_lookup.erase(lru_it);
+  }
+
   return ret;
 }
 
+InputDescriptor InputDescriptor::tensor(
+    const std::vector<int64_t>& sizes,
+    const std::vector<int64_t>& strides,
+    at::ScalarType dtype) {
+  NVF_CHECK(
+      sizes.size() == strides.size(),
+      "Expected a stride per dimension, but got ",
+      strides.size(),
+      " strides for ",
+      sizes.size(),
+      " dimensions");
+  return {at::Tensor(at::detail::empty_strided_meta(
+      sizes,
+      strides,
+      dtype,
+      c10::nullopt,
+      c10::Device(c10::DeviceType::Meta, 0),
+      c10::nullopt))};
+}
+
+InputDescriptor InputDescriptor::tensor(
+    const std::vector<int64_t>& sizes,
+    at::ScalarType dtype) {
+  std::vector<int64_t> strides(sizes.size(), 1);
+  for (int64_t i = (int64_t)sizes.size() - 2; i >= 0; i--) {
+    strides.at(i) = strides.at(i + 1) * std::max(sizes.at(i + 1), (int64_t)1);
+  }
+  return tensor(sizes, strides, dtype);
+}
+
+InputDescriptor InputDescriptor::scalar(const c10::IValue& value) {
+  NVF_CHECK(!value.isTensor(), "Tensor inputs are described by their sizes");
+  return {value};
+}
+
 FusionExecutorCache::FusionExecutorCache(
     std::unique_ptr<Fusion> fusion,
     int64_t fusion_id)
@@ -407,6 +833,51 @@ bool FusionExecutorCache::isCompiled(
   return getKernelRuntimeFor(args)->isCompiled();
 }
 
+int64_t FusionExecutorCache::predictPeakMemory(
+    const at::ArrayRef<c10::IValue>& inputs,
+    int8_t device) {
+  FUSER_PERF_SCOPE("FusionExecutorCache::predictPeakMemory");
+
+  KernelArgumentHolder args = prepareInputs(inputs);
+  args.setDeviceIndex(device);
+
+  return getKernelRuntimeFor(args)->predictPeakMemory(args);
+}
+
+std::vector<SignatureEvaluation> FusionExecutorCache::evaluateSignatures(
+    const std::vector<std::vector<InputDescriptor>>& signatures,
+    int8_t device) {
+  FUSER_PERF_SCOPE("FusionExecutorCache::evaluateSignatures");
+
+  std::lock_guard<std::mutex> cache_lock(mutex_);
+  std::vector<SignatureEvaluation> evaluations;
+  evaluations.reserve(signatures.size());
+  for (const auto& signature : signatures) {
+    std::vector<c10::IValue> inputs;
+    inputs.reserve(signature.size());
+    std::transform(
+        signature.begin(),
+        signature.end(),
+        std::back_inserter(inputs),
+        [](const InputDescriptor& input) { return input.value; });
+
+    // Same as prepareInputs, except that meta tensors have no CUDA device to
+    // take the device index from
+    KernelArgumentHolder args;
+    args.setDeviceIndex(device);
+    args.push(inputs);
+    auto id_lookup_ret = inputs_id_lookup_.lookupId(
+        inputs, initialInfo().scalarInputsAffectingConcretization(), device);
+    if (id_lookup_ret.eviction) {
+      evictCache(id_lookup_ret.evict_id);
+    }
+    args.setCacheId(id_lookup_ret.id);
+
+    evaluations.push_back(getKernelRuntimeFor(args)->evaluateSignature(args));
+  }
+  return evaluations;
+}
+
 // Note [ Permutation support in nvfuser ]
 //
 // Background:
@@ -441,15 +912,328 @@ bool FusionExecutorCache::isCompiled(
 // For details on Part_2, refer to the implementation note. [ Permutation
 // Bookkeeping and Propagation in Parser ]
 std::vector<at::Tensor> FusionExecutorCache::runFusionWithInputs(
+    const at::ArrayRef<c10::IValue>& inputs,
+    std::optional<PrimDataType> forced_index_type,
+    std::optional<int8_t> selected_device,
+    const std::vector<at::Tensor>& preallocated_outputs) {
+  if (hasHostTensors(fusion_.get(), inputs, preallocated_outputs)) {
+    return runStreamed(
+        inputs, forced_index_type, selected_device, preallocated_outputs);
+  }
+  if (preallocated_outputs.empty() &&
+      isOptionEnabled(EnableOption::ChunkedExecution)) {
+    auto outputs = runChunked(inputs, forced_index_type, selected_device);
+    if (outputs.has_value()) {
+      return std::move(outputs.value());
+    }
+  }
+  return runUnchunked(
+      inputs, forced_index_type, selected_device, preallocated_outputs);
+}
+
+const std::vector<bool>& FusionExecutorCache::getChunkedInputs() {
+  if (!chunked_inputs_.has_value()) {
+    chunked_inputs_ = initialInfo().isDynamic() ? std::vector<bool>()
+                                                : chunkedInputs(fusion_.get());
+  }
+  return chunked_inputs_.value();
+}
+
+std::optional<std::vector<at::Tensor>> FusionExecutorCache::runChunked(
     const at::ArrayRef<c10::IValue>& inputs,
     std::optional<PrimDataType> forced_index_type,
     std::optional<int8_t> selected_device) {
+  FUSER_PERF_SCOPE("FusionExecutorCache::runChunked");
+
+  int64_t num_chunks = 1;
+  {
+    std::lock_guard<std::mutex> cache_lock(mutex_);
+    if (getChunkedInputs().empty()) {
+      return std::nullopt;
+    }
+
+    KernelArgumentHolder args = prepareInputs(inputs, selected_device);
+    const int64_t peak = getKernelRuntimeFor(args, forced_index_type)
+                             ->predictPeakMemory(args);
+    int64_t budget = (int64_t)at::cuda::getDeviceProperties(
+                         args.getDeviceIndex())
+                         ->totalGlobalMem /
+        2;
+    const auto& option_args =
+        getEnableOptionArguments(EnableOption::ChunkedExecution);
+    if (!option_args.empty()) {
+      try {
+        budget = std::stoll(option_args.at(0)) << 20;
+      } catch (const std::exception& e) {
+        debug() << "skip invalid argument for ChunkedExecution, arg = "
+                << option_args.at(0) << std::endl;
+      }
+    }
+    if (budget > 0 && peak > budget) {
+      num_chunks = ceilDiv(peak, budget);
+    }
+  }
+  if (num_chunks == 1) {
+    return std::nullopt;
+  }
+
+  // The chunked inputs all have the extent of the chunked dimension
+  int64_t extent = -1;
+  for (const auto i : c10::irange(inputs.size())) {
+    if (chunked_inputs_->at(i)) {
+      extent = inputs[i].toTensor().size(0);
+      break;
+    }
+  }
+  const int64_t chunk_size =
+      roundUpToMultiple(ceilDiv(extent, num_chunks), kChunkAlignment);
+  if (chunk_size >= extent) {
+    return std::nullopt;
+  }
+
+  std::vector<at::Tensor> outputs;
+  // Whether the slices of each output are laid out like the outputs of the
+  // kernels, i.e., the chunked dimension is the outermost in memory
+  std::vector<bool> is_outer_major;
+  std::vector<c10::IValue> chunk_inputs = inputs.vec();
+  for (int64_t start = 0; start < extent; start += chunk_size) {
+    const int64_t length = std::min(chunk_size, extent - start);
+    for (const auto i : c10::irange(inputs.size())) {
+      if (chunked_inputs_->at(i)) {
+        chunk_inputs[i] = inputs[i].toTensor().narrow(0, start, length);
+      }
+    }
+
+    if (outputs.empty()) {
+      outputs = runUnchunked(
+          chunk_inputs, forced_index_type, selected_device, {});
+      for (at::Tensor& output : outputs) {
+        std::vector<int64_t> sizes = output.sizes().vec();
+        sizes.at(0) = extent;
+        is_outer_major.push_back(
+            output.is_non_overlapping_and_dense() &&
+            output.stride(0) * length == output.numel());
+        // Outer-major outputs keep their strides, so their slices are
+        // written by the kernels of the following chunks
+        at::Tensor full_output = is_outer_major.back()
+            ? at::empty_strided(sizes, output.strides(), output.options())
+            : at::empty(
+                  sizes,
+                  output.options().memory_format(
+                      output.suggest_memory_format()));
+        full_output.narrow(0, 0, length).copy_(output);
+        output = full_output;
+      }
+      continue;
+    }
+
+    std::vector<at::Tensor> slices;
+    std::vector<at::Tensor> output_buffers;
+    slices.reserve(outputs.size());
+    output_buffers.reserve(outputs.size());
+    for (const auto i : c10::irange(outputs.size())) {
+      at::Tensor slice = outputs.at(i).narrow(0, start, length);
+      output_buffers.push_back(is_outer_major.at(i) ? slice : at::Tensor());
+      slices.push_back(std::move(slice));
+    }
+    std::vector<at::Tensor> chunk_outputs = runUnchunked(
+        chunk_inputs, forced_index_type, selected_device, output_buffers);
+    for (const auto i : c10::irange(outputs.size())) {
+      if (!chunk_outputs.at(i).is_same(slices.at(i))) {
+        slices.at(i).copy_(chunk_outputs.at(i));
+      }
+    }
+  }
+  return outputs;
+}
+
+std::vector<at::Tensor> FusionExecutorCache::runStreamed(
+    const at::ArrayRef<c10::IValue>& inputs,
+    std::optional<PrimDataType> forced_index_type,
+    std::optional<int8_t> selected_device,
+    const std::vector<at::Tensor>& preallocated_outputs) {
+  FUSER_PERF_SCOPE("FusionExecutorCache::runStreamed");
+
+  std::vector<bool> chunked_inputs;
+  {
+    std::lock_guard<std::mutex> cache_lock(mutex_);
+    chunked_inputs = getChunkedInputs();
+  }
+  NVF_CHECK(
+      !chunked_inputs.empty(),
+      "Host tensors can only be given to fusions that can be chunked, see ",
+      "[ Chunked Execution ]");
+  // Caller-owned outputs of a streamed run are written by the copies
+  for (const at::Tensor& output : preallocated_outputs) {
+    NVF_CHECK(
+        !output.defined() || (output.is_cpu() && output.is_pinned()),
+        "Outputs given with host tensor inputs must be pinned host tensors");
+  }
+
+  const c10::DeviceIndex device = selected_device.has_value()
+      ? (c10::DeviceIndex)selected_device.value()
+      : c10::cuda::current_device();
+  c10::cuda::CUDAGuard device_guard(device);
+
+  // The extent of the chunked dimension and the bytes of a row of it in the
+  // host inputs
+  int64_t extent = -1;
+  int64_t host_row_bytes = 0;
+  for (const auto i : c10::irange(inputs.size())) {
+    if (!chunked_inputs.at(i)) {
+      continue;
+    }
+    const at::Tensor& input = inputs[i].toTensor();
+    extent = input.size(0);
+    if (input.is_cpu()) {
+      NVF_CHECK(input.is_pinned(), "Host tensor inputs must be pinned");
+      host_row_bytes +=
+          (int64_t)input.nbytes() / std::max(extent, (int64_t)1);
+    }
+  }
+  const int64_t tile_size = std::min(
+      roundUpToMultiple(
+          ceilDiv(
+              host_streaming_tile_bytes_,
+              std::max(host_row_bytes, (int64_t)1)),
+          kChunkAlignment),
+      std::max(extent, (int64_t)1));
+
+  // Host inputs that aren't chunked are copied at once, while each chunked
+  // one gets two staging buffers on the device
+  std::vector<c10::IValue> tile_inputs = inputs.vec();
+  std::vector<std::array<at::Tensor, 2>> staging(inputs.size());
+  for (const auto i : c10::irange(inputs.size())) {
+    if (!inputs[i].isTensor() || !inputs[i].toTensor().is_cpu() ||
+        inputs[i].toTensor().dim() == 0) {
+      continue;
+    }
+    const at::Tensor& input = inputs[i].toTensor();
+    NVF_CHECK(input.is_pinned(), "Host tensor inputs must be pinned");
+    if (!chunked_inputs.at(i)) {
+      tile_inputs[i] = input.to(
+          input.options().device(at::kCUDA, device),
+          /*non_blocking=*/true);
+      continue;
+    }
+    std::vector<int64_t> sizes = input.sizes().vec();
+    sizes.at(0) = tile_size;
+    for (at::Tensor& buffer : staging.at(i)) {
+      buffer = at::empty(
+          sizes,
+          input.options()
+              .device(at::kCUDA, device)
+              .pinned_memory(false)
+              .memory_format(input.suggest_memory_format()));
+    }
+  }
+
+  // Tile t is copied in on h2d_stream, computed on the current stream and
+  // copied out on d2h_stream. The staging buffers and the outputs of slot
+  // t % 2 are reused by tile t + 2 once the kernels and the copies of tile
+  // t are done.
+  c10::cuda::CUDAStream compute_stream = at::cuda::getCurrentCUDAStream();
+  c10::cuda::CUDAStream h2d_stream = at::cuda::getStreamFromPool(false, device);
+  c10::cuda::CUDAStream d2h_stream = at::cuda::getStreamFromPool(false, device);
+  std::array<at::cuda::CUDAEvent, 2> inputs_copied;
+  std::array<at::cuda::CUDAEvent, 2> tile_computed;
+  std::array<at::cuda::CUDAEvent, 2> outputs_copied;
+
+  std::vector<at::Tensor> outputs;
+  for (int64_t start = 0, tile = 0; start < extent;
+       start += tile_size, ++tile) {
+    const int64_t length = std::min(tile_size, extent - start);
+    const size_t slot = tile % 2;
+
+    {
+      c10::cuda::CUDAStreamGuard stream_guard(h2d_stream);
+      tile_computed.at(slot).block(h2d_stream);
+      for (const auto i : c10::irange(inputs.size())) {
+        if (!chunked_inputs.at(i)) {
+          continue;
+        }
+        const at::Tensor& input = inputs[i].toTensor();
+        if (!input.is_cpu()) {
+          tile_inputs[i] = input.narrow(0, start, length);
+          continue;
+        }
+        at::Tensor buffer = staging.at(i).at(slot).narrow(0, 0, length);
+        buffer.copy_(input.narrow(0, start, length), /*non_blocking=*/true);
+        tile_inputs[i] = buffer;
+      }
+      inputs_copied.at(slot).record(h2d_stream);
+    }
+
+    inputs_copied.at(slot).block(compute_stream);
+    outputs_copied.at(slot).block(compute_stream);
+    std::vector<at::Tensor> tile_outputs =
+        runUnchunked(tile_inputs, forced_index_type, selected_device, {});
+    tile_computed.at(slot).record(compute_stream);
+
+    if (outputs.empty()) {
+      for (const auto i : c10::irange(tile_outputs.size())) {
+        const at::Tensor& tile_output = tile_outputs.at(i);
+        if (i < preallocated_outputs.size() &&
+            preallocated_outputs.at(i).defined()) {
+          const at::Tensor& output = preallocated_outputs.at(i);
+          NVF_CHECK(
+              output.size(0) == extent &&
+                  output.sizes().slice(1) == tile_output.sizes().slice(1) &&
+                  output.scalar_type() == tile_output.scalar_type(),
+              "The given output ",
+              i,
+              " does not match the output of the fusion");
+          outputs.push_back(output);
+          continue;
+        }
+        std::vector<int64_t> sizes = tile_output.sizes().vec();
+        sizes.at(0) = extent;
+        outputs.push_back(at::empty(
+            sizes,
+            tile_output.options()
+                .device(at::kCPU)
+                .pinned_memory(true)
+                .memory_format(tile_output.suggest_memory_format())));
+      }
+    }
+
+    c10::cuda::CUDAStreamGuard stream_guard(d2h_stream);
+    tile_computed.at(slot).block(d2h_stream);
+    for (const auto i : c10::irange(outputs.size())) {
+      outputs.at(i)
+          .narrow(0, start, length)
+          .copy_(tile_outputs.at(i), /*non_blocking=*/true);
+      // Keeps the allocator from reusing the output before it's copied
+      tile_outputs.at(i).record_stream(d2h_stream);
+    }
+    outputs_copied.at(slot).record(d2h_stream);
+  }
+
+  // The staging buffers are freed on the current stream, and the outputs
+  // are read on the host
+  d2h_stream.synchronize();
+  h2d_stream.synchronize();
+  return outputs;
+}
+
+std::vector<at::Tensor> FusionExecutorCache::runUnchunked(
+    const at::ArrayRef<c10::IValue>& inputs,
+    std::optional<PrimDataType> forced_index_type,
+    std::optional<int8_t> selected_device,
+    const std::vector<at::Tensor>& preallocated_outputs) {
   FUSER_PERF_SCOPE("FusionExecutorCache::runFusionWithInputs");
   // NOTE: This should be the first code in the method to capture all host time
   if (isProfilerEnabled()) {
     FusionProfiler::start(isProfilerEnabledWithoutCupti());
   }
 
+  // Guards the lookup and compilation of the runtime. See
+  // [ Concurrent Execution ].
+  std::unique_lock<std::mutex> cache_lock(mutex_);
+
+  // See [ Fusion Telemetry ]
+  const bool sample_run = telemetry_.beginRun();
+
   // Permute input tensor for kernel execution.
   // See Part_1 in Note [ Channels-Last support in nvfuser ]
   at::ArrayRef<c10::IValue> perm_inputs = inputs;
@@ -467,19 +1251,63 @@ std::vector<at::Tensor> FusionExecutorCache::runFusionWithInputs(
     perm_inputs = inputs_vec;
   }
 
+  if (isProfilerEnabled()) {
+    FusionProfiler::startInputEncoding();
+  }
   KernelArgumentHolder args = prepareInputs(perm_inputs, selected_device);
+  if (isProfilerEnabled()) {
+    FusionProfiler::stopInputEncoding();
+    FusionProfiler::startRuntimeLookup();
+  }
   auto kernel_runtime = getKernelRuntimeFor(args, forced_index_type);
+  if (isProfilerEnabled()) {
+    FusionProfiler::stopRuntimeLookup();
+  }
+  // See [ Annotated NVTX Ranges ]
+  inst::AnnotatedRange nvtx_range(fusion_id_, [&]() {
+    std::stringstream ss;
+    ss << "fusion " << fusion_id_ << " runtime c"
+       << kernel_runtime->concreteId() << "_r" << kernel_runtime->runtimeId()
+       << " (" << runtimeLookupName(most_recent_lookup_) << ")";
+    return ss.str();
+  });
 
   if (isProfilerEnabled()) {
     FusionProfiler::createSegments(kernel_runtime->executors().size());
   }
 
+  // Without a compiled kernel, run the fusion with the precompiled
+  // interpreter or evaluate it with ATen while compiling in the background if
+  // possible. See [ Asynchronous Compilation ] and
+  // [ Interpreted Pointwise Kernels ].
+  std::optional<std::vector<at::Tensor>> fallback_outputs;
   if (!kernel_runtime->isCompiled()) {
-    kernel_runtime->compileFusionParallel(args);
-  }
-
-  if (measure_kernel_time_) {
-    kernel_runtime->enableKernelTimeMeasurement();
+    const auto compile_start = std::chrono::steady_clock::now();
+    const bool async_compile = isOptionEnabled(EnableOption::AsyncCompile) ||
+        kernel_runtime->canRunWithInterpreter();
+    if ((async_compile && !isProfilerEnabled()) ||
+        kernel_runtime->isAsyncCompileQueued()) {
+      kernel_runtime->compileFusionAsync(args);
+      if (kernel_runtime->isAsyncCompilePending()) {
+        fallback_outputs = kernel_runtime->runWithInterpreter(args);
+      }
+      if (!fallback_outputs.has_value() &&
+          kernel_runtime->isAsyncCompilePending() &&
+          isOptionEnabled(EnableOption::AsyncCompile)) {
+        fallback_outputs = kernel_runtime->runWithExpressionEvaluator(args);
+      }
+      if (!fallback_outputs.has_value()) {
+        kernel_runtime->waitForAsyncCompile();
+      }
+    } else {
+      kernel_runtime->compileFusionParallel(args);
+    }
+    // A run evaluated with a fallback doesn't wait for the compilation
+    if (!fallback_outputs.has_value()) {
+      const std::chrono::duration<double, std::milli> blocked =
+          std::chrono::steady_clock::now() - compile_start;
+      telemetry_.recordCompilation(blocked.count());
+    }
   }
 
   most_recent_runtime_ = kernel_runtime;
@@ -495,6 +1323,54 @@ std::vector<at::Tensor> FusionExecutorCache::runFusionWithInputs(
         " failed");
   }
 
+  // Index the given outputs like the outputs of the complete fusion, which
+  // include the hidden ones. See [ Caller-Owned Outputs ].
+  std::vector<at::Tensor> output_buffers;
+  if (!preallocated_outputs.empty()) {
+    NVF_CHECK(
+        fusion->getPermutationOutputMap().empty(),
+        "Outputs can't be given for a fusion with permuted outputs");
+    output_buffers.reserve(fusion->outputs().size());
+    size_t num_returned = 0;
+    for (Val* out : fusion->outputs()) {
+      const AliasInfo* alias_info = fusion->getOutputAlias(out).second;
+      if (alias_info != nullptr && alias_info->hide_output) {
+        output_buffers.emplace_back();
+        continue;
+      }
+      NVF_CHECK(
+          num_returned < preallocated_outputs.size(),
+          "Expected ",
+          num_returned + 1,
+          " or more outputs but ",
+          preallocated_outputs.size(),
+          " were given");
+      const at::Tensor& buffer = preallocated_outputs.at(num_returned++);
+      NVF_CHECK(
+          !buffer.defined() || alias_info == nullptr,
+          "An output can't be given for ",
+          out->toString(),
+          ", which aliases an input");
+      output_buffers.push_back(buffer);
+    }
+    NVF_CHECK(
+        num_returned == preallocated_outputs.size(),
+        "Expected ",
+        num_returned,
+        " outputs but ",
+        preallocated_outputs.size(),
+        " were given");
+  }
+
+  // Other threads may look up and compile runtimes while this one runs, but
+  // only one of them runs a runtime at a time
+  cache_lock.unlock();
+  std::lock_guard<std::mutex> run_guard(kernel_runtime->runMutex());
+
+  if (measure_kernel_time_) {
+    kernel_runtime->enableKernelTimeMeasurement();
+  }
+
   int seq_id = 0;
   // Record kernel input and output tensors so profiler can construct
   // the data flow graph
@@ -502,7 +1378,44 @@ std::vector<at::Tensor> FusionExecutorCache::runFusionWithInputs(
       "run_fused_kernel",
       std::vector<c10::IValue>(inputs.begin(), inputs.end()),
       seq_id);
-  auto outputs = kernel_runtime->runWithInputs(args);
+  std::optional<FusionTelemetry::Sample> sample;
+  if (sample_run && !fallback_outputs.has_value()) {
+    sample = telemetry_.startSample(
+        at::cuda::getCurrentCUDAStream(args.getDeviceIndex()));
+  }
+  auto outputs = fallback_outputs.has_value()
+      ? std::move(fallback_outputs.value())
+      : kernel_runtime->runWithInputs(args, output_buffers);
+  if (sample.has_value()) {
+    telemetry_.stopSample(
+        sample.value(), at::cuda::getCurrentCUDAStream(args.getDeviceIndex()));
+  }
+  if (telemetry_.isEnabled()) {
+    int64_t bytes_moved = 0;
+    for (const c10::IValue& input : inputs) {
+      if (input.isTensor()) {
+        bytes_moved += (int64_t)input.toTensor().nbytes();
+      }
+    }
+    for (const at::Tensor& output : outputs) {
+      if (output.defined()) {
+        bytes_moved += (int64_t)output.nbytes();
+      }
+    }
+    telemetry_.recordRun(
+        fallback_outputs.has_value()
+            ? 0
+            : (int64_t)kernel_runtime->executors().size(),
+        bytes_moved);
+  }
+  // Outputs not written by a kernel are copied to the given tensors
+  for (const auto i : c10::irange(output_buffers.size())) {
+    const at::Tensor& buffer = output_buffers.at(i);
+    if (buffer.defined() && !buffer.is_same(outputs.at(i))) {
+      buffer.copy_(outputs.at(i));
+      outputs.at(i) = buffer;
+    }
+  }
   RECORD_OUTPUTS(outputs);
 
   // Kernel time measurement is off by default
@@ -534,6 +1447,9 @@ std::vector<at::Tensor> FusionExecutorCache::runFusionWithInputs(
   // NOTE: This should be the last code in the method to capture all host time
   if (isProfilerEnabled()) {
     FusionProfiler::stop();
+    if (isProfilerCollectingMetrics()) {
+      kernel_runtime->recordAchievedOccupancy(FusionProfiler::profile());
+    }
   }
   if (isProfilerPrintingEnabled()) {
     debug() << FusionProfiler::profile();
@@ -584,6 +1500,18 @@ std::string FusionExecutorCache::getMostRecentCode(bool intrinsic_code) const {
   return getCode(most_recent_runtime_, intrinsic_code);
 }
 
+std::vector<FusionExecutor::KernelResources> FusionExecutorCache::
+    getMostRecentKernelResources() const {
+  NVF_CHECK(most_recent_runtime_ != nullptr, "No fusion has been executed!");
+  std::vector<FusionExecutor::KernelResources> resources;
+  for (const auto& exec : most_recent_runtime_->executors()) {
+    if (exec.isCompiled()) {
+      resources.push_back(exec.kernelResources());
+    }
+  }
+  return resources;
+}
+
 std::string FusionExecutorCache::getCodeFor(
     const at::ArrayRef<c10::IValue>& inputs,
     bool intrinsic_code) {
@@ -625,6 +1553,39 @@ std::string FusionExecutorCache::getScheduledIrFor(
   return getScheduledIr(kernel_runtime, tensor_transforms);
 }
 
+std::pair<size_t, size_t> FusionExecutorCache::loadedModules() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  size_t num_modules = 0;
+  size_t module_bytes = 0;
+  // Executors of identical code share a module, see [ Kernel Deduplication ]
+  std::unordered_set<CUmodule> modules;
+  for (const auto& [conc_info, runtimes] : kernel_runtimes_) {
+    for (const auto& runtime : runtimes) {
+      // Executors of runtimes that are compiled in the background are not
+      // read until they are done
+      if (!runtime->isCompiled()) {
+        continue;
+      }
+      for (const auto& executor : runtime->executors()) {
+        if (!executor.isCompiled()) {
+          continue;
+        }
+        const auto& compiled_kernel = executor.compiledKernel();
+        // Deserialized modules are only loaded at their first use, see
+        // [ Lazy Module Loading ]
+        if (compiled_kernel.module == nullptr ||
+            !modules.insert(compiled_kernel.module).second) {
+          continue;
+        }
+        ++num_modules;
+        module_bytes +=
+            std::max(compiled_kernel.cubin.size(), compiled_kernel.ptx.size());
+      }
+    }
+  }
+  return {num_modules, module_bytes};
+}
+
 void FusionExecutorCache::evictCache(size_t cache_id) {
   auto it = id_to_kernel_runtime_.find(cache_id);
   NVF_ERROR(it != id_to_kernel_runtime_.end());
@@ -632,52 +1593,243 @@ void FusionExecutorCache::evictCache(size_t cache_id) {
   id_to_kernel_runtime_.erase(it);
 }
 
-DynamicTransformInitialInfo& FusionExecutorCache::initialInfo() {
-  if (!initial_info_.has_value()) {
-    initial_info_ = DynamicTransform::getInitialInfo(fusion());
-    fusion()->manage(
-        "initial_info",
-        initial_info_.value(),
-        [](IrCloner& ir_cloner, std::any data) -> std::any {
-          return std::any_cast<DynamicTransformInitialInfo>(data).clone(
-              ir_cloner);
-        });
-  }
-  return initial_info_.value();
+int64_t ShapeBuckets::bucket(int64_t extent) const {
+  // Small extents are kept as they are, so that rounding them up doesn't
+  // change the powers of two they are divisible by
+  constexpr int64_t max_kept_extent = 16;
+  if (kind == Kind::None || extent <= max_kept_extent) {
+    return extent;
+  }
+  int64_t rounded = kind == Kind::PowerOfTwo
+      ? scheduler_utils::roundUpPow2(extent)
+      : roundUpToMultiple(extent, multiple);
+  NVF_ERROR(rounded % max_kept_extent == 0);
+
+  // Keep the largest power of two up to 16 dividing the extent
+  const int64_t pow2 = extent & -extent;
+  return pow2 < max_kept_extent ? rounded + pow2 : rounded;
 }
 
-FusionKernelRuntime* FusionExecutorCache::getKernelRuntimeFor(
-    const KernelArgumentHolder& args,
-    std::optional<PrimDataType> forced_index_type) {
-  // Check for id hit case
-  auto unique_id_opt = args.getCacheId();
+void FusionExecutorCache::setShapeBuckets(const ShapeBuckets& shape_buckets) {
   NVF_CHECK(
-      unique_id_opt.has_value(),
-      "KernelArgumentHolder has no cache ID in getKernelRuntimeFor");
-  auto unique_id = *unique_id_opt;
-  auto id_it = id_to_kernel_runtime_.find(unique_id);
+      shape_buckets.kind != ShapeBuckets::Kind::Multiple ||
+          (shape_buckets.multiple > 0 && shape_buckets.multiple % 16 == 0),
+      "Shape bucket multiple must be a positive multiple of 16 but got ",
+      shape_buckets.multiple);
+  shape_buckets_ = shape_buckets;
+}
+
+bool FusionExecutorCache::canBucketShapes() {
+  if (can_bucket_shapes_.has_value()) {
+    return can_bucket_shapes_.value();
+  }
+
+  // Integer scalars may be used as extents, which would then be
+  // inconsistent with the rounded extents of the tensor inputs
+  bool can_bucket = !initialInfo().isDynamic() &&
+      std::none_of(fusion_->inputs().begin(),
+                   fusion_->inputs().end(),
+                   [](Val* input) { return input->isIntegralScalar(); }) &&
+      !ir_utils::hasOpsOfType<
+          FullOp,
+          IotaOp,
+          EyeOp,
+          ExpandOp,
+          ViewOp,
+          SliceOp,
+          PadOp,
+          CatOp>(fusion_.get());
+  can_bucket_shapes_ = can_bucket;
+  return can_bucket;
+}
+
+std::optional<KernelArgumentHolder> FusionExecutorCache::getBucketedArgs(
+    const KernelArgumentHolder& args) {
+  if (shape_buckets_.kind == ShapeBuckets::Kind::None || !canBucketShapes()) {
+    return std::nullopt;
+  }
+  FUSER_PERF_SCOPE("FusionExecutorCache::getBucketedArgs");
+
+  KernelArgumentHolder bucketed_args;
+  bucketed_args.setDeviceIndex(args.getDeviceIndex());
+  for (const auto i : c10::irange(args.size())) {
+    auto input_tv = dynamic_cast<TensorView*>(fusion_->inputs().at(i));
+    if (input_tv == nullptr || !args[i]->is<at::Tensor>() ||
+        !args[i]->as<at::Tensor>().is_cuda()) {
+      bucketed_args.push(*args[i]);
+      continue;
+    }
+
+    // Alignment of the data pointer and of the strides is part of the
+    // heuristics, so only inputs that are maximally aligned both before and
+    // after rounding are bucketed
+    const auto& tensor = args[i]->as<at::Tensor>();
+    if (!tensor.is_non_overlapping_and_dense() ||
+        (size_t)tensor.data_ptr() % 16 != 0) {
+      return std::nullopt;
+    }
+
+    auto logical_domain =
+        TensorDomain::noReductions(input_tv->getMaybeRFactorDomain());
+    NVF_ERROR((int64_t)logical_domain.size() == tensor.dim());
+    std::vector<int64_t> sizes = tensor.sizes().vec();
+    for (const auto dim : c10::irange(tensor.dim())) {
+      if (!logical_domain.at(dim)->getMaybeExpandedExtent()->isConstScalar()) {
+        sizes.at(dim) = shape_buckets_.bucket(sizes.at(dim));
+      }
+    }
+
+    // Dense strides for the rounded sizes in the original stride order
+    std::vector<int64_t> stride_order(tensor.dim());
+    std::iota(stride_order.begin(), stride_order.end(), 0);
+    std::stable_sort(
+        stride_order.begin(), stride_order.end(), [&](int64_t a, int64_t b) {
+          return tensor.stride(a) > tensor.stride(b);
+        });
+    std::vector<int64_t> strides(tensor.dim(), 1);
+    int64_t stride = 1;
+    for (auto it = stride_order.rbegin(); it != stride_order.rend(); ++it) {
+      strides.at(*it) = stride;
+      stride *= sizes.at(*it);
+    }
+    bucketed_args.pushTensorProxy(sizes, strides, tensor.scalar_type());
+  }
+  return bucketed_args;
+}
+
+std::optional<std::string> FusionExecutorCache::getRootDynamicValsKey(
+    const DynamicTransformInitialInfo& initial_info,
+    const KernelArgumentHolder& args) const {
+  const auto& positions = initial_info.getRootDynamicValPositions();
+  if (!positions.has_value()) {
+    return std::nullopt;
+  }
+  std::string key;
+  for (const auto& [input_index, axis] : positions.value()) {
+    const PolymorphicValue& arg = *args[input_index];
+    if (axis >= 0) {
+      encodeBuffer(arg.as<at::Tensor>().size(axis), key);
+    } else if (arg.is<int64_t>()) {
+      encodeBuffer(arg.as<int64_t>(), key);
+    } else if (arg.is<bool>()) {
+      encodeBuffer(arg.as<bool>(), key);
+    } else if (arg.is<double>()) {
+      encodeBuffer(arg.as<double>(), key);
+    } else {
+      return std::nullopt;
+    }
+  }
+  return key;
+}
+
+DynamicTransformInitialInfo& FusionExecutorCache::initialInfo() {
+  if (!initial_info_.has_value()) {
+    initial_info_ = DynamicTransform::getInitialInfo(fusion());
+    fusion()->manage(
+        "initial_info",
+        initial_info_.value(),
+        [](IrCloner& ir_cloner, std::any data) -> std::any {
+          return std::any_cast<DynamicTransformInitialInfo>(data).clone(
+              ir_cloner);
+        });
+  }
+  return initial_info_.value();
+}
+
+void FusionExecutorCache::recordRuntimeLookup(
+    FusionTelemetry::RuntimeLookup lookup) {
+  most_recent_lookup_ = lookup;
+  telemetry_.recordRuntimeLookup(lookup);
+}
+
+FusionKernelRuntime* FusionExecutorCache::getKernelRuntimeFor(
+    const KernelArgumentHolder& args,
+    std::optional<PrimDataType> forced_index_type) {
+  // Check for id hit case
+  auto unique_id_opt = args.getCacheId();
+  NVF_CHECK(
+      unique_id_opt.has_value(),
+      "KernelArgumentHolder has no cache ID in getKernelRuntimeFor");
+  auto unique_id = *unique_id_opt;
+  auto id_it = id_to_kernel_runtime_.find(unique_id);
   if (id_it != id_to_kernel_runtime_.end()) {
     // If the forced index type is given, don't use the cached runtime
     // if its index type does not match with the forced type
     if (!forced_index_type.has_value() ||
         forced_index_type.value() == id_it->second->getIndexType()) {
+      recordRuntimeLookup(FusionTelemetry::RuntimeLookup::InputCacheHit);
       return id_it->second;
     }
   }
 
+  // Inputs in the same shape bucket share a runtime. See [ Shape Buckets ].
+  std::optional<KernelArgumentHolder> bucketed_args = getBucketedArgs(args);
+  std::string bucket_key;
+  if (bucketed_args.has_value()) {
+    std::stringstream ss;
+    ss << (int)args.getDeviceIndex() << ";";
+    if (forced_index_type.has_value()) {
+      ss << forced_index_type.value();
+    }
+    for (const auto i : c10::irange(bucketed_args->size())) {
+      const auto& arg = *(*bucketed_args)[i];
+      if (arg.is<at::Tensor>()) {
+        const auto& tensor = arg.as<at::Tensor>();
+        ss << ";" << tensor.sizes() << tensor.strides();
+      }
+    }
+    bucket_key = ss.str();
+    auto bucket_it = bucket_to_kernel_runtime_.find(bucket_key);
+    if (bucket_it != bucket_to_kernel_runtime_.end() &&
+        !bucket_it->second->isAsyncCompilePending()) {
+      id_to_kernel_runtime_[unique_id] = bucket_it->second;
+      recordRuntimeLookup(FusionTelemetry::RuntimeLookup::Reuse);
+      return bucket_it->second;
+    }
+  }
+  const KernelArgumentHolder& heuristic_args =
+      bucketed_args.has_value() ? bucketed_args.value() : args;
+
   // Compute or get cached initial concretization info
   const auto& initial_info = initialInfo();
 
   // Compute concretization info to use as cache key
   DynamicTransformConcretizationInfo* conc_info = nullptr;
   if (initial_info.isDynamic()) {
-    // This class needs to own conc_info so it can be compared in subsequent
-    // invocations.
-    auto expr_eval = executor_utils::bindInputs(args, fusion_.get());
-    cached_conc_info_.emplace_back(
-        std::make_unique<DynamicTransformConcretizationInfo>(
-            &initial_info, &expr_eval));
-    conc_info = cached_conc_info_.back().get();
+    // Inputs whose root dynamic values were seen before, e.g., with different
+    // strides or other extents, are concretized the same way
+    std::optional<std::string> root_vals_key =
+        getRootDynamicValsKey(initial_info, args);
+    if (root_vals_key.has_value()) {
+      auto it = conc_info_by_root_vals_.find(root_vals_key.value());
+      if (it != conc_info_by_root_vals_.end()) {
+        conc_info = it->second;
+      }
+    }
+    if (conc_info == nullptr) {
+      // This class needs to own conc_info so it can be compared in subsequent
+      // invocations.
+      auto expr_eval = executor_utils::bindInputs(args, fusion_.get());
+      auto new_conc_info = std::make_unique<DynamicTransformConcretizationInfo>(
+          &initial_info, &expr_eval);
+      // Keep a single copy of each concretization
+      auto same_it = std::find_if(
+          cached_conc_info_.begin(),
+          cached_conc_info_.end(),
+          [&new_conc_info](const auto& cached) {
+            return *cached == *new_conc_info;
+          });
+      if (same_it != cached_conc_info_.end()) {
+        conc_info = same_it->get();
+      } else {
+        cached_conc_info_.push_back(std::move(new_conc_info));
+        conc_info = cached_conc_info_.back().get();
+      }
+      if (root_vals_key.has_value()) {
+        conc_info_by_root_vals_.emplace(
+            std::move(root_vals_key.value()), conc_info);
+      }
+    }
   }
 
   // Initialize or fetch vector of FusionKernelRuntime objects associated with
@@ -705,18 +1857,33 @@ FusionKernelRuntime* FusionExecutorCache::getKernelRuntimeFor(
   // that whenever we encounter a new set of input shapes we segment and compile
   // a new FusionKernelRuntime.
   if (!isOptionDisabled(DisableOption::KernelReuse)) {
-    auto reuse_it = std::find_if(
-        kernel_runtimes.begin(),
-        kernel_runtimes.end(),
-        [&args, &new_heuristics, &forced_index_type](auto& kernel_runtime) {
-          auto maybe_heuristics =
-              kernel_runtime->getMaybeHeuristicsFor(args, forced_index_type);
-          if (!maybe_heuristics.has_value()) {
-            return false;
-          }
-          new_heuristics = std::move(maybe_heuristics.value());
-          return true;
-        });
+    auto find_reusable = [&](bool tolerate_alignment) {
+      return std::find_if(
+          kernel_runtimes.begin(),
+          kernel_runtimes.end(),
+          [&heuristic_args,
+           &new_heuristics,
+           &forced_index_type,
+           tolerate_alignment](auto& kernel_runtime) {
+            // The heuristics of a runtime can't be updated while it is
+            // being compiled
+            if (kernel_runtime->isAsyncCompilePending()) {
+              return false;
+            }
+            auto maybe_heuristics = kernel_runtime->getMaybeHeuristicsFor(
+                heuristic_args, forced_index_type, tolerate_alignment);
+            if (!maybe_heuristics.has_value()) {
+              return false;
+            }
+            new_heuristics = std::move(maybe_heuristics.value());
+            return true;
+          });
+    };
+    auto reuse_it = find_reusable(false);
+    if (reuse_it == kernel_runtimes.end() &&
+        isOptionEnabled(EnableOption::AlignmentTolerantReuse)) {
+      reuse_it = find_reusable(true);
+    }
     if (reuse_it != kernel_runtimes.end()) {
       kernel_runtime = reuse_it->get();
       kernel_runtime->updateHeuristicsLaunchParams(new_heuristics.get());
@@ -724,6 +1891,10 @@ FusionKernelRuntime* FusionExecutorCache::getKernelRuntimeFor(
     }
   }
 
+  recordRuntimeLookup(
+      reusing ? FusionTelemetry::RuntimeLookup::Reuse
+              : FusionTelemetry::RuntimeLookup::Miss);
+
   if (!reusing) {
     // cache miss, need to re-build an optimized graph for this case
 
@@ -755,7 +1926,7 @@ FusionKernelRuntime* FusionExecutorCache::getKernelRuntimeFor(
     FusionGuard fg(conc_fusion.get());
     kernel_runtimes.emplace_back(std::make_unique<FusionKernelRuntime>(
         std::move(conc_fusion),
-        args,
+        heuristic_args,
         /*serde_buffer=*/nullptr,
         forced_index_type,
         fusion_id_,
@@ -766,9 +1937,13 @@ FusionKernelRuntime* FusionExecutorCache::getKernelRuntimeFor(
     if (profiling_) {
       kernel_runtime->profile(true);
     }
+    kernel_runtime->setCompilePriority(compile_priority_);
   }
 
   id_to_kernel_runtime_[unique_id] = kernel_runtime;
+  if (bucketed_args.has_value()) {
+    bucket_to_kernel_runtime_[bucket_key] = kernel_runtime;
+  }
   return kernel_runtime;
 }
 
@@ -776,6 +1951,9 @@ flatbuffers::Offset<serde::FusionExecutorCache> FusionExecutorCache::serialize(
     flatbuffers::FlatBufferBuilder& builder) const {
   // See definitions in serde/fusion_cache.fbs for tables
   // FusionExecutorCache and KernelRuntimes
+  // Fusions may be journaled while other threads run them. See
+  // [ Concurrent Execution ].
+  std::lock_guard<std::mutex> guard(mutex_);
 
   // For serialization, we require a consistent ordering for the
   // kernel_runtimes_ map.
@@ -959,11 +2137,9 @@ FusionKernelRuntime::FusionKernelRuntime(
       "Fusion must be concretized before constructing FusionKernelRuntime");
 
   // Store metadata copy of arguments for serialization
-  std::transform(
-      args.cbegin(),
-      args.cend(),
-      args_metadata_.getBackInserter(),
-      convertMetadataArg);
+  for (const auto i : c10::irange(args.size())) {
+    args_metadata_.push(convertMetadataArg(*args[i]));
+  }
   args_metadata_.setDeviceIndex(args.getDeviceIndex());
 
   optimization::OptimizationPass<optimization::PreSegmenter>::runPass(
@@ -1013,7 +2189,22 @@ FusionKernelRuntime::FusionKernelRuntime(
     segmented_fusion_->deserialize(serde_buffer->segmented_fusion());
   }
 
-  heuristics_ = segmented_fusion_->makeInitialHeuristics(args, runtime_info);
+  // The outputs kept on the host change the kernels of the groups reading
+  // them, so they are marked before the heuristics are computed
+  prepareHostEvaluatedGroups();
+
+  // See [ Serialized Heuristics ]
+  std::vector<std::shared_ptr<HeuristicParams>> serde_params;
+  if (serde_buffer != nullptr && serde_buffer->heuristics() != nullptr &&
+      serde_buffer->heuristics()->size() ==
+          segmented_fusion_->groups().size()) {
+    serde_params.reserve(serde_buffer->heuristics()->size());
+    for (auto fb_params : *serde_buffer->heuristics()) {
+      serde_params.push_back(serde::deserializeHeuristicParams(fb_params));
+    }
+  }
+  heuristics_ = segmented_fusion_->makeInitialHeuristics(
+      args, runtime_info, serde_params);
 
   executors_ = std::vector<FusionExecutor>(segmented_fusion_->groups().size());
   if (isDebugDumpEnabled(DebugDumpOption::FusionSegments)) {
@@ -1027,7 +2218,16 @@ FusionKernelRuntime::FusionKernelRuntime(
 
   // Pre-compute the executor order so that the run time path
   //  would go directly to kernel launch.
-  prepareRuntimeOrder();
+  prepareRuntimeOrder(runtime_info.expressionEvaluator());
+  validateInplaceUpdates();
+  prepareRuntimeStreams();
+  prepareL2Reuse();
+  prepareAtenFallbackGroups();
+
+  if (isOptionEnabled(EnableOption::InterpretedPointwise)) {
+    interpreter_ =
+        PointwiseInterpreter::tryCreate(segmented_fusion_->completeFusion());
+  }
 }
 
 flatbuffers::Offset<serde::FusionKernelRuntime> FusionKernelRuntime::serialize(
@@ -1046,6 +2246,29 @@ flatbuffers::Offset<serde::FusionKernelRuntime> FusionKernelRuntime::serialize(
     segmented_fusion_fb = segmented_fusion_->serialize(builder);
   }
 
+  // 2. Serialize the parameters of the schedulers, see
+  // [ Serialized Heuristics ]
+  std::vector<flatbuffers::Offset<serde::HeuristicParams>> heuristics_fb;
+  if (heuristics_ != nullptr) {
+    heuristics_fb.reserve(heuristics_->heuristicsList().size());
+    for (const auto& scheduler_entry : heuristics_->heuristicsList()) {
+      heuristics_fb.push_back(
+          serde::serializeHeuristicParams(builder, *scheduler_entry->params()));
+    }
+  }
+
+  // 3. Serialize the paths chosen for the profiled segments, see
+  // [ Profile-Guided ATen Fallback ]
+  std::vector<serde::SegmentPathDecision> segment_paths_fb;
+  {
+    std::lock_guard<std::mutex> guard(aten_fallback_mutex_);
+    for (const auto& [cache_id, decisions] : aten_fallback_decisions_) {
+      for (const auto& [group_id, use_aten] : decisions) {
+        segment_paths_fb.emplace_back(cache_id, group_id, use_aten);
+      }
+    }
+  }
+
   return serde::CreateFusionKernelRuntimeDirect(
       builder,
       fusion_id_,
@@ -1053,7 +2276,9 @@ flatbuffers::Offset<serde::FusionKernelRuntime> FusionKernelRuntime::serialize(
       runtime_id_,
       args_metadata_.serialize(builder),
       &executors_fb,
-      segmented_fusion_fb);
+      segmented_fusion_fb,
+      &heuristics_fb,
+      &segment_paths_fb);
 }
 
 void FusionKernelRuntime::deserialize(
@@ -1098,6 +2323,16 @@ void FusionKernelRuntime::deserialize(
         runtime_id_,
         group_id);
   }
+
+  // 2. Deserialize the paths chosen for the profiled segments. Caches
+  // written before they were serialized have none.
+  if (buffer->segment_paths() != nullptr) {
+    std::lock_guard<std::mutex> guard(aten_fallback_mutex_);
+    for (auto fb_decision : *buffer->segment_paths()) {
+      auto& decisions = aten_fallback_decisions_[fb_decision->cache_id()];
+      decisions[fb_decision->group_id()] = fb_decision->use_aten();
+    }
+  }
 }
 
 std::vector<at::Tensor> FusionKernelRuntime::runKernelWithInput(
@@ -1132,11 +2367,19 @@ std::vector<at::Tensor> FusionKernelRuntime::runKernelWithInput(
     sprof.inputBytesAccessed(executor.inputBytesProcessed(args));
     sprof.startKernel(args.getDeviceIndex());
   }
+  if (isOptionEnabled(EnableOption::L2Persistence)) {
+    setL2AccessPolicyWindow(args, sg);
+  }
   auto outputs = executor.runFusion(args, launch_params, compile_params);
   if (isProfilerEnabled()) {
     auto& sprof = FusionProfiler::segment(group_id);
     sprof.stopKernel();
     sprof.outputBytesAccessed(executor.outputBytesProcessed(outputs));
+    if (executor.isCompiled()) {
+      const MemoryTrafficEstimate traffic =
+          executor.estimateMemoryTraffic(args);
+      sprof.modeledBytesAccessed(traffic.load_bytes, traffic.store_bytes);
+    }
   }
 
   // Accumulate the kernel time of each segment
@@ -1171,7 +2414,8 @@ std::vector<at::Tensor> FusionKernelRuntime::runKernelWithInput(
   return outputs;
 }
 
-void FusionKernelRuntime::prepareRuntimeOrder() {
+void FusionKernelRuntime::prepareRuntimeOrder(
+    ExpressionEvaluator& expr_eval) {
   // Setup group run order:
   std::unordered_set<Val*> available_input;
 
@@ -1193,11 +2437,63 @@ void FusionKernelRuntime::prepareRuntimeOrder() {
   // Keep track of groups that has run
   std::vector<bool> group_ran(segmented_fusion_->groups().size(), false);
 
+  // See [ Memory-Aware Segment Order ]
+  const bool memory_aware = isOptionEnabled(EnableOption::MemoryAwareRunOrder);
+  Fusion* fusion = segmented_fusion_->completeFusion();
+  // Number of groups that have not run yet reading each intermediate
+  std::unordered_map<Val*, int64_t> pending_reads;
+  if (memory_aware) {
+    for (auto group : segmented_fusion_->groups()) {
+      for (auto input : group->inputs()) {
+        if (isSegmentIntermediate(input)) {
+          pending_reads[input]++;
+        }
+      }
+    }
+  }
+  // Change of the live bytes by running the group
+  auto live_bytes_delta = [&](SegmentedGroup* group) {
+    int64_t delta = 0;
+    for (auto output : group->outputs()) {
+      if (available_input.count(output) == 0) {
+        delta += allocatedBytes(fusion, output, expr_eval);
+      }
+    }
+    for (auto input : group->inputs()) {
+      if (isSegmentIntermediate(input) && pending_reads.at(input) == 1) {
+        delta -= allocatedBytes(fusion, input, expr_eval);
+      }
+    }
+    return delta;
+  };
+
+  auto run_group = [&](size_t group_i) {
+    auto& group = segmented_fusion_->groups()[group_i];
+    runtime_workspace_.group_run_order.push_back(group);
+    const auto& group_outputs = group->outputs();
+
+    // Insert graph segment output to tensor map
+    for (const size_t group_out_i : c10::irange(group_outputs.size())) {
+      available_input.insert(group_outputs[group_out_i]);
+    }
+    if (memory_aware) {
+      for (auto input : group->inputs()) {
+        if (isSegmentIntermediate(input)) {
+          pending_reads.at(input)--;
+        }
+      }
+    }
+    group_ran[group_i] = true;
+  };
+
   while (!std::all_of(
       group_ran.begin(), group_ran.end(), [](bool b) { return b; })) {
     bool one_ran = false;
+    std::optional<size_t> best_group_i;
+    int64_t best_delta = 0;
 
-    // Find the first segment with all inputs available to run
+    // Find the first segment with all inputs available to run, or the one
+    // that increases the live bytes the least
     for (const size_t group_i :
          c10::irange(segmented_fusion_->groups().size())) {
       auto& group = segmented_fusion_->groups()[group_i];
@@ -1210,25 +2506,612 @@ void FusionKernelRuntime::prepareRuntimeOrder() {
           group_inputs.end(),
           [&available_input](Val* val) { return available_input.count(val); });
 
-      if (ready_to_run) {
-        runtime_workspace_.group_run_order.push_back(group);
-        const auto& group_outputs = group->outputs();
-
-        // Insert graph segment output to tensor map
-        for (const size_t group_out_i : c10::irange(group_outputs.size())) {
-          available_input.insert(group_outputs[group_out_i]);
-        }
-        group_ran[group_i] = true;
+      if (!ready_to_run) {
+        continue;
+      }
+      if (!memory_aware) {
+        run_group(group_i);
         one_ran = true;
+        continue;
+      }
+      const int64_t delta = live_bytes_delta(group);
+      if (!best_group_i.has_value() || delta < best_delta) {
+        best_group_i = group_i;
+        best_delta = delta;
       }
     }
+    if (best_group_i.has_value()) {
+      run_group(best_group_i.value());
+      one_ran = true;
+    }
     NVF_ERROR(
         one_ran,
         "Couldn't run all groups, something must have gone wrong in segmentation.");
   }
 }
 
+int64_t FusionKernelRuntime::predictPeakMemory(
+    const KernelArgumentHolder& args) const {
+  FUSER_PERF_SCOPE("FusionKernelRuntime::predictPeakMemory");
+  Fusion* fusion = segmented_fusion_->completeFusion();
+  ExpressionEvaluator expr_eval = executor_utils::bindInputs(args, fusion);
+  const auto& group_run_order = runtime_workspace_.group_run_order;
+
+  // Position of the last group reading each intermediate
+  std::unordered_map<Val*, int64_t> last_reads;
+  for (const auto pos : c10::irange((int64_t)group_run_order.size())) {
+    for (auto input : group_run_order.at(pos)->inputs()) {
+      if (isSegmentIntermediate(input)) {
+        last_reads[input] = pos;
+      }
+    }
+  }
+
+  std::unordered_set<Val*> allocated;
+  int64_t live_bytes = 0;
+  int64_t peak_bytes = 0;
+  for (const auto pos : c10::irange((int64_t)group_run_order.size())) {
+    auto group = group_run_order.at(pos);
+    // The inputs of a group are freed only after it has run
+    for (auto output : group->outputs()) {
+      if (allocated.insert(output).second) {
+        live_bytes += allocatedBytes(fusion, output, expr_eval);
+      }
+    }
+    peak_bytes = std::max(peak_bytes, live_bytes);
+    for (auto input : group->inputs()) {
+      if (isSegmentIntermediate(input) && last_reads.at(input) == pos) {
+        live_bytes -= allocatedBytes(fusion, input, expr_eval);
+      }
+    }
+  }
+  return peak_bytes;
+}
+
+SignatureEvaluation FusionKernelRuntime::evaluateSignature(
+    const KernelArgumentHolder& args) const {
+  FUSER_PERF_SCOPE("FusionKernelRuntime::evaluateSignature");
+  SignatureEvaluation evaluation;
+  evaluation.concrete_id = concrete_id_;
+  evaluation.runtime_id = runtime_id_;
+
+  Fusion* fusion = segmented_fusion_->completeFusion();
+  ExpressionEvaluator expr_eval = executor_utils::bindInputs(args, fusion);
+  for (Val* output : fusion->outputs()) {
+    std::vector<int64_t>& sizes = evaluation.output_sizes.emplace_back();
+    auto tv = dynamic_cast<TensorView*>(output);
+    if (tv == nullptr) {
+      continue;
+    }
+    for (IterDomain* id : TensorDomain::noReductions(tv->getLogicalDomain())) {
+      PolymorphicValue extent =
+          expr_eval.evaluate(id->getMaybeExpandedExtent());
+      NVF_CHECK(
+          extent.hasValue(),
+          "Could not evaluate the extent ",
+          id->getMaybeExpandedExtent()->toInlineString(),
+          " of output ",
+          tv->toString());
+      sizes.push_back(extent.as<int64_t>());
+    }
+  }
+
+  for (const auto& entry : heuristics_->heuristicsList()) {
+    evaluation.heuristics.push_back(entry->heuristic());
+    evaluation.params.push_back(entry->params()->clone());
+  }
+  evaluation.peak_memory = predictPeakMemory(args);
+  return evaluation;
+}
+
+void FusionKernelRuntime::validateInplaceUpdates() {
+  Fusion* fusion = segmented_fusion_->completeFusion();
+  const auto& group_run_order = runtime_workspace_.group_run_order;
+  // Fusion::exprs() computes and returns topological order.
+  std::vector<Expr*> fusion_exprs;
+  std::optional<AliasAnalysisResult> alias_analysis;
+  for (const auto pos : c10::irange(group_run_order.size())) {
+    SegmentedGroup* group = group_run_order.at(pos);
+    for (Val* out : group->outputs()) {
+      auto [in, alias_info] = fusion->getOutputAlias(out);
+      if (alias_info == nullptr ||
+          alias_info->type != AliasType::InplaceUpdate) {
+        continue;
+      }
+      NVF_CHECK(
+          in->isA<TensorView>() && out->isA<TensorView>(),
+          "Only tensors can be updated in place: ",
+          out->toString());
+
+      // The groups after this one would read the updated values
+      for (const auto later_pos :
+           c10::irange(pos + 1, group_run_order.size())) {
+        const auto& later_inputs = group_run_order.at(later_pos)->inputs();
+        NVF_CHECK(
+            std::find(later_inputs.begin(), later_inputs.end(), in) ==
+                later_inputs.end(),
+            "Can't update ",
+            in->toString(),
+            " in place because it's read by a segment after the one computing ",
+            out->toString());
+      }
+
+      // Earlier groups may have returned views of the input, e.g., by a
+      // NoOp segment, which this group would read while overwriting them
+      if (!alias_analysis.has_value()) {
+        alias_analysis = findAliases(
+            fusion, /*can_override_empty_allocation_domain=*/false);
+      }
+      for (auto* group_in :
+           ir_utils::filterByType<TensorView>(group->inputs())) {
+        NVF_CHECK(
+            group_in == in ||
+                alias_analysis->getNearestAliasedIo(group_in) != in,
+            "Can't update ",
+            in->toString(),
+            " in place because ",
+            group_in->toString(),
+            ", which may be a view of it, is read by the segment computing ",
+            out->toString());
+      }
+
+      if (fusion_exprs.empty()) {
+        fusion_exprs = fusion->exprs();
+      }
+      const std::unordered_set<Expr*> group_exprs(
+          group->exprs().begin(), group->exprs().end());
+      std::vector<Expr*> exprs;
+      std::copy_if(
+          fusion_exprs.begin(),
+          fusion_exprs.end(),
+          std::back_inserter(exprs),
+          [&](Expr* expr) { return group_exprs.count(expr) > 0; });
+      validateInplaceUpdate(
+          out->as<TensorView>(), in->as<TensorView>(), exprs);
+    }
+  }
+}
+
+void FusionKernelRuntime::prepareRuntimeStreams() {
+  const auto& group_run_order = runtime_workspace_.group_run_order;
+  const auto num_groups = (int64_t)group_run_order.size();
+  Fusion* fusion = segmented_fusion_->completeFusion();
+
+  // Position of the group producing each segment output, and of the groups
+  // reading each fusion input
+  std::unordered_map<Val*, int64_t> producer_pos;
+  std::unordered_map<Val*, std::vector<int64_t>> reader_pos;
+  auto& dependencies = runtime_workspace_.group_run_dependencies;
+  dependencies.assign(num_groups, {});
+  auto add_dependency = [&](int64_t pos, int64_t dep) {
+    if (std::find(
+            dependencies.at(pos).begin(), dependencies.at(pos).end(), dep) ==
+        dependencies.at(pos).end()) {
+      dependencies.at(pos).push_back(dep);
+    }
+  };
+  for (const auto pos : c10::irange(num_groups)) {
+    for (auto input : group_run_order.at(pos)->inputs()) {
+      auto it = producer_pos.find(input);
+      if (it != producer_pos.end()) {
+        add_dependency(pos, it->second);
+      }
+      if (input->isFusionInput()) {
+        reader_pos[input].push_back(pos);
+      }
+    }
+    for (auto output : group_run_order.at(pos)->outputs()) {
+      producer_pos.emplace(output, pos);
+      // A group updating a fusion input in place has to wait for the
+      // groups reading the old values. See validateInplaceUpdates.
+      auto [in, alias_info] = fusion->getOutputAlias(output);
+      if (alias_info != nullptr &&
+          alias_info->type == AliasType::InplaceUpdate) {
+        for (auto dep : reader_pos[in]) {
+          if (dep != pos) {
+            add_dependency(pos, dep);
+          }
+        }
+      }
+    }
+  }
+
+  // Continue on the stream of a producer if nothing else has been put on
+  // that stream after it, otherwise go round robin over the streams
+  auto& streams = runtime_workspace_.group_run_streams;
+  streams.assign(num_groups, 0);
+  std::vector<int64_t> last_on_stream(kMaxSegmentStreams, -1);
+  int64_t next_stream = 0;
+  int64_t num_streams = 1;
+  for (const auto pos : c10::irange(num_groups)) {
+    int64_t stream = -1;
+    for (auto dep : dependencies.at(pos)) {
+      if (last_on_stream.at(streams.at(dep)) == dep) {
+        stream = streams.at(dep);
+        break;
+      }
+    }
+    if (stream == -1) {
+      stream = next_stream;
+      next_stream = (next_stream + 1) % kMaxSegmentStreams;
+    }
+    streams.at(pos) = stream;
+    last_on_stream.at(stream) = pos;
+    num_streams = std::max(num_streams, stream + 1);
+  }
+  runtime_workspace_.num_streams = num_streams;
+
+  // Fusion outputs are used on stream 0 by the caller after the run
+  auto& consumer_streams = runtime_workspace_.group_run_consumer_streams;
+  consumer_streams.assign(num_groups, {});
+  auto add_consumer_stream = [&](int64_t pos, int64_t stream) {
+    auto& pos_streams = consumer_streams.at(pos);
+    if (stream != streams.at(pos) &&
+        std::find(pos_streams.begin(), pos_streams.end(), stream) ==
+            pos_streams.end()) {
+      pos_streams.push_back(stream);
+    }
+  };
+  for (const auto pos : c10::irange(num_groups)) {
+    for (auto dep : dependencies.at(pos)) {
+      add_consumer_stream(dep, streams.at(pos));
+    }
+    const auto& outputs = group_run_order.at(pos)->outputs();
+    if (std::any_of(outputs.begin(), outputs.end(), [](Val* output) {
+          return output->isFusionOutput();
+        })) {
+      add_consumer_stream(pos, 0);
+    }
+  }
+}
+
+bool FusionKernelRuntime::useSegmentStreams() const {
+  if (!isOptionEnabled(EnableOption::MultiStreamSegments) ||
+      runtime_workspace_.num_streams < 2) {
+    return false;
+  }
+
+  // Timing each kernel with events on the current stream doesn't work when
+  // kernels overlap
+  return !(
+      profiling_ || measure_kernel_time_ || isProfilerEnabled() ||
+      isOptionEnabled(EnableOption::KernelProfile) ||
+      isDebugDumpEnabled(DebugDumpOption::PerfDebugVerbose) ||
+      isDebugDumpEnabled(DebugDumpOption::EffectiveBandwidth));
+}
+
 // passing args by value because we will be modify this
+void FusionKernelRuntime::prepareL2Reuse() {
+  const auto num_groups = segmented_fusion_->groups().size();
+  l2_reused_inputs_.resize(num_groups);
+  l2_shared_inputs_.resize(num_groups);
+
+  std::unordered_map<Val*, int64_t> num_readers;
+  for (auto group : runtime_workspace_.group_run_order) {
+    for (auto input : group->inputs()) {
+      if (input->isA<TensorView>()) {
+        num_readers[input]++;
+      }
+    }
+  }
+
+  // Readers of each tensor that have not been visited yet
+  auto num_remaining_readers = num_readers;
+  for (auto group : runtime_workspace_.group_run_order) {
+    const auto& inputs = group->inputs();
+    for (const auto i : c10::irange((int64_t)inputs.size())) {
+      auto it = num_remaining_readers.find(inputs.at(i));
+      if (it == num_remaining_readers.end()) {
+        continue;
+      }
+      if (num_readers.at(inputs.at(i)) > 1) {
+        l2_shared_inputs_.at(group->groupId()).push_back(i);
+      }
+      if (--it->second > 0) {
+        l2_reused_inputs_.at(group->groupId()).push_back(i);
+      }
+    }
+  }
+}
+
+void FusionKernelRuntime::setL2AccessPolicyWindow(
+    const KernelArgumentHolder& args,
+    SegmentedGroup* sg) {
+  const auto& shared_inputs = l2_shared_inputs_.at(sg->groupId());
+  const auto properties = at::cuda::getDeviceProperties(args.getDeviceIndex());
+  if (shared_inputs.empty() || properties->persistingL2CacheMaxSize == 0) {
+    return;
+  }
+
+  const at::Tensor* window_tensor = nullptr;
+  for (auto i : shared_inputs) {
+    const auto& tensor = args[i]->as<at::Tensor>();
+    if (window_tensor == nullptr || tensor.nbytes() > window_tensor->nbytes()) {
+      window_tensor = &tensor;
+    }
+  }
+  if (window_tensor->nbytes() == 0) {
+    return;
+  }
+
+  size_t set_aside = 0;
+  NVFUSER_CUDA_RT_SAFE_CALL(
+      cudaDeviceGetLimit(&set_aside, cudaLimitPersistingL2CacheSize));
+  if (set_aside == 0) {
+    set_aside = properties->persistingL2CacheMaxSize;
+    NVFUSER_CUDA_RT_SAFE_CALL(
+        cudaDeviceSetLimit(cudaLimitPersistingL2CacheSize, set_aside));
+  }
+
+  const size_t num_bytes = std::min(
+      window_tensor->nbytes(), (size_t)properties->accessPolicyMaxWindowSize);
+  cudaStreamAttrValue attr = {};
+  attr.accessPolicyWindow.base_ptr = window_tensor->data_ptr();
+  attr.accessPolicyWindow.num_bytes = num_bytes;
+  // Only as much of the window as fits into the set-aside persists, so that
+  // the lines that persist don't evict each other
+  attr.accessPolicyWindow.hitRatio =
+      std::min(1.0f, (float)set_aside / (float)num_bytes);
+  attr.accessPolicyWindow.hitProp = cudaAccessPropertyPersisting;
+  attr.accessPolicyWindow.missProp = cudaAccessPropertyStreaming;
+
+  cudaStream_t stream = at::cuda::getCurrentCUDAStream();
+  NVFUSER_CUDA_RT_SAFE_CALL(cudaStreamSetAttribute(
+      stream, cudaStreamAttributeAccessPolicyWindow, &attr));
+  l2_window_streams_.insert(stream);
+}
+
+void FusionKernelRuntime::clearL2AccessPolicyWindows() {
+  // A window of zero bytes removes the window. The lines that persist are
+  // left to be replaced by later persisting accesses, as resetting them
+  // isn't ordered with the kernels still running.
+  cudaStreamAttrValue attr = {};
+  for (auto stream : l2_window_streams_) {
+    NVFUSER_CUDA_RT_SAFE_CALL(cudaStreamSetAttribute(
+        stream, cudaStreamAttributeAccessPolicyWindow, &attr));
+  }
+  l2_window_streams_.clear();
+}
+
+void FusionKernelRuntime::prepareHostEvaluatedGroups() {
+  const auto& groups = segmented_fusion_->groups();
+  host_fusions_.clear();
+  host_fusions_.resize(groups.size());
+  if (!isOptionEnabled(EnableOption::HostEvaluatedSegments)) {
+    return;
+  }
+
+  int64_t max_elements = kMaxHostEvaluatedElements;
+  const auto& option_args =
+      getEnableOptionArguments(EnableOption::HostEvaluatedSegments);
+  if (!option_args.empty()) {
+    try {
+      max_elements = std::stoll(option_args.at(0));
+    } catch (const std::exception& e) {
+      debug() << "skip invalid argument for HostEvaluatedSegments, arg = "
+              << option_args.at(0) << std::endl;
+    }
+  }
+
+  auto complete_fusion = segmented_fusion_->completeFusion();
+
+  // Tensors on the host when a group is run, i.e., the CPU scalar fusion
+  // inputs and the outputs kept by the groups picked so far
+  std::unordered_set<Val*> host_tvs;
+  for (auto tv :
+       ir_utils::filterByType<TensorView>(segmented_fusion_->inputs())) {
+    if (tv->isCpuScalar()) {
+      host_tvs.insert(tv);
+    }
+  }
+
+  auto can_evaluate_on_host = [&](SegmentedGroup* group) {
+    if (group->heuristic() == ScheduleHeuristic::NoOp) {
+      return false;
+    }
+    if (std::any_of(
+            group->inputs().begin(), group->inputs().end(), [&](Val* input) {
+              return input->isA<TensorView>() && host_tvs.count(input) == 0;
+            })) {
+      return false;
+    }
+    if (!std::all_of(
+            group->exprs().begin(), group->exprs().end(), isHostEvaluable)) {
+      return false;
+    }
+    for (auto output : group->outputs()) {
+      auto tv = dynamic_cast<TensorView*>(output);
+      if (tv == nullptr || tv->dtype() == DataType::Index ||
+          complete_fusion->getOutputAlias(tv).first != nullptr) {
+        return false;
+      }
+      int64_t num_elements = 1;
+      for (auto id : TensorDomain::noReductions(tv->getMaybeRFactorDomain())) {
+        if (!id->extent()->isConstInt()) {
+          return false;
+        }
+        num_elements *= id->extent()->evaluate().as<int64_t>();
+      }
+      if (num_elements > max_elements) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  // A group can read the outputs kept by another group, so groups are
+  // picked until no more of them can be evaluated on the host
+  std::vector<SegmentedGroup*> host_groups;
+  std::unordered_set<SegmentedGroup*> picked;
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (auto group : groups) {
+      if (picked.count(group) || !can_evaluate_on_host(group)) {
+        continue;
+      }
+      picked.insert(group);
+      host_groups.push_back(group);
+      changed = true;
+      for (auto tv : ir_utils::filterByType<TensorView>(group->outputs())) {
+        if (tv->nDims() == 0 && !tv->isFusionOutput()) {
+          tv->setCpuScalar(true);
+          host_tvs.insert(tv);
+        }
+      }
+    }
+  }
+
+  for (auto group : host_groups) {
+    host_fusions_.at(group->groupId()) = segmented_fusion_->makeFusion(group);
+  }
+}
+
+std::vector<at::Tensor> FusionKernelRuntime::evaluateGroupOnHost(
+    const KernelArgumentHolder& args,
+    SegmentedGroup* sg,
+    const std::vector<at::Tensor>& output_buffers) {
+  FUSER_PERF_SCOPE("FusionKernelRuntime::evaluateGroupOnHost");
+  Fusion* fusion = host_fusions_.at(sg->groupId()).get();
+  NVF_ERROR(
+      fusion != nullptr,
+      "Group ",
+      sg->groupId(),
+      " is not evaluated on the host");
+
+  ExpressionEvaluator expr_eval = executor_utils::bindInputs(args, fusion);
+  const c10::Device device(c10::DeviceType::CUDA, args.getDeviceIndex());
+  const auto& group_outputs = sg->outputs();
+  std::vector<at::Tensor> outputs;
+  outputs.reserve(group_outputs.size());
+  for (const auto out_i : c10::irange(group_outputs.size())) {
+    auto tv = fusion->outputs().at(out_i)->as<TensorView>();
+    // ATen may promote the results to wider types than the fusion
+    at::Tensor output = expr_eval.evaluate(tv).as<at::Tensor>().to(
+        group_outputs.at(out_i)->as<TensorView>()->isCpuScalar()
+            ? c10::Device(c10::DeviceType::CPU)
+            : device,
+        data_type_to_aten(tv->dtype()));
+    if (out_i < output_buffers.size() && output_buffers.at(out_i).defined()) {
+      output_buffers.at(out_i).copy_(output);
+      output = output_buffers.at(out_i);
+    }
+    outputs.push_back(std::move(output));
+  }
+  return outputs;
+}
+
+void FusionKernelRuntime::prepareAtenFallbackGroups() {
+  const auto& groups = segmented_fusion_->groups();
+  aten_fusions_.clear();
+  aten_fusions_.resize(groups.size());
+  if (!isOptionEnabled(EnableOption::ProfileGuidedFallback)) {
+    return;
+  }
+
+  auto complete_fusion = segmented_fusion_->completeFusion();
+  for (auto group : groups) {
+    if (!isEvaluatedOnHost(group) && canRunWithAten(complete_fusion, group)) {
+      aten_fusions_.at(group->groupId()) = segmented_fusion_->makeFusion(group);
+    }
+  }
+}
+
+std::optional<bool> FusionKernelRuntime::isRunWithAten(
+    size_t cache_id,
+    SegmentedGroup* sg) const {
+  std::lock_guard<std::mutex> guard(aten_fallback_mutex_);
+  auto cache_it = aten_fallback_decisions_.find(cache_id);
+  if (cache_it == aten_fallback_decisions_.end()) {
+    return std::nullopt;
+  }
+  auto group_it = cache_it->second.find(sg->groupId());
+  if (group_it == cache_it->second.end()) {
+    return std::nullopt;
+  }
+  return group_it->second;
+}
+
+std::vector<at::Tensor> FusionKernelRuntime::evaluateGroupWithAten(
+    const KernelArgumentHolder& args,
+    SegmentedGroup* sg,
+    const std::vector<at::Tensor>& output_buffers) {
+  FUSER_PERF_SCOPE("FusionKernelRuntime::evaluateGroupWithAten");
+  Fusion* fusion = aten_fusions_.at(sg->groupId()).get();
+  NVF_ERROR(
+      fusion != nullptr, "Group ", sg->groupId(), " can't run with ATen");
+
+  ExpressionEvaluator expr_eval = executor_utils::bindInputs(args, fusion);
+  std::vector<at::Tensor> outputs;
+  outputs.reserve(fusion->outputs().size());
+  for (const auto out_i : c10::irange(fusion->outputs().size())) {
+    auto tv = fusion->outputs().at(out_i)->as<TensorView>();
+    // Kernels write contiguous outputs of the types of the fusion, which
+    // the kernels of the consumers may have been compiled for
+    at::Tensor output = expr_eval.evaluate(tv)
+                            .as<at::Tensor>()
+                            .to(data_type_to_aten(tv->dtype()))
+                            .contiguous();
+    if (out_i < output_buffers.size() && output_buffers.at(out_i).defined()) {
+      output_buffers.at(out_i).copy_(output);
+      output = output_buffers.at(out_i);
+    }
+    outputs.push_back(std::move(output));
+  }
+  return outputs;
+}
+
+std::vector<at::Tensor> FusionKernelRuntime::runGroupWithFallback(
+    KernelArgumentHolder& args,
+    SegmentedGroup* sg,
+    size_t cache_id,
+    std::vector<at::Tensor> output_buffers) {
+  const std::optional<bool> use_aten = isRunWithAten(cache_id, sg);
+  if (use_aten.has_value() && use_aten.value()) {
+    return evaluateGroupWithAten(args, sg, output_buffers);
+  }
+  if (!output_buffers.empty()) {
+    executors_.at(sg->groupId()).setOutputBuffers(std::move(output_buffers));
+  }
+  std::vector<at::Tensor> outputs = runKernelWithInput(args, sg);
+  if (use_aten.has_value()) {
+    return outputs;
+  }
+
+  // The untimed runs leave out loading the module of the kernel and
+  // initializing the libraries ATen calls
+  FUSER_PERF_SCOPE("FusionKernelRuntime::profileAtenFallback");
+  executor_utils::CudaKernelTimer timer(at::cuda::getCurrentCUDAStream());
+  timer.init();
+  timer.start();
+  runKernelWithInput(args, sg);
+  const float kernel_ms = timer.elapsed();
+
+  bool aten_is_faster = false;
+  try {
+    evaluateGroupWithAten(args, sg);
+    timer.start();
+    evaluateGroupWithAten(args, sg);
+    const float aten_ms = timer.elapsed();
+    aten_is_faster = aten_ms < kAtenFallbackMargin * kernel_ms;
+    if (isDebugDumpEnabled(DebugDumpOption::PerfDebugVerbose)) {
+      debug() << "Segment " << sg->groupId() << " took " << kernel_ms
+              << " ms with its kernel and " << aten_ms << " ms with ATen"
+              << std::endl;
+    }
+  } catch (const std::exception& e) {
+    // Some expression has no ATen implementation
+    if (isDebugDumpEnabled(DebugDumpOption::PerfDebugVerbose)) {
+      debug() << "Failed to evaluate segment " << sg->groupId()
+              << " with ATen: " << e.what() << std::endl;
+    }
+  }
+
+  std::lock_guard<std::mutex> guard(aten_fallback_mutex_);
+  aten_fallback_decisions_[cache_id][sg->groupId()] = aten_is_faster;
+  return outputs;
+}
+
 void FusionKernelRuntime::compileFusionParallel(KernelArgumentHolder args) {
   std::lock_guard<std::mutex> guard(mutex_);
 
@@ -1266,35 +3149,49 @@ void FusionKernelRuntime::compileFusionParallel(KernelArgumentHolder args) {
       group_runtime_inputs.push(*args_manager.checkTensorMap(input));
     }
 
-    if (num_groups == 1 || isOptionDisabled(DisableOption::ParallelCompile)) {
+    // Waiting for the thread pool from one of its own threads would never
+    // return, so compile serially when run by compileFusionAsync
+    if (num_groups == 1 || isOptionDisabled(DisableOption::ParallelCompile) ||
+        getThreadPool()->inThreadPool()) {
       FUSER_PERF_SCOPE("FusionKernelRuntime::compileFusionParallel");
       c10::cuda::CUDAGuard dg(args.getDeviceIndex());
       c10::Device device(c10::DeviceType::CUDA, args.getDeviceIndex());
       compileKernel(group_runtime_inputs, group_to_run);
     } else {
       // launch compileKernel thread here
-      getThreadPool()->run([this,
-                            args,
-                            group_runtime_inputs,
-                            group_to_run,
-                            &detect_exception_in_thread_pool]() {
-        FUSER_PERF_SCOPE("FusionKernelRuntime::compileFusionParallel");
-        try {
-          c10::cuda::CUDAGuard dg(args.getDeviceIndex());
-          c10::Device device(c10::DeviceType::CUDA, args.getDeviceIndex());
-          compileKernel(group_runtime_inputs, group_to_run);
-        } catch (const std::exception& e) {
-          // Set flag inside lambda so we can throw an exception after thread
-          // pool completes its work.
-          detect_exception_in_thread_pool.store(true);
-        }
-      });
+      getThreadPool()->run(
+          [this,
+           args,
+           group_runtime_inputs,
+           group_to_run,
+           &detect_exception_in_thread_pool]() {
+            FUSER_PERF_SCOPE("FusionKernelRuntime::compileFusionParallel");
+            try {
+              c10::cuda::CUDAGuard dg(args.getDeviceIndex());
+              c10::Device device(
+                  c10::DeviceType::CUDA, args.getDeviceIndex());
+              compileKernel(group_runtime_inputs, group_to_run);
+            } catch (const std::exception& e) {
+              // Set flag inside lambda so we can throw an exception after
+              // thread pool completes its work.
+              detect_exception_in_thread_pool.store(true);
+            }
+          },
+          compile_priority_);
     }
 
-    auto fusion_to_run = segmented_fusion_->makeFusion(group_to_run);
-    auto group_runtime_outputs =
-        executors_[group_to_run->groupId()].inferOutputSizes(
-            fusion_to_run.get(), group_runtime_inputs);
+    // The kernels of the groups reading the outputs a group keeps on the
+    // host are compiled for their values. See [ Host-Evaluated Segments ].
+    std::vector<at::Tensor> group_runtime_outputs;
+    if (isEvaluatedOnHost(group_to_run)) {
+      group_runtime_outputs =
+          evaluateGroupOnHost(group_runtime_inputs, group_to_run);
+    } else {
+      auto fusion_to_run = segmented_fusion_->makeFusion(group_to_run);
+      group_runtime_outputs =
+          executors_[group_to_run->groupId()].inferOutputSizes(
+              fusion_to_run.get(), group_runtime_inputs);
+    }
 
     // map output args to tensor map
     args_manager.updateWithSegmentOutputs(
@@ -1302,7 +3199,8 @@ void FusionKernelRuntime::compileFusionParallel(KernelArgumentHolder args) {
     num_live_args_after_segment_runs_.push_back((int64_t)args.size());
   }
 
-  if (num_groups != 1 && !isOptionDisabled(DisableOption::ParallelCompile)) {
+  if (num_groups != 1 && !isOptionDisabled(DisableOption::ParallelCompile) &&
+      !getThreadPool()->inThreadPool()) {
     // Wait until all segments finish compiling
     getThreadPool()->waitWorkComplete();
     NVF_ERROR(
@@ -1315,6 +3213,109 @@ void FusionKernelRuntime::compileFusionParallel(KernelArgumentHolder args) {
   }
 }
 
+void FusionKernelRuntime::compileFusionAsync(KernelArgumentHolder args) {
+  std::call_once(async_compile_once_, [this, &args]() {
+    FUSER_PERF_SCOPE("FusionKernelRuntime::compileFusionAsync");
+    auto done = std::make_shared<std::promise<void>>();
+    async_compile_done_ = done->get_future().share();
+    async_compile_pending_.store(true, std::memory_order_release);
+    async_compile_queued_.store(true, std::memory_order_release);
+    getThreadPool()->run(
+        [this, args = std::move(args), done]() {
+          std::exception_ptr error;
+          try {
+            compileFusionParallel(args);
+          } catch (...) {
+            error = std::current_exception();
+          }
+          // The runtime may be destroyed as soon as the future is ready, so
+          // this must be the last access to it
+          async_compile_pending_.store(false, std::memory_order_release);
+          if (error) {
+            done->set_exception(error);
+          } else {
+            done->set_value();
+          }
+        },
+        compile_priority_);
+  });
+}
+
+void FusionKernelRuntime::waitForAsyncCompile() {
+  FUSER_PERF_SCOPE("FusionKernelRuntime::waitForAsyncCompile");
+  NVF_ERROR(
+      async_compile_done_.valid(),
+      "Compilation has not been queued with compileFusionAsync");
+  async_compile_done_.get();
+}
+
+FusionKernelRuntime::~FusionKernelRuntime() {
+  if (async_compile_done_.valid()) {
+    async_compile_done_.wait();
+  }
+}
+
+bool FusionKernelRuntime::canRunWithExpressionEvaluator() const {
+  if (expr_eval_failed_.load()) {
+    return false;
+  }
+
+  auto complete_fusion = segmented_fusion_->completeFusion();
+
+  // Random numbers would differ from the ones generated by the kernels
+  if (complete_fusion->isStochastic()) {
+    return false;
+  }
+
+  // ExpressionEvaluator creates new tensors rather than writing to aliased
+  // inputs, and doesn't follow allocation domains
+  return std::all_of(
+      complete_fusion->outputs().begin(),
+      complete_fusion->outputs().end(),
+      [complete_fusion](Val* output) {
+        auto tv = dynamic_cast<TensorView*>(output);
+        return tv != nullptr && !tv->hasAllocation() &&
+            complete_fusion->getOutputAlias(output).first == nullptr;
+      });
+}
+
+std::optional<std::vector<at::Tensor>> FusionKernelRuntime::
+    runWithExpressionEvaluator(const KernelArgumentHolder& args) {
+  FUSER_PERF_SCOPE("FusionKernelRuntime::runWithExpressionEvaluator");
+  if (!canRunWithExpressionEvaluator()) {
+    return std::nullopt;
+  }
+
+  auto complete_fusion = segmented_fusion_->completeFusion();
+  c10::cuda::CUDAGuard dg(args.getDeviceIndex());
+  try {
+    ExpressionEvaluator expr_eval =
+        executor_utils::bindInputs(args, complete_fusion);
+    std::vector<at::Tensor> outputs;
+    outputs.reserve(complete_fusion->outputs().size());
+    for (Val* output : complete_fusion->outputs()) {
+      outputs.push_back(expr_eval.evaluate(output).as<at::Tensor>());
+    }
+    return outputs;
+  } catch (const std::exception& e) {
+    // Some expression has no ATen implementation. Don't try again.
+    if (isDebugDumpEnabled(DebugDumpOption::PerfDebugVerbose)) {
+      debug() << "Failed to evaluate fusion with ExpressionEvaluator: "
+              << e.what() << std::endl;
+    }
+    expr_eval_failed_.store(true);
+    return std::nullopt;
+  }
+}
+
+std::optional<std::vector<at::Tensor>> FusionKernelRuntime::
+    runWithInterpreter(const KernelArgumentHolder& args) const {
+  if (interpreter_ == nullptr) {
+    return std::nullopt;
+  }
+  return interpreter_->run(args);
+}
+
 void FusionKernelRuntime::compileKernel(
     const KernelArgumentHolder& args,
     SegmentedGroup* sg) {
@@ -1337,6 +3338,10 @@ void FusionKernelRuntime::compileKernel(
   }
   FusionGuard fg(fusion_to_run.get());
   scheduler_entry->schedule(fusion_to_run.get());
+  if (isOptionEnabled(EnableOption::L2Persistence)) {
+    refineCachePolicyForReuse(
+        fusion_to_run.get(), l2_reused_inputs_.at(group_id));
+  }
   NVF_ERROR(
       scheduler_entry->params()->cparams.index_type.has_value(),
       "Kernel index type is not defined.");
@@ -1371,22 +3376,33 @@ std::pair<LaunchParams, CompileParams> FusionKernelRuntime::getKernelConfig(
 }
 
 std::vector<at::Tensor> FusionKernelRuntime::runWithInputs(
-    KernelArgumentHolder& args) {
+    KernelArgumentHolder& args,
+    const std::vector<at::Tensor>& output_buffers) {
   FUSER_PERF_SCOPE("FusionKernelRuntime::runWithInputs");
 
+  // The graphs write to the outputs they were captured with
+  if (output_buffers.empty() && isCudaGraphCompatible(args)) {
+    return runWithCudaGraph(args);
+  }
+
   if (isDebugDumpEnabled(DebugDumpOption::PerfDebugVerbose)) {
     debug() << "=================RUNNING FUSION SEGMENTS================="
             << std::endl;
   }
 
   c10::Device device(c10::DeviceType::CUDA, (int8_t)args.getDeviceIndex());
-  const auto& tensor_map = runSegmentsWithInputs(args);
+  const auto& tensor_map = runSegmentsWithInputs(args, output_buffers);
 
   if (isDebugDumpEnabled(DebugDumpOption::PerfDebugVerbose)) {
     debug() << "============= FINISHED RUNNING FUSION SEGMENTS ============"
             << std::endl;
   }
 
+  return getFusionOutputs(tensor_map);
+}
+
+std::vector<at::Tensor> FusionKernelRuntime::getFusionOutputs(
+    const std::unordered_map<Val*, const PolymorphicValue*>& tensor_map) {
   // Produce final global output
   std::vector<at::Tensor> fusion_outputs;
   fusion_outputs.reserve(segmented_fusion_->outputs().size());
@@ -1402,8 +3418,106 @@ std::vector<at::Tensor> FusionKernelRuntime::runWithInputs(
   return fusion_outputs;
 }
 
+bool FusionKernelRuntime::isCudaGraphCompatible(
+    const KernelArgumentHolder& args) const {
+  if (!isOptionEnabled(EnableOption::CudaGraph) ||
+      !args.getCacheId().has_value()) {
+    return false;
+  }
+
+  // Profiling and timing need to observe each launch individually
+  if (profiling_ || measure_kernel_time_ || isProfilerEnabled() ||
+      isOptionEnabled(EnableOption::KernelProfile) ||
+      isDebugDumpEnabled(DebugDumpOption::PerfDebugVerbose) ||
+      isDebugDumpEnabled(DebugDumpOption::EffectiveBandwidth)) {
+    return false;
+  }
+
+  // Access policy windows are set on the streams between launches
+  if (isOptionEnabled(EnableOption::L2Persistence)) {
+    return false;
+  }
+
+  // Segments may run without their kernels, and the profiling runs of a
+  // segment launch its kernel twice. See [ Profile-Guided ATen Fallback ].
+  if (isOptionEnabled(EnableOption::ProfileGuidedFallback)) {
+    return false;
+  }
+
+  // The cache id only encodes the metadata of tensor inputs, so scalar
+  // inputs, whose values are baked into the kernel arguments of the graph,
+  // could change without changing the cache id
+  for (const auto i : c10::irange(args.size())) {
+    if (!args[i]->is<at::Tensor>() || !args[i]->as<at::Tensor>().is_cuda()) {
+      return false;
+    }
+  }
+
+  auto complete_fusion = segmented_fusion_->completeFusion();
+
+  // Outputs are newly allocated on each replay, so they must not alias
+  // inputs
+  return std::none_of(
+      complete_fusion->outputs().begin(),
+      complete_fusion->outputs().end(),
+      [complete_fusion](Val* output) {
+        return output->isFusionInput() ||
+            complete_fusion->getOutputAlias(output).first != nullptr;
+      });
+}
+
+std::vector<at::Tensor> FusionKernelRuntime::runWithCudaGraph(
+    KernelArgumentHolder& args) {
+  FUSER_PERF_SCOPE("FusionKernelRuntime::runWithCudaGraph");
+  const auto cache_id = args.getCacheId().value();
+
+  auto graph_it = cuda_graphs_.find(cache_id);
+  if (graph_it != cuda_graphs_.end()) {
+    FusionCudaGraph* graph = graph_it->second.get();
+    if (graph != nullptr &&
+        graph->stream() == at::cuda::getCurrentCUDAStream().stream()) {
+      return graph->replay(args);
+    }
+    return getFusionOutputs(runSegmentsWithInputs(args));
+  }
+
+  // First run with this cache id. Run the segments as usual while recording
+  // each kernel launch, then build a graph from the recorded launches.
+  // runSegmentsWithInputs appends to args, so keep a copy of the fusion
+  // inputs.
+  KernelArgumentHolder fusion_inputs = args;
+  for (auto& executor : executors_) {
+    executor.setRecordLaunchFlag(true);
+  }
+  auto outputs = getFusionOutputs(runSegmentsWithInputs(args));
+
+  std::vector<FusionExecutor::LaunchRecord> launches;
+  launches.reserve(runtime_workspace_.group_run_order.size());
+  bool all_launches_recorded = true;
+  for (auto group : runtime_workspace_.group_run_order) {
+    auto& executor = executors_.at(group->groupId());
+    auto record = executor.takeLastLaunchRecord();
+    if (record.has_value()) {
+      launches.push_back(std::move(record.value()));
+    } else {
+      all_launches_recorded = false;
+    }
+  }
+  for (auto& executor : executors_) {
+    executor.setRecordLaunchFlag(false);
+  }
+
+  cuda_graphs_[cache_id] = all_launches_recorded
+      ? FusionCudaGraph::create(std::move(launches), fusion_inputs, outputs)
+      : nullptr;
+
+  return outputs;
+}
+
 std::unordered_map<Val*, const PolymorphicValue*> FusionKernelRuntime::
-    runSegmentsWithInputs(KernelArgumentHolder& args) {
+    runSegmentsWithInputs(
+        KernelArgumentHolder& args,
+        const std::vector<at::Tensor>& output_buffers) {
   NVF_ERROR(
       args.size() == segmented_fusion_->inputs().size(),
       "Inputs were not set up correctly, received ",
@@ -1422,6 +3536,53 @@ std::unordered_map<Val*, const PolymorphicValue*> FusionKernelRuntime::
   // group should share cache id.
   auto group_cache_id = args.getCacheId();
   const int64_t num_groups = (int64_t)runtime_workspace_.group_run_order.size();
+
+  // Place the tensors passed between segments in the intermediate arena if
+  // a layout has been planned for this cache id, otherwise record them to
+  // plan one. See [ Arena for Segment Intermediates ].
+  std::unique_lock<std::mutex> arena_lock(arena_mutex_, std::defer_lock);
+  // Regions of the arena are reused based on the order of kernels on a
+  // single stream, so it is not used when segments run on multiple streams.
+  // See [ Multi-Stream Execution of Segments ].
+  const bool use_streams = useSegmentStreams();
+  const bool use_arena = group_cache_id.has_value() && num_groups > 1 &&
+      !use_streams && !isOptionDisabled(DisableOption::SegmentArena) &&
+      arena_lock.try_lock();
+  std::vector<std::vector<at::Tensor>> arena_output_buffers;
+  std::optional<std::vector<IntermediateArena::Buffer>> arena_buffers_to_plan;
+  if (use_arena) {
+    if (intermediate_arena_.hasLayout(group_cache_id.value())) {
+      std::vector<int64_t> num_segment_outputs;
+      num_segment_outputs.reserve(num_groups);
+      for (auto group : runtime_workspace_.group_run_order) {
+        num_segment_outputs.push_back((int64_t)group->outputs().size());
+      }
+      arena_output_buffers = intermediate_arena_.getOutputBuffers(
+          group_cache_id.value(),
+          num_segment_outputs,
+          c10::Device(c10::DeviceType::CUDA, args.getDeviceIndex()));
+    } else {
+      arena_buffers_to_plan.emplace();
+    }
+  }
+
+  // Stream 0 is the current stream. The other streams start after the work
+  // already queued on it, e.g., producing the fusion inputs.
+  std::vector<c10::cuda::CUDAStream> streams;
+  std::vector<at::cuda::CUDAEvent> group_done_events;
+  if (use_streams) {
+    streams.push_back(at::cuda::getCurrentCUDAStream(args.getDeviceIndex()));
+    at::cuda::CUDAEvent inputs_ready;
+    inputs_ready.record(streams.front());
+    for (const auto i : c10::irange(1, runtime_workspace_.num_streams)) {
+      (void)i; // Suppress unused variable warning
+      streams.push_back(
+          at::cuda::getStreamFromPool(false, args.getDeviceIndex()));
+      inputs_ready.block(streams.back());
+    }
+    group_done_events.resize(num_groups);
+  }
+
   num_live_args_after_segment_runs_.reserve(num_groups);
   kernel_time_ms_ = 0;
   for (auto group_id : c10::irange(num_groups)) {
@@ -1433,16 +3594,116 @@ std::unordered_map<Val*, const PolymorphicValue*> FusionKernelRuntime::
     if (group_cache_id.has_value()) {
       group_runtime_inputs.setCacheId(group_cache_id.value());
     }
+    // The arguments outlive the segment, see [ Kernel Argument Storage ]
     for (auto input : group_to_run->inputs()) {
-      group_runtime_inputs.push(*args_manager.checkTensorMap(input));
+      group_runtime_inputs.pushView(args_manager.checkTensorMap(input));
+    }
+
+    // The profiler expects a kernel for each segment, so the groups
+    // evaluated on the host are launched instead while profiling. See
+    // [ Host-Evaluated Segments ].
+    const bool is_host_group = isEvaluatedOnHost(group_to_run);
+    const bool evaluate_on_host = is_host_group && !isProfilerEnabled();
+    // See [ Profile-Guided ATen Fallback ]
+    const bool run_with_fallback =
+        aten_fusions_.at(group_to_run->groupId()) != nullptr &&
+        group_cache_id.has_value() && !isProfilerEnabled();
+
+    std::vector<at::Tensor> group_output_buffers;
+    if (!arena_output_buffers.empty()) {
+      group_output_buffers = std::move(arena_output_buffers.at(group_id));
+    }
+    // See [ Caller-Owned Outputs ]
+    if (!output_buffers.empty()) {
+      const auto& group_outputs = group_to_run->outputs();
+      const auto& fusion_outputs = segmented_fusion_->outputs();
+      group_output_buffers.resize(group_outputs.size());
+      for (const auto out_i : c10::irange(group_outputs.size())) {
+        auto it = std::find(
+            fusion_outputs.begin(),
+            fusion_outputs.end(),
+            group_outputs.at(out_i));
+        if (it != fusion_outputs.end()) {
+          const auto& buffer =
+              output_buffers.at(std::distance(fusion_outputs.begin(), it));
+          if (buffer.defined()) {
+            group_output_buffers.at(out_i) = buffer;
+          }
+        }
+      }
+    }
+    if (!group_output_buffers.empty() && !evaluate_on_host &&
+        !run_with_fallback) {
+      executors_.at(group_to_run->groupId())
+          .setOutputBuffers(std::move(group_output_buffers));
     }
 
     // TODO: currently we are still outputing PyTorch tensors, instead of
     // something abstract. This is quite unsatisfying.
 
+    // Launch the segment on its stream after the producers of its inputs
+    std::optional<c10::cuda::CUDAStreamGuard> stream_guard;
+    if (use_streams) {
+      const auto stream_i = runtime_workspace_.group_run_streams.at(group_id);
+      for (auto dep : runtime_workspace_.group_run_dependencies.at(group_id)) {
+        if (runtime_workspace_.group_run_streams.at(dep) != stream_i) {
+          group_done_events.at(dep).block(streams.at(stream_i));
+        }
+      }
+      stream_guard.emplace(streams.at(stream_i));
+    }
+
     // Run graph segment
-    std::vector<at::Tensor> group_runtime_outputs =
-        runKernelWithInput(group_runtime_inputs, group_to_run);
+    std::vector<at::Tensor> group_runtime_outputs;
+    if (evaluate_on_host) {
+      group_runtime_outputs = evaluateGroupOnHost(
+          group_runtime_inputs, group_to_run, group_output_buffers);
+    } else if (run_with_fallback) {
+      group_runtime_outputs = runGroupWithFallback(
+          group_runtime_inputs,
+          group_to_run,
+          group_cache_id.value(),
+          std::move(group_output_buffers));
+    } else {
+      group_runtime_outputs =
+          runKernelWithInput(group_runtime_inputs, group_to_run);
+    }
+    if (is_host_group && !evaluate_on_host) {
+      const auto& group_outputs = group_to_run->outputs();
+      for (const auto out_i : c10::irange(group_outputs.size())) {
+        if (group_outputs.at(out_i)->as<TensorView>()->isCpuScalar()) {
+          group_runtime_outputs.at(out_i) =
+              group_runtime_outputs.at(out_i).cpu();
+        }
+      }
+    }
+
+    if (use_streams) {
+      const auto& consumer_streams =
+          runtime_workspace_.group_run_consumer_streams.at(group_id);
+      for (const auto& tensor : group_runtime_outputs) {
+        if (!tensor.defined() || !tensor.is_cuda()) {
+          continue;
+        }
+        for (auto consumer_stream : consumer_streams) {
+          tensor.record_stream(streams.at(consumer_stream));
+        }
+      }
+      if (!consumer_streams.empty()) {
+        group_done_events.at(group_id).record(
+            streams.at(runtime_workspace_.group_run_streams.at(group_id)));
+      }
+      stream_guard.reset();
+    }
+    if (arena_buffers_to_plan.has_value() && !is_host_group &&
+        !run_with_fallback) {
+      addArenaBuffers(
+          runtime_workspace_.group_run_order,
+          group_id,
+          group_runtime_inputs,
+          group_runtime_outputs,
+          arena_buffers_to_plan.value());
+    }
     args_manager.updateWithSegmentOutputs(
         group_to_run->outputs(), group_runtime_outputs, group_id);
     num_live_args_after_segment_runs_.push_back((int64_t)args.size());
@@ -1458,6 +3719,20 @@ std::unordered_map<Val*, const PolymorphicValue*> FusionKernelRuntime::
     }
   }
 
+  if (arena_buffers_to_plan.has_value()) {
+    intermediate_arena_.addLayout(
+        group_cache_id.value(), std::move(arena_buffers_to_plan.value()));
+  }
+
+  clearL2AccessPolicyWindows();
+
+  // Join all streams back into the current stream
+  for (const auto i : c10::irange(1, (int64_t)streams.size())) {
+    at::cuda::CUDAEvent stream_done;
+    stream_done.record(streams.at(i));
+    stream_done.block(streams.front());
+  }
+
   if (isProfilerEnabled()) {
     int64_t input_bytes = 0;
     for (auto inp : fusionSegments()->inputs()) {
@@ -1582,10 +3857,25 @@ void FusionKernelRuntime::updateHeuristicsLaunchParams(
   }
 }
 
+void FusionKernelRuntime::recordAchievedOccupancy(
+    const FusionProfile& profile) {
+  // Kernel profiles are indexed by the segment id, i.e., the group id
+  const auto num_profiles =
+      std::min(profile.kernel_profiles.size(), executors_.size());
+  for (const auto i : c10::irange(num_profiles)) {
+    const KernelProfile& kprof = profile.kernel_profiles[i];
+    if (kprof.metrics.has_value() && executors_[i].isCompiled()) {
+      executors_[i].setAchievedOccupancy(
+          kprof.metrics->achieved_occupancy_pct);
+    }
+  }
+}
+
 std::optional<FusionKernelRuntime::HeuristicsPtr> FusionKernelRuntime::
     getMaybeHeuristicsFor(
         const KernelArgumentHolder& args,
-        std::optional<PrimDataType> forced_index_type) {
+        std::optional<PrimDataType> forced_index_type,
+        bool tolerate_alignment) {
   FUSER_PERF_SCOPE("FusionKernelRuntime::getMaybeHeuristicsFor");
   auto complete_fusion = segmented_fusion_->completeFusion();
   precomputed_values_->bindInputs(args);
@@ -1608,8 +3898,11 @@ std::optional<FusionKernelRuntime::HeuristicsPtr> FusionKernelRuntime::
       return std::nullopt;
     }
     auto scheduler_entry = std::move(maybe_scheduler_entry.value());
-    if (!scheduler_entry->sameAs(
-            heuristics_->heuristicsList()[group_index].get())) {
+    SchedulerEntry* compiled_entry =
+        heuristics_->heuristicsList()[group_index].get();
+    if (tolerate_alignment
+            ? !compiled_entry->canRunInputsOf(scheduler_entry.get())
+            : !scheduler_entry->sameAs(compiled_entry)) {
       return std::nullopt;
     }
     ret.value()->emplaceBack(std::move(scheduler_entry));
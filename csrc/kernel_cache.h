@@ -7,28 +7,39 @@
 // clang-format on
 #pragma once
 
+#include <cuda_graph.h>
 #include <dynamic_transform.h>
 #include <evaluator_common.h>
 #include <exceptions.h>
 #include <executor.h>
 #include <fusion.h>
 #include <fusion_segmenter.h>
+#include <intermediate_arena.h>
+#include <interpreter/interpreter.h>
 #include <scheduler/all_schedulers.h>
 #include <scheduler/registry.h>
 #include <serde/fusion_cache_generated.h>
+#include <telemetry.h>
 
 #include <c10/macros/Export.h>
 #include <c10/util/ArrayRef.h>
 
+#include <atomic>
+#include <future>
 #include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
 #include <type_traits>
 #include <unordered_map>
+#include <unordered_set>
 
 namespace nvfuser {
 
 class SegmentedGroup;
 class FusionHeuristics;
 class SchedulerRuntimeInfo;
+struct FusionProfile;
 
 // Utilities for benchmarking and profiling
 struct ExecutorLog {
@@ -36,12 +47,153 @@ struct ExecutorLog {
   FusionExecutor* fusion_executor = nullptr;
 };
 
+//! [ L2 Reuse Across Segments ]
+//!
+//! A tensor that several segments read, e.g., a weight used by two
+//! consecutive segments, is loaded from DRAM by each of them if the
+//! segments in between evict it from L2. When EnableOption::L2Persistence is
+//! set, FusionKernelRuntime finds the tensors read by more than one segment
+//! once per runtime in prepareL2Reuse and
+//!  - marks the global loads of such a tensor in all but the last segment
+//!    reading it as CacheOp::EvictLast, see refineCachePolicyForReuse, and
+//!  - before launching a segment reading such a tensor, sets the access
+//!    policy window of the stream to the largest of them, so that its lines
+//!    persist in the L2 set-aside. The set-aside is configured to its
+//!    maximum size on first use, and the windows are removed again after the
+//!    last segment is launched.
+//! Both are hints only and need sm_80 or later.
+//!
+//! [ Memory-Aware Segment Order ]
+//!
+//! The tensors passed between segments are freed after the last segment
+//! reading them, so the order the segments run in, group_run_order,
+//! determines the peak memory of a run. By default it's the first
+//! topological order found, in which, e.g., the many intermediates of the
+//! early segments of a backward fusion can stay alive long after they are
+//! needed. When EnableOption::MemoryAwareRunOrder is set,
+//! prepareRuntimeOrder instead builds the order greedily: out of the groups
+//! whose inputs are ready, it picks the one that increases the live bytes
+//! the least, i.e., the bytes of its outputs minus the bytes of the
+//! intermediates it's the last reader of. Ties go to the first such group.
+//! The sizes are evaluated for the inputs the runtime is created for.
+//!
+//! FusionKernelRuntime::predictPeakMemory replays group_run_order for given
+//! inputs and returns the largest number of bytes held by the outputs and
+//! the intermediates at once. Fusion inputs, outputs that alias inputs and
+//! the global work buffers of the kernels are not counted.
+//!
+//! [ Multi-Stream Execution of Segments ]
+//!
+//! Segments that do not depend on each other, e.g., the separate gradient
+//! reductions of a layer norm backward, are still launched one after another
+//! following group_run_order. Each of them is often too small to fill the
+//! GPU by itself. When EnableOption::MultiStreamSegments is set,
+//! FusionKernelRuntime launches each segment on one of a few streams instead
+//! and orders the segments with CUDA events, so independent segments can run
+//! concurrently.
+//!
+//! The streams are assigned once per runtime in prepareRuntimeOrder. A
+//! segment stays on the stream of one of its producers if that producer is
+//! the most recent segment on its stream, so a chain of segments runs on one
+//! stream without any event. Otherwise, the segment is given the next stream
+//! in round-robin order. Stream 0 is the stream current when the fusion is
+//! run. The other streams first wait for the work queued on stream 0 so far,
+//! and stream 0 waits for all of them before returning.
+//!
+//! The host side is unchanged: segments are still run one by one from the
+//! calling thread in group_run_order, which is a topological order, so only
+//! the device work overlaps. Tensors used on a stream other than the one
+//! they were allocated on are marked with record_stream so that the caching
+//! allocator does not reuse their memory too early.
+//!
+//! [ Host-Evaluated Segments ]
+//!
+//! Scalar arithmetic on CPU scalars, e.g., scaling a learning rate or a loss
+//! scale passed as a 0-dim CPU tensor, may end up in a segment of its own,
+//! which costs a kernel launch for a handful of flops. When
+//! EnableOption::HostEvaluatedSegments is set, prepareHostEvaluatedGroups
+//! picks the groups that
+//!  - read no tensors other than CPU scalars, i.e., 0-dim CPU tensors that
+//!    are fusion inputs or kept on the host by other such groups,
+//!  - only have ops with ATen implementations and no random numbers, and
+//!  - only write tensors of constant sizes of at most
+//!    kMaxHostEvaluatedElements elements, or of the number of elements given
+//!    as the argument of the option.
+//! These groups are evaluated with ExpressionEvaluator instead of launching
+//! their kernels. Their 0-dim outputs that aren't fusion outputs stay on the
+//! host and are marked as CPU scalars in the complete fusion, so that later
+//! segments take them by value as kernel arguments, like CPU scalar fusion
+//! inputs, and later groups can be host-evaluated in turn. Their other
+//! outputs are copied to the device.
+//!
+//! Tiny tensors already on the device are not moved to the host, as reading
+//! them would synchronize with the device. The kernels of these groups are
+//! still compiled, so that the runtime is serialized as usual, but they are
+//! never launched. As with the other options changing the kernels, the
+//! option has to be the same when a serialized runtime is deserialized.
+//!
+//! [ Profile-Guided ATen Fallback ]
+//!
+//! Some segments, e.g., a lone large matmul or a plain copy, run faster with
+//! ATen and cuBLAS than with the kernel generated for them. When
+//! EnableOption::ProfileGuidedFallback is set, the first run of a segment
+//! for an input cache id, i.e., for the sizes and strides of the fusion
+//! inputs, times the kernel and the evaluation of the segment with
+//! ExpressionEvaluator, after running each once untimed to leave out the
+//! loading of modules and the initialization of libraries. The outputs of
+//! the untimed kernel run are the ones returned. Later runs for the cache id
+//! use ATen if it took less than kAtenFallbackMargin of the kernel time, and
+//! the kernel otherwise or if the evaluation throws. The decisions are
+//! serialized with the runtime.
+//!
+//! Only segments without random numbers, outputs aliasing inputs, allocation
+//! domains and expanded broadcasts are profiled, so that their outputs are
+//! the same either way and running them twice has no side effects. CUDA
+//! graphs aren't captured with the option, as a segment may run without a
+//! kernel.
 struct RuntimeWorkSpace {
   //! Pre-determined order to run the segmented groups
   std::vector<SegmentedGroup*> group_run_order;
 
   //! Pre-determined order to bind tensor input meta data
   std::vector<Val*> group_extent_binding_order;
+
+  //! Positions in group_run_order of the groups producing the inputs of each
+  //! group, and of the groups reading the fusion inputs it updates in place,
+  //! indexed by the position of the consuming group
+  std::vector<std::vector<int64_t>> group_run_dependencies;
+
+  //! Stream each group is launched on, indexed by the position in
+  //! group_run_order. See [ Multi-Stream Execution of Segments ].
+  std::vector<int64_t> group_run_streams;
+
+  //! Streams other than the group's own that use the outputs of each group,
+  //! indexed by the position in group_run_order
+  std::vector<std::vector<int64_t>> group_run_consumer_streams;
+
+  //! Number of distinct streams in group_run_streams
+  int64_t num_streams = 1;
+};
+
+//! What running a fusion with an input signature would do, evaluated without
+//! compiling it. See [ Batched Shape Evaluation ].
+struct SignatureEvaluation {
+  //! Sizes of the fusion outputs, with expanded broadcasts at their expanded
+  //! extents. Scalar outputs have no sizes.
+  std::vector<std::vector<int64_t>> output_sizes;
+
+  //! Concretization and runtime the signature is run with, also shared by
+  //! other signatures
+  int64_t concrete_id = -1;
+  int64_t runtime_id = -1;
+
+  //! Scheduler and heuristic parameters of each segment, in the order of the
+  //! segmented groups
+  std::vector<ScheduleHeuristic> heuristics;
+  std::vector<std::shared_ptr<HeuristicParams>> params;
+
+  //! See [ Memory-Aware Segment Order ]
+  int64_t peak_memory = 0;
 };
 //! Simple hasher for pair<T, const U*>. There is no default hasher for pairs,
 //! since there are a lot of options how to combine hashes. In a case where one
@@ -78,6 +230,26 @@ struct PairPointerEquals {
   }
 };
 
+//! [ Asynchronous Compilation ]
+//!
+//! Compiling a new FusionKernelRuntime blocks the first call with new input
+//! shapes, often for seconds. When EnableOption::AsyncCompile is set,
+//! FusionExecutorCache::runFusionWithInputs queues the compilation on
+//! getThreadPool() instead. Until it finishes, the complete fusion is
+//! evaluated with ATen through ExpressionEvaluator, which is slow but needs
+//! no compilation. Once all executors are compiled, async_compile_pending_
+//! is cleared and the next run launches the kernels. Pointwise fusions that
+//! can be interpreted by a precompiled kernel are also compiled this way, see
+//! [ Interpreted Pointwise Kernels ].
+//!
+//! Fusions that cannot be evaluated this way, e.g., because they use random
+//! numbers or update inputs in place, or that contain an expression without
+//! an ATen implementation, wait for the compilation as before. Since
+//! compileFusionParallel holds mutex_ while compiling, nothing else may
+//! touch the executors or heuristics of the runtime in the meantime. In
+//! particular, FusionExecutorCache does not reuse a runtime for new input
+//! shapes while it is being compiled.
+
 //! FusionKernelRuntime is the unified interface from fusion graphs into
 //!  caching, compilation into kernels, and kernel launches.
 //!
@@ -110,13 +282,33 @@ class FusionKernelRuntime {
   //! Evicts internally cached parameters based on input sizes.
   //!  An interface used by runtime caches.
   void evictCache(size_t input_id) {
+    std::lock_guard<std::mutex> run_guard(run_mutex_);
     for (auto& fe : executors_) {
       fe.evictCache(input_id);
     }
+    cuda_graphs_.erase(input_id);
+    std::lock_guard<std::mutex> guard(arena_mutex_);
+    intermediate_arena_.evictLayout(input_id);
+  }
+
+  //! Waits for a pending background compilation, which refers to this
+  //! runtime
+  ~FusionKernelRuntime();
+
+  //! Held by FusionExecutorCache while it runs this runtime, since the
+  //! executors, CUDA graphs and timers are not safe for concurrent runs.
+  //! See [ Concurrent Execution ].
+  std::mutex& runMutex() {
+    return run_mutex_;
   }
 
   //! query if we already have a compiled kernel for execution
   bool isCompiled() {
+    // The executors are being compiled in the background while holding
+    // mutex_. See [ Asynchronous Compilation ].
+    if (async_compile_pending_.load(std::memory_order_acquire)) {
+      return false;
+    }
     std::lock_guard<std::mutex> guard(mutex_);
     return std::all_of(
         executors_.begin(), executors_.end(), [](const auto& executor) {
@@ -145,13 +337,59 @@ class FusionKernelRuntime {
     return index_type.value();
   }
 
-  //! Unified interface to run the managed kernels with given input
-  std::vector<at::Tensor> runWithInputs(KernelArgumentHolder& args);
+  //! Unified interface to run the managed kernels with given input. Defined
+  //! entries of output_buffers, indexed like the outputs of the complete
+  //! fusion, are written to instead of allocating the outputs. See
+  //! [ Caller-Owned Outputs ].
+  std::vector<at::Tensor> runWithInputs(
+      KernelArgumentHolder& args,
+      const std::vector<at::Tensor>& output_buffers = {});
 
   //! Compile a kernel executor for given inputs. Note: The compilation is
   //! multithreaded. The segments in the fusion are compiled independently.
   void compileFusionParallel(KernelArgumentHolder args);
 
+  //! Queue compileFusionParallel on the thread pool and return immediately.
+  //! Does nothing if compilation has already been queued. See
+  //! [ Asynchronous Compilation ].
+  void compileFusionAsync(KernelArgumentHolder args);
+
+  //! Check if compileFusionAsync has been called
+  bool isAsyncCompileQueued() const {
+    return async_compile_queued_.load(std::memory_order_acquire);
+  }
+
+  //! Check if compilation queued by compileFusionAsync has not finished yet
+  bool isAsyncCompilePending() const {
+    return async_compile_pending_.load(std::memory_order_acquire);
+  }
+
+  //! Block until compilation queued by compileFusionAsync has finished.
+  //! Rethrows any error raised while compiling.
+  void waitForAsyncCompile();
+
+  //! Check if the complete fusion can be evaluated with ATen while its
+  //! kernels are being compiled
+  bool canRunWithExpressionEvaluator() const;
+
+  //! Evaluate the complete fusion with ATen through ExpressionEvaluator
+  //! instead of running the compiled kernels. Returns nullopt if some
+  //! expression of the fusion cannot be evaluated.
+  std::optional<std::vector<at::Tensor>> runWithExpressionEvaluator(
+      const KernelArgumentHolder& args);
+
+  //! Check if the complete fusion was translated for the precompiled
+  //! interpreter. See [ Interpreted Pointwise Kernels ].
+  bool canRunWithInterpreter() const {
+    return interpreter_ != nullptr;
+  }
+
+  //! Run the complete fusion with the precompiled interpreter instead of
+  //! the compiled kernels. Returns nullopt if the fusion or its inputs are
+  //! not supported by the interpreter.
+  std::optional<std::vector<at::Tensor>> runWithInterpreter(
+      const KernelArgumentHolder& args) const;
+
   const std::vector<int64_t>& getArgsNumAfterSegmentRuns() {
     return num_live_args_after_segment_runs_;
   }
@@ -161,6 +399,12 @@ class FusionKernelRuntime {
     profiling_ = to_profile;
   }
 
+  //! Priority of the compiles queued on the thread pool. See
+  //! [ Compile Thread Pool ].
+  void setCompilePriority(int64_t priority) {
+    compile_priority_ = priority;
+  }
+
   //! Enable kernel time measurement. Only the device time is
   //! inclued.
   void enableKernelTimeMeasurement() {
@@ -200,6 +444,17 @@ class FusionKernelRuntime {
     return segmented_fusion_.get();
   }
 
+  //! Whether the group is evaluated on the host instead of launching its
+  //! kernel, see [ Host-Evaluated Segments ]
+  bool isEvaluatedOnHost(SegmentedGroup* sg) const {
+    return host_fusions_.at(sg->groupId()) != nullptr;
+  }
+
+  //! Whether the group runs with ATen instead of its kernel for the inputs of
+  //! the cache id, or nullopt if it hasn't been profiled for them. See
+  //! [ Profile-Guided ATen Fallback ].
+  std::optional<bool> isRunWithAten(size_t cache_id, SegmentedGroup* sg) const;
+
   //! Returns the list of heuristics in this runtime
   FusionHeuristics* schedulerHeuristics() {
     return heuristics_.get();
@@ -219,10 +474,14 @@ class FusionKernelRuntime {
   //  any segment cannot be scheduled or the parameters don't match
   //
   // Heuristics must use the index type of forced_index_type if given.
+  //
+  // With tolerate_alignment, the parameters only need to describe kernels
+  // that can run the inputs, see [ Alignment Tolerant Kernel Reuse ].
   using HeuristicsPtr = std::unique_ptr<FusionHeuristics>;
   std::optional<HeuristicsPtr> getMaybeHeuristicsFor(
       const KernelArgumentHolder& args,
-      std::optional<PrimDataType> forced_index_type = std::nullopt);
+      std::optional<PrimDataType> forced_index_type = std::nullopt,
+      bool tolerate_alignment = false);
 
   //! Copy the launch params given in the parameter heuristics to prepare
   //!  for kernel launch for a new input dimension but same heuristics
@@ -232,13 +491,71 @@ class FusionKernelRuntime {
     return executors_;
   }
 
+  //! Copies the achieved occupancy measured by the profiler of the most recent
+  //! run to the kernel resources of the executors, see [ Kernel Resources ]
+  void recordAchievedOccupancy(const FusionProfile& profile);
+
+  int64_t concreteId() const {
+    return concrete_id_;
+  }
+
+  int64_t runtimeId() const {
+    return runtime_id_;
+  }
+
+  //! Check if the kernel launches for the given arguments can be replayed
+  //! from a CUDA graph. See [ CUDA Graph Replay of Segmented Fusions ].
+  bool isCudaGraphCompatible(const KernelArgumentHolder& args) const;
+
+  //! Largest number of bytes of outputs and intermediates alive at once when
+  //! running the groups in group_run_order for the given arguments. See
+  //! [ Memory-Aware Segment Order ].
+  int64_t predictPeakMemory(const KernelArgumentHolder& args) const;
+
+  //! Output sizes, heuristics and peak memory of running the runtime with
+  //! args, whose tensors may be meta tensors. The parameters are copies, as
+  //! the heuristics are updated for the launch parameters of each input.
+  SignatureEvaluation evaluateSignature(const KernelArgumentHolder& args) const;
+
+  //! Arena holding the tensors passed between segments. See [ Arena for
+  //! Segment Intermediates ].
+  const IntermediateArena& intermediateArena() const {
+    return intermediate_arena_;
+  }
+
+  //! Number of streams the segments are launched on when
+  //! EnableOption::MultiStreamSegments is set. See [ Multi-Stream Execution
+  //! of Segments ].
+  int64_t numSegmentStreams() const {
+    return runtime_workspace_.num_streams;
+  }
+
+  //! Number of input cache ids for which a CUDA graph has been built
+  size_t numCudaGraphs() const {
+    return std::count_if(
+        cuda_graphs_.begin(), cuda_graphs_.end(), [](const auto& entry) {
+          return entry.second != nullptr;
+        });
+  }
+
  private:
+  //! Runs the fusion by replaying the CUDA graph built for the cache id of
+  //! the given arguments. The graph is built from the kernel launches of the
+  //! first run with that cache id.
+  std::vector<at::Tensor> runWithCudaGraph(KernelArgumentHolder& args);
+
+  //! Gathers the outputs of the complete fusion from the result of
+  //! runSegmentsWithInputs
+  std::vector<at::Tensor> getFusionOutputs(
+      const std::unordered_map<Val*, const PolymorphicValue*>& tensor_map);
+
   //! Runs each fusion segment given arguments. The outputs for a fusion are
   //! added back to the arguments, so they can be used as inputs to successive
   //! segments. Returns a map that links each NvFuser Val to its corresponding
-  //! tensor.
+  //! tensor. See runWithInputs for output_buffers.
   std::unordered_map<Val*, const PolymorphicValue*> runSegmentsWithInputs(
-      KernelArgumentHolder& args);
+      KernelArgumentHolder& args,
+      const std::vector<at::Tensor>& output_buffers = {});
 
   //! Interface to run a single kernel, either one kernel for single-kernel
   //! fusions, or a kernel for a segmentedGrouup in a segmented fusion. Returns
@@ -259,13 +576,99 @@ class FusionKernelRuntime {
   //! Access the list of schedulers maintained in this runtime instance
   const std::vector<SchedulerEntryPtr>& schedulers() const;
 
-  void prepareRuntimeOrder();
+  //! expr_eval is used to order the groups by their memory use. See
+  //! [ Memory-Aware Segment Order ].
+  void prepareRuntimeOrder(ExpressionEvaluator& expr_eval);
+
+  //! Check that every output updating a fusion input in place is computed
+  //! after the input is read by the other groups and without hazards in its
+  //! own kernel. See validateInplaceUpdate in alias_analysis.h.
+  void validateInplaceUpdates();
+
+  //! Assign a stream to each group in group_run_order. See [ Multi-Stream
+  //! Execution of Segments ].
+  void prepareRuntimeStreams();
+
+  //! Check if the segments of the next run are launched on multiple streams
+  bool useSegmentStreams() const;
+
+  //! Find the tensors read by more than one group. See [ L2 Reuse Across
+  //! Segments ].
+  void prepareL2Reuse();
+
+  //! Set the access policy window of the current stream to the largest input
+  //! of the group that another group reads as well, if any
+  void setL2AccessPolicyWindow(
+      const KernelArgumentHolder& args,
+      SegmentedGroup* sg);
+
+  //! Remove the access policy windows set by setL2AccessPolicyWindow
+  void clearL2AccessPolicyWindows();
+
+  //! Find the groups to evaluate on the host and mark the outputs they keep
+  //! there as CPU scalars. See [ Host-Evaluated Segments ].
+  void prepareHostEvaluatedGroups();
+
+  //! Evaluate a group picked by prepareHostEvaluatedGroups with
+  //! ExpressionEvaluator. Returns its outputs, CPU scalars for the outputs
+  //! kept on the host and device tensors for the others, which are copied
+  //! into the given buffers if defined.
+  std::vector<at::Tensor> evaluateGroupOnHost(
+      const KernelArgumentHolder& args,
+      SegmentedGroup* sg,
+      const std::vector<at::Tensor>& output_buffers = {});
+
+  //! Find the groups whose kernels are timed against ATen. See
+  //! [ Profile-Guided ATen Fallback ].
+  void prepareAtenFallbackGroups();
+
+  //! Evaluate a group picked by prepareAtenFallbackGroups with
+  //! ExpressionEvaluator on the device
+  std::vector<at::Tensor> evaluateGroupWithAten(
+      const KernelArgumentHolder& args,
+      SegmentedGroup* sg,
+      const std::vector<at::Tensor>& output_buffers = {});
+
+  //! Run a group picked by prepareAtenFallbackGroups with its kernel or with
+  //! ATen, whichever was faster for the cache id, and time both on its first
+  //! run for it
+  std::vector<at::Tensor> runGroupWithFallback(
+      KernelArgumentHolder& args,
+      SegmentedGroup* sg,
+      size_t cache_id,
+      std::vector<at::Tensor> output_buffers);
 
  private:
   //! Entries indexed by groupID:
   //! Executors holding compiled kernels
   std::vector<FusionExecutor> executors_;
 
+  //! Positions in the inputs of each group of the tensors that a group later
+  //! in group_run_order reads again, indexed by groupID. See [ L2 Reuse
+  //! Across Segments ].
+  std::vector<std::vector<int64_t>> l2_reused_inputs_;
+
+  //! Positions in the inputs of each group of the tensors that any other
+  //! group reads as well, indexed by groupID
+  std::vector<std::vector<int64_t>> l2_shared_inputs_;
+
+  //! Streams with an access policy window set by setL2AccessPolicyWindow
+  std::unordered_set<cudaStream_t> l2_window_streams_;
+
+  //! Fusions of the groups evaluated on the host, indexed by groupID, and
+  //! nullptr for the groups run as kernels. See [ Host-Evaluated Segments ].
+  std::vector<std::unique_ptr<Fusion>> host_fusions_;
+
+  //! Fusions of the groups that are timed against ATen, indexed by groupID,
+  //! and nullptr for the other groups. See [ Profile-Guided ATen Fallback ].
+  std::vector<std::unique_ptr<Fusion>> aten_fusions_;
+
+  //! Whether each profiled group, by groupID, runs with ATen for the inputs
+  //! of each cache id. Guarded by aten_fallback_mutex_.
+  std::unordered_map<size_t, std::unordered_map<int64_t, bool>>
+      aten_fallback_decisions_;
+  mutable std::mutex aten_fallback_mutex_;
+
   // A metadata copy of initial arguments used to contruct this
   // FusionKernelRuntime. Used during deserialization to schedule the fusion
   // rather than storing the scheduled fusion directly.
@@ -298,6 +701,9 @@ class FusionKernelRuntime {
   // States for profiling support
   bool profiling_ = false;
 
+  //! Priority of the compiles queued on the thread pool
+  std::atomic<int64_t> compile_priority_ = 0;
+
   //! Flag to indicate kernel timing measurement. Should be disabled
   //! unless benchmarking the kernel timing only as the measurement
   //! itself incurs an overhead.
@@ -308,6 +714,9 @@ class FusionKernelRuntime {
 
   std::mutex mutex_;
 
+  //! See runMutex()
+  std::mutex run_mutex_;
+
   // ID of fusion in python frontend fusion cache, which maps to a single
   // FusionExecutorCache.
   int64_t fusion_id_ = -1;
@@ -320,6 +729,36 @@ class FusionKernelRuntime {
 
   // The heuristics and executor for most recent kernel launch
   ExecutorLog most_recent_executor_log_;
+
+  //! CUDA graphs keyed by the input cache id. A nullptr entry means the
+  //! launches for that cache id could not be turned into a graph, so they
+  //! are run without one.
+  std::unordered_map<size_t, std::unique_ptr<FusionCudaGraph>> cuda_graphs_;
+
+  //! Tensors passed between segments are placed in this arena. Only one run
+  //! at a time can use it, which is guarded by arena_mutex_. Concurrent runs
+  //! allocate their intermediates as usual.
+  IntermediateArena intermediate_arena_;
+  std::mutex arena_mutex_;
+
+  //! Makes sure compileFusionAsync queues compilation only once
+  std::once_flag async_compile_once_;
+  std::atomic<bool> async_compile_queued_ = false;
+
+  //! Set while compileFusionAsync is compiling the executors
+  std::atomic<bool> async_compile_pending_ = false;
+
+  //! Becomes ready when compilation queued by compileFusionAsync finishes
+  std::shared_future<void> async_compile_done_;
+
+  //! Set once ExpressionEvaluator failed to evaluate the complete fusion, so
+  //! that later runs wait for the kernels instead
+  std::atomic<bool> expr_eval_failed_ = false;
+
+  //! The complete fusion translated for the precompiled interpreter, or
+  //! nullptr if it cannot be interpreted or EnableOption::InterpretedPointwise
+  //! is not set
+  std::unique_ptr<PointwiseInterpreter> interpreter_;
 };
 
 //! Encoding an input set to unique id, which is used to short-cut cache entry
@@ -337,8 +776,9 @@ class InputsIdLookup : public NonCopyable {
  public:
   //! constructor where maximum cache size is fixed during init
   // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init,cppcoreguidelines-avoid-magic-numbers)
-  explicit InputsIdLookup(size_t max_cache_size = 100)
-      : max_cache_size_(max_cache_size){};
+  explicit InputsIdLookup(size_t max_cache_size = 100) {
+    initShards(max_cache_size);
+  }
 
   //! struct to hold return value for lookupId.
   struct IdLookupReturn {
@@ -373,14 +813,22 @@ class InputsIdLookup : public NonCopyable {
   //! However, if scalar_inputs_to_record is provided, then the values of scalar
   //! inputs at the integer locations specified in that argument will affect the
   //! returned ID.
+  //!
+  //! This function is meant to be called concurrently from multiple threads.
+  //! The encoding is built in a thread-local buffer, and only the shard the
+  //! encoding hashes to is locked. Looking up an existing entry takes a
+  //! shared lock only. See [ Note -- Sharded InputsIdLookup ].
   IdLookupReturn lookupId(
       const at::ArrayRef<c10::IValue>& inputs,
       const std::unordered_set<size_t>& scalar_inputs_to_record = {},
       int8_t device = 0);
 
   //! debugging API that returns the size of lookup table
-  size_t size() const {
-    return encoding_lookup_.size();
+  size_t size() const;
+
+  //! Number of independently locked shards of the lookup table
+  size_t numShards() const {
+    return shards_.size();
   }
 
   //! Serialize InputsIdLookup using flatbuffers
@@ -391,36 +839,80 @@ class InputsIdLookup : public NonCopyable {
   void deserialize(const serde::InputsIdLookup* buffer);
 
  private:
-  // string to store encoded input meta information. Reuse the buffer instead of
-  // stringtream gives few us perf gain.
-  std::string encoding_; // Note: shared state, guarded by mutex_
-
-  // mutex_ used to guard reused encoding_
-  std::mutex mutex_;
-
-  //! entry stored in `encoding_lookup_` to implement LRU
-  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init)
+  //! [ Note -- Sharded InputsIdLookup ]
+  //!
+  //! The encoding of a set of inputs is a fixed-width binary record per input
+  //! (rank, sizes, strides and alignment for tensors, a tag and optionally
+  //! the value for scalars), so it can be built without any formatting and,
+  //! since the buffer is thread-local, without any locking. We keep the full
+  //! encoding as the key instead of just its hash because a hash collision
+  //! would silently run a kernel compiled for different inputs.
+  //!
+  //! The hash of the encoding selects one of several shards, each with its
+  //! own lock, map and share of max_cache_size_. Instead of maintaining a
+  //! linked list for LRU, each entry records the value of a global use counter
+  //! when it was last looked up. A hit therefore only needs to update an
+  //! atomic, and the least recently used entry of a shard is found by a scan
+  //! when the shard is full, which only happens together with inserting a new
+  //! entry. Eviction is LRU within a shard; with a single shard, which we use
+  //! for small caches, it is exactly LRU.
+
+  //! entry stored in `Shard::encoding_lookup` to implement LRU
   struct EncodingEntry {
     size_t id = 0;
-    std::list<std::string>::iterator lru_iter;
+    //! Value of use_counter_ when this entry was last looked up
+    std::atomic<uint64_t> last_use{0};
   };
 
+  struct Shard {
+    //! guards encoding_lookup. last_use of an entry can be updated while
+    //! holding the lock in shared mode
+    mutable std::shared_mutex mutex;
+
+    //! maximum number of entries in this shard
+    size_t max_size = 0;
+
+    //! map from the encoding of inputs to a unique id `size_t` (packaged in
+    //! `EncodingEntry`)
+    std::unordered_map<std::string, EncodingEntry> encoding_lookup;
+  };
+
+  //! Create the shards for the given maximum cache size. Must not be called
+  //! concurrently with lookupId.
+  void initShards(size_t max_cache_size);
+
+  //! Shard that owns the given encoding
+  Shard& shardFor(const std::string& encoding) const;
+
   //! maximum cache size for LRU
   size_t max_cache_size_ = 0;
 
   //! next available unique id, we monotonically increase `current_id_` avoid
   //! conflicts
-  size_t current_id_ = 1;
+  std::atomic<size_t> current_id_{1};
+
+  //! logical clock used to order entries by their recent usage
+  std::atomic<uint64_t> use_counter_{0};
+
+  //! Shard objects are not movable because of their mutex
+  std::vector<std::unique_ptr<Shard>> shards_;
+};
+
+//! Rounding of the extents of tensor inputs. See [ Shape Buckets ].
+struct ShapeBuckets {
+  enum class Kind {
+    None,
+    //! Round up to the next power of two
+    PowerOfTwo,
+    //! Round up to a multiple of `multiple`, which must be a multiple of 16
+    Multiple
+  };
 
-  //! entry in the cache, This is used to implement LRU cache, where entries in
-  //! the list is ordered by their recent usage (freshly used entry is placed at
-  //! the beginning)
-  std::list<std::string> used_entry_;
+  Kind kind = Kind::None;
+  int64_t multiple = 64;
 
-  //! map from `std::string` to a unique id `size_t` (packaged in
-  //! `EncodingEntry`
-  //! ). We store an iterator to `used_entry_` to implement LRU
-  std::unordered_map<std::string, EncodingEntry> encoding_lookup_;
+  //! The extent used in place of the given one to compute heuristics
+  int64_t bucket(int64_t extent) const;
 };
 
 //! [ Note -- Post-definition cache implementation ]
@@ -501,11 +993,143 @@ class InputsIdLookup : public NonCopyable {
 //!     d) rank;
 //!     e) scalar type;
 //!
+//! [ Shape Buckets ]
+//! Every new set of input sizes creates new InputsIdLookup and ExecutorEntry
+//! entries, and computing heuristics for it may result in a new
+//! FusionKernelRuntime, even though the generated kernels handle any extent.
+//! With FusionExecutorCache::setShapeBuckets, the extents of tensor inputs
+//! are rounded up to a bucket before segmentation and heuristics, so all
+//! inputs in a bucket share one FusionKernelRuntime and its heuristics and
+//! launch params. The kernels are run with the actual extents and their
+//! predicates handle the rest of the bucket.
+//!
+//! Rounding must not change whether a scheduler decision is valid. Extents
+//! of up to 16 are kept as they are, and each bucket is split by the largest
+//! power of two up to 16 dividing the extent, so vectorization and divisible
+//! splits are valid for every extent in the bucket. Only fusions whose
+//! extents are all derived from the input tensors are bucketed, i.e., there
+//! are no dynamic transforms, integer scalar inputs or ops creating extents,
+//! and only dense, 16-byte aligned input tensors are. Everything else takes
+//! the path described above.
+//!
+//! [ Alignment Tolerant Kernel Reuse ]
+//! The alignment of input pointers is part of the InputsIdLookup key, since
+//! it limits the vectorization factor. Inputs whose alignment jitters, e.g.,
+//! slices at different offsets, therefore get heuristics with different
+//! factors and each factor compiles a new FusionKernelRuntime. With
+//! EnableOption::AlignmentTolerantReuse, when no runtime has the same
+//! heuristics, a runtime is also reused if each of its kernels can run the
+//! inputs, see HeuristicParams::canRunInputsOf. For pointwise kernels, the
+//! inputs must allow a multiple of the compiled vectorization factor, or the
+//! kernel is not vectorized. The compiled alternatives thus act as variants
+//! chosen on the host. A runtime with the same heuristics is still
+//! preferred, and FusionExecutor validates the vectorized tensors at launch.
+//!
+//! [ Caller-Owned Outputs ]
+//!
+//! Callers capturing CUDA graphs or updating persistent buffers in place can
+//! pass their own output tensors to runFusionWithInputs, one per returned
+//! output, leaving the entries to be allocated undefined. The input cache id
+//! is still used, so the cached launch params and output buffer info of each
+//! FusionExecutor are reused. A given tensor is only checked against the
+//! cached GlobalBufferInfo of the output: its sizes, strides and dtype must
+//! match, and it must be aligned to 16 bytes like a fresh allocation, as the
+//! kernel may vectorize its accesses. Outputs aliasing inputs and fusions
+//! with permuted outputs can't be given buffers. If the output is not written
+//! by a kernel, e.g., when it's evaluated while the kernel compiles, it's
+//! copied to the given tensor.
+//!
+//! [ Chunked Execution ]
+//! A fusion whose intermediates and outputs don't fit in memory at once,
+//! e.g., a large batch, may still be run if it's computed independently for
+//! each index of an outer dimension. With EnableOption::ChunkedExecution,
+//! runFusionWithInputs predicts the peak memory of the inputs, see
+//! [ Memory-Aware Segment Order ], and if it exceeds the budget, the argument
+//! of the option in MiB or half of the device memory by default, the fusion
+//! is run on slices of the inputs along that dimension and the outputs of
+//! the slices are written to the full outputs. The size of a slice is a
+//! multiple of 16 of the extent divided by the number of budgets the peak
+//! takes, so the slices stay as aligned as the full tensors and all but the
+//! last one share an input cache id and FusionKernelRuntime. After the first
+//! slice, the slices of the full outputs are given as caller-owned outputs
+//! where their strides match, see [ Caller-Owned Outputs ].
+//!
+//! A fusion is chunked only if the outermost non-reduction logical domain of
+//! each output is exactly mapped to an outermost iteration domain of an
+//! input, and no tensor has a domain of that dimension at another position,
+//! reduces it or transforms it between its root and logical domains, and its
+//! extent is not used by any expression. Fusions with dynamic transforms,
+//! aliased or permuted outputs and random numbers, whose values depend on
+//! the indices of the full tensors, and runs with caller-owned outputs are
+//! never chunked.
+//!
+//! [ Host Streaming ]
+//! Activations and optimizer states offloaded to pinned host memory may be
+//! given to runFusionWithInputs directly, as may pinned host tensors for
+//! the outputs, if the fusion can be chunked, see [ Chunked Execution ].
+//! The run is tiled along the chunked dimension, with tiles of about
+//! setHostStreamingTileBytes of host inputs, and pipelined over three
+//! streams: the slices of the chunked host inputs of a tile are copied to
+//! one of two staging buffers on the device, computed on the current stream
+//! while the next tile is copied in, and the outputs are copied to the host
+//! outputs on a third stream while the following tiles are computed. So a
+//! fusion bound by the transfers runs at the bandwidth of the host link
+//! instead of copying, computing and copying back one after another. Host
+//! inputs that aren't chunked, e.g., weights, are copied once. Tensors on
+//! the device are used as they are, but outputs are always on the host and
+//! are ready when runFusionWithInputs returns. As with chunked execution,
+//! all tiles but the last one share an input cache id.
+//!
+//! [ Concurrent Execution ]
+//! runFusionWithInputs may be called from multiple threads, e.g., by the
+//! Python frontend, which releases the GIL while a fusion runs. Looking up
+//! and compiling the FusionKernelRuntime for the inputs is guarded by
+//! mutex_, since it updates the caches above. The runtime is then run
+//! holding only its runMutex(), so threads with inputs mapped to different
+//! runtimes, or using different FusionExecutorCaches, launch their kernels
+//! concurrently. Other methods of FusionExecutorCache, e.g., the ones
+//! returning the most recent code, and the profiler are not thread-safe.
+//!
 //! [ Note -- Segmented Fusion Tentative Design ]
 //! Segmentation adds an extra dimension in caching. Initial implementation,
 //! assumed graph partition strategy is independent of input pattern, which we
 //! can revisit once we have more advanced graph segmentation logic Each
 //! FusionExecutorCache corresponds to one graph and one graph segmentation.
+//! [ Batched Shape Evaluation ]
+//!
+//! Autotuning, ahead-of-time compilation and memory planning need what a
+//! fusion does with many input signatures, e.g., a range of batch sizes,
+//! before any tensor of them exists. FusionExecutorCache::evaluateSignatures
+//! takes signatures of InputDescriptors, which hold meta tensors instead of
+//! real ones, and returns a SignatureEvaluation for each of them. They go
+//! through the same lookup as runFusionWithInputs, so the concretizations,
+//! segmentations and heuristics of signatures a runtime can run are reused,
+//! and the runtimes created for them are compiled by the first run of a
+//! matching input. Extents are evaluated with ExpressionEvaluator and
+//! heuristics are computed from the current DeviceModel, see
+//! [ Device Model ], so they can also be computed for another GPU.
+//!
+//! Meta tensors have no address, so the signatures are evaluated as if their
+//! tensors were aligned to the largest vectorization.
+struct InputDescriptor {
+  //! A tensor input with the given strides
+  static InputDescriptor tensor(
+      const std::vector<int64_t>& sizes,
+      const std::vector<int64_t>& strides,
+      at::ScalarType dtype);
+
+  //! A contiguous tensor input
+  static InputDescriptor tensor(
+      const std::vector<int64_t>& sizes,
+      at::ScalarType dtype);
+
+  //! A scalar input, whose value may decide concretizations
+  static InputDescriptor scalar(const c10::IValue& value);
+
+  //! A meta tensor or a scalar
+  c10::IValue value;
+};
+
 class FusionExecutorCache {
  public:
   //! create new fusion executor cache at a given device to handle kernel
@@ -524,10 +1148,15 @@ class FusionExecutorCache {
   //! cases as our analysis of index type may be overly conservative
   //! for intermediate tensors.
   //! WARING: Correctness is not guaranteed.
+  //!
+  //! If given, the defined entries of preallocated_outputs are written to
+  //! and returned instead of allocating the corresponding outputs. See
+  //! [ Caller-Owned Outputs ].
   std::vector<at::Tensor> runFusionWithInputs(
       const at::ArrayRef<c10::IValue>& inputs,
       std::optional<PrimDataType> forced_index_type = std::nullopt,
-      std::optional<int8_t> selected_device = std::nullopt);
+      std::optional<int8_t> selected_device = std::nullopt,
+      const std::vector<at::Tensor>& preallocated_outputs = {});
 
   //! Converts inputs from IValue to KernelArgumentHolder, also handles cache
   //! lookup
@@ -538,6 +1167,18 @@ class FusionExecutorCache {
   //! query if there's a kernel ready to go for given inputs
   bool isCompiled(const at::ArrayRef<c10::IValue>& inputs, int8_t device = 0);
 
+  //! Peak memory of running the fusion with the given inputs, without
+  //! compiling it. See [ Memory-Aware Segment Order ].
+  int64_t predictPeakMemory(
+      const at::ArrayRef<c10::IValue>& inputs,
+      int8_t device = 0);
+
+  //! Evaluates input signatures without tensors or compilation. See
+  //! [ Batched Shape Evaluation ].
+  std::vector<SignatureEvaluation> evaluateSignatures(
+      const std::vector<std::vector<InputDescriptor>>& signatures,
+      int8_t device = 0);
+
   Fusion* fusion() {
     return fusion_.get();
   }
@@ -560,6 +1201,10 @@ class FusionExecutorCache {
       bool instrinsic_code = false) const;
   //! Get the most recently executed kernel code
   std::string getMostRecentCode(bool instrinsic_code = false) const;
+  //! Get the resources of the most recently executed kernels, one per
+  //! segment, see [ Kernel Resources ]
+  std::vector<FusionExecutor::KernelResources> getMostRecentKernelResources()
+      const;
   //! Get the kernel code for the given inputs
   std::string getCodeFor(
       const at::ArrayRef<c10::IValue>& inputs,
@@ -616,6 +1261,25 @@ class FusionExecutorCache {
     return runtimes;
   }
 
+  //! Number of loaded kernel modules of the compiled runtimes and the size
+  //! of their binaries in bytes
+  std::pair<size_t, size_t> loadedModules() const;
+
+  //! Share kernel runtimes among inputs whose extents fall into the same
+  //! bucket. See [ Shape Buckets ].
+  void setShapeBuckets(const ShapeBuckets& shape_buckets);
+
+  const ShapeBuckets& shapeBuckets() const {
+    return shape_buckets_;
+  }
+
+  //! Host input bytes of each tile of runs on host tensors. See
+  //! [ Host Streaming ].
+  void setHostStreamingTileBytes(int64_t tile_bytes) {
+    NVF_CHECK(tile_bytes > 0, "Tiles must have a positive size");
+    host_streaming_tile_bytes_ = tile_bytes;
+  }
+
   void profile(bool to_profile) {
     profiling_ = to_profile;
     for (auto& it : kernel_runtimes_) {
@@ -625,6 +1289,19 @@ class FusionExecutorCache {
     }
   }
 
+  //! Compiles of the kernels of this fusion are run before the ones of
+  //! fusions of lower priority, e.g., so that a service compiles its hot
+  //! fusions first. See [ Compile Thread Pool ].
+  void setCompilePriority(int64_t priority) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    compile_priority_ = priority;
+    for (auto& it : kernel_runtimes_) {
+      for (auto& kernel_runtime : it.second) {
+        kernel_runtime->setCompilePriority(priority);
+      }
+    }
+  }
+
   //! Internal knob for profiling shape inference
   void disableLaunchParamCache() {
     for (auto& it : kernel_runtimes_) {
@@ -661,6 +1338,11 @@ class FusionExecutorCache {
     return rt->kernelTimeMs();
   }
 
+  //! Counters of the runs of this fusion. See [ Fusion Telemetry ].
+  FusionTelemetry& telemetry() {
+    return telemetry_;
+  }
+
   //! Serialize Fusion Executor Cache using flatbuffers
   flatbuffers::Offset<serde::FusionExecutorCache> serialize(
       flatbuffers::FlatBufferBuilder& builder) const;
@@ -692,6 +1374,50 @@ class FusionExecutorCache {
   //! finalized.
   DynamicTransformInitialInfo& initialInfo();
 
+  //! Encode the values that inputs give to the root dynamic Vals of
+  //! initial_info, which determine the concretization. Returns nullopt if
+  //! they can't be read from the inputs directly.
+  std::optional<std::string> getRootDynamicValsKey(
+      const DynamicTransformInitialInfo& initial_info,
+      const KernelArgumentHolder& args) const;
+
+  //! runFusionWithInputs without considering chunking
+  std::vector<at::Tensor> runUnchunked(
+      const at::ArrayRef<c10::IValue>& inputs,
+      std::optional<PrimDataType> forced_index_type,
+      std::optional<int8_t> selected_device,
+      const std::vector<at::Tensor>& preallocated_outputs);
+
+  //! Run the fusion on host tensors, see [ Host Streaming ]
+  std::vector<at::Tensor> runStreamed(
+      const at::ArrayRef<c10::IValue>& inputs,
+      std::optional<PrimDataType> forced_index_type,
+      std::optional<int8_t> selected_device,
+      const std::vector<at::Tensor>& preallocated_outputs);
+
+  //! The inputs sliced by chunked execution, which must be called holding
+  //! mutex_. See [ Chunked Execution ].
+  const std::vector<bool>& getChunkedInputs();
+
+  //! Run the fusion in slices of its outer dimension if its predicted peak
+  //! memory exceeds the budget. Returns nullopt if the fusion can't be or
+  //! doesn't need to be chunked. See [ Chunked Execution ].
+  std::optional<std::vector<at::Tensor>> runChunked(
+      const at::ArrayRef<c10::IValue>& inputs,
+      std::optional<PrimDataType> forced_index_type,
+      std::optional<int8_t> selected_device);
+
+  //! Count the lookup of the runtime of the current run
+  void recordRuntimeLookup(FusionTelemetry::RuntimeLookup lookup);
+
+  //! Check if the extents of this fusion may be rounded up to shape buckets
+  bool canBucketShapes();
+
+  //! Metadata of the given inputs with their extents rounded up to shape
+  //! buckets. Returns nullopt if the inputs can't be bucketed.
+  std::optional<KernelArgumentHolder> getBucketedArgs(
+      const KernelArgumentHolder& args);
+
  private:
   //! original un-scheduled `Fusion`. This may contain dynamic transforms and
   //! Symbolic IterDomains.
@@ -723,6 +1449,10 @@ class FusionExecutorCache {
       cached_initial_info_;
   std::vector<std::unique_ptr<DynamicTransformConcretizationInfo>>
       cached_conc_info_;
+  //! Memoizes the concretization info of each getRootDynamicValsKey, so the
+  //! dynamic ops aren't analyzed again for inputs of a known key
+  std::unordered_map<std::string, DynamicTransformConcretizationInfo*>
+      conc_info_by_root_vals_;
   //! Map each pair of device_id and concretization info to an integer id
   std::unordered_map<ConcreteInfo, int64_t, PairPointerHash, PairPointerEquals>
       conc_info_id_map_;
@@ -733,6 +1463,9 @@ class FusionExecutorCache {
   //! Logging state for most recent compilation
   bool profiling_ = false;
 
+  //! Priority of the compiles of the kernel runtimes
+  int64_t compile_priority_ = 0;
+
   //! Flag to indicate kernel time measurement
   bool measure_kernel_time_ = false;
 
@@ -742,6 +1475,15 @@ class FusionExecutorCache {
   //! short-cut for cache hit
   std::unordered_map<size_t, FusionKernelRuntime*> id_to_kernel_runtime_;
 
+  //! See [ Shape Buckets ]
+  ShapeBuckets shape_buckets_;
+  std::optional<bool> can_bucket_shapes_;
+
+  //! Kernel runtimes keyed by the bucketed sizes and strides of the inputs,
+  //! the device and the forced index type
+  std::unordered_map<std::string, FusionKernelRuntime*>
+      bucket_to_kernel_runtime_;
+
   //! Profiling info:
   //! TODO: this can be largely expanded to look at complete
   //!   caching profiles. Currently it just makes it easier to test
@@ -750,6 +1492,25 @@ class FusionExecutorCache {
   //! Initial concretization info
   std::optional<DynamicTransformInitialInfo> initial_info_ = std::nullopt;
 
+  //! Which inputs are sliced by chunked execution, or empty if the fusion
+  //! can't be chunked. See [ Chunked Execution ].
+  std::optional<std::vector<bool>> chunked_inputs_;
+
+  //! Host input bytes of each tile of a streamed run. See
+  //! [ Host Streaming ].
+  int64_t host_streaming_tile_bytes_ = 64L << 20;
+
+  //! Guards the caches of runtimes in runFusionWithInputs. See
+  //! [ Concurrent Execution ].
+  mutable std::mutex mutex_;
+
+  FusionTelemetry telemetry_;
+
+  //! How getKernelRuntimeFor found the runtime of the current run. Guarded
+  //! by mutex_.
+  FusionTelemetry::RuntimeLookup most_recent_lookup_ =
+      FusionTelemetry::RuntimeLookup::Miss;
+
   // ID of fusion in python frontend fusion cache, which maps to a single
   // FusionExecutorCache.
   int64_t fusion_id_ = -1;
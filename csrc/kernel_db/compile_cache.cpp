@@ -0,0 +1,405 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <kernel_db/compile_cache.h>
+
+#include <instrumentation.h>
+#include <kernel_db/kernel_db.h>
+#include <kernel_db/utils.h>
+#include <options.h>
+#include <utils.h>
+
+#include <c10/util/Exception.h>
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+#include <thread>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace nvfuser {
+
+namespace {
+
+constexpr uint64_t kIndexMagic = 0x6e76664343616368; // "nvfCCach"
+constexpr uint64_t kIndexVersion = 1;
+constexpr int64_t kDefaultMaxMiB = 1024;
+
+// FNV-1a, continued from the given hash
+uint64_t fnv1a(const void* data, size_t size, uint64_t hash) {
+  const auto* bytes = static_cast<const unsigned char*>(data);
+  for (size_t i = 0; i < size; ++i) {
+    hash ^= bytes[i];
+    hash *= 0x100000001b3;
+  }
+  return hash;
+}
+
+} // namespace
+
+struct CompileCache::IndexHeader {
+  uint64_t magic;
+  uint64_t version;
+  uint64_t num_slots;
+  //! Sum of the entry sizes of all used slots
+  uint64_t total_bytes;
+  //! Logical clock incremented on every access, used for LRU eviction
+  uint64_t clock;
+};
+
+struct CompileCache::IndexSlot {
+  //! A zero key marks an unused slot
+  Key key;
+  uint64_t nbytes;
+  uint64_t last_use;
+};
+
+namespace {
+
+constexpr size_t indexFileSize() {
+  return sizeof(uint64_t) * 5 +
+      sizeof(uint64_t) * 4 * (size_t)CompileCache::kNumSlots;
+}
+
+} // namespace
+
+class CompileCache::IndexLock {
+ public:
+  explicit IndexLock(CompileCache& cache) : guard_(cache.mutex_) {
+#if defined(__linux__)
+    fd_ = cache.index_fd_;
+    NVF_ERROR(flock(fd_, LOCK_EX) == 0, "Failed to lock compile cache index");
+#endif
+  }
+
+  ~IndexLock() {
+#if defined(__linux__)
+    flock(fd_, LOCK_UN);
+#endif
+  }
+
+  IndexLock(const IndexLock&) = delete;
+  IndexLock& operator=(const IndexLock&) = delete;
+
+ private:
+  std::lock_guard<std::mutex> guard_;
+  int fd_ = -1;
+};
+
+CompileCache::CompileCache(const std::string& cache_dir, int64_t max_bytes)
+    : cache_dir_(cache_dir), max_bytes_(max_bytes) {
+  FUSER_PERF_SCOPE("CompileCache::open");
+  static_assert(sizeof(IndexHeader) == sizeof(uint64_t) * 5);
+  static_assert(sizeof(IndexSlot) == sizeof(uint64_t) * 4);
+#if defined(__linux__)
+  std::error_code error;
+  fs::create_directories(cache_dir_, error);
+  if (error) {
+    TORCH_WARN(
+        "Unable to create nvFuser compile cache directory ",
+        cache_dir_,
+        ": ",
+        error.message());
+    return;
+  }
+
+  const auto index_path = (fs::path(cache_dir_) / "index").string();
+  index_fd_ = ::open(index_path.c_str(), O_RDWR | O_CREAT, 0644);
+  if (index_fd_ < 0) {
+    TORCH_WARN("Unable to open nvFuser compile cache index ", index_path);
+    return;
+  }
+
+  {
+    IndexLock lock(*this);
+    struct stat st = {};
+    if (fstat(index_fd_, &st) != 0 ||
+        ((size_t)st.st_size != indexFileSize() &&
+         ftruncate(index_fd_, (off_t)indexFileSize()) != 0)) {
+      TORCH_WARN("Unable to resize nvFuser compile cache index ", index_path);
+      return;
+    }
+    void* index = mmap(
+        nullptr,
+        indexFileSize(),
+        PROT_READ | PROT_WRITE,
+        MAP_SHARED,
+        index_fd_,
+        0);
+    if (index == MAP_FAILED) {
+      TORCH_WARN("Unable to map nvFuser compile cache index ", index_path);
+      return;
+    }
+    index_ = index;
+
+    // A new index file is all zeros. An index written by a different version
+    // is reset, which orphans its entry files until they are overwritten.
+    auto header = static_cast<IndexHeader*>(index_);
+    if (header->magic != kIndexMagic || header->version != kIndexVersion ||
+        header->num_slots != (uint64_t)kNumSlots) {
+      std::memset(index_, 0, indexFileSize());
+      header->magic = kIndexMagic;
+      header->version = kIndexVersion;
+      header->num_slots = kNumSlots;
+    }
+  }
+#else
+  TORCH_WARN("nvFuser compile cache is only supported on Linux");
+#endif
+}
+
+CompileCache::~CompileCache() {
+#if defined(__linux__)
+  if (index_ != nullptr) {
+    munmap(index_, indexFileSize());
+  }
+  if (index_fd_ >= 0) {
+    close(index_fd_);
+  }
+#endif
+}
+
+CompileCache* CompileCache::get() {
+  if (!isOptionEnabled(EnableOption::CompileCache)) {
+    return nullptr;
+  }
+
+  static std::mutex get_mutex;
+  static std::unique_ptr<CompileCache> cache;
+  std::lock_guard<std::mutex> guard(get_mutex);
+  if (cache == nullptr) {
+    const auto& args = getEnableOptionArguments(EnableOption::CompileCache);
+    std::string cache_dir = !args.empty() && !args.at(0).empty()
+        ? args.at(0)
+        : (fs::temp_directory_path() / "nvfuser_compile_cache").string();
+    int64_t max_mib = kDefaultMaxMiB;
+    if (args.size() > 1) {
+      try {
+        max_mib = std::stoll(args.at(1));
+      } catch (const std::exception& e) {
+        TORCH_WARN(
+            "Invalid size for nvFuser compile cache, using ",
+            kDefaultMaxMiB,
+            " MiB: ",
+            args.at(1));
+      }
+    }
+    cache = std::make_unique<CompileCache>(cache_dir, max_mib << 20);
+  }
+  return cache->enabled() ? cache.get() : nullptr;
+}
+
+CompileCache::Key CompileCache::makeKey(
+    const std::string& src_code,
+    const std::string& compile_args,
+    int nvrtc_major,
+    int nvrtc_minor,
+    int arch_major,
+    int arch_minor,
+    bool compile_to_sass) {
+  // Two FNV-1a hashes with different offset bases. The sizes are hashed too
+  // so that the boundaries between the strings are unambiguous.
+  Key key = {0xcbf29ce484222325, 0x84222325cbf29ce4};
+  const std::array<int64_t, 7> header = {
+      (int64_t)src_code.size(),
+      (int64_t)compile_args.size(),
+      nvrtc_major,
+      nvrtc_minor,
+      arch_major,
+      arch_minor,
+      compile_to_sass};
+  for (auto& hash : key) {
+    hash = fnv1a(header.data(), sizeof(header), hash);
+    hash = fnv1a(src_code.data(), src_code.size(), hash);
+    hash = fnv1a(compile_args.data(), compile_args.size(), hash);
+  }
+  // Zero marks an unused slot
+  if (key[0] == 0 && key[1] == 0) {
+    key[1] = 1;
+  }
+  return key;
+}
+
+std::string CompileCache::toString(const Key& key) {
+  std::stringstream ss;
+  ss << std::hex << std::setfill('0') << std::setw(16) << key[0]
+     << std::setw(16) << key[1];
+  return ss.str();
+}
+
+CompileCache::IndexSlot* CompileCache::slots() const {
+  return reinterpret_cast<IndexSlot*>(static_cast<IndexHeader*>(index_) + 1);
+}
+
+std::string CompileCache::entryPath(const Key& key) const {
+  return (fs::path(cache_dir_) / (toString(key) + ".bin")).string();
+}
+
+void CompileCache::evictSlot(IndexSlot& slot) {
+  auto header = static_cast<IndexHeader*>(index_);
+  std::error_code error;
+  fs::remove(entryPath(slot.key), error);
+  header->total_bytes -= std::min(header->total_bytes, slot.nbytes);
+  std::memset(&slot, 0, sizeof(IndexSlot));
+}
+
+bool CompileCache::query(
+    const Key& key,
+    std::string& kernel_name,
+    std::vector<char>& binary) {
+  FUSER_PERF_SCOPE("CompileCache::query");
+  if (!enabled()) {
+    return false;
+  }
+
+  IndexLock lock(*this);
+  auto header = static_cast<IndexHeader*>(index_);
+  IndexSlot* end = slots() + kNumSlots;
+  IndexSlot* slot = std::find_if(
+      slots(), end, [&key](const IndexSlot& s) { return s.key == key; });
+  if (slot == end) {
+    return false;
+  }
+
+  // The entry file starts with the key and the kernel name. A file that
+  // doesn't match, e.g., because it was removed, invalidates the slot.
+  std::vector<char> contents;
+  const size_t prefix_size = sizeof(Key) + sizeof(uint64_t);
+  if (!copy_from_binary_file(entryPath(key), contents) ||
+      contents.size() < prefix_size) {
+    evictSlot(*slot);
+    return false;
+  }
+  Key file_key = {};
+  uint64_t name_size = 0;
+  std::memcpy(file_key.data(), contents.data(), sizeof(Key));
+  std::memcpy(&name_size, contents.data() + sizeof(Key), sizeof(name_size));
+  if (file_key != key || contents.size() < prefix_size + name_size) {
+    evictSlot(*slot);
+    return false;
+  }
+
+  kernel_name.assign(contents.data() + prefix_size, name_size);
+  binary.assign(
+      contents.begin() + (int64_t)(prefix_size + name_size), contents.end());
+  slot->last_use = ++header->clock;
+  return true;
+}
+
+bool CompileCache::write(
+    const Key& key,
+    const std::string& kernel_name,
+    const std::vector<char>& binary) {
+  FUSER_PERF_SCOPE("CompileCache::write");
+  if (!enabled()) {
+    return false;
+  }
+
+  std::vector<char> contents(sizeof(Key) + sizeof(uint64_t));
+  const uint64_t name_size = kernel_name.size();
+  std::memcpy(contents.data(), key.data(), sizeof(Key));
+  std::memcpy(contents.data() + sizeof(Key), &name_size, sizeof(name_size));
+  contents.insert(contents.end(), kernel_name.begin(), kernel_name.end());
+  contents.insert(contents.end(), binary.begin(), binary.end());
+  const auto nbytes = (uint64_t)contents.size();
+  if ((int64_t)nbytes > max_bytes_) {
+    return false;
+  }
+
+  // Write the entry file before taking the lock. Other processes only find
+  // it after the rename, which replaces the file atomically.
+  const auto path = entryPath(key);
+  std::stringstream tmp_path;
+  tmp_path << path << ".tmp";
+#if defined(__linux__)
+  tmp_path << "." << getpid();
+#endif
+  tmp_path << "." << std::hash<std::thread::id>{}(std::this_thread::get_id());
+  if (!copy_to_binary_file(tmp_path.str(), contents)) {
+    return false;
+  }
+  std::error_code error;
+  fs::rename(tmp_path.str(), path, error);
+  if (error) {
+    fs::remove(tmp_path.str(), error);
+    return false;
+  }
+
+  IndexLock lock(*this);
+  auto header = static_cast<IndexHeader*>(index_);
+  IndexSlot* end = slots() + kNumSlots;
+  IndexSlot* slot = std::find_if(
+      slots(), end, [&key](const IndexSlot& s) { return s.key == key; });
+  if (slot != end) {
+    // Written concurrently by another process
+    header->total_bytes -= std::min(header->total_bytes, slot->nbytes);
+    header->total_bytes += nbytes;
+    slot->nbytes = nbytes;
+    slot->last_use = ++header->clock;
+    return true;
+  }
+
+  // Evict least recently used entries until the new one fits
+  const Key unused = {0, 0};
+  while (true) {
+    IndexSlot* free_slot =
+        std::find_if(slots(), end, [&unused](const IndexSlot& s) {
+          return s.key == unused;
+        });
+    if (free_slot != end &&
+        header->total_bytes + nbytes <= (uint64_t)max_bytes_) {
+      slot = free_slot;
+      break;
+    }
+    IndexSlot* lru = nullptr;
+    for (IndexSlot* s = slots(); s != end; ++s) {
+      if (s->key != unused && (lru == nullptr || s->last_use < lru->last_use)) {
+        lru = s;
+      }
+    }
+    NVF_ERROR(lru != nullptr, "Compile cache index is inconsistent");
+    evictSlot(*lru);
+  }
+
+  slot->key = key;
+  slot->nbytes = nbytes;
+  slot->last_use = ++header->clock;
+  header->total_bytes += nbytes;
+  return true;
+}
+
+int64_t CompileCache::numEntries() {
+  if (!enabled()) {
+    return 0;
+  }
+  IndexLock lock(*this);
+  const Key unused = {0, 0};
+  return std::count_if(
+      slots(), slots() + kNumSlots, [&unused](const IndexSlot& s) {
+        return s.key != unused;
+      });
+}
+
+int64_t CompileCache::totalBytes() {
+  if (!enabled()) {
+    return 0;
+  }
+  IndexLock lock(*this);
+  return (int64_t) static_cast<IndexHeader*>(index_)->total_bytes;
+}
+
+} // namespace nvfuser
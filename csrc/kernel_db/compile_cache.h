@@ -0,0 +1,129 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace nvfuser {
+
+//! [ Persistent Compile Cache ]
+//!
+//! CompileCache keeps compiled kernels on disk so that other processes, or
+//! the same program run again, don't need to invoke NVRTC for a kernel that
+//! has been compiled before. It is enabled with
+//! NVFUSER_ENABLE=compile_cache(<directory>,<max size in MiB>), where both
+//! arguments are optional.
+//!
+//! Entries are content-addressed: the key is a 128-bit hash of everything
+//! that determines the compiled binary, i.e., the full source code, the
+//! compile options, the NVRTC version, the target architecture and whether
+//! the binary is a cubin or PTX. The binary of each entry is stored in its
+//! own file named after the key.
+//!
+//! All entries are tracked by a single index file with a fixed number of
+//! slots, which each process maps into memory. Every access to the index is
+//! done while holding an exclusive flock on it, so concurrent processes see
+//! a consistent index. Entry files are written to a temporary file first and
+//! then renamed, so a reader never sees a partially written binary. When the
+//! total size of the binaries would exceed the limit, or all slots are
+//! used, the least recently used entries are evicted.
+//!
+//! This is only supported on Linux. Errors are reported as warnings and make
+//! lookups miss, so that kernels are compiled as usual.
+class CompileCache {
+ public:
+  using Key = std::array<uint64_t, 2>;
+
+  //! Opens the cache in the given directory, creating it if necessary. Use
+  //! enabled() to check if that succeeded.
+  CompileCache(const std::string& cache_dir, int64_t max_bytes);
+  ~CompileCache();
+
+  CompileCache(const CompileCache&) = delete;
+  CompileCache& operator=(const CompileCache&) = delete;
+
+  //! Returns the cache configured by EnableOption::CompileCache, or nullptr
+  //! if it is not enabled or could not be opened
+  static CompileCache* get();
+
+  //! Hash everything that determines the compiled binary into a key
+  static Key makeKey(
+      const std::string& src_code,
+      const std::string& compile_args,
+      int nvrtc_major,
+      int nvrtc_minor,
+      int arch_major,
+      int arch_minor,
+      bool compile_to_sass);
+
+  //! Key formatted as a hex string, used as the name of the entry file
+  static std::string toString(const Key& key);
+
+  bool enabled() const {
+    return index_ != nullptr;
+  }
+
+  //! Looks up a compiled kernel and marks it as most recently used. Returns
+  //! false if there is no entry for the key.
+  bool query(
+      const Key& key,
+      std::string& kernel_name,
+      std::vector<char>& binary);
+
+  //! Adds a compiled kernel, evicting least recently used entries if
+  //! needed. Returns false if the entry could not be written.
+  bool write(
+      const Key& key,
+      const std::string& kernel_name,
+      const std::vector<char>& binary);
+
+  //! Number of entries in the index
+  int64_t numEntries();
+
+  //! Total size of the binaries of all entries in bytes
+  int64_t totalBytes();
+
+  int64_t maxBytes() const {
+    return max_bytes_;
+  }
+
+  //! Number of slots in the index, which is the maximum number of entries
+  static constexpr int64_t kNumSlots = 4096;
+
+ private:
+  struct IndexHeader;
+  struct IndexSlot;
+
+  //! Holds the flock on the index file for the duration of an access
+  class IndexLock;
+
+  IndexSlot* slots() const;
+
+  //! Removes the entry in the slot and its file
+  void evictSlot(IndexSlot& slot);
+
+  std::string entryPath(const Key& key) const;
+
+ private:
+  std::string cache_dir_;
+  int64_t max_bytes_ = 0;
+
+  //! File descriptor and memory mapping of the index file
+  int index_fd_ = -1;
+  void* index_ = nullptr;
+
+  //! flock is per open file description, so threads of this process have to
+  //! be serialized separately
+  std::mutex mutex_;
+};
+
+} // namespace nvfuser
@@ -5,6 +5,7 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 // clang-format on
+#include <fstream>
 #include <mutex>
 #include <regex>
 
@@ -14,10 +15,57 @@
 #include <options.h>
 #include <utils.h>
 
+#if defined(__linux__)
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#endif
+
 namespace nvfuser {
 
 static std::mutex kernel_db_lock;
 
+namespace {
+
+const std::string kDbHeader(
+    "kernel_signature,compile_args,kernel_code_file,cubin_file");
+
+// Holds an flock on the lock file next to the CSV file for the duration of
+// an access, which serializes the processes sharing the db. See
+// [ Shared Kernel DB ].
+class DbFileLock {
+ public:
+  DbFileLock(const fs::path& lock_file, bool exclusive) {
+#if defined(__linux__)
+    fd_ = ::open(lock_file.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd_ >= 0 && flock(fd_, exclusive ? LOCK_EX : LOCK_SH) != 0) {
+      close(fd_);
+      fd_ = -1;
+    }
+    if (fd_ < 0) {
+      TORCH_WARN("Kernel DB: Unable to lock ", lock_file.string());
+    }
+#endif
+  }
+
+  ~DbFileLock() {
+#if defined(__linux__)
+    if (fd_ >= 0) {
+      flock(fd_, LOCK_UN);
+      close(fd_);
+    }
+#endif
+  }
+
+  DbFileLock(const DbFileLock&) = delete;
+  DbFileLock& operator=(const DbFileLock&) = delete;
+
+ private:
+  int fd_ = -1;
+};
+
+} // namespace
+
 KernelDb::KernelDb(bool _disabled)
     : disabled_(_disabled),
       initialized_(false),
@@ -25,14 +73,21 @@ KernelDb::KernelDb(bool _disabled)
       kernel_db_path_(),
       kernel_db_txt_file_() {}
 
+fs::path KernelDb::defaultDirectory() {
+  const auto& args = getEnableOptionArguments(EnableOption::KernelDb);
+  if (!args.empty() && !args.at(0).empty()) {
+    return fs::path(args.at(0));
+  }
+  return fs::temp_directory_path() / "nvfuser_kernel_db";
+}
+
 KernelDb& KernelDb::get() {
-  const std::string kernel_db_dir = "nvfuser_kernel_db";
   const std::string kernel_db_file = "db.csv";
 
   return get(
-      kernel_db_dir,
+      defaultDirectory().string(),
       kernel_db_file,
-      true,
+      false,
       !isOptionEnabled(EnableOption::KernelDb),
       false);
 }
@@ -55,6 +110,9 @@ KernelDb& KernelDb::get(
     singleton.kernel_map_.clear();
     singleton.kernel_db_path_.clear();
     singleton.kernel_db_txt_file_.clear();
+    singleton.kernel_db_lock_file_.clear();
+    singleton.kernel_db_txt_offset_ = 0;
+    singleton.num_db_txt_entries_ = 0;
   }
 
   singleton.disabled_ = disabled;
@@ -84,8 +142,6 @@ bool KernelDb::open(
     const std::string& kernel_db_file,
     bool use_temp_dir) {
   FUSER_PERF_SCOPE("KernelDb::open");
-  const std::string header(
-      "kernel_signature,compile_args,kernel_code_file,cubin_file");
 
   // The KernelDb directory is queried and created if it doesn't exist
   {
@@ -97,7 +153,7 @@ bool KernelDb::open(
     }
     if (!fs::is_directory(kernel_db_path_)) {
       try {
-        fs::create_directory(kernel_db_path_);
+        fs::create_directories(kernel_db_path_);
       } catch (const std::exception& e) {
         TORCH_WARN(
             "Unable to create nvFuser Kernel DB directory! ",
@@ -108,66 +164,28 @@ bool KernelDb::open(
     }
   }
 
+  kernel_db_txt_file_ = kernel_db_path_ / kernel_db_file;
+  kernel_db_lock_file_ = kernel_db_path_ / (kernel_db_file + ".lock");
+  DbFileLock lock(kernel_db_lock_file_, /*exclusive=*/true);
+
   // The CSV file that captures the db is read if it exists
   {
     FUSER_PERF_SCOPE("KernelDb::open::read_db_txt_file");
 
-    kernel_db_txt_file_ = kernel_db_path_ / kernel_db_file;
     if (fs::is_regular_file(kernel_db_txt_file_)) {
       std::ifstream in_file(kernel_db_txt_file_.c_str(), std::ios::in);
-      if (in_file) {
-        bool matched_header = false;
-        bool read_db_file = true;
-        // kernel_signature
-        //  --- Group 1: any word character and dash
-        // compile_args
-        //  --- Group 2: any word character, space, plus, dash and equals
-        // kernel_code_file
-        //  --- Group 3: [any word character, dash and slash].cu
-        // cubin_file
-        //  --- Group 4: [any word character, dash and slash].cubin
-        std::regex db_line_regex(
-            R"(^([\w-]+),([\w \+\-\=]+),([\w\-\/]+\.cu),([\w\-\/]+\.cubin)$)");
-        for (std::string line; std::getline(in_file, line);) {
-          if (!matched_header) {
-            if (line.compare(header) == 0) {
-              matched_header = true;
-            } else {
-              // Header is corrupted or badly formed
-              TORCH_WARN(
-                  "Kernel DB: CSV file header is corrupted or badly formed - Resetting!: ",
-                  line);
-              read_db_file = false;
-              break;
-            }
-          } else {
-            std::smatch db_line_match;
-            if (std::regex_match(line, db_line_match, db_line_regex)) {
-              if (db_line_match.size() == 5) {
-                KernelDbEntry temp{
-                    db_line_match[1],
-                    db_line_match[2],
-                    db_line_match[3],
-                    db_line_match[4]};
-
-                fs::path code_path = kernel_db_path_ / temp.kernel_code_file;
-                std::string code;
-                if (copy_from_text_file(code_path.string(), code)) {
-                  kernel_map_[code] = temp;
-                } else {
-                  TORCH_WARN(
-                      "Kernel DB: Unable to copy cuda file: ",
-                      code_path.string());
-                }
-              }
-            } else {
-              TORCH_WARN("Kernel DB: CSV line Doesn't match: ", line);
-            }
-          }
-        }
-        if (read_db_file) {
+      std::string line;
+      if (in_file && std::getline(in_file, line)) {
+        if (line.compare(kDbHeader) == 0) {
+          kernel_db_txt_offset_ = line.size() + 1;
+          in_file.close();
+          readNewEntries();
           return true;
         }
+        // Header is corrupted or badly formed
+        TORCH_WARN(
+            "Kernel DB: CSV file header is corrupted or badly formed - Resetting!: ",
+            line);
       }
     }
   }
@@ -190,22 +208,84 @@ bool KernelDb::open(
   {
     FUSER_PERF_SCOPE("KernelDb::open::create_db_txt_file");
 
-    if (copy_to_text_file(kernel_db_txt_file_, header + "\n")) {
+    if (copy_to_text_file(kernel_db_txt_file_, kDbHeader + "\n")) {
+      kernel_db_txt_offset_ = kDbHeader.size() + 1;
       return true;
     }
   }
   return false;
 }
 
+void KernelDb::readNewEntries() {
+  FUSER_PERF_SCOPE("KernelDb::readNewEntries");
+  std::ifstream in_file(kernel_db_txt_file_.c_str(), std::ios::in);
+  if (!in_file) {
+    return;
+  }
+  in_file.seekg((std::streamoff)kernel_db_txt_offset_);
+
+  // kernel_signature
+  //  --- Group 1: any word character and dash
+  // compile_args
+  //  --- Group 2: any word character, space, plus, dash and equals
+  // kernel_code_file
+  //  --- Group 3: [any word character, dash and slash].cu
+  // cubin_file
+  //  --- Group 4: [any word character, dash and slash].cubin
+  static const std::regex db_line_regex(
+      R"(^([\w-]+),([\w \+\-\=]+),([\w\-\/]+\.cu),([\w\-\/]+\.cubin)$)");
+  for (std::string line; std::getline(in_file, line);) {
+    // Entries are appended under the lock, so a line without a newline was
+    // left by a writer that did not finish
+    if (in_file.eof()) {
+      break;
+    }
+    kernel_db_txt_offset_ += line.size() + 1;
+    ++num_db_txt_entries_;
+
+    std::smatch db_line_match;
+    if (std::regex_match(line, db_line_match, db_line_regex)) {
+      if (db_line_match.size() == 5) {
+        KernelDbEntry temp{
+            db_line_match[1],
+            db_line_match[2],
+            db_line_match[3],
+            db_line_match[4]};
+
+        fs::path code_path = kernel_db_path_ / temp.kernel_code_file;
+        std::vector<char> code;
+        if (copy_from_binary_file(code_path.string(), code) &&
+            maybe_decompress_binary(code)) {
+          kernel_map_.emplace(std::string(code.begin(), code.end()), temp);
+        } else {
+          TORCH_WARN(
+              "Kernel DB: Unable to copy cuda file: ", code_path.string());
+        }
+      }
+    } else {
+      TORCH_WARN("Kernel DB: CSV line Doesn't match: ", line);
+    }
+  }
+}
+
 bool KernelDb::query(
     const std::string& kernel_code,
     const std::string& compile_args,
     std::string& kernel_signature,
-    std::vector<char>& cubin) const {
+    std::vector<char>& cubin) {
   FUSER_PERF_SCOPE("KernelDb::query");
+  std::lock_guard<std::mutex> guard(kernel_db_lock);
   bool status = false;
   auto db_entry = kernel_map_.find(kernel_code);
 
+  // The kernel may have been written by another process since the CSV file
+  // was last read
+  if (db_entry == kernel_map_.end()) {
+    DbFileLock lock(kernel_db_lock_file_, /*exclusive=*/false);
+    readNewEntries();
+    db_entry = kernel_map_.find(kernel_code);
+  }
+
   // Kernel Match is found
   if (db_entry != kernel_map_.end()) {
     // Make sure the compilation args also match
@@ -213,7 +293,8 @@ bool KernelDb::query(
       // Copy the cubin to a data buffer and record the kernel name for module
       // loading
       fs::path cubin_file_path = kernel_db_path_ / db_entry->second.cubin_file;
-      if (copy_from_binary_file(cubin_file_path.string(), cubin)) {
+      if (copy_from_binary_file(cubin_file_path.string(), cubin) &&
+          maybe_decompress_binary(cubin)) {
         kernel_signature = db_entry->second.kernel_signature;
         status = true;
       }
@@ -231,19 +312,22 @@ bool KernelDb::write(
     const std::vector<char>& cubin) {
   FUSER_PERF_SCOPE("KernelDb::write");
   std::lock_guard<std::mutex> guard(kernel_db_lock);
+  DbFileLock lock(kernel_db_lock_file_, /*exclusive=*/true);
 
-  // Short-circuit path if kernel already exist in database.
+  // Short-circuit path if kernel already exist in database, which includes
+  // the kernels written by other processes.
   // Only return false if it does not already exist in the database and we fail
   // to add kernel to database.
+  readNewEntries();
   if (kernel_map_.count(kernel_code) > 0) {
     return true;
   }
 
   // If the kernel doesn't already exist in the hash map, add it.
   // The cubin and kernel code files are given a unique number based on the
-  // size of the hash map.
+  // number of entries in the CSV file.
   std::string kernel_num =
-      std::to_string(static_cast<unsigned long>(kernel_map_.size()));
+      std::to_string(static_cast<unsigned long>(num_db_txt_entries_));
 
   // Kernel Code File path
   std::string code_file_name("kernel_" + kernel_num + ".cu");
@@ -253,12 +337,26 @@ bool KernelDb::write(
   std::string cubin_file_name("kernel_" + kernel_num + ".cubin");
   fs::path cubin_file_path = kernel_db_path_ / cubin_file_name;
 
-  // Copy kernel code to file
-  bool status = copy_to_text_file(code_file_path.string(), kernel_code);
+  // Copy kernel code to file, compressed if requested. See
+  // [ Compressed Kernel Binaries ]
+  bool status = false;
+  std::vector<char> compressed_code;
+  std::vector<char> compressed_cubin;
+  if (isOptionEnabled(EnableOption::CompressKernelBinaries) &&
+      compress_binary(
+          std::vector<char>(kernel_code.begin(), kernel_code.end()),
+          compressed_code) &&
+      compress_binary(cubin, compressed_cubin)) {
+    status = copy_to_binary_file(code_file_path.string(), compressed_code);
+  } else {
+    status = copy_to_text_file(code_file_path.string(), kernel_code);
+  }
 
   // If the kernel code copy was successful, copy the cubin to file
   if (status) {
-    status = copy_to_binary_file(cubin_file_path.string(), cubin);
+    status = copy_to_binary_file(
+        cubin_file_path.string(),
+        compressed_cubin.empty() ? cubin : compressed_cubin);
   }
 
   // If both files were created successfully, add an entry to the CSV file
@@ -267,6 +365,10 @@ bool KernelDb::write(
     entry += "," + compile_args + "," + code_file_name + "," + cubin_file_name +
         "\n";
     status = append_to_text_file(kernel_db_txt_file_.string(), entry);
+    if (status) {
+      kernel_db_txt_offset_ += entry.size();
+      ++num_db_txt_entries_;
+    }
   }
 
   // If writing both files and adding an entry the CSV file was successful,
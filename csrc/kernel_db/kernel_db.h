@@ -41,6 +41,18 @@ struct KernelDbEntry {
 //! KernelDb class is a singleton structure that is used to open, query, and
 //! write to the the database that is held in a hash map.  The kernel code is
 //! used as string key to the hash map.
+//!
+//! [ Shared Kernel DB ]
+//!
+//! The processes of a node, e.g., the workers of an inference service, can
+//! share a db by passing the same directory to
+//! NVFUSER_ENABLE=kernel_db(<directory>). The serialized FusionCache is
+//! then stored in that directory too. Every access to the CSV file holds an
+//! flock on a lock file next to it: exclusive while opening and writing,
+//! shared while reading. A query that misses reads the entries appended by
+//! other processes since the CSV file was last read, and write reads them
+//! too, so that a kernel is only added once and the files of every entry
+//! are numbered after the entries of the CSV file.
 class KernelDb {
   KernelDb(bool _disabled);
 
@@ -56,6 +68,10 @@ class KernelDb {
   KernelDb(const KernelDb&) = delete;
   KernelDb& operator=(const KernelDb&) = delete;
 
+  //! Directory of the db opened by get(), which is the argument of
+  //! EnableOption::KernelDb if given. See [ Shared Kernel DB ].
+  static fs::path defaultDirectory();
+
   //! Thread-Safe method to get the Meyer's singleton -- Interface
   static KernelDb& get();
   //! Thread-Safe method to get the Meyer's singleton -- For testing
@@ -82,7 +98,7 @@ class KernelDb {
       const std::string& kernel_code,
       const std::string& compile_args,
       std::string& kernel_signature,
-      std::vector<char>& cubin) const;
+      std::vector<char>& cubin);
   //! Write is used to write a new entry to the db upon compilation of a
   //! new fusion
   bool write(
@@ -91,6 +107,11 @@ class KernelDb {
       const std::string& kernel_signature,
       const std::vector<char>& cubin);
 
+ private:
+  //! Adds the entries of the CSV file after kernel_db_txt_offset_. The lock
+  //! file must be held.
+  void readNewEntries();
+
  private:
   //! Disablement is specified by the user and can also be set by a
   //! failure to open the db
@@ -104,6 +125,13 @@ class KernelDb {
   fs::path kernel_db_path_;
   //! Full path to csv file used to record and restore the db
   fs::path kernel_db_txt_file_;
+  //! Full path to the file locked by every access to the csv file
+  fs::path kernel_db_lock_file_;
+  //! Size of the complete lines of the csv file that have been read
+  size_t kernel_db_txt_offset_ = 0;
+  //! Number of entries of the csv file that have been read, including the
+  //! ones that could not be restored
+  size_t num_db_txt_entries_ = 0;
 };
 
 } // namespace nvfuser
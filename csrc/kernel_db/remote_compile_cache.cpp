@@ -0,0 +1,281 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <kernel_db/remote_compile_cache.h>
+
+#include <instrumentation.h>
+#include <options.h>
+#include <utils.h>
+
+#include <c10/util/Exception.h>
+
+#include <cstring>
+#include <functional>
+#include <sstream>
+#include <thread>
+
+#if defined(__linux__)
+#include <unistd.h>
+#endif
+
+#ifdef USE_DISTRIBUTED
+#include <torch/csrc/distributed/c10d/TCPStore.hpp>
+#endif
+
+namespace nvfuser {
+
+namespace {
+
+constexpr int kDefaultPort = 29500;
+constexpr int64_t kDefaultTimeoutMs = 30000;
+
+[[maybe_unused]] std::string entryKey(const CompileCache::Key& key) {
+  return "nvfuser_compile_cache/" + CompileCache::toString(key);
+}
+
+[[maybe_unused]] std::string claimKey(const CompileCache::Key& key) {
+  return entryKey(key) + "/claim";
+}
+
+// An entry is the size of the kernel name, the kernel name and the binary
+[[maybe_unused]] std::vector<uint8_t> encodeEntry(
+    const std::string& kernel_name,
+    const std::vector<char>& binary) {
+  const uint64_t name_size = kernel_name.size();
+  std::vector<uint8_t> entry(sizeof(name_size));
+  std::memcpy(entry.data(), &name_size, sizeof(name_size));
+  entry.insert(entry.end(), kernel_name.begin(), kernel_name.end());
+  entry.insert(entry.end(), binary.begin(), binary.end());
+  return entry;
+}
+
+[[maybe_unused]] bool decodeEntry(
+    const std::vector<uint8_t>& entry,
+    std::string& kernel_name,
+    std::vector<char>& binary) {
+  uint64_t name_size = 0;
+  if (entry.size() < sizeof(name_size)) {
+    return false;
+  }
+  std::memcpy(&name_size, entry.data(), sizeof(name_size));
+  if (entry.size() < sizeof(name_size) + name_size) {
+    return false;
+  }
+  const auto name_begin = entry.begin() + (int64_t)sizeof(name_size);
+  const auto name_end = name_begin + (int64_t)name_size;
+  kernel_name.assign(name_begin, name_end);
+  binary.assign(name_end, entry.end());
+  return true;
+}
+
+std::string makeClientId() {
+  std::stringstream ss;
+#if defined(__linux__)
+  char hostname[256] = {}; // NOLINT (modernize-avoid-c-arrays)
+  gethostname(hostname, sizeof(hostname) - 1);
+  ss << hostname << ":" << getpid() << ":";
+#endif
+  ss << std::hash<std::thread::id>{}(std::this_thread::get_id());
+  return ss.str();
+}
+
+} // namespace
+
+struct RemoteCompileCache::Client {
+#ifdef USE_DISTRIBUTED
+  c10::intrusive_ptr<c10d::TCPStore> store;
+#endif
+};
+
+RemoteCompileCache::RemoteCompileCache(
+    const std::string& host,
+    int port,
+    int64_t timeout_ms)
+    : client_(std::make_unique<Client>()),
+      timeout_(timeout_ms),
+      client_id_(makeClientId()) {
+  FUSER_PERF_SCOPE("RemoteCompileCache::connect");
+#ifdef USE_DISTRIBUTED
+  c10d::TCPStoreOptions options;
+  options.port = (std::uint16_t)port;
+  options.isServer = false;
+  options.waitWorkers = false;
+  options.timeout = timeout_;
+  try {
+    client_->store = c10::make_intrusive<c10d::TCPStore>(host, options);
+  } catch (const std::exception& e) {
+    TORCH_WARN(
+        "Unable to connect to the nvFuser remote compile cache at ",
+        host,
+        ":",
+        port,
+        ", compiling locally: ",
+        e.what());
+  }
+#else
+  TORCH_WARN(
+      "nvFuser remote compile cache needs a build with USE_DISTRIBUTED, "
+      "compiling locally");
+#endif
+}
+
+RemoteCompileCache::~RemoteCompileCache() = default;
+
+RemoteCompileCache* RemoteCompileCache::get() {
+  if (!isOptionEnabled(EnableOption::RemoteCompileCache)) {
+    return nullptr;
+  }
+
+  static std::mutex get_mutex;
+  static std::unique_ptr<RemoteCompileCache> cache;
+  std::lock_guard<std::mutex> guard(get_mutex);
+  if (cache == nullptr) {
+    const auto& args =
+        getEnableOptionArguments(EnableOption::RemoteCompileCache);
+    std::string host = args.empty() ? "" : args.at(0);
+    int port = kDefaultPort;
+    const auto separator = host.rfind(':');
+    if (separator != std::string::npos) {
+      try {
+        port = std::stoi(host.substr(separator + 1));
+      } catch (const std::exception& e) {
+        TORCH_WARN(
+            "Invalid port for nvFuser remote compile cache, using ",
+            kDefaultPort,
+            ": ",
+            host);
+      }
+      host = host.substr(0, separator);
+    }
+    if (host.empty()) {
+      host = "localhost";
+    }
+    int64_t timeout_ms = kDefaultTimeoutMs;
+    if (args.size() > 1) {
+      try {
+        timeout_ms = std::stoll(args.at(1));
+      } catch (const std::exception& e) {
+        TORCH_WARN(
+            "Invalid timeout for nvFuser remote compile cache, using ",
+            kDefaultTimeoutMs,
+            " ms: ",
+            args.at(1));
+      }
+    }
+    cache = std::make_unique<RemoteCompileCache>(host, port, timeout_ms);
+  }
+  return cache->enabled() ? cache.get() : nullptr;
+}
+
+bool RemoteCompileCache::connected() const {
+#ifdef USE_DISTRIBUTED
+  return client_->store.defined();
+#else
+  return false;
+#endif
+}
+
+void RemoteCompileCache::disable(const std::exception& error) {
+  TORCH_WARN(
+      "nvFuser remote compile cache failed, compiling locally from now on: ",
+      error.what());
+#ifdef USE_DISTRIBUTED
+  client_->store.reset();
+#endif
+}
+
+bool RemoteCompileCache::enabled() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return connected();
+}
+
+bool RemoteCompileCache::query(
+    const Key& key,
+    std::string& kernel_name,
+    std::vector<char>& binary) {
+  FUSER_PERF_SCOPE("RemoteCompileCache::query");
+  std::lock_guard<std::mutex> guard(mutex_);
+  if (!connected()) {
+    return false;
+  }
+#ifdef USE_DISTRIBUTED
+  try {
+    if (!client_->store->check({entryKey(key)})) {
+      return false;
+    }
+    return decodeEntry(
+        client_->store->get(entryKey(key)), kernel_name, binary);
+  } catch (const std::exception& e) {
+    disable(e);
+  }
+#endif
+  return false;
+}
+
+bool RemoteCompileCache::claim(const Key& key) {
+  FUSER_PERF_SCOPE("RemoteCompileCache::claim");
+  std::lock_guard<std::mutex> guard(mutex_);
+  if (!connected()) {
+    return false;
+  }
+#ifdef USE_DISTRIBUTED
+  try {
+    // Sets the claim only if there is none, and returns the current one
+    const std::vector<uint8_t> id(client_id_.begin(), client_id_.end());
+    return client_->store->compareSet(claimKey(key), {}, id) == id;
+  } catch (const std::exception& e) {
+    disable(e);
+  }
+#endif
+  return false;
+}
+
+bool RemoteCompileCache::wait(const Key& key) {
+  FUSER_PERF_SCOPE("RemoteCompileCache::wait");
+#ifdef USE_DISTRIBUTED
+  // The other threads keep using the store while this one waits
+  c10::intrusive_ptr<c10d::TCPStore> store;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (!connected()) {
+      return false;
+    }
+    store = client_->store;
+  }
+  try {
+    store->wait({entryKey(key)}, timeout_);
+    return true;
+  } catch (const std::exception&) {
+    // The claiming client may have failed, the store is still usable
+    return false;
+  }
+#else
+  return false;
+#endif
+}
+
+bool RemoteCompileCache::write(
+    const Key& key,
+    const std::string& kernel_name,
+    const std::vector<char>& binary) {
+  FUSER_PERF_SCOPE("RemoteCompileCache::write");
+  std::lock_guard<std::mutex> guard(mutex_);
+  if (!connected()) {
+    return false;
+  }
+#ifdef USE_DISTRIBUTED
+  try {
+    client_->store->set(entryKey(key), encodeEntry(kernel_name, binary));
+    return true;
+  } catch (const std::exception& e) {
+    disable(e);
+  }
+#endif
+  return false;
+}
+
+} // namespace nvfuser
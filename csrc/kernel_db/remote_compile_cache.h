@@ -0,0 +1,108 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <kernel_db/compile_cache.h>
+
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace nvfuser {
+
+//! [ Remote Compile Cache ]
+//!
+//! The persistent compile cache, see [ Persistent Compile Cache ], only
+//! helps the processes of a node, so every new node or container of a fleet
+//! still compiles every kernel. RemoteCompileCache shares compiled kernels
+//! through a key-value store that all of them reach over the network. It is
+//! enabled with
+//!   NVFUSER_ENABLE=remote_compile_cache(<host>[:<port>],<timeout in ms>)
+//! where the store is a c10d::TCPStore server kept running, e.g., by a
+//! Python process holding
+//!   torch.distributed.TCPStore(
+//!       "0.0.0.0", 29500, is_master=True, wait_for_workers=False)
+//! The port defaults to 29500 and the timeout to 30s.
+//!
+//! Entries are content-addressed by the keys of the persistent compile
+//! cache, i.e., hashes of the full source, the compile options, the NVRTC
+//! version and the target architecture, so kernels are only shared between
+//! clients that would compile the same binary. A kernel missing from the
+//! store is compiled once across the fleet: the first client to claim its
+//! key compiles and writes it, and the others wait up to the timeout for
+//! the entry before compiling it themselves. Kernels fetched from the store
+//! are also written to the persistent compile cache, if it is enabled.
+//!
+//! Client errors are reported as warnings and disable the remote cache for
+//! the rest of the process, so kernels are compiled locally when the store
+//! is unreachable. This needs a build with USE_DISTRIBUTED.
+class RemoteCompileCache {
+ public:
+  using Key = CompileCache::Key;
+
+  //! Connects to the store at host:port, which enabled() reports the
+  //! success of
+  RemoteCompileCache(const std::string& host, int port, int64_t timeout_ms);
+  ~RemoteCompileCache();
+
+  RemoteCompileCache(const RemoteCompileCache&) = delete;
+  RemoteCompileCache& operator=(const RemoteCompileCache&) = delete;
+
+  //! Returns the cache configured by EnableOption::RemoteCompileCache, or
+  //! nullptr if it is not enabled or the store is unreachable
+  static RemoteCompileCache* get();
+
+  bool enabled();
+
+  //! Fetches a compiled kernel. Returns false if the store has no entry for
+  //! the key.
+  bool query(
+      const Key& key,
+      std::string& kernel_name,
+      std::vector<char>& binary);
+
+  //! Claims the compilation of a kernel missing from the store. Returns
+  //! false if another client claimed it first.
+  bool claim(const Key& key);
+
+  //! Waits up to the timeout for the entry of a kernel claimed by another
+  //! client. Returns false if it wasn't written in time.
+  bool wait(const Key& key);
+
+  //! Writes a compiled kernel. Returns false if it could not be written.
+  bool write(
+      const Key& key,
+      const std::string& kernel_name,
+      const std::vector<char>& binary);
+
+ private:
+  //! Whether the store is usable, with mutex_ held
+  bool connected() const;
+
+  //! Warns about a client error and stops using the store, with mutex_ held
+  void disable(const std::exception& error);
+
+ private:
+  //! Holds the store client, which only exists in builds with
+  //! USE_DISTRIBUTED
+  struct Client;
+  std::unique_ptr<Client> client_;
+
+  std::chrono::milliseconds timeout_;
+
+  //! Identifies the claims of this process
+  std::string client_id_;
+
+  std::mutex mutex_;
+};
+
+} // namespace nvfuser
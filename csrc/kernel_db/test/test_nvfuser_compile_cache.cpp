@@ -0,0 +1,148 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <gmock/gmock-matchers.h>
+#include <gtest/gtest.h>
+
+#include <kernel_db/compile_cache.h>
+#include <kernel_db/kernel_db.h>
+#include <kernel_db/remote_compile_cache.h>
+#include <test/utils.h>
+
+#ifdef USE_DISTRIBUTED
+#include <torch/csrc/distributed/c10d/TCPStore.hpp>
+#endif
+
+// RUN CMD: bin/test_jit --gtest_filter="NVFuserTest*CompileCache*"
+
+namespace nvfuser {
+
+TEST_F(NVFuserTest, CompileCache_CUDA) {
+  fs::path test_dir = fs::temp_directory_path() / "nvfuser_compile_cache_test";
+  fs::remove_all(test_dir);
+
+  // Room for two of the entries below, including the key and kernel name
+  // stored with each binary
+  const int64_t binary_size = 1000;
+  const int64_t max_bytes = 2 * binary_size + 200;
+
+  auto make_key = [](const std::string& code) {
+    return CompileCache::makeKey(
+        code, "--gpu-architecture=sm_80", 12, 1, 8, 0, true);
+  };
+  const auto key0 = make_key("kernel0");
+  const auto key1 = make_key("kernel1");
+  const auto key2 = make_key("kernel2");
+  EXPECT_NE(key0, key1);
+  // Every input is part of the key
+  EXPECT_NE(
+      key0,
+      CompileCache::makeKey(
+          "kernel0", "--gpu-architecture=sm_90", 12, 1, 8, 0, true));
+  EXPECT_NE(
+      key0,
+      CompileCache::makeKey(
+          "kernel0", "--gpu-architecture=sm_80", 12, 2, 8, 0, true));
+  EXPECT_NE(
+      key0,
+      CompileCache::makeKey(
+          "kernel0", "--gpu-architecture=sm_80", 12, 1, 9, 0, true));
+  EXPECT_NE(
+      key0,
+      CompileCache::makeKey(
+          "kernel0", "--gpu-architecture=sm_80", 12, 1, 8, 0, false));
+
+  {
+    CompileCache cache(test_dir.string(), max_bytes);
+    ASSERT_TRUE(cache.enabled());
+    EXPECT_EQ(cache.numEntries(), 0);
+
+    std::vector<char> binary(binary_size, 'a');
+    ASSERT_TRUE(cache.write(key0, "kernel0_name", binary));
+    binary.assign(binary_size, 'b');
+    ASSERT_TRUE(cache.write(key1, "kernel1_name", binary));
+    EXPECT_EQ(cache.numEntries(), 2);
+
+    // Makes key1 the least recently used entry
+    std::string kernel_name;
+    std::vector<char> result;
+    ASSERT_TRUE(cache.query(key0, kernel_name, result));
+    EXPECT_EQ(kernel_name, "kernel0_name");
+    EXPECT_EQ(result, std::vector<char>(binary_size, 'a'));
+
+    binary.assign(binary_size, 'c');
+    ASSERT_TRUE(cache.write(key2, "kernel2_name", binary));
+    EXPECT_EQ(cache.numEntries(), 2);
+    EXPECT_LE(cache.totalBytes(), max_bytes);
+    EXPECT_FALSE(cache.query(key1, kernel_name, result));
+  }
+
+  // A new instance, e.g., in another process, sees the same entries
+  {
+    CompileCache cache(test_dir.string(), max_bytes);
+    ASSERT_TRUE(cache.enabled());
+    EXPECT_EQ(cache.numEntries(), 2);
+
+    std::string kernel_name;
+    std::vector<char> result;
+    ASSERT_TRUE(cache.query(key2, kernel_name, result));
+    EXPECT_EQ(kernel_name, "kernel2_name");
+    EXPECT_EQ(result, std::vector<char>(binary_size, 'c'));
+    EXPECT_TRUE(cache.query(key0, kernel_name, result));
+    EXPECT_FALSE(cache.query(key1, kernel_name, result));
+
+    // A missing entry file invalidates the entry
+    fs::remove(test_dir / (CompileCache::toString(key0) + ".bin"));
+    EXPECT_FALSE(cache.query(key0, kernel_name, result));
+    EXPECT_EQ(cache.numEntries(), 1);
+  }
+
+  fs::remove_all(test_dir);
+}
+
+#ifdef USE_DISTRIBUTED
+TEST_F(NVFuserTest, RemoteCompileCache_CUDA) {
+  c10d::TCPStoreOptions options;
+  options.port = 0;
+  options.isServer = true;
+  options.waitWorkers = false;
+  c10d::TCPStore server("localhost", options);
+
+  const int64_t timeout_ms = 100;
+  RemoteCompileCache cache0("localhost", server.getPort(), timeout_ms);
+  RemoteCompileCache cache1("localhost", server.getPort(), timeout_ms);
+  ASSERT_TRUE(cache0.enabled());
+  ASSERT_TRUE(cache1.enabled());
+
+  const auto key = CompileCache::makeKey(
+      "kernel0", "--gpu-architecture=sm_80", 12, 1, 8, 0, true);
+  std::string kernel_name;
+  std::vector<char> result;
+  EXPECT_FALSE(cache0.query(key, kernel_name, result));
+
+  // Only the first client compiles the missing kernel, the other one gives
+  // up waiting after the timeout
+  EXPECT_TRUE(cache0.claim(key));
+  EXPECT_FALSE(cache1.claim(key));
+  EXPECT_FALSE(cache1.wait(key));
+  EXPECT_TRUE(cache1.enabled());
+
+  const std::vector<char> binary(1000, 'a');
+  ASSERT_TRUE(cache0.write(key, "kernel0_name", binary));
+  EXPECT_TRUE(cache1.wait(key));
+  ASSERT_TRUE(cache1.query(key, kernel_name, result));
+  EXPECT_EQ(kernel_name, "kernel0_name");
+  EXPECT_EQ(result, binary);
+
+  // An unreachable store leaves the cache disabled
+  RemoteCompileCache unreachable("localhost", 1, timeout_ms);
+  EXPECT_FALSE(unreachable.enabled());
+  EXPECT_FALSE(unreachable.query(key, kernel_name, result));
+}
+#endif
+
+} // namespace nvfuser
@@ -74,4 +74,87 @@ TEST_F(NVFuserTest, KernelDb_Write_CUDA) {
   }
 }
 
+// Entries appended to the CSV file by another process are found by queries
+// and are not overwritten by writes. See [ Shared Kernel DB ].
+TEST_F(NVFuserTest, KernelDb_Write_Shared_CUDA) {
+  fs::path test_data =
+      fs::path(__FILE__).parent_path() / "test_data/kernel_db_for_query_test";
+  ASSERT_TRUE(fs::is_directory(test_data));
+
+  const std::string kernel_db_dir("nvfuser_kernel_db_shared_test");
+  const std::string kernel_db_file("db.csv");
+  fs::path test_db_path = fs::temp_directory_path() / kernel_db_dir;
+  if (fs::is_directory(test_db_path)) {
+    fs::remove_all(test_db_path);
+  }
+
+  auto& kernel_db =
+      KernelDb::get(kernel_db_dir, kernel_db_file, true, false, true);
+  ASSERT_TRUE(kernel_db.enabled());
+  ASSERT_TRUE(kernel_db.size() == 0);
+
+  std::string code;
+  const std::string compile_args(
+      "--std=c++14 --gpu-architecture=sm_80 -default-device --fmad=true -DNDEBUG --ptxas-options --maxrregcount=255");
+  const std::string kernel_signature(
+      "_ZN76_GLOBAL__N__00000000_37___tmp_kernel_pointwise_f0_c1_r0_g0_cu_8995cef2_3255329nvfuser_pointwise_f0_c1_r0_g0ENS_6TensorIfLi2ELi2EEES1_S1_");
+  std::vector<char> cubin;
+  ASSERT_TRUE(copy_from_text_file(test_data / "kernel_0.cu", code));
+  ASSERT_TRUE(copy_from_binary_file(test_data / "kernel_0.cubin", cubin));
+
+  // Another process writes an entry after the db has been opened
+  ASSERT_TRUE(copy_to_text_file(test_db_path / "kernel_0.cu", code));
+  ASSERT_TRUE(copy_to_binary_file(test_db_path / "kernel_0.cubin", cubin));
+  ASSERT_TRUE(append_to_text_file(
+      test_db_path / kernel_db_file,
+      kernel_signature + "," + compile_args + ",kernel_0.cu,kernel_0.cubin\n"));
+
+  std::string queried_signature;
+  std::vector<char> queried_cubin;
+  ASSERT_TRUE(kernel_db.query(
+      code, compile_args, queried_signature, queried_cubin));
+  ASSERT_EQ(queried_signature, kernel_signature);
+  ASSERT_EQ(queried_cubin, cubin);
+  ASSERT_TRUE(kernel_db.size() == 1);
+
+  // A new kernel is numbered after the entries of the other process
+  const std::string other_code = code + "\n// Another kernel\n";
+  ASSERT_TRUE(
+      kernel_db.write(other_code, compile_args, kernel_signature, cubin));
+  ASSERT_TRUE(kernel_db.size() == 2);
+  ASSERT_TRUE(fs::is_regular_file(test_db_path / "kernel_1.cu"));
+  std::string first_code;
+  ASSERT_TRUE(copy_from_text_file(test_db_path / "kernel_0.cu", first_code));
+  ASSERT_EQ(first_code, code);
+
+  // Cleanup DB Directory
+  if (fs::is_directory(test_db_path)) {
+    fs::remove_all(test_db_path);
+  }
+}
+
+// Compressed blobs are decompressed on reading, and raw blobs are read as
+// is. See [ Compressed Kernel Binaries ].
+TEST_F(NVFuserTest, KernelDb_Write_Compressed_CUDA) {
+  fs::path test_data =
+      fs::path(__FILE__).parent_path() / "test_data/kernel_db_for_query_test";
+  ASSERT_TRUE(fs::is_directory(test_data));
+  std::vector<char> cubin;
+  ASSERT_TRUE(copy_from_binary_file(test_data / "kernel_0.cubin", cubin));
+
+  std::vector<char> raw = cubin;
+  ASSERT_FALSE(is_compressed_binary(raw.data(), raw.size()));
+  ASSERT_TRUE(maybe_decompress_binary(raw));
+  ASSERT_EQ(raw, cubin);
+
+  std::vector<char> compressed;
+  if (!compress_binary(cubin, compressed)) {
+    GTEST_SKIP() << "nvFuser is built without zstd";
+  }
+  ASSERT_TRUE(is_compressed_binary(compressed.data(), compressed.size()));
+  EXPECT_LT(compressed.size(), cubin.size());
+  ASSERT_TRUE(maybe_decompress_binary(compressed));
+  ASSERT_EQ(compressed, cubin);
+}
+
 } // namespace nvfuser
@@ -5,7 +5,16 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 // clang-format on
+#include <debug.h>
 #include <kernel_db/utils.h>
+#include <options.h>
+
+#ifdef NVFUSER_BUILD_WITH_ZSTD
+#include <zstd.h>
+#endif
+
+#include <cstdint>
+#include <cstring>
 #include <fstream>
 
 namespace nvfuser {
@@ -76,4 +85,85 @@ bool copy_to_text_file(const std::string& file_path, const std::string& src) {
   return status;
 }
 
+namespace {
+
+// The magic number and the uncompressed size in front of a zstd frame. See
+// [ Compressed Kernel Binaries ]
+constexpr char kCompressedMagic[8] = {'N', 'V', 'F', 'Z', 'S', 'T', 'D', '1'};
+constexpr size_t kCompressedHeaderSize = sizeof(kCompressedMagic) + 8;
+
+#ifdef NVFUSER_BUILD_WITH_ZSTD
+int compression_level() {
+  int level = 3;
+  const auto& args =
+      getEnableOptionArguments(EnableOption::CompressKernelBinaries);
+  if (!args.empty()) {
+    try {
+      level = (int)std::stoll(args.at(0));
+    } catch (const std::exception& e) {
+      debug() << "skip invalid argument for CompressKernelBinaries, arg = "
+              << args.at(0) << std::endl;
+    }
+  }
+  return level;
+}
+#endif
+
+} // namespace
+
+bool is_compressed_binary(const char* data, size_t size) {
+  return size >= kCompressedHeaderSize &&
+      std::memcmp(data, kCompressedMagic, sizeof(kCompressedMagic)) == 0;
+}
+
+bool compress_binary(const std::vector<char>& src, std::vector<char>& dst) {
+#ifdef NVFUSER_BUILD_WITH_ZSTD
+  std::vector<char> frame(
+      kCompressedHeaderSize + ZSTD_compressBound(src.size()));
+  const size_t frame_size = ZSTD_compress(
+      frame.data() + kCompressedHeaderSize,
+      frame.size() - kCompressedHeaderSize,
+      src.data(),
+      src.size(),
+      compression_level());
+  if (ZSTD_isError(frame_size)) {
+    return false;
+  }
+  std::memcpy(frame.data(), kCompressedMagic, sizeof(kCompressedMagic));
+  const uint64_t size = src.size();
+  std::memcpy(frame.data() + sizeof(kCompressedMagic), &size, sizeof(size));
+  frame.resize(kCompressedHeaderSize + frame_size);
+  dst = std::move(frame);
+  return true;
+#else
+  TORCH_WARN_ONCE(
+      "compress_kernel_binaries is ignored since nvFuser is built without ",
+      "zstd, see NVFUSER_BUILD_WITH_ZSTD");
+  return false;
+#endif
+}
+
+bool maybe_decompress_binary(std::vector<char>& data) {
+  if (!is_compressed_binary(data.data(), data.size())) {
+    return true;
+  }
+#ifdef NVFUSER_BUILD_WITH_ZSTD
+  uint64_t size = 0;
+  std::memcpy(&size, data.data() + sizeof(kCompressedMagic), sizeof(size));
+  std::vector<char> decompressed(size);
+  const size_t decompressed_size = ZSTD_decompress(
+      decompressed.data(),
+      decompressed.size(),
+      data.data() + kCompressedHeaderSize,
+      data.size() - kCompressedHeaderSize);
+  if (ZSTD_isError(decompressed_size) || decompressed_size != size) {
+    return false;
+  }
+  data = std::move(decompressed);
+  return true;
+#else
+  return false;
+#endif
+}
+
 } // namespace nvfuser
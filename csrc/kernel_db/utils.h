@@ -28,4 +28,27 @@ bool copy_to_binary_file(
     const std::vector<char>& dst);
 bool copy_to_text_file(const std::string& file_path, const std::string& src);
 
+//! [ Compressed Kernel Binaries ]
+//!
+//! Cubins, PTX and kernel code make up most of a serialized FusionCache and
+//! of a Kernel DB directory. With NVFUSER_ENABLE=compress_kernel_binaries,
+//! optionally compress_kernel_binaries(<zstd level>), they are written as
+//! zstd frames behind a header of a magic number and the uncompressed size.
+//! Readers recognize the header, so compressed and raw blobs can be mixed,
+//! and a build without zstd (NVFUSER_BUILD_WITH_ZSTD) writes raw blobs and
+//! only fails on reading compressed ones. The PTX of kernels with a cubin
+//! isn't serialized either, since deserialization only checks it for
+//! kernels that aren't compiled to SASS.
+
+//! Whether data starts with the header of compress_binary
+bool is_compressed_binary(const char* data, size_t size);
+
+//! Compresses src into dst. Returns false, leaving dst unchanged, if nvFuser
+//! is built without zstd or compression fails.
+bool compress_binary(const std::vector<char>& src, std::vector<char>& dst);
+
+//! Decompresses data in place if it was written by compress_binary. Returns
+//! false if it was, but can't be decompressed.
+bool maybe_decompress_binary(std::vector<char>& data);
+
 } // namespace nvfuser
@@ -401,18 +401,24 @@ std::string Asm::toInlineString(int indent_size) const {
 
 NVFUSER_DEFINE_CLONE_AND_CREATE(Asm)
 
-BlockSync::BlockSync(IrBuilderPasskey passkey, bool war_sync) : Expr(passkey) {
+BlockSync::BlockSync(IrBuilderPasskey passkey, bool war_sync, bool row_sync)
+    : Expr(passkey) {
   NVF_ERROR(passkey.ir_container_ != nullptr);
   NVF_ERROR(
       passkey.ir_container_->isA<kir::Kernel>(),
       "IR type only valid for Kernel container.");
   addDataAttribute(war_sync);
+  addDataAttribute(row_sync);
 }
 
 std::string BlockSync::toString(int indent_size) const {
   std::stringstream ss;
   indent(ss, indent_size) << "BLOCKSYNC(war_hazard="
-                          << boolLiteral(isWarHazardSync()) << ")\n";
+                          << boolLiteral(isWarHazardSync());
+  if (isRowSync()) {
+    ss << ", row_sync=true";
+  }
+  ss << ")\n";
   return ss.str();
 }
 
@@ -559,6 +565,51 @@ std::string MBarrierWait::toInlineString(int indent_size) const {
 
 NVFUSER_DEFINE_CLONE_AND_CREATE(MBarrierWait)
 
+MBarrierWaitParity::MBarrierWaitParity(
+    IrBuilderPasskey passkey,
+    Val* mbarrier,
+    Val* parity)
+    : Expr(passkey) {
+  NVF_ERROR(passkey.ir_container_ != nullptr);
+  NVF_CHECK(parity->dtype() == DataType::UInt32);
+  addInput(mbarrier);
+  addInput(parity);
+}
+
+std::string MBarrierWaitParity::toString(int indent_size) const {
+  std::stringstream ss;
+  indent(ss, indent_size) << "MBarrierWaitParity(" << mbarrier()->toString()
+                          << ", " << parity()->toString() << ")\n";
+  return ss.str();
+}
+
+std::string MBarrierWaitParity::toInlineString(int indent_size) const {
+  NVF_CHECK(false, "MBarrierWaitParity can not be printed inline");
+}
+
+NVFUSER_DEFINE_CLONE_AND_CREATE(MBarrierWaitParity)
+
+CpAsyncMBarrierArrive::CpAsyncMBarrierArrive(
+    IrBuilderPasskey passkey,
+    Val* mbarrier)
+    : Expr(passkey) {
+  NVF_ERROR(passkey.ir_container_ != nullptr);
+  addInput(mbarrier);
+}
+
+std::string CpAsyncMBarrierArrive::toString(int indent_size) const {
+  std::stringstream ss;
+  indent(ss, indent_size) << "CpAsyncMBarrierArrive(" << mbarrier()->toString()
+                          << ")\n";
+  return ss.str();
+}
+
+std::string CpAsyncMBarrierArrive::toInlineString(int indent_size) const {
+  NVF_CHECK(false, "CpAsyncMBarrierArrive can not be printed inline");
+}
+
+NVFUSER_DEFINE_CLONE_AND_CREATE(CpAsyncMBarrierArrive)
+
 BlockSerializeWait::BlockSerializeWait(
     IrBuilderPasskey passkey,
     ParallelTypeBitmap sync_dims,
@@ -743,6 +794,36 @@ std::string UpdateMagicZero::toInlineString(int indent_size) const {
 
 NVFUSER_DEFINE_CLONE_AND_CREATE(UpdateMagicZero)
 
+IncrementScalar::IncrementScalar(
+    IrBuilderPasskey passkey,
+    Val* scalar,
+    Val* increment)
+    : Expr(passkey) {
+  NVF_ERROR(passkey.ir_container_ != nullptr);
+  NVF_ERROR(
+      passkey.ir_container_->isA<kir::Kernel>(),
+      "IR type only valid for Kernel container.");
+  NVF_ERROR(
+      scalar->isScalar() && increment->isScalar(),
+      "Only scalars can be incremented: ",
+      scalar->toString());
+  addInput(scalar);
+  addInput(increment);
+}
+
+std::string IncrementScalar::toString(int indent_size) const {
+  std::stringstream ss;
+  indent(ss, indent_size) << scalar()->toString() << " += "
+                          << increment()->toInlineString() << ";\n";
+  return ss.str();
+}
+
+std::string IncrementScalar::toInlineString(int indent_size) const {
+  NVF_CHECK(false, "IncrementScalar can not be printed inline");
+}
+
+NVFUSER_DEFINE_CLONE_AND_CREATE(IncrementScalar)
+
 std::string Scope::toString(int indent_size) const {
   std::stringstream ss;
   for (auto expr : exprs()) {
@@ -1158,10 +1239,20 @@ std::string GridReduction::toString(int indent_size) const {
                           << ", initial value = " << init()->toString()
                           << ",\n";
   ++indent_size;
-  indent(ss, indent_size) << "reduction buffer = "
-                          << reduction_buffer()->buffer()->toString() << ",\n";
-  indent(ss, indent_size) << "sync buffer = "
-                          << sync_buffer()->buffer()->toString() << ",\n";
+  indent(ss, indent_size) << "reduction buffer = ";
+  if (reduction_buffer() != nullptr) {
+    ss << reduction_buffer()->buffer()->toString();
+  } else {
+    ss << "nullptr";
+  }
+  ss << ",\n";
+  indent(ss, indent_size) << "sync buffer = ";
+  if (sync_buffer() != nullptr) {
+    ss << sync_buffer()->buffer()->toString();
+  } else {
+    ss << "nullptr";
+  }
+  ss << ",\n";
   indent(ss, indent_size) << "read predicate = ";
   if (predicate() != nullptr) {
     ss << predicate()->toString();
@@ -1182,6 +1273,9 @@ std::string GridReduction::toString(int indent_size) const {
                           << (isAllreduce() ? "true" : "false") << " )\n";
   indent(ss, indent_size) << "serial reduction = "
                           << (isSerial() ? "true" : "false") << " )\n";
+  indent(ss, indent_size) << "atomic reduction = "
+                          << (atomicGridReductionRequested() ? "true" : "false")
+                          << " )\n";
   if (isSerial()) {
     indent(ss, indent_size)
         << "serial reduction tensor = " << serialReductionTensor()->toString()
@@ -1207,7 +1301,8 @@ GroupedGridReduction::GroupedGridReduction(
     Val* entrance_index,
     Val* entrances,
     Val* buffer_stride,
-    bool is_allreduce)
+    bool is_allreduce,
+    bool use_outer_opt)
     : GroupedReductionOp(
           passkey,
           std::move(reduction_op_types),
@@ -1231,6 +1326,32 @@ GroupedGridReduction::GroupedGridReduction(
   for (auto buffer : reduction_buffers) {
     addAttribute(buffer);
   }
+  addDataAttribute(use_outer_opt);
+}
+
+int GroupedGridReduction::getSmemBufferSize(int bdimx, int bdimy, int bdimz)
+    const {
+  NVF_ERROR(useOuterOpt());
+
+  int group_count = 1;
+  for (auto axis : ir_utils::getTvOutput(this)->getLeafDomain()) {
+    if (axis->getParallelType() == ParallelType::Group) {
+      group_count *= (int)axis->extent()->value();
+    }
+  }
+  NVF_ERROR(group_count > 1);
+
+  // The grouped reductions are done one by one, so the buffer is sized
+  // for the largest data type. The size is blockDim.x * NumberOfWarps *
+  // GroupCount, see blockReduceOuter.
+  int num_warps = bdimx * bdimy / 32;
+  NVF_ERROR((bdimx * bdimy) % 32 == 0);
+  int max_dtype_size = 0;
+  for (auto output : outputs()) {
+    max_dtype_size = std::max(
+        max_dtype_size, (int)dataTypeSize(output->getDataType().value()));
+  }
+  return bdimx * num_warps * group_count * max_dtype_size;
 }
 
 std::string GroupedGridReduction::toString(int indent_size) const {
@@ -1735,5 +1856,50 @@ std::string EncodeTensorMapTiled::toInlineString(int indent_size) const {
 
 NVFUSER_DEFINE_CLONE_AND_CREATE(EncodeTensorMapTiled)
 
+EncodeFastDivmod::EncodeFastDivmod(
+    IrBuilderPasskey passkey,
+    Val* multiplier,
+    Val* shift,
+    Val* divisor)
+    : Expr(passkey) {
+  NVF_ERROR(passkey.ir_container_ != nullptr);
+  NVF_ERROR(
+      passkey.ir_container_->isA<kir::Kernel>(),
+      "IR type only valid for Kernel container.");
+  NVF_ERROR(
+      multiplier->dtype() == DataType::Int ||
+          multiplier->dtype() == DataType::Int32,
+      "Unexpected type of the multiplier: ",
+      multiplier->dtype());
+  NVF_ERROR(shift->dtype() == multiplier->dtype());
+  NVF_ERROR(divisor->isIntegralScalar());
+  addOutput(multiplier);
+  addOutput(shift);
+  addInput(divisor);
+}
+
+std::string EncodeFastDivmod::toString(int indent_size) const {
+  std::stringstream ss;
+  indent(ss, indent_size) << "(" << multiplier()->toString() << ", "
+                          << shift()->toString() << ") = " << getOpString()
+                          << "(" << divisor()->toString() << ")\n";
+  return ss.str();
+}
+
+std::string EncodeFastDivmod::toInlineString(int indent_size) const {
+  return std::string(getOpString()) + "(" + divisor()->toInlineString() + ")";
+}
+
+std::vector<PolymorphicValue> EncodeFastDivmod::evaluate(
+    const ExpressionEvaluator& ee,
+    const std::vector<PolymorphicValue>& inputs) const {
+  auto [multiplier, shift] = getFastDivmodParams(
+      inputs.at(0).as<int64_t>(),
+      multiplier()->dtype() == DataType::Int32 ? 32 : 64);
+  return {PolymorphicValue(multiplier), PolymorphicValue(shift)};
+}
+
+NVFUSER_DEFINE_CLONE_AND_CREATE(EncodeFastDivmod)
+
 } // namespace kir
 } // namespace nvfuser
@@ -45,12 +45,15 @@ class MBarrierInvalidate;
 class MBarrierArrive;
 class MBarrierArriveExpectTx;
 class MBarrierWait;
+class MBarrierWaitParity;
+class CpAsyncMBarrierArrive;
 class BlockSerializeWait;
 class BlockSerializeRelease;
 class AsyncWait;
 class AsyncCommit;
 class InitMagicZero;
 class UpdateMagicZero;
+class IncrementScalar;
 class ForLoop;
 class IfThenElse;
 class GridReduction;
@@ -349,7 +352,10 @@ class BlockSync final : public Expr {
  public:
   using Expr::Expr;
 
-  explicit BlockSync(IrBuilderPasskey passkey, bool war_sync = false);
+  explicit BlockSync(
+      IrBuilderPasskey passkey,
+      bool war_sync = false,
+      bool row_sync = false);
 
   const char* getOpString() const override {
     return "BlockSync";
@@ -364,6 +370,12 @@ class BlockSync final : public Expr {
   bool isWarHazardSync() const {
     return attribute<bool>(0);
   }
+
+  //! Only synchronizes the threads with the same threadIdx.y and
+  //! threadIdx.z, see [ Row Barriers ]
+  bool isRowSync() const {
+    return attribute<bool>(1);
+  }
 };
 
 // Synchronize all blocks in device, implies cooperative group launch is
@@ -521,6 +533,58 @@ class MBarrierWait final : public Expr {
   }
 };
 
+// IR node for: mbarrier.try_wait.parity
+// Waits for the completion of the phase of the given parity instead of the
+// phase of an arrival state, so that threads can wait on an mbarrier without
+// having arrived at it.
+class MBarrierWaitParity final : public Expr {
+ public:
+  using Expr::Expr;
+  explicit MBarrierWaitParity(
+      IrBuilderPasskey passkey,
+      Val* mbarrier,
+      Val* parity);
+
+  NVFUSER_DECLARE_CLONE_AND_CREATE
+
+  const char* getOpString() const override {
+    return "MBarrierWaitParity";
+  }
+
+  std::string toString(int indent_size = 0) const override;
+  std::string toInlineString(int indent_size = 0) const override;
+
+  Val* mbarrier() const {
+    return input(0);
+  }
+
+  Val* parity() const {
+    return input(1);
+  }
+};
+
+// IR node for: cp.async.mbarrier.arrive.noinc
+// Arrives at the mbarrier once all prior cp.async operations of the thread
+// have completed.
+class CpAsyncMBarrierArrive final : public Expr {
+ public:
+  using Expr::Expr;
+  explicit CpAsyncMBarrierArrive(IrBuilderPasskey passkey, Val* mbarrier);
+
+  NVFUSER_DECLARE_CLONE_AND_CREATE
+
+  const char* getOpString() const override {
+    return "CpAsyncMBarrierArrive";
+  }
+
+  std::string toString(int indent_size = 0) const override;
+  std::string toInlineString(int indent_size = 0) const override;
+
+  Val* mbarrier() const {
+    return input(0);
+  }
+};
+
 // For all but first block in each reduction segment, first thread waits for
 // sync flag to indicate it is our turn to proceed (sync flag is incremented by
 // BlockSerializeRelease). Then block sync. This has the effect of
@@ -683,6 +747,37 @@ class UpdateMagicZero final : public Expr {
   std::string toInlineString(int indent_size = 0) const override;
 };
 
+// Adds an increment to an allocated scalar in place, i.e., prints
+// "scalar += increment;". The scalar is an input rather than an output, so
+// that its definition stays the computation of its initial value. See
+// [ Index Strength Reduction ] in scalar_hoist.h.
+class IncrementScalar final : public Expr {
+ public:
+  using Expr::Expr;
+
+  explicit IncrementScalar(
+      IrBuilderPasskey passkey,
+      Val* scalar,
+      Val* increment);
+
+  NVFUSER_DECLARE_CLONE_AND_CREATE
+
+  const char* getOpString() const override {
+    return "IncrementScalar";
+  }
+
+  std::string toString(int indent_size = 0) const override;
+  std::string toInlineString(int indent_size = 0) const override;
+
+  Val* scalar() const {
+    return input(0);
+  }
+
+  Val* increment() const {
+    return input(1);
+  }
+};
+
 // TODO(kir): promote to IR node
 class Scope {
  public:
@@ -947,8 +1042,39 @@ class IfThenElse final : public Expr {
 //!
 //! This node provides FusionExecutor the information it needs to allocate the
 //! reduction and sync buffers.
+//!
+//! [ Single-Pass Grid Reduction ]
+//!
+//! gridReduce writes the partial result of every block to the work buffer,
+//! and the last block of each reduction segment reduces all of them once the
+//! other blocks are done. For outer reductions across many blocks, that final
+//! pass over the buffer is on the critical path of the kernel, and the
+//! buffer grows with the number of blocks. When a non-allreduce ReductionOp
+//! has singlePassGridReductionRequested(), it is instead generated as
+//! gridReduceSinglePass, where the blocks of a segment combine their partial
+//! results into a single accumulator in the order of their index, each one
+//! as soon as its predecessor is done, and the last block writes the result.
+//! The block dimensions of the reduction are thus left out of the work
+//! buffer, and the result is deterministic. The reduction scheduler requests
+//! it for cross-grid outer reductions with
+//! NVFUSER_ENABLE=single_pass_grid_reduction. It isn't supported in
+//! cooperative kernels, where all grid reductions are persistent.
+//!
+//! [ Atomic Grid Reduction ]
+//!
+//! Sums that may be nondeterministic, like training metrics or gradient
+//! norms, don't need the partial results of the blocks to be combined in
+//! any particular order. When a non-allreduce ReductionOp has
+//! atomicGridReductionRequested(), it is generated as gridReduceAtomic,
+//! where each block reduces its values and then adds its partial result
+//! to the output with atomicAdd. There is no work buffer, no sync buffer
+//! and no last block, so reduction_buffer() and sync_buffer() are nullptr.
+//! The output must be a float or double fusion output in global memory,
+//! which FusionExecutor zero-initializes before the launch instead of the
+//! kernel initializing it. The reduction scheduler requests it for
+//! cross-grid sums with NVFUSER_ENABLE=atomic_grid_reduction.
 class GridReduction final : public ReductionOp {
-  static constexpr int num_reduction_op_attr = 3;
+  static constexpr int num_reduction_op_attr = 6;
 
  public:
   using ReductionOp::ReductionOp;
@@ -975,12 +1101,14 @@ class GridReduction final : public ReductionOp {
   std::string toString(int indent_size = 0) const override;
   std::string toInlineString(int indent_size = 0) const override;
 
+  //! nullptr for an atomic grid reduction
   Allocate* reduction_buffer() const {
-    return attribute(num_reduction_op_attr)->as<Allocate>();
+    return dynamic_cast<Allocate*>(attribute(num_reduction_op_attr));
   }
 
+  //! nullptr for an atomic grid reduction
   Allocate* sync_buffer() const {
-    return attribute(num_reduction_op_attr + 1)->as<Allocate>();
+    return dynamic_cast<Allocate*>(attribute(num_reduction_op_attr + 1));
   }
 
   // Which instance of entering this grid reduction is this iteration?
@@ -1035,7 +1163,8 @@ class GroupedGridReduction final : public GroupedReductionOp {
       Val* entrance_index,
       Val* entrances,
       Val* buffer_stride,
-      bool is_allreduce = false);
+      bool is_allreduce = false,
+      bool use_outer_opt = false);
 
   NVFUSER_DECLARE_CLONE_AND_CREATE
 
@@ -1102,6 +1231,15 @@ class GroupedGridReduction final : public GroupedReductionOp {
     result->threadPredicate() = thread_predicate;
     return result;
   }
+
+  // True if the outer-optimized kernel should be used
+  bool useOuterOpt() const {
+    auto offset = numGroupedReductionOpAttr() + 5 + outputs().size();
+    return attribute<bool>(offset);
+  }
+
+  //! Return the required smem buffer size of the outer-optimized kernel
+  int getSmemBufferSize(int bdimx, int bdimy, int bdimz) const;
 };
 
 //! Grid broadcast operation
@@ -1512,5 +1650,44 @@ class EncodeTensorMapTiled : public Expr {
       const std::vector<PolymorphicValue>& inputs) const override;
 };
 
+//! Multiplier and shift of the fast division by a kernel-invariant divisor,
+//! computed on the host for each launch. The outputs are of the index type of
+//! the kernel, see [ Fast Divmod ] in csrc/device_lower/pass/scalar_hoist.h
+class EncodeFastDivmod : public Expr {
+ public:
+  using Expr::Expr;
+
+  EncodeFastDivmod(
+      IrBuilderPasskey,
+      Val* multiplier,
+      Val* shift,
+      Val* divisor);
+
+  NVFUSER_DECLARE_CLONE_AND_CREATE
+
+  const char* getOpString() const override {
+    return "EncodeFastDivmod";
+  }
+
+  std::string toString(int indent_size = 0) const override;
+  std::string toInlineString(int indent_size = 0) const override;
+
+  Val* multiplier() const {
+    return output(0);
+  }
+
+  Val* shift() const {
+    return output(1);
+  }
+
+  Val* divisor() const {
+    return input(0);
+  }
+
+  std::vector<PolymorphicValue> evaluate(
+      const ExpressionEvaluator& ee,
+      const std::vector<PolymorphicValue>& inputs) const override;
+};
+
 } // namespace kir
 } // namespace nvfuser
@@ -34,12 +34,24 @@ enum class MatmulDomain { M = 0, N, K };
 //!            for example tensor used in beta scaling fusion
 //!  OUTPUT_D - the main consumer of MMA op results
 //!  OUTPUT_AUX - fusion outputs that are consumers of OUTPUT_D
+//!  OUTPUT_REDUCTION - fusion outputs that are reductions along N of the
+//!            epilogue, see [ Matmul Epilogue Reductions ]
+//!  INPUT_PROLOGUE - fusion inputs of the pointwise ops computing INPUT_A or
+//!            INPUT_B, see [ Matmul Prologue Fusion ]
 //!
 //! Naming convention is based on the following formula:
 //!    D = alpha * A x B + beta * C
 //!    AUX = relu(D)
 //!  Note: bias vector tensors will be assigned to INPUT_C role.
-enum class MatmulRole { INPUT_A = 0, INPUT_B, OUTPUT_D, INPUT_C, OUTPUT_AUX };
+enum class MatmulRole {
+  INPUT_A = 0,
+  INPUT_B,
+  OUTPUT_D,
+  INPUT_C,
+  OUTPUT_AUX,
+  OUTPUT_REDUCTION,
+  INPUT_PROLOGUE
+};
 
 //! The expected number of occurances of core TensorView roles in fusion
 static constexpr size_t MATMUL_CORE_ROLES_EXPECTED_COUNT = 1;
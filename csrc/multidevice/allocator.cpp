@@ -6,11 +6,20 @@
  */
 // clang-format on
 #ifdef USE_DISTRIBUTED
+#include <debug.h>
 #include <executor.h>
 #include <fusion.h>
 #include <ir/cloner.h>
 #include <ir/utils.h>
 #include <multidevice/allocator.h>
+#include <multidevice/lower_communication.h>
+#include <multidevice/utils.h>
+#include <options.h>
+#include <utils.h>
+
+#include <map>
+#include <sstream>
+#include <tuple>
 
 namespace nvfuser {
 
@@ -52,12 +61,24 @@ copyFusionAndChangeOutputs(Fusion* fusion, std::unordered_set<Val*> outputs) {
           std::move(fusion_copy), std::move(copy_to_original_map));
 }
 
+// Whether the stage output is only sent by Allreduces, which are bucketed
+// with EnableOption::AllreduceBuckets, see [ Allreduce Buckets ]
+bool isOnlyAllreduced(Val* output) {
+  return isOptionEnabled(EnableOption::AllreduceBuckets) &&
+      !output->uses().empty() &&
+      std::all_of(output->uses().begin(), output->uses().end(), [](Expr* use) {
+           return use->isA<PipelineCommunication>() &&
+               isLoweredToAllreduce(use->as<PipelineCommunication>());
+         });
+}
+
 } // namespace
 
 std::unordered_map<Val*, c10::IValue> allocatePipelineIntermediateBuffers(
     Pipeline* pipeline,
     DeviceIdxType my_device_index,
-    std::vector<c10::IValue> global_inputs_IValues) {
+    std::vector<c10::IValue> global_inputs_IValues,
+    bool allocate_sent_outputs) {
   // Stores the Vals that needs to be allocated
   std::unordered_set<Val*> vals_to_allocate;
   // Add all the input of stages run by the current device
@@ -83,6 +104,36 @@ std::unordered_map<Val*, c10::IValue> allocatePipelineIntermediateBuffers(
       }
     }
   }
+  // Add the outputs of the manually scheduled stages run by the current
+  // device that are sent, which the stages write in place
+  if (allocate_sent_outputs) {
+    for (auto stage : ir_utils::filterByType<PipelineStage>(exprs)) {
+      if (!stage->descriptor()->mesh.has(my_device_index) ||
+          stage->descriptor()->auto_schedule) {
+        continue;
+      }
+      std::unordered_set<Val*> outputs;
+      bool is_sent = false;
+      for (auto output : stage->outputs()) {
+        auto output_val = output->as<PipelineVal>()->getOriginalVal();
+        if (!output_val->isA<TensorView>() ||
+            (isSharded(output_val->as<TensorView>()) &&
+             !isOnlyAllreduced(output))) {
+          outputs.clear();
+          break;
+        }
+        outputs.insert(output_val);
+        is_sent = is_sent ||
+            std::any_of(
+                output->uses().begin(), output->uses().end(), [](Expr* use) {
+                  return use->isA<PipelineCommunication>();
+                });
+      }
+      if (is_sent) {
+        vals_to_allocate.insert(outputs.begin(), outputs.end());
+      }
+    }
+  }
 
   // We copy the original fusion and set the outputs to be the tensors to be
   // allocated. This way we can directly use FusionExecutor::allocOutputSpace
@@ -107,6 +158,184 @@ std::unordered_map<Val*, c10::IValue> allocatePipelineIntermediateBuffers(
   return allocations;
 }
 
+namespace {
+
+constexpr int64_t kDefaultAllreduceBucketMiB = 25;
+
+// Bytes the slices of a bucket are aligned to, so that the kernels reading
+// and writing them can vectorize their accesses
+constexpr int64_t kAllreduceBucketAlignment = 16;
+
+int64_t getMaxAllreduceBucketBytes() {
+  int64_t max_bucket_mib = kDefaultAllreduceBucketMiB;
+  const auto& args = getEnableOptionArguments(EnableOption::AllreduceBuckets);
+  if (!args.empty()) {
+    try {
+      max_bucket_mib = std::stoll(args.at(0));
+    } catch (const std::exception& e) {
+      debug() << "skip invalid argument for AllreduceBuckets, arg = "
+              << args.at(0) << std::endl;
+    }
+  }
+  return max_bucket_mib << 20;
+}
+
+int64_t getBucketSliceBytes(const at::Tensor& tensor) {
+  return roundUpToMultiple(
+      tensor.numel() * (int64_t)tensor.element_size(),
+      kAllreduceBucketAlignment);
+}
+
+} // namespace
+
+std::vector<AllreduceBucket> bucketAllreduceBuffers(
+    Pipeline* pipeline,
+    DeviceIdxType my_device_index,
+    std::unordered_map<Val*, c10::IValue>& buffers) {
+  if (!isOptionEnabled(EnableOption::AllreduceBuckets)) {
+    return {};
+  }
+  const int64_t max_bucket_bytes = getMaxAllreduceBucketBytes();
+  const auto& global_outputs = pipeline->originalFusion()->outputs();
+  auto output_of = [](PipelineCommunication* c) {
+    return c->out()->as<PipelineVal>()->getOriginalVal();
+  };
+
+  // Group the Allreduces in the order of the pipeline by producing stage,
+  // reduction and dtype, into buckets of up to max_bucket_bytes
+  std::vector<AllreduceBucket> buckets;
+  std::vector<int64_t> bucket_bytes;
+  std::map<std::tuple<PipelineStage*, BinaryOpType, at::ScalarType>, size_t>
+      open_buckets;
+  for (auto c :
+       ir_utils::filterByType<PipelineCommunication>(pipeline->exprs())) {
+    if (!isLoweredToAllreduce(c)) {
+      continue;
+    }
+    auto stage = c->in()->as<PipelineVal>()->getStage();
+    Val* output_val = output_of(c);
+    auto it = buffers.find(output_val);
+    // The buffers of the global outputs are replaced on every run
+    if (!stage->descriptor()->mesh.has(my_device_index) ||
+        it == buffers.end() || !it->second.toTensor().is_contiguous() ||
+        std::find(global_outputs.begin(), global_outputs.end(), output_val) !=
+            global_outputs.end()) {
+      continue;
+    }
+    const at::Tensor& output = it->second.toTensor();
+    const auto key = std::make_tuple(
+        stage,
+        output_val->definition()->as<ReductionOp>()->getReductionOpType(),
+        output.scalar_type());
+    const int64_t bytes = getBucketSliceBytes(output);
+    auto bucket_it = open_buckets.find(key);
+    if (bucket_it == open_buckets.end() ||
+        bucket_bytes.at(bucket_it->second) + bytes > max_bucket_bytes) {
+      open_buckets[key] = buckets.size();
+      buckets.emplace_back();
+      bucket_bytes.push_back(0);
+    }
+    const size_t index = open_buckets.at(key);
+    buckets.at(index).communications.push_back(c);
+    bucket_bytes.at(index) += bytes;
+  }
+
+  std::vector<AllreduceBucket> bucketed;
+  for (auto i : c10::irange(buckets.size())) {
+    AllreduceBucket& bucket = buckets.at(i);
+    if (bucket.communications.size() < 2) {
+      continue;
+    }
+    const at::Tensor& first =
+        buffers.at(output_of(bucket.communications.front())).toTensor();
+    const auto element_size = (int64_t)first.element_size();
+    // Zeroed, so that the padding between the slices reduces harmlessly
+    bucket.buffer =
+        at::zeros({bucket_bytes.at(i) / element_size}, first.options());
+    int64_t offset = 0;
+    for (auto c : bucket.communications) {
+      Val* output_val = output_of(c);
+      const at::Tensor output = buffers.at(output_val).toTensor();
+      at::Tensor slice = bucket.buffer.narrow(0, offset, output.numel())
+                             .view(output.sizes());
+      offset += getBucketSliceBytes(output) / element_size;
+      buffers[output_val] = slice;
+
+      // The producing stage writes the device's single slice of the input
+      // straight into the bucket
+      auto input_it =
+          buffers.find(c->in()->as<PipelineVal>()->getOriginalVal());
+      if (input_it == buffers.end()) {
+        continue;
+      }
+      const at::Tensor& input = input_it->second.toTensor();
+      if (input.dim() > 0 && input.size(0) == 1 && input.is_contiguous() &&
+          input.numel() == output.numel() &&
+          input.scalar_type() == output.scalar_type()) {
+        input_it->second = slice.view(input.sizes());
+      }
+    }
+    bucketed.push_back(std::move(bucket));
+  }
+  return bucketed;
+}
+
+namespace {
+
+// Key of the slot and the shapes of the inputs, which determine the shapes of
+// the buffers
+std::string getBuffersKey(
+    const std::vector<c10::IValue>& inputs,
+    int64_t slot) {
+  std::stringstream ss;
+  ss << slot << ":";
+  for (const auto& input : inputs) {
+    if (input.isTensor()) {
+      const auto& tensor = input.toTensor();
+      ss << tensor.scalar_type() << tensor.sizes() << ";";
+    } else {
+      ss << input << ";";
+    }
+  }
+  return ss.str();
+}
+
+} // namespace
+
+std::unordered_map<Val*, c10::IValue> PipelineBuffers::get(
+    Pipeline* pipeline,
+    DeviceIdxType my_device_index,
+    const std::vector<c10::IValue>& global_inputs_IValues,
+    int64_t slot) {
+  const std::string key = getBuffersKey(global_inputs_IValues, slot);
+  auto it = buffers_.find(key);
+  if (it == buffers_.end()) {
+    auto allocations = allocatePipelineIntermediateBuffers(
+        pipeline,
+        my_device_index,
+        global_inputs_IValues,
+        /*allocate_sent_outputs=*/true);
+    buckets_[key] =
+        bucketAllreduceBuffers(pipeline, my_device_index, allocations);
+    it = buffers_.emplace(key, std::move(allocations)).first;
+  }
+  auto buffers = it->second;
+  // The global outputs are returned to the user, so they can't be reused
+  for (auto output : pipeline->originalFusion()->outputs()) {
+    auto buffer_it = buffers.find(output);
+    if (buffer_it != buffers.end()) {
+      buffer_it->second = at::empty_like(buffer_it->second.toTensor());
+    }
+  }
+  return buffers;
+}
+
+const std::vector<AllreduceBucket>& PipelineBuffers::allreduceBuckets(
+    const std::vector<c10::IValue>& global_inputs_IValues,
+    int64_t slot) const {
+  return buckets_.at(getBuffersKey(global_inputs_IValues, slot));
+}
+
 } // namespace nvfuser
 
 #endif
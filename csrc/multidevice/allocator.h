@@ -18,11 +18,74 @@ namespace nvfuser {
 // concrete inputs. returns a map associating the allocated buffer with the
 // corresponding symbolic Val. The allocations correspond to intermediate
 // tensors that will be received from an inter-device communication and will be
-// used as a subsequent stage's input.
+// used as a subsequent stage's input. If allocate_sent_outputs is true, the
+// outputs of the stages run by the device that are sent to other stages are
+// also allocated, when the stages are not auto-scheduled and their outputs
+// are not sharded, or only sent by Allreduces that are bucketed, see
+// [ Allreduce Buckets ].
 std::unordered_map<Val*, c10::IValue> allocatePipelineIntermediateBuffers(
     Pipeline* pipeline,
     DeviceIdxType my_device_index,
-    std::vector<c10::IValue> global_inputs_IValues);
+    std::vector<c10::IValue> global_inputs_IValues,
+    bool allocate_sent_outputs = false);
+
+// [ Allreduce Buckets ]
+// Data-parallel training allreduces many gradients, most of them too small to
+// use the bandwidth of the links on their own. Instead of flattening them into
+// buckets and unflattening them back around the allreduces, with
+// EnableOption::AllreduceBuckets the buffers received by the Allreduces of the
+// outputs of a stage that have the same reduction and dtype are laid out back
+// to back in contiguous buckets of up to 25 MiB, or the number of MiB given as
+// the option's argument. The first Allreduce of a bucket reached allreduces
+// the whole bucket in place, and the consuming stages read the reduced
+// tensors straight from the bucket, so the scaling and the optimizer update
+// of the consumers stay fused in their kernels. The producing stage writes
+// the tensors straight into the bucket when its device holds a single slice
+// of them. Otherwise the device's slice is copied into the bucket, like the
+// local copy of an unbucketed Allreduce.
+struct AllreduceBucket {
+  // The bucketed Allreduces, whose outputs are slices of buffer
+  std::vector<PipelineCommunication*> communications;
+  at::Tensor buffer;
+};
+
+// Groups the Allreduces run by the device into buckets when
+// EnableOption::AllreduceBuckets is set, and replaces the buffers of their
+// outputs, and the buffers of their inputs where possible, by slices of the
+// buckets. Allreduces that would be alone in their bucket are left out.
+std::vector<AllreduceBucket> bucketAllreduceBuffers(
+    Pipeline* pipeline,
+    DeviceIdxType my_device_index,
+    std::unordered_map<Val*, c10::IValue>& buffers);
+
+// [ Persistent Communication Buffers ]
+// Caches the intermediate buffers of a pipeline across runs, so that the
+// communication backends see the same buffers on every run and only register
+// or map them once, and so that the stages write the tensors they send in
+// place. The buffers are allocated with allocate_sent_outputs for each shape
+// of the inputs and each micro-batch slot, as micro-batches in flight must
+// not share buffers. The buffers of the global outputs are allocated anew on
+// every call, since they are returned to the user.
+class PipelineBuffers {
+ public:
+  std::unordered_map<Val*, c10::IValue> get(
+      Pipeline* pipeline,
+      DeviceIdxType my_device_index,
+      const std::vector<c10::IValue>& global_inputs_IValues,
+      int64_t slot);
+
+  // The Allreduce buckets of the buffers returned by get for the same inputs
+  // and slot, see [ Allreduce Buckets ]
+  const std::vector<AllreduceBucket>& allreduceBuckets(
+      const std::vector<c10::IValue>& global_inputs_IValues,
+      int64_t slot) const;
+
+ private:
+  // The keys are strings generated from the slot and the inputs' shapes
+  std::unordered_map<std::string, std::unordered_map<Val*, c10::IValue>>
+      buffers_;
+  std::unordered_map<std::string, std::vector<AllreduceBucket>> buckets_;
+};
 
 } // namespace nvfuser
 
@@ -11,6 +11,7 @@
 #endif
 
 #include <multidevice/communication.h>
+#include <options.h>
 
 namespace nvfuser {
 namespace {
@@ -52,10 +53,51 @@ inline void post_common(Communication& self, Communicator& comm) {
       " must be present in the communication's team");
 }
 
+// Returns the backend of a collective posted without one, which is selected
+// by the communicator if EnableOption::CommBackendSelection is set, see
+// [ Backend Selection ]
+std::optional<CommunicatorBackend> selectBackend(
+    Communication& self,
+    Communicator& comm,
+    std::optional<CommunicatorBackend> backend) {
+  if (backend.has_value() ||
+      !isOptionEnabled(EnableOption::CommBackendSelection)) {
+    return backend;
+  }
+  int64_t bytes = 0;
+  for (const auto& buf : self.params().src_bufs) {
+    bytes += static_cast<int64_t>(buf.nbytes());
+  }
+  return comm.selectBackend(
+      self.collectiveType(),
+      self.params().team,
+      bytes,
+      [&](CommunicatorBackend candidate) {
+        return self.post(comm, candidate);
+      });
+}
+
 inline void doLocalCopy(const at::Tensor& dst, const at::Tensor& src) {
   dst.copy_(src, /* non-blocking */ true);
 }
 
+// Returns a flat view of the buffer whose consecutive slices are bufs, or an
+// undefined tensor if bufs are not laid out contiguously in that order
+at::Tensor getFlatConcatenation(const std::vector<at::Tensor>& bufs) {
+  const at::Tensor& first = bufs.at(0);
+  for (auto i : c10::irange(bufs.size())) {
+    const at::Tensor& buf = bufs.at(i);
+    if (!buf.is_contiguous() || buf.sizes() != first.sizes() ||
+        buf.scalar_type() != first.scalar_type() ||
+        static_cast<char*>(buf.data_ptr()) !=
+            static_cast<char*>(first.data_ptr()) + i * first.nbytes()) {
+      return at::Tensor();
+    }
+  }
+  return first.as_strided(
+      {static_cast<int64_t>(bufs.size()) * first.numel()}, {1});
+}
+
 } // namespace
 
 Communication::Communication(CommParams params, std::string name, bool has_root)
@@ -176,6 +218,7 @@ c10::intrusive_ptr<c10d::Work> Allgather::post(
     Communicator& comm,
     std::optional<CommunicatorBackend> backend) {
   post_common(*this, comm);
+  backend = selectBackend(*this, comm, backend);
   // This is used to change the representation of the buffers to match c10d
   // ProcessGroup API
   std::vector<std::vector<at::Tensor>> buf_list;
@@ -256,11 +299,82 @@ c10::intrusive_ptr<c10d::Work> Allreduce::post(
     Communicator& comm,
     std::optional<CommunicatorBackend> backend) {
   post_common(*this, comm);
+  backend = selectBackend(*this, comm, backend);
   doLocalCopy(params_.dst_bufs.at(0), params_.src_bufs.at(0));
   return comm.getBackendForTeam(params_.team, backend)
       ->allreduce(params_.dst_bufs, {.reduceOp = params_.redOp});
 }
 
+HierarchicalAllreduce::HierarchicalAllreduce(
+    CommParams params,
+    Team intra_node_team,
+    Team inter_node_team)
+    : Communication(params, "hierarchical_allreduce", false),
+      intra_node_team_(std::move(intra_node_team)),
+      inter_node_team_(std::move(inter_node_team)) {
+  assertBufferCount(params_.src_bufs, 1);
+  assertBufferCount(params_.dst_bufs, 1);
+  NVF_ERROR(
+      params_.dst_bufs.at(0).is_contiguous(),
+      "the dst buffer must be contiguous");
+  NVF_ERROR(
+      params_.dst_bufs.at(0).numel() %
+              static_cast<int64_t>(intra_node_team_.size()) ==
+          0,
+      "the buffers must be divisible into ",
+      intra_node_team_.size(),
+      " shards");
+  NVF_ERROR(
+      intra_node_team_.size() > 1,
+      "the intra-node team size must be greater than 1");
+  NVF_ERROR(
+      intra_node_team_.size() * inter_node_team_.size() == params_.team.size(),
+      "the intra-node and inter-node teams must span the team");
+}
+
+c10::intrusive_ptr<c10d::Work> HierarchicalAllreduce::post(
+    Communicator& comm,
+    std::optional<CommunicatorBackend> backend) {
+  post_common(*this, comm);
+  at::Tensor dst = params_.dst_bufs.at(0);
+  doLocalCopy(dst, params_.src_bufs.at(0));
+
+  // The three steps operate in place on the shards of the dst buffer. The
+  // shard of a device is the one at its position in its intra-node team
+  std::vector<at::Tensor> shards =
+      dst.view({-1}).chunk(static_cast<int64_t>(intra_node_team_.size()));
+  auto it = std::find(
+      intra_node_team_.begin(), intra_node_team_.end(), comm.deviceId());
+  NVF_ERROR(
+      it != intra_node_team_.end(),
+      "current device index ",
+      comm.deviceId(),
+      " must be present in the intra-node team");
+  at::Tensor shard = shards.at(std::distance(intra_node_team_.begin(), it));
+
+  // Each step waits for the previous one, which doesn't block the host with
+  // NCCL but only orders the streams of the teams' backends
+  CommParams params;
+  params.redOp = params_.redOp;
+  params.team = intra_node_team_;
+  params.src_bufs = shards;
+  params.dst_bufs = {shard};
+  ReduceScatter(params).post(comm, backend)->wait();
+
+  if (inter_node_team_.size() > 1) {
+    params.team = inter_node_team_;
+    params.src_bufs = {shard};
+    params.dst_bufs = {shard};
+    Allreduce(params).post(comm, backend)->wait();
+  }
+
+  params.redOp = c10d::ReduceOp::RedOpType::UNUSED;
+  params.team = intra_node_team_;
+  params.src_bufs = {shard};
+  params.dst_bufs = shards;
+  return Allgather(params).post(comm, backend);
+}
+
 ReduceScatter::ReduceScatter(CommParams params)
     : Communication(params, "reduce_scatter", false) {
   assertBufferCount(params_.src_bufs, params_.team.size());
@@ -272,12 +386,22 @@ c10::intrusive_ptr<c10d::Work> ReduceScatter::post(
     Communicator& comm,
     std::optional<CommunicatorBackend> backend) {
   post_common(*this, comm);
+  backend = selectBackend(*this, comm, backend);
+  auto team_backend = comm.getBackendForTeam(params_.team, backend);
+  // The src buffers are usually the slices of the tensor written by the
+  // reduction that precedes the communication. NCCL then reduces that tensor
+  // in place, instead of a flattened copy of the buffers
+  at::Tensor flat_src = getFlatConcatenation(params_.src_bufs);
+  if (flat_src.defined() && params_.dst_bufs.at(0).is_contiguous() &&
+      team_backend->getBackendName() == "nccl") {
+    return team_backend->_reduce_scatter_base(
+        params_.dst_bufs.at(0), flat_src, {.reduceOp = params_.redOp});
+  }
   // This is used to change the representation of the buffers to match c10d
   // ProcessGroup API
   std::vector<std::vector<at::Tensor>> buf_list = {std::move(params_.src_bufs)};
-  auto work = comm.getBackendForTeam(params_.team, backend)
-                  ->reduce_scatter(
-                      params_.dst_bufs, buf_list, {.reduceOp = params_.redOp});
+  auto work = team_backend->reduce_scatter(
+      params_.dst_bufs, buf_list, {.reduceOp = params_.redOp});
   params_.src_bufs = std::move(buf_list.back());
   return work;
 }
@@ -65,6 +65,10 @@ class Communication {
     return params_;
   }
 
+  const std::string& collectiveType() const {
+    return collective_type_;
+  }
+
   // Triggers the execution of the communication. This is a non-blocking call.
   // The communication can be posted multiple times
   virtual c10::intrusive_ptr<c10d::Work> post(
@@ -191,6 +195,35 @@ class Allreduce : public Communication {
       std::optional<CommunicatorBackend> backend = std::nullopt) override;
 };
 
+/*
+Reduce the src buffers to the dst buffer over devices spread across nodes, in
+three steps: a ReduceScatter within each node, an Allreduce of the resulting
+shards across the nodes, and an Allgather within each node. Each device thus
+only sends and receives over the slower inter-node links a shard of the buffer
+of 1/<intra-node team size> of its size.
+Requirements:
+  - all devices have one src buffer and one contiguous dst buffer
+  - all buffers have the same size, whose number of elements is divisible by
+    the size of the intra-node team
+  - the intra-node and inter-node teams of a device both contain it, and their
+    product is the team, like the slices of a {nodes, devices per node}
+    DeviceMesh
+*/
+class HierarchicalAllreduce : public Communication {
+ public:
+  HierarchicalAllreduce(
+      CommParams params,
+      Team intra_node_team,
+      Team inter_node_team);
+  c10::intrusive_ptr<c10d::Work> post(
+      Communicator& comm,
+      std::optional<CommunicatorBackend> backend = std::nullopt) override;
+
+ private:
+  Team intra_node_team_;
+  Team inter_node_team_;
+};
+
 /*
 Reduce all the src buffers and shard the result to the dst buffers.
 
@@ -8,6 +8,10 @@
 #ifdef USE_DISTRIBUTED
 #include <netdb.h>
 
+#include <chrono>
+#include <sstream>
+
+#include <c10/cuda/CUDAStream.h>
 #include <multidevice/communicator.h>
 #include <torch/csrc/distributed/c10d/PrefixStore.hpp>
 #ifdef USE_C10D_GLOO
@@ -249,6 +253,71 @@ c10::intrusive_ptr<c10d::Backend> Communicator::getWorld(
   return getBackendForTeam(all_ranks, backend);
 }
 
+CommunicatorBackend Communicator::selectBackend(
+    const std::string& collective,
+    const Team& team,
+    int64_t bytes,
+    const std::function<c10::intrusive_ptr<c10d::Work>(CommunicatorBackend)>&
+        post) {
+  std::vector<CommunicatorBackend> candidates;
+  for (auto backend : {CommunicatorBackend::nccl, CommunicatorBackend::ucc}) {
+    if (isBackendAvailable(backend)) {
+      candidates.push_back(backend);
+    }
+  }
+  if (candidates.size() <= 1) {
+    return candidates.empty() ? default_backend_ : candidates.front();
+  }
+
+  int64_t size_bucket = 1;
+  while (size_bucket < bytes) {
+    size_bucket *= 2;
+  }
+  std::stringstream key;
+  key << collective << "_" << size_bucket;
+  for (auto d_id : team) {
+    key << "_" << d_id;
+  }
+  auto it = selected_backends_.find(key.str());
+  if (it != selected_backends_.end()) {
+    return it->second;
+  }
+
+  constexpr int64_t kWarmupIterations = 2;
+  constexpr int64_t kTimedIterations = 5;
+  auto run = [&](CommunicatorBackend backend) {
+    if (auto work = post(backend)) {
+      work->wait();
+    }
+    c10::cuda::getCurrentCUDAStream().synchronize();
+  };
+  std::vector<float> times;
+  for (auto backend : candidates) {
+    // Also creates the backend for the team
+    for (int64_t i = 0; i < kWarmupIterations; i++) {
+      run(backend);
+    }
+    auto start = std::chrono::steady_clock::now();
+    for (int64_t i = 0; i < kTimedIterations; i++) {
+      run(backend);
+    }
+    std::chrono::duration<float> elapsed =
+        std::chrono::steady_clock::now() - start;
+    times.push_back(elapsed.count());
+  }
+
+  // The slowest device of the team determines the time of a collective
+  std::vector<at::Tensor> times_buf = {at::tensor(times).to(device())};
+  getBackendForTeam(team, default_backend_)
+      ->allreduce(times_buf, {.reduceOp = c10d::ReduceOp::RedOpType::MAX})
+      ->wait();
+  auto reduced_times = times_buf.at(0).cpu();
+  auto best = reduced_times.argmin().item<int64_t>();
+
+  selected_backends_[key.str()] = candidates.at(best);
+  return candidates.at(best);
+}
+
 } // namespace nvfuser
 
 #endif
@@ -14,6 +14,8 @@
 #include <torch/csrc/distributed/c10d/Store.hpp>
 #include <torch/csrc/distributed/c10d/TCPStore.hpp>
 
+#include <functional>
+
 namespace nvfuser {
 
 /*
@@ -105,6 +107,21 @@ class Communicator {
   c10::intrusive_ptr<c10d::Backend> getWorld(
       std::optional<CommunicatorBackend> backend = std::nullopt);
 
+  // [ Backend Selection ]
+  // Returns the backend to post the collective of the given type over team
+  // with messages of the given size. The first time a collective is posted
+  // over a team with messages of a given power of two of bytes, post is
+  // called with each available backend, which are timed, and the fastest
+  // backend is cached. The timings are reduced over the team so that all its
+  // devices make the same choice. The best backend depends on the message
+  // size and on whether the team spans NVLink or network links.
+  CommunicatorBackend selectBackend(
+      const std::string& collective,
+      const Team& team,
+      int64_t bytes,
+      const std::function<c10::intrusive_ptr<c10d::Work>(CommunicatorBackend)>&
+          post);
+
   // returns if a backend is available for creation
   bool isBackendAvailable(CommunicatorBackend backend) const {
     if (backend == CommunicatorBackend::ucc) {
@@ -144,6 +161,9 @@ class Communicator {
   c10::intrusive_ptr<c10d::TCPStore> store_;
   // cache for the created backends. The keys are strings generated from Teams
   std::unordered_map<std::string, c10::intrusive_ptr<c10d::Backend>> backends_;
+  // cache for selectBackend. The keys are strings generated from the
+  // collective, the message size and the Team
+  std::unordered_map<std::string, CommunicatorBackend> selected_backends_;
 };
 
 } // namespace nvfuser
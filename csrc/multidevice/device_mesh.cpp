@@ -8,8 +8,59 @@
 
 #include <multidevice/device_mesh.h>
 
+#include <c10/util/irange.h>
+
+#include <functional>
+#include <numeric>
+
 namespace nvfuser {
 
+DeviceMesh::DeviceMesh(
+    std::vector<DeviceIdxType> devices,
+    std::vector<int64_t> shape) {
+  setDevices(std::move(devices));
+  NVF_ERROR(!shape.empty(), "device mesh must have at least one dimension");
+  NVF_ERROR(
+      std::accumulate(
+          shape.begin(), shape.end(), (int64_t)1, std::multiplies<>()) ==
+          static_cast<int64_t>(vector_.size()),
+      "the shape of the device mesh doesn't match its ",
+      vector_.size(),
+      " devices");
+  shape_ = std::move(shape);
+}
+
+std::vector<DeviceIdxType> DeviceMesh::getSlice(
+    DeviceIdxType device,
+    int64_t axis) const {
+  NVF_ERROR(
+      axis >= 0 && axis < nDims(),
+      "axis ",
+      axis,
+      " is out of the ",
+      nDims(),
+      " dimensions of the device mesh");
+  auto it = std::find(vector_.begin(), vector_.end(), device);
+  NVF_ERROR(it != vector_.end(), "device ", device, " is not in the mesh");
+  const auto index = static_cast<int64_t>(std::distance(vector_.begin(), it));
+
+  // In row-major order, moving along axis steps over the extents of the
+  // inner axes
+  const int64_t stride = std::accumulate(
+      shape_.begin() + axis + 1,
+      shape_.end(),
+      (int64_t)1,
+      std::multiplies<>());
+  const int64_t extent = shape_.at(axis);
+  const int64_t first = index - (index / stride) % extent * stride;
+  std::vector<DeviceIdxType> slice;
+  slice.reserve(extent);
+  for (auto i : c10::irange(extent)) {
+    slice.push_back(vector_.at(first + i * stride));
+  }
+  return slice;
+}
+
 std::string DeviceMesh::toString() const {
   std::stringstream ss;
   ss << "DeviceMesh{";
@@ -17,6 +68,13 @@ std::string DeviceMesh::toString() const {
     ss << i << ", ";
   }
   ss << "}";
+  if (nDims() > 1) {
+    ss << " of shape {";
+    for (auto extent : shape_) {
+      ss << extent << ", ";
+    }
+    ss << "}";
+  }
   return ss.str();
 }
 
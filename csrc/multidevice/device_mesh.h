@@ -14,8 +14,11 @@ namespace nvfuser {
 
 /*
    The class DeviceMesh represents a set of (unique) devices on which a Pipeline
-   Stage will be executed. For now, we only support flat meshes, but later we
-   will add support for n-dimensional meshes.
+   Stage will be executed. A mesh is flat by default, but it can be given a
+   multi-dimensional shape reflecting the topology of the devices, e.g.,
+   {number of nodes, number of devices per node}, in which case the devices are
+   laid out in row-major order. Tensors are still sharded over the flattened
+   mesh, and the shape is only used to decompose collectives hierarchically.
 */
 class DeviceMesh final {
  public:
@@ -23,6 +26,8 @@ class DeviceMesh final {
     setDevices(devices);
   }
 
+  DeviceMesh(std::vector<DeviceIdxType> devices, std::vector<int64_t> shape);
+
   std::string toString() const;
 
   DeviceMesh& operator=(const std::vector<DeviceIdxType>& devices) {
@@ -35,14 +40,30 @@ class DeviceMesh final {
     return vector_;
   }
 
+  // returns the shape of the mesh
+  const auto& shape() const {
+    return shape_;
+  }
+
+  // returns the number of dimensions of the mesh
+  int64_t nDims() const {
+    return static_cast<int64_t>(shape_.size());
+  }
+
   // returns whether a device is present in the mesh
   bool has(const DeviceIdxType device) const {
     return std::find(vector_.begin(), vector_.end(), device) != vector_.end();
   }
 
+  // returns the devices of the mesh whose coordinates are the ones of device
+  // along every axis but axis, ordered along axis
+  std::vector<DeviceIdxType> getSlice(DeviceIdxType device, int64_t axis)
+      const;
+
  private:
   void setDevices(std::vector<DeviceIdxType> devices) {
     vector_ = devices;
+    shape_ = {static_cast<int64_t>(vector_.size())};
     NVF_ERROR(
         std::unique(vector_.begin(), vector_.end()) == vector_.end(),
         "device mesh has duplicates");
@@ -50,6 +71,8 @@ class DeviceMesh final {
 
   // stores the list of device indices
   std::vector<DeviceIdxType> vector_;
+  // stores the extent of each dimension of the mesh
+  std::vector<int64_t> shape_;
 };
 
 std::ostream& operator<<(std::ostream& out, const DeviceMesh& mesh);
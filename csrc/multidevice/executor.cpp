@@ -7,10 +7,14 @@
 // clang-format on
 #ifdef USE_DISTRIBUTED
 #include <ir/utils.h>
+#include <iter_visitor.h>
+#include <kernel_db/compile_cache.h>
 #include <multidevice/allocator.h>
 #include <multidevice/executor.h>
 #include <multidevice/lower_communication.h>
 #include <multidevice/pipeline.h>
+#include <options.h>
+#include <root_domain_map.h>
 
 namespace nvfuser {
 
@@ -22,14 +26,197 @@ bool PipelineExecutor::shouldRun(PipelineStage* stage) {
   return should_run_[stage];
 }
 
+void PipelineExecutor::waitFor(Val* val) {
+  auto it = pending_works_.find(val);
+  if (it == pending_works_.end()) {
+    return;
+  }
+  for (auto& work : it->second) {
+    work->wait();
+  }
+  pending_works_.erase(it);
+}
+
+namespace {
+
+// Whether the stage fusion can be run on chunks of its input of index
+// input_idx along the outermost dimension, each chunk of the input giving the
+// same chunk of all the outputs along their outermost dimension. This is the
+// case of a matmul whose first operand is the input.
+bool isChunkableAlongOutermost(Fusion* fusion, int64_t input_idx) {
+  auto input = dynamic_cast<TensorView*>(fusion->inputs().at(input_idx));
+  if (input == nullptr) {
+    return false;
+  }
+  auto outermost = [](TensorView* tv) -> IterDomain* {
+    auto ids = TensorDomain::noReductions(tv->getMaybeRFactorDomain());
+    return ids.empty() ? nullptr : ids.front();
+  };
+  std::unordered_set<TensorView*> chunked{input};
+  for (auto expr : StmtSort::getExprs(fusion)) {
+    auto inputs = ir_utils::filterByType<TensorView>(expr->inputs());
+    if (std::none_of(inputs.begin(), inputs.end(), [&](TensorView* tv) {
+          return chunked.count(tv);
+        })) {
+      continue;
+    }
+    if (!expr->isOneOf<
+            UnaryOp,
+            BinaryOp,
+            TernaryOp,
+            BroadcastOp,
+            ReductionOp,
+            LoadStoreOp>()) {
+      return false;
+    }
+    for (auto out : ir_utils::filterByType<TensorView>(expr->outputs())) {
+      IterDomain* out_id = out->getRootDomain().front();
+      if (out_id != out->getMaybeRFactorDomain().front() ||
+          out_id->isReduction() || out_id->isBroadcast()) {
+        return false;
+      }
+      for (auto in : inputs) {
+        auto p2c = PairwiseRootDomainMap(in, out).mapProducerToConsumer();
+        IterDomain* in_id = outermost(in);
+        auto it = p2c.find(in_id);
+        const bool is_mapped = it != p2c.end() && it->second == out_id;
+        // Inputs that are not chunked must be broadcast along the chunks
+        if (chunked.count(in) ? !is_mapped
+                              : is_mapped && !in_id->isBroadcast()) {
+          return false;
+        }
+      }
+      chunked.insert(out);
+    }
+  }
+  return std::all_of(
+      fusion->outputs().begin(), fusion->outputs().end(), [&](Val* out) {
+        return out->isA<TensorView>() && chunked.count(out->as<TensorView>());
+      });
+}
+
+// Whether the current device compiles the stages run by team for the other
+// devices of its node, see [ Leader Compilation ]
+bool isCompileLeader(Communicator& comm, const Team& team) {
+  auto node = [&](DeviceIdxType device) {
+    return device / comm.local_size();
+  };
+  auto leader = std::find_if(team.begin(), team.end(), [&](DeviceIdxType d) {
+    return node(d) == node(comm.deviceId());
+  });
+  return leader != team.end() && *leader == comm.deviceId();
+}
+
+} // namespace
+
+std::vector<at::Tensor> PipelineExecutor::runStage(
+    PipelineStage* stage,
+    const std::vector<c10::IValue>& stage_input_IValues,
+    const std::vector<at::Tensor>& outputs) {
+  // Compile the stage and either execute it or allocate output buffers
+  // if the stage is configured to be autoscheduled, use FusionExecutorCache,
+  // otherwise use FusionExecutor
+  if (stage->descriptor()->auto_schedule) {
+    // Check if the executor has been cached. If not, create and cache it
+    if (fec_.find(stage) == fec_.end()) {
+      fec_.emplace(
+          stage,
+          std::make_unique<FusionExecutorCache>(
+              runtime_.pipeline_->stageToFusion(stage)));
+    }
+    // Run the stage to get concrete outputs or placeholders
+    return fec_[stage]->runFusionWithInputs(stage_input_IValues);
+  }
+
+  // Check if the executor has been cached. If not, create and cache it
+  if (fe_.find(stage) == fe_.end()) {
+    fe_.emplace(stage, std::make_unique<FusionExecutor>());
+    fe_[stage]->compileFusion(
+        runtime_.pipeline_->stageToFusion(stage).get(), stage_input_IValues);
+  }
+  // Run the stage to get concrete outputs or placeholders
+  // TODO: deal with aliases I/O. For example if the stage is empty, i.e.,
+  // Inputs=Outputs, we need to handle them anyway
+  return fe_[stage]->runFusion(stage_input_IValues, outputs);
+}
+
+std::vector<at::Tensor> PipelineExecutor::runStageCompiledByLeader(
+    PipelineStage* stage,
+    const std::vector<c10::IValue>& stage_input_IValues,
+    const std::vector<at::Tensor>& outputs) {
+  const Team& team = stage->descriptor()->mesh.vector();
+  const bool is_compiled = fe_.count(stage) || fec_.count(stage);
+  if (is_compiled || team.size() < 2 || CompileCache::get() == nullptr) {
+    return runStage(stage, stage_input_IValues, outputs);
+  }
+
+  Communicator& comm = runtime_.comm_;
+  auto barrier = [&]() {
+    comm.getBackendForTeam(team, std::nullopt)->barrier()->wait();
+  };
+  if (isCompileLeader(comm, team)) {
+    auto stage_outputs = runStage(stage, stage_input_IValues, outputs);
+    barrier();
+    return stage_outputs;
+  }
+  barrier();
+  return runStage(stage, stage_input_IValues, outputs);
+}
+
+void PipelineExecutor::runRingAllgather(
+    Val* val,
+    const std::function<void(int64_t)>& consume_chunk) {
+  PipelineCommunication* c = ring_allgathers_.at(val);
+  ring_allgathers_.erase(val);
+  auto input_val = c->in()->as<PipelineVal>()->getOriginalVal();
+  const auto& mesh =
+      c->in()->as<PipelineVal>()->getStage()->descriptor()->mesh.vector();
+  auto it = std::find(mesh.begin(), mesh.end(), runtime_.comm_.deviceId());
+  if (it == mesh.end() || val_to_IValue_.find(val) == val_to_IValue_.end()) {
+    return;
+  }
+  const auto size = static_cast<int64_t>(mesh.size());
+  const auto relative_index = static_cast<int64_t>(it - mesh.begin());
+
+  waitFor(input_val);
+  at::Tensor input_tensor = val_to_IValue_.at(input_val).toTensor();
+  at::Tensor output_tensor = val_to_IValue_.at(val).toTensor();
+  output_tensor.index({static_cast<int>(relative_index), "..."})
+      .copy_(input_tensor.index({0, "..."}));
+
+  auto steps = lowerToRingAllgather(
+      runtime_.comm_.deviceId(), c, input_tensor, output_tensor);
+  for (auto step : c10::irange(size)) {
+    // Receive the next chunk while the current one is consumed
+    std::vector<c10::intrusive_ptr<c10d::Work>> works;
+    if (step < size - 1) {
+      for (auto& communication : steps.at(step)) {
+        if (auto work = communication->post(runtime_.comm_)) {
+          works.push_back(std::move(work));
+        }
+      }
+    }
+    if (consume_chunk) {
+      consume_chunk(ringAllgatherChunk(size, relative_index, step));
+    }
+    for (auto& work : works) {
+      work->wait();
+    }
+  }
+}
+
 void PipelineExecutor::handle(PipelineStage* stage) {
   if (!shouldRun(stage)) {
     return;
   }
   // get the IValues corresponding to the stage's input
   std::vector<c10::IValue> stage_input_IValues;
-  for (auto& input : stage->inputs()) {
-    auto input_val = input->as<PipelineVal>()->getOriginalVal();
+  // The input gathered by a ring Allgather that is consumed chunk by chunk,
+  // see [ Collective Matmul ]
+  std::optional<int64_t> ring_input_idx;
+  for (auto input_idx : c10::irange(stage->inputs().size())) {
+    auto input_val =
+        stage->inputs().at(input_idx)->as<PipelineVal>()->getOriginalVal();
     NVF_ERROR(
         val_to_IValue_.find(input_val) != val_to_IValue_.end(),
         "Device ",
@@ -39,36 +226,57 @@ void PipelineExecutor::handle(PipelineStage* stage) {
         " for handling stage ",
         stage);
     NVF_ERROR(val_to_IValue_.at(input_val).isTensor());
+    waitFor(input_val);
+    if (ring_allgathers_.count(input_val)) {
+      if (!ring_input_idx.has_value() &&
+          isChunkableAlongOutermost(
+              runtime_.pipeline_->stageToFusion(stage).get(),
+              (int64_t)input_idx)) {
+        ring_input_idx = input_idx;
+      } else {
+        runRingAllgather(input_val, nullptr);
+      }
+    }
     stage_input_IValues.push_back(val_to_IValue_.at(input_val));
   }
 
   std::vector<at::Tensor> outputs;
-
-  // Compile the stage and either execute it or allocate output buffers
-  // if the stage is configured to be autoscheduled, use FusionExecutorCache,
-  // otherwise use FusionExecutor
-  if (stage->descriptor()->auto_schedule) {
-    // Check if the executor has been cached. If not, create and cache it
-    if (fec_.find(stage) == fec_.end()) {
-      fec_.emplace(
-          stage,
-          std::make_unique<FusionExecutorCache>(
-              runtime_.pipeline_->stageToFusion(stage)));
+  if (ring_input_idx.has_value()) {
+    // Run the stage on each chunk once it is received, and concatenate the
+    // outputs of the chunks in order
+    auto ring_val = stage->inputs()
+                        .at(*ring_input_idx)
+                        ->as<PipelineVal>()
+                        ->getOriginalVal();
+    at::Tensor gathered = val_to_IValue_.at(ring_val).toTensor();
+    std::vector<std::vector<at::Tensor>> chunk_outputs(gathered.size(0));
+    runRingAllgather(ring_val, [&](int64_t chunk) {
+      std::vector<c10::IValue> chunk_inputs = stage_input_IValues;
+      chunk_inputs.at(*ring_input_idx) = gathered.narrow(0, chunk, 1);
+      chunk_outputs.at(chunk) = runStage(stage, chunk_inputs);
+    });
+    for (auto output_idx : c10::irange(stage->outputs().size())) {
+      std::vector<at::Tensor> chunks;
+      for (const auto& outputs_of_chunk : chunk_outputs) {
+        chunks.push_back(outputs_of_chunk.at(output_idx));
+      }
+      outputs.push_back(at::cat(chunks, 0));
     }
-    // Run the stage to get concrete outputs or placeholders
-    outputs = fec_[stage]->runFusionWithInputs(stage_input_IValues);
-
   } else {
-    // Check if the executor has been cached. If not, create and cache it
-    if (fe_.find(stage) == fe_.end()) {
-      fe_.emplace(stage, std::make_unique<FusionExecutor>());
-      fe_[stage]->compileFusion(
-          runtime_.pipeline_->stageToFusion(stage).get(), stage_input_IValues);
+    // The stage writes in place into the persistent buffers of its outputs,
+    // if they are all allocated, see [ Persistent Communication Buffers ]
+    std::vector<at::Tensor> preallocated_outputs;
+    for (auto output : stage->outputs()) {
+      auto it = val_to_IValue_.find(
+          output->as<PipelineVal>()->getOriginalVal());
+      if (it == val_to_IValue_.end()) {
+        preallocated_outputs.clear();
+        break;
+      }
+      preallocated_outputs.push_back(it->second.toTensor());
     }
-    // Run the stage to get concrete outputs or placeholders
-    // TODO: deal with aliases I/O. For example if the stage is empty, i.e.,
-    // Inputs=Outputs, we need to handle them anyway
-    outputs = fe_[stage]->runFusion(stage_input_IValues);
+    outputs = runStageCompiledByLeader(
+        stage, stage_input_IValues, preallocated_outputs);
   }
 
   // Store the outputs or placeholders in the context
@@ -83,6 +291,28 @@ void PipelineExecutor::handle(PipelineCommunication* c) {
   auto input_val = c->in()->as<PipelineVal>()->getOriginalVal();
   auto output_val = c->out()->as<PipelineVal>()->getOriginalVal();
 
+  // The input may itself be produced by a pending communication
+  if (ring_allgathers_.count(input_val)) {
+    runRingAllgather(input_val, nullptr);
+  }
+  waitFor(input_val);
+
+  // The Allreduces of a bucket are all posted by the first one reached
+  auto bucket_it = allreduce_bucket_of_.find(c);
+  if (bucket_it != allreduce_bucket_of_.end()) {
+    if (bucket_it->second != nullptr) {
+      postAllreduceBucket(*bucket_it->second);
+    }
+    return;
+  }
+
+  // Allgathers are run as rings by their first consumer
+  if (isOptionEnabled(EnableOption::CollectiveMatmul) &&
+      isLoweredToAllgather(c)) {
+    ring_allgathers_[output_val] = c;
+    return;
+  }
+
   at::Tensor input_tensor, output_tensor;
   if (val_to_IValue_.find(input_val) != val_to_IValue_.end()) {
     input_tensor = val_to_IValue_.at(input_val).toTensor();
@@ -100,24 +330,59 @@ void PipelineExecutor::handle(PipelineCommunication* c) {
   }
   auto& communications = communications_[c];
 
-  // post and wait communications
+  // post communications, which are waited for by the consumers of their
+  // output
   for (auto& communication : communications) {
     auto work = communication->post(runtime_.comm_);
     if (work) {
-      work->wait();
+      pending_works_[output_val].push_back(std::move(work));
     }
   }
 }
 
-std::vector<at::Tensor> PipelineExecutor::runWithInput(
-    const std::vector<c10::IValue>& inputs) {
-  // Make sure inputs align at global boundary.
-  NVF_ERROR(
-      inputs.size() == runtime_.pipeline_->inputs().size(),
-      "Wrong number of inputs");
+void PipelineExecutor::postAllreduceBucket(const AllreduceBucket& bucket) {
+  auto output_of = [](PipelineCommunication* c) {
+    return c->out()->as<PipelineVal>()->getOriginalVal();
+  };
+  for (auto c : bucket.communications) {
+    allreduce_bucket_of_[c] = nullptr;
+    auto input_val = c->in()->as<PipelineVal>()->getOriginalVal();
+    waitFor(input_val);
+    at::Tensor src = val_to_IValue_.at(input_val).toTensor().index({0, "..."});
+    at::Tensor dst = val_to_IValue_.at(output_of(c)).toTensor();
+    if (src.data_ptr() != dst.data_ptr()) {
+      dst.copy_(src, /*non_blocking=*/true);
+    }
+  }
 
-  val_to_IValue_ = allocatePipelineIntermediateBuffers(
-      runtime_.pipeline_, runtime_.comm().deviceId(), inputs);
+  auto communications = lowerToBucketedAllreduce(
+      runtime_.comm_.deviceId(), bucket.communications.front(), bucket.buffer);
+  for (auto& communication : communications) {
+    auto work = communication->post(runtime_.comm_);
+    if (!work) {
+      continue;
+    }
+    for (auto c : bucket.communications) {
+      pending_works_[output_of(c)].push_back(work);
+    }
+  }
+}
+
+std::vector<at::Tensor> PipelineExecutor::runMicroBatch(
+    const std::vector<c10::IValue>& inputs,
+    int64_t slot) {
+  // Communications are lowered with the buffers they operate on, which are
+  // different for each micro-batch
+  communications_.clear();
+  val_to_IValue_ = runtime_.buffers_.get(
+      runtime_.pipeline_, runtime_.comm().deviceId(), inputs, slot);
+  allreduce_bucket_of_.clear();
+  for (const auto& bucket :
+       runtime_.buffers_.allreduceBuckets(inputs, slot)) {
+    for (auto c : bucket.communications) {
+      allreduce_bucket_of_[c] = &bucket;
+    }
+  }
 
   // process input values:
   for (auto input_idx : c10::irange(inputs.size())) {
@@ -129,6 +394,19 @@ std::vector<at::Tensor> PipelineExecutor::runWithInput(
 
   // Run through the stages to launch kernel
   traverseTo(runtime_.pipeline_->outputs());
+  // Allgathers without a consumer on this device
+  while (!ring_allgathers_.empty()) {
+    runRingAllgather(ring_allgathers_.begin()->first, nullptr);
+  }
+
+  // The communications that are still pending are waited for once the
+  // micro-batch after the next one is started, or at the end of the run
+  std::vector<c10::intrusive_ptr<c10d::Work>> works;
+  for (auto& [val, val_works] : pending_works_) {
+    works.insert(works.end(), val_works.begin(), val_works.end());
+  }
+  pending_works_.clear();
+  in_flight_works_.push_back(std::move(works));
 
   // Collect global outputs from context
   std::vector<at::Tensor> outputs;
@@ -142,6 +420,83 @@ std::vector<at::Tensor> PipelineExecutor::runWithInput(
   return outputs;
 }
 
+std::vector<at::Tensor> PipelineExecutor::runWithInput(
+    const std::vector<c10::IValue>& inputs,
+    int64_t num_micro_batches) {
+  // Make sure inputs align at global boundary.
+  NVF_ERROR(
+      inputs.size() == runtime_.pipeline_->inputs().size(),
+      "Wrong number of inputs");
+  NVF_CHECK(
+      num_micro_batches >= 1,
+      "Invalid number of micro-batches: ",
+      num_micro_batches);
+
+  // Split the tensor inputs along their outermost dimension. Micro-batches
+  // all have the same shape, so that the stages are compiled only once.
+  std::vector<std::vector<c10::IValue>> micro_batch_inputs(
+      num_micro_batches, inputs);
+  for (auto input_idx : c10::irange(inputs.size())) {
+    const auto& input = inputs.at(input_idx);
+    if (!input.isTensor() || num_micro_batches == 1) {
+      continue;
+    }
+    const at::Tensor& tensor = input.toTensor();
+    NVF_CHECK(
+        tensor.dim() > 0 && tensor.size(0) % num_micro_batches == 0,
+        "The outermost dimension of input ",
+        input_idx,
+        " can't be split into ",
+        num_micro_batches,
+        " micro-batches");
+    auto chunks = tensor.chunk(num_micro_batches, 0);
+    for (auto micro_batch : c10::irange(num_micro_batches)) {
+      micro_batch_inputs.at(micro_batch).at(input_idx) =
+          chunks.at(micro_batch);
+    }
+  }
+
+  std::vector<std::vector<at::Tensor>> micro_batch_outputs;
+  for (auto micro_batch : c10::irange(num_micro_batches)) {
+    // Double buffering: the buffers of the micro-batch before the previous
+    // one are only reused once its communications are done
+    if (in_flight_works_.size() >= 2) {
+      for (auto& work : in_flight_works_.front()) {
+        work->wait();
+      }
+      in_flight_works_.pop_front();
+    }
+    micro_batch_outputs.push_back(runMicroBatch(
+        micro_batch_inputs.at(micro_batch), /*slot=*/micro_batch % 2));
+  }
+
+  // The outputs, and the buffers of the communications that have no consumer
+  // on this device, must be complete before returning
+  for (auto& works : in_flight_works_) {
+    for (auto& work : works) {
+      work->wait();
+    }
+  }
+  in_flight_works_.clear();
+
+  if (num_micro_batches == 1) {
+    return micro_batch_outputs.front();
+  }
+
+  // Concatenate the outputs of the micro-batches, which are undefined on the
+  // devices that don't produce them
+  std::vector<at::Tensor> outputs;
+  for (auto output_idx : c10::irange(micro_batch_outputs.front().size())) {
+    std::vector<at::Tensor> chunks;
+    for (const auto& outputs_of_micro_batch : micro_batch_outputs) {
+      chunks.push_back(outputs_of_micro_batch.at(output_idx));
+    }
+    outputs.push_back(
+        chunks.front().defined() ? at::cat(chunks, 0) : at::Tensor());
+  }
+  return outputs;
+}
+
 } // namespace nvfuser
 
 #endif
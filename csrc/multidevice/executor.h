@@ -15,18 +15,39 @@
 #include <multidevice/pipeline_ir.h>
 #include <multidevice/runtime.h>
 
+#include <deque>
+#include <functional>
+
 namespace nvfuser {
 
 // Runtime Executor for Pipelines
 // This class inherits from IterVisitor because the execution
 // is ordered by the traversal of the Pipeline seen as a DAG
+//
+// [ Micro-batching ]
+// The global inputs can be split along their outermost dimension into
+// micro-batches, which are run through the whole Pipeline one after the
+// other, GPipe style. Since communications are only waited for by their
+// consumers, a device can start the next micro-batch as soon as it has
+// posted the sends of the current one, so that the stages of different
+// devices process different micro-batches concurrently and the idle fraction
+// of the pipeline shrinks to (p-1)/(m+p-1) for p stages and m micro-batches.
+// Each micro-batch has its own intermediate buffers, and at most two
+// micro-batches are in flight, so the inter-stage buffers are double
+// buffered. The outputs of the micro-batches are concatenated along their
+// outermost dimension, so the Fusion must be independent across the
+// outermost dimension of its inputs. As pipelines only run forward, 1F1B
+// degenerates to this schedule.
 class PipelineExecutor : public IterVisitor {
  public:
   explicit PipelineExecutor(MultiDeviceRuntime& runtime)
       : IterVisitor(), runtime_(runtime) {}
 
-  // Run the Pipelined Fusion with the given global inputs
-  std::vector<at::Tensor> runWithInput(const std::vector<c10::IValue>& inputs);
+  // Run the Pipelined Fusion with the given global inputs, split into
+  // num_micro_batches micro-batches, see [ Micro-batching ]
+  std::vector<at::Tensor> runWithInput(
+      const std::vector<c10::IValue>& inputs,
+      int64_t num_micro_batches = 1);
 
  private:
   // Implement the execution of exprs of the Pipeline
@@ -40,6 +61,50 @@ class PipelineExecutor : public IterVisitor {
   // Returns whether the current process should run the stage
   bool shouldRun(PipelineStage* stage);
 
+  // Waits for the pending communications that produce val, if any
+  void waitFor(Val* val);
+
+  // Compiles if needed and runs the stage on the given inputs. The outputs,
+  // if any, are written in place by stages that are not auto-scheduled
+  std::vector<at::Tensor> runStage(
+      PipelineStage* stage,
+      const std::vector<c10::IValue>& stage_input_IValues,
+      const std::vector<at::Tensor>& outputs = {});
+
+  // [ Leader Compilation ]
+  // The devices of a stage's mesh all compile the same kernels for it. With
+  // the persistent compile cache of EnableOption::CompileCache, see
+  // [ Persistent Compile Cache ], only the first device of the mesh on each
+  // node compiles them, the first time the stage is run, while the other
+  // devices wait at a barrier of the mesh. They then run the stage and load
+  // its kernels from the cache instead of invoking NVRTC, so the compilation
+  // cost at startup doesn't grow with the number of devices per node. If the
+  // cache directory is shared by the nodes, the leaders of each node compile
+  // concurrently and all but the first write are redundant. Stages run on the
+  // chunks of a ring Allgather are compiled by every device, as their runs are
+  // interleaved with the steps of the ring.
+  std::vector<at::Tensor> runStageCompiledByLeader(
+      PipelineStage* stage,
+      const std::vector<c10::IValue>& stage_input_IValues,
+      const std::vector<at::Tensor>& outputs = {});
+
+  // Runs the ring Allgather producing val, calling consume_chunk, if any,
+  // with the index of each chunk of val while the next one is received
+  void runRingAllgather(
+      Val* val,
+      const std::function<void(int64_t)>& consume_chunk);
+
+  // Copies the device's slices of the inputs of the bucketed Allreduces into
+  // the bucket, unless the producing stage wrote them in place, and posts
+  // the Allreduce of the bucket, see [ Allreduce Buckets ]
+  void postAllreduceBucket(const AllreduceBucket& bucket);
+
+  // Runs the Pipeline on the inputs of a single micro-batch, with the
+  // buffers of the given slot
+  std::vector<at::Tensor> runMicroBatch(
+      const std::vector<c10::IValue>& inputs,
+      int64_t slot);
+
   // Stores concrete computed values,
   std::unordered_map<Val*, c10::IValue> val_to_IValue_;
 
@@ -53,6 +118,36 @@ class PipelineExecutor : public IterVisitor {
       std::vector<std::shared_ptr<Communication>>>
       communications_;
 
+  // Communications are posted without waiting for them. Their works are
+  // stored here by the Val they produce, and only waited for when a stage or
+  // a communication consumes the Val, so that communications overlap with the
+  // stages that don't depend on them. The works run on the process group's
+  // own communication streams.
+  std::unordered_map<Val*, std::vector<c10::intrusive_ptr<c10d::Work>>>
+      pending_works_;
+
+  // Works of the micro-batches still in flight, oldest first, whose buffers
+  // are kept alive by the works until they are waited for
+  std::deque<std::vector<c10::intrusive_ptr<c10d::Work>>> in_flight_works_;
+
+  // [ Collective Matmul ]
+  // With EnableOption::CollectiveMatmul, the Allgathers are decomposed into
+  // the steps of a ring, where each device sends the last chunk it received
+  // to the next device. They are not posted by handle(PipelineCommunication)
+  // but recorded here by the Val they produce, and run by the first stage
+  // that consumes the Val. If the stage's outputs can be computed chunk by
+  // chunk along the outermost dimension of the Val, like a matmul of the
+  // gathered activations by replicated weights in a tensor-parallel layer,
+  // the stage is run on each chunk while the next one is received, so that
+  // the communication hides behind the compute. The outputs of the chunks
+  // are then concatenated.
+  std::unordered_map<Val*, PipelineCommunication*> ring_allgathers_;
+
+  // The bucket of each bucketed Allreduce of the current micro-batch, or
+  // nullptr once the bucket has been posted
+  std::unordered_map<PipelineCommunication*, const AllreduceBucket*>
+      allreduce_bucket_of_;
+
   // Cache results of shouldRun method
   std::unordered_map<PipelineStage*, bool> should_run_;
 
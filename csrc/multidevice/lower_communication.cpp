@@ -350,10 +350,12 @@ void lowerToReduce(
   }
 }
 
-void lowerToAllreduce(
+// Adds the allreduce of the src buffer, the device's slice of the input, to
+// the output
+void lowerSliceToAllreduce(
     DeviceIdxType my_device_index,
     const DeviceMesh& mesh,
-    at::Tensor input_tensor,
+    at::Tensor src_buf,
     at::Tensor output_tensor,
     BinaryOpType op_type,
     std::vector<std::shared_ptr<Communication>>& comms) {
@@ -364,12 +366,43 @@ void lowerToAllreduce(
   params.redOp = getC10dReduceOpType(op_type);
   params.team = mesh.vector();
   params.dst_bufs = {output_tensor};
-  auto sliced_buf = input_tensor.index({0, "..."});
-  params.src_bufs = {sliced_buf};
+  params.src_bufs = {src_buf};
+
+  // On a {nodes, devices per node} mesh, the allreduce is decomposed so that
+  // only a shard of the buffer crosses the nodes
+  const auto intra_node_size = mesh.shape().back();
+  if (mesh.nDims() == 2 && intra_node_size > 1 && mesh.shape().front() > 1 &&
+      output_tensor.is_contiguous() &&
+      output_tensor.numel() % intra_node_size == 0) {
+    comms.push_back(std::make_shared<HierarchicalAllreduce>(
+        params,
+        mesh.getSlice(my_device_index, 1),
+        mesh.getSlice(my_device_index, 0)));
+    return;
+  }
 
   comms.push_back(std::make_shared<Allreduce>(params));
 }
 
+void lowerToAllreduce(
+    DeviceIdxType my_device_index,
+    const DeviceMesh& mesh,
+    at::Tensor input_tensor,
+    at::Tensor output_tensor,
+    BinaryOpType op_type,
+    std::vector<std::shared_ptr<Communication>>& comms) {
+  if (!mesh.has(my_device_index)) {
+    return;
+  }
+  lowerSliceToAllreduce(
+      my_device_index,
+      mesh,
+      input_tensor.index({0, "..."}),
+      output_tensor,
+      op_type,
+      comms);
+}
+
 void lowerToReduceScatter(
     DeviceIdxType my_device_index,
     const DeviceMesh& mesh,
@@ -537,6 +570,116 @@ std::vector<std::shared_ptr<Communication>> lowerCommunication(
   return comms;
 }
 
+bool isLoweredToAllgather(PipelineCommunication* c) {
+  auto input_tv =
+      c->in()->as<PipelineVal>()->getOriginalVal()->as<TensorView>();
+  auto output_tv =
+      c->out()->as<PipelineVal>()->getOriginalVal()->as<TensorView>();
+  const auto& sender_mesh =
+      c->in()->as<PipelineVal>()->getStage()->descriptor()->mesh;
+  const auto& receiver_mesh =
+      c->out()->as<PipelineVal>()->getStage()->descriptor()->mesh;
+  return !output_tv->definition()->isA<ReductionOp>() &&
+      sender_mesh.vector() == receiver_mesh.vector() &&
+      isSharded(input_tv) && sender_mesh.vector().size() > 1 &&
+      !isSharded(output_tv);
+}
+
+bool isLoweredToAllreduce(PipelineCommunication* c) {
+  auto input_tv =
+      c->in()->as<PipelineVal>()->getOriginalVal()->as<TensorView>();
+  auto output_tv =
+      c->out()->as<PipelineVal>()->getOriginalVal()->as<TensorView>();
+  const auto& sender_mesh =
+      c->in()->as<PipelineVal>()->getStage()->descriptor()->mesh;
+  const auto& receiver_mesh =
+      c->out()->as<PipelineVal>()->getStage()->descriptor()->mesh;
+  return output_tv->definition()->isA<ReductionOp>() &&
+      sender_mesh.vector() == receiver_mesh.vector() &&
+      isSharded(input_tv) && sender_mesh.vector().size() > 1 &&
+      !isSharded(output_tv);
+}
+
+std::vector<std::shared_ptr<Communication>> lowerToBucketedAllreduce(
+    DeviceIdxType my_device_index,
+    PipelineCommunication* c,
+    at::Tensor bucket) {
+  NVF_ERROR(isLoweredToAllreduce(c), "Expected an allreduce, got ", c);
+  auto output_tv =
+      c->out()->as<PipelineVal>()->getOriginalVal()->as<TensorView>();
+  std::vector<std::shared_ptr<Communication>> comms;
+  lowerSliceToAllreduce(
+      my_device_index,
+      c->in()->as<PipelineVal>()->getStage()->descriptor()->mesh,
+      bucket,
+      bucket,
+      output_tv->definition()->as<ReductionOp>()->getReductionOpType(),
+      comms);
+  return comms;
+}
+
+int64_t ringAllgatherChunk(
+    int64_t mesh_size,
+    int64_t relative_index,
+    int64_t step) {
+  return ((relative_index - step) % mesh_size + mesh_size) % mesh_size;
+}
+
+std::vector<std::vector<std::shared_ptr<Communication>>> lowerToRingAllgather(
+    DeviceIdxType my_device_index,
+    PipelineCommunication* c,
+    at::Tensor input_tensor,
+    at::Tensor output_tensor) {
+  NVF_ERROR(isLoweredToAllgather(c), "Not an allgather: ", c);
+  const auto& mesh =
+      c->in()->as<PipelineVal>()->getStage()->descriptor()->mesh.vector();
+  auto it = std::find(mesh.begin(), mesh.end(), my_device_index);
+  if (it == mesh.end()) {
+    return {};
+  }
+  const auto size = static_cast<int64_t>(mesh.size());
+  const auto relative_index = static_cast<int64_t>(it - mesh.begin());
+  const DeviceIdxType next = mesh.at((relative_index + 1) % size);
+  const DeviceIdxType previous = mesh.at((relative_index + size - 1) % size);
+
+  std::vector<std::vector<std::shared_ptr<Communication>>> steps;
+  for (auto step : c10::irange(size - 1)) {
+    const auto send_chunk = ringAllgatherChunk(size, relative_index, step);
+    const auto recv_chunk = ringAllgatherChunk(size, relative_index, step + 1);
+    // The own chunk is sent from the input, the others from the output
+    at::Tensor send_buf = step == 0
+        ? input_tensor.index({0, "..."})
+        : output_tensor.index({static_cast<int>(send_chunk), "..."});
+    at::Tensor recv_buf =
+        output_tensor.index({static_cast<int>(recv_chunk), "..."});
+
+    std::vector<std::shared_ptr<Communication>> send, recv;
+    lowerToBroadcastOrP2P(
+        my_device_index,
+        my_device_index,
+        DeviceMesh({next}),
+        send_buf,
+        at::Tensor(),
+        send);
+    lowerToBroadcastOrP2P(
+        my_device_index,
+        previous,
+        DeviceMesh({my_device_index}),
+        at::Tensor(),
+        recv_buf,
+        recv);
+    // Neighbors alternate between sending and receiving first, so that
+    // the sends and receives of a pair of devices match when they share a
+    // communicator
+    auto& step_comms = steps.emplace_back();
+    auto& first = (relative_index % 2 == 0) ? send : recv;
+    auto& second = (relative_index % 2 == 0) ? recv : send;
+    step_comms.insert(step_comms.end(), first.begin(), first.end());
+    step_comms.insert(step_comms.end(), second.begin(), second.end());
+  }
+  return steps;
+}
+
 bool isLowerableToCommunication(Expr* expr) {
   if (expr->isA<ReductionOp>()) {
     auto out = expr->as<ReductionOp>()->out();
@@ -26,6 +26,40 @@ std::vector<std::shared_ptr<Communication>> lowerCommunication(
     at::Tensor input_tensor,
     at::Tensor output_tensor);
 
+// Returns whether c is lowered to an Allgather
+bool isLoweredToAllgather(PipelineCommunication* c);
+
+// Returns whether c is lowered to an Allreduce
+bool isLoweredToAllreduce(PipelineCommunication* c);
+
+// Lowers the Allreduces of a bucket, whose outputs are slices of bucket and
+// which all reduce like c over the mesh of c, into a single Allreduce of
+// bucket in place, see [ Allreduce Buckets ]
+std::vector<std::shared_ptr<Communication>> lowerToBucketedAllreduce(
+    DeviceIdxType my_device_index,
+    PipelineCommunication* c,
+    at::Tensor bucket);
+
+// Lowers the Allgather c into the steps of a ring, see [ Collective Matmul ].
+// At step s, the device of relative index r in the mesh sends chunk
+// ringAllgatherChunk(p, r, s) to the next device and receives chunk
+// ringAllgatherChunk(p, r, s + 1) from the previous one, for the p - 1 first
+// steps. Returns the communications of each step, in the order the device
+// must post them. The device's own chunk is not copied into the output.
+std::vector<std::vector<std::shared_ptr<Communication>>> lowerToRingAllgather(
+    DeviceIdxType my_device_index,
+    PipelineCommunication* c,
+    at::Tensor input_tensor,
+    at::Tensor output_tensor);
+
+// The chunk of the output of a ring Allgather over a mesh of size
+// mesh_size that the device of relative index relative_index holds at step
+// step
+int64_t ringAllgatherChunk(
+    int64_t mesh_size,
+    int64_t relative_index,
+    int64_t step);
+
 } // namespace nvfuser
 
 #endif
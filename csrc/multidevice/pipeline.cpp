@@ -5,6 +5,7 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 // clang-format on
+#include <expr_evaluator.h>
 #include <ir/builder.h>
 #include <ir/cloner.h>
 #include <ir/printer.h>
@@ -13,6 +14,12 @@
 #include <multidevice/lower_communication.h>
 #include <multidevice/pipeline.h>
 #include <multidevice/pipeline_ir.h>
+#include <multidevice/utils.h>
+#include <ops/alias.h>
+
+#include <c10/util/irange.h>
+
+#include <limits>
 
 namespace nvfuser {
 
@@ -320,4 +327,291 @@ std::string Pipeline::toString() {
   return p.toString();
 }
 
+PipelineDescriptor inferPipelineDescriptor(Fusion* fusion) {
+  DisjointSets<Val*> stages;
+  for (auto tv : ir_utils::allTvs(fusion)) {
+    NVF_ERROR(tv->hasDeviceMesh(), "No DeviceMesh is set on ", tv);
+    stages.initializeSet(tv);
+  }
+  for (auto expr : fusion->exprs()) {
+    if (isResharding(expr)) {
+      continue;
+    }
+    auto tvs = ir_utils::filterByType<TensorView>(expr->outputs()).vector();
+    auto inputs = ir_utils::filterByType<TensorView>(expr->inputs());
+    tvs.insert(tvs.end(), inputs.begin(), inputs.end());
+    for (auto tv : tvs) {
+      stages.mapEntries(tvs.front(), tv);
+    }
+  }
+
+  PipelineDescriptor descriptor;
+  for (const auto& stage_vals : stages.disjointSets()) {
+    auto& stage = descriptor.stage_descriptors.emplace_back();
+    stage.addVal(stage_vals->vector());
+    stage.mesh = stage_vals->front()->as<TensorView>()->getDeviceMesh();
+  }
+  return descriptor;
+}
+
+namespace {
+
+// Number of elements of tv, where the extents expr_eval can't evaluate count
+// as one
+double numElements(TensorView* tv, ExpressionEvaluator& expr_eval) {
+  double num_elements = 1.0;
+  for (auto id : TensorDomain::noReductions(tv->getMaybeRFactorDomain())) {
+    if (id->isBroadcast()) {
+      continue;
+    }
+    const auto& extent = expr_eval.evaluate(id->extent());
+    if (extent.hasValue()) {
+      num_elements *= (double)extent.as<int64_t>();
+    }
+  }
+  return num_elements;
+}
+
+bool isSet(Expr* expr) {
+  return expr->isA<LoadStoreOp>() &&
+      expr->as<LoadStoreOp>()->opType() == LoadStoreOpType::Set;
+}
+
+bool hasTvOutput(Expr* expr) {
+  return !ir_utils::filterByType<TensorView>(expr->outputs()).empty();
+}
+
+// Splits Exprs of the given costs into num_stages contiguous stages, see
+// [ Pipeline Partitioning ], and returns the index of the first Expr of each
+// stage. boundary_bytes[k] is the traffic of a stage boundary before Expr k.
+std::vector<int64_t> partitionCosts(
+    const std::vector<double>& costs,
+    const std::vector<double>& boundary_bytes,
+    int64_t num_stages,
+    double imbalance_tolerance) {
+  constexpr double kInfinity = std::numeric_limits<double>::infinity();
+  const auto num_exprs = (int64_t)costs.size();
+  std::vector<double> prefix_costs(num_exprs + 1, 0.0);
+  for (auto i : c10::irange(num_exprs)) {
+    prefix_costs[i + 1] = prefix_costs[i] + costs[i];
+  }
+  auto stage_cost = [&](int64_t begin, int64_t end) {
+    return prefix_costs[end] - prefix_costs[begin];
+  };
+
+  // bottleneck[s][k] is the lowest cost of the slowest stage when splitting
+  // the first k Exprs into s stages
+  std::vector<std::vector<double>> bottleneck(
+      num_stages + 1, std::vector<double>(num_exprs + 1, kInfinity));
+  bottleneck[0][0] = 0.0;
+  for (auto s : c10::irange((int64_t)1, num_stages + 1)) {
+    for (auto k : c10::irange(s, num_exprs + 1)) {
+      for (auto j : c10::irange(s - 1, k)) {
+        bottleneck[s][k] = std::min(
+            bottleneck[s][k], std::max(bottleneck[s - 1][j], stage_cost(j, k)));
+      }
+    }
+  }
+  // The relative slack keeps rounding errors from excluding the optimum
+  const double max_stage_cost = bottleneck[num_stages][num_exprs] *
+      (1.0 + imbalance_tolerance + 1e-9);
+
+  // traffic[s][k] is the fewest bytes crossing the boundaries when splitting
+  // the first k Exprs into s stages that all cost at most max_stage_cost,
+  // the last of which starts at begin[s][k]
+  std::vector<std::vector<double>> traffic(
+      num_stages + 1, std::vector<double>(num_exprs + 1, kInfinity));
+  std::vector<std::vector<int64_t>> begin(
+      num_stages + 1, std::vector<int64_t>(num_exprs + 1, -1));
+  traffic[0][0] = 0.0;
+  for (auto s : c10::irange((int64_t)1, num_stages + 1)) {
+    for (auto k : c10::irange(s, num_exprs + 1)) {
+      for (auto j : c10::irange(s - 1, k)) {
+        if (traffic[s - 1][j] == kInfinity ||
+            stage_cost(j, k) > max_stage_cost) {
+          continue;
+        }
+        const double bytes =
+            traffic[s - 1][j] + (j > 0 ? boundary_bytes[j] : 0.0);
+        if (bytes < traffic[s][k]) {
+          traffic[s][k] = bytes;
+          begin[s][k] = j;
+        }
+      }
+    }
+  }
+  NVF_ERROR(
+      traffic[num_stages][num_exprs] != kInfinity,
+      "No partition within the bottleneck cost");
+
+  std::vector<int64_t> stage_begins(num_stages);
+  int64_t end = num_exprs;
+  for (int64_t s = num_stages; s > 0; --s) {
+    stage_begins[s - 1] = begin[s][end];
+    end = begin[s][end];
+  }
+  return stage_begins;
+}
+
+} // namespace
+
+PipelineDescriptor partitionPipeline(
+    Fusion* fusion,
+    const std::vector<DeviceMesh>& meshes,
+    const PipelinePartitionOptions& options) {
+  FusionGuard fg(fusion);
+  NVF_CHECK(!meshes.empty(), "A pipeline needs at least one stage");
+  NVF_CHECK(
+      options.imbalance_tolerance >= 0.0,
+      "The imbalance tolerance must be non-negative, but got ",
+      options.imbalance_tolerance);
+  ExpressionEvaluator default_expr_eval;
+  ExpressionEvaluator& expr_eval =
+      options.expr_eval != nullptr ? *options.expr_eval : default_expr_eval;
+
+  std::vector<Expr*> exprs;
+  for (auto expr : fusion->exprs()) {
+    if (hasTvOutput(expr)) {
+      exprs.push_back(expr);
+    }
+  }
+  const auto num_exprs = (int64_t)exprs.size();
+  const auto num_stages = (int64_t)meshes.size();
+  NVF_CHECK(
+      num_exprs >= num_stages,
+      "Can't split ",
+      num_exprs,
+      " tensor operations into ",
+      num_stages,
+      " stages");
+
+  // Costs of the Exprs, and positions of the producers and of the last
+  // consumers of the tensors. The position of the producer of a fusion input
+  // is its first consumer, as it belongs to the same stage.
+  std::vector<double> costs(num_exprs);
+  std::unordered_map<TensorView*, int64_t> producer_pos;
+  std::unordered_map<TensorView*, int64_t> last_use_pos;
+  for (auto i : c10::irange(num_exprs)) {
+    double cost = 0.0;
+    for (auto tv : ir_utils::filterByType<TensorView>(exprs[i]->inputs())) {
+      cost += numElements(tv, expr_eval);
+      producer_pos.emplace(tv, i);
+      last_use_pos[tv] = i;
+    }
+    for (auto tv : ir_utils::filterByType<TensorView>(exprs[i]->outputs())) {
+      cost += numElements(tv, expr_eval);
+      producer_pos[tv] = i;
+    }
+    auto cost_it = options.expr_costs.find(exprs[i]);
+    costs[i] = cost_it != options.expr_costs.end() ? cost_it->second : cost;
+  }
+
+  // A tensor crosses the boundaries after its producer, up to its last use
+  std::vector<double> boundary_bytes(num_exprs + 1, 0.0);
+  for (auto [tv, last_use] : last_use_pos) {
+    const int64_t producer = producer_pos.at(tv);
+    if (last_use == producer) {
+      continue;
+    }
+    const double bytes = numElements(tv, expr_eval) *
+        (double)dataTypeSize(tv->dtype(), DataType::Int);
+    boundary_bytes[producer + 1] += bytes;
+    boundary_bytes[last_use + 1] -= bytes;
+  }
+  for (auto k : c10::irange((int64_t)1, num_exprs + 1)) {
+    boundary_bytes[k] += boundary_bytes[k - 1];
+  }
+
+  const std::vector<int64_t> stage_begins = partitionCosts(
+      costs, boundary_bytes, num_stages, options.imbalance_tolerance);
+  std::vector<int64_t> expr_stage(num_exprs);
+  std::unordered_map<TensorView*, int64_t> tv_stage;
+  int64_t current_stage = 0;
+  for (auto i : c10::irange(num_exprs)) {
+    while (current_stage + 1 < num_stages &&
+           i >= stage_begins[current_stage + 1]) {
+      current_stage++;
+    }
+    expr_stage[i] = current_stage;
+    for (auto tv : ir_utils::filterByType<TensorView>(exprs[i]->inputs())) {
+      tv_stage.emplace(tv, current_stage);
+    }
+    for (auto tv : ir_utils::filterByType<TensorView>(exprs[i]->outputs())) {
+      tv_stage[tv] = current_stage;
+    }
+  }
+
+  // Copy the tensors consumed by another stage into the consumer stage,
+  // with a copy per tensor and stage
+  std::unordered_map<TensorView*, std::unordered_map<int64_t, TensorView*>>
+      copies;
+  for (auto i : c10::irange(num_exprs)) {
+    if (isSet(exprs[i])) {
+      continue;
+    }
+    VectorOfUniqueEntries<TensorView*> inputs;
+    for (auto tv : ir_utils::filterByType<TensorView>(exprs[i]->inputs())) {
+      inputs.pushBack(tv);
+    }
+    for (auto tv : inputs) {
+      if (tv_stage.at(tv) == expr_stage[i]) {
+        continue;
+      }
+      TensorView*& copy = copies[tv][expr_stage[i]];
+      if (copy == nullptr) {
+        copy = set(tv);
+        tv_stage[copy] = expr_stage[i];
+      }
+      exprs[i] = ir_utils::replaceValInExprInputs(exprs[i], tv, copy);
+    }
+  }
+
+  PipelineDescriptor descriptor;
+  for (const auto& mesh : meshes) {
+    descriptor.stage_descriptors.emplace_back().mesh = mesh;
+  }
+  auto add_to_stage = [&](Val* val, int64_t stage_id) {
+    descriptor.stage_descriptors.at(stage_id).addVal({val});
+    if (auto tv = dynamic_cast<TensorView*>(val)) {
+      tv->setDeviceMesh(meshes.at(stage_id));
+    }
+  };
+  for (auto expr : fusion->exprs()) {
+    if (!hasTvOutput(expr)) {
+      continue;
+    }
+    const int64_t stage = tv_stage.at(
+        ir_utils::filterByType<TensorView>(expr->outputs()).vector().front());
+    // Scalars belong to each stage that uses them
+    for (auto input : expr->inputs()) {
+      if (!input->isA<TensorView>()) {
+        add_to_stage(input, stage);
+      } else if (input->isFusionInput()) {
+        add_to_stage(input, tv_stage.at(input->as<TensorView>()));
+      }
+    }
+    for (auto output : expr->outputs()) {
+      add_to_stage(output, stage);
+    }
+  }
+  // Tensors that don't contribute to the outputs go with their producers
+  for (auto tv : ir_utils::filterByType<TensorView>(fusion->vals())) {
+    if (tv_stage.count(tv)) {
+      continue;
+    }
+    int64_t producer_stage = 0;
+    if (tv->definition() != nullptr) {
+      for (auto input :
+           ir_utils::filterByType<TensorView>(tv->definition()->inputs())) {
+        if (tv_stage.count(input)) {
+          producer_stage = tv_stage.at(input);
+          break;
+        }
+      }
+    }
+    add_to_stage(tv, producer_stage);
+  }
+  return descriptor;
+}
+
 } // namespace nvfuser
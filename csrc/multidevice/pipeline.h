@@ -12,6 +12,9 @@
 #include <ir/base_nodes.h>
 #include <multidevice/device_mesh.h>
 
+#include <unordered_map>
+#include <vector>
+
 /*
 This file implements the Pipeline interface.
 A Pipeline represents a Fusion or a parent stage segmented into a series of
@@ -146,4 +149,51 @@ class Pipeline : public Fusion {
   PipelineDescriptor descriptor_;
 };
 
+// Returns a PipelineDescriptor with a stage for each set of TensorViews
+// connected by Exprs that are not resharding, on the mesh of the
+// TensorViews. All the TensorViews must have a mesh, for example after
+// propagateShardings (see [ Sharding Propagation ] in multidevice/utils.h).
+PipelineDescriptor inferPipelineDescriptor(Fusion* fusion);
+
+class ExpressionEvaluator;
+
+//! [ Pipeline Partitioning ]
+//!
+//! The throughput of a pipeline is bounded by its slowest stage, so stages
+//! written by hand with unequal costs leave devices idle. partitionPipeline
+//! splits the Exprs of a Fusion, in topological order, into one contiguous
+//! stage per DeviceMesh:
+//! 1) The cost of the bottleneck stage is minimized, by dynamic programming
+//!    over the boundaries between the stages.
+//! 2) Among the partitions whose stages all cost at most
+//!    (1 + imbalance_tolerance) times this bottleneck, the one with the
+//!    fewest bytes of tensors crossing stage boundaries is picked, each
+//!    boundary counting the tensors produced before and used after it.
+//! A tensor consumed by a stage other than its producer's is copied with a
+//! "set" into each such stage, unless its consumer is already a "set", so
+//! that the stage inputs are copies as the Pipeline requires. Fusion inputs
+//! belong to the stage of their first consumer.
+//!
+//! The cost of an Expr is the number of elements of its input and output
+//! tensors, or the value of expr_costs, e.g., measured by profiling the
+//! segments of the fusion. Extents that expr_eval can't evaluate count as
+//! one, so sizes should be bound to it, e.g., from example inputs.
+struct PipelinePartitionOptions {
+  //! Costs of Exprs that override the estimate above
+  std::unordered_map<Expr*, double> expr_costs;
+  //! Evaluates the extents of tensors to estimate their sizes
+  ExpressionEvaluator* expr_eval = nullptr;
+  //! Relative increase of the bottleneck cost that is traded for less
+  //! traffic between the stages
+  double imbalance_tolerance = 0.05;
+};
+
+//! Returns a PipelineDescriptor with a stage on each of meshes, see
+//! [ Pipeline Partitioning ]. Inserts the copies of the stage inputs in
+//! fusion and sets the mesh of its TensorViews to the mesh of their stage.
+PipelineDescriptor partitionPipeline(
+    Fusion* fusion,
+    const std::vector<DeviceMesh>& meshes,
+    const PipelinePartitionOptions& options = {});
+
 } // namespace nvfuser
@@ -16,11 +16,12 @@
 namespace nvfuser {
 
 std::vector<at::Tensor> MultiDeviceRuntime::runWithInput(
-    std::vector<c10::IValue> inputs) {
+    std::vector<c10::IValue> inputs,
+    int64_t num_micro_batches) {
   auto error_msg = validate();
   NVF_ERROR(error_msg.empty(), error_msg);
   PipelineExecutor executor(*this);
-  return executor.runWithInput(inputs);
+  return executor.runWithInput(inputs, num_micro_batches);
 }
 
 std::string MultiDeviceRuntime::validate() const {
@@ -10,6 +10,7 @@
 
 #include <c10/core/DeviceType.h>
 #include <exceptions.h>
+#include <multidevice/allocator.h>
 #include <multidevice/communicator.h>
 #include <multidevice/pipeline.h>
 #include <multidevice/pipeline_ir.h>
@@ -27,8 +28,11 @@ class MultiDeviceRuntime {
   explicit MultiDeviceRuntime(Pipeline* pipeline, Communicator& comm)
       : pipeline_(pipeline), comm_(comm) {}
 
-  // Run the multidevice fusion with the given global inputs
-  std::vector<at::Tensor> runWithInput(std::vector<c10::IValue> inputs);
+  // Run the multidevice fusion with the given global inputs, split into
+  // num_micro_batches micro-batches along their outermost dimension
+  std::vector<at::Tensor> runWithInput(
+      std::vector<c10::IValue> inputs,
+      int64_t num_micro_batches = 1);
 
   // Returns the Communicator
   auto& comm() {
@@ -51,6 +55,8 @@ class MultiDeviceRuntime {
 
   Pipeline* pipeline_;
   Communicator& comm_;
+  // Intermediate buffers reused across runs
+  PipelineBuffers buffers_;
 };
 
 } // namespace nvfuser
@@ -10,6 +10,8 @@
 #include <ir/internal_base_nodes.h>
 #include <ir/utils.h>
 #include <multidevice/utils.h>
+#include <ops/alias.h>
+#include <root_domain_map.h>
 
 #include <c10/util/irange.h>
 
@@ -96,4 +98,110 @@ bool isResharding(Expr* expr) {
   return !haveDifferentSharding(tv_ref, tvs).empty();
 }
 
+namespace {
+
+struct Sharding {
+  DeviceMesh mesh;
+  bool is_sharded = false;
+};
+
+// Whether the outermost axis of producer is mapped to the outermost axis of
+// consumer, so that they can share a sharding
+bool isOutermostAxisMapped(TensorView* producer, TensorView* consumer) {
+  auto producer_ids =
+      TensorDomain::noReductions(producer->getMaybeRFactorDomain());
+  auto consumer_ids =
+      TensorDomain::noReductions(consumer->getMaybeRFactorDomain());
+  if (producer_ids.empty() || consumer_ids.empty() ||
+      consumer_ids.front() != consumer->getRootDomain().front()) {
+    return false;
+  }
+  auto p2c = PairwiseRootDomainMap(producer, consumer).mapProducerToConsumer();
+  auto it = p2c.find(producer_ids.front());
+  return it != p2c.end() && it->second == consumer_ids.front();
+}
+
+// Whether tv has sharding when consumed by consumer
+bool hasSharding(
+    TensorView* tv,
+    TensorView* consumer,
+    const Sharding& sharding) {
+  if (tv->getDeviceMesh().vector() != sharding.mesh.vector()) {
+    return false;
+  }
+  return isSharded(tv) ==
+      (sharding.is_sharded && isOutermostAxisMapped(tv, consumer));
+}
+
+void setSharding(TensorView* tv, const Sharding& sharding) {
+  tv->setDeviceMesh(sharding.mesh);
+  if (sharding.is_sharded) {
+    tv->axis(0)->parallelize(ParallelType::DIDx);
+  }
+}
+
+} // namespace
+
+void propagateShardings(Fusion* fusion) {
+  FusionGuard fg(fusion);
+  for (auto expr : fusion->exprs()) {
+    auto outputs = ir_utils::filterByType<TensorView>(expr->outputs());
+    if (outputs.empty() ||
+        std::any_of(outputs.begin(), outputs.end(), [](TensorView* tv) {
+          return tv->hasDeviceMesh();
+        })) {
+      continue;
+    }
+    TensorView* ref_out = *outputs.begin();
+    std::vector<TensorView*> inputs;
+    for (auto tv : ir_utils::filterByType<TensorView>(expr->inputs())) {
+      if (tv->hasDeviceMesh()) {
+        inputs.push_back(tv);
+      }
+    }
+    if (inputs.empty()) {
+      continue;
+    }
+
+    // Cost model: the number of inputs to reshard, each of which is a
+    // communication
+    std::optional<Sharding> best;
+    int64_t best_cost = 0;
+    for (auto tv : inputs) {
+      Sharding candidate{
+          tv->getDeviceMesh(),
+          isSharded(tv) && isOutermostAxisMapped(tv, ref_out)};
+      const auto cost = std::count_if(
+          inputs.begin(), inputs.end(), [&](TensorView* input) {
+            return !hasSharding(input, ref_out, candidate);
+          });
+      if (!best.has_value() || cost < best_cost ||
+          (cost == best_cost && candidate.is_sharded && !best->is_sharded)) {
+        best = candidate;
+        best_cost = cost;
+      }
+    }
+    for (auto out : outputs) {
+      setSharding(out, *best);
+    }
+
+    const bool is_communication = expr->isA<ReductionOp>() ||
+        (expr->isA<LoadStoreOp>() &&
+         expr->as<LoadStoreOp>()->opType() == LoadStoreOpType::Set);
+    if (is_communication) {
+      continue;
+    }
+    for (auto tv : inputs) {
+      if (hasSharding(tv, ref_out, *best)) {
+        continue;
+      }
+      TensorView* resharded = set(tv);
+      setSharding(
+          resharded,
+          {best->mesh, best->is_sharded && isOutermostAxisMapped(tv, ref_out)});
+      expr = ir_utils::replaceValInExprInputs(expr, tv, resharded);
+    }
+  }
+}
+
 } // namespace nvfuser
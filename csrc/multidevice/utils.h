@@ -25,4 +25,17 @@ std::unordered_set<TensorView*> haveDifferentSharding(
 // Returns whether an Expr embbeds multi-device resharding
 bool isResharding(Expr* expr);
 
+// [ Sharding Propagation ]
+// Propagates the DeviceMeshes and shardings of the TensorViews that have a
+// mesh, typically the inputs, to the TensorViews defined from them, in
+// topological order. The outputs of an Expr take the sharding that requires
+// resharding the fewest of its inputs, among the shardings of its inputs,
+// preferring sharded ones. An output is sharded if the outermost axis of the
+// input it takes the sharding from is mapped to its own outermost axis. The
+// inputs of the Expr that don't have that sharding are resharded with an
+// inserted `set`, so that every communication is a `set` or a reduction, as
+// expected by Pipeline. Sets and reductions are not resharded, as they are
+// communications themselves.
+void propagateShardings(Fusion* fusion);
+
 } // namespace nvfuser
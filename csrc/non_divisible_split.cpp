@@ -104,6 +104,9 @@ Val* NonDivisibleSplitInfo::getMaybeNonDivisibleExtent(Split* split) const {
   std::optional<int64_t> in_extent;
   if (split->in()->extent()->isConstInt()) {
     in_extent = split->in()->extent()->evaluate().as<int64_t>();
+  } else if (GpuLower::hasCurrent()) {
+    // See [ Size-Specialized Predicate Elimination ]
+    in_extent = GpuLower::current()->getKnownDivisor(split->in()->extent());
   }
 
   std::optional<int64_t> factor;
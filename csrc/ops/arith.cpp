@@ -73,6 +73,29 @@ TensorView* maybeCastOp(DataType dtype, TensorView* v1) {
   return v1;
 }
 
+TensorView* scaledCastOp(DataType dtype, TensorView* v1, Val* scale) {
+  NVF_CHECK(
+      isFloatingPointType(dtype) && isFloatingPointType(v1->dtype()),
+      "Scaled casts are only supported between floating point types, but got ",
+      v1->dtype(),
+      " to ",
+      dtype);
+  NVF_CHECK(
+      isFloatingPointType(scale->dtype()) &&
+          (scale->isScalar() ||
+           (scale->isA<TensorView>() &&
+            TensorDomain::noReductions(
+                scale->as<TensorView>()->getMaybeRFactorDomain())
+                .empty())),
+      "The scale of a scaled cast must be a floating point scalar or 0-dim ",
+      "tensor, but got ",
+      scale->toString());
+  auto scaled =
+      mul(maybeCastOp(DataType::Float, v1),
+          maybeCastOp(DataType::Float, scale));
+  return maybeCastOp(dtype, scaled);
+}
+
 Val* bitCastOp(DataType dtype, Val* v1) {
   if (v1->getDataType().value() == dtype) {
     return v1;
@@ -1392,6 +1415,91 @@ TensorView* min(
   return reductionOp(BinaryOpType::Min, axes, init, v1, keep_dim);
 }
 
+TensorView* scan(TensorView* v1, int64_t dim, BinaryOpType scan_op_type) {
+  const auto inp_domain =
+      TensorDomain::noReductions(v1->getMaybeRFactorDomain());
+  NVF_CHECK(!inp_domain.empty(), "scan can not be applied to 0d tensor.");
+
+  if (dim < 0) {
+    dim += (int64_t)inp_domain.size();
+  }
+  NVF_CHECK(
+      dim >= 0 && dim < (int64_t)inp_domain.size(),
+      "scan on invalid axis, received: ",
+      dim,
+      " however tensor view only has ",
+      inp_domain.size(),
+      " non-reduction dims.");
+
+  NVF_CHECK(
+      !isComplexType(v1->getDataType().value()),
+      "scan is not defined for complex tensors.");
+
+  // Reduced precision and boolean types are scanned in Float and Int, as
+  // warp shuffles don't support them
+  const DataType dtype = v1->getDataType().value();
+  if (dtype == DataType::Half || dtype == DataType::BFloat16 ||
+      isFp8Type(dtype) || isBooleanType(dtype)) {
+    const DataType scan_dtype =
+        isBooleanType(dtype) ? DataType::Int : DataType::Float;
+    auto scanned = scan(castOp(scan_dtype, v1), dim, scan_op_type);
+    return castOp(dtype, scanned);
+  }
+
+  Val* init = nullptr;
+  switch (scan_op_type) {
+    case BinaryOpType::Add:
+      init = FusionGuard::getCurFusion()->zeroVal(dtype);
+      break;
+    case BinaryOpType::Mul:
+      init = FusionGuard::getCurFusion()->oneVal(dtype);
+      break;
+    case BinaryOpType::Max:
+      init = ops::getMinimumValue(dtype);
+      break;
+    case BinaryOpType::Min:
+      init = ops::getMaximumValue(dtype);
+      break;
+    default:
+      NVF_CHECK(false, "Unsupported scan op: ", scan_op_type);
+  }
+  NVF_CHECK(init != nullptr, "Missing initial value");
+
+  auto out = ops::newOutputTV({v1}, dtype);
+  IrBuilder::create<ScanOp>(scan_op_type, init, out, v1, dim);
+  return out;
+}
+
+TensorView* cumsum(TensorView* v1, int64_t dim, DataType dtype) {
+  if (dtype == DataType::Null) {
+    auto initial_v1_dtype = v1->getDataType().value();
+    if (isBooleanType(initial_v1_dtype) || isIntegralType(initial_v1_dtype)) {
+      dtype = DataType::Int;
+    }
+  }
+
+  // Cast input tensor to dtype before the operation is performed
+  if (dtype != DataType::Null) {
+    v1 = optionalCastStrict(dtype, v1)->as<TensorView>();
+  }
+  return scan(v1, dim, BinaryOpType::Add);
+}
+
+TensorView* cumprod(TensorView* v1, int64_t dim, DataType dtype) {
+  if (dtype == DataType::Null) {
+    auto initial_v1_dtype = v1->getDataType().value();
+    if (isBooleanType(initial_v1_dtype) || isIntegralType(initial_v1_dtype)) {
+      dtype = DataType::Int;
+    }
+  }
+
+  // Cast input tensor to dtype before the operation is performed
+  if (dtype != DataType::Null) {
+    v1 = optionalCastStrict(dtype, v1)->as<TensorView>();
+  }
+  return scan(v1, dim, BinaryOpType::Mul);
+}
+
 TensorView* broadcast(
     TensorView* inp,
     const std::vector<bool>& is_broadcast_dim) {
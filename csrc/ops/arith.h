@@ -31,6 +31,12 @@ TensorView* castOp(DataType dtype, TensorView* v1);
 // If v1 is not dtype, insert a cast op, otherwise return v1
 Val* maybeCastOp(DataType dtype, Val* v1);
 TensorView* maybeCastOp(DataType dtype, TensorView* v1);
+// Per-tensor scaled cast of FP8 quantization: multiplies v1 by scale in float
+// and casts the product to dtype. To quantize, dtype is an FP8 type and scale
+// the inverse of the quantization scale. To dequantize, v1 is an FP8 tensor
+// and scale the quantization scale. scale is a scalar or a 0-dim tensor.
+// Casts to FP8 saturate to the largest finite value.
+TensorView* scaledCastOp(DataType dtype, TensorView* v1, Val* scale);
 
 Val* bitCastOp(DataType dtype, Val* v1);
 TensorView* bitCastOp(DataType dtype, TensorView* v1);
@@ -584,6 +590,26 @@ TensorView* min(
     bool keep_dim = false,
     DataType dtype = DataType::Null);
 
+// SCAN OPERATIONS
+//! Inclusive scan of v1 along dim with Add, Mul, Max or Min, starting from
+//! the identity of the op. See [ Scan Scheduler ] for the fusions with scans
+//! that can be scheduled.
+TensorView* scan(TensorView* v1, int64_t dim, BinaryOpType scan_op_type);
+
+//! torch.cumsum. Boolean and integral tensors are summed as Int unless a
+//! dtype is given.
+TensorView* cumsum(
+    TensorView* v1,
+    int64_t dim,
+    DataType dtype = DataType::Null);
+
+//! torch.cumprod. Boolean and integral tensors are multiplied as Int unless
+//! a dtype is given.
+TensorView* cumprod(
+    TensorView* v1,
+    int64_t dim,
+    DataType dtype = DataType::Null);
+
 // COMPOUND OPERATIONS
 // add_alpha
 Val* add_alpha(Val* v1, Val* v2, Val* s);
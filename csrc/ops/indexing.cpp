@@ -200,6 +200,27 @@ TensorView* scatter(
   return scatterOp(ScatterOpType::Set, self, dim, index, src);
 }
 
+TensorView* scatter_add(
+    TensorView* self,
+    int dim,
+    TensorView* index,
+    TensorView* src) {
+  NVF_CHECK(
+      self->getDataType() == src->getDataType(),
+      "scatter_add requires self and src of the same type, but got ",
+      self->getDataType().value(),
+      " and ",
+      src->getDataType().value());
+  NVF_CHECK(
+      self->getDataType() == DataType::Float ||
+          self->getDataType() == DataType::Double ||
+          self->getDataType() == DataType::Int ||
+          self->getDataType() == DataType::Int32,
+      "scatter_add is only supported for types with atomic additions, but got ",
+      self->getDataType().value());
+  return scatterOp(ScatterOpType::Add, self, dim, index, src);
+}
+
 TensorView* take_along_axis(TensorView* inp, TensorView* index, int64_t dim) {
   const auto inp_domain =
       TensorDomain::noReductions(inp->getMaybeRFactorDomain());
@@ -276,4 +297,94 @@ TensorView* take_along_axis(TensorView* inp, TensorView* index, int64_t dim) {
   return out_tensor->as<TensorView>();
 }
 
+SortResult sort(TensorView* input, int64_t dim, bool descending) {
+  const auto inp_domain =
+      TensorDomain::noReductions(input->getMaybeRFactorDomain());
+  NVF_CHECK(!inp_domain.empty(), "sort can not be applied to 0d tensor.");
+  NVF_CHECK(
+      !isComplexType(input->getDataType().value()),
+      "sort is not defined for complex tensors.");
+
+  if (dim < 0) {
+    dim += (int64_t)inp_domain.size();
+  }
+
+  NVF_CHECK(
+      dim >= 0 && dim < (int64_t)inp_domain.size(),
+      "sort on invalid axis, received: ",
+      dim,
+      " however tensor view only has ",
+      inp_domain.size(),
+      " non-reduction dims.");
+
+  auto values = ops::newOutputTV({input}, input->getDataType().value());
+  auto indices = ops::newOutputTV({input}, DataType::Int);
+  IrBuilder::create<SortOp>(values, indices, input, dim, descending);
+  return {values, indices};
+}
+
+SortResult topk(TensorView* input, int64_t k, int64_t dim, bool largest) {
+  NVF_CHECK(k >= 0, "topk needs a non-negative k, but received: ", k);
+  auto sorted = sort(input, dim, /*descending=*/largest);
+
+  const auto ndims = (int64_t)sorted.values->getMaybeRFactorDomain().size();
+  if (dim < 0) {
+    dim += ndims;
+  }
+  std::vector<Slice> ranges(ndims);
+  ranges.at(dim).stop = IrBuilder::create<Val>(k, DataType::Index);
+  return {slice(sorted.values, ranges), slice(sorted.indices, ranges)};
+}
+
+CompactResult compact(TensorView* input, TensorView* mask, int64_t dim) {
+  NVF_CHECK(input != nullptr && mask != nullptr, "Input is invalid.");
+  NVF_CHECK(
+      mask->getDataType().value() == DataType::Bool,
+      "compact expects a boolean mask, but received: ",
+      mask->getDataType().value());
+  const auto inp_domain =
+      TensorDomain::noReductions(input->getMaybeRFactorDomain());
+  NVF_CHECK(!inp_domain.empty(), "compact can not be applied to 0d tensor.");
+  NVF_CHECK(
+      TensorDomain::noReductions(mask->getMaybeRFactorDomain()).size() ==
+          inp_domain.size(),
+      "The mask of compact must have the dimensions of the input.");
+
+  const auto ndims = (int64_t)inp_domain.size();
+  if (dim < 0) {
+    dim += ndims;
+  }
+  NVF_CHECK(
+      dim >= 0 && dim < ndims,
+      "compact on invalid axis, received: ",
+      dim,
+      " however tensor view only has ",
+      ndims,
+      " non-reduction dims.");
+
+  // Selected elements up to and including each element, and in its row
+  TensorView* selected = cumsum(mask, dim, DataType::Int);
+  TensorView* count =
+      sum(castOp(DataType::Int, mask), {(int)dim}, /*keep_dim=*/true);
+
+  std::vector<bool> broadcast_mask(ndims, true);
+  broadcast_mask.at(dim) = false;
+  Fusion* fusion = input->fusion();
+  TensorView* positions = broadcast(
+      iota(
+          inp_domain.at(dim)->extent(),
+          fusion->zeroVal(DataType::Int),
+          fusion->oneVal(DataType::Int),
+          DataType::Int),
+      broadcast_mask);
+
+  // A selected element goes after the selected ones before it, and another
+  // one after all the selected ones and the others before it
+  TensorView* index =
+      where(mask,
+            sub(selected, fusion->oneVal(DataType::Int)),
+            add(count, sub(positions, selected)));
+  return {scatter(input, (int)dim, index, input), count};
+}
+
 } // namespace nvfuser
@@ -37,10 +37,59 @@ TensorView* scatter(
     TensorView* index,
     TensorView* src);
 
+//! torch.scatter_add. Elements of src with the same index are accumulated
+//! with atomics, see [ Scatter Accumulation ] in runtime/scatter.cu, so the
+//! order of the additions is not deterministic. In generated kernels, self
+//! must be a fusion input and the result a fusion output, and index and src
+//! must have the same shape as self.
+TensorView* scatter_add(
+    TensorView* self,
+    int dim,
+    TensorView* index,
+    TensorView* src);
+
 //! numpy.take_along_axis
 //! (https://numpy.org/doc/stable/reference/generated/numpy.take_along_axis.html)
 //! Note the order of the parameters follows the numpy order, which is
 //! different from torch_gather.
 TensorView* take_along_axis(TensorView* input, TensorView* index, int64_t dim);
 
+struct SortResult {
+  TensorView* values = nullptr;
+  TensorView* indices = nullptr;
+};
+
+//! torch.sort with stable=True. The indices are of type Int. See
+//! [ Sort Scheduler ] for the fusions with sorts that can be scheduled.
+SortResult sort(TensorView* input, int64_t dim = -1, bool descending = false);
+
+//! torch.topk with sorted=True, i.e., a sort followed by a slice of the
+//! first k elements along dim
+SortResult topk(
+    TensorView* input,
+    int64_t k,
+    int64_t dim = -1,
+    bool largest = true);
+
+struct CompactResult {
+  TensorView* values = nullptr;
+  TensorView* count = nullptr;
+};
+
+//! Stable compaction of the elements of input whose mask is true along dim,
+//! e.g., for masked_select, or nonzero with an iota as input, without
+//! knowing the number of selected elements on the host. values has the
+//! shape of input, an upper bound of the selected elements: the first count
+//! elements of each row along dim are the selected ones in order, followed
+//! by the others in order. count is the Int number of selected elements of
+//! each row, with dim kept as a broadcast, and stays on the device, e.g.,
+//! downstream ops mask the rows with lt(iota, count) instead of the host
+//! reading it to allocate exact outputs.
+//!
+//! The position of each element is computed with a cumsum of the mask, and
+//! the elements are written there with a scatter, as the positions are a
+//! permutation of the row. See [ Scan Scheduler ] for the rows that can be
+//! scanned.
+CompactResult compact(TensorView* input, TensorView* mask, int64_t dim = -1);
+
 } // namespace nvfuser
@@ -6,8 +6,12 @@
  */
 // clang-format on
 #include <ir/builder.h>
+#include <ops/alias.h>
 #include <ops/arith.h>
 #include <ops/normalization.h>
+#include <options.h>
+
+#include <limits>
 
 namespace nvfuser {
 
@@ -143,6 +147,90 @@ TensorView* standard_deviation(
   return sqrt(variance(x, dims, unbiased, keepdim));
 }
 
+namespace {
+
+// [ Online Softmax ]
+//
+// softmax computes the max of a row, then the sum of the exponentials of the
+// row minus the max, and then normalizes the row. When the row doesn't fit in
+// registers or shared memory, e.g., a vocabulary of 128k or more elements,
+// the fusion is segmented and the row is read once per step.
+//
+// With EnableOption::OnlineSoftmax, the max and the sum are instead computed
+// in one pass over chunks of the row. The row is padded with -inf to a
+// multiple of the chunk size and reshaped to [num_chunks, chunk]. Each chunk
+// gets its own max m_c and sum s_c = sum(exp(x - m_c)), which is a
+// normalization small enough to be persistent. The statistics of the chunks
+// are then combined by rescaling each sum to the max of the row M:
+//
+//   S = sum_c(s_c * exp(m_c - M))
+//
+// so the row is read once for the statistics and once for the outputs.
+// Chunks of only -inf get a sum of zero instead of NaN.
+constexpr int64_t kOnlineSoftmaxChunkSize = 4096;
+
+bool useOnlineSoftmax(TensorView* x, int axis) {
+  if (!isOptionEnabled(EnableOption::OnlineSoftmax)) {
+    return false;
+  }
+  // A row known to fit in a chunk gains nothing from chunking
+  Val* extent =
+      TensorDomain::noReductions(x->getMaybeRFactorDomain()).at(axis)->extent();
+  return !extent->isConstInt() ||
+      extent->evaluate().as<int64_t>() > kOnlineSoftmaxChunkSize;
+}
+
+// Returns the max and the sum of the exponentials of x along axis, both
+// with axis kept as a broadcast domain. See [ Online Softmax ].
+std::pair<TensorView*, TensorView*> onlineSoftmaxStatistics(
+    TensorView* x,
+    int axis) {
+  const auto root = TensorDomain::noReductions(x->getMaybeRFactorDomain());
+  const int num_dims = (int)root.size();
+
+  Val* extent = root.at(axis)->extent();
+  Val* chunk_size =
+      IrBuilder::create<Val>(kOnlineSoftmaxChunkSize, DataType::Index);
+  Val* num_chunks = ceilDiv(extent, chunk_size);
+
+  // pad_widths starts from the innermost dimension
+  std::vector<Val*> pad_widths(
+      2 * (num_dims - axis), x->fusion()->zeroVal(DataType::Index));
+  pad_widths.back() = sub(mul(num_chunks, chunk_size), extent);
+  Val* neg_inf =
+      IrBuilder::create<Val>(-std::numeric_limits<double>::infinity());
+  TensorView* padded = pad(x, pad_widths, neg_inf);
+
+  std::vector<Val*> chunked_sizes;
+  for (const auto i : c10::irange(num_dims)) {
+    if (i == axis) {
+      chunked_sizes.push_back(num_chunks);
+      chunked_sizes.push_back(chunk_size);
+    } else {
+      chunked_sizes.push_back(root.at(i)->extent());
+    }
+  }
+  TensorView* chunked = reshape(padded, chunked_sizes);
+
+  std::vector<bool> chunk_broadcast_mask(num_dims + 1, false);
+  chunk_broadcast_mask[axis + 1] = true;
+  TensorView* chunk_max = max(chunked, {axis + 1});
+  TensorView* safe_chunk_max =
+      where(eq(chunk_max, neg_inf), x->fusion()->zeroVal(), chunk_max);
+  TensorView* chunk_sum =
+      sum(exp(sub(chunked, broadcast(safe_chunk_max, chunk_broadcast_mask))),
+          {axis + 1});
+
+  TensorView* row_max = max(chunk_max, {axis}, true /* keepdim */);
+  TensorView* row_sum =
+      sum(mul(chunk_sum, exp(sub(chunk_max, row_max))),
+          {axis},
+          true /* keepdim */);
+  return {row_max, row_sum};
+}
+
+} // namespace
+
 TensorView* softmax(TensorView* x, int dim) {
   NVF_ERROR(x != nullptr, "Input is invalid.");
 
@@ -151,6 +239,11 @@ TensorView* softmax(TensorView* x, int dim) {
   const int kReductionAxis = (dim < 0) ? dim + (int)kNumberOfDims : dim;
   NVF_ERROR(kReductionAxis >= 0 && kReductionAxis < (int)kNumberOfDims);
 
+  if (useOnlineSoftmax(x, kReductionAxis)) {
+    auto [bcast_max, bcast_sum] = onlineSoftmaxStatistics(x, kReductionAxis);
+    return mul(exp(sub(x, bcast_max)), reciprocal(bcast_sum));
+  }
+
   std::vector<bool> broadcast_mask(kNumberOfDims, false);
   broadcast_mask[kReductionAxis] = true;
 
@@ -194,6 +287,11 @@ TensorView* log_softmax(TensorView* x, int dim) {
   const int kReductionAxis = (dim < 0) ? dim + (int)kNumberOfDims : dim;
   NVF_ERROR(kReductionAxis >= 0 && kReductionAxis < (int)kNumberOfDims);
 
+  if (useOnlineSoftmax(x, kReductionAxis)) {
+    auto [bcast_max, bcast_sum] = onlineSoftmaxStatistics(x, kReductionAxis);
+    return sub(sub(x, bcast_max), log(bcast_sum));
+  }
+
   std::vector<bool> broadcast_mask(kNumberOfDims, false);
   broadcast_mask[kReductionAxis] = true;
 
@@ -225,6 +323,177 @@ TensorView* log_softmax_backward(TensorView* dy, TensorView* y, int dim) {
   return dx;
 }
 
+namespace {
+
+struct LogitsChunk {
+  //! Float logits of the slice, [tokens, chunk]
+  TensorView* logits = nullptr;
+  //! Whether each logit is the one of the target of its token
+  TensorView* is_target = nullptr;
+  //! Float slice of the weight, [chunk, hidden]
+  TensorView* weight = nullptr;
+};
+
+void checkLinearCrossEntropyInputs(
+    TensorView* x,
+    TensorView* weight,
+    TensorView* target,
+    int64_t num_chunks) {
+  NVF_CHECK(
+      x != nullptr && weight != nullptr && target != nullptr,
+      "Input is invalid.");
+  NVF_CHECK(
+      TensorDomain::noReductions(x->getMaybeRFactorDomain()).size() == 2 &&
+          TensorDomain::noReductions(weight->getMaybeRFactorDomain())
+                  .size() == 2 &&
+          TensorDomain::noReductions(target->getMaybeRFactorDomain())
+                  .size() == 1,
+      "Expected x of [tokens, hidden], weight of [vocab, hidden] and target ",
+      "of [tokens]");
+  NVF_CHECK(isIntegralType(target->dtype()), "Expected integral targets");
+  NVF_CHECK(num_chunks > 0, "Expected a positive number of chunks");
+}
+
+// Logits of chunk of the num_chunks slices of the vocabulary. See
+// [ Linear Cross Entropy ].
+LogitsChunk linearCrossEntropyChunk(
+    TensorView* x,
+    TensorView* weight,
+    TensorView* target,
+    int64_t chunk,
+    int64_t num_chunks) {
+  Val* vocab =
+      TensorDomain::noReductions(weight->getMaybeRFactorDomain())
+          .at(0)
+          ->extent();
+  Val* chunk_size = ceilDiv(
+      vocab, IrBuilder::create<Val>(num_chunks, DataType::Index));
+  // Slices past the vocabulary are empty
+  Val* start = mul(chunk_size, IrBuilder::create<Val>(chunk, DataType::Index));
+  Val* stop = add(start, chunk_size);
+
+  LogitsChunk result;
+  result.weight = maybeCastOp(
+      DataType::Float, slice(weight, {Slice{start, stop}, Slice()}));
+  TensorView* x_float = maybeCastOp(DataType::Float, x);
+  result.logits =
+      sum(mul(broadcast(x_float, {false, true, false}),
+              broadcast(result.weight, {true, false, false})),
+          {2});
+
+  Val* length =
+      TensorDomain::noReductions(result.weight->getMaybeRFactorDomain())
+          .at(0)
+          ->extent();
+  TensorView* ids = iota(
+      length,
+      SimplifyingIrBuilder::maybeCastExpr(DataType::Int, start),
+      x->fusion()->oneVal(DataType::Int),
+      DataType::Int);
+  result.is_target =
+      eq(broadcast(ids, {true, false}),
+         broadcast(maybeCastOp(DataType::Int, target), {false, true}));
+  return result;
+}
+
+} // namespace
+
+ForwardLinearCrossEntropyResult linear_cross_entropy(
+    TensorView* x,
+    TensorView* weight,
+    TensorView* target,
+    int64_t num_chunks) {
+  checkLinearCrossEntropyInputs(x, weight, target, num_chunks);
+
+  Val* neg_inf =
+      IrBuilder::create<Val>(-std::numeric_limits<double>::infinity());
+  std::vector<TensorView*> chunk_maxes;
+  std::vector<TensorView*> chunk_sums;
+  TensorView* target_logit = nullptr;
+  for (const auto chunk : c10::irange(num_chunks)) {
+    LogitsChunk logits_chunk =
+        linearCrossEntropyChunk(x, weight, target, chunk, num_chunks);
+    TensorView* logits = logits_chunk.logits;
+    // Empty slices of a small vocabulary get a max of zero and a sum of
+    // zero instead of NaN
+    TensorView* chunk_max = max(logits, {1});
+    chunk_max =
+        where(eq(chunk_max, neg_inf), x->fusion()->zeroVal(), chunk_max);
+    chunk_maxes.push_back(chunk_max);
+    chunk_sums.push_back(
+        sum(exp(sub(logits, broadcast(chunk_max, {false, true}))), {1}));
+    TensorView* chunk_target =
+        sum(where(logits_chunk.is_target, logits, x->fusion()->zeroVal()),
+            {1});
+    target_logit = target_logit == nullptr ? chunk_target
+                                           : add(target_logit, chunk_target);
+  }
+
+  TensorView* row_max = chunk_maxes.front();
+  for (TensorView* chunk_max : chunk_maxes) {
+    row_max = where(gt(chunk_max, row_max), chunk_max, row_max);
+  }
+  TensorView* row_sum = nullptr;
+  for (const auto chunk : c10::irange(num_chunks)) {
+    TensorView* rescaled = mul(
+        chunk_sums.at(chunk), exp(sub(chunk_maxes.at(chunk), row_max)));
+    row_sum = row_sum == nullptr ? rescaled : add(row_sum, rescaled);
+  }
+
+  ForwardLinearCrossEntropyResult result;
+  result.log_sum_exp = add(row_max, log(row_sum));
+  result.loss = sub(result.log_sum_exp, target_logit);
+  return result;
+}
+
+BackwardLinearCrossEntropyResult linear_cross_entropy_backward(
+    TensorView* grad_loss,
+    TensorView* x,
+    TensorView* weight,
+    TensorView* target,
+    TensorView* log_sum_exp,
+    int64_t num_chunks) {
+  checkLinearCrossEntropyInputs(x, weight, target, num_chunks);
+  NVF_CHECK(
+      grad_loss != nullptr && log_sum_exp != nullptr, "Input is invalid.");
+
+  TensorView* x_float = maybeCastOp(DataType::Float, x);
+  TensorView* bcast_grad_loss =
+      broadcast(maybeCastOp(DataType::Float, grad_loss), {false, true});
+  TensorView* bcast_log_sum_exp =
+      broadcast(maybeCastOp(DataType::Float, log_sum_exp), {false, true});
+  TensorView* grad_input = nullptr;
+  std::vector<TensorView*> grad_weight_chunks;
+  for (const auto chunk : c10::irange(num_chunks)) {
+    LogitsChunk logits_chunk =
+        linearCrossEntropyChunk(x, weight, target, chunk, num_chunks);
+    TensorView* softmax = exp(sub(logits_chunk.logits, bcast_log_sum_exp));
+    TensorView* grad_logits = mul(
+        sub(softmax, castOp(DataType::Float, logits_chunk.is_target)),
+        bcast_grad_loss);
+    TensorView* bcast_grad_logits =
+        broadcast(grad_logits, {false, false, true});
+
+    TensorView* grad_input_chunk =
+        sum(mul(bcast_grad_logits,
+                broadcast(logits_chunk.weight, {true, false, false})),
+            {1});
+    grad_input = grad_input == nullptr ? grad_input_chunk
+                                       : add(grad_input, grad_input_chunk);
+    grad_weight_chunks.push_back(
+        sum(mul(bcast_grad_logits, broadcast(x_float, {false, true, false})),
+            {0}));
+  }
+
+  BackwardLinearCrossEntropyResult result;
+  result.grad_input = maybeCastOp(x->dtype(), grad_input);
+  result.grad_weight = maybeCastOp(
+      weight->dtype(),
+      grad_weight_chunks.size() == 1 ? grad_weight_chunks.front()
+                                     : cat(grad_weight_chunks, 0));
+  return result;
+}
+
 ForwardNormResult layer_norm(
     TensorView* x,
     const std::vector<int64_t>& norm_shape,
@@ -51,13 +51,25 @@ struct VarMeanResult {
   TensorView* mean = nullptr;
 };
 
+struct ForwardLinearCrossEntropyResult {
+  TensorView* loss = nullptr;
+  TensorView* log_sum_exp = nullptr;
+};
+
+struct BackwardLinearCrossEntropyResult {
+  TensorView* grad_input = nullptr;
+  TensorView* grad_weight = nullptr;
+};
+
 } // namespace nvfuser
 
 namespace std {
 
 // Make these results behave like a std::tuple
+using nvfuser::BackwardLinearCrossEntropyResult;
 using nvfuser::BackwardNormResult;
 using nvfuser::BackwardRMSNormResult;
+using nvfuser::ForwardLinearCrossEntropyResult;
 using nvfuser::ForwardNormResult;
 using nvfuser::ForwardRMSNormResult;
 using nvfuser::TensorView;
@@ -124,6 +136,28 @@ constexpr TensorView* get(const VarMeanResult& results) {
   return nullptr;
 }
 
+template <int i>
+constexpr TensorView* get(const ForwardLinearCrossEntropyResult& results) {
+  if (i == 0) {
+    return results.loss;
+  }
+  if (i == 1) {
+    return results.log_sum_exp;
+  }
+  return nullptr;
+}
+
+template <int i>
+constexpr TensorView* get(const BackwardLinearCrossEntropyResult& results) {
+  if (i == 0) {
+    return results.grad_input;
+  }
+  if (i == 1) {
+    return results.grad_weight;
+  }
+  return nullptr;
+}
+
 } // namespace std
 
 namespace nvfuser {
@@ -162,6 +196,41 @@ TensorView* log_softmax(TensorView* x, int dim);
 
 TensorView* log_softmax_backward(TensorView* dy, TensorView* y, const int dim);
 
+//! [ Linear Cross Entropy ]
+//!
+//! The cross entropy loss of a language model head,
+//!   loss[t] = logsumexp(logits[t, :]) - logits[t, target[t]]
+//! with logits = x @ weight^T, where x is [tokens, hidden], weight is
+//! [vocab, hidden] and target is [tokens] in [0, vocab). For a large
+//! vocabulary, the logits are the largest tensor of a training step. Here
+//! they are computed in num_chunks slices of the vocabulary, each of which
+//! is reduced to its max m_c, sum of exponentials s_c and target logit
+//! right away, and the statistics are combined as in [ Online Softmax ]:
+//!   log_sum_exp = M + log(sum_c(s_c * exp(m_c - M)))
+//! So a segment only materializes the logits of its slice, which are freed
+//! after the last segment reading them, see [ Memory-Aware Segment Order ].
+//! The loss and log_sum_exp are Float.
+//!
+//! The backward recomputes the logits of each slice from x and weight and
+//! the saved log_sum_exp instead of saving the softmax:
+//!   grad_logits = (exp(logits - log_sum_exp) - onehot(target)) * grad_loss
+//!   grad_input = sum_c(grad_logits_c @ weight_c)
+//!   grad_weight_c = grad_logits_c^T @ x
+//! The gradients have the dtypes of x and weight.
+ForwardLinearCrossEntropyResult linear_cross_entropy(
+    TensorView* x,
+    TensorView* weight,
+    TensorView* target,
+    int64_t num_chunks);
+
+BackwardLinearCrossEntropyResult linear_cross_entropy_backward(
+    TensorView* grad_loss,
+    TensorView* x,
+    TensorView* weight,
+    TensorView* target,
+    TensorView* log_sum_exp,
+    int64_t num_chunks);
+
 ForwardNormResult layer_norm(
     TensorView* x,
     const std::vector<int64_t>& norm_shape,
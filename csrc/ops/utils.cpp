@@ -347,6 +347,15 @@ Val* getMinimumValue(DataType v) {
       return IrBuilder::create<Val>(
           static_cast<double>(-std::numeric_limits<c10::BFloat16>::infinity()));
       break;
+    case DataType::Float8_e4m3fn:
+      // e4m3 has no infinity
+      return IrBuilder::create<Val>(static_cast<double>(
+          std::numeric_limits<c10::Float8_e4m3fn>::lowest()));
+      break;
+    case DataType::Float8_e5m2:
+      return IrBuilder::create<Val>(-static_cast<double>(
+          std::numeric_limits<c10::Float8_e5m2>::infinity()));
+      break;
     case (DataType::Int):
       return IrBuilder::create<Val>(std::numeric_limits<int64_t>::lowest());
       break;
@@ -354,6 +363,10 @@ Val* getMinimumValue(DataType v) {
       return IrBuilder::create<Val>(
           (int64_t)std::numeric_limits<int32_t>::lowest());
       break;
+    case (DataType::Int8):
+      return IrBuilder::create<Val>(
+          (int64_t)std::numeric_limits<int8_t>::lowest());
+      break;
     case (DataType::Bool):
       return IrBuilder::create<Val>(false);
       break;
@@ -383,6 +396,15 @@ Val* getMaximumValue(DataType v) {
       return IrBuilder::create<Val>(
           static_cast<double>(std::numeric_limits<c10::BFloat16>::infinity()));
       break;
+    case DataType::Float8_e4m3fn:
+      // e4m3 has no infinity
+      return IrBuilder::create<Val>(
+          static_cast<double>(std::numeric_limits<c10::Float8_e4m3fn>::max()));
+      break;
+    case DataType::Float8_e5m2:
+      return IrBuilder::create<Val>(static_cast<double>(
+          std::numeric_limits<c10::Float8_e5m2>::infinity()));
+      break;
     case (DataType::Int):
       return IrBuilder::create<Val>(std::numeric_limits<int64_t>::max());
       break;
@@ -390,6 +412,10 @@ Val* getMaximumValue(DataType v) {
       return IrBuilder::create<Val>(
           (int64_t)std::numeric_limits<int32_t>::max());
       break;
+    case (DataType::Int8):
+      return IrBuilder::create<Val>(
+          (int64_t)std::numeric_limits<int8_t>::max());
+      break;
     case (DataType::Bool):
       return IrBuilder::create<Val>(true);
       break;
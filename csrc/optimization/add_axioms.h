@@ -15,6 +15,9 @@ class AddAxiomsPass : public OptimizationPass<AddAxiomsPass> {
 
  protected:
   static void runPass(Fusion* fusion);
+  static std::string name() {
+    return "AddAxiomsPass";
+  }
 };
 
 } // namespace nvfuser::optimization
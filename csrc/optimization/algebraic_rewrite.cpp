@@ -0,0 +1,170 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <optimization/algebraic_rewrite.h>
+
+#include <debug.h>
+#include <ir/utils.h>
+#include <ops/alias.h>
+#include <ops/arith.h>
+#include <ops/utils.h>
+#include <options.h>
+
+namespace nvfuser::optimization {
+
+namespace {
+
+void logRewrite(const char* rewrite, Expr* expr) {
+  if (isDebugDumpEnabled(DebugDumpOption::PreSegmenterLogging)) {
+    debug() << "AlgebraicRewritePass: " << rewrite << " of "
+            << expr->toString();
+  }
+}
+
+// Fusion outputs, including the aliased ones, are kept as they are
+bool isReplaceable(Val* val) {
+  return !val->isFusionOutput();
+}
+
+// Returns the permutation of expr if it's a permute, see
+// ir_utils::computePermutation
+std::optional<std::vector<int64_t>> getPermutation(Expr* expr) {
+  auto ldst = dynamic_cast<LoadStoreOp*>(expr);
+  if (ldst == nullptr || ldst->opType() != LoadStoreOpType::Set) {
+    return std::nullopt;
+  }
+  auto out = dynamic_cast<TensorView*>(ldst->out());
+  if (out == nullptr || !out->hasRFactor()) {
+    return std::nullopt;
+  }
+  return ir_utils::computePermutation(
+      out->getRootDomain(), out->getMaybeRFactorDomain());
+}
+
+// Computes a pointwise op before the broadcast of all its tensor inputs
+bool hoistBroadcast(Fusion* fusion, Expr* expr) {
+  if (!expr->isOneOf<UnaryOp, BinaryOp, TernaryOp>() ||
+      expr->outputs().size() != 1 || !expr->output(0)->isA<TensorView>() ||
+      !isReplaceable(expr->output(0))) {
+    return false;
+  }
+
+  const std::vector<bool>* flags = nullptr;
+  std::vector<Val*> inputs;
+  for (Val* in : expr->inputs()) {
+    if (!in->isA<TensorView>()) {
+      inputs.push_back(in);
+      continue;
+    }
+    auto bcast = dynamic_cast<BroadcastOp*>(in->definition());
+    if (bcast == nullptr ||
+        (flags != nullptr && *flags != bcast->getBroadcastDimFlags())) {
+      return false;
+    }
+    flags = &bcast->getBroadcastDimFlags();
+    inputs.push_back(bcast->in());
+  }
+  if (flags == nullptr) {
+    return false;
+  }
+
+  logRewrite("hoisting the broadcast", expr);
+  Val* out = expr->output(0);
+  TensorView* hoisted_out = ops::newOutputTV(inputs, out->dtype());
+  expr->newObjectFunc()(
+      expr->container(), inputs, {hoisted_out}, expr->attributes());
+  ir_utils::replaceValue(fusion, {{out, broadcast(hoisted_out, *flags)}});
+  return true;
+}
+
+// Casts to a narrower type before a permute
+bool castBeforePermute(Fusion* fusion, Expr* expr) {
+  auto cast = dynamic_cast<UnaryOp*>(expr);
+  if (cast == nullptr || cast->getUnaryOpType() != UnaryOpType::Cast ||
+      !cast->in()->isA<TensorView>() || !isReplaceable(cast->out()) ||
+      !isReplaceable(cast->in()) || cast->in()->uses().size() != 1 ||
+      dataTypeSize(cast->out()->dtype()) >= dataTypeSize(cast->in()->dtype())) {
+    return false;
+  }
+  Expr* permute_expr = cast->in()->definition();
+  const std::optional<std::vector<int64_t>> permutation =
+      getPermutation(permute_expr);
+  if (!permutation.has_value()) {
+    return false;
+  }
+
+  logRewrite("casting before the permute", expr);
+  TensorView* narrow_in =
+      castOp(cast->out()->dtype(), permute_expr->input(0)->as<TensorView>());
+  ir_utils::replaceValue(
+      fusion, {{cast->out(), permute(narrow_in, *permutation)}});
+  return true;
+}
+
+// Removes permute(permute(x)) and squeeze(broadcast(x)) that give back x
+bool removeRoundTrip(Fusion* fusion, Expr* expr) {
+  if (expr->inputs().empty() || expr->outputs().size() != 1 ||
+      !isReplaceable(expr->output(0)) ||
+      expr->input(0)->definition() == nullptr) {
+    return false;
+  }
+  Expr* producer = expr->input(0)->definition();
+  Val* round_trip_in = nullptr;
+
+  auto squeeze = dynamic_cast<SqueezeOp*>(expr);
+  auto bcast = dynamic_cast<BroadcastOp*>(producer);
+  const std::optional<std::vector<int64_t>> permutation = getPermutation(expr);
+  const std::optional<std::vector<int64_t>> producer_permutation =
+      getPermutation(producer);
+  if (squeeze != nullptr && bcast != nullptr &&
+      bcast->getBroadcastDimFlags() == squeeze->getSqueezeDimFlags()) {
+    round_trip_in = bcast->in();
+  } else if (permutation.has_value() && producer_permutation.has_value()) {
+    // out[i] == in[producer_permutation[permutation[i]]]
+    bool is_identity = true;
+    for (const auto i : c10::irange(permutation->size())) {
+      is_identity = is_identity &&
+          producer_permutation->at(permutation->at(i)) == (int64_t)i;
+    }
+    if (is_identity) {
+      round_trip_in = producer->input(0);
+    }
+  }
+  if (round_trip_in == nullptr) {
+    return false;
+  }
+
+  logRewrite("removing the round trip", expr);
+  ir_utils::replaceValue(fusion, {{expr->output(0), round_trip_in}});
+  return true;
+}
+
+// Applies the first rewrite it finds and returns true, or returns false if
+// there is none
+bool rewrite(Fusion* fusion) {
+  for (auto expr : fusion->exprs()) {
+    if (hoistBroadcast(fusion, expr) || castBeforePermute(fusion, expr) ||
+        removeRoundTrip(fusion, expr)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+} // namespace
+
+void AlgebraicRewritePass::runPass(Fusion* fusion) {
+  if (!isOptionEnabled(EnableOption::AlgebraicRewrite)) {
+    return;
+  }
+  FusionGuard fg(fusion);
+  // Each rewrite replaces expressions, so start over after each one
+  while (rewrite(fusion)) {
+  }
+}
+
+} // namespace nvfuser::optimization
@@ -0,0 +1,36 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <optimization/optimization_pass.h>
+
+namespace nvfuser::optimization {
+
+//! [ Algebraic Rewrites ]
+//!
+//! With NVFUSER_ENABLE=algebraic_rewrite, AlgebraicRewritePass rewrites the
+//! fusion before segmentation so that fewer or narrower elements are
+//! computed and moved, without changing any result:
+//!  - A pointwise op whose tensor inputs are all broadcast the same way is
+//!    computed before the broadcast, e.g., relu(broadcast(x)) becomes
+//!    broadcast(relu(x)). This includes casts.
+//!  - A cast to a narrower type of a permute is done before the permute, so
+//!    the transpose moves the narrower elements.
+//!  - A permute of a permute and a squeeze of a broadcast that give back
+//!    their input are removed.
+//! Intermediates that are fusion outputs are kept as they are. Each rewrite
+//! is printed with NVFUSER_DUMP=pre_segmenter_logging.
+class AlgebraicRewritePass : public OptimizationPass<AlgebraicRewritePass> {
+  friend class OptimizationPass<AlgebraicRewritePass>;
+
+ protected:
+  static void runPass(Fusion* fusion);
+  static std::string name() {
+    return "AlgebraicRewritePass";
+  }
+};
+
+} // namespace nvfuser::optimization
@@ -0,0 +1,136 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <optimization/allocation_order_inference.h>
+
+#include <debug.h>
+#include <ir/utils.h>
+#include <options.h>
+#include <root_domain_map.h>
+
+#include <algorithm>
+#include <optional>
+
+namespace nvfuser::optimization {
+
+namespace {
+
+// The allocation domain of tv if it permutes the logical domain
+std::optional<std::vector<IterDomain*>> getAllocationOrder(TensorView* tv) {
+  if (!tv->hasAllocation()) {
+    return std::nullopt;
+  }
+  const std::vector<IterDomain*>& alloc = tv->getAllocationDomain();
+  const std::vector<IterDomain*>& logical = tv->getMaybeRFactorDomain();
+  if (alloc.size() != logical.size() ||
+      !std::is_permutation(alloc.begin(), alloc.end(), logical.begin())) {
+    return std::nullopt;
+  }
+  return alloc;
+}
+
+int64_t countConcreteIds(TensorView* tv) {
+  const std::vector<IterDomain*>& logical = tv->getMaybeRFactorDomain();
+  return std::count_if(logical.begin(), logical.end(), [](IterDomain* id) {
+    return !id->isBroadcast() && !id->isReduction();
+  });
+}
+
+// Orders the root domain of consumer as producer_order orders the root
+// domain of producer, see [ Allocation Order Inference ]
+std::vector<IterDomain*> mapOrder(
+    TensorView* producer,
+    const std::vector<IterDomain*>& producer_order,
+    TensorView* consumer) {
+  const std::unordered_map<IterDomain*, IterDomain*> p2c =
+      PairwiseRootDomainMap(producer, consumer)
+          .mapSymbolic(true)
+          .mapProducerToConsumer();
+  std::vector<IterDomain*> mapped_order;
+  std::unordered_set<IterDomain*> mapped;
+  for (IterDomain* producer_id : producer_order) {
+    auto it = p2c.find(producer_id);
+    if (it != p2c.end() && mapped.insert(it->second).second) {
+      mapped_order.push_back(it->second);
+    }
+  }
+  std::vector<IterDomain*> order;
+  for (IterDomain* consumer_id : consumer->getRootDomain()) {
+    if (!mapped.count(consumer_id)) {
+      order.push_back(consumer_id);
+    }
+  }
+  order.insert(order.end(), mapped_order.begin(), mapped_order.end());
+  return order;
+}
+
+} // namespace
+
+void AllocationOrderInferencePass::runPass(Fusion* fusion) {
+  if (!isOptionEnabled(EnableOption::AllocationOrderInference)) {
+    return;
+  }
+
+  std::unordered_map<TensorView*, std::vector<IterDomain*>> orders;
+  for (TensorView* tv : ir_utils::filterByType<TensorView>(fusion->inputs())) {
+    orders[tv] =
+        getAllocationOrder(tv).value_or(tv->getMaybeRFactorDomain());
+  }
+
+  for (Expr* expr : fusion->exprs()) {
+    for (TensorView* out :
+         ir_utils::filterByType<TensorView>(expr->outputs())) {
+      if (out->hasAllocation()) {
+        if (auto order = getAllocationOrder(out)) {
+          orders[out] = std::move(order.value());
+        }
+        continue;
+      }
+      if (out->hasRFactor()) {
+        continue;
+      }
+
+      TensorView* ref = nullptr;
+      std::pair<int64_t, bool> ref_rank = {-1, false};
+      for (TensorView* in :
+           ir_utils::filterByType<TensorView>(expr->inputs())) {
+        auto it = orders.find(in);
+        if (it == orders.end()) {
+          continue;
+        }
+        std::pair<int64_t, bool> rank = {
+            countConcreteIds(in), it->second != in->getMaybeRFactorDomain()};
+        if (rank > ref_rank) {
+          ref = in;
+          ref_rank = rank;
+        }
+      }
+      if (ref != nullptr) {
+        orders[out] = mapOrder(ref, orders.at(ref), out);
+      }
+    }
+  }
+
+  for (TensorView* out :
+       ir_utils::filterByType<TensorView>(fusion->outputs())) {
+    if (out->isFusionInput() || out->hasAllocation() || out->isZeroDim() ||
+        out->hasReduction()) {
+      continue;
+    }
+    auto it = orders.find(out);
+    if (it == orders.end() || it->second == out->getMaybeRFactorDomain()) {
+      continue;
+    }
+    out->setAllocationDomain(it->second, true);
+    if (isDebugDumpEnabled(DebugDumpOption::PreSegmenterLogging)) {
+      debug() << "Set the allocation domain of " << ir_utils::varName(out)
+              << " to " << toDelimitedString(it->second) << std::endl;
+    }
+  }
+}
+
+} // namespace nvfuser::optimization
@@ -0,0 +1,44 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <optimization/optimization_pass.h>
+
+namespace nvfuser::optimization {
+
+//! [ Allocation Order Inference ]
+//!
+//! Fusion outputs without an allocation domain are allocated contiguously in
+//! the order of their logical domains. When the inputs are in another memory
+//! format, e.g., channels last, the outputs then have a different format than
+//! the inputs, the consumer of an output in PyTorch transposes it, and the
+//! kernel writes the output with a different order than it reads the inputs.
+//! With NVFUSER_ENABLE=allocation_order_inference, AllocationOrderInferencePass
+//! propagates the allocation orders of the fusion inputs to the outputs as
+//! PyTorch propagates memory formats:
+//!  - the order of any other tensor is that of its producer with the most
+//!    non-broadcast IterDomains, preferring non-trivial orders among
+//!    producers of as many, with the IterDomains it doesn't map outermost;
+//!  - the order of a tensor with an allocation domain that permutes its
+//!    logical domain is that permutation, and that of any other fusion input
+//!    is its logical order;
+//!  - the outputs of reshapes and permutes don't get an order;
+//!  - an output without an allocation domain and with a non-trivial order
+//!    gets the permutation of its logical domain in that order as its
+//!    allocation domain.
+//! Outputs with reduction IterDomains are left as they are.
+class AllocationOrderInferencePass
+    : public OptimizationPass<AllocationOrderInferencePass> {
+  friend class OptimizationPass<AllocationOrderInferencePass>;
+
+ protected:
+  static void runPass(Fusion* fusion);
+  static std::string name() {
+    return "AllocationOrderInferencePass";
+  }
+};
+
+} // namespace nvfuser::optimization
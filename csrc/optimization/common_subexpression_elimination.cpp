@@ -0,0 +1,139 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <optimization/common_subexpression_elimination.h>
+
+#include <debug.h>
+#include <ir/utils.h>
+#include <options.h>
+#include <utils.h>
+
+#include <algorithm>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+
+namespace nvfuser::optimization {
+
+namespace {
+
+// Whether the values computed by expr only depend on its op, attributes,
+// inputs and output domains
+bool isEliminable(Expr* expr) {
+  if (!ir_utils::isTvOp(expr) || expr->isA<RNGOp>()) {
+    return false;
+  }
+  return std::all_of(
+      expr->outputs().begin(), expr->outputs().end(), [](Val* out) {
+        auto tv = dynamic_cast<TensorView*>(out);
+        return tv != nullptr && !tv->isFusionOutput() && !tv->hasRFactor() &&
+            !tv->hasAllocation();
+      });
+}
+
+bool haveSameDomains(TensorView* tv, TensorView* other) {
+  const std::vector<IterDomain*>& domain = tv->getRootDomain();
+  const std::vector<IterDomain*>& other_domain = other->getRootDomain();
+  if (tv->dtype() != other->dtype() || domain.size() != other_domain.size()) {
+    return false;
+  }
+  for (const auto i : c10::irange(domain.size())) {
+    IterDomain* id = domain.at(i);
+    IterDomain* other_id = other_domain.at(i);
+    if (id->getIterType() != other_id->getIterType() ||
+        !id->extent()->sameAs(other_id->extent()) ||
+        id->hasExpandedExtent() != other_id->hasExpandedExtent() ||
+        (id->hasExpandedExtent() &&
+         !id->expandedExtent()->sameAs(other_id->expandedExtent()))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// An eliminable expression with its inputs after replacing the earlier
+// duplicates
+struct Computation {
+  Expr* expr = nullptr;
+  std::vector<Val*> inputs;
+
+  size_t hash() const {
+    size_t hash = std::hash<std::type_index>()(typeid(*expr));
+    for (Val* in : inputs) {
+      hashCombine(hash, std::hash<Val*>()(in));
+    }
+    for (auto out : ir_utils::filterByType<TensorView>(expr->outputs())) {
+      hashCombine(hash, out->getRootDomain().size());
+    }
+    return hash;
+  }
+
+  bool isSameAs(const Computation& other) const {
+    if (inputs != other.inputs || !expr->sameOp(other.expr)) {
+      return false;
+    }
+    for (const auto i : c10::irange(expr->outputs().size())) {
+      if (!haveSameDomains(
+              expr->output(i)->as<TensorView>(),
+              other.expr->output(i)->as<TensorView>())) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+} // namespace
+
+void CommonSubexpressionEliminationPass::runPass(Fusion* fusion) {
+  if (!isOptionEnabled(EnableOption::CommonSubexpressionElimination)) {
+    return;
+  }
+
+  // Maps the outputs of the duplicates to the outputs of the first
+  // expressions computing them
+  std::unordered_map<Val*, Val*> replacement_map;
+  std::unordered_map<size_t, std::vector<Computation>> computations;
+  // Fusion::exprs() computes and returns topological order, so the inputs
+  // of an expression are replaced before it's visited.
+  for (Expr* expr : fusion->exprs()) {
+    if (!isEliminable(expr)) {
+      continue;
+    }
+    Computation computation{expr, {}};
+    computation.inputs.reserve(expr->inputs().size());
+    for (Val* in : expr->inputs()) {
+      auto it = replacement_map.find(in);
+      computation.inputs.push_back(
+          it == replacement_map.end() ? in : it->second);
+    }
+
+    std::vector<Computation>& same_hash = computations[computation.hash()];
+    auto first = std::find_if(
+        same_hash.begin(), same_hash.end(), [&](const Computation& other) {
+          return computation.isSameAs(other);
+        });
+    if (first == same_hash.end()) {
+      same_hash.push_back(std::move(computation));
+      continue;
+    }
+
+    if (isDebugDumpEnabled(DebugDumpOption::PreSegmenterLogging)) {
+      debug() << "CommonSubexpressionEliminationPass: replacing "
+              << expr->toString() << "  by " << first->expr->toString();
+    }
+    for (const auto i : c10::irange(expr->outputs().size())) {
+      replacement_map.emplace(expr->output(i), first->expr->output(i));
+    }
+  }
+
+  if (!replacement_map.empty()) {
+    ir_utils::replaceValue(fusion, replacement_map);
+  }
+}
+
+} // namespace nvfuser::optimization
@@ -0,0 +1,40 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <optimization/optimization_pass.h>
+
+namespace nvfuser::optimization {
+
+//! [ Common Subexpression Elimination ]
+//!
+//! Fusions traced from autograd often compute the same tensor more than
+//! once, e.g., the mean and rsqrt of a normalization in both the forward
+//! and its recomputation. Each copy is scheduled separately and may even
+//! get its own reduction segment. With
+//! NVFUSER_ENABLE=common_subexpression_elimination,
+//! CommonSubexpressionEliminationPass replaces tensor expressions that
+//! compute the same values as an earlier one by the outputs of the earlier
+//! one. Two expressions compute the same values when
+//!  - they are the same op with the same attributes, see Expr::sameOp,
+//!  - their inputs are the same after replacing the earlier duplicates, and
+//!  - their output tensors have the same dtype and IterDomains, e.g., the
+//!    same reduction axes.
+//! Expressions are found by a structural hash of the above. Random number
+//! generation, expressions with rfactor or allocation domains, e.g.,
+//! reshapes and permutes, and fusion outputs are left alone.
+class CommonSubexpressionEliminationPass
+    : public OptimizationPass<CommonSubexpressionEliminationPass> {
+  friend class OptimizationPass<CommonSubexpressionEliminationPass>;
+
+ protected:
+  static void runPass(Fusion* fusion);
+  static std::string name() {
+    return "CommonSubexpressionEliminationPass";
+  }
+};
+
+} // namespace nvfuser::optimization
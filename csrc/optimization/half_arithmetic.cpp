@@ -0,0 +1,110 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <optimization/half_arithmetic.h>
+
+#include <ir/utils.h>
+#include <ops/arith.h>
+#include <options.h>
+
+namespace nvfuser::optimization {
+
+namespace {
+
+bool isHalfPrecisionType(DataType dtype) {
+  return dtype == DataType::Half || dtype == DataType::BFloat16;
+}
+
+UnaryOp* getCast(Val* val) {
+  auto uop = dynamic_cast<UnaryOp*>(val->definition());
+  if (uop == nullptr || uop->getUnaryOpType() != UnaryOpType::Cast) {
+    return nullptr;
+  }
+  return uop;
+}
+
+BinaryOp* getArithmetic(Val* val) {
+  auto bop = dynamic_cast<BinaryOp*>(val->definition());
+  if (bop == nullptr) {
+    return nullptr;
+  }
+  switch (bop->getBinaryOpType()) {
+    case BinaryOpType::Add:
+    case BinaryOpType::Sub:
+    case BinaryOpType::Mul:
+      return bop;
+    default:
+      return nullptr;
+  }
+}
+
+// Whether the float tensor val is a cast of a dtype tensor, or an
+// arithmetic tree over such casts whose intermediates can be replaced
+bool isHalfTree(Val* val, DataType dtype) {
+  if (!val->isA<TensorView>() || val->dtype() != DataType::Float) {
+    return false;
+  }
+  if (auto cast = getCast(val)) {
+    return cast->in()->isA<TensorView>() && cast->in()->dtype() == dtype;
+  }
+  auto bop = getArithmetic(val);
+  if (bop == nullptr || val->isFusionOutput() || val->uses().size() != 1) {
+    return false;
+  }
+  return isHalfTree(bop->lhs(), dtype) && isHalfTree(bop->rhs(), dtype);
+}
+
+// Computes the tree of isHalfTree in dtype
+Val* computeInHalf(Val* val, DataType dtype) {
+  if (auto cast = getCast(val)) {
+    return cast->in();
+  }
+  auto bop = getArithmetic(val);
+  return binaryOp(
+      bop->getBinaryOpType(),
+      computeInHalf(bop->lhs(), dtype),
+      computeInHalf(bop->rhs(), dtype),
+      dtype);
+}
+
+// Rewrites the first cast of an arithmetic tree to half precision it finds
+// and returns true, or returns false if there is none
+bool rewriteHalfTree(Fusion* fusion) {
+  for (auto expr : fusion->exprs()) {
+    auto cast = dynamic_cast<UnaryOp*>(expr);
+    if (cast == nullptr || cast->getUnaryOpType() != UnaryOpType::Cast) {
+      continue;
+    }
+    const DataType dtype = cast->out()->dtype();
+    if (!isHalfPrecisionType(dtype) || getArithmetic(cast->in()) == nullptr ||
+        !isHalfTree(cast->in(), dtype)) {
+      continue;
+    }
+    Val* out = cast->out();
+    Val* half_out = computeInHalf(cast->in(), dtype);
+    ir_utils::replaceValue(fusion, {{out, half_out}});
+    if (out->isFusionOutput()) {
+      fusion->replaceOutput(out, half_out);
+    }
+    return true;
+  }
+  return false;
+}
+
+} // namespace
+
+void HalfArithmeticPass::runPass(Fusion* fusion) {
+  if (!isOptionEnabled(EnableOption::HalfArithmetic)) {
+    return;
+  }
+  FusionGuard fg(fusion);
+  // Each rewrite replaces expressions, so start over after each one
+  while (rewriteHalfTree(fusion)) {
+  }
+}
+
+} // namespace nvfuser::optimization
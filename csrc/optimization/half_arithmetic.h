@@ -0,0 +1,42 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <optimization/optimization_pass.h>
+
+namespace nvfuser::optimization {
+
+//! [ Half-Precision Arithmetic ]
+//!
+//! Arithmetic on half and bfloat16 tensors is defined by casting the inputs
+//! to float, computing in float and casting the result back, so each element
+//! costs two conversions per input and one per output on top of the
+//! arithmetic. With NVFUSER_ENABLE=half_arithmetic, HalfArithmeticPass
+//! instead computes trees of additions, subtractions and multiplications in
+//! the half-precision type when
+//!  - every leaf of the tree is a cast of a tensor of that type to float,
+//!  - the root is cast back to the same type, and
+//!  - no intermediate of the tree is used elsewhere or is a fusion output.
+//! Only the precision of the intermediates of such a tree changes: they are
+//! rounded to the half-precision type after every operation. A single
+//! operation gives the same result as before, since float has more than
+//! twice the precision of half and bfloat16.
+//!
+//! The half-precision operations are generated as scalar f16 or bf16
+//! instructions. Unrolled loops that only consist of such operations on
+//! consecutive local elements are generated with a step of two and packed
+//! f16x2 or bf16x2 instructions, which process a pair of elements at once.
+class HalfArithmeticPass : public OptimizationPass<HalfArithmeticPass> {
+  friend class OptimizationPass<HalfArithmeticPass>;
+
+ protected:
+  static void runPass(Fusion* fusion);
+  static std::string name() {
+    return "HalfArithmeticPass";
+  }
+};
+
+} // namespace nvfuser::optimization
@@ -17,6 +17,9 @@ class MarkAliasesPreparePass : public OptimizationPass<MarkAliasesPreparePass> {
 
  protected:
   static void runPass(Fusion* fusion);
+  static std::string name() {
+    return "MarkAliasesPreparePass";
+  }
 };
 
 } // namespace nvfuser::optimization
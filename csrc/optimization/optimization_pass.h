@@ -8,10 +8,12 @@
 #pragma once
 
 #include <exceptions.h>
+#include <instrumentation.h>
 #include <ir/interface_nodes.h>
 #include <ir/utils.h>
 
 #include <atomic>
+#include <string>
 
 namespace nvfuser::optimization {
 
@@ -34,7 +36,13 @@ using FusionPass = std::function<void(Fusion*)>;
 //!
 //!    protected:
 //!     static void runPass(Fusion* fusion);
+//!     static std::string name() {
+//!       return "Pass0";
+//!     }
 //!   };
+//!
+//! The name is that of the pass in traces and compile profiles, see
+//! [ Compile Profile ].
 template <typename DerivedClass>
 class OptimizationPass {
  public:
@@ -50,6 +58,8 @@ class OptimizationPass {
     if (!flag_.load()) {
       return;
     }
+    const std::string name = DerivedClass::name();
+    FUSER_PERF_SCOPE(name.c_str());
     DerivedClass::runPass(fusion);
 #ifndef NDEBUG
     // cycle detection is only enabled on debug run
@@ -8,19 +8,36 @@
 #include <optimization/pre_segmenter.h>
 
 #include <optimization/add_axioms.h>
+#include <optimization/algebraic_rewrite.h>
+#include <optimization/allocation_order_inference.h>
+#include <optimization/common_subexpression_elimination.h>
 #include <optimization/consecutive_cast.h>
+#include <optimization/half_arithmetic.h>
 #include <optimization/mark_aliases_prepare.h>
 #include <optimization/remove_empty.h>
+#include <optimization/resize_to_inputs.h>
 
 namespace nvfuser::optimization {
 
 void PreSegmenter::runPass(Fusion* fusion) {
   // Replace TensorViews with zero extent. Outputs and inputs may still be empty
   OptimizationPass<RemoveEmptyPass>::runPass(fusion);
+  // rewrites the fusion to compute and move fewer or narrower elements if
+  // enabled
+  OptimizationPass<AlgebraicRewritePass>::runPass(fusion);
+  // slices and concatenates fusion inputs instead of intermediates if enabled
+  OptimizationPass<ResizeToInputsPass>::runPass(fusion);
+  // merges tensor expressions computing the same values if enabled
+  OptimizationPass<CommonSubexpressionEliminationPass>::runPass(fusion);
   // removes consecutive cast operations
   OptimizationPass<ConsecutiveCastPass>::runPass(fusion);
+  // computes half-precision arithmetic in its own type if enabled
+  OptimizationPass<HalfArithmeticPass>::runPass(fusion);
   OptimizationPass<AddAxiomsPass>::runPass(fusion);
   OptimizationPass<MarkAliasesPreparePass>::runPass(fusion);
+  // gives outputs the allocation order of their inputs if enabled, after the
+  // layouts of aliases are set
+  OptimizationPass<AllocationOrderInferencePass>::runPass(fusion);
 }
 
 } // namespace nvfuser::optimization
@@ -18,6 +18,9 @@ class PreSegmenter : public OptimizationPass<PreSegmenter> {
 
  protected:
   static void runPass(Fusion* fusion);
+  static std::string name() {
+    return "PreSegmenter";
+  }
 };
 
 } // namespace nvfuser::optimization
@@ -17,6 +17,9 @@ class RemoveEmptyPass : public OptimizationPass<RemoveEmptyPass> {
 
  protected:
   static void runPass(Fusion* fusion);
+  static std::string name() {
+    return "RemoveEmptyPass";
+  }
 };
 
 } // namespace nvfuser::optimization
@@ -0,0 +1,357 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <optimization/resize_to_inputs.h>
+
+#include <debug.h>
+#include <ir/utils.h>
+#include <ops/alias.h>
+#include <ops/arith.h>
+#include <ops/utils.h>
+#include <options.h>
+
+namespace nvfuser::optimization {
+
+namespace {
+
+// Widths of the left and right sides of a pad of each dimension
+using PadWidths = std::vector<std::pair<Val*, Val*>>;
+
+void logRewrite(const char* rewrite, Expr* expr) {
+  if (isDebugDumpEnabled(DebugDumpOption::PreSegmenterLogging)) {
+    debug() << "ResizeToInputsPass: " << rewrite << " of "
+            << expr->toString();
+  }
+}
+
+// Fusion outputs, including the aliased ones, are kept as they are
+bool isReplaceable(Val* val) {
+  return !val->isFusionOutput();
+}
+
+// Ops computing each element of their output from the same element of
+// their inputs
+bool isPointwise(Expr* expr) {
+  if (expr == nullptr || expr->outputs().size() != 1 ||
+      !expr->output(0)->isA<TensorView>()) {
+    return false;
+  }
+  if (expr->isOneOf<UnaryOp, BinaryOp, TernaryOp>()) {
+    return true;
+  }
+  auto ldst = dynamic_cast<LoadStoreOp*>(expr);
+  return ldst != nullptr && ldst->opType() == LoadStoreOpType::Set &&
+      !ldst->out()->as<TensorView>()->hasRFactor();
+}
+
+// Returns the permutation of expr if it's a permute, see
+// ir_utils::computePermutation
+std::optional<std::vector<int64_t>> getPermutation(Expr* expr) {
+  auto ldst = dynamic_cast<LoadStoreOp*>(expr);
+  if (ldst == nullptr || ldst->opType() != LoadStoreOpType::Set) {
+    return std::nullopt;
+  }
+  auto out = dynamic_cast<TensorView*>(ldst->out());
+  if (out == nullptr || !out->hasRFactor()) {
+    return std::nullopt;
+  }
+  return ir_utils::computePermutation(
+      out->getRootDomain(), out->getMaybeRFactorDomain());
+}
+
+std::vector<IterDomain*> logicalDomain(TensorView* tv) {
+  return TensorDomain::noReductions(tv->getMaybeRFactorDomain());
+}
+
+// Rebuilds the pointwise expr on new_inputs
+TensorView* replicate(Expr* expr, const std::vector<Val*>& new_inputs) {
+  TensorView* new_out = ops::newOutputTV(new_inputs, expr->output(0)->dtype());
+  expr->newObjectFunc()(
+      expr->container(), new_inputs, {new_out}, expr->attributes());
+  return new_out;
+}
+
+// Slices the inputs of a pointwise op or a permute instead of its output,
+// and merges a slice of a slice
+bool hoistSlice(Fusion* fusion, Expr* expr) {
+  auto sop = dynamic_cast<SliceOp*>(expr);
+  if (sop == nullptr || !isReplaceable(sop->out())) {
+    return false;
+  }
+  Expr* producer = sop->in()->definition();
+  const std::vector<Slice> ranges = sop->getRanges();
+  const std::optional<std::vector<int64_t>> permutation =
+      getPermutation(producer);
+
+  TensorView* hoisted_out = nullptr;
+  if (auto producer_sop = dynamic_cast<SliceOp*>(producer)) {
+    logRewrite("merging the slices", expr);
+    std::vector<Slice> merged_ranges = producer_sop->getRanges();
+    for (const auto i : c10::irange(ranges.size())) {
+      Val* offset = merged_ranges.at(i).start;
+      merged_ranges.at(i) = {
+          SimplifyingIrBuilder::addExpr(offset, ranges.at(i).start),
+          SimplifyingIrBuilder::addExpr(offset, ranges.at(i).stop),
+          nullptr};
+    }
+    hoisted_out =
+        slice(producer_sop->in()->as<TensorView>(), merged_ranges);
+  } else if (permutation.has_value()) {
+    logRewrite("slicing before the permute", expr);
+    // out[i] == in[permutation[i]]
+    std::vector<Slice> in_ranges(ranges.size());
+    for (const auto i : c10::irange(ranges.size())) {
+      in_ranges.at(permutation->at(i)) = ranges.at(i);
+    }
+    hoisted_out = permute(
+        slice(producer->input(0)->as<TensorView>(), in_ranges), *permutation);
+  } else if (isPointwise(producer)) {
+    logRewrite("slicing before the pointwise op", expr);
+    std::vector<Val*> sliced_inputs;
+    for (Val* in : producer->inputs()) {
+      auto in_tv = dynamic_cast<TensorView*>(in);
+      const std::vector<IterDomain*> in_domain =
+          in_tv == nullptr ? std::vector<IterDomain*>{} : logicalDomain(in_tv);
+      // Broadcast domains are resolved by the sliced domains of the other
+      // inputs
+      if (std::all_of(in_domain.begin(), in_domain.end(), [](auto id) {
+            return id->isBroadcast();
+          })) {
+        sliced_inputs.push_back(in);
+        continue;
+      }
+      std::vector<Slice> in_ranges(in_domain.size());
+      for (const auto i : c10::irange(in_domain.size())) {
+        if (!in_domain.at(i)->isBroadcast()) {
+          in_ranges.at(i) = ranges.at(i);
+        }
+      }
+      sliced_inputs.push_back(slice(in_tv, in_ranges));
+    }
+    hoisted_out = replicate(producer, sliced_inputs);
+  } else {
+    return false;
+  }
+
+  ir_utils::replaceValue(fusion, {{sop->out(), hoisted_out}});
+  return true;
+}
+
+// Whether the pad of tv along the padded dimensions can be moved to the
+// fusion inputs it is computed from
+bool canPadInputsOf(TensorView* tv, const std::vector<bool>& padded) {
+  const std::vector<IterDomain*> domain = logicalDomain(tv);
+  for (const auto i : c10::irange(domain.size())) {
+    if (padded.at(i) && domain.at(i)->isBroadcast()) {
+      return false;
+    }
+  }
+  if (tv->isFusionInput()) {
+    return true;
+  }
+  Expr* def = tv->definition();
+  if (auto sop = dynamic_cast<SliceOp*>(def)) {
+    return canPadInputsOf(sop->in()->as<TensorView>(), padded);
+  }
+  if (const std::optional<std::vector<int64_t>> permutation =
+          getPermutation(def)) {
+    std::vector<bool> in_padded(padded.size());
+    for (const auto i : c10::irange(padded.size())) {
+      in_padded.at(permutation->at(i)) = padded.at(i);
+    }
+    return canPadInputsOf(def->input(0)->as<TensorView>(), in_padded);
+  }
+  if (!isPointwise(def)) {
+    return false;
+  }
+  for (auto in_tv : ir_utils::filterByType<TensorView>(def->inputs())) {
+    const std::vector<IterDomain*> in_domain = logicalDomain(in_tv);
+    std::vector<bool> in_padded(padded.size());
+    for (const auto i : c10::irange(padded.size())) {
+      in_padded.at(i) = padded.at(i) && !in_domain.at(i)->isBroadcast();
+    }
+    if (!canPadInputsOf(in_tv, in_padded)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Computes tv from the fusion inputs padded by widths, see
+// canPadInputsOf. Only the elements of tv, i.e., those in the unpadded
+// range, are the same as those of the pad of tv.
+TensorView* padInputsOf(TensorView* tv, const PadWidths& widths) {
+  const bool is_padded =
+      std::any_of(widths.begin(), widths.end(), [](const auto& width) {
+        return !width.first->isZeroInt() || !width.second->isZeroInt();
+      });
+  if (!is_padded) {
+    return tv;
+  }
+
+  Expr* def = tv->definition();
+  if (tv->isFusionInput()) {
+    // pad takes the widths of the innermost dimension first
+    std::vector<Val*> pad_widths;
+    for (auto it = widths.rbegin(); it != widths.rend(); ++it) {
+      pad_widths.push_back(it->first);
+      pad_widths.push_back(it->second);
+    }
+    return pad(tv, pad_widths);
+  } else if (auto sop = dynamic_cast<SliceOp*>(def)) {
+    // The pad of in[start, stop)
+    auto in = sop->in()->as<TensorView>();
+    const std::vector<IterDomain*> in_domain = logicalDomain(in);
+    const std::vector<Slice> ranges = sop->getRanges();
+    PadWidths in_widths;
+    for (const auto i : c10::irange(widths.size())) {
+      Val* in_extent = SimplifyingIrBuilder::maybeCastExpr(
+          DataType::Index, in_domain.at(i)->getMaybeExpandedExtent());
+      in_widths.emplace_back(
+          SimplifyingIrBuilder::subExpr(
+              widths.at(i).first, ranges.at(i).start),
+          SimplifyingIrBuilder::subExpr(
+              widths.at(i).second,
+              SimplifyingIrBuilder::subExpr(in_extent, ranges.at(i).stop)));
+    }
+    return padInputsOf(in, in_widths);
+  } else if (
+      const std::optional<std::vector<int64_t>> permutation =
+          getPermutation(def)) {
+    PadWidths in_widths(widths.size());
+    for (const auto i : c10::irange(widths.size())) {
+      in_widths.at(permutation->at(i)) = widths.at(i);
+    }
+    return permute(
+        padInputsOf(def->input(0)->as<TensorView>(), in_widths),
+        *permutation);
+  }
+
+  NVF_ERROR(isPointwise(def), "Unexpected definition of ", tv->toString());
+  std::vector<Val*> padded_inputs;
+  for (Val* in : def->inputs()) {
+    auto in_tv = dynamic_cast<TensorView*>(in);
+    if (in_tv == nullptr) {
+      padded_inputs.push_back(in);
+      continue;
+    }
+    // Broadcast domains are resolved by the padded domains of the other
+    // inputs
+    const std::vector<IterDomain*> in_domain = logicalDomain(in_tv);
+    PadWidths in_widths;
+    for (const auto i : c10::irange(widths.size())) {
+      if (in_domain.at(i)->isBroadcast()) {
+        Val* zero = tv->fusion()->zeroVal(DataType::Index);
+        in_widths.emplace_back(zero, zero);
+      } else {
+        in_widths.push_back(widths.at(i));
+      }
+    }
+    padded_inputs.push_back(padInputsOf(in_tv, in_widths));
+  }
+  return replicate(def, padded_inputs);
+}
+
+// Replaces a cat of intermediates with a where of its inputs padded at the
+// fusion inputs
+bool catOfPaddedInputs(Fusion* fusion, Expr* expr) {
+  auto cat = dynamic_cast<CatOp*>(expr);
+  if (cat == nullptr || !isReplaceable(cat->output(0))) {
+    return false;
+  }
+  const int64_t cat_dim = cat->concatenatedDim();
+
+  std::vector<PadOp*> pads;
+  bool reads_intermediates = false;
+  for (Val* in : cat->inputs()) {
+    auto pad_op = dynamic_cast<PadOp*>(in->definition());
+    if (pad_op == nullptr) {
+      return false;
+    }
+    auto pad_in = pad_op->in()->as<TensorView>();
+    std::vector<bool> padded(logicalDomain(pad_in).size(), false);
+    for (auto axis : pad_op->getPaddedAxes()) {
+      padded.at(axis) = true;
+    }
+    if (!canPadInputsOf(pad_in, padded)) {
+      return false;
+    }
+    reads_intermediates = reads_intermediates || !pad_in->isFusionInput();
+    pads.push_back(pad_op);
+  }
+  if (!reads_intermediates) {
+    return false;
+  }
+
+  logRewrite("padding the inputs", expr);
+  // Position along the concatenated dimension
+  auto out = cat->output(0)->as<TensorView>();
+  const std::vector<IterDomain*> out_domain = logicalDomain(out);
+  std::vector<bool> bcast_flags(out_domain.size(), true);
+  bcast_flags.at(cat_dim) = false;
+  TensorView* position = broadcast(
+      iota(
+          out_domain.at(cat_dim)->getMaybeExpandedExtent(),
+          fusion->zeroVal(DataType::Index),
+          fusion->oneVal(DataType::Index),
+          DataType::Index),
+      bcast_flags);
+
+  // The cat of [in_0, ..., in_n) is
+  //   where(position < end_0, pad_0, where(position < end_1, pad_1, ...))
+  std::vector<TensorView*> padded_inputs;
+  std::vector<Val*> ends;
+  Val* end = nullptr;
+  for (auto pad_op : pads) {
+    auto pad_in = pad_op->in()->as<TensorView>();
+    if (pad_in->isFusionInput()) {
+      padded_inputs.push_back(pad_op->out()->as<TensorView>());
+    } else {
+      PadWidths widths;
+      for (const auto i : c10::irange(logicalDomain(pad_in).size())) {
+        widths.push_back(pad_op->getPadWidths((int)i));
+      }
+      padded_inputs.push_back(padInputsOf(pad_in, widths));
+    }
+    end = SimplifyingIrBuilder::addExpr(
+        end, logicalDomain(pad_in).at(cat_dim)->getMaybeExpandedExtent());
+    ends.push_back(end);
+  }
+  TensorView* selected = padded_inputs.back();
+  for (int64_t i = (int64_t)padded_inputs.size() - 2; i >= 0; --i) {
+    selected =
+        where(lt(position, ends.at(i)), padded_inputs.at(i), selected);
+  }
+
+  ir_utils::replaceValue(fusion, {{out, selected}});
+  return true;
+}
+
+// Applies the first rewrite it finds and returns true, or returns false if
+// there is none
+bool rewrite(Fusion* fusion) {
+  for (auto expr : fusion->exprs()) {
+    if (hoistSlice(fusion, expr) || catOfPaddedInputs(fusion, expr)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+} // namespace
+
+void ResizeToInputsPass::runPass(Fusion* fusion) {
+  if (!isOptionEnabled(EnableOption::ResizeToInputs)) {
+    return;
+  }
+  FusionGuard fg(fusion);
+  // Each rewrite replaces expressions, so start over after each one
+  while (rewrite(fusion)) {
+  }
+}
+
+} // namespace nvfuser::optimization
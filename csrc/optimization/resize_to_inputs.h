@@ -0,0 +1,53 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <optimization/optimization_pass.h>
+
+namespace nvfuser::optimization {
+
+//! [ Resize To Inputs ]
+//!
+//! Resize ops, i.e., slice, pad and cat, are only scheduled with the rest of
+//! a fusion when they read fusion inputs, as the producer of a resize would
+//! otherwise have to be materialized for the threads reading it at shifted
+//! positions, see EnableOption::MemoryPromotion. Rotary embeddings, for
+//! example,
+//!   x1 = slice(q, ..., [0, d/2))
+//!   x2 = slice(q, ..., [d/2, d))
+//!   out = q * cos + cat({neg(x2), x1}, -1) * sin
+//! slice and pad intermediates whenever q is computed from the inputs, e.g.,
+//! by a permute.
+//!
+//! With NVFUSER_ENABLE=resize_to_inputs, ResizeToInputsPass rewrites the
+//! fusion before segmentation so that these ops read fusion inputs instead,
+//! without changing any result:
+//!  - A slice of a pointwise op or a permute slices their inputs instead,
+//!    e.g., slice(neg(q)) becomes neg(slice(q)), and a slice of a slice is
+//!    a single slice.
+//!  - A cat of intermediates becomes a where of its inputs padded to the
+//!    concatenated extent, selected by the position along the concatenated
+//!    dimension. The pads are moved through pointwise ops, permutes and
+//!    slices to the fusion inputs, where a pad of a slice is a single pad,
+//!    possibly of negative widths. The values such a pad gives outside of
+//!    its part of the cat are never selected.
+//! The pointwise scheduler then computes the whole fusion in one kernel,
+//! where each resize is an offset of the index of a fusion input. The ops
+//! the resizes are moved through are computed again for the resized inputs
+//! if their outputs have other uses. Resizes of reshapes, reductions and
+//! fusion outputs are kept as they are. Each rewrite is printed with
+//! NVFUSER_DUMP=pre_segmenter_logging.
+class ResizeToInputsPass : public OptimizationPass<ResizeToInputsPass> {
+  friend class OptimizationPass<ResizeToInputsPass>;
+
+ protected:
+  static void runPass(Fusion* fusion);
+  static std::string name() {
+    return "ResizeToInputsPass";
+  }
+};
+
+} // namespace nvfuser::optimization
@@ -138,6 +138,7 @@ std::unordered_map<DebugDumpOption, std::vector<std::string>> Options<
       {"python_frontend_debug", DebugDumpOption::PythonFrontendDebug},
       {"sass", DebugDumpOption::Sass},
       {"segmented_fusion", DebugDumpOption::FusionSegments},
+      {"segmenter_cost_model", DebugDumpOption::SegmenterCostModel},
       {"segmenter_logging", DebugDumpOption::FusionSegmenterLog},
       {"scheduler_params", DebugDumpOption::SchedulerDebug},
       {"scheduler_verbose", DebugDumpOption::SchedulerVerbose},
@@ -151,12 +152,77 @@ template <>
 std::unordered_map<EnableOption, std::vector<std::string>> Options<
     EnableOption>::getOptionsFromEnv() {
   const std::unordered_map<std::string, EnableOption> available_options = {
+      {"algebraic_rewrite", EnableOption::AlgebraicRewrite},
+      {"alignment_tolerant_reuse", EnableOption::AlignmentTolerantReuse},
+      {"allocation_order_inference", EnableOption::AllocationOrderInference},
+      {"allreduce_buckets", EnableOption::AllreduceBuckets},
+      {"async_compile", EnableOption::AsyncCompile},
+      {"atomic_grid_reduction", EnableOption::AtomicGridReduction},
+      {"autotune", EnableOption::Autotune},
+      {"bank_conflict_swizzle", EnableOption::BankConflictSwizzle},
+      {"chunked_execution", EnableOption::ChunkedExecution},
+      {"cluster_grid_sync", EnableOption::ClusterGridSync},
+      {"collective_matmul", EnableOption::CollectiveMatmul},
+      {"comm_backend_selection", EnableOption::CommBackendSelection},
+      {"common_subexpression_elimination",
+       EnableOption::CommonSubexpressionElimination},
+      {"compile_cache", EnableOption::CompileCache},
+      {"compile_profile", EnableOption::CompileProfile},
+      {"compress_kernel_binaries", EnableOption::CompressKernelBinaries},
+      {"cp_async_pipeline", EnableOption::CpAsyncPipeline},
+      {"cuda_graph", EnableOption::CudaGraph},
+      {"fast_divmod", EnableOption::FastDivmod},
+      {"fast_math", EnableOption::FastMath},
+      {"fusion_cache_journal", EnableOption::FusionCacheJournal},
+      {"generic_kernels", EnableOption::GenericKernels},
+      {"global_heuristic_cache", EnableOption::GlobalHeuristicCache},
+      {"grid_outer_persistent_reduction",
+       EnableOption::GridOuterPersistentReduction},
+      {"half_arithmetic", EnableOption::HalfArithmetic},
+      {"heuristic_log", EnableOption::HeuristicLog},
+      {"horizontal_fusion", EnableOption::HorizontalFusion},
+      {"host_evaluated_segments", EnableOption::HostEvaluatedSegments},
+      {"hybrid_persistent_buffers", EnableOption::HybridPersistentBuffers},
       {"id_model", EnableOption::IdModel},
+      {"index_strength_reduction", EnableOption::IndexStrengthReduction},
+      {"interpreted_pointwise", EnableOption::InterpretedPointwise},
       {"kernel_db", EnableOption::KernelDb},
       {"kernel_profile", EnableOption::KernelProfile},
+      {"l2_persistence", EnableOption::L2Persistence},
+      {"low_precision_segment_edges", EnableOption::LowPrecisionSegmentEdges},
+      {"magic_zero_elision", EnableOption::MagicZeroElision},
+      {"memory_aware_run_order", EnableOption::MemoryAwareRunOrder},
       {"memory_promotion", EnableOption::MemoryPromotion},
+      {"misaligned_vectorize", EnableOption::MisalignedVectorize},
+      {"mixed_index_type", EnableOption::MixedIndexType},
+      {"multi_stream_segments", EnableOption::MultiStreamSegments},
+      {"named_barriers", EnableOption::NamedBarriers},
+      {"occupancy_launch", EnableOption::OccupancyLaunch},
+      {"online_softmax", EnableOption::OnlineSoftmax},
+      {"parallel_lowering", EnableOption::ParallelLowering},
+      {"pointwise_persistent_grid", EnableOption::PointwisePersistentGrid},
+      {"prefetch_modules", EnableOption::PrefetchModules},
+      {"profile_guided_fallback", EnableOption::ProfileGuidedFallback},
+      {"programmatic_dependent_launch",
+       EnableOption::ProgrammaticDependentLaunch},
+      {"recompute_cheap_producers", EnableOption::RecomputeCheapProducers},
+      {"register_prefetch", EnableOption::RegisterPrefetch},
+      {"register_pressure_feedback", EnableOption::RegisterPressureFeedback},
+      {"release_lowering_info", EnableOption::ReleaseLoweringInfo},
+      {"remote_compile_cache", EnableOption::RemoteCompileCache},
+      {"resize_to_inputs", EnableOption::ResizeToInputs},
+      {"single_pass_grid_reduction", EnableOption::SinglePassGridReduction},
+      {"size_specialization", EnableOption::SizeSpecialization},
+      {"smem_packing", EnableOption::SmemPacking},
+      {"spill_kernel_arguments", EnableOption::SpillKernelArguments},
+      {"split_compile", EnableOption::SplitCompile},
       {"static_fusion_count", EnableOption::StaticFusionCount},
-      {"warn_register_spill", EnableOption::WarnRegisterSpill}};
+      {"streaming_stores", EnableOption::StreamingStores},
+      {"tail_peeling", EnableOption::TailPeeling},
+      {"telemetry", EnableOption::Telemetry},
+      {"tma_persistent_buffer", EnableOption::TmaPersistentBuffer},
+      {"warn_register_spill", EnableOption::WarnRegisterSpill},
+      {"warp_segment_reduction", EnableOption::WarpSegmentReduction}};
 
   return parseEnvOptions("ENABLE", available_options);
 }
@@ -172,12 +238,17 @@ std::unordered_map<DisableOption, std::vector<std::string>> Options<
       {"grouped_grid_welford_outer_opt",
        DisableOption::GroupedGridWelfordOuterOpt},
       {"index_hoist", DisableOption::IndexHoist},
+      {"kernel_deduplication", DisableOption::KernelDeduplication},
+      {"lazy_module_loading", DisableOption::LazyModuleLoading},
       {"magic_zero", DisableOption::MagicZero},
       {"nvtx", DisableOption::Nvtx},
       {"parallel_compile", DisableOption::ParallelCompile},
       {"parallel_serde", DisableOption::ParallelSerde},
+      {"persistent_semaphores", DisableOption::PersistentSemaphores},
       {"predicate_elimination", DisableOption::PredicateElimination},
+      {"register_transpose", DisableOption::RegisterTranspose},
       {"kernel_reuse", DisableOption::KernelReuse},
+      {"segment_arena", DisableOption::SegmentArena},
       {"var_name_remapping", DisableOption::VarNameRemapping},
       {"welford_vectorization", DisableOption::WelfordVectorization},
       {"reuse_mismatched_type_registers",
@@ -199,6 +270,7 @@ std::unordered_map<ProfilerOption, std::vector<std::string>> Options<
   const std::unordered_map<std::string, ProfilerOption> available_options = {
       {"enable", ProfilerOption::Enable},
       {"enable.nocupti", ProfilerOption::EnableNocupti},
+      {"metrics", ProfilerOption::Metrics},
       {"print", ProfilerOption::Print},
       {"print.nocupti", ProfilerOption::PrintNocupti},
       {"print.verbose", ProfilerOption::PrintVerbose},
@@ -288,6 +360,9 @@ bool isProfilerPrintingVerbose() {
   return ProfilerOptionsGuard::getCurOptions().has(
       ProfilerOption::PrintVerbose);
 }
+bool isProfilerCollectingMetrics() {
+  return ProfilerOptionsGuard::getCurOptions().has(ProfilerOption::Metrics);
+}
 
 const std::vector<std::string>& getDisableOptionArguments(
     ProfilerOption option) {
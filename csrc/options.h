@@ -42,6 +42,8 @@ enum class DebugDumpOption {
   LaunchParam, //!< Dump the Launch parameters of kernel
   FusionSegments, //!< Dump Segmented Fusion Graph
   FusionSegmenterLog, //!< Dump Detailed Segmenter Logging
+  SegmenterCostModel, //!< Dump the scores and decisions of the segmenter
+                      //!< cost model
   FusionArgs, //!< Print the runtime fusion arguments
   KernelArgs, //!< Print the runtime kernel arguments when launching kernels
   EffectiveBandwidth, //! Measure kernel performance and print effective
@@ -80,12 +82,167 @@ enum class DebugDumpOption {
 //! These can be set through the `NVFUSER_ENABLE` environment variable
 //!
 enum class EnableOption {
+  AlgebraicRewrite, //! Enable rewriting fusions before segmentation to
+                    //! compute and move fewer or narrower elements
+  AlignmentTolerantReuse, //! Enable reusing kernels with smaller
+                          //! vectorization factors for inputs of a
+                          //! different alignment
+  AllocationOrderInference, //! Enable giving fusion outputs the allocation
+                            //! order of their inputs, see
+                            //! [ Allocation Order Inference ]
+  AllreduceBuckets, //! Enable coalescing the allreduces of the outputs of a
+                    //! pipeline stage into contiguous buckets, see
+                    //! [ Allreduce Buckets ]
+  AsyncCompile, //! Enable compiling new fusions in the background while
+                //! evaluating them with ATen
+  AtomicGridReduction, //! Enable nondeterministic cross-grid sums that
+                       //! accumulate into the outputs with atomics, see
+                       //! [ Atomic Grid Reduction ]
+  Autotune, //! Enable benchmarking variants of reduction heuristics and
+            //! persisting the fastest in a tuning database
+  BankConflictSwizzle, //! Enable swizzling shared memory tensors with bank
+                       //! conflicts before lowering
+  ChunkedExecution, //! Enable running fusions whose predicted peak memory
+                    //! exceeds a budget in chunks of their outer dimension,
+                    //! see [ Chunked Execution ]
+  ClusterGridSync, //! Enable launching cooperative kernels with thread block
+                   //! clusters on Hopper to synchronize clusters, not blocks
+  CollectiveMatmul, //! Enable interleaving the ring steps of allgathers
+                    //! with the stages consuming the gathered chunks
+  CommBackendSelection, //! Enable benchmarking the communicator backends for
+                        //! each collective, team and message size
+  CommonSubexpressionElimination, //! Enable merging tensor expressions
+                                  //! that compute the same values before
+                                  //! segmentation
+  CompileCache, //! Enable the persistent on-disk cache of compiled kernels
+  CompileProfile, //! Enable aggregating the durations of the traced scopes,
+                  //! see [ Compile Profile ]
+  CompressKernelBinaries, //! Enable compressing the kernels of serialized
+                          //! FusionCaches and of the Kernel DB, see
+                          //! [ Compressed Kernel Binaries ]
+  CpAsyncPipeline, //! Enable circular buffering the global loads of
+                   //! reductions and normalizations with cp.async
+  CudaGraph, //! Enable replaying kernel launches of a fusion as a CUDA graph
+  FastDivmod, //! Enable dividing indices by kernel-invariant extents with
+              //! multipliers computed on the host, see [ Fast Divmod ]
+  FastMath, //! Enable approximate instructions for transcendental unary ops
+            //! of all fusions, see CompileParams::enable_fast_math
+  FusionCacheJournal, //! Enable appending newly compiled fusions to a
+                      //! journal next to the serialized FusionCache
+  GenericKernels, //! Enable shape-independent pointwise and reduction
+                  //! heuristics so new shapes reuse the compiled kernels, see
+                  //! [ Generic Kernels ]
+  GlobalHeuristicCache, //! Enable sharing compile-time scheduler analyses
+                        //! across copies of a fusion, see
+                        //! [ Global Heuristic Summary Cache ]
+  GridOuterPersistentReduction, //! Enable grid persistent outer
+                                //! normalizations of non-Welford
+                                //! reductions with the outer-optimized
+                                //! grouped grid reduction
+  HalfArithmetic, //! Enable computing additions, subtractions and
+                  //! multiplications of half and bfloat16 tensors in their
+                  //! own type, in pairs with packed instructions
+  HeuristicLog, //! Enable appending a record of every scheduler decision to
+                //! a file, see [ Heuristic Decision Log ]
+  HorizontalFusion, //! Enable scheduling independent pointwise sub-problems
+                    //! as a single kernel
+  HostEvaluatedSegments, //! Enable evaluating segments of CPU scalars on
+                         //! the host, see [ Host-Evaluated Segments ]
+  HybridPersistentBuffers, //! Enable keeping some of the persistent
+                           //! buffers of shared memory persistent kernels
+                           //! in registers, see [ Hybrid Persistent Buffers ]
   IdModel, //! Enable IdModel
+  IndexStrengthReduction, //! Enable incrementing hoisted indices across
+                          //! iterations of serial loops
+  InterpretedPointwise, //! Run new pointwise fusions with a precompiled
+                        //! interpreter while their kernels compile
   KernelDb, //! Enable Kernel Database
   KernelProfile, //! Enable intra-kernel performance profiling
+  L2Persistence, //! Enable keeping tensors read by several segments in L2
+                 //! with eviction hints and access policy windows
+  LowPrecisionSegmentEdges, //! Enable storing fp32 intermediates between
+                            //! segments in half precision, see
+                            //! [ Low Precision Segment Edges ]
+  MagicZeroElision, //! Enable leaving small unrolled loop nests unprotected
+                    //! by magic zero, see [ Magic Zero Elision ]
+  MemoryAwareRunOrder, //! Enable ordering segments to reduce the peak memory
+                       //! of their outputs, see [ Memory-Aware Segment
+                       //! Order ]
   MemoryPromotion, //! Enable promotion of memory types for non-pointwise ops
+  MisalignedVectorize, //! Enable vectorizing pointwise inputs with
+                       //! misaligned base addresses by peeling the
+                       //! misaligned elements into scalar loops
+  MixedIndexType, //! Enable 32-bit math for bounded terms of 64-bit indices
+  MultiStreamSegments, //! Enable launching independent segments on multiple
+                       //! streams
+  NamedBarriers, //! Enable synchronizing only the threads of a row of the
+                 //! block for shared memory they don't share with other
+                 //! rows, see [ Row Barriers ]
+  OccupancyLaunch, //! Enable adjusting free launch dimensions to the
+                   //! occupancy of the compiled kernel and preferring L1 for
+                   //! kernels without shared memory, see [ Occupancy-Driven
+                   //! Launch Parameters ]
+  OnlineSoftmax, //! Enable computing the max and the sum of exponentials of
+                 //! softmax and log_softmax in chunks, see [ Online Softmax ]
+  ParallelLowering, //! Enable running independent lowering analyses on
+                    //! multiple threads, see [ Parallel Lowering ]
+  PointwisePersistentGrid, //! Enable a grid sized to the device that loops
+                           //! over the tiles of large pointwise fusions
+  PrefetchModules, //! Enable loading the modules of deserialized kernels
+                   //! launched at least the given number of times in the
+                   //! background, see [ Lazy Module Loading ]
+  ProfileGuidedFallback, //! Enable timing the kernels of segments against
+                         //! evaluating them with ATen on their first run and
+                         //! running the faster, see [ Profile-Guided ATen
+                         //! Fallback ]
+  ProgrammaticDependentLaunch, //! Enable launching the kernels of consecutive
+                               //! segments with programmatic dependent launch
+                               //! on Hopper, see [ Programmatic Dependent
+                               //! Launch ]
+  RecomputeCheapProducers, //! Enable recomputing cheap pointwise producers
+                           //! in each consumer segment instead of
+                           //! materializing them
+  RegisterPrefetch, //! Enable loading the cached inputs of the next
+                    //! iteration of serial reduction loops into registers
+                    //! before the math of the current one, see [ Register
+                    //! Prefetched Global Loads ]
+  RegisterPressureFeedback, //! Enable re-running the inner-outer persistent
+                            //! heuristic if the registers estimated on the
+                            //! lowered kernel exceed the budget
+  ReleaseLoweringInfo, //! Enable releasing the lowering analyses of compiled
+                       //! kernels, see [ Releasing Lowering Info ]
+  RemoteCompileCache, //! Enable sharing compiled kernels through a
+                      //! network store, see [ Remote Compile Cache ]
+  ResizeToInputs, //! Enable moving slices and concatenations of
+                  //! intermediates to the fusion inputs, see
+                  //! [ Resize To Inputs ]
+  SinglePassGridReduction, //! Enable accumulating cross-grid outer
+                           //! reductions in block order in a single pass
+  SizeSpecialization, //! Enable eliminating predicates of splits that are
+                      //! divisible for the power-of-two divisors of the
+                      //! input sizes, compiling a kernel per size class,
+                      //! or for a given divisor only, e.g.,
+                      //! size_specialization(128)
+  SmemPacking, //! Enable packing shared memory allocations by their lifetimes
+  SpillKernelArguments, //! Enable passing the tensor arguments of kernels
+                        //! whose parameters exceed the given bytes in a
+                        //! device buffer, see [ Spilled Kernel Arguments ]
+  SplitCompile, //! Enable compiling the functions of a kernel on multiple
+                //! threads with NVRTC --split-compile
   StaticFusionCount, //! Enable using single static count in kernel name
+  StreamingStores, //! Enable streaming stores of outputs that are written
+                   //! once and not read back by the kernel
+  TailPeeling, //! Enable predicating unswitched loop nests per iteration of
+               //! their outermost serial loop in the inlined path
+  Telemetry, //! Enable sampled counters of the runs of each
+             //! FusionExecutorCache, see [ Fusion Telemetry ]
+  TmaPersistentBuffer, //! Enable TMA loads of shared memory persistent
+                       //! buffers on Hopper
   WarnRegisterSpill, //! Enable warnings of register spill
+  WarpSegmentReduction, //! Enable shuffle-only reductions over TIDx of less
+                        //! than a warp, with multiple rows per warp, of all
+                        //! fusions, see
+                        //! CompileParams::enable_warp_segment_reduction
   EndOfOption //! Placeholder for counting the number of elements
 };
 
@@ -102,13 +259,24 @@ enum class DisableOption {
   GroupedGridWelfordOuterOpt, //! Disable use of outer-optimized
                               //! grouped grid welford kernel
   IndexHoist, //! Disable index hoisting
+  KernelDeduplication, //! Disable sharing the compiled kernels of identical
+                       //! code among executors, see [ Kernel Deduplication ]
+  LazyModuleLoading, //! Disable deferring the loading of deserialized kernels
+                     //! to their first use, see [ Lazy Module Loading ]
   MagicZero, //! Disable nvfuser_zero
   Nvtx, //! Disable NVTX instrumentation
   ParallelCompile, //! Disable compiling Fusion segments in parallel
   ParallelSerde, //! Disable deserializing FusionExecutorCache in parallel
+  PersistentSemaphores, //! Disable keeping the zero-initialized semaphores
+                        //! of grid syncs across launches, see
+                        //! [ Persistent Semaphores ]
   PredicateElimination, //! Disable predicate elimination
+  RegisterTranspose, //! Disable transposing small tiles in registers with
+                     //! warp shuffles, see [ Register Transpose ]
   KernelReuse, //! Disable re-using cached FusionKernelRuntimes with different
                //! input shapes
+  SegmentArena, //! Disable placing tensors passed between segments in an
+                //! arena reused across runs
   VarNameRemapping, //! Disable variable name remapping
   WelfordVectorization, //! Disable vectorizaton of Welford ops
   ReuseMismatchedTypeRegisters, //! Disable explicitly re-using registers unless
@@ -127,6 +295,8 @@ enum class ProfilerOption {
   EnableNocupti, //! Enables the profiler, but disables CUPTI specific
                  //! profiling inorder to measure true host time without
                  //! overhead.
+  Metrics, //! Enables the profiler and collects hardware metrics of each
+           //! kernel, see [ Kernel Metrics ]
   Print, //! Enables the profiler and prints the output to the console.
   PrintNocupti, //! Enables the profiler, disables CUPTI specific
                 //! profiling inorder to measure true host time without
@@ -249,6 +419,7 @@ bool isProfilerEnabled();
 bool isProfilerEnabledWithoutCupti();
 bool isProfilerPrintingEnabled();
 bool isProfilerPrintingVerbose();
+bool isProfilerCollectingMetrics();
 
 const std::vector<std::string>& getProfilerOptionArguments(
     ProfilerOption option);
@@ -8,27 +8,107 @@
 #include <ATen/cuda/CUDAContext.h>
 #include <nvrtc.h>
 
+#include <compile_thread_pool.h>
 #include <debug.h>
 #include <instrumentation.h>
+#include <kernel_db/kernel_db.h>
 #include <options.h>
 #include <python_frontend/fusion_cache.h>
 #include <serde/fusion_record.h>
 #include <utils.h>
 
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
 #include <filesystem>
 namespace fs = std::filesystem;
 
 #ifdef _WIN32
 #include <c10/util/win32-headers.h>
 #else
+#include <fcntl.h>
 #include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <unistd.h>
 #endif
 
 namespace nvfuser::python_frontend {
 
+class FusionCacheBuffer {
+ public:
+  explicit FusionCacheBuffer(const std::string& filename);
+  ~FusionCacheBuffer();
+
+  FusionCacheBuffer(const FusionCacheBuffer&) = delete;
+  FusionCacheBuffer& operator=(const FusionCacheBuffer&) = delete;
+
+  const uint8_t* data() const {
+    return data_;
+  }
+
+  size_t size() const {
+    return size_;
+  }
+
+ private:
+  const uint8_t* data_ = nullptr;
+  size_t size_ = 0;
+#ifdef _WIN32
+  //! The file is read into memory instead of mapping it
+  std::vector<uint8_t> contents_;
+#endif
+};
+
+FusionCacheBuffer::FusionCacheBuffer(const std::string& filename) {
+  FUSER_PERF_SCOPE("Flatbuffers::openFusionCache");
+#ifdef _WIN32
+  auto file_handle = std::fopen(filename.c_str(), "rb");
+  NVF_CHECK(file_handle != nullptr, "Failed to open FusionCache buffer.");
+
+  auto file_size = fs::file_size(fs::path(filename.c_str()));
+  NVF_CHECK(file_size > 0, "FusionCache buffer is empty.");
+
+  contents_.resize(file_size);
+  size_t read_status =
+      std::fread(contents_.data(), sizeof(uint8_t), file_size, file_handle);
+  std::fclose(file_handle);
+  NVF_CHECK(
+      read_status == file_size, "Failed to read entire FusionCache buffer.\n");
+  data_ = contents_.data();
+  size_ = file_size;
+#else
+  int fd = open(filename.c_str(), O_RDONLY);
+  NVF_CHECK(fd >= 0, "Failed to open FusionCache buffer.");
+
+  struct stat file_stat {};
+  if (fstat(fd, &file_stat) != 0 || file_stat.st_size <= 0) {
+    close(fd);
+    NVF_CHECK(false, "FusionCache buffer is empty.");
+  }
+
+  // The mapping stays valid after closing the file, and also if the file is
+  // replaced by serialize() as that creates a new file.
+  void* mapping = mmap(
+      nullptr, (size_t)file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  NVF_CHECK(mapping != MAP_FAILED, "Failed to map FusionCache buffer.");
+  // Lookups only touch the parts of the buffer they need
+  madvise(mapping, (size_t)file_stat.st_size, MADV_RANDOM);
+  data_ = static_cast<const uint8_t*>(mapping);
+  size_ = (size_t)file_stat.st_size;
+#endif
+}
+
+FusionCacheBuffer::~FusionCacheBuffer() {
+#ifndef _WIN32
+  if (data_ != nullptr) {
+    munmap(const_cast<uint8_t*>(data_), size_);
+  }
+#endif
+}
+
 namespace {
-using BinaryBuffer = std::vector<uint8_t>;
 
 // Generate temporary file for this FusionCacheBuffer
 std::string getSerdeTmpFile() {
@@ -42,26 +122,23 @@ std::string getSerdeTmpFile() {
   return ss.str();
 }
 
+// The workspace doesn't depend on the CUDA version, since the kernels are
+// versioned individually. See [ Versioned Kernel Entries ]
 std::string getSerdeFile() {
   auto device_prop = at::cuda::getCurrentDeviceProperties();
-  int cuda_major = 0;
-  int cuda_minor = 0;
-  NVFUSER_NVRTC_SAFE_CALL(nvrtcVersion(&cuda_major, &cuda_minor));
-
   std::stringstream ss;
   ss << "nvf_serde";
   ss << "_device" << device_prop->major << "_" << device_prop->minor;
-  ss << "_cuda" << cuda_major << "_" << cuda_minor;
   return ss.str();
 }
 
 // Get std::filesystem::path to specified file in nvfuser kernel database
-// directory.
+// directory, which may be shared by processes. See [ Shared Kernel DB ].
 fs::path getSerdeFilePath(const std::string& file_name) {
-  fs::path kernel_db_path = fs::temp_directory_path() / "nvfuser_kernel_db";
+  fs::path kernel_db_path = KernelDb::defaultDirectory();
   if (!fs::is_directory(kernel_db_path)) {
     try {
-      fs::create_directory(kernel_db_path);
+      fs::create_directories(kernel_db_path);
     } catch (const std::exception& e) {
       NVF_ERROR(
           "Unable to create nvFuser Kernel DB directory! ",
@@ -72,37 +149,20 @@ fs::path getSerdeFilePath(const std::string& file_name) {
   return kernel_db_path / file_name;
 }
 
-BinaryBuffer openFusionCache(std::string filename) {
-  FUSER_PERF_SCOPE("Flatbuffers::openFusionCache");
-  auto file_handle = std::fopen(filename.c_str(), "rb");
-  NVF_CHECK(file_handle != nullptr, "Failed to open FusionCache buffer.");
-
-  auto file_path = fs::path(filename.c_str());
-  auto file_size = fs::file_size(file_path);
-  NVF_CHECK(file_size > 0, "FusionCache buffer is empty.");
-
-  BinaryBuffer buffer(file_size);
-  size_t read_status =
-      std::fread(buffer.data(), sizeof(uint8_t), file_size, file_handle);
-  NVF_CHECK(
-      read_status == file_size, "Failed to read entire FusionCache buffer.\n");
-  return buffer;
-}
-
 // This check function only throws errors if strict flag is enabled.
-const serde::FusionCache* verifyFusionCache(const BinaryBuffer& buffer) {
+const serde::FusionCache* verifyFusionCache(const uint8_t* data, size_t size) {
   FUSER_PERF_SCOPE("Flatbuffers::verifyFusionCache");
-  auto fusion_cache_buffer = serde::GetFusionCache(buffer.data());
+  auto fusion_cache_buffer = serde::GetFusionCache(data);
 
   // Check flatbuffer integrity
-  flatbuffers::Verifier v(buffer.data(), buffer.size());
+  flatbuffers::Verifier v(data, size);
   NVF_CHECK(
       fusion_cache_buffer->Verify(v),
       "Failed to verify the integrity of FusionCache buffer.");
 
   // Check schema version
   NVF_CHECK(
-      serde::FusionCacheBufferHasIdentifier(buffer.data()),
+      serde::FusionCacheBufferHasIdentifier(data),
       "Failed to verify the schema version of the FusionCache buffer");
 
   // Check device major and minor versions
@@ -120,30 +180,50 @@ const serde::FusionCache* verifyFusionCache(const BinaryBuffer& buffer) {
       ".",
       fusion_cache_buffer->device_minor());
 
-  // Check cuda installation
+  // The cuda installation isn't checked, since the kernels compiled by
+  // another NVRTC are compiled again. See [ Versioned Kernel Entries ]
+  return fusion_cache_buffer;
+}
+
+// Journal of the fusions compiled since the last serialization. See
+// [ FusionCache Journal ].
+std::string getSerdeJournalFile() {
+  return getSerdeFile() + "_journal";
+}
+
+// Builds the FusionCache table of a trie flattened in breadth-first order
+flatbuffers::Offset<serde::FusionCache> createFusionCacheTable(
+    flatbuffers::FlatBufferBuilder& builder,
+    size_t max_fusions,
+    const std::vector<flatbuffers::Offset<serde::TrieNode>>& fb_nodes,
+    const std::vector<size_t>& terminal_node_idx,
+    const std::vector<flatbuffers::Offset<serde::FusionExecutorCache>>&
+        fb_auto_gen_schedules) {
+  auto device_prop = at::cuda::getCurrentDeviceProperties();
   int cuda_major = 0;
   int cuda_minor = 0;
   NVFUSER_NVRTC_SAFE_CALL(nvrtcVersion(&cuda_major, &cuda_minor));
-  NVF_CHECK(
-      cuda_major == fusion_cache_buffer->cuda_major() &&
-          cuda_minor == fusion_cache_buffer->cuda_minor(),
-      "Expected cuda version ",
-      cuda_major,
-      ".",
-      cuda_minor,
-      " but flatbuffer has cuda version ",
-      fusion_cache_buffer->cuda_major(),
-      ".",
-      fusion_cache_buffer->cuda_minor());
 
-  return fusion_cache_buffer;
+  // See table definition for FusionCache in serde/fusion_cache.fbs
+  return serde::CreateFusionCacheDirect(
+      builder,
+      max_fusions,
+      &fb_nodes,
+      &terminal_node_idx,
+      &fb_auto_gen_schedules,
+      FusionExecutor::getGlobalFusionCount(),
+      device_prop->major,
+      device_prop->minor,
+      cuda_major,
+      cuda_minor);
 }
 
 } // namespace
 
 void serialize() {
   auto tmp_file_path = getSerdeFilePath(getSerdeTmpFile());
-  FusionCache::get()->serialize(tmp_file_path);
+  FusionCache* fusion_cache = FusionCache::get();
+  fusion_cache->serialize(tmp_file_path);
 
   // Save to a per-process temporary file to avoid multi-process contention.
   // Then, rename the temporary file to the actual file. If the actual file
@@ -155,6 +235,14 @@ void serialize() {
   std::error_code rename_ec;
   fs::rename(tmp_file_path, file_path, rename_ec);
 
+  // The new workspace contains the fusions of the journal that were
+  // replayed or appended by this process. See [ FusionCache Journal ].
+  if (!rename_ec && isOptionEnabled(EnableOption::FusionCacheJournal) &&
+      fusion_cache->ownsJournal()) {
+    std::error_code remove_ec;
+    fs::remove(getSerdeFilePath(getSerdeJournalFile()), remove_ec);
+  }
+
   // Failed to replace common workspace, so remove the temporary file.
   if (rename_ec) {
     try {
@@ -172,6 +260,7 @@ void serialize() {
 // FusionCache static data member definitions for singleton usage
 std::mutex FusionCache::singleton_lock_;
 FusionCache* FusionCache::singleton_ = nullptr;
+std::atomic<size_t> FusionCache::generation_ = 0;
 
 UserSchedule::UserSchedule() : schedule(nullptr), executor(nullptr) {
   schedule = std::make_unique<Fusion>();
@@ -250,15 +339,7 @@ FusionCache* FusionCache::get(
             << "A new workspace will be saved upon program exit after deleting incompatible workspace."
             << std::endl;
 
-        // Hide exception message because it should be resolved by saving a new
-        // workspace.
-        if (!isOptionDisabled(DisableOption::ParallelSerde)) {
-          std::cout
-              << "Use NVFUSER_DISABLE=parallel_serde to print exception message."
-              << std::endl;
-        } else {
-          std::cout << deserialize_exception.what() << std::endl;
-        }
+        std::cout << deserialize_exception.what() << std::endl;
 
         // Delete incompatible workspace
         std::error_code remove_ec;
@@ -273,6 +354,22 @@ FusionCache* FusionCache::get(
         singleton_ = new FusionCache(max_fusions);
       }
     }
+
+    // Add the fusions compiled by processes that did not serialize
+    auto journal_path = getSerdeFilePath(getSerdeJournalFile()).native();
+    if (load_from_default_workspace &&
+        isOptionEnabled(EnableOption::FusionCacheJournal) &&
+        fs::exists(journal_path)) {
+      try {
+        singleton_->replayJournal(journal_path);
+      } catch (const std::exception& e) {
+        TORCH_WARN(
+            "Stopped replaying the FusionCache journal ",
+            journal_path,
+            " at an invalid entry.\n",
+            e.what());
+      }
+    }
   }
   NVF_CHECK(
       max_fusions >= singleton_->fusions_.size(),
@@ -285,7 +382,7 @@ size_t FusionCache::numFusions() const {
   return fusions_.size();
 }
 
-void FusionCache::print(std::ostream& os) const {
+void FusionCache::print(std::ostream& os) {
   os << "Fusions by id:" << std::endl;
   std::vector<TrieNode*> stack;
   stack.push_back(root_.get());
@@ -293,6 +390,7 @@ void FusionCache::print(std::ostream& os) const {
   while (!stack.empty()) {
     TrieNode* node = stack.back();
     stack.pop_back();
+    materializeChildren(node);
 
     if (node->isTerminal()) {
       std::vector<TrieNode*> rev_fusion_records;
@@ -329,8 +427,15 @@ void FusionCache::stats(std::ostream& os) const {
     os << "Cache Hits by Fusion Id:\n";
     size_t total_cache_hits = 0;
     for (size_t i = 0; i < terminal_nodes_.size(); ++i) {
+      // Terminal nodes that have not been created yet still have the visits
+      // stored in the mapped buffer
+      size_t node_visits = terminal_nodes_[i] != nullptr
+          ? terminal_nodes_[i]->visits
+          : fusion_cache_buffer_->structure()
+                ->Get(fusion_cache_buffer_->terminal_nodes()->Get(i))
+                ->visits();
       // The first visit is a miss!
-      auto visits = terminal_nodes_[i]->visits - 1;
+      auto visits = node_visits - 1;
       total_cache_hits += visits;
       os << "\t" << i << " -> " << visits << " hits\n";
     }
@@ -341,6 +446,14 @@ void FusionCache::stats(std::ostream& os) const {
     os << " Cache Hits: " << total_cache_hits;
     os << " Hit Rate: " << hit_rate << "%\n";
   }
+
+  // See [ FusionCache Eviction ]
+  std::lock_guard<std::mutex> guard(fusions_lock_);
+  os << "Live Fusions: " << num_live_fusions_
+     << " Evicted Fusions: " << evicted_fusion_ids_.size()
+     << " Evictions: " << num_evictions_ << "\n";
+  os << "Loaded Kernel Modules: " << num_modules_ << " (" << module_bytes_
+     << " bytes)\n";
 }
 
 void FusionCache::reset() {
@@ -350,6 +463,11 @@ void FusionCache::reset() {
     delete singleton_;
     singleton_ = new FusionCache(max_fusions);
   }
+  ++generation_;
+}
+
+size_t FusionCache::generation() {
+  return generation_;
 }
 
 FusionCache::FusionCache(size_t max_fusions)
@@ -362,34 +480,323 @@ FusionCache::FusionCache(size_t max_fusions)
   root_ = std::make_unique<TrieNode>(start);
 }
 
+// Defined here because FusionCacheBuffer is incomplete in the header
+FusionCache::~FusionCache() = default;
+
 // In order to keep queries fast, this method does not lock.
 // In the worst case, the query should fail and if you try to create a child,
 // it should give you back an already created child if two threads are walking
 // the trie at the same time with the same definition.
 std::optional<TrieNode*> FusionCache::queryChildren(
     TrieNode* node,
-    RecordFunctor* rec) const {
+    RecordFunctor* rec) {
   NVF_CHECK(
       !node->isTerminal(), "There should be no children from a Terminal Node!");
   NVF_CHECK(rec, "Record is null!");
+  materializeChildren(node);
   auto trie_node = node->children.find(rec);
   if (trie_node == std::end(node->children)) {
     return std::nullopt;
   } else {
     ++(trie_node->second.get()->visits);
+    if (trie_node->second->isTerminal()) {
+      materializeFusion(trie_node->second.get());
+    }
     return std::optional<TrieNode*>(trie_node->second.get());
   }
 }
 
-FusionSchedules* FusionCache::queryFusionSchedules(size_t fusion_id) const {
+std::optional<TrieNode*> FusionCache::queryDefinition(
+    size_t definition_hash,
+    const std::vector<std::unique_ptr<RecordFunctor>>& records) {
+  FUSER_PERF_SCOPE("FusionCache::queryDefinition");
+  auto candidates = definitions_.find(definition_hash);
+  if (candidates == definitions_.end()) {
+    return std::nullopt;
+  }
+  for (TrieNode* terminal : candidates->second) {
+    // The records are compared from the terminal node back to the root
+    // to resolve collisions of the hash
+    TrieNode* node = terminal->parent;
+    bool matches = true;
+    for (auto it = records.rbegin(); matches && it != records.rend(); ++it) {
+      matches = node != root_.get() && *(node->record) == **it;
+      node = node->parent;
+    }
+    if (!matches || node != root_.get()) {
+      continue;
+    }
+    // Count the visits as the walk of the trie would
+    for (node = terminal; node != root_.get(); node = node->parent) {
+      ++(node->visits);
+    }
+    return std::optional<TrieNode*>(terminal);
+  }
+  return std::nullopt;
+}
+
+FusionSchedules* FusionCache::queryFusionSchedules(size_t fusion_id) {
+  std::lock_guard<std::mutex> guard(fusions_lock_);
   NVF_CHECK(
       fusion_id < fusions_.size(),
       "Invalid scheduler query for id:",
       fusion_id);
+  rebuildIfEvicted(fusion_id);
   FusionSchedules* ptr = fusions_.at(fusion_id).get();
   NVF_CHECK(ptr != nullptr, "Unexpected null FusionSchedules object.");
   return ptr;
 }
+
+std::shared_ptr<FusionSchedules> FusionCache::acquireFusionSchedules(
+    size_t fusion_id) {
+  std::lock_guard<std::mutex> guard(fusions_lock_);
+  NVF_CHECK(
+      fusion_id < fusions_.size(),
+      "Invalid scheduler query for id:",
+      fusion_id);
+  rebuildIfEvicted(fusion_id);
+  last_used_.at(fusion_id) = ++clock_;
+  return fusions_.at(fusion_id);
+}
+
+void FusionCache::releaseFusionSchedules(size_t fusion_id) {
+  FUSER_PERF_SCOPE("FusionCache::releaseFusionSchedules");
+  std::shared_ptr<FusionSchedules> scheds;
+  {
+    std::lock_guard<std::mutex> guard(fusions_lock_);
+    scheds = fusions_.at(fusion_id);
+  }
+  // The FusionExecutorCache may be compiling for another thread, so it is
+  // not queried while holding fusions_lock_
+  auto [num_modules, module_bytes] =
+      scheds->auto_gen_schedules->loadedModules();
+
+  // Evicted schedules are destroyed after fusions_lock_ is released, since
+  // their runtimes may wait for background compilation
+  std::vector<std::shared_ptr<FusionSchedules>> evicted;
+  std::unique_lock<std::mutex> guard(fusions_lock_);
+  // Skip fusions that were evicted while running
+  if (fusions_.at(fusion_id) != scheds) {
+    return;
+  }
+  num_modules_ = num_modules_ - scheds->num_modules + num_modules;
+  module_bytes_ = module_bytes_ - scheds->module_bytes + module_bytes;
+  scheds->num_modules = num_modules;
+  scheds->module_bytes = module_bytes;
+  evicted = evictLeastRecentlyUsed(fusion_id);
+
+  // Journal the fusion whenever it has compiled new kernels. See
+  // [ FusionCache Journal ].
+  if (isOptionEnabled(EnableOption::FusionCacheJournal) &&
+      num_modules > scheds->journaled_modules) {
+    scheds->journaled_modules = num_modules;
+    TrieNode* terminal = terminal_nodes_.at(fusion_id);
+    guard.unlock();
+    appendToJournal(terminal, scheds.get());
+  }
+}
+
+void FusionCache::appendToJournal(TrieNode* terminal, FusionSchedules* scheds) {
+  FUSER_PERF_SCOPE("FusionCache::appendToJournal");
+  std::vector<TrieNode*> path;
+  for (TrieNode* node = terminal; node != nullptr; node = node->parent) {
+    path.push_back(node);
+  }
+  std::reverse(path.begin(), path.end());
+
+  // The entry is a FusionCache whose trie is the path to the terminal node
+  flatbuffers::FlatBufferBuilder builder(1024);
+  std::vector<flatbuffers::Offset<serde::TrieNode>> fb_nodes;
+  for (auto i : c10::irange(path.size())) {
+    std::vector<size_t> children;
+    if (i + 1 < path.size()) {
+      children.push_back(i + 1);
+    }
+    fb_nodes.push_back(serde::CreateTrieNodeDirect(
+        builder,
+        path[i]->record->serialize(builder),
+        &children,
+        path[i]->fusion_id,
+        path[i]->visits,
+        path[i]->isTerminal()));
+  }
+  std::vector<size_t> terminal_node_idx = {path.size() - 1};
+  std::vector<flatbuffers::Offset<serde::FusionExecutorCache>>
+      fb_auto_gen_schedules = {scheds->auto_gen_schedules->serialize(builder)};
+  builder.Finish(
+      createFusionCacheTable(
+          builder,
+          max_fusions_,
+          fb_nodes,
+          terminal_node_idx,
+          fb_auto_gen_schedules),
+      /*file_identifier=*/"NV01");
+
+  // Each entry is prefixed by its size and padded to keep the next entry
+  // aligned, and it is written with a single unbuffered write
+  auto fb = builder.GetBufferSpan();
+  const uint64_t entry_size = (fb.size() + 7) / 8 * 8;
+  std::vector<uint8_t> entry(sizeof(uint64_t) + entry_size, 0);
+  std::memcpy(entry.data(), &entry_size, sizeof(uint64_t));
+  std::memcpy(entry.data() + sizeof(uint64_t), fb.data(), fb.size());
+
+  std::lock_guard<std::mutex> guard(journal_lock_);
+  auto journal_path = getSerdeFilePath(getSerdeJournalFile()).native();
+  auto file_handle = std::fopen(journal_path.c_str(), "ab");
+  if (file_handle == nullptr) {
+    TORCH_WARN("Failed to open the FusionCache journal ", journal_path);
+    return;
+  }
+  std::setvbuf(file_handle, nullptr, _IONBF, 0);
+  size_t write_status =
+      std::fwrite(entry.data(), sizeof(uint8_t), entry.size(), file_handle);
+  std::fclose(file_handle);
+  if (write_status != entry.size()) {
+    TORCH_WARN("Failed to append to the FusionCache journal ", journal_path);
+    return;
+  }
+  journal_bytes_ += entry.size();
+}
+
+bool FusionCache::ownsJournal() {
+  std::lock_guard<std::mutex> guard(journal_lock_);
+  std::error_code ec;
+  auto size = fs::file_size(getSerdeFilePath(getSerdeJournalFile()), ec);
+  return ec || size == journal_bytes_;
+}
+
+void FusionCache::replayJournal(const std::string& filename) {
+  FUSER_PERF_SCOPE("FusionCache::replayJournal");
+  journal_buffer_ = std::make_unique<FusionCacheBuffer>(filename);
+  const uint8_t* data = journal_buffer_->data();
+  const size_t size = journal_buffer_->size();
+  {
+    std::lock_guard<std::mutex> guard(journal_lock_);
+    journal_bytes_ = size;
+  }
+
+  static serde::RecordFunctorFactory record_functor_factory;
+
+  size_t offset = 0;
+  while (offset + sizeof(uint64_t) <= size) {
+    uint64_t entry_size = 0;
+    std::memcpy(&entry_size, data + offset, sizeof(uint64_t));
+    offset += sizeof(uint64_t);
+    // A process may have been killed while appending the last entry
+    if (entry_size > size - offset) {
+      break;
+    }
+    const serde::FusionCache* entry =
+        verifyFusionCache(data + offset, entry_size);
+    offset += entry_size;
+    NVF_CHECK(
+        entry->terminal_nodes()->size() == 1 &&
+            entry->auto_gen_schedules()->size() == 1,
+        "Expected a single fusion in a FusionCache journal entry.");
+    FusionExecutor::setGlobalFusionCount(std::max(
+        FusionExecutor::getGlobalFusionCount(), entry->global_fusion_count()));
+
+    // Add the path of the entry to the trie
+    TrieNode* node = root_.get();
+    auto fb_node = entry->structure()->Get(0);
+    while (!node->isTerminal()) {
+      NVF_CHECK(
+          fb_node->children()->size() == 1,
+          "Expected a single path in a FusionCache journal entry.");
+      fb_node = entry->structure()->Get(fb_node->children()->Get(0));
+      std::unique_ptr<RecordFunctor> rec(record_functor_factory.parse(
+          fb_node->record()->type(), fb_node->record()));
+      auto child_node = queryChildren(node, rec.get());
+      node = child_node.has_value() ? child_node.value()
+                                    : createChild(node, rec.get());
+    }
+
+    // The kernels of the entry replace the ones of earlier entries and of
+    // the workspace, since they were compiled later
+    const size_t fusion_id = node->fusion_id;
+    auto scheds = std::make_shared<FusionSchedules>((int64_t)fusion_id);
+    buildFusionFromTrie(node, scheds.get());
+    try {
+      scheds->auto_gen_schedules->deserialize(
+          entry->auto_gen_schedules()->Get(0), (int64_t)fusion_id);
+      scheds->journaled_modules =
+          scheds->auto_gen_schedules->loadedModules().first;
+    } catch (const std::exception& e) {
+      TORCH_WARN(
+          "Failed to replay the kernels of fusion ",
+          fusion_id,
+          ", which will be compiled again.\n",
+          e.what());
+      scheds = std::make_shared<FusionSchedules>((int64_t)fusion_id);
+      buildFusionFromTrie(node, scheds.get());
+    }
+    std::lock_guard<std::mutex> guard(fusions_lock_);
+    fusions_.at(fusion_id) = std::move(scheds);
+  }
+}
+
+void FusionCache::setEvictionLimits(
+    size_t max_live_fusions,
+    size_t max_module_bytes) {
+  std::lock_guard<std::mutex> guard(fusions_lock_);
+  max_live_fusions_ = max_live_fusions;
+  max_module_bytes_ = max_module_bytes;
+}
+
+void FusionCache::rebuildIfEvicted(size_t fusion_id) {
+  if (evicted_fusion_ids_.erase(fusion_id) == 0) {
+    return;
+  }
+  buildFusionFromTrie(
+      terminal_nodes_.at(fusion_id), fusions_.at(fusion_id).get());
+  ++num_live_fusions_;
+}
+
+std::vector<std::shared_ptr<FusionSchedules>> FusionCache::
+    evictLeastRecentlyUsed(size_t keep_fusion_id) {
+  auto exceeds_limits = [this]() {
+    return (max_live_fusions_ > 0 && num_live_fusions_ > max_live_fusions_) ||
+        (max_module_bytes_ > 0 && module_bytes_ > max_module_bytes_);
+  };
+  std::vector<std::shared_ptr<FusionSchedules>> evicted;
+  if (!exceeds_limits()) {
+    return evicted;
+  }
+
+  std::vector<size_t> candidates;
+  for (auto fusion_id : c10::irange(fusions_.size())) {
+    if (fusion_id != keep_fusion_id &&
+        terminal_nodes_.at(fusion_id) != nullptr &&
+        evicted_fusion_ids_.count(fusion_id) == 0 &&
+        lazy_fusion_ids_.count(fusion_id) == 0) {
+      candidates.push_back(fusion_id);
+    }
+  }
+  std::sort(candidates.begin(), candidates.end(), [this](size_t a, size_t b) {
+    return last_used_.at(a) < last_used_.at(b);
+  });
+
+  for (auto fusion_id : candidates) {
+    if (!exceeds_limits()) {
+      break;
+    }
+    const FusionSchedules* scheds = fusions_.at(fusion_id).get();
+    num_modules_ -= scheds->num_modules;
+    module_bytes_ -= scheds->module_bytes;
+    --num_live_fusions_;
+    ++num_evictions_;
+    // Running executions keep the old schedules alive
+    evicted.push_back(std::move(fusions_.at(fusion_id)));
+    fusions_.at(fusion_id) =
+        std::make_shared<FusionSchedules>((int64_t)fusion_id);
+    evicted_fusion_ids_.insert(fusion_id);
+    if (isDebugDumpEnabled(DebugDumpOption::PythonFrontendDebug)) {
+      debug() << "\nFusionCache: Evicted fusion " << fusion_id << "\n";
+    }
+  }
+  return evicted;
+}
+
 std::optional<size_t> FusionCache::queryUserScheduleId(
     const FusionSchedules* scheds,
     const at::ArrayRef<c10::IValue>& inputs) {
@@ -442,8 +849,11 @@ TrieNode* FusionCache::createChild(TrieNode* node, RecordFunctor* rec) {
           max_fusions_,
           "fusions.  The max_fusions for the FusionCache might need to be ",
           "increased if the max number is not being exceeded due to an error.");
+      std::lock_guard<std::mutex> fusions_guard(fusions_lock_);
       fusion_id = fusions_.size();
-      fusions_.emplace_back(std::make_unique<FusionSchedules>(fusion_id));
+      fusions_.emplace_back(std::make_shared<FusionSchedules>(fusion_id));
+      last_used_.push_back(++clock_);
+      ++num_live_fusions_;
     }
 
     // Copying the record owned by the FusionDefinition that calls this function
@@ -457,6 +867,7 @@ TrieNode* FusionCache::createChild(TrieNode* node, RecordFunctor* rec) {
     NVF_CHECK(child, "Created child of TrieNode should not be null!");
     ++(child->visits);
     if (rec->recordType() == serde::RecordType::End) {
+      std::lock_guard<std::mutex> fusions_guard(fusions_lock_);
       terminal_nodes_.push_back(node->children[new_rec].get());
     }
     if (isDebugDumpEnabled(DebugDumpOption::PythonFrontendDebug)) {
@@ -469,6 +880,29 @@ TrieNode* FusionCache::createChild(TrieNode* node, RecordFunctor* rec) {
   return child;
 }
 
+void FusionCache::registerDefinition(
+    size_t definition_hash,
+    TrieNode* terminal) {
+  NVF_CHECK(terminal->isTerminal(), "Expected a terminal node!");
+  std::lock_guard<std::mutex> guard(definitions_lock_);
+  auto& terminals = definitions_[definition_hash];
+  if (std::find(terminals.begin(), terminals.end(), terminal) ==
+      terminals.end()) {
+    terminals.push_back(terminal);
+  }
+}
+
+FusionExecutorCache* FusionCache::queryStitchedFusion(
+    const std::vector<int64_t>& key,
+    const std::function<std::unique_ptr<Fusion>()>& stitch) {
+  std::lock_guard<std::mutex> guard(stitched_fusions_lock_);
+  auto& executor_cache = stitched_fusions_[key];
+  if (executor_cache == nullptr) {
+    executor_cache = std::make_unique<FusionExecutorCache>(stitch());
+  }
+  return executor_cache.get();
+}
+
 UserSchedule* FusionCache::createUserSchedule(
     FusionSchedules* scheds,
     const at::ArrayRef<c10::IValue>& inputs,
@@ -499,8 +933,10 @@ TrieNode* FusionCache::rootTriePtr() {
   return root_.get();
 }
 
-void FusionCache::serialize(std::string filename) const {
+void FusionCache::serialize(std::string filename) {
   FUSER_PERF_SCOPE("FusionCache::serialize");
+  materializeAll();
+
   flatbuffers::FlatBufferBuilder builder(1024);
   // TODO: Serialize Fusion IR containers
 
@@ -559,24 +995,13 @@ void FusionCache::serialize(std::string filename) const {
         schedule->auto_gen_schedules->serialize(builder));
   }
 
-  auto device_prop = at::cuda::getCurrentDeviceProperties();
-  int cuda_major = 0;
-  int cuda_minor = 0;
-  NVFUSER_NVRTC_SAFE_CALL(nvrtcVersion(&cuda_major, &cuda_minor));
-
   // 6. Build FusionCache flatbuffer object
-  // See table definition for FusionCache in serde/fusion_cache.fbs
-  auto fusion_cache = serde::CreateFusionCacheDirect(
+  auto fusion_cache = createFusionCacheTable(
       builder,
       max_fusions_,
-      &fb_nodes,
-      &terminal_node_idx,
-      &fb_auto_gen_schedules,
-      FusionExecutor::getGlobalFusionCount(),
-      device_prop->major,
-      device_prop->minor,
-      cuda_major,
-      cuda_minor);
+      fb_nodes,
+      terminal_node_idx,
+      fb_auto_gen_schedules);
   builder.Finish(fusion_cache, /*file_identifier=*/"NV01");
 
   // 6. Write flatbuffer binary to file
@@ -592,16 +1017,14 @@ void FusionCache::serialize(std::string filename) const {
 
 void FusionCache::deserialize(std::string filename) {
   // See table definition for FusionCache in serde/fusion_cache.fbs
-  // 0. Load flatbuffer binary from file
+  // 0. Map flatbuffer binary from file
   FUSER_PERF_SCOPE("FusionCache::deserialize");
   NVF_CHECK(
       fusions_.empty(),
       "Deserialization is prohibited if FusionCache is already populated.");
-  const BinaryBuffer& buffer = openFusionCache(filename);
-  const serde::FusionCache* fusion_cache_buffer = verifyFusionCache(buffer);
-
-  // See table definition for FusionCache in serde/fusion_cache.fbs
-  FUSER_PERF_SCOPE("FusionCache::deserialize");
+  auto buffer = std::make_unique<FusionCacheBuffer>(filename);
+  const serde::FusionCache* fusion_cache_buffer =
+      verifyFusionCache(buffer->data(), buffer->size());
   NVF_CHECK(fusion_cache_buffer != nullptr, "Fusion Cache buffer is invalid.");
 
   // 0. Set static fusion count in Fusion Executor
@@ -611,133 +1034,195 @@ void FusionCache::deserialize(std::string filename) {
   // 1. Deserialize max_fusions field
   max_fusions_ = fusion_cache_buffer->max_fusions();
 
-  // 2. Deserialize fusions: (Fusion) and structure: (TrieNode) fields
-  std::generate_n(
-      std::back_inserter(fusions_),
-      fusion_cache_buffer->terminal_nodes()->size(),
-      [] { return std::make_unique<FusionSchedules>(); });
-
-  serde::RecordFunctorFactory record_functor_factory;
-
-  using BfsState = std::pair<TrieNode*, size_t>;
-  std::deque<BfsState> queue = {
-      {root_.get() /* TrieNode pointer */, 0 /* structure_idx */}};
-
-  // state_queue holds the FusionState for each BfsState in the queue.
-  std::deque<std::unique_ptr<FusionState>> state_queue;
-
-  // Create empty fusion container for root node
-  state_queue.emplace_back(std::make_unique<FusionState>());
-
-  // bfs_order is used to map indices in the structure field to their
-  // corresponding TrieNode pointers. It is used to reconstruct the
-  // terminal_nodes vector.
-  std::vector<TrieNode*> bfs_order;
-
-  // Starting from the root node, we build the Trie structure in breadth-first
-  // (BFS) order.
-  while (!queue.empty()) {
-    auto& [trie_ptr, structure_idx] = queue.front();
+  // 2. Create the FusionSchedules for all fusions. Their Fusion IR and
+  // FusionExecutorCache are deserialized when a query first reaches their
+  // terminal node. See [ Lazy Deserialization of the FusionCache ].
+  const auto num_fusions = fusion_cache_buffer->terminal_nodes()->size();
+  NVF_CHECK(
+      fusion_cache_buffer->auto_gen_schedules()->size() == num_fusions,
+      "Expected a FusionExecutorCache for each terminal node.");
+  fusions_.reserve(num_fusions);
+  terminal_nodes_.resize(num_fusions, nullptr);
+  last_used_.resize(num_fusions, 0);
+  for (auto fusion_id : c10::irange(num_fusions)) {
+    auto fb_trie_node = fusion_cache_buffer->structure()->Get(
+        fusion_cache_buffer->terminal_nodes()->Get(fusion_id));
+    NVF_CHECK(
+        fb_trie_node->is_terminal() && fb_trie_node->fusion_id() == fusion_id,
+        "Expected terminal nodes to be ordered by fusion id.");
+    fusions_.emplace_back(
+        std::make_shared<FusionSchedules>((int64_t)fusion_id));
+    lazy_fusion_ids_.insert(fusion_id);
+  }
 
-    // Update BFS order
-    bfs_order.push_back(trie_ptr);
+  // 3. The root node is the first node of the structure field in
+  // breadth-first order. Its children are created by the first query.
+  root_->visits = fusion_cache_buffer->structure()->Get(0)->visits();
+  root_->lazy_structure_idx = 0;
 
-    // Get corresponding flatbuffer object for current TrieNode
-    auto fb_trie_node = fusion_cache_buffer->structure()->Get(structure_idx);
+  serde_buffer_ = std::move(buffer);
+  fusion_cache_buffer_ = fusion_cache_buffer;
+}
 
-    // While traversing the Trie Structure, build the Fusion Container by
-    // adding the TrieNode's RecordFunctor
-    auto state = state_queue.front().get();
-    state->addRecord(trie_ptr->record.get()->clone());
+void FusionCache::materializeChildren(TrieNode* node) {
+  if (node->lazy_structure_idx < 0) {
+    return;
+  }
+  FUSER_PERF_SCOPE("FusionCache::materializeChildren");
+  auto fb_trie_node =
+      fusion_cache_buffer_->structure()->Get(node->lazy_structure_idx);
+  node->lazy_structure_idx = -1;
+
+  static serde::RecordFunctorFactory record_functor_factory;
+
+  // Table TrieNode => Field: children: [ulong]
+  for (auto child_bfs_idx : *fb_trie_node->children()) {
+    auto fb_child_trie_node =
+        fusion_cache_buffer_->structure()->Get(child_bfs_idx);
+
+    // Create child RecordFunctor
+    auto serde_buffer = fb_child_trie_node->record();
+    auto rec = record_functor_factory.parse(serde_buffer->type(), serde_buffer);
+
+    // Deserialize the record and fusion id fields in the TrieNode table
+    auto status = node->children.emplace(
+        rec,
+        std::make_unique<TrieNode>(
+            rec, node, fb_child_trie_node->fusion_id()));
+    NVF_CHECK(
+        status.second,
+        "Fusion-Cache Deserialization: Failed to add child to the current TrieNode.");
+    TrieNode* child = status.first->second.get();
 
     // Deserialize Table TrieNode => Field: visits (ulong)
-    trie_ptr->visits = fb_trie_node->visits();
+    child->visits = fb_child_trie_node->visits();
 
-    // Build fusion container if current node is a terminal node
-    if (fb_trie_node->is_terminal()) {
+    if (fb_child_trie_node->is_terminal()) {
       NVF_CHECK(
-          fb_trie_node->children()->size() == 0,
+          fb_child_trie_node->children()->size() == 0,
           "This terminal node should not have any children.")
       NVF_CHECK(
-          fb_trie_node->record()->type() == serde::RecordType::End,
+          serde_buffer->type() == serde::RecordType::End,
           "This terminal node should have an EndRecord RecordFunctor")
-      NVF_CHECK(
-          trie_ptr->fusion_id == fb_trie_node->fusion_id(),
-          "The fusion id for this TrieNode should already be set.")
-      Fusion* fusion =
-          queryFusionSchedules(fb_trie_node->fusion_id())->preschedFusion();
-      state->buildFusionIr(fusion);
+      std::lock_guard<std::mutex> guard(fusions_lock_);
+      terminal_nodes_.at(child->fusion_id) = child;
+    } else {
+      child->lazy_structure_idx = (int64_t)child_bfs_idx;
     }
+  }
+}
 
-    // Table TrieNode => Field: children: [ulong]
-    // Create Children TrieNode
-    for (auto child_bfs_idx : *fb_trie_node->children()) {
-      auto fb_child_trie_node =
-          fusion_cache_buffer->structure()->Get(child_bfs_idx);
-
-      // Create child RecordFunctor
-      auto serde_buffer = fb_child_trie_node->record();
-      auto rec =
-          record_functor_factory.parse(serde_buffer->type(), serde_buffer);
-
-      // Deserialize the record and fusion id fields in the TrieNode table
-      auto status = trie_ptr->children.emplace(
-          rec,
-          std::make_unique<TrieNode>(
-              rec, trie_ptr, fb_child_trie_node->fusion_id()));
-      NVF_CHECK(
-          status.second,
-          "Fusion-Cache Deserialization: Failed to add child to the current TrieNode.");
-
-      // Add child TrieNode to BFS queue
-      queue.emplace_back(
-          status.first->second.get() /* TrieNode pointer */, child_bfs_idx);
-      state_queue.emplace_back(state->clone());
+void FusionCache::materializeFusion(TrieNode* node) {
+  {
+    std::lock_guard<std::mutex> guard(fusions_lock_);
+    rebuildIfEvicted(node->fusion_id);
+    if (lazy_fusion_ids_.erase(node->fusion_id) == 0) {
+      return;
     }
+  }
+  deserializeFusion(node);
+}
 
-    // Destroy current fusion state
-    queue.pop_front();
-    state_queue.pop_front();
+void FusionCache::buildFusionFromTrie(TrieNode* node, FusionSchedules* scheds)
+    const {
+  // Build the Fusion container from the records on the path from the root
+  std::vector<TrieNode*> path;
+  for (TrieNode* path_node = node; path_node != nullptr;
+       path_node = path_node->parent) {
+    path.push_back(path_node);
   }
+  FusionState state;
+  for (auto it = path.rbegin(); it != path.rend(); ++it) {
+    state.addRecord((*it)->record->clone());
+  }
+  state.buildFusionIr(scheds->preschedFusion());
+}
 
-  std::atomic<bool> detect_exception_in_thread_pool{false};
-  // Deserialize terminal_nodes field in the FusionCache table
-  for (auto idx : c10::irange(fusions_.size())) {
-    auto node_idx = fusion_cache_buffer->terminal_nodes()->Get(idx);
-    auto trie_node = bfs_order.at(node_idx);
-    terminal_nodes_.push_back(trie_node);
-
-    auto fb_fec_node = fusion_cache_buffer->auto_gen_schedules()->Get(idx);
-    auto fusion_schedule = queryFusionSchedules(trie_node->fusion_id);
-
-    if (!isOptionDisabled(DisableOption::ParallelSerde)) {
-      // Parallelize the deserialization of each FusionExecutorCache.
-      getThreadPool()->run([=, &detect_exception_in_thread_pool]() {
-        FUSER_PERF_SCOPE("FusionCache::deserializeFusionParallel");
-        try {
-          fusion_schedule->auto_gen_schedules->deserialize(
-              fb_fec_node, (int64_t)trie_node->fusion_id);
-        } catch (const std::exception& e) {
-          // Set flag inside lambda so we can throw an exception after thread
-          // pool completes its work.
-          detect_exception_in_thread_pool.store(true);
-        }
-      });
-    } else {
-      FUSER_PERF_SCOPE("FusionCache::deserializeFusionSerial");
-      fusion_schedule->auto_gen_schedules->deserialize(
-          fb_fec_node, (int64_t)trie_node->fusion_id);
+void FusionCache::deserializeFusion(TrieNode* node) {
+  FUSER_PERF_SCOPE("FusionCache::deserializeFusion");
+  const size_t fusion_id = node->fusion_id;
+
+  FusionSchedules* fusion_schedule = queryFusionSchedules(fusion_id);
+  buildFusionFromTrie(node, fusion_schedule);
+
+  try {
+    fusion_schedule->auto_gen_schedules->deserialize(
+        fusion_cache_buffer_->auto_gen_schedules()->Get(fusion_id),
+        (int64_t)fusion_id);
+  } catch (const std::exception& e) {
+    // The other fusions in the workspace may still be valid, so only this
+    // fusion starts over as if it was newly defined
+    TORCH_WARN(
+        "Failed to deserialize the kernels of fusion ",
+        fusion_id,
+        ", which will be compiled again.\n",
+        e.what());
+    auto new_fusion_schedule =
+        std::make_shared<FusionSchedules>((int64_t)fusion_id);
+    buildFusionFromTrie(node, new_fusion_schedule.get());
+    std::lock_guard<std::mutex> guard(fusions_lock_);
+    fusions_.at(fusion_id) = std::move(new_fusion_schedule);
+  }
+  // The kernels in the workspace need not be journaled again
+  fusion_schedule = queryFusionSchedules(fusion_id);
+  fusion_schedule->journaled_modules =
+      fusion_schedule->auto_gen_schedules->loadedModules().first;
+  std::lock_guard<std::mutex> guard(fusions_lock_);
+  ++num_live_fusions_;
+}
+
+void FusionCache::materializeAll() {
+  if (fusion_cache_buffer_ == nullptr) {
+    return;
+  }
+  FUSER_PERF_SCOPE("FusionCache::materializeAll");
+
+  // Create the remaining trie nodes
+  std::vector<TrieNode*> lazy_terminal_nodes;
+  std::vector<TrieNode*> stack = {root_.get()};
+  while (!stack.empty()) {
+    TrieNode* node = stack.back();
+    stack.pop_back();
+    if (node->isTerminal()) {
+      std::lock_guard<std::mutex> guard(fusions_lock_);
+      if (lazy_fusion_ids_.erase(node->fusion_id) > 0) {
+        lazy_terminal_nodes.push_back(node);
+      }
+      continue;
+    }
+    materializeChildren(node);
+    for (auto& iter : node->children) {
+      stack.push_back(iter.second.get());
     }
   }
+  NVF_ERROR(lazy_fusion_ids_.empty());
 
-  if (!isOptionDisabled(DisableOption::ParallelSerde)) {
-    // Wait until all fusion executor caches are deserialized
-    getThreadPool()->waitWorkComplete();
-    NVF_ERROR(
-        !detect_exception_in_thread_pool.load(),
-        "Detected exception while deserializing fusions in parallel.\n",
-        "Use NVFUSER_DISABLE=parallel_serde to print exception message.");
+  if (isOptionDisabled(DisableOption::ParallelSerde)) {
+    for (TrieNode* node : lazy_terminal_nodes) {
+      deserializeFusion(node);
+    }
+    return;
   }
+
+  // Parallelize the deserialization of the remaining fusions
+  std::atomic<bool> detect_exception_in_thread_pool{false};
+  for (TrieNode* node : lazy_terminal_nodes) {
+    getThreadPool()->run([this, node, &detect_exception_in_thread_pool]() {
+      try {
+        deserializeFusion(node);
+      } catch (const std::exception& e) {
+        // Set flag inside lambda so we can throw an exception after thread
+        // pool completes its work.
+        detect_exception_in_thread_pool.store(true);
+      }
+    });
+  }
+  // Wait until all fusions are deserialized
+  getThreadPool()->waitWorkComplete();
+  NVF_ERROR(
+      !detect_exception_in_thread_pool.load(),
+      "Detected exception while deserializing fusions in parallel.\n",
+      "Use NVFUSER_DISABLE=parallel_serde to print exception message.");
 }
 
 } // namespace nvfuser::python_frontend
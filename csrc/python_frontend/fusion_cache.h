@@ -12,8 +12,14 @@
 #include <kernel_cache.h>
 #include <python_frontend/fusion_record.h>
 
+#include <atomic>
+#include <functional>
+#include <map>
 #include <memory>
 #include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 namespace nvfuser::python_frontend {
 
@@ -57,6 +63,13 @@ struct FusionSchedules {
   std::mutex scheds_lock;
   //! ID of fusion in python frontend fusion cache
   int64_t fusion_id_ = -1;
+  //! Loaded kernel modules of auto_gen_schedules and the size of their
+  //! binaries as of the last execution. See [ FusionCache Eviction ].
+  size_t num_modules = 0;
+  size_t module_bytes = 0;
+  //! Number of kernel modules in the last journal entry of this fusion. See
+  //! [ FusionCache Journal ].
+  size_t journaled_modules = 0;
 };
 
 //! \struct TrieNode
@@ -94,8 +107,15 @@ struct TrieNode {
   TrieNode* parent;
   //! For thread-Safe locking of a node
   std::mutex trie_node_lock;
+  //! Index of this node in the structure field of the mapped FusionCache
+  //! buffer if its children have not been created yet, -1 otherwise. See
+  //! [ Lazy Deserialization of the FusionCache ].
+  int64_t lazy_structure_idx = -1;
 };
 
+//! Read-only memory mapping of a serialized FusionCache file
+class FusionCacheBuffer;
+
 //! \class FusionCache
 //! \brief A singleton class used in the nvFuser python interface
 //! to manage the caching of fusions.
@@ -104,16 +124,89 @@ struct TrieNode {
 //! cache fusions.  A leaf of the tree with a terminal node contains a
 //! container for caching the kernels generated for specific fusions.
 //!
-//! \todo
-//! Add the ability to evict a fusion.  There is currently a max number
-//! of fusions that is checked to prevent a runaway case.
+//! There is a max number of fusions that is checked to prevent a runaway
+//! case, and the kernels of least recently used fusions can be evicted, see
+//! [ FusionCache Eviction ].
 //!
 //! \note
-//! Thread-Safety is assured by the Python GIL.  If a no-GIL python is used
-//! then further scrutiny needs to be applied to the mutexes used to limit
-//! acccess to the singleton pointer, node creation, and user schedule
-//! creation.  Otherwise, the Python GIL provides a natural thread based mutex
-//! that does not allow for multiple threads to interact.
+//! Thread-Safety of definitions is assured by the Python GIL, which is held
+//! while records are defined and the trie is queried.  If a no-GIL python is
+//! used then further scrutiny needs to be applied to the mutexes used to
+//! limit acccess to the singleton pointer, node creation, and user schedule
+//! creation.  Executing a fusion releases the GIL, so the fusions_ vector
+//! and the user schedules, which are read during execution, are guarded by
+//! fusions_lock_ and FusionSchedules::scheds_lock. FusionExecutorCache
+//! guards itself, see [ Concurrent Execution ].
+//!
+//! [ Lazy Deserialization of the FusionCache ]
+//!
+//! A serialized FusionCache can contain thousands of fusions, and building
+//! every Fusion and FusionExecutorCache upfront makes the startup of every
+//! process slow, although most processes only use a few of them. Instead,
+//! deserialize maps the file into memory and only verifies it. The root
+//! TrieNode refers to its entry in the flatbuffer, and the children of a
+//! TrieNode are only created when a query first reaches it. When a query
+//! reaches a terminal node whose fusion has not been deserialized, the
+//! Fusion IR is built from the records on the path to the node and its
+//! FusionExecutorCache is deserialized. If that fails, the fusion starts
+//! with an empty FusionExecutorCache as if it was newly defined.
+//!
+//! Printing and serializing the cache need the complete trie, so they
+//! deserialize everything that is still pending. The mapping is kept for
+//! the lifetime of the FusionCache.
+//!
+//! [ Definition Hash ]
+//!
+//! Walking the trie takes a lookup in the children of a node for every
+//! record, each of which calls the virtual hash and operator== of the
+//! record. For definitions of hundreds of records that are entered again
+//! and again, these walks add up. Instead, FusionDefinition only combines
+//! the hashes of its records while they are defined, and finalizeDefinition
+//! looks up the terminal node in a single step with queryDefinition. A
+//! candidate terminal node is only accepted if the records on its path are
+//! equal to the records of the definition, so a collision of the hashes
+//! falls back to the walk of the trie. Terminal nodes are indexed after
+//! the walk, which also covers nodes created by lazy deserialization.
+
+//!
+//! [ FusionCache Eviction ]
+//!
+//! Services that see many definitions, e.g., with dynamic shapes, keep
+//! compiling kernels for fusions that are rarely used again. With
+//! setEvictionLimits, the number of live fusions, i.e., the fusions that
+//! have a FusionExecutorCache with their Fusion IR, and the size of the
+//! binaries of their loaded kernel modules can be limited. The modules of a
+//! fusion are accounted by releaseFusionSchedules after each execution,
+//! which then evicts the least recently executed fusions until the limits
+//! are met again. The fusion that just ran is never evicted.
+//!
+//! Evicting a fusion replaces its FusionSchedules with an empty one, which
+//! frees its FusionKernelRuntimes, CUmodules and user schedules once running
+//! executions are done, since executions hold a shared_ptr. The trie and
+//! the fusion id are kept, so existing FusionDefinitions and handles stay
+//! valid. When the fusion is queried again, its Fusion IR is rebuilt from
+//! the records on the path to its terminal node, as for lazy
+//! deserialization, and its kernels are compiled again when it runs. Host
+//! memory of the trie itself and of the Fusion IR is not accounted.
+//!
+//! [ FusionCache Journal ]
+//!
+//! The workspace is only written by serialize, usually at exit, so the
+//! kernels compiled by processes that crash or are killed are lost. With
+//! EnableOption::FusionCacheJournal, releaseFusionSchedules appends a fusion
+//! to a journal next to the workspace whenever it has loaded new kernel
+//! modules. Each entry is a complete FusionCache flatbuffer with the path
+//! of the fusion in the trie and its FusionExecutorCache, prefixed by its
+//! size, and is written with a single append. Entries therefore don't
+//! depend on each other, and a truncated last entry is skipped.
+//!
+//! When FusionCache::get loads the workspace, the journal is replayed in
+//! order after it: the path of each entry is added to the trie and the
+//! fusion is replaced by the one in the entry. serialize compacts the
+//! journal by writing the complete cache to the workspace and then removing
+//! the journal, since all of its fusions are in the new workspace. When
+//! processes share the workspace, see [ Shared Kernel DB ], the journal is
+//! kept if other processes have appended to it since it was replayed.
 
 class FusionCache {
   //! The constructor is private given the FusionCache is only constructed
@@ -125,6 +218,7 @@ class FusionCache {
   //! clang-tidy: deleted member function should be public
   FusionCache(const FusionCache&) = delete;
   FusionCache& operator=(const FusionCache&) = delete;
+  ~FusionCache();
 
   //! The next 4 public methods are the python interface methods
 
@@ -135,14 +229,16 @@ class FusionCache {
   //! Number of fusions cached
   size_t numFusions() const;
   //! print cache contents
-  void print(std::ostream& os) const;
+  void print(std::ostream& os);
   //! print cache stats
   void stats(std::ostream& os) const;
   //! Reset Cache to an empty state
   static void reset();
+  //! Number of resets, each of which invalidates the FusionSchedules
+  static size_t generation();
 
   //! Serialize Fusion Cache using flatbuffers
-  void serialize(std::string filename) const;
+  void serialize(std::string filename);
   //! Deserialize Fusion Cache using flatbuffers
   void deserialize(std::string filename);
 
@@ -150,10 +246,26 @@ class FusionCache {
 
   //! Thread-Unsafe: Queries the current trie node to see if a record matches
   //! one of its children
-  std::optional<TrieNode*> queryChildren(TrieNode* node, RecordFunctor* rec)
-      const;
-  //! Query a Fusion's Schedules based on fusion id or cache id
-  FusionSchedules* queryFusionSchedules(size_t fusion_id) const;
+  std::optional<TrieNode*> queryChildren(TrieNode* node, RecordFunctor* rec);
+  //! Thread-Unsafe: Queries the terminal node of a definition by the
+  //! combined hash of its records. See [ Definition Hash ].
+  std::optional<TrieNode*> queryDefinition(
+      size_t definition_hash,
+      const std::vector<std::unique_ptr<RecordFunctor>>& records);
+  //! Query a Fusion's Schedules based on fusion id or cache id. The Fusion
+  //! IR of an evicted fusion is rebuilt.
+  FusionSchedules* queryFusionSchedules(size_t fusion_id);
+  //! Thread-Safe: Like queryFusionSchedules, but marks the fusion as used
+  //! and keeps its schedules alive during an execution even if it is
+  //! evicted. See [ FusionCache Eviction ].
+  std::shared_ptr<FusionSchedules> acquireFusionSchedules(size_t fusion_id);
+  //! Thread-Safe: Accounts the kernel modules of a fusion after it was
+  //! executed and evicts the least recently used fusions if a limit of
+  //! setEvictionLimits is exceeded
+  void releaseFusionSchedules(size_t fusion_id);
+  //! Limits the number of live fusions and the bytes of their loaded kernel
+  //! modules, where 0 is unlimited. See [ FusionCache Eviction ].
+  void setEvictionLimits(size_t max_live_fusions, size_t max_module_bytes);
   //! Lookup the User Schedule Id and return null if one does not exist.
   //! NOTE: this method cannot be const because the InputsIdLookup can
   //! cause a modification to that data member for cache eviction.
@@ -168,6 +280,15 @@ class FusionCache {
   //! Thread-Safe: Creates a child node for the current cache entry and an
   //! optional fusion_id is returned if the new entry is terminal
   TrieNode* createChild(TrieNode* node, RecordFunctor* rec);
+  //! Thread-Safe: Indexes a terminal node by the combined hash of the
+  //! records of its definition
+  void registerDefinition(size_t definition_hash, TrieNode* terminal);
+  //! Thread-Safe: The FusionExecutorCache of a stitched sequence of calls
+  //! of fusions by its key, which is created from the Fusion of stitch if the
+  //! sequence is new. See [ Lazy Execution ].
+  FusionExecutorCache* queryStitchedFusion(
+      const std::vector<int64_t>& key,
+      const std::function<std::unique_ptr<Fusion>()>& stitch);
   //! Lookup the User Schedule based on Id
   UserSchedule* createUserSchedule(
       FusionSchedules* scheds,
@@ -175,22 +296,70 @@ class FusionCache {
       int device);
   //! Get the root Trie ptr
   TrieNode* rootTriePtr();
+  //! Returns whether all entries of the journal were replayed or appended
+  //! by this process, so that the journal can be removed once the cache is
+  //! serialized. See [ FusionCache Journal ].
+  bool ownsJournal();
+
+ private:
+  //! Create the children of a node that are still in the mapped buffer
+  void materializeChildren(TrieNode* node);
+  //! Build the Fusion IR and deserialize the FusionExecutorCache of a
+  //! terminal node if they are still in the mapped buffer
+  void materializeFusion(TrieNode* node);
+  //! Does the work of materializeFusion for a fusion that has been removed
+  //! from lazy_fusion_ids_. Fusions can be deserialized in parallel.
+  void deserializeFusion(TrieNode* node);
+  //! Create all nodes and fusions that are still in the mapped buffer
+  void materializeAll();
+  //! Builds the Fusion IR of scheds from the records on the path to the
+  //! terminal node
+  void buildFusionFromTrie(TrieNode* node, FusionSchedules* scheds) const;
+  //! Rebuilds the Fusion IR of an evicted fusion. fusions_lock_ must be
+  //! held.
+  void rebuildIfEvicted(size_t fusion_id);
+  //! Evicts the least recently used fusions other than keep_fusion_id until
+  //! the limits are met and returns their schedules. fusions_lock_ must be
+  //! held.
+  std::vector<std::shared_ptr<FusionSchedules>> evictLeastRecentlyUsed(
+      size_t keep_fusion_id);
+  //! Appends the fusion of the terminal node to the journal. See
+  //! [ FusionCache Journal ].
+  void appendToJournal(TrieNode* terminal, FusionSchedules* scheds);
+  //! Adds the fusions of the journal to the cache in order
+  void replayJournal(const std::string& filename);
 
  private:
   //! The static pointer to the FusionCache
   static FusionCache* singleton_;
   //! Lock for accessing the singleton by multiple threads
   static std::mutex singleton_lock_;
+  //! Incremented by reset
+  static std::atomic<size_t> generation_;
 
   //! The max allowed number of fusions in the cache
   size_t max_fusions_;
   //! The root (start) of the prefix tree to start a cache look up of a given
   //! fusion definition.
   std::unique_ptr<TrieNode> root_;
-  //! A vector of nvFuser Fusion IR fusions.
-  std::vector<std::unique_ptr<FusionSchedules>> fusions_;
+  //! A vector of nvFuser Fusion IR fusions. They are shared with running
+  //! executions, so evicting a fusion doesn't free them while in use.
+  std::vector<std::shared_ptr<FusionSchedules>> fusions_;
+  //! For thread-Safe access to fusions_ during execution
+  mutable std::mutex fusions_lock_;
   //! A vector of Terminal trie nodes for Stats collection
   std::vector<TrieNode*> terminal_nodes_;
+  //! Terminal nodes by the combined hash of the records of their
+  //! definitions. See [ Definition Hash ].
+  std::unordered_map<size_t, std::vector<TrieNode*>> definitions_;
+  //! For thread-Safe registration of definitions
+  std::mutex definitions_lock_;
+  //! Stitched sequences of calls by the fusion ids and arguments of their
+  //! calls. They are not evicted. See [ Lazy Execution ].
+  std::map<std::vector<int64_t>, std::unique_ptr<FusionExecutorCache>>
+      stitched_fusions_;
+  //! For thread-Safe creation of stitched fusions
+  std::mutex stitched_fusions_lock_;
 
   //! Items specifically to aid user defined schedules these data members
   //! are for the mechanics of user schedule usage and don't make sense as
@@ -200,10 +369,48 @@ class FusionCache {
   // NOTE: I would prefer this be per FusionSchedules object but the container
   // is not allowed to be copied or moved.
   InputsIdLookup user_def_input_encodings_;
+
+  //! Items for lazy deserialization. See
+  //! [ Lazy Deserialization of the FusionCache ].
+
+  //! The mapped flatbuffer, which lazily created nodes and fusions refer to
+  std::unique_ptr<FusionCacheBuffer> serde_buffer_;
+  //! Root table of serde_buffer_
+  const serde::FusionCache* fusion_cache_buffer_ = nullptr;
+  //! Ids of the fusions that have not been deserialized yet
+  std::unordered_set<size_t> lazy_fusion_ids_;
+
+  //! Items for eviction, guarded by fusions_lock_. See
+  //! [ FusionCache Eviction ].
+
+  //! Limits of setEvictionLimits, 0 if unlimited
+  size_t max_live_fusions_ = 0;
+  size_t max_module_bytes_ = 0;
+  //! Logical clock of the last use of each fusion, parallel to fusions_
+  std::vector<uint64_t> last_used_;
+  uint64_t clock_ = 0;
+  //! Ids of the evicted fusions, whose Fusion IR is rebuilt on their next
+  //! query
+  std::unordered_set<size_t> evicted_fusion_ids_;
+  //! Totals of the live fusions
+  size_t num_live_fusions_ = 0;
+  size_t num_modules_ = 0;
+  size_t module_bytes_ = 0;
+  size_t num_evictions_ = 0;
+
+  //! The mapped journal, which replayed fusions may refer to. See
+  //! [ FusionCache Journal ].
+  std::unique_ptr<FusionCacheBuffer> journal_buffer_;
+  //! Serializes appends to the journal
+  std::mutex journal_lock_;
+  //! Size of the journal entries replayed or appended by this process,
+  //! guarded by journal_lock_
+  size_t journal_bytes_ = 0;
 };
 
 //! Serialize Fusion Cache to common workspace
-//! /tmp/nvfuser_kernel_db/nvf_serde_[cuda_major]_[cuda_minor]_[nvrtc_major]_[nvrtc_minor]
+//! /tmp/nvfuser_kernel_db/nvf_serde_device[major]_[minor], which is shared by
+//! the CUDA versions, see [ Versioned Kernel Entries ]
 //!
 //! '''python
 //! # Use atexit to automatically call serialize on program exit
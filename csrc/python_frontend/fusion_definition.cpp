@@ -7,6 +7,8 @@
 // clang-format on
 #include <debug.h>
 #include <instrumentation.h>
+#include <ir/utils.h>
+#include <iter_visitor.h>
 #include <options.h>
 #include <python_frontend/fusion_cache.h>
 #include <python_frontend/fusion_definition.h>
@@ -31,10 +33,16 @@ const char* dtypeToPyString(PrimDataType t) {
       return "DataType.Half";
     case DataType::BFloat16:
       return "DataType.BFloat16";
+    case DataType::Float8_e4m3fn:
+      return "DataType.Float8_e4m3fn";
+    case DataType::Float8_e5m2:
+      return "DataType.Float8_e5m2";
     case DataType::Int:
       return "DataType.Int";
     case DataType::Int32:
       return "DataType.Int32";
+    case DataType::Int8:
+      return "DataType.Int8";
     case DataType::ComplexFloat:
       return "DataType.ComplexFloat";
     case DataType::ComplexDouble:
@@ -54,6 +62,7 @@ FusionDefinition::FusionDefinition(std::optional<size_t> id, size_t max_length)
       fusion_id_(id),
       fusion_cache_(FusionCache::get()),
       trie_node_(nullptr),
+      definition_hash_(0),
       prev_fusion_(nullptr),
       user_sched_(nullptr),
       ops(this),
@@ -68,11 +77,45 @@ FusionDefinition* FusionDefinition::setupDefinition() {
   NVF_CHECK(max_length_ > 0, "Can't make a FusionDefinition with 0 records!");
   NVF_CHECK(!id().has_value(), "Fusion Schedule is already found!");
   trie_node_ = fusionCache()->rootTriePtr();
+  definition_hash_ = 0;
   return this;
 }
 
 void FusionDefinition::finalizeDefinition() {
   FUSER_PERF_SCOPE("FusionDefinition::finalizeDefinition");
+  auto terminal_node =
+      fusionCache()->queryDefinition(definition_hash_, recording_);
+  if (terminal_node.has_value()) {
+    if (isDebugDumpEnabled(DebugDumpOption::PythonFrontendDebug)) {
+      debug() << "\nFusionDefinition: Terminal Node found by hash (0x"
+              << std::hex << definition_hash_ << ")!\n";
+    }
+    trie_node_ = terminal_node.value();
+    fusion_id_ = std::optional<size_t>(trie_node_->fusion_id);
+    return;
+  }
+
+  for (auto& record : recording_) {
+    auto child_node = fusionCache()->queryChildren(trie_node_, record.get());
+    // If the Record is found in the cache, the FusionDefinition and the Cache
+    // will not share Record given the Record had to be created in order to
+    // match it but it also already existed in the cache.
+    if (child_node.has_value()) {
+      if (isDebugDumpEnabled(DebugDumpOption::PythonFrontendDebug)) {
+        debug() << "\nFusionDefinition: Record (hash: 0x" << std::hex
+                << record->hash() << ") hit in Fusion Cache.\n";
+      }
+      trie_node_ = child_node.value();
+      // The FusionDefinition and the Cache will share the Record
+    } else {
+      if (isDebugDumpEnabled(DebugDumpOption::PythonFrontendDebug)) {
+        debug() << "\nFusionDefinition: Record (hash: 0x" << std::hex
+                << record->hash() << ") missed in Fusion Cache.\n";
+      }
+      trie_node_ = fusionCache()->createChild(trie_node_, record.get());
+    }
+  }
+
   auto child_node = fusionCache()->queryChildren(trie_node_, end_record_.get());
   if (!child_node.has_value()) {
     if (isDebugDumpEnabled(DebugDumpOption::PythonFrontendDebug)) {
@@ -81,6 +124,7 @@ void FusionDefinition::finalizeDefinition() {
     trie_node_ = fusionCache()->createChild(trie_node_, end_record_.get());
     fusion_id_ = std::optional<size_t>(trie_node_->fusion_id);
     NVF_CHECK(id().has_value(), "Invalid fusion id!");
+    fusionCache()->registerDefinition(definition_hash_, trie_node_);
 
     if (isDebugDumpEnabled(DebugDumpOption::PythonDefinition)) {
       print(debug());
@@ -97,6 +141,7 @@ void FusionDefinition::finalizeDefinition() {
     }
     trie_node_ = child_node.value();
     fusion_id_ = std::optional<size_t>(trie_node_->fusion_id);
+    fusionCache()->registerDefinition(definition_hash_, trie_node_);
   }
 }
 
@@ -164,7 +209,7 @@ std::vector<at::Tensor> FusionDefinition::execute(
 
   NVF_CHECK(id().has_value(), "Valid fusion schedule is not available!");
 
-  auto scheds = fusionCache()->queryFusionSchedules(id().value());
+  auto scheds = fusionCache()->acquireFusionSchedules(id().value());
 
   std::vector<at::Tensor> outputs;
 
@@ -173,10 +218,14 @@ std::vector<at::Tensor> FusionDefinition::execute(
     NVF_CHECK(
         inputs.empty() || device > -1,
         "Inputs are not all on the same device or don't match selection!");
-    auto user_sched_id = fusionCache()->queryUserScheduleId(scheds, inputs);
+    // The GIL is released during execution, so user schedules are guarded
+    // against concurrent runs and creation
+    std::lock_guard<std::mutex> guard(scheds->scheds_lock);
+    auto user_sched_id =
+        fusionCache()->queryUserScheduleId(scheds.get(), inputs);
     if (user_sched_id.has_value()) {
       auto& user_sched = fusionCache()->queryUserSchedule(
-          scheds, user_sched_id.value(), device);
+          scheds.get(), user_sched_id.value(), device);
       scheds->last_user_def_scheduled_ir = user_sched.schedule.get();
       scheds->last_user_def_executor = user_sched.executor.get();
       outputs = user_sched.executor->runFusion(inputs);
@@ -185,6 +234,7 @@ std::vector<at::Tensor> FusionDefinition::execute(
 
   outputs = scheds->auto_gen_schedules->runFusionWithInputs(
       inputs, std::nullopt, selected_device);
+  fusionCache()->releaseFusionSchedules(id().value());
 
   if (capture_debug_output) {
     debug_output_ = debug_ss.str();
@@ -193,6 +243,202 @@ std::vector<at::Tensor> FusionDefinition::execute(
   return outputs;
 }
 
+FusionHandle FusionDefinition::handle() const {
+  NVF_CHECK(id().has_value(), "Valid fusion schedule is not available!");
+  return FusionHandle(fusionCache(), id().value());
+}
+
+FusionHandle::FusionHandle(FusionCache* fusion_cache, size_t fusion_id)
+    : fusion_cache_(fusion_cache),
+      fusion_id_(fusion_id),
+      cache_generation_(FusionCache::generation()) {
+  NVF_ERROR(fusion_cache_ != nullptr, "FusionCache pointer is null!");
+}
+
+std::vector<at::Tensor> FusionHandle::execute(
+    const at::ArrayRef<c10::IValue>& inputs,
+    std::optional<int8_t> device) const {
+  FUSER_PERF_SCOPE("FusionHandle::execute");
+  NVF_CHECK(
+      FusionCache::generation() == cache_generation_,
+      "The FusionCache has been reset since the handle of fusion ",
+      fusion_id_,
+      " was created!");
+  auto scheds = fusion_cache_->acquireFusionSchedules(fusion_id_);
+  auto outputs = scheds->auto_gen_schedules->runFusionWithInputs(
+      inputs, std::nullopt, device);
+  fusion_cache_->releaseFusionSchedules(fusion_id_);
+  return outputs;
+}
+
+namespace {
+
+//! Replaces from by to when stitching fusions, and the extents of the
+//! dimensions of a tensor by the ones of to
+void mapStitchedValue(
+    Val* from,
+    Val* to,
+    std::unordered_map<Val*, Val*>& replacement_map) {
+  NVF_CHECK(
+      from->dtype() == to->dtype(),
+      "Cannot stitch ",
+      to->toString(),
+      " to an input of type ",
+      from->dtype());
+  replacement_map.emplace(from, to);
+  auto from_tv = dynamic_cast<TensorView*>(from);
+  if (from_tv == nullptr) {
+    return;
+  }
+  NVF_CHECK(
+      to->isA<TensorView>(),
+      "Cannot stitch ",
+      to->toString(),
+      " to a tensor input");
+  auto from_ids = TensorDomain::noReductions(from_tv->getMaybeRFactorDomain());
+  auto to_ids = TensorDomain::noReductions(
+      to->as<TensorView>()->getMaybeRFactorDomain());
+  NVF_CHECK(
+      from_ids.size() == to_ids.size(),
+      "Cannot stitch ",
+      to->toString(),
+      " to an input of ",
+      from_ids.size(),
+      " dimensions");
+  for (auto i : c10::irange(from_ids.size())) {
+    IterDomain* from_id = from_ids.at(i);
+    IterDomain* to_id = to_ids.at(i);
+    NVF_CHECK(
+        from_id->isBroadcast() == to_id->isBroadcast(),
+        "Cannot stitch ",
+        to->toString(),
+        " to ",
+        from->toString(),
+        " as they differ in broadcast dimensions");
+    // Static extents of the input are kept
+    if (!from_id->isBroadcast() && !from_id->extent()->isConstScalar()) {
+      replacement_map.emplace(from_id->extent(), to_id->extent());
+    }
+  }
+}
+
+} // namespace
+
+std::unique_ptr<Fusion> stitchFusions(
+    const std::vector<Fusion*>& fusions,
+    const std::vector<std::vector<StitchedValue>>& args,
+    const std::vector<StitchedValue>& outputs) {
+  FUSER_PERF_SCOPE("stitchFusions");
+  NVF_ERROR(fusions.size() == args.size(), "Expected arguments of each call");
+  auto stitched = std::make_unique<Fusion>();
+  FusionGuard fg(stitched.get());
+
+  std::vector<Val*> stitched_inputs;
+  std::vector<std::vector<Val*>> call_outputs;
+  call_outputs.reserve(fusions.size());
+  for (auto call : c10::irange(fusions.size())) {
+    Fusion* fusion = fusions.at(call);
+    const std::vector<StitchedValue>& call_args = args.at(call);
+    NVF_CHECK(
+        fusion->inputs().size() == call_args.size(),
+        "Expected ",
+        fusion->inputs().size(),
+        " arguments for call ",
+        call,
+        " of the stitched fusion, but got ",
+        call_args.size());
+    for (auto out : fusion->outputs()) {
+      NVF_CHECK(
+          fusion->getOutputAlias(out).first == nullptr,
+          "Cannot stitch fusions with aliased outputs");
+    }
+
+    // The fusions have the same names, so the clones get new ones
+    IrCloner ir_cloner(stitched.get(), /*keep_names=*/false);
+    for (auto expr : StmtSort::getExprs(fusion, true, true, true)) {
+      ir_cloner.clone(expr);
+    }
+
+    std::unordered_map<Val*, Val*> replacement_map;
+    for (auto i : c10::irange(call_args.size())) {
+      Val* in = ir_cloner.clone(fusion->inputs().at(i));
+      auto [producer, index] = call_args.at(i);
+      if (producer >= 0) {
+        NVF_CHECK(
+            producer < (int64_t)call,
+            "Call ",
+            call,
+            " can only use outputs of earlier calls");
+        mapStitchedValue(
+            in, call_outputs.at(producer).at(index), replacement_map);
+      } else if (index < (int64_t)stitched_inputs.size()) {
+        mapStitchedValue(in, stitched_inputs.at(index), replacement_map);
+      } else {
+        NVF_CHECK(
+            index == (int64_t)stitched_inputs.size(),
+            "Inputs of the stitched fusion must be numbered by first use");
+        stitched->addInput(in);
+        stitched_inputs.push_back(in);
+      }
+    }
+    if (!replacement_map.empty()) {
+      ir_utils::replaceValue(stitched.get(), replacement_map);
+    }
+
+    // Outputs that are inputs of the call are replaced as well
+    std::vector<Val*>& outs = call_outputs.emplace_back();
+    for (auto out : ir_cloner.clone(fusion->outputs())) {
+      auto it = replacement_map.find(out);
+      outs.push_back(it == replacement_map.end() ? out : it->second);
+    }
+  }
+
+  for (auto [producer, index] : outputs) {
+    stitched->addOutput(
+        producer >= 0 ? call_outputs.at(producer).at(index)
+                      : stitched_inputs.at(index));
+  }
+  return stitched;
+}
+
+std::vector<at::Tensor> executeStitched(
+    const std::vector<size_t>& fusion_ids,
+    const std::vector<std::vector<StitchedValue>>& args,
+    const std::vector<StitchedValue>& outputs,
+    const at::ArrayRef<c10::IValue>& inputs,
+    std::optional<int8_t> device) {
+  FUSER_PERF_SCOPE("executeStitched");
+  // Each list is prefixed by its size, so that keys don't collide
+  std::vector<int64_t> key;
+  key.push_back((int64_t)fusion_ids.size());
+  key.insert(key.end(), fusion_ids.begin(), fusion_ids.end());
+  for (const auto& values : args) {
+    key.push_back((int64_t)values.size());
+    for (auto [producer, index] : values) {
+      key.push_back(producer);
+      key.push_back(index);
+    }
+  }
+  for (auto [producer, index] : outputs) {
+    key.push_back(producer);
+    key.push_back(index);
+  }
+
+  FusionCache* fusion_cache = FusionCache::get();
+  FusionExecutorCache* executor_cache =
+      fusion_cache->queryStitchedFusion(key, [&]() {
+        // Evicted fusions are rebuilt and kept alive while they are stitched
+        std::vector<std::shared_ptr<FusionSchedules>> scheds;
+        std::vector<Fusion*> fusions;
+        for (auto fusion_id : fusion_ids) {
+          scheds.push_back(fusion_cache->acquireFusionSchedules(fusion_id));
+          fusions.push_back(scheds.back()->preschedFusion());
+        }
+        return stitchFusions(fusions, args, outputs);
+      });
+  return executor_cache->runFusionWithInputs(inputs, std::nullopt, device);
+}
+
 std::string FusionDefinition::fusionIr() {
   NVF_CHECK(id().has_value(), "Invalid fusion definition!");
   std::stringstream ss;
@@ -200,6 +446,11 @@ std::string FusionDefinition::fusionIr() {
   return ss.str();
 }
 
+size_t FusionDefinition::numOutputs() {
+  NVF_CHECK(id().has_value(), "Invalid fusion definition!");
+  return preschedFusion()->outputs().size();
+}
+
 std::string FusionDefinition::lastCudaCode(
     bool intrinsic_code,
     bool override_user_schedule) const {
@@ -221,6 +472,18 @@ std::string FusionDefinition::lastCudaCode(
   return result;
 }
 
+std::vector<FusionExecutor::KernelResources> FusionDefinition::
+    lastKernelResources(bool override_user_schedule) const {
+  NVF_CHECK(id().has_value(), "Invalid fusion definition!");
+  auto scheds = fusionCache()->queryFusionSchedules(id().value());
+  auto user_exec = scheds->last_user_def_executor;
+
+  if (!override_user_schedule && (user_exec != nullptr)) {
+    return {user_exec->kernelResources()};
+  }
+  return scheds->auto_gen_schedules->getMostRecentKernelResources();
+}
+
 std::string FusionDefinition::cudaCodeFor(
     const at::ArrayRef<c10::IValue>& inputs,
     bool intrinsic_code,
@@ -233,10 +496,11 @@ std::string FusionDefinition::cudaCodeFor(
     NVF_CHECK(
         inputs.empty() || device > -1,
         "Inputs are not all on the same device!");
-    auto user_sched_id = fusionCache()->queryUserScheduleId(scheds, inputs);
+    auto user_sched_id =
+        fusionCache()->queryUserScheduleId(scheds.get(), inputs);
     if (user_sched_id.has_value()) {
       auto& user_sched = fusionCache()->queryUserSchedule(
-          scheds, user_sched_id.value(), device);
+          scheds.get(), user_sched_id.value(), device);
       auto user_exec = user_sched.executor.get();
       if (intrinsic_code) {
         return user_exec->getStructuredCode(
@@ -280,10 +544,11 @@ std::string FusionDefinition::scheduledFusionIrFor(
     NVF_CHECK(
         inputs.empty() || device > -1,
         "Inputs are not all on the same device!");
-    auto user_sched_id = fusionCache()->queryUserScheduleId(scheds, inputs);
+    auto user_sched_id =
+        fusionCache()->queryUserScheduleId(scheds.get(), inputs);
     if (user_sched_id.has_value()) {
       auto& user_sched = fusionCache()->queryUserSchedule(
-          scheds, user_sched_id.value(), device);
+          scheds.get(), user_sched_id.value(), device);
       auto user_sched_ir = user_sched.schedule.get();
       std::stringstream ss;
       user_sched_ir->print(ss, tensor_transforms);
@@ -328,26 +593,9 @@ void FusionDefinition::defineRecord(RecordFunctor* record) {
       "operations.  The max_length for FusionDefintion's might need to be ",
       "increased if the definition is created as expected.");
   addRecord(record);
-  auto child_node =
-      fusionCache()->queryChildren(trie_node_, recording_.back().get());
-  // If the Record is found in the cache, the FusionDefinition and the Cache
-  // will not share Record given the Record had to be created in order to
-  // match it but it also already existed in the cache.
-  if (child_node.has_value()) {
-    if (isDebugDumpEnabled(DebugDumpOption::PythonFrontendDebug)) {
-      debug() << "\nFusionDefinition: Record (hash: 0x" << std::hex
-              << record->hash() << ") hit in Fusion Cache.\n";
-    }
-    trie_node_ = child_node.value();
-    // The FusionDefinition and the Cache will share the Record
-  } else {
-    if (isDebugDumpEnabled(DebugDumpOption::PythonFrontendDebug)) {
-      debug() << "\nFusionDefinition: Record (hash: 0x" << std::hex
-              << record->hash() << ") missed in Fusion Cache.\n";
-    }
-    trie_node_ =
-        fusionCache()->createChild(trie_node_, recording_.back().get());
-  }
+  // The trie is only walked by finalizeDefinition if the definition is not
+  // found by its hash. See [ Definition Hash ].
+  hashCombine(definition_hash_, record->hash());
 }
 
 Fusion* FusionDefinition::preschedFusion() {
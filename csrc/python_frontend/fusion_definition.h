@@ -88,6 +88,77 @@ struct Vector {
   FusionDefinition* fusion_definition;
 };
 
+//! [ Fusion Handles ]
+//!
+//! Executing a FusionDefinition of a child class runs its definition() in
+//! Python again, which records every operation only to find the fusion in
+//! the FusionCache. In a training loop that is repeated on every step for
+//! the same fusion. A FusionHandle is bound to the id of a defined fusion
+//! instead, so calling it only converts the arguments in C++, acquires the
+//! schedules of the fusion and calls runFusionWithInputs without the GIL.
+//! Handles only run the automatically generated schedules, and
+//! FusionCache::reset invalidates them.
+class FusionHandle {
+ public:
+  FusionHandle(FusionCache* fusion_cache, size_t fusion_id);
+
+  //! Runs the fusion with inputs, optionally on the selected device
+  std::vector<at::Tensor> execute(
+      const at::ArrayRef<c10::IValue>& inputs,
+      std::optional<int8_t> device) const;
+  //! Return fusion id of the handled fusion in the FusionCache
+  size_t id() const {
+    return fusion_id_;
+  }
+
+ private:
+  FusionCache* fusion_cache_;
+  size_t fusion_id_;
+  //! FusionCache::generation() when the handle was created
+  size_t cache_generation_;
+};
+
+//! [ Lazy Execution ]
+//!
+//! Framework integrations often execute several small fusions back to back,
+//! where the outputs of one are the inputs of the next. Each boundary writes
+//! the intermediate tensors to global memory, reads them back and launches
+//! another kernel. In nvfuser.lazy_execution(), FusionDefinition.execute
+//! returns LazyTensors and queues the call instead. When a LazyTensor is
+//! materialized, the queued calls are stitched into one Fusion by
+//! stitchFusions: the statements of each fusion are cloned into it, and the
+//! inputs of a call that are outputs of earlier calls are replaced by them,
+//! along with their extents. Only the outputs that still have a LazyTensor
+//! are outputs of the stitched fusion, so the others can stay in registers.
+//!
+//! The stitched Fusion is segmented and compiled by its own
+//! FusionExecutorCache, which the FusionCache keeps by the fusion ids of the
+//! calls and how their arguments are wired, so the same sequence is only
+//! stitched once. Stitched fusions are not evicted, serialized or printed
+//! with the cache.
+
+//! An argument or output of a call of a stitched sequence: {-1, i} is input
+//! i of the stitched fusion and {c, i} is output i of the earlier call c
+using StitchedValue = std::pair<int64_t, int64_t>;
+
+//! Stitches the fusions of a sequence of calls into one Fusion, where
+//! args[c] are the arguments of call c and outputs are the outputs of the
+//! stitched fusion. Inputs of the stitched fusion are numbered by their
+//! first use. See [ Lazy Execution ].
+std::unique_ptr<Fusion> stitchFusions(
+    const std::vector<Fusion*>& fusions,
+    const std::vector<std::vector<StitchedValue>>& args,
+    const std::vector<StitchedValue>& outputs);
+
+//! Executes the sequence of calls of the fusions of fusion_ids stitched by
+//! stitchFusions, compiling it if the sequence is new
+std::vector<at::Tensor> executeStitched(
+    const std::vector<size_t>& fusion_ids,
+    const std::vector<std::vector<StitchedValue>>& args,
+    const std::vector<StitchedValue>& outputs,
+    const at::ArrayRef<c10::IValue>& inputs,
+    std::optional<int8_t> device);
+
 //! FusionDefinition defines the C++ side of a Python Context manager to
 //! encapsulate the definition of fusion operations.
 //!
@@ -130,6 +201,9 @@ class FusionDefinition : public FusionState {
       bool override_user_schedule,
       bool capture_debug_output,
       std::optional<int8_t> device) const;
+  //! Returns a handle that executes the fusion without the definition. See
+  //! [ Fusion Handles ].
+  FusionHandle handle() const;
   //! Return debugging output captured through exeuction with
   //! capture_debug_output=true
   std::optional<std::string> getDebugOutput() const {
@@ -141,9 +215,15 @@ class FusionDefinition : public FusionState {
 
   //! Return the unscheduled Fusion IR
   std::string fusionIr();
+  //! Return the number of outputs of the fusion
+  size_t numOutputs();
   //! Return the Cuda code for the last executed set of inputs
   std::string lastCudaCode(bool intrinsic_code, bool override_user_schedule)
       const;
+  //! Return the resources of the kernels of the last executed set of inputs,
+  //! see [ Kernel Resources ]
+  std::vector<FusionExecutor::KernelResources> lastKernelResources(
+      bool override_user_schedule) const;
   //! Return the Cuda code for the given inputs
   std::string cudaCodeFor(
       const at::ArrayRef<c10::IValue>& inputs,
@@ -197,6 +277,8 @@ class FusionDefinition : public FusionState {
   FusionCache* fusion_cache_;
   //! Current pointer to node in FusionCache.
   TrieNode* trie_node_;
+  //! Combined hash of the records defined so far. See [ Definition Hash ].
+  size_t definition_hash_;
 
   // Book keeping data members for user created schedules
 
@@ -0,0 +1,76 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <python_frontend/fusion_record.h>
+
+#include <array>
+#include <new>
+
+namespace nvfuser::python_frontend {
+
+namespace {
+
+// Records are pooled in sizes of multiples of kPoolGranularity up to
+// kMaxPooledSize bytes, see [ Record Pool ]
+constexpr size_t kPoolGranularity = 16;
+constexpr size_t kMaxPooledSize = 512;
+constexpr size_t kNumPooledSizes = kMaxPooledSize / kPoolGranularity;
+// Number of freed records a thread keeps of each size
+constexpr size_t kMaxPooledRecords = 4096;
+
+// A freed record in the list of the records of its size
+struct FreeRecord {
+  FreeRecord* next;
+};
+
+// Trivially destructible, so that it's still valid while the thread exits
+struct RecordPool {
+  std::array<FreeRecord*, kNumPooledSizes> free_records;
+  std::array<size_t, kNumPooledSizes> num_free_records;
+};
+
+thread_local RecordPool record_pool = {};
+
+size_t pooledSizeIndex(size_t size) {
+  return (size + kPoolGranularity - 1) / kPoolGranularity - 1;
+}
+
+} // namespace
+
+void* RecordFunctor::operator new(size_t size) {
+  if (size == 0 || size > kMaxPooledSize) {
+    return ::operator new(size);
+  }
+  const size_t index = pooledSizeIndex(size);
+  if (FreeRecord* record = record_pool.free_records[index]) {
+    record_pool.free_records[index] = record->next;
+    --record_pool.num_free_records[index];
+    return record;
+  }
+  return ::operator new((index + 1) * kPoolGranularity);
+}
+
+void RecordFunctor::operator delete(void* ptr, size_t size) {
+  if (ptr == nullptr) {
+    return;
+  }
+  if (size == 0 || size > kMaxPooledSize) {
+    ::operator delete(ptr);
+    return;
+  }
+  const size_t index = pooledSizeIndex(size);
+  if (record_pool.num_free_records[index] >= kMaxPooledRecords) {
+    ::operator delete(ptr);
+    return;
+  }
+  auto record = static_cast<FreeRecord*>(ptr);
+  record->next = record_pool.free_records[index];
+  record_pool.free_records[index] = record;
+  ++record_pool.num_free_records[index];
+}
+
+} // namespace nvfuser::python_frontend
@@ -40,6 +40,17 @@ namespace nvfuser::python_frontend {
 //! The print function is used to print the given Record as a statement
 //! in a python formated function.
 
+//! [ Record Pool ]
+//!
+//! Every operation of a definition allocates a record, which is usually
+//! discarded with its FusionDefinition after the definition is found in the
+//! FusionCache. A training loop that defines the same fusions on every step
+//! therefore keeps allocating and freeing the same records. Records of up
+//! to 512 bytes are instead pooled by size in multiples of 16 bytes, and a
+//! freed record is kept in the pool of the freeing thread, up to 4096 per
+//! size, for the next record of its size. The pools of a thread are trivially
+//! destructible, so records can still be freed while the thread exits, and
+//! its pooled records leak when it exits.
 struct RecordFunctor {
   RecordFunctor(
       std::vector<State> _args,
@@ -55,6 +66,11 @@ struct RecordFunctor {
   //! Allows for copying of Child Class objects with RecordFunctor pointers.
   virtual RecordFunctor* clone() = 0;
 
+  //! Records are recycled by the thread that frees them. See
+  //! [ Record Pool ].
+  static void* operator new(size_t size);
+  static void operator delete(void* ptr, size_t size);
+
   //! The base class is placing the type, outputs, and args hashed as follows:
   //! | 63 - 56 | 55 - 48 | 47 ----------- 32 | 32 ------------------------  0 |
   //! | Type    | Outputs | Args              | Child Class Specified          |
@@ -7,21 +7,29 @@
 // clang-format on
 #include <python_frontend/python_bindings.h>
 
+#include <ATen/DLConvertor.h>
+#include <ATen/cuda/CUDAContext.h>
+#include <c10/cuda/CUDAGuard.h>
 #include <c10/util/ArrayRef.h>
 #include <c10/util/irange.h>
+#include <compile_thread_pool.h>
 #include <instrumentation.h>
 #include <ir/all_nodes.h>
 #include <ir/builder.h>
 #include <ops/all_ops.h>
+#include <options.h>
 #include <python_frontend/fusion_cache.h>
 #include <python_frontend/fusion_definition.h>
 #include <python_frontend/fusion_record.h>
 #include <python_frontend/python_bindings.h>
+#include <scheduler/autotune.h>
+#include <torch/csrc/autograd/python_variable.h>
 #include <torch/csrc/jit/python/pybind_utils.h>
 #include <complex>
 #include <iostream>
 #include <optional>
 #include <tuple>
+#include <unordered_map>
 
 #include <pybind11/complex.h>
 #include <pybind11/stl.h>
@@ -217,6 +225,167 @@ struct DimInfo {
   }
 };
 
+//! Stream argument of __dlpack__ for the current stream of a device. The
+//! legacy default stream is 1, since 0 is ambiguous in the DLPack protocol.
+int64_t dlpackStream(int64_t device_index) {
+  cudaStream_t stream =
+      at::cuda::getCurrentCUDAStream((c10::DeviceIndex)device_index).stream();
+  return stream == nullptr ? 1 : (int64_t)stream;
+}
+
+//! Makes the current stream wait for the work on the stream of a
+//! __cuda_array_interface__, which is 1 for the legacy default stream and 2
+//! for the per-thread default stream
+void waitForProducerStream(int64_t producer_stream) {
+  cudaStream_t producer = producer_stream == 1
+      ? cudaStreamLegacy
+      : (producer_stream == 2 ? cudaStreamPerThread
+                              : (cudaStream_t)producer_stream);
+  cudaStream_t consumer = at::cuda::getCurrentCUDAStream().stream();
+  if (producer == consumer) {
+    return;
+  }
+  cudaEvent_t event = nullptr;
+  C10_CUDA_CHECK(cudaEventCreateWithFlags(&event, cudaEventDisableTiming));
+  C10_CUDA_CHECK(cudaEventRecord(event, producer));
+  C10_CUDA_CHECK(cudaStreamWaitEvent(consumer, event, 0));
+  C10_CUDA_CHECK(cudaEventDestroy(event));
+}
+
+at::ScalarType toScalarType(const std::string& typestr) {
+  // The first character is the byte order
+  static const std::unordered_map<std::string, at::ScalarType> types = {
+      {"b1", at::kBool},
+      {"u1", at::kByte},
+      {"i1", at::kChar},
+      {"i2", at::kShort},
+      {"i4", at::kInt},
+      {"i8", at::kLong},
+      {"f2", at::kHalf},
+      {"f4", at::kFloat},
+      {"f8", at::kDouble},
+      {"c8", at::kComplexFloat},
+      {"c16", at::kComplexDouble}};
+  auto it = types.find(typestr.substr(1));
+  NVF_CHECK(
+      it != types.end(),
+      "Unsupported typestr in __cuda_array_interface__: ",
+      typestr);
+  return it->second;
+}
+
+//! Wraps the device memory of an object with __cuda_array_interface__.
+//! The tensor keeps a reference to the object.
+at::Tensor fromCudaArrayInterface(py::handle obj) {
+  auto interface = obj.attr("__cuda_array_interface__").cast<py::dict>();
+  auto shape = interface["shape"].cast<std::vector<int64_t>>();
+  const auto dtype = toScalarType(interface["typestr"].cast<std::string>());
+  auto* data = (void*)interface["data"].cast<py::tuple>()[0].cast<intptr_t>();
+  const int64_t item_size = (int64_t)c10::elementSize(dtype);
+
+  std::vector<int64_t> strides(shape.size(), 1);
+  if (interface.contains("strides") && !interface["strides"].is_none()) {
+    auto byte_strides = interface["strides"].cast<std::vector<int64_t>>();
+    for (auto i : c10::irange(shape.size())) {
+      NVF_CHECK(
+          byte_strides.at(i) % item_size == 0,
+          "Strides of __cuda_array_interface__ must be multiples of the item size");
+      strides.at(i) = byte_strides.at(i) / item_size;
+    }
+  } else {
+    for (int64_t i = (int64_t)shape.size() - 2; i >= 0; --i) {
+      strides.at(i) = strides.at(i + 1) * shape.at(i + 1);
+    }
+  }
+
+  int device_index = at::cuda::current_device();
+  if (data != nullptr) {
+    cudaPointerAttributes attributes;
+    C10_CUDA_CHECK(cudaPointerGetAttributes(&attributes, data));
+    device_index = attributes.device;
+  }
+  c10::cuda::CUDAGuard device_guard((c10::DeviceIndex)device_index);
+  if (interface.contains("stream") && !interface["stream"].is_none()) {
+    waitForProducerStream(interface["stream"].cast<int64_t>());
+  }
+
+  // The object may be released without the GIL held by the caller
+  auto owner = new py::object(py::reinterpret_borrow<py::object>(obj));
+  return at::from_blob(
+      data,
+      shape,
+      strides,
+      [owner](void*) {
+        py::gil_scoped_acquire gil;
+        delete owner;
+      },
+      at::TensorOptions()
+          .dtype(dtype)
+          .device(at::kCUDA, (c10::DeviceIndex)device_index));
+}
+
+//! Wraps the memory of a DLPack capsule, an object with __dlpack__, such as
+//! a CuPy or JAX array, or an object with __cuda_array_interface__ in an
+//! at::Tensor without copying it. Returns nullopt for other objects.
+std::optional<at::Tensor> toTensorWithoutCopy(py::handle obj) {
+  if (THPVariable_Check(obj.ptr())) {
+    return std::nullopt;
+  }
+  py::object capsule;
+  if (PyCapsule_IsValid(obj.ptr(), "dltensor")) {
+    capsule = py::reinterpret_borrow<py::object>(obj);
+  } else if (py::hasattr(obj, "__dlpack__")) {
+    // kDLCUDA is 2. The producer orders its work before the current stream.
+    auto device = obj.attr("__dlpack_device__")().cast<py::tuple>();
+    capsule = device[0].cast<int64_t>() == 2
+        ? obj.attr("__dlpack__")(
+              py::arg("stream") = dlpackStream(device[1].cast<int64_t>()))
+        : obj.attr("__dlpack__")();
+  } else if (py::hasattr(obj, "__cuda_array_interface__")) {
+    return fromCudaArrayInterface(obj);
+  } else {
+    return std::nullopt;
+  }
+  auto* dl_tensor =
+      (DLManagedTensor*)PyCapsule_GetPointer(capsule.ptr(), "dltensor");
+  NVF_CHECK(dl_tensor != nullptr, "Invalid DLPack capsule");
+  // The tensor owns the DLManagedTensor from now on
+  PyCapsule_SetName(capsule.ptr(), "used_dltensor");
+  return at::fromDLPack(dl_tensor);
+}
+
+c10::IValue toExecutionInput(py::handle obj) {
+  if (auto tensor = toTensorWithoutCopy(obj)) {
+    return tensor.value();
+  }
+  return torch::jit::toIValue(obj, c10::AnyType::get());
+}
+
+//! Converts the inputs of an execution. Allows for a Vector of Sizes to be
+//! inputed as a list. Arrays of other libraries are passed without copies.
+//! See toTensorWithoutCopy.
+std::vector<c10::IValue> toExecutionInputs(const py::iterable& iter) {
+  std::vector<c10::IValue> inputs;
+  for (py::handle obj : iter) {
+    if (py::isinstance<py::list>(obj)) {
+      for (py::handle item : obj) {
+        inputs.push_back(toExecutionInput(item));
+      }
+    } else {
+      inputs.push_back(toExecutionInput(obj));
+    }
+  }
+  return inputs;
+}
+
+std::optional<int8_t> toExecutionDevice(std::optional<int64_t> device) {
+  if (!device.has_value()) {
+    return std::nullopt;
+  }
+  NVF_CHECK(device.value() < 256, "Maximum device index is 255");
+  return (int8_t)device.value();
+}
+
 } // namespace
 
 std::vector<std::optional<bool>> computeContiguity(
@@ -400,8 +569,11 @@ void initNvFuserPythonBindings(PyObject* module) {
       .value("Half", DataType::Half)
       .value("Int", DataType::Int)
       .value("Int32", DataType::Int32)
+      .value("Int8", DataType::Int8)
       .value("Bool", DataType::Bool)
       .value("BFloat16", DataType::BFloat16)
+      .value("Float8_e4m3fn", DataType::Float8_e4m3fn)
+      .value("Float8_e5m2", DataType::Float8_e5m2)
       .value("ComplexFloat", DataType::ComplexFloat)
       .value("ComplexDouble", DataType::ComplexDouble)
       .value("Null", DataType::Null);
@@ -410,6 +582,54 @@ void initNvFuserPythonBindings(PyObject* module) {
   nvfuser.def("compute_tensor_descriptor", computeTensorDescriptor);
   nvfuser.def("serialize", serialize);
 
+  //! Autotuning of heuristics, see [ Autotuning of Reduction Heuristics ]
+  //! and [ Autotuning of Matmul Heuristics ]. enable_autotune has the same
+  //! effect as NVFUSER_ENABLE=autotune(<path>) for fusions scheduled
+  //! afterwards, where the default path is in the temporary directory.
+  nvfuser.def(
+      "enable_autotune",
+      [](const std::string& path) {
+        EnableOptionsGuard::getCurOptions().set(
+            EnableOption::Autotune, {path});
+      },
+      py::arg("path") = "");
+  nvfuser.def("disable_autotune", []() {
+    EnableOptionsGuard::getCurOptions().unset(EnableOption::Autotune);
+  });
+  //! Writes the entries of the tuning database to the given path and returns
+  //! the number of entries
+  nvfuser.def(
+      "export_tuning_db",
+      [](const std::string& path) {
+        auto db = TuningDb::get();
+        NVF_CHECK(db != nullptr, "Autotuning is not enabled");
+        return db->exportTo(path);
+      },
+      py::arg("path"));
+
+  //! Aggregation of the traced scopes, see [ Compile Profile ].
+  //! enable_compile_profile clears the scopes aggregated so far.
+  nvfuser.def("enable_compile_profile", []() {
+    inst::Trace::instance()->resetProfile();
+    inst::Trace::instance()->setRecordProfile(true);
+  });
+  nvfuser.def("disable_compile_profile", []() {
+    inst::Trace::instance()->setRecordProfile(false);
+  });
+  nvfuser.def("reset_compile_profile", []() {
+    inst::Trace::instance()->resetProfile();
+  });
+  //! Returns the aggregated scopes as (name, count, total_ms, self_ms), by
+  //! decreasing total time
+  nvfuser.def("compile_profile", []() {
+    std::vector<std::tuple<std::string, int64_t, double, double>> entries;
+    for (const auto& entry : inst::Trace::instance()->profile()) {
+      entries.emplace_back(
+          entry.name, entry.count, entry.total_ms, entry.self_ms);
+    }
+    return entries;
+  });
+
   //! Binding the FusionCache that holds a cache of Fusions
   //! This is only bound to provide an interface to get the number of fusions
   //! that are cached.
@@ -445,12 +665,44 @@ void initNvFuserPythonBindings(PyObject* module) {
             self.print(ss);
             return ss.str();
           })
+      .def(
+          "set_eviction_limits",
+          &FusionCache::setEvictionLimits,
+          py::arg("max_live_fusions") = 0,
+          py::arg("max_module_bytes") = 0)
       .def("stats", [](FusionCache& self) {
         std::stringstream ss;
         self.stats(ss);
         return ss.str();
       });
 
+  //! Replaces the thread pool compiling kernels. Options that are not given
+  //! are read from the environment. See [ Compile Thread Pool ].
+  nvfuser.def(
+      "configure_compile_thread_pool",
+      [](std::optional<int64_t> num_threads,
+         std::optional<std::vector<int64_t>> cpus,
+         std::optional<int64_t> nice) {
+        auto options = CompileThreadPool::Options::fromEnvironment();
+        if (num_threads.has_value()) {
+          options.num_threads = num_threads.value() == 0
+              ? std::max<int64_t>(std::thread::hardware_concurrency(), 1)
+              : num_threads.value();
+        }
+        if (cpus.has_value()) {
+          options.cpus = cpus.value();
+        }
+        if (nice.has_value()) {
+          options.nice = nice.value();
+        }
+        py::gil_scoped_release release;
+        configureThreadPool(std::move(options));
+      },
+      py::kw_only(),
+      py::arg("num_threads") = py::none(),
+      py::arg("cpus") = py::none(),
+      py::arg("nice") = py::none());
+
   //! These are the FusionDefinition supported object types that are either
   //! defined as inputs or the output of an operation.
   py::class_<Tensor> tensor_class(nvfuser, "Tensor");
@@ -481,6 +733,77 @@ void initNvFuserPythonBindings(PyObject* module) {
   vector_class.def_property_readonly(
       "size", [](Vector& self) { return self.size; });
 
+  //! A FusionHandle executes a defined fusion without its definition. See
+  //! [ Fusion Handles ].
+  py::class_<FusionHandle> fusion_handle(nvfuser, "FusionHandle");
+  fusion_handle.def("id", &FusionHandle::id)
+      .def(
+          "__call__",
+          [](const FusionHandle& self,
+             const py::iterable& iter,
+             std::optional<int64_t> device) {
+            std::vector<c10::IValue> inputs = toExecutionInputs(iter);
+            std::optional<int8_t> int8_device = toExecutionDevice(device);
+            py::gil_scoped_release release;
+            return self.execute(inputs, int8_device);
+          },
+          py::arg("inputs"),
+          py::kw_only(),
+          py::arg("device") = py::none());
+
+  //! Executes a list of (FusionDefinition or FusionHandle, inputs) pairs
+  //! back to back without returning to Python in between, and returns the
+  //! outputs of each. The definitions must be complete.
+  nvfuser.def(
+      "execute_many",
+      [](const py::iterable& executions) {
+        std::vector<FusionHandle> handles;
+        std::vector<std::vector<c10::IValue>> inputs;
+        for (py::handle execution : executions) {
+          auto pair = execution.cast<py::tuple>();
+          NVF_CHECK(
+              pair.size() == 2,
+              "Expected (FusionDefinition, inputs) pairs to execute!");
+          if (py::isinstance<FusionHandle>(pair[0])) {
+            handles.push_back(pair[0].cast<FusionHandle>());
+          } else {
+            handles.push_back(pair[0].cast<FusionDefinition&>().handle());
+          }
+          inputs.push_back(toExecutionInputs(pair[1].cast<py::iterable>()));
+        }
+        std::vector<std::vector<at::Tensor>> outputs;
+        outputs.reserve(handles.size());
+        // See [ Concurrent Execution ]
+        py::gil_scoped_release release;
+        for (auto i : c10::irange(handles.size())) {
+          outputs.push_back(handles[i].execute(inputs[i], std::nullopt));
+        }
+        return outputs;
+      },
+      py::arg("executions"));
+
+  //! Executes a sequence of calls of defined fusions stitched into one. See
+  //! [ Lazy Execution ].
+  nvfuser.def(
+      "_execute_stitched",
+      [](const std::vector<size_t>& fusion_ids,
+         const std::vector<std::vector<StitchedValue>>& args,
+         const std::vector<StitchedValue>& outputs,
+         const py::iterable& iter,
+         std::optional<int64_t> device) {
+        std::vector<c10::IValue> inputs = toExecutionInputs(iter);
+        std::optional<int8_t> int8_device = toExecutionDevice(device);
+        // See [ Concurrent Execution ]
+        py::gil_scoped_release release;
+        return executeStitched(fusion_ids, args, outputs, inputs, int8_device);
+      },
+      py::arg("fusion_ids"),
+      py::arg("args"),
+      py::arg("outputs"),
+      py::arg("inputs"),
+      py::kw_only(),
+      py::arg("device") = py::none());
+
   //! The FusionDefinition is a context manager in Python where the user will
   //! define the set the operations and connections between operations for
   //! nvFuser to create.
@@ -542,24 +865,11 @@ void initNvFuserPythonBindings(PyObject* module) {
              bool override_user_schedule,
              std::optional<int64_t> device,
              bool capture_debug_output) {
-            std::vector<c10::IValue> inputs;
-            for (py::handle obj : iter) {
-              // Allows for a Vector of Sizes to be inputed as a list
-              if (py::isinstance<py::list>(obj)) {
-                for (py::handle item : obj) {
-                  inputs.push_back(
-                      torch::jit::toIValue(item, c10::AnyType::get()));
-                }
-              } else {
-                inputs.push_back(
-                    torch::jit::toIValue(obj, c10::AnyType::get()));
-              }
-            }
-            std::optional<int8_t> int8_device = std::nullopt;
-            if (device.has_value()) {
-              NVF_CHECK(device.value() < 256, "Maximum device index is 255");
-              int8_device = (int8_t)device.value();
-            }
+            std::vector<c10::IValue> inputs = toExecutionInputs(iter);
+            std::optional<int8_t> int8_device = toExecutionDevice(device);
+            // Other threads may define and execute fusions while this one
+            // runs. See [ Concurrent Execution ].
+            py::gil_scoped_release release;
             return self.execute(
                 inputs,
                 override_user_schedule,
@@ -572,6 +882,7 @@ void initNvFuserPythonBindings(PyObject* module) {
           py::arg("device") = py::none(),
           py::arg("capture_debug_output") = false,
           py::return_value_policy::reference)
+      .def("_get_handle", &FusionDefinition::handle)
       .def(
           "_debug_output",
           [](FusionDefinition& self) { return self.getDebugOutput(); },
@@ -580,6 +891,16 @@ void initNvFuserPythonBindings(PyObject* module) {
           "_fusion_ir",
           [](FusionDefinition& self) { return self.fusionIr(); },
           py::return_value_policy::reference)
+      .def("_num_outputs", &FusionDefinition::numOutputs)
+      .def(
+          "set_compile_priority",
+          [](FusionDefinition& self, int64_t priority) {
+            NVF_CHECK(self.id().has_value(), "Invalid fusion definition!");
+            FusionCache::get()
+                ->queryFusionSchedules(self.id().value())
+                ->auto_gen_schedules->setCompilePriority(priority);
+          },
+          py::arg("priority"))
       .def(
           "_last_cuda_code",
           [](FusionDefinition& self,
@@ -590,6 +911,35 @@ void initNvFuserPythonBindings(PyObject* module) {
           py::arg("intrinsic_code") = false,
           py::arg("override_user_schedule") = false,
           py::return_value_policy::reference)
+      .def(
+          "_last_kernel_resources",
+          [](FusionDefinition& self, bool override_user_schedule) {
+            py::list result;
+            for (const auto& resources :
+                 self.lastKernelResources(override_user_schedule)) {
+              const LaunchParams& lparams = resources.launch_params;
+              py::dict entry;
+              entry["registers"] = resources.registers;
+              entry["local_bytes"] = resources.local_bytes;
+              entry["spill_store_bytes"] = resources.spill_store_bytes;
+              entry["spill_load_bytes"] = resources.spill_load_bytes;
+              entry["static_smem_bytes"] = resources.static_smem_bytes;
+              entry["dynamic_smem_bytes"] = resources.dynamic_smem_bytes;
+              entry["grid"] = py::make_tuple(
+                  lparams.gdimx(), lparams.gdimy(), lparams.gdimz());
+              entry["block"] = py::make_tuple(
+                  lparams.bdimx(), lparams.bdimy(), lparams.bdimz());
+              entry["blocks_per_sm"] = resources.blocks_per_sm;
+              entry["theoretical_occupancy_pct"] =
+                  resources.theoretical_occupancy_pct;
+              entry["achieved_occupancy_pct"] =
+                  resources.achieved_occupancy_pct;
+              entry["waves"] = resources.waves;
+              result.append(entry);
+            }
+            return result;
+          },
+          py::arg("override_user_schedule") = false)
       .def(
           "_cuda_code_for",
           [](FusionDefinition& self,
@@ -136,4 +136,25 @@ TEST_F(NVFuserTest, RecordFunctorEquality_CUDA) {
   }
 }
 
+// RUN CMD: bin/test_jit --gtest_filter="NVFuserTest*RecordFunctorPool*"
+TEST_F(NVFuserTest, RecordFunctorPool_CUDA) {
+  auto t0 = State(0, serde::StateType::Tensor);
+  auto out = State(1, serde::StateType::Tensor);
+  auto make_record = [&]() -> RecordFunctor* {
+    return new OpRecord<TensorView*, TensorView*>(
+        {t0},
+        {out},
+        "ops.abs",
+        serde::RecordType::Unary_TV,
+        static_cast<TensorView* (*)(TensorView*)>(abs));
+  };
+
+  // A freed record is reused by the next record of its size
+  RecordFunctor* record = make_record();
+  void* storage = record;
+  delete record;
+  std::unique_ptr<RecordFunctor> reused(make_record());
+  EXPECT_EQ((void*)reused.get(), storage);
+}
+
 } // namespace nvfuser
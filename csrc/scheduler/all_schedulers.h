@@ -6,6 +6,7 @@
  */
 // clang-format on
 #pragma once
+#include <scheduler/horizontal.h>
 #include <scheduler/matmul.h>
 #include <scheduler/no_op.h>
 #include <scheduler/normalization_inner.h>
@@ -13,4 +14,7 @@
 #include <scheduler/normalization_outer.h>
 #include <scheduler/pointwise.h>
 #include <scheduler/reduction.h>
+#include <scheduler/scan.h>
+#include <scheduler/sort.h>
+#include <scheduler/stencil.h>
 #include <scheduler/transpose.h>
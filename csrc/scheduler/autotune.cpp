@@ -0,0 +1,803 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <scheduler/autotune.h>
+
+#include <debug.h>
+#include <executor.h>
+#include <instrumentation.h>
+#include <ir/utils.h>
+#include <kernel_db/kernel_db.h>
+#include <options.h>
+#include <scheduler/device_model.h>
+#include <scheduler/matmul.h>
+#include <scheduler/matmul_utils.h>
+#include <scheduler/normalization_inner.h>
+#include <scheduler/reduction.h>
+#include <scheduler/registry.h>
+#include <scheduler/utils.h>
+
+#include <ATen/ATen.h>
+#include <ATen/cuda/CUDAContext.h>
+#include <c10/util/Exception.h>
+#include <c10/util/irange.h>
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <sstream>
+
+namespace nvfuser {
+
+namespace {
+
+constexpr int64_t kWarmupRuns = 1;
+constexpr int64_t kTimedRuns = 5;
+
+//! Lowered unroll factors are tried as long as they divide the given one
+constexpr int64_t kMaxFactorHalvings = 2;
+
+//! Iteration domain unroll factors tried for reductions where it can be
+//! changed freely
+constexpr std::array<int64_t, 3> kIterUnrollFactors = {1, 2, 4};
+
+//! Instruction tiles per warp tile in M and N
+constexpr std::array<int, 2> kMatmulWarpTileRatios = {2, 4};
+
+//! Warp tiles per CTA tile in M and N
+constexpr std::array<std::pair<int, int>, 5> kMatmulCtaTileRatios = {
+    {{1, 2}, {2, 1}, {2, 2}, {2, 4}, {4, 2}}};
+
+constexpr std::array<int, 3> kMatmulStages = {2, 3, 4};
+constexpr std::array<int, 2> kMatmulGridSwizzleFactors = {1, 4};
+constexpr std::array<int, 3> kMatmulSplitKFactors = {1, 2, 4};
+
+constexpr int64_t kWarpSize = 32;
+
+//! Grid reductions don't support unrolling the iteration domain, see
+//! getReductionHeuristics
+bool canChangeIterUnroll(const ReductionParams& rparams) {
+  return !rparams.cross_grid_inner_reduction &&
+      !rparams.cross_grid_outer_reduction;
+}
+
+//! The given factor followed by the lower factors that divide it
+std::vector<int64_t> loweredFactors(int64_t factor) {
+  std::vector<int64_t> factors = {factor};
+  for (int64_t i = 0; i < kMaxFactorHalvings && factor % 2 == 0; ++i) {
+    factor /= 2;
+    factors.push_back(factor);
+  }
+  return factors;
+}
+
+//! Random inputs of the sizes of the actual inputs, or nullopt if they can't
+//! be synthesized faithfully
+std::optional<KernelArgumentHolder> makeInputs(
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info) {
+  for (auto output : fusion->outputs()) {
+    if (fusion->getOutputAlias(output).first != nullptr) {
+      return std::nullopt;
+    }
+  }
+
+  auto& expr_eval = runtime_info.expressionEvaluator();
+  const auto options =
+      at::TensorOptions().device(at::kCUDA, at::cuda::current_device());
+  std::vector<c10::IValue> inputs;
+  for (auto input : fusion->inputs()) {
+    auto tv = dynamic_cast<TensorView*>(input);
+    if (tv == nullptr) {
+      auto value = expr_eval.evaluate(input);
+      if (value.is<int64_t>()) {
+        inputs.emplace_back(value.as<int64_t>());
+      } else if (value.is<double>()) {
+        inputs.emplace_back(value.as<double>());
+      } else if (value.is<bool>()) {
+        inputs.emplace_back(value.as<bool>());
+      } else {
+        return std::nullopt;
+      }
+      continue;
+    }
+
+    if (tv->hasAllocation()) {
+      return std::nullopt;
+    }
+    std::vector<int64_t> sizes;
+    for (auto id : TensorDomain::noReductions(tv->getMaybeRFactorDomain())) {
+      if (id->hasExpandedExtent()) {
+        return std::nullopt;
+      }
+      auto extent = expr_eval.evaluate(id->extent());
+      if (!extent.is<int64_t>()) {
+        return std::nullopt;
+      }
+      sizes.push_back(extent.as<int64_t>());
+    }
+
+    const auto dtype = tv->getDataType().value();
+    const auto aten_options = options.dtype(data_type_to_aten(dtype));
+    if (isFloatingPointType(dtype) || isComplexType(dtype)) {
+      inputs.emplace_back(at::randn(sizes, aten_options));
+    } else if (dtype == DataType::Bool) {
+      inputs.emplace_back(at::randn(sizes, options.dtype(at::kFloat)) > 0);
+    } else {
+      inputs.emplace_back(at::randint(-8, 8, sizes, aten_options));
+    }
+  }
+  return KernelArgumentHolder::createKernelArgumentHolder(inputs);
+}
+
+//! Schedules a copy of the fusion, runs it and returns the outputs and the
+//! fastest kernel time
+std::pair<std::vector<at::Tensor>, float> runVariant(
+    ScheduleHeuristic heuristic,
+    Fusion* fusion,
+    const HeuristicParams& params,
+    const std::function<void(Fusion*)>& schedule,
+    KernelArgumentHolder& args) {
+  auto fusion_copy = std::make_unique<Fusion>(*fusion);
+  FusionGuard fg(fusion_copy.get());
+  schedule(fusion_copy.get());
+
+  FusionExecutor fe;
+  fe.compileFusion(
+      fusion_copy.get(), args, params.lparams, params.cparams, heuristic);
+  fe.setMeasureKernelTimeFlag(true);
+
+  std::vector<at::Tensor> outputs;
+  float time_ms = std::numeric_limits<float>::max();
+  for (int64_t i = 0; i < kWarmupRuns + kTimedRuns; ++i) {
+    outputs = fe.runFusion(args, params.lparams, params.cparams);
+    if (i >= kWarmupRuns) {
+      time_ms = std::min(time_ms, fe.kernelTimeMs());
+    }
+  }
+  return {outputs, time_ms};
+}
+
+//! Variants use different reduction orders, so outputs are only expected to
+//! be close
+bool sameOutputs(
+    const std::vector<at::Tensor>& outputs,
+    const std::vector<at::Tensor>& reference) {
+  if (outputs.size() != reference.size()) {
+    return false;
+  }
+  for (auto i : c10::irange(outputs.size())) {
+    const auto& output = outputs.at(i);
+    const auto& ref = reference.at(i);
+    if (output.sizes() != ref.sizes() || output.dtype() != ref.dtype()) {
+      return false;
+    }
+    const bool reduced_precision = output.scalar_type() == at::kHalf ||
+        output.scalar_type() == at::kBFloat16;
+    const double tolerance = reduced_precision ? 1e-2 : 1e-3;
+    const auto to_double = [](const at::Tensor& t) {
+      return t.is_complex() ? t.to(at::kComplexDouble) : t.to(at::kDouble);
+    };
+    if (!at::allclose(
+            to_double(output), to_double(ref), tolerance, tolerance)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+//! Runs variants of a fusion on the same random inputs. The outputs of the
+//! first variant are the reference for those of the others.
+class VariantBenchmark {
+ public:
+  VariantBenchmark(
+      ScheduleHeuristic heuristic,
+      Fusion* fusion,
+      SchedulerRuntimeInfo& runtime_info)
+      : heuristic_(heuristic), fusion_(fusion) {
+    try {
+      args_ = makeInputs(fusion, runtime_info);
+    } catch (const std::exception& e) {
+      TORCH_WARN("Could not autotune ", heuristic, " fusion: ", e.what());
+    }
+  }
+
+  //! Whether inputs could be synthesized
+  bool valid() const {
+    return args_.has_value();
+  }
+
+  //! Returns the kernel time of the variant, or nullopt if it failed or its
+  //! outputs differ from the reference
+  std::optional<float> run(
+      const HeuristicParams& params,
+      const std::function<void(Fusion*)>& schedule) {
+    NVF_ERROR(valid());
+    const bool is_reference = !reference_.has_value();
+    try {
+      auto [outputs, time_ms] =
+          runVariant(heuristic_, fusion_, params, schedule, args_.value());
+      if (is_reference) {
+        reference_ = std::move(outputs);
+      } else if (!sameOutputs(outputs, reference_.value())) {
+        return std::nullopt;
+      }
+      return time_ms;
+    } catch (const std::exception& e) {
+      if (is_reference) {
+        // Nothing to compare the other variants to
+        TORCH_WARN("Could not autotune ", heuristic_, " fusion: ", e.what());
+      }
+      return std::nullopt;
+    }
+  }
+
+ private:
+  const ScheduleHeuristic heuristic_;
+  Fusion* fusion_ = nullptr;
+  std::optional<KernelArgumentHolder> args_;
+  std::optional<std::vector<at::Tensor>> reference_;
+};
+
+//! Benchmarks the candidates and returns the fastest correct one, or nullopt
+//! if the fusion can't be tuned
+std::optional<ReductionTuning> benchmarkCandidates(
+    ScheduleHeuristic heuristic,
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info,
+    const ReductionParams& rparams) {
+  FUSER_PERF_SCOPE("autotune::benchmarkCandidates");
+  VariantBenchmark benchmark(heuristic, fusion, runtime_info);
+  if (!benchmark.valid()) {
+    return std::nullopt;
+  }
+
+  std::optional<ReductionTuning> best;
+  for (const auto& candidate : autotune::tuningCandidates(heuristic, rparams)) {
+    ReductionParams variant = rparams;
+    if (!autotune::applyTuning(heuristic, candidate, variant)) {
+      continue;
+    }
+    auto time_ms = benchmark.run(variant, [&](Fusion* fusion_copy) {
+      if (heuristic == ScheduleHeuristic::Reduction) {
+        scheduleReduction(fusion_copy, variant);
+      } else {
+        scheduleInnerPersistentKernel(fusion_copy, variant);
+      }
+    });
+    if (!best.has_value()) {
+      // The first candidate, i.e., the heuristic's parameters, failed
+      if (!time_ms.has_value()) {
+        return std::nullopt;
+      }
+    } else if (!time_ms.has_value() || time_ms.value() >= best->time_ms) {
+      continue;
+    }
+    best = candidate;
+    best->time_ms = time_ms.value();
+  }
+  return best;
+}
+
+//! Same as benchmarkCandidates for matmuls, in rounds as described in
+//! [ Autotuning of Matmul Heuristics ]
+std::optional<MatmulTuning> benchmarkMatmulCandidates(
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info,
+    const MatmulParams& params) {
+  FUSER_PERF_SCOPE("autotune::benchmarkMatmulCandidates");
+  VariantBenchmark benchmark(ScheduleHeuristic::Matmul, fusion, runtime_info);
+  if (!benchmark.valid()) {
+    return std::nullopt;
+  }
+
+  auto best = MatmulTuning::fromParams(params);
+  auto time_ms = benchmark.run(params, [&](Fusion* fusion_copy) {
+    scheduleMatmul(fusion_copy, params);
+  });
+  if (!time_ms.has_value()) {
+    return std::nullopt;
+  }
+  best.time_ms = time_ms.value();
+
+  for (int64_t round = 0; round < autotune::kMatmulTuningRounds; ++round) {
+    for (const auto& candidate :
+         autotune::matmulTuningCandidates(round, params, best)) {
+      MatmulParams variant = params;
+      if (!autotune::applyMatmulTuning(fusion, candidate, variant)) {
+        continue;
+      }
+      time_ms = benchmark.run(variant, [&](Fusion* fusion_copy) {
+        scheduleMatmul(fusion_copy, variant);
+      });
+      if (time_ms.has_value() && time_ms.value() < best.time_ms) {
+        best = candidate;
+        best.time_ms = time_ms.value();
+      }
+    }
+  }
+  return best;
+}
+
+//! Returns the tuning stored for the key, benchmarking and storing it first
+//! if there is none
+template <typename Tuning>
+std::optional<Tuning> queryOrBenchmark(
+    TuningDb* db,
+    const std::string& key,
+    ScheduleHeuristic heuristic,
+    const std::function<std::optional<Tuning>()>& benchmark) {
+  if (auto entry = db->query(key); entry.has_value()) {
+    if (auto tuning = Tuning::deserialize(entry.value()); tuning.has_value()) {
+      return tuning;
+    }
+  }
+
+  auto tuning = benchmark();
+  if (!tuning.has_value()) {
+    return std::nullopt;
+  }
+  db->write(key, tuning->serialize());
+  if (isDebugDumpEnabled(DebugDumpOption::SchedulerDebug)) {
+    debug() << "\n===== Autotuned " << heuristic << " ========\n"
+            << tuning->serialize() << std::endl;
+  }
+  return tuning;
+}
+
+} // namespace
+
+std::string ReductionTuning::serialize() const {
+  std::stringstream ss;
+  ss << unroll_factor_inner_reduction << " " << unroll_factor_iter_dom << " "
+     << batches_per_block_multiple << " " << time_ms;
+  return ss.str();
+}
+
+std::optional<ReductionTuning> ReductionTuning::deserialize(
+    const std::string& str) {
+  std::istringstream ss(str);
+  ReductionTuning tuning;
+  if (!(ss >> tuning.unroll_factor_inner_reduction >>
+        tuning.unroll_factor_iter_dom >> tuning.batches_per_block_multiple >>
+        tuning.time_ms)) {
+    return std::nullopt;
+  }
+  return tuning;
+}
+
+MatmulTuning MatmulTuning::fromParams(const MatmulParams& params) {
+  MatmulTuning tuning;
+  tuning.cta_tile = params.tile_sizes.cta_tile;
+  tuning.warp_tile = params.tile_sizes.warp_tile;
+  tuning.smem_double_buffer_stage =
+      params.double_buffer_options.smem_double_buffer_stage;
+  tuning.grid_swizzle_factor = params.grid_swizzle_factor;
+  tuning.splitk_factor = params.splitk_factor;
+  tuning.cta_order = params.cta_order;
+  return tuning;
+}
+
+std::string MatmulTuning::serialize() const {
+  std::stringstream ss;
+  ss << cta_tile.m << " " << cta_tile.n << " " << cta_tile.k << " "
+     << warp_tile.m << " " << warp_tile.n << " " << warp_tile.k << " "
+     << smem_double_buffer_stage << " " << grid_swizzle_factor << " "
+     << splitk_factor << " " << static_cast<int>(cta_order) << " " << time_ms;
+  return ss.str();
+}
+
+std::optional<MatmulTuning> MatmulTuning::deserialize(const std::string& str) {
+  std::istringstream ss(str);
+  MatmulTuning tuning;
+  int cta_order = 0;
+  if (!(ss >> tuning.cta_tile.m >> tuning.cta_tile.n >> tuning.cta_tile.k >>
+        tuning.warp_tile.m >> tuning.warp_tile.n >> tuning.warp_tile.k >>
+        tuning.smem_double_buffer_stage >> tuning.grid_swizzle_factor >>
+        tuning.splitk_factor >> cta_order >> tuning.time_ms)) {
+    return std::nullopt;
+  }
+  if (cta_order !=
+          static_cast<int>(MatmulParams::TileRasterizationOrder::RowMajor) &&
+      cta_order !=
+          static_cast<int>(MatmulParams::TileRasterizationOrder::ColumnMajor)) {
+    return std::nullopt;
+  }
+  tuning.cta_order =
+      static_cast<MatmulParams::TileRasterizationOrder>(cta_order);
+  return tuning;
+}
+
+TuningDb::TuningDb(std::string path) : path_(std::move(path)) {
+  std::ifstream file(path_);
+  std::string line;
+  while (std::getline(file, line)) {
+    const auto separator = line.find(' ');
+    if (separator == std::string::npos || separator == 0) {
+      continue;
+    }
+    entries_[line.substr(0, separator)] = line.substr(separator + 1);
+  }
+}
+
+TuningDb* TuningDb::get() {
+  if (!isOptionEnabled(EnableOption::Autotune)) {
+    return nullptr;
+  }
+
+  const auto& args = getEnableOptionArguments(EnableOption::Autotune);
+  const std::string path = !args.empty() && !args.at(0).empty()
+      ? args.at(0)
+      : (fs::temp_directory_path() / "nvfuser_tuning_db.txt").string();
+
+  // Databases are never destroyed, since other threads may still use them
+  // when the option changes
+  static std::mutex get_mutex;
+  static std::unordered_map<std::string, std::unique_ptr<TuningDb>> dbs;
+  std::lock_guard<std::mutex> guard(get_mutex);
+  auto& db = dbs[path];
+  if (db == nullptr) {
+    db = std::make_unique<TuningDb>(path);
+  }
+  return db.get();
+}
+
+std::optional<std::string> TuningDb::query(const std::string& key) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    return std::nullopt;
+  }
+  return it->second;
+}
+
+bool TuningDb::write(const std::string& key, const std::string& tuning) {
+  NVF_ERROR(
+      key.find_first_of(" \n") == std::string::npos &&
+          tuning.find('\n') == std::string::npos,
+      "Invalid tuning database entry: ",
+      key,
+      " ",
+      tuning);
+  std::lock_guard<std::mutex> guard(mutex_);
+  entries_[key] = tuning;
+
+  // A single write of the whole line, so that lines appended by concurrent
+  // processes don't interleave
+  const std::string line = key + " " + tuning + "\n";
+  std::ofstream file(path_, std::ios::app);
+  file << line << std::flush;
+  if (!file) {
+    TORCH_WARN("Could not write to nvFuser tuning database ", path_);
+    return false;
+  }
+  return true;
+}
+
+int64_t TuningDb::exportTo(const std::string& path) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  // Sorted, so that exports of the same entries are identical
+  const std::map<std::string, std::string> sorted_entries(
+      entries_.begin(), entries_.end());
+  std::ofstream file(path, std::ios::trunc);
+  for (const auto& [key, tuning] : sorted_entries) {
+    file << key << " " << tuning << "\n";
+  }
+  file << std::flush;
+  NVF_CHECK(file, "Could not export the nvFuser tuning database to ", path);
+  return (int64_t)sorted_entries.size();
+}
+
+int64_t TuningDb::numEntries() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return (int64_t)entries_.size();
+}
+
+namespace autotune {
+
+std::string makeKey(
+    ScheduleHeuristic heuristic,
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info) {
+  std::stringstream ss;
+  ss << heuristic << "\n";
+  if (heuristic == ScheduleHeuristic::Matmul) {
+    ss << getMatmulProblemKey(fusion, runtime_info) << "\n";
+  } else {
+    {
+      DebugStreamGuard dsg(ss);
+      fusion->printMath();
+    }
+
+    auto& expr_eval = runtime_info.expressionEvaluator();
+    for (auto tv : ir_utils::filterByType<TensorView>(fusion->inputs())) {
+      for (auto id :
+           TensorDomain::noReductions(tv->getMaybeRFactorDomain())) {
+        auto extent = expr_eval.evaluate(id->extent());
+        if (extent.is<int64_t>()) {
+          ss << scheduler_utils::roundUpPow2(extent.as<int64_t>()) << " ";
+        } else {
+          ss << "? ";
+        }
+      }
+      ss << "\n";
+    }
+  }
+
+  const auto& device_model = getDeviceModel();
+  ss << DataType(runtime_info.getIndexType()) << " " << device_model.name
+     << " sm_" << device_model.major << device_model.minor;
+
+  std::stringstream key;
+  key << std::hex << std::setfill('0') << std::setw(16)
+      << std::hash<std::string>{}(ss.str());
+  return key.str();
+}
+
+std::vector<ReductionTuning> tuningCandidates(
+    ScheduleHeuristic heuristic,
+    const ReductionParams& rparams) {
+  std::vector<int64_t> inner_factors =
+      loweredFactors(rparams.unroll_factor_inner_reduction);
+  if (heuristic == ScheduleHeuristic::InnerPersistent &&
+      inner_factors.size() > 1 && inner_factors.back() == 1) {
+    // See applyTuning
+    inner_factors.pop_back();
+  }
+
+  std::vector<int64_t> iter_factors = {rparams.unroll_factor_iter_dom};
+  std::vector<int64_t> batch_multiples = {1};
+  if (heuristic == ScheduleHeuristic::InnerPersistent) {
+    batch_multiples.push_back(2);
+  } else if (rparams.vectorize_iter_dom) {
+    iter_factors = loweredFactors(rparams.unroll_factor_iter_dom);
+  } else if (canChangeIterUnroll(rparams)) {
+    for (auto factor : kIterUnrollFactors) {
+      if (factor != rparams.unroll_factor_iter_dom) {
+        iter_factors.push_back(factor);
+      }
+    }
+  }
+
+  std::vector<ReductionTuning> candidates;
+  for (auto inner_factor : inner_factors) {
+    for (auto iter_factor : iter_factors) {
+      for (auto batch_multiple : batch_multiples) {
+        ReductionTuning tuning;
+        tuning.unroll_factor_inner_reduction = inner_factor;
+        tuning.unroll_factor_iter_dom = iter_factor;
+        tuning.batches_per_block_multiple = batch_multiple;
+        candidates.push_back(tuning);
+      }
+    }
+  }
+  return candidates;
+}
+
+bool applyTuning(
+    ScheduleHeuristic heuristic,
+    const ReductionTuning& tuning,
+    ReductionParams& rparams) {
+  NVF_ERROR(
+      heuristic == ScheduleHeuristic::Reduction ||
+          heuristic == ScheduleHeuristic::InnerPersistent,
+      "Autotuning is not supported for ",
+      heuristic);
+
+  const int64_t inner_factor = std::min(
+      tuning.unroll_factor_inner_reduction,
+      rparams.unroll_factor_inner_reduction);
+  if (inner_factor < 1 ||
+      rparams.unroll_factor_inner_reduction % inner_factor != 0) {
+    return false;
+  }
+
+  int64_t iter_factor = rparams.unroll_factor_iter_dom;
+  int64_t batches = rparams.batches_per_block_inner_reduction;
+  if (heuristic == ScheduleHeuristic::InnerPersistent) {
+    // Persistent schedules always mark the reduction unrolled, otherwise
+    // rfactor can fail
+    if (tuning.batches_per_block_multiple < 1 ||
+        (inner_factor == 1 && rparams.unroll_factor_inner_reduction > 1)) {
+      return false;
+    }
+    batches *= rparams.unroll_factor_inner_reduction / inner_factor *
+        tuning.batches_per_block_multiple;
+  } else if (rparams.vectorize_iter_dom) {
+    iter_factor = std::min(tuning.unroll_factor_iter_dom, iter_factor);
+    if (iter_factor < 1 || rparams.unroll_factor_iter_dom % iter_factor != 0) {
+      return false;
+    }
+  } else if (canChangeIterUnroll(rparams)) {
+    if (tuning.unroll_factor_iter_dom < 1) {
+      return false;
+    }
+    iter_factor = tuning.unroll_factor_iter_dom;
+  }
+
+  rparams.unroll_factor_inner_reduction = inner_factor;
+  rparams.vectorize_inner_reduction =
+      rparams.vectorize_inner_reduction && inner_factor > 1;
+  rparams.unroll_factor_iter_dom = iter_factor;
+  rparams.vectorize_iter_dom = rparams.vectorize_iter_dom && iter_factor > 1;
+  rparams.batches_per_block_inner_reduction = batches;
+  return true;
+}
+
+std::shared_ptr<HeuristicParams> tuneReductionParams(
+    ScheduleHeuristic heuristic,
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info,
+    const std::shared_ptr<HeuristicParams>& params) {
+  auto db = TuningDb::get();
+  if (db == nullptr) {
+    return params;
+  }
+  FUSER_PERF_SCOPE("autotune::tuneReductionParams");
+
+  auto rparams = std::dynamic_pointer_cast<ReductionParams>(params);
+  NVF_ERROR(rparams != nullptr, "Expected reduction parameters");
+
+  const auto tuning = queryOrBenchmark<ReductionTuning>(
+      db, makeKey(heuristic, fusion, runtime_info), heuristic, [&]() {
+        return benchmarkCandidates(heuristic, fusion, runtime_info, *rparams);
+      });
+  if (!tuning.has_value()) {
+    return params;
+  }
+
+  auto tuned_params = std::make_shared<ReductionParams>(*rparams);
+  if (!applyTuning(heuristic, tuning.value(), *tuned_params)) {
+    return params;
+  }
+  tuned_params->tag += "Autotuned.\n";
+  return tuned_params;
+}
+
+std::vector<MatmulTuning> matmulTuningCandidates(
+    int64_t round,
+    const MatmulParams& params,
+    const MatmulTuning& best) {
+  std::vector<MatmulTuning> candidates;
+  auto add_candidate = [&](const MatmulTuning& tuning) {
+    if (!(tuning == best)) {
+      candidates.push_back(tuning);
+    }
+  };
+
+  switch (round) {
+    case 0: {
+      const auto& instruction_tile = params.tile_sizes.instruction_tile;
+      for (auto warp_m : kMatmulWarpTileRatios) {
+        for (auto warp_n : kMatmulWarpTileRatios) {
+          for (const auto& [cta_m, cta_n] : kMatmulCtaTileRatios) {
+            MatmulTuning tuning = best;
+            tuning.warp_tile = GemmTile(
+                instruction_tile.m * warp_m,
+                instruction_tile.n * warp_n,
+                best.warp_tile.k);
+            tuning.cta_tile = GemmTile(
+                tuning.warp_tile.m * cta_m,
+                tuning.warp_tile.n * cta_n,
+                best.cta_tile.k);
+            // Every thread of a warp holds its part of the warp tile
+            if ((int64_t)tuning.warp_tile.m * tuning.warp_tile.n / kWarpSize >
+                kMaxMatmulAccumulatorRegisters) {
+              continue;
+            }
+            add_candidate(tuning);
+          }
+        }
+      }
+      break;
+    }
+    case 1:
+      if (params.double_buffer_options.double_buffer_smem_write) {
+        for (auto stages : kMatmulStages) {
+          MatmulTuning tuning = best;
+          tuning.smem_double_buffer_stage = stages;
+          add_candidate(tuning);
+        }
+      }
+      break;
+    case 2:
+      for (auto swizzle : kMatmulGridSwizzleFactors) {
+        for (auto splitk : kMatmulSplitKFactors) {
+          for (auto order :
+               {MatmulParams::TileRasterizationOrder::RowMajor,
+                MatmulParams::TileRasterizationOrder::ColumnMajor}) {
+            MatmulTuning tuning = best;
+            tuning.grid_swizzle_factor = swizzle;
+            tuning.splitk_factor = splitk;
+            tuning.cta_order = order;
+            add_candidate(tuning);
+          }
+        }
+      }
+      break;
+    default:
+      NVF_ERROR(false, "Invalid matmul tuning round: ", round);
+  }
+  return candidates;
+}
+
+bool applyMatmulTuning(
+    Fusion* fusion,
+    const MatmulTuning& tuning,
+    MatmulParams& params) {
+  const auto& instruction_tile = params.tile_sizes.instruction_tile;
+  const auto& warp_tile = tuning.warp_tile;
+  const auto& cta_tile = tuning.cta_tile;
+  if (warp_tile.m <= 0 || warp_tile.n <= 0 || warp_tile.k <= 0 ||
+      warp_tile.m % instruction_tile.m != 0 ||
+      warp_tile.n % instruction_tile.n != 0 ||
+      warp_tile.k % instruction_tile.k != 0 || cta_tile.m <= 0 ||
+      cta_tile.n <= 0 || cta_tile.m % warp_tile.m != 0 ||
+      cta_tile.n % warp_tile.n != 0 || cta_tile.k != warp_tile.k) {
+    return false;
+  }
+  if (tuning.smem_double_buffer_stage < 1 || tuning.grid_swizzle_factor < 1 ||
+      tuning.splitk_factor < 1) {
+    return false;
+  }
+
+  MatmulParams tuned_params = params;
+  tuned_params.tile_sizes =
+      MatMulTileOptions(cta_tile, warp_tile, instruction_tile);
+  if (tuned_params.double_buffer_options.double_buffer_smem_write) {
+    tuned_params.double_buffer_options.smem_double_buffer_stage =
+        tuning.smem_double_buffer_stage;
+  }
+  tuned_params.grid_swizzle_factor = tuning.grid_swizzle_factor;
+  tuned_params.splitk_factor = tuning.splitk_factor;
+  tuned_params.cta_order = tuning.cta_order;
+  if (!updateMatmulSharedMemoryParams(fusion, tuned_params)) {
+    return false;
+  }
+  params = tuned_params;
+  return true;
+}
+
+std::shared_ptr<HeuristicParams> tuneMatmulParams(
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info,
+    const std::shared_ptr<HeuristicParams>& params) {
+  auto db = TuningDb::get();
+  if (db == nullptr) {
+    return params;
+  }
+  FUSER_PERF_SCOPE("autotune::tuneMatmulParams");
+
+  auto mparams = std::dynamic_pointer_cast<MatmulParams>(params);
+  NVF_ERROR(mparams != nullptr, "Expected matmul parameters");
+
+  const auto tuning = queryOrBenchmark<MatmulTuning>(
+      db,
+      makeKey(ScheduleHeuristic::Matmul, fusion, runtime_info),
+      ScheduleHeuristic::Matmul,
+      [&]() {
+        return benchmarkMatmulCandidates(fusion, runtime_info, *mparams);
+      });
+  if (!tuning.has_value()) {
+    return params;
+  }
+
+  auto tuned_params = std::make_shared<MatmulParams>(*mparams);
+  if (!applyMatmulTuning(fusion, tuning.value(), *tuned_params)) {
+    return params;
+  }
+  tuned_params->tag += "Autotuned.\n";
+  return tuned_params;
+}
+
+} // namespace autotune
+
+} // namespace nvfuser
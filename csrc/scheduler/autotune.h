@@ -0,0 +1,237 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <fusion.h>
+#include <mma_type.h>
+#include <scheduler/heuristic_types.h>
+#include <scheduler/matmul_heuristic.h>
+#include <scheduler/reduction_heuristic.h>
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace nvfuser {
+
+class SchedulerRuntimeInfo;
+
+//! [ Autotuning of Reduction Heuristics ]
+//!
+//! The reduction and inner persistent heuristics derive their parameters
+//! from a formula of the problem size, the data types and the device. The
+//! formula is a good default, but it is not the fastest choice for every
+//! fusion. With NVFUSER_ENABLE=autotune(<file>), SchedulerEntry::makeEntry
+//! benchmarks a few variants of the parameters the formula picked and uses
+//! the fastest one. The result is persisted in a tuning database, so the
+//! benchmarking happens once per fusion, input-shape bucket and device,
+//! i.e., also across processes.
+//!
+//! The variants only change knobs that are valid for any problem the
+//! formula's parameters are valid for:
+//!  - The inner reduction unroll factor is only ever lowered, so a
+//!    vectorization that was legal for the alignment of the inputs stays
+//!    legal. For persistent kernels, the persistent batch is raised by the
+//!    same factor, so that the block size and the size of the persistent
+//!    buffer per thread are unchanged.
+//!  - The persistent batch of inner persistent kernels may be doubled,
+//!    which halves the block size.
+//!  - The unroll factor of the iteration domain of reductions is changed
+//!    unless they are cross-grid reductions, which don't support it. A
+//!    vectorized iteration domain is only ever unrolled less.
+//!
+//! Each variant is scheduled on a copy of the fusion, compiled and run on
+//! random inputs of the actual input sizes. Variants that fail, or whose
+//! outputs differ from those of the formula's parameters, are discarded.
+//! Since a tuning never makes the parameters invalid, inputs in the same
+//! bucket as the benchmarked ones as well as hash collisions of the key can
+//! at worst result in a slower kernel.
+//!
+//! Fusions with aliased outputs, with inputs that have an allocation domain
+//! or expanded broadcasts, or with scalar inputs that can't be evaluated are
+//! not tuned, since their inputs can't be synthesized faithfully.
+
+//! [ Autotuning of Matmul Heuristics ]
+//!
+//! getMatmulHeuristics picks one static configuration for every problem.
+//! With autotuning enabled, the tile sizes, the number of stages, the grid
+//! swizzle, the split-K factor and the rasterization order are tuned as
+//! well. Any combination of them is valid for any problem size, so tunings
+//! are keyed by the exact M, N and K, the layout, the data types and the
+//! device, not by the IR of the fusion.
+//!
+//! Trying every combination would compile hundreds of kernels, so the
+//! candidates are benchmarked in rounds, each starting from the fastest
+//! configuration of the previous round:
+//!  - Warp tiles of 2 or 4 instruction tiles in M and N, with 2 to 8 warps
+//!    per CTA, skipping those that need more accumulator registers per
+//!    thread than kMaxMatmulAccumulatorRegisters. The K sizes of the tiles
+//!    are kept.
+//!  - 2 to 4 stages, if the heuristic double buffers the operands.
+//!  - Grid swizzle factors, split-K factors and rasterization orders.
+//! Candidates whose operands don't fit in shared memory are skipped. The
+//! shared memory epilogue is re-derived for each candidate.
+
+//! Knobs of ReductionParams chosen by autotuning
+struct ReductionTuning {
+  //! Unroll or vectorization factor of the inner reduction. Clamped to the
+  //! factor chosen by the heuristic.
+  int64_t unroll_factor_inner_reduction = 1;
+  //! Unroll factor of the iteration domain. Ignored where it can't be
+  //! changed.
+  int64_t unroll_factor_iter_dom = 1;
+  //! Multiplier on the persistent batch of inner persistent kernels
+  int64_t batches_per_block_multiple = 1;
+  //! Kernel time of the tuned variant when it was benchmarked
+  float time_ms = 0;
+
+  bool operator==(const ReductionTuning& other) const {
+    return unroll_factor_inner_reduction ==
+        other.unroll_factor_inner_reduction &&
+        unroll_factor_iter_dom == other.unroll_factor_iter_dom &&
+        batches_per_block_multiple == other.batches_per_block_multiple;
+  }
+
+  //! Space-separated fields, as stored in the TuningDb
+  std::string serialize() const;
+  static std::optional<ReductionTuning> deserialize(const std::string& str);
+};
+
+//! Knobs of MatmulParams chosen by autotuning
+struct MatmulTuning {
+  GemmTile cta_tile = GemmTile(128, 128, 32);
+  GemmTile warp_tile = GemmTile(64, 64, 32);
+  //! Ignored if the heuristic doesn't double buffer the operands
+  int smem_double_buffer_stage = 2;
+  int grid_swizzle_factor = 1;
+  int splitk_factor = 1;
+  MatmulParams::TileRasterizationOrder cta_order =
+      MatmulParams::TileRasterizationOrder::RowMajor;
+  //! Kernel time of the tuned variant when it was benchmarked
+  float time_ms = 0;
+
+  //! The configuration chosen by the heuristic
+  static MatmulTuning fromParams(const MatmulParams& params);
+
+  bool operator==(const MatmulTuning& other) const {
+    return cta_tile == other.cta_tile && warp_tile == other.warp_tile &&
+        smem_double_buffer_stage == other.smem_double_buffer_stage &&
+        grid_swizzle_factor == other.grid_swizzle_factor &&
+        splitk_factor == other.splitk_factor && cta_order == other.cta_order;
+  }
+
+  //! Space-separated fields, as stored in the TuningDb
+  std::string serialize() const;
+  static std::optional<MatmulTuning> deserialize(const std::string& str);
+};
+
+//! A text file of tunings, one entry per line, consisting of the key and the
+//! serialized tuning. Entries are appended as single lines, so concurrent
+//! processes can share the file. A later line for the same key replaces an
+//! earlier one.
+class TuningDb {
+ public:
+  //! Loads the entries in the given file, if it exists
+  explicit TuningDb(std::string path);
+
+  TuningDb(const TuningDb&) = delete;
+  TuningDb& operator=(const TuningDb&) = delete;
+
+  //! Returns the database configured by EnableOption::Autotune, or nullptr
+  //! if autotuning is not enabled
+  static TuningDb* get();
+
+  //! Returns the serialized tuning for the key
+  std::optional<std::string> query(const std::string& key);
+
+  //! Adds an entry and appends it to the file. Returns false if the file
+  //! could not be written, in which case the entry is only kept in memory.
+  bool write(const std::string& key, const std::string& tuning);
+
+  //! Writes all entries to the given file, one line per key, and returns the
+  //! number of entries written
+  int64_t exportTo(const std::string& path);
+
+  int64_t numEntries();
+
+  const std::string& path() const {
+    return path_;
+  }
+
+ private:
+  const std::string path_;
+  std::mutex mutex_;
+  std::unordered_map<std::string, std::string> entries_;
+};
+
+namespace autotune {
+
+//! See [ Autotuning of Matmul Heuristics ]
+constexpr int64_t kMaxMatmulAccumulatorRegisters = 128;
+constexpr int64_t kMatmulTuningRounds = 3;
+
+//! Key of the tuning database. For matmuls, it consists of the problem
+//! description of getMatmulProblemKey. Otherwise, it consists of the IR of
+//! the fusion and the input sizes rounded up to powers of two. Both also
+//! include the heuristic, the index type and the device.
+std::string makeKey(
+    ScheduleHeuristic heuristic,
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info);
+
+//! Tunings benchmarked for the parameters chosen by the heuristic. The first
+//! one leaves the parameters unchanged.
+std::vector<ReductionTuning> tuningCandidates(
+    ScheduleHeuristic heuristic,
+    const ReductionParams& rparams);
+
+//! Applies a tuning to the parameters chosen by the heuristic. Returns false
+//! and leaves rparams unchanged if the tuning isn't applicable to them.
+bool applyTuning(
+    ScheduleHeuristic heuristic,
+    const ReductionTuning& tuning,
+    ReductionParams& rparams);
+
+//! Candidates of the given round of matmul tuning, derived from the fastest
+//! tuning of the previous rounds
+std::vector<MatmulTuning> matmulTuningCandidates(
+    int64_t round,
+    const MatmulParams& params,
+    const MatmulTuning& best);
+
+//! Applies a tuning to the parameters chosen by getMatmulHeuristics. Returns
+//! false and leaves params unchanged if the tiles are inconsistent or don't
+//! fit in shared memory.
+bool applyMatmulTuning(
+    Fusion* fusion,
+    const MatmulTuning& tuning,
+    MatmulParams& params);
+
+//! Looks up the tuning of the fusion in the tuning database, benchmarking
+//! the candidates if there is none yet, and returns the tuned parameters.
+//! Returns the given parameters if autotuning is not enabled or not possible
+//! for the fusion.
+std::shared_ptr<HeuristicParams> tuneReductionParams(
+    ScheduleHeuristic heuristic,
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info,
+    const std::shared_ptr<HeuristicParams>& params);
+
+//! Same as tuneReductionParams for the matmul heuristic
+std::shared_ptr<HeuristicParams> tuneMatmulParams(
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info,
+    const std::shared_ptr<HeuristicParams>& params);
+
+} // namespace autotune
+
+} // namespace nvfuser
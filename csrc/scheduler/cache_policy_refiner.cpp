@@ -10,6 +10,7 @@
 #include <ir/base_nodes.h>
 #include <ir/internal_nodes.h>
 #include <ir/utils.h>
+#include <options.h>
 #include <root_domain_map.h>
 #include <scheduler/cache_policy_refiner.h>
 #include <scheduler/debug_utils.h>
@@ -67,6 +68,24 @@ bool isLoadGlobalToLocal(const Expr* expr) {
   return true;
 }
 
+bool isStoreLocalToGlobal(const Expr* expr) {
+  if (!expr->isA<LoadStoreOp>()) {
+    return false;
+  }
+  const LoadStoreOp* ldst = expr->as<LoadStoreOp>();
+
+  if (ldst->opType() != LoadStoreOpType::Set) {
+    return false;
+  }
+  if (ldst->in()->as<TensorView>()->getMemoryType() != MemoryType::Local) {
+    return false;
+  }
+  if (ldst->out()->as<TensorView>()->getMemoryType() != MemoryType::Global) {
+    return false;
+  }
+  return true;
+}
+
 // Finds the first expanding use of `ldst`'s output, bypassing all pointwise
 // operations.
 const Expr* findExpand(const LoadStoreOp* ldst) {
@@ -145,15 +164,70 @@ bool refineCachePolicy(LoadStoreOp* ldst) {
   return true;
 }
 
+// Stores of fusion outputs that the kernel doesn't read back are streaming,
+// so that the written lines are evicted first. Other stores are write-back.
+void refineStoreCachePolicy(LoadStoreOp* ldst) {
+  const Val* out = ldst->out();
+  auto target_cache_op = out->isFusionOutput() && out->uses().empty()
+      ? CacheOp::Streaming
+      : CacheOp::AllLevels;
+  if (ldst->cacheOp() == target_cache_op) {
+    return;
+  }
+  vlog(
+      "Changed the cache op of ",
+      ldst->toString(),
+      " from ",
+      ldst->cacheOp(),
+      " to ",
+      target_cache_op,
+      " because ",
+      out->toString(),
+      target_cache_op == CacheOp::Streaming ? " is written once"
+                                            : " is read back");
+  ldst->setCacheOp(target_cache_op);
+}
+
 } // namespace
 
 void refineCachePolicy(Fusion* fusion) {
+  const bool streaming_stores = isOptionEnabled(EnableOption::StreamingStores);
   for (Expr* expr : fusion->exprs()) {
-    // Currently, we only change cache policy for global->local loads.
     if (isLoadGlobalToLocal(expr)) {
       refineCachePolicy(expr->as<LoadStoreOp>());
+    } else if (streaming_stores && isStoreLocalToGlobal(expr)) {
+      refineStoreCachePolicy(expr->as<LoadStoreOp>());
     }
   }
 }
 
+void refineCachePolicyForReuse(
+    Fusion* fusion,
+    const std::vector<int64_t>& reused_input_positions) {
+  std::unordered_set<Val*> reused_inputs;
+  for (auto pos : reused_input_positions) {
+    reused_inputs.insert(fusion->inputs().at(pos));
+  }
+  for (Expr* expr : fusion->exprs()) {
+    if (!isLoadGlobalToLocal(expr)) {
+      continue;
+    }
+    auto ldst = expr->as<LoadStoreOp>();
+    if (reused_inputs.count(ldst->in()) == 0 ||
+        ldst->cacheOp() != CacheOp::Streaming) {
+      continue;
+    }
+    vlog(
+        "Changed the cache op of ",
+        ldst->toString(),
+        " from ",
+        ldst->cacheOp(),
+        " to ",
+        CacheOp::EvictLast,
+        " because a later segment reads ",
+        ldst->in()->toString());
+    ldst->setCacheOp(CacheOp::EvictLast);
+  }
+}
+
 } // namespace nvfuser
@@ -12,7 +12,16 @@
 namespace nvfuser {
 
 // Visits all global-to-local vector loads in `fusion` and refines their cache
-// policies.
+// policies. With NVFUSER_ENABLE=streaming_stores, also marks the
+// local-to-global stores of outputs that are written once as streaming and
+// the other stores as write-back.
 void refineCachePolicy(Fusion* fusion);
 
+// Changes the cache policy of the global-to-local loads of the given fusion
+// inputs from streaming to evict-last, because another segment reads these
+// inputs again. See [ L2 Reuse Across Segments ] in kernel_cache.h.
+void refineCachePolicyForReuse(
+    Fusion* fusion,
+    const std::vector<int64_t>& reused_input_positions);
+
 } // namespace nvfuser
@@ -227,6 +227,8 @@ class CompileTimeInfoBase : public PolymorphicBase {
 //!  - when not in `recording` mode, compiled-time data has
 //!     been stored in this cache and the entries can be accessed
 //!!    but new entries can no longer be inserted.
+//!  See [ Global Heuristic Summary Cache ] for the entries shared across
+//!   the copies of a fusion.
 class HeuristicSummary {
   using Entry = HeuristicCompileTime::CompileTimeInfoBase;
   using EntryOwningPtr = std::unique_ptr<Entry>;
@@ -249,14 +251,34 @@ class HeuristicSummary {
     return entry_type_map_.at(entry_type);
   }
 
+  //! Check if an entry of entry_type has been inserted, e.g., from the
+  //! global cache before recording
+  bool has(EntryType entry_type) const {
+    return entry_type_map_.count(entry_type) > 0;
+  }
+
  private:
   void validate() const;
 
+  //! Insert the entries of the global cache recorded for a copy of fusion
+  void loadGlobalEntries(Fusion* fusion);
+
+  //! Store the entries that can be remapped to copies of the fusion in the
+  //! global cache
+  void storeGlobalEntries() const;
+
  private:
   std::vector<EntryOwningPtr> entries_;
   std::unordered_map<EntryType, EntryPtr> entry_type_map_;
   ScheduleHeuristic heuristic_;
   bool recording_ = true;
+
+  //! Key of the fusion in the global cache, empty if
+  //! EnableOption::GlobalHeuristicCache is not set
+  std::string global_key_;
+
+  //! Set if the global cache had entries for the fusion
+  bool loaded_global_entries_ = false;
 };
 
 //! A utility class to facilitate accessing HeuristicSummary.
@@ -0,0 +1,251 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <exceptions.h>
+#include <scheduler/device_model.h>
+#include <utils.h>
+
+#include <ATen/cuda/CUDAContext.h>
+#include <c10/cuda/CUDAFunctions.h>
+
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace nvfuser {
+
+namespace {
+
+//! Estimates of what cudaDeviceProp doesn't report, from the peak
+//! throughputs published for each architecture
+struct ArchitectureEstimates {
+  int64_t major;
+  int64_t minor;
+  //! Dense half-precision tensor core FLOPs per SM and per clock
+  int64_t tensor_core_flops_per_sm_per_clock;
+  //! L2 bandwidth relative to the DRAM bandwidth
+  double l2_to_dram_bandwidth;
+};
+
+// In increasing order of compute capability. A device takes the estimates of
+// the last architecture that isn't newer than it.
+constexpr ArchitectureEstimates kArchitectureEstimates[] = {
+    {0, 0, 0, 2.0},
+    // V100
+    {7, 0, 1024, 2.5},
+    // T4
+    {7, 5, 1024, 2.5},
+    // A100
+    {8, 0, 2048, 3.0},
+    // A10, RTX 30
+    {8, 6, 1024, 3.0},
+    // L4, L40, RTX 40
+    {8, 9, 1024, 4.0},
+    // H100
+    {9, 0, 4096, 2.5},
+};
+
+const ArchitectureEstimates& getArchitectureEstimates(
+    int64_t major,
+    int64_t minor) {
+  const ArchitectureEstimates* estimates = &kArchitectureEstimates[0];
+  for (const auto& arch : kArchitectureEstimates) {
+    if (std::make_pair(arch.major, arch.minor) <=
+        std::make_pair(major, minor)) {
+      estimates = &arch;
+    }
+  }
+  return *estimates;
+}
+
+const std::vector<std::pair<std::string, int64_t DeviceModel::*>>&
+integerFields() {
+  static const std::vector<std::pair<std::string, int64_t DeviceModel::*>>
+      fields = {
+          {"major", &DeviceModel::major},
+          {"minor", &DeviceModel::minor},
+          {"sm_count", &DeviceModel::sm_count},
+          {"warp_size", &DeviceModel::warp_size},
+          {"max_threads_per_block", &DeviceModel::max_threads_per_block},
+          {"max_threads_per_sm", &DeviceModel::max_threads_per_sm},
+          {"registers_per_sm", &DeviceModel::registers_per_sm},
+          {"registers_per_block", &DeviceModel::registers_per_block},
+          {"smem_per_block", &DeviceModel::smem_per_block},
+          {"reserved_smem_per_block", &DeviceModel::reserved_smem_per_block},
+          {"smem_per_sm", &DeviceModel::smem_per_sm},
+          {"l1_size", &DeviceModel::l1_size},
+          {"active_threads_per_sm", &DeviceModel::active_threads_per_sm},
+          {"l2_size", &DeviceModel::l2_size},
+      };
+  return fields;
+}
+
+const std::vector<std::pair<std::string, double DeviceModel::*>>&
+floatingPointFields() {
+  static const std::vector<std::pair<std::string, double DeviceModel::*>>
+      fields = {
+          {"clock_rate", &DeviceModel::clock_rate},
+          {"dram_bandwidth", &DeviceModel::dram_bandwidth},
+          {"l2_bandwidth", &DeviceModel::l2_bandwidth},
+          {"tensor_core_flops", &DeviceModel::tensor_core_flops},
+      };
+  return fields;
+}
+
+template <typename T>
+T parseField(const std::string& field, const std::string& value) {
+  std::istringstream ss(value);
+  T parsed;
+  ss >> parsed;
+  NVF_CHECK(
+      !ss.fail() && (ss >> std::ws).eof(),
+      "Invalid value of the device model field ",
+      field,
+      ": ",
+      value);
+  return parsed;
+}
+
+std::string trim(const std::string& str) {
+  const auto begin = str.find_first_not_of(" \t\r");
+  if (begin == std::string::npos) {
+    return "";
+  }
+  const auto end = str.find_last_not_of(" \t\r");
+  return str.substr(begin, end - begin + 1);
+}
+
+DeviceModel buildCurrentDeviceModel() {
+  DeviceModel model = DeviceModel::fromDeviceProperties(
+      *at::cuda::getCurrentDeviceProperties());
+  if (const char* path = getNvFuserEnv("DEVICE_MODEL")) {
+    model.loadConfig(path);
+  }
+  return model;
+}
+
+std::mutex device_models_mutex;
+std::unordered_map<int64_t, std::unique_ptr<DeviceModel>> device_models;
+
+} // namespace
+
+DeviceModel DeviceModel::fromDeviceProperties(const cudaDeviceProp& prop) {
+  DeviceModel model;
+  model.name = prop.name;
+  model.major = prop.major;
+  model.minor = prop.minor;
+  model.sm_count = prop.multiProcessorCount;
+  model.warp_size = prop.warpSize;
+  model.max_threads_per_block = prop.maxThreadsPerBlock;
+  model.max_threads_per_sm = prop.maxThreadsPerMultiProcessor;
+  model.registers_per_sm = prop.regsPerMultiprocessor;
+  model.registers_per_block = prop.regsPerBlock;
+  model.smem_per_block = prop.sharedMemPerBlockOptin;
+  model.reserved_smem_per_block = prop.reservedSharedMemPerBlock;
+  model.smem_per_sm = prop.sharedMemPerMultiprocessor;
+  model.l2_size = prop.l2CacheSize;
+
+  // The rates are in kHz, and the memory transfers twice per clock
+  model.clock_rate = (double)prop.clockRate * 1e3;
+  model.dram_bandwidth =
+      (double)prop.memoryClockRate * 1e3 * 2.0 * (prop.memoryBusWidth / 8.0);
+
+  const ArchitectureEstimates& estimates =
+      getArchitectureEstimates(model.major, model.minor);
+  model.l2_bandwidth = model.dram_bandwidth * estimates.l2_to_dram_bandwidth;
+  model.tensor_core_flops = (double)model.sm_count * model.clock_rate *
+      (double)estimates.tensor_core_flops_per_sm_per_clock;
+  return model;
+}
+
+void DeviceModel::setField(const std::string& field, const std::string& value) {
+  if (field == "name") {
+    name = value;
+    return;
+  }
+  for (const auto& [field_name, member] : integerFields()) {
+    if (field_name == field) {
+      this->*member = parseField<int64_t>(field, value);
+      return;
+    }
+  }
+  for (const auto& [field_name, member] : floatingPointFields()) {
+    if (field_name == field) {
+      this->*member = parseField<double>(field, value);
+      return;
+    }
+  }
+  NVF_CHECK(false, "Unknown device model field: ", field);
+}
+
+void DeviceModel::loadConfig(const std::string& path) {
+  std::ifstream config(path);
+  NVF_CHECK(config.good(), "Could not open the device model config ", path);
+  std::string line;
+  int64_t line_number = 0;
+  while (std::getline(config, line)) {
+    line_number++;
+    line = trim(line.substr(0, line.find('#')));
+    if (line.empty()) {
+      continue;
+    }
+    const auto separator = line.find('=');
+    NVF_CHECK(
+        separator != std::string::npos,
+        "Expected \"field = value\" at line ",
+        line_number,
+        " of ",
+        path,
+        ", but got: ",
+        line);
+    setField(
+        trim(line.substr(0, separator)), trim(line.substr(separator + 1)));
+  }
+}
+
+std::string DeviceModel::toString() const {
+  std::stringstream ss;
+  ss << "name = " << name << "\n";
+  for (const auto& [field_name, member] : integerFields()) {
+    ss << field_name << " = " << this->*member << "\n";
+  }
+  for (const auto& [field_name, member] : floatingPointFields()) {
+    ss << field_name << " = " << this->*member << "\n";
+  }
+  return ss.str();
+}
+
+const DeviceModel& getDeviceModel() {
+  const int64_t device = c10::cuda::current_device();
+  std::lock_guard<std::mutex> guard(device_models_mutex);
+  auto& model = device_models[device];
+  if (model == nullptr) {
+    model = std::make_unique<DeviceModel>(buildCurrentDeviceModel());
+  }
+  return *model;
+}
+
+void setDeviceModel(const DeviceModel& model) {
+  const int64_t device = c10::cuda::current_device();
+  std::lock_guard<std::mutex> guard(device_models_mutex);
+  auto& current_model = device_models[device];
+  if (current_model == nullptr) {
+    current_model = std::make_unique<DeviceModel>(model);
+  } else {
+    *current_model = model;
+  }
+}
+
+void resetDeviceModel() {
+  setDeviceModel(buildCurrentDeviceModel());
+}
+
+} // namespace nvfuser
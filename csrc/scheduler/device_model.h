@@ -0,0 +1,106 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+struct cudaDeviceProp;
+
+namespace nvfuser {
+
+//! [ Device Model ]
+//!
+//! The scheduler heuristics size their launch configurations from the
+//! resources of the target GPU. DeviceModel describes them in one place, so
+//! that all the heuristics make the same assumptions, e.g., on L4 and H100
+//! as well as on A100, instead of each querying a few device properties and
+//! hard-coding the others.
+//!
+//! The model of a device is built from its cudaDeviceProp. The properties
+//! CUDA doesn't report, the L2 bandwidth and the tensor core throughput, are
+//! per-architecture estimates. Any field can be overridden by a config file
+//! whose path is in NVFUSER_DEVICE_MODEL, with a "field = value" line per
+//! field and comments starting with '#', e.g., with bandwidths measured by
+//! benchmarks or to generate heuristics for another GPU:
+//!   # NVIDIA L4
+//!   dram_bandwidth = 3.0e11
+//!   l2_bandwidth = 1.2e12
+struct DeviceModel {
+  std::string name;
+  //! Compute capability
+  int64_t major = 0;
+  int64_t minor = 0;
+
+  int64_t sm_count = 0;
+  int64_t warp_size = 32;
+  int64_t max_threads_per_block = 1024;
+  int64_t max_threads_per_sm = 2048;
+  //! 32-bit registers
+  int64_t registers_per_sm = 64 * 1024;
+  int64_t registers_per_block = 64 * 1024;
+  //! Bytes of shared memory a block can opt in to, including the reserved
+  //! bytes
+  int64_t smem_per_block = 48 * 1024;
+  //! Bytes of shared memory per block reserved by the system
+  int64_t reserved_smem_per_block = 0;
+  int64_t smem_per_sm = 64 * 1024;
+  //! Bytes of L1 the heuristics expect to be available to their data. This
+  //! is a conservative value, lower than the L1 of recent architectures.
+  int64_t l1_size = 32 * 1024;
+  //! Threads per SM the heuristics expect to keep active to hide latencies,
+  //! rather than the resident ones
+  int64_t active_threads_per_sm = 1024;
+  int64_t l2_size = 0;
+
+  //! Clock rate of the SMs in Hz
+  double clock_rate = 0.0;
+  //! Bytes per second
+  double dram_bandwidth = 0.0;
+  double l2_bandwidth = 0.0;
+  //! Dense half-precision tensor core FLOPs per second, zero if the device
+  //! has no tensor cores
+  double tensor_core_flops = 0.0;
+
+  //! Model of a device from its properties and the estimates of its
+  //! architecture
+  static DeviceModel fromDeviceProperties(const cudaDeviceProp& prop);
+
+  //! Sets a field by name, e.g., from a line of a config file
+  void setField(const std::string& field, const std::string& value);
+
+  //! Overrides the fields listed in a config file
+  void loadConfig(const std::string& path);
+
+  //! Bytes of the register file of an SM
+  int64_t registerFileSize() const {
+    return registers_per_sm * (int64_t)sizeof(int32_t);
+  }
+
+  //! Bytes of shared memory a block can use
+  int64_t availableSmemPerBlock() const {
+    return smem_per_block - reserved_smem_per_block;
+  }
+
+  std::string toString() const;
+};
+
+//! Model of the current device, built on first use, see [ Device Model ].
+//! The reference stays valid, but setDeviceModel must not be called while
+//! heuristics are computed on other threads.
+const DeviceModel& getDeviceModel();
+
+//! Replaces the model of the current device, e.g., to generate heuristics
+//! for another GPU or in tests
+void setDeviceModel(const DeviceModel& model);
+
+//! Rebuilds the model of the current device from its properties and the
+//! NVFUSER_DEVICE_MODEL config file
+void resetDeviceModel();
+
+} // namespace nvfuser
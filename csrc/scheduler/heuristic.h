@@ -31,6 +31,14 @@ class HeuristicParams : public PolymorphicBase {
 
   virtual bool sameAs(const std::shared_ptr<HeuristicParams>& other) const = 0;
 
+  //! Returns true if a kernel compiled with these parameters is also valid for
+  //! the inputs that other was computed for, e.g., when other only differs by
+  //! a larger vectorization factor. See [ Alignment Tolerant Kernel Reuse ].
+  virtual bool canRunInputsOf(
+      const std::shared_ptr<HeuristicParams>& other) const {
+    return sameAs(other);
+  }
+
   virtual std::shared_ptr<HeuristicParams> clone() const = 0;
 
   HeuristicParams() = default;
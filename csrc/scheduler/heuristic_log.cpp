@@ -0,0 +1,749 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <scheduler/heuristic_log.h>
+
+#include <executor.h>
+#include <expr_evaluator.h>
+#include <instrumentation.h>
+#include <ir/all_nodes.h>
+#include <ir/utils.h>
+#include <iter_visitor.h>
+#include <options.h>
+#include <scheduler/registry.h>
+#include <utils.h>
+
+#include <c10/util/irange.h>
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+
+namespace nvfuser {
+
+namespace heuristic_log {
+
+namespace {
+
+namespace fs = std::filesystem;
+
+constexpr int64_t kWarmupRuns = 1;
+constexpr int64_t kTimedRuns = 5;
+
+//! Set while replayHeuristics runs, so that its decisions aren't logged
+thread_local bool in_replay = false;
+
+class ReplayGuard {
+ public:
+  ReplayGuard() : prev_(in_replay) {
+    in_replay = true;
+  }
+  ~ReplayGuard() {
+    in_replay = prev_;
+  }
+
+ private:
+  const bool prev_;
+};
+
+std::string logPath() {
+  const auto& args = getEnableOptionArguments(EnableOption::HeuristicLog);
+  return !args.empty() && !args.at(0).empty()
+      ? args.at(0)
+      : (fs::temp_directory_path() / "nvfuser_heuristic_log.txt").string();
+}
+
+//! The name of the PrimDataType enumerator, or nullopt for other types
+std::optional<std::string> primDataTypeName(const DataType& dtype) {
+  if (!std::holds_alternative<PrimDataType>(dtype.type)) {
+    return std::nullopt;
+  }
+  switch (std::get<PrimDataType>(dtype.type)) {
+    case PrimDataType::Double:
+      return "Double";
+    case PrimDataType::Float:
+      return "Float";
+    case PrimDataType::Half:
+      return "Half";
+    case PrimDataType::BFloat16:
+      return "BFloat16";
+    case PrimDataType::Float8_e4m3fn:
+      return "Float8_e4m3fn";
+    case PrimDataType::Float8_e5m2:
+      return "Float8_e5m2";
+    case PrimDataType::Int:
+      return "Int";
+    case PrimDataType::Int32:
+      return "Int32";
+    case PrimDataType::Int8:
+      return "Int8";
+    case PrimDataType::UInt:
+      return "UInt";
+    case PrimDataType::UInt32:
+      return "UInt32";
+    case PrimDataType::Index:
+      return "Index";
+    case PrimDataType::Bool:
+      return "Bool";
+    case PrimDataType::ComplexDouble:
+      return "ComplexDouble";
+    case PrimDataType::ComplexFloat:
+      return "ComplexFloat";
+    default:
+      return std::nullopt;
+  }
+}
+
+//! The function of ops/ creating a BinaryOp of the given type
+std::optional<std::string> binaryOpFunction(BinaryOpType type) {
+  switch (type) {
+    case BinaryOpType::Add:
+      return "add";
+    case BinaryOpType::Atan2:
+      return "atan2";
+    case BinaryOpType::Div:
+      return "div";
+    case BinaryOpType::Fmod:
+      return "fmod";
+    case BinaryOpType::Max:
+      return "max";
+    case BinaryOpType::Min:
+      return "min";
+    case BinaryOpType::Mul:
+      return "mul";
+    case BinaryOpType::Nextafter:
+      return "nextafter";
+    case BinaryOpType::Pow:
+      return "pow";
+    case BinaryOpType::Remainder:
+      return "remainder";
+    case BinaryOpType::Sub:
+      return "sub";
+    case BinaryOpType::Complex:
+      return "complex";
+    case BinaryOpType::Mod:
+      return "mod";
+    case BinaryOpType::CeilDiv:
+      return "ceilDiv";
+    case BinaryOpType::Lshift:
+      return "bitwise_left_shift";
+    case BinaryOpType::Rshift:
+      return "bitwise_right_shift";
+    case BinaryOpType::Gcd:
+      return "gcd";
+    case BinaryOpType::BitwiseAnd:
+      return "bitwise_and";
+    case BinaryOpType::BitwiseOr:
+      return "bitwise_or";
+    case BinaryOpType::BitwiseXor:
+      return "bitwise_xor";
+    case BinaryOpType::LogicalAnd:
+      return "logical_and";
+    case BinaryOpType::LogicalOr:
+      return "logical_or";
+    case BinaryOpType::Eq:
+      return "eq";
+    case BinaryOpType::GE:
+      return "ge";
+    case BinaryOpType::GT:
+      return "gt";
+    case BinaryOpType::LE:
+      return "le";
+    case BinaryOpType::LT:
+      return "lt";
+    case BinaryOpType::NE:
+      return "ne";
+    default:
+      return std::nullopt;
+  }
+}
+
+//! The BinaryOpType enumerator of the reductions reductionOp supports
+std::optional<std::string> reductionOpTypeName(BinaryOpType type) {
+  switch (type) {
+    case BinaryOpType::Add:
+      return "Add";
+    case BinaryOpType::Mul:
+      return "Mul";
+    case BinaryOpType::Max:
+      return "Max";
+    case BinaryOpType::Min:
+      return "Min";
+    default:
+      return std::nullopt;
+  }
+}
+
+//! The function of ops/ creating a UnaryOp of the given type, other than
+//! casts
+std::optional<std::string> unaryOpFunction(UnaryOpType type) {
+  switch (type) {
+    case UnaryOpType::Cast:
+    case UnaryOpType::BitCast:
+    case UnaryOpType::RefCast:
+    case UnaryOpType::Address:
+    case UnaryOpType::Dereference:
+    case UnaryOpType::Gelu:
+    case UnaryOpType::Print:
+    case UnaryOpType::ToUnsignedSmemAddr:
+    case UnaryOpType::AdjustPartialLdMatrixAddrInTuring8:
+    case UnaryOpType::AdjustPartialLdMatrixAddrInTuring16:
+      return std::nullopt;
+    case UnaryOpType::Round:
+      return "round";
+    case UnaryOpType::Real:
+      return "real";
+    case UnaryOpType::Imag:
+      return "imag";
+    default: {
+      // The others are printed as the name of their function
+      std::stringstream ss;
+      ss << type;
+      return ss.str();
+    }
+  }
+}
+
+template <typename T>
+std::string toList(const std::vector<T>& values) {
+  std::stringstream ss;
+  ss << "{";
+  for (auto i : c10::irange(values.size())) {
+    ss << (i > 0 ? ", " : "") << values.at(i);
+  }
+  ss << "}";
+  return ss.str();
+}
+
+std::string toBoolList(const std::vector<bool>& values) {
+  std::stringstream ss;
+  ss << "std::vector<bool>{";
+  for (auto i : c10::irange(values.size())) {
+    ss << (i > 0 ? ", " : "") << (values.at(i) ? "true" : "false");
+  }
+  ss << "}";
+  return ss.str();
+}
+
+//! Positions of the reduction domains of the root domain of tv
+std::vector<int> reductionAxes(TensorView* tv) {
+  std::vector<int> axes;
+  const auto& root = tv->getRootDomain();
+  for (auto i : c10::irange(root.size())) {
+    if (root.at(i)->isReduction()) {
+      axes.push_back((int)i);
+    }
+  }
+  return axes;
+}
+
+//! Prints the statements of fusionToCpp
+class FusionCppPrinter {
+ public:
+  explicit FusionCppPrinter(ExpressionEvaluator& expr_eval)
+      : expr_eval_(expr_eval) {}
+
+  std::string print(Fusion* fusion) {
+    for (Val* input : fusion->inputs()) {
+      declareInput(input);
+    }
+    for (Expr* expr :
+         StmtSort::getExprsBetween(fusion->inputs(), fusion->outputs())) {
+      handle(expr);
+    }
+    for (Val* output : fusion->outputs()) {
+      ss_ << "fusion->addOutput(" << name(output) << ");\n";
+    }
+    return ss_.str();
+  }
+
+ private:
+  static std::string variable(Val* val) {
+    return (val->isA<TensorView>() ? "tv" : "s") + std::to_string(val->name());
+  }
+
+  //! The variable holding val, or a new constant of its value
+  std::string name(Val* val) {
+    auto it = names_.find(val);
+    if (it != names_.end()) {
+      return it->second;
+    }
+    if (val->isA<TensorView>()) {
+      // Defined by an unsupported expr
+      return variable(val);
+    }
+    const PolymorphicValue& value = val->definition() == nullptr &&
+            val->value().hasValue()
+        ? val->value()
+        : expr_eval_.evaluate(val);
+    if (auto literal = literalOf(value, val->dtype())) {
+      return literal.value();
+    }
+    return "/* unknown " + val->toInlineString() + " */ nullptr";
+  }
+
+  static std::optional<std::string> literalOf(
+      const PolymorphicValue& value,
+      const DataType& dtype) {
+    const auto dtype_name = primDataTypeName(dtype);
+    if (!dtype_name.has_value()) {
+      return std::nullopt;
+    }
+    std::stringstream ss;
+    ss << "IrBuilder::create<Val>(";
+    if (value.is<bool>()) {
+      ss << (value.as<bool>() ? "true" : "false");
+    } else if (value.is<int64_t>()) {
+      ss << "(int64_t)" << value.as<int64_t>();
+    } else if (value.is<double>()) {
+      const double d = value.as<double>();
+      if (std::isnan(d)) {
+        ss << "std::numeric_limits<double>::quiet_NaN()";
+      } else if (std::isinf(d)) {
+        ss << (d < 0 ? "-" : "") << "std::numeric_limits<double>::infinity()";
+      } else {
+        ss << std::setprecision(std::numeric_limits<double>::max_digits10)
+           << std::showpoint << d;
+      }
+    } else {
+      return std::nullopt;
+    }
+    ss << ", DataType::" << dtype_name.value() << ")";
+    return ss.str();
+  }
+
+  void declareInput(Val* input) {
+    const std::string var = variable(input);
+    names_[input] = var;
+    const auto dtype_name = primDataTypeName(input->dtype());
+    const std::string dtype =
+        "DataType::" + dtype_name.value_or("/* unsupported */ Null");
+    auto tv = dynamic_cast<TensorView*>(input);
+    if (tv == nullptr) {
+      ss_ << "Val* " << var << " = IrBuilder::create<Val>(" << dtype
+          << ");\n";
+      ss_ << "fusion->addInput(" << var << ");\n";
+      return;
+    }
+
+    const auto& rfactor = tv->getMaybeRFactorDomain();
+    std::vector<int64_t> shape;
+    std::vector<bool> expanded;
+    for (auto i : c10::irange(rfactor.size())) {
+      IterDomain* id = rfactor.at(i);
+      if (id->hasExpandedExtent()) {
+        shape.push_back(-1);
+      } else if (id->extent()->isConstInt()) {
+        shape.push_back(id->extent()->evaluate().as<int64_t>());
+      } else {
+        shape.push_back(-1);
+      }
+      expanded.push_back(id->hasExpandedExtent());
+      names_[id->getMaybeExpandedExtent()] = var +
+          "->getMaybeRFactorDomain().at(" + std::to_string(i) +
+          ")->getMaybeExpandedExtent()";
+    }
+
+    std::vector<std::string> contiguity;
+    for (const auto& contig : tv->getContiguity()) {
+      contiguity.emplace_back(
+          !contig.has_value() ? "std::nullopt"
+              : contig.value() ? "true"
+                               : "false");
+    }
+
+    ss_ << "TensorView* " << var << " = TensorViewBuilder()\n"
+        << "    .ndims(" << rfactor.size() << ")\n"
+        << "    .shape(std::vector<int64_t>" << toList(shape) << ")\n"
+        << "    .contiguity(std::vector<std::optional<bool>>"
+        << toList(contiguity) << ")\n";
+    if (std::any_of(expanded.begin(), expanded.end(), [](bool e) {
+          return e;
+        })) {
+      ss_ << "    .expanded(" << toBoolList(expanded) << ")\n";
+    }
+    if (tv->hasAllocation()) {
+      // See TensorDomain's constructor for the meaning of a stride order
+      const auto& allocation = tv->getMaybeAllocationDomain();
+      std::vector<int64_t> stride_order;
+      for (IterDomain* id : rfactor) {
+        auto pos = std::find(allocation.begin(), allocation.end(), id);
+        stride_order.push_back(
+            (int64_t)allocation.size() - 1 -
+            (int64_t)std::distance(allocation.begin(), pos));
+      }
+      ss_ << "    .strideOrder(" << toList(stride_order) << ")\n";
+    }
+    ss_ << "    .dtype(" << dtype << ")\n"
+        << "    .build();\n";
+    ss_ << "fusion->addInput(" << var << ");\n";
+  }
+
+  //! Starts the statement defining val
+  std::stringstream& define(Val* val) {
+    const std::string var = variable(val);
+    names_[val] = var;
+    ss_ << (val->isA<TensorView>() ? "TensorView* " : "Val* ") << var
+        << " = ";
+    return ss_;
+  }
+
+  void unsupported(Expr* expr) {
+    std::stringstream expr_ss;
+    expr_ss << expr->toString();
+    std::string line;
+    while (std::getline(expr_ss, line)) {
+      ss_ << "// Unsupported: " << line << "\n";
+    }
+  }
+
+  void handle(Expr* expr) {
+    if (auto uop = dynamic_cast<UnaryOp*>(expr)) {
+      handle(uop);
+    } else if (auto bop = dynamic_cast<BinaryOp*>(expr)) {
+      handle(bop);
+    } else if (auto top = dynamic_cast<TernaryOp*>(expr)) {
+      define(top->out()) << top->getTernaryOpType() << "("
+                         << name(top->in1()) << ", " << name(top->in2())
+                         << ", " << name(top->in3()) << ");\n";
+    } else if (auto rop = dynamic_cast<ReductionOp*>(expr)) {
+      handle(rop);
+    } else if (auto wop = dynamic_cast<WelfordOp*>(expr)) {
+      handle(wop);
+    } else if (auto bcast = dynamic_cast<BroadcastOp*>(expr)) {
+      define(bcast->out()) << "broadcast(" << name(bcast->in()) << ", "
+                           << toBoolList(bcast->getBroadcastDimFlags())
+                           << ");\n";
+    } else if (auto squeeze = dynamic_cast<SqueezeOp*>(expr)) {
+      define(squeeze->out()) << "squeeze(" << name(squeeze->in()) << ", "
+                             << toBoolList(squeeze->getSqueezeDimFlags())
+                             << ");\n";
+    } else if (auto expand = dynamic_cast<ExpandOp*>(expr)) {
+      handle(expand);
+    } else if (auto view = dynamic_cast<ViewOp*>(expr)) {
+      std::vector<std::string> sizes;
+      for (IterDomain* id : view->out()->getMaybeRFactorDomain()) {
+        sizes.push_back(name(id->extent()));
+      }
+      define(view->out()) << "reshape(" << name(view->in())
+                          << ", std::vector<Val*>" << toList(sizes) << ");\n";
+    } else if (auto ldst = dynamic_cast<LoadStoreOp*>(expr)) {
+      handle(ldst);
+    } else {
+      unsupported(expr);
+    }
+  }
+
+  void handle(UnaryOp* uop) {
+    const UnaryOpType type = uop->getUnaryOpType();
+    const auto dtype_name = primDataTypeName(uop->out()->dtype());
+    if (type == UnaryOpType::Cast && dtype_name.has_value()) {
+      define(uop->out()) << "castOp(DataType::" << dtype_name.value() << ", "
+                         << name(uop->in()) << ");\n";
+    } else if (type == UnaryOpType::BitCast && dtype_name.has_value()) {
+      define(uop->out()) << "bitCastOp(DataType::" << dtype_name.value()
+                         << ", " << name(uop->in()) << ");\n";
+    } else if (auto function = unaryOpFunction(type)) {
+      define(uop->out()) << function.value() << "(" << name(uop->in())
+                         << ");\n";
+    } else {
+      unsupported(uop);
+    }
+  }
+
+  void handle(BinaryOp* bop) {
+    auto function = binaryOpFunction(bop->getBinaryOpType());
+    if (!function.has_value()) {
+      unsupported(bop);
+      return;
+    }
+    define(bop->out()) << function.value() << "(" << name(bop->lhs()) << ", "
+                       << name(bop->rhs()) << ");\n";
+  }
+
+  void handle(ReductionOp* rop) {
+    auto type = reductionOpTypeName(rop->getReductionOpType());
+    auto out = dynamic_cast<TensorView*>(rop->out());
+    if (!type.has_value() || out == nullptr) {
+      unsupported(rop);
+      return;
+    }
+    define(out) << "reductionOp(BinaryOpType::" << type.value() << ", "
+                << toList(reductionAxes(out)) << ", " << name(rop->init())
+                << ", " << name(rop->in()) << ");\n";
+  }
+
+  void handle(WelfordOp* wop) {
+    auto avg = dynamic_cast<TensorView*>(wop->outAvg());
+    if (wop->hasInit() || !wop->singleValue() || avg == nullptr) {
+      unsupported(wop);
+      return;
+    }
+    const std::string result = "welford" + std::to_string(avg->name());
+    ss_ << "auto " << result << " = WelfordRaw(" << name(wop->in()) << ", "
+        << toList(reductionAxes(avg)) << ");\n";
+    define(wop->outAvg()) << result << ".avg;\n";
+    define(wop->outVar()) << result << ".var_sum;\n";
+    define(wop->outN()) << result << ".n;\n";
+  }
+
+  void handle(ExpandOp* expand) {
+    // -1 keeps the extent of a domain that isn't expanded
+    std::vector<std::string> sizes;
+    for (IterDomain* id : expand->out()->getMaybeRFactorDomain()) {
+      sizes.push_back(
+          id->hasExpandedExtent()
+              ? name(id->expandedExtent())
+              : "IrBuilder::create<Val>((int64_t)-1, DataType::Index)");
+    }
+    define(expand->out()) << "expand(" << name(expand->in())
+                          << ", std::vector<Val*>" << toList(sizes)
+                          << ");\n";
+  }
+
+  void handle(LoadStoreOp* ldst) {
+    auto out = dynamic_cast<TensorView*>(ldst->out());
+    if (ldst->opType() != LoadStoreOpType::Set) {
+      unsupported(ldst);
+      return;
+    }
+    if (out == nullptr || !out->hasRFactor()) {
+      define(ldst->out()) << "set(" << name(ldst->in()) << ");\n";
+      return;
+    }
+    // A permute, see permute in ops/alias.h
+    const auto& root = out->getRootDomain();
+    std::vector<int64_t> new2old;
+    for (IterDomain* id : out->getRFactorDomain()) {
+      auto pos = std::find(root.begin(), root.end(), id);
+      if (pos == root.end()) {
+        unsupported(ldst);
+        return;
+      }
+      new2old.push_back((int64_t)std::distance(root.begin(), pos));
+    }
+    define(out) << "permute(" << name(ldst->in()) << ", "
+                << "std::vector<int64_t>" << toList(new2old) << ");\n";
+  }
+
+ private:
+  ExpressionEvaluator& expr_eval_;
+  std::stringstream ss_;
+  std::unordered_map<Val*, std::string> names_;
+};
+
+//! The sizes or strides as a list, or "?" if they can't be evaluated
+std::string shapeString(const std::optional<std::vector<int64_t>>& values) {
+  return values.has_value() ? "[" + toDelimitedString(values.value()) + "]"
+                            : "?";
+}
+
+//! Schedules a copy of the fusion with the entry, runs it on the arguments
+//! and returns the fastest kernel time
+float timeEntry(
+    ScheduleHeuristic heuristic,
+    SchedulerEntry* entry,
+    Fusion* fusion,
+    KernelArgumentHolder& args) {
+  auto fusion_copy = std::make_unique<Fusion>(*fusion);
+  FusionGuard fg(fusion_copy.get());
+  entry->schedule(fusion_copy.get());
+
+  const HeuristicParams& params = *entry->params();
+  FusionExecutor fe;
+  fe.compileFusion(
+      fusion_copy.get(), args, params.lparams, params.cparams, heuristic);
+  fe.setMeasureKernelTimeFlag(true);
+  float time_ms = std::numeric_limits<float>::max();
+  for (int64_t i = 0; i < kWarmupRuns + kTimedRuns; ++i) {
+    fe.runFusion(args, params.lparams, params.cparams);
+    if (i >= kWarmupRuns) {
+      time_ms = std::min(time_ms, fe.kernelTimeMs());
+    }
+  }
+  return time_ms;
+}
+
+} // namespace
+
+bool isEnabled() {
+  return !in_replay && isOptionEnabled(EnableOption::HeuristicLog);
+}
+
+std::string makeRecord(
+    ScheduleHeuristic heuristic,
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info,
+    const HeuristicParams& params) {
+  auto& expr_eval = runtime_info.expressionEvaluator();
+  std::stringstream ss;
+  ss << "=== heuristic decision ===\n";
+  ss << "heuristic: " << heuristic << "\n";
+  ss << "index_type: " << runtime_info.getIndexType() << "\n";
+  for (Val* input : fusion->inputs()) {
+    const std::string dtype =
+        primDataTypeName(input->dtype()).value_or("unsupported");
+    auto tv = dynamic_cast<TensorView*>(input);
+    if (tv == nullptr) {
+      const PolymorphicValue& value = expr_eval.evaluate(input);
+      ss << "input: scalar dtype=" << dtype << " value=";
+      if (value.is<double>()) {
+        ss << std::setprecision(std::numeric_limits<double>::max_digits10)
+           << value.as<double>();
+      } else if (value.is<int64_t>()) {
+        ss << value.as<int64_t>();
+      } else if (value.is<bool>()) {
+        ss << (value.as<bool>() ? "true" : "false");
+      } else {
+        ss << "?";
+      }
+      ss << "\n";
+      continue;
+    }
+
+    // Intermediates of a segment aren't bound, and evaluating them would
+    // compute them
+    std::optional<std::vector<int64_t>> sizes;
+    std::optional<std::vector<int64_t>> strides;
+    if (tv->definition() == nullptr &&
+        expr_eval.evaluate(tv).is<at::Tensor>()) {
+      const auto& tensor = expr_eval.evaluate(tv).as<at::Tensor>();
+      sizes = tensor.sizes().vec();
+      strides = tensor.strides().vec();
+    } else {
+      sizes = std::vector<int64_t>();
+      for (IterDomain* id :
+           TensorDomain::noReductions(tv->getMaybeRFactorDomain())) {
+        const PolymorphicValue& extent =
+            expr_eval.evaluate(id->getMaybeExpandedExtent());
+        if (!extent.is<int64_t>()) {
+          sizes = std::nullopt;
+          break;
+        }
+        sizes->push_back(extent.as<int64_t>());
+      }
+    }
+    ss << "input: tensor dtype=" << dtype << " sizes=" << shapeString(sizes)
+       << " strides=" << shapeString(strides)
+       << " alignment=" << runtime_info.getAlignmentSize(tv) << "\n";
+  }
+  ss << "params:\n" << params.toString();
+  if (ss.str().back() != '\n') {
+    ss << "\n";
+  }
+  ss << "repro:\n" << fusionToCpp(fusion, expr_eval);
+  ss << "=== end ===\n";
+  return ss.str();
+}
+
+void logDecision(
+    ScheduleHeuristic heuristic,
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info,
+    const HeuristicParams& params) {
+  if (!isEnabled()) {
+    return;
+  }
+  FUSER_PERF_SCOPE("heuristic_log::logDecision");
+  const std::string record =
+      makeRecord(heuristic, fusion, runtime_info, params);
+  const std::string path = logPath();
+
+  // A single write of the whole record, so that records appended by
+  // concurrent threads and processes don't interleave
+  static std::mutex log_mutex;
+  std::lock_guard<std::mutex> guard(log_mutex);
+  std::ofstream file(path, std::ios::app);
+  file << record << std::flush;
+  if (!file) {
+    TORCH_WARN("Could not write to nvFuser heuristic log ", path);
+  }
+}
+
+std::string fusionToCpp(Fusion* fusion, ExpressionEvaluator& expr_eval) {
+  return FusionCppPrinter(expr_eval).print(fusion);
+}
+
+std::vector<ReplayResult> replayHeuristics(
+    Fusion* fusion,
+    const std::vector<c10::IValue>& inputs) {
+  FUSER_PERF_SCOPE("heuristic_log::replayHeuristics");
+  ReplayGuard replay_guard;
+  FusionGuard fg(fusion);
+  auto args = KernelArgumentHolder::createKernelArgumentHolder(inputs);
+  SchedulerRuntimeInfo runtime_info(fusion, args);
+
+  std::vector<ReplayResult> results;
+  for (ScheduleHeuristic heuristic : all_heuristics_in_priority_order) {
+    ReplayResult result;
+    result.heuristic = heuristic;
+    try {
+      result.can_schedule =
+          SchedulerEntry::canSchedule(heuristic, fusion, runtime_info);
+      if (result.can_schedule) {
+        auto entry =
+            SchedulerEntry::makeEntry(heuristic, fusion, runtime_info);
+        result.params = entry->params()->toString();
+        result.time_ms = timeEntry(heuristic, entry.get(), fusion, args);
+      }
+    } catch (const std::exception& e) {
+      // Only the first line, the rest is usually a stack trace
+      result.error = e.what();
+      result.error = result.error.substr(0, result.error.find('\n'));
+    }
+    results.push_back(std::move(result));
+  }
+  return results;
+}
+
+std::string toString(const std::vector<ReplayResult>& results) {
+  // Fastest first, then those that failed, then those that were rejected
+  auto rank = [](const ReplayResult& result) {
+    return std::make_pair(
+        result.time_ms.has_value() ? 0 : (result.can_schedule ? 1 : 2),
+        result.time_ms.value_or(0.0f));
+  };
+  std::vector<const ReplayResult*> sorted;
+  for (const ReplayResult& result : results) {
+    sorted.push_back(&result);
+  }
+  std::stable_sort(
+      sorted.begin(),
+      sorted.end(),
+      [&](const ReplayResult* a, const ReplayResult* b) {
+        return rank(*a) < rank(*b);
+      });
+
+  std::stringstream ss;
+  for (const ReplayResult* result : sorted) {
+    ss << "===== " << result->heuristic << ": ";
+    if (result->time_ms.has_value()) {
+      ss << std::fixed << std::setprecision(4) << result->time_ms.value()
+         << " ms";
+    } else if (result->can_schedule) {
+      ss << "failed";
+    } else {
+      ss << "rejected";
+    }
+    ss << " =====\n";
+    if (!result->error.empty()) {
+      ss << result->error << "\n";
+    }
+    ss << result->params;
+  }
+  return ss.str();
+}
+
+} // namespace heuristic_log
+
+} // namespace nvfuser
@@ -0,0 +1,97 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <fusion.h>
+#include <scheduler/heuristic_types.h>
+
+#include <ATen/core/ivalue.h>
+
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace nvfuser {
+
+class ExpressionEvaluator;
+class HeuristicParams;
+class SchedulerRuntimeInfo;
+
+//! [ Heuristic Decision Log ]
+//!
+//! A slow kernel in production is usually the result of a heuristic choice
+//! for an input shape nobody benchmarked. With
+//! NVFUSER_ENABLE=heuristic_log(<file>), every SchedulerEntry::makeEntry
+//! appends a record of its decision to the file, by default
+//! nvfuser_heuristic_log.txt in the temporary directory. A record consists
+//! of:
+//!  - the heuristic and the index type,
+//!  - the data type, sizes, strides and alignment of each tensor input of
+//!    the fused segment, and the value of each scalar input,
+//!  - the chosen parameters, as printed by HeuristicParams::toString,
+//!  - C++ statements that rebuild the segment, see fusionToCpp.
+//!
+//! Records are appended with a single write, so that records of concurrent
+//! threads and processes don't interleave. Sizes and strides of inputs that
+//! can't be evaluated at the decision, e.g., of intermediates of the
+//! segmenter, are printed as "?".
+//!
+//! tools/heuristic-replay.py lists the records of a log and turns one into
+//! a gtest, which rebuilds the segment, synthesizes inputs of the logged
+//! sizes and strides, and calls replayHeuristics to compare the parameters
+//! of every scheduler that accepts the segment.
+namespace heuristic_log {
+
+//! Whether decisions are logged, i.e., EnableOption::HeuristicLog is set and
+//! no replay is running on this thread
+bool isEnabled();
+
+//! The record of a decision
+std::string makeRecord(
+    ScheduleHeuristic heuristic,
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info,
+    const HeuristicParams& params);
+
+//! Appends the record of a decision to the log, if logging is enabled
+void logDecision(
+    ScheduleHeuristic heuristic,
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info,
+    const HeuristicParams& params);
+
+//! C++ statements that rebuild the fusion in the Fusion `fusion` held by the
+//! current FusionGuard. Scalars that aren't inputs or constants are given
+//! the values of expr_eval. Exprs of unsupported types are emitted as
+//! comments, in which case the statements don't compile.
+std::string fusionToCpp(Fusion* fusion, ExpressionEvaluator& expr_eval);
+
+//! Result of replaying a fusion with one scheduler
+struct ReplayResult {
+  ScheduleHeuristic heuristic = ScheduleHeuristic::None;
+  bool can_schedule = false;
+  //! HeuristicParams::toString of the scheduler's parameters
+  std::string params;
+  //! Fastest kernel time, or nullopt if compiling or running failed
+  std::optional<float> time_ms;
+  std::string error;
+};
+
+//! Schedules, compiles and runs the fusion with every scheduler that
+//! accepts it. The fusion must not be segmented. Decisions of the replay
+//! aren't logged.
+std::vector<ReplayResult> replayHeuristics(
+    Fusion* fusion,
+    const std::vector<c10::IValue>& inputs);
+
+//! A table of the results, fastest first
+std::string toString(const std::vector<ReplayResult>& results);
+
+} // namespace heuristic_log
+
+} // namespace nvfuser
@@ -29,6 +29,14 @@ std::string toString(ScheduleHeuristic sh) {
       return "transpose";
     case ScheduleHeuristic::Matmul:
       return "matmul";
+    case ScheduleHeuristic::Horizontal:
+      return "horizontal";
+    case ScheduleHeuristic::Sort:
+      return "sort";
+    case ScheduleHeuristic::Scan:
+      return "scan";
+    case ScheduleHeuristic::Stencil:
+      return "stencil";
     case ScheduleHeuristic::None:
       return "none";
     default:
@@ -54,11 +54,15 @@ enum class ScheduleHeuristic {
   InnerPersistent,
   InnerOuterPersistent,
   OuterPersistent,
-  Transpose
+  Transpose,
+  Horizontal,
+  Sort,
+  Scan,
+  Stencil
 };
 
 //! Define a schedule table to loop over all the heuristics in priority order.
-constexpr std::array<ScheduleHeuristic, 8> all_heuristics_in_priority_order = {
+constexpr std::array<ScheduleHeuristic, 12> all_heuristics_in_priority_order = {
     ScheduleHeuristic::NoOp,
     ScheduleHeuristic::Matmul,
     ScheduleHeuristic::Reduction,
@@ -66,7 +70,11 @@ constexpr std::array<ScheduleHeuristic, 8> all_heuristics_in_priority_order = {
     ScheduleHeuristic::PointWise,
     ScheduleHeuristic::InnerPersistent,
     ScheduleHeuristic::OuterPersistent,
-    ScheduleHeuristic::InnerOuterPersistent};
+    ScheduleHeuristic::InnerOuterPersistent,
+    ScheduleHeuristic::Horizontal,
+    ScheduleHeuristic::Sort,
+    ScheduleHeuristic::Scan,
+    ScheduleHeuristic::Stencil};
 
 std::string toString(ScheduleHeuristic sh);
 
@@ -0,0 +1,290 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <ATen/cuda/CUDAContext.h>
+#include <device_lower/utils.h>
+#include <disjoint_set.h>
+#include <inlining.h>
+#include <instrumentation.h>
+#include <ir/utils.h>
+#include <options.h>
+#include <scheduler/debug_utils.h>
+#include <scheduler/device_model.h>
+#include <scheduler/horizontal.h>
+#include <scheduler/mark_aliases.h>
+#include <scheduler/utils.h>
+#include <transform_replay.h>
+
+namespace nvfuser {
+
+namespace {
+
+// Blocks per SM the grid is limited to, unless the sub-problems are smaller
+constexpr int64_t kBlocksPerSm = 8;
+// Elements each thread should at least process
+constexpr int64_t kMinElementsPerThread = 4;
+constexpr int64_t kThreadsPerBlock = 128;
+
+//! Tensors that are connected by tensor expressions, and the fusion output
+//! the sub-problem is scheduled like
+struct SubProblem {
+  TensorView* reference = nullptr;
+  std::vector<TensorView*> tvs;
+};
+
+//! Sub-problems in the order of their first fusion output
+std::vector<SubProblem> getSubProblems(Fusion* fusion) {
+  DisjointSets<TensorView*> connected_tvs;
+  for (auto tv : ir_utils::allTvs(fusion)) {
+    connected_tvs.initializeSet(tv);
+  }
+  for (auto expr : fusion->exprs()) {
+    auto out_tvs = ir_utils::filterByType<TensorView>(expr->outputs());
+    if (out_tvs.empty()) {
+      continue;
+    }
+    TensorView* out_tv = *out_tvs.begin();
+    for (auto tv : ir_utils::filterByType<TensorView>(expr->inputs())) {
+      connected_tvs.mapEntries(out_tv, tv);
+    }
+    for (auto tv : out_tvs) {
+      connected_tvs.mapEntries(out_tv, tv);
+    }
+  }
+
+  std::vector<SubProblem> sub_problems;
+  std::unordered_set<const VectorOfUniqueEntries<TensorView*>*> visited_sets;
+  for (auto out_tv : ir_utils::filterByType<TensorView>(fusion->outputs())) {
+    const auto& tvs = connected_tvs.getDisjointSetOf(out_tv);
+    if (!visited_sets.insert(&tvs).second) {
+      continue;
+    }
+    sub_problems.push_back({out_tv, tvs.vector()});
+  }
+  return sub_problems;
+}
+
+int64_t numel(SchedulerRuntimeInfo& runtime_info, TensorView* tv) {
+  int64_t numel = 1;
+  for (auto id : TensorDomain::noReductions(tv->getMaybeRFactorDomain())) {
+    auto extent = runtime_info.expressionEvaluator().evaluate(id->extent());
+    NVF_ERROR(
+        extent.hasValue(),
+        "Could not infer the extent of ",
+        id->toString(),
+        " of ",
+        tv->toString());
+    numel *= extent.as<int64_t>();
+  }
+  return numel;
+}
+
+} // namespace
+
+HorizontalScheduler::HorizontalScheduler(
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info,
+    HeuristicSummary* data_cache)
+    : SchedulerEntry(heuristicType()) {
+  computeHeuristics(fusion, runtime_info, data_cache);
+}
+
+bool HorizontalScheduler::canScheduleCompileTime(Fusion* fusion) {
+  if (!isOptionEnabled(EnableOption::HorizontalFusion)) {
+    scheduler_debug_utils::canScheduleRejectReason(
+        heuristicType(), "not enabled");
+    return false;
+  }
+
+  if (ir_utils::hasAnyReductionOps(fusion)) {
+    scheduler_debug_utils::canScheduleRejectReason(
+        heuristicType(), "no support for reduction ops");
+    return false;
+  }
+
+  for (auto expr : fusion->exprs()) {
+    if (ir_utils::isScalarOp(expr)) {
+      continue;
+    }
+    const bool is_pointwise = expr->isA<UnaryOp>() || expr->isA<BinaryOp>() ||
+        expr->isA<TernaryOp>() ||
+        (expr->isA<LoadStoreOp>() &&
+         expr->as<LoadStoreOp>()->opType() == LoadStoreOpType::Set);
+    if (!is_pointwise) {
+      scheduler_debug_utils::canScheduleRejectReason(
+          heuristicType(), "unsupported expression: ", expr->toString());
+      return false;
+    }
+  }
+
+  for (auto tv : ir_utils::allTvs(fusion)) {
+    if (tv->hasAllocation()) {
+      scheduler_debug_utils::canScheduleRejectReason(
+          heuristicType(), "no support for allocation domains");
+      return false;
+    }
+    const auto& rfactor_domain = tv->getMaybeRFactorDomain();
+    if (std::any_of(rfactor_domain.begin(), rfactor_domain.end(), [](auto id) {
+          return id->isBroadcast();
+        })) {
+      scheduler_debug_utils::canScheduleRejectReason(
+          heuristicType(), "no support for broadcast domains");
+      return false;
+    }
+  }
+
+  for (auto out : fusion->outputs()) {
+    if (!out->isA<TensorView>() || out->isFusionInput()) {
+      scheduler_debug_utils::canScheduleRejectReason(
+          heuristicType(), "outputs must be computed tensors");
+      return false;
+    }
+  }
+
+  const auto sub_problems = getSubProblems(fusion);
+  if (sub_problems.size() < 2) {
+    scheduler_debug_utils::canScheduleRejectReason(
+        heuristicType(), "needs at least two independent sub-problems");
+    return false;
+  }
+
+  // An output aliasing an input of another sub-problem would be written
+  // while other blocks may still read the input
+  for (auto out : fusion->outputs()) {
+    auto in = dynamic_cast<TensorView*>(fusion->getOutputAlias(out).first);
+    if (in == nullptr) {
+      continue;
+    }
+    const bool same_sub_problem = std::any_of(
+        sub_problems.begin(), sub_problems.end(), [&](const auto& sub_problem) {
+          return std::count(
+                     sub_problem.tvs.begin(), sub_problem.tvs.end(), out) &&
+              std::count(sub_problem.tvs.begin(), sub_problem.tvs.end(), in);
+        });
+    if (!same_sub_problem) {
+      scheduler_debug_utils::canScheduleRejectReason(
+          heuristicType(), "output aliases an input of another sub-problem");
+      return false;
+    }
+  }
+
+  // Without broadcasts, the tensors of a sub-problem map to the reference
+  // dimension by dimension
+  for (const auto& sub_problem : sub_problems) {
+    const auto rank = sub_problem.reference->getMaybeRFactorDomain().size();
+    if (rank == 0) {
+      scheduler_debug_utils::canScheduleRejectReason(
+          heuristicType(), "no support for 0-dim tensors");
+      return false;
+    }
+    for (auto tv : sub_problem.tvs) {
+      if (tv->getMaybeRFactorDomain().size() != rank) {
+        scheduler_debug_utils::canScheduleRejectReason(
+            heuristicType(),
+            "tensors of a sub-problem must have the same rank");
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+bool HorizontalScheduler::canScheduleRunTime(
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info,
+    HeuristicSummary* data_cache) {
+  return true;
+}
+
+void HorizontalScheduler::schedule(Fusion* fusion) {
+  FUSER_PERF_SCOPE("Schedule Horizontal Fusion");
+  auto params = std::dynamic_pointer_cast<HorizontalParams>(params_);
+  NVF_ERROR(
+      params != nullptr, "Heuristic parameter is not a horizontal parameter");
+  scheduleHorizontal(fusion, *params);
+}
+
+void HorizontalScheduler::computeHeuristics(
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info,
+    HeuristicSummary* data_cache) {
+  params_ = getHorizontalHeuristics(fusion, runtime_info, data_cache);
+  NVF_ERROR(params_ != nullptr);
+}
+
+std::shared_ptr<HorizontalParams> getHorizontalHeuristics(
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info,
+    HeuristicSummary* data_cache) {
+  FUSER_PERF_SCOPE("getHorizontalHeuristics");
+  FusionGuard fg(fusion);
+
+  int64_t total_numel = 0;
+  int64_t max_numel = 0;
+  for (const auto& sub_problem : getSubProblems(fusion)) {
+    const int64_t sub_problem_numel =
+        numel(runtime_info, sub_problem.reference);
+    total_numel += sub_problem_numel;
+    max_numel = std::max(max_numel, sub_problem_numel);
+  }
+
+  auto params = std::make_shared<HorizontalParams>(
+      "Horizontal heuristics", runtime_info.getIndexType());
+  params->bdimx = kThreadsPerBlock;
+
+  // Enough blocks to give every thread a few elements, but not more than
+  // fill the device a few times over, and not more than the largest
+  // sub-problem has threads for
+  const int64_t device_blocks =
+      getDeviceModel().sm_count *
+      kBlocksPerSm;
+  int64_t gdimx =
+      ceilDiv(total_numel, params->bdimx * kMinElementsPerThread);
+  gdimx = std::min(gdimx, device_blocks);
+  gdimx = std::min(gdimx, ceilDiv(max_numel, params->bdimx));
+  params->gdimx = std::max(gdimx, (int64_t)1);
+
+  if (isDebugDumpEnabled(DebugDumpOption::SchedulerDebug)) {
+    debug() << params->toString() << std::endl;
+  }
+  return params;
+}
+
+void scheduleHorizontal(Fusion* fusion, const HorizontalParams& params) {
+  FusionGuard fg(fusion);
+
+  // Make sure we don't have global memory set on intermediate tensors from
+  // fusion segmentation
+  scheduler_utils::clearMemorySpace(fusion);
+
+  scheduler_utils::cacheInputs(fusion, true);
+  scheduler_utils::cacheAndForkOutputs(fusion, true);
+
+  for (const auto& sub_problem : getSubProblems(fusion)) {
+    TensorView* reference = sub_problem.reference;
+    while (reference->nDims() > 1) {
+      reference->merge(0);
+    }
+    // [BIDx{gdimx}, serial, TIDx{bdimx}], so each block processes a
+    // contiguous chunk of the sub-problem
+    reference->split(0, params.gdimx, /*inner_split=*/false);
+    reference->split(1, params.bdimx);
+    reference->axis(0)->parallelize(ParallelType::BIDx);
+    reference->axis(2)->parallelize(ParallelType::TIDx);
+
+    TransformPropagator propagator(reference);
+    MaxRootDomainInfoSpanningTree(reference).traverse(&propagator);
+    scheduler_utils::parallelizeAllLike(reference, sub_problem.tvs);
+  }
+
+  inlineMost();
+
+  markAliases(fusion);
+}
+
+} // namespace nvfuser
@@ -0,0 +1,75 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <scheduler/horizontal_heuristic.h>
+#include <scheduler/registry.h>
+
+namespace nvfuser {
+
+class Fusion;
+class SchedulerRuntimeInfo;
+class HeuristicSummary;
+
+//! [ Horizontal Fusion ]
+//!
+//! Fusions like optimizer steps update many small tensors that don't depend
+//! on each other. The pointwise scheduler can't find a reference tensor for
+//! them, so they are segmented into one kernel per tensor, and the launch
+//! overhead dominates. The horizontal scheduler instead generates a single
+//! kernel for a fusion that consists of two or more independent pointwise
+//! sub-problems, i.e., groups of tensors that are not connected by any
+//! tensor expression. Scalars, e.g., a learning rate, may be shared.
+//!
+//! Each sub-problem is flattened and scheduled on its own as
+//!   [BIDx{gdimx}, serial, TIDx{bdimx}]
+//! where all sub-problems use the same gdimx and bdimx. Every block thus
+//! processes a contiguous chunk of 1/gdimx of each sub-problem, which
+//! balances the work of the blocks regardless of the sizes of the
+//! sub-problems, and the parallel dimensions of the kernel are exact.
+//!
+//! Only unary, binary and ternary ops and sets are supported, and tensors
+//! can't have broadcast domains or allocation domains. Reductions are not
+//! supported. The scheduler has the lowest priority, so it only applies to
+//! fusions no other scheduler accepts. It is enabled with
+//! NVFUSER_ENABLE=horizontal_fusion.
+class HorizontalScheduler : public SchedulerEntry {
+ public:
+  explicit HorizontalScheduler(
+      Fusion* fusion,
+      SchedulerRuntimeInfo& runtime_info,
+      HeuristicSummary* data_cache = nullptr);
+
+  static bool canScheduleCompileTime(Fusion* fusion);
+
+  static bool canScheduleRunTime(
+      Fusion* fusion,
+      SchedulerRuntimeInfo& runtime_info,
+      HeuristicSummary* data_cache = nullptr);
+
+  constexpr static ScheduleHeuristic heuristicType() {
+    return ScheduleHeuristic::Horizontal;
+  }
+
+  void schedule(Fusion* fusion) override;
+
+ private:
+  void computeHeuristics(
+      Fusion* fusion,
+      SchedulerRuntimeInfo& runtime_info,
+      HeuristicSummary* data_cache = nullptr);
+};
+
+std::shared_ptr<HorizontalParams> getHorizontalHeuristics(
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info,
+    HeuristicSummary* data_cache = nullptr);
+
+void scheduleHorizontal(Fusion* fusion, const HorizontalParams& params);
+
+} // namespace nvfuser
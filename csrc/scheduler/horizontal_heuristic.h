@@ -0,0 +1,61 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <scheduler/heuristic.h>
+
+#include <sstream>
+
+namespace nvfuser {
+
+//! Parameters of the horizontal heuristic, see [ Horizontal Fusion ].
+//! Warning: equal operator is intended for use in caching the kernel
+//! associated with these parameters. It does not check if the launch
+//! parameters are equivelent!
+class HorizontalParams : public HeuristicParams {
+ public:
+  //! Number of blocks each sub-problem is distributed over
+  int64_t gdimx = 1;
+
+  //! Threads per block
+  int64_t bdimx = 128;
+
+  using HeuristicParams::HeuristicParams;
+
+  // Warning: Does not check launch parameters!
+  bool sameAs(
+      const std::shared_ptr<HeuristicParams>& other_base) const override {
+    auto other_casted = std::dynamic_pointer_cast<HorizontalParams>(other_base);
+    if (other_casted == nullptr) {
+      return false;
+    }
+    const HorizontalParams& other = *other_casted;
+    return other.cparams == cparams && other.gdimx == gdimx &&
+        other.bdimx == bdimx;
+  }
+
+  std::string toString() const override {
+    std::stringstream ss;
+    ss << "\n===== Horizontal Parameters ========\n"
+       << (tag.empty() ? "" : "Tag: ") << tag << "\n"
+       << " Gridx: " << gdimx << " BlckX: " << bdimx << "\n"
+       << "====================================\n";
+    return ss.str();
+  }
+
+  // Warning: Hash is not based on launch parameters!
+  size_t hash() const override {
+    return static_cast<size_t>(gdimx) ^ static_cast<size_t>(bdimx) << 32;
+  }
+
+  std::shared_ptr<HeuristicParams> clone() const override {
+    return std::make_shared<HorizontalParams>(*this);
+  }
+};
+
+} // namespace nvfuser
@@ -7,6 +7,8 @@
 // clang-format on
 #include <inlining.h>
 #include <instrumentation.h>
+#include <iter_visitor.h>
+#include <ops/alias.h>
 #include <scheduler/debug_utils.h>
 #include <scheduler/matmul.h>
 #include <scheduler/matmul_utils.h>
@@ -651,9 +653,12 @@ void scheduleOutputTensor(
 }
 //! Propagates transformations from fusion output to fusion tv inputs that are
 //!  producers in the epilogue. Transformations' propagation aims at input tvs
-//!  which are not assigned to core roles, that is, are not MMA inputs.
+//!  which are not assigned to core roles, that is, are not MMA inputs. Inputs
+//!  of epilogue reductions only are scheduled like their staged tensors, see
+//!  [ Matmul Epilogue Reductions ].
 void scheduleFusionInputsForEpilogue(
     const mma_utils::RolesMap& roles_map,
+    const std::vector<TensorView*>& staged_tvs,
     const bool with_smem_epilogue) {
   std::vector<TensorView*> cached_tvs;
 
@@ -664,17 +669,10 @@ void scheduleFusionInputsForEpilogue(
   if (roles_map.count(MatmulRole::INPUT_C)) {
     auto& c_tvs = roles_map.at(MatmulRole::INPUT_C);
 
-    // The system supports only scenario where there is only one fusion output
-    //  with assigned OUTPUT_D role, this condition is already verified so there
-    //  is no need for an additional checks here
-    auto output_d = roles_map.at(MatmulRole::OUTPUT_D).front();
     for (auto* c : c_tvs) {
       cached_tvs.push_back(c->cacheAfter());
     }
 
-    scheduler_utils::BoundedDirectionalTransformPropagator::backward(
-        output_d, -1, c_tvs);
-
     std::unordered_set<ParallelType> parallel_types = {};
     if (with_smem_epilogue) {
       //! In cases where smem epilogue feature is enabled, the vectorization of
@@ -685,14 +683,201 @@ void scheduleFusionInputsForEpilogue(
       //!  enabled for matmul scheduler.
       parallel_types = allParallelTypesExcept({ParallelType::Vectorize});
     }
-    scheduler_utils::parallelizeAllLike(
-        output_d, -1, cached_tvs, parallel_types);
+
+    // The staged tensors have the layout of the epilogue, so they can be used
+    //  as references for the inputs they depend on
+    for (auto staged : staged_tvs) {
+      std::vector<TensorView*> staged_c_tvs;
+      std::vector<TensorView*> staged_cached_tvs;
+      for (auto i : c10::irange(c_tvs.size())) {
+        if (DependencyCheck::isDependencyOf(c_tvs[i], staged)) {
+          staged_c_tvs.push_back(c_tvs[i]);
+          staged_cached_tvs.push_back(cached_tvs[i]);
+        }
+      }
+      if (!staged_c_tvs.empty()) {
+        scheduler_utils::BoundedDirectionalTransformPropagator::backward(
+            staged, -1, staged_c_tvs);
+        scheduler_utils::parallelizeAllLike(
+            staged, -1, staged_cached_tvs, parallel_types);
+      }
+    }
+
+    // The system supports only scenario where there is only one fusion output
+    //  with assigned OUTPUT_D role, this condition is already verified so there
+    //  is no need for an additional checks here. There is no such output if
+    //  the MMA result is only consumed by epilogue reductions.
+    if (roles_map.count(MatmulRole::OUTPUT_D)) {
+      auto output_d = roles_map.at(MatmulRole::OUTPUT_D).front();
+      scheduler_utils::BoundedDirectionalTransformPropagator::backward(
+          output_d, -1, c_tvs);
+      scheduler_utils::parallelizeAllLike(
+          output_d, -1, cached_tvs, parallel_types);
+    }
 
     // The cached INPUT_C tvs are not needed anymore
     cached_tvs.clear();
   }
 }
 
+//! [ Matmul Epilogue Reductions ]
+//!
+//! A matmul fusion may reduce its epilogue along N, e.g., to compute
+//! statistics of the rows of linear(x) + bias, without writing the full
+//! result to global memory and reading it again in a separate reduction
+//! kernel. The reductions must be fusion outputs with no other uses, and
+//! only N may be reduced. This rules out normalizations in the same fusion,
+//! since those need the statistics of complete rows, which span the CTA
+//! tiles of all of N.
+//!
+//! The accumulator is distributed over the threads of a CTA by the MMA
+//! swizzle, which merges parts of M and N into the same axes, so it can't be
+//! reduced along N in place. Instead, each distinct input of the reductions
+//! is staged in shared memory in the layout of the epilogue, and reduced
+//! from there with a layout of its own:
+//!
+//!   [..., Mo, rNo, Mi/TIDz/TIDy, TIDz, TIDy, rNi/TIDx, rTIDx]
+//!
+//! The serial rNi/TIDx axis is reduced per thread by an rFactor, the warp of
+//! TIDx combines the partial results of each row within the CTA tile, and a
+//! grid reduction over the tiles along N, i.e., the block dimension rNo is
+//! parallelized with, produces the final result. Because that grid reduction
+//! requires plain tiles, grid swizzling and split-K aren't supported with
+//! epilogue reductions, and the shared memory epilogue is disabled in favor
+//! of the staged tiles.
+
+//! Stages the inputs of the epilogue reductions in shared memory, see
+//!  [ Matmul Epilogue Reductions ], and returns the staged tensors
+std::vector<TensorView*> stageEpilogueReductionInputs(
+    Fusion* fusion,
+    const std::vector<TensorView*>& reduction_tvs) {
+  FusionGuard fg(fusion);
+  std::vector<TensorView*> staged_tvs;
+  std::unordered_map<TensorView*, TensorView*> staged_inputs;
+  for (auto tv : reduction_tvs) {
+    auto in = tv->definition()->as<ReductionOp>()->in()->as<TensorView>();
+    auto it = staged_inputs.find(in);
+    if (it == staged_inputs.end()) {
+      auto staged = set(in);
+      staged->setMemoryType(MemoryType::Shared);
+      staged_tvs.push_back(staged);
+      it = staged_inputs.emplace(in, staged).first;
+    }
+    ir_utils::replaceValInExprInputs(tv->definition(), in, it->second);
+  }
+  return staged_tvs;
+}
+
+//! Schedules the staged inputs like the epilogue and the epilogue reductions
+//!  as described in [ Matmul Epilogue Reductions ]
+void scheduleEpilogueReductions(
+    TensorView* mma_result,
+    const std::vector<TensorView*>& staged_tvs,
+    const std::vector<TensorView*>& reduction_tvs,
+    const MatMulTileOptions& gemm_tile,
+    int num_batch_dims) {
+  for (auto staged : staged_tvs) {
+    scheduler_utils::BoundedDirectionalTransformPropagator::forward(
+        mma_result,
+        -1,
+        {staged},
+        scheduler_utils::BoundedDirectionalTransformPropagator::Options()
+            .propagateParallelType()
+            .propagateToBoundary());
+  }
+
+  constexpr int64_t tidx = 32l;
+  const int64_t tidy = gemm_tile.cta_tile.n / gemm_tile.warp_tile.n;
+  const int64_t tidz = gemm_tile.cta_tile.m / gemm_tile.warp_tile.m;
+  for (auto tv : reduction_tvs) {
+    NVF_ERROR(
+        tv->nDims() == num_batch_dims + 4,
+        "Unexpected epilogue reduction tiling: ",
+        tv->toString());
+    // [..., Mo, rNo, Mi, rNi]
+    tv->split(-1, tidx);
+    tv->axis(-1)->parallelize(ParallelType::TIDx);
+    tv->split(-3, tidy);
+    tv->axis(-3)->parallelize(ParallelType::TIDy);
+    tv->split(-4, tidz);
+    tv->axis(-4)->parallelize(ParallelType::TIDz);
+    // [..., Mo, rNo, Mi/TIDz/TIDy, TIDz, TIDy, rNi/TIDx, rTIDx]
+    scheduler_utils::parallelizeAllLike(
+        mma_result,
+        num_batch_dims + 2,
+        {tv},
+        {ParallelType::BIDx, ParallelType::BIDy, ParallelType::BIDz});
+
+    // The cached fusion output
+    scheduler_utils::BoundedDirectionalTransformPropagator::forward(
+        tv,
+        -1,
+        ir_utils::consumerTvsOf(tv),
+        scheduler_utils::BoundedDirectionalTransformPropagator::Options()
+            .propagateParallelType()
+            .propagateToBoundary());
+
+    // Reduce rNi/TIDx per thread, then the warps and the tiles along N
+    tv->rFactor({-2});
+  }
+}
+
+//! [ Matmul Prologue Fusion ]
+//!
+//! The operands of a matmul fusion may be computed from fusion inputs by
+//! pointwise ops, e.g., the weight of a weight-only quantized linear layer,
+//! which is stored in Int8 or FP8 and dequantized with a scale per output
+//! channel:
+//!
+//!   B = castOp(Half, mul(castOp(Float, B_int8), broadcast(scale)))
+//!
+//! Instead of materializing B in global memory in a separate kernel, the
+//! prologue computing B is fused into the main loop. The inputs of the
+//! prologue take the INPUT_PROLOGUE role, and B, which isn't a fusion input,
+//! the INPUT_B role. Each tile of the inputs is loaded into registers, the
+//! prologue is computed there, and its result is stored to the shared memory
+//! tile of the operand, from which the MMAs read as usual. So only the
+//! compressed weights and the scales are read from global memory.
+//!
+//! Prologues may also gather rows of fusion inputs, which are read from
+//! global memory at the gathered indices. With batch dimensions, this covers
+//! the grouped GEMMs of Mixture-of-Experts layers with a fixed capacity per
+//! expert: the tokens routed to each expert are gathered into its batch of
+//! A, all the experts are computed by the CTAs of a single kernel along
+//! BIDz, and the routing weights are applied by the epilogue:
+//!
+//!   A[e, c, k] = X[idx[e, c], k]
+//!   D[e, c, n] = gate[e, c] * sum_k A[e, c, k] * W[e, n, k]
+//!
+//! Because the tiles pass through registers, the operands are loaded with
+//! plain loads instead of cp.async, and shared memory is double buffered
+//! with at most two stages. Only the loads of the prologue inputs are
+//! vectorized, the pointwise ops are computed in the unrolled loops of the
+//! shared memory stores. The prologue tensors must not be used outside of
+//! the prologue, and the operand has to be Half or BFloat16.
+
+//! Unvectorizes the pointwise ops of the prologues, see
+//!  [ Matmul Prologue Fusion ]. The prologue tensors are scheduled like the
+//!  shared memory tiles of the operands by scheduleProlog, including the
+//!  vectorization of the stores.
+void unvectorizePrologues(
+    const std::vector<TensorView*>& prologue_inputs,
+    const std::vector<Val*>& operands) {
+  for (auto expr : DependencyCheck::getAllExprsBetween(
+           {prologue_inputs.begin(), prologue_inputs.end()}, operands)) {
+    if (expr->isA<LoadStoreOp>()) {
+      continue;
+    }
+    for (auto tv : ir_utils::filterByType<TensorView>(expr->outputs())) {
+      for (auto id : tv->getLeafDomain()) {
+        if (id->getParallelType() == ParallelType::Vectorize) {
+          id->parallelize(ParallelType::Serial);
+        }
+      }
+    }
+  }
+}
+
 } // namespace
 
 void scheduleMatmul(Fusion* fusion, const MatmulParams& params) {
@@ -737,6 +922,23 @@ void scheduleMatmul(Fusion* fusion, const MatmulParams& params) {
   const bool has_fusion_c_roles = (0 != roles_map.count(MatmulRole::INPUT_C));
   const bool has_non_mma_input_tvs = has_epilogue && has_fusion_c_roles;
 
+  // See [ Matmul Epilogue Reductions ]. With the MmaOp in place, all
+  //  remaining reductions are epilogue reductions.
+  std::vector<TensorView*> reduction_tvs;
+  for (auto rop : ir_utils::getOpsOfType<ReductionOp>(fusion)) {
+    reduction_tvs.push_back(rop->out()->as<TensorView>());
+  }
+  std::vector<TensorView*> staged_tvs;
+  if (!reduction_tvs.empty()) {
+    NVF_ERROR(
+        params.grid_swizzle_factor == 1 && params.splitk_factor == 1,
+        "Epilogue reductions don't support grid swizzle or split-K");
+    NVF_ERROR(
+        !params.use_smem_epilogue,
+        "Epilogue reductions don't support the shared memory epilogue");
+    staged_tvs = stageEpilogueReductionInputs(fusion, reduction_tvs);
+  }
+
   // Including current tensor naming convention for reference,
   //  this is very temporary and will change over time and
   //  in fact the whole body of this function will
@@ -769,8 +971,8 @@ void scheduleMatmul(Fusion* fusion, const MatmulParams& params) {
   //
   //  result in global memory: d
 
-  // Currently the support is for a, b, c and d as fusion inputs/outputs
-  //  aka. no prolog fusion yet.
+  // a and b may also be computed from fusion inputs in registers, see
+  //  [ Matmul Prologue Fusion ]
 
   mma->setMacro(params.mma_macro);
 
@@ -795,9 +997,26 @@ void scheduleMatmul(Fusion* fusion, const MatmulParams& params) {
   // Staging register for global memory load
   TensorView *ar = a, *br = b;
 
+  // See [ Matmul Prologue Fusion ]. The inputs of the prologues are staged
+  //  in registers instead of the operands they compute.
+  std::vector<TensorView*> prologue_inputs;
+  if (roles_map.count(MatmulRole::INPUT_PROLOGUE)) {
+    NVF_ERROR(
+        !params.async_gmem_load_operands,
+        "Prologue fusion doesn't support async loads of the operands");
+    prologue_inputs = roles_map.at(MatmulRole::INPUT_PROLOGUE);
+    for (auto tv : prologue_inputs) {
+      // Gathered tensors are indexed in global memory
+      if (!ir_utils::isTorchGatherLookupTv(tv) &&
+          !ir_utils::isIndexSelectLookupTv(tv)) {
+        tv->cacheAfter();
+      }
+    }
+  }
+
   if (!params.async_gmem_load_operands) {
-    ar = a->cacheAfter();
-    br = b->cacheAfter();
+    ar = a->isFusionInput() ? a->cacheAfter() : a;
+    br = b->isFusionInput() ? b->cacheAfter() : b;
   }
 
   // TODO:
@@ -898,6 +1117,9 @@ void scheduleMatmul(Fusion* fusion, const MatmulParams& params) {
     // the actual MmaOp output, so here we reassign that to the intermediate.
     splitk_sum = mma_result;
     mma_result = splitk_sum->rFactor({-4, -1});
+    if (params.use_serial_splitk) {
+      splitk_sum->definition()->as<ReductionOp>()->requestSerialGridReduction();
+    }
 
     num_splitk_dims = 1;
   }
@@ -925,6 +1147,9 @@ void scheduleMatmul(Fusion* fusion, const MatmulParams& params) {
   // ------------------------------------------------------------------
   scheduleProlog(acw_smem, params);
   scheduleProlog(bcw_smem, params);
+  if (!prologue_inputs.empty()) {
+    unvectorizePrologues(prologue_inputs, {a, b});
+  }
   // [..., Mo, No, (Kf,) Ko, Kw, Mwo, Nwo, Mwi, Nwi, Mi, Ni, Ki]
 
   // Add mma swizzle:
@@ -1059,6 +1284,11 @@ void scheduleMatmul(Fusion* fusion, const MatmulParams& params) {
     }
   } else {
     for (auto [dc, d] : cached_and_forked_outputs) {
+      // Epilogue reductions are scheduled by scheduleEpilogueReductions
+      if (std::find(reduction_tvs.begin(), reduction_tvs.end(), dc) !=
+          reduction_tvs.end()) {
+        continue;
+      }
       scheduler_utils::BoundedDirectionalTransformPropagator::forward(
           mma_result,
           -1,
@@ -1069,11 +1299,17 @@ void scheduleMatmul(Fusion* fusion, const MatmulParams& params) {
       d->axis(-1)->parallelize(ParallelType::Vectorize);
     }
   }
+  if (!reduction_tvs.empty()) {
+    scheduleEpilogueReductions(
+        mma_result, staged_tvs, reduction_tvs, gemm_tile, num_batch_dims);
+  }
+
   // propagate output transformations to all inputs that are part of epilogue
   //  operations, input tvs with non-core roles
   //  core roles: essential for matmul, for example mma inputs' producers
   if (has_non_mma_input_tvs) {
-    scheduleFusionInputsForEpilogue(roles_map, params.use_smem_epilogue);
+    scheduleFusionInputsForEpilogue(
+        roles_map, staged_tvs, params.use_smem_epilogue);
   }
 
   if (num_splitk_dims) {
@@ -1137,6 +1373,18 @@ void scheduleMatmul(Fusion* fusion, const MatmulParams& params) {
         params.double_buffer_options.smem_double_buffer_stage);
     bcw_smem->circularBuffer(
         params.double_buffer_options.smem_double_buffer_stage);
+
+    if (params.double_buffer_options.mbarrier_handoff) {
+      NVF_ERROR(
+          params.async_gmem_load_operands,
+          "MBarrier handoff only supports async load");
+      acw_smem->handOffStagesWithMBarriers();
+      bcw_smem->handOffStagesWithMBarriers();
+    }
+  } else {
+    NVF_ERROR(
+        !params.double_buffer_options.mbarrier_handoff,
+        "MBarrier handoff requires double buffered shared memory writes");
   }
 
   if (params.double_buffer_options.double_buffer_smem_read) {
@@ -25,6 +25,11 @@ class MatmulScheduler : public SchedulerEntry {
       SchedulerRuntimeInfo& runtime_info,
       HeuristicSummary* data_cache = nullptr);
 
+  //! Builds an entry with deserialized parameters, see
+  //! [ Serialized Heuristics ] in scheduler/registry.h
+  explicit MatmulScheduler(std::shared_ptr<HeuristicParams> params)
+      : SchedulerEntry(heuristicType(), std::move(params)) {}
+
   void schedule(Fusion* fusion) override;
 
   static bool canScheduleCompileTime(Fusion* fusion);
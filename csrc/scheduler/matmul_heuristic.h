@@ -30,11 +30,18 @@ class MatmulParams : public HeuristicParams {
     bool double_buffer_smem_write = false;
     bool double_buffer_smem_read = false;
     int smem_double_buffer_stage = 2;
+    //! (Ampere+) Hand off the stages of the shared memory operand buffers
+    //!  between loading and consuming them with mbarriers instead of
+    //!  cp.async.wait_group and __syncthreads, so that warps only wait for
+    //!  each other when they are about to overwrite a stage. Requires
+    //!  double_buffer_smem_write and async_gmem_load_operands.
+    bool mbarrier_handoff = false;
 
     bool operator==(const DoubleBufferOptions& other) const {
       return other.double_buffer_smem_write == double_buffer_smem_write &&
           other.double_buffer_smem_read == double_buffer_smem_read &&
-          other.smem_double_buffer_stage == smem_double_buffer_stage;
+          other.smem_double_buffer_stage == smem_double_buffer_stage &&
+          other.mbarrier_handoff == mbarrier_handoff;
     }
 
     std::string toString() const {
@@ -44,13 +51,15 @@ class MatmulParams : public HeuristicParams {
          << (double_buffer_smem_write ? "true" : "false") << "\n"
          << "  double_buffer_smem_read: "
          << (double_buffer_smem_read ? "true" : "false") << "\n"
-         << "  smem_double_buffer_stage: " << smem_double_buffer_stage;
+         << "  smem_double_buffer_stage: " << smem_double_buffer_stage << "\n"
+         << "  mbarrier_handoff: " << (mbarrier_handoff ? "true" : "false");
       return ss.str();
     }
 
     size_t hash() const {
       return std::hash<size_t>{}(
-                 (static_cast<size_t>(smem_double_buffer_stage) << 2) |
+                 (static_cast<size_t>(smem_double_buffer_stage) << 3) |
+                 (static_cast<size_t>(mbarrier_handoff) << 2) |
                  (static_cast<size_t>(double_buffer_smem_write)) << 1) |
           (static_cast<size_t>(double_buffer_smem_read));
     }
@@ -101,6 +110,11 @@ class MatmulParams : public HeuristicParams {
   //! axis and perform a grid reduction before the epilogue.
   int splitk_factor = 1;
 
+  //! Whether to do the split-K reduction serially, with the CTAs of each
+  //! output tile accumulating into a global work buffer one after another,
+  //! instead of with a parallel grid reduction. See [ Serial Grid Reduction ]
+  bool use_serial_splitk = false;
+
   std::string toString() const override {
     std::stringstream ss;
     ss << "\n===== Matmul Parameters ========\n"
@@ -127,13 +141,16 @@ class MatmulParams : public HeuristicParams {
        << "Promote re-use of prologue shared memory: "
        << promote_prologue_smem_reuse << "\n"
        << "Split-K factor: " << splitk_factor << "\n"
+       << "Serial split-K: " << (use_serial_splitk ? "true" : "false")
+       << "\n"
        << "====================================\n";
     return ss.str();
   }
 
   size_t hash() const override {
     // combine boolean flags for hashing
-    size_t attr_hash = (static_cast<size_t>(promote_prologue_smem_reuse) << 3) |
+    size_t attr_hash = (static_cast<size_t>(use_serial_splitk) << 4) |
+        (static_cast<size_t>(promote_prologue_smem_reuse) << 3) |
         (static_cast<size_t>(use_smem_epilogue) << 2) |
         (static_cast<size_t>(rotate_ldmatrix_out_of_main_loop) << 1) |
         (static_cast<size_t>(async_gmem_load_operands));
@@ -166,7 +183,8 @@ class MatmulParams : public HeuristicParams {
         other_casted->use_smem_epilogue == use_smem_epilogue &&
         other_casted->promote_prologue_smem_reuse ==
         promote_prologue_smem_reuse &&
-        other_casted->splitk_factor == splitk_factor;
+        other_casted->splitk_factor == splitk_factor &&
+        other_casted->use_serial_splitk == use_serial_splitk;
   }
 
   std::shared_ptr<HeuristicParams> clone() const override {
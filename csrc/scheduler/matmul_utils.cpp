@@ -5,6 +5,7 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 // clang-format on
+#include <scheduler/device_model.h>
 #include <scheduler/matmul_heuristic.h>
 #include <scheduler/matmul_utils.h>
 #include <scheduler/registry.h>
@@ -17,6 +18,7 @@
 #include <ir/interface_nodes.h>
 #include <ir/internal_nodes.h>
 #include <ir/utils.h>
+#include <iter_visitor.h>
 #include <options.h>
 #include <algorithm>
 #include <deque>
@@ -25,6 +27,7 @@
 #include <memory>
 #include <sstream>
 #include <type_traits>
+#include <unordered_set>
 #include <utility>
 #include <variant>
 #include "ATen/cuda/CUDAContext.h"
@@ -135,6 +138,58 @@ inline bool initCoreHeuristics(
   return true;
 }
 
+//! [ Serial Split-K for Skinny Matmuls ]
+//!
+//! When the output has fewer tiles than the device can run in one wave,
+//! e.g., for the small M of decode-phase GEMMs, most SMs idle while the few
+//! CTAs iterate over a long K. In that case, K is split so that the CTAs of
+//! all splits fill about one wave, while each split keeps at least
+//! kMinSplitKTiles iterations of the main loop to amortize its prologue and
+//! epilogue. The partial tiles of the splits are accumulated with a serial
+//! grid reduction, so no separate reduction of a work buffer is needed. See
+//! [ Serial Grid Reduction ]
+constexpr int64_t kMinSplitKTiles = 4;
+constexpr int64_t kMaxSplitKFactor = 16;
+
+//! Returns the split-K factor for the given tiles, or 1 if the output tiles
+//! fill at least one wave
+int getSplitKFactor(
+    const MatmulParams& params,
+    const ProblemShape& problem_shape,
+    const mma_utils::MmaDataTypes& data_types) {
+  const auto& cta_tile = params.tile_sizes.cta_tile;
+  const auto& warp_tile = params.tile_sizes.warp_tile;
+  const int64_t num_tiles =
+      ceilDiv(problem_shape[(size_t)MatmulDomain::M], cta_tile.m) *
+      ceilDiv(problem_shape[(size_t)MatmulDomain::N], cta_tile.n);
+
+  // Number of CTAs that can be resident at once, limited by the shared
+  // memory of the operands and the number of threads
+  const auto& device_model = getDeviceModel();
+  const auto [smem_a, smem_b] = mma_utils::getOperandsSharedMemorySize(
+      params.tile_sizes,
+      params.double_buffer_options.smem_double_buffer_stage,
+      data_types);
+  const int64_t threads_per_cta = (cta_tile.m / warp_tile.m) *
+      (cta_tile.n / warp_tile.n) * at::cuda::warp_size();
+  const int64_t ctas_per_sm = std::max(
+      std::min(
+          device_model.smem_per_sm /
+              (int64_t)(smem_a + smem_b),
+          device_model.max_threads_per_sm / threads_per_cta),
+      (int64_t)1);
+  const int64_t wave_size = device_model.sm_count * ctas_per_sm;
+  if (num_tiles >= wave_size) {
+    return 1;
+  }
+
+  const int64_t k_tiles =
+      ceilDiv(problem_shape[(size_t)MatmulDomain::K], cta_tile.k);
+  const int64_t factor = std::min(
+      {wave_size / num_tiles, k_tiles / kMinSplitKTiles, kMaxSplitKFactor});
+  return (int)std::max(factor, (int64_t)1);
+}
+
 //! A helper for getting problem shape from fusion and runtime info.
 ProblemShape getProblemShape(
     const mma_utils::MulSumProperties::InputsOutputs& props,
@@ -166,6 +221,56 @@ ProblemShape getProblemShape(
       m_extend.as<int64_t>(), n_extend.as<int64_t>(), k_extend.as<int64_t>()};
 }
 
+//! Checks that the operand is computed by a prologue the scheduler supports,
+//!  if any, see [ Matmul Prologue Fusion ]
+std::string getPrologueRejectReason(TensorView* operand) {
+  const auto prologue_inputs = mma_utils::getPrologueInputs(operand);
+  if (prologue_inputs.empty()) {
+    return "";
+  }
+  if (operand->dtype() != DataType::Half &&
+      operand->dtype() != DataType::BFloat16) {
+    return "Prologue doesn't compute a Half or BFloat16 operand";
+  }
+  const auto exprs = DependencyCheck::getAllExprsBetween(
+      {prologue_inputs.begin(), prologue_inputs.end()}, {operand});
+  const std::unordered_set<Expr*> prologue_exprs(exprs.begin(), exprs.end());
+  for (auto expr : exprs) {
+    auto ldst = dynamic_cast<LoadStoreOp*>(expr);
+    const bool is_pointwise =
+        expr->isOneOf<UnaryOp, BinaryOp, TernaryOp, BroadcastOp>() ||
+        (ldst != nullptr && ldst->opType() == LoadStoreOpType::Set &&
+         !ldst->out()->as<TensorView>()->hasRFactor());
+    // Gathers, e.g., of the tokens routed to the experts of an MoE layer,
+    //  read their lookup tensors from global memory
+    TensorView* lookup_tv = nullptr;
+    if (auto gather = dynamic_cast<TorchGatherOp*>(expr)) {
+      lookup_tv = gather->lookupTv();
+    } else if (auto index_select = dynamic_cast<IndexSelectOp*>(expr)) {
+      lookup_tv = index_select->lookupTv();
+    }
+    if (!is_pointwise && lookup_tv == nullptr) {
+      return "Prologue has unsupported expression: " + expr->toString();
+    }
+    if (lookup_tv != nullptr && !lookup_tv->isFusionInput()) {
+      return "Prologue gathers from an intermediate tensor";
+    }
+    for (auto tv : ir_utils::filterByType<TensorView>(expr->inputs())) {
+      // The prologue is only computed where the operand tiles are loaded
+      if (tv->isFusionOutput() ||
+          std::any_of(tv->uses().begin(), tv->uses().end(), [&](Expr* use) {
+            return prologue_exprs.count(use) == 0;
+          })) {
+        return "Prologue tensor is used outside of the prologue";
+      }
+    }
+  }
+  if (operand->isFusionOutput() || operand->uses().size() != 1) {
+    return "Prologue output is used outside of the MMA";
+  }
+  return "";
+}
+
 std::string isMatmulFusionDefinitionSupported(
     Fusion* fusion,
     const mma_utils::MulSumProperties::InputsOutputs& props) {
@@ -240,10 +345,12 @@ std::string isMatmulFusionDefinitionSupported(
       return "No candidate in fusion inputs for MMA second input";
     }
 
+    // The MMA output doesn't need to be a fusion output if it's only
+    //  consumed by epilogue reductions
     entry = roles_map.find(MatmulRole::OUTPUT_D);
     if (entry != roles_map.end()) {
       tvs_with_roles.insert(entry->second.begin(), entry->second.end());
-    } else {
+    } else if (!roles_map.count(MatmulRole::OUTPUT_REDUCTION)) {
       return "No candidate in fusion outputs MMA output";
     }
 
@@ -259,11 +366,67 @@ std::string isMatmulFusionDefinitionSupported(
       tvs_with_roles.insert(entry->second.begin(), entry->second.end());
     }
 
+    entry = roles_map.find(MatmulRole::OUTPUT_REDUCTION);
+    if (entry != roles_map.end()) {
+      tvs_with_roles.insert(entry->second.begin(), entry->second.end());
+    }
+
+    // Operands computed by prologues aren't fusion inputs, their inputs
+    //  are, see [ Matmul Prologue Fusion ]
+    entry = roles_map.find(MatmulRole::INPUT_PROLOGUE);
+    if (entry != roles_map.end()) {
+      for (auto role : {MatmulRole::INPUT_A, MatmulRole::INPUT_B}) {
+        for (auto tv : roles_map.at(role)) {
+          if (!tv->isFusionInput()) {
+            tvs_with_roles.erase(tv);
+          }
+        }
+      }
+      tvs_with_roles.insert(entry->second.begin(), entry->second.end());
+    }
+
     const auto in_out_tvs_count =
         fusion_inputs_tvs.size() + fusion_outputs_tvs.size();
     if (in_out_tvs_count != tvs_with_roles.size()) {
       return "Detected input/output TVs without assigned roles";
     }
+
+    // Epilogue reductions check, see [ Matmul Epilogue Reductions ]
+    std::unordered_set<Expr*> epilogue_reductions;
+    entry = roles_map.find(MatmulRole::OUTPUT_REDUCTION);
+    if (entry != roles_map.end()) {
+      for (auto tv : entry->second) {
+        auto rop = dynamic_cast<ReductionOp*>(tv->definition());
+        if (rop == nullptr) {
+          return "Epilogue reduction output is not defined by a ReductionOp";
+        }
+        // Normalizations consume the statistics of complete rows, which
+        //  aren't available within a CTA tile
+        if (!tv->uses().empty()) {
+          return "Epilogue reduction output has uses";
+        }
+        const auto& rfactor = tv->getMaybeRFactorDomain();
+        if (TensorDomain::noReductions(rfactor).size() + 1 != rfactor.size()) {
+          return "Epilogue reduction must only reduce N";
+        }
+        if (rop->in() != mma_output &&
+            !DependencyCheck::isDependencyOf(mma_output, rop->in())) {
+          return "Epilogue reduction doesn't consume MMA output";
+        }
+        epilogue_reductions.insert(rop);
+      }
+    }
+
+    // Besides the epilogue reductions, the only reduction can be the sum of a
+    //  mul-sum pair that will be replaced with an MmaOp
+    for (auto rop : ir_utils::getOpsOfType<ReductionOp>(fusion)) {
+      if (rop->out() != mma_output && !epilogue_reductions.count(rop)) {
+        return "Unsupported reduction in matmul fusion";
+      }
+    }
+    if (!ir_utils::getOpsOfType<WelfordOp>(fusion).empty()) {
+      return "Welford ops are not supported in matmul fusion";
+    }
   }
 
   // MmaOp inputs/outputs dependencies check
@@ -277,16 +440,25 @@ std::string isMatmulFusionDefinitionSupported(
         // BroadcastOp has single input/output, not need to check other things
         return bcast_inputs.front()->isFusionInput() ||
             (dynamic_cast<LoadStoreOp*>(bcast_inputs.front()->definition()) !=
-             nullptr);
+             nullptr) ||
+            !mma_utils::getPrologueInputs(
+                 bcast_inputs.front()->as<TensorView>())
+                 .empty();
       }
       return false;
     };
 
-    // MmaOp input is a result of broadcast op with input being fusion input
-    for (const auto* mma_in : mma_inputs) {
+    // MmaOp input is a result of broadcast op with input being fusion input,
+    //  or being computed from fusion inputs by a prologue
+    for (auto mma_in : mma_inputs) {
       if (!areMmaOpInputDependeciesValid(mma_in)) {
         return "MmaOp input has unsupported dependency";
       }
+      const auto reject_reason =
+          getPrologueRejectReason(mma_utils::getMmaOperand(mma_in));
+      if (!reject_reason.empty()) {
+        return reject_reason;
+      }
     }
   }
 
@@ -373,9 +545,9 @@ std::shared_ptr<MatmulParams> getMatmulHeuristics(
   const auto problem_shape =
       getProblemShape(mulSum.front().insouts, runtime_info);
 
-  const auto device_prop = at::cuda::getCurrentDeviceProperties();
+  const auto& device_model = getDeviceModel();
   const auto mma_op =
-      getMmaOp(device_prop->major * 10 + device_prop->minor, problem_shape);
+      getMmaOp(device_model.major * 10 + device_model.minor, problem_shape);
   NVF_ERROR(
       mma_op.has_value(), "Failed to determine a MMA op for given problem.");
 
@@ -395,11 +567,60 @@ std::shared_ptr<MatmulParams> getMatmulHeuristics(
   NVF_ERROR(roles_map_opt.isValid(), "Tensor roles map in mma is not valid.");
 
   const auto roles_map = roles_map_opt.getData();
-  std::tie(params->use_smem_epilogue, params->promote_prologue_smem_reuse) =
-      mma_utils::generateSharedMemoryEpilogueHeuristics(
-          params->tile_sizes,
-          params->double_buffer_options.smem_double_buffer_stage,
-          roles_map);
+  // See [ Matmul Prologue Fusion ]. The prologues are computed between the
+  // loads of the operands and their stores to shared memory, so the loads
+  // can't be asynchronous copies, and only two stages are supported.
+  if (roles_map.count(MatmulRole::INPUT_PROLOGUE)) {
+    params->async_gmem_load_operands = false;
+    auto& stages = params->double_buffer_options.smem_double_buffer_stage;
+    stages = std::min(stages, 2);
+  }
+  // See [ Matmul Epilogue Reductions ]. The inputs of the reductions are
+  // staged in shared memory instead of the output.
+  const bool has_epilogue_reductions =
+      roles_map.count(MatmulRole::OUTPUT_REDUCTION) != 0;
+  if (!has_epilogue_reductions) {
+    std::tie(params->use_smem_epilogue, params->promote_prologue_smem_reuse) =
+        mma_utils::generateSharedMemoryEpilogueHeuristics(
+            params->tile_sizes,
+            params->double_buffer_options.smem_double_buffer_stage,
+            roles_map);
+  } else if (params->double_buffer_options.double_buffer_smem_write) {
+    // Make room for the staged tiles with fewer stages if needed
+    const auto shared_memory_available =
+        device_model.smem_per_block -
+        device_model.reserved_smem_per_block;
+    const size_t smem_reduction =
+        mma_utils::getEpilogueReductionSharedMemorySize(
+            params->tile_sizes, roles_map);
+    auto& stages = params->double_buffer_options.smem_double_buffer_stage;
+    while (stages > 2) {
+      const auto [smem_a, smem_b] = mma_utils::getOperandsSharedMemorySize(
+          params->tile_sizes, stages, mma_utils::getMmaDataTypes(roles_map));
+      if (smem_a + smem_b + smem_reduction <= shared_memory_available) {
+        break;
+      }
+      stages--;
+    }
+  }
+
+  // See [ Serial Split-K for Skinny Matmuls ]. Batch dimensions are
+  // parallelized the same way as split-K, so both can't be used together.
+  // Epilogue reductions don't support split-K either.
+  if (!has_epilogue_reductions) {
+    const bool has_batch_dims = std::any_of(
+        roles_map.at(MatmulRole::OUTPUT_D).begin(),
+        roles_map.at(MatmulRole::OUTPUT_D).end(),
+        [](TensorView* tv) {
+          return TensorDomain::noReductions(tv->getMaybeRFactorDomain())
+                     .size() > 2;
+        });
+    if (!has_batch_dims) {
+      params->splitk_factor = getSplitKFactor(
+          *params, problem_shape, mma_utils::getMmaDataTypes(roles_map));
+      params->use_serial_splitk = params->splitk_factor > 1;
+    }
+  }
 
   if (isDebugDumpEnabled(DebugDumpOption::SchedulerDebug)) {
     debug() << params->toString() << std::endl;
@@ -408,4 +629,75 @@ std::shared_ptr<MatmulParams> getMatmulHeuristics(
   return params;
 }
 
+std::string getMatmulProblemKey(
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info) {
+  FusionGuard fg(fusion);
+  mma_utils::CombineMulSum combiner(fusion);
+  NVF_ERROR(
+      combiner.isValid(),
+      "There's no (single) mma op or mul-sum op which mma op can replace");
+  const auto& insouts = combiner.getMulSumCanidates().front().insouts;
+
+  const auto problem_shape = getProblemShape(insouts, runtime_info);
+  const auto layout_opt = mma_utils::getMmaLayout(fusion, insouts);
+  NVF_ERROR(layout_opt.isValid(), layout_opt.getErrorMsg());
+  const auto roles_map_opt = mma_utils::getTensorsRoles(fusion, insouts);
+  NVF_ERROR(roles_map_opt.isValid(), "Tensor roles map in mma is not valid.");
+  const auto data_types = mma_utils::getMmaDataTypes(roles_map_opt.getData());
+
+  std::stringstream ss;
+  ss << problem_shape[(size_t)MatmulDomain::M] << " "
+     << problem_shape[(size_t)MatmulDomain::N] << " "
+     << problem_shape[(size_t)MatmulDomain::K] << " "
+     << toString(layout_opt.getData());
+  for (const auto& data_type : data_types) {
+    ss << " " << data_type;
+  }
+  // Epilogue reductions restrict the tunable parameters
+  if (roles_map_opt.getData().count(MatmulRole::OUTPUT_REDUCTION)) {
+    ss << " epilogue_reduction";
+  }
+  return ss.str();
+}
+
+bool updateMatmulSharedMemoryParams(Fusion* fusion, MatmulParams& params) {
+  FusionGuard fg(fusion);
+  const auto roles_map_opt = mma_utils::getTensorsRoles(fusion);
+  NVF_ERROR(roles_map_opt.isValid(), "Tensor roles map in mma is not valid.");
+  const auto& roles_map = roles_map_opt.getData();
+
+  const auto& device_model = getDeviceModel();
+  const auto shared_memory_available = device_model.smem_per_block -
+      device_model.reserved_smem_per_block;
+  const auto [smem_a, smem_b] = mma_utils::getOperandsSharedMemorySize(
+      params.tile_sizes,
+      params.double_buffer_options.smem_double_buffer_stage,
+      mma_utils::getMmaDataTypes(roles_map));
+  if (smem_a + smem_b > shared_memory_available) {
+    return false;
+  }
+
+  // See [ Matmul Epilogue Reductions ]
+  const size_t smem_reduction =
+      mma_utils::getEpilogueReductionSharedMemorySize(
+          params.tile_sizes, roles_map);
+  if (smem_reduction != 0) {
+    if (params.grid_swizzle_factor != 1 || params.splitk_factor != 1 ||
+        smem_a + smem_b + smem_reduction > shared_memory_available) {
+      return false;
+    }
+    params.use_smem_epilogue = false;
+    params.promote_prologue_smem_reuse = false;
+    return true;
+  }
+
+  std::tie(params.use_smem_epilogue, params.promote_prologue_smem_reuse) =
+      mma_utils::generateSharedMemoryEpilogueHeuristics(
+          params.tile_sizes,
+          params.double_buffer_options.smem_double_buffer_stage,
+          roles_map);
+  return true;
+}
+
 } // namespace nvfuser
@@ -35,4 +35,16 @@ std::string getMatmulRunTimeRejectReason(
     HeuristicSummary* data_cache,
     SchedulerRuntimeInfo& runtime_info);
 
+//! Describes the matmul in the fusion by M, N, K, the layout and the data
+//!  types of the operands and the output. Used to key tuned parameters, see
+//!  [ Autotuning of Matmul Heuristics ].
+std::string getMatmulProblemKey(
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info);
+
+//! Re-derives the parameters that depend on the tile sizes and the number of
+//!  stages, i.e., whether to use a shared memory epilogue. Returns false if
+//!  the operand tiles don't fit in shared memory.
+bool updateMatmulSharedMemoryParams(Fusion* fusion, MatmulParams& params);
+
 } // namespace nvfuser
@@ -10,9 +10,12 @@
 #include <device_lower/utils.h>
 #include <expr_evaluator.h>
 #include <ir/printer.h>
+#include <iter_visitor.h>
 #include <root_domain_map.h>
+#include <scheduler/device_model.h>
 #include <scheduler/mma_utils.h>
 #include <scheduler/utils.h>
+#include <unordered_set>
 #include <variant>
 #include "mma_type.h"
 namespace nvfuser {
@@ -21,7 +24,7 @@ namespace mma_utils {
 
 //! A wrapper to get MMA Tensor data types
 //!   The order of returned types: INPUT_A, INPUT_B, OUTPUT_D
-inline mma_utils::MmaDataTypes getMmaDataTypes(
+mma_utils::MmaDataTypes getMmaDataTypes(
     const std::map<MatmulRole, std::vector<TensorView*>>& roles_map) {
   auto getMMADataType = [&](MatmulRole role) {
     auto entry = roles_map.find(role);
@@ -32,31 +35,23 @@ inline mma_utils::MmaDataTypes getMmaDataTypes(
   };
   const auto a_type = getMMADataType(MatmulRole::INPUT_A);
   const auto b_type = getMMADataType(MatmulRole::INPUT_B);
-  const auto c_type = getMMADataType(MatmulRole::OUTPUT_D);
+  const auto c_type = getMMADataType(
+      roles_map.count(MatmulRole::OUTPUT_D) ? MatmulRole::OUTPUT_D
+                                            : MatmulRole::OUTPUT_REDUCTION);
   return mma_utils::MmaDataTypes{a_type, b_type, c_type};
 }
 
-std::pair<bool, bool> generateSharedMemoryEpilogueHeuristics(
+std::pair<size_t, size_t> getOperandsSharedMemorySize(
     const MatMulTileOptions& gemm_tile,
     const int smem_double_buffer_stage,
-    const MmaDataTypes& data_types,
-    bool smem_a_reuse_guaranteed,
-    bool smem_b_reuse_guaranteed,
-    bool ignore_occupancy_drop) {
-  const auto properties = at::cuda::getCurrentDeviceProperties();
-  const size_t device_smem_limit = properties->sharedMemPerBlockOptin;
-  const size_t shared_memory_overhead = properties->reservedSharedMemPerBlock;
-  const size_t shared_memory_available =
-      device_smem_limit - shared_memory_overhead;
-
+    const MmaDataTypes& data_types) {
+  const auto& device_model = getDeviceModel();
   auto warp_dims = gemm_tile.cta_tile / gemm_tile.warp_tile;
-  const auto threads_per_block =
-      warp_dims.m * warp_dims.n * warp_dims.k * properties->warpSize;
 
   // see scheduleContiguousVectorLoad
   const int vector_word = 8;
   const int round_to_factor = warp_dims.m * warp_dims.n * warp_dims.k *
-      properties->warpSize * vector_word;
+      device_model.warp_size * vector_word;
   const int mk = gemm_tile.cta_tile.m * gemm_tile.cta_tile.k;
   const int nk = gemm_tile.cta_tile.n * gemm_tile.cta_tile.k;
   const size_t smem_a = (size_t)(ceilDiv(mk, round_to_factor) *
@@ -65,6 +60,48 @@ std::pair<bool, bool> generateSharedMemoryEpilogueHeuristics(
   const size_t smem_b = (size_t)(ceilDiv(nk, round_to_factor) *
                                  round_to_factor * smem_double_buffer_stage) *
       dataTypeSize(data_types[1]);
+  return {smem_a, smem_b};
+}
+
+size_t getEpilogueReductionSharedMemorySize(
+    const MatMulTileOptions& gemm_tile,
+    const RolesMap& roles_map) {
+  auto entry = roles_map.find(MatmulRole::OUTPUT_REDUCTION);
+  if (entry == roles_map.end()) {
+    return 0;
+  }
+  // Reductions of the same tensor share its staged tile
+  std::unordered_set<Val*> reduction_inputs;
+  size_t smem_size = 0;
+  for (auto tv : entry->second) {
+    auto in = tv->definition()->as<ReductionOp>()->in();
+    if (reduction_inputs.insert(in).second) {
+      smem_size += (size_t)(gemm_tile.cta_tile.m * gemm_tile.cta_tile.n) *
+          dataTypeSize(in->dtype());
+    }
+  }
+  return smem_size;
+}
+
+std::pair<bool, bool> generateSharedMemoryEpilogueHeuristics(
+    const MatMulTileOptions& gemm_tile,
+    const int smem_double_buffer_stage,
+    const MmaDataTypes& data_types,
+    bool smem_a_reuse_guaranteed,
+    bool smem_b_reuse_guaranteed,
+    bool ignore_occupancy_drop) {
+  const auto& device_model = getDeviceModel();
+  const size_t device_smem_limit = device_model.smem_per_block;
+  const size_t shared_memory_overhead = device_model.reserved_smem_per_block;
+  const size_t shared_memory_available =
+      device_smem_limit - shared_memory_overhead;
+
+  auto warp_dims = gemm_tile.cta_tile / gemm_tile.warp_tile;
+  const auto threads_per_block =
+      warp_dims.m * warp_dims.n * warp_dims.k * device_model.warp_size;
+
+  const auto [smem_a, smem_b] = getOperandsSharedMemorySize(
+      gemm_tile, smem_double_buffer_stage, data_types);
   const size_t smem_c = (size_t)(gemm_tile.cta_tile.m * gemm_tile.cta_tile.n) *
       dataTypeSize(data_types[2]);
 
@@ -1045,12 +1082,55 @@ ProblemIterDomainsOpt getProblemIterDomains(Fusion* fusion) {
        static_cast<TensorView*>(mma_exprs.front()->out())});
 }
 
+TensorView* getMmaOperand(TensorView* mma_input) {
+  auto bcast = dynamic_cast<BroadcastOp*>(mma_input->definition());
+  return bcast == nullptr ? nullptr : bcast->in()->as<TensorView>();
+}
+
+std::vector<TensorView*> getPrologueInputs(TensorView* operand) {
+  // Transposes of fusion inputs are loaded with ldmatrix.trans instead
+  if (operand->isFusionInput() || operand->definition()->isA<LoadStoreOp>()) {
+    return {};
+  }
+  return ir_utils::filterByType<TensorView>(InputsOf::output(operand))
+      .vector();
+}
+
+namespace {
+
+//! Returns the fusion inputs that can be MMA inputs, where the inputs of the
+//!  prologues are replaced with the operands they compute
+std::vector<TensorView*> getMmaInputCandidates(
+    Fusion* fusion,
+    const mma_utils::MulSumProperties::InputsOutputs& props) {
+  std::vector<TensorView*> candidates;
+  std::unordered_set<TensorView*> prologue_inputs;
+  for (auto mma_input : {props.a, props.b}) {
+    TensorView* operand = getMmaOperand(mma_input);
+    if (operand == nullptr) {
+      continue;
+    }
+    const auto inputs = getPrologueInputs(operand);
+    if (!inputs.empty()) {
+      candidates.push_back(operand);
+      prologue_inputs.insert(inputs.begin(), inputs.end());
+    }
+  }
+  for (auto tv : ir_utils::filterByType<TensorView>(fusion->inputs())) {
+    if (prologue_inputs.count(tv) == 0) {
+      candidates.push_back(tv);
+    }
+  }
+  return candidates;
+}
+
+} // namespace
+
 MatmulProblemLayoutOpt getMmaLayout(
     Fusion* fusion,
     const mma_utils::MulSumProperties::InputsOutputs& props) {
   ComputeAtMap ca_map(fusion);
-  const auto mma_input_candidates =
-      ir_utils::filterByType<TensorView>(fusion->inputs()).vector();
+  const auto mma_input_candidates = getMmaInputCandidates(fusion, props);
   if (mma_input_candidates.empty()) {
     return {"Failed to find any TV that is fusion input"};
   }
@@ -1144,8 +1224,7 @@ RolesMapOpt getTensorsRoles(
     Fusion* fusion,
     const mma_utils::MulSumProperties::InputsOutputs& props) {
   ComputeAtMap ca_map(fusion);
-  const auto mma_input_candidates =
-      ir_utils::filterByType<TensorView>(fusion->inputs()).vector();
+  const auto mma_input_candidates = getMmaInputCandidates(fusion, props);
   if (mma_input_candidates.empty()) {
     return {"Failed to find any TV that is fusion input"};
   }
@@ -1260,11 +1339,43 @@ RolesMapOpt getTensorsRoles(
       deps_map, mma_input_candidates, m, n, k, ca_map);
   findInputRolesByDomains(deps_map, roles_map);
 
+  // The fusion inputs of the prologues, see [ Matmul Prologue Fusion ]
+  std::vector<TensorView*> prologue_inputs;
+  for (auto mma_input : {props.a, props.b}) {
+    TensorView* operand = getMmaOperand(mma_input);
+    if (operand == nullptr) {
+      continue;
+    }
+    for (auto tv : getPrologueInputs(operand)) {
+      if (std::find(prologue_inputs.begin(), prologue_inputs.end(), tv) ==
+          prologue_inputs.end()) {
+        prologue_inputs.push_back(tv);
+      }
+    }
+  }
+  if (!prologue_inputs.empty()) {
+    roles_map[MatmulRole::INPUT_PROLOGUE] = prologue_inputs;
+  }
+
   deps_map.clear();
 
-  // Handle fusion output TensorView objects
+  // Handle fusion output TensorView objects. Outputs that are reduced along
+  //  N are the results of epilogue reductions, the remaining ones are
+  //  classified by their domains.
+  std::vector<TensorView*> output_candidates;
+  for (auto tv : mma_output_candidates) {
+    const auto& leaf = tv->getLeafDomain();
+    if (std::any_of(leaf.begin(), leaf.end(), [&](IterDomain* id) {
+          return id->isReduction() &&
+              ca_map.areMapped(n, id, IdMappingMode::EXACT);
+        })) {
+      roles_map[MatmulRole::OUTPUT_REDUCTION].push_back(tv);
+    } else {
+      output_candidates.push_back(tv);
+    }
+  }
   resolveTvToMatmulDomainsMapping(
-      deps_map, mma_output_candidates, m, n, k, ca_map);
+      deps_map, output_candidates, m, n, k, ca_map);
   findOutputRolesByDomains(deps_map, roles_map);
 
   return roles_map;
@@ -308,14 +308,42 @@ ProblemIterDomainsOpt getProblemIterDomains(Fusion* fusion);
 ProblemIterDomainsOpt getProblemIterDomains(
     const mma_utils::MulSumProperties::InputsOutputs& props);
 
+//! Returns the tensor that is broadcast into the MMA input mma_input, or
+//!  nullptr if mma_input isn't defined by a BroadcastOp
+TensorView* getMmaOperand(TensorView* mma_input);
+
+//! Returns the fusion inputs of the pointwise ops computing the operand, or
+//!  an empty vector if the operand is loaded from a fusion input as it is,
+//!  see [ Matmul Prologue Fusion ]
+std::vector<TensorView*> getPrologueInputs(TensorView* operand);
+
 //! Returns wrapped collection of TensorView roles in fusion.
 //!  An error message is stored in retruned object if valid data cannot
-//!  be gathered.
+//!  be gathered. Operands computed by prologues take the INPUT_A and INPUT_B
+//!  roles instead of the fusion inputs they are computed from.
 RolesMapOpt getTensorsRoles(
     Fusion* fusion,
     const mma_utils::MulSumProperties::InputsOutputs& props);
 RolesMapOpt getTensorsRoles(Fusion* fusion);
 
+//! Returns the data types of the operands and the output, in the order
+//!  INPUT_A, INPUT_B, OUTPUT_D. Without an OUTPUT_D, the output data type is
+//!  the one of the first OUTPUT_REDUCTION.
+MmaDataTypes getMmaDataTypes(const RolesMap& roles_map);
+
+//! Returns the shared memory in bytes used by the tiles of operands A and B
+//!  for the given tile sizes and number of stages
+std::pair<size_t, size_t> getOperandsSharedMemorySize(
+    const MatMulTileOptions& gemm_tile,
+    const int smem_double_buffer_stage,
+    const MmaDataTypes& data_types);
+
+//! Returns the shared memory in bytes used to stage the inputs of the
+//!  OUTPUT_REDUCTION tensors, see [ Matmul Epilogue Reductions ]
+size_t getEpilogueReductionSharedMemorySize(
+    const MatMulTileOptions& gemm_tile,
+    const RolesMap& roles_map);
+
 //! Return pair of whether use shared memory epilogue or not and whether to
 //!  reuse shared memory for the prologue at the expense of an additional block
 //!  sync.
@@ -101,6 +101,15 @@ bool NoOpScheduler::canScheduleRunTime(
   return true;
 }
 
+// [ Host-Only Segments ]
+//
+// A segment that only reshapes, squeezes, permutes, slices or expands its
+// inputs, e.g., at the boundary between two reductions, is accepted here when
+// alias analysis finds all of its outputs to be views of its inputs. Its
+// outputs are then marked as pointer-arithmetic aliases, so lowering generates
+// no code for them and FusionExecutor evaluates them as at::Tensor views on
+// the host. As the kernel has no expressions, it is not launched, and no
+// output or intermediate buffer is allocated for the segment.
 void NoOpScheduler::schedule(Fusion* fusion) {
   markAliases(fusion);
 }
@@ -7,6 +7,7 @@
 // clang-format on
 #include <instrumentation.h>
 #include <scheduler/debug_utils.h>
+#include <scheduler/device_model.h>
 #include <scheduler/normalization_inner.h>
 #include <scheduler/normalization_utils.h>
 #include <scheduler/reduction_utils.h>
@@ -37,11 +38,28 @@ bool InnerPersistentKernelScheduler::canScheduleCompileTime(Fusion* fusion) {
 
 namespace {
 
+// Shared memory available for the persistent buffers of a block
+int64_t availableSharedMemorySize(int64_t max_buffer_dtype_size) {
+  const auto& device_model = getDeviceModel();
+  const int64_t max_shared_memory_size = device_model.smem_per_block;
+  // Some shared memories are reserved for kernel launch overhead and
+  // reduction_broadcast_workspace. Estimation is conservative, but should
+  // be good enough. The actual threads per block is set in the heuristics
+  // and it may be smaller than maxThreadsPerBlock.
+  // TODO: More accurate estimation of available shared memory size.
+  const int64_t kernel_overhead = device_model.reserved_smem_per_block;
+  const int64_t reduction_broadcast_workspace =
+      device_model.max_threads_per_block * max_buffer_dtype_size;
+  return max_shared_memory_size - kernel_overhead -
+      reduction_broadcast_workspace;
+}
+
 std::pair<int64_t, int64_t> getPersistentBufferSize(
     Fusion* fusion,
     SchedulerRuntimeInfo& runtime_info,
     HeuristicSummary* data_cache,
-    const std::vector<TensorView*>& reduction_tvs) {
+    const std::vector<TensorView*>& reduction_tvs,
+    int64_t total_reduction_numel) {
   auto persistent_buffer_info_entry =
       HeuristicSummaryEntry<HeuristicCompileTime::PersistentBufferInfo>(
           data_cache, [&fusion]() {
@@ -55,40 +73,43 @@ std::pair<int64_t, int64_t> getPersistentBufferSize(
       fusion, runtime_info, persistent_buffer_info, data_cache);
 
   // Note that projected buffer size can be zero
-  auto persistent_buffer_size =
-      persistent_buffer_size_info.projected_persistent_buffer_size == 0
-      ? persistent_buffer_size_info.persistent_buffer_size
-      : std::min(
-            persistent_buffer_size_info.persistent_buffer_size,
-            persistent_buffer_size_info.projected_persistent_buffer_size);
+  const bool project_to_inputs =
+      persistent_buffer_size_info.projected_persistent_buffer_size != 0 &&
+      persistent_buffer_size_info.projected_persistent_buffer_size <
+          persistent_buffer_size_info.persistent_buffer_size;
+  auto persistent_buffer_size = project_to_inputs
+      ? persistent_buffer_size_info.projected_persistent_buffer_size
+      : persistent_buffer_size_info.persistent_buffer_size;
 
   // Init to register file size, which is half of the full register file size
   int64_t available_persistent_buffer_size =
       scheduler_utils::register_file_size;
 
   // Check available shared memory
-  const auto dev_prop = at::cuda::getCurrentDeviceProperties();
-  const int64_t max_shared_memory_size =
-      (int64_t)dev_prop->sharedMemPerBlockOptin;
-  // Some shared memories are reserved for kernel launch overhead and
-  // reduction_broadcast_workspace. Estimation is conservative, but should
-  // be good enough. The actual threads per block is set in the heuristics
-  // and it may be smaller than maxThreadsPerBlock.
-  // TODO: More accurate estimation of available shared memory size.
-  const int64_t kernel_overhead = (int64_t)dev_prop->reservedSharedMemPerBlock;
   int64_t max_buffer_dtype_size = 1;
   for (auto tv : persistent_buffer_info.persistent_buffers) {
     max_buffer_dtype_size = std::max(
         max_buffer_dtype_size,
         dataTypeSize(tv->getDataType().value(), runtime_info.getIndexType()));
   }
-  const int64_t reduction_broadcast_workspace =
-      (int64_t)(dev_prop->maxThreadsPerBlock) * max_buffer_dtype_size;
   const int64_t available_shared_memory_size =
-      max_shared_memory_size - kernel_overhead - reduction_broadcast_workspace;
+      availableSharedMemorySize(max_buffer_dtype_size);
   available_persistent_buffer_size =
       std::max(available_persistent_buffer_size, available_shared_memory_size);
 
+  // Buffers that exceed both can still be split between them, see
+  // [ Hybrid Persistent Buffers ]
+  if (persistent_buffer_size > available_persistent_buffer_size &&
+      normalization_scheduler_utils::hybridRegisterBufferBytes(
+          normalization_scheduler_utils::persistentBufferElementBytes(
+              persistent_buffer_info,
+              project_to_inputs,
+              runtime_info.getIndexType()),
+          total_reduction_numel,
+          available_shared_memory_size) > 0) {
+    available_persistent_buffer_size = persistent_buffer_size;
+  }
+
   return std::make_pair(
       persistent_buffer_size, available_persistent_buffer_size);
 }
@@ -114,16 +135,20 @@ bool InnerPersistentKernelScheduler::canScheduleRunTime(
   auto properties = scheduler_utils::getReductionProperties(
       fusion, runtime_info, reference_tv);
 
-  const int64_t warp_size = at::cuda::getCurrentDeviceProperties()->warpSize;
+  const int64_t warp_size = getDeviceModel().warp_size;
 
   // pair of persistent_buffer_size and available_persistent_buffer_size
   const std::pair<int64_t, int64_t> buffer_size =
-      getPersistentBufferSize(fusion, runtime_info, data_cache, reduction_tvs);
+      getPersistentBufferSize(
+          fusion,
+          runtime_info,
+          data_cache,
+          reduction_tvs,
+          properties.total_reduction_numel);
   const int64_t persistent_buffer_size = buffer_size.first;
   const int64_t available_persistent_buffer_size = buffer_size.second;
 
-  const int64_t device_multiprocessor_count =
-      (int64_t)at::cuda::getCurrentDeviceProperties()->multiProcessorCount;
+  const int64_t device_multiprocessor_count = getDeviceModel().sm_count;
 
   if (persistent_buffer_size > available_persistent_buffer_size) {
     scheduler_debug_utils::canScheduleRejectReason(
@@ -133,8 +158,7 @@ bool InnerPersistentKernelScheduler::canScheduleRunTime(
   }
 
   const int64_t device_max_threads_per_multiprocessor =
-      (int64_t)at::cuda::getCurrentDeviceProperties()
-          ->maxThreadsPerMultiProcessor;
+      getDeviceModel().max_threads_per_sm;
 
   const int64_t required_sm_per_norm =
       ceilDiv(persistent_buffer_size, scheduler_utils::register_file_size);
@@ -187,7 +211,7 @@ std::shared_ptr<ReductionParams> innerPersistentHeuristicSharedMemory(
     const size_t max_vectorize_factor,
     const bool project_to_input,
     const PrimDataType index_type) {
-  const auto dev_prop = at::cuda::getCurrentDeviceProperties();
+  const auto& device_model = getDeviceModel();
   auto rparams = std::make_shared<ReductionParams>();
   rparams->shared_mem_persistent_buffer = true;
   rparams->persistent_kernel = true;
@@ -199,7 +223,7 @@ std::shared_ptr<ReductionParams> innerPersistentHeuristicSharedMemory(
   // e.g. layer_norm with hidden size larger than 64K for fp16 or 32K for fp32.
   // fully vectorized, use maxThreadsPerBlock to reduce workload per threads
   int64_t vectorize_factor = (int64_t)max_vectorize_factor;
-  int64_t bdimx = dev_prop->maxThreadsPerBlock;
+  int64_t bdimx = device_model.max_threads_per_block;
   NVF_ERROR(
       total_reduction_numel >= vectorize_factor * bdimx,
       "total_reduction_numel should be larger than or equal to vectorize_factor * bdimx.\n",
@@ -248,6 +272,101 @@ std::shared_ptr<ReductionParams> innerPersistentHeuristicSharedMemory(
 
   return rparams;
 }
+// [ Small Group Persistence ]
+//
+// Block-wise quantization reduces small groups of a row, e.g., the absmax of
+// 128 elements, which then scales and casts the elements of the group:
+//   [rows, K] -> reshape [rows, K / 128, 128] -> amax, div, cast
+// The generic heuristic pads such a group to a warp or reduces it through
+// shared memory. Instead, each group is held by a segment of bdimx lanes of a
+// warp, a power of two smaller than a warp, which hold vectorize_factor
+// elements each in registers, so the group is read and written with a
+// vectorized access per lane. The groups of a block are along TIDy, and the
+// reduction is lowered to shuffles within the segments, see
+// [ Warp Segment Reduction ]. That needs TIDx to be a constant, i.e., the
+// group size must be a constant, as it is after a reshape. Otherwise, the
+// same schedule reduces a group through shared memory.
+constexpr int64_t kSmallGroupThreadsPerBlock = 256;
+
+//! Lanes of a small group, or 0 if the inner reduction isn't a small group,
+//! see [ Small Group Persistence ]
+int64_t smallGroupLanes(
+    const int64_t total_reduction_numel,
+    const int64_t inner_most_dimension_numel,
+    const int64_t vectorize_factor) {
+  if (total_reduction_numel != inner_most_dimension_numel ||
+      inner_most_dimension_numel % vectorize_factor != 0) {
+    return 0;
+  }
+  const int64_t lanes = inner_most_dimension_numel / vectorize_factor;
+  if (lanes < 2 || lanes >= (int64_t)at::cuda::warp_size() ||
+      scheduler_utils::lastPow2(lanes) != lanes) {
+    return 0;
+  }
+  return lanes;
+}
+
+std::shared_ptr<ReductionParams> innerPersistentHeuristicSmallGroup(
+    const int64_t total_iteration_numel,
+    const int64_t inner_most_dimension_numel,
+    const int64_t lanes,
+    const int64_t vectorize_factor,
+    const bool project_to_input,
+    const PrimDataType index_type) {
+  auto rparams = std::make_shared<ReductionParams>();
+  rparams->persistent_kernel = true;
+  rparams->fastest_dim = true;
+  rparams->project_persistent_buffers = project_to_input;
+  rparams->cparams.index_type = index_type;
+  rparams->cparams.enable_warp_segment_reduction = true;
+
+  // Inner reduction domain, a warp segment of lanes with a vector each
+  rparams->cross_block_inner_reduction = true;
+  rparams->block_dim_inner_reduction = ParallelType::TIDx;
+  rparams->batches_per_block_inner_reduction = 1;
+  rparams->unroll_factor_inner_reduction = vectorize_factor;
+  rparams->vectorize_inner_reduction = vectorize_factor > 1;
+
+  // Iter domain, groups along TIDy
+  const int64_t bdimy =
+      std::min(kSmallGroupThreadsPerBlock / lanes, total_iteration_numel);
+  const int64_t godim = ceilDiv(total_iteration_numel, bdimy);
+  int64_t gdimx = LaunchParams::UNINITIALIZED_VAL;
+  rparams->multiple_reds_per_blk = bdimy > 1;
+  if (rparams->multiple_reds_per_blk) {
+    rparams->block_dim_iter_dom = ParallelType::TIDy;
+  }
+  if (godim > 1) {
+    rparams->grid_dim_iter_dom = ParallelType::BIDx;
+    if (godim > scheduler_utils::x_grid_limit) {
+      rparams->split_grid_dim_iter_dom_outer = true;
+      gdimx = scheduler_utils::x_grid_limit;
+    }
+  }
+
+  rparams->lparams = LaunchParams(
+      gdimx,
+      LaunchParams::UNINITIALIZED_VAL,
+      LaunchParams::UNINITIALIZED_VAL,
+      LaunchParams::UNINITIALIZED_VAL,
+      bdimy,
+      LaunchParams::UNINITIALIZED_VAL);
+
+  rparams->tag = "Inner Small Group Persistent Heuristic.\n";
+
+  if (isDebugDumpEnabled(DebugDumpOption::SchedulerDebug)) {
+    debug() << "\n===== Reduction Stats ========\n"
+            << "total_iteration_numel: " << total_iteration_numel << "\n"
+            << "inner_most_dimension_numel: " << inner_most_dimension_numel
+            << "\n"
+            << "vectorize_factor: " << vectorize_factor << "\n"
+            << "block(" << lanes << ", " << bdimy << ", 1)";
+    debug() << rparams->toString() << std::endl;
+  }
+
+  return rparams;
+}
+
 std::shared_ptr<ReductionParams> innerPersistentHeuristic(
     const int64_t total_reduction_numel,
     const int64_t total_iteration_numel,
@@ -272,20 +391,32 @@ std::shared_ptr<ReductionParams> innerPersistentHeuristic(
         index_type);
   }
 
+  if (const int64_t lanes = smallGroupLanes(
+          total_reduction_numel,
+          inner_most_dimension_numel,
+          (int64_t)vectorize_factor)) {
+    return innerPersistentHeuristicSmallGroup(
+        total_iteration_numel,
+        inner_most_dimension_numel,
+        lanes,
+        (int64_t)vectorize_factor,
+        project_to_input,
+        index_type);
+  }
+
   // Set some targets for parallelization
   const int64_t n_elems = total_reduction_numel * total_iteration_numel;
 
   const int64_t outer_reduction_numel =
       total_reduction_numel / inner_most_dimension_numel;
 
-  const auto dev_prop = at::cuda::getCurrentDeviceProperties();
+  const auto& device_model = getDeviceModel();
   // WARNING: At some point we may want to generate heuristics for another
   // device that is not the current device.
   const int64_t device_max_threads_per_multiprocessor =
-      (int64_t)dev_prop->maxThreadsPerMultiProcessor;
+      device_model.max_threads_per_sm;
 
-  const int64_t device_multiprocessor_count =
-      (int64_t)dev_prop->multiProcessorCount;
+  const int64_t device_multiprocessor_count = device_model.sm_count;
 
   auto const max_unroll = ceilDiv(
       // Available unrolling based on size of data type
@@ -293,17 +424,15 @@ std::shared_ptr<ReductionParams> innerPersistentHeuristic(
       // Reduce unrolling if we have many inputs, start reduction at 4 inputs
       scheduler_utils::lastPow2(std::max(n_tensor_inputs >> 2, 1l)));
 
-  // Conservative value, could be set to larger based on arch if necessary.
-  constexpr int64_t l1_cache = 32l * 1024l;
-  // Could change per generation, but for l1 we want to consider active threads,
-  // not resident
-  constexpr int64_t active_threads = 1024;
+  // For l1 we want to consider active threads, not resident
+  const int64_t l1_cache = getDeviceModel().l1_size;
+  const int64_t active_threads = getDeviceModel().active_threads_per_sm;
 
   // if data fits in l2 and we need more parallelization in the reduction dim,
   // we can use a smaller warp size. While thread local data fits in l1, and
   // reduction dim is really small, we can use <32 threads per warp.
   const bool fits_in_l2 =
-      n_elems * max_input_dtype_size * n_tensor_inputs < dev_prop->l2CacheSize;
+      n_elems * max_input_dtype_size * n_tensor_inputs < device_model.l2_size;
 
   // If it fits in l2, we just want to make sure each warp uses 32Bytes. Set
   // minimum warp as 16 threads instead of 32 as if we have a small reduction
@@ -391,7 +520,7 @@ std::shared_ptr<ReductionParams> innerPersistentHeuristic(
       // reductions
       max_threads_in_block = std::min(
           ceilDiv(n_elems, target_blocks * target_unroll),
-          (int64_t)dev_prop->maxThreadsPerBlock);
+          device_model.max_threads_per_block);
     } else {
       // targetting 4 waves, so try to use a quarter of available threads
       max_threads_in_block = std::min(
@@ -404,7 +533,7 @@ std::shared_ptr<ReductionParams> innerPersistentHeuristic(
   if (max_threads_in_block % warp_size != 0) {
     max_threads_in_block += warp_size - max_threads_in_block % warp_size;
     max_threads_in_block =
-        std::min(max_threads_in_block, (int64_t)dev_prop->maxThreadsPerBlock);
+        std::min(max_threads_in_block, device_model.max_threads_per_block);
   }
   // Compute maximum number of reductions we could do in the same kernel based
   // on persistent buffer size. Bounded by the wave count for utilization of
@@ -491,7 +620,7 @@ std::shared_ptr<ReductionParams> innerPersistentHeuristic(
   // (2) Two warps, so we can achieve 100% occupancy since most GPUs allow 32
   //     blocks per SM.
   // (3) Four warps, number recommended by the cuda-c-best-practices-guide.
-  const int64_t min_threads_per_block = 4l * dev_prop->warpSize;
+  const int64_t min_threads_per_block = 4l * device_model.warp_size;
 
   // start bdimx with min_threads_per_block then increase if we have too many
   // persistent buffer batches per block
@@ -623,7 +752,7 @@ std::shared_ptr<ReductionParams> innerPersistentHeuristic(
       : bdimx + (device_warp_size - bdimx % device_warp_size);
 
   bool pad_bdimx = bdimx > 16 &&
-      padded_bdimx * bdimy * bdimz < (int64_t)dev_prop->maxThreadsPerBlock;
+      padded_bdimx * bdimy * bdimz < device_model.max_threads_per_block;
 
   // estimate register usage and occupancy raito.
   // If occupancy raito is less than a preset occupancy_ratio, reduce register
@@ -687,7 +816,7 @@ std::shared_ptr<ReductionParams> innerPersistentHeuristic(
     constexpr double occupancy_ratio = 0.4;
     const int64_t blocks_per_sm_wanted = ceilDiv(
         static_cast<int64_t>(
-            dev_prop->maxThreadsPerMultiProcessor * occupancy_ratio),
+            device_model.max_threads_per_sm * occupancy_ratio),
         threads_per_block);
 
     // if estimated blocks is smaller than wanted and decrease register usage
@@ -761,6 +890,34 @@ std::shared_ptr<ReductionParams> innerPersistentHeuristic(
     rparams->unroll_factor_outer_reduction = outer_reduction_unroll_factor;
   }
 
+  // See [ Circular Buffered Global Loads ]. Each block loops over its rows,
+  // which needs a serial loop that isn't unswitched, i.e., the iteration
+  // domain must not be unrolled.
+  if (godim > 1 && iter_unroll_factor == 1 &&
+      !rparams->split_grid_dim_iter_dom_outer) {
+    const int64_t threads_per_block =
+        (pad_bdimx ? padded_bdimx : bdimx) * bdimy * bdimz;
+    const int64_t bytes_per_stage =
+        n_tensor_inputs * max_input_dtype_size * total_reduction_numel * bdimy;
+    const int64_t stages =
+        reduction_scheduler_utils::getCircularBufferStages(bytes_per_stage);
+    // Blocks that fit on an SM at the same time, limited by registers and by
+    // the shared memory of the stages
+    const int64_t blocks_per_sm = std::min(
+        getThreadsPerSMGivenRegPerThread(nvrtc_register_per_thread) /
+            threads_per_block,
+        device_model.smem_per_sm /
+            std::max(stages * bytes_per_stage, (int64_t)1));
+    const int64_t resident_blocks =
+        device_multiprocessor_count * std::max(blocks_per_sm, (int64_t)1);
+    // Only worth it if every block normalizes a few rows
+    if (stages > 0 && godim >= resident_blocks * 2) {
+      rparams->circular_buffer_stages = stages;
+      rparams->split_grid_dim_iter_dom_outer = true;
+      gdimx = resident_blocks;
+    }
+  }
+
   rparams->lparams = LaunchParams(
       gdimx,
       gdimy,
@@ -818,6 +975,22 @@ std::shared_ptr<ReductionParams> getInnerPersistentHeuristics(
       prop.vectorize_factor,
       prop.project_persistent_buffers,
       prop.index_type);
+  if (rparams->shared_mem_persistent_buffer) {
+    // See [ Hybrid Persistent Buffers ]
+    const auto& element_bytes = prop.persistent_buffer_element_bytes;
+    rparams->register_persistent_buffer_bytes =
+        normalization_scheduler_utils::hybridRegisterBufferBytes(
+            element_bytes,
+            prop.total_reduction_numel,
+            availableSharedMemorySize(
+                element_bytes.empty() ? 1
+                                      : *std::max_element(
+                                            element_bytes.begin(),
+                                            element_bytes.end())));
+    rparams->tma_load_persistent_buffer =
+        normalization_scheduler_utils::canTmaLoadPersistentBuffers(
+            fusion, prop.vectorize_factor);
+  }
   return rparams;
 }
 
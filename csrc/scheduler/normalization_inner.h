@@ -31,6 +31,12 @@ class InnerPersistentKernelScheduler : public SchedulerEntry {
       SchedulerRuntimeInfo& runtime_info,
       HeuristicSummary* data_cache = nullptr);
 
+  //! Builds an entry with deserialized parameters, see
+  //! [ Serialized Heuristics ] in scheduler/registry.h
+  explicit InnerPersistentKernelScheduler(
+      std::shared_ptr<HeuristicParams> params)
+      : SchedulerEntry(heuristicType(), std::move(params)) {}
+
   void schedule(Fusion* fusion) override;
 
   static bool canScheduleCompileTime(Fusion* fusion);
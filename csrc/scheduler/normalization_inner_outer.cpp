@@ -5,9 +5,13 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 // clang-format on
+#include <device_lower/analysis/register_pressure.h>
+#include <device_lower/lower2device.h>
 #include <inlining.h>
 #include <instrumentation.h>
+#include <options.h>
 #include <scheduler/debug_utils.h>
+#include <scheduler/device_model.h>
 #include <scheduler/normalization_inner_outer.h>
 #include <scheduler/normalization_utils.h>
 #include <scheduler/reduction_utils.h>
@@ -253,7 +257,7 @@ bool InnerOuterPersistentKernelScheduler::canScheduleRunTime(
   auto properties = scheduler_utils::getReductionProperties(
       fusion, runtime_info, reference_tv);
 
-  const int64_t warp_size = at::cuda::getCurrentDeviceProperties()->warpSize;
+  const int64_t warp_size = getDeviceModel().warp_size;
 
   // pair of persistent_buffer_size and available_persistent_buffer_size
   const std::pair<int64_t, int64_t> buffer_size =
@@ -261,8 +265,7 @@ bool InnerOuterPersistentKernelScheduler::canScheduleRunTime(
   const int64_t persistent_buffer_size = buffer_size.first;
   const int64_t available_persistent_buffer_size = buffer_size.second;
 
-  const int64_t device_multiprocessor_count =
-      (int64_t)at::cuda::getCurrentDeviceProperties()->multiProcessorCount;
+  const int64_t device_multiprocessor_count = getDeviceModel().sm_count;
 
   if (persistent_buffer_size > available_persistent_buffer_size) {
     scheduler_debug_utils::canScheduleRejectReason(
@@ -301,8 +304,7 @@ bool InnerOuterPersistentKernelScheduler::canScheduleRunTime(
   }
 
   const int64_t device_max_threads_per_multiprocessor =
-      (int64_t)at::cuda::getCurrentDeviceProperties()
-          ->maxThreadsPerMultiProcessor;
+      getDeviceModel().max_threads_per_sm;
 
   const int64_t required_sm_per_norm =
       ceilDiv(persistent_buffer_size, scheduler_utils::register_file_size);
@@ -339,8 +341,42 @@ void InnerOuterPersistentKernelScheduler::computeHeuristics(
     Fusion* fusion,
     SchedulerRuntimeInfo& runtime_info,
     HeuristicSummary* data_cache) {
-  params_ = getInnerOuterPersistentHeuristics(fusion, runtime_info, data_cache);
-  NVF_ERROR(params_ != nullptr);
+  auto rparams =
+      getInnerOuterPersistentHeuristics(fusion, runtime_info, data_cache);
+  NVF_ERROR(rparams != nullptr);
+
+  // See [ Register Pressure Feedback ]
+  if (isOptionEnabled(EnableOption::RegisterPressureFeedback)) {
+    for (int64_t attempt = 0; attempt < kMaxRegisterPressureAttempts;
+         attempt++) {
+      const int64_t batch = rparams->batches_per_block_inner_reduction;
+      if (batch <= 1) {
+        break;
+      }
+      const int64_t estimated_registers =
+          estimateInnerOuterRegisterUsage(fusion, *rparams);
+      const bool over_budget =
+          estimated_registers > rparams->cparams.maxrregcount;
+      if (isDebugDumpEnabled(DebugDumpOption::SchedulerDebug)) {
+        debug() << "Register pressure feedback: estimated "
+                << estimated_registers << " registers for persistent batch "
+                << batch << ", budget: " << rparams->cparams.maxrregcount
+                << std::endl;
+      }
+      if (!over_budget) {
+        break;
+      }
+      auto reduced_rparams = getInnerOuterPersistentHeuristics(
+          fusion, runtime_info, data_cache, batch - 1);
+      NVF_ERROR(reduced_rparams != nullptr);
+      if (reduced_rparams->batches_per_block_inner_reduction >= batch) {
+        break;
+      }
+      rparams = reduced_rparams;
+    }
+  }
+
+  params_ = rparams;
 }
 
 namespace {
@@ -371,7 +407,8 @@ std::shared_ptr<ReductionParams> innerOuterPersistentHeuristic(
     const size_t tmp_gmem_dtype_size,
     const size_t vectorize_factor,
     const bool project_to_input,
-    const PrimDataType index_type) {
+    const PrimDataType index_type,
+    const std::optional<int64_t> max_inner_batch) {
   auto rparams = std::make_shared<ReductionParams>();
   rparams->project_persistent_buffers = project_to_input;
   rparams->cparams.index_type = index_type;
@@ -433,9 +470,8 @@ std::shared_ptr<ReductionParams> innerOuterPersistentHeuristic(
         threads_per_sm / warp_size, allocated_warps_per_block);
   };
 
-  const auto dev_prop = at::cuda::getCurrentDeviceProperties();
-  const int64_t device_multiprocessor_count =
-      (int64_t)dev_prop->multiProcessorCount;
+  const auto& device_model = getDeviceModel();
+  const int64_t device_multiprocessor_count = device_model.sm_count;
 
   // Step-1, set InnerParams reduction dim: inner_vect, inner_batch,
   // threads_per_block (bdimx * bdimy). Start threads_per_block from a quarter
@@ -462,8 +498,9 @@ std::shared_ptr<ReductionParams> innerOuterPersistentHeuristic(
           outer_dim_numel,
           max_persistent_buffer_size,
           iop.inner_vect,
-          dev_prop->warpSize,
-          ignore_register_size_limit);
+          device_model.warp_size,
+          ignore_register_size_limit,
+          max_inner_batch);
   auto opt_inner_batch = batch_and_block_size.first;
   NVF_ERROR(opt_inner_batch.has_value());
   iop.inner_batch = opt_inner_batch.value();
@@ -481,7 +518,7 @@ std::shared_ptr<ReductionParams> innerOuterPersistentHeuristic(
       getEstimatedRegisterUsage(iop.inner_vect * iop.inner_batch);
   int64_t threads_per_sm = getThreadsPerSMGivenRegPerThread(reg_per_thread);
   int64_t blocks_per_sm =
-      getBlocksPerSM(threads_per_sm, threads_per_block, dev_prop->warpSize);
+      getBlocksPerSM(threads_per_sm, threads_per_block, device_model.warp_size);
   iop.gdimy = blocks_per_sm * device_multiprocessor_count;
   const int64_t outer_iter_min = 8;
   const int64_t gdimy_max = scheduler_utils::roundUpToN(
@@ -539,7 +576,7 @@ std::shared_ptr<ReductionParams> innerOuterPersistentHeuristic(
         getEstimatedRegisterUsage(iop.inner_vect * iop.inner_batch);
     threads_per_sm = getThreadsPerSMGivenRegPerThread(reg_per_thread);
     blocks_per_sm = getBlocksPerSM(
-        threads_per_sm, threads_per_block_mrpb, dev_prop->warpSize);
+        threads_per_sm, threads_per_block_mrpb, device_model.warp_size);
     iop.gdimy = blocks_per_sm * device_multiprocessor_count;
 
     // Step-3, OuterParams, Iteration dim: vectorization_factor_outer(reuse),
@@ -553,7 +590,7 @@ std::shared_ptr<ReductionParams> innerOuterPersistentHeuristic(
 
     // Step-4, OuterParams, Reduction dim: bdimx (already done)
 
-    if (iop.bdimx % dev_prop->warpSize == 0) {
+    if (iop.bdimx % device_model.warp_size == 0) {
       rparams->pad_inner_reduction_to_warp = true;
       rparams->pad_outer_reduction_to_warp = true;
     }
@@ -618,7 +655,8 @@ std::shared_ptr<ReductionParams> persistentHeuristic(
     const int64_t max_persistent_buffer_size,
     size_t vectorize_factor,
     bool project_persistent_buffers,
-    const PrimDataType index_type) {
+    const PrimDataType index_type,
+    const std::optional<int64_t> max_inner_batch) {
   const int64_t outer_dim_numel = total_iteration_numel;
   const int64_t inner_dim_numel = inner_most_dimension_numel;
   auto rparams = innerOuterPersistentHeuristic(
@@ -628,7 +666,8 @@ std::shared_ptr<ReductionParams> persistentHeuristic(
       tmp_gmem_dtype_size,
       vectorize_factor,
       project_persistent_buffers,
-      index_type);
+      index_type,
+      max_inner_batch);
   return rparams;
 }
 
@@ -637,7 +676,8 @@ std::shared_ptr<ReductionParams> persistentHeuristic(
 std::shared_ptr<ReductionParams> getInnerOuterPersistentHeuristics(
     Fusion* fusion,
     SchedulerRuntimeInfo& runtime_info,
-    HeuristicSummary* data_cache) {
+    HeuristicSummary* data_cache,
+    std::optional<int64_t> max_inner_batch) {
   FUSER_PERF_SCOPE("getInnerOuterPersistentHeuristics");
   FusionGuard fg(fusion);
 
@@ -776,10 +816,22 @@ std::shared_ptr<ReductionParams> getInnerOuterPersistentHeuristics(
       max_persistent_size,
       vectorize_factor,
       project_persistent_buffers,
-      runtime_info.getIndexType());
+      runtime_info.getIndexType(),
+      max_inner_batch);
   return heuristic;
 }
 
+int64_t estimateInnerOuterRegisterUsage(
+    Fusion* fusion,
+    const ReductionParams& rparams) {
+  FUSER_PERF_SCOPE("estimateInnerOuterRegisterUsage");
+  Fusion fusion_copy(*fusion);
+  scheduleInnerOuterPersistentKernel(&fusion_copy, rparams);
+  GpuLower lower(&fusion_copy, rparams.cparams);
+  return estimateLocalBufferRegisters(lower.run()) +
+      scheduler_utils::register_overhead;
+}
+
 std::shared_ptr<ReductionParams> getInnerOuterPersistentHeuristics(
     Fusion* fusion,
     const at::ArrayRef<c10::IValue>& runtime_inputs,
@@ -812,7 +864,26 @@ void scheduleReductionCombinedOuter(
       }
     }
   };
+  // Broadcast domains are merged with the iteration domains, so the reduction
+  // domains are moved to the front first, e.g., [B, R, I] -> [R, B, I].
+  auto moveReductionDomainsToFront = [](TensorView* tv) {
+    std::unordered_map<int, int> old2new;
+    int num_reductions = 0;
+    for (const auto i : c10::irange(tv->nDims())) {
+      if (tv->axis((int)i)->isReduction()) {
+        old2new[(int)i] = num_reductions++;
+      }
+    }
+    int num_others = 0;
+    for (const auto i : c10::irange(tv->nDims())) {
+      if (!tv->axis((int)i)->isReduction()) {
+        old2new[(int)i] = num_reductions + num_others++;
+      }
+    }
+    tv->reorder(old2new);
+  };
   for (auto& outer_reduction_tv : outer_reduction_tvs) {
+    moveReductionDomainsToFront(outer_reduction_tv);
     // merge tensorview to [reduction, iteraiton] domains
     mergeReductionOrIterDomains(outer_reduction_tv, true);
     mergeReductionOrIterDomains(outer_reduction_tv, false);
@@ -14,6 +14,8 @@
 #include <scheduler/registry.h>
 #include <scheduler/utils.h>
 
+#include <optional>
+
 // TODO: If caching inputs would require persistence we are sending it to the
 // persistent kerenl scheduler. This isn't necessary if the only persistent
 // buffers are inputs as we could re-read them from global memory. Need to
@@ -31,6 +33,12 @@ class InnerOuterPersistentKernelScheduler : public SchedulerEntry {
       SchedulerRuntimeInfo& runtime_info,
       HeuristicSummary* data_cache = nullptr);
 
+  //! Builds an entry with deserialized parameters, see
+  //! [ Serialized Heuristics ] in scheduler/registry.h
+  explicit InnerOuterPersistentKernelScheduler(
+      std::shared_ptr<HeuristicParams> params)
+      : SchedulerEntry(heuristicType(), std::move(params)) {}
+
   void schedule(Fusion* fusion) override;
 
   static bool canScheduleCompileTime(Fusion* fusion);
@@ -56,10 +64,40 @@ std::shared_ptr<ReductionParams> getInnerOuterPersistentHeuristics(
     const at::ArrayRef<c10::IValue>& runtime_inputs,
     HeuristicSummary* data_cache = nullptr);
 
+//! max_inner_batch, if given, limits the persistent batch of the inner
+//! reduction. See [ Register Pressure Feedback ].
 std::shared_ptr<ReductionParams> getInnerOuterPersistentHeuristics(
     Fusion* fusion,
     SchedulerRuntimeInfo& runtime_info,
-    HeuristicSummary* data_cache = nullptr);
+    HeuristicSummary* data_cache = nullptr,
+    std::optional<int64_t> max_inner_batch = std::nullopt);
+
+//! [ Register Pressure Feedback ]
+//!
+//! The inner-outer persistent heuristic picks the persistent batch from the
+//! size of the persistent buffers alone, assuming that
+//! scheduler_utils::register_overhead registers per thread suffice for
+//! everything else. Buffers the scheduler adds, e.g., for the partial results
+//! of the outer reductions, are not accounted for, and the kernel may then
+//! need more registers than cparams.maxrregcount, so that nvrtc spills them
+//! to local memory.
+//!
+//! With NVFUSER_ENABLE=register_pressure_feedback, the fusion is scheduled
+//! and lowered with the heuristic's parameters before they are used, and the
+//! registers of the local buffers live at the same time are estimated on the
+//! kernel IR. If the estimate plus the overhead exceeds the budget, the
+//! heuristic is run again with a persistent batch limited to one less, which
+//! spreads the buffers over more threads. This is repeated at most
+//! kMaxRegisterPressureAttempts times, and stops when the batch can't be
+//! reduced any further.
+constexpr int64_t kMaxRegisterPressureAttempts = 4;
+
+//! Schedules and lowers a copy of the fusion with the given parameters, and
+//! returns the estimated registers per thread, see
+//! estimateLocalBufferRegisters
+int64_t estimateInnerOuterRegisterUsage(
+    Fusion* fusion,
+    const ReductionParams& rparams);
 
 void scheduleInnerOuterPersistentKernel(
     Fusion* fusion,
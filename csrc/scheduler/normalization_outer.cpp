@@ -6,8 +6,10 @@
  */
 // clang-format on
 #include <instrumentation.h>
+#include <options.h>
 #include <scheduler/cache_policy_refiner.h>
 #include <scheduler/debug_utils.h>
+#include <scheduler/device_model.h>
 #include <scheduler/normalization_outer.h>
 #include <scheduler/normalization_utils.h>
 #include <scheduler/reduction_utils.h>
@@ -53,10 +55,10 @@ bool OuterPersistentKernelScheduler::canScheduleRunTime(
   auto properties = scheduler_utils::getReductionProperties(
       fusion, runtime_info, reduction_tvs[0]);
 
-  const auto device_prop = at::cuda::getCurrentDeviceProperties();
+  const auto& device_model = getDeviceModel();
 
   const int64_t sm_register_file_size =
-      static_cast<int64_t>(device_prop->regsPerBlock * sizeof(int));
+      static_cast<int64_t>(device_model.registers_per_block * sizeof(int));
 
   auto persistent_buffer_info_entry =
       HeuristicSummaryEntry<HeuristicCompileTime::PersistentBufferInfo>(
@@ -78,8 +80,7 @@ bool OuterPersistentKernelScheduler::canScheduleRunTime(
             persistent_buffer_size_info.persistent_buffer_size,
             persistent_buffer_size_info.projected_persistent_buffer_size);
 
-  const int64_t device_multiprocessor_count =
-      (int64_t)device_prop->multiProcessorCount;
+  const int64_t device_multiprocessor_count = device_model.sm_count;
 
   const auto available_persistent_buffer_size =
       sm_register_file_size * device_multiprocessor_count;
@@ -192,7 +193,7 @@ bool OuterPersistentKernelScheduler::canScheduleRunTime(
   }
 
   const int64_t device_max_threads_per_multiprocessor =
-      (int64_t)device_prop->maxThreadsPerMultiProcessor;
+      device_model.max_threads_per_sm;
   const int64_t min_fraction_of_sms =
       scheduler_utils::safeDiv(device_multiprocessor_count, 8);
   if (properties.total_reduction_numel >=
@@ -206,9 +207,10 @@ bool OuterPersistentKernelScheduler::canScheduleRunTime(
   // The runtime kernel for grouped normal grid reductions is not
   // well tuned, and it turned out to be quite difficult to get
   // consistently better performances than non-persistent
-  // schedules. Disabled for now.
-  // TODO: Enable non-welford persistent reductions
+  // schedules. Disabled unless the outer-optimized grouped grid
+  // reduction is enabled, see runtime/fused_reduction_impl_outer.cu.
   if (is_cross_grid &&
+      !isOptionEnabled(EnableOption::GridOuterPersistentReduction) &&
       std::any_of(
           reduction_tvs.begin(),
           reduction_tvs.end(),
@@ -231,7 +233,7 @@ bool OuterPersistentKernelScheduler::canScheduleRunTime(
            (vectorization_factor * cross_grid_params->launch_params.bdimx() *
             cross_grid_params->launch_params.gdimx()) !=
        0) &&
-      device_prop->major == 7) {
+      device_model.major == 7) {
     scheduler_debug_utils::canScheduleRejectReason(
         heuristicType(), "iteration not evenly divided");
     return false;
@@ -376,22 +378,21 @@ std::shared_ptr<ReductionParams> outerPersistentHeuristic(
     const PrimDataType index_type) {
   // Set some targets for parallelization
   const int64_t n_elems = total_reduction_numel * total_iteration_numel;
-  const auto dev_prop = at::cuda::getCurrentDeviceProperties();
+  const auto& device_model = getDeviceModel();
 
-  const int64_t device_multiprocessor_count =
-      (int64_t)dev_prop->multiProcessorCount;
+  const int64_t device_multiprocessor_count = device_model.sm_count;
 
   // If it fits in l2, we just want to make sure each warp uses 32Bytes. Set
   // minimum warp as 16 threads instead of 32 as if we have a small reduction
   // dim going a bit smaller than 32 usually helps.
   const int64_t warp_size =
-      n_elems * max_input_dtype_size * n_tensor_inputs < dev_prop->l2CacheSize
+      n_elems * max_input_dtype_size * n_tensor_inputs < device_model.l2_size
       ? (int64_t)32 / max_input_dtype_size
       : 16;
 
   const auto register_file_size =
-      dev_prop->regsPerBlock * scheduler_utils::bytes_per_register;
-  const int64_t device_warp_size = (int64_t)dev_prop->warpSize;
+      device_model.registers_per_block * scheduler_utils::bytes_per_register;
+  const int64_t device_warp_size = device_model.warp_size;
 
   // Each block runs N reductions, where N is defined as:
   // vectorize_factor * blockDim.x. The minimum number of SMs to run
@@ -8,8 +8,10 @@
 #include <expr_evaluator.h>
 #include <grouped_reduction.h>
 #include <instrumentation.h>
+#include <options.h>
 #include <scheduler/cache_policy_refiner.h>
 #include <scheduler/debug_utils.h>
+#include <scheduler/device_model.h>
 #include <scheduler/normalization_utils.h>
 #include <scheduler/reduction_utils.h>
 #include <scheduler/registry.h>
@@ -18,6 +20,8 @@
 
 #include <ATen/cuda/CUDAContext.h>
 
+#include <numeric>
+
 namespace nvfuser {
 namespace normalization_scheduler_utils {
 
@@ -64,8 +68,7 @@ bool PreferredLaunchConfig::setBdimx(int bdimx, bool dry_run) {
 // 36), (2, 54)].
 void PreferredLaunchConfig::initValidGdims() {
   std::vector<std::pair<int, int>> grid_dims;
-  const int num_sms =
-      at::cuda::getCurrentDeviceProperties()->multiProcessorCount;
+  const int num_sms = (int)getDeviceModel().sm_count;
   const int max_first_half =
       static_cast<int>(std::sqrt(static_cast<float>(num_sms)));
   for (int gdimy = 2; gdimy <= max_first_half; ++gdimy) {
@@ -458,8 +461,8 @@ std::optional<GridOuterNormalizationParams> getGridOuterNormalizationParams(
     int64_t adjusted_gdimy = -1;
     int64_t adjusted_buffer_size = -1;
     bool last_block_work_reduced = false;
-    const auto major_ver = at::cuda::getCurrentDeviceProperties()->major;
-    const auto minor_ver = at::cuda::getCurrentDeviceProperties()->minor;
+    const auto major_ver = getDeviceModel().major;
+    const auto minor_ver = getDeviceModel().minor;
     if (major_ver == 7 && minor_ver == 5) {
       adjusted_gdimy = launch_cfg.gdimy();
       adjusted_buffer_size = getMinPersistentBufferSize(
@@ -511,46 +514,48 @@ std::optional<GridOuterNormalizationParams> getGridOuterNormalizationParams(
 bool checkIfReductionsAreInnerOuter(
     const std::vector<TensorView*>& inner_reduction_tvs,
     const std::vector<TensorView*>& outer_reduction_tvs) {
-  bool pass_combined_heck = true;
-  // inner reduction must be [I,I,...R,R]
-  auto innerReductionCheck = [](TensorView* tv) {
-    int ndim = static_cast<int>(tv->nDims());
-    int lastIter = -1;
-    while (lastIter < ndim - 1 && tv->axis(lastIter + 1)->isIteration()) {
-      lastIter++;
-    }
-    int firstRedu = ndim;
-    while (firstRedu > 0 && tv->axis(firstRedu - 1)->isReduction()) {
-      firstRedu--;
+  // Broadcast domains are neither reduced nor iterated over, so they are
+  // skipped and can be anywhere, e.g., a [N, 1, H] input gives an inner
+  // reduction tv of [I, B, R] and an outer reduction tv of [R, B, I].
+  // Any other iter type gives an empty vector, which fails the check below.
+  auto nonBroadcastIsReduction = [](TensorView* tv) {
+    std::vector<bool> is_reduction;
+    for (auto id : tv->getLeafDomain()) {
+      if (id->isBroadcast()) {
+        continue;
+      }
+      if (!id->isIteration() && !id->isReduction()) {
+        return std::vector<bool>{};
+      }
+      is_reduction.push_back(id->isReduction());
     }
-    return lastIter >= 0 && firstRedu < ndim && lastIter == firstRedu - 1;
+    return is_reduction;
   };
-  // outer reduction must be [R,R,..I,I]
-  auto outerReductionCheck = [](TensorView* tv) {
-    int ndim = static_cast<int>(tv->nDims());
-    int lastRedu = -1;
-    while (lastRedu < ndim - 1 && tv->axis(lastRedu + 1)->isReduction()) {
-      lastRedu++;
-    }
-    int firstIter = ndim;
-    while (firstIter > 0 && tv->axis(firstIter - 1)->isIteration()) {
-      firstIter--;
+  // all_true_first is true if the domains must be [R,R,...I,I] and false if
+  // they must be [I,I,...R,R]
+  auto isSplitAtOnePosition = [](const std::vector<bool>& is_reduction,
+                                 bool all_true_first) {
+    const auto first = std::find(
+        is_reduction.begin(), is_reduction.end(), !all_true_first);
+    if (first == is_reduction.begin() || first == is_reduction.end()) {
+      return false;
     }
-    return lastRedu >= 0 && firstIter < ndim && lastRedu == firstIter - 1;
+    return std::find(first, is_reduction.end(), all_true_first) ==
+        is_reduction.end();
   };
+  // inner reduction must be [I,I,...R,R]
   for (auto itv : inner_reduction_tvs) {
-    if (!innerReductionCheck(itv)) {
-      pass_combined_heck = false;
-      break;
+    if (!isSplitAtOnePosition(nonBroadcastIsReduction(itv), false)) {
+      return false;
     }
   }
+  // outer reduction must be [R,R,..I,I]
   for (auto otv : outer_reduction_tvs) {
-    if (!outerReductionCheck(otv)) {
-      pass_combined_heck = false;
-      break;
+    if (!isSplitAtOnePosition(nonBroadcastIsReduction(otv), true)) {
+      return false;
     }
   }
-  return pass_combined_heck;
+  return true;
 }
 
 bool hasSharedInput(
@@ -607,51 +612,60 @@ bool isReductionIterationAxisMatched(
     const std::vector<TensorView*>& inner_reduction_tvs,
     const std::vector<TensorView*>& outer_reduction_tvs) {
   // set up reference, checkIfReductionsAreInnerOuter already ensures all the
-  // tensor domains are either iteration or reduction, so we can just use a
-  // vector of bool.
+  // tensor domains are iteration, reduction or broadcast, so we can just use
+  // a vector of iter types.
   auto reference_tv = inner_reduction_tvs[0];
-  std::vector<bool> is_reduction(reference_tv->nDims(), false);
+  std::vector<IterType> ref_iter_types;
   for (const auto i : c10::irange(reference_tv->nDims())) {
     auto id = reference_tv->axis((int)i);
     NVF_CHECK(
         id->getIterType() == IterType::Iteration ||
-            id->getIterType() == IterType::Reduction,
+            id->getIterType() == IterType::Reduction ||
+            id->getIterType() == IterType::Broadcast,
         "Invalid iteration type: ",
         id->getIterType());
-    if (id->isReduction()) {
-      is_reduction[i] = true;
-    }
+    ref_iter_types.push_back(id->getIterType());
   }
-  // check other inner reduction tvs, the corresponding axis should be
-  // reduction.
-  for (auto i : c10::irange(1, inner_reduction_tvs.size())) {
-    auto tv = inner_reduction_tvs[i];
+  // Broadcast domains must be at the same positions in all the tvs and the
+  // other domains must be flipped if flip is true, i.e., a reduction domain of
+  // the reference is an iteration domain and vice versa.
+  auto matchesReference = [&ref_iter_types](TensorView* tv, bool flip) {
+    if (tv->nDims() != ref_iter_types.size()) {
+      return false;
+    }
     for (const auto i : c10::irange(tv->nDims())) {
       auto id = tv->axis((int)i);
       NVF_CHECK(
           id->getIterType() == IterType::Iteration ||
-              id->getIterType() == IterType::Reduction,
+              id->getIterType() == IterType::Reduction ||
+              id->getIterType() == IterType::Broadcast,
           "Invalid iteration type: ",
           id->getIterType());
-
-      if (id->isReduction() != is_reduction.at(i)) {
+      const IterType ref_iter_type = ref_iter_types.at(i);
+      if (id->isBroadcast() || ref_iter_type == IterType::Broadcast) {
+        if (id->getIterType() != ref_iter_type) {
+          return false;
+        }
+        continue;
+      }
+      if ((id->isReduction() != (ref_iter_type == IterType::Reduction)) !=
+          flip) {
         return false;
       }
     }
+    return true;
+  };
+  // check other inner reduction tvs, the corresponding axis should be
+  // reduction.
+  for (auto i : c10::irange(1, inner_reduction_tvs.size())) {
+    if (!matchesReference(inner_reduction_tvs[i], false)) {
+      return false;
+    }
   }
   // check outer reduction tvs, the corresponding axis should be iteration.
   for (auto tv : outer_reduction_tvs) {
-    for (const auto i : c10::irange(tv->nDims())) {
-      auto id = tv->axis((int)i);
-      NVF_CHECK(
-          id->getIterType() == IterType::Iteration ||
-              id->getIterType() == IterType::Reduction,
-          "Invalid iteration type: ",
-          id->getIterType());
-
-      if (id->isIteration() != is_reduction.at(i)) {
-        return false;
-      }
+    if (!matchesReference(tv, true)) {
+      return false;
     }
   }
 
@@ -692,7 +706,8 @@ getOptionalInnerOuterPersistentBufferBatches(
     const int64_t persistent_buffer_size,
     const int64_t vectorize_factor,
     const int64_t warp_size,
-    const bool ignore_register_size_limit) {
+    const bool ignore_register_size_limit,
+    const std::optional<int64_t> max_batch) {
   // if inner_dim_numel <= 1024, we are doing multiple reductions per block
   // with a constant batch size of 1 if vectorized. See Step 5 of
   // innerOuterPersistentHeuristic. Although batch size is 1, each thread also
@@ -742,7 +757,12 @@ getOptionalInnerOuterPersistentBufferBatches(
   const int64_t threads_per_block_min = std::min(after_vectorization, 128l);
   const int64_t threads_per_block_max = getThreadsPerSMGivenRegPerThread(255l);
   const int64_t batch_min = getMinimumBatch();
-  const int64_t batch_max = getMaximumInnerOuterPersistentBufferBatch();
+  // max_batch further limits the batch, e.g., if the registers estimated for
+  // a previous choice of batch exceeded the register budget. See
+  // [ Register Pressure Feedback ].
+  const int64_t batch_max = max_batch.has_value()
+      ? std::min(getMaximumInnerOuterPersistentBufferBatch(), *max_batch)
+      : getMaximumInnerOuterPersistentBufferBatch();
 
   // Start from the smallest threads_per_block. If the corresponding batch size
   // is larger than batch_max, try increase threads per block by a warp until
@@ -999,7 +1019,11 @@ PersistentKernelProperties getPersistentKernelProperties(
       .max_dtype_size = max_dtype_size,
       .vectorize_factor = vectorize_factor,
       .project_persistent_buffers = project_persistent_buffers,
-      .index_type = runtime_info.getIndexType()};
+      .index_type = runtime_info.getIndexType(),
+      .persistent_buffer_element_bytes = persistentBufferElementBytes(
+          persistent_buffer_info,
+          project_persistent_buffers,
+          runtime_info.getIndexType())};
 }
 
 bool checkOpsAndInputs(Fusion* fusion, ScheduleHeuristic schedule_heuristic) {
@@ -1225,12 +1249,22 @@ void beforeSchedule(
   scheduler_utils::clearMemorySpace(fusion);
   scheduler_utils::prepareForMemoryTypePromotion(fusion);
 
-  // Use shared memory to store persistent buffers
+  // Use shared memory to store persistent buffers, except those kept in
+  // registers, see [ Hybrid Persistent Buffers ]
   if (rparams.shared_mem_persistent_buffer) {
     const auto& persistent_buffers =
         scheduler_utils::persistentBuffers(fusion).persistent_buffers;
+    std::vector<int64_t> element_bytes;
+    element_bytes.reserve(persistent_buffers.size());
     for (auto tv : persistent_buffers) {
-      tv->setMemoryType(MemoryType::Shared);
+      element_bytes.push_back(dataTypeSize(tv->dtype()));
+    }
+    const auto in_registers = hybridRegisterBuffers(
+        element_bytes, rparams.register_persistent_buffer_bytes);
+    for (auto i : c10::irange(persistent_buffers.size())) {
+      if (!in_registers.at(i)) {
+        persistent_buffers.at(i)->setMemoryType(MemoryType::Shared);
+      }
     }
   }
 
@@ -1282,6 +1316,95 @@ TensorView* scheduleReductionGeneral(
       rparams, reduction_tv, has_iter_axis);
 }
 
+bool canTmaLoadPersistentBuffers(Fusion* fusion, int64_t vectorize_factor) {
+  if (!isOptionEnabled(EnableOption::TmaPersistentBuffer) ||
+      getDeviceModel().major < 9) {
+    return false;
+  }
+  for (auto tv : ir_utils::filterByType<TensorView>(fusion->inputs())) {
+    if (vectorize_factor * dataTypeSize(tv->dtype()) % 16 != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::vector<int64_t> persistentBufferElementBytes(
+    const scheduler_utils::PersistentBufferInfo& persistent_buffer_info,
+    bool project_to_inputs,
+    PrimDataType index_type) {
+  std::vector<TensorView*> buffers;
+  if (project_to_inputs) {
+    const auto& projectable_buffers =
+        persistent_buffer_info.projectable_persistent_buffers;
+    std::copy_if(
+        persistent_buffer_info.persistent_buffers.begin(),
+        persistent_buffer_info.persistent_buffers.end(),
+        std::back_inserter(buffers),
+        [&](TensorView* tv) {
+          return std::find(
+                     projectable_buffers.begin(),
+                     projectable_buffers.end(),
+                     tv) == projectable_buffers.end();
+        });
+    // An input can also be a persistent buffer itself
+    for (auto tv : persistent_buffer_info.projectable_buffer_inputs) {
+      if (std::find(buffers.begin(), buffers.end(), tv) == buffers.end()) {
+        buffers.push_back(tv);
+      }
+    }
+  } else {
+    buffers = persistent_buffer_info.persistent_buffers;
+  }
+  std::vector<int64_t> element_bytes;
+  element_bytes.reserve(buffers.size());
+  for (auto tv : buffers) {
+    element_bytes.push_back(
+        dataTypeSize(tv->getDataType().value(), index_type));
+  }
+  return element_bytes;
+}
+
+std::vector<bool> hybridRegisterBuffers(
+    const std::vector<int64_t>& element_bytes,
+    int64_t register_bytes) {
+  std::vector<size_t> order(element_bytes.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    return element_bytes.at(a) > element_bytes.at(b);
+  });
+  std::vector<bool> in_registers(element_bytes.size(), false);
+  for (auto i : order) {
+    if (element_bytes.at(i) <= register_bytes) {
+      in_registers.at(i) = true;
+      register_bytes -= element_bytes.at(i);
+    }
+  }
+  return in_registers;
+}
+
+int64_t hybridRegisterBufferBytes(
+    const std::vector<int64_t>& element_bytes,
+    int64_t reduction_numel,
+    int64_t available_shared_memory_size) {
+  if (!isOptionEnabled(EnableOption::HybridPersistentBuffers) ||
+      reduction_numel <= 0) {
+    return 0;
+  }
+  const auto in_registers = hybridRegisterBuffers(
+      element_bytes, scheduler_utils::register_file_size / reduction_numel);
+  int64_t register_bytes = 0;
+  int64_t shared_memory_bytes = 0;
+  for (auto i : c10::irange(element_bytes.size())) {
+    (in_registers.at(i) ? register_bytes : shared_memory_bytes) +=
+        element_bytes.at(i);
+  }
+  if (shared_memory_bytes * reduction_numel > available_shared_memory_size) {
+    return 0;
+  }
+  return register_bytes;
+}
+
 // fusion is the input IR that will be modified by this function
 void schedulePersistentKernel(
     Fusion* fusion,
@@ -1321,6 +1444,16 @@ void schedulePersistentKernel(
       rparams.vectorize_inner_reduction || rparams.vectorize_iter_dom;
   const bool is_outer_grid_persistence = rparams.persistent_kernel &&
       rparams.cross_grid_inner_reduction && !rparams.fastest_dim;
+  std::vector<TensorView*> tma_load_tvs;
+  if (rparams.tma_load_persistent_buffer) {
+    std::copy_if(
+        cached_inputs.begin(),
+        cached_inputs.end(),
+        std::back_inserter(tma_load_tvs),
+        [](TensorView* tv) {
+          return tv->getMemoryType() == MemoryType::Shared;
+        });
+  }
   reduction_scheduler_utils::multiReductionInliner(
       fusion,
       reduction_tvs[0],
@@ -1331,13 +1464,22 @@ void schedulePersistentKernel(
       reduction_tvs,
       cached_inputs,
       cached_outputs,
-      dummy_outputs);
+      dummy_outputs,
+      tma_load_tvs);
+
+  reduction_scheduler_utils::circularBufferCachedInputs(
+      cached_inputs, rparams.circular_buffer_stages);
 
   if (rparams.compute_persistent_buffer_with_first_consumer) {
     NVF_ERROR(
         rparams.persistent_kernel,
         "computeWith should be only used with persistent kernels");
     for (const auto persistent_buffer : cached_inputs) {
+      // computeWith is not supported with circular buffering
+      if (persistent_buffer->isCircularBuffered() ||
+          persistent_buffer->isDoubleBuffered()) {
+        continue;
+      }
       persistent_buffer->computeWith(-1, true);
     }
   }
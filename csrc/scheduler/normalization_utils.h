@@ -12,6 +12,7 @@
 #include <ir/all_nodes.h>
 #include <scheduler/heuristic_types.h>
 #include <scheduler/reduction_utils.h>
+#include <scheduler/utils.h>
 #include <cmath>
 #include <optional>
 #include <ostream>
@@ -161,6 +162,7 @@ std::optional<GridOuterNormalizationParams> getGridOuterNormalizationParams(
 //! check iter type of each domain in inner and outer reduction tvs
 //! inner reduction must be [I,I,...R,R]
 //! outer reduction must be [R,R,...I,I]
+//! broadcast domains are ignored
 bool checkIfReductionsAreInnerOuter(
     const std::vector<TensorView*>& inner_reduction_tvs,
     const std::vector<TensorView*>& outer_reduction_tvs);
@@ -180,7 +182,8 @@ bool isConnectedOnlyThroughReductionProducer(
     const std::vector<TensorView*>& outer_reduction_tvs);
 
 // Returns true if every iteration domain in inner reduction tv is a reduction
-// domain in outer reduction tv.
+// domain in outer reduction tv. Broadcast domains must be at the same
+// positions in all of them.
 bool isReductionIterationAxisMatched(
     const std::vector<TensorView*>& inner_reduction_tvs,
     const std::vector<TensorView*>& outer_reduction_tvs);
@@ -214,7 +217,8 @@ getOptionalInnerOuterPersistentBufferBatches(
     const int64_t persistent_buffer_size,
     const int64_t vectorize_factor,
     const int64_t warp_size,
-    const bool ignore_register_size_limit);
+    const bool ignore_register_size_limit,
+    const std::optional<int64_t> max_batch = std::nullopt);
 
 // Return a scheduleHeuristic based on reduction types.
 using ReductionType = reduction_scheduler_utils::ReductionType;
@@ -231,6 +235,9 @@ struct PersistentKernelProperties {
   int64_t vectorize_factor;
   bool project_persistent_buffers;
   PrimDataType index_type;
+  // Bytes of an element of each persistent buffer, see
+  // [ Hybrid Persistent Buffers ]
+  std::vector<int64_t> persistent_buffer_element_bytes;
 };
 PersistentKernelProperties getPersistentKernelProperties(
     Fusion* fusion,
@@ -281,6 +288,81 @@ TensorView* scheduleReductionGeneral(
     std::vector<TensorView*>& reduction_tvs,
     ScheduleHeuristic schedule_heuristic);
 
+//! [ TMA Loads of Persistent Buffers ]
+//!
+//! Inner persistent kernels whose persistent buffers don't fit in registers
+//! keep them in shared memory. On Hopper, with
+//! NVFUSER_ENABLE=tma_persistent_buffer, the buffers that are cached inputs
+//! are loaded with one non-tensor cp.async.bulk per row instead of vectorized
+//! loads by every thread, which saves the registers and the address
+//! computations of those loads. The tensor variant of TMA is not used since
+//! its boxes are limited to 256 elements per dimension, far less than the
+//! rows of these kernels.
+//!
+//! The domains the innermost root domain of a buffer is split into are
+//! parallelized with ParallelType::Bulk, which is never inlined, so the
+//! buffer is computed at the iteration domain. The copy is issued by the
+//! thread selected by the thread predicate of the buffer, which also guards
+//! rows that are out of bounds. All copies of a kernel complete on one
+//! mbarrier. Every thread arrives at it, the issuing thread along with the
+//! number of bytes to expect, and waits for the phase to complete before it
+//! reads the buffer.
+//!
+//! Bulk copies need the addresses and the size of the rows to be multiples
+//! of 16 bytes. This holds if the vectorization factor spans 16 bytes of
+//! each input, as the rows and the alignment of the inputs are multiples of
+//! it. Each CTA of these kernels processes one row, so there is no next row
+//! to prefetch and the buffers are not double buffered.
+
+//! Returns true if the shared memory persistent buffers of inputs can be
+//! loaded with TMA, see [ TMA Loads of Persistent Buffers ]
+bool canTmaLoadPersistentBuffers(Fusion* fusion, int64_t vectorize_factor);
+
+//! [ Hybrid Persistent Buffers ]
+//!
+//! Inner persistent kernels keep their persistent buffers in registers, or
+//! all of them in shared memory if they don't fit in the register file. Rows
+//! that don't fit in shared memory either are normalized by non-persistent
+//! kernels that read the inputs from global memory again. With
+//! NVFUSER_ENABLE=hybrid_persistent_buffers, the shared memory kernels keep
+//! as many of their buffers in registers as fit in the register file; only
+//! the others are in shared memory. So buffers of a row that exceed both the
+//! register file and shared memory, e.g., the inputs and gradients of the
+//! normalization backwards of hidden sizes of 16K to 64K, remain persistent,
+//! and the buffers kept in registers are read without the latency of shared
+//! memory.
+//!
+//! Each buffer is entirely in registers or in shared memory, as the memory
+//! type is a property of a tensor. The buffers hold a whole row each, so
+//! which ones fit only depends on the bytes of their elements. The largest
+//! ones are kept in registers first. The heuristic and the scheduler make the
+//! same choice from the bytes of the elements of the buffers, of which
+//! ReductionParams::register_persistent_buffer_bytes is the sum for the
+//! buffers in registers.
+
+//! Bytes of an element of each buffer a persistent kernel keeps, the buffers
+//! projected to the inputs if project_to_inputs
+std::vector<int64_t> persistentBufferElementBytes(
+    const scheduler_utils::PersistentBufferInfo& persistent_buffer_info,
+    bool project_to_inputs,
+    PrimDataType index_type);
+
+//! Whether each of the buffers with the given bytes per element is kept in
+//! registers, the largest first, while their elements add up to at most
+//! register_bytes bytes. See [ Hybrid Persistent Buffers ].
+std::vector<bool> hybridRegisterBuffers(
+    const std::vector<int64_t>& element_bytes,
+    int64_t register_bytes);
+
+//! The sum of the bytes per element of the buffers of rows of
+//! reduction_numel elements that are kept in registers if the others fit in
+//! available_shared_memory_size, or 0 if hybrid persistent buffers are not
+//! enabled or don't fit. See [ Hybrid Persistent Buffers ].
+int64_t hybridRegisterBufferBytes(
+    const std::vector<int64_t>& element_bytes,
+    int64_t reduction_numel,
+    int64_t available_shared_memory_size);
+
 // Used by InnerPersistentKernelScheduler and  OuterPersistentKernelScheduler
 void schedulePersistentKernel(
     Fusion* fusion,
@@ -10,8 +10,10 @@
 #include <debug.h>
 #include <inlining.h>
 #include <instrumentation.h>
+#include <options.h>
 #include <scheduler/cache_policy_refiner.h>
 #include <scheduler/debug_utils.h>
+#include <scheduler/device_model.h>
 #include <scheduler/mark_aliases.h>
 #include <scheduler/pointwise.h>
 #include <scheduler/reduction_utils.h>
@@ -19,6 +21,7 @@
 #include <scheduler/transpose.h>
 #include <scheduler/utils.h>
 #include <scheduler/vectorize_helper.h>
+#include <tensor_metadata.h>
 
 namespace nvfuser {
 
@@ -114,6 +117,9 @@ namespace {
 // constexpr int64_t x_grid_limit = ((int64_t)1 << (int64_t)31) - (int64_t)1;
 // Unused at the moment, commenting for clang tidy
 constexpr int64_t kThreadX = 128;
+// A persistent grid is only used if one block per tile would need more than
+// this many waves
+constexpr int64_t kMinWavesForPersistentGrid = 4;
 
 class DomainMap : public pointwise_utils::DomainMap {
  public:
@@ -146,6 +152,164 @@ class DomainMap : public pointwise_utils::DomainMap {
   }
 };
 
+// [ Generic Kernels ]
+//
+// The heuristics pick split factors, vectorization and the 2D break point
+// from the sizes and alignments of the inputs, and these are compiled into the
+// kernel, so a workload whose shapes keep changing compiles a kernel for
+// almost every new shape. GenericKernels instead makes the pointwise and
+// reduction heuristics return parameters that depend only on the fusion and
+// the data types. Their kernels are compiled with symbolic extents and
+// launched with grid sizes computed from the inputs, so
+// FusionKernelRuntime::getMaybeHeuristicsFor finds the same parameters for
+// any new shape and reuses the existing kernel.
+//
+// The pointwise schedule is 1D, unrolled but not vectorized, and the reduction
+// heuristics are computed for a fixed, representative problem size with no
+// vectorization. This gives up some bandwidth, mostly from the lack of
+// vectorization, for never recompiling. The index type is still part of the
+// parameters, and persistent normalizations, whose buffers are sized by the
+// problem, are still specialized.
+
+// [ Misaligned Pointwise Vectorization ]
+//
+// The vectorization factor of the regular schedule is limited by the alignment
+// of the base addresses of the inputs, so, e.g., the slices of a fused QKV
+// projection or of a KV cache at an odd offset are not vectorized at all.
+// MisalignedVectorize instead peels the elements before the first aligned
+// address and after the last one into scalar loops and vectorizes the ones in
+// between (see device_lower/pass/misaligned_vectorization.cpp). The shift of
+// the peeled loop is computed from the address of one of the tensors, so it's
+// only used when all the vectorized inputs have the same misalignment, sizes
+// and strides. The lowering also requires the vectorized domain to be the
+// innermost one, right of the computeAt position of the cached inputs:
+//
+//   [BIDx | i-remainder, TIDx, MisalignedVectorize]
+//
+// where the left side merges all the outer dimensions. Outputs are written
+// without vectorization.
+
+// [ Pointwise Grid Swizzle ]
+//
+// The 2D schedule binds the tiles of one side of the break point to BIDx and
+// the other side to BIDy, and blocks are launched in order of BIDx first. So
+// the blocks running at once cover a row of tiles along BIDx, and an operand
+// broadcast along the BIDy side, e.g., the bias of an outer-product style
+// kernel [M, N] + [N], is read in full for every row. Once that row of the
+// operand is larger than L2, each row reads it again from DRAM, evicting the
+// output on the way. Like grid_swizzle_factor of MatmulParams, the grid is
+// then swizzled so that consecutive blocks walk grid_swizzle_factor tiles
+// along BIDy before moving along BIDx:
+//
+//   [BIDx{R} | BIDy{L}] -> [BIDx{R * factor} | BIDy{ceilDiv(L, factor)}]
+//
+// where the factor is the inner one of the merge, so the blocks in flight
+// share factor times fewer tiles of the broadcast operand. The factor is
+// chosen by scheduler_utils::getGridSwizzleFactor from the bytes a row of
+// tiles reads along BIDx, and isn't used when BIDy is split.
+
+// Swizzles the two outermost domains of reference_tv, the tiles bound to BIDx
+// and BIDy, see [ Pointwise Grid Swizzle ]
+void swizzlePointwiseGrid(
+    TensorView* reference_tv,
+    const PointwiseParams& params) {
+  NVF_ERROR(!params.split_grid_y_dim);
+  const int64_t factor = params.grid_swizzle_factor;
+  if (params.flip_grid_binding) {
+    // [BIDy | BIDx] -> [BIDy/factor, factor | BIDx] ->
+    //   [BIDy/factor | BIDx * factor]
+    reference_tv->split(0, factor);
+    reference_tv->reorder({{1, 2}, {2, 1}});
+    reference_tv->merge(1);
+  } else {
+    // [BIDx | BIDy] -> [BIDx | BIDy/factor, factor] ->
+    //   [BIDx * factor | BIDy/factor]
+    reference_tv->split(1, factor);
+    reference_tv->reorder({{1, 2}, {2, 1}});
+    reference_tv->merge(0);
+  }
+}
+
+// Returns the factor that the inputs of the reference can be vectorized by
+// with MisalignedVectorize, or 1 if they can't be. See
+// [ Misaligned Pointwise Vectorization ].
+int64_t getMisalignedVectorizationFactor(
+    SchedulerRuntimeInfo& runtime_info,
+    TensorView* reference_tv,
+    const std::vector<TensorView*>& vectorizable_inputs_outputs,
+    int64_t max_unroll_factor) {
+  const auto ref_root =
+      TensorDomain::noReductions(reference_tv->getMaybeRFactorDomain());
+  if (ref_root.empty() ||
+      std::any_of(ref_root.begin(), ref_root.end(), [](IterDomain* id) {
+        return id->isBroadcast();
+      })) {
+    return 1;
+  }
+
+  std::vector<TensorView*> inputs;
+  for (auto tv : vectorizable_inputs_outputs) {
+    if (tv->isFusionInput()) {
+      inputs.push_back(tv);
+    }
+  }
+  if (inputs.empty()) {
+    return 1;
+  }
+
+  const auto index_type = runtime_info.getIndexType();
+  const int64_t dtype_size =
+      (int64_t)dataTypeSize(inputs.front()->dtype(), index_type);
+  const int64_t factor = scheduler_utils::lastPow2(
+      std::min(max_unroll_factor, (int64_t)16 / dtype_size));
+  if (factor <= 1) {
+    return 1;
+  }
+
+  std::optional<size_t> misalignment;
+  std::vector<int64_t> sizes;
+  std::vector<int64_t> strides;
+  for (auto tv : inputs) {
+    if ((int64_t)dataTypeSize(tv->dtype(), index_type) != dtype_size ||
+        tv->hasAllocation() ||
+        tv->getMaybeRFactorDomain().size() != ref_root.size() ||
+        !tv->domain()->contiguity().back().value_or(false)) {
+      return 1;
+    }
+    const auto& metadata = runtime_info.expressionEvaluator().evaluate(
+        IrBuilder::metadataExpr(tv));
+    const auto& alloc_sizes = metadata->*&TensorMetaData::alloc_size;
+    const auto& alloc_strides = metadata->*&TensorMetaData::alloc_stride;
+    const size_t ptr = runtime_info.ptrOf(tv);
+    if (ptr % (size_t)dtype_size != 0) {
+      return 1;
+    }
+    if (!misalignment.has_value()) {
+      misalignment = ptr % (size_t)(factor * dtype_size);
+      sizes.assign(alloc_sizes.begin(), alloc_sizes.end());
+      strides.assign(alloc_strides.begin(), alloc_strides.end());
+      continue;
+    }
+    if (ptr % (size_t)(factor * dtype_size) != misalignment.value() ||
+        !std::equal(
+            sizes.begin(),
+            sizes.end(),
+            alloc_sizes.begin(),
+            alloc_sizes.end()) ||
+        !std::equal(
+            strides.begin(),
+            strides.end(),
+            alloc_strides.begin(),
+            alloc_strides.end())) {
+      return 1;
+    }
+  }
+  if (strides.empty() || strides.back() != 1) {
+    return 1;
+  }
+  return factor;
+}
+
 } // namespace
 
 std::shared_ptr<PointwiseParams> getPointwiseHeuristics(
@@ -188,8 +352,7 @@ std::shared_ptr<PointwiseParams> getPointwiseHeuristics(
 
   NVF_ERROR(largest_out != nullptr);
 
-  const int64_t device_multiprocessor_count =
-      (int64_t)at::cuda::getCurrentDeviceProperties()->multiProcessorCount;
+  const int64_t device_multiprocessor_count = getDeviceModel().sm_count;
 
   // TODO: Set to 1?
   int64_t max_input_dtype_size = 2;
@@ -287,8 +450,11 @@ std::shared_ptr<PointwiseParams> getPointwiseHeuristics(
            2),
           (int64_t)1));
 
+  // See [ Generic Kernels ]
+  const bool generic_kernel = isOptionEnabled(EnableOption::GenericKernels);
+
   // Don't unroll at the cost of getting a full wave on the GPU
-  if (n_elems < device_multiprocessor_count * kThreadX &&
+  if (!generic_kernel && n_elems < device_multiprocessor_count * kThreadX &&
       max_unroll_factor > 1) {
     max_unroll_factor = std::min(
         max_unroll_factor,
@@ -324,6 +490,10 @@ std::shared_ptr<PointwiseParams> getPointwiseHeuristics(
   // break point.
   int64_t gdim_right = 1;
 
+  // Bytes a row of tiles along BIDx reads with the chosen break point, see
+  // [ Pointwise Grid Swizzle ]
+  int64_t bidx_transfer_size = 0;
+
   auto broadcast_info = HeuristicSummaryEntry<
       HeuristicCompileTime::BroadcastMultiples>(
       data_cache, [&largest_out, &index_type]() {
@@ -397,6 +567,7 @@ std::shared_ptr<PointwiseParams> getPointwiseHeuristics(
           right_transfer_size =
               right_transfer_size * elem_counts[right_i] * rhs_byte_multiple;
         }
+        const int64_t left_transfer_size = cur_transfer_size;
         cur_transfer_size *= right_transfer_size;
 
         //  Continue if this break point doesn't save at least 10% of 1D
@@ -409,14 +580,14 @@ std::shared_ptr<PointwiseParams> getPointwiseHeuristics(
         // Need to be able to parallelize, don't use break if there's not
         // at least an unrolled warp.
         if (ceilDiv(cur_right_elem_count, max_unroll_factor) <=
-            at::cuda::getCurrentDeviceProperties()->warpSize) {
+            getDeviceModel().warp_size) {
           continue;
         }
 
         // If outer broadcast, or balanced broadcast:
         if (lhs_byte_multiple <= rhs_byte_multiple &&
             // If right transfer size is bigger than half of L2
-            at::cuda::getCurrentDeviceProperties()->l2CacheSize <
+            getDeviceModel().l2_size <
                 right_transfer_size * 2) {
           // flip BIDx and BIDy bindings
           flip_grid_binding = true;
@@ -442,6 +613,8 @@ std::shared_ptr<PointwiseParams> getPointwiseHeuristics(
 
         gdim_left = remainder_left;
         gdim_right = remainder_right;
+        bidx_transfer_size =
+            flip_grid_binding ? left_transfer_size : right_transfer_size;
       }
     }
   }
@@ -466,6 +639,46 @@ std::shared_ptr<PointwiseParams> getPointwiseHeuristics(
     params->unroll_factor = vectorize_factor;
   }
 
+  // Peel the misaligned elements instead if that vectorizes by a larger
+  // factor. See [ Misaligned Pointwise Vectorization ].
+  if (isOptionEnabled(EnableOption::MisalignedVectorize) &&
+      ir_utils::getViewOps(fusion).empty() && rfactor_reorder_map.empty()) {
+    const int64_t misaligned_factor = getMisalignedVectorizationFactor(
+        runtime_info,
+        largest_out,
+        vectorizable_inputs_outputs_entry.get(),
+        max_unroll_factor);
+    if (misaligned_factor > vectorize_factor) {
+      params->vectorize = true;
+      params->misaligned_vectorize = true;
+      params->unroll_factor = misaligned_factor;
+      // Only the innermost dimension is vectorized
+      break_point = (int)ref_root.size() - 1;
+      right_elem_count = elem_counts.back();
+      flip_grid_binding = false;
+      bdimx = kThreadX;
+      bdimy = 1;
+      // The left side is bound to BIDx, so BIDy is never split
+      gdim_left = 1;
+      gdim_right = 1;
+    }
+  }
+
+  // Only keep what doesn't depend on the sizes and alignments of the inputs,
+  // i.e., an unvectorized 1D schedule unrolled by what the data types allow
+  if (generic_kernel) {
+    params->vectorize = false;
+    params->misaligned_vectorize = false;
+    params->unroll_factor = max_unroll_factor;
+    break_point = 0;
+    right_elem_count = 0;
+    flip_grid_binding = false;
+    bdimx = kThreadX;
+    bdimy = 1;
+    gdim_left = 1;
+    gdim_right = 1;
+  }
+
   NVF_ERROR(right_elem_count > 0 || break_point == 0);
   NVF_ERROR(!(bdimy > 1 && gdim_right > 1));
 
@@ -482,12 +695,41 @@ std::shared_ptr<PointwiseParams> getPointwiseHeuristics(
     params->split_grid_y_dim = true;
   }
 
+  // See [ Pointwise Grid Swizzle ]
+  if (break_point > 0 && !params->misaligned_vectorize && !generic_kernel &&
+      !params->split_grid_y_dim) {
+    params->grid_swizzle_factor = scheduler_utils::getGridSwizzleFactor(
+        bidx_transfer_size, flip_grid_binding ? gdim_right : gdim_left);
+  }
+
+  // Launching millions of blocks for a huge 1D problem spends time on block
+  // scheduling and repeats the per-block setup, e.g., index computations
+  // hoisted out of the unrolled loop. Instead, launch as many blocks as can be
+  // resident and let them loop over the tiles.
+  int64_t persistent_gdimx = 0;
+  if (break_point == 0 && !params->misaligned_vectorize && !generic_kernel &&
+      isOptionEnabled(EnableOption::PointwisePersistentGrid)) {
+    const int64_t resident_blocks = device_multiprocessor_count *
+        std::max(
+            getDeviceModel().max_threads_per_sm /
+                bdimx,
+            (int64_t)1);
+    const int64_t num_tiles =
+        ceilDiv(n_elems, bdimx * (int64_t)params->unroll_factor);
+    if (num_tiles > resident_blocks * kMinWavesForPersistentGrid) {
+      params->persistent_grid = true;
+      persistent_gdimx = resident_blocks;
+      params->lparams.bind(persistent_gdimx, ParallelType::BIDx);
+    }
+  }
+
   if (isDebugDumpEnabled(DebugDumpOption::SchedulerDebug)) {
     debug() << "\n===== Pointwise Stats ========\n"
             << "num_elems: " << n_elems << "\n"
             << "elem_counts: " << elem_counts << "\n"
             << "max_input_dtype_size: " << max_input_dtype_size << "\n"
             << "vectorize_factor: " << vectorize_factor << std::endl
+            << "persistent_gdimx: " << persistent_gdimx << std::endl
             << "\n"
             << "rfactor_reorder_map: ";
     for (auto [i, j] : rfactor_reorder_map) {
@@ -700,7 +942,27 @@ void schedulePointwise(Fusion* fusion, const PointwiseParams& params) {
 
   int64_t unswitch_pos = 0;
   IterDomain* vectorize_id = nullptr;
-  if (params.break_point) {
+  if (params.misaligned_vectorize) {
+    // See [ Misaligned Pointwise Vectorization ]
+    NVF_ERROR(rhs_i >= 0);
+    if (params.break_point) {
+      // Order as [lhs_i, rhs_i]
+      reference_tv->reorder({{lhs_i, 0}, {-1, 1}});
+      reference_tv->axis(0)->parallelize(ParallelType::BIDx);
+    }
+    // [(outer), rhs_i] -> [(outer) | i-remainder, TIDx, MisalignedVectorize]
+    const int rhs_pos = params.break_point ? 1 : 0;
+    reference_tv->split(rhs_pos, params.unroll_factor);
+    reference_tv->split(rhs_pos, kThreadX);
+    if (!params.break_point) {
+      reference_tv->axis(0)->parallelize(ParallelType::BIDx);
+    }
+    reference_tv->axis(rhs_pos + 1)->parallelize(ParallelType::TIDx);
+    vectorize_id = reference_tv->axis(rhs_pos + 2);
+    // The lowering of MisalignedVectorize requires the cached inputs to be
+    // inlined right before the vectorized domain
+    unswitch_pos = rhs_pos + 2;
+  } else if (params.break_point) {
     // 2D parallelization scheme
     NVF_ERROR(rhs_i >= 0 && lhs_i >= 0);
 
@@ -747,6 +1009,11 @@ void schedulePointwise(Fusion* fusion, const PointwiseParams& params) {
     //[i-remainder | outer | Unswitch, Unroll, TIDx]
     if (params.split_block) {
       reference_tv->split(1, NamedScalar::getParallelDim(ParallelType::TIDy));
+    }
+    if (params.grid_swizzle_factor > 1) {
+      swizzlePointwiseGrid(reference_tv, params);
+    }
+    if (params.split_block) {
       if (params.flip_grid_binding) {
         // [BIDy | BIDx, TIDy | Unswitch, Unroll, TIDx]
         reference_tv->axis(1)->parallelize(ParallelType::BIDx);
@@ -848,6 +1115,15 @@ void schedulePointwise(Fusion* fusion, const PointwiseParams& params) {
       reference_tv->axis(3)->parallelize(ParallelType::TIDx);
     }
     unswitch_pos = 2;
+
+    if (params.persistent_grid) {
+      // [BIDx, Unswitch, ...] -> [serial, BIDx, Unswitch, ...], where the
+      // serial loop strides over the tiles by the number of blocks
+      reference_tv->axis(0)->parallelize(ParallelType::Serial);
+      reference_tv->split(0, NamedScalar::getParallelDim(ParallelType::BIDx));
+      reference_tv->axis(1)->parallelize(ParallelType::BIDx);
+      unswitch_pos = 3;
+    }
   }
 
   TransformPropagator propagator(reference_tv);
@@ -862,6 +1138,10 @@ void schedulePointwise(Fusion* fusion, const PointwiseParams& params) {
     std::vector<TensorView*> vectorized_tvs;
     bool should_vectorize_reference_tv = false;
     for (auto tv : inputs_outputs) {
+      if (params.misaligned_vectorize && !tv->isFusionInput()) {
+        // Outputs are not vectorized
+        continue;
+      }
       if (tv == reference_tv) {
         should_vectorize_reference_tv = true;
       }
@@ -877,9 +1157,12 @@ void schedulePointwise(Fusion* fusion, const PointwiseParams& params) {
     if (!vectorized_tvs.empty()) {
       // Aggressively mark with vectorized and cleanup later. That way we
       // don't have to manually specify parallelization outside the reference.
-      vectorize_id->parallelize(ParallelType::Vectorize);
+      const ParallelType vectorize_type = params.misaligned_vectorize
+          ? ParallelType::MisalignedVectorize
+          : ParallelType::Vectorize;
+      vectorize_id->parallelize(vectorize_type);
       scheduler_utils::parallelizeAllLike(
-          reference_tv, vectorized_tvs, {ParallelType::Vectorize});
+          reference_tv, vectorized_tvs, {vectorize_type});
       if (!should_vectorize_reference_tv) {
         vectorize_id->parallelize(ParallelType::Serial);
       }
@@ -184,6 +184,11 @@ class PointWiseScheduler : public SchedulerEntry {
       SchedulerRuntimeInfo& runtime_info,
       HeuristicSummary* data_cache = nullptr);
 
+  //! Builds an entry with deserialized parameters, see
+  //! [ Serialized Heuristics ] in scheduler/registry.h
+  explicit PointWiseScheduler(std::shared_ptr<HeuristicParams> params)
+      : SchedulerEntry(heuristicType(), std::move(params)) {}
+
   static bool canScheduleCompileTime(Fusion* fusion);
   static bool canScheduleRunTime(
       Fusion* fusion,
@@ -43,6 +43,25 @@ class PointwiseParams : public HeuristicParams {
   // Unroll or vectorization factor
   size_t unroll_factor = 1;
 
+  // Only used by the 1D schedule. Launch as many blocks as the device can run
+  // at once and have them loop over the tiles of the problem in a grid-stride
+  // loop, instead of launching one block per tile. The number of blocks is
+  // bound as gdimx of lparams.
+  bool persistent_grid = false;
+
+  // Vectorize the inputs with MisalignedVectorize, which peels the elements
+  // before the first aligned address and after the last one into scalar loops.
+  // Only the innermost dimension is vectorized and the outputs are not. See
+  // [ Misaligned Pointwise Vectorization ] in pointwise.cpp.
+  bool misaligned_vectorize = false;
+
+  // Only used by the 2D schedule. Number of consecutive tiles along the grid
+  // dimension bound to BIDy that consecutive blocks walk before moving along
+  // BIDx, so that the blocks running at once share the tiles of the operands
+  // broadcast along either dimension in L2. 1 keeps the row-major order. See
+  // [ Pointwise Grid Swizzle ] in pointwise.cpp.
+  int64_t grid_swizzle_factor = 1;
+
   using HeuristicParams::HeuristicParams;
 
   // Warning: Does not check launch parameters!
@@ -58,10 +77,39 @@ class PointwiseParams : public HeuristicParams {
         other.split_block == split_block &&
         other.split_grid_y_dim == split_grid_y_dim &&
         other.unroll_factor == unroll_factor &&
-        other.flip_grid_binding == flip_grid_binding;
+        other.flip_grid_binding == flip_grid_binding &&
+        other.persistent_grid == persistent_grid &&
+        other.misaligned_vectorize == misaligned_vectorize &&
+        other.grid_swizzle_factor == grid_swizzle_factor;
     return attr_equal;
   }
 
+  // A vectorized kernel is valid if the inputs allow a multiple of its
+  // vectorization factor, and an unvectorized kernel is valid regardless of
+  // the alignment.
+  bool canRunInputsOf(
+      const std::shared_ptr<HeuristicParams>& other_base) const override {
+    auto other_casted = std::dynamic_pointer_cast<PointwiseParams>(other_base);
+    if (other_casted == nullptr) {
+      return false;
+    }
+    const PointwiseParams& other = *other_casted;
+    bool attr_equal = other.cparams == cparams &&
+        other.break_point == break_point && other.split_block == split_block &&
+        other.split_grid_y_dim == split_grid_y_dim &&
+        other.flip_grid_binding == flip_grid_binding &&
+        other.persistent_grid == persistent_grid &&
+        other.misaligned_vectorize == misaligned_vectorize &&
+        other.grid_swizzle_factor == grid_swizzle_factor;
+    if (!attr_equal) {
+      return false;
+    }
+    if (!vectorize) {
+      return true;
+    }
+    return other.vectorize && other.unroll_factor % unroll_factor == 0;
+  }
+
   std::string toString() const override {
     std::stringstream ss;
     ss << "\n===== Pointwise Parameters ========\n"
@@ -77,9 +125,14 @@ class PointwiseParams : public HeuristicParams {
       if (split_grid_y_dim) {
         ss << "  Split y grid dim\n";
       }
+      if (grid_swizzle_factor > 1) {
+        ss << "  Grid swizzle factor: " << grid_swizzle_factor << "\n";
+      }
     }
     if (unroll_factor > 1) {
-      if (vectorize) {
+      if (misaligned_vectorize) {
+        ss << "Misaligned vectorize, Factor: " << unroll_factor << "\n";
+      } else if (vectorize) {
         ss << "Vectorize, Factor: " << unroll_factor << "\n";
       } else {
         ss << "Unroll, Factor: " << unroll_factor << "\n";
@@ -88,6 +141,9 @@ class PointwiseParams : public HeuristicParams {
     if (flip_grid_binding) {
       ss << "Flip BIDx/BIDy bindings\n";
     }
+    if (persistent_grid) {
+      ss << "Persistent grid\n";
+    }
     ss << "====================================\n";
     return ss.str();
   }
@@ -99,7 +155,10 @@ class PointwiseParams : public HeuristicParams {
         static_cast<size_t>(split_block) << 5 ^
         static_cast<size_t>(split_grid_y_dim) << 6 ^
         static_cast<size_t>(unroll_factor) << 9 ^
-        static_cast<size_t>(flip_grid_binding) << 10;
+        static_cast<size_t>(flip_grid_binding) << 10 ^
+        static_cast<size_t>(persistent_grid) << 11 ^
+        static_cast<size_t>(misaligned_vectorize) << 12 ^
+        static_cast<size_t>(grid_swizzle_factor) << 13;
     return attr_hash;
   }
 
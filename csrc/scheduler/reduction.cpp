@@ -8,7 +8,9 @@
 #include <ATen/cuda/CUDAContext.h>
 #include <debug.h>
 #include <instrumentation.h>
+#include <options.h>
 #include <scheduler/debug_utils.h>
+#include <scheduler/device_model.h>
 #include <scheduler/mark_aliases.h>
 #include <scheduler/reduction.h>
 #include <scheduler/reduction_utils.h>
@@ -39,6 +41,11 @@ int64_t roundDownPow2OrMultipleOf(const int64_t x, const int64_t multiple) {
   return std::max(std::max(round_down_multiple, round_down_pow2), (int64_t)1);
 }
 
+// The problem size the heuristics are computed for with GenericKernels, so
+// the parameters don't change with the actual sizes
+constexpr int64_t kGenericReductionNumel = 4096;
+constexpr int64_t kGenericIterationNumel = 65536;
+
 int64_t clamp(const int64_t val, const int64_t min_val, const int64_t max_val) {
   return std::min(std::max(val, min_val), max_val);
 }
@@ -75,11 +82,9 @@ std::shared_ptr<ReductionParams> innerReductionHeuristic(
   // WARNING: At some point we may want to generate heuristics for another
   // device that is not the current device.
   const int64_t device_max_threads_per_multiprocessor =
-      (int64_t)at::cuda::getCurrentDeviceProperties()
-          ->maxThreadsPerMultiProcessor;
+      getDeviceModel().max_threads_per_sm;
 
-  const int64_t device_multiprocessor_count =
-      (int64_t)at::cuda::getCurrentDeviceProperties()->multiProcessorCount;
+  const int64_t device_multiprocessor_count = getDeviceModel().sm_count;
 
   auto const max_unroll = ceilDiv(
       // Available unrolling based on size of data type
@@ -88,17 +93,15 @@ std::shared_ptr<ReductionParams> innerReductionHeuristic(
       scheduler_utils::lastPow2(
           std::max((int64_t)n_tensor_inputs >> 2, (int64_t)1)));
 
-  // Conservative value, could be set to larger based on arch if necessary.
-  constexpr int64_t l1_cache = (int64_t)32 * 1024;
-  // Could change per generation, but for l1 we want to consider active threads,
-  // not resident
-  constexpr int64_t active_threads = 1024;
+  // For l1 we want to consider active threads, not resident
+  const int64_t l1_cache = getDeviceModel().l1_size;
+  const int64_t active_threads = getDeviceModel().active_threads_per_sm;
 
   // if data fits in l2 and we need more parallelization in the reduction dim,
   // we can use a smaller warp size. While thread local data fits in l1, and
   // reduction dim is really small, we can use <32 threads per warp.
   const bool fits_in_l2 = n_elems * max_input_dtype_size * n_tensor_inputs <
-      at::cuda::getCurrentDeviceProperties()->l2CacheSize;
+      getDeviceModel().l2_size;
 
   // If it fits in l2, we just want to make sure each warp uses 32Bytes. Set
   // minimum warp as 16 threads instead of 32 as if we have a small reduction
@@ -377,6 +380,24 @@ std::shared_ptr<ReductionParams> innerReductionHeuristic(
     // require iterating over this entire function.
   }
 
+  // If each thread loops over its elements of the reduction more than once,
+  // reduce them into independent partial results so consecutive adds don't
+  // depend on each other, see [ Reduction Accumulators ]. Unrolling the
+  // iteration domain already interleaves independent reductions.
+  constexpr int64_t kMaxAccumulators = 8;
+  int64_t accumulators = 1;
+  const int64_t serial_iterations = ceilDiv(
+      inner_most_dimension_numel,
+      bdimx * inner_reduction_unroll_factor * gridim);
+  if (inner_reduction_unroll_factor > 1 && iter_unroll_factor == 1 &&
+      serial_iterations > 1) {
+    if (vectorize || inner_reduction_unroll_factor <= kMaxAccumulators) {
+      accumulators = inner_reduction_unroll_factor;
+    } else if (inner_reduction_unroll_factor % kMaxAccumulators == 0) {
+      accumulators = kMaxAccumulators;
+    }
+  }
+
   auto rparams = std::make_shared<ReductionParams>();
   rparams->fastest_dim = true;
   rparams->cross_block_inner_reduction = true;
@@ -385,7 +406,7 @@ std::shared_ptr<ReductionParams> innerReductionHeuristic(
   rparams->multiple_reds_per_blk = bdimy > 1;
   bool pad_bdimx = bdimx > 16 &&
       bdimx * bdimy <
-          (int64_t)at::cuda::getCurrentDeviceProperties()->maxThreadsPerBlock;
+          getDeviceModel().max_threads_per_block;
   // If barely just covering reduction dim, don't pad to the next warp
   pad_bdimx = pad_bdimx &&
       bdimx * inner_reduction_unroll_factor != inner_most_dimension_numel;
@@ -393,8 +414,7 @@ std::shared_ptr<ReductionParams> innerReductionHeuristic(
 
   if (rparams->pad_inner_reduction_to_warp) {
     // Adjust bdimx based on padding
-    auto min_warp_size =
-        (int64_t)at::cuda::getCurrentDeviceProperties()->warpSize;
+    auto min_warp_size = getDeviceModel().warp_size;
     bdimx = bdimx % min_warp_size == 0
         ? bdimx
         : bdimx + min_warp_size - bdimx % min_warp_size;
@@ -402,6 +422,7 @@ std::shared_ptr<ReductionParams> innerReductionHeuristic(
 
   rparams->unroll_factor_inner_reduction = inner_reduction_unroll_factor;
   rparams->vectorize_inner_reduction = vectorize;
+  rparams->accumulators_inner_reduction = accumulators;
 
   if (rparams->multiple_reds_per_blk) {
     rparams->block_dim_iter_dom = ParallelType::TIDy;
@@ -459,6 +480,17 @@ std::shared_ptr<ReductionParams> innerReductionHeuristic(
     }
   }
 
+  // See [ Circular Buffered Global Loads ]
+  rparams->circular_buffer_stages =
+      reduction_scheduler_utils::getCircularBufferStages(
+          bdimx * bdimy * bdimz * inner_reduction_unroll_factor *
+          iter_unroll_factor * outer_reduction_unroll_factor *
+          n_tensor_inputs * max_input_dtype_size);
+
+  // See [ Register Prefetched Global Loads ]
+  rparams->prefetch_cached_inputs = rparams->circular_buffer_stages == 0 &&
+      isOptionEnabled(EnableOption::RegisterPrefetch);
+
   rparams->lparams = LaunchParams(
       gdimx,
       gdimy,
@@ -514,11 +546,9 @@ std::shared_ptr<ReductionParams> outerReductionHeuristic(
     const size_t vectorize_factor) {
   // WARNING: Current device for codegen may not be the target device
   const int64_t device_max_threads_per_multiprocessor =
-      (int64_t)at::cuda::getCurrentDeviceProperties()
-          ->maxThreadsPerMultiProcessor;
+      getDeviceModel().max_threads_per_sm;
 
-  const int64_t device_multiprocessor_count =
-      (int64_t)at::cuda::getCurrentDeviceProperties()->multiProcessorCount;
+  const int64_t device_multiprocessor_count = getDeviceModel().sm_count;
 
   auto const max_unroll = ceilDiv(
       // Available unrolling based on size of data type
@@ -536,7 +566,7 @@ std::shared_ptr<ReductionParams> outerReductionHeuristic(
   // TODO: Could get a much more accurate estimation of it the problem fits in
   // L2
   const bool fits_in_l2 = n_elems * max_input_dtype_size * n_tensor_inputs <
-      at::cuda::getCurrentDeviceProperties()->l2CacheSize;
+      getDeviceModel().l2_size;
 
   const int64_t min_warp_size = fits_in_l2 ? 16 : 32;
 
@@ -788,6 +818,9 @@ std::shared_ptr<ReductionParams> outerReductionHeuristic(
       gdimy = std::min(grdim, scheduler_utils::y_grid_limit);
     }
   }
+  // See [ Single-Pass Grid Reduction ]
+  rparams->single_pass_grid_reduction = rparams->cross_grid_inner_reduction &&
+      isOptionEnabled(EnableOption::SinglePassGridReduction);
   rparams->multiple_reds_per_blk = bdimx > 1 || iter_unroll_factor > 1;
 
   if (rparams->multiple_reds_per_blk) {
@@ -823,6 +856,16 @@ std::shared_ptr<ReductionParams> outerReductionHeuristic(
     rparams->vectorize_iter_dom = vectorize;
   }
 
+  // See [ Circular Buffered Global Loads ]
+  rparams->circular_buffer_stages =
+      reduction_scheduler_utils::getCircularBufferStages(
+          bdimx * bdimy * inner_reduction_unroll_factor * iter_unroll_factor *
+          n_tensor_inputs * max_input_dtype_size);
+
+  // See [ Register Prefetched Global Loads ]
+  rparams->prefetch_cached_inputs = rparams->circular_buffer_stages == 0 &&
+      isOptionEnabled(EnableOption::RegisterPrefetch);
+
   rparams->lparams = LaunchParams(
       gdimx,
       gdimy,
@@ -844,6 +887,35 @@ std::shared_ptr<ReductionParams> outerReductionHeuristic(
   return rparams;
 }
 
+//! Whether the cross-grid reductions of fusion can accumulate into its
+//! outputs with atomics, i.e., all of them are float or double sums into
+//! outputs that aren't used otherwise. See [ Atomic Grid Reduction ]
+bool canReduceWithAtomics(Fusion* fusion) {
+  if (ir_utils::hasOpsOfType<WelfordOp, GroupedReductionOp>(fusion)) {
+    return false;
+  }
+  for (auto rop : ir_utils::getOpsOfType<ReductionOp>(fusion)) {
+    auto out_tv = rop->out()->as<TensorView>();
+    if (rop->getReductionOpType() != BinaryOpType::Add ||
+        (out_tv->dtype() != DataType::Float &&
+         out_tv->dtype() != DataType::Double) ||
+        !out_tv->isFusionOutput() || !out_tv->uses().empty()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+//! Requests atomic grid reductions for the reductions into the outputs of
+//! fusion
+void requestAtomicGridReductions(Fusion* fusion) {
+  for (auto tv : ir_utils::filterByType<TensorView>(fusion->outputs())) {
+    if (auto rop = dynamic_cast<ReductionOp*>(tv->definition())) {
+      rop->requestAtomicGridReduction();
+    }
+  }
+}
+
 } // namespace
 
 ReductionScheduler::ReductionScheduler(
@@ -1133,6 +1205,20 @@ std::shared_ptr<ReductionParams> getReductionHeuristics(
   // Protect heuristics div by 0:
   n_tensor_inputs = std::max(n_tensor_inputs, 1l);
 
+  // See [ Generic Kernels ]
+  if (isOptionEnabled(EnableOption::GenericKernels)) {
+    auto heuristic = reductionHeuristic(
+        kGenericReductionNumel,
+        kGenericIterationNumel,
+        kGenericReductionNumel,
+        properties.fastest_dim_reduction,
+        n_tensor_inputs,
+        max_dtype_size,
+        /*vectorize_factor=*/1);
+    heuristic->cparams.index_type = runtime_info.getIndexType();
+    return heuristic;
+  }
+
   auto heuristic = reductionHeuristic(
       properties.total_reduction_numel,
       properties.total_iteration_numel,
@@ -1142,6 +1228,15 @@ std::shared_ptr<ReductionParams> getReductionHeuristics(
       max_dtype_size,
       vectorize_factor);
   heuristic->cparams.index_type = runtime_info.getIndexType();
+
+  // See [ Atomic Grid Reduction ]
+  if ((heuristic->cross_grid_inner_reduction ||
+       heuristic->cross_grid_outer_reduction) &&
+      isOptionEnabled(EnableOption::AtomicGridReduction) &&
+      canReduceWithAtomics(fusion)) {
+    heuristic->atomic_grid_reduction = true;
+    heuristic->single_pass_grid_reduction = false;
+  }
   return heuristic;
 }
 
@@ -1152,8 +1247,17 @@ void scheduleReduction(Fusion* fusion, const ReductionParams& rparams) {
 
   bool unroll = rparams.isUnrolled();
 
-  // Cache inputs if unrolled
-  auto cached_inputs = scheduler_utils::cacheInputs(fusion, unroll);
+  // Cache inputs if unrolled, circular buffered or prefetched
+  auto cached_inputs = scheduler_utils::cacheInputs(
+      fusion,
+      unroll || rparams.circular_buffer_stages > 1 ||
+          rparams.prefetch_cached_inputs);
+
+  // The outputs of atomic grid reductions are not cached, so the request
+  // has to be made before caching. See [ Atomic Grid Reduction ]
+  if (rparams.atomic_grid_reduction) {
+    requestAtomicGridReductions(fusion);
+  }
 
   // Cache and fork outputs
   auto cached_outputs = scheduler_utils::cacheAndForkOutputs(fusion, unroll);
@@ -1225,6 +1329,27 @@ void scheduleReduction(Fusion* fusion, const ReductionParams& rparams) {
       cached_inputs,
       cached_outputs);
 
+  // See [ Single-Pass Grid Reduction ]
+  if (rparams.single_pass_grid_reduction) {
+    for (auto tv : reduction_tvs) {
+      if (auto rop = dynamic_cast<ReductionOp*>(tv->definition())) {
+        rop->requestSinglePassGridReduction();
+      }
+    }
+  }
+
+  // rFactor recreates the reduction ops, so request again
+  if (rparams.atomic_grid_reduction) {
+    requestAtomicGridReductions(fusion);
+  }
+
+  reduction_scheduler_utils::circularBufferCachedInputs(
+      cached_inputs, rparams.circular_buffer_stages);
+
+  if (rparams.prefetch_cached_inputs) {
+    reduction_scheduler_utils::prefetchCachedInputs(cached_inputs);
+  }
+
   scheduler_utils::promoteProducerMemoryTypes(fusion, cached_inputs);
 
   // TODO(#1401): We could let segmentation split a partially alias-producing
@@ -46,6 +46,10 @@ class ReductionParams : public HeuristicParams {
   int64_t unroll_factor_inner_reduction = 1;
   // vectorize instead of unroll
   bool vectorize_inner_reduction = false;
+  // Number of partial results each thread serially reduces the unrolled or
+  // vectorized elements of a non-persistent inner reduction into, see
+  // [ Reduction Accumulators ]
+  int64_t accumulators_inner_reduction = 1;
   // Split grid dim for iteration axis in case it's too large for cuda
   bool split_grid_dim_inner_reduction = false;
   // Pad inner dimension to nearest warp
@@ -136,6 +140,33 @@ class ReductionParams : public HeuristicParams {
   // use shared memory for persistent buffer, if false, will use registers
   bool shared_mem_persistent_buffer = false;
 
+  // with shared memory persistent buffers, the sum of the bytes per element of
+  // the persistent buffers that are kept in registers instead, see
+  // [ Hybrid Persistent Buffers ]
+  int64_t register_persistent_buffer_bytes = 0;
+
+  // load shared memory persistent buffers of inputs with TMA, see
+  // [ TMA Loads of Persistent Buffers ]
+  bool tma_load_persistent_buffer = false;
+
+  // number of stages to circular buffer cached inputs in shared memory with,
+  // loaded with cp.async. 0 disables circular buffering. See
+  // [ Circular Buffered Global Loads ]
+  int64_t circular_buffer_stages = 0;
+
+  // load the cached inputs of the next iteration of the serial reduction loop
+  // into registers before the math of the current one, see
+  // [ Register Prefetched Global Loads ]
+  bool prefetch_cached_inputs = false;
+
+  // accumulate the partial results of the cross-grid reduction in the order
+  // of the blocks in a single pass, see [ Single-Pass Grid Reduction ]
+  bool single_pass_grid_reduction = false;
+
+  // accumulate the partial results of the cross-grid reduction into the
+  // outputs with atomics, see [ Atomic Grid Reduction ]
+  bool atomic_grid_reduction = false;
+
  public:
   using HeuristicParams::HeuristicParams;
 
@@ -156,6 +187,7 @@ class ReductionParams : public HeuristicParams {
         other.cross_grid_inner_reduction == cross_grid_inner_reduction &&
         other.unroll_factor_inner_reduction == unroll_factor_inner_reduction &&
         other.vectorize_inner_reduction == vectorize_inner_reduction &&
+        other.accumulators_inner_reduction == accumulators_inner_reduction &&
         other.split_grid_dim_inner_reduction ==
             split_grid_dim_inner_reduction &&
         other.pad_inner_reduction_to_warp == pad_inner_reduction_to_warp &&
@@ -181,7 +213,14 @@ class ReductionParams : public HeuristicParams {
         other.vectorization_factor_outer == vectorization_factor_outer &&
         other.vectorization_factor_tmp_gmem_write ==
             vectorization_factor_tmp_gmem_write &&
-        other.shared_mem_persistent_buffer == shared_mem_persistent_buffer;
+        other.shared_mem_persistent_buffer == shared_mem_persistent_buffer &&
+        other.register_persistent_buffer_bytes ==
+            register_persistent_buffer_bytes &&
+        other.tma_load_persistent_buffer == tma_load_persistent_buffer &&
+        other.circular_buffer_stages == circular_buffer_stages &&
+        other.prefetch_cached_inputs == prefetch_cached_inputs &&
+        other.single_pass_grid_reduction == single_pass_grid_reduction &&
+        other.atomic_grid_reduction == atomic_grid_reduction;
 
     if (other.static_bdimy || static_bdimy) {
       attr_equal = attr_equal && other.lparams.bdimy() == lparams.bdimy();
@@ -268,11 +307,39 @@ class ReductionParams : public HeuristicParams {
     if (unroll_factor_inner_reduction > 1) {
       ss << "factor " << unroll_factor_inner_reduction;
     }
+    if (accumulators_inner_reduction > 1) {
+      ss << " / accumulators " << accumulators_inner_reduction;
+    }
 
     if (compute_persistent_buffer_with_first_consumer) {
       ss << "\ncomputeWith persistent buffers";
     }
 
+    if (register_persistent_buffer_bytes > 0) {
+      ss << "\nRegister persistent buffer bytes: "
+         << register_persistent_buffer_bytes;
+    }
+
+    if (tma_load_persistent_buffer) {
+      ss << "\nTMA load persistent buffers";
+    }
+
+    if (circular_buffer_stages > 0) {
+      ss << "\nCircular buffer stages: " << circular_buffer_stages;
+    }
+
+    if (prefetch_cached_inputs) {
+      ss << "\nPrefetch cached inputs";
+    }
+
+    if (single_pass_grid_reduction) {
+      ss << "\nSingle-pass grid reduction";
+    }
+
+    if (atomic_grid_reduction) {
+      ss << "\nAtomic grid reduction";
+    }
+
     ss << "\n" << lparams.toString();
     ss << cparams.toString() << "\n";
     ss << "====================================\n";
@@ -305,7 +372,14 @@ class ReductionParams : public HeuristicParams {
         static_cast<size_t>(batches_per_block_outer_reduction) << (bits - 21) ^
         static_cast<size_t>(unroll_factor_outer_reduction) << (bits - 22) ^
         static_cast<size_t>(compute_persistent_buffer_with_first_consumer)
-            << (bits - 23);
+            << (bits - 23) ^
+        static_cast<size_t>(tma_load_persistent_buffer) << (bits - 24) ^
+        static_cast<size_t>(single_pass_grid_reduction) << (bits - 25) ^
+        static_cast<size_t>(circular_buffer_stages) << (bits - 28) ^
+        static_cast<size_t>(atomic_grid_reduction) << (bits - 29) ^
+        static_cast<size_t>(accumulators_inner_reduction) << (bits - 33) ^
+        static_cast<size_t>(prefetch_cached_inputs) << (bits - 34) ^
+        static_cast<size_t>(register_persistent_buffer_bytes) << (bits - 40);
     return attr_hash;
   }
 
@@ -7,16 +7,21 @@
 // clang-format on
 #include <scheduler/reduction_utils.h>
 
+#include <debug.h>
 #include <expr_evaluator.h>
 #include <inlining.h>
 #include <ir/cloner.h>
 #include <ir/utils.h>
 #include <maxinfo_propagator.h>
 #include <ops/arith.h>
+#include <options.h>
+#include <scheduler/device_model.h>
 #include <scheduler/registry.h>
 #include <scheduler/utils.h>
 #include <transform_replay.h>
 
+#include <ATen/cuda/CUDAContext.h>
+
 namespace nvfuser {
 
 namespace reduction_scheduler_utils {
@@ -61,6 +66,19 @@ TensorView* scheduleReductionTV(
       !(rparams.unroll_factor_iter_dom > 1 && !has_iter_axis),
       "Unrolling on iter domain requires an iter domain.");
 
+  const int64_t accumulators = rparams.accumulators_inner_reduction;
+  NVF_ERROR(
+      accumulators == 1 ||
+          (rparams.fastest_dim && !rparams.persistent_kernel &&
+           rparams.unroll_factor_inner_reduction % accumulators == 0 &&
+           (!rparams.vectorize_inner_reduction ||
+            rparams.unroll_factor_inner_reduction == accumulators)),
+      "Invalid number of accumulators of the inner reduction: ",
+      accumulators);
+  // Leaf domain of the partial results of the non-persistent inner reduction,
+  // see [ Reduction Accumulators ]
+  IterDomain* accumulator_id = nullptr;
+
   auto vectorize = [&reduction_tv](int axis, int64_t factor) {
     reduction_tv->split(axis, factor);
     reduction_tv->axis(axis + 1)->parallelize(ParallelType::Vectorize);
@@ -166,6 +184,9 @@ TensorView* scheduleReductionTV(
     // [Grid Split, Remainder, unswitch, unroll, thread dim, vectorize]
     if (rparams.vectorize_inner_reduction) {
       vectorize(inner_reduce_axis, rparams.unroll_factor_inner_reduction);
+      if (accumulators > 1) {
+        accumulator_id = reduction_tv->axis(inner_reduce_axis + 1);
+      }
     }
 
     if (rparams.cross_block_inner_reduction) {
@@ -178,9 +199,20 @@ TensorView* scheduleReductionTV(
     if (!rparams.vectorize_inner_reduction &&
         rparams.unroll_factor_inner_reduction > 1) {
       inner_unroll(inner_reduce_axis, rparams.unroll_factor_inner_reduction);
+      if (accumulators > 1) {
+        // [unroll] -> [unroll / accumulators, accumulators]
+        reduction_tv->split(inner_reduce_axis + 1, accumulators);
+        accumulator_id = reduction_tv->axis(inner_reduce_axis + 2);
+      }
     }
 
-    inner_unswitch(inner_reduce_axis);
+    // The remainder is the loop cached inputs are circular buffered or
+    // prefetched over, see [ Circular Buffered Global Loads ] and
+    // [ Register Prefetched Global Loads ]
+    if (rparams.circular_buffer_stages < 2 &&
+        !rparams.prefetch_cached_inputs) {
+      inner_unswitch(inner_reduce_axis);
+    }
     if (rparams.cross_grid_inner_reduction) {
       if (rparams.split_grid_dim_inner_reduction) {
         outer_parallel(inner_reduce_axis, rparams.grid_dim_inner_reduction);
@@ -266,7 +298,9 @@ TensorView* scheduleReductionTV(
     }
   }
 
-  auto reduction_rf_tv = sortAndRFactor(reduction_tv);
+  auto reduction_rf_tv = accumulator_id != nullptr
+      ? sortAndRFactorAccumulators(reduction_tv, accumulator_id)
+      : sortAndRFactor(reduction_tv);
 
   // In the case of outer grid persistence, make sure the vectorized
   // domain placed at the innermost position.
@@ -351,6 +385,44 @@ bool isGridAllreduce(TensorView* reduction_tv) {
   return false;
 }
 
+namespace {
+
+// Turns the load of tv into a 1D bulk copy of its innermost domain, see
+// [ TMA Loads of Persistent Buffers ]. Leaves tv unchanged if it isn't
+// loaded from a contiguous global tensor or the innermost domain isn't
+// scheduled as the innermost leaf domains.
+void scheduleTmaLoad(TensorView* tv) {
+  auto ldst = dynamic_cast<LoadStoreOp*>(tv->definition());
+  if (ldst == nullptr || ldst->opType() != LoadStoreOpType::Set ||
+      !ldst->in()->isFusionInput() ||
+      tv->getMemoryType() != MemoryType::Shared || tv->hasAllocation()) {
+    return;
+  }
+  auto in_tv = ldst->in()->as<TensorView>();
+  if (in_tv->hasAllocation() || in_tv->domain()->contiguity().empty() ||
+      !in_tv->domain()->contiguity().back().value_or(false)) {
+    return;
+  }
+
+  IterDomain* inner_id = tv->getRootDomain().back();
+  auto inner_leaf_ids = ir_utils::getLeafIDsSplitFrom(tv, inner_id);
+  if (!inner_leaf_ids.has_value() ||
+      inner_leaf_ids->size() >= tv->getLeafDomain().size() ||
+      !std::equal(
+          inner_leaf_ids->begin(),
+          inner_leaf_ids->end(),
+          tv->getLeafDomain().end() - (int64_t)inner_leaf_ids->size())) {
+    return;
+  }
+
+  for (auto id : *inner_leaf_ids) {
+    id->parallelize(ParallelType::Bulk);
+  }
+  ldst->setOpType(LoadStoreOpType::CpAsyncBulk);
+}
+
+} // namespace
+
 void multiReductionInliner(
     Fusion* fusion,
     TensorView* reduction_tv,
@@ -361,7 +433,8 @@ void multiReductionInliner(
     std::vector<TensorView*> reduction_tvs,
     std::vector<TensorView*> cached_inputs,
     std::vector<std::pair<TensorView*, TensorView*>> cached_outputs,
-    std::vector<TensorView*> dummy_outputs) {
+    std::vector<TensorView*> dummy_outputs,
+    std::vector<TensorView*> tma_load_tvs) {
   // Propagate transformations before we rfactor the other reductions
   propagateTransformation(reference_tv);
   // If reduction_tv is rfactored, rfactor all reductions.
@@ -385,10 +458,164 @@ void multiReductionInliner(
     fusion->removeOutput(output);
   }
 
+  // Bulk domains are not inlined, so this needs to be done before inlining
+  for (auto tv : tma_load_tvs) {
+    scheduleTmaLoad(tv);
+  }
+
   // Inline the schedule
   inlineMost();
 }
 
+int64_t getCircularBufferStages(int64_t bytes_per_stage) {
+  if (!isOptionEnabled(EnableOption::CpAsyncPipeline)) {
+    return 0;
+  }
+  const auto& device_model = getDeviceModel();
+  if (device_model.major < 8 || bytes_per_stage <= 0) {
+    return 0;
+  }
+  int64_t stages = kCircularBufferStages;
+  const auto& args = getEnableOptionArguments(EnableOption::CpAsyncPipeline);
+  if (!args.empty()) {
+    try {
+      stages = std::stoi(args.at(0));
+    } catch (const std::exception& e) {
+      debug() << "skip invalid argument for CpAsyncPipeline, arg = "
+              << args.at(0) << std::endl;
+    }
+  }
+  const int64_t max_stages = device_model.smem_per_sm / 4 / bytes_per_stage;
+  stages = std::min(stages, max_stages);
+  return stages >= 2 ? stages : 0;
+}
+
+namespace {
+
+// Returns the position of the loop tv would be circular buffered over, see
+// getDoubleBufferAxisPosition, if it's a serial loop that isn't trivially
+// short
+std::optional<int64_t> getCircularBufferPosition(TensorView* tv) {
+  const auto& leaf_domain = tv->getLeafDomain();
+  const int64_t first_unroll_pos = std::distance(
+      leaf_domain.begin(),
+      std::find_if(leaf_domain.begin(), leaf_domain.end(), [](auto id) {
+        return id->getParallelType() == ParallelType::Unroll;
+      }));
+  const int64_t unroll_or_ca_pos =
+      std::min((int64_t)tv->getComputeAtPosition(), first_unroll_pos);
+  for (int64_t i = unroll_or_ca_pos - 1; i >= 0; --i) {
+    IterDomain* id = tv->axis((int)i);
+    if (isParallelTypeThread(id->getParallelType()) || id->isBroadcast()) {
+      continue;
+    }
+    if (id->getParallelType() != ParallelType::Serial ||
+        id->extent()->isOneInt()) {
+      return std::nullopt;
+    }
+    return i;
+  }
+  return std::nullopt;
+}
+
+} // namespace
+
+std::vector<TensorView*> circularBufferCachedInputs(
+    const std::vector<TensorView*>& cached_inputs,
+    int64_t stages) {
+  std::vector<TensorView*> circular_buffered_tvs;
+  if (stages < 2) {
+    return circular_buffered_tvs;
+  }
+  for (auto tv : cached_inputs) {
+    auto ldst = dynamic_cast<LoadStoreOp*>(tv->definition());
+    if (ldst == nullptr || ldst->opType() != LoadStoreOpType::Set ||
+        !ldst->in()->isFusionInput() ||
+        tv->getMemoryType() != MemoryType::Local || tv->hasComputeWith() ||
+        !getCircularBufferPosition(tv).has_value()) {
+      continue;
+    }
+    int64_t vector_bytes = dataTypeSize(tv->dtype());
+    auto vectorized_id = std::find_if(
+        tv->getLeafDomain().begin(), tv->getLeafDomain().end(), [](auto id) {
+          return id->getParallelType() == ParallelType::Vectorize;
+        });
+    if (vectorized_id != tv->getLeafDomain().end()) {
+      if (!(*vectorized_id)->extent()->isConstInt()) {
+        continue;
+      }
+      vector_bytes *= (*vectorized_id)->extent()->evaluate().as<int64_t>();
+    }
+    if (vector_bytes != 4 && vector_bytes != 8 && vector_bytes != 16) {
+      continue;
+    }
+
+    tv->setMemoryType(MemoryType::Shared);
+    ldst->setOpType(LoadStoreOpType::CpAsync);
+    // .cg bypasses L1, which the streamed inputs don't benefit from, but it
+    // only supports 16 bytes
+    ldst->setCacheOp(
+        vector_bytes == 16 ? CacheOp::Global : CacheOp::AllLevels);
+    tv->circularBuffer((unsigned int)stages);
+    circular_buffered_tvs.push_back(tv);
+  }
+  return circular_buffered_tvs;
+}
+
+std::vector<TensorView*> prefetchCachedInputs(
+    const std::vector<TensorView*>& cached_inputs) {
+  std::vector<TensorView*> prefetched_tvs;
+  if (cached_inputs.empty()) {
+    return prefetched_tvs;
+  }
+  ComputeAtMap ca_map(cached_inputs.front()->fusion());
+  TensorView* loop_tv = nullptr;
+  int64_t loop_pos = -1;
+  for (auto tv : cached_inputs) {
+    auto ldst = dynamic_cast<LoadStoreOp*>(tv->definition());
+    if (ldst == nullptr || ldst->opType() != LoadStoreOpType::Set ||
+        !ldst->in()->isFusionInput() ||
+        tv->getMemoryType() != MemoryType::Local || tv->hasComputeWith() ||
+        tv->isDoubleBuffered() || tv->isCircularBuffered()) {
+      continue;
+    }
+    auto pos = getCircularBufferPosition(tv);
+    if (!pos.has_value()) {
+      continue;
+    }
+    // Only loads at the top level of the body of the loop are rotated, not
+    // the ones in inner loops they share with their consumers
+    const bool in_inner_loop = std::any_of(
+        tv->getLeafDomain().begin() + *pos + 1,
+        tv->getLeafDomain().begin() + tv->getComputeAtPosition(),
+        [](IterDomain* id) {
+          return !isParallelTypeThread(id->getParallelType()) &&
+              !id->isBroadcast() && !id->extent()->isOneInt();
+        });
+    if (in_inner_loop) {
+      continue;
+    }
+    // A loop is rotated once, so all the loads must be in the same loop
+    if (loop_tv == nullptr) {
+      loop_tv = tv;
+      loop_pos = *pos;
+    } else if (!ca_map.areMapped(
+                   loop_tv->axis((int)loop_pos),
+                   tv->axis((int)*pos),
+                   IdMappingMode::LOOP)) {
+      continue;
+    }
+    prefetched_tvs.push_back(tv);
+  }
+  if (loop_tv != nullptr) {
+    scheduler_utils::rotateLoop(
+        loop_tv,
+        loop_pos,
+        {prefetched_tvs.begin(), prefetched_tvs.end()});
+  }
+  return prefetched_tvs;
+}
+
 void propagateTransformation(
     TensorView* reference_tv,
     const std::unordered_set<TensorView*>& boundaryNodesSet) {
@@ -398,6 +625,25 @@ void propagateTransformation(
       .traverse(&propagator);
 }
 
+namespace {
+
+// Clears unrolling and vectorization of tv and its siblings, e.g., of the
+// tensor that combines partial accumulators, see [ Reduction Accumulators ]
+void serializeUnrolledDomains(TensorView* tv) {
+  std::vector<TensorView*> tvs = ir_utils::siblingTvsOf(tv);
+  tvs.push_back(tv);
+  for (auto tv_ : tvs) {
+    for (auto id : tv_->getLeafDomain()) {
+      if (id->getParallelType() == ParallelType::Unroll ||
+          id->getParallelType() == ParallelType::Vectorize) {
+        id->parallelize(ParallelType::Serial);
+      }
+    }
+  }
+}
+
+} // namespace
+
 void propagateRFactor(
     TensorView* reference_tv,
     TensorView* reduction_tv,
@@ -407,17 +653,34 @@ void propagateRFactor(
   // pattern equivalence but have different number of broadcasts, so the
   // position in the reference tensor is not necessary the same as the
   // position in other reduction TVs.
-  std::unordered_set<int> non_broadcast_rfactor_axes_ir;
-  int non_broadcast_pos_ir = 0;
-  for (const auto i : c10::irange(reference_tv->nDims())) {
-    if (reference_tv->axis((int)i)->isBroadcast()) {
-      continue;
-    }
-    if (reference_tv->axis((int)i)->isReduction() &&
-        reference_tv->axis((int)i)->isRFactorProduct()) {
-      non_broadcast_rfactor_axes_ir.insert(non_broadcast_pos_ir);
+  auto non_broadcast_rfactor_axes = [](TensorView* rfactor_tv) {
+    std::unordered_set<int> non_broadcast_rfactor_axes_ir;
+    int non_broadcast_pos_ir = 0;
+    for (const auto i : c10::irange(rfactor_tv->nDims())) {
+      if (rfactor_tv->axis((int)i)->isBroadcast()) {
+        continue;
+      }
+      if (rfactor_tv->axis((int)i)->isReduction() &&
+          rfactor_tv->axis((int)i)->isRFactorProduct()) {
+        non_broadcast_rfactor_axes_ir.insert(non_broadcast_pos_ir);
+      }
+      non_broadcast_pos_ir++;
     }
-    non_broadcast_pos_ir++;
+    return non_broadcast_rfactor_axes_ir;
+  };
+  const auto non_broadcast_rfactor_axes_ir =
+      non_broadcast_rfactor_axes(reference_tv);
+
+  // If reference_tv holds partial accumulators, it's not the producer of
+  // reduction_tv but of the tensor that combines them, see
+  // [ Reduction Accumulators ]
+  std::optional<std::unordered_set<int>> non_broadcast_accumulator_axes_ir;
+  const auto producer_tvs = ir_utils::producerTvsOf(reduction_tv);
+  if (!producer_tvs.empty() &&
+      std::find(producer_tvs.begin(), producer_tvs.end(), reference_tv) ==
+          producer_tvs.end()) {
+    non_broadcast_accumulator_axes_ir =
+        non_broadcast_rfactor_axes(producer_tvs.front());
   }
 
   for (auto reduction_tv_ : reduction_tvs) {
@@ -430,6 +693,12 @@ void propagateRFactor(
           reduction_tv_,
           reduction_scheduler_utils::addBackBroadcasts(
               reduction_tv_, non_broadcast_rfactor_axes_ir));
+      if (non_broadcast_accumulator_axes_ir.has_value()) {
+        serializeUnrolledDomains(ir_utils::rfactorHelper(
+            reduction_tv_,
+            reduction_scheduler_utils::addBackBroadcasts(
+                reduction_tv_, *non_broadcast_accumulator_axes_ir)));
+      }
     }
   }
 }
@@ -483,6 +752,22 @@ void propagateParallelization(
       }
     }
 
+    // Lookup tensors are not cached, so the outputs of index_select ops
+    // reading them are vectorized instead, see
+    // scheduler_utils::getInputsOutputsWithInnerDim
+    if (vectorize) {
+      for (auto index_select :
+           ir_utils::getOpsOfType<IndexSelectOp>(reference_tv->fusion())) {
+        if (std::find(
+                vectorizable_inputs_outputs.begin(),
+                vectorizable_inputs_outputs.end(),
+                index_select->lookupTv()) !=
+            vectorizable_inputs_outputs.end()) {
+          are_unrolled.emplace(index_select->output(0)->as<TensorView>());
+        }
+      }
+    }
+
     for (auto cached_output_pair : cached_outputs) {
       auto output = cached_output_pair.second;
       if (vectorize) {
@@ -651,9 +936,9 @@ struct id_lt {
     return idPos(id0) < idPos(id1);
   }
 };
-} // namespace
 
-TensorView* sortAndRFactor(TensorView* reference_tv) {
+// Sorts the leaf domain of reference_tv as documented for sortAndRFactor
+void sortLeafDomain(TensorView* reference_tv) {
   auto domain = reference_tv->getLeafDomain();
   std::sort(domain.begin(), domain.end(), id_lt());
   std::unordered_map<int, int> reorder_map;
@@ -670,6 +955,12 @@ TensorView* sortAndRFactor(TensorView* reference_tv) {
     reorder_map[old_i] = new_i;
   }
   reference_tv->reorder(reorder_map);
+}
+
+} // namespace
+
+TensorView* sortAndRFactor(TensorView* reference_tv) {
+  sortLeafDomain(reference_tv);
 
   std::vector<int> rfactor_axes;
   std::vector<int> rfactor_axes_no_unswitch;
@@ -702,6 +993,51 @@ TensorView* sortAndRFactor(TensorView* reference_tv) {
   return ir_utils::rfactorHelper(reference_tv, rfactor_axes);
 }
 
+TensorView* sortAndRFactorAccumulators(
+    TensorView* reference_tv,
+    IterDomain* accumulator_id) {
+  sortLeafDomain(reference_tv);
+  NVF_ERROR(
+      std::find(
+          reference_tv->getLeafDomain().begin(),
+          reference_tv->getLeafDomain().end(),
+          accumulator_id) != reference_tv->getLeafDomain().end(),
+      "Accumulator domain ",
+      accumulator_id->toString(),
+      " is not a leaf domain of ",
+      reference_tv->toString());
+
+  // Reduce the serial domains into the accumulators
+  std::vector<int> rfactor_axes;
+  for (int axis_i = 0; axis_i < (int)reference_tv->nDims(); axis_i++) {
+    auto id = reference_tv->axis(axis_i);
+    if (id->isReduction() && !id->isThread() && id != accumulator_id) {
+      rfactor_axes.emplace_back(axis_i);
+    }
+  }
+  NVF_ERROR(
+      !rfactor_axes.empty(),
+      "No serial reduction to accumulate in ",
+      reference_tv->toString());
+  auto accumulators_tv = ir_utils::rfactorHelper(reference_tv, rfactor_axes);
+
+  // Combine the accumulators, which are the only serial reduction left
+  std::vector<int> accumulator_axes;
+  for (int axis_i = 0; axis_i < (int)reference_tv->nDims(); axis_i++) {
+    auto id = reference_tv->axis(axis_i);
+    if (id->isReduction() && !id->isThread()) {
+      accumulator_axes.emplace_back(axis_i);
+    }
+  }
+  auto combined_tv = ir_utils::rfactorHelper(reference_tv, accumulator_axes);
+
+  // Like the reduction of the reference, see propagateParallelization, the
+  // accumulators are combined in a serial loop
+  serializeUnrolledDomains(combined_tv);
+
+  return accumulators_tv;
+}
+
 namespace {
 // If project_to_inputs is true, take all projectable persistent buffers,
 // and move them to the inputs. Otherwise, try to project to their immediate
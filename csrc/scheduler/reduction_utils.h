@@ -27,6 +27,8 @@ TensorView* scheduleReductionTV(
     bool has_iter_axis);
 
 // Inlining function intended for single or multi reduction fusions.
+// tma_load_tvs are loaded with 1D bulk copies where possible, see
+// [ TMA Loads of Persistent Buffers ]
 void multiReductionInliner(
     Fusion* fusion,
     TensorView* reduction_tv,
@@ -37,7 +39,76 @@ void multiReductionInliner(
     std::vector<TensorView*> reduction_tvs,
     std::vector<TensorView*> cached_inputs,
     std::vector<std::pair<TensorView*, TensorView*>> cached_outputs,
-    std::vector<TensorView*> dummy_outputs = {});
+    std::vector<TensorView*> dummy_outputs = {},
+    std::vector<TensorView*> tma_load_tvs = {});
+
+//! [ Circular Buffered Global Loads ]
+//!
+//! Reduction and normalization kernels hide the latency of their global loads
+//! only by occupancy and unrolling. With NVFUSER_ENABLE=cp_async_pipeline, on
+//! Ampere and newer, cached inputs are instead loaded with cp.async into
+//! shared memory that is circular buffered over the innermost serial loop
+//! they are computed in, so the loads of the next iterations are in flight
+//! while the current one is computed. The number of stages defaults to
+//! kCircularBufferStages and can be set with cp_async_pipeline(<stages>).
+//!
+//! In non-persistent reductions, the serial loop is the remainder of the
+//! reduction domain, which is not unswitched then, as the double buffer axis
+//! must not be an unswitched loop. Inner persistent kernels that keep their
+//! buffers in registers have no serial loop, as each block normalizes one
+//! set of rows. With circular buffering, the iteration domain is split by the
+//! number of blocks that fit on the device, and each block loops over its
+//! rows, loading the next rows while normalizing the current ones.
+//!
+//! The stages are limited to a quarter of the shared memory of an SM, so that
+//! they don't limit occupancy, and circular buffering is not used if fewer
+//! than two stages fit. Loads are only converted if they copy 4, 8 or 16
+//! bytes per thread, which cp.async is limited to.
+constexpr int64_t kCircularBufferStages = 3;
+
+//! Number of stages to circular buffer cached inputs with, or 0 if it's not
+//! enabled or fewer than two stages fit in shared memory. bytes_per_stage is
+//! the size of the inputs a block loads per iteration of its serial loop.
+int64_t getCircularBufferStages(int64_t bytes_per_stage);
+
+//! Loads the cached inputs with cp.async into shared memory circular buffered
+//! with the given number of stages, where possible. Must be called after
+//! inlining. Returns the tensors that are circular buffered.
+std::vector<TensorView*> circularBufferCachedInputs(
+    const std::vector<TensorView*>& cached_inputs,
+    int64_t stages);
+
+//! [ Register Prefetched Global Loads ]
+//!
+//! Circular buffering needs cp.async and shared memory, and kernels that use
+//! many registers run only one or two blocks per SM, which is too few to hide
+//! the latency of their global loads. With NVFUSER_ENABLE=register_prefetch,
+//! non-persistent reductions that don't circular buffer their inputs instead
+//! rotate the serial remainder loop of the reduction domain, see
+//! [Loop Rotation], so that the cached inputs of iteration i + 1 are loaded
+//! into registers in the body of iteration i:
+//!   T1 = T0[0]
+//!   for i in rem:
+//!     T2 += T1
+//!     T1 = T0[i + 1]
+//! The loads of the next iteration don't depend on the math of the current
+//! one, so nvcc issues them before it and they are in flight while it's
+//! computed. The rotated loads are predicated like the others, so the loads
+//! past the end of the loop aren't issued.
+//!
+//! As with circular buffering, the remainder isn't unswitched then, as the
+//! unswitch predicate would enclose both the loads and the math. Only loads
+//! that are computed at the top level of the loop body are prefetched, i.e.,
+//! vectorized ones, and not those inlined into the unrolled loops of their
+//! consumers, which they can't be rotated separately from. Prefetching costs
+//! the registers of one more iteration of the cached inputs, and inputs are
+//! prefetched one iteration ahead, as a loop can only be rotated once.
+
+//! Rotates the innermost serial loop the cached inputs are loaded in, see
+//! [ Register Prefetched Global Loads ]. Must be called after inlining.
+//! Returns the tensors that are prefetched.
+std::vector<TensorView*> prefetchCachedInputs(
+    const std::vector<TensorView*>& cached_inputs);
 
 // Propagate transformations with internal cutoff boundary at boundaryNodesSet
 // in P2C forward propagate, disable propagation to TensorView in
@@ -48,7 +119,9 @@ void propagateTransformation(
     const std::unordered_set<TensorView*>& boundaryNodesSet =
         std::unordered_set<TensorView*>());
 
-// Propagate RFactor from first reduction TensorView to others
+// Propagate RFactor from first reduction TensorView to others. If
+// reduction_tv is rfactored twice, see [ Reduction Accumulators ], so are the
+// others.
 void propagateRFactor(
     TensorView* reference_tv,
     TensorView* reduction_tv,
@@ -83,6 +156,33 @@ void propagateParallelization(
 // Reduction inliner expects an rfactored domain.
 TensorView* sortAndRFactor(TensorView* reference_tv);
 
+//! [ Reduction Accumulators ]
+//!
+//! A thread of a non-persistent inner reduction serially reduces the
+//! remainder of its reduction domain, and each step of the loop adds the
+//! unrolled or vectorized elements it loads into the same register. Every add
+//! then depends on the previous one, so with a long remainder, e.g., for
+//! large hidden sizes, the loop is bound by the latency of the adds rather
+//! than by memory. With ReductionParams::accumulators_inner_reduction > 1,
+//! the innermost accumulators_inner_reduction elements of the unrolled or
+//! vectorized domain are instead reduced into as many independent partial
+//! results, which are combined before the reduction across the block:
+//!
+//!   T2[I, rRem, iTIDx, rUS, iK] = reduce(T1)  // accumulators, reference
+//!   T3[I, iTIDx, rK] = reduce(T2)              // combines the accumulators
+//!   T4[I, rTIDx] = reduce(T3)                  // block reduction
+//!
+//! The reduced tensor is rfactored twice, for which the accumulator domain
+//! must be a leaf domain of reference_tv. It's an iteration domain of the
+//! accumulators, so each thread holds accumulators_inner_reduction partial
+//! results in registers. Welford ops are rfactored the same way, so their
+//! partial averages, variances and counts are merged as Welford results.
+//! propagateRFactor rfactors the other reductions of the fusion twice as well.
+//! Returns the accumulators.
+TensorView* sortAndRFactorAccumulators(
+    TensorView* reference_tv,
+    IterDomain* accumulator_id);
+
 // If project_to_inputs is true, take all projectable persistent buffers,
 // and move them to the inputs. Otherwise, try to project to their immediate
 // producers if these producers are persistent buffers.
@@ -7,14 +7,22 @@
 // clang-format on
 #include <ATen/cuda/CUDAContext.h>
 #include <executor_utils.h>
+#include <options.h>
 #include <scheduler/all_schedulers.h>
+#include <scheduler/autotune.h>
 #include <scheduler/debug_utils.h>
+#include <scheduler/heuristic_log.h>
 #include <scheduler/matmul_utils.h>
 #include <scheduler/registry.h>
 #include <scheduler/registry_utils.h>
 #include <scheduler/utils.h>
 #include <tensor_metadata.h>
 
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <type_traits>
+
 namespace nvfuser {
 
 SchedulerRuntimeInfo::SchedulerRuntimeInfo(
@@ -141,6 +149,11 @@ bool SchedulerEntry::sameAs(const SchedulerEntry* other) {
   return heuristic_ == other->heuristic_ && params_->sameAs(other->params_);
 }
 
+bool SchedulerEntry::canRunInputsOf(const SchedulerEntry* other) {
+  return heuristic_ == other->heuristic_ &&
+      params_->canRunInputsOf(other->params_);
+}
+
 namespace {
 //! A Utility for checking both dynamic and static part of
 //!  can schedule
@@ -155,12 +168,42 @@ bool checkCanSchedule(
   //  it has to pass all the compile time checks to create a data cache for this
   //  fusion.
   if (!data_cache) {
-    if (!registry_utils::isConnectedFusionGraph(fusion)) {
+    // Horizontal fusion is meant for disconnected graphs, see
+    // [ Horizontal Fusion ]
+    if (SchedulerType::heuristicType() != ScheduleHeuristic::Horizontal &&
+        !registry_utils::isConnectedFusionGraph(fusion)) {
       scheduler_debug_utils::canScheduleRejectReason(
           SchedulerType::heuristicType(),
           "Connected fusion graph check failed!");
       return false;
     }
+    // Sorts need rows that are held by a single thread, see
+    // [ Sort Scheduler ]
+    if (SchedulerType::heuristicType() != ScheduleHeuristic::Sort &&
+        ir_utils::hasOpsOfType<SortOp>(fusion)) {
+      scheduler_debug_utils::canScheduleRejectReason(
+          SchedulerType::heuristicType(),
+          "Sort ops are only supported by the sort scheduler");
+      return false;
+    }
+    // Scans need rows that are held by a single block, see
+    // [ Scan Scheduler ]
+    if (SchedulerType::heuristicType() != ScheduleHeuristic::Scan &&
+        ir_utils::hasOpsOfType<ScanOp>(fusion)) {
+      scheduler_debug_utils::canScheduleRejectReason(
+          SchedulerType::heuristicType(),
+          "Scan ops are only supported by the scan scheduler");
+      return false;
+    }
+    // Shifts and gathers need their inputs tiled with halo in shared memory,
+    // see [ Stencil Scheduler ]
+    if (SchedulerType::heuristicType() != ScheduleHeuristic::Stencil &&
+        ir_utils::hasOpsOfType<ShiftOp, GatherOp>(fusion)) {
+      scheduler_debug_utils::canScheduleRejectReason(
+          SchedulerType::heuristicType(),
+          "Shift and gather ops are only supported by the stencil scheduler");
+      return false;
+    }
     if (IterDomainGraph(fusion, /*allow_self_mapping=*/true).hasSelfMapping()) {
       scheduler_debug_utils::canScheduleRejectReason(
           SchedulerType::heuristicType(), "Iter domain graph check failed!");
@@ -206,6 +249,16 @@ bool SchedulerEntry::canSchedule(
     case ScheduleHeuristic::Matmul:
       return checkCanSchedule<MatmulScheduler>(
           fusion, runtime_info, data_cache);
+    case ScheduleHeuristic::Horizontal:
+      return checkCanSchedule<HorizontalScheduler>(
+          fusion, runtime_info, data_cache);
+    case ScheduleHeuristic::Sort:
+      return checkCanSchedule<SortScheduler>(fusion, runtime_info, data_cache);
+    case ScheduleHeuristic::Scan:
+      return checkCanSchedule<ScanScheduler>(fusion, runtime_info, data_cache);
+    case ScheduleHeuristic::Stencil:
+      return checkCanSchedule<StencilScheduler>(
+          fusion, runtime_info, data_cache);
     default:
       NVF_ERROR(false, "unreachable");
       return false;
@@ -252,13 +305,83 @@ std::unique_ptr<SchedulerEntry> SchedulerEntry::makeEntry(
       scheduler_entry =
           std::make_unique<MatmulScheduler>(fusion, runtime_info, data_cache);
       break;
+    case ScheduleHeuristic::Horizontal:
+      scheduler_entry = std::make_unique<HorizontalScheduler>(
+          fusion, runtime_info, data_cache);
+      break;
+    case ScheduleHeuristic::Sort:
+      scheduler_entry =
+          std::make_unique<SortScheduler>(fusion, runtime_info, data_cache);
+      break;
+    case ScheduleHeuristic::Scan:
+      scheduler_entry =
+          std::make_unique<ScanScheduler>(fusion, runtime_info, data_cache);
+      break;
+    case ScheduleHeuristic::Stencil:
+      scheduler_entry =
+          std::make_unique<StencilScheduler>(fusion, runtime_info, data_cache);
+      break;
     default:
       NVF_ERROR(false, "unreachable");
   }
 
+  // See [ Autotuning of Reduction Heuristics ]
+  if (sh == ScheduleHeuristic::Reduction ||
+      sh == ScheduleHeuristic::InnerPersistent) {
+    scheduler_entry->params_ = autotune::tuneReductionParams(
+        sh, fusion, runtime_info, scheduler_entry->params_);
+  } else if (sh == ScheduleHeuristic::Matmul) {
+    // See [ Autotuning of Matmul Heuristics ]
+    scheduler_entry->params_ = autotune::tuneMatmulParams(
+        fusion, runtime_info, scheduler_entry->params_);
+  }
+
+  // See [ Size-Specialized Predicate Elimination ]. Matmul parameters are
+  // compared without their compile parameters, so kernels of different size
+  // classes could be mixed up.
+  if (isOptionEnabled(EnableOption::SizeSpecialization) &&
+      sh != ScheduleHeuristic::Matmul) {
+    scheduler_entry->params_->cparams.extent_divisors =
+        scheduler_utils::getExtentDivisors(fusion, runtime_info);
+  }
+
+  // See [ Heuristic Decision Log ]
+  if (heuristic_log::isEnabled()) {
+    heuristic_log::logDecision(
+        sh, fusion, runtime_info, *scheduler_entry->params_);
+  }
+
   return scheduler_entry;
 }
 
+std::unique_ptr<SchedulerEntry> SchedulerEntry::makeEntry(
+    ScheduleHeuristic sh,
+    std::shared_ptr<HeuristicParams> params) {
+  NVF_ERROR(params != nullptr, "Expected the parameters of ", sh);
+  switch (sh) {
+    case ScheduleHeuristic::PointWise:
+      return std::make_unique<PointWiseScheduler>(std::move(params));
+    case ScheduleHeuristic::Reduction:
+      return std::make_unique<ReductionScheduler>(std::move(params));
+    case ScheduleHeuristic::InnerPersistent:
+      return std::make_unique<InnerPersistentKernelScheduler>(
+          std::move(params));
+    case ScheduleHeuristic::OuterPersistent:
+      return std::make_unique<OuterPersistentKernelScheduler>(
+          std::move(params));
+    case ScheduleHeuristic::InnerOuterPersistent:
+      return std::make_unique<InnerOuterPersistentKernelScheduler>(
+          std::move(params));
+    case ScheduleHeuristic::Transpose:
+      return std::make_unique<TransposeScheduler>(std::move(params));
+    case ScheduleHeuristic::Matmul:
+      return std::make_unique<MatmulScheduler>(std::move(params));
+    default:
+      NVF_ERROR(false, "Parameters of ", sh, " can't be deserialized");
+  }
+  return nullptr;
+}
+
 // Simply loop through the list as baseline strategy
 std::optional<ScheduleHeuristic> SchedulerEntry::proposeHeuristics(
     Fusion* fusion,
@@ -296,6 +419,362 @@ class CompileTimeInfo : public HeuristicCompileTime::CompileTimeInfoBase {
   std::unique_ptr<typename EntryClass::DataType> data_;
 };
 
+//! [ Global Heuristic Summary Cache ]
+//!
+//! HeuristicSummary only lives as long as its FusionKernelRuntime. Every new
+//! concretization, and every new runtime created for input shapes that
+//! don't fit the existing ones, reruns the compile-time analyses on a fresh
+//! copy of the same fusion. With EnableOption::GlobalHeuristicCache, the
+//! entries are also kept in a process-wide cache keyed by the heuristic and
+//! the printed math of the segment, which includes the names of its
+//! TensorViews and IterDomains.
+//!
+//! IrCloner preserves names, so the entries of one copy are remapped to
+//! another by replacing each TensorView and IterDomain with the one of the
+//! same name. Only entries that refer to nothing else are cached. That
+//! excludes the domain maps, which hold a ComputeAtMap, and the contiguous
+//! inner sizes, which are Vals created by the analysis itself. Those are
+//! recomputed, and the rest is inserted before recording, so
+//! HeuristicSummaryEntry finds it instead of calling its maker.
+
+//! A Val identified by its type and name, which are the same in every copy
+//! of a fusion. A null pointer has no ValType.
+using ValName = std::pair<std::optional<ValType>, StmtNameType>;
+
+//! Vals of a fusion by valNameKey
+using ValNameIndex = std::unordered_map<std::string, Val*>;
+
+std::string valNameKey(const ValName& name) {
+  return std::to_string((int)name.first.value()) + "_" +
+      std::to_string(name.second);
+}
+
+//! Converts compile-time info to and from ValNames. Values without IR
+//! pointers are kept as is.
+template <typename T>
+struct Portable {
+  using Type = T;
+  static std::optional<Type> toNames(const T& data) {
+    return data;
+  }
+  static std::optional<T> fromNames(const Type& data, const ValNameIndex&) {
+    return data;
+  }
+};
+
+template <typename T>
+struct Portable<T*> {
+  static_assert(std::is_base_of_v<Val, T>);
+  using Type = ValName;
+  static std::optional<Type> toNames(T* val) {
+    if (val == nullptr) {
+      return ValName(std::nullopt, 0);
+    }
+    // Other Vals may be created by the analyses themselves
+    if (val->vtype() != ValType::TensorView &&
+        val->vtype() != ValType::IterDomain) {
+      return std::nullopt;
+    }
+    return ValName(val->vtype(), val->name());
+  }
+  static std::optional<T*> fromNames(
+      const Type& name,
+      const ValNameIndex& index) {
+    if (!name.first.has_value()) {
+      return (T*)nullptr;
+    }
+    auto it = index.find(valNameKey(name));
+    if (it == index.end() || dynamic_cast<T*>(it->second) == nullptr) {
+      return std::nullopt;
+    }
+    return it->second->as<T>();
+  }
+};
+
+template <typename T>
+struct Portable<std::vector<T>> {
+  using Type = std::vector<typename Portable<T>::Type>;
+  static std::optional<Type> toNames(const std::vector<T>& data) {
+    Type names;
+    names.reserve(data.size());
+    for (const auto& element : data) {
+      auto name = Portable<T>::toNames(element);
+      if (!name.has_value()) {
+        return std::nullopt;
+      }
+      names.push_back(std::move(*name));
+    }
+    return names;
+  }
+  static std::optional<std::vector<T>> fromNames(
+      const Type& names,
+      const ValNameIndex& index) {
+    std::vector<T> data;
+    data.reserve(names.size());
+    for (const auto& name : names) {
+      auto element = Portable<T>::fromNames(name, index);
+      if (!element.has_value()) {
+        return std::nullopt;
+      }
+      data.push_back(std::move(*element));
+    }
+    return data;
+  }
+};
+
+// Sets and maps are kept as vectors, so ValNames need no hash
+template <typename T>
+struct Portable<std::unordered_set<T>> {
+  using Type = typename Portable<std::vector<T>>::Type;
+  static std::optional<Type> toNames(const std::unordered_set<T>& data) {
+    return Portable<std::vector<T>>::toNames(
+        std::vector<T>(data.begin(), data.end()));
+  }
+  static std::optional<std::unordered_set<T>> fromNames(
+      const Type& names,
+      const ValNameIndex& index) {
+    auto data = Portable<std::vector<T>>::fromNames(names, index);
+    if (!data.has_value()) {
+      return std::nullopt;
+    }
+    return std::unordered_set<T>(data->begin(), data->end());
+  }
+};
+
+template <typename K, typename V>
+struct Portable<std::unordered_map<K, V>> {
+  using Type = std::vector<
+      std::pair<typename Portable<K>::Type, typename Portable<V>::Type>>;
+  static std::optional<Type> toNames(const std::unordered_map<K, V>& data) {
+    Type names;
+    names.reserve(data.size());
+    for (const auto& [key, value] : data) {
+      auto key_name = Portable<K>::toNames(key);
+      auto value_name = Portable<V>::toNames(value);
+      if (!key_name.has_value() || !value_name.has_value()) {
+        return std::nullopt;
+      }
+      names.emplace_back(std::move(*key_name), std::move(*value_name));
+    }
+    return names;
+  }
+  static std::optional<std::unordered_map<K, V>> fromNames(
+      const Type& names,
+      const ValNameIndex& index) {
+    std::unordered_map<K, V> data;
+    data.reserve(names.size());
+    for (const auto& [key_name, value_name] : names) {
+      auto key = Portable<K>::fromNames(key_name, index);
+      auto value = Portable<V>::fromNames(value_name, index);
+      if (!key.has_value() || !value.has_value()) {
+        return std::nullopt;
+      }
+      data.emplace(std::move(*key), std::move(*value));
+    }
+    return data;
+  }
+};
+
+template <>
+struct Portable<scheduler_utils::PersistentBufferInfo> {
+  using Info = scheduler_utils::PersistentBufferInfo;
+  using Tvs = Portable<std::vector<TensorView*>>;
+  using TvGroups = Portable<std::vector<std::vector<TensorView*>>>;
+  using Ids = Portable<std::unordered_set<IterDomain*>>;
+
+  struct Type {
+    Tvs::Type persistent_buffers;
+    Ids::Type unmappable_dims;
+    TvGroups::Type persistent_buffer_resolution_points;
+    Tvs::Type projectable_persistent_buffers;
+    Tvs::Type projectable_buffer_inputs;
+    Ids::Type unamppable_dims_projected_to_inputs;
+  };
+
+  static std::optional<Type> toNames(const Info& info) {
+    auto persistent_buffers = Tvs::toNames(info.persistent_buffers);
+    auto unmappable_dims = Ids::toNames(info.unmappable_dims);
+    auto resolution_points =
+        TvGroups::toNames(info.persistent_buffer_resolution_points);
+    auto projectable_buffers =
+        Tvs::toNames(info.projectable_persistent_buffers);
+    auto buffer_inputs = Tvs::toNames(info.projectable_buffer_inputs);
+    auto projected_dims =
+        Ids::toNames(info.unamppable_dims_projected_to_inputs);
+    if (!persistent_buffers.has_value() || !unmappable_dims.has_value() ||
+        !resolution_points.has_value() || !projectable_buffers.has_value() ||
+        !buffer_inputs.has_value() || !projected_dims.has_value()) {
+      return std::nullopt;
+    }
+    return Type{
+        std::move(*persistent_buffers),
+        std::move(*unmappable_dims),
+        std::move(*resolution_points),
+        std::move(*projectable_buffers),
+        std::move(*buffer_inputs),
+        std::move(*projected_dims)};
+  }
+
+  static std::optional<Info> fromNames(
+      const Type& names,
+      const ValNameIndex& index) {
+    auto persistent_buffers = Tvs::fromNames(names.persistent_buffers, index);
+    auto unmappable_dims = Ids::fromNames(names.unmappable_dims, index);
+    auto resolution_points =
+        TvGroups::fromNames(names.persistent_buffer_resolution_points, index);
+    auto projectable_buffers =
+        Tvs::fromNames(names.projectable_persistent_buffers, index);
+    auto buffer_inputs = Tvs::fromNames(names.projectable_buffer_inputs, index);
+    auto projected_dims =
+        Ids::fromNames(names.unamppable_dims_projected_to_inputs, index);
+    if (!persistent_buffers.has_value() || !unmappable_dims.has_value() ||
+        !resolution_points.has_value() || !projectable_buffers.has_value() ||
+        !buffer_inputs.has_value() || !projected_dims.has_value()) {
+      return std::nullopt;
+    }
+    Info info;
+    info.persistent_buffers = std::move(*persistent_buffers);
+    info.unmappable_dims = std::move(*unmappable_dims);
+    info.persistent_buffer_resolution_points = std::move(*resolution_points);
+    info.projectable_persistent_buffers = std::move(*projectable_buffers);
+    info.projectable_buffer_inputs = std::move(*buffer_inputs);
+    info.unamppable_dims_projected_to_inputs = std::move(*projected_dims);
+    return info;
+  }
+};
+
+//! An entry of HeuristicSummary with its IR pointers replaced by ValNames
+class PortableEntry {
+ public:
+  virtual ~PortableEntry() = default;
+
+  //! Makes an entry for the fusion of index, or returns nullptr if some
+  //! Val is not found
+  virtual std::unique_ptr<HeuristicCompileTime::CompileTimeInfoBase> remap(
+      const ValNameIndex& index) const = 0;
+};
+
+template <typename EntryClass>
+class TypedPortableEntry : public PortableEntry {
+  using DataType = typename EntryClass::DataType;
+
+ public:
+  explicit TypedPortableEntry(typename Portable<DataType>::Type names)
+      : names_(std::move(names)) {}
+
+  std::unique_ptr<HeuristicCompileTime::CompileTimeInfoBase> remap(
+      const ValNameIndex& index) const override {
+    auto data = Portable<DataType>::fromNames(names_, index);
+    if (!data.has_value()) {
+      return nullptr;
+    }
+    return std::make_unique<CompileTimeInfo<EntryClass>>(
+        std::make_unique<DataType>(std::move(*data)));
+  }
+
+ private:
+  typename Portable<DataType>::Type names_;
+};
+
+template <typename EntryClass>
+std::shared_ptr<const PortableEntry> makePortableEntry(
+    HeuristicCompileTime::CompileTimeInfoBase* entry) {
+  using DataType = typename EntryClass::DataType;
+  auto names = Portable<DataType>::toNames(
+      *entry->as<CompileTimeInfo<EntryClass>>()->get());
+  if (!names.has_value()) {
+    return nullptr;
+  }
+  return std::make_shared<TypedPortableEntry<EntryClass>>(std::move(*names));
+}
+
+//! Returns nullptr for the entries that cannot be remapped
+std::shared_ptr<const PortableEntry> makePortableEntry(
+    HeuristicCompileTime::CompileTimeInfoBase* entry) {
+  using namespace HeuristicCompileTime;
+  switch (entry->type()) {
+    case CompileTimeEntryType::REFERENCE_TENSORS:
+      return makePortableEntry<ReferenceTensors>(entry);
+    case CompileTimeEntryType::REFERENCE_TENSORS_FOR_GROUPS:
+      return makePortableEntry<ReferenceTensorsForGroups>(entry);
+    case CompileTimeEntryType::VECTORIZABLE_INPUTS_AND_OUTPUTS:
+      return makePortableEntry<VectorizableInputsAndOutputs>(entry);
+    case CompileTimeEntryType::INPUTS_AND_OUTPUTS_INNER_DIM_GROUPS:
+      return makePortableEntry<InputsOutputsInnerDimGroups>(entry);
+    case CompileTimeEntryType::UNROLLABLE_INPUTS_AND_OUTPUTS:
+      return makePortableEntry<UnrollableInputsAndOutputs>(entry);
+    case CompileTimeEntryType::REDUCTION_TVS:
+      return makePortableEntry<ReductionTVs>(entry);
+    case CompileTimeEntryType::PERSISTENT_BUFFER_INFO:
+      return makePortableEntry<PersistentBufferInfo>(entry);
+    case CompileTimeEntryType::SCOPE_PERSISTENT_FACTOR_INFO:
+      return makePortableEntry<ScopePersistentFactorInfo>(entry);
+    case CompileTimeEntryType::BROADCAST_BYTE_MULTIPLES:
+      return makePortableEntry<BroadcastMultiples>(entry);
+    case CompileTimeEntryType::INNER_MOST_DIMS_INFO:
+      return makePortableEntry<InnerMostDimInfo>(entry);
+    case CompileTimeEntryType::CAN_SCHEDULE_TRANSPOSE:
+      return makePortableEntry<CanScheduleTranspose>(entry);
+    case CompileTimeEntryType::RFACTOR_REORDER_MAP:
+      return makePortableEntry<RfactorReorderMap>(entry);
+    default:
+      return nullptr;
+  }
+}
+
+using PortableEntries = std::vector<std::shared_ptr<const PortableEntry>>;
+
+class GlobalHeuristicSummaryCache {
+ public:
+  static GlobalHeuristicSummaryCache& get() {
+    static GlobalHeuristicSummaryCache cache;
+    return cache;
+  }
+
+  std::shared_ptr<const PortableEntries> find(const std::string& key) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto it = entries_.find(key);
+    return it == entries_.end() ? nullptr : it->second;
+  }
+
+  void insert(const std::string& key, PortableEntries entries) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    // Bound the memory held by fusions that are no longer used
+    if (entries_.size() >= kMaxFusions) {
+      entries_.clear();
+    }
+    entries_.emplace(
+        key, std::make_shared<const PortableEntries>(std::move(entries)));
+  }
+
+ private:
+  static constexpr size_t kMaxFusions = 1024;
+
+  std::mutex mutex_;
+  std::unordered_map<std::string, std::shared_ptr<const PortableEntries>>
+      entries_;
+};
+
+//! The math of the segment of fusion being scheduled with the names of its
+//! statements and the types of its tensors
+std::string makeGlobalKey(Fusion* fusion, ScheduleHeuristic heuristic) {
+  std::stringstream ss;
+  ss << heuristic << "\n";
+  for (Val* input : fusion->inputs()) {
+    ss << input->toString() << "\n";
+  }
+  for (Expr* expr : fusion->exprs()) {
+    ss << expr->toString();
+  }
+  for (TensorView* tv : ir_utils::allTvs(fusion)) {
+    ss << tv->toString() << " " << tv->dtype() << "\n";
+  }
+  for (Val* output : fusion->outputs()) {
+    ss << output->toString() << "\n";
+  }
+  return ss.str();
+}
+
 } // namespace
 
 HeuristicSummary::HeuristicSummary(
@@ -303,6 +782,10 @@ HeuristicSummary::HeuristicSummary(
     ScheduleHeuristic heuristic,
     SchedulerRuntimeInfo& runtime_info)
     : heuristic_(heuristic), recording_(true) {
+  if (isOptionEnabled(EnableOption::GlobalHeuristicCache)) {
+    global_key_ = makeGlobalKey(fusion, heuristic);
+    loadGlobalEntries(fusion);
+  }
   switch (heuristic) {
     case ScheduleHeuristic::NoOp:
       NoOpScheduler::canScheduleRunTime(fusion, runtime_info, this);
@@ -342,13 +825,62 @@ HeuristicSummary::HeuristicSummary(
       NVF_ERROR(canSchedule, "Could not schedule matmul (run time)");
       break;
     }
+    case ScheduleHeuristic::Horizontal:
+      getHorizontalHeuristics(fusion, runtime_info, this);
+      HorizontalScheduler::canScheduleRunTime(fusion, runtime_info, this);
+      break;
+    case ScheduleHeuristic::Sort:
+      getSortHeuristics(fusion, runtime_info, this);
+      SortScheduler::canScheduleRunTime(fusion, runtime_info, this);
+      break;
+    case ScheduleHeuristic::Scan:
+      getScanHeuristics(fusion, runtime_info, this);
+      ScanScheduler::canScheduleRunTime(fusion, runtime_info, this);
+      break;
+    case ScheduleHeuristic::Stencil:
+      getStencilHeuristics(fusion, runtime_info, this);
+      StencilScheduler::canScheduleRunTime(fusion, runtime_info, this);
+      break;
     default:
       NVF_ERROR(false, "unknown heuristic");
   }
   validate();
+  if (!global_key_.empty() && !loaded_global_entries_) {
+    storeGlobalEntries();
+  }
   recording_ = false;
 }
 
+void HeuristicSummary::loadGlobalEntries(Fusion* fusion) {
+  auto entries = GlobalHeuristicSummaryCache::get().find(global_key_);
+  if (entries == nullptr) {
+    return;
+  }
+  ValNameIndex index;
+  for (Val* val : fusion->vals()) {
+    if (val->vtype() == ValType::TensorView ||
+        val->vtype() == ValType::IterDomain) {
+      index.emplace(valNameKey(ValName(val->vtype(), val->name())), val);
+    }
+  }
+  for (const auto& entry : *entries) {
+    if (auto remapped = entry->remap(index)) {
+      insert(std::move(remapped));
+    }
+  }
+  loaded_global_entries_ = true;
+}
+
+void HeuristicSummary::storeGlobalEntries() const {
+  PortableEntries entries;
+  for (const auto& entry : entries_) {
+    if (auto portable = makePortableEntry(entry.get())) {
+      entries.push_back(std::move(portable));
+    }
+  }
+  GlobalHeuristicSummaryCache::get().insert(global_key_, std::move(entries));
+}
+
 void HeuristicSummary::validate() const {
   switch (heuristic_) {
     case ScheduleHeuristic::NoOp: {
@@ -419,6 +951,11 @@ void HeuristicSummary::validate() const {
       // TODO: add a proper set of checks
       break;
     }
+    case ScheduleHeuristic::Horizontal:
+    case ScheduleHeuristic::Sort:
+    case ScheduleHeuristic::Scan:
+    case ScheduleHeuristic::Stencil:
+      break;
     default:
       NVF_ERROR(false, "unknown heuristic");
   }
@@ -437,7 +974,12 @@ HeuristicSummaryEntry<EntryClass>::HeuristicSummaryEntry(
     MakerFnType fn) {
   using InfoType = CompileTimeInfo<EntryClass>;
 
-  if (!data_cache || data_cache->isRecording()) {
+  if (data_cache && data_cache->isRecording() &&
+      data_cache->has(EntryClass::EntryType)) {
+    // Inserted from the global cache before recording
+    data_ptr_ =
+        data_cache->at(EntryClass::EntryType)->template as<InfoType>()->get();
+  } else if (!data_cache || data_cache->isRecording()) {
     owned_data_ = fn();
     data_ptr_ = owned_data_.get();
 
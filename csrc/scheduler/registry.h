@@ -129,6 +129,18 @@ class SchedulerRuntimeInfo : public NonCopyable {
 
 class HeuristicSummary;
 
+// [ Serialized Heuristics ]
+//
+// A FusionKernelRuntime serializes the parameters of the scheduler of each
+// segment, see serde/heuristic_params.h. When it is deserialized, the entries
+// of the pointwise, reduction, normalization, transpose and matmul schedulers
+// are built from these parameters instead of running the heuristics again on
+// the inputs it was first compiled for. Autotuning, size specialization and
+// the heuristic log were applied before the parameters were serialized. The
+// parameters of the horizontal, sort, scan and stencil schedulers aren't
+// serialized and the no-op scheduler has none, so their entries are computed
+// again.
+
 //! Virtual base class for schedule heuristics
 //!   heuristic implementations derive from this
 //!   class and implement a schedule(Fusion*)
@@ -144,6 +156,12 @@ class SchedulerEntry {
       SchedulerRuntimeInfo& runtime_info,
       HeuristicSummary* data_cache = nullptr);
 
+  //! Builds an entry with the parameters deserialized from a FusionCache,
+  //!  see [ Serialized Heuristics ]
+  static std::unique_ptr<SchedulerEntry> makeEntry(
+      ScheduleHeuristic sh,
+      std::shared_ptr<HeuristicParams> params);
+
   virtual ~SchedulerEntry() = default;
 
   //! External access for canSchedule utilities through SchedulerEntry
@@ -169,6 +187,10 @@ class SchedulerEntry {
   //! Heuristic comparison
   bool sameAs(const SchedulerEntry* other);
 
+  //! Whether the kernel compiled with this entry can run the inputs other was
+  //! made for, see HeuristicParams::canRunInputsOf
+  bool canRunInputsOf(const SchedulerEntry* other);
+
   ScheduleHeuristic heuristic() const {
     return heuristic_;
   }
@@ -213,6 +235,11 @@ class SchedulerEntry {
   explicit SchedulerEntry(ScheduleHeuristic heuristic)
       : heuristic_(heuristic) {}
 
+  SchedulerEntry(
+      ScheduleHeuristic heuristic,
+      std::shared_ptr<HeuristicParams> params)
+      : params_(std::move(params)), heuristic_(heuristic) {}
+
   //! Heuristic parameters if applicable
   std::shared_ptr<HeuristicParams> params_ = nullptr;
 
@@ -183,6 +183,23 @@ bool rejectScheduleForMemoryPromotion(
       }
     }
 
+    // The output of scatter_add is initialized with a copy of self before
+    // the kernel is launched and is only complete once the kernel
+    // finishes, see [ Scatter Accumulation ] in runtime/scatter.cu
+    if (auto scatter = dynamic_cast<ScatterOp*>(expr); scatter != nullptr &&
+        scatter->getScatterOpType() == ScatterOpType::Add) {
+      if (rejectScheduleFusionInputRequirement(expr, schedule_strategy)) {
+        return true;
+      }
+      TensorView* out = scatter->output(0)->as<TensorView>();
+      if (!out->isFusionOutput() || !out->uses().empty()) {
+        scheduler_debug_utils::canScheduleRejectReason(
+            schedule_strategy,
+            "The output of scatter_add must be a fusion output without uses.");
+        return true;
+      }
+    }
+
     // Similarly, ops based resize, such as like slice, pad and cat,
     // may require memory promotion. Require them to be done with
     // fusion inputs unless explicitly allowed
@@ -206,13 +223,22 @@ bool isConnectedFusionGraph(Fusion* fusion) {
     return true;
   }
 
-  // A set of connected components on the fusion graph
-  DisjointSets<Val*> component_sets;
+  // A set of connected components on the fusion graph, over dense ids of
+  // the vals
+  UnionFind component_sets;
+  std::unordered_map<Val*, int64_t> val_ids;
+  auto valId = [&](Val* val) {
+    auto [it, inserted] = val_ids.emplace(val, component_sets.size());
+    if (inserted) {
+      component_sets.resize(component_sets.size() + 1);
+    }
+    return it->second;
+  };
 
   NVF_ERROR(
       !fusion->outputs().empty(), "Fusion without output is not supported");
   auto output0 = fusion->outputs()[0];
-  component_sets.initializeSet(output0);
+  const int64_t output0_id = valId(output0);
 
   // Iterate through all used exprs
   for (auto expr : fusion->exprs()) {
@@ -220,19 +246,19 @@ bool isConnectedFusionGraph(Fusion* fusion) {
 
     // Each expr maps all its inputs and
     //  outputs to the same component
-    auto output0 = expr->output(0);
+    const int64_t expr_output0_id = valId(expr->output(0));
     for (auto input : ir_utils::filterByType<TensorView>(expr->inputs())) {
-      component_sets.mapEntries(output0, input);
+      component_sets.join(expr_output0_id, valId(input));
     }
     for (auto output : expr->outputs()) {
-      component_sets.mapEntries(output0, output);
+      component_sets.join(expr_output0_id, valId(output));
     }
   }
 
   // Map aliased outputs
   for (Val* out : fusion->outputs()) {
     if (Val* in = fusion->getOutputAlias(out).first; in != nullptr) {
-      component_sets.mapEntries(out, in);
+      component_sets.join(valId(out), valId(in));
     }
   }
 
@@ -241,7 +267,7 @@ bool isConnectedFusionGraph(Fusion* fusion) {
   // on this fusion graph, all outputs will be
   // equivalent/connected to the first output.
   for (auto output : fusion->outputs()) {
-    if (!component_sets.strictAreMapped(output0, output)) {
+    if (!component_sets.sameSet(output0_id, valId(output))) {
       return false;
     }
   }
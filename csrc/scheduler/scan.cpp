@@ -0,0 +1,251 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <inlining.h>
+#include <instrumentation.h>
+#include <ir/utils.h>
+#include <scheduler/debug_utils.h>
+#include <scheduler/mark_aliases.h>
+#include <scheduler/scan.h>
+#include <scheduler/utils.h>
+
+namespace nvfuser {
+
+namespace {
+
+constexpr int64_t kWarpSize = 32;
+// Elements of a row each thread holds at least and at most
+constexpr int64_t kMinItemsPerThread = 4;
+constexpr int64_t kMaxItemsPerThread = 16;
+// Threads a row is preferably split across and at most
+constexpr int64_t kTargetThreadsPerRow = 256;
+constexpr int64_t kMaxThreadsPerRow = 1024;
+// Largest row a block scans
+constexpr int64_t kMaxScanRowSize = kMaxItemsPerThread * kMaxThreadsPerRow;
+// Threads a block of short rows should at least have
+constexpr int64_t kMinThreadsPerBlock = 128;
+
+//! Largest extent of the innermost domains of the tensors of fusion
+int64_t maxInnerExtent(Fusion* fusion, SchedulerRuntimeInfo& runtime_info) {
+  int64_t max_extent = 1;
+  for (auto tv : ir_utils::allTvs(fusion)) {
+    IterDomain* inner_id = tv->getMaybeRFactorDomain().back();
+    if (inner_id->isBroadcast()) {
+      continue;
+    }
+    auto extent =
+        runtime_info.expressionEvaluator().evaluate(inner_id->extent());
+    NVF_ERROR(
+        extent.hasValue(),
+        "Could not infer the extent of ",
+        inner_id->toString(),
+        " of ",
+        tv->toString());
+    max_extent = std::max(max_extent, extent.as<int64_t>());
+  }
+  return max_extent;
+}
+
+} // namespace
+
+ScanScheduler::ScanScheduler(
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info,
+    HeuristicSummary* data_cache)
+    : SchedulerEntry(heuristicType()) {
+  computeHeuristics(fusion, runtime_info, data_cache);
+}
+
+bool ScanScheduler::canScheduleCompileTime(Fusion* fusion) {
+  if (!ir_utils::hasOpsOfType<ScanOp>(fusion)) {
+    scheduler_debug_utils::canScheduleRejectReason(
+        heuristicType(), "no scan ops");
+    return false;
+  }
+
+  for (auto expr : fusion->exprs()) {
+    if (ir_utils::isScalarOp(expr)) {
+      continue;
+    }
+    const bool is_supported = expr->isA<UnaryOp>() ||
+        expr->isA<BinaryOp>() || expr->isA<TernaryOp>() ||
+        expr->isA<BroadcastOp>() || expr->isA<ReductionOp>() ||
+        expr->isA<ScanOp>() ||
+        (expr->isA<LoadStoreOp>() &&
+         expr->as<LoadStoreOp>()->opType() == LoadStoreOpType::Set);
+    if (!is_supported) {
+      scheduler_debug_utils::canScheduleRejectReason(
+          heuristicType(), "unsupported expression: ", expr->toString());
+      return false;
+    }
+    if (auto sop = dynamic_cast<ScanOp*>(expr)) {
+      auto in_tv = sop->in()->as<TensorView>();
+      const auto rank = (int64_t)TensorDomain::noReductions(
+                            in_tv->getMaybeRFactorDomain())
+                            .size();
+      if (sop->dim() != rank - 1) {
+        scheduler_debug_utils::canScheduleRejectReason(
+            heuristicType(), "only scans along the innermost dimension");
+        return false;
+      }
+    }
+  }
+
+  // Every tensor is [rows..., row], where only the row may be reduced or
+  // broadcast
+  std::optional<size_t> rank;
+  for (auto tv : ir_utils::allTvs(fusion)) {
+    if (tv->hasAllocation()) {
+      scheduler_debug_utils::canScheduleRejectReason(
+          heuristicType(), "no support for allocation domains");
+      return false;
+    }
+    const auto& rfactor_domain = tv->getMaybeRFactorDomain();
+    if (!rank.has_value()) {
+      rank = rfactor_domain.size();
+    }
+    if (rfactor_domain.size() != *rank || *rank < 2) {
+      scheduler_debug_utils::canScheduleRejectReason(
+          heuristicType(),
+          "tensors must have the same rank of at least two: ",
+          tv->toString());
+      return false;
+    }
+    if (tv->hasRFactor()) {
+      scheduler_debug_utils::canScheduleRejectReason(
+          heuristicType(), "no support for rfactor domains: ", tv->toString());
+      return false;
+    }
+    for (auto i : c10::irange(*rank - 1)) {
+      IterDomain* id = rfactor_domain.at(i);
+      if (id->isReduction() || id->isBroadcast()) {
+        scheduler_debug_utils::canScheduleRejectReason(
+            heuristicType(),
+            "only the innermost dimension can be reduced or broadcast: ",
+            tv->toString());
+        return false;
+      }
+    }
+  }
+
+  for (auto out : fusion->outputs()) {
+    if (!out->isA<TensorView>() || out->isFusionInput()) {
+      scheduler_debug_utils::canScheduleRejectReason(
+          heuristicType(), "outputs must be computed tensors");
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool ScanScheduler::canScheduleRunTime(
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info,
+    HeuristicSummary* data_cache) {
+  if (maxInnerExtent(fusion, runtime_info) > kMaxScanRowSize) {
+    scheduler_debug_utils::canScheduleRejectReason(
+        heuristicType(), "rows don't fit in the registers of a block");
+    return false;
+  }
+  return true;
+}
+
+void ScanScheduler::schedule(Fusion* fusion) {
+  FUSER_PERF_SCOPE("Schedule Scan Fusion");
+  auto params = std::dynamic_pointer_cast<ScanParams>(params_);
+  NVF_ERROR(params != nullptr, "Heuristic parameter is not a scan parameter");
+  scheduleScan(fusion, *params);
+}
+
+void ScanScheduler::computeHeuristics(
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info,
+    HeuristicSummary* data_cache) {
+  params_ = getScanHeuristics(fusion, runtime_info, data_cache);
+  NVF_ERROR(params_ != nullptr);
+}
+
+std::shared_ptr<ScanParams> getScanHeuristics(
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info,
+    HeuristicSummary* data_cache) {
+  FUSER_PERF_SCOPE("getScanHeuristics");
+  FusionGuard fg(fusion);
+
+  auto params = std::make_shared<ScanParams>(
+      "Scan heuristics", runtime_info.getIndexType());
+  const int64_t row_size = maxInnerExtent(fusion, runtime_info);
+  // More elements per thread for longer rows, up to the registers they take
+  params->items_per_thread = std::clamp(
+      scheduler_utils::roundUpPow2(ceilDiv(row_size, kTargetThreadsPerRow)),
+      kMinItemsPerThread,
+      kMaxItemsPerThread);
+  // Whole warps per row, so that no warp holds elements of two rows
+  params->bdimx = std::min(
+      ceilDiv(ceilDiv(row_size, params->items_per_thread), kWarpSize) *
+          kWarpSize,
+      kMaxThreadsPerRow);
+  // Several short rows per block
+  params->bdimy = std::max(kMinThreadsPerBlock / params->bdimx, (int64_t)1);
+
+  if (isDebugDumpEnabled(DebugDumpOption::SchedulerDebug)) {
+    debug() << params->toString() << std::endl;
+  }
+  return params;
+}
+
+void scheduleScan(Fusion* fusion, const ScanParams& params) {
+  FusionGuard fg(fusion);
+
+  // Make sure we don't have global memory set on intermediate tensors from
+  // fusion segmentation
+  scheduler_utils::clearMemorySpace(fusion);
+
+  scheduler_utils::cacheInputs(fusion, true);
+  scheduler_utils::cacheAndForkOutputs(fusion, true);
+
+  // [rows..., row] ->
+  //   [rows/bdimy, bdimy, ceilDiv(row, bdimx * items), bdimx, items]
+  // The middle domain is of size one, as the rows fit in bdimx * items
+  for (auto tv : ir_utils::allTvs(fusion)) {
+    if (tv->isFusionInput()) {
+      continue;
+    }
+    while (tv->nDims() > 2) {
+      tv->merge(0);
+    }
+    tv->split(0, params.bdimy);
+    tv->split(2, params.items_per_thread);
+    tv->split(2, params.bdimx);
+  }
+
+  // Reduce the elements of each thread serially before reducing across TIDx
+  for (auto tv : scheduler_utils::getReductionTvs(fusion)) {
+    tv->rFactor({2, 4});
+  }
+
+  for (auto tv : ir_utils::allTvs(fusion)) {
+    if (tv->isFusionInput()) {
+      continue;
+    }
+    tv->axis(0)->parallelize(ParallelType::BIDx);
+    tv->axis(1)->parallelize(ParallelType::TIDy);
+    tv->axis(3)->parallelize(ParallelType::TIDx);
+  }
+
+  // Each block scans its rows at once
+  for (auto sop : ir_utils::getOpsOfType<ScanOp>(fusion)) {
+    sop->out()->as<TensorView>()->axis(4)->parallelize(ParallelType::Bulk);
+  }
+
+  inlineMost();
+
+  markAliases(fusion);
+}
+
+} // namespace nvfuser
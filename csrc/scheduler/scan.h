@@ -0,0 +1,75 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <scheduler/registry.h>
+#include <scheduler/scan_heuristic.h>
+
+namespace nvfuser {
+
+class Fusion;
+class SchedulerRuntimeInfo;
+class HeuristicSummary;
+
+//! [ Scan Scheduler ]
+//!
+//! Cumulative sums and products along rows, like the cumsum of the sorted
+//! probabilities of top-p sampling or of the positions of attention masks,
+//! are typically surrounded by pointwise ops over the same rows. The scan
+//! scheduler generates a single kernel for a fusion of scans, pointwise ops,
+//! and reductions and broadcasts along the innermost dimension, which reads
+//! and writes each element once:
+//!   [BIDx, TIDy{bdimy}, 1, TIDx{bdimx}, items_per_thread]
+//! The outer dimensions are merged into the rows, and each row is split
+//! across bdimx threads, a multiple of the warp size, which each hold
+//! items_per_thread consecutive elements of the row in registers. The scan
+//! of a row is a single call to scan::blockScan (runtime/scan.cu), for which
+//! the items_per_thread domain of the scanned tensor is parallelized with
+//! ParallelType::Bulk. Each thread scans its elements serially, the totals
+//! of the threads are scanned with warp shuffles, and the totals of the warps
+//! through shared memory, so the rows are scanned in a single pass.
+//!
+//! Scans are only supported by this scheduler, along the innermost
+//! dimension. Rows of more than kMaxScanRowSize elements are rejected, as
+//! they would not fit in the registers of a block. Scanning them would need
+//! a grid scan, e.g., with decoupled look-back between the blocks of a row.
+class ScanScheduler : public SchedulerEntry {
+ public:
+  explicit ScanScheduler(
+      Fusion* fusion,
+      SchedulerRuntimeInfo& runtime_info,
+      HeuristicSummary* data_cache = nullptr);
+
+  static bool canScheduleCompileTime(Fusion* fusion);
+
+  static bool canScheduleRunTime(
+      Fusion* fusion,
+      SchedulerRuntimeInfo& runtime_info,
+      HeuristicSummary* data_cache = nullptr);
+
+  constexpr static ScheduleHeuristic heuristicType() {
+    return ScheduleHeuristic::Scan;
+  }
+
+  void schedule(Fusion* fusion) override;
+
+ private:
+  void computeHeuristics(
+      Fusion* fusion,
+      SchedulerRuntimeInfo& runtime_info,
+      HeuristicSummary* data_cache = nullptr);
+};
+
+std::shared_ptr<ScanParams> getScanHeuristics(
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info,
+    HeuristicSummary* data_cache = nullptr);
+
+void scheduleScan(Fusion* fusion, const ScanParams& params);
+
+} // namespace nvfuser
@@ -0,0 +1,68 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <scheduler/heuristic.h>
+
+#include <sstream>
+
+namespace nvfuser {
+
+//! Parameters of the scan heuristic, see [ Scan Scheduler ].
+//! Warning: equal operator is intended for use in caching the kernel
+//! associated with these parameters. It does not check if the launch
+//! parameters are equivelent!
+class ScanParams : public HeuristicParams {
+ public:
+  //! Consecutive elements of a row each thread holds in registers
+  int64_t items_per_thread = 4;
+
+  //! Threads of a row, a multiple of the warp size. A row is at most
+  //! bdimx * items_per_thread elements long.
+  int64_t bdimx = 32;
+
+  //! Rows per block
+  int64_t bdimy = 1;
+
+  using HeuristicParams::HeuristicParams;
+
+  // Warning: Does not check launch parameters!
+  bool sameAs(
+      const std::shared_ptr<HeuristicParams>& other_base) const override {
+    auto other_casted = std::dynamic_pointer_cast<ScanParams>(other_base);
+    if (other_casted == nullptr) {
+      return false;
+    }
+    const ScanParams& other = *other_casted;
+    return other.cparams == cparams &&
+        other.items_per_thread == items_per_thread && other.bdimx == bdimx &&
+        other.bdimy == bdimy;
+  }
+
+  std::string toString() const override {
+    std::stringstream ss;
+    ss << "\n===== Scan Parameters ========\n"
+       << (tag.empty() ? "" : "Tag: ") << tag << "\n"
+       << " Items per thread: " << items_per_thread << " BlckX: " << bdimx
+       << " BlckY: " << bdimy << "\n"
+       << "==============================\n";
+    return ss.str();
+  }
+
+  // Warning: Hash is not based on launch parameters!
+  size_t hash() const override {
+    return static_cast<size_t>(items_per_thread) ^
+        static_cast<size_t>(bdimx) << 16 ^ static_cast<size_t>(bdimy) << 32;
+  }
+
+  std::shared_ptr<HeuristicParams> clone() const override {
+    return std::make_shared<ScanParams>(*this);
+  }
+};
+
+} // namespace nvfuser
@@ -0,0 +1,235 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <inlining.h>
+#include <instrumentation.h>
+#include <ir/utils.h>
+#include <scheduler/debug_utils.h>
+#include <scheduler/mark_aliases.h>
+#include <scheduler/sort.h>
+#include <scheduler/utils.h>
+
+namespace nvfuser {
+
+namespace {
+
+// Largest row a thread sorts
+constexpr int64_t kMaxSortRowSize = 256;
+// Elements of rows each block should at most hold per tensor
+constexpr int64_t kElementsPerBlock = 16384;
+constexpr int64_t kMinRowsPerBlock = 32;
+constexpr int64_t kMaxRowsPerBlock = 128;
+
+//! Largest extent of the innermost domains of the tensors of fusion
+int64_t maxInnerExtent(Fusion* fusion, SchedulerRuntimeInfo& runtime_info) {
+  int64_t max_extent = 1;
+  for (auto tv : ir_utils::allTvs(fusion)) {
+    IterDomain* inner_id = tv->getMaybeRFactorDomain().back();
+    if (inner_id->isBroadcast()) {
+      continue;
+    }
+    auto extent =
+        runtime_info.expressionEvaluator().evaluate(inner_id->extent());
+    NVF_ERROR(
+        extent.hasValue(),
+        "Could not infer the extent of ",
+        inner_id->toString(),
+        " of ",
+        tv->toString());
+    max_extent = std::max(max_extent, extent.as<int64_t>());
+  }
+  return max_extent;
+}
+
+} // namespace
+
+SortScheduler::SortScheduler(
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info,
+    HeuristicSummary* data_cache)
+    : SchedulerEntry(heuristicType()) {
+  computeHeuristics(fusion, runtime_info, data_cache);
+}
+
+bool SortScheduler::canScheduleCompileTime(Fusion* fusion) {
+  if (!ir_utils::hasOpsOfType<SortOp>(fusion)) {
+    scheduler_debug_utils::canScheduleRejectReason(
+        heuristicType(), "no sort ops");
+    return false;
+  }
+
+  for (auto expr : fusion->exprs()) {
+    if (ir_utils::isScalarOp(expr)) {
+      continue;
+    }
+    const bool is_supported = expr->isA<UnaryOp>() ||
+        expr->isA<BinaryOp>() || expr->isA<TernaryOp>() ||
+        expr->isA<BroadcastOp>() || expr->isA<ReductionOp>() ||
+        expr->isA<SliceOp>() || expr->isA<SortOp>() ||
+        (expr->isA<LoadStoreOp>() &&
+         expr->as<LoadStoreOp>()->opType() == LoadStoreOpType::Set);
+    if (!is_supported) {
+      scheduler_debug_utils::canScheduleRejectReason(
+          heuristicType(), "unsupported expression: ", expr->toString());
+      return false;
+    }
+    if (auto sop = dynamic_cast<SortOp*>(expr)) {
+      auto in_tv = sop->in()->as<TensorView>();
+      const auto rank = (int64_t)TensorDomain::noReductions(
+                            in_tv->getMaybeRFactorDomain())
+                            .size();
+      if (sop->dim() != rank - 1) {
+        scheduler_debug_utils::canScheduleRejectReason(
+            heuristicType(), "only sorts along the innermost dimension");
+        return false;
+      }
+    }
+  }
+
+  // Every tensor is [rows..., row], where only the row may be reduced,
+  // broadcast or sliced
+  std::optional<size_t> rank;
+  for (auto tv : ir_utils::allTvs(fusion)) {
+    if (tv->hasAllocation()) {
+      scheduler_debug_utils::canScheduleRejectReason(
+          heuristicType(), "no support for allocation domains");
+      return false;
+    }
+    const auto& rfactor_domain = tv->getMaybeRFactorDomain();
+    if (!rank.has_value()) {
+      rank = rfactor_domain.size();
+    }
+    if (rfactor_domain.size() != *rank || *rank < 2) {
+      scheduler_debug_utils::canScheduleRejectReason(
+          heuristicType(),
+          "tensors must have the same rank of at least two: ",
+          tv->toString());
+      return false;
+    }
+    for (auto i : c10::irange(*rank - 1)) {
+      IterDomain* id = rfactor_domain.at(i);
+      if (id->isReduction() || id->isBroadcast() ||
+          id != tv->getRootDomain().at(i)) {
+        scheduler_debug_utils::canScheduleRejectReason(
+            heuristicType(),
+            "only the innermost dimension can be reduced, broadcast or ",
+            "sliced: ",
+            tv->toString());
+        return false;
+      }
+    }
+  }
+
+  for (auto out : fusion->outputs()) {
+    if (!out->isA<TensorView>() || out->isFusionInput()) {
+      scheduler_debug_utils::canScheduleRejectReason(
+          heuristicType(), "outputs must be computed tensors");
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool SortScheduler::canScheduleRunTime(
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info,
+    HeuristicSummary* data_cache) {
+  if (maxInnerExtent(fusion, runtime_info) > kMaxSortRowSize) {
+    scheduler_debug_utils::canScheduleRejectReason(
+        heuristicType(), "rows don't fit in registers");
+    return false;
+  }
+  return true;
+}
+
+void SortScheduler::schedule(Fusion* fusion) {
+  FUSER_PERF_SCOPE("Schedule Sort Fusion");
+  auto params = std::dynamic_pointer_cast<SortParams>(params_);
+  NVF_ERROR(params != nullptr, "Heuristic parameter is not a sort parameter");
+  scheduleSort(fusion, *params);
+}
+
+void SortScheduler::computeHeuristics(
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info,
+    HeuristicSummary* data_cache) {
+  params_ = getSortHeuristics(fusion, runtime_info, data_cache);
+  NVF_ERROR(params_ != nullptr);
+}
+
+std::shared_ptr<SortParams> getSortHeuristics(
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info,
+    HeuristicSummary* data_cache) {
+  FUSER_PERF_SCOPE("getSortHeuristics");
+  FusionGuard fg(fusion);
+
+  auto params = std::make_shared<SortParams>(
+      "Sort heuristics", runtime_info.getIndexType());
+  params->row_size =
+      scheduler_utils::roundUpPow2(maxInnerExtent(fusion, runtime_info));
+  // Fewer rows per block for longer rows, which take more registers
+  params->bdimy = std::clamp(
+      kElementsPerBlock / params->row_size, kMinRowsPerBlock, kMaxRowsPerBlock);
+
+  if (isDebugDumpEnabled(DebugDumpOption::SchedulerDebug)) {
+    debug() << params->toString() << std::endl;
+  }
+  return params;
+}
+
+void scheduleSort(Fusion* fusion, const SortParams& params) {
+  FusionGuard fg(fusion);
+
+  // Make sure we don't have global memory set on intermediate tensors from
+  // fusion segmentation
+  scheduler_utils::clearMemorySpace(fusion);
+
+  scheduler_utils::cacheInputs(fusion, true);
+  scheduler_utils::cacheAndForkOutputs(fusion, true);
+
+  // [rows..., row] -> [rows/bdimy, bdimy, row_size, ceilDiv(row, row_size)]
+  for (auto tv : ir_utils::allTvs(fusion)) {
+    if (tv->isFusionInput()) {
+      continue;
+    }
+    while (tv->nDims() > 2) {
+      tv->merge(0);
+    }
+    tv->split(0, params.bdimy);
+    tv->split(2, params.row_size, /*inner_split=*/false);
+  }
+
+  // Reduce the rows serially in their threads, which leaves reductions of
+  // size one over TIDx
+  for (auto tv : scheduler_utils::getReductionTvs(fusion)) {
+    tv->rFactor({2});
+  }
+
+  for (auto tv : ir_utils::allTvs(fusion)) {
+    if (tv->isFusionInput()) {
+      continue;
+    }
+    tv->axis(0)->parallelize(ParallelType::BIDx);
+    tv->axis(1)->parallelize(ParallelType::TIDy);
+    tv->axis(-1)->parallelize(ParallelType::TIDx);
+  }
+
+  // Each thread sorts its rows at once
+  for (auto sop : ir_utils::getOpsOfType<SortOp>(fusion)) {
+    for (auto out : ir_utils::filterByType<TensorView>(sop->outputs())) {
+      out->axis(2)->parallelize(ParallelType::Bulk);
+    }
+  }
+
+  inlineMost();
+
+  markAliases(fusion);
+}
+
+} // namespace nvfuser
@@ -0,0 +1,72 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <scheduler/registry.h>
+#include <scheduler/sort_heuristic.h>
+
+namespace nvfuser {
+
+class Fusion;
+class SchedulerRuntimeInfo;
+class HeuristicSummary;
+
+//! [ Sort Scheduler ]
+//!
+//! Sorts and top-k selections over short rows, like the routing of tokens to
+//! the experts of a mixture of experts, are typically preceded by a softmax
+//! over the same rows. The sort scheduler generates a single kernel for a
+//! fusion of sorts, slices of their results, pointwise ops and reductions
+//! along the innermost dimension, where each thread processes whole rows:
+//!   [BIDx, TIDy{bdimy}, row_size, TIDx]
+//! The outer dimensions are merged into the rows and the innermost dimension
+//! is split by row_size, a power of two of at least its extent, so TIDx is
+//! of size one. The rows of the tensors that are not inlined are thus kept in
+//! registers, and reductions along them are serial. The sort of a row is a
+//! single call to a bitonic network in the thread, for which the row_size
+//! domain of the sorted values and indices is parallelized with
+//! ParallelType::Bulk.
+//!
+//! Sorts are only supported by this scheduler. Rows of more than
+//! kMaxSortRowSize elements are rejected, as they would not fit in
+//! registers.
+class SortScheduler : public SchedulerEntry {
+ public:
+  explicit SortScheduler(
+      Fusion* fusion,
+      SchedulerRuntimeInfo& runtime_info,
+      HeuristicSummary* data_cache = nullptr);
+
+  static bool canScheduleCompileTime(Fusion* fusion);
+
+  static bool canScheduleRunTime(
+      Fusion* fusion,
+      SchedulerRuntimeInfo& runtime_info,
+      HeuristicSummary* data_cache = nullptr);
+
+  constexpr static ScheduleHeuristic heuristicType() {
+    return ScheduleHeuristic::Sort;
+  }
+
+  void schedule(Fusion* fusion) override;
+
+ private:
+  void computeHeuristics(
+      Fusion* fusion,
+      SchedulerRuntimeInfo& runtime_info,
+      HeuristicSummary* data_cache = nullptr);
+};
+
+std::shared_ptr<SortParams> getSortHeuristics(
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info,
+    HeuristicSummary* data_cache = nullptr);
+
+void scheduleSort(Fusion* fusion, const SortParams& params);
+
+} // namespace nvfuser
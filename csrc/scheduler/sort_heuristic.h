@@ -0,0 +1,62 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <scheduler/heuristic.h>
+
+#include <sstream>
+
+namespace nvfuser {
+
+//! Parameters of the sort heuristic, see [ Sort Scheduler ].
+//! Warning: equal operator is intended for use in caching the kernel
+//! associated with these parameters. It does not check if the launch
+//! parameters are equivelent!
+class SortParams : public HeuristicParams {
+ public:
+  //! Power of two of at least the innermost extent of every tensor, which is
+  //! the number of elements of a row each thread holds
+  int64_t row_size = 1;
+
+  //! Rows per block, each of which is processed by one thread
+  int64_t bdimy = 128;
+
+  using HeuristicParams::HeuristicParams;
+
+  // Warning: Does not check launch parameters!
+  bool sameAs(
+      const std::shared_ptr<HeuristicParams>& other_base) const override {
+    auto other_casted = std::dynamic_pointer_cast<SortParams>(other_base);
+    if (other_casted == nullptr) {
+      return false;
+    }
+    const SortParams& other = *other_casted;
+    return other.cparams == cparams && other.row_size == row_size &&
+        other.bdimy == bdimy;
+  }
+
+  std::string toString() const override {
+    std::stringstream ss;
+    ss << "\n===== Sort Parameters ========\n"
+       << (tag.empty() ? "" : "Tag: ") << tag << "\n"
+       << " Row size: " << row_size << " BlckY: " << bdimy << "\n"
+       << "==============================\n";
+    return ss.str();
+  }
+
+  // Warning: Hash is not based on launch parameters!
+  size_t hash() const override {
+    return static_cast<size_t>(row_size) ^ static_cast<size_t>(bdimy) << 32;
+  }
+
+  std::shared_ptr<HeuristicParams> clone() const override {
+    return std::make_shared<SortParams>(*this);
+  }
+};
+
+} // namespace nvfuser
@@ -0,0 +1,442 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <inlining.h>
+#include <instrumentation.h>
+#include <ir/utils.h>
+#include <maxinfo_propagator.h>
+#include <scheduler/debug_utils.h>
+#include <scheduler/mark_aliases.h>
+#include <scheduler/stencil.h>
+#include <scheduler/utils.h>
+#include <transform_replay.h>
+
+#include <array>
+
+namespace nvfuser {
+
+namespace {
+
+// Threads a block has at most and preferably at least
+constexpr int64_t kMaxThreadsPerBlock = 512;
+constexpr int64_t kMinThreadsPerBlock = 128;
+// Static shared memory of a block
+constexpr int64_t kMaxSmemBytes = 48 * 1024;
+// Largest tile of each of the innermost two domains
+constexpr int64_t kMaxTileX = 256;
+constexpr int64_t kMaxTileY = 32;
+// Blocks of BIDy and BIDz at most
+constexpr int64_t kMaxGridDimYZ = 65535;
+
+//! Non-reduction domains of the outputs of fusion
+int64_t stencilRank(Fusion* fusion) {
+  return (int64_t)TensorDomain::noReductions(
+             fusion->outputs().at(0)->as<TensorView>()->getMaybeRFactorDomain())
+      .size();
+}
+
+//! Halo widths of the two sides of the innermost two domains, y and x,
+//! that a tensor needs for the stencils of its consumers
+struct StencilHalo {
+  std::array<std::array<int64_t, 2>, 2> widths = {};
+
+  int64_t width(size_t dim) const {
+    return widths.at(dim).at(0) + widths.at(dim).at(1);
+  }
+};
+
+//! Halo each tensor of fusion is read with, accumulated along the chains of
+//! stencils from the outputs
+std::unordered_map<TensorView*, StencilHalo> getStencilHalos(
+    Fusion* fusion,
+    int64_t rank) {
+  std::unordered_map<TensorView*, StencilHalo> halos;
+  const auto exprs = fusion->exprs();
+  for (auto it = exprs.rbegin(); it != exprs.rend(); ++it) {
+    Expr* expr = *it;
+    StencilHalo halo;
+    for (auto out : ir_utils::filterByType<TensorView>(expr->outputs())) {
+      auto out_it = halos.find(out);
+      if (out_it == halos.end()) {
+        continue;
+      }
+      for (auto dim : c10::irange(2)) {
+        for (auto side : c10::irange(2)) {
+          halo.widths[dim][side] = std::max(
+              halo.widths[dim][side], out_it->second.widths[dim][side]);
+        }
+      }
+    }
+    // Elements the stencil of expr reads on each side of an element
+    for (auto dim : c10::irange(2)) {
+      const int64_t axis = rank - 2 + (int64_t)dim;
+      if (axis < 0) {
+        continue;
+      }
+      if (auto sop = dynamic_cast<ShiftOp*>(expr)) {
+        // out[i] = in[i - offset]
+        const int64_t offset = sop->offset(axis);
+        halo.widths[dim][0] += std::max(offset, (int64_t)0);
+        halo.widths[dim][1] += std::max(-offset, (int64_t)0);
+      } else if (auto gop = dynamic_cast<GatherOp*>(expr)) {
+        // out[i, k] = in[i + k - pad_width[0]]
+        const int64_t pad = gop->padWidth().at(axis).at(0);
+        halo.widths[dim][0] += pad;
+        halo.widths[dim][1] += gop->windowShape().at(axis) - 1 - pad;
+      }
+    }
+    for (auto in : ir_utils::filterByType<TensorView>(expr->inputs())) {
+      auto& in_halo = halos[in];
+      for (auto dim : c10::irange(2)) {
+        for (auto side : c10::irange(2)) {
+          in_halo.widths[dim][side] =
+              std::max(in_halo.widths[dim][side], halo.widths[dim][side]);
+        }
+      }
+    }
+  }
+  return halos;
+}
+
+//! Extent of the non-reduction domain of tv at axis
+int64_t evaluateExtent(
+    TensorView* tv,
+    int64_t axis,
+    SchedulerRuntimeInfo& runtime_info) {
+  IterDomain* id =
+      TensorDomain::noReductions(tv->getMaybeRFactorDomain()).at(axis);
+  auto extent = runtime_info.expressionEvaluator().evaluate(id->extent());
+  NVF_ERROR(
+      extent.hasValue(),
+      "Could not infer the extent of ",
+      id->toString(),
+      " of ",
+      tv->toString());
+  return extent.as<int64_t>();
+}
+
+//! Tile sizes that minimize the loads per output within the threads and
+//! static shared memory of a block, see [ Stencil Scheduler ]. Returns
+//! nullopt if no tile fits.
+std::optional<std::pair<int64_t, int64_t>> pickTileSize(
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info) {
+  const int64_t rank = stencilRank(fusion);
+  const auto halos = getStencilHalos(fusion, rank);
+  auto reference = fusion->outputs().at(0)->as<TensorView>();
+
+  // The inputs of the stencils are held in shared memory and the fusion
+  // inputs have the widest halo
+  std::vector<std::pair<StencilHalo, int64_t>> smem_tvs;
+  StencilHalo max_halo;
+  for (auto expr : fusion->exprs()) {
+    if (expr->isOneOf<ShiftOp, GatherOp>()) {
+      auto in = expr->input(0)->as<TensorView>();
+      smem_tvs.emplace_back(
+          halos.at(in), (int64_t)dataTypeSize(in->getDataType().value()));
+    }
+  }
+  for (auto in : ir_utils::filterByType<TensorView>(fusion->inputs())) {
+    auto it = halos.find(in);
+    if (it == halos.end()) {
+      continue;
+    }
+    for (auto dim : c10::irange(2)) {
+      for (auto side : c10::irange(2)) {
+        max_halo.widths[dim][side] =
+            std::max(max_halo.widths[dim][side], it->second.widths[dim][side]);
+      }
+    }
+  }
+
+  const int64_t extent_x = evaluateExtent(reference, rank - 1, runtime_info);
+  const int64_t extent_y =
+      rank > 1 ? evaluateExtent(reference, rank - 2, runtime_info) : 1;
+  int64_t extent_outer = 1;
+  for (auto axis : c10::irange(std::max(rank - 2, (int64_t)0))) {
+    extent_outer *= evaluateExtent(reference, (int64_t)axis, runtime_info);
+  }
+  if (extent_outer > kMaxGridDimYZ) {
+    return std::nullopt;
+  }
+
+  // Tiles are no larger than the outputs, but at least a warp wide
+  const int64_t max_tile_x = std::min(
+      std::max(scheduler_utils::roundUpPow2(extent_x), (int64_t)32),
+      kMaxTileX);
+  const int64_t max_tile_y =
+      std::min(scheduler_utils::roundUpPow2(extent_y), kMaxTileY);
+
+  std::optional<std::pair<int64_t, int64_t>> best_tile;
+  double best_cost = 0;
+  for (int64_t tile_x = 32; tile_x <= max_tile_x; tile_x *= 2) {
+    for (int64_t tile_y = 1; tile_y <= max_tile_y; tile_y *= 2) {
+      const int64_t threads =
+          (tile_x + max_halo.width(1)) * (tile_y + max_halo.width(0));
+      if (threads > kMaxThreadsPerBlock ||
+          ceilDiv(extent_y, tile_y) > kMaxGridDimYZ) {
+        continue;
+      }
+      int64_t smem_bytes = 0;
+      for (const auto& [halo, size] : smem_tvs) {
+        smem_bytes +=
+            (tile_x + halo.width(1)) * (tile_y + halo.width(0)) * size;
+      }
+      if (smem_bytes > kMaxSmemBytes) {
+        continue;
+      }
+      // Blocks of few threads leave the SMs idle however few loads they
+      // need, so they come after the others
+      double cost = (double)threads / (double)(tile_x * tile_y);
+      if (threads < kMinThreadsPerBlock) {
+        cost += (double)kMaxThreadsPerBlock;
+      }
+      // Equal costs prefer wider tiles, which coalesce better
+      if (!best_tile.has_value() || cost < best_cost ||
+          (cost == best_cost && tile_x > best_tile->first)) {
+        best_tile = std::make_pair(tile_x, tile_y);
+        best_cost = cost;
+      }
+    }
+  }
+  return best_tile;
+}
+
+} // namespace
+
+StencilScheduler::StencilScheduler(
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info,
+    HeuristicSummary* data_cache)
+    : SchedulerEntry(heuristicType()) {
+  computeHeuristics(fusion, runtime_info, data_cache);
+}
+
+bool StencilScheduler::canScheduleCompileTime(Fusion* fusion) {
+  if (!ir_utils::hasOpsOfType<ShiftOp, GatherOp>(fusion)) {
+    scheduler_debug_utils::canScheduleRejectReason(
+        heuristicType(), "no shift or gather ops");
+    return false;
+  }
+
+  for (auto out : fusion->outputs()) {
+    if (!out->isA<TensorView>() || out->isFusionInput()) {
+      scheduler_debug_utils::canScheduleRejectReason(
+          heuristicType(), "outputs must be computed tensors");
+      return false;
+    }
+  }
+
+  // Every tensor is [outer..., y, x], except for the windows of gathers
+  const int64_t rank = stencilRank(fusion);
+  for (auto tv : ir_utils::allTvs(fusion)) {
+    if (tv->hasAllocation()) {
+      scheduler_debug_utils::canScheduleRejectReason(
+          heuristicType(), "no support for allocation domains");
+      return false;
+    }
+    if (tv->hasRFactor()) {
+      scheduler_debug_utils::canScheduleRejectReason(
+          heuristicType(), "no support for rfactor domains: ", tv->toString());
+      return false;
+    }
+    // The windows of gathers are appended to their domains, and reduced
+    const auto& rfactor_domain = tv->getMaybeRFactorDomain();
+    const bool is_window = tv->definition() != nullptr &&
+        tv->definition()->isA<GatherOp>();
+    const bool is_reduced = tv->hasReduction();
+    if ((int64_t)rfactor_domain.size() !=
+        (is_window || is_reduced ? 2 : 1) * rank) {
+      scheduler_debug_utils::canScheduleRejectReason(
+          heuristicType(),
+          "tensors must have the rank of the outputs: ",
+          tv->toString());
+      return false;
+    }
+    for (auto i : c10::irange((int64_t)rfactor_domain.size())) {
+      IterDomain* id = rfactor_domain.at(i);
+      if (id->isBroadcast()) {
+        scheduler_debug_utils::canScheduleRejectReason(
+            heuristicType(), "no support for broadcast: ", tv->toString());
+        return false;
+      }
+      if (id->isReduction() != (is_reduced && i >= rank)) {
+        scheduler_debug_utils::canScheduleRejectReason(
+            heuristicType(),
+            "only the windows of gathers can be reduced: ",
+            tv->toString());
+        return false;
+      }
+    }
+  }
+
+  for (auto expr : fusion->exprs()) {
+    if (ir_utils::isScalarOp(expr)) {
+      continue;
+    }
+    const bool is_supported = expr->isA<UnaryOp>() ||
+        expr->isA<BinaryOp>() || expr->isA<TernaryOp>() ||
+        expr->isA<ShiftOp>() || expr->isA<GatherOp>() ||
+        (expr->isA<ReductionOp>() &&
+         expr->as<ReductionOp>()->in()->definition() != nullptr &&
+         expr->as<ReductionOp>()->in()->definition()->isA<GatherOp>()) ||
+        (expr->isA<LoadStoreOp>() &&
+         expr->as<LoadStoreOp>()->opType() == LoadStoreOpType::Set);
+    if (!is_supported) {
+      scheduler_debug_utils::canScheduleRejectReason(
+          heuristicType(), "unsupported expression: ", expr->toString());
+      return false;
+    }
+    // The outer domains are merged into a single block domain, which can't
+    // be extended with halo
+    for (auto axis : c10::irange(std::max(rank - 2, (int64_t)0))) {
+      if ((expr->isA<ShiftOp>() && expr->as<ShiftOp>()->offset(axis) != 0) ||
+          (expr->isA<GatherOp>() &&
+           expr->as<GatherOp>()->windowShape().at(axis) != 1)) {
+        scheduler_debug_utils::canScheduleRejectReason(
+            heuristicType(),
+            "only the innermost two dimensions can be stenciled: ",
+            expr->toString());
+        return false;
+      }
+    }
+    if (auto gop = dynamic_cast<GatherOp*>(expr)) {
+      const auto& uses = gop->out()->uses();
+      if (gop->out()->isFusionOutput() ||
+          std::any_of(uses.begin(), uses.end(), [](Expr* use) {
+            return !use->isA<ReductionOp>();
+          })) {
+        scheduler_debug_utils::canScheduleRejectReason(
+            heuristicType(),
+            "the windows of gathers must be reduced: ",
+            expr->toString());
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+bool StencilScheduler::canScheduleRunTime(
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info,
+    HeuristicSummary* data_cache) {
+  if (!pickTileSize(fusion, runtime_info).has_value()) {
+    scheduler_debug_utils::canScheduleRejectReason(
+        heuristicType(),
+        "no tile and its halo fit in a block or the grid is too large");
+    return false;
+  }
+  return true;
+}
+
+void StencilScheduler::schedule(Fusion* fusion) {
+  FUSER_PERF_SCOPE("Schedule Stencil Fusion");
+  auto params = std::dynamic_pointer_cast<StencilParams>(params_);
+  NVF_ERROR(
+      params != nullptr, "Heuristic parameter is not a stencil parameter");
+  scheduleStencil(fusion, *params);
+}
+
+void StencilScheduler::computeHeuristics(
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info,
+    HeuristicSummary* data_cache) {
+  params_ = getStencilHeuristics(fusion, runtime_info, data_cache);
+  NVF_ERROR(params_ != nullptr);
+}
+
+std::shared_ptr<StencilParams> getStencilHeuristics(
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info,
+    HeuristicSummary* data_cache) {
+  FUSER_PERF_SCOPE("getStencilHeuristics");
+  FusionGuard fg(fusion);
+
+  auto params = std::make_shared<StencilParams>(
+      "Stencil heuristics", runtime_info.getIndexType());
+  auto tile = pickTileSize(fusion, runtime_info);
+  NVF_ERROR(tile.has_value(), "No stencil tile fits in a block");
+  params->tile_x = tile->first;
+  params->tile_y = tile->second;
+
+  if (isDebugDumpEnabled(DebugDumpOption::SchedulerDebug)) {
+    debug() << params->toString() << std::endl;
+  }
+  return params;
+}
+
+void scheduleStencil(Fusion* fusion, const StencilParams& params) {
+  FusionGuard fg(fusion);
+
+  // Make sure we don't have global memory set on intermediate tensors from
+  // fusion segmentation
+  scheduler_utils::clearMemorySpace(fusion);
+
+  const int rank = (int)stencilRank(fusion);
+
+  scheduler_utils::cacheInputs(fusion, true);
+  scheduler_utils::cacheAndForkOutputs(fusion, true);
+
+  // The inputs of the stencils are read by the threads of the neighboring
+  // elements, including the halo of the tile
+  std::unordered_set<TensorView*> smem_tvs;
+  for (auto expr : fusion->exprs()) {
+    if (expr->isOneOf<ShiftOp, GatherOp>()) {
+      smem_tvs.insert(expr->input(0)->as<TensorView>());
+    }
+  }
+
+  // [outer..., y, x] ->
+  //   [outer, ceilDiv(y, tile_y), ceilDiv(x, tile_x), tile_y, tile_x]
+  auto reference = fusion->outputs().at(0)->as<TensorView>();
+  reference->split(rank - 1, params.tile_x);
+  if (rank > 1) {
+    reference->split(rank - 2, params.tile_y);
+    reference->reorder({{rank - 1, rank}, {rank, rank - 1}});
+  }
+  for (int i = 0; i + 1 < rank - 2; ++i) {
+    reference->merge(0);
+  }
+
+  int pos = 0;
+  if (rank > 2) {
+    reference->axis(pos++)->parallelize(ParallelType::BIDz);
+  }
+  if (rank > 1) {
+    reference->axis(pos++)->parallelize(ParallelType::BIDy);
+  }
+  reference->axis(pos++)->parallelize(ParallelType::BIDx);
+  const int tile_pos = pos;
+  if (rank > 1) {
+    reference->axis(pos++)->parallelize(ParallelType::TIDy);
+  }
+  reference->axis(pos++)->parallelize(ParallelType::TIDx);
+
+  TransformPropagator propagator(reference);
+  MaxRootDomainInfoSpanningTree(reference).traverse(&propagator);
+  scheduler_utils::parallelizeAllLike(reference);
+
+  // The inputs of the stencils are computed per tile, and everything else
+  // per thread
+  for (auto tv : smem_tvs) {
+    tv->setMemoryType(MemoryType::Shared);
+  }
+  inlineSelectedAt(smem_tvs, reference, tile_pos);
+  std::unordered_set<TensorView*> inlined_tvs;
+  for (auto tv : ir_utils::allTvs(fusion)) {
+    if (!tv->isFusionInput() && smem_tvs.count(tv) == 0) {
+      inlined_tvs.insert(tv);
+    }
+  }
+  inlineMost(inlined_tvs);
+
+  markAliases(fusion);
+}
+
+} // namespace nvfuser
@@ -0,0 +1,77 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <scheduler/registry.h>
+#include <scheduler/stencil_heuristic.h>
+
+namespace nvfuser {
+
+class Fusion;
+class SchedulerRuntimeInfo;
+class HeuristicSummary;
+
+//! [ Stencil Scheduler ]
+//!
+//! Stencils, like smoothing filters, pooling and depthwise convolutions of
+//! images, read the neighbors of each element through shift and gather ops.
+//! The stencil scheduler tiles the innermost two domains of the outputs, so
+//! that each block computes a tile_y x tile_x tile of them:
+//!   [BIDz{outer...}, BIDy, BIDx, TIDy{tile_y}, TIDx{tile_x}]
+//! The input of each stencil is computed at the tile in shared memory, while
+//! the rest is inlined into the threads. The lowering extends the tiles of
+//! the inputs of the stencils with the halo their consumers read, see
+//! device_lower/analysis/shift.h, so the input of a chain of stencils is
+//! read once per tile plus the halo of the whole chain, and the
+//! intermediate stencils never go through global memory.
+//!
+//! The halo threads of a block only load and don't compute outputs, so the
+//! tile sizes are picked to minimize the loads per output,
+//!   (tile_y + halo_y) * (tile_x + halo_x) / (tile_y * tile_x),
+//! where halo_y and halo_x are the halo widths of the fusion inputs, within
+//! the threads and static shared memory of a block.
+//!
+//! Shift and gather ops are only supported by this scheduler. Only the
+//! innermost two domains can be shifted or gathered, and the window domains
+//! of each gather must be reduced, e.g., by the sum of a convolution. Strided
+//! gathers and broadcasts are rejected.
+class StencilScheduler : public SchedulerEntry {
+ public:
+  explicit StencilScheduler(
+      Fusion* fusion,
+      SchedulerRuntimeInfo& runtime_info,
+      HeuristicSummary* data_cache = nullptr);
+
+  static bool canScheduleCompileTime(Fusion* fusion);
+
+  static bool canScheduleRunTime(
+      Fusion* fusion,
+      SchedulerRuntimeInfo& runtime_info,
+      HeuristicSummary* data_cache = nullptr);
+
+  constexpr static ScheduleHeuristic heuristicType() {
+    return ScheduleHeuristic::Stencil;
+  }
+
+  void schedule(Fusion* fusion) override;
+
+ private:
+  void computeHeuristics(
+      Fusion* fusion,
+      SchedulerRuntimeInfo& runtime_info,
+      HeuristicSummary* data_cache = nullptr);
+};
+
+std::shared_ptr<StencilParams> getStencilHeuristics(
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info,
+    HeuristicSummary* data_cache = nullptr);
+
+void scheduleStencil(Fusion* fusion, const StencilParams& params);
+
+} // namespace nvfuser
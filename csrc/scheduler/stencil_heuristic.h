@@ -0,0 +1,63 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <scheduler/heuristic.h>
+
+#include <sstream>
+
+namespace nvfuser {
+
+//! Parameters of the stencil heuristic, see [ Stencil Scheduler ].
+//! Warning: equal operator is intended for use in caching the kernel
+//! associated with these parameters. It does not check if the launch
+//! parameters are equivelent!
+class StencilParams : public HeuristicParams {
+ public:
+  //! Outputs of the innermost domain each block computes. The block has
+  //! tile_x plus the halo width of the innermost domain threads of TIDx.
+  int64_t tile_x = 32;
+
+  //! Outputs of the second innermost domain each block computes. The block
+  //! has tile_y plus the halo width of that domain threads of TIDy.
+  int64_t tile_y = 1;
+
+  using HeuristicParams::HeuristicParams;
+
+  // Warning: Does not check launch parameters!
+  bool sameAs(
+      const std::shared_ptr<HeuristicParams>& other_base) const override {
+    auto other_casted = std::dynamic_pointer_cast<StencilParams>(other_base);
+    if (other_casted == nullptr) {
+      return false;
+    }
+    const StencilParams& other = *other_casted;
+    return other.cparams == cparams && other.tile_x == tile_x &&
+        other.tile_y == tile_y;
+  }
+
+  std::string toString() const override {
+    std::stringstream ss;
+    ss << "\n===== Stencil Parameters ========\n"
+       << (tag.empty() ? "" : "Tag: ") << tag << "\n"
+       << " Tile: " << tile_y << " x " << tile_x << "\n"
+       << "=================================\n";
+    return ss.str();
+  }
+
+  // Warning: Hash is not based on launch parameters!
+  size_t hash() const override {
+    return static_cast<size_t>(tile_x) ^ static_cast<size_t>(tile_y) << 16;
+  }
+
+  std::shared_ptr<HeuristicParams> clone() const override {
+    return std::make_shared<StencilParams>(*this);
+  }
+};
+
+} // namespace nvfuser
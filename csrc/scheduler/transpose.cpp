@@ -10,7 +10,9 @@
 #include <debug.h>
 #include <inlining.h>
 #include <instrumentation.h>
+#include <options.h>
 #include <scheduler/debug_utils.h>
+#include <scheduler/device_model.h>
 #include <scheduler/reduction_utils.h>
 #include <scheduler/registry_utils.h>
 #include <scheduler/transpose.h>
@@ -217,12 +219,60 @@ class DomainMap : public pointwise_utils::DomainMap {
     if (ref1 == nullptr || ref2 == nullptr) {
       return false;
     }
+    // The groups of transposes with a shared inner dimension are only found
+    // from the allocation domains of inputs and outputs, so reshapes aren't
+    // followed
+    if (domain_map.hasSharedInnerDim() &&
+        !ir_utils::getViewOps(fusion).empty()) {
+      return false;
+    }
     // reference 1 is the global reference, so it must have dim mapped the
     // innermost dim of both groups
-    auto innermost2 = scheduler_utils::innerMostAllocDim(ref2);
+    auto innermost2 = domain_map.innerMostTransposedDim(ref2);
     return domain_map.getMappedAllocDimIn(ref1, innermost2) != nullptr;
   }
 
+  // Whether all inputs and outputs have the same innermost allocation
+  // dimension, e.g., D of [B, H, S, D] -> [B, S, H, D]. See note
+  // [Transposes with a shared inner dimension].
+  bool hasSharedInnerDim() const {
+    IterDomain* shared_id = nullptr;
+    for (auto tv : inputsAndOutputsToGroup()) {
+      IterDomain* id = scheduler_utils::innerMostAllocDim(tv);
+      if (id == nullptr) {
+        return false;
+      }
+      if (shared_id == nullptr) {
+        shared_id = id;
+      } else if (!ca_map_.areMapped(shared_id, id, IdMappingMode::EXACT)) {
+        return false;
+      }
+    }
+    return shared_id != nullptr;
+  }
+
+  // The innermost allocation dimension of tv that is transposed. That is the
+  // innermost one, unless all inputs and outputs share it, in which case it's
+  // the one next to it.
+  IterDomain* innerMostTransposedDim(TensorView* tv) const {
+    if (!hasSharedInnerDim()) {
+      return scheduler_utils::innerMostAllocDim(tv);
+    }
+    bool skipped_shared_id = false;
+    const auto& alloc_domain = tv->getMaybeAllocationDomain();
+    for (auto it = alloc_domain.rbegin(); it != alloc_domain.rend(); it++) {
+      if ((*it)->isReduction() || (*it)->isBroadcast()) {
+        continue;
+      }
+      if (!skipped_shared_id) {
+        skipped_shared_id = true;
+        continue;
+      }
+      return *it;
+    }
+    return nullptr;
+  }
+
   // scheduler assumes inner leaf dimension on tv is an exact mapping, when the
   // mapping cannot be resolved, we'll return a `-1`
   int64_t getInnerLeafDim(TensorView* tv, IterDomain* root_dim) const {
@@ -309,6 +359,9 @@ class DomainMap : public pointwise_utils::DomainMap {
   // Then T3 should be in the same group with T1, and T0 should have
   // different group with T1 and T3.
   std::vector<std::vector<TensorView*>> groupInputsOutputsByInnerDim() const {
+    if (hasSharedInnerDim()) {
+      return groupInputsOutputsByTransposedDim();
+    }
     std::vector<std::vector<TensorView*>> groups;
     auto output_tvs = ir_utils::filterByType<TensorView>(fusion_->outputs());
     auto input_tvs = ir_utils::filterByType<TensorView>(fusion_->inputs());
@@ -355,6 +408,29 @@ class DomainMap : public pointwise_utils::DomainMap {
         }
       }
     }
+    sortGroups(groups);
+    return groups;
+  }
+
+ private:
+  // Outputs followed by the used inputs, in the order they are grouped
+  std::vector<TensorView*> inputsAndOutputsToGroup() const {
+    std::vector<TensorView*> tvs;
+    for (auto tv : ir_utils::filterByType<TensorView>(fusion_->outputs())) {
+      if (!tv->isFusionInput() || !tv->uses().empty()) {
+        tvs.push_back(tv);
+      }
+    }
+    for (auto tv : ir_utils::filterByType<TensorView>(fusion_->inputs())) {
+      if (!tv->uses().empty() &&
+          std::find(tvs.begin(), tvs.end(), tv) == tvs.end()) {
+        tvs.push_back(tv);
+      }
+    }
+    return tvs;
+  }
+
+  static void sortGroups(std::vector<std::vector<TensorView*>>& groups) {
     std::stable_sort(
         groups.begin(),
         groups.end(),
@@ -362,9 +438,36 @@ class DomainMap : public pointwise_utils::DomainMap {
            const std::vector<TensorView*>& v2) {
           return v1.size() > v2.size();
         });
+  }
+
+  // Groups inputs and outputs of a transpose with a shared inner dimension
+  // by innerMostTransposedDim
+  std::vector<std::vector<TensorView*>> groupInputsOutputsByTransposedDim()
+      const {
+    std::vector<std::vector<TensorView*>> groups;
+    std::vector<IterDomain*> group_ids;
+    for (auto tv : inputsAndOutputsToGroup()) {
+      IterDomain* id = innerMostTransposedDim(tv);
+      if (id == nullptr) {
+        return {};
+      }
+      auto group_it = std::find_if(
+          group_ids.begin(), group_ids.end(), [&](IterDomain* group_id) {
+            return ca_map_.areMapped(group_id, id, IdMappingMode::EXACT);
+          });
+      if (group_it == group_ids.end()) {
+        group_ids.push_back(id);
+        groups.emplace_back();
+        groups.back().push_back(tv);
+      } else {
+        groups.at(std::distance(group_ids.begin(), group_it)).push_back(tv);
+      }
+    }
+    sortGroups(groups);
     return groups;
   }
 
+ protected:
   // In the transpose scheculing, unlike the pointwise scheduling, the
   // permissive map is required to find reference tensors. See also PR
   // #661
@@ -410,13 +513,32 @@ class DomainMap : public pointwise_utils::DomainMap {
 // We will split that dim and large dim and and use the splitted ones to satisfy
 // both of them:
 //   T0[I0*I1o*I5*I6{1024*1024/4*8}, I1i*I2*I3*I4{32}]
+//
+// Note: [Transposes with a shared inner dimension]
+// A permutation that keeps the innermost dimension in place, e.g.,
+//   T0[B, H, S, D] input
+//   T1 = permute(T0, {0, 2, 1, 3}) // [B, S, H, D]
+// gives all inputs and outputs the same innermost dimension, D. When D is
+// small, neither the loads nor the stores of the pointwise scheduler are
+// coalesced beyond D elements. Instead, the transposed dimensions are taken to
+// be the ones next to D, S and H here, and D becomes part of both tiles:
+//   [..., tile1, tile2, D]
+// so that each group reads and writes tile * D contiguous elements, and both
+// groups are vectorized along D. D is never merged into the virtual inner-most
+// dims. Since each element of the tiles is now D elements, the tile sizes are
+// reduced to keep the shared memory of a tile in check.
+// A shared inner dimension of at least this many bytes is already coalesced
+// well enough by the pointwise scheduler
+constexpr int64_t kMaxSharedInnerBytesForTiling = 64;
+
 void maybeBuildVirtualInnerDims(
     TransposeParams& params,
     int64_t device_multiprocessor_count,
     int64_t n_elems,
     const std::vector<int64_t>& shape_in_ref1,
     int64_t inner_most1,
-    int64_t inner_most2) {
+    int64_t inner_most2,
+    int64_t shared_inner = -1) {
   int64_t merged_size1 = shape_in_ref1[inner_most1];
   int64_t merged_size2 = shape_in_ref1[inner_most2];
 
@@ -435,14 +557,14 @@ void maybeBuildVirtualInnerDims(
   // merge inner_most1 and inner_most2 left until we are done or we can no
   // longer do so
   int64_t dim = inner_most1 - 1;
-  while (dim >= 0 && dim != inner_most2 &&
+  while (dim >= 0 && dim != inner_most2 && dim != shared_inner &&
          merged_size1 < (int64_t)params.tile_size1) {
     params.dims_merged_with_1.push_back(dim);
     merged_size1 *= shape_in_ref1[dim];
     dim--;
   }
   dim = inner_most2 - 1;
-  while (dim >= 0 && dim != inner_most1 &&
+  while (dim >= 0 && dim != inner_most1 && dim != shared_inner &&
          merged_size2 < (int64_t)params.tile_size2) {
     params.dims_merged_with_2.push_back(dim);
     merged_size2 *= shape_in_ref1[dim];
@@ -451,9 +573,12 @@ void maybeBuildVirtualInnerDims(
   // If any of them are unsatisfied, then find other dims to merge
   std::unordered_set<int64_t> unavailable_dims;
   unavailable_dims.reserve(
-      2 + params.dims_merged_with_1.size() + params.dims_merged_with_2.size());
+      3 + params.dims_merged_with_1.size() + params.dims_merged_with_2.size());
   unavailable_dims.insert(inner_most1);
   unavailable_dims.insert(inner_most2);
+  if (shared_inner >= 0) {
+    unavailable_dims.insert(shared_inner);
+  }
   for (auto i : params.dims_merged_with_1) {
     unavailable_dims.insert((int64_t)i);
   }
@@ -648,18 +773,328 @@ getInnerMostDimInfoInReference(
       HeuristicSummaryEntry<HeuristicCompileTime::InnerMostDimInfo>(
           data_cache, [&]() {
             std::vector<int64_t> data;
-            data.reserve(group_references.size());
+            data.reserve(group_references.size() + 1);
             for (auto ref_tv : group_references) {
-              auto inner_most_id = scheduler_utils::innerMostAllocDim(ref_tv);
+              auto inner_most_id = domain_map.innerMostTransposedDim(ref_tv);
               auto inner_most_pos_in_global_ref =
                   domain_map.getInnerLeafDim(global_reference, inner_most_id);
               data.emplace_back(inner_most_pos_in_global_ref);
             }
+            // Position of the inner dimension shared by all inputs and
+            // outputs, or -1. See note [Transposes with a shared inner
+            // dimension]
+            data.emplace_back(
+                domain_map.hasSharedInnerDim()
+                    ? domain_map.getInnerLeafDim(
+                          global_reference,
+                          scheduler_utils::innerMostAllocDim(global_reference))
+                    : -1);
             return std::make_unique<std::vector<int64_t>>(std::move(data));
           });
   return innermost_info_entry;
 }
 
+// [ Transpose Grid Swizzle ]
+//
+// The tiles of the two transposed dimensions, and of the other dimensions,
+// are merged into BIDx in row-major order, so the blocks running at once
+// cover a row of tiles along the inner one of the two tiled dimensions. They
+// read or write the tensors of one group in full lines, but the tensors of
+// the other group only in pieces of lines spread over the whole row. Once a
+// row of tiles reads and writes more than L2, the lines are evicted before
+// the blocks of the next rows of tiles complete them. Like
+// grid_swizzle_factor of MatmulParams, consecutive blocks then walk
+// grid_swizzle_factor tiles along the outer tiled dimension before moving
+// along the inner one:
+//
+//   [..., I_outer/tile, .., I_inner/tile, ...] ->
+//   [..., ceilDiv(I_outer/tile, factor), .., I_inner/tile * factor, ...]
+//
+// before everything is merged into BIDx. This is only used without virtual
+// innermost dimensions or a shared inner dimension, so that the tiled
+// dimensions are root domains of reference1.
+
+// Returns the grid swizzle factor of the tiles of reference1, see
+// [ Transpose Grid Swizzle ]
+int64_t getTransposeGridSwizzleFactor(
+    const std::shared_ptr<TransposeParams>& params,
+    const std::vector<int64_t>& shape_in_ref1,
+    int64_t inner_most_pos1_in_ref1,
+    int64_t inner_most_pos2_in_ref1,
+    int64_t io_bytes_per_element) {
+  const int64_t outer_pos =
+      std::min(inner_most_pos1_in_ref1, inner_most_pos2_in_ref1);
+  const int64_t outer_tile_size =
+      (int64_t)(outer_pos == inner_most_pos1_in_ref1 ? params->tile_size1
+                                                     : params->tile_size2);
+  int64_t swept_bytes = outer_tile_size * io_bytes_per_element;
+  for (auto i : c10::irange(outer_pos + 1, (int64_t)shape_in_ref1.size())) {
+    swept_bytes *= shape_in_ref1.at(i);
+  }
+  return scheduler_utils::getGridSwizzleFactor(
+      swept_bytes, ceilDiv(shape_in_ref1.at(outer_pos), outer_tile_size));
+}
+
+// [ Register Transpose ]
+//
+// Layout conversions like NCHW to NHWC with a small C permute a large
+// dimension X with a small dimension Y, which is only a few elements. The
+// tiles staged through shared memory must then be built from virtual inner
+// dimensions, see note [Supporting small transpose dimensions], and the
+// round trip through shared memory costs more than the transpose itself.
+// Instead, the tiles are transposed in registers. X and Y are split into
+// square tiles of T elements, a power of two, and each tile is held by a
+// group of T consecutive lanes of a warp:
+//
+//   [..., X, Y] -> [BIDx, Yo, TIDx{128/T * T}, T]
+//
+// The tensors with X innermost, the strided side, hold a row of Yi in each
+// lane, with the T elements of Xi in registers, and the tensors with Y
+// innermost, the packed side, hold a row of Xi in each lane, with the T
+// elements of Yi in registers. Both sides are loaded or stored in vectors of
+// T elements along their innermost dimensions, so the global memory accesses
+// are coalesced on both sides. The permute between the sides is lowered to
+// transpose::warpTranspose (runtime/transpose.cu), which exchanges the tiles
+// with log2(T) stages of __shfl_xor_sync, as LoadStoreOpType::WarpTranspose.
+//
+// movmatrix isn't used, as it only transposes 8x8 fragments of 16-bit
+// elements in the fixed layout of mma operands.
+//
+// This is only used for fusions of pointwise ops with a single input and a
+// single output and a single permute, where X is the innermost dimension of
+// one of them and the second innermost dimension of the other, and Y is at
+// most kMaxRegisterTransposeSize elements. T divides both X and Y, and is at
+// most the vectorization width of both the input and the output. It can be
+// disabled with NVFUSER_DISABLE=register_transpose.
+
+constexpr int64_t kRegisterTransposeThreads = 128;
+constexpr int64_t kMaxRegisterTransposeSize = 16;
+
+// Returns the permute of a fusion that can be transposed in registers, or
+// nullptr. See [ Register Transpose ]
+LoadStoreOp* getRegisterTransposeOp(Fusion* fusion) {
+  auto inputs = ir_utils::filterByType<TensorView>(fusion->inputs());
+  auto outputs = ir_utils::filterByType<TensorView>(fusion->outputs());
+  if (inputs.size() != 1 || outputs.size() != 1 ||
+      fusion->outputs().size() != 1) {
+    return nullptr;
+  }
+  TensorView* input = *inputs.begin();
+  TensorView* output = *outputs.begin();
+  if (input->hasAllocation() || output->hasAllocation()) {
+    return nullptr;
+  }
+
+  LoadStoreOp* permute = nullptr;
+  for (auto expr : fusion->exprs()) {
+    if (ir_utils::isScalarOp(expr)) {
+      continue;
+    }
+    const bool is_pointwise = expr->isA<UnaryOp>() || expr->isA<BinaryOp>() ||
+        expr->isA<TernaryOp>() ||
+        (expr->isA<LoadStoreOp>() &&
+         expr->as<LoadStoreOp>()->opType() == LoadStoreOpType::Set);
+    if (!is_pointwise) {
+      return nullptr;
+    }
+    for (auto tv : ir_utils::filterByType<TensorView>(expr->outputs())) {
+      for (auto id : tv->getMaybeRFactorDomain()) {
+        if (id->isBroadcast() || id->isReduction()) {
+          return nullptr;
+        }
+      }
+      if (!tv->hasRFactor()) {
+        continue;
+      }
+      const auto& root = tv->getRootDomain();
+      const auto& rfactor = tv->getRFactorDomain();
+      if (permute != nullptr || !expr->isA<LoadStoreOp>() ||
+          !std::is_permutation(
+              root.begin(), root.end(), rfactor.begin(), rfactor.end())) {
+        return nullptr;
+      }
+      permute = expr->as<LoadStoreOp>();
+    }
+  }
+  if (permute == nullptr ||
+      permute->out()->as<TensorView>()->getRootDomain().size() < 2) {
+    return nullptr;
+  }
+
+  // The ops before the permute only depend on the input, and the ops after
+  // it on the permute
+  const auto producer_side =
+      DependencyCheck::getAllValsBetween({input}, {permute->in()});
+  const std::unordered_set<Val*> producer_side_set(
+      producer_side.begin(), producer_side.end());
+  for (auto expr : fusion->exprs()) {
+    if (expr == permute || ir_utils::isScalarOp(expr)) {
+      continue;
+    }
+    const bool is_producer_side =
+        producer_side_set.count(expr->output(0)) > 0;
+    for (auto tv : ir_utils::filterByType<TensorView>(expr->inputs())) {
+      if ((producer_side_set.count(tv) > 0) != is_producer_side) {
+        return nullptr;
+      }
+    }
+  }
+  return permute;
+}
+
+// Sets the register tiles of params if the fusion can be transposed in
+// registers, see [ Register Transpose ]
+bool maybeUseRegisterTranspose(
+    TransposeParams& params,
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info,
+    int64_t max_io_dtype_size) {
+  if (isOptionDisabled(DisableOption::RegisterTranspose)) {
+    return false;
+  }
+  LoadStoreOp* permute = getRegisterTransposeOp(fusion);
+  if (permute == nullptr) {
+    return false;
+  }
+  auto permuted = permute->out()->as<TensorView>();
+  const auto& root = permuted->getRootDomain();
+  const auto& rfactor = permuted->getRFactorDomain();
+  IterDomain* inner_in = root.back();
+  IterDomain* inner_out = rfactor.back();
+
+  auto extent = [&](IterDomain* id) {
+    auto value = runtime_info.expressionEvaluator().evaluate(id->extent());
+    NVF_ERROR(
+        value.hasValue(), "Could not infer the extent of ", id->toString());
+    return value.as<int64_t>();
+  };
+
+  // The packed side has the small dimension Y innermost, and the large
+  // dimension X second innermost
+  std::optional<bool> packed_inputs;
+  int64_t x_size = 0;
+  int64_t y_size = 0;
+  if (rfactor.at(rfactor.size() - 2) == inner_in &&
+      extent(inner_out) <= kMaxRegisterTransposeSize) {
+    packed_inputs = false;
+    x_size = extent(inner_in);
+    y_size = extent(inner_out);
+  }
+  if (root.at(root.size() - 2) == inner_out &&
+      extent(inner_in) <= kMaxRegisterTransposeSize &&
+      (!packed_inputs.has_value() || extent(inner_in) < y_size)) {
+    packed_inputs = true;
+    x_size = extent(inner_out);
+    y_size = extent(inner_in);
+  }
+  if (!packed_inputs.has_value()) {
+    return false;
+  }
+
+  // The lanes load and store their rows of the tiles as vectors
+  constexpr int64_t kSixteen = 16; // clang tidy
+  int64_t tile_size = kSixteen / max_io_dtype_size;
+  TensorView* input =
+      *ir_utils::filterByType<TensorView>(fusion->inputs()).begin();
+  TensorView* output =
+      *ir_utils::filterByType<TensorView>(fusion->outputs()).begin();
+  for (auto io_tv : {input, output}) {
+    tile_size = vectorize_helper::getVectorizationFactorTransposeGroup(
+        runtime_info,
+        io_tv,
+        io_tv->getMaybeRFactorDomain().size() - 1,
+        {},
+        {io_tv},
+        tile_size);
+  }
+  while (tile_size > 1 &&
+         (x_size % tile_size != 0 || y_size % tile_size != 0)) {
+    tile_size /= 2;
+  }
+  if (tile_size < 2) {
+    return false;
+  }
+
+  params.register_tile_size = tile_size;
+  params.packed_register_tile_inputs = *packed_inputs;
+  params.vectorize_factor1 = tile_size;
+  params.vectorize_factor2 = tile_size;
+  params.lparams.bind(kRegisterTransposeThreads, ParallelType::TIDx);
+  return true;
+}
+
+// See [ Register Transpose ]
+void scheduleRegisterTranspose(Fusion* fusion, const TransposeParams& params) {
+  const int64_t tile_size = params.register_tile_size;
+
+  auto cached_inputs = scheduler_utils::cacheInputs(fusion, true);
+  auto cached_outputs = scheduler_utils::cacheAndForkOutputs(fusion, true);
+
+  // The permute is recreated when its output is cached
+  LoadStoreOp* permute = getRegisterTransposeOp(fusion);
+  NVF_ERROR(
+      permute != nullptr, "Could not find the permute to transpose in regs.");
+  auto in = permute->in()->as<TensorView>();
+  auto reference = permute->out()->as<TensorView>();
+
+  IterDomain* inner_in = reference->getRootDomain().back();
+  IterDomain* inner_out = reference->getRFactorDomain().back();
+  IterDomain* x_id = params.packed_register_tile_inputs ? inner_out : inner_in;
+  IterDomain* y_id = params.packed_register_tile_inputs ? inner_in : inner_out;
+  auto position = [&](IterDomain* id) {
+    const auto& leaf = reference->getLeafDomain();
+    auto it = std::find(leaf.begin(), leaf.end(), id);
+    NVF_ERROR(it != leaf.end());
+    return (int)std::distance(leaf.begin(), it);
+  };
+  reference->reorder({{position(x_id), -2}, {position(y_id), -1}});
+  // [..., X, Y]
+  reference->split(-1, tile_size);
+  reference->split(-3, tile_size);
+  reference->split(-4, kRegisterTransposeThreads / tile_size);
+  // [..., Xo/G, G, Xi, Yo, Yi]
+  reference->reorder({{-2, -5}});
+  // [..., Xo/G, Yo, G, Xi, Yi]
+  while (reference->nDims() > 5) {
+    reference->merge(0);
+  }
+  // [Outer, Yo, G, Xi, Yi]
+
+  TransformPropagator propagator(reference);
+  MaxRootDomainInfoSpanningTree(reference).traverse(&propagator);
+
+  const auto producer_side =
+      DependencyCheck::getAllValsBetween(
+          {fusion->inputs().begin(), fusion->inputs().end()}, {in});
+  const std::unordered_set<Val*> producer_side_set(
+      producer_side.begin(), producer_side.end());
+  for (auto tv : ir_utils::allTvs(fusion)) {
+    if (tv->isFusionInput()) {
+      continue;
+    }
+    const bool is_packed = params.packed_register_tile_inputs ==
+        (producer_side_set.count(tv) > 0);
+    if (!is_packed) {
+      tv->reorder({{3, -1}});
+    }
+    tv->merge(2);
+    // Packed: [Outer, Yo, G * Xi, Yi], strided: [Outer, Yo, G * Yi, Xi]
+    tv->axis(0)->parallelize(ParallelType::BIDx);
+    tv->axis(2)->parallelize(ParallelType::TIDx);
+  }
+
+  for (auto tv : cached_inputs) {
+    tv->axis(-1)->parallelize(ParallelType::Vectorize);
+  }
+  for (const auto& [cached_output, output] : cached_outputs) {
+    output->axis(-1)->parallelize(ParallelType::Vectorize);
+  }
+  reference->axis(-1)->parallelize(ParallelType::Bulk);
+  permute->setOpType(LoadStoreOpType::WarpTranspose);
+
+  inlineMost();
+}
+
 } // namespace
 
 std::string getTransposeRuntimeRejectReason(
@@ -686,17 +1121,44 @@ std::string getTransposeRuntimeRejectReason(
   auto innermost_info = innermost_info_entry.get();
   auto inner_most_pos1_in_ref1 = innermost_info[0];
   auto inner_most_pos2_in_ref1 = innermost_info[1];
+  auto shared_inner_pos_in_ref1 = innermost_info[2];
   if (inner_most_pos1_in_ref1 < 0 || inner_most_pos2_in_ref1 < 0) {
     return "Transpose scheduler requires exact mapping on inner most dimension on reference tensor.";
   }
 
+  // See note [Transposes with a shared inner dimension]
+  int64_t shared_inner_size = 1;
+  if (domain_map.hasSharedInnerDim()) {
+    if (shared_inner_pos_in_ref1 < 0) {
+      return "Transpose scheduler requires exact mapping on the shared inner most dimension on reference tensor.";
+    }
+    shared_inner_size = shape_in_ref1[shared_inner_pos_in_ref1];
+    int64_t max_io_dtype_size = 1;
+    for (auto tv : ir_utils::filterByType<TensorView>(fusion->inputs())) {
+      max_io_dtype_size = std::max(
+          max_io_dtype_size,
+          (int64_t)dataTypeSize(
+              tv->getDataType().value(), runtime_info.getIndexType()));
+    }
+    for (auto tv : ir_utils::filterByType<TensorView>(fusion->outputs())) {
+      max_io_dtype_size = std::max(
+          max_io_dtype_size,
+          (int64_t)dataTypeSize(
+              tv->getDataType().value(), runtime_info.getIndexType()));
+    }
+    if (shared_inner_size * max_io_dtype_size >
+        kMaxSharedInnerBytesForTiling) {
+      return "The shared inner most dimension is large enough for the "
+             "pointwise scheduler to coalesce memory accesses";
+    }
+  }
+
   constexpr size_t default_tile_elements =
       TransposeParams::getDefaultTileSize() *
       TransposeParams::getDefaultTileSize();
 
   // don't schedule with transpose scheduler if less than a full wave
-  const int64_t device_multiprocessor_count =
-      (int64_t)at::cuda::getCurrentDeviceProperties()->multiProcessorCount;
+  const int64_t device_multiprocessor_count = getDeviceModel().sm_count;
   auto elements_per_wave = device_multiprocessor_count * default_tile_elements;
   if ((int64_t)elements_per_wave > n_elems) {
     return "Transpose scheduler does not perform well on small problem sizes.";
@@ -710,7 +1172,7 @@ std::string getTransposeRuntimeRejectReason(
   // the pointwise scheduler should provide better performance, because it
   // provides coalesced memory access
   if (inner_size1 * inner_size2 < (int64_t)default_tile_elements) {
-    auto inner_elements = inner_size1 * inner_size2;
+    auto inner_elements = inner_size1 * inner_size2 * shared_inner_size;
     for (int64_t i = inner_most_pos2_in_ref1 + 1; i < inner_most_pos1_in_ref1;
          i++) {
       inner_elements *= shape_in_ref1[i];
@@ -753,7 +1215,8 @@ std::string getTransposeRuntimeRejectReason(
         n_elems,
         shape_in_ref1,
         inner_most_pos1_in_ref1,
-        inner_most_pos2_in_ref1);
+        inner_most_pos2_in_ref1,
+        shared_inner_pos_in_ref1);
 
     // disallow transpose scheduler when we have a combination of:
     // 1. view op; and
@@ -831,8 +1294,7 @@ std::shared_ptr<TransposeParams> getTransposeHeuristics(
   auto& shape_in_ref1 = pair.first;
   auto& n_elems = pair.second;
 
-  const int64_t device_multiprocessor_count =
-      (int64_t)at::cuda::getCurrentDeviceProperties()->multiProcessorCount;
+  const int64_t device_multiprocessor_count = getDeviceModel().sm_count;
 
   auto innermost_info_entry = getInnerMostDimInfoInReference(
       data_cache, reference_tensors, reference1, domain_map);
@@ -840,14 +1302,61 @@ std::shared_ptr<TransposeParams> getTransposeHeuristics(
 
   auto inner_most_pos1_in_ref1 = innermost_info[0];
   auto inner_most_pos2_in_ref1 = innermost_info[1];
+  auto shared_inner_pos_in_ref1 = innermost_info[2];
   // No exact innermost leaf dimension mapping on referenc1. cannot schedule
   if (inner_most_pos1_in_ref1 < 0 || inner_most_pos2_in_ref1 < 0) {
     return nullptr;
   }
+  const bool has_shared_inner_dim = domain_map.hasSharedInnerDim();
+  if (has_shared_inner_dim && shared_inner_pos_in_ref1 < 0) {
+    return nullptr;
+  }
 
   auto params =
       std::make_shared<TransposeParams>("Transpose heuristics", index_type);
 
+  int64_t max_io_dtype_size = 1;
+  size_t n_io_tensors = 0;
+  auto scan_max_dtype_size = [&](const auto& vals) {
+    for (auto inp : ir_utils::filterByType<TensorView>(vals)) {
+      max_io_dtype_size = std::max(
+          max_io_dtype_size,
+          (int64_t)dataTypeSize(inp->getDataType().value(), index_type));
+      n_io_tensors++;
+    }
+  };
+  scan_max_dtype_size(fusion->inputs());
+  scan_max_dtype_size(fusion->outputs());
+
+  // See [ Register Transpose ]
+  if (!has_shared_inner_dim &&
+      maybeUseRegisterTranspose(
+          *params, fusion, runtime_info, max_io_dtype_size)) {
+    if (isDebugDumpEnabled(DebugDumpOption::SchedulerDebug)) {
+      debug() << params->toString() << std::endl;
+    }
+    return params;
+  }
+
+  // Each element of a tile is a row of the shared inner dimension, so shrink
+  // the tiles until a tile fits in the shared memory budget of the default
+  // tile. See note [Transposes with a shared inner dimension]
+  if (has_shared_inner_dim) {
+    const int64_t shared_inner_bytes =
+        shape_in_ref1[shared_inner_pos_in_ref1] * max_io_dtype_size;
+    const int64_t max_tile_bytes =
+        (int64_t)(TransposeParams::getDefaultTileSize() *
+                  TransposeParams::getDefaultTileSize()) *
+        max_io_dtype_size;
+    while (params->tile_size1 > 8 &&
+           (int64_t)(params->tile_size1 * params->tile_size2) *
+                   shared_inner_bytes >
+               max_tile_bytes) {
+      params->tile_size1 /= 2;
+      params->tile_size2 /= 2;
+    }
+  }
+
   // Expand inner-most dims to virtual inner-most dims so that the inner-most
   // dims has at least tile_size elements
   // See note [Supporting small transpose dimensions]
@@ -857,7 +1366,8 @@ std::shared_ptr<TransposeParams> getTransposeHeuristics(
       n_elems,
       shape_in_ref1,
       inner_most_pos1_in_ref1,
-      inner_most_pos2_in_ref1);
+      inner_most_pos2_in_ref1,
+      shared_inner_pos_in_ref1);
 
   NVF_ERROR(
       !hasSmallTransposeDimensions(params) ||
@@ -891,19 +1401,6 @@ std::shared_ptr<TransposeParams> getTransposeHeuristics(
 
   constexpr int64_t kSixteen = 16; // clang tidy
 
-  int64_t max_io_dtype_size = 1;
-  size_t n_io_tensors = 0;
-  auto scan_max_dtype_size = [&](const auto& vals) {
-    for (auto inp : ir_utils::filterByType<TensorView>(vals)) {
-      max_io_dtype_size = std::max(
-          max_io_dtype_size,
-          (int64_t)dataTypeSize(inp->getDataType().value(), index_type));
-      n_io_tensors++;
-    }
-  };
-  scan_max_dtype_size(fusion->inputs());
-  scan_max_dtype_size(fusion->outputs());
-
   auto max_unroll_factor = ceilDiv(
       // Available unrolling based on size of data type
       (int64_t)kSixteen / max_io_dtype_size,
@@ -968,27 +1465,57 @@ std::shared_ptr<TransposeParams> getTransposeHeuristics(
     // simply map those merged domains via ContiguousInnerDimensionsMapper
     scheduler_utils::splitDims(reference1, params->split_before_tiling);
 
-    params->vectorize_factor1 =
-        vectorize_helper::getVectorizationFactorTransposeGroup(
-            runtime_info,
-            reference1,
-            inner_most_pos1_in_ref1,
-            params->dims_merged_with_1,
-            grouped_inputs_outputs[0],
-            max_unroll_factor);
-
-    // TODO: Since group2 only has global->shared and shared->global set op, we
-    // can have fine-grained control of unroll/vectorization at per tensor
-    // level. We should not be using a single global vectorize factor for the
-    // entire group 2
-    params->vectorize_factor2 =
-        vectorize_helper::getVectorizationFactorTransposeGroup(
-            runtime_info,
-            reference1,
-            inner_most_pos2_in_ref1,
-            params->dims_merged_with_2,
-            grouped_inputs_outputs[1],
-            max_unroll_factor);
+    // Both groups are vectorized along the shared inner dimension. See note
+    // [Transposes with a shared inner dimension]
+    if (has_shared_inner_dim) {
+      std::vector<TensorView*> all_inputs_outputs(
+          grouped_inputs_outputs[0].begin(), grouped_inputs_outputs[0].end());
+      all_inputs_outputs.insert(
+          all_inputs_outputs.end(),
+          grouped_inputs_outputs[1].begin(),
+          grouped_inputs_outputs[1].end());
+      params->vectorize_factor1 =
+          vectorize_helper::getVectorizationFactorTransposeGroup(
+              runtime_info,
+              reference1,
+              shared_inner_pos_in_ref1,
+              {},
+              all_inputs_outputs,
+              max_unroll_factor);
+      params->vectorize_factor2 = params->vectorize_factor1;
+    } else {
+      params->vectorize_factor1 =
+          vectorize_helper::getVectorizationFactorTransposeGroup(
+              runtime_info,
+              reference1,
+              inner_most_pos1_in_ref1,
+              params->dims_merged_with_1,
+              grouped_inputs_outputs[0],
+              max_unroll_factor);
+
+      // TODO: Since group2 only has global->shared and shared->global set op,
+      // we can have fine-grained control of unroll/vectorization at per
+      // tensor level. We should not be using a single global vectorize factor
+      // for the entire group 2
+      params->vectorize_factor2 =
+          vectorize_helper::getVectorizationFactorTransposeGroup(
+              runtime_info,
+              reference1,
+              inner_most_pos2_in_ref1,
+              params->dims_merged_with_2,
+              grouped_inputs_outputs[1],
+              max_unroll_factor);
+    }
+  }
+
+  // See [ Transpose Grid Swizzle ]
+  if (!hasSmallTransposeDimensions(params) && !has_shared_inner_dim) {
+    params->grid_swizzle_factor = getTransposeGridSwizzleFactor(
+        params,
+        shape_in_ref1,
+        inner_most_pos1_in_ref1,
+        inner_most_pos2_in_ref1,
+        max_io_dtype_size * (int64_t)n_io_tensors);
   }
 
   params->lparams.bind(params->getThreadsPerBlock(), ParallelType::TIDx);
@@ -1046,6 +1573,12 @@ void scheduleTranspose(Fusion* fusion, TransposeParams params) {
       !ir_utils::hasAnyReductionOps(fusion),
       "This scheduler only handles pointwise ops.");
 
+  // See [ Register Transpose ]
+  if (params.register_tile_size > 1) {
+    scheduleRegisterTranspose(fusion, params);
+    return;
+  }
+
   // Cache inputs
   auto cached_inputs = scheduler_utils::cacheInputs(fusion, true);
 
@@ -1135,8 +1668,19 @@ void scheduleTranspose(Fusion* fusion, TransposeParams params) {
       reference2 != nullptr,
       "Could not find a fully broadcasted tensor to reference schedule on the second group.");
 
-  auto inner_most_id1 = scheduler_utils::innerMostAllocDim(reference1);
-  auto inner_most_id2 = scheduler_utils::innerMostAllocDim(reference2);
+  auto inner_most_id1 = domain_map.innerMostTransposedDim(reference1);
+  auto inner_most_id2 = domain_map.innerMostTransposedDim(reference2);
+
+  // See note [Transposes with a shared inner dimension]
+  IterDomain* shared_inner_id = nullptr;
+  if (domain_map.hasSharedInnerDim()) {
+    auto shared_inner_leaf_index = domain_map.getInnerLeafDim(
+        reference1, scheduler_utils::innerMostAllocDim(reference1));
+    NVF_ERROR(
+        shared_inner_leaf_index >= 0, "getInnerLeafDim cannot be resolved");
+    shared_inner_id = reference1->axis((int)shared_inner_leaf_index);
+  }
+  const int n_shared = shared_inner_id == nullptr ? 0 : 1;
 
   //////////////////////////////////////////
   // Step 1: Make virtual inner most dims //
@@ -1194,10 +1738,36 @@ void scheduleTranspose(Fusion* fusion, TransposeParams params) {
   reference1->split((int)inner_most_pos2_in_ref1, params.tile_size2);
   reference1->reorder({{inner_most_pos2_in_ref1 + 1, -1}});
   // [..., I1/tile1, .., I2/tile2, ..., tile1, tile2]
+  if (shared_inner_id != nullptr) {
+    auto shared_it = std::find(
+        reference1->getLeafDomain().begin(),
+        reference1->getLeafDomain().end(),
+        shared_inner_id);
+    NVF_ERROR(shared_it != reference1->getLeafDomain().end());
+    reference1->reorder(
+        {{(int)std::distance(reference1->getLeafDomain().begin(), shared_it),
+          -1}});
+    // [..., I1/tile1, .., I2/tile2, ..., tile1, tile2, D]
+  }
+
+  // See [ Transpose Grid Swizzle ]
+  if (params.grid_swizzle_factor > 1) {
+    NVF_ERROR(shared_inner_id == nullptr);
+    const int outer_pos =
+        (int)std::min(inner_most_pos1_in_ref1, inner_most_pos2_in_ref1);
+    const int inner_pos =
+        (int)std::max(inner_most_pos1_in_ref1, inner_most_pos2_in_ref1);
+    reference1->split(outer_pos, params.grid_swizzle_factor);
+    // [..., I_outer/tile/factor, factor, .., I_inner/tile, ...]
+    reference1->reorder({{outer_pos + 1, inner_pos + 1}});
+    // [..., I_outer/tile/factor, .., I_inner/tile, factor, ...]
+    reference1->merge(inner_pos);
+    // [..., I_outer/tile/factor, .., I_inner/tile * factor, ...]
+  }
 
   // Merge remaining dimensions
   int lhs_i = -1;
-  for (int i = (int)reference1->nDims() - 2; i > 0; i--) {
+  for (int i = (int)reference1->nDims() - 2 - n_shared; i > 0; i--) {
     auto axis_i = i - 1;
     if (lhs_i == -1) {
       lhs_i = axis_i;
@@ -1207,7 +1777,7 @@ void scheduleTranspose(Fusion* fusion, TransposeParams params) {
     }
   }
   reference1->split(0, 1);
-  // [merged_dim, 1, tile1, tile2]
+  // [merged_dim, 1, tile1, tile2(, D)]
 
   // parallelize non-tile dimensions
   reference1->axis(1)->parallelize(ParallelType::Unswitch);
@@ -1234,9 +1804,12 @@ void scheduleTranspose(Fusion* fusion, TransposeParams params) {
   // transform tile for vectorization/unroll
   // See note [vectorization and unroll of input and output]
 
-  int pos = (int)reference2->nDims() - 2;
-  // [..., tile1, tile2]
+  int pos = (int)reference2->nDims() - 2 - n_shared;
+  // [..., tile1, tile2(, D)]
   reference2->merge(pos);
+  if (shared_inner_id != nullptr) {
+    reference2->merge(pos);
+  }
   reference2->split(pos, params.vectorize_factor2);
   reference2->split(pos, params.getThreadsPerBlock());
   // [..., Unroll, TIDx, Vectorize]
@@ -1318,10 +1891,13 @@ void scheduleTranspose(Fusion* fusion, TransposeParams params) {
   //////////////////////////////
 
   // schedule group 1
-  reference1->reorder({{-2, -1}});
-  // [..., tile2, tile1]
-  pos = (int)reference1->nDims() - 2;
+  reference1->reorder({{-2 - n_shared, -1 - n_shared}});
+  // [..., tile2, tile1(, D)]
+  pos = (int)reference1->nDims() - 2 - n_shared;
   reference1->merge(pos);
+  if (shared_inner_id != nullptr) {
+    reference1->merge(pos);
+  }
   reference1->split(pos, params.vectorize_factor1);
   reference1->split(pos, params.getThreadsPerBlock());
   if (params.vectorize_factor1 > 1) {
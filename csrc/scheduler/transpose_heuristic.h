@@ -50,6 +50,22 @@ class TransposeParams : public HeuristicParams {
   // Tile size for the inner most dim of tensors in the second group
   size_t tile_size2 = getDefaultTileSize();
 
+  // Number of consecutive tiles along the outer tiled dim that consecutive
+  // blocks walk before moving along the inner one, so that the blocks running
+  // at once read and write nearby rows of both groups. 1 keeps the row-major
+  // order of the tiles. See [ Transpose Grid Swizzle ] in transpose.cpp.
+  int64_t grid_swizzle_factor = 1;
+
+  // Size of the square tiles that groups of lanes of a warp transpose in
+  // registers with shuffles, instead of tiling through shared memory, or 1.
+  // See [ Register Transpose ] in transpose.cpp.
+  int64_t register_tile_size = 1;
+
+  // Whether the inputs rather than the outputs access the register tiles as
+  // register_tile_size contiguous rows, i.e., have the small dimension
+  // innermost
+  bool packed_register_tile_inputs = false;
+
   using HeuristicParams::HeuristicParams;
 
   // Warning: Does not check launch parameters!
@@ -66,7 +82,10 @@ class TransposeParams : public HeuristicParams {
         other.dims_merged_with_2 == dims_merged_with_2 &&
         other.vectorize_factor1 == vectorize_factor1 &&
         other.vectorize_factor2 == vectorize_factor2 &&
-        other.tile_size1 == tile_size1 && other.tile_size2 == tile_size2;
+        other.tile_size1 == tile_size1 && other.tile_size2 == tile_size2 &&
+        other.grid_swizzle_factor == grid_swizzle_factor &&
+        other.register_tile_size == register_tile_size &&
+        other.packed_register_tile_inputs == packed_register_tile_inputs;
     return attr_equal;
   }
 
@@ -75,12 +94,22 @@ class TransposeParams : public HeuristicParams {
     ss << "\n===== Transpose Parameters ========\n"
        << (tag == "" ? "" : "Tag: ") << tag << " Transpose Characteristics:\n"
        << " BlckX: " << lparams.bdimx() << "\n";
+    if (register_tile_size > 1) {
+      ss << " register tile size: " << register_tile_size << "\n"
+         << " packed register tiles: "
+         << (packed_register_tile_inputs ? "inputs" : "outputs") << "\n";
+      ss << "====================================\n";
+      return ss.str();
+    }
     ss << " input tile size: " << tile_size1 << "\n";
     ss << " output tile size: " << tile_size2 << "\n";
     int elements_per_tile = tile_size1 * tile_size2;
     ss << " elements per tile: " << elements_per_tile << "\n";
     int elements_per_thread = elements_per_tile / lparams.bdimx();
     ss << " elements per thread: " << elements_per_thread << "\n";
+    if (grid_swizzle_factor > 1) {
+      ss << " grid swizzle factor: " << grid_swizzle_factor << "\n";
+    }
     if (vectorize_factor1 > 1) {
       ss << "Vectorize group 1, Factor: " << vectorize_factor1 << "\n";
     }
@@ -147,7 +176,10 @@ class TransposeParams : public HeuristicParams {
         vectorize_factor1,
         vectorize_factor2,
         tile_size1,
-        tile_size2);
+        tile_size2,
+        grid_swizzle_factor,
+        register_tile_size,
+        packed_register_tile_inputs);
   }
 
   std::shared_ptr<HeuristicParams> clone() const override {
@@ -10,11 +10,14 @@
 #include <scheduler/vectorize_helper.h>
 
 #include <contiguity.h>
+#include <debug.h>
 #include <expr_evaluator.h>
 #include <instrumentation.h>
 #include <ir/utils.h>
 #include <ops/all_ops.h>
+#include <options.h>
 #include <root_domain_map.h>
+#include <scheduler/device_model.h>
 #include <scheduler/mma_utils.h>
 #include <transform_iter.h>
 #include <transform_replay.h>
@@ -1148,6 +1151,12 @@ std::vector<std::pair<TensorView*, TensorView*>> cacheAndForkOutputs(
         output->definition()->isA<ScatterOp>()) {
       continue;
     }
+    // Atomic grid reductions accumulate directly into the global output, see
+    // [ Atomic Grid Reduction ]
+    if (auto rop = dynamic_cast<ReductionOp*>(output->definition());
+        rop != nullptr && rop->atomicGridReductionRequested()) {
+      continue;
+    }
     if (!output->uses().empty()) {
       output = output->cacheFork();
     }
@@ -1402,6 +1411,20 @@ std::unordered_set<IterDomain*> FindAllMappedDims::get() const {
   return mapped_id_set;
 }
 
+namespace {
+
+// Whether tv is only used as the lookup tensor of index_select ops. The
+// innermost dimension of tv is only mapped to the reference, and thus
+// vectorized, when it's not indexed.
+bool isOnlyIndexSelectLookupTv(TensorView* tv) {
+  return std::all_of(tv->uses().begin(), tv->uses().end(), [tv](Expr* use) {
+    auto index_select = dynamic_cast<IndexSelectOp*>(use);
+    return index_select != nullptr && index_select->lookupTv() == tv;
+  });
+}
+
+} // namespace
+
 bool hasInnerDim(
     TensorView* tv,
     std::unordered_set<IterDomain*> inner_dims,
@@ -1474,6 +1497,11 @@ std::vector<TensorView*> getInputsOutputsWithInnerDim(
   // scheduler prefer to use output instead of input as reference tensor.
   for (auto output_tv :
        ir_utils::filterByType<TensorView>(reference_tv->fusion()->outputs())) {
+    // The writes of scatter ops are indexed by index_tv
+    if (vectorize_pass && output_tv->definition() != nullptr &&
+        output_tv->definition()->isA<ScatterOp>()) {
+      continue;
+    }
     if (hasInnerDim(output_tv, vectorizable_dims, vectorize_pass)) {
       vectorizable_tensors.push_back(output_tv);
     }
@@ -1482,9 +1510,12 @@ std::vector<TensorView*> getInputsOutputsWithInnerDim(
   for (auto input_tv :
        ir_utils::filterByType<TensorView>(reference_tv->fusion()->inputs())) {
     // for index_select(lookup_tv, dim, index_tv) op
-    // ignore it's lookup_tv.
+    // ignore it's lookup_tv, unless it's only read by index_select ops, whose
+    // outputs can then be vectorized along the innermost dimension of
+    // lookup_tv, e.g., the embedding dimension of an embedding lookup.
     if (ir_utils::isTorchGatherLookupTv(input_tv) ||
-        ir_utils::isIndexSelectLookupTv(input_tv)) {
+        (ir_utils::isIndexSelectLookupTv(input_tv) &&
+         !(vectorize_pass && isOnlyIndexSelectLookupTv(input_tv)))) {
       continue;
     }
     if (hasInnerDim(input_tv, vectorizable_dims, vectorize_pass)) {
@@ -2455,6 +2486,64 @@ std::unordered_set<TensorView*> getAllTvsFrom(
   return tv_group;
 }
 
+std::vector<int64_t> getExtentDivisors(
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info) {
+  // With a divisor given to the option, an extent is either divisible by it
+  // or not, so there are only two size classes per extent
+  int64_t specialized_divisor = 0;
+  const auto& args =
+      getEnableOptionArguments(EnableOption::SizeSpecialization);
+  if (!args.empty()) {
+    try {
+      specialized_divisor = std::stoll(args.at(0));
+    } catch (const std::exception& e) {
+      debug() << "skip invalid argument for SizeSpecialization, arg = "
+              << args.at(0) << std::endl;
+    }
+    if (specialized_divisor < 2 || specialized_divisor > kMaxExtentDivisor ||
+        lastPow2(specialized_divisor) != specialized_divisor) {
+      specialized_divisor = 0;
+    }
+  }
+
+  std::vector<int64_t> divisors;
+  for (auto tv : ir_utils::filterByType<TensorView>(fusion->inputs())) {
+    for (auto id : tv->getRootDomain()) {
+      auto extent = runtime_info.expressionEvaluator().evaluate(id->extent());
+      NVF_ERROR(
+          extent.hasValue(),
+          "Could not infer the extent of ",
+          id->toString(),
+          " of ",
+          tv->toString());
+      int64_t divisor = 1;
+      while (divisor < kMaxExtentDivisor &&
+             extent.as<int64_t>() % (divisor * 2) == 0) {
+        divisor *= 2;
+      }
+      if (specialized_divisor > 0) {
+        divisor = divisor >= specialized_divisor ? specialized_divisor : 1;
+      }
+      divisors.push_back(divisor);
+    }
+  }
+  return divisors;
+}
+
+int64_t getGridSwizzleFactor(int64_t swept_bytes, int64_t outer_tiles) {
+  const int64_t l2_size = getDeviceModel().l2_size;
+  if (l2_size <= 0) {
+    return 1;
+  }
+  int64_t factor = 1;
+  while (factor < kMaxGridSwizzleFactor && factor * 2 <= outer_tiles &&
+         swept_bytes * 2 > l2_size * factor) {
+    factor *= 2;
+  }
+  return factor;
+}
+
 } // namespace scheduler_utils
 
 } // namespace nvfuser
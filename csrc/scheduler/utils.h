@@ -342,7 +342,9 @@ bool hasInnerDim(
 // ignore all broadcast axes. If inner_only, will require inner->inner mapping
 // in view, otherwise, it allows all inner->any mapping. If vectorize_pass, will
 // check contiguity for vectorization, otherwise it just checks it has that
-// inner dim.
+// inner dim. Lookup tensors of gathers are ignored, except those only read by
+// index_select ops in a vectorize_pass, which are vectorized through the
+// outputs of the index_select ops.
 std::vector<TensorView*> getInputsOutputsWithInnerDim(
     TensorView* reference_tv,
     bool inner_only,
@@ -636,5 +638,24 @@ std::unordered_set<TensorView*> getAllTvsFrom(
     const std::vector<TensorView*>& from_tvs,
     const std::unordered_set<TensorView*>& cutoff_tv_set);
 
+//! Largest power-of-two divisors, up to kMaxExtentDivisor, of the extents of
+//! the root domains of the fusion input tensors, in order of the inputs and
+//! their domains. With NVFUSER_ENABLE=size_specialization(<divisor>), each
+//! divisor is instead the given power of two if it divides the extent, or 1.
+//! See [ Size-Specialized Predicate Elimination ]
+constexpr int64_t kMaxExtentDivisor = 1024;
+std::vector<int64_t> getExtentDivisors(
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info);
+
+//! Number of consecutive tiles along the outer dimension of a 2D grid of
+//! outer_tiles rows that consecutive blocks should walk before moving along
+//! the inner dimension, so that the swept_bytes a row of tiles reads across
+//! the inner dimension are shared in L2 by the blocks running at once. This is
+//! the smallest power of two, up to kMaxGridSwizzleFactor, that brings the
+//! bytes per group of rows under half of L2, or 1 if a row already fits.
+constexpr int64_t kMaxGridSwizzleFactor = 8;
+int64_t getGridSwizzleFactor(int64_t swept_bytes, int64_t outer_tiles);
+
 } // namespace scheduler_utils
 } // namespace nvfuser
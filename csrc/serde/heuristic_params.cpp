@@ -0,0 +1,405 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <scheduler/matmul_heuristic.h>
+#include <scheduler/pointwise_heuristic.h>
+#include <scheduler/reduction_heuristic.h>
+#include <scheduler/transpose_heuristic.h>
+#include <serde/heuristic_params.h>
+#include <serde/utils.h>
+
+namespace nvfuser::serde {
+
+namespace {
+
+flatbuffers::Offset<CompileParams> serializeCompileParams(
+    flatbuffers::FlatBufferBuilder& builder,
+    const nvfuser::CompileParams& cparams) {
+  return CreateCompileParamsDirect(
+      builder,
+      cparams.index_type.has_value()
+          ? (int64_t)toUnderlying(cparams.index_type.value())
+          : -1,
+      cparams.maxrregcount,
+      cparams.enable_magic_zero,
+      cparams.enable_ptxas_verbose,
+      &cparams.extent_divisors,
+      cparams.enable_fast_math,
+      cparams.enable_warp_segment_reduction);
+}
+
+nvfuser::CompileParams deserializeCompileParams(const CompileParams* buffer) {
+  NVF_ERROR(buffer != nullptr, "serde::CompileParams is nullptr.");
+  nvfuser::CompileParams cparams;
+  if (buffer->index_type() >= 0) {
+    cparams.index_type = mapToNvfuserDtype(buffer->index_type());
+  }
+  cparams.maxrregcount = buffer->maxrregcount();
+  cparams.enable_magic_zero = buffer->enable_magic_zero();
+  cparams.enable_ptxas_verbose = buffer->enable_ptxas_verbose();
+  if (buffer->extent_divisors() != nullptr) {
+    cparams.extent_divisors = parseVector(buffer->extent_divisors());
+  }
+  cparams.enable_fast_math = buffer->enable_fast_math();
+  cparams.enable_warp_segment_reduction =
+      buffer->enable_warp_segment_reduction();
+  return cparams;
+}
+
+flatbuffers::Offset<PointwiseParams> serializePointwiseParams(
+    flatbuffers::FlatBufferBuilder& builder,
+    const nvfuser::PointwiseParams& params) {
+  return CreatePointwiseParams(
+      builder,
+      params.vectorize,
+      params.break_point,
+      params.split_block,
+      params.split_grid_y_dim,
+      params.flip_grid_binding,
+      params.unroll_factor,
+      params.persistent_grid,
+      params.misaligned_vectorize,
+      params.grid_swizzle_factor);
+}
+
+std::shared_ptr<nvfuser::HeuristicParams> deserializePointwiseParams(
+    const PointwiseParams* buffer) {
+  auto params = std::make_shared<nvfuser::PointwiseParams>();
+  params->vectorize = buffer->vectorize();
+  params->break_point = (int)buffer->break_point();
+  params->split_block = buffer->split_block();
+  params->split_grid_y_dim = buffer->split_grid_y_dim();
+  params->flip_grid_binding = buffer->flip_grid_binding();
+  params->unroll_factor = buffer->unroll_factor();
+  params->persistent_grid = buffer->persistent_grid();
+  params->misaligned_vectorize = buffer->misaligned_vectorize();
+  params->grid_swizzle_factor = buffer->grid_swizzle_factor();
+  return params;
+}
+
+flatbuffers::Offset<ReductionParams> serializeReductionParams(
+    flatbuffers::FlatBufferBuilder& builder,
+    const nvfuser::ReductionParams& params) {
+  ReductionParamsBuilder rpb(builder);
+  rpb.add_fastest_dim(params.fastest_dim);
+  rpb.add_persistent_kernel(params.persistent_kernel);
+  rpb.add_project_persistent_buffers(params.project_persistent_buffers);
+  rpb.add_schedule_3d(params.schedule_3D);
+  rpb.add_flip_grid(params.flip_grid);
+  rpb.add_cross_block_inner_reduction(params.cross_block_inner_reduction);
+  rpb.add_cross_grid_inner_reduction(params.cross_grid_inner_reduction);
+  rpb.add_unroll_factor_inner_reduction(params.unroll_factor_inner_reduction);
+  rpb.add_vectorize_inner_reduction(params.vectorize_inner_reduction);
+  rpb.add_split_grid_dim_inner_reduction(
+      params.split_grid_dim_inner_reduction);
+  rpb.add_pad_inner_reduction_to_warp(params.pad_inner_reduction_to_warp);
+  rpb.add_batches_per_block_inner_reduction(
+      params.batches_per_block_inner_reduction);
+  rpb.add_block_dim_inner_reduction(
+      (int)toUnderlying(params.block_dim_inner_reduction));
+  rpb.add_grid_dim_inner_reduction(
+      (int)toUnderlying(params.grid_dim_inner_reduction));
+  rpb.add_multiple_reds_per_blk(params.multiple_reds_per_blk);
+  rpb.add_unroll_factor_iter_dom(params.unroll_factor_iter_dom);
+  rpb.add_vectorize_iter_dom(params.vectorize_iter_dom);
+  rpb.add_split_grid_dim_iter_dom_inner(params.split_grid_dim_iter_dom_inner);
+  rpb.add_split_grid_dim_iter_dom_outer(params.split_grid_dim_iter_dom_outer);
+  rpb.add_block_dim_iter_dom((int)toUnderlying(params.block_dim_iter_dom));
+  rpb.add_grid_dim_iter_dom((int)toUnderlying(params.grid_dim_iter_dom));
+  rpb.add_cross_block_outer_reduction(params.cross_block_outer_reduction);
+  rpb.add_cross_grid_outer_reduction(params.cross_grid_outer_reduction);
+  rpb.add_split_grid_dim_outer_reduction(
+      params.split_grid_dim_outer_reduction);
+  rpb.add_batches_per_block_outer_reduction(
+      params.batches_per_block_outer_reduction);
+  rpb.add_unroll_factor_outer_reduction(params.unroll_factor_outer_reduction);
+  rpb.add_block_dim_outer_reduction(
+      (int)toUnderlying(params.block_dim_outer_reduction));
+  rpb.add_grid_dim_outer_reduction(
+      (int)toUnderlying(params.grid_dim_outer_reduction));
+  rpb.add_compute_persistent_buffer_with_first_consumer(
+      params.compute_persistent_buffer_with_first_consumer);
+  rpb.add_static_bdimx(params.static_bdimx);
+  rpb.add_static_bdimy(params.static_bdimy);
+  rpb.add_combined_inner_outer(params.combined_inner_outer);
+  rpb.add_tidx_for_outer_reduction(params.tidx_for_outer_reduction);
+  rpb.add_pad_outer_reduction_to_warp(params.pad_outer_reduction_to_warp);
+  rpb.add_vectorization_factor_outer(params.vectorization_factor_outer);
+  rpb.add_vectorization_factor_tmp_gmem_write(
+      params.vectorization_factor_tmp_gmem_write);
+  rpb.add_block_dim_inner_reduction_extra(
+      (int)toUnderlying(params.block_dim_inner_reduction_extra));
+  rpb.add_shared_mem_persistent_buffer(params.shared_mem_persistent_buffer);
+  rpb.add_tma_load_persistent_buffer(params.tma_load_persistent_buffer);
+  rpb.add_circular_buffer_stages(params.circular_buffer_stages);
+  rpb.add_single_pass_grid_reduction(params.single_pass_grid_reduction);
+  rpb.add_atomic_grid_reduction(params.atomic_grid_reduction);
+  rpb.add_accumulators_inner_reduction(params.accumulators_inner_reduction);
+  rpb.add_prefetch_cached_inputs(params.prefetch_cached_inputs);
+  rpb.add_register_persistent_buffer_bytes(
+      params.register_persistent_buffer_bytes);
+  return rpb.Finish();
+}
+
+std::shared_ptr<nvfuser::HeuristicParams> deserializeReductionParams(
+    const ReductionParams* buffer) {
+  auto params = std::make_shared<nvfuser::ReductionParams>();
+  params->fastest_dim = buffer->fastest_dim();
+  params->persistent_kernel = buffer->persistent_kernel();
+  params->project_persistent_buffers = buffer->project_persistent_buffers();
+  params->schedule_3D = buffer->schedule_3d();
+  params->flip_grid = buffer->flip_grid();
+  params->cross_block_inner_reduction = buffer->cross_block_inner_reduction();
+  params->cross_grid_inner_reduction = buffer->cross_grid_inner_reduction();
+  params->unroll_factor_inner_reduction =
+      buffer->unroll_factor_inner_reduction();
+  params->vectorize_inner_reduction = buffer->vectorize_inner_reduction();
+  params->split_grid_dim_inner_reduction =
+      buffer->split_grid_dim_inner_reduction();
+  params->pad_inner_reduction_to_warp = buffer->pad_inner_reduction_to_warp();
+  params->batches_per_block_inner_reduction =
+      buffer->batches_per_block_inner_reduction();
+  params->block_dim_inner_reduction =
+      static_cast<ParallelType>(buffer->block_dim_inner_reduction());
+  params->grid_dim_inner_reduction =
+      static_cast<ParallelType>(buffer->grid_dim_inner_reduction());
+  params->multiple_reds_per_blk = buffer->multiple_reds_per_blk();
+  params->unroll_factor_iter_dom = buffer->unroll_factor_iter_dom();
+  params->vectorize_iter_dom = buffer->vectorize_iter_dom();
+  params->split_grid_dim_iter_dom_inner =
+      buffer->split_grid_dim_iter_dom_inner();
+  params->split_grid_dim_iter_dom_outer =
+      buffer->split_grid_dim_iter_dom_outer();
+  params->block_dim_iter_dom =
+      static_cast<ParallelType>(buffer->block_dim_iter_dom());
+  params->grid_dim_iter_dom =
+      static_cast<ParallelType>(buffer->grid_dim_iter_dom());
+  params->cross_block_outer_reduction = buffer->cross_block_outer_reduction();
+  params->cross_grid_outer_reduction = buffer->cross_grid_outer_reduction();
+  params->split_grid_dim_outer_reduction =
+      buffer->split_grid_dim_outer_reduction();
+  params->batches_per_block_outer_reduction =
+      buffer->batches_per_block_outer_reduction();
+  params->unroll_factor_outer_reduction =
+      buffer->unroll_factor_outer_reduction();
+  params->block_dim_outer_reduction =
+      static_cast<ParallelType>(buffer->block_dim_outer_reduction());
+  params->grid_dim_outer_reduction =
+      static_cast<ParallelType>(buffer->grid_dim_outer_reduction());
+  params->compute_persistent_buffer_with_first_consumer =
+      buffer->compute_persistent_buffer_with_first_consumer();
+  params->static_bdimx = buffer->static_bdimx();
+  params->static_bdimy = buffer->static_bdimy();
+  params->combined_inner_outer = buffer->combined_inner_outer();
+  params->tidx_for_outer_reduction = buffer->tidx_for_outer_reduction();
+  params->pad_outer_reduction_to_warp = buffer->pad_outer_reduction_to_warp();
+  params->vectorization_factor_outer = buffer->vectorization_factor_outer();
+  params->vectorization_factor_tmp_gmem_write =
+      buffer->vectorization_factor_tmp_gmem_write();
+  params->block_dim_inner_reduction_extra =
+      static_cast<ParallelType>(buffer->block_dim_inner_reduction_extra());
+  params->shared_mem_persistent_buffer =
+      buffer->shared_mem_persistent_buffer();
+  params->tma_load_persistent_buffer = buffer->tma_load_persistent_buffer();
+  params->circular_buffer_stages = buffer->circular_buffer_stages();
+  params->single_pass_grid_reduction = buffer->single_pass_grid_reduction();
+  params->atomic_grid_reduction = buffer->atomic_grid_reduction();
+  params->accumulators_inner_reduction =
+      buffer->accumulators_inner_reduction();
+  params->prefetch_cached_inputs = buffer->prefetch_cached_inputs();
+  params->register_persistent_buffer_bytes =
+      buffer->register_persistent_buffer_bytes();
+  return params;
+}
+
+flatbuffers::Offset<TransposeParams> serializeTransposeParams(
+    flatbuffers::FlatBufferBuilder& builder,
+    const nvfuser::TransposeParams& params) {
+  std::vector<uint64_t> split_before_tiling;
+  split_before_tiling.reserve(params.split_before_tiling.size() * 2);
+  for (const auto& [dim, factor] : params.split_before_tiling) {
+    split_before_tiling.push_back(dim);
+    split_before_tiling.push_back(factor);
+  }
+  std::vector<uint64_t> dims_merged_with_1(
+      params.dims_merged_with_1.begin(), params.dims_merged_with_1.end());
+  std::vector<uint64_t> dims_merged_with_2(
+      params.dims_merged_with_2.begin(), params.dims_merged_with_2.end());
+  return CreateTransposeParamsDirect(
+      builder,
+      &split_before_tiling,
+      &dims_merged_with_1,
+      &dims_merged_with_2,
+      params.vectorize_factor1,
+      params.vectorize_factor2,
+      params.tile_size1,
+      params.tile_size2,
+      params.grid_swizzle_factor,
+      params.register_tile_size,
+      params.packed_register_tile_inputs);
+}
+
+std::shared_ptr<nvfuser::HeuristicParams> deserializeTransposeParams(
+    const TransposeParams* buffer) {
+  auto params = std::make_shared<nvfuser::TransposeParams>();
+  if (buffer->split_before_tiling() != nullptr) {
+    const auto* splits = buffer->split_before_tiling();
+    NVF_ERROR(splits->size() % 2 == 0, "Expected pairs of splits.");
+    for (flatbuffers::uoffset_t i = 0; i < splits->size(); i += 2) {
+      params->split_before_tiling.emplace_back(
+          splits->Get(i), splits->Get(i + 1));
+    }
+  }
+  if (buffer->dims_merged_with_1() != nullptr) {
+    params->dims_merged_with_1.assign(
+        buffer->dims_merged_with_1()->begin(),
+        buffer->dims_merged_with_1()->end());
+  }
+  if (buffer->dims_merged_with_2() != nullptr) {
+    params->dims_merged_with_2.assign(
+        buffer->dims_merged_with_2()->begin(),
+        buffer->dims_merged_with_2()->end());
+  }
+  params->vectorize_factor1 = buffer->vectorize_factor1();
+  params->vectorize_factor2 = buffer->vectorize_factor2();
+  params->tile_size1 = buffer->tile_size1();
+  params->tile_size2 = buffer->tile_size2();
+  params->grid_swizzle_factor = buffer->grid_swizzle_factor();
+  params->register_tile_size = buffer->register_tile_size();
+  params->packed_register_tile_inputs =
+      buffer->packed_register_tile_inputs();
+  return params;
+}
+
+GemmTile deserializeGemmTile(const flatbuffers::Vector<int32_t>* buffer) {
+  NVF_ERROR(
+      buffer != nullptr && buffer->size() == 3,
+      "Expected the m, n and k of a tile.");
+  return GemmTile(buffer->Get(0), buffer->Get(1), buffer->Get(2));
+}
+
+flatbuffers::Offset<MatmulParams> serializeMatmulParams(
+    flatbuffers::FlatBufferBuilder& builder,
+    const nvfuser::MatmulParams& params) {
+  const auto cta_tile = params.tile_sizes.cta_tile.toVector();
+  const auto warp_tile = params.tile_sizes.warp_tile.toVector();
+  const auto instruction_tile = params.tile_sizes.instruction_tile.toVector();
+  const auto& double_buffer = params.double_buffer_options;
+  return CreateMatmulParamsDirect(
+      builder,
+      params.rotate_ldmatrix_out_of_main_loop,
+      params.async_gmem_load_operands,
+      &cta_tile,
+      &warp_tile,
+      &instruction_tile,
+      toUnderlying(params.mma_macro),
+      (int)toUnderlying(params.cta_order),
+      double_buffer.double_buffer_smem_write,
+      double_buffer.double_buffer_smem_read,
+      double_buffer.smem_double_buffer_stage,
+      double_buffer.mbarrier_handoff,
+      params.grid_swizzle_factor,
+      params.use_smem_epilogue,
+      params.promote_prologue_smem_reuse,
+      params.splitk_factor,
+      params.use_serial_splitk);
+}
+
+std::shared_ptr<nvfuser::HeuristicParams> deserializeMatmulParams(
+    const MatmulParams* buffer) {
+  auto params = std::make_shared<nvfuser::MatmulParams>();
+  params->rotate_ldmatrix_out_of_main_loop =
+      buffer->rotate_ldmatrix_out_of_main_loop();
+  params->async_gmem_load_operands = buffer->async_gmem_load_operands();
+  params->tile_sizes = MatMulTileOptions(
+      deserializeGemmTile(buffer->cta_tile()),
+      deserializeGemmTile(buffer->warp_tile()),
+      deserializeGemmTile(buffer->instruction_tile()));
+  params->mma_macro = static_cast<MmaMacro>(buffer->mma_macro());
+  params->cta_order =
+      static_cast<nvfuser::MatmulParams::TileRasterizationOrder>(
+          buffer->cta_order());
+  auto& double_buffer = params->double_buffer_options;
+  double_buffer.double_buffer_smem_write = buffer->double_buffer_smem_write();
+  double_buffer.double_buffer_smem_read = buffer->double_buffer_smem_read();
+  double_buffer.smem_double_buffer_stage = buffer->smem_double_buffer_stage();
+  double_buffer.mbarrier_handoff = buffer->mbarrier_handoff();
+  params->grid_swizzle_factor = buffer->grid_swizzle_factor();
+  params->use_smem_epilogue = buffer->use_smem_epilogue();
+  params->promote_prologue_smem_reuse = buffer->promote_prologue_smem_reuse();
+  params->splitk_factor = buffer->splitk_factor();
+  params->use_serial_splitk = buffer->use_serial_splitk();
+  return params;
+}
+
+} // namespace
+
+flatbuffers::Offset<HeuristicParams> serializeHeuristicParams(
+    flatbuffers::FlatBufferBuilder& builder,
+    const nvfuser::HeuristicParams& params) {
+  // See table definition for HeuristicParams in serde/fusion_cache.fbs
+  HeuristicParamsData data_type = HeuristicParamsData::NONE;
+  flatbuffers::Offset<void> data = 0;
+  if (auto pparams = dynamic_cast<const nvfuser::PointwiseParams*>(&params)) {
+    data_type = HeuristicParamsData::PointwiseParams;
+    data = serializePointwiseParams(builder, *pparams).Union();
+  } else if (
+      auto rparams = dynamic_cast<const nvfuser::ReductionParams*>(&params)) {
+    data_type = HeuristicParamsData::ReductionParams;
+    data = serializeReductionParams(builder, *rparams).Union();
+  } else if (
+      auto tparams = dynamic_cast<const nvfuser::TransposeParams*>(&params)) {
+    data_type = HeuristicParamsData::TransposeParams;
+    data = serializeTransposeParams(builder, *tparams).Union();
+  } else if (
+      auto mparams = dynamic_cast<const nvfuser::MatmulParams*>(&params)) {
+    data_type = HeuristicParamsData::MatmulParams;
+    data = serializeMatmulParams(builder, *mparams).Union();
+  }
+
+  if (data_type == HeuristicParamsData::NONE) {
+    return CreateHeuristicParams(builder);
+  }
+  return CreateHeuristicParams(
+      builder,
+      builder.CreateString(params.tag),
+      params.lparams.serialize(builder),
+      serializeCompileParams(builder, params.cparams),
+      data_type,
+      data);
+}
+
+std::shared_ptr<nvfuser::HeuristicParams> deserializeHeuristicParams(
+    const HeuristicParams* buffer) {
+  // See table definition for HeuristicParams in serde/fusion_cache.fbs
+  NVF_ERROR(buffer != nullptr, "serde::HeuristicParams is nullptr.");
+  std::shared_ptr<nvfuser::HeuristicParams> params;
+  switch (buffer->data_type()) {
+    case HeuristicParamsData::PointwiseParams:
+      params = deserializePointwiseParams(buffer->data_as_PointwiseParams());
+      break;
+    case HeuristicParamsData::ReductionParams:
+      params = deserializeReductionParams(buffer->data_as_ReductionParams());
+      break;
+    case HeuristicParamsData::TransposeParams:
+      params = deserializeTransposeParams(buffer->data_as_TransposeParams());
+      break;
+    case HeuristicParamsData::MatmulParams:
+      params = deserializeMatmulParams(buffer->data_as_MatmulParams());
+      break;
+    default:
+      return nullptr;
+  }
+  if (buffer->tag() != nullptr) {
+    params->tag = buffer->tag()->str();
+  }
+  params->lparams.deserialize(buffer->lparams());
+  params->cparams = deserializeCompileParams(buffer->cparams());
+  return params;
+}
+
+} // namespace nvfuser::serde
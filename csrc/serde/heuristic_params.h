@@ -0,0 +1,28 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+#include <exceptions.h>
+#include <scheduler/heuristic.h>
+#include <serde/fusion_cache_generated.h>
+
+#include <memory>
+
+namespace nvfuser::serde {
+
+//! Serializes the parameters of the pointwise, reduction, normalization,
+//! transpose and matmul heuristics. The parameters of the other heuristics
+//! are serialized without data, so that they are computed again.
+flatbuffers::Offset<HeuristicParams> serializeHeuristicParams(
+    flatbuffers::FlatBufferBuilder& builder,
+    const nvfuser::HeuristicParams& params);
+
+//! The parameters of a HeuristicParams table, or nullptr if it has no data
+std::shared_ptr<nvfuser::HeuristicParams> deserializeHeuristicParams(
+    const HeuristicParams* buffer);
+
+} // namespace nvfuser::serde
@@ -0,0 +1,199 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <telemetry.h>
+
+#include <cuda_utils.h>
+#include <exceptions.h>
+#include <options.h>
+
+#include <sstream>
+
+namespace nvfuser {
+
+FusionTelemetry::FusionTelemetry()
+    : enabled_(isOptionEnabled(EnableOption::Telemetry)) {
+  if (!enabled_) {
+    return;
+  }
+  const auto& args = getEnableOptionArguments(EnableOption::Telemetry);
+  if (!args.empty()) {
+    try {
+      sample_period_ = std::stoll(args.at(0));
+    } catch (const std::exception& e) {
+      TORCH_WARN(
+          "Invalid sample period for nvFuser telemetry, using ",
+          sample_period_,
+          ": ",
+          args.at(0));
+    }
+  }
+}
+
+FusionTelemetry::~FusionTelemetry() {
+  std::lock_guard<std::mutex> guard(sample_mutex_);
+  free_samples_.insert(
+      free_samples_.end(), pending_samples_.begin(), pending_samples_.end());
+  for (const Sample& sample : free_samples_) {
+    NVFUSER_CUDA_RT_SAFE_CALL(cudaEventDestroy(sample.start));
+    NVFUSER_CUDA_RT_SAFE_CALL(cudaEventDestroy(sample.stop));
+  }
+}
+
+bool FusionTelemetry::beginRun() {
+  if (!enabled_) {
+    return false;
+  }
+  const int64_t run = runs_.fetch_add(1, std::memory_order_relaxed);
+  return sample_period_ > 0 && run % sample_period_ == 0;
+}
+
+void FusionTelemetry::recordRuntimeLookup(RuntimeLookup lookup) {
+  if (!enabled_) {
+    return;
+  }
+  switch (lookup) {
+    case RuntimeLookup::InputCacheHit:
+      input_cache_hits_.fetch_add(1, std::memory_order_relaxed);
+      break;
+    case RuntimeLookup::Reuse:
+      runtime_reuses_.fetch_add(1, std::memory_order_relaxed);
+      break;
+    case RuntimeLookup::Miss:
+      runtime_misses_.fetch_add(1, std::memory_order_relaxed);
+      break;
+  }
+}
+
+void FusionTelemetry::recordCompilation(double blocked_ms) {
+  if (!enabled_) {
+    return;
+  }
+  compilations_.fetch_add(1, std::memory_order_relaxed);
+  compile_us_.fetch_add(
+      (int64_t)(blocked_ms * 1000.0), std::memory_order_relaxed);
+}
+
+void FusionTelemetry::recordRun(int64_t launches, int64_t bytes_moved) {
+  if (!enabled_) {
+    return;
+  }
+  launches_.fetch_add(launches, std::memory_order_relaxed);
+  bytes_moved_.fetch_add(bytes_moved, std::memory_order_relaxed);
+}
+
+FusionTelemetry::Sample FusionTelemetry::startSample(cudaStream_t stream) {
+  Sample sample;
+  {
+    std::lock_guard<std::mutex> guard(sample_mutex_);
+    if (!free_samples_.empty()) {
+      sample = free_samples_.back();
+      free_samples_.pop_back();
+    }
+  }
+  if (sample.start == nullptr) {
+    NVFUSER_CUDA_RT_SAFE_CALL(cudaEventCreate(&sample.start));
+    NVFUSER_CUDA_RT_SAFE_CALL(cudaEventCreate(&sample.stop));
+  }
+  NVFUSER_CUDA_RT_SAFE_CALL(cudaEventRecord(sample.start, stream));
+  return sample;
+}
+
+void FusionTelemetry::stopSample(Sample sample, cudaStream_t stream) {
+  NVFUSER_CUDA_RT_SAFE_CALL(cudaEventRecord(sample.stop, stream));
+  bool finished = false;
+  {
+    std::lock_guard<std::mutex> guard(sample_mutex_);
+    // The earlier samples most likely finished by now
+    finished = pollSamples();
+    pending_samples_.push_back(sample);
+  }
+  if (finished && callback_) {
+    callback_(snapshot());
+  }
+}
+
+bool FusionTelemetry::pollSamples() {
+  bool finished = false;
+  while (!pending_samples_.empty()) {
+    const Sample& sample = pending_samples_.front();
+    // Samples are recorded in order, but may be on different streams
+    const cudaError_t status = cudaEventQuery(sample.stop);
+    if (status == cudaErrorNotReady) {
+      break;
+    }
+    NVFUSER_CUDA_RT_SAFE_CALL(status);
+    float ms = 0.0;
+    NVFUSER_CUDA_RT_SAFE_CALL(
+        cudaEventElapsedTime(&ms, sample.start, sample.stop));
+    sampled_runs_++;
+    sampled_kernel_ms_ += ms;
+    free_samples_.push_back(sample);
+    pending_samples_.pop_front();
+    finished = true;
+  }
+  return finished;
+}
+
+FusionTelemetry::Snapshot FusionTelemetry::snapshot() {
+  Snapshot snapshot;
+  snapshot.runs = runs_.load(std::memory_order_relaxed);
+  snapshot.input_cache_hits =
+      input_cache_hits_.load(std::memory_order_relaxed);
+  snapshot.runtime_reuses = runtime_reuses_.load(std::memory_order_relaxed);
+  snapshot.runtime_misses = runtime_misses_.load(std::memory_order_relaxed);
+  snapshot.compilations = compilations_.load(std::memory_order_relaxed);
+  snapshot.compile_ms =
+      (double)compile_us_.load(std::memory_order_relaxed) / 1000.0;
+  snapshot.launches = launches_.load(std::memory_order_relaxed);
+  snapshot.bytes_moved = bytes_moved_.load(std::memory_order_relaxed);
+  std::lock_guard<std::mutex> guard(sample_mutex_);
+  pollSamples();
+  snapshot.sampled_runs = sampled_runs_;
+  snapshot.sampled_kernel_ms = sampled_kernel_ms_;
+  return snapshot;
+}
+
+std::string FusionTelemetry::toPrometheus(int64_t fusion_id) {
+  const Snapshot s = snapshot();
+  std::stringstream ss;
+  const std::string labels =
+      "{fusion_id=\"" + std::to_string(fusion_id) + "\"} ";
+  auto add = [&](const char* name, const char* help, auto value) {
+    ss << "# HELP nvfuser_" << name << " " << help << "\n";
+    ss << "# TYPE nvfuser_" << name << " counter\n";
+    ss << "nvfuser_" << name << labels << value << "\n";
+  };
+  add("runs_total", "Runs of the fusion", s.runs);
+  add("input_cache_hits_total",
+      "Runs whose inputs were seen before",
+      s.input_cache_hits);
+  add("runtime_reuses_total",
+      "Runs of new inputs that reused compiled kernels",
+      s.runtime_reuses);
+  add("runtime_misses_total",
+      "Runs of new inputs that needed a new runtime",
+      s.runtime_misses);
+  add("compilations_total", "Compilations of runtimes", s.compilations);
+  add("compile_ms_total", "Host time blocked on compilation", s.compile_ms);
+  add("launches_total", "Segments run", s.launches);
+  add("bytes_moved_total", "Bytes of inputs and outputs", s.bytes_moved);
+  add("sampled_runs_total",
+      "Runs whose kernel time was sampled",
+      s.sampled_runs);
+  add("sampled_kernel_ms_total",
+      "Device time of the sampled runs",
+      s.sampled_kernel_ms);
+  return ss.str();
+}
+
+void FusionTelemetry::setCallback(
+    std::function<void(const Snapshot&)> callback) {
+  callback_ = std::move(callback);
+}
+
+} // namespace nvfuser
@@ -0,0 +1,131 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <cuda_runtime.h>
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace nvfuser {
+
+//! [ Fusion Telemetry ]
+//!
+//! FusionProfiler times every segment of a run and synchronizes the device
+//! to do so, which is too expensive to leave on in production. With
+//! NVFUSER_ENABLE=telemetry, each FusionExecutorCache instead keeps
+//! cumulative counters of its runs: how its runtimes were found, how many
+//! were compiled and how long that blocked the runs, the segments launched
+//! and the bytes of the inputs and outputs. The time of the kernels of every
+//! Nth run, N = 100 by default or given as telemetry(N), is sampled with a
+//! pair of CUDA events recorded on the stream around the run. The events are
+//! polled without blocking at the next run and when the counters are read,
+//! so sampling never synchronizes.
+//!
+//! The counters are read with FusionExecutorCache::telemetry(), exported as
+//! Prometheus text with toPrometheus, or pushed to a callback whenever a
+//! sample completes.
+class FusionTelemetry {
+ public:
+  struct Snapshot {
+    int64_t runs = 0;
+    //! Runs whose inputs were seen before
+    int64_t input_cache_hits = 0;
+    //! Runs of new inputs that reused the kernels of a runtime
+    int64_t runtime_reuses = 0;
+    //! Runs of new inputs that needed a new runtime
+    int64_t runtime_misses = 0;
+    int64_t compilations = 0;
+    //! Host time of runs blocked on compilation
+    double compile_ms = 0.0;
+    //! Segments run, each of which launches at most one kernel
+    int64_t launches = 0;
+    //! Bytes of the inputs and outputs of the runs
+    int64_t bytes_moved = 0;
+    int64_t sampled_runs = 0;
+    //! Device time of the sampled runs
+    double sampled_kernel_ms = 0.0;
+  };
+
+  enum class RuntimeLookup { InputCacheHit, Reuse, Miss };
+
+  //! Enabled when NVFUSER_ENABLE=telemetry was set at construction
+  FusionTelemetry();
+  ~FusionTelemetry();
+
+  FusionTelemetry(const FusionTelemetry&) = delete;
+  FusionTelemetry& operator=(const FusionTelemetry&) = delete;
+
+  bool isEnabled() const {
+    return enabled_;
+  }
+
+  //! Count a run and return whether its kernel time is to be sampled
+  bool beginRun();
+
+  void recordRuntimeLookup(RuntimeLookup lookup);
+
+  void recordCompilation(double blocked_ms);
+
+  void recordRun(int64_t launches, int64_t bytes_moved);
+
+  //! The events recorded around the launches of a sampled run
+  struct Sample {
+    cudaEvent_t start = nullptr;
+    cudaEvent_t stop = nullptr;
+  };
+
+  //! Record the start event of a sampled run on stream
+  Sample startSample(cudaStream_t stream);
+
+  //! Record the stop event of sample on stream. Its time is accounted once
+  //! the event completes.
+  void stopSample(Sample sample, cudaStream_t stream);
+
+  //! The counters, including the samples that finished by now
+  Snapshot snapshot();
+
+  //! The counters as Prometheus metrics labeled with fusion_id
+  std::string toPrometheus(int64_t fusion_id);
+
+  //! Called with the counters whenever a sample finishes
+  void setCallback(std::function<void(const Snapshot&)> callback);
+
+ private:
+  //! Account the finished samples and recycle their events, and return
+  //! whether there were any. Requires sample_mutex_.
+  bool pollSamples();
+
+ private:
+  bool enabled_ = false;
+  int64_t sample_period_ = 100;
+
+  std::atomic<int64_t> runs_ = 0;
+  std::atomic<int64_t> input_cache_hits_ = 0;
+  std::atomic<int64_t> runtime_reuses_ = 0;
+  std::atomic<int64_t> runtime_misses_ = 0;
+  std::atomic<int64_t> compilations_ = 0;
+  std::atomic<int64_t> compile_us_ = 0;
+  std::atomic<int64_t> launches_ = 0;
+  std::atomic<int64_t> bytes_moved_ = 0;
+
+  std::mutex sample_mutex_;
+  //! Samples whose events are recorded but may not have completed yet
+  std::deque<Sample> pending_samples_;
+  std::vector<Sample> free_samples_;
+  int64_t sampled_runs_ = 0;
+  double sampled_kernel_ms_ = 0.0;
+  std::function<void(const Snapshot&)> callback_;
+};
+
+} // namespace nvfuser
@@ -252,6 +252,7 @@ TensorView::TensorView(const TensorView* src, IrCloner* ir_cloner)
       is_double_buffered_(src->is_double_buffered_),
       is_circular_buffered_(src->is_circular_buffered_),
       circular_buffer_stage_(src->circular_buffer_stage_),
+      has_mbarrier_handoff_(src->has_mbarrier_handoff_),
       cpu_scalar_(src->cpu_scalar_),
       has_swizzle_op_(src->has_swizzle_op_),
       compute_with_consumers_(ir_cloner->clone(src->compute_with_consumers_)),
@@ -1409,6 +1410,22 @@ void TensorView::circularBuffer(unsigned int stage) {
   circular_buffer_stage_ = stage;
 }
 
+void TensorView::handOffStagesWithMBarriers() {
+  NVF_CHECK(
+      is_double_buffered_ || is_circular_buffered_,
+      "Only double or circular buffered tensors can be handed off with mbarriers: ",
+      toString());
+  auto def = definition();
+  NVF_CHECK(
+      ir_utils::isCpAsyncOp(def) &&
+          def->input(0)->as<TensorView>()->getMemoryType() ==
+              MemoryType::Global &&
+          getMemoryType() == MemoryType::Shared,
+      "MBarrier handoff requires a cp.async load from global to shared memory: ",
+      def->toString());
+  has_mbarrier_handoff_ = true;
+}
+
 bool TensorView::isEmptyTensor() const {
   auto& root_domain = getMaybeRFactorDomain();
   return std::all_of(
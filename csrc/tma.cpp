@@ -35,10 +35,15 @@ inline CUtensorMapDataType getCUtensorMapDataType(DataType dtype) {
       return CU_TENSOR_MAP_DATA_TYPE_FLOAT16;
     case PrimDataType::BFloat16:
       return CU_TENSOR_MAP_DATA_TYPE_BFLOAT16;
+    case PrimDataType::Float8_e4m3fn:
+    case PrimDataType::Float8_e5m2:
+      return CU_TENSOR_MAP_DATA_TYPE_UINT8;
     case PrimDataType::Int:
       return CU_TENSOR_MAP_DATA_TYPE_INT64;
     case PrimDataType::Int32:
       return CU_TENSOR_MAP_DATA_TYPE_INT32;
+    case PrimDataType::Int8:
+      return CU_TENSOR_MAP_DATA_TYPE_UINT8;
     default:
       NVF_ERROR(false, "Unknown tensor map data type!");
   }
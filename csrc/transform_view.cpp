@@ -902,6 +902,29 @@ size_t AnalyzeViewResult::hash() const {
   return broadcast_hash ^ squeeze_hash ^ transform_hash;
 }
 
+void AnalyzeViewResult::encode(std::vector<int64_t>& encoding) const {
+  // The sizes come first so that the elements need no delimiters. A split is
+  // encoded as its index and its factor, which is positive, and a merge as its
+  // index and 0.
+  encoding.push_back((int64_t)broadcast_axes.size());
+  encoding.insert(encoding.end(), broadcast_axes.begin(), broadcast_axes.end());
+  encoding.push_back((int64_t)squeeze_axes.size());
+  encoding.insert(encoding.end(), squeeze_axes.begin(), squeeze_axes.end());
+  encoding.push_back((int64_t)transforms.size());
+  for (const auto& transform : transforms) {
+    if (transform->isA<SplitTransform>()) {
+      encoding.push_back(transform->index());
+      encoding.push_back(transform->as<SplitTransform>()->split_factor());
+    } else {
+      NVF_ERROR(
+          transform->isA<MergeTransform>(),
+          "Unrecognized transformation found.");
+      encoding.push_back(transform->index());
+      encoding.push_back(0);
+    }
+  }
+}
+
 namespace {
 
 //! Transform TensorView according to keep, merge, and split transformations.
@@ -52,6 +52,10 @@ struct AnalyzeViewResult {
   }
 
   size_t hash() const;
+
+  //! Append an integer encoding of this result to encoding. Two results are
+  //! equal if and only if their encodings are.
+  void encode(std::vector<int64_t>& encoding) const;
 };
 
 struct AnalyzeViewConstraint {
@@ -111,12 +111,19 @@ bool isInclusiveType(const DataType& base_type, const DataType& wider_type) {
   if ((wider_type == DataType::Double ||
        wider_type == DataType::ComplexDouble) &&
       (base_type == DataType::Double || base_type == DataType::Float ||
-       base_type == DataType::Half || base_type == DataType::BFloat16)) {
+       base_type == DataType::Half || base_type == DataType::BFloat16 ||
+       isFp8Type(base_type))) {
     return true;
   }
   if ((wider_type == DataType::Float || wider_type == DataType::ComplexFloat) &&
       (base_type == DataType::Float || base_type == DataType::Half ||
-       base_type == DataType::BFloat16)) {
+       base_type == DataType::BFloat16 || isFp8Type(base_type))) {
+    return true;
+  }
+  // Both FP8 types have fewer exponent and mantissa bits than half and
+  // bfloat16
+  if ((wider_type == DataType::Half || wider_type == DataType::BFloat16) &&
+      isFp8Type(base_type)) {
     return true;
   }
   if ((wider_type == DataType::Int || wider_type == DataType::Double ||
@@ -214,12 +221,18 @@ static std::string data_type2string(DataType t) {
               return "__half";
             case DataType::BFloat16:
               return "__bfloat";
+            case DataType::Float8_e4m3fn:
+              return "__e4m3";
+            case DataType::Float8_e5m2:
+              return "__e5m2";
             case DataType::Int:
               return "int64_t";
             case DataType::Index:
               return "nvfuser_index_t";
             case DataType::Int32:
               return "int";
+            case DataType::Int8:
+              return "int8_t";
             case DataType::UInt:
               return "uint64_t";
             case DataType::UInt32:
@@ -658,6 +671,8 @@ static const char* ternary_op_type2string(TernaryOpType t) {
   switch (t) {
     case TernaryOpType::Clamp:
       return "clamp";
+    case TernaryOpType::FastDiv:
+      return "fastDiv";
     case TernaryOpType::Lerp:
       return "lerp";
     case TernaryOpType::Threshold:
@@ -832,8 +847,12 @@ const char* load_store_type2string(LoadStoreOpType t) {
       return "LdMatrixTranspose";
     case LoadStoreOpType::CpAsync:
       return "CpAsync";
+    case LoadStoreOpType::CpAsyncBulk:
+      return "CpAsyncBulk";
     case LoadStoreOpType::CpAsyncBulkTensorTile:
       return "CpAsyncBulkTensorTile";
+    case LoadStoreOpType::WarpTranspose:
+      return "WarpTranspose";
     default:
       NVF_ERROR(false, "Unexpected parallel type");
   }
@@ -854,6 +873,7 @@ static const char* supported_casts2string(std::pair<DataType, DataType> t) {
     case supported_switch_pair(DataType::Index, DataType::Float):
     case supported_switch_pair(DataType::Int, DataType::Float):
     case supported_switch_pair(DataType::Int32, DataType::Float):
+    case supported_switch_pair(DataType::Int8, DataType::Float):
     case supported_switch_pair(DataType::UInt, DataType::Float):
     case supported_switch_pair(DataType::UInt32, DataType::Float):
     case supported_switch_pair(DataType::Double, DataType::Float):
@@ -864,6 +884,7 @@ static const char* supported_casts2string(std::pair<DataType, DataType> t) {
       return "(float)std::real";
     case supported_switch_pair(DataType::Index, DataType::Int):
     case supported_switch_pair(DataType::Int32, DataType::Int):
+    case supported_switch_pair(DataType::Int8, DataType::Int):
     case supported_switch_pair(DataType::UInt, DataType::Int):
     case supported_switch_pair(DataType::UInt32, DataType::Int):
     case supported_switch_pair(DataType::Float, DataType::Int):
@@ -875,6 +896,7 @@ static const char* supported_casts2string(std::pair<DataType, DataType> t) {
       return "(int64_t)std::real";
     case supported_switch_pair(DataType::Index, DataType::Int32):
     case supported_switch_pair(DataType::Int, DataType::Int32):
+    case supported_switch_pair(DataType::Int8, DataType::Int32):
     case supported_switch_pair(DataType::UInt, DataType::Int32):
     case supported_switch_pair(DataType::UInt32, DataType::Int32):
     case supported_switch_pair(DataType::Float, DataType::Int32):
@@ -884,9 +906,22 @@ static const char* supported_casts2string(std::pair<DataType, DataType> t) {
     case supported_switch_pair(DataType::ComplexFloat, DataType::Int32):
     case supported_switch_pair(DataType::ComplexDouble, DataType::Int32):
       return "(int32_t)std::real";
+    case supported_switch_pair(DataType::Index, DataType::Int8):
+    case supported_switch_pair(DataType::Int, DataType::Int8):
+    case supported_switch_pair(DataType::Int32, DataType::Int8):
+    case supported_switch_pair(DataType::UInt, DataType::Int8):
+    case supported_switch_pair(DataType::UInt32, DataType::Int8):
+    case supported_switch_pair(DataType::Float, DataType::Int8):
+    case supported_switch_pair(DataType::Double, DataType::Int8):
+    case supported_switch_pair(DataType::Bool, DataType::Int8):
+      return "(int8_t)";
+    case supported_switch_pair(DataType::ComplexFloat, DataType::Int8):
+    case supported_switch_pair(DataType::ComplexDouble, DataType::Int8):
+      return "(int8_t)std::real";
     case supported_switch_pair(DataType::Index, DataType::UInt):
     case supported_switch_pair(DataType::Int, DataType::UInt):
     case supported_switch_pair(DataType::Int32, DataType::UInt):
+    case supported_switch_pair(DataType::Int8, DataType::UInt):
     case supported_switch_pair(DataType::UInt32, DataType::UInt):
     case supported_switch_pair(DataType::Float, DataType::UInt):
     case supported_switch_pair(DataType::Double, DataType::UInt):
@@ -898,6 +933,7 @@ static const char* supported_casts2string(std::pair<DataType, DataType> t) {
     case supported_switch_pair(DataType::Index, DataType::UInt32):
     case supported_switch_pair(DataType::Int, DataType::UInt32):
     case supported_switch_pair(DataType::Int32, DataType::UInt32):
+    case supported_switch_pair(DataType::Int8, DataType::UInt32):
     case supported_switch_pair(DataType::UInt, DataType::UInt32):
     case supported_switch_pair(DataType::Float, DataType::UInt32):
     case supported_switch_pair(DataType::Double, DataType::UInt32):
@@ -908,6 +944,7 @@ static const char* supported_casts2string(std::pair<DataType, DataType> t) {
       return "(uint32_t)std::real";
     case supported_switch_pair(DataType::Int, DataType::Index):
     case supported_switch_pair(DataType::Int32, DataType::Index):
+    case supported_switch_pair(DataType::Int8, DataType::Index):
     case supported_switch_pair(DataType::UInt, DataType::Index):
     case supported_switch_pair(DataType::UInt32, DataType::Index):
     case supported_switch_pair(DataType::Float, DataType::Index):
@@ -920,6 +957,7 @@ static const char* supported_casts2string(std::pair<DataType, DataType> t) {
     case supported_switch_pair(DataType::Index, DataType::Double):
     case supported_switch_pair(DataType::Int, DataType::Double):
     case supported_switch_pair(DataType::Int32, DataType::Double):
+    case supported_switch_pair(DataType::Int8, DataType::Double):
     case supported_switch_pair(DataType::UInt, DataType::Double):
     case supported_switch_pair(DataType::UInt32, DataType::Double):
     case supported_switch_pair(DataType::Float, DataType::Double):
@@ -933,6 +971,7 @@ static const char* supported_casts2string(std::pair<DataType, DataType> t) {
     case supported_switch_pair(DataType::Index, DataType::Bool):
     case supported_switch_pair(DataType::Int, DataType::Bool):
     case supported_switch_pair(DataType::Int32, DataType::Bool):
+    case supported_switch_pair(DataType::Int8, DataType::Bool):
     case supported_switch_pair(DataType::UInt, DataType::Bool):
     case supported_switch_pair(DataType::UInt32, DataType::Bool):
       return "(bool)";
@@ -942,6 +981,7 @@ static const char* supported_casts2string(std::pair<DataType, DataType> t) {
     case supported_switch_pair(DataType::Index, DataType::ComplexDouble):
     case supported_switch_pair(DataType::Int, DataType::ComplexDouble):
     case supported_switch_pair(DataType::Int32, DataType::ComplexDouble):
+    case supported_switch_pair(DataType::Int8, DataType::ComplexDouble):
     case supported_switch_pair(DataType::UInt, DataType::ComplexDouble):
     case supported_switch_pair(DataType::UInt32, DataType::ComplexDouble):
     case supported_switch_pair(DataType::Double, DataType::ComplexDouble):
@@ -952,6 +992,7 @@ static const char* supported_casts2string(std::pair<DataType, DataType> t) {
     case supported_switch_pair(DataType::Index, DataType::ComplexFloat):
     case supported_switch_pair(DataType::Int, DataType::ComplexFloat):
     case supported_switch_pair(DataType::Int32, DataType::ComplexFloat):
+    case supported_switch_pair(DataType::Int8, DataType::ComplexFloat):
     case supported_switch_pair(DataType::UInt, DataType::ComplexFloat):
     case supported_switch_pair(DataType::UInt32, DataType::ComplexFloat):
     case supported_switch_pair(DataType::Double, DataType::ComplexFloat):
@@ -966,6 +1007,7 @@ static const char* supported_casts2string(std::pair<DataType, DataType> t) {
       return "__double2half";
     case supported_switch_pair(DataType::Int, DataType::Half):
     case supported_switch_pair(DataType::Int32, DataType::Half):
+    case supported_switch_pair(DataType::Int8, DataType::Half):
     case supported_switch_pair(DataType::UInt, DataType::Half):
     case supported_switch_pair(DataType::UInt32, DataType::Half):
     case supported_switch_pair(DataType::Index, DataType::Half):
@@ -984,6 +1026,8 @@ static const char* supported_casts2string(std::pair<DataType, DataType> t) {
       return "__half2int32";
     case supported_switch_pair(DataType::Half, DataType::Int):
       return "__half2int";
+    case supported_switch_pair(DataType::Half, DataType::Int8):
+      return "(int8_t)__half2int32";
     case supported_switch_pair(DataType::Half, DataType::UInt32):
       return "__half2uint32";
     case supported_switch_pair(DataType::Half, DataType::UInt):
@@ -1005,6 +1049,7 @@ static const char* supported_casts2string(std::pair<DataType, DataType> t) {
       return "__half2bfloat";
     case supported_switch_pair(DataType::Int, DataType::BFloat16):
     case supported_switch_pair(DataType::Int32, DataType::BFloat16):
+    case supported_switch_pair(DataType::Int8, DataType::BFloat16):
     case supported_switch_pair(DataType::UInt, DataType::BFloat16):
     case supported_switch_pair(DataType::UInt32, DataType::BFloat16):
     case supported_switch_pair(DataType::Index, DataType::BFloat16):
@@ -1025,6 +1070,8 @@ static const char* supported_casts2string(std::pair<DataType, DataType> t) {
       return "__bfloat2int32";
     case supported_switch_pair(DataType::BFloat16, DataType::Int):
       return "__bfloat2int";
+    case supported_switch_pair(DataType::BFloat16, DataType::Int8):
+      return "(int8_t)__bfloat2int32";
     case supported_switch_pair(DataType::BFloat16, DataType::UInt32):
       return "__bfloat2uint32";
     case supported_switch_pair(DataType::BFloat16, DataType::UInt):
@@ -1038,6 +1085,40 @@ static const char* supported_casts2string(std::pair<DataType, DataType> t) {
     case supported_switch_pair(DataType::BFloat16, DataType::ComplexDouble):
       return "(std::complex<double>)__bfloat2double";
 
+    case supported_switch_pair(DataType::Float, DataType::Float8_e4m3fn):
+      return "__float2e4m3";
+    case supported_switch_pair(DataType::Double, DataType::Float8_e4m3fn):
+      return "__double2e4m3";
+    case supported_switch_pair(DataType::Half, DataType::Float8_e4m3fn):
+      return "__half2e4m3";
+    case supported_switch_pair(DataType::BFloat16, DataType::Float8_e4m3fn):
+      return "__bfloat2e4m3";
+    case supported_switch_pair(DataType::Float8_e4m3fn, DataType::Float):
+      return "__e4m32float";
+    case supported_switch_pair(DataType::Float8_e4m3fn, DataType::Double):
+      return "__e4m32double";
+    case supported_switch_pair(DataType::Float8_e4m3fn, DataType::Half):
+      return "__e4m32half";
+    case supported_switch_pair(DataType::Float8_e4m3fn, DataType::BFloat16):
+      return "__e4m32bfloat";
+
+    case supported_switch_pair(DataType::Float, DataType::Float8_e5m2):
+      return "__float2e5m2";
+    case supported_switch_pair(DataType::Double, DataType::Float8_e5m2):
+      return "__double2e5m2";
+    case supported_switch_pair(DataType::Half, DataType::Float8_e5m2):
+      return "__half2e5m2";
+    case supported_switch_pair(DataType::BFloat16, DataType::Float8_e5m2):
+      return "__bfloat2e5m2";
+    case supported_switch_pair(DataType::Float8_e5m2, DataType::Float):
+      return "__e5m22float";
+    case supported_switch_pair(DataType::Float8_e5m2, DataType::Double):
+      return "__e5m22double";
+    case supported_switch_pair(DataType::Float8_e5m2, DataType::Half):
+      return "__e5m22half";
+    case supported_switch_pair(DataType::Float8_e5m2, DataType::BFloat16):
+      return "__e5m22bfloat";
+
     default:
       return nullptr;
   }
@@ -1055,10 +1136,16 @@ DataType aten_to_data_type(const at::ScalarType& scalar_type) {
       return DataType::Half;
     case at::ScalarType::BFloat16:
       return DataType::BFloat16;
+    case at::ScalarType::Float8_e4m3fn:
+      return DataType::Float8_e4m3fn;
+    case at::ScalarType::Float8_e5m2:
+      return DataType::Float8_e5m2;
     case at::ScalarType::Long:
       return DataType::Int;
     case at::ScalarType::Int:
       return DataType::Int32;
+    case at::ScalarType::Char:
+      return DataType::Int8;
     case at::ScalarType::ComplexFloat:
       return DataType::ComplexFloat;
     case at::ScalarType::ComplexDouble:
@@ -1080,6 +1167,10 @@ at::ScalarType data_type_to_aten(const DataType& data_type) {
       return at::ScalarType::Half;
     case DataType::BFloat16:
       return at::ScalarType::BFloat16;
+    case DataType::Float8_e4m3fn:
+      return at::ScalarType::Float8_e4m3fn;
+    case DataType::Float8_e5m2:
+      return at::ScalarType::Float8_e5m2;
     case DataType::Int:
       return at::ScalarType::Long;
     case DataType::Index:
@@ -1091,6 +1182,8 @@ at::ScalarType data_type_to_aten(const DataType& data_type) {
           "There's also this information in FusionExecutorCache and the Registry system.");
     case DataType::Int32:
       return at::ScalarType::Int;
+    case DataType::Int8:
+      return at::ScalarType::Char;
     case DataType::ComplexFloat:
       return at::ScalarType::ComplexFloat;
     case DataType::ComplexDouble:
@@ -1121,8 +1214,11 @@ std::ostream& operator<<(std::ostream& out, const BinaryOpType botype) {
 }
 
 std::ostream& operator<<(std::ostream& out, const ScatterOpType sotype) {
-  if (sotype == ScatterOpType::Set) {
-    return out << "scatter";
+  switch (sotype) {
+    case ScatterOpType::Set:
+      return out << "scatter";
+    case ScatterOpType::Add:
+      return out << "scatter_add";
   }
   NVF_ERROR(false, "No scatterOp type found for scatterOp.");
 }
@@ -1240,6 +1336,9 @@ std::ostream& operator<<(std::ostream& os, const CacheOp& cache_op) {
     case CacheOp::Global:
       os << "Global";
       break;
+    case CacheOp::EvictLast:
+      os << "EvictLast";
+      break;
     default:
       NVF_ERROR(false, "undefined cache operator");
       break;
@@ -1310,10 +1409,13 @@ std::string typePrefix(const DataType data_type) {
     case DataType::Float:
     case DataType::Half:
     case DataType::BFloat16:
+    case DataType::Float8_e4m3fn:
+    case DataType::Float8_e5m2:
       return "f";
     case DataType::Index:
     case DataType::Int:
     case DataType::Int32:
+    case DataType::Int8:
     case DataType::UInt:
     case DataType::UInt32:
     case DataType::SMemAddress:
@@ -1422,6 +1524,8 @@ int max_digits10(DataType dtype) {
   //   ceil(1 + p log10(2))
   // where p is the precision of the type (aka significand):
   //    Type      Precision   max_digits10
+  //   float8_e5m2    3           2
+  //   float8_e4m3    4           3
   //   bfloat16       8           4
   //   float16       11           5
   //   float32       24           9
@@ -1435,6 +1539,10 @@ int max_digits10(DataType dtype) {
     return 5;
   } else if (dtype == DataType::BFloat16) {
     return 4;
+  } else if (dtype == DataType::Float8_e4m3fn) {
+    return 3;
+  } else if (dtype == DataType::Float8_e5m2) {
+    return 2;
   } else {
     NVF_CHECK(
         !isFloatingPointType(dtype),
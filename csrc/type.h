@@ -72,9 +72,12 @@ enum class PrimDataType {
   Float,
   Half,
   BFloat16,
+  Float8_e4m3fn,
+  Float8_e5m2,
   // Integral types
   Int,
   Int32,
+  Int8,
   UInt,
   UInt32,
   Index,
@@ -180,10 +183,13 @@ struct DataType {
   static constexpr PrimDataType Int = PrimDataType::Int;
   static constexpr PrimDataType Index = PrimDataType::Index;
   static constexpr PrimDataType Int32 = PrimDataType::Int32;
+  static constexpr PrimDataType Int8 = PrimDataType::Int8;
   static constexpr PrimDataType UInt = PrimDataType::UInt;
   static constexpr PrimDataType UInt32 = PrimDataType::UInt32;
   static constexpr PrimDataType Bool = PrimDataType::Bool;
   static constexpr PrimDataType BFloat16 = PrimDataType::BFloat16;
+  static constexpr PrimDataType Float8_e4m3fn = PrimDataType::Float8_e4m3fn;
+  static constexpr PrimDataType Float8_e5m2 = PrimDataType::Float8_e5m2;
   static constexpr PrimDataType ComplexFloat = PrimDataType::ComplexFloat;
   static constexpr PrimDataType ComplexDouble = PrimDataType::ComplexDouble;
   static constexpr PrimDataType SMemAddress = PrimDataType::SMemAddress;
@@ -246,10 +252,16 @@ KernelIndexMode indexTypeToMode(DataType index_type);
 // cast from base_type -> type -> base_type should be bit-wise identical
 bool isInclusiveType(const DataType& base_type, const DataType& type);
 
+// Returns if the datatype is an 8-bit floating point type
+inline bool isFp8Type(DataType dtype) {
+  return dtype == DataType::Float8_e4m3fn || dtype == DataType::Float8_e5m2;
+}
+
 // Returns if the datatype is a floating point type
 inline bool isFloatingPointType(DataType dtype) {
   return dtype == DataType::Double || dtype == DataType::Float ||
-      dtype == DataType::Half || dtype == DataType::BFloat16;
+      dtype == DataType::Half || dtype == DataType::BFloat16 ||
+      isFp8Type(dtype);
 }
 
 // Returns if the datatype is an integer type
@@ -262,6 +274,7 @@ inline bool isIntegralType(DataType dtype) {
             case DataType::Index:
             case DataType::Int:
             case DataType::Int32:
+            case DataType::Int8:
             case DataType::UInt:
             case DataType::UInt32:
               return true;
@@ -375,6 +388,14 @@ DEFINE_DATATYPE_TO_ATEN_AND_NATIVE_TYPE(
     DataType::BFloat16,
     at::ScalarType::BFloat16,
     at::BFloat16);
+DEFINE_DATATYPE_TO_ATEN_AND_NATIVE_TYPE(
+    DataType::Float8_e4m3fn,
+    at::ScalarType::Float8_e4m3fn,
+    c10::Float8_e4m3fn);
+DEFINE_DATATYPE_TO_ATEN_AND_NATIVE_TYPE(
+    DataType::Float8_e5m2,
+    at::ScalarType::Float8_e5m2,
+    c10::Float8_e5m2);
 DEFINE_DATATYPE_TO_ATEN_AND_NATIVE_TYPE(
     DataType::Int,
     at::ScalarType::Long,
@@ -383,6 +404,10 @@ DEFINE_DATATYPE_TO_ATEN_AND_NATIVE_TYPE(
     DataType::Int32,
     at::ScalarType::Int,
     int);
+DEFINE_DATATYPE_TO_ATEN_AND_NATIVE_TYPE(
+    DataType::Int8,
+    at::ScalarType::Char,
+    int8_t);
 DEFINE_DATATYPE_TO_NATIVE_TYPE(DataType::UInt, uint64_t);
 DEFINE_DATATYPE_TO_NATIVE_TYPE(DataType::UInt32, uint32_t);
 DEFINE_DATATYPE_TO_ATEN_AND_NATIVE_TYPE(
@@ -635,7 +660,7 @@ enum class BinaryOpType {
   Complex
 };
 
-enum class ScatterOpType { Set };
+enum class ScatterOpType { Set, Add };
 
 enum class RNGOpType {
   Uniform, // Uniform in [0, 1)
@@ -651,7 +676,15 @@ bool isIntegerOp(const BinaryOpType bopt);
 // Return if output of operator should be a boolean
 bool isLogicalOp(const BinaryOpType bopt);
 
-enum class TernaryOpType { Clamp, Lerp, Threshold, Where };
+enum class TernaryOpType {
+  Clamp,
+  // Quotient of a non-negative index by a kernel-invariant divisor, given by
+  // its multiplier and shift, see [ Fast Divmod ]
+  FastDiv,
+  Lerp,
+  Threshold,
+  Where
+};
 
 enum class ParallelType {
   DIDx,
@@ -734,6 +767,10 @@ enum class CacheOp {
   AllLevels,
   Streaming,
   Global,
+  // Caches at all levels with an L2 cache policy that evicts the lines last,
+  // for tensors another kernel reads again. Requires sm_80, and falls back to
+  // AllLevels on older architectures.
+  EvictLast,
 };
 
 //! Used to annotate the special memory intrinsics that a loadstore op will be
@@ -741,13 +778,18 @@ enum class CacheOp {
 //!
 //!  SegmenterSet here is used to hint segmenter to break kernel on the output
 //!  of the node
+//!
+//!  CpAsyncBulk is a non-tensor TMA copy of a contiguous range of a global
+//!  tensor to shared memory, see [ TMA Loads of Persistent Buffers ]
 enum class LoadStoreOpType {
   Set,
   SegmenterSet,
   LdMatrix,
   LdMatrixTranspose,
   CpAsync,
-  CpAsyncBulkTensorTile
+  CpAsyncBulk,
+  CpAsyncBulkTensorTile,
+  WarpTranspose
 };
 
 // Used to label what part of the double buffered iterdomain
@@ -944,6 +986,10 @@ constexpr inline size_t primDataTypeSize(PrimDataType type) {
       return sizeof(at::Half);
     case DataType::BFloat16:
       return sizeof(at::BFloat16);
+    case DataType::Float8_e4m3fn:
+      return sizeof(c10::Float8_e4m3fn);
+    case DataType::Float8_e5m2:
+      return sizeof(c10::Float8_e5m2);
     case DataType::Index:
       NVF_ERROR(
           false, "The actual type of Index is only known at compile time.");
@@ -951,6 +997,8 @@ constexpr inline size_t primDataTypeSize(PrimDataType type) {
       return sizeof(int64_t);
     case DataType::Int32:
       return sizeof(int32_t);
+    case DataType::Int8:
+      return sizeof(int8_t);
     case DataType::UInt:
       return sizeof(uint64_t);
     case DataType::UInt32:
@@ -59,7 +59,8 @@ ResultTypeState updateResultTypeState(
     const ResultTypeState& in_state) {
   ResultTypeState new_state = in_state;
   DataType current = scalar;
-  if (scalar == DataType::Half || scalar == DataType::BFloat16) {
+  if (scalar == DataType::Half || scalar == DataType::BFloat16 ||
+      isFp8Type(scalar)) {
     current = DataType::Float;
   }
   new_state.wrappedResult =
@@ -196,9 +197,10 @@ DataType computeTypes(
   }
 
   auto common_type = computeTypes(config, vt_operands);
-  // Cast FP16 / BFloat16 to Float
+  // Cast FP16 / BFloat16 / FP8 to Float
   if (cast_half_to_float &&
-      (common_type == DataType::Half || common_type == DataType::BFloat16)) {
+      (common_type == DataType::Half || common_type == DataType::BFloat16 ||
+       isFp8Type(common_type))) {
     common_type = DataType::Float;
   }
 
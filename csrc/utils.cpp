@@ -14,6 +14,7 @@
 
 #include <cstdlib>
 #include <iostream>
+#include <limits>
 #include <optional>
 
 namespace nvfuser {
@@ -27,16 +28,13 @@ int getNumThreads() {
   }
   auto num_threads_value = std::atoi(dump_options);
   int max_num_threads = (int)std::thread::hardware_concurrency();
+  // Every core, e.g., to precompile kernels
+  if (num_threads_value == 0) {
+    return std::max(max_num_threads, 1);
+  }
   return std::max(std::min(num_threads_value, max_num_threads), 1);
 }
 
-// TODO: clean this up with some knobs
-c10::ThreadPool* getThreadPool() {
-  static auto num_threads = getNumThreads();
-  static c10::ThreadPool pool(num_threads);
-  return &pool;
-}
-
 C10_DIAGNOSTIC_PUSH_AND_IGNORED_IF_DEFINED("-Wunused-function")
 void debugPrint(const c10::TensorTypePtr& type) {
   std::stringstream sizes_s;
@@ -206,6 +204,53 @@ int64_t getThreadsPerSMGivenRegPerThread(int64_t reg_per_thread) {
   return num_warps * static_cast<int64_t>(warp_size);
 }
 
+std::pair<int64_t, int64_t> getFastDivmodParams(int64_t divisor, int64_t bits) {
+  NVF_ERROR(bits == 32 || bits == 64, "Unexpected number of bits: ", bits);
+  NVF_ERROR(
+      bits == 64 || divisor <= std::numeric_limits<int32_t>::max(),
+      "Divisor out of the range of 32-bit integers: ",
+      divisor);
+  // Extents of empty tensors are zero, but nothing is divided by them
+  if (divisor <= 0) {
+    return {0, 0};
+  }
+  // shift = ceil(log2(divisor)) and
+  // multiplier = floor(2^bits * (2^shift - divisor) / divisor) + 1,
+  // which is less than 2^bits
+  using uint128_t = unsigned __int128;
+  int64_t shift = 0;
+  while (((uint128_t)1 << shift) < (uint128_t)divisor) {
+    shift++;
+  }
+  const uint128_t multiplier = ((uint128_t)1 << bits) *
+          (((uint128_t)1 << shift) - (uint128_t)divisor) / (uint128_t)divisor +
+      1;
+  if (bits == 32) {
+    return {(int64_t)(int32_t)(uint32_t)multiplier, shift};
+  }
+  return {(int64_t)(uint64_t)multiplier, shift};
+}
+
+int64_t fastDiv(
+    int64_t dividend,
+    int64_t multiplier,
+    int64_t shift,
+    int64_t bits) {
+  NVF_ERROR(bits == 32 || bits == 64, "Unexpected number of bits: ", bits);
+  // The sum doesn't overflow, as the high half of the product is at most the
+  // dividend, which is less than 2^(bits - 1)
+  if (bits == 32) {
+    const auto n = (uint32_t)dividend;
+    const auto hi = (uint32_t)(((uint64_t)(uint32_t)multiplier * n) >> 32);
+    return (int64_t)((hi + n) >> shift);
+  }
+  using uint128_t = unsigned __int128;
+  const auto n = (uint64_t)dividend;
+  const auto hi =
+      (uint64_t)(((uint128_t)(uint64_t)multiplier * (uint128_t)n) >> 64);
+  return (int64_t)((hi + n) >> shift);
+}
+
 char* getNvFuserEnv(const char* env_name) {
   // Prepend the default prefix and try if the variable is defined.
   const std::string prefix = "NVFUSER_";
@@ -24,6 +24,7 @@
 #include <type_traits>
 #include <typeinfo>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 //! IR header hierarchy
@@ -35,8 +36,9 @@
 
 namespace nvfuser {
 
+//! Number of threads of the compile thread pool, NVFUSER_NUM_THREADS or 8
+//! by default. See [ Compile Thread Pool ].
 int getNumThreads();
-c10::ThreadPool* getThreadPool();
 
 void debugPrint(const c10::TensorTypePtr& type);
 
@@ -73,6 +75,20 @@ constexpr int64_t roundUpToMultiple(int64_t dividend, int64_t divisor) {
   return ceilDiv(dividend, divisor) * divisor;
 }
 
+//! Multiplier and shift that divide non-negative integers of the given
+//! number of bits, 32 or 64, by divisor with fastDiv. The multiplier is the
+//! bit pattern of an unsigned integer of that width. See [ Fast Divmod ] in
+//! csrc/device_lower/pass/scalar_hoist.h
+std::pair<int64_t, int64_t> getFastDivmodParams(int64_t divisor, int64_t bits);
+
+//! Quotient of a non-negative dividend by the divisor of the multiplier and
+//! shift of getFastDivmodParams. Same as fastDiv in runtime/helpers.cu.
+int64_t fastDiv(
+    int64_t dividend,
+    int64_t multiplier,
+    int64_t shift,
+    int64_t bits);
+
 //! Simple mixin for suppressing copy & move operations, ex:
 //!
 //!  class Foo : public NonCopyable {
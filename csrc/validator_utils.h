@@ -172,6 +172,7 @@ std::pair<double, double> getTolerance(
     }
     case DataType::Int:
     case DataType::Int32:
+    case DataType::Int8:
     case DataType::Index:
     case DataType::Bool:
       return {0.0, 0.0};
@@ -2,10 +2,14 @@
 # All rights reserved.
 # SPDX-License-Identifier: BSD-3-Clause
 
+import contextlib
+import json
 import logging
 import os
 import re
 import sys
+import threading
+import weakref
 from typing import Optional, Union, List  # noqa: F401
 
 import torch
@@ -47,6 +51,347 @@ def disable_automatic_serialization():
     atexit.unregister(_C.serialize)
 
 
+# Formats the traced scopes aggregated since enable_compile_profile() as a
+# table, by decreasing total time. Only the first `limit` scopes are listed
+# when `limit` is given.
+def compile_profile_table(limit: Optional[int] = None) -> str:
+    entries = _C.compile_profile()
+    if limit is not None:
+        entries = entries[:limit]
+    name_width = max([len("Scope")] + [len(e[0]) for e in entries])
+    lines = [
+        f"{'Scope':<{name_width}}  {'Count':>7}  {'Total (ms)':>12}  "
+        f"{'Self (ms)':>12}"
+    ]
+    for name, count, total_ms, self_ms in entries:
+        lines.append(
+            f"{name:<{name_width}}  {count:>7}  {total_ms:>12.3f}  "
+            f"{self_ms:>12.3f}"
+        )
+    return "\n".join(lines)
+
+
+# Input signatures of the executed fusions by the python definition of the
+# fusion, while record_shape_trace() is active.
+_shape_trace = None
+_shape_trace_lock = threading.Lock()
+
+
+def _input_signature(inp):
+    # Arrays of other libraries are recorded as the tensors they are run as.
+    # DLPack capsules can only be consumed once, so they are not recorded.
+    if not isinstance(inp, torch.Tensor):
+        if hasattr(inp, "__cuda_array_interface__"):
+            inp = torch.as_tensor(inp, device="cuda")
+        elif hasattr(inp, "__dlpack__"):
+            inp = torch.from_dlpack(inp)
+    if isinstance(inp, torch.Tensor):
+        return {
+            "shape": list(inp.size()),
+            "stride": list(inp.stride()),
+            "dtype": str(inp.dtype).replace("torch.", ""),
+            "device": str(inp.device),
+        }
+    if isinstance(inp, complex):
+        return {"complex": [inp.real, inp.imag]}
+    return {"scalar": inp}
+
+
+def _input_from_signature(signature):
+    if "complex" in signature:
+        return complex(*signature["complex"])
+    if "scalar" in signature:
+        return signature["scalar"]
+    dtype = getattr(torch, signature["dtype"])
+    shape = signature["shape"]
+    stride = signature["stride"]
+    # max linear index determines number of elements to generate
+    numel = 1
+    for size, stride_i in zip(shape, stride):
+        if size == 0:
+            numel = 0
+            break
+        numel += (size - 1) * stride_i
+    device = signature["device"]
+    if dtype.is_floating_point or dtype.is_complex:
+        storage = torch.randn((numel,), dtype=dtype, device=device)
+    else:
+        upper_bound = 2 if dtype == torch.bool else 10
+        storage = torch.randint(
+            0, upper_bound, (numel,), dtype=dtype, device=device
+        )
+    return storage.as_strided(shape, stride)
+
+
+@contextlib.contextmanager
+def record_shape_trace(trace_file: str):
+    """
+    Records the input signatures of the executed fusions into a trace file
+
+    Run a representative workload, e.g., a canary, inside the context.
+    For every FusionDefinition executed, its python definition and the
+    shapes, strides, dtypes and devices of its tensor inputs and the values
+    of its scalar inputs are recorded, and the trace is written to
+    trace_file on exit. Executions through handles, execute_many or
+    lazy_execution are not recorded. See precompile().
+
+    Example:
+        with nvfuser.record_shape_trace("trace.json"):
+            run_canary()
+    """
+    global _shape_trace
+    with _shape_trace_lock:
+        assert _shape_trace is None, "A shape trace is already being recorded"
+        _shape_trace = {}
+    try:
+        yield
+    finally:
+        with _shape_trace_lock:
+            trace, _shape_trace = _shape_trace, None
+        fusions = [
+            {"definition": definition, "inputs": [json.loads(s) for s in sigs]}
+            for definition, sigs in trace.items()
+        ]
+        with open(trace_file, "w") as f:
+            json.dump({"version": 1, "fusions": fusions}, f, indent=1)
+
+
+def _record_execution(fd, inputs):
+    definition = str(fd)
+    try:
+        signature = json.dumps(
+            [_input_signature(i) for i in inputs], sort_keys=True
+        )
+    except TypeError:
+        logger.warning(f"Skipped recording the inputs of fusion {fd.id()}")
+        return
+    with _shape_trace_lock:
+        if _shape_trace is not None:
+            sigs = _shape_trace.setdefault(definition, [])
+            if signature not in sigs:
+                sigs.append(signature)
+
+
+def precompile(
+    trace_file: str, *, max_workers: Optional[int] = None, serialize: bool = True
+) -> int:
+    """
+    Compiles the kernels of the fusions of a trace from record_shape_trace()
+
+    The fusions are defined again from their recorded python definitions
+    and executed with random inputs of every recorded signature from a pool
+    of max_workers threads, so that their kernels are compiled in parallel.
+    Unless serialize is False, the FusionCache is then written to the
+    default workspace, which processes load at startup with automatic
+    serialization enabled.
+
+    Returns:
+        int: the number of compiled input signatures
+    """
+    from concurrent.futures import ThreadPoolExecutor
+
+    with open(trace_file) as f:
+        trace = json.load(f)
+    assert trace.get("version") == 1, f"Unsupported shape trace {trace_file}"
+
+    # Definitions walk the FusionCache, so they are done on this thread
+    jobs = []
+    for entry in trace["fusions"]:
+        definition = entry["definition"]
+        func_name = re.findall(r"def (nvfuser_\w+)", definition)[0]
+        namespace = dict(globals())
+        exec(definition, namespace)
+        with FusionDefinition() as fd:
+            namespace[func_name](fd)
+        for signature in entry["inputs"]:
+            jobs.append((fd, signature))
+
+    def compile_job(job):
+        fd, signature = job
+        fd.execute([_input_from_signature(s) for s in signature])
+
+    with ThreadPoolExecutor(max_workers=max_workers) as pool:
+        list(pool.map(compile_job, jobs))
+
+    if serialize:
+        _C.serialize()
+    return len(jobs)
+
+
+# The queue of lazily executed calls of the current thread, while
+# lazy_execution() is active. See [ Lazy Execution ] in
+# csrc/python_frontend/fusion_definition.h.
+_lazy_state = threading.local()
+# Stitching keys of the sequences that can't be stitched, which are run call
+# by call instead
+_unstitchable = set()
+
+
+class LazyTensor:
+    """
+    An output of a FusionDefinition executed in lazy_execution()
+
+    Passing it to another execution in lazy_execution() queues that call
+    after the one producing it. materialize() runs the queued calls stitched
+    into a single fusion and returns the tensor.
+    """
+
+    __slots__ = ("_queue", "_call", "_index", "_value", "__weakref__")
+
+    def __init__(self, queue, call, index):
+        self._queue = queue
+        self._call = call
+        self._index = index
+        self._value = None
+
+    def materialize(self):
+        if self._value is None:
+            self._queue.flush()
+        return self._value
+
+    def __repr__(self):
+        state = "materialized" if self._value is not None else "pending"
+        return f"LazyTensor(call={self._call}, index={self._index}, {state})"
+
+
+class _LazyQueue:
+    def __init__(self):
+        self.device = None
+        # (fd, args, weak references to the LazyTensors of the outputs),
+        # where an argument that is a pending output of this queue is a
+        # (call, index) pair, so that queued calls don't keep it alive
+        self.calls = []
+
+    def add(self, fd, inputs, device):
+        if self.calls and device != self.device:
+            self.flush()
+        self.device = device
+        args = []
+        for inp in inputs:
+            if isinstance(inp, list):
+                args.append([self._argument(i) for i in inp])
+            else:
+                args.append(self._argument(inp))
+        call = len(self.calls)
+        outputs = [LazyTensor(self, call, i) for i in range(fd._num_outputs())]
+        self.calls.append((fd, args, [weakref.ref(o) for o in outputs]))
+        return outputs
+
+    def _argument(self, inp):
+        if not isinstance(inp, LazyTensor):
+            return inp
+        if inp._value is None and inp._queue is self:
+            return (inp._call, inp._index)
+        return inp.materialize()
+
+    def flush(self):
+        calls, self.calls = self.calls, []
+        live = [
+            (call, index)
+            for call, (_, _, refs) in enumerate(calls)
+            for index, ref in enumerate(refs)
+            if ref() is not None
+        ]
+        if not live:
+            return
+
+        # Tensors and scalars passed to several calls are a single input
+        inputs = []
+        input_index = {}
+        args = []
+        for _, call_args, _ in calls:
+            stitched_args = []
+            for arg in call_args:
+                for item in arg if isinstance(arg, list) else [arg]:
+                    if isinstance(item, tuple):
+                        stitched_args.append(item)
+                        continue
+                    if id(item) not in input_index:
+                        input_index[id(item)] = len(inputs)
+                        inputs.append(item)
+                    stitched_args.append((-1, input_index[id(item)]))
+            args.append(stitched_args)
+        fusion_ids = [fd.id() for fd, _, _ in calls]
+
+        key = (
+            tuple(fusion_ids),
+            tuple(tuple(a) for a in args),
+            tuple(live),
+        )
+        if len(calls) > 1 and key not in _unstitchable:
+            try:
+                values = _C._execute_stitched(
+                    fusion_ids, args, live, inputs, device=self.device
+                )
+            except RuntimeError as err:
+                logger.warning(f"Executing the calls one by one: {err}")
+                _unstitchable.add(key)
+            else:
+                for (call, index), value in zip(live, values):
+                    self._set_value(calls, call, index, value)
+                return
+
+        # The calls run immediately, also inside lazy_execution()
+        queue, _lazy_state.queue = getattr(_lazy_state, "queue", None), None
+        results = []
+        try:
+            for fd, call_args, _ in calls:
+                resolved = [
+                    [self._resolve(results, i) for i in a]
+                    if isinstance(a, list)
+                    else self._resolve(results, a)
+                    for a in call_args
+                ]
+                results.append(fd.execute(resolved, device=self.device))
+        finally:
+            _lazy_state.queue = queue
+        for call, index in live:
+            self._set_value(calls, call, index, results[call][index])
+
+    @staticmethod
+    def _resolve(results, arg):
+        return results[arg[0]][arg[1]] if isinstance(arg, tuple) else arg
+
+    @staticmethod
+    def _set_value(calls, call, index, value):
+        lazy_tensor = calls[call][2][index]()
+        if lazy_tensor is not None:
+            lazy_tensor._value = value
+
+
+@contextlib.contextmanager
+def lazy_execution():
+    """
+    Defers the execution of FusionDefinitions to fuse consecutive calls
+
+    Inside the context, FusionDefinition.execute queues the call and returns
+    LazyTensors, which can be passed to later executions. When a LazyTensor
+    is materialized, or the context is left, the queued calls are stitched
+    into one fusion, which is compiled and cached as a unit, so that the
+    tensors passed between them don't have to go through global memory. Only
+    the outputs whose LazyTensors are still referenced are computed. Calls
+    with user schedules or capture_debug_output run immediately. If the
+    calls can't be stitched, e.g., because an output is passed to an input
+    with other broadcast dimensions, they are run one by one.
+
+    Example:
+        with nvfuser.lazy_execution():
+            (t1,) = fd1.execute([t0])
+            (t2,) = fd2.execute([t1, t0])
+            out = t2.materialize()
+    """
+    outer = getattr(_lazy_state, "queue", None)
+    if outer is not None:
+        yield
+        return
+    _lazy_state.queue = _LazyQueue()
+    try:
+        yield
+    finally:
+        queue, _lazy_state.queue = _lazy_state.queue, None
+        queue.flush()
+
+
 class FusionDefinition(_C._FusionDefinition):
     def __enter__(self):
         return self._setup_definition()
@@ -107,7 +452,7 @@ class FusionDefinition(_C._FusionDefinition):
                 then that method will return None when called.
 
         Returns:
-            List[Tensor]
+            List[Tensor], or List[LazyTensor] in lazy_execution()
         """
         func_based_def = False
 
@@ -127,7 +472,23 @@ class FusionDefinition(_C._FusionDefinition):
             func_based_def = True
 
         # If schedule is defined by child class, make a schedule for inputs
-        if func_based_def and (super(type(self), self).schedule != self.schedule):
+        user_schedule = func_based_def and (
+            super(type(self), self).schedule != self.schedule
+        )
+
+        lazy_queue = getattr(_lazy_state, "queue", None)
+        if (
+            lazy_queue is not None
+            and not user_schedule
+            and not override_user_schedule
+            and not capture_debug_output
+        ):
+            return lazy_queue.add(self, inputs, device)
+        inputs = [
+            i.materialize() if isinstance(i, LazyTensor) else i for i in inputs
+        ]
+
+        if user_schedule:
             self._setup_schedule(inputs)
             self.schedule()
             self._finalize_schedule(inputs)
@@ -196,8 +557,37 @@ class FusionDefinition(_C._FusionDefinition):
             logger.exception(msg)
             raise
 
+        if _shape_trace is not None:
+            _record_execution(self, inputs)
         return result
 
+    def get_handle(self):
+        """
+        Returns a callable that executes the fusion without its definition
+
+        A FusionDefinition of a child class runs definition() again on every
+        call to execute() only to find its fusion in the cache. The handle is
+        bound to the fusion instead, so calling it with the same inputs as
+        execute() goes straight to the cached kernels. Only automatically
+        generated schedules are used, and resetting the FusionCache
+        invalidates the handle.
+
+        Example:
+            handle = fd.get_handle()
+            for inputs in batches:
+                outputs = handle(inputs)
+
+        Returns:
+            FusionHandle: called as handle(inputs, *, device=None), where
+            device is a CUDA device index
+        """
+        # if definition is not defined by a context manager, try a child class
+        if self.id() is None:
+            self._setup_definition()
+            self.definition()
+            self._finalize_definition()
+        return self._get_handle()
+
     def debug_output(self):
         """
         Retrieve string of captured debug information from the previous execution.
@@ -266,6 +656,24 @@ class FusionDefinition(_C._FusionDefinition):
         override_user_schedule = kwargs.pop("override_user_schedule", False)
         return self._last_cuda_code(intrinsic_code, override_user_schedule)
 
+    def last_kernel_resources(self, **kwargs):
+        """
+        Returns the resources of the kernels of the last executed set of inputs,
+        one dict per segment with the registers, local memory, spills, shared
+        memory, launch configuration, occupancy and waves of the kernel.
+        Spills are -1 unless ptxas is verbose, e.g., with
+        NVFUSER_DUMP=ptxas_verbose or NVFUSER_ENABLE=warn_register_spill.
+        The achieved occupancy is None unless it is measured by the profiler.
+
+        Kwargs:
+            override_user_schedule (Bool): For a user defined schedule, override with auto-generated schedule (default: False)
+
+        Returns:
+            List[Dict]
+        """
+        override_user_schedule = kwargs.pop("override_user_schedule", False)
+        return self._last_kernel_resources(override_user_schedule)
+
     def cuda_code_for(self, inputs, intrinsic_code=False, **kwargs):
         """
         Returns the Cuda Code for the given inputs
@@ -7,6 +7,7 @@ from copy import deepcopy
 from functools import partial
 import itertools
 import math
+import os
 import random
 import re
 from typing import List, Callable
@@ -3151,6 +3152,241 @@ class TestNvFuserFrontend(TestCase):
         nvf_out, _ = self.exec_nvfuser(fusion_func, inputs)
         # self.assertEqual(nvf_out[0], t24)
 
+    def test_autotune_export(self):
+        from nvfuser import enable_autotune, disable_autotune, export_tuning_db
+
+        inputs = [torch.randn(64, 1024, device="cuda")]
+
+        # A definition no other test uses, so that it's scheduled here
+        def fusion_func(fd: FusionDefinition) -> None:
+            t0 = fd.from_pytorch(inputs[0])
+            s0 = fd.define_scalar(0.125, dtype=DataType.Double)
+            t1 = fd.ops.mul(t0, s0)
+            t2 = fd.ops.sum(t1, [1])
+            fd.add_output(t2)
+
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            enable_autotune(os.path.join(tmp_dir, "tuning_db.txt"))
+            try:
+                with FusionDefinition() as fd:
+                    fusion_func(fd)
+                nvf_out = fd.execute(inputs)
+
+                export_path = os.path.join(tmp_dir, "export.txt")
+                num_entries = export_tuning_db(export_path)
+                with open(export_path) as f:
+                    self.assertEqual(len(f.readlines()), num_entries)
+            finally:
+                disable_autotune()
+
+        self.assertGreaterEqual(num_entries, 1)
+        self.assertEqual(nvf_out[0], (inputs[0] * 0.125).sum(1))
+
+    def test_fusion_handle(self):
+        inputs = [
+            torch.randn(4, 8, device="cuda"),
+            torch.randn(8, device="cuda"),
+        ]
+
+        class Definition(FusionDefinition):
+            def definition(self):
+                t0 = self.define_tensor(shape=[-1, -1], contiguity=[True, True])
+                t1 = self.define_tensor(shape=[-1], contiguity=[True])
+                t2 = self.ops.broadcast_in_dim(t1, [4, 8], [1])
+                t3 = self.ops.relu(self.ops.add(t0, t2))
+                self.add_output(t3)
+
+        fd = Definition()
+        handle = fd.get_handle()
+        self.assertEqual(handle.id(), fd.id())
+
+        nvf_out = handle(inputs)
+        self.assertEqual(nvf_out[0], torch.relu(inputs[0] + inputs[1]))
+        self.assertEqual(fd.execute(inputs)[0], nvf_out[0])
+
+        FusionCache.reset()
+        with self.assertRaisesRegex(RuntimeError, "has been reset"):
+            handle(inputs)
+
+    def test_execute_many(self):
+        from nvfuser import execute_many
+
+        inputs = [torch.randn(4, 8, device="cuda"), torch.randn(8, device="cuda")]
+
+        with FusionDefinition() as fd_add:
+            t0 = fd_add.from_pytorch(inputs[0])
+            t1 = fd_add.from_pytorch(inputs[1])
+            t2 = fd_add.ops.broadcast_in_dim(t1, [4, 8], [1])
+            fd_add.add_output(fd_add.ops.add(t0, t2))
+
+        with FusionDefinition() as fd_sum:
+            t0 = fd_sum.from_pytorch(inputs[0])
+            fd_sum.add_output(fd_sum.ops.sum(t0, [0]))
+
+        nvf_outs = execute_many(
+            [
+                (fd_add, inputs),
+                (fd_sum.get_handle(), inputs[:1]),
+                (fd_add, [inputs[0], inputs[0][0]]),
+            ]
+        )
+        self.assertEqual(len(nvf_outs), 3)
+        self.assertEqual(nvf_outs[0][0], inputs[0] + inputs[1])
+        self.assertEqual(nvf_outs[1][0], inputs[0].sum(0))
+        self.assertEqual(nvf_outs[2][0], inputs[0] + inputs[0][0])
+
+    def test_zero_copy_inputs(self):
+        inputs = [torch.randn(4, 8, device="cuda"), torch.randn(8, device="cuda")]
+
+        def fusion_func(fd: FusionDefinition) -> None:
+            t0 = fd.from_pytorch(inputs[0])
+            t1 = fd.from_pytorch(inputs[1])
+            t2 = fd.ops.broadcast_in_dim(t1, [4, 8], [1])
+            fd.add_output(fd.ops.add(t0, t2))
+
+        # Only expose the protocols, as arrays of other libraries would
+        class DLPackArray:
+            def __init__(self, tensor):
+                self.tensor = tensor
+
+            def __dlpack__(self, stream=None):
+                return self.tensor.__dlpack__(stream=stream)
+
+            def __dlpack_device__(self):
+                return self.tensor.__dlpack_device__()
+
+        class CudaArray:
+            def __init__(self, tensor):
+                self.__cuda_array_interface__ = tensor.__cuda_array_interface__
+                self.tensor = tensor
+
+        with FusionDefinition() as fd:
+            fusion_func(fd)
+        expected = inputs[0] + inputs[1]
+        for wrap in (
+            DLPackArray,
+            CudaArray,
+            lambda t: torch.utils.dlpack.to_dlpack(t),
+        ):
+            nvf_out = fd.execute([wrap(inputs[0]), wrap(inputs[1])])
+            self.assertEqual(nvf_out[0], expected)
+
+    def test_precompile_shape_trace(self):
+        from nvfuser import precompile, record_shape_trace
+
+        def fusion_func(fd: FusionDefinition) -> None:
+            t0 = fd.define_tensor(shape=[-1, -1], contiguity=[True, True])
+            s0 = fd.define_scalar(None, dtype=DataType.Double)
+            fd.add_output(fd.ops.mul(t0, s0))
+
+        with FusionDefinition() as fd:
+            fusion_func(fd)
+
+        with tempfile.NamedTemporaryFile(suffix=".json") as tmp:
+            with record_shape_trace(tmp.name):
+                for shape in [(4, 8), (16, 32), (4, 8)]:
+                    fd.execute([torch.randn(shape, device="cuda"), 2.0])
+
+            FusionCache.reset()
+            self.assertEqual(precompile(tmp.name, serialize=False), 2)
+
+        fc = FusionCache.get()
+        self.assertEqual(fc.num_fusions(), 1)
+        with FusionDefinition() as fd:
+            fusion_func(fd)
+        inputs = [torch.randn(16, 32, device="cuda"), 3.0]
+        self.assertEqual(fd.execute(inputs)[0], inputs[0] * 3.0)
+        self.assertEqual(fc.num_fusions(), 1)
+
+    def test_fusion_cache_eviction(self):
+        inputs = [torch.randn(4, 8, device="cuda")]
+
+        def fusion_func(fd: FusionDefinition, n: int) -> None:
+            t0 = fd.from_pytorch(inputs[0])
+            s0 = fd.define_scalar(float(n), dtype=DataType.Double)
+            fd.add_output(fd.ops.mul(t0, s0))
+
+        FusionCache.reset()
+        fc = FusionCache.get()
+        fc.set_eviction_limits(max_live_fusions=1)
+        try:
+            fds = []
+            for n in range(2):
+                with FusionDefinition() as fd:
+                    fusion_func(fd, n + 1)
+                fds.append(fd)
+
+            for _ in range(2):
+                for n, fd in enumerate(fds):
+                    nvf_out = fd.execute(inputs)
+                    self.assertEqual(nvf_out[0], inputs[0] * (n + 1))
+
+            # Every execution evicts the other fusion, which is rebuilt and
+            # compiled again when it runs
+            self.assertIn(
+                "Live Fusions: 1 Evicted Fusions: 1 Evictions: 4", fc.stats()
+            )
+        finally:
+            FusionCache.reset()
+
+    def test_lazy_execution(self):
+        from nvfuser import LazyTensor, lazy_execution
+
+        inputs = [torch.randn(4, 8, device="cuda"), torch.randn(8, device="cuda")]
+
+        with FusionDefinition() as fd_add:
+            t0 = fd_add.from_pytorch(inputs[0])
+            t1 = fd_add.from_pytorch(inputs[1])
+            t2 = fd_add.ops.broadcast_in_dim(t1, [4, 8], [1])
+            fd_add.add_output(fd_add.ops.add(t0, t2))
+
+        with FusionDefinition() as fd_sum:
+            t0 = fd_sum.from_pytorch(inputs[0])
+            fd_sum.add_output(fd_sum.ops.sum(t0, [0]))
+
+        for _ in range(2):
+            with lazy_execution():
+                (added,) = fd_add.execute(inputs)
+                (summed,) = fd_sum.execute([added])
+                self.assertIsInstance(summed, LazyTensor)
+                # Only the sum is an output of the stitched fusion
+                del added
+                nvf_out = summed.materialize()
+            self.assertEqual(nvf_out, (inputs[0] + inputs[1]).sum(0))
+
+        with lazy_execution():
+            (added,) = fd_add.execute(inputs)
+            (twice,) = fd_add.execute([added, inputs[1]])
+        self.assertEqual(added.materialize(), inputs[0] + inputs[1])
+        self.assertEqual(twice.materialize(), inputs[0] + 2 * inputs[1])
+
+    def test_concurrent_execution(self):
+        from concurrent.futures import ThreadPoolExecutor
+
+        def fusion_func(fd: FusionDefinition, n: int) -> None:
+            t0 = fd.define_tensor(shape=[-1, -1], contiguity=[True, True])
+            s0 = fd.define_scalar(float(n), dtype=DataType.Double)
+            t1 = fd.ops.mul(t0, s0)
+            fd.add_output(fd.ops.sum(t1, [1]))
+
+        fds = []
+        for n in range(2):
+            with FusionDefinition() as fd:
+                fusion_func(fd, n)
+            fds.append(fd)
+
+        # Each thread runs both fusions with its own shapes, so executions of
+        # the same FusionExecutorCache overlap with lookups of new runtimes
+        def run(i: int):
+            inputs = [torch.randn(16, 32 + i, device="cuda")]
+            for n, fd in enumerate(fds):
+                for _ in range(4):
+                    nvf_out = fd.execute(inputs)
+                    self.assertEqual(nvf_out[0], (inputs[0] * n).sum(1))
+
+        with ThreadPoolExecutor(max_workers=4) as pool:
+            list(pool.map(run, range(8)))
+
 
 if __name__ == "__main__":
     run_tests()
@@ -175,8 +175,44 @@ enum class CacheOp {
   AllLevels,
   Streaming,
   Global,
+  EvictLast,
 };
 
+// Loads with an L2 cache policy that evicts the lines last, so that they are
+// likely still cached when a later kernel reads them again
+
+__device__ __inline__ uint2 loadGlobalEvictLast(const uint2* from) {
+#if __CUDA_ARCH__ >= 800
+  uint2 data;
+  asm("{\n"
+      "  .reg .b64 policy;\n"
+      "  createpolicy.fractional.L2::evict_last.b64 policy, 1.0;\n"
+      "  ld.global.L2::cache_hint.v2.s32 {%0,%1}, [%2], policy;\n"
+      "}\n"
+      : "=r"(data.x), "=r"(data.y)
+      : "l"(from));
+  return data;
+#else
+  return __ldca(from);
+#endif
+}
+
+__device__ __inline__ uint4 loadGlobalEvictLast(const uint4* from) {
+#if __CUDA_ARCH__ >= 800
+  uint4 data;
+  asm("{\n"
+      "  .reg .b64 policy;\n"
+      "  createpolicy.fractional.L2::evict_last.b64 policy, 1.0;\n"
+      "  ld.global.L2::cache_hint.v4.s32 {%0,%1,%2,%3}, [%4], policy;\n"
+      "}\n"
+      : "=r"(data.x), "=r"(data.y), "=r"(data.z), "=r"(data.w)
+      : "l"(from));
+  return data;
+#else
+  return __ldca(from);
+#endif
+}
+
 template <typename T, CacheOp cache_op>
 __device__ void loadGlobalToLocalCached(void* to, void* from) {
   T* typed_to = reinterpret_cast<T*>(to);
@@ -191,6 +227,9 @@ __device__ void loadGlobalToLocalCached(void* to, void* from) {
     case CacheOp::Global:
       *typed_to = __ldcg(typed_from);
       break;
+    case CacheOp::EvictLast:
+      *typed_to = loadGlobalEvictLast(typed_from);
+      break;
   }
 }
 
@@ -234,6 +273,52 @@ __device__ void loadGlobalToLocal(
   }
 }
 
+// Non-volatile stores with the cache operator of EnableOption::StreamingStores.
+// Streaming stores are st.global.cs, which evicts the written lines first, so
+// that outputs written once don't push tensors another kernel reads again out
+// of L2. Other cache operators store with the default write-back policy.
+// Stores smaller than a word are issued from a wider register, as PTX allows.
+template <typename scalar_t, int vec_size, CacheOp cache_op>
+__device__ void storeLocalToGlobal(scalar_t* to, scalar_t* from) {
+  if (cache_op != CacheOp::Streaming) {
+    loadGeneric<scalar_t, vec_size>(to, from);
+    return;
+  }
+  switch (sizeof(scalar_t) * vec_size) {
+    case 1:
+      asm volatile("st.global.cs.b8 [%0], %1;" ::"l"(to),
+                   "h"((unsigned short)*reinterpret_cast<uint8_t*>(from)));
+      break;
+    case 2:
+      asm volatile("st.global.cs.b16 [%0], %1;" ::"l"(to),
+                   "h"(*reinterpret_cast<unsigned short*>(from)));
+      break;
+    case 4:
+      asm volatile("st.global.cs.b32 [%0], %1;" ::"l"(to),
+                   "r"(*reinterpret_cast<unsigned int*>(from)));
+      break;
+    case 8: {
+      uint2 const& data = *reinterpret_cast<uint2*>(from);
+      asm volatile("st.global.cs.v2.s32 [%0], {%1,%2};" ::"l"(to),
+                   "r"(data.x),
+                   "r"(data.y));
+      break;
+    }
+    case 16: {
+      uint4 const& data = *reinterpret_cast<uint4*>(from);
+      asm volatile("st.global.cs.v4.s32 [%0], {%1,%2,%3,%4};" ::"l"(to),
+                   "r"(data.x),
+                   "r"(data.y),
+                   "r"(data.z),
+                   "r"(data.w));
+      break;
+    }
+    default:
+      loadGeneric<scalar_t, vec_size>(to, from);
+      break;
+  }
+}
+
 template <
     typename scalar_t,
     int vec_size,
@@ -229,3 +229,119 @@ __device__ __inline__ __bfloat __real_then_2bfloat(
     const std::complex<double> c) {
   return __double2bfloat(std::real(c));
 }
+
+// Arithmetic of EnableOption::HalfArithmetic, see
+// [ Half-Precision Arithmetic ] in optimization/half_arithmetic.h. Additions
+// and multiplications are computed as bf16 fused multiply-adds with a
+// constant of 1, -1 or -0, since Ampere has no bf16 additions and
+// multiplications. Before Ampere, they are computed in float, which gives the
+// same result as float has more than twice the precision of bfloat16.
+
+#if __CUDA_ARCH__ >= 800
+// Computes x * y + z, where y or z is the constant k given by its bits
+#define __NVFUSER_BFLOAT_FMA_ASM(x, y, z, bits)  \
+  asm("{\n"                                      \
+      "  .reg .b16 k;\n"                         \
+      "  mov.b16 k, " bits ";\n"                 \
+      "  fma.rn.bf16 %0, " x ", " y ", " z ";\n" \
+      "}\n"                                      \
+      : "=h"(__NVFUSER_BFLOAT_TO_US(val))        \
+      : "h"(__NVFUSER_BFLOAT_TO_CUS(lhs)),       \
+        "h"(__NVFUSER_BFLOAT_TO_CUS(rhs)))
+#endif
+
+__device__ __inline__ __bfloat operator+(
+    const __bfloat lhs,
+    const __bfloat rhs) {
+#if __CUDA_ARCH__ >= 800
+  __bfloat val;
+  __NVFUSER_BFLOAT_FMA_ASM("%1", "k", "%2", "0x3F80");
+  return val;
+#else
+  return __float2bfloat(__bfloat2float(lhs) + __bfloat2float(rhs));
+#endif
+}
+
+__device__ __inline__ __bfloat operator-(
+    const __bfloat lhs,
+    const __bfloat rhs) {
+#if __CUDA_ARCH__ >= 800
+  __bfloat val;
+  __NVFUSER_BFLOAT_FMA_ASM("%2", "k", "%1", "0xBF80");
+  return val;
+#else
+  return __float2bfloat(__bfloat2float(lhs) - __bfloat2float(rhs));
+#endif
+}
+
+__device__ __inline__ __bfloat operator*(
+    const __bfloat lhs,
+    const __bfloat rhs) {
+#if __CUDA_ARCH__ >= 800
+  __bfloat val;
+  __NVFUSER_BFLOAT_FMA_ASM("%1", "%2", "k", "0x8000");
+  return val;
+#else
+  return __float2bfloat(__bfloat2float(lhs) * __bfloat2float(rhs));
+#endif
+}
+
+#undef __NVFUSER_BFLOAT_FMA_ASM
+
+// Packed arithmetic on the pairs of elements out[0:2], a[0:2] and b[0:2]
+
+#if __CUDA_ARCH__ >= 800
+#define __NVFUSER_BFLOAT2_FMA_ASM(x, y, z, bits)    \
+  asm("{\n"                                         \
+      "  .reg .b32 lhs, rhs, out, k;\n"             \
+      "  mov.b32 lhs, {%2, %3};\n"                  \
+      "  mov.b32 rhs, {%4, %5};\n"                  \
+      "  mov.b32 k, " bits ";\n"                    \
+      "  fma.rn.bf16x2 out, " x ", " y ", " z ";\n" \
+      "  mov.b32 {%0, %1}, out;\n"                  \
+      "}\n"                                         \
+      : "=h"(__NVFUSER_BFLOAT_TO_US(out[0])),       \
+        "=h"(__NVFUSER_BFLOAT_TO_US(out[1]))        \
+      : "h"(__NVFUSER_BFLOAT_TO_CUS(a[0])),         \
+        "h"(__NVFUSER_BFLOAT_TO_CUS(a[1])),         \
+        "h"(__NVFUSER_BFLOAT_TO_CUS(b[0])),         \
+        "h"(__NVFUSER_BFLOAT_TO_CUS(b[1])))
+#endif
+
+__device__ __inline__ void __hadd2(
+    __bfloat* out,
+    const __bfloat* a,
+    const __bfloat* b) {
+#if __CUDA_ARCH__ >= 800
+  __NVFUSER_BFLOAT2_FMA_ASM("lhs", "k", "rhs", "0x3F803F80");
+#else
+  out[0] = a[0] + b[0];
+  out[1] = a[1] + b[1];
+#endif
+}
+
+__device__ __inline__ void __hsub2(
+    __bfloat* out,
+    const __bfloat* a,
+    const __bfloat* b) {
+#if __CUDA_ARCH__ >= 800
+  __NVFUSER_BFLOAT2_FMA_ASM("rhs", "k", "lhs", "0xBF80BF80");
+#else
+  out[0] = a[0] - b[0];
+  out[1] = a[1] - b[1];
+#endif
+}
+
+__device__ __inline__ void __hmul2(
+    __bfloat* out,
+    const __bfloat* a,
+    const __bfloat* b) {
+#if __CUDA_ARCH__ >= 800
+  __NVFUSER_BFLOAT2_FMA_ASM("lhs", "rhs", "k", "0x80008000");
+#else
+  out[0] = a[0] * b[0];
+  out[1] = a[1] * b[1];
+#endif
+}
+
+#undef __NVFUSER_BFLOAT2_FMA_ASM
@@ -0,0 +1,151 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+namespace fused_reduction {
+namespace impl {
+
+// Grouped block reduction optimized for outer reductions with TIDx
+// and TIDy mapped to non-reduction and reduction domains,
+// respectively, with unused TIDz. This is the same algorithm as
+// blockWelfordOuter, see block_welford_outer.cu, applied to a
+// single value per group with an arbitrary reduction_op. The same
+// assumptions apply:
+//
+// - blockDim.x and blockDim.y are statically known values so that all
+// loops can be completely unrolled
+// - blockDim.x is smaller than WARP_SIZE
+// - blockDim.x evenly divides WARP_SIZE
+// - There are multiple warps per block
+// - The gouping factor, NumVals, is at least as large as the warp
+// dimY and is divisible by the warp dimY.
+//
+// The values of inp are overwritten. Only the threads of the first
+// NumVals warps with threadIdx.y % (32 / BDIMX) == 0 return valid
+// results, and warp wid holds the result of the wid-th value of the
+// group.
+template <
+    bool Aligned,
+    int NumVals,
+    typename DataType,
+    int BDIMX,
+    int BDIMY,
+    typename Func>
+__inline__ __device__ DataType blockReduceOuter(
+    DataType* inp,
+    DataType* smem,
+    Func reduction_op,
+    DataType init_val) {
+  constexpr int num_warps = BDIMX * BDIMY / 32;
+  static_assert(num_warps >= 1, "There must be at least a single warp");
+  static_assert(32 % BDIMX == 0, "blockDimx.x must be able to divide 32");
+
+  const int tid = threadIdx.x + threadIdx.y * BDIMX;
+  const int wid = tid / 32;
+
+  // Dimension of the Y axis within each warp
+  constexpr int wdimy = 32 / BDIMX;
+  static_assert(NumVals >= wdimy, "NumVals must be >= 32 / blockDim.x");
+  static_assert(
+      NumVals % wdimy == 0, "NumVals must be divisible by 32 / blockDim.x");
+
+  // Y index within each warp
+  const int warp_tidy = threadIdx.y % wdimy;
+
+  // Thread index in each warp
+  const int lane_id = threadIdx.x + warp_tidy * BDIMX;
+
+  int chunk_size = NumVals;
+
+  // Butterfly reduction, a.k.a. recursive halving as each iteration
+  // halves the number of values
+#pragma unroll
+  for (int lane_mask = 16; lane_mask >= BDIMX; lane_mask /= 2) {
+    chunk_size /= 2;
+
+#pragma unroll
+    for (int index_in_chunk = 0; index_in_chunk < chunk_size;
+         ++index_in_chunk) {
+      DataType pushed = init_val;
+      DataType self = init_val;
+      if (lane_id & lane_mask) {
+        // Push first half
+        pushed = inp[index_in_chunk];
+        self = inp[index_in_chunk + chunk_size];
+      } else {
+        // Push second half
+        pushed = inp[index_in_chunk + chunk_size];
+        self = inp[index_in_chunk];
+      }
+      auto peer = __shfl_xor_sync(0xffffffff, pushed, lane_mask);
+      reduction_op(self, peer);
+      inp[index_in_chunk] = self;
+    }
+  }
+
+  // Upload the warp-reduced chunks with the same layout and swizzle
+  // as blockWelfordOuter:
+  //
+  // [chunk_size, wid, warp_tidy, TIDx]
+#pragma unroll
+  for (int i = 0; i < chunk_size; ++i) {
+    int smem_offset = 0;
+    // TIDx
+    smem_offset += threadIdx.x;
+    // Warp_TIDy with swizzle
+    smem_offset += ((warp_tidy + wid) % wdimy) * BDIMX;
+    // WID
+    smem_offset += wid * 32;
+    // chunk_size
+    smem_offset += i * BDIMX * BDIMY;
+    smem[smem_offset] = inp[i];
+  }
+
+  block_sync::sync<Aligned>();
+
+  static_assert(
+      num_warps >= NumVals,
+      "Number of warps must be at least as large as NumVals");
+
+  // Warp wid accumulates the partial results of the wid-th chunk
+  DataType result = init_val;
+
+  if (wid < NumVals) {
+#pragma unroll
+    for (int i = warp_tidy; i < num_warps; i += wdimy) {
+      int offset = 0;
+      offset += threadIdx.x;
+      // Offset to the partial results of the i-th warp
+      offset += i * 32;
+      // Offset to the chunk for this warp. Swizzled to avoid bank
+      // conflicts.
+      offset += ((wid / chunk_size + i) % wdimy) * BDIMX;
+      offset += (wid % chunk_size) * BDIMX * BDIMY;
+
+      reduction_op(result, smem[offset]);
+    }
+  }
+
+  block_sync::sync<Aligned>();
+
+  // Nothing to do for warps whose wid is larger than NunVals
+  if (wid >= NumVals) {
+    return init_val;
+  }
+
+  // Standard binary-exchange reduction within wdimy intra-warp
+  // threads.
+#pragma unroll
+  for (int lane_mask = 16; lane_mask >= BDIMX; lane_mask /= 2) {
+    auto peer = __shfl_xor_sync(0xffffffff, result, lane_mask);
+    reduction_op(result, peer);
+  }
+
+  return result;
+}
+
+} // namespace impl
+} // namespace fused_reduction
@@ -21,4 +21,26 @@ __forceinline__ __device__ void sync() {
   }
 }
 
+// Synchronizes the threads with the same threadIdx.y and threadIdx.z, see
+// [ Row Barriers ] in csrc/device_lower/pass/insert_syncs.h. Each row uses
+// its own named barrier, as barrier 0 is used by sync. Falls back to sync if
+// the rows aren't made of whole warps or there are more rows than barriers.
+template <bool aligned>
+__forceinline__ __device__ void syncRow() {
+  constexpr unsigned int max_rows = 15;
+  const unsigned int num_rows = blockDim.y * blockDim.z;
+  if (num_rows == 1 || num_rows > max_rows || blockDim.x % 32 != 0) {
+    sync<aligned>();
+    return;
+  }
+  const unsigned int barrier_id = 1 + threadIdx.y + threadIdx.z * blockDim.y;
+  if constexpr (aligned) {
+    asm volatile("bar.sync %0, %1;" : : "r"(barrier_id), "r"(blockDim.x)
+                 : "memory");
+  } else {
+    asm volatile("barrier.sync %0, %1;" : : "r"(barrier_id), "r"(blockDim.x)
+                 : "memory");
+  }
+}
+
 } // namespace block_sync
@@ -157,3 +157,70 @@ __device__ __inline__ __half __real_then_2half(const std::complex<float> c) {
 __device__ __inline__ __half __real_then_2half(const std::complex<double> c) {
   return __double2half(std::real(c));
 }
+
+// Arithmetic of EnableOption::HalfArithmetic, see
+// [ Half-Precision Arithmetic ] in optimization/half_arithmetic.h
+
+__device__ __inline__ __half operator+(const __half a, const __half b) {
+  __half val;
+  asm("{  add.f16 %0, %1, %2;}\n"
+      : "=h"(__NVFUSER_HALF_TO_US(val))
+      : "h"(__NVFUSER_HALF_TO_CUS(a)), "h"(__NVFUSER_HALF_TO_CUS(b)));
+  return val;
+}
+
+__device__ __inline__ __half operator-(const __half a, const __half b) {
+  __half val;
+  asm("{  sub.f16 %0, %1, %2;}\n"
+      : "=h"(__NVFUSER_HALF_TO_US(val))
+      : "h"(__NVFUSER_HALF_TO_CUS(a)), "h"(__NVFUSER_HALF_TO_CUS(b)));
+  return val;
+}
+
+__device__ __inline__ __half operator*(const __half a, const __half b) {
+  __half val;
+  asm("{  mul.f16 %0, %1, %2;}\n"
+      : "=h"(__NVFUSER_HALF_TO_US(val))
+      : "h"(__NVFUSER_HALF_TO_CUS(a)), "h"(__NVFUSER_HALF_TO_CUS(b)));
+  return val;
+}
+
+// Packed arithmetic on the pairs of elements out[0:2], a[0:2] and b[0:2]
+
+#define __NVFUSER_HALF2_ASM(op)             \
+  asm("{\n"                                 \
+      "  .reg .b32 a, b, out;\n"            \
+      "  mov.b32 a, {%2, %3};\n"            \
+      "  mov.b32 b, {%4, %5};\n"            \
+      "  " op " out, a, b;\n"               \
+      "  mov.b32 {%0, %1}, out;\n"          \
+      "}\n"                                 \
+      : "=h"(__NVFUSER_HALF_TO_US(out[0])), \
+        "=h"(__NVFUSER_HALF_TO_US(out[1]))  \
+      : "h"(__NVFUSER_HALF_TO_CUS(a[0])),   \
+        "h"(__NVFUSER_HALF_TO_CUS(a[1])),   \
+        "h"(__NVFUSER_HALF_TO_CUS(b[0])),   \
+        "h"(__NVFUSER_HALF_TO_CUS(b[1])))
+
+__device__ __inline__ void __hadd2(
+    __half* out,
+    const __half* a,
+    const __half* b) {
+  __NVFUSER_HALF2_ASM("add.f16x2");
+}
+
+__device__ __inline__ void __hsub2(
+    __half* out,
+    const __half* a,
+    const __half* b) {
+  __NVFUSER_HALF2_ASM("sub.f16x2");
+}
+
+__device__ __inline__ void __hmul2(
+    __half* out,
+    const __half* a,
+    const __half* b) {
+  __NVFUSER_HALF2_ASM("mul.f16x2");
+}
+
+#undef __NVFUSER_HALF2_ASM
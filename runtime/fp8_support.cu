@@ -0,0 +1,256 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+
+// FP8 types of the OCP 8-bit floating point specification, which are the
+// layouts of at::Float8_e4m3fn and at::Float8_e5m2. Conversions to FP8 round
+// to nearest even and saturate to the largest finite value, so that scaled
+// casts never produce infinity. This is what the cvt instructions of sm_89
+// and later do. Older architectures use the equivalent bit manipulation.
+
+#define __NVFUSER_FP8_TO_UC(var) *(reinterpret_cast<unsigned char*>(&(var)))
+#define __NVFUSER_FP8_TO_CUC(var) \
+  *(reinterpret_cast<const unsigned char*>(&(var)))
+
+struct __e4m3;
+__device__ __inline__ __e4m3 __float2e4m3(const float);
+
+struct __align__(1) __e4m3 {
+  __e4m3() = default;
+
+  __device__ __e4m3(const float f) {
+    __x = __float2e4m3(f).__x;
+  }
+
+  __device__ uint8_t raw() const {
+    return __x;
+  }
+
+ protected:
+  unsigned char __x;
+};
+
+struct __e5m2;
+__device__ __inline__ __e5m2 __float2e5m2(const float);
+
+struct __align__(1) __e5m2 {
+  __e5m2() = default;
+
+  __device__ __e5m2(const float f) {
+    __x = __float2e5m2(f).__x;
+  }
+
+  __device__ uint8_t raw() const {
+    return __x;
+  }
+
+ protected:
+  unsigned char __x;
+};
+
+namespace fp8 {
+
+// Bits of the FP8 value of f with the given number of exponent and mantissa
+// bits. max_finite is the magnitude of the largest finite value, and
+// max_finite_bits its encoding without the sign.
+template <int EXP_BITS, int MAN_BITS>
+__device__ __inline__ uint8_t fromFloat(
+    const float f,
+    const float max_finite,
+    const uint8_t max_finite_bits) {
+  constexpr int kBias = (1 << (EXP_BITS - 1)) - 1;
+  constexpr int kShift = 23 - MAN_BITS;
+  const uint32_t bits = __float_as_uint(f);
+  const uint8_t sign = (bits >> 24) & 0x80;
+  uint32_t abs_bits = bits & 0x7fffffff;
+  if (abs_bits > 0x7f800000) {
+    // NaN
+    return 0x7f;
+  }
+  const float abs_f = __uint_as_float(abs_bits);
+  if (abs_f >= max_finite) {
+    return sign | max_finite_bits;
+  }
+  // Smallest normal value, 2^(1 - bias)
+  const float min_normal = __uint_as_float((uint32_t)(128 - kBias) << 23);
+  if (abs_f < min_normal) {
+    // Subnormal, in units of 2^(1 - bias - mantissa bits). A result of
+    // 2^mantissa bits is the encoding of the smallest normal value.
+    const float unit =
+        __uint_as_float((uint32_t)(128 - kBias - MAN_BITS) << 23);
+    return sign | (uint8_t)__float2uint_rn(abs_f / unit);
+  }
+  // Round the mantissa to nearest even. A carry into the exponent is
+  // intended.
+  abs_bits += ((abs_bits >> kShift) & 1) + (1u << (kShift - 1)) - 1;
+  const uint32_t exponent = (abs_bits >> 23) - 127 + kBias;
+  const uint32_t mantissa = (abs_bits >> kShift) & ((1u << MAN_BITS) - 1);
+  const uint32_t result = (exponent << MAN_BITS) | mantissa;
+  return sign | (uint8_t)(result > max_finite_bits ? max_finite_bits : result);
+}
+
+// Float value of the FP8 bits. e4m3 has no infinity and a single NaN
+// encoding, e5m2 follows IEEE 754.
+template <int EXP_BITS, int MAN_BITS, bool HAS_INF>
+__device__ __inline__ float toFloat(const uint8_t x) {
+  constexpr int kBias = (1 << (EXP_BITS - 1)) - 1;
+  constexpr uint32_t kMaxExponent = (1u << EXP_BITS) - 1;
+  const uint32_t sign = (uint32_t)(x & 0x80) << 24;
+  const uint32_t exponent = (x >> MAN_BITS) & kMaxExponent;
+  const uint32_t mantissa = x & ((1u << MAN_BITS) - 1);
+  if (HAS_INF && exponent == kMaxExponent) {
+    return __uint_as_float(sign | (mantissa == 0 ? 0x7f800000 : 0x7fffffff));
+  }
+  if (!HAS_INF && (x & 0x7f) == 0x7f) {
+    return __uint_as_float(0x7fffffff);
+  }
+  if (exponent == 0) {
+    const float unit =
+        __uint_as_float((uint32_t)(128 - kBias - MAN_BITS) << 23);
+    return __uint_as_float(sign | __float_as_uint((float)mantissa * unit));
+  }
+  return __uint_as_float(
+      sign | ((exponent - kBias + 127) << 23) | (mantissa << (23 - MAN_BITS)));
+}
+
+} // namespace fp8
+
+// Packed conversions of two values, where x is in the lower byte
+
+__device__ __inline__ uint16_t __float22e4m3x2(const float2 f) {
+  uint16_t val;
+#if __CUDA_ARCH__ >= 890
+  asm("{  cvt.rn.satfinite.e4m3x2.f32 %0, %2, %1;}\n"
+      : "=h"(val)
+      : "f"(f.x), "f"(f.y));
+#else
+  val = (uint16_t)fp8::fromFloat<4, 3>(f.x, 448.0f, 0x7e) |
+      ((uint16_t)fp8::fromFloat<4, 3>(f.y, 448.0f, 0x7e) << 8);
+#endif
+  return val;
+}
+
+__device__ __inline__ uint16_t __float22e5m2x2(const float2 f) {
+  uint16_t val;
+#if __CUDA_ARCH__ >= 890
+  asm("{  cvt.rn.satfinite.e5m2x2.f32 %0, %2, %1;}\n"
+      : "=h"(val)
+      : "f"(f.x), "f"(f.y));
+#else
+  val = (uint16_t)fp8::fromFloat<5, 2>(f.x, 57344.0f, 0x7b) |
+      ((uint16_t)fp8::fromFloat<5, 2>(f.y, 57344.0f, 0x7b) << 8);
+#endif
+  return val;
+}
+
+__device__ __inline__ float2 __e4m3x22float2(const uint16_t x) {
+  float2 val;
+#if __CUDA_ARCH__ >= 890
+  asm("{\n"
+      "  .reg .b32 halves;\n"
+      "  .reg .b16 lo, hi;\n"
+      "  cvt.rn.f16x2.e4m3x2 halves, %2;\n"
+      "  mov.b32 {lo, hi}, halves;\n"
+      "  cvt.f32.f16 %0, lo;\n"
+      "  cvt.f32.f16 %1, hi;\n"
+      "}\n"
+      : "=f"(val.x), "=f"(val.y)
+      : "h"(x));
+#else
+  val.x = fp8::toFloat<4, 3, false>(x & 0xff);
+  val.y = fp8::toFloat<4, 3, false>(x >> 8);
+#endif
+  return val;
+}
+
+__device__ __inline__ float2 __e5m2x22float2(const uint16_t x) {
+  float2 val;
+#if __CUDA_ARCH__ >= 890
+  asm("{\n"
+      "  .reg .b32 halves;\n"
+      "  .reg .b16 lo, hi;\n"
+      "  cvt.rn.f16x2.e5m2x2 halves, %2;\n"
+      "  mov.b32 {lo, hi}, halves;\n"
+      "  cvt.f32.f16 %0, lo;\n"
+      "  cvt.f32.f16 %1, hi;\n"
+      "}\n"
+      : "=f"(val.x), "=f"(val.y)
+      : "h"(x));
+#else
+  val.x = fp8::toFloat<5, 2, true>(x & 0xff);
+  val.y = fp8::toFloat<5, 2, true>(x >> 8);
+#endif
+  return val;
+}
+
+__device__ __inline__ __e4m3 __float2e4m3(const float f) {
+  __e4m3 val;
+  __NVFUSER_FP8_TO_UC(val) = (unsigned char)__float22e4m3x2({f, 0.0f});
+  return val;
+}
+
+__device__ __inline__ __e4m3 __double2e4m3(const double d) {
+  return __float2e4m3(static_cast<float>(d));
+}
+
+__device__ __inline__ __e4m3 __half2e4m3(const __half h) {
+  return __float2e4m3(__half2float(h));
+}
+
+__device__ __inline__ __e4m3 __bfloat2e4m3(const __bfloat h) {
+  return __float2e4m3(__bfloat2float(h));
+}
+
+__device__ __inline__ float __e4m32float(const __e4m3 h) {
+  return __e4m3x22float2(__NVFUSER_FP8_TO_CUC(h)).x;
+}
+
+__device__ __inline__ double __e4m32double(const __e4m3 h) {
+  return static_cast<double>(__e4m32float(h));
+}
+
+__device__ __inline__ __half __e4m32half(const __e4m3 h) {
+  return __float2half(__e4m32float(h));
+}
+
+__device__ __inline__ __bfloat __e4m32bfloat(const __e4m3 h) {
+  return __float2bfloat(__e4m32float(h));
+}
+
+__device__ __inline__ __e5m2 __float2e5m2(const float f) {
+  __e5m2 val;
+  __NVFUSER_FP8_TO_UC(val) = (unsigned char)__float22e5m2x2({f, 0.0f});
+  return val;
+}
+
+__device__ __inline__ __e5m2 __double2e5m2(const double d) {
+  return __float2e5m2(static_cast<float>(d));
+}
+
+__device__ __inline__ __e5m2 __half2e5m2(const __half h) {
+  return __float2e5m2(__half2float(h));
+}
+
+__device__ __inline__ __e5m2 __bfloat2e5m2(const __bfloat h) {
+  return __float2e5m2(__bfloat2float(h));
+}
+
+__device__ __inline__ float __e5m22float(const __e5m2 h) {
+  return __e5m2x22float2(__NVFUSER_FP8_TO_CUC(h)).x;
+}
+
+__device__ __inline__ double __e5m22double(const __e5m2 h) {
+  return static_cast<double>(__e5m22float(h));
+}
+
+__device__ __inline__ __half __e5m22half(const __e5m2 h) {
+  return __float2half(__e5m22float(h));
+}
+
+__device__ __inline__ __bfloat __e5m22bfloat(const __e5m2 h) {
+  return __float2bfloat(__e5m22float(h));
+}
@@ -632,6 +632,44 @@ class ParallelReduce {
       int64_t& cycles,
       int64_t& count);
 
+  // Non-Welford version of welfordGroupOuter with the same
+  // assumptions. Each call reduces the NumVals grouped iterations of a
+  // single reduction.
+  template <
+      bool Aligned,
+      int NumVals,
+      typename DataType,
+      int BDIMX,
+      int BDIMY,
+      typename Func>
+  __device__ __inline__ void reduceGroupOuter(
+      DataType out[NumVals],
+      const DataType in[NumVals],
+      DataType* global_buf,
+      DataType* shared_buf,
+      int64_t* global_sync_buffer,
+      Func reduction_op,
+      DataType init_val);
+
+  // Profiled version
+  template <
+      bool Aligned,
+      int NumVals,
+      typename DataType,
+      int BDIMX,
+      int BDIMY,
+      typename Func>
+  __device__ __inline__ void reduceGroupOuter(
+      DataType out[NumVals],
+      const DataType in[NumVals],
+      DataType* global_buf,
+      DataType* shared_buf,
+      int64_t* global_sync_buffer,
+      Func reduction_op,
+      DataType init_val,
+      int64_t& cycles,
+      int64_t& count);
+
  private:
   __device__ static bool isLastBlockInGrid() {
     return index_utils::maskedIsLast<
@@ -0,0 +1,236 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+namespace fused_reduction {
+
+namespace impl {
+
+// Per-thread accumulation of the per-block partial results in global
+// memory. There's gridDim.y partial results, which is accumulated in
+// parallel by threadIdx.y. This should be followed by a block
+// reduction. See also welfordGroupAccumulateGlobalBuffer.
+template <
+    int NumVals,
+    typename DataType,
+    int BDIMX,
+    int BDIMY,
+    typename Func>
+__device__ __inline__ Array<DataType, NumVals, NumVals>
+reduceGroupAccumulateGlobalBuffer(
+    volatile DataType* global_buf,
+    bool flip,
+    Func reduction_op,
+    DataType init_val) {
+  const int grid_size = gridDim.x * gridDim.y;
+  const int iter_idx = threadIdx.x;
+  const int red_idx = threadIdx.y;
+  const int num_threads_per_reduction = BDIMY;
+
+  Array<DataType, NumVals, NumVals> results;
+  results.set(init_val);
+
+  // Thread blocks with the same blockIdx.x use a global buffer of
+  // size blockDim.x * gridDim.y for each value in a group
+  global_buf += iter_idx + blockIdx.x * BDIMX * gridDim.y;
+
+  if (flip) {
+    global_buf += BDIMX * grid_size * NumVals;
+  }
+
+  for (int ri = red_idx; ri < gridDim.y; ri += num_threads_per_reduction) {
+    int work_buf_offset = ri * BDIMX;
+#pragma unroll
+    for (int gi = 0; gi < NumVals; ++gi) {
+      reduction_op(results[gi], global_buf[work_buf_offset]);
+      work_buf_offset += grid_size * BDIMX;
+    }
+  }
+
+  return results;
+}
+
+} // namespace impl
+
+template <
+    int X_BLOCK,
+    int Y_BLOCK,
+    int Z_BLOCK,
+    int X_THREAD,
+    int Y_THREAD,
+    int Z_THREAD,
+    bool PERSISTENT_REDUCTION,
+    bool BROADCAST>
+template <
+    bool Aligned,
+    int NumVals,
+    typename DataType,
+    int BDIMX,
+    int BDIMY,
+    typename Func>
+__device__ __inline__ void ParallelReduce<
+    X_BLOCK,
+    Y_BLOCK,
+    Z_BLOCK,
+    X_THREAD,
+    Y_THREAD,
+    Z_THREAD,
+    PERSISTENT_REDUCTION,
+    BROADCAST>::
+    reduceGroupOuter(
+        DataType out[NumVals],
+        const DataType in[NumVals],
+        DataType* global_buf,
+        DataType* shared_buf,
+        int64_t* global_sync_buffer,
+        Func reduction_op,
+        DataType init_val) {
+  using namespace fused_reduction::impl;
+
+  static_assert(
+      isIter(X_BLOCK) && isReduce(Y_BLOCK) && inactive(Z_BLOCK) &&
+          isIter(X_THREAD) && isReduce(Y_THREAD) && inactive(Z_THREAD),
+      "Invalid parallelization for outer reduction");
+
+  static_assert(
+      BDIMY % NumVals == 0, "blockDim.y must be divisible by group count");
+  static_assert(BDIMX <= 32, "blockDim.x must be up to 32.");
+  static_assert(
+      (BDIMX * BDIMY) % 32 == 0, "Number of threads must be a multiple of 32.");
+  static_assert(32 % BDIMX == 0, "blockDim.x must be able to divide 32.");
+  static_assert(
+      NumVals >= (32 / BDIMX), "Group count must be >= 32 / blockDim.x");
+
+#pragma unroll
+  for (int i = 0; i < NumVals; ++i) {
+    out[i] = in[i];
+  }
+
+  auto per_block_result =
+      impl::blockReduceOuter<Aligned, NumVals, DataType, BDIMX, BDIMY>(
+          out, shared_buf, reduction_op, init_val);
+
+  const int grid_size = gridDim.x * gridDim.y;
+  const int iter_idx = threadIdx.x;
+
+  // Stores the partial results into the global work buffer. Each
+  // valid result is held by a warp
+  const int wid = (threadIdx.x + threadIdx.y * BDIMX) / 32;
+  constexpr int wdimy = 32 / BDIMX;
+  const int warp_tidy = threadIdx.y % wdimy;
+  const bool has_valid_block_reduction_result = warp_tidy == 0 && wid < NumVals;
+  const int valid_group_idx = wid;
+
+  if (has_valid_block_reduction_result) {
+    int work_buf_offset = iter_idx + blockIdx.y * BDIMX +
+        blockIdx.x * BDIMX * gridDim.y + valid_group_idx * BDIMX * grid_size;
+    if (PERSISTENT_REDUCTION && flip) {
+      auto global_buffer_size = BDIMX * grid_size * NumVals;
+      work_buf_offset += global_buffer_size;
+    }
+    global_buf[work_buf_offset] = per_block_result;
+  }
+
+  flip = !flip;
+
+  // -- GLOBAL BUFFER FILLED -- //
+
+  bool last_block = index_utils::
+      maskedIsLast<isReduce(X_BLOCK), isReduce(Y_BLOCK), isReduce(Z_BLOCK)>(
+          blockIdx, gridDim);
+
+  grid_sync::sync<
+      isReduce(X_BLOCK),
+      isReduce(Y_BLOCK),
+      isReduce(Z_BLOCK),
+      PERSISTENT_REDUCTION,
+      Aligned>(global_sync_buffer[blockIdx.x], gridDim.y, last_block);
+
+  auto partial_results =
+      reduceGroupAccumulateGlobalBuffer<NumVals, DataType, BDIMX, BDIMY>(
+          global_buf, !flip, reduction_op, init_val);
+
+  auto per_block_final_result =
+      impl::blockReduceOuter<Aligned, NumVals, DataType, BDIMX, BDIMY>(
+          partial_results.array, shared_buf, reduction_op, init_val);
+
+  // Broadcast the final results within the block through shared
+  // memory
+  if (has_valid_block_reduction_result) {
+    shared_buf[getSmemGroupOffset<BDIMX>(iter_idx, valid_group_idx)] =
+        per_block_final_result;
+  }
+
+  __syncthreads();
+
+#pragma unroll
+  for (int i = 0; i < NumVals; ++i) {
+    out[i] = shared_buf[getSmemGroupOffset<BDIMX>(iter_idx, i)];
+  }
+
+  // Forward protect the smem buffer
+  __syncthreads();
+}
+
+template <
+    int X_BLOCK,
+    int Y_BLOCK,
+    int Z_BLOCK,
+    int X_THREAD,
+    int Y_THREAD,
+    int Z_THREAD,
+    bool PERSISTENT_REDUCTION,
+    bool BROADCAST>
+template <
+    bool Aligned,
+    int NumVals,
+    typename DataType,
+    int BDIMX,
+    int BDIMY,
+    typename Func>
+__device__ __inline__ void ParallelReduce<
+    X_BLOCK,
+    Y_BLOCK,
+    Z_BLOCK,
+    X_THREAD,
+    Y_THREAD,
+    Z_THREAD,
+    PERSISTENT_REDUCTION,
+    BROADCAST>::
+    reduceGroupOuter(
+        DataType out[NumVals],
+        const DataType in[NumVals],
+        DataType* global_buf,
+        DataType* shared_buf,
+        int64_t* global_sync_buffer,
+        Func reduction_op,
+        DataType init_val,
+        int64_t& cycles,
+        int64_t& count) {
+  int64_t start_counter = 0;
+
+  if (isLastBlockInGrid() &&
+      index_utils::maskedIsZero<true, true, true>(threadIdx)) {
+    start_counter = readCycleCounter();
+  }
+
+  reduceGroupOuter<Aligned, NumVals, DataType, BDIMX, BDIMY>(
+      out,
+      in,
+      global_buf,
+      shared_buf,
+      global_sync_buffer,
+      reduction_op,
+      init_val);
+
+  if (isLastBlockInGrid() &&
+      index_utils::maskedIsZero<true, true, true>(threadIdx)) {
+    cycles += readCycleCounter() - start_counter;
+    ++count;
+  }
+}
+
+} // namespace fused_reduction
@@ -359,6 +359,217 @@ __device__ void gridReduce(
 }
 #endif // NVFUSER_PROFILE_KERNEL
 
+// Single-pass variant of gridReduce for non-persistent reductions. Instead of
+// having every block write its partial result to the work buffer and the last
+// block reduce all of them, the blocks of each reduction segment combine
+// their partial results into the work buffer one after another in the order
+// of their offset in the segment. Each block only waits for its predecessor
+// once its own partial result is ready, and the last block of the segment
+// combines the accumulated value into out, so the result ends up in the same
+// block as with gridReduce. The work buffer only needs one value per
+// reduction segment and reduction block, i.e., it does not grow with the
+// number of blocks in the segment.
+//
+// The order of the combining steps is fixed, so the result is deterministic.
+// Like the serial grid reduction, this assumes a block is only scheduled once
+// all blocks with smaller indices have been.
+//
+// Function and template parameters are the same as for gridReduce, except
+// that reductions are never persistent. sync_flags must be zero-initialized
+// and is reset by the last block of each segment.
+template <
+    bool X_BLOCK,
+    bool Y_BLOCK,
+    bool Z_BLOCK,
+    bool X_THREAD,
+    bool Y_THREAD,
+    bool Z_THREAD,
+    bool Aligned,
+    typename T,
+    typename Func>
+__device__ void gridReduceSinglePass(
+    T& out,
+    const T& inp_val,
+    Func reduction_op,
+    volatile T* work_buf,
+    int64_t* sync_flags,
+    T* shared_buf,
+    bool read_pred,
+    bool write_pred,
+    T init_val,
+    const nvfuser_index_t entrance_ind,
+    const nvfuser_index_t n_entrances) {
+  T block_reduction_val = init_val;
+
+  // Do block reduction when required
+  if (X_THREAD || Y_THREAD || Z_THREAD) {
+    blockReduce<X_THREAD, Y_THREAD, Z_THREAD, Aligned>(
+        block_reduction_val,
+        inp_val,
+        reduction_op,
+        shared_buf,
+        read_pred,
+        true,
+        init_val);
+  } else if (read_pred) {
+    block_reduction_val = inp_val;
+  }
+
+  const auto grid_reduction_segment_size =
+      index_utils::maskedSize<X_BLOCK, Y_BLOCK, Z_BLOCK>(gridDim);
+  const auto block_offset =
+      index_utils::maskedOffset<X_BLOCK, Y_BLOCK, Z_BLOCK>(blockIdx, gridDim);
+  const bool last_block = block_offset == grid_reduction_segment_size - 1;
+
+  const auto idx_in_grid_segment =
+      index_utils::maskedOffset<!X_BLOCK, !Y_BLOCK, !Z_BLOCK>(
+          blockIdx, gridDim);
+  const nvfuser_index_t grid_segment_size =
+      index_utils::maskedSize<!X_BLOCK, !Y_BLOCK, !Z_BLOCK>(gridDim);
+  const auto block_reduction_segment_size =
+      index_utils::maskedSize<!X_THREAD, !Y_THREAD, !Z_THREAD>(blockDim);
+
+  // Each segment and entrance has its own semaphore and accumulator
+  const auto segment_ind =
+      entrance_ind * grid_segment_size + idx_in_grid_segment;
+  int64_t* semaphore = sync_flags + segment_ind;
+  work_buf += segment_ind * block_reduction_segment_size;
+
+  // Wait until the previous block of the segment is done with the
+  // accumulator
+  if (block_offset > 0) {
+    grid_sync::semaphoreWait(semaphore, block_offset);
+  }
+  block_sync::sync<Aligned>();
+
+  if ((!X_THREAD || threadIdx.x == 0) && (!Y_THREAD || threadIdx.y == 0) &&
+      (!Z_THREAD || threadIdx.z == 0)) {
+    auto thread_offset =
+        index_utils::maskedOffset<!X_THREAD, !Y_THREAD, !Z_THREAD>(
+            threadIdx, blockDim);
+    if (block_offset > 0) {
+      reduction_op(block_reduction_val, work_buf[thread_offset]);
+    }
+    if (!last_block) {
+      work_buf[thread_offset] = block_reduction_val;
+    } else if (write_pred) {
+      reduction_op(out, block_reduction_val);
+    }
+  }
+
+  // Make the accumulator visible to the next block before releasing it. The
+  // last block resets the semaphore.
+  __threadfence();
+  block_sync::sync<Aligned>();
+  grid_sync::semaphoreRelease(semaphore, last_block ? 0 : block_offset + 1);
+}
+
+#ifdef NVFUSER_PROFILE_KERNEL
+template <
+    bool X_BLOCK,
+    bool Y_BLOCK,
+    bool Z_BLOCK,
+    bool X_THREAD,
+    bool Y_THREAD,
+    bool Z_THREAD,
+    bool Aligned,
+    typename T,
+    typename Func>
+__device__ void gridReduceSinglePass(
+    T& out,
+    const T& inp_val,
+    Func reduction_op,
+    volatile T* work_buf,
+    int64_t* sync_flags,
+    T* shared_buf,
+    bool read_pred,
+    bool write_pred,
+    T init_val,
+    const nvfuser_index_t entrance_ind,
+    const nvfuser_index_t n_entrances,
+    int64_t& cycles,
+    int64_t& count) {
+  int64_t start_counter = 0;
+
+  if (index_utils::maskedIsLast<true, true, true>(blockIdx, gridDim) &&
+      index_utils::maskedIsZero<true, true, true>(threadIdx)) {
+    start_counter = readCycleCounter();
+  }
+
+  gridReduceSinglePass<
+      X_BLOCK,
+      Y_BLOCK,
+      Z_BLOCK,
+      X_THREAD,
+      Y_THREAD,
+      Z_THREAD,
+      Aligned,
+      T,
+      Func>(
+      out,
+      inp_val,
+      reduction_op,
+      work_buf,
+      sync_flags,
+      shared_buf,
+      read_pred,
+      write_pred,
+      init_val,
+      entrance_ind,
+      n_entrances);
+
+  if (index_utils::maskedIsLast<true, true, true>(blockIdx, gridDim) &&
+      index_utils::maskedIsZero<true, true, true>(threadIdx)) {
+    cycles += readCycleCounter() - start_counter;
+    ++count;
+  }
+}
+#endif // NVFUSER_PROFILE_KERNEL
+
+// Atomic variant of gridReduce for non-persistent sums. Each block reduces
+// its values over the X/Y/Z_THREAD dimensions and adds its partial result to
+// out with atomicAdd, so no work buffer, sync flags or last block are needed.
+// out must be zero-initialized before the kernel is launched, and only the
+// thread at offset zero of each block reduction segment adds to it when
+// write_pred is true. The order of the additions, and thus the result, is
+// nondeterministic. Only float and double are supported.
+template <
+    bool X_THREAD,
+    bool Y_THREAD,
+    bool Z_THREAD,
+    bool Aligned,
+    typename T,
+    typename Func>
+__device__ void gridReduceAtomic(
+    T& out,
+    const T& inp_val,
+    Func reduction_op,
+    T* shared_buf,
+    bool read_pred,
+    bool write_pred,
+    T init_val) {
+  T block_reduction_val = init_val;
+
+  // Do block reduction when required
+  if (X_THREAD || Y_THREAD || Z_THREAD) {
+    blockReduce<X_THREAD, Y_THREAD, Z_THREAD, Aligned>(
+        block_reduction_val,
+        inp_val,
+        reduction_op,
+        shared_buf,
+        read_pred,
+        true,
+        init_val);
+  } else if (read_pred) {
+    block_reduction_val = inp_val;
+  }
+
+  if (write_pred &&
+      index_utils::maskedIsZero<X_THREAD, Y_THREAD, Z_THREAD>(threadIdx)) {
+    atomicAdd(&out, block_reduction_val);
+  }
+}
+
 template <
     bool X_BLOCK,
     bool Y_BLOCK,
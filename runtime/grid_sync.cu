@@ -15,6 +15,114 @@ __device__ T globalAsVolatile(volatile T& global_val) {
   return global_val;
 }
 
+#if __CUDA_ARCH__ >= 900
+// Number of blocks in the thread block cluster of this block, which is 1
+// unless the kernel is launched with clusters
+__device__ __forceinline__ uint32_t clusterSize() {
+  uint32_t size;
+  asm volatile("mov.u32 %0, %%cluster_nctarank;\n" : "=r"(size));
+  return size;
+}
+
+// Index of this block in its thread block cluster
+__device__ __forceinline__ uint32_t clusterRank() {
+  uint32_t rank;
+  asm volatile("mov.u32 %0, %%cluster_ctarank;\n" : "=r"(rank));
+  return rank;
+}
+
+// Synchronizes all threads of all blocks of the cluster. The arrival has
+// release and the wait acquire semantics, so memory accesses before the sync
+// are visible to the cluster after it.
+template <bool Aligned>
+__device__ __forceinline__ void clusterSync() {
+  if (Aligned) {
+    asm volatile(
+        "barrier.cluster.arrive.aligned;\n"
+        "barrier.cluster.wait.aligned;\n" ::
+            : "memory");
+  } else {
+    asm volatile(
+        "barrier.cluster.arrive;\n"
+        "barrier.cluster.wait;\n" ::
+            : "memory");
+  }
+}
+
+// Grid sync of kernels launched with clusters of blocks along X, see
+// [ Cluster Grid Sync ] in csrc/executor.cpp. The blocks of a cluster are
+// first synchronized with the cluster barrier, and only the first block of
+// each cluster arrives at the global semaphore, so the semaphore counts
+// clusters instead of blocks. The other blocks of the cluster wait at the
+// cluster barrier instead of spinning on global memory. This requires
+// X_BLOCK, so that all blocks of a cluster are in the same segment, and it
+// assumes the block with the largest index is the last one, like sync
+// below.
+template <bool Y_BLOCK, bool Z_BLOCK, bool PERSISTENT, bool Aligned>
+__device__ void clusterGridSync(
+    int64_t& semaphore,
+    const uint64_t& segment_size) {
+  const uint32_t cluster_size = clusterSize();
+  const uint32_t cluster_rank = clusterRank();
+
+  // Finish all global memory transactions before synchronizing
+  __threadfence();
+
+  // Synchronize all blocks of the cluster before synchronizing clusters
+  clusterSync<Aligned>();
+
+  if (cluster_rank == 0 && threadIdx.x == 0 && threadIdx.y == 0 &&
+      threadIdx.z == 0) {
+    const bool last_cluster = blockIdx.x + cluster_size == gridDim.x &&
+        (!Y_BLOCK || blockIdx.y == gridDim.y - 1) &&
+        (!Z_BLOCK || blockIdx.z == gridDim.z - 1);
+    const uint64_t num_clusters = segment_size / cluster_size;
+
+    // Same flip/flop of the first bit as in sync, counting clusters
+    uint64_t semaphore_increment = 1;
+    if (last_cluster) {
+      semaphore_increment = FIRST_UINT64_BIT - (num_clusters - 1);
+    }
+
+    uint64_t oldArrive =
+        atomicAdd(reinterpret_cast<uint64_t*>(&semaphore), semaphore_increment);
+
+    unsigned int ns = 8;
+    while ((PERSISTENT || last_cluster) &&
+           ((oldArrive ^ globalAsVolatile(semaphore)) & FIRST_UINT64_BIT) ==
+               0) {
+      __nanosleep(ns); // avoids busy waiting
+      if (ns < 256) {
+        ns *= 2;
+      }
+    }
+    // Make the writes of the other clusters visible to this cluster
+    __threadfence();
+  }
+
+  // Release the other blocks of the cluster
+  clusterSync<Aligned>();
+}
+#endif // __CUDA_ARCH__ >= 900
+
+// Allows the next kernel of the stream to start launching its blocks, if it
+// was launched with programmatic dependent launch. See
+// [ Programmatic Dependent Launch ] in csrc/executor.cpp. No-op before Hopper.
+__device__ __forceinline__ void launchDependentGrids() {
+#if __CUDA_ARCH__ >= 900
+  asm volatile("griddepcontrol.launch_dependents;\n" ::: "memory");
+#endif // __CUDA_ARCH__ >= 900
+}
+
+// Waits until the preceding kernels of the stream have completed and their
+// memory operations are visible. Returns immediately if this kernel wasn't
+// launched with programmatic dependent launch. No-op before Hopper.
+__device__ __forceinline__ void waitForPrerequisiteGrids() {
+#if __CUDA_ARCH__ >= 900
+  asm volatile("griddepcontrol.wait;\n" ::: "memory");
+#endif // __CUDA_ARCH__ >= 900
+}
+
 // A grid synchronization that can be called multiple times in a kernel assuming
 // all the blocks fit on device at once. The semaphore is an integer semaphore
 // assumed to be initialized to 0 before launching the kernel. The persistent
@@ -34,6 +142,14 @@ __device__ void sync(
     int64_t& semaphore,
     const uint64_t& segment_size,
     const bool last_block) {
+#if __CUDA_ARCH__ >= 900
+  if (X_BLOCK && clusterSize() > 1) {
+    clusterGridSync<Y_BLOCK, Z_BLOCK, PERSISTENT, Aligned>(
+        semaphore, segment_size);
+    return;
+  }
+#endif // __CUDA_ARCH__ >= 900
+
   // Finish all global memory transactions before synchronizing
   __threadfence();
 
@@ -50,6 +50,21 @@ __device__ constexpr double ceilDiv(int64_t a, double b) {
   return std::ceil(a / b);
 }
 
+// Quotient of a non-negative a by the divisor whose multiplier and shift are
+// computed with getFastDivmodParams on the host, see [ Fast Divmod ] in
+// csrc/device_lower/pass/scalar_hoist.h. The sum can't overflow, as a is less
+// than 2^31 or 2^63 and the high half of the product is at most a.
+__device__ inline int fastDiv(int a, int multiplier, int shift) {
+  const unsigned int hi = __umulhi((unsigned int)multiplier, (unsigned int)a);
+  return (int)((hi + (unsigned int)a) >> shift);
+}
+
+__device__ inline int64_t
+fastDiv(int64_t a, int64_t multiplier, int64_t shift) {
+  const uint64_t hi = __umul64hi((uint64_t)multiplier, (uint64_t)a);
+  return (int64_t)((hi + (uint64_t)a) >> shift);
+}
+
 // Monotonic and precise lerp is described here:
 // https://math.stackexchange.com/a/1798323
 __device__ double lerp(double start, double end, double weight) {
@@ -496,6 +511,34 @@ __device__ inline int64_t readCycleCounter() {
   return clock64();
 }
 
+// Profiled regions are measured by one thread of the last thread block, as
+// the profiled grid reductions are
+__device__ inline bool isProfilingThread() {
+  return blockIdx.x == gridDim.x - 1 && blockIdx.y == gridDim.y - 1 &&
+      blockIdx.z == gridDim.z - 1 && threadIdx.x == 0 && threadIdx.y == 0 &&
+      threadIdx.z == 0;
+}
+
+__device__ inline int64_t startProfiledRegion() {
+  return isProfilingThread() ? readCycleCounter() : 0;
+}
+
+// Accumulates the cycles since start_counter into a profile entry of
+// [cycles, count, first start, last end]
+__device__ inline void stopProfiledRegion(
+    int64_t start_counter,
+    int64_t* entry) {
+  if (isProfilingThread()) {
+    const int64_t end_counter = readCycleCounter();
+    entry[0] += end_counter - start_counter;
+    if (entry[1] == 0) {
+      entry[2] = start_counter;
+    }
+    ++entry[1];
+    entry[3] = end_counter;
+  }
+}
+
 __device__ float print_impl(const char* name, float value) {
   printf(
       "%s = %f @ threadIdx=(%d,%d,%d), blockIdx=(%d,%d,%d)\n",
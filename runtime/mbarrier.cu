@@ -72,6 +72,42 @@ __device__ inline void wait(uint32_t smem_barrier_ptr, uint64_t state) {
 #endif
 }
 
+// Waits for the completion of the phase of the given parity, i.e., of the
+// current phase if it has that parity, or else of the preceding phase
+__device__ inline void waitParity(uint32_t smem_barrier_ptr, uint32_t parity) {
+#if (defined(__CUDA_ARCH__) && (__CUDA_ARCH__ >= 900))
+  asm volatile(
+      "{\n"
+      ".reg .pred                complete;\n"
+      "waitLoop:\n"
+      "mbarrier.try_wait.parity.shared.b64 complete, [%0], %1;\n"
+      "@!complete bra waitLoop;\n"
+      "}\n" ::"r"(smem_barrier_ptr),
+      "r"(parity));
+#else
+  asm volatile(
+      "{\n"
+      ".reg .pred                P1;\n"
+      "LAB_WAIT:\n"
+      "mbarrier.test_wait.parity.shared.b64 P1, [%0], %1;\n"
+      "@P1                       bra.uni DONE;\n"
+      "nanosleep.u32 20;\n"
+      "bra.uni                   LAB_WAIT;\n"
+      "DONE:\n"
+      "}\n" ::"r"(smem_barrier_ptr),
+      "r"(parity));
+#endif
+}
+
+// Arrives at the mbarrier once all prior cp.async operations of the calling
+// thread have completed. The arrival is one of the expected arrivals the
+// mbarrier was initialized with.
+__device__ inline void cpAsyncArrive(uint32_t smem_barrier_ptr) {
+  asm volatile(
+      "cp.async.mbarrier.arrive.noinc.shared.b64 [%0];\n" ::"r"(
+          smem_barrier_ptr));
+}
+
 } // namespace mbarrier
 
 #endif // (defined(__CUDA_ARCH__) && (__CUDA_ARCH__ >= 800))
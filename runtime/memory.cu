@@ -69,6 +69,25 @@ namespace Hopper {
 
 // TMA Loads:
 
+// Non-tensor bulk copy of a contiguous range of bytes from global to shared
+// memory. The address of both ranges and the size must be multiples of 16.
+struct CpAsyncBulkG2SIndex {
+  const void* src;
+  uint32_t bytes;
+  uint32_t mbarrier;
+};
+
+__device__ inline void cpAsyncBulkG2S(
+    const CpAsyncBulkG2SIndex& src,
+    uint32_t smem_addr) {
+  asm volatile(
+      "cp.async.bulk.shared::cluster.global.mbarrier::complete_tx::bytes"
+      " [%0], [%1], %2, [%3];"
+      :
+      : "r"(smem_addr), "l"(src.src), "r"(src.bytes), "r"(src.mbarrier)
+      : "memory");
+}
+
 template <int dim>
 struct CpAsyncBulkTensorTileG2SIndex {
   const TensorMap* descriptor;
@@ -95,15 +95,28 @@ __device__ float rng_uniform_rangef(
   return from + range * uniform01;
 }
 
-__device__ float normalf(unsigned int x, unsigned int y, int rng_component) {
+// Both normals of the Box-Muller transform of two uniforms
+__device__ float2 normal_pairf(unsigned int x, unsigned int y) {
   float u = uniformf(x);
   float v = uniformf(y) * 6.2831855f;
+  float r = sqrtf(-2.0f * logf(u));
+  return make_float2(r * sinf(v), r * cosf(v));
+}
 
-  if (rng_component % 2 == 0) {
-    return sqrtf(-2.0f * logf(u)) * sinf(v);
-  } else {
-    return sqrtf(-2.0f * logf(u)) * cosf(v);
-  }
+__device__ double2 normal_pair(
+    unsigned int x0,
+    unsigned int x1,
+    unsigned int y0,
+    unsigned int y1) {
+  double u = uniform(x0, x1);
+  double v = uniform(y0, y1) * 6.2831853071795860;
+  double r = sqrt(-2.0 * log(u));
+  return make_double2(r * sin(v), r * cos(v));
+}
+
+__device__ float normalf(unsigned int x, unsigned int y, int rng_component) {
+  float2 pair = normal_pairf(x, y);
+  return rng_component % 2 == 0 ? pair.x : pair.y;
 }
 
 __device__ double normal(
@@ -112,14 +125,8 @@ __device__ double normal(
     unsigned int y0,
     unsigned int y1,
     int rng_component) {
-  double u = uniform(x0, x1);
-  double v = uniform(y0, y1) * 6.2831853071795860;
-
-  if (rng_component % 2 == 0) {
-    return sqrt(-2.0 * log(u)) * sin(v);
-  } else {
-    return sqrt(-2.0 * log(u)) * cos(v);
-  }
+  double2 pair = normal_pair(x0, x1, y0, y1);
+  return rng_component % 2 == 0 ? pair.x : pair.y;
 }
 
 __device__ double rng_normal_standard(
@@ -155,3 +162,45 @@ __device__ float rng_normal_generalf(
   auto normal01 = rng_normal_standardf(rng_result, rng_component);
   return normal01 * std + mean;
 }
+
+// All the normals of a Philox result, i.e., both normals of each Box-Muller
+// pair. The generated kernels compute them once per Philox call and pick the
+// normal of each element by its rng_component, which gives the same values
+// as rng_normal_standardf and rng_normal_standard.
+__device__ float4 rng_normal_standard4f(const uint4& rng_result) {
+  float2 pair0 = normal_pairf(rng_result.x, rng_result.y);
+  float2 pair1 = normal_pairf(rng_result.z, rng_result.w);
+  return make_float4(pair0.x, pair0.y, pair1.x, pair1.y);
+}
+
+__device__ double2 rng_normal_standard2(const uint4& rng_result) {
+  return normal_pair(rng_result.x, rng_result.y, rng_result.z, rng_result.w);
+}
+
+__device__ float rng_normal_standardf(
+    const float4& rng_normals,
+    int rng_component) {
+  return (&rng_normals.x)[rng_component];
+}
+
+__device__ double rng_normal_standard(
+    const double2& rng_normals,
+    int rng_component) {
+  return (&rng_normals.x)[rng_component % 2];
+}
+
+__device__ float rng_normal_generalf(
+    const float4& rng_normals,
+    int rng_component,
+    float mean,
+    float std) {
+  return rng_normal_standardf(rng_normals, rng_component) * std + mean;
+}
+
+__device__ double rng_normal_general(
+    const double2& rng_normals,
+    int rng_component,
+    double mean,
+    double std) {
+  return rng_normal_standard(rng_normals, rng_component) * std + mean;
+}
@@ -0,0 +1,102 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+
+// Inclusive scans of rows that are split across the threads of TIDx, see
+// [ Scan Scheduler ] in csrc/scheduler/scan.h
+
+namespace scan {
+
+constexpr unsigned int WARP_SIZE = 32;
+
+// Inclusive scan of the values of the lanes of a warp. All the lanes of the
+// warp must call it.
+template <typename T, typename Func>
+__device__ __inline__ T warpInclusiveScan(T value, Func scan_op) {
+  const unsigned int lane_idx = threadIdx.x % WARP_SIZE;
+#pragma unroll
+  for (unsigned int offset = 1; offset < WARP_SIZE; offset *= 2) {
+    T prefix = __shfl_up_sync(0xffffffff, value, offset);
+    if (lane_idx >= offset) {
+      scan_op(prefix, value);
+      value = prefix;
+    }
+  }
+  return value;
+}
+
+// Inclusive scan of the rows of a block, each of blockDim.x * ITEMS
+// elements, where thread x holds elements [x * ITEMS, (x + 1) * ITEMS) of
+// its row in in and out. The rows of threads with different threadIdx.y and
+// threadIdx.z are scanned independently. blockDim.x must be a multiple of
+// the warp size, so no warp holds elements of two rows.
+//
+// Each thread scans its elements serially, then the totals of the threads
+// are scanned with shuffles within each warp, and the totals of the warps
+// through shared_mem, which needs a value per warp of the block. Elements at
+// or after length, and all the elements of threads with a false pred, are
+// treated as init, the identity of scan_op. out is only written if pred.
+template <int ITEMS, bool Aligned, typename T, typename Func>
+__device__ void blockScan(
+    T* out,
+    const T* in,
+    const nvfuser_index_t length,
+    Func scan_op,
+    T* shared_mem,
+    bool pred,
+    T init_val) {
+  static_assert(ITEMS > 0, "Each thread must hold an element of its row");
+
+  // Scan the elements of the thread
+  const nvfuser_index_t thread_offset = (nvfuser_index_t)threadIdx.x * ITEMS;
+  T values[ITEMS];
+  T thread_total = init_val;
+#pragma unroll
+  for (int i = 0; i < ITEMS; ++i) {
+    if (pred && thread_offset + i < length) {
+      scan_op(thread_total, in[i]);
+    }
+    values[i] = thread_total;
+  }
+
+  // Scan the totals of the threads of each warp
+  const T warp_scan = warpInclusiveScan(thread_total, scan_op);
+
+  // Scan the totals of the warps of each row
+  const unsigned int warp_idx = threadIdx.x / WARP_SIZE;
+  const unsigned int lane_idx = threadIdx.x % WARP_SIZE;
+  const unsigned int num_of_warps = blockDim.x / WARP_SIZE;
+  const unsigned int smem_offset =
+      (threadIdx.z * blockDim.y + threadIdx.y) * num_of_warps;
+  if (lane_idx == WARP_SIZE - 1) {
+    shared_mem[smem_offset + warp_idx] = warp_scan;
+  }
+  block_sync::sync<Aligned>();
+
+  // Combine the totals of the preceding warps and lanes
+  T prefix = init_val;
+  for (unsigned int i = 0; i < warp_idx; ++i) {
+    scan_op(prefix, shared_mem[smem_offset + i]);
+  }
+  const T lane_prefix = __shfl_up_sync(0xffffffff, warp_scan, 1);
+  if (lane_idx > 0) {
+    scan_op(prefix, lane_prefix);
+  }
+
+  if (pred) {
+#pragma unroll
+    for (int i = 0; i < ITEMS; ++i) {
+      T result = prefix;
+      scan_op(result, values[i]);
+      out[i] = result;
+    }
+  }
+  // Other warps may still read the totals
+  block_sync::sync<Aligned>();
+}
+
+} // namespace scan
@@ -0,0 +1,73 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+
+// [ Scatter Accumulation ]
+//
+// scatter_add adds each element of src to the element of the output at its
+// index. The output is initialized with a copy of self before the kernel is
+// launched, and each thread adds its elements with an atomic.
+//
+// When many elements have the same index, e.g., the gradients of frequent
+// tokens in an embedding backward, the atomics to the same address are
+// serialized. So the lanes of a warp that add to the same address are first
+// found with __match_any_sync and their values are summed with shuffles, and
+// only the lowest of those lanes issues the atomic. Lanes whose addresses are
+// all different skip the shuffles, so the choice between the two is made per
+// warp from the indices themselves.
+
+namespace scatter {
+
+__device__ __inline__ void atomicAddValue(float* address, const float value) {
+  atomicAdd(address, value);
+}
+
+__device__ __inline__ void atomicAddValue(double* address, const double value) {
+  atomicAdd(address, value);
+}
+
+__device__ __inline__ void atomicAddValue(int* address, const int value) {
+  atomicAdd(address, value);
+}
+
+__device__ __inline__ void atomicAddValue(
+    int64_t* address,
+    const int64_t value) {
+  atomicAdd(
+      reinterpret_cast<unsigned long long*>(address),
+      static_cast<unsigned long long>(value));
+}
+
+template <typename T>
+__device__ void scatterAdd(T* address, const T value) {
+#if __CUDA_ARCH__ >= 700
+  const unsigned int active = __activemask();
+  const unsigned int peers = __match_any_sync(
+      active, reinterpret_cast<unsigned long long>(address));
+  // No other lane adds to this address
+  if ((peers & (peers - 1)) == 0) {
+    atomicAddValue(address, value);
+    return;
+  }
+
+  // All the peers run the same iterations, so each shuffle is only
+  // synchronized among them
+  T sum = 0;
+  for (unsigned int rest = peers; rest != 0; rest &= rest - 1) {
+    sum += __shfl_sync(peers, value, __ffs(rest) - 1);
+  }
+  unsigned int lower_lanes;
+  asm volatile("mov.u32 %0, %%lanemask_lt;" : "=r"(lower_lanes));
+  if ((peers & lower_lanes) == 0) {
+    atomicAddValue(address, sum);
+  }
+#else
+  atomicAddValue(address, value);
+#endif
+}
+
+} // namespace scatter
@@ -0,0 +1,116 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+
+// Sorts of rows that are held by a single thread, see [ Sort Scheduler ] in
+// csrc/scheduler/sort.h
+
+namespace sort {
+
+template <typename T>
+__device__ __inline__ T sortKey(const T x) {
+  return x;
+}
+
+__device__ __inline__ float sortKey(const __half x) {
+  return __half2float(x);
+}
+
+__device__ __inline__ float sortKey(const __bfloat x) {
+  return __bfloat2float(x);
+}
+
+// Whether element a at position a_index goes after element b at position
+// b_index. Positions at or after the length of the row are padding, which
+// goes last. NaNs are larger than any other value, as in PyTorch. Equal
+// elements keep the order of their positions, so the sort is stable.
+template <typename T, bool DESCENDING>
+__device__ __inline__ bool goesAfter(
+    const T a,
+    const int64_t a_index,
+    const T b,
+    const int64_t b_index,
+    const nvfuser_index_t length) {
+  const bool a_padding = a_index >= length;
+  const bool b_padding = b_index >= length;
+  if (a_padding || b_padding) {
+    return a_padding && (!b_padding || a_index > b_index);
+  }
+  const auto a_key = sortKey(a);
+  const auto b_key = sortKey(b);
+  const bool a_nan = a_key != a_key;
+  const bool b_nan = b_key != b_key;
+  if (a_nan || b_nan) {
+    if (a_nan && b_nan) {
+      return a_index > b_index;
+    }
+    return DESCENDING ? b_nan : a_nan;
+  }
+  if (a_key == b_key) {
+    return a_index > b_index;
+  }
+  return DESCENDING ? a_key < b_key : a_key > b_key;
+}
+
+// Sorts the first length elements of in into out_values, and writes their
+// positions in in to out_indices. SIZE is a power of two of at least length,
+// and the elements of the outputs at or after length are padding. The
+// elements are sorted with a bitonic network, which doesn't branch on the
+// data, so the rows stay in registers.
+template <typename T, int SIZE, bool DESCENDING>
+__device__ void threadSort(
+    T* out_values,
+    int64_t* out_indices,
+    const T* in,
+    const nvfuser_index_t length) {
+  static_assert(
+      SIZE > 0 && (SIZE & (SIZE - 1)) == 0,
+      "The size of a sorted row must be a power of two");
+#pragma unroll
+  for (int i = 0; i < SIZE; ++i) {
+    out_values[i] = in[i];
+    out_indices[i] = i;
+  }
+#pragma unroll
+  for (int k = 2; k <= SIZE; k *= 2) {
+#pragma unroll
+    for (int j = k / 2; j > 0; j /= 2) {
+#pragma unroll
+      for (int i = 0; i < SIZE; ++i) {
+        const int l = i ^ j;
+        if (l <= i) {
+          continue;
+        }
+        // Every k elements are sorted in alternating directions, so that
+        // each 2k elements form a bitonic sequence
+        const bool in_order = ((i & k) == 0)
+            ? !goesAfter<T, DESCENDING>(
+                  out_values[i],
+                  out_indices[i],
+                  out_values[l],
+                  out_indices[l],
+                  length)
+            : !goesAfter<T, DESCENDING>(
+                  out_values[l],
+                  out_indices[l],
+                  out_values[i],
+                  out_indices[i],
+                  length);
+        if (!in_order) {
+          const T value = out_values[i];
+          out_values[i] = out_values[l];
+          out_values[l] = value;
+          const int64_t index = out_indices[i];
+          out_indices[i] = out_indices[l];
+          out_indices[l] = index;
+        }
+      }
+    }
+  }
+}
+
+} // namespace sort
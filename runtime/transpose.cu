@@ -0,0 +1,92 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+
+// Transposes of small tiles held in registers by the lanes of a warp, see
+// [ Register Transpose ] in csrc/scheduler/transpose.cpp
+
+namespace transpose {
+
+// __shfl_xor_sync of the bits of value, as it only takes arithmetic types
+template <typename T>
+__device__ __inline__ T shflXorBits(T value, int lane_mask, int width) {
+  static_assert(
+      sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8,
+      "Only types of 1, 2, 4 or 8 bytes can be shuffled");
+  if constexpr (sizeof(T) == 8) {
+    return std::bit_cast<T>(__shfl_xor_sync(
+        0xffffffff,
+        std::bit_cast<unsigned long long>(value),
+        lane_mask,
+        width));
+  } else if constexpr (sizeof(T) == 4) {
+    return std::bit_cast<T>(__shfl_xor_sync(
+        0xffffffff, std::bit_cast<unsigned int>(value), lane_mask, width));
+  } else if constexpr (sizeof(T) == 2) {
+    return std::bit_cast<T>((unsigned short)__shfl_xor_sync(
+        0xffffffff,
+        (unsigned int)std::bit_cast<unsigned short>(value),
+        lane_mask,
+        width));
+  } else {
+    return std::bit_cast<T>((unsigned char)__shfl_xor_sync(
+        0xffffffff,
+        (unsigned int)std::bit_cast<unsigned char>(value),
+        lane_mask,
+        width));
+  }
+}
+
+// Transposes the TILE x TILE tiles held by each group of TILE consecutive
+// lanes of a warp. Lane i of a group holds row i of its tile in in and gets
+// column i in out, i.e., out[j] of lane i is in[i] of lane j.
+//
+// Each of the log2(TILE) butterfly stages exchanges half of the elements of
+// each lane with the lane that differs in a bit, and swaps that bit of the
+// lane with the same bit of the element index, so the registers are only
+// indexed with constants. All the lanes of the warp must call it.
+template <int TILE, typename T>
+__device__ void warpTranspose(T* out, const T* in) {
+  static_assert(
+      TILE > 1 && TILE <= 32 && (TILE & (TILE - 1)) == 0,
+      "The tiles must be of a power of two of at most a warp of lanes");
+  const unsigned int lane = threadIdx.x % TILE;
+
+  T values[TILE];
+#pragma unroll
+  for (int i = 0; i < TILE; ++i) {
+    values[i] = in[i];
+  }
+
+#pragma unroll
+  for (int stage = TILE / 2; stage > 0; stage /= 2) {
+    const bool upper = (lane & stage) != 0;
+#pragma unroll
+    for (int i = 0; i < TILE; ++i) {
+      if ((i & stage) != 0) {
+        continue;
+      }
+      // The lower lane of the pair sends element i + stage and the upper
+      // lane element i, and each replaces the element it sent with the one
+      // it receives
+      T received =
+          shflXorBits(upper ? values[i] : values[i + stage], stage, TILE);
+      if (upper) {
+        values[i] = received;
+      } else {
+        values[i + stage] = received;
+      }
+    }
+  }
+
+#pragma unroll
+  for (int i = 0; i < TILE; ++i) {
+    out[i] = values[i];
+  }
+}
+
+} // namespace transpose
@@ -8,16 +8,21 @@
 namespace warp {
 
 template <typename T>
-__device__ __forceinline__ T shfl_xor(T var, int laneMask, int width = 32) {
-  return __shfl_xor_sync(0xffffffff, var, laneMask, width);
+__device__ __forceinline__ T shfl_xor(
+    T var,
+    int laneMask,
+    int width = 32,
+    unsigned int mask = 0xffffffff) {
+  return __shfl_xor_sync(mask, var, laneMask, width);
 }
 template <typename T>
 __device__ __forceinline__ std::complex<T> shfl_xor(
     std::complex<T> var,
     int laneMask,
-    int width = 32) {
-  T real = __shfl_xor_sync(0xffffffff, var.real(), laneMask, width);
-  T imag = __shfl_xor_sync(0xffffffff, var.imag(), laneMask, width);
+    int width = 32,
+    unsigned int mask = 0xffffffff) {
+  T real = __shfl_xor_sync(mask, var.real(), laneMask, width);
+  T imag = __shfl_xor_sync(mask, var.imag(), laneMask, width);
   return std::complex<T>(real, imag);
 }
 
@@ -88,4 +93,41 @@ __device__ void warpReduceTIDX(
   }
 }
 
+// Reduces over TIDx when blockDim.x is SEGMENT_SIZE, a power of two smaller
+// than a warp. The threads with the same threadIdx.y and threadIdx.z are
+// then a segment of consecutive lanes of a warp, so each segment is reduced
+// with shuffles only. Only the lanes of the segment are synchronized, as the
+// last warp of the block may be partial.
+template <int SEGMENT_SIZE, typename T, typename Func>
+__device__ void warpSegmentReduceTIDX(
+    T& out,
+    const T& inp_val,
+    Func reduction_op,
+    bool read_write_pred,
+    T init_val) {
+  constexpr int WARP_SIZE = 32;
+  static_assert(
+      SEGMENT_SIZE > 1 && SEGMENT_SIZE < WARP_SIZE &&
+          (SEGMENT_SIZE & (SEGMENT_SIZE - 1)) == 0,
+      "Segment size must be a power of two smaller than a warp");
+
+  T reduce_val = init_val;
+  if (read_write_pred) {
+    reduce_val = inp_val;
+  }
+
+  const unsigned int lane_idx =
+      (threadIdx.x + blockDim.x * (threadIdx.y + blockDim.y * threadIdx.z)) %
+      WARP_SIZE;
+  const unsigned int segment_mask = ((1u << SEGMENT_SIZE) - 1u)
+      << (lane_idx & ~(SEGMENT_SIZE - 1u));
+
+  for (int i = SEGMENT_SIZE / 2; i >= 1; i /= 2) {
+    reduction_op(
+        reduce_val, shfl_xor(reduce_val, i, SEGMENT_SIZE, segment_mask));
+  }
+
+  reduction_op(out, reduce_val);
+}
+
 } // namespace warp
@@ -106,8 +106,29 @@ __inline__ __device__ void welfordVectorized(
   a_N = ab_N;
 }
 
+// Reduces the Welford states of the lanes of a warp. Each element of the
+// state is moved with one shuffle per step, and all lanes end up with the
+// result. Must be called by all lanes of the warp.
+template <typename T, typename TN>
+__inline__ __device__ void warpWelford(T& avg, T& M2, TN& N) {
+  constexpr int WARP_SIZE = 32;
+  for (int i = WARP_SIZE / 2; i >= 1; i /= 2) {
+    const T peer_avg = __shfl_xor_sync(0xffffffff, avg, i, WARP_SIZE);
+    const T peer_M2 = __shfl_xor_sync(0xffffffff, M2, i, WARP_SIZE);
+    const TN peer_N = __shfl_xor_sync(0xffffffff, N, i, WARP_SIZE);
+    welfordCombine(avg, M2, N, peer_avg, peer_M2, peer_N);
+  }
+}
+
 // [Z,Y,X]_THREADS is the number of participating threads in the z, y, x
 // dimension of the block.
+//
+// When the reduction segments are made of whole warps, i.e., the reduced
+// dimensions are the innermost ones and the segment size is a multiple of
+// the warp size, each warp is first reduced with shuffles and only the
+// results of the warps go through shared memory. This needs two block
+// syncs instead of one per step of the tree reduction. Shuffles need all
+// lanes of a warp, so this is only done when the call is aligned.
 template <
     bool X_REDUCE,
     bool Y_REDUCE,
@@ -146,6 +167,52 @@ __inline__ __device__ void blockWelford(
       index_utils::maskedOffset<!X_REDUCE, !Y_REDUCE, !Z_REDUCE>(
           threadIdx, blockDim);
 
+  constexpr int WARP_SIZE = 32;
+  constexpr bool innermost_reduction = X_REDUCE && (Y_REDUCE || !Z_REDUCE);
+  if (Aligned && innermost_reduction && reduction_size % WARP_SIZE == 0) {
+    T warp_avg = init_val;
+    T warp_M2 = init_val;
+    TN warp_N = 0;
+    if (read_pred) {
+      warp_avg = in_avg;
+      warp_M2 = in_M2;
+      warp_N = in_N;
+    }
+    warpWelford(warp_avg, warp_M2, warp_N);
+
+    const unsigned int warp_idx = reduction_tid / WARP_SIZE;
+    const unsigned int lane_idx = reduction_tid % WARP_SIZE;
+    const unsigned int num_warps = reduction_size / WARP_SIZE;
+    const unsigned int warp_smem_offset = reduction_idx * num_warps;
+
+    block_sync::sync<Aligned>();
+    if (lane_idx == 0) {
+      shared_mem_avg[warp_smem_offset + warp_idx] = warp_avg;
+      shared_mem_M2[warp_smem_offset + warp_idx] = warp_M2;
+      shared_mem_N[warp_smem_offset + warp_idx] = warp_N;
+    }
+    block_sync::sync<Aligned>();
+
+    // The first warp of each segment reduces the results of the warps
+    if (warp_idx == 0) {
+      if (lane_idx < num_warps) {
+        warp_avg = shared_mem_avg[warp_smem_offset + lane_idx];
+        warp_M2 = shared_mem_M2[warp_smem_offset + lane_idx];
+        warp_N = shared_mem_N[warp_smem_offset + lane_idx];
+      } else {
+        warp_avg = init_val;
+        warp_M2 = init_val;
+        warp_N = 0;
+      }
+      warpWelford(warp_avg, warp_M2, warp_N);
+      if (should_write && write_pred) {
+        welfordCombine(out_avg, out_M2, out_N, warp_avg, warp_M2, warp_N);
+      }
+    }
+    block_sync::sync<Aligned>();
+    return;
+  }
+
   // Offset into smem for the current thread
   unsigned int smem_offset = reduction_idx * reduction_size + reduction_tid;
 
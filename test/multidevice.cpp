@@ -285,7 +285,8 @@ void executeAndValidatePipeline(
     Pipeline& pipeline,
     std::vector<c10::IValue>& inputs,
     Communicator* communicator,
-    bool print) {
+    bool print,
+    int64_t num_micro_batches) {
   if (print && !communicator->deviceId()) {
     fusion_ptr->printKernel();
     std::cout << pipeline.toString() << std::endl;
@@ -297,7 +298,7 @@ void executeAndValidatePipeline(
     GTEST_SKIP() << error_msg;
   }
 
-  auto outputs = runtime.runWithInput(inputs);
+  auto outputs = runtime.runWithInput(inputs, num_micro_batches);
 
   if (print) {
     std::stringstream ss;
@@ -324,7 +325,12 @@ void PipelineTest::SetUp() {
 
 void PipelineTest::validate() {
   executeAndValidatePipeline(
-      std::move(fusion), *pipeline, inputs, communicator, debug_print);
+      std::move(fusion),
+      *pipeline,
+      inputs,
+      communicator,
+      debug_print,
+      num_micro_batches);
 }
 
 } // namespace nvfuser
@@ -72,6 +72,7 @@ class PipelineTest : public MultiDeviceTest {
   std::unique_ptr<Pipeline> pipeline;
   std::unique_ptr<Fusion> fusion;
   std::vector<c10::IValue> inputs;
+  int64_t num_micro_batches = 1;
 };
 
 } // namespace nvfuser
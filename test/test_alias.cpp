@@ -996,6 +996,50 @@ TEST_F(AliasTest, Squeeze) {
   EXPECT_EQ(out_tensor.data_ptr(), in_tensor.data_ptr());
 }
 
+TEST_F(AliasTest, Expand) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  TensorView* in = makeContigConcreteTensor({-1, 1});
+  TensorView* out = expand(
+      in,
+      {in->axis(0)->extent(),
+       IrBuilder::create<Val>(5L, DataType::Index)});
+  fusion->addInput(in);
+  fusion->addOutput(out);
+
+  FusionExecutorCache fec(std::move(fusion));
+  at::Tensor in_tensor = at::randn({2, 1}).cuda();
+  at::Tensor out_tensor = fec.runFusionWithInputs({in_tensor})[0];
+  testValidate(fec.fusion(), {out_tensor}, {in_tensor}, __LINE__, __FILE__);
+
+  EXPECT_TRUE(out_tensor.is_alias_of(in_tensor));
+  EXPECT_EQ(out_tensor.stride(1), 0);
+}
+
+TEST_F(AliasTest, ExpandComputedTensor) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  TensorView* in = makeContigTensor(1);
+  TensorView* mask = gt(in, IrBuilder::create<Val>(0.0));
+  TensorView* out = expand(
+      broadcast(mask, {false, true}),
+      {in->axis(0)->extent(),
+       IrBuilder::create<Val>(1024L, DataType::Index)});
+  fusion->addInput(in);
+  fusion->addOutput(out);
+
+  FusionExecutorCache fec(std::move(fusion));
+  at::Tensor in_tensor = at::randn({16}).cuda();
+  at::Tensor out_tensor = fec.runFusionWithInputs({in_tensor})[0];
+  testValidate(fec.fusion(), {out_tensor}, {in_tensor}, __LINE__, __FILE__);
+
+  // Only the unique data is stored.
+  EXPECT_EQ(out_tensor.stride(1), 0);
+  EXPECT_EQ(out_tensor.storage().nbytes(), 16 * sizeof(bool));
+}
+
 TEST_F(AliasTest, SourceIsBothInputAndOutput) {
   auto fusion = std::make_unique<Fusion>();
   FusionGuard fg(fusion.get());
@@ -1044,6 +1088,135 @@ TEST_F(AliasTest, SegmentBoundary) {
       UnorderedElementsAre(
           HeuristicIs(ScheduleHeuristic::NoOp),
           HeuristicIs(ScheduleHeuristic::PointWise)));
+
+  // The NoOp segment computes its output on the host, so it has no kernel to
+  // launch.
+  for (SegmentedGroup* group : runtime->fusionSegments()->groups()) {
+    if (group->heuristic() == ScheduleHeuristic::NoOp) {
+      const FusionExecutor& executor =
+          runtime->executors().at(group->groupId());
+      EXPECT_TRUE(executor.kernel()->topLevelExprs().empty());
+    }
+  }
+}
+
+TEST_F(AliasAnalysisTest, InplaceUpdate_Pointwise) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  TensorView* param = makeContigTensor(2);
+  TensorView* grad = makeContigTensor(2);
+  fusion.addInput(param);
+  fusion.addInput(grad);
+  TensorView* out = sub(param, mul(grad, IrBuilder::create<Val>(0.1)));
+  fusion.addOutput(out);
+
+  EXPECT_NO_THROW(validateInplaceUpdate(out, param, fusion.exprs()));
+}
+
+TEST_F(AliasAnalysisTest, InplaceUpdate_ReduceBroadcastAxis) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  // Like the running stats of instance norm
+  TensorView* running_mean = makeContigTensor(1);
+  TensorView* mean = makeContigTensor(2);
+  fusion.addInput(running_mean);
+  fusion.addInput(mean);
+  TensorView* out = sum(add(broadcast(running_mean, {true, false}), mean), {0});
+  fusion.addOutput(out);
+
+  EXPECT_NO_THROW(validateInplaceUpdate(out, running_mean, fusion.exprs()));
+}
+
+TEST_F(AliasAnalysisTest, InplaceUpdate_Transpose) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  TensorView* in = makeContigConcreteTensor({3, 3});
+  fusion.addInput(in);
+  TensorView* out = add(transpose(in, 0, 1), in);
+  fusion.addOutput(out);
+
+  EXPECT_THAT(
+      [&]() { validateInplaceUpdate(out, in, fusion.exprs()); },
+      testing::ThrowsMessage<nvfuser::nvfError>(
+          testing::HasSubstr("reorders")));
+}
+
+TEST_F(AliasAnalysisTest, InplaceUpdate_Reduction) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  TensorView* in = makeContigTensor(2);
+  fusion.addInput(in);
+  TensorView* out = sub(in, broadcast(sum(in, {1}), {false, true}));
+  fusion.addOutput(out);
+
+  EXPECT_THAT(
+      [&]() { validateInplaceUpdate(out, in, fusion.exprs()); },
+      testing::ThrowsMessage<nvfuser::nvfError>(
+          testing::HasSubstr("reduces")));
+}
+
+TEST_F(AliasAnalysisTest, InplaceUpdate_StoredBroadcast) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  TensorView* in = makeContigTensor(1);
+  TensorView* other = makeContigTensor(2);
+  fusion.addInput(in);
+  fusion.addInput(other);
+  TensorView* out = add(in, IrBuilder::create<Val>(1.0));
+  TensorView* other_out = mul(broadcast(in, {true, false}), other);
+  fusion.addOutput(out);
+  fusion.addOutput(other_out);
+
+  EXPECT_THAT(
+      [&]() { validateInplaceUpdate(out, in, fusion.exprs()); },
+      testing::ThrowsMessage<nvfuser::nvfError>(
+          testing::HasSubstr("along the broadcast axis")));
+}
+
+TEST_F(AliasTest, InplaceUpdate) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  TensorView* param = makeContigTensor(2);
+  TensorView* grad = makeContigTensor(2);
+  fusion->addInput(param);
+  fusion->addInput(grad);
+  TensorView* out = sub(param, mul(grad, IrBuilder::create<Val>(0.1)));
+  fusion->addOutput(out);
+  fusion->aliasOutputToInput(out, param, AliasType::InplaceUpdate);
+
+  FusionExecutorCache fec(std::move(fusion));
+  at::Tensor param_tensor = at::randn({128, 64}).cuda();
+  at::Tensor grad_tensor = at::randn({128, 64}).cuda();
+  at::Tensor expected_out = param_tensor - grad_tensor * 0.1;
+  at::Tensor out_tensor =
+      fec.runFusionWithInputs({param_tensor, grad_tensor})[0];
+
+  EXPECT_EQ(out_tensor.data_ptr(), param_tensor.data_ptr());
+  EXPECT_TRUE(at::allclose(param_tensor, expected_out));
+}
+
+TEST_F(AliasTest, InplaceUpdate_Transpose) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  TensorView* in = makeContigConcreteTensor({64, 64});
+  fusion->addInput(in);
+  TensorView* out = add(transpose(in, 0, 1), in);
+  fusion->addOutput(out);
+  fusion->aliasOutputToInput(out, in, AliasType::InplaceUpdate);
+
+  FusionExecutorCache fec(std::move(fusion));
+  at::Tensor in_tensor = at::randn({64, 64}).cuda();
+  EXPECT_THAT(
+      [&]() { fec.runFusionWithInputs({in_tensor}); },
+      testing::ThrowsMessage<nvfuser::nvfError>(
+          testing::HasSubstr("in place")));
 }
 
 } // namespace nvfuser
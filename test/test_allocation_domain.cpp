@@ -9,6 +9,7 @@
 #include <gtest/gtest.h>
 
 #include <executor.h>
+#include <kernel_cache.h>
 #include <ir/all_nodes.h>
 #include <ir/builder.h>
 #include <ops/all_ops.h>
@@ -1333,4 +1334,41 @@ TEST_F(AllocationDomainTest, Issue1524) {
   fec.runFusionWithInputs({in_tensor});
 }
 
+// The outputs of pointwise ops of a channels-last input are channels last
+TEST_F(AllocationDomainTest, InferAllocationOrder) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(
+      EnableOption::AllocationOrderInference);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  TensorView* in = TensorViewBuilder()
+                       .ndims(4)
+                       .contiguity(true)
+                       .strideOrder({3, 0, 2, 1})
+                       .build();
+  TensorView* bias = makeContigTensor(1);
+  fusion->addInput(in);
+  fusion->addInput(bias);
+  TensorView* out = relu(add(in, broadcast(bias, {true, false, true, true})));
+  fusion->addOutput(out);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor in_tensor = at::randn({2, 8, 4, 4}, options)
+                             .contiguous(at::MemoryFormat::ChannelsLast);
+  at::Tensor bias_tensor = at::randn({8}, options);
+  FusionExecutorCache fec(std::move(fusion));
+  std::vector<at::Tensor> outputs =
+      fec.runFusionWithInputs({in_tensor, bias_tensor});
+
+  EXPECT_TRUE(outputs[0].is_contiguous(at::MemoryFormat::ChannelsLast));
+  testValidate(
+      fec.fusion(),
+      outputs,
+      {in_tensor, bias_tensor},
+      __LINE__,
+      __FILE__);
+}
+
 } // namespace nvfuser
@@ -1061,4 +1061,95 @@ TEST_F(NVFuserTest, CombinedSchedulerInnerOuterMismatch) {
   test({0});
 }
 
+// Broadcast domains are skipped when matching the inner and outer reductions.
+// inner reduction is [I, B, R] and outer reduction is [R, B, I], so both are
+// computed in one kernel that reads the input once.
+TEST_F(NVFuserTest, CombinedSchedulerBroadcastDomain) {
+  std::unique_ptr<Fusion> fusion_ptr = std::make_unique<Fusion>();
+  Fusion& fusion = *fusion_ptr.get();
+  FusionGuard fg(&fusion);
+
+  const int64_t x = 1024, z = 2048;
+  auto tv0 = makeContigConcreteTensor({-1, 1, -1});
+  fusion.addInput(tv0);
+  auto tv1 = sum(tv0, {-1});
+  auto tv2 = broadcast(tv1, {false, false, true});
+  auto tv3 = add(tv2, tv0);
+  auto tv4 = sum(tv0, {0});
+  fusion.addOutput(tv3);
+  fusion.addOutput(tv4);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({x, 1, z}, options);
+  std::vector<c10::IValue> aten_inputs = {t0};
+
+  FusionExecutorCache fec(std::move(fusion_ptr));
+  auto cg_outputs = fec.runFusionWithInputs(aten_inputs);
+
+  auto runtime = fec.getMostRecentKernelRuntime();
+  ASSERT_FALSE(runtime->isSegmented());
+  EXPECT_EQ(
+      runtime->schedulerHeuristics()->heuristicsList().at(0)->heuristic(),
+      ScheduleHeuristic::InnerOuterPersistent);
+
+  auto t3 = t0 + t0.sum({-1}).unsqueeze(-1);
+  auto t4 = t0.sum({0});
+  testValidate(&fusion, cg_outputs, aten_inputs, {t3, t4}, __LINE__, __FILE__);
+}
+
+
+// Test that the persistent batch chosen with register pressure feedback is
+// never larger than the one chosen by the heuristic alone, and that the
+// resulting kernel is correct. See [ Register Pressure Feedback ].
+TEST_F(NVFuserTest, CombinedSchedulerRegisterPressureFeedback) {
+  std::unique_ptr<Fusion> fusion_ptr = std::make_unique<Fusion>();
+  Fusion& fusion = *fusion_ptr.get();
+  FusionGuard fg(&fusion);
+
+  const int64_t x = 1024, y = 8192;
+  auto tv0 = makeContigTensor(2);
+  auto tv1 = makeContigTensor(1);
+  fusion.addInput(tv0);
+  fusion.addInput(tv1);
+  auto tv2 = mul(tv0, broadcast(tv1, {true, false}));
+  auto tv3 = sum(tv2, {1});
+  auto tv4 = sub(tv2, broadcast(tv3, {false, true}));
+  auto tv5 = sum(tv0, {0});
+  fusion.addOutput(tv4);
+  fusion.addOutput(tv5);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({x, y}, options);
+  at::Tensor t1 = at::randn({y}, options);
+  std::vector<c10::IValue> aten_inputs = {t0, t1};
+
+  auto heuristic_rparams =
+      getInnerOuterPersistentHeuristics(&fusion, aten_inputs);
+  ASSERT_NE(heuristic_rparams, nullptr);
+  EXPECT_GT(
+      estimateInnerOuterRegisterUsage(&fusion, *heuristic_rparams),
+      scheduler_utils::register_overhead);
+
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(
+      EnableOption::RegisterPressureFeedback);
+
+  FusionExecutorCache fec(std::move(fusion_ptr));
+  auto cg_outputs = fec.runFusionWithInputs(aten_inputs);
+
+  auto runtime = fec.getMostRecentKernelRuntime();
+  ASSERT_FALSE(runtime->isSegmented());
+  const auto& heuristic =
+      runtime->schedulerHeuristics()->heuristicsList().at(0);
+  ASSERT_EQ(heuristic->heuristic(), ScheduleHeuristic::InnerOuterPersistent);
+  EXPECT_LE(
+      heuristic->reductionParams().batches_per_block_inner_reduction,
+      heuristic_rparams->batches_per_block_inner_reduction);
+
+  auto t2 = t0 * t1.unsqueeze(0);
+  auto t4 = t2 - t2.sum({1}).unsqueeze(-1);
+  auto t5 = t0.sum({0});
+  testValidate(&fusion, cg_outputs, aten_inputs, {t4, t5}, __LINE__, __FILE__);
+}
+
 } // namespace nvfuser
@@ -657,6 +657,56 @@ TEST_F(NVFuserTest, DynamicTransform11_CUDA) {
       info2.toString());
 }
 
+// Concretization infos with the same decisions have the same signature, and
+// FusionExecutorCache reuses them for inputs with the same root dynamic values
+TEST_F(NVFuserTest, DynamicTransformSignature_CUDA) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+  auto s0 = IrBuilder::create<Val>(DataType::Int);
+  fusion->addInput(s0);
+  auto s1 = IrBuilder::create<Val>(DataType::Int);
+  fusion->addInput(s1);
+
+  auto tv1 = reshape(tv0, {s0, s1});
+  auto tv2 = reshape(tv1, {mul(s0, s1)});
+  fusion->addOutput(tv2);
+
+  auto initial_info = DynamicTransform::getInitialInfo(fusion.get());
+  ASSERT_TRUE(initial_info.getRootDynamicValPositions().has_value());
+
+  auto makeInfo = [&](int64_t x0, int64_t x1, int64_t y0, int64_t y1) {
+    ExpressionEvaluator expr_eval;
+    expr_eval.bind(tv0->axis(0)->extent(), x0);
+    expr_eval.bind(tv0->axis(1)->extent(), x1);
+    expr_eval.bind(s0, y0);
+    expr_eval.bind(s1, y1);
+    return DynamicTransformConcretizationInfo(&initial_info, &expr_eval);
+  };
+  auto info1 = makeInfo(4, 3, 2, 6);
+  auto info2 = makeInfo(4, 3, 2, 6);
+  auto info3 = makeInfo(4, 3, 6, 2);
+  EXPECT_EQ(info1.signature(), info2.signature());
+  EXPECT_EQ(info1.hash(), info2.hash());
+  EXPECT_EQ(info1, info2);
+  EXPECT_NE(info1.signature(), info3.signature());
+  EXPECT_FALSE(info1 == info3);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({4, 3}, options);
+  at::Tensor t0_transposed = at::randn({3, 4}, options).t();
+  for (const at::Tensor& t : {t0, t0_transposed, t0}) {
+    std::vector<c10::IValue> inputs = {t, 2L, 6L};
+    auto cg_outputs = executor_cache.runFusionWithInputs(inputs);
+    testValidate(
+        executor_cache.fusion(), cg_outputs, inputs, __LINE__, __FILE__);
+  }
+  EXPECT_EQ(executor_cache.countConcretizations(), 1);
+}
+
 // Test FusionExecutorCache with dynamic reshapes
 TEST_F(NVFuserTest, DynamicTransformFusionExecutorCache_CUDA) {
   auto fusion = std::make_unique<Fusion>();
@@ -734,6 +784,78 @@ TEST_F(NVFuserTest, DynamicTransformFusionExecutorCache_CUDA) {
   }
 }
 
+TEST_F(NVFuserTest, DynamicTransformEvaluateSignatures_CUDA) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+  auto s0 = IrBuilder::create<Val>(DataType::Int);
+  fusion->addInput(s0);
+  auto s1 = IrBuilder::create<Val>(DataType::Int);
+  fusion->addInput(s1);
+
+  auto tv1 = reshape(tv0, {s0, s1});
+  auto tv2 = sum(tv1, {1});
+  fusion->addOutput(tv1);
+  fusion->addOutput(tv2);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+
+  auto signature = [](int64_t n0, int64_t n1, int64_t r0, int64_t r1) {
+    return std::vector<InputDescriptor>{
+        InputDescriptor::tensor({n0, n1}, at::kFloat),
+        InputDescriptor::scalar(r0),
+        InputDescriptor::scalar(r1)};
+  };
+  auto evaluations = executor_cache.evaluateSignatures(
+      {signature(3, 4, 3, 4),
+       signature(3, 4, 4, 3),
+       signature(2, 6, 4, 3),
+       signature(1024, 1024, 512, 2048)});
+  ASSERT_EQ(evaluations.size(), 4);
+
+  EXPECT_THAT(
+      evaluations.at(1).output_sizes,
+      testing::ElementsAre(
+          std::vector<int64_t>{4, 3}, std::vector<int64_t>{4}));
+  EXPECT_THAT(
+      evaluations.at(3).output_sizes,
+      testing::ElementsAre(
+          std::vector<int64_t>{512, 2048}, std::vector<int64_t>{512}));
+
+  // Trivial and non-trivial reshapes are concretized differently, and the
+  // same non-trivial reshape is concretized once
+  EXPECT_NE(evaluations.at(0).concrete_id, evaluations.at(1).concrete_id);
+  EXPECT_EQ(evaluations.at(1).concrete_id, evaluations.at(2).concrete_id);
+  EXPECT_EQ(executor_cache.countConcretizations(), 2);
+
+  for (const auto& evaluation : evaluations) {
+    ASSERT_FALSE(evaluation.heuristics.empty());
+    EXPECT_EQ(evaluation.heuristics.size(), evaluation.params.size());
+    EXPECT_GT(evaluation.peak_memory, 0);
+  }
+  EXPECT_GT(evaluations.at(3).peak_memory, evaluations.at(1).peak_memory);
+
+  // Nothing was compiled, and a real input of an evaluated signature runs
+  // with the runtime created for it
+  const auto num_runtimes = executor_cache.countRuntimes();
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn({3, 4}, options);
+  std::vector<c10::IValue> inputs = {t0, 4L, 3L};
+  EXPECT_FALSE(executor_cache.isCompiled(inputs));
+  auto cg_outputs = executor_cache.runFusionWithInputs(inputs);
+  EXPECT_EQ(executor_cache.countRuntimes(), num_runtimes);
+  auto t1 = t0.reshape({4, 3});
+  testValidate(
+      executor_cache.fusion(),
+      cg_outputs,
+      inputs,
+      {t1, t1.sum({1})},
+      __LINE__,
+      __FILE__);
+}
+
 using shape_t = std::vector<int64_t>;
 using dynamic_view_invocation = std::tuple<
     shape_t, // input_shape
@@ -12,6 +12,7 @@
 
 #include <test/utils.h>
 
+#include <executor_kernel_arg.h>
 #include <expr_evaluator.h>
 #include <fusion.h>
 #include <ops/all_ops.h>
@@ -539,6 +540,51 @@ TEST_F(ExprEvalTest, TernaryOps) {
   }
 }
 
+// Integer extents are evaluated on registers, including the ones computed
+// from a double
+TEST_F(ExprEvalTest, PrecomputedValuesOnRegisters) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  TensorView* tv0 = makeSymbolicTensor(2);
+  auto* factor = IrBuilder::create<Val>(DataType::Int);
+  auto* scale = IrBuilder::create<Val>(DataType::Double);
+  fusion.addInput(tv0);
+  fusion.addInput(factor);
+  fusion.addInput(scale);
+  TensorView* tv1 = mul(tv0, scale);
+  fusion.addOutput(tv1);
+
+  tv1->merge(0);
+  auto* max_factor = IrBuilder::create<Val>(8L);
+  tv1->split(0, where(lt(factor, max_factor), factor, max_factor));
+  tv1->split(
+      0,
+      castOp(DataType::Index, mul(scale, IrBuilder::create<Val>(2.0))),
+      /*inner_split=*/false);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({5, 7}, options);
+  KernelArgumentHolder args =
+      KernelArgumentHolder::createKernelArgumentHolder({t0, 3L, 2.0});
+
+  PrecomputedValues pv(&fusion);
+  // Run twice to check that the registers are reloaded
+  for ([[maybe_unused]] auto i : c10::irange(2)) {
+    pv.bindInputs(args);
+    pv.evaluate();
+
+    // [35] -> [12, 3] -> [4, 3, 3]
+    std::vector<int64_t> extents;
+    for (IterDomain* id : tv1->getLeafDomain()) {
+      const PolymorphicValue& extent = pv.getMaybeValueFor(id->extent());
+      ASSERT_TRUE(extent.is<int64_t>());
+      extents.push_back(extent.as<int64_t>());
+    }
+    EXPECT_THAT(extents, ElementsAre(4, 3, 3));
+  }
+}
+
 TEST_F(ExprEvalTest, Permute) {
   Fusion fusion;
   FusionGuard fg(&fusion);
@@ -1117,4 +1117,20 @@ TEST_F(ExprSimplifierTest, FactorizeGcd) {
       simplifyExpr("gcd( i1 * i2 , i2 )"_, {}, {"i2 >= 0"_})->sameAs("i2"_));
 }
 
+TEST_F(ExprSimplifierTest, UpperBound) {
+  EXPECT_EQ(getUpperBound("3"_), 3);
+  EXPECT_EQ(getUpperBound("( threadIdx.x * 4 ) + 3"_), 1023 * 4 + 3);
+  EXPECT_EQ(getUpperBound("threadIdx.z % 8"_), 7);
+  EXPECT_EQ(getUpperBound("( threadIdx.y / 32 ) * 2"_), 62);
+  EXPECT_FALSE(getUpperBound("blockIdx.x * 4"_).has_value());
+  EXPECT_FALSE(getUpperBound("threadIdx.x - 1"_).has_value());
+  EXPECT_FALSE(getUpperBound("-1"_).has_value());
+
+  auto i1 = "i1"_;
+  EXPECT_FALSE(getUpperBound(i1).has_value());
+  auto index = IrBuilder::addExpr(
+      IrBuilder::mulExpr(i1, "128"_), "threadIdx.x"_);
+  EXPECT_EQ(getUpperBound(index, {{i1, 7}}), 7 * 128 + 1023);
+}
+
 } // namespace nvfuser
@@ -95,6 +95,86 @@ TEST_F(FusionProfilerTest, Profile1Segment) {
   EXPECT_FALSE(sprof.device_name.empty());
 }
 
+// Hardware metrics of the kernel with NVFUSER_PROF=metrics
+TEST_F(FusionProfilerTest, ProfileMetrics1Segment) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  ProfilerOptionsGuard::getCurOptions().set(ProfilerOption::Metrics);
+
+  TensorView* tv0 = makeContigTensor(2);
+  TensorView* tv1 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  fusion->addInput(tv1);
+  fusion->addOutput(add(tv0, tv1));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({1024, 1024}, options);
+  at::Tensor t1 = at::randn({1024, 1024}, options);
+  FusionExecutorCache executor_cache(std::move(fusion));
+  executor_cache.runFusionWithInputs({t0, t1});
+
+  const FusionProfile& fprof = FusionProfiler::profile();
+  ASSERT_EQ(fprof.kernel_profiles.size(), 1);
+  const KernelProfile& kprof = fprof.kernel_profiles.at(0);
+  if (!kprof.metrics.has_value()) {
+    GTEST_SKIP() << "The CUPTI Range Profiler is not available";
+  }
+  const KernelMetrics& metrics = kprof.metrics.value();
+  EXPECT_GT(metrics.dram_throughput_pct, 0.0);
+  EXPECT_LE(metrics.dram_throughput_pct, 100.0);
+  EXPECT_GT(metrics.achieved_occupancy_pct, 0.0);
+  EXPECT_LE(metrics.l2_hit_rate_pct, 100.0);
+  // The pointwise kernel doesn't use shared memory
+  EXPECT_EQ(metrics.smem_bank_conflicts, 0.0);
+  // Each input element is read once, so the caches can only reduce the DRAM
+  // reads below the modeled loads
+  EXPECT_GE(metrics.dram_read_bytes, 0.0);
+  EXPECT_LE(metrics.dram_read_bytes, 1.1 * (double)kprof.modeled_load_bytes);
+}
+
+// The modeled global memory traffic of a kernel, see [ Memory Traffic Model ]
+TEST_F(FusionProfilerTest, ProfileModeledTraffic) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  ProfilerOptionsGuard::getCurOptions().set(ProfilerOption::Enable);
+
+  // tv1 is broadcast along the outer dimension, so each of its elements is
+  // read once per row
+  TensorView* tv0 = makeContigTensor(2);
+  TensorView* tv1 = makeContigTensor(1);
+  fusion->addInput(tv0);
+  fusion->addInput(tv1);
+  fusion->addOutput(add(tv0, broadcast(tv1, {true, false})));
+
+  constexpr int64_t kRows = 1024;
+  constexpr int64_t kCols = 1024;
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({kRows, kCols}, options);
+  at::Tensor t1 = at::randn({kCols}, options);
+  FusionExecutorCache executor_cache(std::move(fusion));
+  executor_cache.runFusionWithInputs({t0, t1});
+
+  const FusionProfile& fprof = FusionProfiler::profile();
+  ASSERT_EQ(fprof.kernel_profiles.size(), 1);
+  const KernelProfile& kprof = fprof.kernel_profiles.at(0);
+  EXPECT_EQ(kprof.input_bytes, (kRows * kCols + kCols) * 4);
+  // Bounded by a read of tv1 per output element
+  EXPECT_GT(kprof.modeled_load_bytes, kprof.input_bytes);
+  EXPECT_LE(kprof.modeled_load_bytes, 2 * kRows * kCols * 4);
+  EXPECT_EQ(kprof.modeled_store_bytes, kRows * kCols * 4);
+
+  const FusionExecutor& fe = executor_cache.getMostRecentKernelRuntime()
+                                 ->executors()
+                                 .front();
+  KernelArgumentHolder args =
+      KernelArgumentHolder::createKernelArgumentHolder({t0, t1});
+  const MemoryTrafficEstimate traffic = fe.estimateMemoryTraffic(args);
+  EXPECT_TRUE(traffic.complete);
+  EXPECT_EQ(traffic.load_bytes, kprof.modeled_load_bytes);
+  EXPECT_EQ(traffic.unique_load_bytes, kprof.input_bytes);
+  EXPECT_EQ(traffic.unique_store_bytes, kRows * kCols * 4);
+}
+
 TEST_F(FusionProfilerTest, ProfileNocupti1Segment) {
   try {
     auto fusion = std::make_unique<Fusion>();
@@ -133,6 +213,22 @@ TEST_F(FusionProfilerTest, ProfileNocupti1Segment) {
   EXPECT_EQ(fprof.effective_bandwidth_gbs, 0.0);
   EXPECT_EQ(fprof.percentage_peak_bandwidth, 0.0);
   EXPECT_TRUE(fprof.kernel_profiles.empty());
+
+  // Host time is split into phases without CUPTI as well
+  EXPECT_GT(fprof.input_encoding_time_ms, 0.0);
+  EXPECT_GT(fprof.runtime_lookup_time_ms, 0.0);
+  ASSERT_EQ(fprof.segment_host_profiles.size(), 1);
+  const auto& hprof = fprof.segment_host_profiles.at(0);
+  EXPECT_GT(hprof.host_time_ms, 0.0);
+  EXPECT_GT(hprof.executor_entry_lookup_time_ms, 0.0);
+  EXPECT_GT(hprof.argument_binding_time_ms, 0.0);
+  EXPECT_GT(hprof.allocation_time_ms, 0.0);
+  EXPECT_GT(hprof.kernel_launch_time_ms, 0.0);
+  EXPECT_LE(
+      hprof.executor_entry_lookup_time_ms + hprof.argument_binding_time_ms +
+          hprof.allocation_time_ms + hprof.kernel_launch_time_ms,
+      hprof.host_time_ms);
+  EXPECT_EQ(fprof.segment_host_time_ms, hprof.host_time_ms);
 }
 
 TEST_F(FusionProfilerTest, Profile3Segments) {
@@ -185,6 +281,11 @@ TEST_F(FusionProfilerTest, Profile3Segments) {
   EXPECT_EQ(fprof.output_bytes, int64_t((11 + 13 + 17) * 4));
   EXPECT_GT(fprof.effective_bandwidth_gbs, 0.0);
   EXPECT_GT(fprof.percentage_peak_bandwidth, 0.0);
+  EXPECT_EQ(fprof.segment_host_profiles.size(), 3);
+  for (const auto& hprof : fprof.segment_host_profiles) {
+    EXPECT_GT(hprof.host_time_ms, 0.0);
+    EXPECT_GT(hprof.kernel_launch_time_ms, 0.0);
+  }
 }
 
 TEST_F(FusionProfilerTest, FusionProfilerErrorChecks) {
@@ -226,4 +327,43 @@ TEST_F(FusionProfilerTest, FusionProfilerErrorChecks) {
   }
 }
 
+// Telemetry counts every run and samples the kernel time of every Nth run
+// without synchronizing
+TEST_F(NVFuserTest, FusionTelemetry_CUDA) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::Telemetry, {"2"});
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  TensorView* tv0 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  fusion->addOutput(sum(add(tv0, tv0), {1}));
+
+  FusionExecutorCache fec(std::move(fusion));
+  ASSERT_TRUE(fec.telemetry().isEnabled());
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({128, 64}, options);
+  for (int i = 0; i < 3; ++i) {
+    fec.runFusionWithInputs({t0});
+  }
+  cudaDeviceSynchronize();
+
+  const FusionTelemetry::Snapshot snapshot = fec.telemetry().snapshot();
+  EXPECT_EQ(snapshot.runs, 3);
+  EXPECT_EQ(snapshot.input_cache_hits, 2);
+  EXPECT_EQ(snapshot.runtime_reuses, 0);
+  EXPECT_EQ(snapshot.runtime_misses, 1);
+  EXPECT_EQ(snapshot.compilations, 1);
+  EXPECT_EQ(snapshot.launches, 3);
+  EXPECT_EQ(snapshot.bytes_moved, 3 * (128 * 64 + 128) * 4);
+  // The first and third runs
+  EXPECT_EQ(snapshot.sampled_runs, 2);
+  EXPECT_GT(snapshot.sampled_kernel_ms, 0.0);
+
+  EXPECT_THAT(
+      fec.telemetry().toPrometheus(7),
+      ::testing::HasSubstr("nvfuser_runs_total{fusion_id=\"7\"} 3\n"));
+}
+
 } // namespace nvfuser
@@ -124,6 +124,69 @@ TEST_F(IndexingOpTest, Scatter1DIndexZerosSelfTvSameShape_CUDA) {
   }
 }
 
+// Few distinct indices, so most of the additions collide
+TEST_F(IndexingOpTest, ScatterAddCollidingIndices_CUDA) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  Fusion& fusion = *fusion_ptr.get();
+  FusionGuard fg(&fusion);
+
+  TensorView* tv_self = makeContigTensor(2);
+  TensorView* tv_idx = makeContigTensor(2, DataType::Int);
+  TensorView* tv_src = makeContigTensor(2);
+  fusion.addInput(tv_self);
+  fusion.addInput(tv_idx);
+  fusion.addInput(tv_src);
+
+  TensorView* tv_out = scatter_add(tv_self, 0, tv_idx, relu(tv_src));
+  fusion.addOutput(tv_out);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto options_i = at::TensorOptions().dtype(at::kLong).device(at::kCUDA, 0);
+  at::Tensor self = at::randn({256, 64}, options);
+  at::Tensor idx = at::randint(0, 4, {256, 64}, options_i);
+  at::Tensor src = at::randn({256, 64}, options);
+  std::vector<c10::IValue> aten_inputs = {self, idx, src};
+
+  FusionExecutorCache executor_cache(std::move(fusion_ptr));
+  auto cg_outputs = executor_cache.runFusionWithInputs(aten_inputs);
+  EXPECT_FALSE(executor_cache.getMostRecentKernelRuntime()->isSegmented());
+
+  auto ref = at::scatter_add(self, 0, idx, at::relu(src));
+  testValidate(&fusion, cg_outputs, aten_inputs, {ref}, __LINE__, __FILE__);
+}
+
+// The result of scatter_add is only complete at the end of the kernel, so its
+// uses are segmented out
+TEST_F(IndexingOpTest, ScatterAddSegmentUses_CUDA) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  Fusion& fusion = *fusion_ptr.get();
+  FusionGuard fg(&fusion);
+
+  TensorView* tv_self = makeContigTensor(2);
+  TensorView* tv_idx = makeContigTensor(2, DataType::Int);
+  TensorView* tv_src = makeContigTensor(2);
+  fusion.addInput(tv_self);
+  fusion.addInput(tv_idx);
+  fusion.addInput(tv_src);
+
+  TensorView* tv_out = scatter_add(neg(tv_self), 1, tv_idx, tv_src);
+  fusion.addOutput(exp(tv_out));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto options_i = at::TensorOptions().dtype(at::kLong).device(at::kCUDA, 0);
+  at::Tensor self = at::randn({32, 128}, options);
+  at::Tensor idx = at::randint(0, 128, {32, 128}, options_i);
+  at::Tensor src = at::randn({32, 128}, options);
+  std::vector<c10::IValue> aten_inputs = {self, idx, src};
+
+  FusionExecutorCache executor_cache(std::move(fusion_ptr));
+  auto cg_outputs = executor_cache.runFusionWithInputs(aten_inputs);
+  EXPECT_TRUE(executor_cache.getMostRecentKernelRuntime()->isSegmented());
+
+  auto ref = at::exp(at::scatter_add(-self, 1, idx, src));
+  testValidate(&fusion, cg_outputs, aten_inputs, {ref}, __LINE__, __FILE__);
+}
+
 // all torch.gather test follow the FusionTorchGather* pattern
 
 // Test the correctness of gather operator in different dimensions and selcted
@@ -1212,4 +1275,109 @@ TEST_F(IndexingOpTest, TakeAlongAxisCrossEntropyLoss_CUDA) {
   testValidate(fusion, cg_outputs, inputs, {ref}, __LINE__, __FILE__);
 }
 
+TEST_F(IndexingOpTest, Sort_CUDA) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  Fusion& fusion = *fusion_ptr.get();
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeContigTensor(2);
+  fusion.addInput(tv0);
+  auto result = sort(tv0, /*dim=*/1, /*descending=*/true);
+  fusion.addOutput(result.values);
+  fusion.addOutput(result.indices);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  // Rows that are not a power of two are padded in the sort
+  auto t0 = at::randn({1000, 50}, options);
+  std::vector<c10::IValue> inputs({t0});
+
+  FusionExecutorCache fec(std::move(fusion_ptr));
+  auto cg_outputs = fec.runFusionWithInputs(inputs);
+
+  validateSegmentation(
+      fec.getMostRecentKernelRuntime(), {ScheduleHeuristic::Sort});
+
+  auto [ref_values, ref_indices] =
+      at::sort(t0, /*stable=*/true, /*dim=*/1, /*descending=*/true);
+  testValidate(
+      fec.fusion(),
+      cg_outputs,
+      inputs,
+      {ref_values, ref_indices},
+      __LINE__,
+      __FILE__);
+}
+
+// Routing of tokens to their top experts in a mixture of experts
+TEST_F(IndexingOpTest, SoftmaxTopK_CUDA) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  Fusion& fusion = *fusion_ptr.get();
+  FusionGuard fg(&fusion);
+
+  const int64_t k = 4;
+  auto tv0 = makeContigTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = softmax(tv0, 1);
+  auto result = topk(tv1, k);
+  fusion.addOutput(result.values);
+  fusion.addOutput(result.indices);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn({1024, 64}, options);
+  std::vector<c10::IValue> inputs({t0});
+
+  FusionExecutorCache fec(std::move(fusion_ptr));
+  auto cg_outputs = fec.runFusionWithInputs(inputs);
+
+  // The softmax and the top-k are fused into one kernel
+  validateSegmentation(
+      fec.getMostRecentKernelRuntime(), {ScheduleHeuristic::Sort});
+
+  auto [ref_values, ref_indices] = at::topk(at::softmax(t0, 1), k);
+  testValidate(
+      fec.fusion(),
+      cg_outputs,
+      inputs,
+      {ref_values, ref_indices},
+      __LINE__,
+      __FILE__);
+}
+
+// Rows of a mask compacted on the device, e.g., for masked_select
+TEST_F(IndexingOpTest, Compact_CUDA) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  Fusion& fusion = *fusion_ptr.get();
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeContigTensor(2);
+  auto tv1 = makeContigTensor(2, DataType::Bool);
+  fusion.addInput(tv0);
+  fusion.addInput(tv1);
+  auto result = compact(tv0, tv1);
+  fusion.addOutput(result.values);
+  fusion.addOutput(result.count);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn({64, 1000}, options);
+  auto t1 = at::rand({64, 1000}, options) > 0.7;
+  std::vector<c10::IValue> inputs({t0, t1});
+
+  FusionExecutorCache fec(std::move(fusion_ptr));
+  auto cg_outputs = fec.runFusionWithInputs(inputs);
+
+  // The selected elements come first, both parts in their original order
+  auto order = std::get<1>(at::sort(
+      t1.logical_not().to(at::kInt),
+      /*stable=*/true,
+      /*dim=*/1,
+      /*descending=*/false));
+  testValidate(
+      fec.fusion(),
+      cg_outputs,
+      inputs,
+      {t0.gather(1, order), t1.sum({1}, /*keepdim=*/true)},
+      __LINE__,
+      __FILE__);
+}
+
 } // namespace nvfuser
@@ -1035,6 +1035,44 @@ TEST_F(NVFuserTest, FusionInputsIdLookup_CUDA) {
   NVF_CHECK(id_3_norecord.id == id_3_lookup_norecord.id);
 }
 
+// Lookups from multiple threads sharing one InputsIdLookup must agree on the
+// ids. There are no more shapes than a single shard can hold, so nothing is
+// evicted.
+TEST_F(NVFuserTest, FusionInputsIdLookupConcurrent_CUDA) {
+  nvfuser::InputsIdLookup inputs_id_lookup(64);
+  EXPECT_GT(inputs_id_lookup.numShards(), 1);
+
+  constexpr int64_t num_threads = 4;
+  constexpr int64_t num_shapes = 16;
+  // Metadata is all that matters, so CPU tensors are fine
+  std::vector<at::Tensor> tensors;
+  for (const auto i : c10::irange(num_shapes)) {
+    tensors.push_back(at::empty({i + 1, 8}));
+  }
+
+  std::vector<std::vector<size_t>> ids(
+      num_threads, std::vector<size_t>(num_shapes, 0));
+  std::vector<std::thread> threads;
+  for (const auto thread_i : c10::irange(num_threads)) {
+    threads.emplace_back([&, thread_i]() {
+      for (const auto shape_i : c10::irange(num_shapes)) {
+        ids[thread_i][shape_i] =
+            inputs_id_lookup.lookupId({tensors.at(shape_i)}).id;
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (const auto shape_i : c10::irange(num_shapes)) {
+    for (const auto thread_i : c10::irange(num_threads)) {
+      EXPECT_EQ(ids[thread_i][shape_i], ids[0][shape_i]);
+    }
+  }
+  EXPECT_EQ(inputs_id_lookup.size(), num_shapes);
+}
+
 TEST_F(NVFuserTest, FusionDisjointSet_CUDA) {
   DisjointSets<int> set;
 
@@ -1147,6 +1185,56 @@ TEST_F(NVFuserTest, FusionDisjointSet_CUDA) {
   }
 }
 
+// Merged sets go to the end of the list of sets, each with the entries of
+// the first set followed by those of the second
+TEST_F(NVFuserTest, FusionDisjointSetOrder_CUDA) {
+  DisjointSets<int> set;
+  for (int i : c10::irange(6)) {
+    set.initializeSet(i);
+  }
+  set.mapEntries(3, 1);
+  set.mapEntries(4, 0);
+  set.mapEntries(1, 4);
+  EXPECT_TRUE(set.erase(5));
+  set.mapEntries(6, 7);
+
+  std::vector<std::vector<int>> sets;
+  for (const auto& s : set.disjointSets()) {
+    sets.push_back(s->vector());
+  }
+  EXPECT_EQ(
+      sets, (std::vector<std::vector<int>>{{2}, {3, 1, 4, 0}, {6, 7}}));
+  EXPECT_EQ(set.size(), 3);
+
+  DisjointSets<int> copy(set);
+  copy.mapEntries(2, 6);
+  EXPECT_EQ(copy.size(), 2);
+  EXPECT_EQ(copy.disjointSets().back()->vector(), std::vector<int>({2, 6, 7}));
+  EXPECT_FALSE(set.permissiveAreMapped(2, 6));
+  EXPECT_EQ(set.disjointSets().size(), 3);
+}
+
+TEST_F(NVFuserTest, FusionUnionFind_CUDA) {
+  UnionFind sets(4);
+  EXPECT_EQ(sets.numSets(), 4);
+  EXPECT_TRUE(sets.join(0, 1));
+  EXPECT_TRUE(sets.join(2, 3));
+  EXPECT_FALSE(sets.join(1, 0));
+  EXPECT_EQ(sets.numSets(), 2);
+  EXPECT_TRUE(sets.sameSet(0, 1));
+  EXPECT_FALSE(sets.sameSet(1, 2));
+
+  sets.resize(6);
+  EXPECT_EQ(sets.numSets(), 4);
+  EXPECT_TRUE(sets.join(5, 3));
+  EXPECT_TRUE(sets.join(1, 5));
+  EXPECT_EQ(sets.numSets(), 2);
+  for (int64_t id : {0, 1, 2, 3, 5}) {
+    EXPECT_EQ(sets.find(id), sets.find(0));
+  }
+  EXPECT_FALSE(sets.sameSet(4, 0));
+}
+
 TEST_F(NVFuserTest, FusionNonUniqueBroadcastSize_CUDA) {
   Fusion fusion;
   FusionGuard fg(&fusion);
@@ -2446,6 +2534,49 @@ TEST_F(NVFuserTest, FusionBlockWelfordOp_CUDA) {
       __FILE__);
 }
 
+// Block Welford over TIDx and TIDy, where the reduction segments are made
+// of whole warps and are reduced with shuffles first
+TEST_F(NVFuserTest, FusionBlockWelfordWarpShuffle_CUDA) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  int M = 16, N = 4, K = 96;
+
+  auto tv0 = makeSymbolicTensor(3);
+  fusion.addInput(tv0);
+  auto tv1 = mul(tv0, IrBuilder::create<Val>(1.0));
+  auto tvs = Welford(tv1, {1, 2});
+  fusion.addOutput(tvs.avg);
+  fusion.addOutput(tvs.var_sum);
+  fusion.addOutput(tvs.n);
+
+  tvs.avg->axis(0)->parallelize(ParallelType::BIDx);
+  tvs.avg->axis(1)->parallelize(ParallelType::TIDy);
+  tvs.avg->axis(2)->parallelize(ParallelType::TIDx);
+
+  tv1->computeAt(tvs.avg, -1);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto options_int = at::TensorOptions().dtype(at::kLong).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({M, N, K}, options);
+
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, {t0});
+  auto outputs = fe.runFusion({t0});
+
+  outputs[1] /= N * K;
+
+  testValidate(
+      fe.kernel(),
+      outputs,
+      {t0},
+      {t0.mean({1, 2}),
+       t0.var({1, 2}, false),
+       at::ones({M}, options_int) * N * K},
+      __LINE__,
+      __FILE__);
+}
+
 TEST_F(NVFuserTest, FusionGridWelfordOp_CUDA) {
   Fusion fusion;
   FusionGuard fg(&fusion);
@@ -6575,6 +6706,50 @@ TEST_F(NVFuserTest, FusionWarpReducePredication_CUDA) {
   testValidate(&fusion, cg_outputs, {t0, t2}, {t1, t4}, __LINE__, __FILE__);
 }
 
+// Softmax-like normalization over 16 elements, with 8 rows per block. See
+// [ Warp Segment Reduction ]
+TEST_F(NVFuserTest, FusionWarpSegmentReduction_CUDA) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::WarpSegmentReduction);
+
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeContigConcreteTensor({-1, 16});
+  fusion.addInput(tv0);
+  auto tv1 = sum(tv0, {1});
+  auto tv2 = broadcast(tv1, {false, true});
+  auto tv3 = div(tv0, tv2);
+  fusion.addOutput(tv3);
+
+  // Warp reductions need their input in registers
+  tv0->cacheAfter();
+
+  tv3->split(0, 8);
+  TransformPropagatorWithCheck propagator(tv3);
+  MaxRootDomainInfoSpanningTree(tv3).traverse(&propagator);
+  tv3->axis(0)->parallelize(ParallelType::BIDx);
+  tv3->axis(1)->parallelize(ParallelType::TIDy);
+  tv3->axis(2)->parallelize(ParallelType::TIDx);
+  scheduler_utils::parallelizeAllLike(tv3);
+  inlineMost();
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn({1000, 16}, options);
+
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, {t0});
+  auto cg_outputs = fe.runFusion({t0});
+
+  const auto kernel_code = fe.kernelString();
+  EXPECT_THAT(kernel_code, testing::HasSubstr("warpSegmentReduceTIDX<16>"));
+  EXPECT_THAT(kernel_code, testing::Not(testing::HasSubstr("blockReduce")));
+  EXPECT_THAT(
+      kernel_code, testing::Not(testing::HasSubstr("blockBroadcast")));
+
+  testValidate(&fusion, cg_outputs, {t0}, __LINE__, __FILE__);
+}
+
 TEST_F(NVFuserTest, FusionSegfaultReduction_CUDA) {
   std::unique_ptr<Fusion> fusion_ptr = std::make_unique<Fusion>();
   Fusion& fusion = *fusion_ptr.get();
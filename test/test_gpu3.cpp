@@ -10,6 +10,7 @@
 #include <gtest/gtest.h>
 
 #include <codegen.h>
+#include <compile_thread_pool.h>
 #include <debug.h>
 #include <device_lower/lower2device.h>
 #include <device_lower/pass/magic_zero.h>
@@ -21,6 +22,7 @@
 #include <fusion_segmenter.h>
 #include <grouped_reduction.h>
 #include <inlining.h>
+#include <instrumentation.h>
 #include <ir/all_nodes.h>
 #include <ir/builder.h>
 #include <ir/graphviz.h>
@@ -33,8 +35,12 @@
 #include <ops/all_ops.h>
 #include <root_domain_map.h>
 #include <scheduler/all_schedulers.h>
+#include <scheduler/autotune.h>
+#include <scheduler/device_model.h>
+#include <scheduler/heuristic_log.h>
 #include <scheduler/reduction_utils.h>
 #include <scheduler/utils.h>
+#include <serde/heuristic_params.h>
 #include <test/utils.h>
 #include <test/validator.h>
 #include <transform_replay.h>
@@ -46,10 +52,14 @@
 
 #include <ATen/cuda/CUDAContext.h>
 #include <ATen/cuda/Exceptions.h>
+#include <c10/cuda/CUDAGuard.h>
 #include <c10/cuda/CUDAStream.h>
+#include <nvrtc.h>
 
 #include <algorithm>
 #include <cmath>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
 #include <sstream>
 #include <thread>
@@ -4854,6 +4864,139 @@ TEST_F(NVFuserTest, FusionCastings_CUDA) {
       "");
 }
 
+TEST_F(NVFuserTest, FusionFp8Castings_CUDA) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  Fusion& fusion = *fusion_ptr.get();
+  FusionGuard fg(&fusion);
+
+  int x = 4, y = 1024;
+
+  std::vector<DataType> data_types{
+      DataType::Double, DataType::Float, DataType::Half};
+  if (at::cuda::getDeviceProperties(0)->major >= 8) {
+    data_types.emplace_back(DataType::BFloat16);
+  }
+  const std::vector<DataType> fp8_types{
+      DataType::Float8_e4m3fn, DataType::Float8_e5m2};
+
+  // Casts from each type to each FP8 type and back
+  for (const auto& input_type : data_types) {
+    auto tv_in = makeContigTensor(2, input_type);
+    fusion.addInput(tv_in);
+    for (const auto& fp8_type : fp8_types) {
+      auto tv_fp8 = castOp(fp8_type, tv_in);
+      fusion.addOutput(tv_fp8);
+      fusion.addOutput(castOp(input_type, tv_fp8));
+    }
+  }
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+
+  std::vector<c10::IValue> inputs;
+  std::vector<at::Tensor> outputs;
+  for (const auto& input_type : data_types) {
+    // Within the range of both FP8 types, which saturate differently than
+    // ATen
+    at::Tensor t =
+        at::randn({x, y}, options).mul(8).to(data_type_to_aten(input_type));
+    inputs.emplace_back(t);
+    for (const auto& fp8_type : fp8_types) {
+      at::Tensor t_fp8 = t.to(data_type_to_aten(fp8_type));
+      outputs.emplace_back(t_fp8);
+      outputs.emplace_back(t_fp8.to(data_type_to_aten(input_type)));
+    }
+  }
+
+  FusionExecutorCache executor_cache(std::move(fusion_ptr));
+  auto cg_outputs = executor_cache.runFusionWithInputs(inputs);
+
+  // Conversions round to nearest even, so they match ATen exactly
+  ASSERT_EQ(cg_outputs.size(), outputs.size());
+  for (auto i : c10::irange(outputs.size())) {
+    EXPECT_TRUE(at::equal(
+        cg_outputs.at(i).to(at::kFloat), outputs.at(i).to(at::kFloat)))
+        << "Mismatch in output " << i;
+  }
+}
+
+TEST_F(NVFuserTest, FusionFp8ScaledCast_CUDA) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  Fusion& fusion = *fusion_ptr.get();
+  FusionGuard fg(&fusion);
+
+  // Quantizes tv0 with a per-tensor scale and dequantizes the result
+  auto tv0 = makeContigTensor(2, DataType::Half);
+  auto tv1 = makeContigTensor(0, DataType::Float);
+  fusion.addInput(tv0);
+  fusion.addInput(tv1);
+  auto tv2 = reciprocal(tv1);
+  auto tv3 = scaledCastOp(DataType::Float8_e4m3fn, tv0, tv2);
+  auto tv4 = scaledCastOp(DataType::Half, tv3, tv1);
+  fusion.addOutput(tv3);
+  fusion.addOutput(tv4);
+
+  auto options = at::TensorOptions().dtype(at::kHalf).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({128, 1024}, options);
+  // Saturates to the largest finite value of e4m3, 448
+  t0[0][0] = 1000;
+  at::Tensor t1 = at::full({}, 0.125, options.dtype(at::kFloat));
+  std::vector<c10::IValue> inputs{t0, t1};
+
+  FusionExecutorCache executor_cache(std::move(fusion_ptr));
+  auto cg_outputs = executor_cache.runFusionWithInputs(inputs);
+
+  at::Tensor ref_fp8 = t0.to(at::kFloat)
+                           .div(t1)
+                           .clamp(-448, 448)
+                           .to(at::ScalarType::Float8_e4m3fn);
+  at::Tensor ref = ref_fp8.to(at::kFloat).mul(t1).to(at::kHalf);
+
+  EXPECT_TRUE(
+      at::equal(cg_outputs.at(0).to(at::kFloat), ref_fp8.to(at::kFloat)));
+  EXPECT_TRUE(at::equal(cg_outputs.at(1), ref));
+  EXPECT_EQ(cg_outputs.at(1)[0][0].item<float>(), 56);
+}
+
+TEST_F(NVFuserTest, FusionFastMath_CUDA) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeContigTensor(2);
+  fusion.addInput(tv0);
+  fusion.addOutput(exp(tv0));
+  fusion.addOutput(log(add(abs(tv0), IrBuilder::create<Val>(1.0))));
+  fusion.addOutput(tanh(tv0));
+  fusion.addOutput(sigmoid(tv0));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({128, 1024}, options);
+  std::vector<c10::IValue> inputs{t0};
+
+  auto lparams = schedulePointwise(&fusion, inputs);
+
+  CompileParams cparams;
+  cparams.enable_fast_math = true;
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, inputs, lparams, cparams);
+  EXPECT_THAT(fe.kernelString(), ::testing::HasSubstr("ex2.approx.ftz.f32"));
+  EXPECT_THAT(fe.kernelString(), ::testing::HasSubstr("lg2.approx.ftz.f32"));
+  if (at::cuda::getCurrentDeviceProperties()->major >= 8) {
+    EXPECT_THAT(fe.kernelString(), ::testing::HasSubstr("tanh.approx.f32"));
+  }
+  auto cg_outputs = fe.runFusion(inputs, lparams, cparams);
+
+  EXPECT_TRUE(at::allclose(cg_outputs.at(0), t0.exp(), 1e-4, 1e-5));
+  EXPECT_TRUE(at::allclose(cg_outputs.at(1), t0.abs().log1p(), 1e-4, 1e-5));
+  EXPECT_TRUE(at::allclose(cg_outputs.at(2), t0.tanh(), 1e-3, 1e-3));
+  EXPECT_TRUE(at::allclose(cg_outputs.at(3), t0.sigmoid(), 1e-3, 1e-3));
+
+  const auto errors = getFastMathErrors(&fusion, inputs, lparams);
+  ASSERT_EQ(errors.size(), 4);
+  for (auto error : errors) {
+    EXPECT_LT(error, 1e-2);
+  }
+}
+
 TEST_F(NVFuserTest, FusionIssue2074_CUDA) {
   auto fusion_ptr = std::make_unique<Fusion>();
   Fusion& fusion = *fusion_ptr.get();
@@ -8674,6 +8817,1751 @@ TEST_F(NVFuserTest, ProjectToInputsAndBroadcastTvs3) {
   auto cg_outputs = fe.runFusion(inputs, persistent_params->lparams);
 }
 
+// Repeated launches with the same input cache id reuse the argument buffer of
+// the ExecutorEntry and only patch the data pointers. Make sure every launch
+// sees its own inputs and outputs, with and without scalar arguments, which
+// are not covered by the launch plan.
+TEST_F(NVFuserTest, LaunchPlanPatchesDataPointers) {
+  std::unique_ptr<Fusion> fusion_ptr = std::make_unique<Fusion>();
+  auto fusion = fusion_ptr.get();
+  FusionGuard fg(fusion);
+
+  auto tv0 = makeContigTensor(2);
+  auto tv1 = makeContigTensor(2);
+  auto s2 = IrBuilder::create<Val>(DataType::Double);
+  fusion->addInput(tv0);
+  fusion->addInput(tv1);
+  fusion->addInput(s2);
+  auto tv3 = add(tv0, tv1);
+  fusion->addOutput(tv3);
+  auto tv4 = mul(tv3, s2);
+  fusion->addOutput(tv4);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  std::vector<c10::IValue> inputs = {
+      at::randn({128, 65}, options), at::randn({128, 65}, options), 2.0};
+
+  FusionExecutor fe;
+  fe.compileFusion(fusion, inputs);
+
+  for (const auto i : c10::irange(3)) {
+    inputs = {
+        at::randn({128, 65}, options),
+        at::randn({128, 65}, options),
+        (double)i};
+    auto cg_outputs = fe.runFusion(inputs, {}, {}, /*opt_code=*/0);
+    auto t3 = inputs[0].toTensor() + inputs[1].toTensor();
+    auto t4 = t3 * (double)i;
+    testValidate(
+        fusion,
+        cg_outputs,
+        inputs,
+        {t3, t4},
+        __LINE__,
+        __FILE__,
+        "Iteration " + std::to_string(i));
+  }
+
+  // Same without the scalar input so that the launch plan is used
+  std::unique_ptr<Fusion> fusion2_ptr = std::make_unique<Fusion>();
+  auto fusion2 = fusion2_ptr.get();
+  FusionGuard fg2(fusion2);
+
+  auto tv5 = makeContigTensor(2);
+  auto tv6 = makeContigTensor(2);
+  fusion2->addInput(tv5);
+  fusion2->addInput(tv6);
+  auto tv7 = sub(tv5, tv6);
+  fusion2->addOutput(tv7);
+
+  FusionExecutor fe2;
+  fe2.compileFusion(
+      fusion2, {at::randn({128, 65}, options), at::randn({128, 65}, options)});
+
+  for (const auto i : c10::irange(3)) {
+    std::vector<c10::IValue> inputs2 = {
+        at::randn({128, 65}, options), at::randn({128, 65}, options)};
+    auto cg_outputs = fe2.runFusion(inputs2, {}, {}, /*opt_code=*/0);
+    auto t7 = inputs2[0].toTensor() - inputs2[1].toTensor();
+    testValidate(
+        fusion2,
+        cg_outputs,
+        inputs2,
+        {t7},
+        __LINE__,
+        __FILE__,
+        "Iteration " + std::to_string(i));
+  }
+}
+
+TEST_F(NVFuserTest, AsyncCompileWithFallback) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::AsyncCompile);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  TensorView* tv0 = makeContigTensor(2);
+  TensorView* tv1 = makeContigTensor(1);
+  fusion->addInput(tv0);
+  fusion->addInput(tv1);
+  TensorView* tv2 = add(tv0, broadcast(tv1, {true, false}));
+  TensorView* tv3 = sum(tv2, {1});
+  fusion->addOutput(tv2);
+  fusion->addOutput(tv3);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({32, 64}, options);
+  at::Tensor t1 = at::randn({64}, options);
+  std::vector<c10::IValue> inputs = {t0, t1};
+  at::Tensor t2 = t0 + t1.unsqueeze(0);
+
+  FusionExecutorCache fec(std::move(fusion));
+  // The first run returns either the ATen result or, if compilation was
+  // quick enough, the kernel result
+  auto outputs = fec.runFusionWithInputs(inputs);
+  testValidate(
+      fec.fusion(), outputs, inputs, {t2, t2.sum({1})}, __LINE__, __FILE__);
+
+  FusionKernelRuntime* runtime = fec.getMostRecentKernelRuntime();
+  EXPECT_TRUE(runtime->isAsyncCompileQueued());
+  runtime->waitForAsyncCompile();
+  EXPECT_TRUE(runtime->isCompiled());
+
+  outputs = fec.runFusionWithInputs(inputs);
+  testValidate(
+      fec.fusion(), outputs, inputs, {t2, t2.sum({1})}, __LINE__, __FILE__);
+  EXPECT_EQ(fec.getMostRecentKernelRuntime(), runtime);
+}
+
+TEST_F(NVFuserTest, InterpretedPointwise) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::InterpretedPointwise);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  TensorView* tv0 = makeContigTensor(2, DataType::Half);
+  TensorView* tv1 = makeContigTensor(1);
+  Val* s2 = IrBuilder::create<Val>(DataType::Double);
+  fusion->addInput(tv0);
+  fusion->addInput(tv1);
+  fusion->addInput(s2);
+  TensorView* tv3 =
+      add(castOp(DataType::Float, tv0), broadcast(tv1, {false, true}));
+  TensorView* tv4 = mul(silu(tv3), s2);
+  TensorView* tv5 = castOp(DataType::Half, tv4);
+  TensorView* tv6 = relu(sub(tv4, IrBuilder::create<Val>(1.0)));
+  fusion->addOutput(tv5);
+  fusion->addOutput(tv6);
+
+  auto options = at::TensorOptions().dtype(at::kHalf).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({128, 33}, options);
+  at::Tensor t1 = at::randn({128}, options.dtype(at::kFloat));
+  std::vector<c10::IValue> inputs = {t0, t1, 0.5};
+  at::Tensor t4 = at::silu(t0.to(at::kFloat) + t1.unsqueeze(1)) * 0.5;
+  std::vector<at::Tensor> expected = {t4.to(at::kHalf), at::relu(t4 - 1.0)};
+
+  auto interpreter = PointwiseInterpreter::tryCreate(fusion.get());
+  ASSERT_NE(interpreter, nullptr);
+  auto outputs = interpreter->run(
+      KernelArgumentHolder::createKernelArgumentHolder(inputs));
+  ASSERT_TRUE(outputs.has_value());
+  testValidate(fusion.get(), *outputs, inputs, expected, __LINE__, __FILE__);
+
+  // Mismatched extents are left to the compiled kernels to report
+  std::vector<c10::IValue> bad_inputs = {
+      t0, at::randn({64}, options.dtype(at::kFloat)), 0.5};
+  EXPECT_FALSE(
+      interpreter
+          ->run(KernelArgumentHolder::createKernelArgumentHolder(bad_inputs))
+          .has_value());
+
+  FusionExecutorCache fec(std::move(fusion));
+  // The first run returns either the interpreted result or, if compilation
+  // was quick enough, the kernel result
+  auto fec_outputs = fec.runFusionWithInputs(inputs);
+  testValidate(
+      fec.fusion(), fec_outputs, inputs, expected, __LINE__, __FILE__);
+
+  FusionKernelRuntime* runtime = fec.getMostRecentKernelRuntime();
+  EXPECT_TRUE(runtime->canRunWithInterpreter());
+  EXPECT_TRUE(runtime->isAsyncCompileQueued());
+  runtime->waitForAsyncCompile();
+  EXPECT_TRUE(runtime->isCompiled());
+
+  fec_outputs = fec.runFusionWithInputs(inputs);
+  testValidate(
+      fec.fusion(), fec_outputs, inputs, expected, __LINE__, __FILE__);
+}
+
+TEST_F(NVFuserTest, InterpretedPointwiseRejectsReductions) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  TensorView* tv0 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  fusion->addOutput(sum(exp(tv0), {1}));
+
+  EXPECT_EQ(PointwiseInterpreter::tryCreate(fusion.get()), nullptr);
+}
+
+TEST_F(NVFuserTest, FusionSplitCompile_CUDA) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::SplitCompile, {"2"});
+
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  TensorView* tv0 = makeContigTensor(2);
+  fusion.addInput(tv0);
+  TensorView* tv1 = exp(tv0);
+  fusion.addOutput(tv1);
+  tv1->axis(0)->parallelize(ParallelType::BIDx);
+  tv1->axis(1)->parallelize(ParallelType::TIDx);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({8, 32}, options);
+
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, {t0});
+  auto outputs = fe.runFusion({t0});
+  testValidate(&fusion, outputs, {t0}, {t0.exp()}, __LINE__, __FILE__);
+
+  // Only ptxas, i.e., compilation to SASS, is split, which needs NVRTC 12.1
+  int nvrtc_major = 0, nvrtc_minor = 0;
+  NVFUSER_NVRTC_SAFE_CALL(nvrtcVersion(&nvrtc_major, &nvrtc_minor));
+  const std::string& compile_args = fe.compiledKernel().compile_args;
+  if (compile_args.find("--gpu-architecture=sm_") != std::string::npos &&
+      (nvrtc_major > 12 || (nvrtc_major == 12 && nvrtc_minor >= 1))) {
+    EXPECT_THAT(compile_args, ::testing::HasSubstr("--split-compile=2"));
+  }
+}
+
+// Fusions defined the same way share their compile-time analyses
+TEST_F(NVFuserTest, FusionGlobalHeuristicCache_CUDA) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::GlobalHeuristicCache);
+
+  auto makeFusion = []() {
+    auto fusion = std::make_unique<Fusion>();
+    FusionGuard fg(fusion.get());
+    TensorView* tv0 = makeSymbolicTensor(2);
+    fusion->addInput(tv0);
+    TensorView* tv1 = softmax(tv0, 1);
+    fusion->addOutput(tv1);
+    return fusion;
+  };
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  for (auto shape : std::vector<std::vector<int64_t>>{
+           {128, 1024}, {64, 2048}, {128, 1024}}) {
+    at::Tensor t0 = at::randn(shape, options);
+    FusionExecutorCache fec(makeFusion());
+    auto outputs = fec.runFusionWithInputs({t0});
+    testValidate(
+        fec.fusion(), outputs, {t0}, {at::softmax(t0, 1)}, __LINE__, __FILE__);
+  }
+}
+
+// Inputs whose extents fall into the same shape bucket share a runtime
+TEST_F(NVFuserTest, ShapeBucketsShareRuntime) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = add(tv0, IrBuilder::create<Val>(1.0));
+  auto tv2 = sum(tv1, {1});
+  fusion->addOutput(tv1);
+  fusion->addOutput(tv2);
+
+  FusionExecutorCache fec(std::move(fusion));
+  fec.setShapeBuckets({ShapeBuckets::Kind::Multiple, 64});
+
+  ShapeBuckets buckets{ShapeBuckets::Kind::Multiple, 64};
+  EXPECT_EQ(buckets.bucket(8), 8);
+  EXPECT_EQ(buckets.bucket(101), 129);
+  EXPECT_EQ(buckets.bucket(100), 132);
+  EXPECT_EQ(buckets.bucket(128), 128);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  // Odd extents in the same bucket
+  for (int64_t extent : {101, 103, 105}) {
+    at::Tensor t0 = at::randn({extent, extent}, options);
+    std::vector<c10::IValue> inputs = {t0};
+    auto outputs = fec.runFusionWithInputs(inputs);
+    at::Tensor t1 = t0 + 1;
+    testValidate(
+        fec.fusion(), outputs, inputs, {t1, t1.sum({1})}, __LINE__, __FILE__);
+  }
+  EXPECT_EQ(fec.countRuntimes(), 1);
+}
+
+TEST_F(NVFuserTest, AutotuneReductionParams) {
+  ReductionParams rparams;
+  rparams.fastest_dim = true;
+  rparams.unroll_factor_inner_reduction = 4;
+  rparams.vectorize_inner_reduction = true;
+  rparams.batches_per_block_inner_reduction = 3;
+
+  // The inner reduction is never vectorized more than the heuristic allows
+  ReductionTuning tuning;
+  tuning.unroll_factor_inner_reduction = 8;
+  tuning.unroll_factor_iter_dom = 2;
+  ReductionParams tuned = rparams;
+  EXPECT_TRUE(
+      autotune::applyTuning(ScheduleHeuristic::Reduction, tuning, tuned));
+  EXPECT_EQ(tuned.unroll_factor_inner_reduction, 4);
+  EXPECT_EQ(tuned.unroll_factor_iter_dom, 2);
+
+  // Persistent kernels keep the size of the persistent buffer per thread
+  tuning.unroll_factor_inner_reduction = 2;
+  tuned = rparams;
+  EXPECT_TRUE(autotune::applyTuning(
+      ScheduleHeuristic::InnerPersistent, tuning, tuned));
+  EXPECT_EQ(tuned.unroll_factor_inner_reduction, 2);
+  EXPECT_TRUE(tuned.vectorize_inner_reduction);
+  EXPECT_EQ(tuned.batches_per_block_inner_reduction, 6);
+  EXPECT_EQ(tuned.unroll_factor_iter_dom, 1);
+
+  EXPECT_EQ(
+      autotune::tuningCandidates(ScheduleHeuristic::Reduction, rparams).size(),
+      9);
+  EXPECT_EQ(
+      autotune::tuningCandidates(ScheduleHeuristic::InnerPersistent, rparams)
+          .size(),
+      4);
+
+  const auto db_path =
+      std::filesystem::temp_directory_path() / "nvfuser_autotune_test.txt";
+  std::filesystem::remove(db_path);
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(
+      EnableOption::Autotune, {db_path.string()});
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  // Both sizes are in the same bucket, so the second fusion reuses the
+  // tuning of the first
+  for (auto [x, y] : std::vector<std::pair<int64_t, int64_t>>{
+           {128, 1024}, {100, 1000}}) {
+    auto fusion = std::make_unique<Fusion>();
+    FusionGuard fg(fusion.get());
+
+    auto tv0 = makeSymbolicTensor(2);
+    fusion->addInput(tv0);
+    auto tv1 = sum(tv0, {1});
+    fusion->addOutput(tv1);
+
+    FusionExecutorCache fec(std::move(fusion));
+    at::Tensor t0 = at::randn({x, y}, options);
+    std::vector<c10::IValue> inputs = {t0};
+    auto outputs = fec.runFusionWithInputs(inputs);
+    testValidate(
+        fec.fusion(), outputs, inputs, {t0.sum({1})}, __LINE__, __FILE__);
+
+    auto runtime = fec.getMostRecentKernelRuntime();
+    const auto& scheduler_entry =
+        runtime->schedulerHeuristics()->heuristicsList().at(0);
+    EXPECT_EQ(scheduler_entry->heuristic(), ScheduleHeuristic::Reduction);
+    EXPECT_THAT(
+        scheduler_entry->params()->tag, testing::HasSubstr("Autotuned"));
+    EXPECT_EQ(TuningDb::get()->numEntries(), 1);
+  }
+
+  // The tuning is persisted
+  EXPECT_EQ(TuningDb(db_path.string()).numEntries(), 1);
+  std::filesystem::remove(db_path);
+}
+
+TEST_F(NVFuserTest, HeuristicLogRecordAndReplay) {
+  const auto log_path =
+      std::filesystem::temp_directory_path() / "nvfuser_heuristics_test.txt";
+  std::filesystem::remove(log_path);
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(
+      EnableOption::HeuristicLog, {log_path.string()});
+
+  auto make_fusion = []() {
+    auto fusion = std::make_unique<Fusion>();
+    FusionGuard fg(fusion.get());
+    auto tv0 = makeSymbolicTensor(2);
+    fusion->addInput(tv0);
+    auto tv1 = add(tv0, IrBuilder::create<Val>(1.0));
+    auto tv2 = sum(tv1, {1});
+    fusion->addOutput(tv2);
+    return fusion;
+  };
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({128, 1024}, options);
+  std::vector<c10::IValue> inputs = {t0};
+  FusionExecutorCache fec(make_fusion());
+  auto outputs = fec.runFusionWithInputs(inputs);
+  testValidate(
+      fec.fusion(), outputs, inputs, {(t0 + 1).sum({1})}, __LINE__, __FILE__);
+
+  auto read_log = [&]() {
+    std::ifstream file(log_path);
+    std::stringstream ss;
+    ss << file.rdbuf();
+    return ss.str();
+  };
+  const std::string log = read_log();
+  EXPECT_THAT(log, testing::HasSubstr("heuristic: reduction\n"));
+  EXPECT_THAT(
+      log,
+      testing::HasSubstr(
+          "input: tensor dtype=Float sizes=[128, 1024] strides=[1024, 1]"));
+  EXPECT_THAT(log, testing::HasSubstr("reductionOp(BinaryOpType::Add, {1}"));
+  EXPECT_THAT(log, testing::Not(testing::HasSubstr("Unsupported")));
+
+  auto fusion = make_fusion();
+  auto results = heuristic_log::replayHeuristics(fusion.get(), inputs);
+  EXPECT_EQ(results.size(), all_heuristics_in_priority_order.size());
+  auto reduction = std::find_if(
+      results.begin(), results.end(), [](const auto& result) {
+        return result.heuristic == ScheduleHeuristic::Reduction;
+      });
+  ASSERT_NE(reduction, results.end());
+  EXPECT_TRUE(reduction->can_schedule);
+  EXPECT_TRUE(reduction->time_ms.has_value()) << reduction->error;
+  EXPECT_THAT(
+      heuristic_log::toString(results), testing::HasSubstr("reduction: "));
+
+  // Decisions of the replay aren't logged
+  EXPECT_EQ(read_log(), log);
+  std::filesystem::remove(log_path);
+}
+
+TEST_F(NVFuserTest, KernelResources) {
+  // Spills are only parsed from a verbose ptxas log
+  DebugDumpOptionsGuard dump_guard;
+  DebugDumpOptionsGuard::getCurOptions().set(DebugDumpOption::PrintPtxasLog);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  auto tv0 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = sum(mul(tv0, tv0), {1});
+  fusion->addOutput(tv1);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({1024, 512}, options);
+  std::vector<c10::IValue> inputs = {t0};
+  FusionExecutorCache fec(std::move(fusion));
+  auto outputs = fec.runFusionWithInputs(inputs);
+  testValidate(
+      fec.fusion(), outputs, inputs, {(t0 * t0).sum({1})}, __LINE__, __FILE__);
+
+  auto all_resources = fec.getMostRecentKernelResources();
+  ASSERT_EQ(all_resources.size(), 1);
+  const auto& resources = all_resources.front();
+  const FusionExecutor& fe =
+      fec.getMostRecentKernelRuntime()->executors().front();
+  EXPECT_GT(resources.registers, 0);
+  EXPECT_GE(resources.local_bytes, 0);
+  EXPECT_GE(resources.spill_store_bytes, 0);
+  EXPECT_GE(resources.spill_load_bytes, 0);
+  EXPECT_GE(resources.static_smem_bytes, 0);
+  EXPECT_EQ(resources.dynamic_smem_bytes, fe.lastLaunchParams().smem());
+  EXPECT_EQ(resources.launch_params, fe.lastLaunchParams());
+  EXPECT_GT(resources.blocks_per_sm, 0);
+  EXPECT_GT(resources.theoretical_occupancy_pct, 0.0);
+  EXPECT_LE(resources.theoretical_occupancy_pct, 100.0);
+  EXPECT_GT(resources.waves, 0.0);
+  EXPECT_FALSE(resources.achieved_occupancy_pct.has_value());
+  EXPECT_THAT(
+      resources.toString(), testing::HasSubstr("theoretical_occupancy= "));
+}
+
+// Kernels compiled with programmatic dependent launch wait for the preceding
+// kernel of the stream before they access global memory, see
+// [ Programmatic Dependent Launch ]
+TEST_F(NVFuserTest, ProgrammaticDependentLaunch) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(
+      EnableOption::ProgrammaticDependentLaunch);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  auto tv0 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = add(tv0, IrBuilder::create<Val>(1.0));
+  auto tv2 = segment_set(tv1);
+  auto tv3 = sum(tv2, {1});
+  auto tv4 = mul(tv3, IrBuilder::create<Val>(2.0));
+  fusion->addOutput(tv4);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({1024, 512}, options);
+  std::vector<c10::IValue> inputs = {t0};
+  FusionExecutorCache fec(std::move(fusion));
+  // The second run launches the second kernel right after the first one
+  fec.runFusionWithInputs(inputs);
+  auto outputs = fec.runFusionWithInputs(inputs);
+  testValidate(
+      fec.fusion(),
+      outputs,
+      inputs,
+      {(t0 + 1).sum({1}) * 2},
+      __LINE__,
+      __FILE__);
+
+  FusionKernelRuntime* runtime = fec.getMostRecentKernelRuntime();
+  EXPECT_TRUE(runtime->isSegmented());
+  for (const FusionExecutor& fe : runtime->executors()) {
+    if (!fe.isCompiled()) {
+      continue;
+    }
+    EXPECT_TRUE(fe.usesProgrammaticDependentLaunch());
+    const std::string code = fe.kernelString();
+    const auto launch_pos = code.find("grid_sync::launchDependentGrids();");
+    const auto wait_pos = code.find("grid_sync::waitForPrerequisiteGrids();");
+    ASSERT_NE(launch_pos, std::string::npos);
+    ASSERT_NE(wait_pos, std::string::npos);
+    EXPECT_LT(launch_pos, wait_pos);
+  }
+}
+
+// The tensor arguments of a kernel whose parameters exceed 4KB are passed in
+// a device buffer, see [ Spilled Kernel Arguments ]
+TEST_F(NVFuserTest, SpilledKernelArguments) {
+  constexpr int64_t num_inputs = 200;
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  TensorView* tv_sum = nullptr;
+  for (int64_t i = 0; i < num_inputs; ++i) {
+    auto tv = makeSymbolicTensor(2);
+    fusion->addInput(tv);
+    tv_sum = tv_sum == nullptr ? tv : add(tv_sum, tv);
+  }
+  fusion->addOutput(mul(tv_sum, IrBuilder::create<Val>(2.0)));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  std::vector<c10::IValue> inputs;
+  at::Tensor ref = at::zeros({256, 33}, options);
+  for (int64_t i = 0; i < num_inputs; ++i) {
+    at::Tensor t = at::randn({256, 33}, options);
+    ref = ref + t;
+    inputs.emplace_back(t);
+  }
+
+  FusionExecutorCache fec(std::move(fusion));
+  // The first run packs the argument buffers and the second one the launch
+  // plan of the executor entry
+  for (int run = 0; run < 2; ++run) {
+    auto outputs = fec.runFusionWithInputs(inputs);
+    testValidate(
+        fec.fusion(), outputs, inputs, {ref * 2.0}, __LINE__, __FILE__);
+  }
+
+  const FusionExecutor& fe =
+      fec.getMostRecentKernelRuntime()->executors().front();
+  EXPECT_THAT(fe.kernelString(), testing::HasSubstr("spilled_args->T0"));
+}
+
+// Executors of identical fusions share their compiled kernel, see
+// [ Kernel Deduplication ]
+TEST_F(NVFuserTest, KernelDeduplication) {
+  auto make_fusion = []() {
+    auto fusion = std::make_unique<Fusion>();
+    FusionGuard fg(fusion.get());
+    auto tv0 = makeSymbolicTensor(2);
+    auto tv1 = makeSymbolicTensor(1);
+    fusion->addInput(tv0);
+    fusion->addInput(tv1);
+    auto tv2 = add(tv0, broadcast(tv1, {true, false}));
+    fusion->addOutput(tanh(tv2));
+    return fusion;
+  };
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({128, 256}, options);
+  at::Tensor t1 = at::randn({256}, options);
+  std::vector<c10::IValue> inputs = {t0, t1};
+
+  auto compile = [&](std::unique_ptr<FusionExecutorCache>& fec) {
+    fec = std::make_unique<FusionExecutorCache>(make_fusion());
+    auto outputs = fec->runFusionWithInputs(inputs);
+    testValidate(
+        fec->fusion(),
+        outputs,
+        inputs,
+        {at::tanh(t0 + t1.unsqueeze(0))},
+        __LINE__,
+        __FILE__);
+    return &fec->getMostRecentKernelRuntime()
+                ->executors()
+                .front()
+                .compiledKernel();
+  };
+
+  std::unique_ptr<FusionExecutorCache> fec0;
+  std::unique_ptr<FusionExecutorCache> fec1;
+  const auto compiled_kernel0 = compile(fec0);
+  const auto compiled_kernel1 = compile(fec1);
+  EXPECT_EQ(compiled_kernel0, compiled_kernel1);
+
+  DisableOptionsGuard opt_guard;
+  DisableOptionsGuard::getCurOptions().set(DisableOption::KernelDeduplication);
+  std::unique_ptr<FusionExecutorCache> fec2;
+  const auto compiled_kernel2 = compile(fec2);
+  EXPECT_NE(compiled_kernel0->module, compiled_kernel2->module);
+}
+
+// A kernel compiled for one device is loaded, not compiled again, on other
+// devices of the same architecture, see [ Kernel Deduplication ]
+TEST_F(NVFuserTest, KernelSharingAcrossDevices) {
+  if (at::cuda::getNumGPUs() < 2) {
+    GTEST_SKIP() << "requires at least two GPUs";
+  }
+  const auto prop0 = at::cuda::getDeviceProperties(0);
+  const auto prop1 = at::cuda::getDeviceProperties(1);
+  if (prop0->major != prop1->major || prop0->minor != prop1->minor) {
+    GTEST_SKIP() << "requires two GPUs of the same architecture";
+  }
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  auto tv0 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+  fusion->addOutput(sin(tv0));
+  FusionExecutorCache fec(std::move(fusion));
+
+  std::vector<const executor_utils::CompiledKernel*> compiled_kernels;
+  for (int64_t device : {0, 1}) {
+    auto options =
+        at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, device);
+    at::Tensor t0 = at::randn({64, 128}, options);
+    c10::cuda::CUDAGuard device_guard((c10::DeviceIndex)device);
+    auto outputs = fec.runFusionWithInputs({t0});
+    testValidate(fec.fusion(), outputs, {t0}, {t0.sin()}, __LINE__, __FILE__);
+    compiled_kernels.push_back(&fec.getMostRecentKernelRuntime()
+                                    ->executors()
+                                    .front()
+                                    .compiledKernel());
+  }
+
+  EXPECT_NE(compiled_kernels.at(0)->module, compiled_kernels.at(1)->module);
+  EXPECT_EQ(
+      compiled_kernels.at(0)->kernel_name, compiled_kernels.at(1)->kernel_name);
+  EXPECT_EQ(compiled_kernels.at(0)->cubin, compiled_kernels.at(1)->cubin);
+  EXPECT_EQ(compiled_kernels.at(0)->ptx, compiled_kernels.at(1)->ptx);
+}
+
+// The module of a deserialized kernel is only loaded at its first launch, see
+// [ Lazy Module Loading ]
+TEST_F(NVFuserTest, LazyModuleLoading) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+  auto tv0 = makeSymbolicTensor(1);
+  fusion.addInput(tv0);
+  auto tv1 = exp(tv0);
+  fusion.addOutput(tv1);
+  tv1->split(0, 128);
+  tv1->axis(0)->parallelize(ParallelType::BIDx);
+  tv1->axis(1)->parallelize(ParallelType::TIDx);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({1000}, options);
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, {t0});
+  fe.runFusion({t0});
+  EXPECT_EQ(fe.launchCount(), 1);
+
+  flatbuffers::FlatBufferBuilder builder;
+  builder.Finish(fe.serialize(builder));
+  auto buffer =
+      flatbuffers::GetRoot<serde::FusionExecutor>(builder.GetBufferPointer());
+
+  FusionExecutor deserialized_fe;
+  deserialized_fe.deserialize(
+      buffer,
+      &fusion,
+      0,
+      CompileParams(),
+      static_cast<ScheduleHeuristic>(buffer->heuristic()),
+      buffer->fusion_id(),
+      buffer->concrete_id(),
+      buffer->runtime_id(),
+      buffer->group_id());
+  EXPECT_TRUE(deserialized_fe.isCompiled());
+  EXPECT_EQ(deserialized_fe.compiledKernel().module, nullptr);
+  EXPECT_EQ(deserialized_fe.launchCount(), 1);
+
+  auto outputs = deserialized_fe.runFusion({t0});
+  EXPECT_NE(deserialized_fe.compiledKernel().module, nullptr);
+  EXPECT_EQ(deserialized_fe.launchCount(), 2);
+  testValidate(&fusion, outputs, {t0}, {t0.exp()}, __LINE__, __FILE__);
+}
+
+// The function is configured for the largest dynamic shared memory of all
+// executor entries at the first launch, so launches of the others don't
+// change it
+TEST_F(NVFuserTest, DynamicSmemOfAllEntries) {
+  const int64_t large_size = 16384;
+  if ((int64_t)at::cuda::getCurrentDeviceProperties()->sharedMemPerBlockOptin <
+      (large_size + 1024) * (int64_t)sizeof(float)) {
+    GTEST_SKIP() << "Not enough shared memory";
+  }
+
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+  auto tv0 = makeSymbolicTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = set(tv0);
+  auto tv2 = set(tv1);
+  fusion.addOutput(tv2);
+  tv1->setMemoryType(MemoryType::Shared);
+  tv1->split(1, 128);
+  tv2->split(1, 128);
+  tv1->computeAt(tv2, 1);
+  for (auto tv : {tv1, tv2}) {
+    tv->axis(0)->parallelize(ParallelType::BIDx);
+    tv->axis(2)->parallelize(ParallelType::TIDx);
+  }
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t_small = at::randn({2, 1024}, options);
+  at::Tensor t_large = at::randn({2, large_size}, options);
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, {t_large});
+  fe.runFusion({t_small}, LaunchParams(), CompileParams(), 0);
+  fe.runFusion({t_large}, LaunchParams(), CompileParams(), 1);
+  const int64_t large_smem = fe.lastLaunchParams().smem();
+  EXPECT_GE(large_smem, large_size * (int64_t)sizeof(float));
+
+  flatbuffers::FlatBufferBuilder builder;
+  builder.Finish(fe.serialize(builder));
+  auto buffer =
+      flatbuffers::GetRoot<serde::FusionExecutor>(builder.GetBufferPointer());
+
+  // The entry of the small input is launched first
+  FusionExecutor deserialized_fe;
+  deserialized_fe.deserialize(
+      buffer,
+      &fusion,
+      0,
+      CompileParams(),
+      static_cast<ScheduleHeuristic>(buffer->heuristic()),
+      buffer->fusion_id(),
+      buffer->concrete_id(),
+      buffer->runtime_id(),
+      buffer->group_id());
+  auto outputs =
+      deserialized_fe.runFusion({t_small}, LaunchParams(), CompileParams(), 0);
+  EXPECT_GE(
+      deserialized_fe.compiledKernel().max_dynamic_smem_size, large_smem);
+  testValidate(&fusion, outputs, {t_small}, {t_small}, __LINE__, __FILE__);
+
+  outputs =
+      deserialized_fe.runFusion({t_large}, LaunchParams(), CompileParams(), 1);
+  testValidate(&fusion, outputs, {t_large}, {t_large}, __LINE__, __FILE__);
+}
+
+// A serialized kernel is only loaded if it was compiled by a compatible
+// NVRTC. See [ Versioned Kernel Entries ]
+TEST_F(NVFuserTest, VersionedKernelEntries) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+  auto tv0 = makeSymbolicTensor(1);
+  fusion.addInput(tv0);
+  auto tv1 = exp(tv0);
+  fusion.addOutput(tv1);
+  tv1->split(0, 128);
+  tv1->axis(0)->parallelize(ParallelType::BIDx);
+  tv1->axis(1)->parallelize(ParallelType::TIDx);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({1000}, options);
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, {t0});
+  const executor_utils::CompiledKernel& compiled_kernel = fe.compiledKernel();
+
+  int nvrtc_major = 0, nvrtc_minor = 0;
+  NVFUSER_NVRTC_SAFE_CALL(nvrtcVersion(&nvrtc_major, &nvrtc_minor));
+
+  // Whether a CudaKernel of the kernel compiled by the given NVRTC is loaded
+  auto loads = [&](int64_t major, int64_t minor) {
+    flatbuffers::FlatBufferBuilder builder;
+    std::vector<uint8_t> cubin(
+        compiled_kernel.cubin.begin(), compiled_kernel.cubin.end());
+    std::vector<uint8_t> ptx(
+        compiled_kernel.ptx.begin(), compiled_kernel.ptx.end());
+    builder.Finish(serde::CreateCudaKernelDirect(
+        builder,
+        compiled_kernel.kernel_name.c_str(),
+        compiled_kernel.compile_args.c_str(),
+        cubin.empty() ? nullptr : &cubin,
+        compiled_kernel.cubin_filename.c_str(),
+        ptx.empty() ? nullptr : &ptx,
+        compiled_kernel.ptx_filename.c_str(),
+        compiled_kernel.block_size,
+        major,
+        minor));
+    CompileParams compile_params;
+    compile_params.index_type = fe.kernel()->indexType();
+    return executor_utils::getCompiledKernel(
+               flatbuffers::GetRoot<serde::CudaKernel>(
+                   builder.GetBufferPointer()),
+               compile_params) != nullptr;
+  };
+
+  EXPECT_TRUE(loads(nvrtc_major, nvrtc_minor));
+  // Cubins are kept across minor versions, PTX isn't
+  EXPECT_EQ(
+      loads(nvrtc_major, nvrtc_minor + 1), !compiled_kernel.cubin.empty());
+  EXPECT_FALSE(loads(nvrtc_major + 1, nvrtc_minor));
+  // Buffers written before the version was serialized
+  EXPECT_FALSE(loads(-1, -1));
+}
+
+// The parameters of the schedulers are kept across serialization, see
+// [ Serialized Heuristics ]
+TEST_F(NVFuserTest, SerializedHeuristicParams) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+  auto tv0 = makeContigTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = sum(tv0, {1});
+  fusion.addOutput(tv1);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({129, 1000}, options);
+
+  auto round_trip = [](const HeuristicParams& params) {
+    flatbuffers::FlatBufferBuilder builder;
+    builder.Finish(serde::serializeHeuristicParams(builder, params));
+    return serde::deserializeHeuristicParams(
+        flatbuffers::GetRoot<serde::HeuristicParams>(
+            builder.GetBufferPointer()));
+  };
+
+  auto rparams = getReductionHeuristics(&fusion, {t0});
+  ASSERT_NE(rparams, nullptr);
+  rparams->cparams.extent_divisors = {1, 8};
+  auto deserialized_rparams = round_trip(*rparams);
+  ASSERT_NE(deserialized_rparams, nullptr);
+  EXPECT_TRUE(rparams->sameAs(deserialized_rparams));
+  EXPECT_EQ(rparams->lparams, deserialized_rparams->lparams);
+  EXPECT_EQ(rparams->tag, deserialized_rparams->tag);
+
+  TransposeParams tparams;
+  tparams.split_before_tiling = {{0, 4}, {2, 8}};
+  tparams.dims_merged_with_1 = {1};
+  tparams.dims_merged_with_2 = {3, 4};
+  tparams.vectorize_factor1 = 4;
+  tparams.tile_size2 = 64;
+  auto deserialized_tparams = round_trip(tparams);
+  ASSERT_NE(deserialized_tparams, nullptr);
+  EXPECT_TRUE(tparams.sameAs(deserialized_tparams));
+
+  // The parameters of the other schedulers are computed again
+  NoOpHeuristic no_op_params;
+  EXPECT_EQ(round_trip(no_op_params), nullptr);
+}
+
+// Scans fuse with their pointwise producers and consumers, see
+// [ Scan Scheduler ]
+TEST_F(NVFuserTest, FusionCumsumPointwise_CUDA) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  Fusion& fusion = *fusion_ptr.get();
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeContigTensor(2, DataType::Half);
+  fusion.addInput(tv0);
+  auto tv1 = exp(castOp(DataType::Float, tv0));
+  auto tv2 = cumsum(tv1, /*dim=*/-1);
+  auto tv3 = mul(tv2, IrBuilder::create<Val>(0.5));
+  fusion.addOutput(tv3);
+
+  FusionExecutorCache fec(std::move(fusion_ptr));
+  auto options = at::TensorOptions().dtype(at::kHalf).device(at::kCUDA, 0);
+  // Rows that don't fill the threads of their warps, and longer rows
+  for (int64_t row_size : {7, 1000, 10000}) {
+    auto t0 = at::randn({257, row_size}, options);
+    std::vector<c10::IValue> inputs({t0});
+    auto cg_outputs = fec.runFusionWithInputs(inputs);
+
+    validateSegmentation(
+        fec.getMostRecentKernelRuntime(), {ScheduleHeuristic::Scan});
+
+    auto ref = at::cumsum(t0.to(at::kFloat).exp(), -1) * 0.5;
+    testValidate(
+        fec.fusion(), cg_outputs, inputs, {ref}, __LINE__, __FILE__);
+  }
+}
+
+// The cumulative distribution of the probabilities of each row
+TEST_F(NVFuserTest, FusionCumsumNormalized_CUDA) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  Fusion& fusion = *fusion_ptr.get();
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeContigTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = cumsum(tv0, /*dim=*/1);
+  auto tv2 = sum(tv0, {1});
+  auto tv3 = broadcast(tv2, {false, true});
+  auto tv4 = div(tv1, tv3);
+  auto tv5 = cumprod(tv0, /*dim=*/1);
+  fusion.addOutput(tv4);
+  fusion.addOutput(tv5);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::rand({100, 300}, options) + 0.5;
+  std::vector<c10::IValue> inputs({t0});
+
+  FusionExecutorCache fec(std::move(fusion_ptr));
+  auto cg_outputs = fec.runFusionWithInputs(inputs);
+
+  validateSegmentation(
+      fec.getMostRecentKernelRuntime(), {ScheduleHeuristic::Scan});
+
+  auto ref_cdf = at::cumsum(t0, 1) / t0.sum({1}, /*keepdim=*/true);
+  auto ref_cumprod = at::cumprod(t0, 1);
+  testValidate(
+      fec.fusion(),
+      cg_outputs,
+      inputs,
+      {ref_cdf, ref_cumprod},
+      __LINE__,
+      __FILE__);
+}
+
+// The inlined path of a non-divisible unswitched loop nest should be
+// predicated per iteration of its unrolled loop
+TEST_F(NVFuserTest, FusionTailPeeling_CUDA) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::TailPeeling);
+
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeContigTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = set(tv0);
+  auto tv2 = add(tv1, IrBuilder::create<Val>(1.0));
+  auto tv3 = set(tv2);
+  fusion.addOutput(tv3);
+
+  // [BIDx, US{1}, U{4}, TIDx, V{4}]
+  tv3->split(1, 4);
+  tv3->split(0, 4);
+  tv3->split(0, 1);
+  TransformPropagatorWithCheck propagator(tv3);
+  MaxRootDomainInfoSpanningTree(tv3).traverse(&propagator);
+
+  tv3->axis(0)->parallelize(ParallelType::BIDx);
+  tv3->axis(1)->parallelize(ParallelType::Unswitch);
+  tv3->axis(2)->parallelize(ParallelType::Unroll);
+  tv3->axis(3)->parallelize(ParallelType::TIDx);
+  scheduler_utils::parallelizeAllLike(tv3);
+  tv1->axis(-1)->parallelize(ParallelType::Vectorize);
+  tv3->axis(-1)->parallelize(ParallelType::Vectorize);
+
+  inlineMost();
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({129, 256}, options);
+
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, {t0});
+  auto cg_outputs = fe.runFusion({t0});
+
+  // The unswitched path, and the unpredicated and predicated path of the
+  // peeled loop
+  const auto kernel_code = fe.kernelString();
+  int64_t num_loads = 0;
+  for (auto pos = kernel_code.find("loadGlobalToLocal<");
+       pos != std::string::npos;
+       pos = kernel_code.find("loadGlobalToLocal<", pos + 1)) {
+    num_loads++;
+  }
+  EXPECT_EQ(num_loads, 3) << kernel_code;
+
+  testValidate(&fusion, cg_outputs, {t0}, __LINE__, __FILE__);
+}
+
+// Splits that are divisible for the size class of the inputs don't need
+// predicates. See [ Size-Specialized Predicate Elimination ]
+TEST_F(NVFuserTest, FusionSizeSpecialization_CUDA) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::SizeSpecialization);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = add(tv0, IrBuilder::create<Val>(1.0));
+  fusion->addOutput(tv1);
+
+  FusionExecutorCache fec(std::move(fusion));
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+
+  auto count_predicates = [&](const std::vector<int64_t>& shape) {
+    at::Tensor t0 = at::randn(shape, options);
+    auto outputs = fec.runFusionWithInputs({t0});
+    testValidate(fec.fusion(), outputs, {t0}, __LINE__, __FILE__);
+
+    auto runtime = fec.getMostRecentKernelRuntime();
+    const auto& scheduler_entry =
+        runtime->schedulerHeuristics()->heuristicsList().at(0);
+    EXPECT_EQ(scheduler_entry->params()->cparams.extent_divisors.size(), 2);
+
+    const auto kernel_code = runtime->executors().at(0).kernelString();
+    int64_t num_predicates = 0;
+    for (auto pos = kernel_code.find("if (");
+         pos != std::string::npos;
+         pos = kernel_code.find("if (", pos + 1)) {
+      num_predicates++;
+    }
+    return num_predicates;
+  };
+
+  const auto num_divisible_predicates = count_predicates({1024, 1024});
+  const auto num_non_divisible_predicates = count_predicates({1023, 1025});
+  EXPECT_LT(num_divisible_predicates, num_non_divisible_predicates);
+
+  // Each size class gets its own kernel
+  EXPECT_EQ(fec.getKernelRuntimes().begin()->second.size(), 2);
+}
+
+// With a divisor given to the option, extents that are multiples of it share
+// a specialized kernel, and the others fall back to a generic kernel
+TEST_F(NVFuserTest, FusionSizeSpecializationDivisor_CUDA) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(
+      EnableOption::SizeSpecialization, {"128"});
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = add(tv0, IrBuilder::create<Val>(1.0));
+  fusion->addOutput(tv1);
+
+  FusionExecutorCache fec(std::move(fusion));
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+
+  auto run = [&](const std::vector<int64_t>& shape) {
+    at::Tensor t0 = at::randn(shape, options);
+    auto outputs = fec.runFusionWithInputs({t0});
+    testValidate(fec.fusion(), outputs, {t0}, __LINE__, __FILE__);
+    return fec.getMostRecentKernelRuntime()
+        ->schedulerHeuristics()
+        ->heuristicsList()
+        .at(0)
+        ->params()
+        ->cparams.extent_divisors;
+  };
+
+  EXPECT_EQ(run({256, 1024}), std::vector<int64_t>({128, 128}));
+  EXPECT_EQ(run({384, 4096}), std::vector<int64_t>({128, 128}));
+  EXPECT_EQ(run({64, 1000}), std::vector<int64_t>({1, 1}));
+  EXPECT_EQ(run({1023, 1025}), std::vector<int64_t>({1, 1}));
+  EXPECT_EQ(run({128, 1000}), std::vector<int64_t>({128, 1}));
+}
+
+// See [ Profiling of Top-Level Expressions ]
+TEST_F(NVFuserTest, FusionKernelProfileLoops_CUDA) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(
+      EnableOption::KernelProfile, {"loops"});
+
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = add(tv0, IrBuilder::create<Val>(1.0));
+  auto tv2 = add(tv1, IrBuilder::create<Val>(1.0));
+  fusion.addOutput(tv2);
+
+  // Two top-level loop nests
+  tv1->setMemoryType(MemoryType::Global);
+  for (auto tv : {tv1, tv2}) {
+    tv->split(1, 128);
+    tv->axis(-1)->parallelize(ParallelType::TIDx);
+    tv->axis(0)->parallelize(ParallelType::BIDx);
+  }
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({8, 1000}, options);
+
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, {t0});
+  EXPECT_GE(fe.kernel()->profile().getNumberOfProfileEntries(), 2);
+  EXPECT_THAT(fe.kernelString(), testing::HasSubstr("startProfiledRegion()"));
+
+  std::stringstream ss;
+  std::vector<at::Tensor> cg_outputs;
+  {
+    DebugStreamGuard dsg(ss);
+    cg_outputs = fe.runFusion({t0});
+  }
+  EXPECT_THAT(ss.str(), testing::HasSubstr("Timeline of the last"));
+
+  testValidate(&fusion, cg_outputs, {t0}, __LINE__, __FILE__);
+}
+
+// Alternating between register caps reuses the kernels compiled for them
+TEST_F(NVFuserTest, FusionRecompileAlternatingMaxRegCount_CUDA) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  TensorView* tv0 = makeContigTensor(1);
+  fusion->addInput(tv0);
+  TensorView* tv1 = add(tv0, IrBuilder::create<Val>(1.0));
+  fusion->addOutput(tv1);
+  tv1->split(0, 128);
+  tv1->axis(0)->parallelize(ParallelType::BIDx);
+  tv1->axis(1)->parallelize(ParallelType::TIDx);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({1000}, options);
+
+  FusionExecutor fe;
+  CompileParams compile_params_32 = {.maxrregcount = 32};
+  CompileParams compile_params_64 = {.maxrregcount = 64};
+  fe.compileFusion(fusion.get(), {t0}, LaunchParams(), compile_params_32);
+  auto kernel_32 = fe.compiledKernel().function;
+
+  auto outputs = fe.runFusion({t0}, LaunchParams(), compile_params_64);
+  testValidate(fusion.get(), outputs, {t0}, {t0 + 1}, __LINE__, __FILE__);
+  auto kernel_64 = fe.compiledKernel().function;
+  EXPECT_NE(kernel_64, kernel_32);
+
+  outputs = fe.runFusion({t0}, LaunchParams(), compile_params_32);
+  testValidate(fusion.get(), outputs, {t0}, {t0 + 1}, __LINE__, __FILE__);
+  EXPECT_EQ(fe.compiledKernel().function, kernel_32);
+
+  outputs = fe.runFusion({t0}, LaunchParams(), compile_params_64);
+  EXPECT_EQ(fe.compiledKernel().function, kernel_64);
+}
+
+// The compile profile breaks down the first run of a fusion by traced scope
+TEST_F(NVFuserTest, FusionCompileProfile_CUDA) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  TensorView* tv0 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+  TensorView* tv1 = sum(add(tv0, IrBuilder::create<Val>(1.0)), {1});
+  fusion->addOutput(tv1);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({128, 1024}, options);
+
+  inst::Trace* trace = inst::Trace::instance();
+  const bool recorded_profile = trace->recordsProfile();
+  trace->resetProfile();
+  trace->setRecordProfile(true);
+  FusionExecutorCache fec(std::move(fusion));
+  auto outputs = fec.runFusionWithInputs({t0});
+  trace->setRecordProfile(recorded_profile);
+  testValidate(
+      fec.fusion(), outputs, {t0}, {(t0 + 1).sum({1})}, __LINE__, __FILE__);
+
+  std::unordered_map<std::string, inst::ScopeProfile> scopes;
+  for (const auto& entry : trace->profile()) {
+    EXPECT_GT(entry.count, 0);
+    EXPECT_LE(entry.self_ms, entry.total_ms + 1e-6);
+    scopes.emplace(entry.name, entry);
+  }
+  for (const char* name :
+       {"FusionExecutorCache::runFusionWithInputs",
+        "RemoveEmptyPass",
+        "GpuLower::lower",
+        "GpuLower::run",
+        "LoopNestGenerator",
+        "FusionExecutor::compileFusion"}) {
+    EXPECT_EQ(scopes.count(name), 1) << "Missing scope " << name;
+  }
+  EXPECT_GE(
+      scopes.at("FusionExecutorCache::runFusionWithInputs").total_ms,
+      scopes.at("GpuLower::run").total_ms);
+  trace->resetProfile();
+}
+
+// Independent lowering analyses running concurrently give the same kernel
+TEST_F(NVFuserTest, FusionParallelLowering_CUDA) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  TensorView* tv0 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+  TensorView* tv1 = softmax(tv0, 1);
+  fusion->addOutput(tv1);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({256, 1024}, options);
+
+  // Kernels of both caches get the same name
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::StaticFusionCount);
+  std::string serial_code;
+  {
+    FusionExecutorCache fec(std::make_unique<Fusion>(*fusion));
+    fec.runFusionWithInputs({t0});
+    serial_code = fec.getMostRecentCode();
+  }
+
+  EnableOptionsGuard::getCurOptions().set(EnableOption::ParallelLowering);
+  FusionExecutorCache fec(std::move(fusion));
+  auto outputs = fec.runFusionWithInputs({t0});
+  testValidate(
+      fec.fusion(), outputs, {t0}, {at::softmax(t0, 1)}, __LINE__, __FILE__);
+  EXPECT_EQ(fec.getMostRecentCode(), serial_code);
+}
+
+// A row longer than a chunk and not a multiple of it, with a chunk of only
+// -inf as with masked tokens. See [ Online Softmax ].
+TEST_F(NVFuserTest, FusionOnlineSoftmax_CUDA) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::OnlineSoftmax);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  TensorView* tv0 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+  fusion->addOutput(softmax(tv0, 1));
+  fusion->addOutput(log_softmax(tv0, 1));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({16, 128 * 1024 + 7}, options);
+  t0.index({0, at::indexing::Slice(0, 8192)}).fill_(-INFINITY);
+
+  FusionExecutorCache fec(std::move(fusion));
+  auto outputs = fec.runFusionWithInputs({t0});
+  testValidate(
+      fec.fusion(),
+      outputs,
+      {t0},
+      {at::softmax(t0, 1), at::log_softmax(t0, 1)},
+      __LINE__,
+      __FILE__);
+}
+
+// Slices at offsets of 0, 1 and 2 floats are aligned to allow vectorization
+// factors of 4, 1 and 2. The last one reuses the kernel compiled for the
+// second instead of compiling a third. See
+// [ Alignment Tolerant Kernel Reuse ].
+TEST_F(NVFuserTest, FusionAlignmentTolerantReuse_CUDA) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::AlignmentTolerantReuse);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  TensorView* tv0 = makeSymbolicTensor(1);
+  fusion->addInput(tv0);
+  fusion->addOutput(add(tv0, IrBuilder::create<Val>(1.0)));
+
+  FusionExecutorCache fec(std::move(fusion));
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  const int64_t n = 1024 * 1024;
+  at::Tensor base = at::randn({n + 2}, options);
+
+  for (int64_t offset : {0, 1, 2}) {
+    at::Tensor t0 = base.slice(0, offset, offset + n);
+    auto outputs = fec.runFusionWithInputs({t0});
+    testValidate(fec.fusion(), outputs, {t0}, __LINE__, __FILE__);
+  }
+  EXPECT_EQ(fec.getKernelRuntimes().begin()->second.size(), 2);
+}
+
+// Slices of a fused projection at the same odd offset can't be vectorized by
+// the regular pointwise schedule, but can with MisalignedVectorize
+TEST_F(NVFuserTest, FusionPointwiseMisalignedVectorize_CUDA) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::MisalignedVectorize);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  TensorView* tv0 =
+      TensorViewBuilder().contiguity({false, true}).ndims(2).build();
+  TensorView* tv1 =
+      TensorViewBuilder().contiguity({false, true}).ndims(2).build();
+  fusion->addInput(tv0);
+  fusion->addInput(tv1);
+  fusion->addOutput(add(tv0, tv1));
+
+  FusionExecutorCache fec(std::move(fusion));
+  fec.profile(true);
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  const int64_t n = 1024;
+  const int64_t h = 1024;
+  at::Tensor base0 = at::randn({n, h + 1}, options);
+  at::Tensor base1 = at::randn({n, h + 1}, options);
+  at::Tensor t0 = base0.slice(1, 1, h + 1);
+  at::Tensor t1 = base1.slice(1, 1, h + 1);
+
+  auto outputs = fec.runFusionWithInputs({t0, t1});
+  auto params = fec.getMostRecentExecutorInfo().params->as<PointwiseParams>();
+  ASSERT_NE(params, nullptr);
+  EXPECT_TRUE(params->misaligned_vectorize);
+  EXPECT_EQ(params->unroll_factor, 4);
+  testValidate(fec.fusion(), outputs, {t0, t1}, __LINE__, __FILE__);
+
+  // Different offsets are not peeled by the same number of elements
+  at::Tensor t2 = base1.slice(1, 0, h);
+  outputs = fec.runFusionWithInputs({t0, t2});
+  params = fec.getMostRecentExecutorInfo().params->as<PointwiseParams>();
+  ASSERT_NE(params, nullptr);
+  EXPECT_FALSE(params->misaligned_vectorize);
+  testValidate(fec.fusion(), outputs, {t0, t2}, __LINE__, __FILE__);
+}
+
+// Reductions of any size reuse the kernel compiled for the first one with
+// GenericKernels
+TEST_F(NVFuserTest, FusionGenericReductionKernel_CUDA) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::GenericKernels);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  TensorView* tv0 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  fusion->addOutput(sum(tv0, {1}));
+
+  FusionExecutorCache fec(std::move(fusion));
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  for (auto [m, n] : std::vector<std::pair<int64_t, int64_t>>{
+           {1024, 4096}, {7, 100003}, {100003, 7}, {2, 3}}) {
+    at::Tensor t0 = at::randn({m, n}, options);
+    auto outputs = fec.runFusionWithInputs({t0});
+    testValidate(
+        fec.fusion(), outputs, {t0}, {t0.sum({1})}, __LINE__, __FILE__);
+  }
+  EXPECT_EQ(fec.getKernelRuntimes().begin()->second.size(), 1);
+}
+
+// Block-wise FP8 quantization with a scale per group of 128 elements. Each
+// group is reduced by a warp segment, see [ Small Group Persistence ]
+TEST_F(NVFuserTest, FusionBlockwiseQuantization_CUDA) {
+  const int64_t m = 1000;
+  const int64_t k = 1024;
+  const int64_t group = 128;
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  auto tv0 = makeContigConcreteTensor({m, k}, DataType::BFloat16);
+  fusion->addInput(tv0);
+  auto tv1 =
+      castOp(DataType::Float, reshape(tv0, {m, k}, {m, k / group, group}));
+  auto tv2 = max(abs(tv1), {2});
+  auto tv3 = div(tv2, IrBuilder::create<Val>(448.0));
+  auto tv4 = div(tv1, broadcast(tv3, {false, false, true}));
+  auto tv5 = castOp(DataType::Float8_e4m3fn, tv4);
+  fusion->addOutput(tv5);
+  fusion->addOutput(tv3);
+
+  auto options = at::TensorOptions().dtype(at::kBFloat16).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({m, k}, options);
+
+  FusionExecutorCache fec(std::move(fusion));
+  auto outputs = fec.runFusionWithInputs({t0});
+
+  auto runtime = fec.getMostRecentKernelRuntime();
+  EXPECT_FALSE(runtime->isSegmented());
+  const auto& scheduler_entry =
+      runtime->schedulerHeuristics()->heuristicsList().at(0);
+  EXPECT_EQ(scheduler_entry->heuristic(), ScheduleHeuristic::InnerPersistent);
+  auto rparams = scheduler_entry->params()->as<ReductionParams>();
+  EXPECT_TRUE(rparams->cparams.enable_warp_segment_reduction);
+  EXPECT_TRUE(rparams->vectorize_inner_reduction);
+  const auto kernel_code = runtime->executors().at(0).kernelString();
+  EXPECT_THAT(kernel_code, testing::HasSubstr("warpSegmentReduceTIDX"));
+  EXPECT_THAT(kernel_code, testing::Not(testing::HasSubstr("blockReduce")));
+
+  at::Tensor t1 = t0.to(at::kFloat).view({m, k / group, group});
+  at::Tensor ref_scale = t1.abs().amax({2}).div(448.0);
+  at::Tensor ref =
+      t1.div(ref_scale.unsqueeze(-1)).to(at::ScalarType::Float8_e4m3fn);
+  EXPECT_TRUE(at::equal(outputs.at(1), ref_scale));
+  EXPECT_TRUE(at::equal(outputs.at(0).to(at::kFloat), ref.to(at::kFloat)));
+}
+
+// Long rows are reduced into several partial results per thread, see
+// [ Reduction Accumulators ]
+TEST_F(NVFuserTest, FusionReductionAccumulators_CUDA) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  auto tv0 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = sum(tv0, {1});
+  auto tvs = Welford(tv0, {1});
+  fusion->addOutput(tv1);
+  fusion->addOutput(tvs.avg);
+  fusion->addOutput(tvs.var_sum);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({1024, 16384}, options);
+
+  FusionExecutorCache fec(std::move(fusion));
+  auto outputs = fec.runFusionWithInputs({t0});
+
+  auto runtime = fec.getMostRecentKernelRuntime();
+  ASSERT_FALSE(runtime->isSegmented());
+  const auto& heuristic =
+      runtime->schedulerHeuristics()->heuristicsList().at(0);
+  ASSERT_EQ(heuristic->heuristic(), ScheduleHeuristic::Reduction);
+  EXPECT_GT(heuristic->reductionParams().accumulators_inner_reduction, 1);
+
+  testValidate(
+      fec.fusion(),
+      outputs,
+      {t0},
+      {t0.sum({1}),
+       t0.mean({1}),
+       t0.var({1}, /*unbiased=*/false) * t0.size(1)},
+      __LINE__,
+      __FILE__);
+}
+
+// The rows of threadIdx.y only communicate through their own part of a shared
+// memory tensor, so they synchronize separately, see [ Row Barriers ]
+TEST_F(NVFuserTest, FusionRowBarriers_CUDA) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::NamedBarriers);
+
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+  auto tv0 = makeContigTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = set(tv0);
+  auto tv2 = sum(tv1, {1});
+  fusion.addOutput(tv2);
+
+  // [serial, TIDy{4}, TIDx] for tv1, which tv2 reduces serially
+  tv1->setMemoryType(MemoryType::Shared);
+  for (auto tv : {tv1, tv2}) {
+    tv->split(0, 4);
+    tv->axis(1)->parallelize(ParallelType::TIDy);
+  }
+  tv1->axis(2)->parallelize(ParallelType::TIDx);
+  inlineMost();
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({64, 128}, options);
+
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, {t0});
+  auto cg_outputs = fe.runFusion({t0});
+
+  // Both the RAW sync and the WAR sync of tv1 within the serial loop
+  EXPECT_THAT(
+      fe.kernelString(), testing::HasSubstr("block_sync::syncRow<true>()"));
+  EXPECT_THAT(
+      fe.kernelString(), testing::Not(testing::HasSubstr("__syncthreads")));
+  EXPECT_EQ(fe.kernel()->summary().war_hazard_syncs_count, 1);
+
+  testValidate(&fusion, cg_outputs, {t0}, __LINE__, __FILE__);
+}
+
+// The inputs of the next iteration of the serial reduction loop are loaded
+// into registers during the current one, see
+// [ Register Prefetched Global Loads ]
+TEST_F(NVFuserTest, FusionRegisterPrefetch_CUDA) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::RegisterPrefetch);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  auto tv0 = makeContigTensor(2);
+  auto tv1 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  fusion->addInput(tv1);
+  auto tv2 = mul(tv0, tv1);
+  auto tv3 = sum(tv2, {1});
+  fusion->addOutput(tv3);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  // The loads of the last iteration past the end of the rows are predicated
+  at::Tensor t0 = at::randn({256, 65540}, options);
+  at::Tensor t1 = at::randn({256, 65540}, options);
+
+  FusionExecutorCache fec(std::move(fusion));
+  auto outputs = fec.runFusionWithInputs({t0, t1});
+
+  auto runtime = fec.getMostRecentKernelRuntime();
+  ASSERT_FALSE(runtime->isSegmented());
+  const auto& heuristic =
+      runtime->schedulerHeuristics()->heuristicsList().at(0);
+  ASSERT_EQ(heuristic->heuristic(), ScheduleHeuristic::Reduction);
+  EXPECT_TRUE(heuristic->reductionParams().prefetch_cached_inputs);
+
+  testValidate(
+      fec.fusion(),
+      outputs,
+      {t0, t1},
+      {(t0 * t1).sum({1})},
+      __LINE__,
+      __FILE__);
+}
+
+// Two fp32 rows of 32K elements exceed both the register file and the shared
+// memory of a block, but one of them fits in each, see
+// [ Hybrid Persistent Buffers ]
+TEST_F(NVFuserTest, FusionHybridPersistentBuffers_CUDA) {
+  if (at::cuda::getCurrentDeviceProperties()->sharedMemPerBlockOptin <
+      160 * 1024) {
+    GTEST_SKIP() << "not enough shared memory";
+  }
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(
+      EnableOption::HybridPersistentBuffers);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  auto tv0 = makeContigTensor(2);
+  auto tv1 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  fusion->addInput(tv1);
+  auto tv2 = sum(mul(tv0, tv1), {1});
+  auto tv3 = broadcast(tv2, {false, true});
+  auto tv4 = add(mul(tv0, tv3), tv1);
+  fusion->addOutput(tv4);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({264, 32 * 1024}, options);
+  at::Tensor t1 = at::randn({264, 32 * 1024}, options);
+
+  FusionExecutorCache fec(std::move(fusion));
+  auto outputs = fec.runFusionWithInputs({t0, t1});
+
+  auto runtime = fec.getMostRecentKernelRuntime();
+  ASSERT_FALSE(runtime->isSegmented());
+  const auto& heuristic =
+      runtime->schedulerHeuristics()->heuristicsList().at(0);
+  ASSERT_EQ(heuristic->heuristic(), ScheduleHeuristic::InnerPersistent);
+  EXPECT_TRUE(heuristic->reductionParams().shared_mem_persistent_buffer);
+  EXPECT_EQ(heuristic->reductionParams().register_persistent_buffer_bytes, 4);
+
+  testValidate(
+      fec.fusion(),
+      outputs,
+      {t0, t1},
+      {t0 * (t0 * t1).sum({1}, /*keepdim=*/true) + t1},
+      __LINE__,
+      __FILE__);
+}
+
+// A vocabulary that is not a multiple of the number of slices. See
+// [ Linear Cross Entropy ].
+TEST_F(NVFuserTest, FusionLinearCrossEntropy_CUDA) {
+  constexpr int64_t kNumChunks = 3;
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor x = at::randn({64, 32}, options);
+  at::Tensor weight = at::randn({1000, 32}, options);
+  at::Tensor target = at::randint(0, 1000, {64}, options.dtype(at::kLong));
+  at::Tensor grad_loss = at::randn({64}, options);
+
+  at::Tensor logits = at::matmul(x, weight.t());
+  at::Tensor expected_lse = at::logsumexp(logits, {1});
+  at::Tensor expected_loss =
+      expected_lse - logits.gather(1, target.unsqueeze(1)).squeeze(1);
+  at::Tensor grad_logits =
+      (at::softmax(logits, 1) - at::one_hot(target, 1000).to(at::kFloat)) *
+      grad_loss.unsqueeze(1);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  TensorView* tv_x = makeContigTensor(2);
+  TensorView* tv_weight = makeContigTensor(2);
+  TensorView* tv_target = makeContigTensor(1, DataType::Int);
+  fusion->addInput(tv_x);
+  fusion->addInput(tv_weight);
+  fusion->addInput(tv_target);
+  auto [loss, lse] =
+      linear_cross_entropy(tv_x, tv_weight, tv_target, kNumChunks);
+  fusion->addOutput(loss);
+  fusion->addOutput(lse);
+
+  FusionExecutorCache fec(std::move(fusion));
+  auto outputs = fec.runFusionWithInputs({x, weight, target});
+  testValidate(
+      fec.fusion(),
+      outputs,
+      {x, weight, target},
+      {expected_loss, expected_lse},
+      __LINE__,
+      __FILE__);
+
+  auto bwd_fusion = std::make_unique<Fusion>();
+  FusionGuard bwd_fg(bwd_fusion.get());
+  TensorView* tv_grad_loss = makeContigTensor(1);
+  tv_x = makeContigTensor(2);
+  tv_weight = makeContigTensor(2);
+  tv_target = makeContigTensor(1, DataType::Int);
+  TensorView* tv_lse = makeContigTensor(1);
+  bwd_fusion->addInput(tv_grad_loss);
+  bwd_fusion->addInput(tv_x);
+  bwd_fusion->addInput(tv_weight);
+  bwd_fusion->addInput(tv_target);
+  bwd_fusion->addInput(tv_lse);
+  auto [grad_x, grad_weight] = linear_cross_entropy_backward(
+      tv_grad_loss, tv_x, tv_weight, tv_target, tv_lse, kNumChunks);
+  bwd_fusion->addOutput(grad_x);
+  bwd_fusion->addOutput(grad_weight);
+
+  FusionExecutorCache bwd_fec(std::move(bwd_fusion));
+  std::vector<c10::IValue> bwd_inputs = {
+      grad_loss, x, weight, target, outputs.at(1)};
+  auto bwd_outputs = bwd_fec.runFusionWithInputs(bwd_inputs);
+  testValidate(
+      bwd_fec.fusion(),
+      bwd_outputs,
+      bwd_inputs,
+      {grad_logits.matmul(weight), grad_logits.t().matmul(x)},
+      __LINE__,
+      __FILE__);
+}
+
+TEST_F(NVFuserTest, FusionMagicZeroElision_CUDA) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = add(tv0, IrBuilder::create<Val>(1.0));
+  auto tv2 = set(tv1);
+  fusion.addOutput(tv2);
+
+  // Unrolled loop of two iterations
+  tv2->split(-1, 2);
+  TransformPropagatorWithCheck propagator(tv2);
+  MaxRootDomainInfoSpanningTree(tv2).traverse(&propagator);
+  inlineMost();
+
+  {
+    GpuLower gpulw(&fusion);
+    const auto code = codegen::generateCudaKernel(gpulw.run());
+    EXPECT_THAT(code, ::testing::HasSubstr("nvfuser_zero"));
+  }
+
+  // The indices of the two iterations fit in a few registers, so they aren't
+  // protected
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::MagicZeroElision);
+  GpuLower gpulw(&fusion);
+  const auto code = codegen::generateCudaKernel(gpulw.run());
+  EXPECT_THAT(code, ::testing::Not(::testing::HasSubstr("nvfuser_zero")));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({33, 17}, options);
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, {t0});
+  auto cg_outputs = fe.runFusion({t0});
+  testValidate(&fusion, cg_outputs, {t0}, {t0 + 1}, __LINE__, __FILE__);
+}
+
+// Pending tasks of the compile thread pool run by decreasing priority
+TEST_F(NVFuserTest, FusionCompileThreadPoolPriority_CUDA) {
+  CompileThreadPool::Options options;
+  options.num_threads = 1;
+  CompileThreadPool pool(options);
+  EXPECT_FALSE(pool.inThreadPool());
+
+  // Keep the thread busy until all tasks are queued
+  std::promise<void> queued;
+  std::shared_future<void> all_queued = queued.get_future().share();
+  pool.run([all_queued]() { all_queued.wait(); });
+
+  std::mutex order_mutex;
+  std::vector<int64_t> order;
+  for (int64_t priority : {0, 2, 1, 2}) {
+    pool.run(
+        [&, priority]() {
+          EXPECT_TRUE(pool.inThreadPool());
+          std::lock_guard<std::mutex> guard(order_mutex);
+          order.push_back(priority);
+        },
+        priority);
+  }
+  queued.set_value();
+  pool.waitWorkComplete();
+
+  EXPECT_THAT(order, testing::ElementsAre(2, 2, 1, 0));
+}
+
+// The device model describes the current device, and its fields can be
+// overridden by a config file
+TEST_F(NVFuserTest, FusionDeviceModel_CUDA) {
+  const auto prop = at::cuda::getCurrentDeviceProperties();
+  const DeviceModel model = DeviceModel::fromDeviceProperties(*prop);
+  EXPECT_EQ(model.sm_count, prop->multiProcessorCount);
+  EXPECT_EQ(model.l2_size, prop->l2CacheSize);
+  EXPECT_EQ(model.registerFileSize(), prop->regsPerMultiprocessor * 4);
+  EXPECT_GT(model.dram_bandwidth, 0.0);
+  EXPECT_GE(model.l2_bandwidth, model.dram_bandwidth);
+
+  const auto path =
+      std::filesystem::temp_directory_path() / "nvfuser_device_model.txt";
+  {
+    std::ofstream config(path);
+    config << "# Half of the device\n"
+           << "sm_count = " << model.sm_count / 2 << "\n"
+           << "\n"
+           << "  l2_bandwidth=1.5e12  # measured\n";
+  }
+  DeviceModel overridden = model;
+  overridden.loadConfig(path.string());
+  std::filesystem::remove(path);
+  EXPECT_EQ(overridden.sm_count, model.sm_count / 2);
+  EXPECT_EQ(overridden.l2_bandwidth, 1.5e12);
+  EXPECT_EQ(overridden.l2_size, model.l2_size);
+  EXPECT_THAT(
+      [&]() { overridden.setField("l3_size", "1"); },
+      ::testing::ThrowsMessage<nvfuser::nvfError>(
+          ::testing::HasSubstr("Unknown device model field")));
+  EXPECT_THAT(
+      [&]() { overridden.setField("sm_count", "many"); },
+      ::testing::ThrowsMessage<nvfuser::nvfError>(
+          ::testing::HasSubstr("Invalid value")));
+
+  // The heuristics see the model set for the current device
+  setDeviceModel(overridden);
+  EXPECT_EQ(getDeviceModel().sm_count, model.sm_count / 2);
+  resetDeviceModel();
+  EXPECT_EQ(getDeviceModel().sm_count, prop->multiProcessorCount);
+}
+
+// Kernels launch with the lowering analyses released, including for sizes
+// they weren't compiled with. See [ Releasing Lowering Info ]
+TEST_F(NVFuserTest, FusionReleaseLoweringInfo_CUDA) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::ReleaseLoweringInfo);
+
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeSymbolicTensor(1);
+  fusion.addInput(tv0);
+  auto tv1 = makeSymbolicTensor(2);
+  fusion.addInput(tv1);
+  auto tv2 = broadcast(tv0, {false, true});
+  auto tv3 = add(tv2, tv1);
+  fusion.addOutput(tv3);
+
+  tv3->axis(0)->parallelize(ParallelType::BIDx);
+  tv3->axis(1)->parallelize(ParallelType::TIDx);
+  scheduler_utils::parallelizeAllLike(tv3);
+  inlineMost();
+
+  FusionExecutor fe;
+  fe.compileFusion(&fusion);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  for (auto [rows, cols] : {std::make_pair(5, 33), std::make_pair(7, 65)}) {
+    at::Tensor t0 = at::randn({rows}, options);
+    at::Tensor t1 = at::randn({rows, cols}, options);
+    std::vector<c10::IValue> aten_inputs({t0, t1});
+    auto cg_outputs = fe.runFusion(aten_inputs);
+    testValidate(&fusion, cg_outputs, aten_inputs, __LINE__, __FILE__);
+  }
+}
+
 // Test file size should be up to 10K LoC. Create a new file for more tests.
 
 } // namespace nvfuser
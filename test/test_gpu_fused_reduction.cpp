@@ -39,11 +39,13 @@
 // fuser and IR parser
 #include <ATen/cuda/CUDAContext.h>
 #include <ATen/cuda/Exceptions.h>
+#include <c10/cuda/CUDAGuard.h>
 #include <c10/cuda/CUDAStream.h>
 #include <torch/csrc/jit/codegen/cuda/interface.h>
 
 #include <algorithm>
 #include <iostream>
+#include <thread>
 
 namespace nvfuser {
 
@@ -124,6 +126,108 @@ TEST_F(NVFuserTest, FusionGridAllreduce1_CUDA) {
   testValidate(&fusion, cg_outputs, {t0}, {ref}, __LINE__, __FILE__);
 }
 
+// The semaphore of a grid reduction is reused across launches of the same
+// entry. Each launch syncs once, so every other launch starts from the
+// flipped state. See [ Persistent Semaphores ].
+TEST_F(NVFuserTest, FusionPersistentSemaphores_CUDA) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = sum(tv0, {0});
+  fusion.addOutput(tv1);
+
+  tv1->split(0, 8);
+  tv1->axis(0)->parallelize(ParallelType::BIDx);
+  tv1->axis(1)->parallelize(ParallelType::TIDy);
+  tv1->axis(2)->parallelize(ParallelType::TIDx);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({64, 32}, options);
+  std::vector<c10::IValue> inputs = {t0};
+  auto ref = t0.sum({0});
+
+  for (bool persistent : {true, false}) {
+    DisableOptionsGuard opt_guard;
+    if (!persistent) {
+      DisableOptionsGuard::getCurOptions().set(
+          DisableOption::PersistentSemaphores);
+    }
+    FusionExecutor fe;
+    fe.compileFusion(&fusion, inputs);
+    ASSERT_TRUE(fe.kernel()->summary().has_grid_reductions);
+    for (int i = 0; i < 3; ++i) {
+      auto cg_outputs = fe.runFusion(
+          inputs, LaunchParams(), CompileParams(), /*opt_code=*/0);
+      testValidate(&fusion, cg_outputs, inputs, {ref}, __LINE__, __FILE__);
+    }
+  }
+}
+
+// Threads launching the same entry of an executor at once, each on its own
+// stream, don't share semaphores nor argument buffers. See
+// [ Concurrent Launches ].
+TEST_F(NVFuserTest, FusionConcurrentLaunches_CUDA) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = sum(tv0, {0});
+  fusion.addOutput(tv1);
+
+  tv1->split(0, 8);
+  tv1->axis(0)->parallelize(ParallelType::BIDx);
+  tv1->axis(1)->parallelize(ParallelType::TIDy);
+  tv1->axis(2)->parallelize(ParallelType::TIDx);
+
+  constexpr int64_t num_threads = 4;
+  constexpr int64_t num_launches = 8;
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  std::vector<at::Tensor> inputs;
+  for (const auto i : c10::irange(num_threads)) {
+    inputs.push_back(at::randn({64, 32}, options) + (double)i);
+  }
+
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, {inputs.at(0)});
+  ASSERT_TRUE(fe.kernel()->summary().has_grid_reductions);
+
+  std::vector<std::vector<at::Tensor>> outputs(num_threads);
+  std::vector<std::thread> threads;
+  for (const auto thread_i : c10::irange(num_threads)) {
+    threads.emplace_back([&, thread_i]() {
+      c10::cuda::CUDAStreamGuard stream_guard(
+          c10::cuda::getStreamFromPool(false, 0));
+      for (const auto launch_i : c10::irange(num_launches)) {
+        (void)launch_i;
+        outputs.at(thread_i) = fe.runFusion(
+            {inputs.at(thread_i)},
+            LaunchParams(),
+            CompileParams(),
+            /*opt_code=*/0);
+      }
+      c10::cuda::getCurrentCUDAStream().synchronize();
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (const auto thread_i : c10::irange(num_threads)) {
+    std::vector<c10::IValue> aten_inputs = {inputs.at(thread_i)};
+    testValidate(
+        &fusion,
+        outputs.at(thread_i),
+        aten_inputs,
+        {inputs.at(thread_i).sum({0})},
+        __LINE__,
+        __FILE__);
+  }
+  EXPECT_EQ(fe.launchCount(), num_threads * num_launches);
+}
+
 TEST_F(NVFuserTest, FusionGridAllreduce2_CUDA) {
   const int nx = 99;
   const int tidx = 32;
@@ -381,6 +485,56 @@ TEST_F(NVFuserTest, FusionGridAllreduce6_CUDA) {
   testValidate(fe.kernel(), outputs, {t0}, {ref}, __LINE__, __FILE__);
 }
 
+// Grid allreduce in a cooperative kernel launched with thread block
+// clusters along BIDx on Hopper. See [ Cluster Grid Sync ]
+TEST_F(NVFuserTest, FusionGridAllreduceClusterSync_CUDA) {
+  const int tidx = 128;
+  const int bidx = 8;
+  const int bidy = 2;
+  const int nx = tidx * bidx * bidy;
+
+  if (bidx * bidy > deviceSMCount()) {
+    GTEST_SKIP() << "Not enough SMs to run this test";
+  }
+
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::ClusterGridSync);
+
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeSymbolicTensor(1);
+  fusion.addInput(tv0);
+
+  auto tv1 = sum(tv0, {0});
+  auto tv2 = broadcast(tv1, {true});
+  auto tv3 = add(tv0, tv2);
+
+  fusion.addOutput(tv3);
+
+  tv3->split(0, tidx);
+  tv3->split(0, bidx);
+  TransformPropagator propagator(tv3);
+  MaxRootDomainInfoSpanningTree(tv3).traverse(&propagator);
+
+  tv3->axis(0)->parallelize(ParallelType::BIDy);
+  tv3->axis(1)->parallelize(ParallelType::BIDx);
+  tv3->axis(2)->parallelize(ParallelType::TIDx);
+  scheduler_utils::parallelizeAllLike(tv3);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn({nx}, options);
+
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, {t0});
+  ASSERT_TRUE(fe.kernel()->summary().has_cooperative_grid_reduction);
+  auto cg_outputs = fe.runFusion({t0});
+
+  auto ref = sum(t0).unsqueeze(0) + t0;
+
+  testValidate(&fusion, cg_outputs, {t0}, {ref}, __LINE__, __FILE__);
+}
+
 TEST_F(NVFuserTest, FusionGridAllreduceWelford1_CUDA) {
   const int nx = 999;
   const int tidx = 128;
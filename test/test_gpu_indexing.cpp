@@ -766,4 +766,46 @@ TEST_F(NVFuserTest, FusionIndexing18_CUDA) {
   testValidate(fe.kernel(), cg_outputs, inputs, {ref}, __LINE__, __FILE__);
 }
 
+// Offsets within a block are computed in 32 bits in a 64-bit kernel
+TEST_F(NVFuserTest, FusionMixedIndexType_CUDA) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::MixedIndexType);
+
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeContigTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = set(tv0);
+  auto tv2 = add(tv1, IrBuilder::create<Val>(1.0));
+  auto tv3 = set(tv2);
+  fusion.addOutput(tv3);
+
+  // [BIDx, U{4}, TIDx{128}]
+  tv3->merge(0);
+  tv3->split(0, 128);
+  tv3->split(0, 4);
+  TransformPropagatorWithCheck propagator(tv3);
+  MaxRootDomainInfoSpanningTree(tv3).traverse(&propagator);
+  tv3->axis(0)->parallelize(ParallelType::BIDx);
+  tv3->axis(1)->parallelize(ParallelType::Unroll);
+  tv3->axis(2)->parallelize(ParallelType::TIDx);
+  scheduler_utils::parallelizeAllLike(tv3);
+  inlineMost();
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({99, 101}, options);
+  std::vector<c10::IValue> inputs = {t0};
+
+  FusionExecutor fe;
+  CompileParams compile_opts = {.index_type = PrimDataType::Int};
+  fe.compileFusion(&fusion, inputs, LaunchParams(), compile_opts);
+  EXPECT_EQ(fe.kernel()->indexType(), PrimDataType::Int);
+  EXPECT_NE(fe.kernelString().find("(int32_t)"), std::string::npos)
+      << fe.kernelString();
+
+  auto cg_outputs = fe.runFusion(inputs);
+  testValidate(&fusion, cg_outputs, inputs, __LINE__, __FILE__);
+}
+
 } // namespace nvfuser
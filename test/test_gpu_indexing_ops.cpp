@@ -10,6 +10,7 @@
 
 #include <kernel_cache.h>
 #include <ops/all_ops.h>
+#include <scheduler/pointwise_heuristic.h>
 #include <test/utils.h>
 #include <test/validator.h>
 
@@ -672,4 +673,47 @@ TEST_F(NVFuserTest, MultipleIndexSelectIssue_CUDA) {
   testValidate(&fusion, outputs, aten_inputs, __LINE__, __FILE__);
 }
 
+// An embedding lookup is read along its rows, which are contiguous, so the
+// index_select can be vectorized like a load of a fusion input
+TEST_F(NVFuserTest, IndexSelectVectorizeEmbedding_CUDA) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  Fusion& fusion = *fusion_ptr.get();
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeContigTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = makeContigTensor(1, DataType::Int);
+  fusion.addInput(tv1);
+  auto tv2 = makeContigTensor(2);
+  fusion.addInput(tv2);
+
+  auto tv3 = index_select(tv0, 0, tv1);
+  auto tv4 = mul(tv3, tv2);
+  fusion.addOutput(tv4);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto options_i = at::TensorOptions().dtype(at::kLong).device(at::kCUDA, 0);
+
+  const int64_t num_embeddings = 1000;
+  const int64_t embedding_dim = 1024;
+  const int64_t num_tokens = 2048;
+  auto t0 = at::randn({num_embeddings, embedding_dim}, options);
+  auto t1 = at::randint(0, num_embeddings, {num_tokens}, options_i);
+  auto t2 = at::randn({num_tokens, embedding_dim}, options);
+  std::vector<c10::IValue> aten_inputs = {t0, t1, t2};
+
+  FusionExecutorCache executor_cache(std::move(fusion_ptr));
+  auto outputs = executor_cache.runFusionWithInputs(aten_inputs);
+
+  FusionKernelRuntime* runtime = executor_cache.getMostRecentKernelRuntime();
+  ASSERT_FALSE(runtime->isSegmented());
+  auto params = dynamic_cast<PointwiseParams*>(
+      runtime->getMostRecentExecutorLog().params.get());
+  ASSERT_NE(params, nullptr);
+  EXPECT_TRUE(params->vectorize);
+  EXPECT_EQ(params->unroll_factor, 4);
+
+  testValidate(&fusion, outputs, aten_inputs, __LINE__, __FILE__);
+}
+
 } // namespace nvfuser
@@ -230,6 +230,113 @@ TEST_F(OuterReductionTest, GroupedGridWelfordOuterOpt) {
   }
 }
 
+// Same as GroupedGridWelfordOuterOpt but with a sum, which only uses
+// the optimized implementation with
+// EnableOption::GridOuterPersistentReduction
+TEST_F(OuterReductionTest, GroupedGridReductionOuterOpt) {
+  auto run_test = [&](DataType dtype, int64_t bidx, bool enable_opt) {
+    EnableOptionsGuard opt_guard;
+    if (enable_opt) {
+      EnableOptionsGuard::getCurOptions().set(
+          EnableOption::GridOuterPersistentReduction);
+    }
+
+    std::unique_ptr<Fusion> fusion_ptr = std::make_unique<Fusion>();
+    Fusion& fusion = *fusion_ptr.get();
+    FusionGuard fg(&fusion);
+
+    constexpr int64_t vec = 4;
+    constexpr int64_t tidx = 8;
+    constexpr int64_t tidy = 32;
+    constexpr int64_t pb = 8;
+
+    auto tv0 = makeContigTensor(2, dtype);
+    fusion.addInput(tv0);
+
+    auto tv1 = set(tv0);
+    auto tv2 = dtype == DataType::Half ? castOp(DataType::Float, tv1) : tv1;
+    auto tv3 = sum(tv2, {0});
+    auto tv4 = broadcast(tv3, {true, false});
+    auto tv5 = dtype == DataType::Half ? castOp(DataType::Float, tv1) : tv1;
+    auto tv6 = sub(tv5, tv4);
+    fusion.addOutput(tv6);
+
+    int64_t bidy = deviceSMCount() / bidx;
+
+    // Skip if the available SM count is too small for this problem size
+    if (deviceSMCount() <= bidx || bidy <= 1) {
+      return;
+    }
+
+    int64_t reduction_size = tidy * bidy * pb;
+    int64_t iteration_size = vec * tidx * bidx * 8;
+
+    auto ref = tv3;
+
+    ref->reorder({{0, 1}});
+
+    ref->split(1, tidy);
+    ref->split(1, pb);
+
+    ref->split(0, vec);
+    ref->split(0, tidx);
+    ref->split(0, bidx);
+
+    // Move the vectorized ID to the innermost position
+    ref->reorder({{3, -1}});
+
+    auto ref_rf = ref->rFactor({-3});
+
+    TransformPropagator propagator(ref_rf);
+    MaxRootDomainInfoSpanningTree(ref_rf).traverse(&propagator);
+
+    ref_rf->axis(1)->parallelize(ParallelType::BIDx);
+    ref_rf->axis(2)->parallelize(ParallelType::TIDx);
+    ref_rf->axis(3)->parallelize(ParallelType::BIDy);
+    ref_rf->axis(5)->parallelize(ParallelType::TIDy);
+
+    scheduler_utils::parallelizeAllLike(ref_rf, ir_utils::allTvs(&fusion));
+
+    tv1->axis(-1)->parallelize(ParallelType::Vectorize);
+    tv3->axis(-1)->parallelize(ParallelType::Group);
+
+    inlineMost();
+
+    auto at_dtype = dtype == DataType::Half ? at::kHalf : at::kFloat;
+    auto options = at::TensorOptions().dtype(at_dtype).device(at::kCUDA, 0);
+
+    const std::vector<int64_t> input_shape{reduction_size, iteration_size};
+    auto t0 = at::randn(input_shape, options);
+    std::vector<c10::IValue> aten_inputs = {t0};
+
+    FusionExecutor fe;
+    fe.compileFusion(&fusion, aten_inputs);
+
+    NVF_CHECK(
+        fe.kernel()->summary().has_outer_grouped_grid_reduction == enable_opt,
+        (enable_opt ? "Failed to use the optimized implementation"
+                    : "Should not use the optimized implementation"),
+        ": ",
+        bidx);
+
+    auto cg_outputs = fe.runFusion(aten_inputs);
+
+    auto t1 = dtype == DataType::Half ? t0.to(at::kFloat) : t0;
+    auto t2 = t1 - t1.sum({0}).unsqueeze(0);
+
+    testValidate(
+        &fusion, cg_outputs, aten_inputs, {t2}, __LINE__, __FILE__, "");
+  };
+
+  for (const auto& dtype : {DataType::Half, DataType::Float}) {
+    for (int64_t bidx = 1; bidx < 8; bidx *= 2) {
+      maybeClearAllocator();
+      run_test(dtype, bidx, true);
+    }
+    run_test(dtype, 1, false);
+  }
+}
+
 namespace {
 
 // A quick opt-in switch to enable performance measurements.
@@ -2143,4 +2250,146 @@ TEST_F(
   grid_persistent_batchnorm_bwd_scheduler(256, 28, 512, DataType::Float);
 }
 #endif
+
+// See [ Single-Pass Grid Reduction ]
+TEST_F(OuterReductionTest, SinglePassGridReduction) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeContigTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = sum(tv0, {0});
+  fusion.addOutput(tv1);
+
+  // [BIDy{32}, serial{256}, TIDx]
+  tv1->split(0, 256);
+  auto tv2 = tv1->rFactor({1});
+  for (auto tv : {tv1, tv2}) {
+    tv->axis(0)->parallelize(ParallelType::BIDy);
+    tv->axis(-1)->parallelize(ParallelType::TIDx);
+  }
+  inlineMost();
+
+  tv1->definition()->as<ReductionOp>()->requestSinglePassGridReduction();
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn({32 * 256, 96}, options);
+
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, {t0});
+  auto cg_outputs = fe.runFusion({t0});
+
+  EXPECT_THAT(
+      fe.kernelString(),
+      testing::HasSubstr("reduction::gridReduceSinglePass<"));
+
+  testValidate(&fusion, cg_outputs, {t0}, __LINE__, __FILE__);
+}
+
+TEST_F(OuterReductionTest, SinglePassGridReductionScheduler) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(
+      EnableOption::SinglePassGridReduction);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = sum(tv0, {0});
+  fusion->addOutput(tv1);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn({1 << 18, 64}, options);
+
+  FusionExecutorCache fec(std::move(fusion));
+  auto cg_outputs = fec.runFusionWithInputs({t0});
+
+  auto runtime = fec.getMostRecentKernelRuntime();
+  ASSERT_FALSE(runtime->isSegmented());
+  const auto& heuristic =
+      runtime->schedulerHeuristics()->heuristicsList().at(0);
+  ASSERT_EQ(heuristic->heuristic(), ScheduleHeuristic::Reduction);
+  const auto& rparams = heuristic->reductionParams();
+  ASSERT_TRUE(rparams.cross_grid_inner_reduction);
+  EXPECT_TRUE(rparams.single_pass_grid_reduction);
+  EXPECT_THAT(
+      runtime->executors().at(0).kernelString(),
+      testing::HasSubstr("reduction::gridReduceSinglePass<"));
+
+  testValidate(fec.fusion(), cg_outputs, {t0}, __LINE__, __FILE__);
+}
+
+// See [ Atomic Grid Reduction ]
+TEST_F(OuterReductionTest, AtomicGridReduction) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeContigTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = sum(tv0, {0});
+  fusion.addOutput(tv1);
+
+  // [BIDy{32}, serial{256}, TIDx]
+  tv1->split(0, 256);
+  auto tv2 = tv1->rFactor({1});
+  for (auto tv : {tv1, tv2}) {
+    tv->axis(0)->parallelize(ParallelType::BIDy);
+    tv->axis(-1)->parallelize(ParallelType::TIDx);
+  }
+  inlineMost();
+
+  tv1->definition()->as<ReductionOp>()->requestAtomicGridReduction();
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn({32 * 256, 96}, options);
+
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, {t0});
+  auto cg_outputs = fe.runFusion({t0});
+
+  EXPECT_THAT(
+      fe.kernelString(), testing::HasSubstr("reduction::gridReduceAtomic<"));
+  EXPECT_THAT(
+      fe.kernelString(), testing::Not(testing::HasSubstr("gridReduce<")));
+
+  testValidate(&fusion, cg_outputs, {t0}, __LINE__, __FILE__);
+}
+
+TEST_F(OuterReductionTest, AtomicGridReductionScheduler) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::AtomicGridReduction);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = sum(tv0, {0});
+  fusion->addOutput(tv1);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn({1 << 18, 64}, options);
+
+  FusionExecutorCache fec(std::move(fusion));
+  // Outputs are zero-initialized before every launch, so running twice
+  // must not accumulate into the previous results
+  fec.runFusionWithInputs({t0});
+  auto cg_outputs = fec.runFusionWithInputs({t0});
+
+  auto runtime = fec.getMostRecentKernelRuntime();
+  ASSERT_FALSE(runtime->isSegmented());
+  const auto& heuristic =
+      runtime->schedulerHeuristics()->heuristicsList().at(0);
+  ASSERT_EQ(heuristic->heuristic(), ScheduleHeuristic::Reduction);
+  const auto& rparams = heuristic->reductionParams();
+  ASSERT_TRUE(rparams.cross_grid_inner_reduction);
+  EXPECT_TRUE(rparams.atomic_grid_reduction);
+  EXPECT_THAT(
+      runtime->executors().at(0).kernelString(),
+      testing::HasSubstr("reduction::gridReduceAtomic<"));
+
+  testValidate(fec.fusion(), cg_outputs, {t0}, __LINE__, __FILE__);
+}
+
 } // namespace nvfuser
@@ -156,6 +156,66 @@ TEST_F(NVFuserTest, FusionAmpereMatmulBFloat16_CUDA) {
   }
 }
 
+// Matmul test for Ampere MMA: with the stages of the operands in shared
+// memory handed off with mbarriers
+TEST_F(NVFuserTest, FusionAmpereMatmulMBarrierHandoff_CUDA) {
+  // Keep multiples of 8 to keep vectorizable.
+  int M = 504, N = 136, K = 248;
+
+  for (auto layout : kAllSupportedMmaLayout) {
+    for (int stage : {2, 4}) {
+      Fusion fusion;
+      FusionGuard fg(&fusion);
+      auto tv0 = makeContigTensor(2, DataType::BFloat16);
+      auto tv1 = makeContigTensor(2, DataType::BFloat16);
+
+      fusion.addInput(tv0);
+      fusion.addInput(tv1);
+
+      auto tv2 = matmul(tv0, tv1, layout, true);
+
+      fusion.addOutput(tv2);
+
+      MatMulTileOptions gemm_tile;
+      gemm_tile.cta_tile = GemmTile(128, 128, 32);
+      gemm_tile.warp_tile = GemmTile(64, 64, 32);
+      gemm_tile.instruction_tile = GemmTile(16, 8, 16);
+
+      MatmulParams params;
+      params.mma_macro = MmaMacro::Ampere_16_8_16;
+      params.tile_sizes = gemm_tile;
+      params.async_gmem_load_operands = true;
+      params.double_buffer_options.double_buffer_smem_write = true;
+      params.double_buffer_options.double_buffer_smem_read = true;
+      params.double_buffer_options.smem_double_buffer_stage = stage;
+      params.double_buffer_options.mbarrier_handoff = true;
+      scheduleMatmul(&fusion, params);
+
+      auto inputs = matmulAtInput(M, N, K, layout, at::kBFloat16);
+
+      FusionExecutor fe;
+      NVFUSER_TEST_CUDA_ARCH_COMPILE_CHECK(
+          8,
+          0,
+          fe.compileFusion(
+              &fusion,
+              {inputs.first, inputs.second},
+              LaunchParams(),
+              matmul_cparams));
+      // The stages are synchronized with mbarriers instead of waiting for
+      // cp.async groups
+      const auto kernel_code = fe.kernelString();
+      EXPECT_NE(kernel_code.find("mbarrier::cpAsyncArrive"), std::string::npos);
+      EXPECT_NE(kernel_code.find("mbarrier::waitParity"), std::string::npos);
+      EXPECT_EQ(kernel_code.find("cp.async.wait_group"), std::string::npos);
+      auto cg_outputs = fe.runFusion({inputs.first, inputs.second});
+      auto tref = atMatmul(
+          inputs.first.to(at::kFloat), inputs.second.to(at::kFloat), layout);
+      NVF_CHECK(cg_outputs[0].allclose(tref, 0.0001, 0.0001));
+    }
+  }
+}
+
 // Matmul test for Ampere MMA: with pipelined gmem load
 TEST_F(NVFuserTest, FusionAmpereMatmulPipelineGmem_CUDA) {
   // Keep multiples of 8 to keep vectorizable.
@@ -15,6 +15,7 @@
 #include <ops/all_ops.h>
 #include <optimization/mark_aliases_prepare.h>
 #include <scheduler/all_schedulers.h>
+#include <scheduler/device_model.h>
 #include <scheduler/transpose.h>
 #include <scheduler/utils.h>
 #include <test/utils.h>
@@ -1114,6 +1115,47 @@ TEST_F(TransposeTest, TransposeAggregatedVectorizationWidth) {
   NVF_CHECK(ref.equal(cg_outputs.at(0)));
 }
 
+// See note [Transposes with a shared inner dimension]
+TEST_F(TransposeTest, TransposeSharedInnerDim) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeContigTensor(4);
+  fusion->addInput(tv0);
+  // [B, H, S, D] -> [B, S, H, D]
+  auto tv1 = permute(tv0, {0, 2, 1, 3});
+  fusion->addOutput(tv1);
+
+  std::vector<int64_t> shape({8, 16, 2048, 4});
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+
+  auto t0 = at::randn(shape, options);
+  std::vector<c10::IValue> aten_inputs({t0});
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  auto cg_outputs = executor_cache.runFusionWithInputs(aten_inputs);
+
+  auto runtime = executor_cache.getMostRecentKernelRuntime();
+  NVF_CHECK(!runtime->isSegmented(), "Segmentation not expected");
+  auto scheduler = runtime->schedulerHeuristics()->heuristicsList().at(0).get();
+  auto heuristic = scheduler->heuristic();
+  NVF_CHECK(
+      heuristic == ScheduleHeuristic::Transpose,
+      "Unexpected heuristic: ",
+      heuristic);
+  NVF_CHECK(
+      scheduler->transposeParams().vectorize_factor1 == 4,
+      "expecting vectorization for group 1 to be 4");
+  NVF_CHECK(
+      scheduler->transposeParams().vectorize_factor2 == 4,
+      "expecting vectorization for group 2 to be 4");
+
+  auto ref = t0.permute({0, 2, 1, 3});
+
+  NVF_CHECK(ref.equal(cg_outputs.at(0)));
+}
+
 TEST_F(TransposeTest, ViewTransposeReshape) {
   auto fusion = std::make_unique<Fusion>();
   FusionGuard fg(fusion.get());
@@ -1335,4 +1377,94 @@ TEST_F(TransposeTest, TransposeSplitAggregatedVectorizationWidth) {
   NVF_CHECK(ref.equal(cg_outputs.at(0)));
 }
 
+// A row of tiles doesn't fit in the L2 of the model, so the tiles are
+// swizzled. See [ Transpose Grid Swizzle ]
+TEST_F(TransposeTest, GridSwizzle) {
+  DeviceModel small_l2 = getDeviceModel();
+  small_l2.l2_size = 16 * 1024;
+  setDeviceModel(small_l2);
+
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeContigTensor(3);
+  fusion.addInput(tv0);
+  auto tv1 = transpose(tv0, 1, 2);
+  fusion.addOutput(tv1);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  // Not divisible by the tiles or the swizzle factor
+  at::Tensor t0 = at::randn({3, 1031, 2049}, options);
+  std::vector<c10::IValue> aten_inputs({t0});
+
+  auto params = getTransposeHeuristics(&fusion, aten_inputs);
+  ASSERT_NE(params, nullptr);
+  EXPECT_GT(params->grid_swizzle_factor, 1);
+  scheduleTranspose(&fusion, *params);
+
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, aten_inputs, params->lparams);
+  auto cg_outputs = fe.runFusion(aten_inputs, params->lparams);
+  testValidate(&fusion, cg_outputs, aten_inputs, __LINE__, __FILE__);
+
+  resetDeviceModel();
+}
+
+// NCHW to NHWC and back with a small C are transposed in registers. See
+// [ Register Transpose ]
+TEST_F(TransposeTest, RegisterTranspose) {
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  for (bool to_channels_last : {true, false}) {
+    Fusion fusion;
+    FusionGuard fg(&fusion);
+
+    auto tv0 = makeContigTensor(3);
+    fusion.addInput(tv0);
+    auto tv1 = relu(tv0);
+    auto tv2 = transpose(tv1, 1, 2);
+    auto tv3 = add(tv2, IrBuilder::create<Val>(1.0));
+    fusion.addOutput(tv3);
+
+    // Not divisible by the tiles of a block
+    at::Tensor t0 = to_channels_last ? at::randn({5, 4, 3136 + 4}, options)
+                                     : at::randn({5, 3136 + 4, 4}, options);
+    std::vector<c10::IValue> aten_inputs({t0});
+
+    auto params = getTransposeHeuristics(&fusion, aten_inputs);
+    ASSERT_NE(params, nullptr);
+    EXPECT_EQ(params->register_tile_size, 4);
+    EXPECT_EQ(params->packed_register_tile_inputs, !to_channels_last);
+    scheduleTranspose(&fusion, *params);
+
+    FusionExecutor fe;
+    fe.compileFusion(&fusion, aten_inputs, params->lparams);
+    EXPECT_THAT(fe.kernelString(), ::testing::HasSubstr("warpTranspose"));
+    auto cg_outputs = fe.runFusion(aten_inputs, params->lparams);
+    testValidate(&fusion, cg_outputs, aten_inputs, __LINE__, __FILE__);
+  }
+}
+
+// The tiles are staged through shared memory when transposing in registers
+// is disabled
+TEST_F(TransposeTest, RegisterTransposeDisabled) {
+  DisableOptionsGuard opt_guard;
+  DisableOptionsGuard::getCurOptions().set(DisableOption::RegisterTranspose);
+
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeContigTensor(3);
+  fusion.addInput(tv0);
+  auto tv1 = transpose(tv0, 1, 2);
+  fusion.addOutput(tv1);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({5, 4, 3136}, options);
+  std::vector<c10::IValue> aten_inputs({t0});
+
+  auto params = getTransposeHeuristics(&fusion, aten_inputs);
+  ASSERT_NE(params, nullptr);
+  EXPECT_EQ(params->register_tile_size, 1);
+}
+
 } // namespace nvfuser
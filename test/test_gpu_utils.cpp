@@ -10,6 +10,7 @@
 #include <gtest/gtest.h>
 
 #include <device_lower/utils.h>
+#include <executor_kernel_arg.h>
 #include <executor_utils.h>
 #include <fusion.h>
 #include <ops/all_ops.h>
@@ -1080,4 +1081,42 @@ TEST_F(NVFuserTest, FusionSASSDumpError_CUDA) {
   testValidate(fe.kernel(), cg_outputs, {t0}, __LINE__, __FILE__);
 }
 
+// See [ Kernel Argument Storage ]
+TEST_F(NVFuserTest, KernelArgumentHolderViews_CUDA) {
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({16}, options);
+
+  KernelArgumentHolder args =
+      KernelArgumentHolder::createKernelArgumentHolder({t0, 3L});
+  const PolymorphicValue* tensor_arg = args[0];
+  const PolymorphicValue* scalar_arg = args[1];
+
+  // Arguments don't move while more are pushed
+  for (const auto i : c10::irange(100)) {
+    args.push(PolymorphicValue((int64_t)i));
+  }
+  EXPECT_EQ(args[0], tensor_arg);
+  EXPECT_EQ(args[1], scalar_arg);
+
+  // Views refer to the arguments of another holder
+  KernelArgumentHolder views;
+  views.pushView(args[1]);
+  views.pushView(args[0]);
+  EXPECT_EQ(views[0], scalar_arg);
+  EXPECT_EQ(views[1], tensor_arg);
+
+  // Copies own their arguments
+  KernelArgumentHolder copy = views;
+  ASSERT_EQ(copy.size(), 2);
+  EXPECT_NE(copy[1], tensor_arg);
+  EXPECT_TRUE(copy[1]->as<at::Tensor>().is_same(t0));
+  EXPECT_EQ(copy[0]->as<int64_t>(), 3);
+
+  // Erasing an argument releases it without moving the others
+  args.erase(scalar_arg);
+  EXPECT_EQ(args.size(), 101);
+  EXPECT_EQ(args[0], tensor_arg);
+  EXPECT_EQ(args[1]->as<int64_t>(), 0);
+}
+
 } // namespace nvfuser
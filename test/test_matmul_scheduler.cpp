@@ -6,16 +6,20 @@
  */
 // clang-format on
 #include <csrc/exceptions.h>
+#include <gmock/gmock-matchers.h>
 #include <gtest/gtest.h>
 
 #include <fusion.h>
 #include <mma_type.h>
 #include <ops/all_ops.h>
 #include <scheduler/all_schedulers.h>
+#include <scheduler/autotune.h>
 #include <scheduler/mma_utils.h>
 #include <test/utils.h>
 #include <test/validator.h>
 
+#include <filesystem>
+
 namespace nvfuser {
 
 namespace {
@@ -2147,6 +2151,362 @@ TEST_F(MatmulSchedulerTest, StridedBatchEpilogueSingleBias) {
   }
 }
 
+// Matmul autotuning picks a valid configuration, stores it by problem shape
+// and reuses it for the same problem
+TEST_F(MatmulSchedulerTest, Autotune) {
+  NVFUSER_TEST_CUDA_ARCH_RANGE_GUARD(8, 0, 8, 9);
+  const int M = 256, N = 512, K = 256;
+  const auto layout = MmaLayout::TT;
+
+  const auto db_path =
+      std::filesystem::temp_directory_path() / "nvfuser_autotune_matmul.txt";
+  std::filesystem::remove(db_path);
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(
+      EnableOption::Autotune, {db_path.string()});
+
+  auto t0 = matmulAtInput(layout, TensorMatmulPos::A, at::kHalf, M, N, K);
+  auto t1 = matmulAtInput(layout, TensorMatmulPos::B, at::kHalf, M, N, K);
+  auto tref = atMatmul(t0.to(at::kFloat), t1.to(at::kFloat), layout);
+
+  std::optional<std::string> tuning;
+  for (auto i : c10::irange(2)) {
+    auto fusion = std::make_unique<Fusion>();
+    FusionGuard fg(fusion.get());
+
+    auto tv0 = makeContigTensor(2, DataType::Half);
+    auto tv1 = makeContigTensor(2, DataType::Half);
+    auto tv2 = matmul(tv0, tv1, layout, true);
+
+    fusion->addInput(tv0);
+    fusion->addInput(tv1);
+    fusion->addOutput(tv2);
+
+    FusionExecutorCache executor_cache(std::move(fusion));
+    auto outputs = executor_cache.runFusionWithInputs({t0, t1});
+    NVF_CHECK(outputs[0].allclose(tref, 0.001, 0.001));
+
+    const auto& params = executor_cache.getMostRecentKernelRuntime()
+                             ->schedulerHeuristics()
+                             ->heuristicsList()
+                             .at(0)
+                             ->matmulParams();
+    EXPECT_THAT(params.tag, testing::HasSubstr("Autotuned"));
+    const auto& tiles = params.tile_sizes;
+    EXPECT_EQ(tiles.cta_tile.m % tiles.warp_tile.m, 0);
+    EXPECT_EQ(tiles.cta_tile.n % tiles.warp_tile.n, 0);
+    EXPECT_EQ(tiles.warp_tile.m % tiles.instruction_tile.m, 0);
+    EXPECT_EQ(tiles.warp_tile.n % tiles.instruction_tile.n, 0);
+
+    // The second fusion finds the tuning of the first
+    EXPECT_EQ(TuningDb::get()->numEntries(), 1);
+    const auto serialized = MatmulTuning::fromParams(params).serialize();
+    if (i == 0) {
+      tuning = serialized;
+    } else {
+      EXPECT_EQ(serialized, tuning.value());
+    }
+  }
+
+  const auto export_path =
+      std::filesystem::temp_directory_path() / "nvfuser_autotune_export.txt";
+  EXPECT_EQ(TuningDb::get()->exportTo(export_path.string()), 1);
+  EXPECT_EQ(TuningDb(export_path.string()).numEntries(), 1);
+  std::filesystem::remove(export_path);
+  std::filesystem::remove(db_path);
+}
+
+// Skinny matmuls whose output tiles don't fill a wave use serial split-K
+TEST_F(MatmulSchedulerTest, SerialSplitKSkinny) {
+  NVFUSER_TEST_CUDA_ARCH_RANGE_GUARD(8, 0, 8, 9);
+  const int M = 16, N = 256, K = 8192;
+  const auto layout = MmaLayout::TT;
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeContigTensor(2, DataType::Half);
+  auto tv1 = makeContigTensor(2, DataType::Half);
+  auto tv2 = matmul(tv0, tv1, layout, true);
+
+  fusion->addInput(tv0);
+  fusion->addInput(tv1);
+  fusion->addOutput(tv2);
+
+  auto t0 = matmulAtInput(layout, TensorMatmulPos::A, at::kHalf, M, N, K);
+  auto t1 = matmulAtInput(layout, TensorMatmulPos::B, at::kHalf, M, N, K);
+  auto tref = atMatmul(t0.to(at::kFloat), t1.to(at::kFloat), layout);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  auto outputs = executor_cache.runFusionWithInputs({t0, t1});
+  // Relax tolerance for larger sum due to large K
+  NVF_CHECK(outputs[0].allclose(tref, 1e-6 * K, 1e-6 * K));
+
+  auto runtime = executor_cache.getMostRecentKernelRuntime();
+  const auto& params =
+      runtime->schedulerHeuristics()->heuristicsList().at(0)->matmulParams();
+  EXPECT_GT(params.splitk_factor, 1);
+  EXPECT_TRUE(params.use_serial_splitk);
+
+  const auto kernel_code = runtime->executors().at(0).kernelString();
+  EXPECT_THAT(kernel_code, testing::HasSubstr("serialReductionStep"));
+  EXPECT_THAT(kernel_code, testing::HasSubstr("blockSerializeWait"));
+  EXPECT_THAT(kernel_code, testing::Not(testing::HasSubstr("gridReduce<")));
+
+  // The semaphores are reset, so running again gives the same result
+  auto outputs2 = executor_cache.runFusionWithInputs({t0, t1});
+  EXPECT_TRUE(outputs2[0].equal(outputs[0]));
+}
+
+// Matmul test with reductions along N in the epilogue, see
+//  [ Matmul Epilogue Reductions ]:
+//   D = (A x B) + bias
+//   S = sum(D, N), X = max(D, N)
+//  Target architectures: Ampere
+TEST_F(MatmulSchedulerTest, EpilogueBiasRowReductions) {
+  NVFUSER_TEST_CUDA_ARCH_RANGE_GUARD(8, 0, 9, 0);
+  const int M = 504, N = 136, K = 248;
+  const auto layout = MmaLayout::TT;
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeContigTensor(2, DataType::Half);
+  auto tv1 = makeContigTensor(2, DataType::Half);
+  auto tv2 = makeContigTensor(1, DataType::Float);
+  auto tv3 = matmul(tv0, tv1, layout, true);
+  auto tv4 = biasEpilogue(tv3, tv2);
+  auto tv5 = castOp(DataType::Half, tv4);
+  auto tv6 = sum(tv4, {1});
+  auto tv7 = max(tv4, {1});
+
+  fusion->addInput(tv0);
+  fusion->addInput(tv1);
+  fusion->addInput(tv2);
+  fusion->addOutput(tv5);
+  fusion->addOutput(tv6);
+  fusion->addOutput(tv7);
+
+  at::manual_seed(0);
+  auto t0 = matmulAtInput(layout, TensorMatmulPos::A, at::kHalf, M, N, K);
+  auto t1 = matmulAtInput(layout, TensorMatmulPos::B, at::kHalf, M, N, K);
+  auto t2 = matmulAtInput(layout, TensorMatmulPos::Bias, at::kFloat, M, N, K);
+  auto t4 = atBiasEpilogue(
+      atMatmul(t0.to(at::kFloat), t1.to(at::kFloat), layout), t2);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  auto outputs = executor_cache.runFusionWithInputs({t0, t1, t2});
+
+  auto runtime = executor_cache.getMostRecentKernelRuntime();
+  EXPECT_FALSE(runtime->isSegmented());
+  EXPECT_EQ(
+      runtime->schedulerHeuristics()->heuristicsList().at(0)->heuristic(),
+      ScheduleHeuristic::Matmul);
+  const auto kernel_code = runtime->executors().at(0).kernelString();
+  EXPECT_THAT(kernel_code, testing::HasSubstr("gridReduce"));
+
+  EXPECT_TRUE(outputs[0].allclose(t4.to(at::kHalf), 0.001, 0.001));
+  EXPECT_TRUE(outputs[1].allclose(t4.sum(1), 0.01 * N, 0.001));
+  EXPECT_TRUE(outputs[2].allclose(std::get<0>(t4.max(1)), 0.0001, 0.0001));
+
+  // The semaphores of the grid reductions are reset, so running again gives
+  // the same result
+  auto outputs2 = executor_cache.runFusionWithInputs({t0, t1, t2});
+  EXPECT_TRUE(outputs2[2].equal(outputs[2]));
+}
+
+// Matmul test whose only output is a reduction of the epilogue along N:
+//   S = sum(relu(A x B), N)
+//  Target architectures: Ampere
+TEST_F(MatmulSchedulerTest, EpilogueRowSumOnly) {
+  NVFUSER_TEST_CUDA_ARCH_RANGE_GUARD(8, 0, 9, 0);
+  const int M = 504, N = 136, K = 248;
+  const auto layout = MmaLayout::TN;
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeContigTensor(2, DataType::Half);
+  auto tv1 = makeContigTensor(2, DataType::Half);
+  auto tv2 = matmul(tv0, tv1, layout, true);
+  auto tv3 = sum(relu(tv2), {1});
+
+  fusion->addInput(tv0);
+  fusion->addInput(tv1);
+  fusion->addOutput(tv3);
+
+  at::manual_seed(0);
+  auto t0 = matmulAtInput(layout, TensorMatmulPos::A, at::kHalf, M, N, K);
+  auto t1 = matmulAtInput(layout, TensorMatmulPos::B, at::kHalf, M, N, K);
+  auto tref =
+      atMatmul(t0.to(at::kFloat), t1.to(at::kFloat), layout).relu().sum(1);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  auto outputs = executor_cache.runFusionWithInputs({t0, t1});
+
+  EXPECT_FALSE(executor_cache.getMostRecentKernelRuntime()->isSegmented());
+  EXPECT_TRUE(outputs[0].allclose(tref, 0.01 * N, 0.001));
+}
+
+// Matmul test with a weight dequantized in the prologue, see
+//  [ Matmul Prologue Fusion ]:
+//   D = A x (B_fp8 * scale)
+//  Target architectures: Ampere
+TEST_F(MatmulSchedulerTest, PrologueDequantizeWeight) {
+  NVFUSER_TEST_CUDA_ARCH_RANGE_GUARD(8, 0, 9, 0);
+  const int M = 504, N = 136, K = 248;
+  const auto layout = MmaLayout::TN;
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeContigTensor(2, DataType::Half);
+  auto tv1 = makeContigTensor(2, DataType::Float8_e4m3fn);
+  auto tv2 = makeContigTensor(1, DataType::Float);
+  auto tv3 = castOp(
+      DataType::Half,
+      mul(castOp(DataType::Float, tv1), broadcast(tv2, {false, true})));
+  auto tv4 = matmul(tv0, tv3, layout, true);
+
+  fusion->addInput(tv0);
+  fusion->addInput(tv1);
+  fusion->addInput(tv2);
+  fusion->addOutput(tv4);
+
+  at::manual_seed(0);
+  auto t0 = matmulAtInput(layout, TensorMatmulPos::A, at::kHalf, M, N, K);
+  auto t1 = matmulAtInput(layout, TensorMatmulPos::B, at::kFloat, M, N, K)
+                .mul(8)
+                .to(at::kFloat8_e4m3fn);
+  auto t2 = at::rand({N}, t0.options().dtype(at::kFloat));
+  auto t3 = t1.to(at::kFloat).mul(t2.unsqueeze(1)).to(at::kHalf);
+  auto tref = atMatmul(t0.to(at::kFloat), t3.to(at::kFloat), layout);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  auto outputs = executor_cache.runFusionWithInputs({t0, t1, t2});
+
+  auto runtime = executor_cache.getMostRecentKernelRuntime();
+  EXPECT_FALSE(runtime->isSegmented());
+  EXPECT_EQ(
+      runtime->schedulerHeuristics()->heuristicsList().at(0)->heuristic(),
+      ScheduleHeuristic::Matmul);
+  const auto& params =
+      runtime->schedulerHeuristics()->heuristicsList().at(0)->matmulParams();
+  EXPECT_FALSE(params.async_gmem_load_operands);
+
+  EXPECT_TRUE(outputs[0].allclose(tref, 0.01 * K, 0.001));
+}
+
+// Grouped matmul test of the experts of an MoE layer with a fixed capacity,
+//  where the tokens routed to each expert are gathered in the prologue and
+//  the outputs are scaled by the routing weights in the epilogue, see
+//  [ Matmul Prologue Fusion ]:
+//   A[e, c, :] = X[idx[e, c], :]
+//   D[e] = gate[e] * (A[e] x W[e])
+//  Target architectures: Ampere
+TEST_F(MatmulSchedulerTest, PrologueGatherExperts) {
+  NVFUSER_TEST_CUDA_ARCH_RANGE_GUARD(8, 0, 9, 0);
+  const int T = 300, E = 4, C = 96, N = 136, K = 248;
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  // X - tv0, idx - tv1, W - tv2, gate - tv3
+  auto tv0 = makeContigConcreteTensor({1, -1, -1}, DataType::Half);
+  auto tv1 = makeContigConcreteTensor({-1, -1, 1}, DataType::Int);
+  auto tv2 = makeContigTensor(3, DataType::Half);
+  auto tv3 = makeContigTensor(2, DataType::Float);
+
+  // [E, C, K]
+  auto tv4 = take_along_axis(tv0, tv1, 1);
+  auto tv5 = fusedMultiplySum(
+      broadcast(tv4, {false, false, true, false}),
+      broadcast(tv2, {false, true, false, false}),
+      {3});
+  auto tv6 =
+      castOp(DataType::Half, mul(tv5, broadcast(tv3, {false, false, true})));
+
+  fusion->addInput(tv0);
+  fusion->addInput(tv1);
+  fusion->addInput(tv2);
+  fusion->addInput(tv3);
+  fusion->addOutput(tv6);
+
+  at::manual_seed(0);
+  auto options = at::TensorOptions().dtype(at::kHalf).device(at::kCUDA, 0);
+  auto t0 = at::randn({1, T, K}, options);
+  auto t1 = at::randint(0, T, {E, C, 1}, options.dtype(at::kLong));
+  auto t2 = at::randn({E, N, K}, options);
+  auto t3 = at::rand({E, C}, options.dtype(at::kFloat));
+
+  auto t4 = t0.squeeze(0).index_select(0, t1.flatten()).view({E, C, K});
+  auto tref = t4.to(at::kFloat)
+                  .matmul(t2.to(at::kFloat).transpose(1, 2))
+                  .mul(t3.unsqueeze(-1))
+                  .to(at::kHalf);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  auto outputs = executor_cache.runFusionWithInputs({t0, t1, t2, t3});
+
+  auto runtime = executor_cache.getMostRecentKernelRuntime();
+  EXPECT_FALSE(runtime->isSegmented());
+  EXPECT_EQ(
+      runtime->schedulerHeuristics()->heuristicsList().at(0)->heuristic(),
+      ScheduleHeuristic::Matmul);
+
+  EXPECT_TRUE(outputs[0].allclose(tref, 0.001 * K, 0.001));
+}
+
+// Matmul test of an int8 linear layer, whose weight is dequantized in the
+//  prologue and whose output is requantized in the epilogue, see
+//  [ Matmul Prologue Fusion ]:
+//   D = int8(clamp(round((A x (B_int8 * scale)) / out_scale), -128, 127))
+//  Target architectures: Ampere
+TEST_F(MatmulSchedulerTest, PrologueInt8WeightRequantize) {
+  NVFUSER_TEST_CUDA_ARCH_RANGE_GUARD(8, 0, 9, 0);
+  const int M = 504, N = 136, K = 248;
+  const auto layout = MmaLayout::TN;
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeContigTensor(2, DataType::Half);
+  auto tv1 = makeContigTensor(2, DataType::Int8);
+  auto tv2 = makeContigTensor(1, DataType::Float);
+  auto tv3 = castOp(
+      DataType::Half,
+      mul(castOp(DataType::Float, tv1), broadcast(tv2, {false, true})));
+  auto tv4 = matmul(tv0, tv3, layout, true);
+  auto out_scale = IrBuilder::create<Val>(4.0);
+  auto tv5 = castOp(
+      DataType::Int8,
+      clamp(
+          round(div(tv4, out_scale)),
+          IrBuilder::create<Val>(-128.0),
+          IrBuilder::create<Val>(127.0)));
+
+  fusion->addInput(tv0);
+  fusion->addInput(tv1);
+  fusion->addInput(tv2);
+  fusion->addOutput(tv5);
+
+  at::manual_seed(0);
+  auto t0 = matmulAtInput(layout, TensorMatmulPos::A, at::kHalf, M, N, K);
+  auto t1 = at::randint(-128, 128, {N, K}, t0.options().dtype(at::kChar));
+  auto t2 = at::rand({N}, t0.options().dtype(at::kFloat)).div(64);
+  auto t3 = t1.to(at::kFloat).mul(t2.unsqueeze(1)).to(at::kHalf);
+  auto t4 = atMatmul(t0.to(at::kFloat), t3.to(at::kFloat), layout);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  auto outputs = executor_cache.runFusionWithInputs({t0, t1, t2});
+
+  EXPECT_FALSE(executor_cache.getMostRecentKernelRuntime()->isSegmented());
+  EXPECT_EQ(outputs[0].scalar_type(), at::kChar);
+  // Accumulation order may round the quantized values differently
+  auto tref = t4.div(4.0).round().clamp(-128, 127);
+  EXPECT_TRUE(outputs[0].to(at::kFloat).allclose(tref, 0.0, 1.0));
+}
+
 #undef NVFUSER_TEST_CUDA_ARCH_GUARD
 
 } // namespace nvfuser
@@ -15,11 +15,15 @@
 #include <fusion.h>
 #include <inlining.h>
 #include <ir/utils.h>
+#include <kernel_cache.h>
 #include <ops/alias.h>
 #include <ops/arith.h>
+#include <ops/normalization.h>
 #include <ops/utils.h>
 #include <options.h>
 #include <scheduler/cache_policy_refiner.h>
+#include <scheduler/normalization_inner.h>
+#include <scheduler/reduction.h>
 #include <test/utils.h>
 #include <test/validator.h>
 #include <type.h>
@@ -472,6 +476,157 @@ TEST_F(TMATest, DisableIndexHoisting) {
   testValidate(&fusion, cg_outputs, {t0}, {t0}, __LINE__, __FILE__);
 }
 
+// Loads each row with a 1D bulk copy issued by a single thread, while all
+// threads of the block read the row from shared memory
+TEST_F(TMATest, LoadRowsBulk1D) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeContigTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = set(tv0);
+  auto tv2 = sum(tv1, {1});
+  fusion.addOutput(tv2);
+
+  tv1->setMemoryType(MemoryType::Shared);
+  tv1->definition()->as<LoadStoreOp>()->setOpType(
+      LoadStoreOpType::CpAsyncBulk);
+
+  tv1->split(1, 128);
+  tv1->axis(0)->parallelize(ParallelType::BIDx);
+  tv1->axis(1)->parallelize(ParallelType::Bulk);
+  tv1->axis(2)->parallelize(ParallelType::Bulk);
+
+  tv2->split(1, 128);
+  tv2->axis(0)->parallelize(ParallelType::BIDx);
+  tv2->axis(2)->parallelize(ParallelType::TIDx);
+
+  inlineMost();
+  // Bulk domains are not inlined
+  EXPECT_EQ(tv1->getComputeAtPosition(), 1);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn({5, 1024}, options);
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, {t0});
+  EXPECT_THAT(fe.kernelString(), testing::HasSubstr("Hopper::cpAsyncBulkG2S"));
+  auto cg_outputs = fe.runFusion({t0});
+  testValidate(&fusion, cg_outputs, {t0}, {t0.sum({1})}, __LINE__, __FILE__);
+}
+
+// The inner persistent scheduler loads shared memory persistent buffers with
+// TMA when enabled
+TEST_F(TMATest, LayerNormSharedMemoryBuffer) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::TmaPersistentBuffer);
+
+  auto fusion_ptr = std::make_unique<Fusion>();
+  Fusion& fusion = *fusion_ptr.get();
+  FusionGuard fg(&fusion);
+
+  const int64_t hidden_size = 80 * 1024;
+  std::vector<int64_t> input_shape{264, hidden_size};
+  auto tv0 = makeContigTensor(2, DataType::Half);
+  fusion.addInput(tv0);
+  auto tv1 = castOp(DataType::Float, tv0);
+  auto result = layer_norm(
+      tv1, {hidden_size}, nullptr, nullptr, IrBuilder::create<Val>(1e-5));
+  fusion.addOutput(castOp(DataType::Half, result.output));
+
+  auto options = at::TensorOptions().dtype(at::kHalf).device(at::kCUDA, 0);
+  auto t0 = at::randn(input_shape, options);
+
+  auto rparams = getInnerPersistentHeuristics(&fusion, {t0});
+  ASSERT_NE(rparams, nullptr);
+  EXPECT_TRUE(rparams->shared_mem_persistent_buffer);
+  EXPECT_TRUE(rparams->tma_load_persistent_buffer);
+
+  FusionExecutorCache executor_cache(std::move(fusion_ptr));
+  auto cg_outputs = executor_cache.runFusionWithInputs({t0});
+  auto runtime = executor_cache.getMostRecentKernelRuntime();
+  EXPECT_THAT(
+      runtime->executors().at(0).kernelString(),
+      testing::HasSubstr("Hopper::cpAsyncBulkG2S"));
+  testValidate(executor_cache.fusion(), cg_outputs, {t0}, __LINE__, __FILE__);
+}
+
+// See [ Circular Buffered Global Loads ]
+class CpAsyncPipelineTest : public NVFuserTest {
+  void SetUp() override {
+    // requires Ampere or newer
+    if (!deviceMajorMinorCheck(8)) {
+      GTEST_SKIP() << "skipping tests on pre-Ampere GPUs";
+    }
+    NVFuserTest::SetUp();
+  }
+};
+
+TEST_F(CpAsyncPipelineTest, InnerReduction) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::CpAsyncPipeline);
+
+  auto fusion_ptr = std::make_unique<Fusion>();
+  Fusion& fusion = *fusion_ptr.get();
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeContigTensor(2);
+  fusion.addInput(tv0);
+  fusion.addOutput(sum(tv0, {1}));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn({1024, 128 * 1024}, options);
+
+  auto rparams = getReductionHeuristics(&fusion, {t0});
+  ASSERT_NE(rparams, nullptr);
+  EXPECT_FALSE(rparams->persistent_kernel);
+  EXPECT_GE(rparams->circular_buffer_stages, 2);
+
+  FusionExecutorCache executor_cache(std::move(fusion_ptr));
+  auto cg_outputs = executor_cache.runFusionWithInputs({t0});
+  auto runtime = executor_cache.getMostRecentKernelRuntime();
+  EXPECT_THAT(
+      runtime->executors().at(0).kernelString(),
+      testing::HasSubstr("cp.async"));
+  testValidate(executor_cache.fusion(), cg_outputs, {t0}, __LINE__, __FILE__);
+}
+
+// Blocks of the inner persistent scheduler loop over their rows, so the next
+// rows are loaded while the current ones are normalized
+TEST_F(CpAsyncPipelineTest, LayerNorm) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::CpAsyncPipeline);
+
+  auto fusion_ptr = std::make_unique<Fusion>();
+  Fusion& fusion = *fusion_ptr.get();
+  FusionGuard fg(&fusion);
+
+  const int64_t hidden_size = 1024;
+  std::vector<int64_t> input_shape{32 * 1024, hidden_size};
+  auto tv0 = makeContigTensor(2, DataType::Half);
+  fusion.addInput(tv0);
+  auto tv1 = castOp(DataType::Float, tv0);
+  auto result = layer_norm(
+      tv1, {hidden_size}, nullptr, nullptr, IrBuilder::create<Val>(1e-5));
+  fusion.addOutput(castOp(DataType::Half, result.output));
+
+  auto options = at::TensorOptions().dtype(at::kHalf).device(at::kCUDA, 0);
+  auto t0 = at::randn(input_shape, options);
+
+  auto rparams = getInnerPersistentHeuristics(&fusion, {t0});
+  ASSERT_NE(rparams, nullptr);
+  EXPECT_FALSE(rparams->shared_mem_persistent_buffer);
+  EXPECT_GE(rparams->circular_buffer_stages, 2);
+  EXPECT_TRUE(rparams->split_grid_dim_iter_dom_outer);
+
+  FusionExecutorCache executor_cache(std::move(fusion_ptr));
+  auto cg_outputs = executor_cache.runFusionWithInputs({t0});
+  auto runtime = executor_cache.getMostRecentKernelRuntime();
+  EXPECT_THAT(
+      runtime->executors().at(0).kernelString(),
+      testing::HasSubstr("cp.async"));
+  testValidate(executor_cache.fusion(), cg_outputs, {t0}, __LINE__, __FILE__);
+}
+
 using LdMatrixTestParam = std::tuple<MmaMacro, MmaOperand>;
 
 class LdMatrixTest : public NVFuserFixtureParamTest<LdMatrixTestParam> {
@@ -10,6 +10,8 @@
 
 #include <multidevice/communication.h>
 #include <multidevice/communicator.h>
+#include <multidevice/device_mesh.h>
+#include <options.h>
 #include <test/multidevice.h>
 
 #include <iostream>
@@ -267,6 +269,71 @@ TEST_P(CommunicationTest, Communication_ReduceScatter) {
   }
 }
 
+// Posts without a backend so that the communicator selects one
+TEST_P(CommunicationTest, Communication_AllreduceBackendSelection) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::CommBackendSelection);
+
+  params.redOp = red_op;
+  params.team = all_ranks;
+  params.src_bufs = {at::empty(tensor_size, tensor_options)};
+  params.dst_bufs = {at::empty(tensor_size, tensor_options)};
+  auto communication = Allreduce(params);
+
+  for (int j : c10::irange(number_of_repetitions)) {
+    resetDstBuffers();
+    params.src_bufs.at(0).copy_(
+        at::arange(tensor_size, tensor_options) +
+        (communicator->deviceId() + 1) * j);
+
+    auto work = communication.post(*communicator);
+    work->wait();
+
+    auto obtained = params.dst_bufs.at(0);
+    int S = communicator->size();
+    auto ref =
+        at::arange(tensor_size, tensor_options) * S + S * (S + 1) / 2 * j;
+    validate(obtained, ref);
+  }
+}
+
+TEST_P(CommunicationTest, Communication_HierarchicalAllreduce) {
+  const int64_t S = communicator->size();
+  if (S < 4 || S % 2 != 0) {
+    GTEST_SKIP() << "This test needs an even number of at least 4 devices";
+  }
+  // Pairs of devices play the role of nodes
+  DeviceMesh mesh(all_ranks, {S / 2, 2});
+  std::vector<DeviceIdxType> second_devices_of_nodes;
+  for (DeviceIdxType device = 1; device < S; device += 2) {
+    second_devices_of_nodes.push_back(device);
+  }
+  EXPECT_EQ(mesh.getSlice(1, 1), std::vector<DeviceIdxType>({0, 1}));
+  EXPECT_EQ(mesh.getSlice(1, 0), second_devices_of_nodes);
+  const DeviceIdxType my_device = communicator->deviceId();
+
+  params.redOp = red_op;
+  params.team = all_ranks;
+  params.src_bufs = {at::empty(tensor_size, tensor_options)};
+  params.dst_bufs = {at::empty(tensor_size, tensor_options)};
+  auto communication = HierarchicalAllreduce(
+      params, mesh.getSlice(my_device, 1), mesh.getSlice(my_device, 0));
+
+  for (int j : c10::irange(number_of_repetitions)) {
+    resetDstBuffers();
+    params.src_bufs.at(0).copy_(
+        at::arange(tensor_size, tensor_options) + (my_device + 1) * j);
+
+    auto work = communication.post(*communicator, GetParam());
+    work->wait();
+
+    auto obtained = params.dst_bufs.at(0);
+    auto ref =
+        at::arange(tensor_size, tensor_options) * S + S * (S + 1) / 2 * j;
+    validate(obtained, ref);
+  }
+}
+
 INSTANTIATE_TEST_SUITE_P(
     CommunicatorBackend,
     CommunicationTest,
@@ -25,7 +25,9 @@
 #include <kernel_cache.h>
 #include <kernel_ir.h>
 #include <mma_type.h>
+#include <multidevice/utils.h>
 #include <ops/all_ops.h>
+#include <options.h>
 #include <root_domain_map.h>
 #include <scheduler/all_schedulers.h>
 #include <scheduler/reduction_utils.h>
@@ -136,6 +138,207 @@ TEST_F(PipelineTest, Pipeline) {
   validate();
 }
 
+// Runs a two-stage pipeline on micro-batches, so that device 0 computes the
+// first stage of a micro-batch while device 1 computes the second stage of the
+// previous one
+TEST_F(PipelineTest, MicroBatches) {
+  FusionGuard fg(fusion.get());
+  TensorView* tv0 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  TensorView* tv1 = sum(tv0, {1});
+  TensorView* tv2 = set(tv1);
+  TensorView* tv3 = mul(tv2, tv2);
+  fusion->addOutput(tv3);
+
+  PipelineStageDescriptor stage0, stage1;
+  stage0.addVal({tv0, tv1});
+  stage1.addVal({tv2, tv3});
+  stage0.mesh = {0};
+  stage1.mesh = {1};
+
+  PipelineDescriptor descriptor{
+      .stage_descriptors{std::move(stage0), std::move(stage1)}};
+  pipeline = std::make_unique<Pipeline>(fusion.get(), std::move(descriptor));
+
+  inputs = {at::randn({1024, 517}, tensor_options)};
+  num_micro_batches = 4;
+
+  validate();
+}
+
+// Allgathers activations and multiplies them by replicated weights, which
+// runs the matmul on each gathered chunk while the next one is received
+TEST_F(PipelineTest, CollectiveMatmul) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::CollectiveMatmul);
+
+  DeviceMesh mesh({0, 1, 2, 3});
+  const int64_t num_devices = mesh.vector().size();
+  const int64_t m = 64, k = 32, n = 48;
+
+  FusionGuard fg(fusion.get());
+  TensorView* tv0 = makeContigTensor(3);
+  TensorView* weights = makeContigTensor(2);
+  fusion->addInput(tv0);
+  fusion->addInput(weights);
+  TensorView* tv1 = set(tv0);
+  TensorView* tv2 = set(tv1);
+  TensorView* tv3 = broadcast(tv2, {false, false, false, true});
+  TensorView* tv4 = broadcast(weights, {true, true, false, false});
+  TensorView* tv5 = mul(tv3, tv4);
+  TensorView* tv6 = sum(tv5, {2});
+  fusion->addOutput(tv6);
+
+  PipelineStageDescriptor stage0(false), stage1(false);
+  stage0.addVal({tv0, tv1});
+  stage1.addVal({weights, tv2, tv3, tv4, tv5, tv6});
+  stage0.mesh = mesh;
+  stage1.mesh = mesh;
+  tv0->axis(0)->parallelize(ParallelType::DIDx);
+  tv1->axis(0)->parallelize(ParallelType::DIDx);
+
+  PipelineDescriptor descriptor{
+      .stage_descriptors{std::move(stage0), std::move(stage1)}};
+  pipeline = std::make_unique<Pipeline>(fusion.get(), std::move(descriptor));
+
+  inputs = {
+      at::ones({num_devices, m, k}, tensor_options) * communicator->deviceId(),
+      at::arange(k * n, tensor_options).reshape({k, n}) / (k * n)};
+
+  validate();
+}
+
+// Allreduces the gradients of two parameters in a single bucket, from which
+// the averaging and the update of the parameters read them in place
+TEST_F(PipelineTest, AllreduceBuckets) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::AllreduceBuckets);
+
+  DeviceMesh mesh({0, 1, 2, 3});
+  const int64_t num_devices = mesh.vector().size();
+  const double learning_rate = 0.1;
+
+  FusionGuard fg(fusion.get());
+  TensorView* grad0 = makeContigTensor(3);
+  TensorView* grad1 = makeContigTensor(2);
+  TensorView* param0 = makeContigTensor(2);
+  TensorView* param1 = makeContigTensor(1);
+  fusion->addInput(grad0);
+  fusion->addInput(grad1);
+  fusion->addInput(param0);
+  fusion->addInput(param1);
+  // Epilogue of the backward pass of each device
+  TensorView* tv0 = mul(grad0, grad0);
+  TensorView* tv1 = neg(grad1);
+  // Allreduces
+  TensorView* tv2 = sum(tv0, {0});
+  TensorView* tv3 = sum(tv1, {0});
+  // Averaged SGD update
+  Val* scale = IrBuilder::create<Val>(learning_rate / (double)num_devices);
+  TensorView* tv4 = mul(tv2, scale);
+  TensorView* tv5 = mul(tv3, scale);
+  TensorView* tv6 = sub(param0, tv4);
+  TensorView* tv7 = sub(param1, tv5);
+  fusion->addOutput(tv6);
+  fusion->addOutput(tv7);
+
+  PipelineStageDescriptor stage0(false), stage1(false);
+  stage0.addVal({grad0, grad1, tv0, tv1});
+  stage1.addVal({param0, param1, tv2, tv3, tv4, tv5, tv6, tv7});
+  stage0.mesh = mesh;
+  stage1.mesh = mesh;
+  for (auto tv : {grad0, grad1, tv0, tv1}) {
+    tv->axis(0)->parallelize(ParallelType::DIDx);
+  }
+
+  PipelineDescriptor descriptor{
+      .stage_descriptors{std::move(stage0), std::move(stage1)}};
+  pipeline = std::make_unique<Pipeline>(fusion.get(), std::move(descriptor));
+
+  // The parameters are replicated, so they must be the same on all devices
+  const double device_scale = (double)communicator->deviceId() + 1;
+  inputs = {
+      at::arange(num_devices * 16 * 33, tensor_options)
+              .reshape({num_devices, 16, 33}) /
+          1000 * device_scale,
+      at::ones({num_devices, 7}, tensor_options) * device_scale,
+      at::ones({16, 33}, tensor_options),
+      at::arange(7, tensor_options)};
+
+  validate();
+}
+
+// Runs a stage replicated on all the devices with the compile cache, so that
+// the first device of each node compiles it for the others
+TEST_F(PipelineTest, LeaderCompilation) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::CompileCache);
+
+  DeviceMesh mesh({0, 1, 2, 3});
+
+  FusionGuard fg(fusion.get());
+  TensorView* tv0 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  TensorView* tv1 = sum(tv0, {1});
+  TensorView* tv2 = mul(tv1, tv1);
+  fusion->addOutput(tv2);
+
+  PipelineStageDescriptor stage;
+  stage.addVal({tv0, tv1, tv2});
+  stage.mesh = mesh;
+
+  PipelineDescriptor descriptor{.stage_descriptors{std::move(stage)}};
+  pipeline = std::make_unique<Pipeline>(fusion.get(), std::move(descriptor));
+
+  inputs = {at::randn({67, 129}, tensor_options)};
+
+  validate();
+}
+
+// Only annotates the inputs, and lets the shardings and the stages be
+// inferred
+TEST_F(PipelineTest, ShardingPropagation) {
+  DeviceMesh mesh({0, 1});
+  const int64_t num_devices = mesh.vector().size();
+
+  FusionGuard fg(fusion.get());
+  TensorView* tv0 = makeContigTensor(2);
+  TensorView* tv1 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  fusion->addInput(tv1);
+  TensorView* tv2 = add(tv0, tv1);
+  TensorView* tv3 = sum(tv2, {0});
+  TensorView* tv4 = mul(tv3, tv3);
+  fusion->addOutput(tv4);
+
+  tv0->setDeviceMesh(mesh);
+  tv0->axis(0)->parallelize(ParallelType::DIDx);
+  tv1->setDeviceMesh(mesh);
+
+  propagateShardings(fusion.get());
+
+  // tv2 is computed on the shards of tv0, which takes scattering tv1, and the
+  // reduction of the sharded axis is an allreduce
+  EXPECT_TRUE(isSharded(tv2));
+  EXPECT_FALSE(isSharded(tv3));
+  EXPECT_FALSE(isSharded(tv4));
+  auto exprs = fusion->exprs();
+  auto resharding_exprs =
+      std::count_if(exprs.begin(), exprs.end(), [](Expr* expr) {
+        return isResharding(expr);
+      });
+  EXPECT_EQ(resharding_exprs, 2);
+
+  pipeline = std::make_unique<Pipeline>(
+      fusion.get(), inferPipelineDescriptor(fusion.get()));
+
+  inputs = {
+      at::arange(num_devices * 17, tensor_options).reshape({num_devices, 17}),
+      at::ones({num_devices, 17}, tensor_options)};
+
+  validate();
+}
+
 //(first stage's mesh, second stage's mesh, is first stage sharded, is second
 // stage sharded, do_reduction?)
 using PipelineTestTwoStagesParams =
@@ -9,10 +9,17 @@
 #include <gmock/gmock-matchers.h>
 #include <gtest/gtest.h>
 
+#include <executor.h>
+#include <inlining.h>
 #include <ir/all_nodes.h>
 #include <ir/utils.h>
 #include <ops/all_ops.h>
+#include <optimization/algebraic_rewrite.h>
+#include <optimization/common_subexpression_elimination.h>
+#include <optimization/half_arithmetic.h>
 #include <optimization/optimization_pass.h>
+#include <options.h>
+#include <scheduler/utils.h>
 #include <optimization/pre_segmenter.h>
 #include <test/utils.h>
 #include <test/validator.h>
@@ -628,4 +635,199 @@ TEST_F(NVFuserTest, FusionRemoveEmptyMatmul_CUDA) {
   testValidate(preseg_fusion, outputs, aten_inputs, __LINE__, __FILE__);
 }
 
+TEST_F(NVFuserTest, FusionHalfArithmetic_CUDA) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::HalfArithmetic);
+
+  std::unique_ptr<Fusion> fusion_ptr = std::make_unique<Fusion>();
+  Fusion& fusion = *fusion_ptr.get();
+  FusionGuard fg(fusion_ptr.get());
+
+  auto tv0 = makeContigTensor(1, DataType::Half);
+  auto tv1 = makeContigTensor(1, DataType::Half);
+  auto tv2 = makeContigTensor(1, DataType::Half);
+  fusion.addInput(tv0);
+  fusion.addInput(tv1);
+  fusion.addInput(tv2);
+  auto tv3 = mul(tv0, tv1);
+  auto tv4 = sub(tv3, tv2);
+  auto tv5 = castOp(DataType::Half, tv4);
+  fusion.addOutput(tv5);
+  // tv6 is also used by tv7, so it stays in float
+  auto tv6 = add(tv0, tv1);
+  auto tv7 = castOp(DataType::Half, tv6);
+  fusion.addOutput(tv6);
+  fusion.addOutput(tv7);
+
+  auto options = at::TensorOptions().dtype(at::kHalf).device(at::kCUDA, 0);
+  at::Tensor at0 = at::randn({1024}, options);
+  at::Tensor at1 = at::randn({1024}, options);
+  at::Tensor at2 = at::randn({1024}, options);
+  std::vector<c10::IValue> aten_inputs = {at0, at1, at2};
+
+  auto args = KernelArgumentHolder::createKernelArgumentHolder(aten_inputs);
+  FusionKernelRuntime runtime(std::move(fusion_ptr), args);
+
+  auto preseg_fusion = runtime.fusionSegments()->completeFusion();
+  ASSERT_EQ(preseg_fusion->outputs().size(), 3);
+  auto rewritten_def =
+      dynamic_cast<BinaryOp*>(preseg_fusion->outputs()[0]->definition());
+  ASSERT_NE(rewritten_def, nullptr);
+  EXPECT_EQ(rewritten_def->getBinaryOpType(), BinaryOpType::Sub);
+  EXPECT_EQ(rewritten_def->out()->dtype(), DataType::Half);
+  EXPECT_EQ(rewritten_def->lhs()->dtype(), DataType::Half);
+  EXPECT_EQ(preseg_fusion->outputs()[1]->dtype(), DataType::Float);
+  EXPECT_TRUE(preseg_fusion->outputs()[2]->definition()->isA<UnaryOp>());
+
+  runtime.compileFusionParallel(args);
+  auto outputs = runtime.runWithInputs(args);
+
+  auto ref = at0 * at1 - at2;
+  EXPECT_TRUE(at::allclose(outputs[0], ref, 1e-2, 1e-2));
+  EXPECT_TRUE(outputs[1].equal(at0.to(at::kFloat) + at1.to(at::kFloat)));
+  EXPECT_TRUE(outputs[2].equal(at0 + at1));
+}
+
+TEST_F(NVFuserTest, FusionPackedHalfArithmetic_CUDA) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::HalfArithmetic);
+
+  for (auto dtype : {DataType::Half, DataType::BFloat16}) {
+    Fusion fusion;
+    FusionGuard fg(&fusion);
+
+    auto tv0 = makeContigTensor(1, dtype);
+    auto tv1 = makeContigTensor(1, dtype);
+    fusion.addInput(tv0);
+    fusion.addInput(tv1);
+    auto tv2 = castOp(dtype, add(tv0, tv1));
+    fusion.addOutput(tv2);
+
+    OptimizationPass<HalfArithmeticPass>::runPass(&fusion);
+    auto tv3 = fusion.outputs()[0]->as<TensorView>();
+    ASSERT_TRUE(tv3->definition()->isA<BinaryOp>());
+
+    // Every tensor gets its own unrolled inner loop, so the loop of the
+    // addition only reads and writes local tensors
+    tv0->cacheAfter();
+    tv1->cacheAfter();
+    tv3->cacheBefore();
+    tv3->split(0, 4);
+    tv3->split(0, 128);
+    tv3->axis(0)->parallelize(ParallelType::BIDx);
+    tv3->axis(1)->parallelize(ParallelType::TIDx);
+    tv3->axis(2)->parallelize(ParallelType::Unroll);
+    TransformPropagatorWithCheck propagator(tv3);
+    MaxRootDomainInfoSpanningTree(tv3).traverse(&propagator);
+    scheduler_utils::parallelizeAllLike(tv3);
+    inlineAllAt(tv3, 2);
+
+    auto options = at::TensorOptions()
+                       .dtype(data_type_to_aten(dtype))
+                       .device(at::kCUDA, 0);
+    at::Tensor at0 = at::randn({1024 * 128}, options);
+    at::Tensor at1 = at::randn({1024 * 128}, options);
+    std::vector<c10::IValue> aten_inputs = {at0, at1};
+
+    FusionExecutor fe;
+    fe.compileFusion(&fusion, aten_inputs);
+    EXPECT_THAT(fe.kernelString(), ::testing::HasSubstr("__hadd2("));
+    auto outputs = fe.runFusion(aten_inputs);
+
+    EXPECT_TRUE(outputs[0].equal(at0 + at1));
+  }
+}
+
+TEST_F(NVFuserTest, FusionAlgebraicRewrite_CUDA) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::AlgebraicRewrite);
+
+  auto fusion_ptr = std::make_unique<Fusion>();
+  Fusion& fusion = *fusion_ptr.get();
+  FusionGuard fg(fusion_ptr.get());
+
+  auto tv0 = makeContigTensor(1);
+  auto tv1 = makeContigTensor(2);
+  auto tv2 = makeContigTensor(2);
+  fusion.addInput(tv0);
+  fusion.addInput(tv1);
+  fusion.addInput(tv2);
+  // The relu is computed before the broadcast
+  auto tv3 = add(relu(broadcast(tv0, {true, false})), tv1);
+  fusion.addOutput(tv3);
+  // The cast to half is done before the transpose
+  auto tv4 = castOp(DataType::Half, transpose(tv2, 0, 1));
+  fusion.addOutput(tv4);
+  // The two transposes are removed
+  auto tv5 = mul(transpose(transpose(tv1, 0, 1), 0, 1), tv2);
+  fusion.addOutput(tv5);
+
+  OptimizationPass<AlgebraicRewritePass>::runPass(&fusion);
+
+  auto tv3_lhs = fusion.outputs()[0]->definition()->input(0);
+  ASSERT_TRUE(tv3_lhs->definition()->isA<BroadcastOp>());
+  auto relu_def =
+      dynamic_cast<UnaryOp*>(tv3_lhs->definition()->input(0)->definition());
+  ASSERT_NE(relu_def, nullptr);
+  EXPECT_EQ(relu_def->getUnaryOpType(), UnaryOpType::Relu);
+  EXPECT_EQ(relu_def->in(), tv0);
+
+  auto tv4_def = fusion.outputs()[1]->definition();
+  ASSERT_TRUE(tv4_def->isA<LoadStoreOp>());
+  EXPECT_EQ(tv4_def->input(0)->dtype(), DataType::Half);
+
+  EXPECT_EQ(fusion.outputs()[2]->definition()->input(0), tv1);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor at0 = at::randn({64}, options);
+  at::Tensor at1 = at::randn({32, 64}, options);
+  at::Tensor at2 = at::randn({32, 64}, options);
+  std::vector<c10::IValue> aten_inputs = {at0, at1, at2};
+
+  FusionExecutorCache fec(std::move(fusion_ptr));
+  auto outputs = fec.runFusionWithInputs(aten_inputs);
+
+  EXPECT_TRUE(outputs[0].equal(at0.relu().unsqueeze(0) + at1));
+  EXPECT_TRUE(outputs[1].equal(at2.t().to(at::kHalf)));
+  EXPECT_TRUE(outputs[2].equal(at1 * at2));
+}
+
+TEST_F(NVFuserTest, FusionCommonSubexpressionElimination_CUDA) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(
+      EnableOption::CommonSubexpressionElimination);
+
+  auto fusion_ptr = std::make_unique<Fusion>();
+  Fusion& fusion = *fusion_ptr.get();
+  FusionGuard fg(fusion_ptr.get());
+
+  auto tv0 = makeContigConcreteTensor({128, 128});
+  fusion.addInput(tv0);
+  // The forward and its recomputation
+  auto tv1 = rsqrt(sum(tv0, {1}));
+  auto tv2 = rsqrt(sum(tv0, {1}));
+  // Reduces the other axis, so it's not merged
+  auto tv3 = sum(tv0, {0});
+  auto tv4 = add(
+      mul(tv0, broadcast(tv1, {false, true})), broadcast(tv3, {true, false}));
+  auto tv5 = mul(tv0, broadcast(tv2, {false, true}));
+  fusion.addOutput(tv4);
+  fusion.addOutput(tv5);
+
+  OptimizationPass<CommonSubexpressionEliminationPass>::runPass(&fusion);
+
+  EXPECT_EQ(ir_utils::getOpsOfType<ReductionOp>(&fusion).size(), 2);
+  EXPECT_EQ(ir_utils::getOpsOfType<UnaryOp>(&fusion).size(), 1);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor at0 = at::randn({128, 128}, options);
+  FusionExecutorCache fec(std::move(fusion_ptr));
+  auto outputs = fec.runFusionWithInputs({at0});
+
+  auto ref_rsqrt = at0.sum({1}).rsqrt().unsqueeze(1);
+  EXPECT_TRUE(at::allclose(
+      outputs[0], at0 * ref_rsqrt + at0.sum({0}).unsqueeze(0)));
+  EXPECT_TRUE(at::allclose(outputs[1], at0 * ref_rsqrt));
+}
+
 } // namespace nvfuser::optimization
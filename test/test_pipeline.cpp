@@ -7,6 +7,7 @@
 // clang-format on
 #include <gtest/gtest.h>
 
+#include <expr_evaluator.h>
 #include <fusion.h>
 #include <ir/all_nodes.h>
 #include <ir/builder.h>
@@ -361,4 +362,65 @@ TEST_F(NVFuserTest, ReshardingDetection) {
   GTEST_EXPECT_TRUE(isResharding(tv26->definition()));
 }
 
+TEST_F(NVFuserTest, PipelinePartitioning_CUDA) {
+  // Splitting before the reduction balances the stages best, while splitting
+  // after it only transfers the reduced tensor
+  for (double tolerance : {0.0, 0.5}) {
+    Fusion fusion;
+    FusionGuard fg(&fusion);
+
+    TensorView* tv0 = makeContigTensor(2);
+    fusion.addInput(tv0);
+    TensorView* tv1 = neg(tv0);
+    TensorView* tv2 = neg(tv1);
+    TensorView* tv3 = sum(tv2, {1});
+    TensorView* tv4 = neg(tv3);
+    fusion.addOutput(tv4);
+
+    ExpressionEvaluator expr_eval;
+    expr_eval.bind(tv0->axis(0)->extent(), 1024L);
+    expr_eval.bind(tv0->axis(1)->extent(), 1024L);
+
+    PipelinePartitionOptions options;
+    options.expr_costs = {
+        {tv1->definition(), 2.0},
+        {tv2->definition(), 1.0},
+        {tv3->definition(), 1.0},
+        {tv4->definition(), 2.0}};
+    options.expr_eval = &expr_eval;
+    options.imbalance_tolerance = tolerance;
+    std::vector<DeviceMesh> meshes(2);
+    meshes[0] = {0};
+    meshes[1] = {1};
+    PipelineDescriptor descriptor =
+        partitionPipeline(&fusion, meshes, options);
+
+    ASSERT_EQ(descriptor.stage_descriptors.size(), meshes.size());
+    auto stage_of = [&](TensorView* tv) {
+      for (auto i : c10::irange(descriptor.stage_descriptors.size())) {
+        if (descriptor.stage_descriptors.at(i).vals().has(tv)) {
+          return (int64_t)i;
+        }
+      }
+      return (int64_t)-1;
+    };
+    TensorView* cut_tv = tolerance == 0.0 ? tv2 : tv3;
+    TensorView* consumer = tolerance == 0.0 ? tv3 : tv4;
+    EXPECT_EQ(stage_of(tv0), 0);
+    EXPECT_EQ(stage_of(tv1), 0);
+    EXPECT_EQ(stage_of(cut_tv), 0);
+    EXPECT_EQ(stage_of(consumer), 1);
+    EXPECT_EQ(stage_of(tv4), 1);
+    EXPECT_EQ(tv4->getDeviceMesh().vector(), meshes[1].vector());
+
+    // The consumer of the cut tensor reads a copy of it in its own stage
+    auto copy = consumer->definition()->input(0)->as<TensorView>();
+    ASSERT_TRUE(copy->definition()->isA<LoadStoreOp>());
+    EXPECT_EQ(copy->definition()->input(0), cut_tv);
+    EXPECT_EQ(stage_of(copy), 1);
+
+    Pipeline pipeline(&fusion, std::move(descriptor));
+  }
+}
+
 } // namespace nvfuser
@@ -10,6 +10,8 @@
 #include <kernel_cache.h>
 #include <ir/interface_nodes.h>
 #include <fusion.h>
+#include <scheduler/device_model.h>
+#include <scheduler/pointwise.h>
 #include <test/utils.h>
 #include <test/validator.h>
 #include <ops/all_ops.h>
@@ -201,4 +203,177 @@ TEST_F(PointwiseTest, VectorizeAllocationDomain) {
   testValidate(fusion, cg_outputs, {t0}, __LINE__, __FILE__);
 }
 
+TEST_F(PointwiseTest, PersistentGrid) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(
+      EnableOption::PointwisePersistentGrid);
+
+  auto fusion_ptr = std::make_unique<Fusion>();
+  auto fusion = fusion_ptr.get();
+  FusionGuard fg(fusion);
+
+  TensorView* tv0 = makeContigTensor(1);
+  fusion->addInput(tv0);
+  auto tv1 = add(tv0, IrBuilder::create<Val>(1.0, DataType::Float));
+  fusion->addOutput(tv1);
+
+  FusionExecutorCache fec(std::move(fusion_ptr));
+  fec.profile(true);
+
+  // Not divisible by the tile size, so the last tile is partial
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({(1 << 24) + 7}, options);
+  auto cg_outputs = fec.runFusionWithInputs({t0});
+
+  auto most_recent_params =
+      fec.getMostRecentKernelRuntime()->getMostRecentExecutorLog().params;
+  const auto* params = dynamic_cast<PointwiseParams*>(most_recent_params.get());
+  ASSERT_NE(params, nullptr);
+  EXPECT_TRUE(params->persistent_grid);
+  EXPECT_LE(
+      params->lparams.gdimx(),
+      (int64_t)at::cuda::getCurrentDeviceProperties()->multiProcessorCount *
+          at::cuda::getCurrentDeviceProperties()->maxThreadsPerMultiProcessor);
+
+  testValidate(fusion, cg_outputs, {t0}, __LINE__, __FILE__);
+}
+
+TEST_F(PointwiseTest, StreamingStores) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::StreamingStores);
+
+  auto fusion_ptr = std::make_unique<Fusion>();
+  auto fusion = fusion_ptr.get();
+  FusionGuard fg(fusion);
+
+  TensorView* tv0 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = add(tv0, IrBuilder::create<Val>(1.0, DataType::Float));
+  fusion->addOutput(tv1);
+
+  FusionExecutorCache fec(std::move(fusion_ptr));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({1024, 1024}, options);
+  auto cg_outputs = fec.runFusionWithInputs({t0});
+
+  // tv1 is written once, so its vectorized store is streaming
+  EXPECT_EQ(getVecSizeForPointwise(fec), 4);
+  const auto& executors = fec.getMostRecentKernelRuntime()->executors();
+  ASSERT_EQ(executors.size(), 1);
+  EXPECT_THAT(
+      executors.front().kernelString(),
+      ::testing::HasSubstr(
+          "storeLocalToGlobal<float, /*vec_size=*/4, CacheOp::Streaming>"));
+
+  testValidate(fusion, cg_outputs, {t0}, __LINE__, __FILE__);
+}
+
+// The parameters don't depend on the shapes, so a single kernel runs all of
+// them
+TEST_F(PointwiseTest, GenericKernels) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::GenericKernels);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  TensorView* tv0 = makeContigTensor(2);
+  TensorView* tv1 = makeContigTensor(1);
+  fusion->addInput(tv0);
+  fusion->addInput(tv1);
+  fusion->addOutput(add(tv0, broadcast(tv1, {true, false})));
+
+  FusionExecutorCache fec(std::move(fusion));
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  for (auto [m, n] : std::vector<std::pair<int64_t, int64_t>>{
+           {1024, 1024}, {3, 5}, {777, 129}, {1, 65537}}) {
+    at::Tensor t0 = at::randn({m, n}, options);
+    at::Tensor t1 = at::randn({n}, options);
+    auto outputs = fec.runFusionWithInputs({t0, t1});
+    testValidate(fec.fusion(), outputs, {t0, t1}, __LINE__, __FILE__);
+  }
+  EXPECT_EQ(fec.getKernelRuntimes().begin()->second.size(), 1);
+}
+
+// The persistent grid is sized from the occupancy of the compiled kernel, which
+// uses no shared memory. See [ Occupancy-Driven Launch Parameters ]
+TEST_F(PointwiseTest, OccupancyLaunch) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::OccupancyLaunch);
+  EnableOptionsGuard::getCurOptions().set(
+      EnableOption::PointwisePersistentGrid);
+
+  auto fusion_ptr = std::make_unique<Fusion>();
+  auto fusion = fusion_ptr.get();
+  FusionGuard fg(fusion);
+
+  TensorView* tv0 = makeContigTensor(1);
+  fusion->addInput(tv0);
+  auto tv1 = add(tv0, IrBuilder::create<Val>(1.0, DataType::Float));
+  fusion->addOutput(tv1);
+
+  FusionExecutorCache fec(std::move(fusion_ptr));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({(1 << 24) + 7}, options);
+  auto cg_outputs = fec.runFusionWithInputs({t0});
+
+  const auto& executors = fec.getMostRecentKernelRuntime()->executors();
+  ASSERT_EQ(executors.size(), 1);
+  const auto choice = executors.front().lastLaunchChoice();
+  ASSERT_TRUE(choice.has_value());
+  EXPECT_EQ(choice->chosen, executors.front().lastLaunchParams());
+  EXPECT_GE(choice->chosen_resident_warps, choice->requested_resident_warps);
+  EXPECT_EQ(choice->smem_carveout_pct, 0);
+  // A single wave
+  const int64_t warp_size = at::cuda::getCurrentDeviceProperties()->warpSize;
+  EXPECT_EQ(
+      choice->chosen_resident_warps,
+      choice->chosen.nBlocks() * ceilDiv(choice->chosen.nThreads(), warp_size));
+
+  testValidate(fusion, cg_outputs, {t0}, __LINE__, __FILE__);
+}
+
+// A row of tiles of the outer product doesn't fit in the L2 of the model, so
+// the grid is swizzled. See [ Pointwise Grid Swizzle ]
+TEST_F(PointwiseTest, GridSwizzle) {
+  DeviceModel small_l2 = getDeviceModel();
+  small_l2.l2_size = 16 * 1024;
+  setDeviceModel(small_l2);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  // Not divisible by the swizzle factors
+  at::Tensor t0 = at::randn({3001}, options);
+  at::Tensor t1 = at::randn({4100}, options);
+  std::vector<c10::IValue> aten_inputs({t0, t1});
+
+  for (bool flip_grid_binding : {false, true}) {
+    Fusion fusion;
+    FusionGuard fg(&fusion);
+
+    TensorView* tv0 = makeContigTensor(1);
+    TensorView* tv1 = makeContigTensor(1);
+    fusion.addInput(tv0);
+    fusion.addInput(tv1);
+    auto tv2 =
+        mul(broadcast(tv0, {false, true}), broadcast(tv1, {true, false}));
+    fusion.addOutput(tv2);
+
+    auto params = getPointwiseHeuristics(&fusion, aten_inputs);
+    ASSERT_NE(params, nullptr);
+    EXPECT_EQ(params->break_point, 1);
+    EXPECT_GT(params->grid_swizzle_factor, 1);
+    params->flip_grid_binding = flip_grid_binding;
+    schedulePointwise(&fusion, *params);
+
+    FusionExecutor fe;
+    fe.compileFusion(&fusion, aten_inputs, params->lparams);
+    auto cg_outputs = fe.runFusion(aten_inputs, params->lparams);
+    testValidate(&fusion, cg_outputs, aten_inputs, __LINE__, __FILE__);
+  }
+
+  resetDeviceModel();
+}
+
 } // namespace nvfuser
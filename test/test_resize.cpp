@@ -3254,4 +3254,66 @@ TEST_F(ResizeTest, SqueezeSlicedExpand) {
       fec.fusion(), cg_outputs, aten_inputs, {ref}, __LINE__, __FILE__);
 }
 
+// Rotary embedding of the query, where the slices and the cat of the
+// permuted query are moved to the input, so the fusion isn't segmented
+TEST_F(ResizeTest, ResizeToInputsRotaryEmbedding) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::ResizeToInputs);
+
+  auto fusion_ptr = std::make_unique<Fusion>();
+  auto fusion = fusion_ptr.get();
+  FusionGuard fg(fusion);
+
+  const int64_t b = 2, s = 16, h = 4, d = 128;
+
+  // [B, S, H, D]
+  auto tv0 = makeContigConcreteTensor({-1, -1, -1, d});
+  fusion->addInput(tv0);
+  // [S, D]
+  auto cos = makeContigTensor(2);
+  fusion->addInput(cos);
+  auto sin = makeContigTensor(2);
+  fusion->addInput(sin);
+
+  // [B, H, S, D]
+  auto q = permute(tv0, {0, 2, 1, 3});
+  auto x1 = slice(
+      q,
+      {{nullptr, nullptr},
+       {nullptr, nullptr},
+       {nullptr, nullptr},
+       {fusion->zeroVal(), IrBuilder::create<Val>(d / 2)}});
+  auto x2 = slice(
+      q,
+      {{nullptr, nullptr},
+       {nullptr, nullptr},
+       {nullptr, nullptr},
+       {IrBuilder::create<Val>(d / 2), IrBuilder::create<Val>(d)}});
+  auto rotated = cat({neg(x2), x1}, -1);
+  auto out = add(
+      mul(q, broadcast(cos, {true, true, false, false})),
+      mul(rotated, broadcast(sin, {true, true, false, false})));
+  fusion->addOutput(out);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn({b, s, h, d}, options);
+  auto t1 = at::randn({s, d}, options);
+  auto t2 = at::randn({s, d}, options);
+  std::vector<c10::IValue> aten_inputs({t0, t1, t2});
+
+  FusionExecutorCache fec(std::move(fusion_ptr));
+  auto cg_outputs = fec.runFusionWithInputs(aten_inputs);
+
+  auto runtime = fec.getMostRecentKernelRuntime();
+  EXPECT_FALSE(runtime->isSegmented());
+
+  auto t0_permuted = t0.permute({0, 2, 1, 3});
+  auto t0_rotated = at::cat(
+      {-t0_permuted.slice(3, d / 2, d), t0_permuted.slice(3, 0, d / 2)}, -1);
+  auto ref = t0_permuted * t1 + t0_rotated * t2;
+
+  testValidate(
+      fec.fusion(), cg_outputs, aten_inputs, {ref}, __LINE__, __FILE__);
+}
+
 } // namespace nvfuser
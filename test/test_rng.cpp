@@ -129,6 +129,48 @@ TEST_F(RNGTest, ManualScheduleValidateWithCURand) {
   testValidate(fusion, {out}, {t0}, {ref}, __LINE__, __FILE__);
 }
 
+// Two RNG ops in the same loop use separate caches of Philox outputs, so
+// each Philox call is still used for four consecutive elements
+TEST_F(RNGTest, InterleavedRNGOps) {
+  int64_t size = 1024;
+  auto dtype = at::kFloat;
+  std::unique_ptr<Fusion> fusion_ptr = std::make_unique<Fusion>();
+  auto fusion = fusion_ptr.get();
+  FusionGuard fg(fusion);
+
+  TensorView* tv0 = makeSymbolicTensor(1, aten_to_data_type(dtype));
+  fusion->addInput(tv0);
+  auto tv1 = rand_like(tv0);
+  auto tv2 = rand_like(tv0);
+  auto tv3 = add(tv1, tv2);
+  fusion->addOutput(tv3);
+
+  tv3->split(0, 8);
+  tv3->axis(0)->parallelize(ParallelType::TIDx);
+
+  tv1->computeAt(tv3, 1);
+  tv2->computeAt(tv3, 1);
+
+  auto options = at::TensorOptions().dtype(dtype).device(at::kCUDA, 0);
+  at::Tensor t0 = at::zeros({size}, options);
+
+  FusionExecutor fe;
+  fe.compileFusion(fusion, {t0});
+
+  EXPECT_THAT(
+      fe.kernelString(),
+      testing::Not(testing::HasSubstr("nvfuser_index_t rng_offset = -1;")));
+
+  at::manual_seed(0);
+  auto cg_outputs = fe.runFusion({t0});
+
+  at::manual_seed(0);
+  auto ref0 = generate_uniform(size, dtype);
+  auto ref1 = generate_uniform(size, dtype);
+
+  testValidate(fusion, cg_outputs, {t0}, {ref0 + ref1}, __LINE__, __FILE__);
+}
+
 TEST_F(RNGTest, ManualScheduleValidateWithCURand2) {
   auto dtype = at::kFloat;
   std::unique_ptr<Fusion> fusion_ptr = std::make_unique<Fusion>();
@@ -368,6 +410,33 @@ TEST_F(RNGTest, Normal) {
   }
 }
 
+// The normals of both Box-Muller pairs of a Philox result are computed once
+// and taken by the consecutive elements of an unrolled loop
+TEST_F(RNGTest, NormalPairsPerPhiloxCall) {
+  std::unique_ptr<Fusion> fusion_ptr = std::make_unique<Fusion>();
+  auto fusion = fusion_ptr.get();
+  FusionGuard fg(fusion);
+
+  TensorView* tv0 = makeContigTensor(1);
+  fusion->addInput(tv0);
+  fusion->addOutput(add(tv0, randn_like(tv0)));
+
+  FusionExecutorCache fec(std::move(fusion_ptr));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::zeros({10003}, options);
+  at::manual_seed(0);
+  auto cg_outputs = fec.runFusionWithInputs({t0});
+
+  const auto kernel_code =
+      fec.getMostRecentKernelRuntime()->executors().at(0).kernelString();
+  EXPECT_THAT(kernel_code, testing::HasSubstr("rng_normal_standard4f("));
+
+  at::manual_seed(0);
+  auto ref = generate_normal(10003, at::kFloat);
+  testValidate(fec.fusion(), cg_outputs, {t0}, {ref}, __LINE__, __FILE__);
+}
+
 TEST_F(RNGTest, RandLikeReduction) {
   auto dtype = at::kFloat;
   std::unique_ptr<Fusion> fusion_ptr = std::make_unique<Fusion>();
@@ -539,4 +608,52 @@ TEST_F(RNGTest, DifferentOffsets) {
   }
 }
 
+// See [ CUDA Graph Replay of Segmented Fusions ]
+TEST_F(RNGTest, CudaGraphReplay) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::CudaGraph);
+
+  std::unique_ptr<Fusion> fusion_ptr = std::make_unique<Fusion>();
+  auto fusion = fusion_ptr.get();
+  FusionGuard fg(fusion);
+
+  TensorView* tv0 = makeContigTensor(1);
+  fusion->addInput(tv0);
+  TensorView* tv1 = rand_like(tv0);
+  TensorView* tv2 = add(tv0, tv1);
+  fusion->addOutput(tv2);
+
+  FusionExecutorCache fec(std::move(fusion_ptr));
+
+  const int64_t size = 10001;
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::zeros({size}, options);
+
+  // The first run is recorded, the others replay the graph
+  for (auto seed : c10::irange(3)) {
+    at::manual_seed(seed);
+    auto cg_outputs = fec.runFusionWithInputs({t0});
+    EXPECT_EQ(get_current_offset(), 4);
+
+    at::manual_seed(seed);
+    auto ref = generate_uniform(size, at::kFloat);
+
+    testValidate(
+        fec.fusion(),
+        cg_outputs,
+        {t0},
+        {ref},
+        __LINE__,
+        __FILE__,
+        "Seed " + std::to_string(seed));
+  }
+
+  // Without reseeding, each replay draws new numbers
+  auto r1 = fec.runFusionWithInputs({t0}).at(0);
+  auto r2 = fec.runFusionWithInputs({t0}).at(0);
+  EXPECT_FALSE(r1.equal(r2));
+
+  EXPECT_EQ(fec.getMostRecentKernelRuntime()->numCudaGraphs(), 1);
+}
+
 } // namespace nvfuser
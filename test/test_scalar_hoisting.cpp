@@ -5,6 +5,7 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 // clang-format on
+#include <gmock/gmock-matchers.h>
 #include <gtest/gtest.h>
 
 #include <executor.h>
@@ -389,4 +390,134 @@ __global__ void CUDAGeneratedKernel(int64_t i0, int64_t i1, int64_t i2, Tensor<i
       fusion.get(), cg_outputs, {start, end, step}, __LINE__, __FILE__);
 }
 
+
+TEST_F(ScalarHoistTest, IndexStrengthReduction) {
+  if (isOptionDisabled(DisableOption::IndexHoist)) {
+    GTEST_SKIP() << "Index hoisting disabled";
+  }
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(
+      EnableOption::IndexStrengthReduction);
+
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeContigTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = set(tv0);
+  auto tv2 = add(tv1, IrBuilder::create<Val>(1.0));
+  fusion.addOutput(tv2);
+
+  // [BIDx, serial, TIDx{128}]
+  for (auto tv : {tv1, tv2}) {
+    tv->split(1, 128);
+    tv->axis(0)->parallelize(ParallelType::BIDx);
+    tv->axis(2)->parallelize(ParallelType::TIDx);
+  }
+  inlineMost();
+
+  GpuLower gpulw(&fusion);
+  auto kernel = gpulw.run();
+
+  // The hoisted indices of the serial loop are incremented at the end of
+  // each iteration
+  int64_t num_increments = 0;
+  std::vector<Expr*> exprs = kernel->topLevelExprs();
+  while (!exprs.empty()) {
+    auto expr = exprs.back();
+    exprs.pop_back();
+    if (auto loop = dynamic_cast<kir::ForLoop*>(expr)) {
+      const auto& body = loop->body().exprs();
+      exprs.insert(exprs.end(), body.begin(), body.end());
+    } else if (auto ite = dynamic_cast<kir::IfThenElse*>(expr)) {
+      const auto& then_body = ite->thenBody().exprs();
+      exprs.insert(exprs.end(), then_body.begin(), then_body.end());
+      const auto& else_body = ite->elseBody().exprs();
+      exprs.insert(exprs.end(), else_body.begin(), else_body.end());
+    } else if (expr->isA<kir::IncrementScalar>()) {
+      num_increments++;
+    }
+  }
+  EXPECT_GT(num_increments, 0);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn({10, 1000}, options);
+
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, {t0});
+  auto cg_outputs = fe.runFusion({t0});
+
+  testValidate(&fusion, cg_outputs, {t0}, __LINE__, __FILE__);
+}
+
+TEST_F(ScalarHoistTest, FastDivmod) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::FastDivmod);
+
+  // The host computation of the multipliers matches integer division
+  for (int64_t bits : {32, 64}) {
+    for (int64_t d : {1, 2, 3, 7, 100, 641, 65536, 100003, 2147483647}) {
+      auto [multiplier, shift] = getFastDivmodParams(d, bits);
+      for (int64_t n : {0L, 1L, d - 1, d, d + 1, 123456789L, 2147483647L}) {
+        // Dividends are less than 2^(bits - 1)
+        if (bits == 32 && n > std::numeric_limits<int32_t>::max()) {
+          continue;
+        }
+        EXPECT_EQ(fastDiv(n, multiplier, shift, bits), n / d)
+            << n << " / " << d << " with " << bits << " bits";
+      }
+    }
+  }
+
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  // The input isn't contiguous, so its index is computed from the indices of
+  // both dimensions of the merged domain
+  auto tv0 = makeSymbolicTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = set(tv0);
+  auto tv2 = add(tv1, IrBuilder::create<Val>(1.0));
+  fusion.addOutput(tv2);
+
+  for (auto tv : {tv1, tv2}) {
+    tv->merge(0);
+    tv->split(0, 128);
+    tv->axis(0)->parallelize(ParallelType::BIDx);
+    tv->axis(1)->parallelize(ParallelType::TIDx);
+  }
+  inlineMost();
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn({10, 1000}, options);
+
+  for (auto index_type : {PrimDataType::Int32, PrimDataType::Int}) {
+    CompileParams cparams;
+    cparams.index_type = index_type;
+    FusionExecutor fe;
+    fe.compileFusion(&fusion, {t0}, LaunchParams(), cparams);
+
+    // The multiplier and shift of the extent of the inner dimension are
+    // kernel arguments
+    const auto& parameters = fe.kernel()->parameters();
+    EXPECT_EQ(
+        std::count_if(
+            parameters.begin(),
+            parameters.end(),
+            [](Val* v) {
+              return v->definition() != nullptr &&
+                  v->definition()->isA<kir::EncodeFastDivmod>();
+            }),
+        2);
+    EXPECT_THAT(fe.kernelString(), ::testing::HasSubstr("fastDiv("));
+
+    for (auto sizes : std::vector<std::vector<int64_t>>{
+             {10, 1000}, {1000, 1}, {3, 100003}, {129, 7}}) {
+      auto t = at::randn(sizes, options).transpose(0, 1);
+      auto cg_outputs = fe.runFusion({t});
+      testValidate(&fusion, cg_outputs, {t}, __LINE__, __FILE__);
+    }
+  }
+}
+
 } // namespace nvfuser
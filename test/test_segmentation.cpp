@@ -9,6 +9,7 @@
 #include <gtest/gtest.h>
 
 #include <fusion.h>
+#include <fusion_segmenter.h>
 #include <ops/all_ops.h>
 #include <test/utils.h>
 #include <test/validator.h>
@@ -227,4 +228,638 @@ TEST_F(SegmentationTest, SetAllocationDomainOnSegmentBoundary) {
   testValidate(fec.fusion(), out_tensors, {in_tensor}, __LINE__, __FILE__);
 }
 
+TEST_F(SegmentationTest, CudaGraphReplay) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::CudaGraph);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  TensorView* in = makeContigTensor(2);
+  TensorView* add_out = add(in, in);
+  add_out = segment_set(add_out);
+  TensorView* sum_out = sum(add_out, {0});
+  TensorView* div_out = div(add_out, sum_out);
+  fusion->addInput(in);
+  fusion->addOutput(div_out);
+
+  FusionExecutorCache fec(std::move(fusion));
+  // Replay with new inputs every time so that the data pointers have to be
+  // updated in the graph
+  for (auto i : c10::irange(3)) {
+    at::Tensor in_tensor = at::randn({16, 32}).cuda();
+    std::vector<at::Tensor> out_tensors = fec.runFusionWithInputs({in_tensor});
+    testValidate(
+        fec.fusion(),
+        out_tensors,
+        {in_tensor},
+        {(in_tensor + in_tensor) / (in_tensor + in_tensor).sum({0})},
+        __LINE__,
+        __FILE__,
+        "Iteration " + std::to_string(i));
+  }
+
+  FusionKernelRuntime* runtime = fec.getMostRecentKernelRuntime();
+  EXPECT_GE(runtime->fusionSegments()->groups().size(), 2);
+  EXPECT_EQ(runtime->numCudaGraphs(), 1);
+}
+
+TEST_F(SegmentationTest, IntermediateArena) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  TensorView* in = makeContigTensor(2);
+  TensorView* add_out = add(in, in);
+  add_out = segment_set(add_out);
+  TensorView* sum_out = sum(add_out, {0});
+  TensorView* div_out = div(add_out, sum_out);
+  fusion->addInput(in);
+  fusion->addOutput(div_out);
+
+  FusionExecutorCache fec(std::move(fusion));
+  // The first run plans the arena, and the following runs reuse it
+  for (auto i : c10::irange(3)) {
+    at::Tensor in_tensor = at::randn({16, 32}).cuda();
+    std::vector<at::Tensor> out_tensors = fec.runFusionWithInputs({in_tensor});
+    testValidate(
+        fec.fusion(),
+        out_tensors,
+        {in_tensor},
+        {(in_tensor + in_tensor) / (in_tensor + in_tensor).sum({0})},
+        __LINE__,
+        __FILE__,
+        "Iteration " + std::to_string(i));
+  }
+
+  FusionKernelRuntime* runtime = fec.getMostRecentKernelRuntime();
+  EXPECT_GE(runtime->fusionSegments()->groups().size(), 2);
+  // At least add_out is passed between segments
+  EXPECT_GE(runtime->intermediateArena().size(), 16 * 32 * sizeof(float));
+}
+
+TEST_F(SegmentationTest, LowPrecisionSegmentEdges) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(
+      EnableOption::LowPrecisionSegmentEdges);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  TensorView* in = makeContigTensor(2);
+  TensorView* add_out = add(in, in);
+  add_out = segment_set(add_out);
+  TensorView* sum_out = sum(add_out, {0});
+  TensorView* div_out = div(add_out, sum_out);
+  fusion->addInput(in);
+  fusion->addOutput(div_out);
+
+  FusionExecutorCache fec(std::move(fusion));
+  at::Tensor in_tensor = at::randn({16, 32}).cuda();
+  std::vector<at::Tensor> out_tensors = fec.runFusionWithInputs({in_tensor});
+
+  FusionKernelRuntime* runtime = fec.getMostRecentKernelRuntime();
+  EXPECT_GE(runtime->fusionSegments()->groups().size(), 2);
+  for (SegmentedEdge* edge : runtime->fusionSegments()->cedges()) {
+    EXPECT_EQ(edge->val->getDataType(), DataType::BFloat16);
+  }
+
+  // The edge is rounded to bfloat16 before the second segment
+  at::Tensor rounded = (in_tensor + in_tensor).to(at::kBFloat16).to(at::kFloat);
+  testValidate(
+      fec.fusion(),
+      out_tensors,
+      {in_tensor},
+      {rounded / rounded.sum({0})},
+      __LINE__,
+      __FILE__);
+}
+
+TEST_F(SegmentationTest, MemoryAwareRunOrder) {
+  auto make_fusion = []() {
+    auto fusion = std::make_unique<Fusion>();
+    FusionGuard fg(fusion.get());
+    TensorView* in = makeContigTensor(2);
+    fusion->addInput(in);
+    TensorView* big0 = segment_set(add(in, in));
+    TensorView* big1 = segment_set(mul(in, in));
+    fusion->addOutput(sum(big0, {1}));
+    fusion->addOutput(sum(big1, {1}));
+    return fusion;
+  };
+
+  at::Tensor in_tensor = at::randn({1024, 1024}).cuda();
+  FusionExecutorCache default_fec(make_fusion());
+  const int64_t default_peak = default_fec.predictPeakMemory({in_tensor});
+  // Both intermediates are held at once at most
+  EXPECT_GT(default_peak, 0);
+  EXPECT_LE(default_peak, 2 * 1024 * 1024 * (int64_t)sizeof(float) + 8192);
+
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::MemoryAwareRunOrder);
+  FusionExecutorCache fec(make_fusion());
+  EXPECT_LE(fec.predictPeakMemory({in_tensor}), default_peak);
+
+  std::vector<at::Tensor> out_tensors = fec.runFusionWithInputs({in_tensor});
+  testValidate(
+      fec.fusion(),
+      out_tensors,
+      {in_tensor},
+      {(in_tensor + in_tensor).sum({1}), (in_tensor * in_tensor).sum({1})},
+      __LINE__,
+      __FILE__);
+}
+
+TEST_F(SegmentationTest, CallerOwnedOutputs) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  TensorView* in = makeContigTensor(2);
+  TensorView* add_out = add(in, in);
+  add_out = segment_set(add_out);
+  TensorView* sum_out = sum(add_out, {0});
+  TensorView* div_out = div(add_out, sum_out);
+  fusion->addInput(in);
+  fusion->addOutput(div_out);
+  fusion->addOutput(sum_out);
+
+  FusionExecutorCache fec(std::move(fusion));
+  at::Tensor out_buffer = at::empty({16, 32}).cuda();
+  // The first run initializes the cached entries, and the following ones use
+  // them with the same buffer
+  for (auto i : c10::irange(3)) {
+    at::Tensor in_tensor = at::randn({16, 32}).cuda();
+    std::vector<at::Tensor> out_tensors = fec.runFusionWithInputs(
+        {in_tensor}, std::nullopt, std::nullopt, {out_buffer, at::Tensor()});
+    EXPECT_TRUE(out_tensors.at(0).is_same(out_buffer));
+    at::Tensor expected_sum = (in_tensor + in_tensor).sum({0});
+    testValidate(
+        fec.fusion(),
+        out_tensors,
+        {in_tensor},
+        {(in_tensor + in_tensor) / expected_sum, expected_sum},
+        __LINE__,
+        __FILE__,
+        "Iteration " + std::to_string(i));
+  }
+  EXPECT_EQ(fec.getKernelRuntimes().begin()->second.size(), 1);
+
+  // Buffers of a different shape are rejected
+  at::Tensor in_tensor = at::randn({16, 32}).cuda();
+  EXPECT_THAT(
+      [&]() {
+        fec.runFusionWithInputs(
+            {in_tensor},
+            std::nullopt,
+            std::nullopt,
+            {at::empty({16, 31}).cuda(), at::Tensor()});
+      },
+      ::testing::ThrowsMessage<nvfuser::nvfError>(
+          ::testing::HasSubstr("does not match the expected sizes")));
+}
+
+// A fusion whose predicted peak memory exceeds the budget is run in chunks
+// of its outer dimension, which share the kernels of the first chunk
+TEST_F(SegmentationTest, ChunkedExecution) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(
+      EnableOption::ChunkedExecution, {"4"});
+  EnableOptionsGuard::getCurOptions().set(EnableOption::Telemetry);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  TensorView* in = makeContigTensor(2);
+  TensorView* bias = makeContigTensor(1);
+  TensorView* add_out = add(in, broadcast(bias, {true, false}));
+  TensorView* sum_out = sum(add_out, {1});
+  fusion->addInput(in);
+  fusion->addInput(bias);
+  fusion->addOutput(add_out);
+  fusion->addOutput(sum_out);
+
+  // 16 MiB per tensor
+  FusionExecutorCache fec(std::move(fusion));
+  at::Tensor in_tensor = at::randn({4096, 1024}).cuda();
+  at::Tensor bias_tensor = at::randn({1024}).cuda();
+  std::vector<at::Tensor> out_tensors =
+      fec.runFusionWithInputs({in_tensor, bias_tensor});
+  at::Tensor expected_add = in_tensor + bias_tensor;
+  testValidate(
+      fec.fusion(),
+      out_tensors,
+      {in_tensor, bias_tensor},
+      {expected_add, expected_add.sum({1})},
+      __LINE__,
+      __FILE__);
+
+  // The chunks of equal size hit the input cache
+  const FusionTelemetry::Snapshot snapshot = fec.telemetry().snapshot();
+  EXPECT_GE(snapshot.runs, 4);
+  EXPECT_EQ(snapshot.input_cache_hits, snapshot.runs - 1);
+  EXPECT_EQ(snapshot.compilations, 1);
+
+  // Reducing the outer dimension prevents chunking
+  auto outer_fusion = std::make_unique<Fusion>();
+  FusionGuard outer_fg(outer_fusion.get());
+  TensorView* outer_in = makeContigTensor(2);
+  outer_fusion->addInput(outer_in);
+  outer_fusion->addOutput(sum(outer_in, {0}));
+
+  FusionExecutorCache outer_fec(std::move(outer_fusion));
+  out_tensors = outer_fec.runFusionWithInputs({in_tensor});
+  testValidate(
+      outer_fec.fusion(),
+      out_tensors,
+      {in_tensor},
+      {in_tensor.sum({0})},
+      __LINE__,
+      __FILE__);
+  EXPECT_EQ(outer_fec.telemetry().snapshot().runs, 1);
+}
+
+// Pinned host inputs and outputs are streamed through the device in tiles
+// of the outer dimension
+TEST_F(SegmentationTest, HostStreaming) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  TensorView* in = makeContigTensor(2);
+  TensorView* bias = makeContigTensor(1);
+  TensorView* add_out = add(in, broadcast(bias, {true, false}));
+  TensorView* sum_out = sum(add_out, {1});
+  fusion->addInput(in);
+  fusion->addInput(bias);
+  fusion->addOutput(add_out);
+  fusion->addOutput(sum_out);
+
+  FusionExecutorCache fec(std::move(fusion));
+  // Tiles of 256 rows, the last of which is shorter
+  fec.setHostStreamingTileBytes(256 * 1024 * 4);
+  at::Tensor in_tensor = at::randn({1000, 1024}).pin_memory();
+  at::Tensor bias_tensor = at::randn({1024}).pin_memory();
+  at::Tensor out_buffer = at::empty({1000, 1024}).pin_memory();
+  std::vector<at::Tensor> out_tensors = fec.runFusionWithInputs(
+      {in_tensor, bias_tensor},
+      std::nullopt,
+      std::nullopt,
+      {out_buffer, at::Tensor()});
+  EXPECT_TRUE(out_tensors.at(0).is_same(out_buffer));
+  EXPECT_TRUE(out_tensors.at(1).is_cpu());
+  at::Tensor expected_add = in_tensor + bias_tensor;
+  EXPECT_TRUE(out_tensors.at(0).allclose(expected_add));
+  EXPECT_TRUE(
+      out_tensors.at(1).allclose(expected_add.sum({1}), 1e-4, 1e-3));
+
+  // Host tensors can't be given to fusions that can't be chunked
+  auto outer_fusion = std::make_unique<Fusion>();
+  FusionGuard outer_fg(outer_fusion.get());
+  TensorView* outer_in = makeContigTensor(2);
+  outer_fusion->addInput(outer_in);
+  outer_fusion->addOutput(sum(outer_in, {0}));
+
+  FusionExecutorCache outer_fec(std::move(outer_fusion));
+  EXPECT_THAT(
+      [&]() { outer_fec.runFusionWithInputs({in_tensor}); },
+      ::testing::ThrowsMessage<nvfuser::nvfError>(
+          ::testing::HasSubstr("can only be given to fusions")));
+}
+
+TEST_F(SegmentationTest, MultiStreamSegments) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::MultiStreamSegments);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  // The two reductions can't be scheduled as one kernel and don't depend on
+  // each other
+  TensorView* in = makeContigTensor(2);
+  TensorView* sum0 = sum(in, {0});
+  TensorView* sum1 = sum(in, {1});
+  fusion->addInput(in);
+  fusion->addOutput(sum0);
+  fusion->addOutput(sum1);
+
+  FusionExecutorCache fec(std::move(fusion));
+  for (auto i : c10::irange(3)) {
+    at::Tensor in_tensor = at::randn({128, 256}).cuda();
+    std::vector<at::Tensor> out_tensors = fec.runFusionWithInputs({in_tensor});
+    testValidate(
+        fec.fusion(),
+        out_tensors,
+        {in_tensor},
+        {in_tensor.sum({0}), in_tensor.sum({1})},
+        __LINE__,
+        __FILE__,
+        "Iteration " + std::to_string(i));
+  }
+
+  FusionKernelRuntime* runtime = fec.getMostRecentKernelRuntime();
+  EXPECT_EQ(runtime->fusionSegments()->groups().size(), 2);
+  EXPECT_EQ(runtime->numSegmentStreams(), 2);
+}
+
+TEST_F(SegmentationTest, L2Persistence) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::L2Persistence);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  // Both segments read in
+  TensorView* in = makeContigTensor(2);
+  TensorView* add_out = add(in, IrBuilder::create<Val>(1.0));
+  add_out = segment_set(add_out);
+  TensorView* mul_out = mul(add_out, in);
+  fusion->addInput(in);
+  fusion->addOutput(mul_out);
+
+  FusionExecutorCache fec(std::move(fusion));
+  at::Tensor in_tensor = at::randn({1024, 1024}).cuda();
+  std::vector<at::Tensor> out_tensors = fec.runFusionWithInputs({in_tensor});
+  testValidate(
+      fec.fusion(),
+      out_tensors,
+      {in_tensor},
+      {(in_tensor + 1) * in_tensor},
+      __LINE__,
+      __FILE__);
+
+  // Only the first segment reading in keeps it in L2
+  FusionKernelRuntime* runtime = fec.getMostRecentKernelRuntime();
+  ASSERT_EQ(runtime->fusionSegments()->groups().size(), 2);
+  EXPECT_EQ(
+      std::count_if(
+          runtime->executors().begin(),
+          runtime->executors().end(),
+          [](const FusionExecutor& fe) {
+            return fe.kernelString().find("CacheOp::EvictLast") !=
+                std::string::npos;
+          }),
+      1);
+}
+
+TEST_F(SegmentationTest, RecomputeCheapProducers) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(
+      EnableOption::RecomputeCheapProducers);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  // The two reductions can't be scheduled as one kernel. tv2 is cheaper to
+  // recompute from the half input than to write and read back as float.
+  TensorView* tv0 = makeContigTensor(2, DataType::Half);
+  fusion->addInput(tv0);
+  TensorView* tv1 = castOp(DataType::Float, tv0);
+  TensorView* tv2 = mul(tv1, tv1);
+  TensorView* tv3 = sum(tv2, {0});
+  TensorView* tv4 = sum(tv2, {1});
+  fusion->addOutput(tv3);
+  fusion->addOutput(tv4);
+
+  auto options = at::TensorOptions().dtype(at::kHalf).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({128, 256}, options);
+
+  FusionExecutorCache fec(std::move(fusion));
+  std::vector<at::Tensor> outputs = fec.runFusionWithInputs({t0});
+
+  FusionKernelRuntime* runtime = fec.getMostRecentKernelRuntime();
+  const auto& groups = runtime->fusionSegments()->groups();
+  EXPECT_EQ(groups.size(), 2);
+  // Both segments read the fusion input instead of an intermediate
+  for (auto group : groups) {
+    for (auto inp : group->inputs()) {
+      EXPECT_TRUE(inp->isFusionInput()) << inp->toString();
+    }
+  }
+
+  auto t2 = t0.to(at::kFloat).square();
+  testValidate(
+      fec.fusion(),
+      outputs,
+      {t0},
+      {t2.sum({0}), t2.sum({1})},
+      __LINE__,
+      __FILE__);
+}
+
+TEST_F(SegmentationTest, HorizontalFusion) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::HorizontalFusion);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  // Three independent updates of differently shaped tensors that only share
+  // a scalar, like the parameter updates of an optimizer step
+  Val* lr = IrBuilder::create<Val>(DataType::Double);
+  fusion->addInput(lr);
+  std::vector<at::Tensor> inputs;
+  std::vector<at::Tensor> expected_outputs;
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  const double lr_value = 0.1;
+  for (const std::vector<int64_t>& shape :
+       std::vector<std::vector<int64_t>>{{1000}, {33, 65}, {7, 3, 129}}) {
+    TensorView* param = makeContigTensor((int64_t)shape.size());
+    TensorView* grad = makeContigTensor((int64_t)shape.size());
+    fusion->addInput(param);
+    fusion->addInput(grad);
+    fusion->addOutput(sub(param, mul(grad, lr)));
+
+    at::Tensor t_param = at::randn(shape, options);
+    at::Tensor t_grad = at::randn(shape, options);
+    inputs.push_back(t_param);
+    inputs.push_back(t_grad);
+    expected_outputs.push_back(t_param - t_grad * lr_value);
+  }
+
+  std::vector<c10::IValue> aten_inputs = {lr_value};
+  aten_inputs.insert(aten_inputs.end(), inputs.begin(), inputs.end());
+
+  FusionExecutorCache fec(std::move(fusion));
+  std::vector<at::Tensor> outputs = fec.runFusionWithInputs(aten_inputs);
+
+  FusionKernelRuntime* runtime = fec.getMostRecentKernelRuntime();
+  const auto& groups = runtime->fusionSegments()->groups();
+  ASSERT_EQ(groups.size(), 1);
+  EXPECT_EQ(groups.front()->heuristic(), ScheduleHeuristic::Horizontal);
+
+  testValidate(
+      fec.fusion(), outputs, aten_inputs, expected_outputs, __LINE__, __FILE__);
+}
+
+namespace {
+
+//! Vetoes all merges and counts how often it's asked
+class VetoingCostModel : public SegmentationCostModel {
+ public:
+  double mergeScore(
+      SegmentedFusion* segmented_fusion,
+      SchedulerRuntimeInfo& runtime_info,
+      SegmentedGroup* a,
+      SegmentedGroup* b,
+      ScheduleHeuristic heuristic) override {
+    num_queries++;
+    return -1;
+  }
+
+  std::string name() const override {
+    return "veto";
+  }
+
+  int64_t num_queries = 0;
+};
+
+} // namespace
+
+TEST_F(SegmentationTest, CostModel) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = add(tv0, IrBuilder::create<Val>(1.0));
+  auto tv2 = sum(tv1, {1});
+  fusion->addOutput(tv2);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({128, 256}, options);
+
+  KernelArgumentHolder args;
+  args.setDeviceIndex(0);
+  args.push(t0);
+
+  // The default cost model only orders merges
+  auto segmented_fusion = SegmentCandidateFinder::segment(fusion.get(), args);
+  EXPECT_EQ(segmented_fusion->groups().size(), 1);
+
+  // A negative score prevents merges that could be scheduled
+  auto cost_model = std::make_shared<VetoingCostModel>();
+  SegmentCandidateFinderOptions segment_options;
+  segment_options.cost_model = cost_model;
+  segmented_fusion =
+      SegmentCandidateFinder::segment(fusion.get(), args, segment_options);
+  EXPECT_EQ(segmented_fusion->groups().size(), 2);
+  EXPECT_GT(cost_model->num_queries, 0);
+}
+
+// Alternately centering the columns and the rows can't be done by a single
+// kernel, so the groups are merged over many iterations, each of which
+// proposes most of the merges of the previous one again
+TEST_F(SegmentationTest, ManySegments) {
+  constexpr int64_t kNumCenterings = 16;
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+  TensorView* tv = tv0;
+  for (int64_t i = 0; i < kNumCenterings; i++) {
+    const int64_t dim = i % 2;
+    tv = sub(tv, mean(tv, {(int)dim}, /*keepdim=*/true));
+  }
+  fusion->addOutput(tv);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({128, 256}, options);
+
+  FusionExecutorCache fec(std::move(fusion));
+  auto outputs = fec.runFusionWithInputs({t0});
+
+  FusionKernelRuntime* runtime = fec.getMostRecentKernelRuntime();
+  EXPECT_GT(runtime->fusionSegments()->groups().size(), 1);
+
+  at::Tensor expected = t0;
+  for (int64_t i = 0; i < kNumCenterings; i++) {
+    expected = expected - expected.mean({i % 2}, /*keepdim=*/true);
+  }
+  testValidate(fec.fusion(), outputs, {t0}, {expected}, __LINE__, __FILE__);
+}
+
+// The scalar arithmetic on a CPU scalar is evaluated on the host, and the
+// kernel reading its result takes it by value as a CPU scalar
+TEST_F(SegmentationTest, HostEvaluatedSegment) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::HostEvaluatedSegments);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeSymbolicTensor(0);
+  tv0->setCpuScalar(true);
+  auto tv1 = makeSymbolicTensor(1);
+  fusion->addInput(tv0);
+  fusion->addInput(tv1);
+  auto tv2 = add(mul(tv0, IrBuilder::create<Val>(2.0)), tv0);
+  auto tv3 = segment_set(tv2);
+  auto tv4 = mul(tv1, tv3);
+  fusion->addOutput(tv4);
+
+  at::Tensor t0 = at::scalar_tensor(1.5, at::TensorOptions().dtype(at::kFloat));
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t1 = at::randn({1024}, options);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  auto outputs = executor_cache.runFusionWithInputs({t0, t1});
+
+  FusionKernelRuntime* runtime = executor_cache.getMostRecentKernelRuntime();
+  const auto& groups = runtime->fusionSegments()->groups();
+  ASSERT_EQ(groups.size(), 2);
+  for (auto group : groups) {
+    const bool reads_tv1 = std::find(
+                               group->inputs().begin(),
+                               group->inputs().end(),
+                               runtime->fusionSegments()->inputs().at(1)) !=
+        group->inputs().end();
+    EXPECT_EQ(runtime->isEvaluatedOnHost(group), !reads_tv1);
+  }
+
+  testValidate(
+      executor_cache.fusion(),
+      outputs,
+      {t0, t1},
+      {t1 * (t0 * 2.0 + t0)},
+      __LINE__,
+      __FILE__);
+}
+
+// Both segments are timed against ATen on their first run, and later runs
+// take the faster path
+TEST_F(SegmentationTest, ProfileGuidedFallback) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::ProfileGuidedFallback);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = segment_set(relu(tv0));
+  auto tv2 = sum(neg(tv1), {1});
+  fusion->addOutput(tv2);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({1024, 512}, options);
+  at::Tensor expected = (-t0.relu()).sum({1});
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  for (auto i : c10::irange(2)) {
+    (void)i; // Suppress unused variable warning
+    auto outputs = executor_cache.runFusionWithInputs({t0});
+    testValidate(
+        executor_cache.fusion(), outputs, {t0}, {expected}, __LINE__, __FILE__);
+  }
+
+  // The ids of a new lookup start from the same one
+  InputsIdLookup inputs_id_lookup;
+  const size_t cache_id = inputs_id_lookup.lookupId({t0}).id;
+  FusionKernelRuntime* runtime = executor_cache.getMostRecentKernelRuntime();
+  const auto& groups = runtime->fusionSegments()->groups();
+  EXPECT_EQ(groups.size(), 2);
+  for (auto group : groups) {
+    EXPECT_TRUE(runtime->isRunWithAten(cache_id, group).has_value());
+  }
+}
+
 } // namespace nvfuser
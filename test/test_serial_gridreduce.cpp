@@ -256,4 +256,62 @@ TEST_F(SerialGridReductionTest, CodegenNodes) {
   }
 }
 
+// Test the lowering of a grid reduction requested to be serial
+TEST_F(SerialGridReductionTest, Lowering) {
+  std::unique_ptr<Fusion> fusion_ptr = std::make_unique<Fusion>();
+  auto fusion = fusion_ptr.get();
+  FusionGuard fg(fusion);
+
+  const int64_t blocks_x = 8;
+  const int64_t blocks_z = 5;
+  const int64_t serial = 4;
+  const int64_t H = 7 * blocks_z;
+  const int64_t W = blocks_x * serial * 128;
+
+  auto tv0 = makeContigConcreteTensor({H, W});
+  fusion->addInput(tv0);
+  auto tv1 = sum(tv0, {0});
+  fusion->addOutput(tv1);
+
+  auto tv2 = tv0->cacheAfter();
+  auto tv3 = tv1->cacheBefore();
+
+  // [ rS{H}, iS{W} ] -> [ iBIDx, iS{serial}, iTIDx{128}, rS, rBIDz ]
+  tv3->reorder({{1, 0}, {0, 1}});
+  tv3->split(1, blocks_z);
+  tv3->split(0, 128);
+  tv3->split(0, serial);
+  tv3->axis(0)->parallelize(ParallelType::BIDx);
+  tv3->axis(2)->parallelize(ParallelType::TIDx);
+  tv3->axis(4)->parallelize(ParallelType::BIDz);
+
+  // Reduce the serial part of H in each block first
+  auto tv4 = tv3->rFactor({3});
+
+  TransformPropagator propagator(tv4);
+  MaxRootDomainInfoSpanningTree(tv4).traverse(&propagator);
+  scheduler_utils::parallelizeAllLike(tv4);
+  tv3->definition()->as<ReductionOp>()->requestSerialGridReduction();
+
+  inlineMost();
+
+  FusionExecutor fe;
+  fe.compileFusion(fusion);
+  const auto kernel_code = fe.kernelString();
+  EXPECT_THAT(kernel_code, testing::HasSubstr("serialReductionStep"));
+  EXPECT_THAT(kernel_code, testing::HasSubstr("blockSerializeWait"));
+  EXPECT_THAT(kernel_code, testing::HasSubstr("blockSerializeRelease"));
+  EXPECT_THAT(kernel_code, testing::Not(testing::HasSubstr("gridReduce<")));
+
+  auto input = at::randn(
+      {H, W}, at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0));
+  auto outputs = fe.runFusion({input});
+  testValidate(fusion, outputs, {input}, __LINE__, __FILE__);
+
+  // The semaphores are reset by the last block, so the kernel can be run
+  // again
+  outputs = fe.runFusion({input});
+  testValidate(fusion, outputs, {input}, __LINE__, __FILE__);
+}
+
 } // namespace nvfuser
@@ -5445,4 +5445,84 @@ TEST_F(ShiftTest, ContigPredicateShift) {
   NVF_CHECK(t3.index(indices).equal((ref + 1).index(indices)));
 }
 
+
+// Chains of stencils are scheduled automatically, see [ Stencil Scheduler ]
+TEST_F(ShiftTest, StencilScheduler5ptChain) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  Fusion& fusion = *fusion_ptr.get();
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeSymbolicTensor(3);
+  fusion.addInput(tv0);
+  std::vector<std::vector<int>> offsets = {
+      {0, -1, 0}, {0, 1, 0}, {0, 0, -1}, {0, 0, 1}};
+
+  auto stencil = [&](TensorView* inp) {
+    auto out = inp;
+    for (const auto& offset : offsets) {
+      out = add(out, shift(inp, offset));
+    }
+    return div(out, IrBuilder::create<Val>(offsets.size() + 1.0));
+  };
+  auto tv1 = stencil(tv0);
+  auto tv2 = stencil(tv1);
+  fusion.addOutput(tv1);
+  fusion.addOutput(tv2);
+
+  FusionExecutorCache fec(std::move(fusion_ptr));
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  for (int64_t numel : {5, 99, 1000}) {
+    at::Tensor t0 = at::randn({3, numel, numel + 1}, options);
+    std::vector<c10::IValue> inputs = {t0};
+    auto cg_outputs = fec.runFusionWithInputs(inputs);
+
+    validateSegmentation(
+        fec.getMostRecentKernelRuntime(), {ScheduleHeuristic::Stencil});
+
+    auto ref_stencil = [&](at::Tensor inp) {
+      auto out = inp;
+      for (const auto& offset : offsets) {
+        out = out + shift(inp, offset);
+      }
+      return out / int(offsets.size() + 1);
+    };
+    auto t1 = ref_stencil(t0);
+    auto t2 = ref_stencil(t1);
+    testValidate(
+        fec.fusion(), cg_outputs, inputs, {t1, t2}, __LINE__, __FILE__);
+  }
+}
+
+// Gathered windows are scheduled by the stencil scheduler when they are
+// reduced
+TEST_F(ShiftTest, StencilSchedulerGather) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  Fusion& fusion = *fusion_ptr.get();
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = add(tv0, IrBuilder::create<Val>(1.0));
+  auto tv2 = gather(tv1, {3, 5}, {{1, 1}, {2, 2}});
+  auto tv3 = sum(tv2, {-2, -1});
+  auto tv4 = div(tv3, IrBuilder::create<Val>(15.0));
+  fusion.addOutput(tv4);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({99, 101}, options);
+  std::vector<c10::IValue> inputs = {t0};
+
+  FusionExecutorCache fec(std::move(fusion_ptr));
+  auto cg_outputs = fec.runFusionWithInputs(inputs);
+
+  validateSegmentation(
+      fec.getMostRecentKernelRuntime(), {ScheduleHeuristic::Stencil});
+
+  auto t1 = t0 + 1;
+  auto t2 = gather(t1, {3, 5}, {{1, 1}, {2, 2}});
+  auto t3 = sum(t2, {-2, -1});
+  auto ref = t3 / 15;
+  testValidate(fec.fusion(), cg_outputs, inputs, {ref}, __LINE__, __FILE__);
+}
+
 } // namespace nvfuser
@@ -688,4 +688,60 @@ TEST_F(SmemReuseTest, ExpandInterferes) {
   testExpand(false);
 }
 
+// Test that packing reclaims memory the stack can't, because the reclaimable
+// allocation is at the bottom of the stack. D and A are written, D is last
+// read, the block syncs, A is last read, B is written, the block syncs again,
+// and C is written. The stack allocates B and C on top of A, since the second
+// sync happens while B is waiting to be pushed. Packing places D and B at
+// address 0, and A and C above B.
+TEST_F(SmemReuseTest, IntervalGraphPacking) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  int64_t H = 32;
+  auto tv0 =
+      full({IrBuilder::create<Val>(H)}, fusion->oneVal(), DataType::Float);
+  auto tv1 = set(tv0); // pos = a. D = tv1 [H]
+  tv1->setMemoryType(MemoryType::Shared);
+  auto tv2 = pad(tv0, {fusion->zeroVal(), fusion->oneVal()}); // A = tv2 [H+1]
+  tv2->setMemoryType(MemoryType::Shared);
+
+  auto tv3 = add(pad(tv1, {fusion->zeroVal(), fusion->oneVal()}), tv2); // b
+  auto tv4 = sum(tv3, {0}); // first sync
+  tv4->axis(0)->parallelize(ParallelType::TIDx);
+
+  auto tv5 = add(broadcast(tv4, {true}), tv2); // pos = d
+  auto tv6 = pad(tv5, {fusion->zeroVal(), fusion->oneVal()}); // B [H+2]
+  tv6->setMemoryType(MemoryType::Shared);
+  auto tv7 = sum(tv6, {0}); // second sync
+  tv7->axis(0)->parallelize(ParallelType::TIDx);
+
+  auto tv8 = mul(broadcast(tv7, {true}), tv6); // pos = e. C = tv8 [H+2]
+  tv8->setMemoryType(MemoryType::Shared);
+  auto tv9 = add(tv8, tv6); // pos = f
+  fusion->addOutput(tv9);
+
+  auto getSmemUsage = [&fusion]() {
+    GpuLower gpulw(fusion.get());
+    ExpressionEvaluator ee;
+    int64_t smem_usage = 0;
+    for (auto alloc : gpulw.run()->summary().dynamic_smem_allocations) {
+      EXPECT_NE(alloc->address(), nullptr);
+      auto addr = ee.evaluate(alloc->address()).as<int64_t>();
+      auto size = ee.evaluate(alloc->size()).as<int64_t>() *
+          dataTypeSize(alloc->buffer()->dtype());
+      smem_usage = std::max(smem_usage, addr + size);
+    }
+    return smem_usage;
+  };
+
+  EXPECT_EQ(
+      getSmemUsage(),
+      alignInt((H + 1) * 4) + alignInt((H + 2) * 4) + (H + 2) * 4);
+
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::SmemPacking);
+  EXPECT_EQ(getSmemUsage(), alignInt((H + 2) * 4) + (H + 2) * 4);
+}
+
 } // namespace nvfuser
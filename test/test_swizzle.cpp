@@ -471,6 +471,44 @@ TEST_F(SwizzleTest, TransposeBankConflictSwizzle2) {
   ASSERT_EQ(bank_conflict_info.at(tv1).first, std::vector<int>{16});
 }
 
+TEST_F(SwizzleTest, AutomaticBankConflictSwizzle) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::BankConflictSwizzle);
+
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeConcreteTensor({32, 32});
+  fusion.addInput(tv0);
+  auto tv1 = set(tv0);
+  auto tv2 = transpose(tv1, 0, 1);
+  auto tv3 = set(tv2);
+  fusion.addOutput(tv3);
+
+  tv1->setMemoryType(MemoryType::Shared);
+  tv1->axis(0)->parallelize(ParallelType::TIDy);
+  tv1->axis(1)->parallelize(ParallelType::TIDx);
+  tv2->axis(0)->parallelize(ParallelType::TIDy);
+  tv2->axis(1)->parallelize(ParallelType::TIDx);
+  tv3->axis(0)->parallelize(ParallelType::TIDy);
+  tv3->axis(1)->parallelize(ParallelType::TIDx);
+
+  // 32-way bank confliction
+  ASSERT_EQ(fusion.bankConflictInfo().at(tv1).first, std::vector<int>{32});
+
+  // compileFusion swizzles tv1 before lowering
+  FusionExecutor fe;
+  fe.compileFusion(&fusion);
+  EXPECT_TRUE(tv1->hasSwizzleOp());
+  EXPECT_TRUE(fusion.bankConflictInfo().empty());
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn({32, 32}, options);
+  auto cg_outputs = fe.runFusion({t0});
+
+  testValidate(&fusion, cg_outputs, {t0}, __LINE__, __FILE__);
+}
+
 TEST_F(SwizzleTest, DataSwizzleGlobal) {
   // Data swizzle is ignored in global indexing, so we should just throw an
   // error if someone wants to do so.
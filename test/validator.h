@@ -7,6 +7,8 @@
 // clang-format on
 
 #include <csrc/validator_utils.h>
+#include <debug.h>
+#include <executor.h>
 
 namespace nvfuser {
 
@@ -166,4 +168,38 @@ void testValidate(
       tolerances);
 }
 
+//! Largest absolute difference of each output of a scheduled fusion between
+//! compiling it with and without CompileParams::enable_fast_math, to report
+//! the error fast math introduces for the given inputs, see [ Fast Math ].
+//! The errors are also printed.
+std::vector<double> getFastMathErrors(
+    Fusion* fusion,
+    const at::ArrayRef<c10::IValue>& aten_inputs,
+    const LaunchParams& lparams = LaunchParams()) {
+  std::vector<std::vector<at::Tensor>> outputs;
+  for (bool enable_fast_math : {false, true}) {
+    CompileParams cparams;
+    cparams.enable_fast_math = enable_fast_math;
+    FusionExecutor fe;
+    fe.compileFusion(fusion, aten_inputs, lparams, cparams);
+    outputs.push_back(fe.runFusion(aten_inputs, lparams, cparams));
+  }
+
+  std::vector<double> errors;
+  for (auto i : c10::irange(outputs.at(0).size())) {
+    const auto& precise = outputs.at(0).at(i);
+    const auto& fast = outputs.at(1).at(i);
+    const double error = precise.numel() == 0
+        ? 0.0
+        : (fast.to(at::kDouble) - precise.to(at::kDouble))
+              .abs()
+              .max()
+              .item<double>();
+    debug() << "Fast math error of output " << i << ": " << error
+            << std::endl;
+    errors.push_back(error);
+  }
+  return errors;
+}
+
 } // namespace nvfuser
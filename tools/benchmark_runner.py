@@ -0,0 +1,261 @@
+# SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+# All rights reserved.
+# SPDX-License-Identifier: BSD-3-Clause
+#
+# "benchmark_runner.py -h" for help.
+#
+# Runs the C++ benchmarks (bin/nvfuser_bench) and the python benchmarks
+# (python_benchmarks/) of the checked out commit and stores their results in a
+# single JSON file, <out_dir>/<gpu>/<commit>.json:
+#
+#   {
+#     "gpu": "NVIDIA A100-SXM4-80GB",
+#     "commit": "<sha>",
+#     "peak_bandwidth_gbps": 2039.0,
+#     "benchmarks": {
+#       "cpp/<name>": {"time_s": ..., "stddev_s": ..., "peak_bandwidth_pct": ...},
+#       "python/<name>": {...}
+#     }
+#   }
+#
+# Two result files, e.g., of the same GPU at two commits, are compared with the
+# "compare" command, which exits with status 1 if a benchmark regressed by more
+# than the noise threshold.
+
+import argparse
+import json
+import math
+import os
+import re
+import shlex
+import subprocess
+import sys
+import tempfile
+from typing import Optional
+
+TIME_UNIT_IN_SECONDS = {"ns": 1e-9, "us": 1e-6, "ms": 1e-3, "s": 1.0}
+
+
+def get_head_commit() -> str:
+    return subprocess.check_output("git rev-parse HEAD", text=True, shell=True).strip()
+
+
+# Returns the name and the peak memory bandwidth in GB/s of the current GPU,
+# computed the same way as for the python benchmarks.
+def get_gpu() -> tuple[str, float]:
+    repo_root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+    sys.path.insert(0, repo_root)
+    from python_benchmarks.core import DEVICE_PROPERTIES
+
+    return (
+        DEVICE_PROPERTIES["gpu_name"],
+        DEVICE_PROPERTIES["gpu_peak_bandwidth_gbps"],
+    )
+
+
+def mean_and_stddev(values: list[float]) -> tuple[float, Optional[float]]:
+    mean = sum(values) / len(values)
+    if len(values) < 2:
+        return mean, None
+    variance = sum((v - mean) ** 2 for v in values) / (len(values) - 1)
+    return mean, math.sqrt(variance)
+
+
+# Runs nvfuser_bench and returns its results by benchmark name. Repetitions,
+# e.g., with --benchmark_repetitions, are averaged.
+def run_cpp_benchmarks(
+    benchmark_args: list[str], peak_bandwidth_gbps: float
+) -> dict[str, dict]:
+    for arg in benchmark_args:
+        if arg.startswith("--benchmark_out") or arg.startswith("--benchmark_format"):
+            raise ValueError(f"{arg} should be specified by benchmark_runner.py")
+    with tempfile.NamedTemporaryFile(suffix=".json") as out:
+        subprocess.check_call(
+            ["bin/nvfuser_bench"]
+            + benchmark_args
+            + [f"--benchmark_out={out.name}", "--benchmark_format=json"]
+        )
+        data = json.load(out)
+
+    times: dict[str, list[float]] = {}
+    bandwidths: dict[str, list[float]] = {}
+    for row in data["benchmarks"]:
+        if row.get("run_type", "iteration") != "iteration":
+            continue
+        name = row.get("run_name", row["name"])
+        times.setdefault(name, []).append(
+            row["real_time"] * TIME_UNIT_IN_SECONDS[row["time_unit"]]
+        )
+        if "bytes_per_second" in row:
+            bandwidths.setdefault(name, []).append(row["bytes_per_second"])
+
+    results = {}
+    for name, values in times.items():
+        time_s, stddev_s = mean_and_stddev(values)
+        peak_bandwidth_pct = None
+        if name in bandwidths:
+            bandwidth_bps, _ = mean_and_stddev(bandwidths[name])
+            peak_bandwidth_pct = 100 * bandwidth_bps / (peak_bandwidth_gbps * 1e9)
+        results["cpp/" + name] = {
+            "time_s": time_s,
+            "stddev_s": stddev_s,
+            "peak_bandwidth_pct": peak_bandwidth_pct,
+        }
+    return results
+
+
+# Runs the python benchmarks with pytest-benchmark and returns their results
+# by benchmark name.
+def run_python_benchmarks(pytest_args: list[str]) -> dict[str, dict]:
+    with tempfile.NamedTemporaryFile(suffix=".json") as out:
+        subprocess.check_call(
+            [sys.executable, "-m", "pytest", "python_benchmarks"]
+            + pytest_args
+            + [f"--benchmark-json={out.name}"]
+        )
+        data = json.load(out)
+
+    results = {}
+    for row in data["benchmarks"]:
+        results["python/" + row["fullname"]] = {
+            "time_s": row["stats"]["mean"],
+            "stddev_s": row["stats"]["stddev"],
+            "peak_bandwidth_pct": row["extra_info"].get("% Peak Bandwidth (SOL)"),
+        }
+    return results
+
+
+def result_path(out_dir: str, gpu: str, commit: str) -> str:
+    gpu_dir = re.sub(r"[^\w.-]+", "_", gpu)
+    return os.path.join(out_dir, gpu_dir, commit + ".json")
+
+
+def run(args: argparse.Namespace) -> None:
+    gpu, peak_bandwidth_gbps = get_gpu()
+    commit = get_head_commit()
+    benchmarks = {}
+    if not args.skip_cpp:
+        benchmarks.update(
+            run_cpp_benchmarks(shlex.split(args.cpp_args), peak_bandwidth_gbps)
+        )
+    if not args.skip_python:
+        benchmarks.update(run_python_benchmarks(shlex.split(args.pytest_args)))
+
+    out = result_path(args.out_dir, gpu, commit)
+    os.makedirs(os.path.dirname(out), exist_ok=True)
+    with open(out, "w") as f:
+        json.dump(
+            {
+                "gpu": gpu,
+                "commit": commit,
+                "peak_bandwidth_gbps": peak_bandwidth_gbps,
+                "benchmarks": benchmarks,
+            },
+            f,
+            indent=2,
+        )
+    print(f"Stored the results of {len(benchmarks)} benchmarks in {out}.")
+
+
+# A benchmark regressed if its time increased by more than the threshold and,
+# when both runs measured their standard deviations, by more than twice their
+# combined standard deviation.
+def is_regression(baseline: dict, contender: dict, threshold: float) -> bool:
+    difference = contender["time_s"] - baseline["time_s"]
+    if difference <= threshold * baseline["time_s"]:
+        return False
+    if baseline["stddev_s"] is not None and contender["stddev_s"] is not None:
+        noise = math.sqrt(baseline["stddev_s"] ** 2 + contender["stddev_s"] ** 2)
+        return difference > 2 * noise
+    return True
+
+
+def format_bandwidth(result: dict) -> str:
+    if result["peak_bandwidth_pct"] is None:
+        return ""
+    return f", {result['peak_bandwidth_pct']:.1f}% of peak bandwidth"
+
+
+def compare(args: argparse.Namespace) -> int:
+    with open(args.baseline) as f:
+        baseline = json.load(f)
+    with open(args.contender) as f:
+        contender = json.load(f)
+    if baseline["gpu"] != contender["gpu"]:
+        print(
+            f"Warning: comparing results of {baseline['gpu']} and {contender['gpu']}."
+        )
+
+    regressions = []
+    for name, result in sorted(contender["benchmarks"].items()):
+        if name not in baseline["benchmarks"]:
+            continue
+        base_result = baseline["benchmarks"][name]
+        if is_regression(base_result, result, args.threshold):
+            regressions.append(
+                f"  {name}: {base_result['time_s'] * 1e6:.2f}us"
+                f"{format_bandwidth(base_result)} -> "
+                f"{result['time_s'] * 1e6:.2f}us{format_bandwidth(result)} "
+                f"({result['time_s'] / base_result['time_s']:.2f}x)"
+            )
+
+    if not regressions:
+        print(
+            f"No regressions beyond {args.threshold:.0%} from "
+            f"{baseline['commit']} to {contender['commit']}."
+        )
+        return 0
+    print(
+        f"{len(regressions)} regressions beyond {args.threshold:.0%} from "
+        f"{baseline['commit']} to {contender['commit']}:"
+    )
+    print("\n".join(regressions))
+    return 1
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(
+        description="Runs the C++ and python benchmarks and stores their results, or compares two stored results."
+    )
+    subparsers = parser.add_subparsers(dest="command", required=True)
+
+    run_parser = subparsers.add_parser(
+        "run", help="Benchmark the checked out commit on the current GPU"
+    )
+    run_parser.add_argument(
+        "out_dir",
+        type=str,
+        help="The folder that stores the results by GPU and commit",
+    )
+    run_parser.add_argument("--skip-cpp", action="store_true")
+    run_parser.add_argument("--skip-python", action="store_true")
+    run_parser.add_argument(
+        "--cpp-args",
+        type=str,
+        default="",
+        help='Arguments passed to nvfuser_bench, e.g., --cpp-args="--benchmark_filter=NvFuserScheduler"',
+    )
+    run_parser.add_argument(
+        "--pytest-args",
+        type=str,
+        default="",
+        help='Arguments passed to pytest, e.g., --pytest-args="-k softmax"',
+    )
+
+    compare_parser = subparsers.add_parser(
+        "compare", help="Flag the regressions between two stored results"
+    )
+    compare_parser.add_argument("baseline", type=str)
+    compare_parser.add_argument("contender", type=str)
+    compare_parser.add_argument(
+        "--threshold",
+        type=float,
+        default=0.05,
+        help="Relative increase in time below which a change is considered noise",
+    )
+
+    args = parser.parse_args()
+    if args.command == "run":
+        run(args)
+    else:
+        sys.exit(compare(args))
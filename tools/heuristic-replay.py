@@ -0,0 +1,223 @@
+# SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+# All rights reserved.
+# SPDX-License-Identifier: BSD-3-Clause
+#
+# "heuristic-replay.py -h" for help.
+#
+# Reads a log written with NVFUSER_ENABLE=heuristic_log(<file>), see
+# [ Heuristic Decision Log ] in csrc/scheduler/heuristic_log.h. Without
+# --record, lists the records of the log. With --record N, prints a gtest that
+# rebuilds the fusion of the Nth record, runs it on random inputs of the logged
+# sizes and strides, and compares the parameters of every scheduler with
+# heuristic_log::replayHeuristics, e.g.,
+#
+#   python tools/heuristic-replay.py heuristics.txt --record 3 > test/test_repro.cpp
+
+import argparse
+import re
+import sys
+
+ATEN_DTYPES = {
+    "Double": "at::kDouble",
+    "Float": "at::kFloat",
+    "Half": "at::kHalf",
+    "BFloat16": "at::kBFloat16",
+    "Float8_e4m3fn": "at::kFloat8_e4m3fn",
+    "Float8_e5m2": "at::kFloat8_e5m2",
+    "Int": "at::kLong",
+    "Int32": "at::kInt",
+    "Index": "at::kLong",
+    "Bool": "at::kBool",
+    "ComplexDouble": "at::kComplexDouble",
+    "ComplexFloat": "at::kComplexFloat",
+}
+
+FLOATING_DTYPES = {
+    "Double",
+    "Float",
+    "Half",
+    "BFloat16",
+    "ComplexDouble",
+    "ComplexFloat",
+}
+
+INPUT_RE = re.compile(
+    r"input: tensor dtype=(\w+) sizes=(\[[^\]]*\]|\?) strides=(\[[^\]]*\]|\?)"
+)
+SCALAR_RE = re.compile(r"input: scalar dtype=(\w+) value=(\S+)")
+
+
+class Record:
+    def __init__(self, lines: list[str]):
+        self.heuristic = ""
+        self.inputs = []
+        self.params = []
+        self.repro = []
+        section = None
+        for line in lines:
+            if section == "params" and line != "repro:":
+                self.params.append(line)
+            elif section == "repro":
+                self.repro.append(line)
+            elif line == "params:":
+                section = "params"
+            elif line == "repro:":
+                section = "repro"
+            elif line.startswith("heuristic: "):
+                self.heuristic = line[len("heuristic: ") :]
+            elif m := INPUT_RE.match(line):
+                sizes = parse_list(m.group(2))
+                strides = parse_list(m.group(3))
+                self.inputs.append(("tensor", m.group(1), sizes, strides))
+            elif m := SCALAR_RE.match(line):
+                self.inputs.append(("scalar", m.group(1), m.group(2), None))
+
+    def summary(self) -> str:
+        inputs = []
+        for kind, dtype, value, _ in self.inputs:
+            if kind == "tensor":
+                sizes = "?" if value is None else "x".join(map(str, value))
+                inputs.append(f"{dtype}[{sizes}]")
+            else:
+                inputs.append(f"{dtype} {value}")
+        return f"{self.heuristic}({', '.join(inputs)})"
+
+
+def parse_list(text: str):
+    if text == "?":
+        return None
+    return [int(x) for x in text.strip("[]").split(",") if x.strip()]
+
+
+def read_records(path: str) -> list[Record]:
+    records = []
+    lines = None
+    with open(path) as f:
+        for line in f:
+            line = line.rstrip("\n")
+            if line == "=== heuristic decision ===":
+                lines = []
+            elif line == "=== end ===" and lines is not None:
+                records.append(Record(lines))
+                lines = None
+            elif lines is not None:
+                lines.append(line)
+    return records
+
+
+def contiguous_strides(sizes: list[int]) -> list[int]:
+    strides = []
+    stride = 1
+    for size in reversed(sizes):
+        strides.insert(0, stride)
+        stride *= max(size, 1)
+    return strides
+
+
+def make_input(index: int, kind: str, dtype: str, value, strides) -> str:
+    if kind == "scalar":
+        if value == "?":
+            sys.exit(f"The value of scalar input {index} was not logged")
+        if dtype == "Bool":
+            return value
+        if dtype in ("Double", "Float", "Half", "BFloat16"):
+            return f"(double){value}"
+        return f"(int64_t){value}"
+
+    if value is None:
+        sys.exit(f"The sizes of tensor input {index} were not logged")
+    if strides is None:
+        strides = contiguous_strides(value)
+    # The storage of a tensor of the sizes and strides
+    storage = 1 + sum((size - 1) * stride for size, stride in zip(value, strides))
+    if 0 in value:
+        storage = 0
+    options = f"options.dtype({ATEN_DTYPES[dtype]})"
+    if dtype in FLOATING_DTYPES:
+        base = f"at::randn({{{storage}}}, {options})"
+    elif dtype == "Bool":
+        base = f"at::randn({{{storage}}}, options.dtype(at::kFloat)) > 0"
+    else:
+        base = f"at::randint(-8, 8, {{{storage}}}, {options})"
+    sizes = ", ".join(map(str, value))
+    strides = ", ".join(map(str, strides))
+    return f"({base}).as_strided({{{sizes}}}, {{{strides}}})"
+
+
+def make_test(record: Record, name: str) -> str:
+    body = "\n".join("  " + line if line else "" for line in record.repro)
+    inputs = ",\n".join(
+        "      " + make_input(i, *input) for i, input in enumerate(record.inputs)
+    )
+    params = "\n".join(f"//   {line}".rstrip() for line in record.params)
+    return f"""// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <gtest/gtest.h>
+
+#include <fusion.h>
+#include <ir/all_nodes.h>
+#include <ir/builder.h>
+#include <ops/all_ops.h>
+#include <scheduler/heuristic_log.h>
+#include <test/utils.h>
+
+#include <iostream>
+#include <limits>
+
+namespace nvfuser {{
+
+// Generated by tools/heuristic-replay.py from a record of the {record.heuristic}
+// heuristic with the parameters
+//
+{params}
+TEST_F(NVFuserTest, {name}) {{
+  auto fusion_ptr = std::make_unique<Fusion>();
+  Fusion* fusion = fusion_ptr.get();
+  FusionGuard fg(fusion);
+
+{body}
+
+  auto options = at::TensorOptions().device(at::kCUDA, 0);
+  std::vector<c10::IValue> inputs = {{
+{inputs}}};
+
+  auto results = heuristic_log::replayHeuristics(fusion, inputs);
+  std::cout << heuristic_log::toString(results) << std::endl;
+}}
+
+}} // namespace nvfuser
+"""
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(
+        description="Lists the records of a heuristic log, or turns one into a gtest replaying it through all schedulers."
+    )
+    parser.add_argument("log", type=str, help="The heuristic_log file")
+    parser.add_argument(
+        "--record",
+        type=int,
+        default=None,
+        help="The index of the record to print a gtest of",
+    )
+    parser.add_argument(
+        "--name",
+        type=str,
+        default="HeuristicReplay",
+        help="The name of the generated test",
+    )
+    args = parser.parse_args()
+
+    records = read_records(args.log)
+    if args.record is None:
+        for i, record in enumerate(records):
+            print(f"{i}: {record.summary()}")
+    else:
+        if not 0 <= args.record < len(records):
+            sys.exit(f"{args.log} has {len(records)} records")
+        print(make_test(records[args.record], args.name), end="")
@@ -0,0 +1,122 @@
+# SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+# All rights reserved.
+# SPDX-License-Identifier: BSD-3-Clause
+#
+# "roofline.py -h" for help.
+#
+# Reads the JSON output of nvfuser_bench, e.g.,
+#
+#   bin/nvfuser_bench --benchmark_out=out.json --benchmark_format=json
+#
+# prints the achieved bandwidth and throughput of each benchmark relative to
+# the peaks of the GPU, and plots the benchmarks that count FLOPs against the
+# roofline of the GPU. The bytes and FLOPs are the counters reported by
+# setRooflineCounters in benchmark/utils.h, and the peaks are in the context
+# written by benchmark/main.cpp.
+
+import argparse
+import json
+from typing import Optional
+
+TIME_UNIT_IN_SECONDS = {"ns": 1e-9, "us": 1e-6, "ms": 1e-3, "s": 1.0}
+
+
+class Point:
+    def __init__(self, row: dict):
+        self.name = row.get("run_name", row["name"])
+        self.time_s = row["real_time"] * TIME_UNIT_IN_SECONDS[row["time_unit"]]
+        self.bytes = row["bytes"]
+        self.flops: Optional[float] = row.get("flops")
+        self.bandwidth_pct = row["peak_bandwidth_pct"]
+        self.flops_pct: Optional[float] = row.get("peak_flops_pct")
+
+    def arithmetic_intensity(self) -> float:
+        return self.flops / self.bytes
+
+    def gflops_per_s(self) -> float:
+        return self.flops / self.time_s / 1e9
+
+
+def read_points(path: str) -> tuple[dict, list[Point]]:
+    with open(path) as f:
+        data = json.load(f)
+    points = [
+        Point(row)
+        for row in data["benchmarks"]
+        if row.get("run_type", "iteration") == "iteration" and "bytes" in row
+    ]
+    return data["context"], points
+
+
+def print_table(points: list[Point]) -> None:
+    for p in sorted(points, key=lambda p: p.name):
+        line = (
+            f"{p.name}: {p.time_s * 1e6:.2f}us, "
+            f"{p.bytes / p.time_s / 1e9:.1f}GB/s "
+            f"({p.bandwidth_pct:.1f}% of peak)"
+        )
+        if p.flops is not None:
+            line += (
+                f", {p.gflops_per_s():.1f}GFLOP/s ({p.flops_pct:.1f}% of peak), "
+                f"{p.arithmetic_intensity():.2f}FLOP/B"
+            )
+        print(line)
+
+
+def plot(context: dict, points: list[Point], out: str) -> None:
+    import matplotlib
+
+    matplotlib.use("Agg")
+    import matplotlib.pyplot as plt
+    import numpy as np
+
+    peak_gbps = float(context["gpu_peak_bandwidth_gbps"])
+    roofs = {
+        "FP32": float(context["gpu_peak_fp32_tflops"]) * 1e3,
+        "Tensor core": float(context["gpu_peak_tensor_tflops"]) * 1e3,
+    }
+    points = [p for p in points if p.flops is not None]
+
+    intensities = np.logspace(-2, 4, 256)
+    fig, ax = plt.subplots(figsize=(10, 7))
+    for label, peak_gflops in roofs.items():
+        ax.plot(
+            intensities,
+            np.minimum(intensities * peak_gbps, peak_gflops),
+            label=f"{label} roof ({peak_gflops / 1e3:.1f}TFLOP/s)",
+        )
+    for p in points:
+        ax.scatter(p.arithmetic_intensity(), p.gflops_per_s(), s=12)
+        if len(points) <= 32:
+            ax.annotate(
+                p.name,
+                (p.arithmetic_intensity(), p.gflops_per_s()),
+                fontsize=6,
+            )
+    ax.set_xscale("log")
+    ax.set_yscale("log")
+    ax.set_xlabel("Arithmetic intensity (FLOP/B)")
+    ax.set_ylabel("Achieved throughput (GFLOP/s)")
+    ax.set_title(f"{context['gpu_name']}, {peak_gbps:.0f}GB/s")
+    ax.legend()
+    fig.savefig(out, dpi=150, bbox_inches="tight")
+    print(f"Plotted {len(points)} benchmarks in {out}.")
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(
+        description="Relates the results of nvfuser_bench to the peak bandwidth and throughput of the GPU."
+    )
+    parser.add_argument("benchmark_json", type=str, help="The --benchmark_out file")
+    parser.add_argument(
+        "--plot",
+        type=str,
+        default=None,
+        help="The image file to plot the roofline in, e.g., roofline.png",
+    )
+    args = parser.parse_args()
+
+    context, points = read_points(args.benchmark_json)
+    print_table(points)
+    if args.plot is not None:
+        plot(context, points, args.plot)